@@ -40,8 +40,8 @@ int main(int argc, char** argv) {
     if(world.rank() == 0)
       std::cout << "Reading input...";
 
-    InputData data(input);
     input.close();
+    InputData data(file_name);
 
     if(world.rank() == 0)
       std::cout << " done.\nConstructing Fock tensors...";
@@ -123,6 +123,41 @@ int main(int argc, char** argv) {
 
     data.clear();
 
+    // Group the spin blocks of each tensor
+    typedef TiledArray::SpinArray<TiledArray::TensorD> SpinArrayD;
+    SpinArrayD f_oo, f_vv;
+    f_oo.set_block("aa", f_a_oo);
+    f_oo.set_block("bb", f_b_oo);
+    f_vv.set_block("aa", f_a_vv);
+    f_vv.set_block("bb", f_b_vv);
+
+    SpinArrayD v_oooo, v_vvoo, v_vovo, v_oovv, v_vvvv;
+    v_oooo.set_block("aaaa", v_aa_oooo);
+    v_oooo.set_block("abab", v_ab_oooo);
+    v_oooo.set_block("bbbb", v_bb_oooo);
+    v_vvoo.set_block("aaaa", v_aa_vvoo);
+    v_vvoo.set_block("abab", v_ab_vvoo);
+    v_vvoo.set_block("bbbb", v_bb_vvoo);
+    v_vovo.set_block("aaaa", v_aa_vovo);
+    v_vovo.set_block("abab", v_ab_vovo);
+    v_vovo.set_block("bbbb", v_bb_vovo);
+    v_oovv.set_block("aaaa", v_aa_oovv);
+    v_oovv.set_block("abab", v_ab_oovv);
+    v_oovv.set_block("bbbb", v_bb_oovv);
+    v_vvvv.set_block("aaaa", v_aa_vvvv);
+    v_vvvv.set_block("abab", v_ab_vvvv);
+    v_vvvv.set_block("bbbb", v_bb_vvvv);
+
+    SpinArrayD v_voov, v_ovov, v_ovvo;
+    v_voov.set_block("abab", v_ab_voov);
+    v_ovov.set_block("abab", v_ab_ovov);
+    v_ovvo.set_block("abab", v_ab_ovvo);
+
+    SpinArrayD t_vvoo;
+    t_vvoo.set_block("aaaa", t_aa_vvoo);
+    t_vvoo.set_block("abab", t_ab_vvoo);
+    t_vvoo.set_block("bbbb", t_bb_vvoo);
+
     if(world.rank() == 0)
       std::cout << "Calculating t amplitudes...\n";
 
@@ -134,133 +169,121 @@ int main(int argc, char** argv) {
       if(world.rank() == 0)
         std::cout << "Iteration " << i << "\n";
 
-      TiledArray::TSpArrayD r_aa_vvoo;
-      r_aa_vvoo("p1a,p2a,h1a,h2a") =
-          v_aa_vvoo("p1a,p2a,h1a,h2a")
-          -f_a_vv("p1a,p3a")*t_aa_vvoo("p2a,p3a,h1a,h2a")
-          +f_a_vv("p2a,p3a")*t_aa_vvoo("p1a,p3a,h1a,h2a")
-          +f_a_oo("h3a,h1a")*t_aa_vvoo("p1a,p2a,h2a,h3a")
-          -f_a_oo("h3a,h2a")*t_aa_vvoo("p1a,p2a,h1a,h3a")
-          +0.5*t_aa_vvoo("p3a,p4a,h1a,h2a")*v_aa_vvvv("p1a,p2a,p3a,p4a")
-          +v_ab_voov("p1a,h3b,h1a,p3b")*t_ab_vvoo("p2a,p3b,h2a,h3b")
-          -v_aa_vovo("p1a,h3a,p3a,h1a")*t_aa_vvoo("p2a,p3a,h2a,h3a")
-          -v_ab_voov("p1a,h3b,h2a,p3b")*t_ab_vvoo("p2a,p3b,h1a,h3b")
-          +v_aa_vovo("p1a,h3a,p3a,h2a")*t_aa_vvoo("p2a,p3a,h1a,h3a")
-          -v_ab_voov("p2a,h3b,h1a,p3b")*t_ab_vvoo("p1a,p3b,h2a,h3b")
-          +v_aa_vovo("p2a,h3a,p3a,h1a")*t_aa_vvoo("p1a,p3a,h2a,h3a")
-          +v_ab_voov("p2a,h3b,h2a,p3b")*t_ab_vvoo("p1a,p3b,h1a,h3b")
-          -v_aa_vovo("p2a,h3a,p3a,h2a")*t_aa_vvoo("p1a,p3a,h1a,h3a")
-          +0.5*v_aa_oooo("h3a,h4a,h1a,h2a")*t_aa_vvoo("p1a,p2a,h3a,h4a")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p2a,p4b,h3a,h4b")*t_aa_vvoo("p1a,p3a,h1a,h2a")
-          -0.5*v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p2a,p4a,h3a,h4a")*t_aa_vvoo("p1a,p3a,h1a,h2a")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p1a,p4b,h3a,h4b")*t_aa_vvoo("p2a,p3a,h1a,h2a")
-          +0.5*v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p1a,p4a,h3a,h4a")*t_aa_vvoo("p2a,p3a,h1a,h2a")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p4b,h2a,h4b")*t_aa_vvoo("p1a,p2a,h1a,h3a")
-          -0.5*v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p3a,p4a,h2a,h4a")*t_aa_vvoo("p1a,p2a,h1a,h3a")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p4b,h1a,h4b")*t_aa_vvoo("p1a,p2a,h2a,h3a")
-          -0.5*v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p3a,p4a,h1a,h3a")*t_aa_vvoo("p1a,p2a,h2a,h4a")
-          +0.25*v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p3a,p4a,h1a,h2a")*t_aa_vvoo("p1a,p2a,h3a,h4a")
-          +v_bb_oovv("h3b,h4b,p3b,p4b")*t_ab_vvoo("p1a,p3b,h1a,h3b")*t_ab_vvoo("p2a,p4b,h2a,h4b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p1a,p4b,h1a,h4b")*t_aa_vvoo("p2a,p3a,h2a,h3a")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_aa_vvoo("p1a,p3a,h1a,h3a")*t_ab_vvoo("p2a,p4b,h2a,h4b")
-          +v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p1a,p3a,h1a,h3a")*t_aa_vvoo("p2a,p4a,h2a,h4a")
-          -v_bb_oovv("h3b,h4b,p3b,p4b")*t_ab_vvoo("p2a,p3b,h1a,h3b")*t_ab_vvoo("p1a,p4b,h2a,h4b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p2a,p4b,h1a,h4b")*t_aa_vvoo("p1a,p3a,h2a,h3a")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_aa_vvoo("p2a,p3a,h1a,h3a")*t_ab_vvoo("p1a,p4b,h2a,h4b")
-          -v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p2a,p3a,h1a,h3a")*t_aa_vvoo("p1a,p4a,h2a,h4a");
-
-      world.gop.fence();
-
-      TiledArray::TSpArrayD r_ab_vvoo;
-      r_ab_vvoo("p1a,p2b,h1a,h2b") =
-          v_ab_vvoo("p1a,p2b,h1a,h2b")
-          +f_a_vv("p1a,p3a")*t_ab_vvoo("p3a,p2b,h1a,h2b")
-          +f_b_vv("p2b,p3b")*t_ab_vvoo("p1a,p3b,h1a,h2b")
-          -f_a_oo("h3a,h1a")*t_ab_vvoo("p1a,p2b,h3a,h2b")
-          -f_b_oo("h3b,h2b")*t_ab_vvoo("p1a,p2b,h1a,h3b")
-          +t_ab_vvoo("p3a,p4b,h1a,h2b")*v_ab_vvvv("p1a,p2b,p3a,p4b")
-          +v_ab_voov("p1a,h3b,h1a,p3b")*t_bb_vvoo("p2b,p3b,h2b,h3b")
-          -v_aa_vovo("p1a,h3a,p3a,h1a")*t_ab_vvoo("p3a,p2b,h3a,h2b")
-          -v_ab_vovo("p1a,h3b,p3a,h2b")*t_ab_vvoo("p3a,p2b,h1a,h3b")
-          -v_ab_ovov("h3a,p2b,h1a,p3b")*t_ab_vvoo("p1a,p3b,h3a,h2b")
-          -v_bb_vovo("p2b,h3b,p3b,h2b")*t_ab_vvoo("p1a,p3b,h1a,h3b")
-          +v_ab_ovvo("h3a,p2b,p3a,h2b")*t_aa_vvoo("p1a,p3a,h1a,h3a")
-          +v_ab_oooo("h3a,h4b,h1a,h2b")*t_ab_vvoo("p1a,p2b,h3a,h4b")
-          -0.5*v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p2b,p4b,h3b,h4b")*t_ab_vvoo("p1a,p3b,h1a,h2b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p2b,h3a,h4b")*t_ab_vvoo("p1a,p4b,h1a,h2b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p1a,p4b,h3a,h4b")*t_ab_vvoo("p3a,p2b,h1a,h2b")
-          -0.5*v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p1a,p4a,h3a,h4a")*t_ab_vvoo("p3a,p2b,h1a,h2b")
-          -0.5*v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p3b,p4b,h2b,h4b")*t_ab_vvoo("p1a,p2b,h1a,h3b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p4b,h3a,h2b")*t_ab_vvoo("p1a,p2b,h1a,h4b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p4b,h1a,h4b")*t_ab_vvoo("p1a,p2b,h3a,h2b")
-          +0.5*v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p3a,p4a,h1a,h3a")*t_ab_vvoo("p1a,p2b,h4a,h2b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p4b,h1a,h2b")*t_ab_vvoo("p1a,p2b,h3a,h4b")
-          +v_bb_oovv("h3b,h4b,p3b,p4b")*t_ab_vvoo("p1a,p3b,h1a,h3b")*t_bb_vvoo("p2b,p4b,h2b,h4b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p1a,p4b,h1a,h4b")*t_ab_vvoo("p3a,p2b,h3a,h2b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_aa_vvoo("p1a,p3a,h1a,h3a")*t_bb_vvoo("p2b,p4b,h2b,h4b")
-          +v_aa_oovv("h3a,h4a,p3a,p4a")*t_aa_vvoo("p1a,p3a,h1a,h3a")*t_ab_vvoo("p4a,p2b,h4a,h2b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p2b,h1a,h4b")*t_ab_vvoo("p1a,p4b,h3a,h2b");
-
-      world.gop.fence();
-
-      TiledArray::TSpArrayD r_bb_vvoo;
-      r_bb_vvoo("p1b,p2b,h1b,h2b") =
-          v_bb_vvoo("p1b,p2b,h1b,h2b")
-          -f_b_vv("p1b,p3b")*t_bb_vvoo("p2b,p3b,h1b,h2b")
-          +f_b_vv("p2b,p3b")*t_bb_vvoo("p1b,p3b,h1b,h2b")
-          +f_b_oo("h3b,h1b")*t_bb_vvoo("p1b,p2b,h2b,h3b")
-          -f_b_oo("h3b,h2b")*t_bb_vvoo("p1b,p2b,h1b,h3b")
-          +0.5*t_bb_vvoo("p3b,p4b,h1b,h2b")*v_bb_vvvv("p1b,p2b,p3b,p4b")
-          -v_bb_vovo("p1b,h3b,p3b,h1b")*t_bb_vvoo("p2b,p3b,h2b,h3b")
-          +v_ab_ovvo("h3a,p1b,p3a,h1b")*t_ab_vvoo("p3a,p2b,h3a,h2b")
-          +v_bb_vovo("p1b,h3b,p3b,h2b")*t_bb_vvoo("p2b,p3b,h1b,h3b")
-          -v_ab_ovvo("h3a,p1b,p3a,h2b")*t_ab_vvoo("p3a,p2b,h3a,h1b")
-          +v_bb_vovo("p2b,h3b,p3b,h1b")*t_bb_vvoo("p1b,p3b,h2b,h3b")
-          -v_ab_ovvo("h3a,p2b,p3a,h1b")*t_ab_vvoo("p3a,p1b,h3a,h2b")
-          -v_bb_vovo("p2b,h3b,p3b,h2b")*t_bb_vvoo("p1b,p3b,h1b,h3b")
-          +v_ab_ovvo("h3a,p2b,p3a,h2b")*t_ab_vvoo("p3a,p1b,h3a,h1b")
-          +0.5*v_bb_oooo("h3b,h4b,h1b,h2b")*t_bb_vvoo("p1b,p2b,h3b,h4b")
-          -0.5*v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p2b,p4b,h3b,h4b")*t_bb_vvoo("p1b,p3b,h1b,h2b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p2b,h3a,h4b")*t_bb_vvoo("p1b,p4b,h1b,h2b")
-          +0.5*v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p1b,p4b,h3b,h4b")*t_bb_vvoo("p2b,p3b,h1b,h2b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p1b,h3a,h4b")*t_bb_vvoo("p2b,p4b,h1b,h2b")
-          -0.5*v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p3b,p4b,h2b,h4b")*t_bb_vvoo("p1b,p2b,h1b,h3b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p4b,h3a,h2b")*t_bb_vvoo("p1b,p2b,h1b,h4b")
-          -0.5*v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p3b,p4b,h1b,h3b")*t_bb_vvoo("p1b,p2b,h2b,h4b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p4b,h3a,h1b")*t_bb_vvoo("p1b,p2b,h2b,h4b")
-          +0.25*v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p3b,p4b,h1b,h2b")*t_bb_vvoo("p1b,p2b,h3b,h4b")
-          +v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p1b,p3b,h1b,h3b")*t_bb_vvoo("p2b,p4b,h2b,h4b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p2b,h3a,h2b")*t_bb_vvoo("p1b,p4b,h1b,h4b")
-          +v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p1b,h3a,h1b")*t_bb_vvoo("p2b,p4b,h2b,h4b")
-          +v_aa_oovv("h3a,h4a,p3a,p4a")*t_ab_vvoo("p3a,p1b,h3a,h1b")*t_ab_vvoo("p4a,p2b,h4a,h2b")
-          -v_bb_oovv("h3b,h4b,p3b,p4b")*t_bb_vvoo("p2b,p3b,h1b,h3b")*t_bb_vvoo("p1b,p4b,h2b,h4b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p1b,h3a,h2b")*t_bb_vvoo("p2b,p4b,h1b,h4b")
-          -v_ab_oovv("h3a,h4b,p3a,p4b")*t_ab_vvoo("p3a,p2b,h3a,h1b")*t_bb_vvoo("p1b,p4b,h2b,h4b")
-          -v_aa_oovv("h3a,h4a,p3a,p4a")*t_ab_vvoo("p3a,p2b,h3a,h1b")*t_ab_vvoo("p4a,p1b,h4a,h2b");
-
+      // Evaluate the spin cases of the residual concurrently
+      SpinArrayD r_vvoo;
+      r_vvoo.assign_blocks([&] () {
+        r_vvoo("p1a,p2a,h1a,h2a") =
+            v_vvoo("p1a,p2a,h1a,h2a")
+            -f_vv("p1a,p3a")*t_vvoo("p2a,p3a,h1a,h2a")
+            +f_vv("p2a,p3a")*t_vvoo("p1a,p3a,h1a,h2a")
+            +f_oo("h3a,h1a")*t_vvoo("p1a,p2a,h2a,h3a")
+            -f_oo("h3a,h2a")*t_vvoo("p1a,p2a,h1a,h3a")
+            +0.5*t_vvoo("p3a,p4a,h1a,h2a")*v_vvvv("p1a,p2a,p3a,p4a")
+            +v_voov("p1a,h3b,h1a,p3b")*t_vvoo("p2a,p3b,h2a,h3b")
+            -v_vovo("p1a,h3a,p3a,h1a")*t_vvoo("p2a,p3a,h2a,h3a")
+            -v_voov("p1a,h3b,h2a,p3b")*t_vvoo("p2a,p3b,h1a,h3b")
+            +v_vovo("p1a,h3a,p3a,h2a")*t_vvoo("p2a,p3a,h1a,h3a")
+            -v_voov("p2a,h3b,h1a,p3b")*t_vvoo("p1a,p3b,h2a,h3b")
+            +v_vovo("p2a,h3a,p3a,h1a")*t_vvoo("p1a,p3a,h2a,h3a")
+            +v_voov("p2a,h3b,h2a,p3b")*t_vvoo("p1a,p3b,h1a,h3b")
+            -v_vovo("p2a,h3a,p3a,h2a")*t_vvoo("p1a,p3a,h1a,h3a")
+            +0.5*v_oooo("h3a,h4a,h1a,h2a")*t_vvoo("p1a,p2a,h3a,h4a")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p2a,p4b,h3a,h4b")*t_vvoo("p1a,p3a,h1a,h2a")
+            -0.5*v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p2a,p4a,h3a,h4a")*t_vvoo("p1a,p3a,h1a,h2a")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p1a,p4b,h3a,h4b")*t_vvoo("p2a,p3a,h1a,h2a")
+            +0.5*v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p1a,p4a,h3a,h4a")*t_vvoo("p2a,p3a,h1a,h2a")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p4b,h2a,h4b")*t_vvoo("p1a,p2a,h1a,h3a")
+            -0.5*v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p3a,p4a,h2a,h4a")*t_vvoo("p1a,p2a,h1a,h3a")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p4b,h1a,h4b")*t_vvoo("p1a,p2a,h2a,h3a")
+            -0.5*v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p3a,p4a,h1a,h3a")*t_vvoo("p1a,p2a,h2a,h4a")
+            +0.25*v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p3a,p4a,h1a,h2a")*t_vvoo("p1a,p2a,h3a,h4a")
+            +v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p1a,p3b,h1a,h3b")*t_vvoo("p2a,p4b,h2a,h4b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p1a,p4b,h1a,h4b")*t_vvoo("p2a,p3a,h2a,h3a")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p1a,p3a,h1a,h3a")*t_vvoo("p2a,p4b,h2a,h4b")
+            +v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p1a,p3a,h1a,h3a")*t_vvoo("p2a,p4a,h2a,h4a")
+            -v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p2a,p3b,h1a,h3b")*t_vvoo("p1a,p4b,h2a,h4b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p2a,p4b,h1a,h4b")*t_vvoo("p1a,p3a,h2a,h3a")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p2a,p3a,h1a,h3a")*t_vvoo("p1a,p4b,h2a,h4b")
+            -v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p2a,p3a,h1a,h3a")*t_vvoo("p1a,p4a,h2a,h4a");
+
+        r_vvoo("p1a,p2b,h1a,h2b") =
+            v_vvoo("p1a,p2b,h1a,h2b")
+            +f_vv("p1a,p3a")*t_vvoo("p3a,p2b,h1a,h2b")
+            +f_vv("p2b,p3b")*t_vvoo("p1a,p3b,h1a,h2b")
+            -f_oo("h3a,h1a")*t_vvoo("p1a,p2b,h3a,h2b")
+            -f_oo("h3b,h2b")*t_vvoo("p1a,p2b,h1a,h3b")
+            +t_vvoo("p3a,p4b,h1a,h2b")*v_vvvv("p1a,p2b,p3a,p4b")
+            +v_voov("p1a,h3b,h1a,p3b")*t_vvoo("p2b,p3b,h2b,h3b")
+            -v_vovo("p1a,h3a,p3a,h1a")*t_vvoo("p3a,p2b,h3a,h2b")
+            -v_vovo("p1a,h3b,p3a,h2b")*t_vvoo("p3a,p2b,h1a,h3b")
+            -v_ovov("h3a,p2b,h1a,p3b")*t_vvoo("p1a,p3b,h3a,h2b")
+            -v_vovo("p2b,h3b,p3b,h2b")*t_vvoo("p1a,p3b,h1a,h3b")
+            +v_ovvo("h3a,p2b,p3a,h2b")*t_vvoo("p1a,p3a,h1a,h3a")
+            +v_oooo("h3a,h4b,h1a,h2b")*t_vvoo("p1a,p2b,h3a,h4b")
+            -0.5*v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p2b,p4b,h3b,h4b")*t_vvoo("p1a,p3b,h1a,h2b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p2b,h3a,h4b")*t_vvoo("p1a,p4b,h1a,h2b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p1a,p4b,h3a,h4b")*t_vvoo("p3a,p2b,h1a,h2b")
+            -0.5*v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p1a,p4a,h3a,h4a")*t_vvoo("p3a,p2b,h1a,h2b")
+            -0.5*v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p3b,p4b,h2b,h4b")*t_vvoo("p1a,p2b,h1a,h3b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p4b,h3a,h2b")*t_vvoo("p1a,p2b,h1a,h4b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p4b,h1a,h4b")*t_vvoo("p1a,p2b,h3a,h2b")
+            +0.5*v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p3a,p4a,h1a,h3a")*t_vvoo("p1a,p2b,h4a,h2b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p4b,h1a,h2b")*t_vvoo("p1a,p2b,h3a,h4b")
+            +v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p1a,p3b,h1a,h3b")*t_vvoo("p2b,p4b,h2b,h4b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p1a,p4b,h1a,h4b")*t_vvoo("p3a,p2b,h3a,h2b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p1a,p3a,h1a,h3a")*t_vvoo("p2b,p4b,h2b,h4b")
+            +v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p1a,p3a,h1a,h3a")*t_vvoo("p4a,p2b,h4a,h2b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p2b,h1a,h4b")*t_vvoo("p1a,p4b,h3a,h2b");
+
+        r_vvoo("p1b,p2b,h1b,h2b") =
+            v_vvoo("p1b,p2b,h1b,h2b")
+            -f_vv("p1b,p3b")*t_vvoo("p2b,p3b,h1b,h2b")
+            +f_vv("p2b,p3b")*t_vvoo("p1b,p3b,h1b,h2b")
+            +f_oo("h3b,h1b")*t_vvoo("p1b,p2b,h2b,h3b")
+            -f_oo("h3b,h2b")*t_vvoo("p1b,p2b,h1b,h3b")
+            +0.5*t_vvoo("p3b,p4b,h1b,h2b")*v_vvvv("p1b,p2b,p3b,p4b")
+            -v_vovo("p1b,h3b,p3b,h1b")*t_vvoo("p2b,p3b,h2b,h3b")
+            +v_ovvo("h3a,p1b,p3a,h1b")*t_vvoo("p3a,p2b,h3a,h2b")
+            +v_vovo("p1b,h3b,p3b,h2b")*t_vvoo("p2b,p3b,h1b,h3b")
+            -v_ovvo("h3a,p1b,p3a,h2b")*t_vvoo("p3a,p2b,h3a,h1b")
+            +v_vovo("p2b,h3b,p3b,h1b")*t_vvoo("p1b,p3b,h2b,h3b")
+            -v_ovvo("h3a,p2b,p3a,h1b")*t_vvoo("p3a,p1b,h3a,h2b")
+            -v_vovo("p2b,h3b,p3b,h2b")*t_vvoo("p1b,p3b,h1b,h3b")
+            +v_ovvo("h3a,p2b,p3a,h2b")*t_vvoo("p3a,p1b,h3a,h1b")
+            +0.5*v_oooo("h3b,h4b,h1b,h2b")*t_vvoo("p1b,p2b,h3b,h4b")
+            -0.5*v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p2b,p4b,h3b,h4b")*t_vvoo("p1b,p3b,h1b,h2b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p2b,h3a,h4b")*t_vvoo("p1b,p4b,h1b,h2b")
+            +0.5*v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p1b,p4b,h3b,h4b")*t_vvoo("p2b,p3b,h1b,h2b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p1b,h3a,h4b")*t_vvoo("p2b,p4b,h1b,h2b")
+            -0.5*v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p3b,p4b,h2b,h4b")*t_vvoo("p1b,p2b,h1b,h3b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p4b,h3a,h2b")*t_vvoo("p1b,p2b,h1b,h4b")
+            -0.5*v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p3b,p4b,h1b,h3b")*t_vvoo("p1b,p2b,h2b,h4b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p4b,h3a,h1b")*t_vvoo("p1b,p2b,h2b,h4b")
+            +0.25*v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p3b,p4b,h1b,h2b")*t_vvoo("p1b,p2b,h3b,h4b")
+            +v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p1b,p3b,h1b,h3b")*t_vvoo("p2b,p4b,h2b,h4b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p2b,h3a,h2b")*t_vvoo("p1b,p4b,h1b,h4b")
+            +v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p1b,h3a,h1b")*t_vvoo("p2b,p4b,h2b,h4b")
+            +v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p3a,p1b,h3a,h1b")*t_vvoo("p4a,p2b,h4a,h2b")
+            -v_oovv("h3b,h4b,p3b,p4b")*t_vvoo("p2b,p3b,h1b,h3b")*t_vvoo("p1b,p4b,h2b,h4b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p1b,h3a,h2b")*t_vvoo("p2b,p4b,h1b,h4b")
+            -v_oovv("h3a,h4b,p3a,p4b")*t_vvoo("p3a,p2b,h3a,h1b")*t_vvoo("p1b,p4b,h2b,h4b")
+            -v_oovv("h3a,h4a,p3a,p4a")*t_vvoo("p3a,p2b,h3a,h1b")*t_vvoo("p4a,p1b,h4a,h2b");
+      });
 
       world.gop.fence();
 
-      t_aa_vvoo("a,b,i,j") =
-          D_vvoo("a,b,i,j") * r_aa_vvoo("a,b,i,j")
-          + t_aa_vvoo("a,b,i,j");
-
-      t_ab_vvoo("a,b,i,j") =
-          D_vvoo("a,b,i,j") * r_ab_vvoo("a,b,i,j")
-          + t_ab_vvoo("a,b,i,j");
-
-      t_bb_vvoo("a,b,i,j") =
-          D_vvoo("a,b,i,j") * r_bb_vvoo("a,b,i,j")
-          + t_bb_vvoo("a,b,i,j");
+      t_vvoo.for_each_block([&] (const std::string& spins, TiledArray::TSpArrayD& t) {
+        t("a,b,i,j") = D_vvoo("a,b,i,j") * r_vvoo.block(spins)("a,b,i,j") + t("a,b,i,j");
+      });
 
-      const double error = (r_aa_vvoo("a,b,i,j")
-          + r_ab_vvoo("a,b,i,j") + r_bb_vvoo("a,b,i,j")).norm();
+      const double error = (r_vvoo.block("aaaa")("a,b,i,j")
+          + r_vvoo.block("abab")("a,b,i,j") + r_vvoo.block("bbbb")("a,b,i,j")).norm();
 
       energy =
-           0.25 * ( t_aa_vvoo("a,b,i,j").dot(v_aa_vvoo("a,b,i,j"))
-                   + t_bb_vvoo("a,b,i,j").dot(v_bb_vvoo("a,b,i,j"))
+           0.25 * ( t_vvoo.block("aaaa")("a,b,i,j").dot(v_vvoo.block("aaaa")("a,b,i,j"))
+                   + t_vvoo.block("bbbb")("a,b,i,j").dot(v_vvoo.block("bbbb")("a,b,i,j"))
                   )
-          + t_ab_vvoo("a,b,i,j").dot(v_ab_vvoo("a,b,i,j"));
+          + t_vvoo.block("abab")("a,b,i,j").dot(v_vvoo.block("abab")("a,b,i,j"));
 
       world.gop.fence();
 
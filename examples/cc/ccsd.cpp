@@ -39,8 +39,8 @@ int main(int argc, char** argv) {
     if(world.rank() == 0)
       std::cout << "Reading input...";
 
-    InputData data(input);
     input.close();
+    InputData data(file_name);
 
     if(world.rank() == 0)
       std::cout << " done.\nConstructing Fock tensors...";
@@ -0,0 +1,497 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  ccsd_bench.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Synthetic CCSD benchmark
+//
+// Runs the spin-orbital CCSD equations (Stanton and Gauss, J. Chem. Phys. 94,
+// 4334 (1991)) on synthetic integrals and amplitudes of any number of
+// occupied and virtual orbitals, so the scaling of the full CCSD term set can
+// be measured at sizes that no bundled input reaches. The tensors are filled
+// with deterministic pseudo-random values, which do not depend on the number
+// of processes, and their shapes have:
+//  - point group symmetry blocking with 1, 2, 4, or 8 irreps, where the
+//    tiles of each orbital space are assigned to irreps cyclically, and
+//  - a fraction of tiles that are randomly zero (sparsity).
+// Each term of an iteration is evaluated and fenced separately, and the
+// benchmark reports its time, the flops estimated from the shapes, the bytes
+// sent between processes, and the peak memory of any process. In strong
+// scaling mode the sizes are fixed; in weak scaling mode both orbital spaces
+// grow with the sixth root of the number of processes, so the o^2 v^4 work
+// per process is constant.
+
+namespace {
+
+  /// Benchmark parameters
+  struct Config {
+    long occ = 20; ///< Number of occupied orbitals
+    long vir = 80; ///< Number of virtual orbitals
+    long occ_block = 5; ///< Occupied tile size
+    long vir_block = 20; ///< Virtual tile size
+    double sparsity = 0.0; ///< Fraction of tiles that are zero
+    unsigned int irreps = 1u; ///< Number of irreps
+    bool weak = false; ///< Weak scaling mode
+    unsigned int iterations = 3u; ///< Number of CCSD iterations
+    float threshold = 1.0e-30f; ///< Shape zero threshold
+    std::string output; ///< CSV output file
+  }; // struct Config
+
+  /// The measurements of one term, summed over iterations
+  struct Term {
+    std::string name;
+    double time = 0.0; ///< Wall time (s)
+    double flops = 0.0; ///< Estimated floating point operations
+    double comm = 0.0; ///< Bytes sent between processes
+    double memory = 0.0; ///< Peak memory of any process (bytes)
+  }; // struct Term
+
+  void usage() {
+    std::cout << "Usage: ccsd_bench [-o occ] [-v vir] [-bo occ_block] [-bv vir_block]\n"
+              << "                  [-s sparsity] [-g irreps] [-m strong|weak]\n"
+              << "                  [-i iterations] [-e threshold] [-c output.csv]\n"
+              << "  sparsity is the fraction of tiles that are zero; irreps is 1, 2,\n"
+              << "  4, or 8; in weak scaling mode occ and vir are the sizes on one\n"
+              << "  process.\n";
+  }
+
+  /// Mix the bits of an integer (splitmix64)
+  std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+  }
+
+  /// A pseudo-random number in [0,1)
+  double uniform(const std::uint64_t seed, const std::uint64_t i) {
+    return double(mix(seed ^ mix(i)) >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  /// An orbital space
+  struct Space {
+    long size;
+    TiledArray::TiledRange1 trange;
+    TiledArray::symmetry::IrrepBlocking::labels_type labels; ///< Tile irreps
+
+    Space(const long n, const long block, const unsigned int irreps) : size(n) {
+      std::vector<long> bounds;
+      for(long i = 0l; i < n; i += block)
+        bounds.push_back(i);
+      bounds.push_back(n);
+      trange = TiledArray::TiledRange1(bounds.begin(), bounds.end());
+      for(std::size_t t = 0ul; t + 1ul < bounds.size(); ++t)
+        labels.push_back(t % irreps);
+    }
+  }; // struct Space
+
+  /// Make a totally symmetric array of pseudo-random values
+
+  /// \param world The world of the array
+  /// \param spaces The orbital space of each dimension
+  /// \param scale The magnitude of the elements
+  /// \param salt The seed of the array
+  /// \param sparsity The fraction of tiles that are zero
+  TiledArray::TSpArrayD make_array(TiledArray::World& world,
+      const std::vector<const Space*>& spaces, const double scale,
+      const std::uint64_t salt, const double sparsity)
+  {
+    std::vector<TiledArray::TiledRange1> ranges;
+    std::vector<TiledArray::symmetry::IrrepBlocking::labels_type> labels;
+    for(const Space* space : spaces) {
+      ranges.push_back(space->trange);
+      labels.push_back(space->labels);
+    }
+    const TiledArray::TiledRange trange(ranges.begin(), ranges.end());
+    const TiledArray::symmetry::IrrepBlocking blocking(labels);
+    const auto shape = TiledArray::symmetry::make_shape(trange, blocking,
+        [&] (const std::size_t i) -> float {
+          if(uniform(salt, i) < sparsity)
+            return 0.0f;
+          return scale * std::sqrt(double(trange.make_tile_range(i).volume()));
+        });
+
+    TiledArray::TSpArrayD array(world, trange, shape);
+    array.init_tiles([scale, salt] (const TiledArray::Range& range) {
+      TiledArray::TensorD tile(range);
+      std::uint64_t seed = salt;
+      for(unsigned int d = 0u; d < range.rank(); ++d)
+        seed = mix(seed ^ range.lobound_data()[d]);
+      for(std::size_t k = 0ul; k < tile.size(); ++k)
+        tile[k] = scale * (2.0 * uniform(seed, k) - 1.0);
+      return tile;
+    });
+    return array;
+  }
+
+  /// Make the orbital energies of a space
+
+  /// \param world The world of the array
+  /// \param space The orbital space
+  /// \param first The energy of the first orbital
+  /// \param step The energy difference of consecutive orbitals
+  TiledArray::TSpArrayD make_energies(TiledArray::World& world,
+      const Space& space, const double first, const double step)
+  {
+    const TiledArray::TiledRange trange({ space.trange });
+    TiledArray::TSpArrayD array(world, trange, TiledArray::SparseShape<float>(
+        TiledArray::Tensor<float>(trange.tiles_range(), 1.0f), trange));
+    array.init_tiles([first, step] (const TiledArray::Range& range) {
+      TiledArray::TensorD tile(range);
+      for(std::size_t k = 0ul; k < tile.size(); ++k)
+        tile[k] = first + step * double(range.lobound(0) + k);
+      return tile;
+    });
+    return array;
+  }
+
+  /// Term timer
+  class Benchmark {
+    TiledArray::World& world_;
+    std::vector<Term> terms_;
+
+    Term& find(const std::string& name) {
+      for(Term& term : terms_)
+        if(term.name == name)
+          return term;
+      terms_.emplace_back();
+      terms_.back().name = name;
+      return terms_.back();
+    }
+
+  public:
+    explicit Benchmark(TiledArray::World& world) : world_(world), terms_() { }
+
+    const std::vector<Term>& terms() const { return terms_; }
+
+    /// Evaluate and measure a term
+
+    /// \param name The name of the term
+    /// \param op The evaluation of the term, which takes a reference to its
+    /// \c Term to add the estimated flops
+    template <typename Op>
+    void run(const std::string& name, Op&& op) {
+      Term& term = find(name);
+      TiledArray::CommTracker::instance().reset();
+      TiledArray::MemoryTracker::instance().reset_peak();
+      world_.gop.fence();
+
+      const auto start = std::chrono::steady_clock::now();
+      op(term);
+      world_.gop.fence();
+      term.time += std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+
+      for(const auto& usage : TiledArray::sum_comm_usage(world_))
+        term.comm += usage.bytes_sent;
+      term.memory = std::max(term.memory,
+          double(TiledArray::max_memory_usage(world_).back().peak));
+    }
+  }; // class Benchmark
+
+  /// Evaluate an expression and add its estimated flops to a term
+  template <typename D>
+  void evaluate(Term& term, TiledArray::TSpArrayD& result, const std::string& vars,
+      const TiledArray::expressions::Expr<D>& expr)
+  {
+    term.flops += expr.estimate(result(vars)).flops();
+    result(vars) = expr;
+  }
+
+  /// Round a size up to a multiple of the block size
+  long round_up(const double size, const long block) {
+    return std::max(1l, long(std::ceil(size / double(block)))) * block;
+  }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    Config config;
+    for(int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if((arg == "-h") || (i + 1 == argc)) {
+        if(world.rank() == 0)
+          usage();
+        TiledArray::finalize();
+        return 0;
+      }
+      const std::string value = argv[++i];
+      if(arg == "-o")
+        config.occ = std::stol(value);
+      else if(arg == "-v")
+        config.vir = std::stol(value);
+      else if(arg == "-bo")
+        config.occ_block = std::stol(value);
+      else if(arg == "-bv")
+        config.vir_block = std::stol(value);
+      else if(arg == "-s")
+        config.sparsity = std::stod(value);
+      else if(arg == "-g")
+        config.irreps = std::stoul(value);
+      else if(arg == "-m")
+        config.weak = (value == "weak");
+      else if(arg == "-i")
+        config.iterations = std::stoul(value);
+      else if(arg == "-e")
+        config.threshold = std::stof(value);
+      else if(arg == "-c")
+        config.output = value;
+      else
+        throw std::runtime_error("unrecognized option " + arg);
+    }
+    if((config.occ <= 0l) || (config.vir <= 0l) || (config.occ_block <= 0l) ||
+        (config.vir_block <= 0l))
+      throw std::runtime_error("sizes and block sizes must be positive");
+    if((config.irreps == 0u) || (config.irreps > 8u) ||
+        (config.irreps & (config.irreps - 1u)))
+      throw std::runtime_error("the number of irreps must be 1, 2, 4, or 8");
+    if((config.sparsity < 0.0) || (config.sparsity >= 1.0))
+      throw std::runtime_error("sparsity must be in [0,1)");
+
+    // The work of CCSD is o^2 v^4, so weak scaling grows both spaces with the
+    // sixth root of the number of processes.
+    const double factor = (config.weak ? std::pow(double(world.size()), 1.0 / 6.0) : 1.0);
+    const Space occ(round_up(config.occ * factor, config.occ_block),
+        config.occ_block, config.irreps);
+    const Space vir(round_up(config.vir * factor, config.vir_block),
+        config.vir_block, config.irreps);
+    TiledArray::SparseShape<float>::threshold(config.threshold);
+    TiledArray::CommTracker::instance().enable();
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: synthetic CCSD benchmark..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of processes = " << world.size()
+                << "\nScaling mode        = " << (config.weak ? "weak" : "strong")
+                << "\nOccupied orbitals   = " << occ.size << " (block " << config.occ_block << ")"
+                << "\nVirtual orbitals    = " << vir.size << " (block " << config.vir_block << ")"
+                << "\nIrreps              = " << config.irreps
+                << "\nSparsity            = " << config.sparsity
+                << "\nIterations          = " << config.iterations << "\n";
+
+    // Construct the Fock matrix (without its diagonal), the antisymmetrized
+    // integrals, and the amplitudes
+    const Space* const o = &occ;
+    const Space* const v = &vir;
+    const double s = config.sparsity;
+    TiledArray::TSpArrayD f_oo = make_array(world, { o, o }, 1.0e-3, 1u, s);
+    TiledArray::TSpArrayD f_ov = make_array(world, { o, v }, 1.0e-3, 2u, s);
+    TiledArray::TSpArrayD f_vo = make_array(world, { v, o }, 1.0e-3, 3u, s);
+    TiledArray::TSpArrayD f_vv = make_array(world, { v, v }, 1.0e-3, 4u, s);
+    TiledArray::TSpArrayD v_oooo = make_array(world, { o, o, o, o }, 1.0e-2, 5u, s);
+    TiledArray::TSpArrayD v_ooov = make_array(world, { o, o, o, v }, 1.0e-2, 6u, s);
+    TiledArray::TSpArrayD v_oovv = make_array(world, { o, o, v, v }, 1.0e-2, 7u, s);
+    TiledArray::TSpArrayD v_ovvo = make_array(world, { o, v, v, o }, 1.0e-2, 8u, s);
+    TiledArray::TSpArrayD v_vovv = make_array(world, { v, o, v, v }, 1.0e-2, 9u, s);
+    TiledArray::TSpArrayD v_vvvv = make_array(world, { v, v, v, v }, 1.0e-2, 10u, s);
+    TiledArray::TSpArrayD t1 = make_array(world, { v, o }, 1.0e-3, 11u, s);
+    TiledArray::TSpArrayD t2 = make_array(world, { v, v, o, o }, 1.0e-3, 12u, s);
+
+    const TiledArray::TSpArrayD e_occ = make_energies(world, occ, -2.0, 1.0 / occ.size);
+    const TiledArray::TSpArrayD e_vir = make_energies(world, vir, 0.5, 2.0 / vir.size);
+    const TiledArray::EnergyDenominator<double> d1({ e_vir, e_occ }, { -1.0, 1.0 });
+    const TiledArray::EnergyDenominator<double> d2({ e_vir, e_vir, e_occ, e_occ },
+        { -1.0, -1.0, 1.0, 1.0 });
+    world.gop.fence();
+
+    Benchmark bench(world);
+    TiledArray::TSpArrayD tau, tau_t, Fae, Fmi, Fme, Wmnij, Wabef, Wmbej, r1, r2,
+        x_ab, x_ij, ladder_o, ladder_v, ring, z_ij, z_ab;
+    for(unsigned int iter = 0u; iter < config.iterations; ++iter) {
+      double energy = 0.0, r1_norm = 0.0, r2_norm = 0.0;
+
+      // Effective doubles
+      bench.run("tau", [&] (Term& term) {
+        evaluate(term, tau, "a,b,i,j", t2("a,b,i,j")
+            + t1("a,i") * t1("b,j") - t1("b,i") * t1("a,j"));
+        evaluate(term, tau_t, "a,b,i,j", t2("a,b,i,j")
+            + 0.5 * (t1("a,i") * t1("b,j") - t1("b,i") * t1("a,j")));
+      });
+
+      bench.run("energy", [&] (Term&) {
+        energy = f_ov("i,a").dot(t1("a,i")).get()
+            + 0.25 * v_oovv("i,j,a,b").dot(tau("a,b,i,j")).get();
+      });
+
+      // One-particle intermediates
+      bench.run("Fae", [&] (Term& term) {
+        evaluate(term, Fae, "a,e", f_vv("a,e") - 0.5 * f_ov("m,e") * t1("a,m")
+            + t1("f,m") * v_vovv("a,m,e,f")
+            - 0.5 * tau_t("a,f,m,n") * v_oovv("m,n,e,f"));
+      });
+      bench.run("Fmi", [&] (Term& term) {
+        evaluate(term, Fmi, "m,i", f_oo("m,i") + 0.5 * t1("e,i") * f_ov("m,e")
+            + t1("e,n") * v_ooov("m,n,i,e")
+            + 0.5 * tau_t("e,f,i,n") * v_oovv("m,n,e,f"));
+      });
+      bench.run("Fme", [&] (Term& term) {
+        evaluate(term, Fme, "m,e", f_ov("m,e") + t1("f,n") * v_oovv("m,n,e,f"));
+      });
+
+      // Two-particle intermediates
+      bench.run("Wmnij", [&] (Term& term) {
+        evaluate(term, Wmnij, "m,n,i,j", v_oooo("m,n,i,j")
+            + t1("e,j") * v_ooov("m,n,i,e") - t1("e,i") * v_ooov("m,n,j,e")
+            + 0.25 * tau("e,f,i,j") * v_oovv("m,n,e,f"));
+      });
+      bench.run("Wabef", [&] (Term& term) {
+        evaluate(term, Wabef, "a,b,e,f", v_vvvv("a,b,e,f")
+            - t1("b,m") * v_vovv("a,m,e,f") + t1("a,m") * v_vovv("b,m,e,f")
+            + 0.25 * tau("a,b,m,n") * v_oovv("m,n,e,f"));
+      });
+      bench.run("Wmbej", [&] (Term& term) {
+        evaluate(term, Wmbej, "m,b,e,j", v_ovvo("m,b,e,j")
+            - t1("f,j") * v_vovv("b,m,e,f") + t1("b,n") * v_ooov("m,n,j,e")
+            - (0.5 * t2("f,b,j,n") + t1("f,j") * t1("b,n")) * v_oovv("m,n,e,f"));
+      });
+
+      // Singles residual
+      bench.run("T1", [&] (Term& term) {
+        evaluate(term, r1, "a,i", f_vo("a,i") + t1("e,i") * Fae("a,e")
+            - t1("a,m") * Fmi("m,i") + t2("a,e,i,m") * Fme("m,e")
+            + t1("f,n") * v_ovvo("n,a,f,i") + 0.5 * t2("e,f,i,m") * v_vovv("a,m,e,f")
+            + 0.5 * t2("a,e,m,n") * v_ooov("n,m,i,e"));
+      });
+
+      // Doubles residual
+      bench.run("T2 Fock", [&] (Term& term) {
+        evaluate(term, x_ab, "a,b,i,j", t2("a,e,i,j")
+            * (Fae("b,e") - 0.5 * t1("b,m") * Fme("m,e")));
+        evaluate(term, x_ij, "a,b,i,j", t2("a,b,i,m")
+            * (Fmi("m,j") + 0.5 * t1("e,j") * Fme("m,e")));
+      });
+      bench.run("T2 ladder oooo", [&] (Term& term) {
+        evaluate(term, ladder_o, "a,b,i,j", 0.5 * tau("a,b,m,n") * Wmnij("m,n,i,j"));
+      });
+      bench.run("T2 ladder vvvv", [&] (Term& term) {
+        evaluate(term, ladder_v, "a,b,i,j", 0.5 * tau("e,f,i,j") * Wabef("a,b,e,f"));
+      });
+      bench.run("T2 ring", [&] (Term& term) {
+        evaluate(term, ring, "a,b,i,j", t2("a,e,i,m") * Wmbej("m,b,e,j")
+            - t1("e,i") * t1("a,m") * v_ovvo("m,b,e,j"));
+      });
+      bench.run("T2 singles", [&] (Term& term) {
+        evaluate(term, z_ij, "a,b,i,j", t1("e,i") * v_vovv("e,j,a,b"));
+        evaluate(term, z_ab, "a,b,i,j", t1("a,m") * v_ooov("i,j,m,b"));
+      });
+      bench.run("T2 sum", [&] (Term& term) {
+        evaluate(term, r2, "a,b,i,j", v_oovv("i,j,a,b")
+            + x_ab("a,b,i,j") - x_ab("b,a,i,j") - x_ij("a,b,i,j") + x_ij("a,b,j,i")
+            + ladder_o("a,b,i,j") + ladder_v("a,b,i,j")
+            + ring("a,b,i,j") - ring("b,a,i,j") - ring("a,b,j,i") + ring("b,a,j,i")
+            + z_ij("a,b,i,j") - z_ij("a,b,j,i") - z_ab("a,b,i,j") + z_ab("b,a,i,j"));
+      });
+
+      // Jacobi update of the amplitudes
+      bench.run("update", [&] (Term&) {
+        r1_norm = d1(r1);
+        r2_norm = d2(r2);
+        t1 = r1;
+        t2 = r2;
+      });
+
+      if(world.rank() == 0)
+        std::cout << "Iteration " << iter << ": energy = " << std::setprecision(12)
+                  << energy << ", |r1| = " << r1_norm << ", |r2| = " << r2_norm << "\n";
+    }
+
+    // Report the measurements of each term, per iteration
+    if(world.rank() == 0) {
+      const double n = config.iterations;
+      double total_time = 0.0, total_flops = 0.0, total_comm = 0.0, peak = 0.0;
+      std::cout << "\n" << std::left << std::setw(16) << "term" << std::right
+                << std::setw(12) << "time (s)" << std::setw(12) << "GFLOP"
+                << std::setw(12) << "GFLOP/s" << std::setw(12) << "comm (MB)"
+                << std::setw(14) << "memory (MB)" << "\n" << std::fixed;
+      for(const Term& term : bench.terms()) {
+        std::cout << std::left << std::setw(16) << term.name << std::right
+                  << std::setprecision(4) << std::setw(12) << term.time / n
+                  << std::setprecision(3) << std::setw(12) << term.flops / n * 1.0e-9
+                  << std::setw(12) << (term.time > 0.0 ? term.flops / term.time * 1.0e-9 : 0.0)
+                  << std::setw(12) << term.comm / n / 1048576.0
+                  << std::setw(14) << term.memory / 1048576.0 << "\n";
+        total_time += term.time;
+        total_flops += term.flops;
+        total_comm += term.comm;
+        peak = std::max(peak, term.memory);
+      }
+      std::cout << std::left << std::setw(16) << "total" << std::right
+                << std::setprecision(4) << std::setw(12) << total_time / n
+                << std::setprecision(3) << std::setw(12) << total_flops / n * 1.0e-9
+                << std::setw(12) << (total_time > 0.0 ? total_flops / total_time * 1.0e-9 : 0.0)
+                << std::setw(12) << total_comm / n / 1048576.0
+                << std::setw(14) << peak / 1048576.0 << "\n";
+
+      if(! config.output.empty()) {
+        std::ofstream file(config.output, std::ios::app);
+        if(file.tellp() == 0)
+          file << "mode,processes,occ,vir,irreps,sparsity,term,time,flops,comm,memory\n";
+        for(const Term& term : bench.terms())
+          file << (config.weak ? "weak" : "strong") << ',' << world.size() << ','
+               << occ.size << ',' << vir.size << ',' << config.irreps << ','
+               << config.sparsity << ',' << term.name << ',' << term.time / n << ','
+               << term.flops / n << ',' << term.comm / n << ',' << term.memory << '\n';
+        std::cout << "Results appended to " << config.output << "\n";
+      }
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
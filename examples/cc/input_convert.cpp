@@ -0,0 +1,48 @@
+/*
+ * This file is a part of TiledArray.
+ * Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <iostream>
+#include <tiledarray.h>
+#include "input_data.h"
+
+int main(int argc, char** argv) {
+  // Initialize runtime
+  TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+  if(argc < 3) {
+    if(world.rank() == 0)
+      std::cout << "Usage: " << argv[0] << " text_input binary_output\n"
+                << "Converts the text input of ccd and ccsd into the binary format.\n";
+    TiledArray::finalize();
+    return 0;
+  }
+
+  // The conversion is serial, so only one process writes the file.
+  if(world.rank() == 0) {
+    std::cout << "Reading input...";
+    InputData data((std::string(argv[1])));
+    std::cout << " done.\nWriting binary input...";
+    data.save(argv[2]);
+    std::cout << " done.\n";
+  }
+
+  world.gop.fence();
+  TiledArray::finalize();
+  return 0;
+}
@@ -18,8 +18,61 @@
  */
 
 #include "input_data.h"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <map>
 #include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+  /// Magic number of the binary input format
+  const char binary_magic[8] = { 'T', 'A', 'C', 'C', 'I', 'N', 'P', '1' };
+
+  /// Sequential reader of the mapped binary input
+  class BinaryReader {
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_;
+
+  public:
+    BinaryReader(const char* data, const std::size_t size) :
+      data_(data), size_(size), pos_(0ul)
+    { }
+
+    /// Skip \c n bytes, and return a pointer to the first one
+    const char* skip(const std::size_t n) {
+      if(pos_ + n > size_)
+        TA_EXCEPTION("InputData: binary input is truncated.");
+      const char* const result = data_ + pos_;
+      // Keep the following data 8 byte aligned
+      pos_ += (n + 7ul) & ~std::size_t(7ul);
+      return result;
+    }
+
+    std::uint64_t get() {
+      std::uint64_t result;
+      std::memcpy(& result, skip(sizeof(result)), sizeof(result));
+      return result;
+    }
+  }; // class BinaryReader
+
+  /// Write data to a binary input file, padded to 8 bytes
+  void write_binary(std::ostream& output, const void* data, const std::size_t n) {
+    static const char padding[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    output.write(static_cast<const char*>(data), n);
+    output.write(padding, ((n + 7ul) & ~std::size_t(7ul)) - n);
+  }
+
+  void write_binary(std::ostream& output, const std::uint64_t value) {
+    write_binary(output, & value, sizeof(value));
+  }
+
+} // namespace
 
 TiledArray::TiledRange1
 InputData::make_trange1(const obs_mosym::const_iterator& begin, obs_mosym::const_iterator first, obs_mosym::const_iterator last) {
@@ -81,7 +134,174 @@ InputData::trange(const Spin s1, const Spin s2, const RangeOV ov1, const RangeOV
   return TiledArray::TiledRange(tr_list.begin(), tr_list.end());
 }
 
-InputData::InputData(std::ifstream& input) {
+TiledArray::TiledRange1 InputData::full_trange1(const Spin s) const {
+  const TiledArray::TiledRange1 occ_tr1 = trange(s, occ, occ).data()[0];
+  const TiledArray::TiledRange1 vir_tr1 = trange(s, vir, vir).data()[0];
+
+  std::vector<std::size_t> tiles;
+  for(std::size_t t = 0ul; t < occ_tr1.tiles_range().second; ++t)
+    tiles.push_back(occ_tr1.tile(t).first);
+  for(std::size_t t = 0ul; t < vir_tr1.tiles_range().second; ++t)
+    tiles.push_back(vir_tr1.tile(t).first);
+  tiles.push_back(nmo_);
+
+  return TiledArray::TiledRange1(tiles.begin(), tiles.end());
+}
+
+TiledArray::TiledRange InputData::v_ab_trange() const {
+  const std::array<TiledArray::TiledRange1, 4> tr_list = {{
+      full_trange1(alpha), full_trange1(beta), full_trange1(alpha), full_trange1(beta) }};
+
+  return TiledArray::TiledRange(tr_list.begin(), tr_list.end());
+}
+
+const InputData::TileRecord* InputData::find_v_ab_tile(const std::size_t ordinal) const {
+  const TileRecord* const last = v_ab_tiles_ + v_ab_ntiles_;
+  const TileRecord* const it = std::lower_bound(v_ab_tiles_, last, ordinal,
+      [] (const TileRecord& record, const std::size_t i) { return record.ordinal < i; });
+  return ((it != last) && (it->ordinal == ordinal) ? it : nullptr);
+}
+
+InputData::InputData(std::ifstream& input) :
+  map_(), v_ab_tiles_(nullptr), v_ab_ntiles_(0ul), v_ab_data_(nullptr)
+{
+  read_text(input);
+}
+
+InputData::InputData(const std::string& file_name) :
+  map_(), v_ab_tiles_(nullptr), v_ab_ntiles_(0ul), v_ab_data_(nullptr)
+{
+  if(is_binary(file_name)) {
+    read_binary(file_name);
+  } else {
+    std::ifstream input(file_name.c_str());
+    if(input.fail())
+      TA_EXCEPTION("InputData: unable to open the input file.");
+    read_text(input);
+  }
+}
+
+bool InputData::is_binary(const std::string& file_name) {
+  std::ifstream input(file_name.c_str(), std::ios::binary);
+  char magic[sizeof(binary_magic)];
+  return input.read(magic, sizeof(magic)) &&
+      std::equal(magic, magic + sizeof(magic), binary_magic);
+}
+
+void InputData::read_binary(const std::string& file_name) {
+  // Map the file
+  const int fd = open(file_name.c_str(), O_RDONLY);
+  if(fd < 0)
+    TA_EXCEPTION("InputData: unable to open the input file.");
+  struct stat st;
+  if(fstat(fd, & st) != 0) {
+    close(fd);
+    TA_EXCEPTION("InputData: unable to read the input file.");
+  }
+  const std::size_t size = st.st_size;
+  void* const data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED)
+    TA_EXCEPTION("InputData: unable to map the input file.");
+  map_ = std::shared_ptr<const char>(static_cast<const char*>(data),
+      [size] (const char* p) { munmap(const_cast<char*>(p), size); });
+
+  BinaryReader reader(map_.get(), size);
+  reader.skip(sizeof(binary_magic));
+
+  // Read the metadata
+  const std::size_t name_size = reader.get();
+  name_.assign(reader.skip(name_size), name_size);
+  nirreps_ = reader.get();
+  nmo_ = reader.get();
+  nocc_act_alpha_ = reader.get();
+  nocc_act_beta_ = reader.get();
+  nvir_act_alpha_ = reader.get();
+  nvir_act_beta_ = reader.get();
+  obs_mosym_alpha_.resize(nmo_, 0);
+  for(obs_mosym::iterator it = obs_mosym_alpha_.begin(); it != obs_mosym_alpha_.end(); ++it)
+    *it = reader.get();
+  obs_mosym_beta_.resize(nmo_, 0);
+  for(obs_mosym::iterator it = obs_mosym_beta_.begin(); it != obs_mosym_beta_.end(); ++it)
+    *it = reader.get();
+
+  // Read the Fock matrix elements
+  f_.resize(reader.get());
+  for(array2d::iterator it = f_.begin(); it != f_.end(); ++it) {
+    it->first[0] = reader.get();
+    it->first[1] = reader.get();
+    std::memcpy(& it->second, reader.skip(sizeof(double)), sizeof(double));
+  }
+
+  // Find the v_ab tile records and data, which are read when the arrays are
+  // constructed
+  v_ab_ntiles_ = reader.get();
+  v_ab_tiles_ = reinterpret_cast<const TileRecord*>(
+      reader.skip(v_ab_ntiles_ * sizeof(TileRecord)));
+  const std::size_t v_ab_size = reader.get();
+  v_ab_data_ = reinterpret_cast<const double*>(reader.skip(v_ab_size * sizeof(double)));
+}
+
+void InputData::save(const std::string& file_name) const {
+  if(map_)
+    TA_EXCEPTION("InputData: binary input cannot be saved again.");
+  std::ofstream output(file_name.c_str(), std::ios::binary);
+  if(output.fail())
+    TA_EXCEPTION("InputData: unable to open the output file.");
+
+  // Write the metadata
+  write_binary(output, binary_magic, sizeof(binary_magic));
+  write_binary(output, name_.size());
+  write_binary(output, name_.data(), name_.size());
+  write_binary(output, nirreps_);
+  write_binary(output, nmo_);
+  write_binary(output, nocc_act_alpha_);
+  write_binary(output, nocc_act_beta_);
+  write_binary(output, nvir_act_alpha_);
+  write_binary(output, nvir_act_beta_);
+  for(obs_mosym::const_iterator it = obs_mosym_alpha_.begin(); it != obs_mosym_alpha_.end(); ++it)
+    write_binary(output, *it);
+  for(obs_mosym::const_iterator it = obs_mosym_beta_.begin(); it != obs_mosym_beta_.end(); ++it)
+    write_binary(output, *it);
+
+  // Write the Fock matrix elements
+  write_binary(output, f_.size());
+  for(array2d::const_iterator it = f_.begin(); it != f_.end(); ++it) {
+    write_binary(output, it->first[0]);
+    write_binary(output, it->first[1]);
+    write_binary(output, & it->second, sizeof(double));
+  }
+
+  // Sort the v_ab elements into tiles
+  const TiledArray::TiledRange tr = v_ab_trange();
+  std::map<std::size_t, TiledArray::TSpArrayD::value_type> tiles;
+  for(array4d::const_iterator it = v_ab_.begin(); it != v_ab_.end(); ++it) {
+    const std::size_t ordinal = tr.tiles_range().ordinal(tr.element_to_tile(it->first));
+    TiledArray::TSpArrayD::value_type& tile = tiles[ordinal];
+    if(tile.empty())
+      tile = TiledArray::TSpArrayD::value_type(tr.make_tile_range(ordinal), 0.0);
+    tile[it->first] = it->second;
+  }
+
+  // Write the v_ab tile records and data
+  std::vector<TileRecord> records;
+  records.reserve(tiles.size());
+  std::size_t offset = 0ul;
+  for(const auto& tile : tiles) {
+    records.push_back(TileRecord{ tile.first, offset, tile.second.norm() });
+    offset += tile.second.size();
+  }
+  write_binary(output, records.size());
+  write_binary(output, records.data(), records.size() * sizeof(TileRecord));
+  write_binary(output, offset);
+  for(const auto& tile : tiles)
+    write_binary(output, tile.second.data(), tile.second.size() * sizeof(double));
+
+  if(output.fail())
+    TA_EXCEPTION("InputData: unable to write the output file.");
+}
+
+void InputData::read_text(std::istream& input) {
   std::string label;
   input >> label >> name_;
 //  std::cout << label << name_ << "\n";
@@ -171,6 +391,39 @@ InputData::make_v_ab(TiledArray::World& w, const RangeOV ov1, const RangeOV ov2,
   // Construct the array
   TiledArray::TiledRange tr = trange(alpha, beta, ov1, ov2, ov3, ov4);
 //  std::cout << tr << "\n";
+  if(map_) {
+    // Get the tile norms from the binary input
+    const TiledArray::TiledRange full_tr = v_ab_trange();
+    TiledArray::Tensor<float> tile_norms(tr.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < tr.tiles_range().volume(); ++i) {
+      const TiledArray::Range range = tr.make_tile_range(i);
+      const TileRecord* const record =
+          find_v_ab_tile(full_tr.tiles_range().ordinal(full_tr.element_to_tile(range.lobound())));
+      if(record)
+        tile_norms[i] = record->norm;
+    }
+    TiledArray::TSpArrayD v_ab(w, tr, TiledArray::SparseShape<float>(tile_norms, tr));
+
+    // Copy the local tiles from the mapped file with parallel tasks. The
+    // tiles of tr are tiles of full_tr, so the data is copied as is.
+    const std::shared_ptr<const char> map = map_;
+    const TileRecord* const first = v_ab_tiles_;
+    const TileRecord* const last = v_ab_tiles_ + v_ab_ntiles_;
+    const double* const data = v_ab_data_;
+    v_ab.init_tiles([=] (const TiledArray::Range& range) {
+      const std::size_t ordinal =
+          full_tr.tiles_range().ordinal(full_tr.element_to_tile(range.lobound()));
+      const TileRecord* const record = std::lower_bound(first, last, ordinal,
+          [] (const TileRecord& r, const std::size_t i) { return r.ordinal < i; });
+      TA_ASSERT((record != last) && (record->ordinal == ordinal));
+      TA_ASSERT(full_tr.make_tile_range(ordinal) == range);
+      const double* const tile_data = data + record->offset;
+      return TiledArray::TSpArrayD::value_type(range, tile_data);
+    });
+
+    return v_ab;
+  }
+
   TiledArray::TSpArrayD v_ab(w, tr,make_sparse_shape(tr, v_ab_));
 
   // Initialize tiles
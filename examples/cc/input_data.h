@@ -23,6 +23,9 @@
 #include <vector>
 #include <iosfwd>
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <tiledarray.h>
 
 /// Spin enum type
@@ -38,12 +41,25 @@ typedef enum {
 } RangeOV;
 
 /// Read input file and generate tensors for the algorithm
+
+/// The input is either the text file produced by the integral program, or a
+/// binary file written by \c save() . The binary file stores the two-electron
+/// integrals tile by tile, using the tiling of \c make_v_ab() , together with
+/// the tile norms. It is memory mapped, so each process reads only its local
+/// tiles, and the tiles are copied by parallel tasks.
 class InputData {
 public:
   typedef std::vector<std::size_t> obs_mosym;
   typedef std::vector<std::pair<std::array<std::size_t, 2>, double> > array2d;
   typedef std::vector<std::pair<std::array<std::size_t, 4>, double> > array4d;
 
+  /// Non-zero tile of the binary v_ab integrals
+  struct TileRecord {
+    std::uint64_t ordinal; ///< Ordinal index of the tile in \c v_ab_trange()
+    std::uint64_t offset; ///< Offset of the tile data, in elements
+    double norm; ///< Frobenius norm of the tile
+  }; // struct TileRecord
+
 private:
   std::string name_;
   unsigned long nirreps_;
@@ -57,6 +73,18 @@ private:
   array2d f_;
   array4d v_ab_;
 
+  // Memory mapped binary input (empty for text input)
+  std::shared_ptr<const char> map_;
+  const TileRecord* v_ab_tiles_;
+  std::size_t v_ab_ntiles_;
+  const double* v_ab_data_;
+
+  void read_text(std::istream& input);
+
+  void read_binary(const std::string& file_name);
+
+  static bool is_binary(const std::string& file_name);
+
   template <typename I>
   struct predicate {
     typedef bool result_type;
@@ -78,6 +106,21 @@ private:
   TiledArray::TiledRange trange(const Spin s1, const Spin s2, const RangeOV ov1, const RangeOV ov2,
       const RangeOV ov3, const RangeOV ov4) const;
 
+  /// Tiled range of all occupied and virtual indices of spin \c s
+  TiledArray::TiledRange1 full_trange1(const Spin s) const;
+
+  /// Tiled range of the v_ab integrals for all occupied and virtual indices
+
+  /// The tiles of the arrays constructed by \c make_v_ab() are tiles of this
+  /// range.
+  TiledArray::TiledRange v_ab_trange() const;
+
+  /// Find a tile of the binary v_ab integrals
+
+  /// \param ordinal The ordinal index of the tile in \c v_ab_trange()
+  /// \return The tile record, or \c nullptr if the tile is zero
+  const TileRecord* find_v_ab_tile(const std::size_t ordinal) const;
+
   template <typename R, typename T>
   TiledArray::SparseShape<float> make_sparse_shape(const R& r, const T& t) const {
     TiledArray::Tensor<float> tile_norms(r.tiles_range(), 0.0f);
@@ -99,6 +142,19 @@ public:
 
   InputData(std::ifstream& input);
 
+  /// Read a text or binary input file
+
+  /// \param file_name The input file name
+  /// \throw TiledArray::Exception When the file cannot be read
+  explicit InputData(const std::string& file_name);
+
+  /// Write the input data in the binary format
+
+  /// \param file_name The output file name
+  /// \throw TiledArray::Exception When the data was read from a binary file
+  /// or the file cannot be written
+  void save(const std::string& file_name) const;
+
   std::string name() const { return name_; }
 
   TiledArray::TSpArrayD
@@ -140,6 +196,10 @@ public:
     array2d().swap(f_);
     v_ab_.clear();
     array4d().swap(v_ab_);
+    map_.reset();
+    v_ab_tiles_ = nullptr;
+    v_ab_ntiles_ = 0ul;
+    v_ab_data_ = nullptr;
   }
 };
 
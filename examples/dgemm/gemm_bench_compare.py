@@ -0,0 +1,53 @@
+# Compare two ta_gemm_bench result files
+#
+# Usage: python gemm_bench_compare.py baseline.json current.json [tolerance]
+#
+# Cases are matched by matrix size, block size, and sparsity. A case is
+# reported as a regression when its GFLOP/s drop, or its communication or
+# memory grow, by more than tolerance (default 0.05 = 5%). The exit status
+# is 1 if any regression is found.
+
+import json, sys
+
+def load(fn):
+    with open(fn) as f:
+        data = json.load(f)
+    cases = {}
+    for r in data["results"]:
+        cases[(r["matrix_size"], r["block_size"], r["sparsity"])] = r
+    return data, cases
+
+if len(sys.argv) < 3:
+    print("Usage: python gemm_bench_compare.py baseline.json current.json [tolerance]")
+    sys.exit(2)
+
+tolerance = float(sys.argv[3]) if len(sys.argv) > 3 else 0.05
+base, base_cases = load(sys.argv[1])
+curr, curr_cases = load(sys.argv[2])
+
+if base["nodes"] != curr["nodes"] or base["threads"] != curr["threads"]:
+    print("Warning: the runs used different numbers of nodes or threads")
+
+# (key, larger is better)
+metrics = [("gflops", True), ("comm_bytes", False), ("memory_mb", False)]
+
+regressions = 0
+print("%6s %6s %8s %12s %12s %12s" % ("n", "block", "sparsity", "metric", "baseline", "current"))
+for key in sorted(base_cases):
+    if key not in curr_cases:
+        continue
+    b, c = base_cases[key], curr_cases[key]
+    for metric, larger_is_better in metrics:
+        if b[metric] == 0:
+            continue
+        change = (c[metric] - b[metric]) / b[metric]
+        if not larger_is_better:
+            change = -change
+        flag = ""
+        if change < -tolerance:
+            flag = "  REGRESSION"
+            regressions += 1
+        print("%6d %6d %8.2f %12s %12.4g %12.4g%s" % (key + (metric, b[metric], c[metric], flag)))
+
+print("%d regression(s) found" % regressions)
+sys.exit(1 if regressions else 0)
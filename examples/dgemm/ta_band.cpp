@@ -18,8 +18,39 @@
  */
 
 #include <iostream>
+#include <string>
 #include <tiledarray.h>
 
+// Multiply two matrices repeatedly and print the timings
+template <typename Array>
+void run_gemm(TiledArray::World& world, const Array& a, const Array& b,
+    const long repeat)
+{
+  Array c;
+
+  // Start clock
+  world.gop.fence();
+  const double wall_time_start = madness::wall_time();
+
+  // Do matrix multiplication
+  for(int i = 0; i < repeat; ++i) {
+    c("m,n") = a("m,k") * b("k,n");
+    world.gop.fence();
+    if(world.rank() == 0)
+      std::cout << "Iteration " << i + 1 << "\n";
+  }
+
+  // Stop clock
+  const double wall_time_stop = madness::wall_time();
+
+  // Print results
+  const long flop = 2.0 * c("m,n").sum().get();
+  if(world.rank() == 0) {
+    std::cout << "Average wall time = " << (wall_time_stop - wall_time_start) / double(repeat)
+        << "\nAverage GFLOPS = " << double(repeat) * double(flop) / (wall_time_stop - wall_time_start) / 1.0e9 << "\n";
+  }
+}
+
 int main(int argc, char** argv) {
   int rc = 0;
 
@@ -30,7 +61,7 @@ int main(int argc, char** argv) {
 
     // Get command line arguments
     if(argc < 2) {
-      std::cout << "Usage: ta_band matrix_size block_size band_width [repetitions]\n";
+      std::cout << "Usage: ta_band matrix_size block_size band_width [repetitions] [dense|band]\n";
       return 0;
     }
     const long matrix_size = atol(argv[1]);
@@ -61,6 +92,11 @@ int main(int argc, char** argv) {
       std::cerr << "Error: number of repetitions must be greater than zero.\n";
       return 1;
     }
+    const std::string tile_type = (argc >= 6 ? argv[5] : "dense");
+    if((tile_type != "dense") && (tile_type != "band")) {
+      std::cerr << "Error: tile type must be dense or band.\n";
+      return 1;
+    }
 
     const long num_blocks = matrix_size / block_size;
     std::size_t block_count = 0;
@@ -91,45 +127,57 @@ int main(int argc, char** argv) {
 
     TiledArray::SparseShape<float>::threshold(0.5);
 
-    // Construct shape
-    TiledArray::Tensor<float> shape_tensor(trange.tiles_range(), 0.0f);
-    for(long i = 0l; i < num_blocks; ++i) {
-      long j = std::max<long>(i - band_width + 1, 0);
-      const long j_end = std::min<long>(i + band_width - 1, num_blocks);
-      long ij = i * num_blocks + j;
-      for(; j < j_end; ++j, ++ij)
-        shape_tensor[ij] = 1.0;
-    }
-
-    TiledArray::SparseShape<float> shape(shape_tensor, trange);
-
-    // Construct and initialize arrays
-    TiledArray::TSpArrayD a(world, trange, shape);
-    TiledArray::TSpArrayD b(world, trange, shape);
-    TiledArray::TSpArrayD c(world, trange);
-    a.fill(1.0);
-    b.fill(1.0);
-
-    // Start clock
-    world.gop.fence();
-    const double wall_time_start = madness::wall_time();
-
-    // Do matrix multiplication
-    for(int i = 0; i < repeat; ++i) {
-      c("m,n") = a("m,k") * b("k,n");
-      world.gop.fence();
-      if(world.rank() == 0)
-        std::cout << "Iteration " << i + 1 << "\n";
-    }
-
-    // Stop clock
-    const double wall_time_stop = madness::wall_time();
-
-    // Print results
-    const long flop = 2.0 * c("m,n").sum().get();
-    if(world.rank() == 0) {
-      std::cout << "Average wall time = " << (wall_time_stop - wall_time_start) / double(repeat)
-          << "\nAverage GFLOPS = " << double(repeat) * double(flop) / (wall_time_stop - wall_time_start) / 1.0e9 << "\n";
+    if(tile_type == "dense") {
+      // Construct shape
+      TiledArray::Tensor<float> shape_tensor(trange.tiles_range(), 0.0f);
+      for(long i = 0l; i < num_blocks; ++i) {
+        long j = std::max<long>(i - band_width + 1, 0);
+        const long j_end = std::min<long>(i + band_width - 1, num_blocks);
+        long ij = i * num_blocks + j;
+        for(; j < j_end; ++j, ++ij)
+          shape_tensor[ij] = 1.0;
+      }
+
+      TiledArray::SparseShape<float> shape(shape_tensor, trange);
+
+      // Construct and initialize arrays
+      TiledArray::TSpArrayD a(world, trange, shape);
+      TiledArray::TSpArrayD b(world, trange, shape);
+      a.fill(1.0);
+      b.fill(1.0);
+
+      run_gemm(world, a, b, repeat);
+    } else {
+      // The element band covers the diagonals within band_width - 1 blocks
+      // of the main diagonal, and only the band is stored in the tiles
+      typedef TiledArray::BandTensor<double> BandD;
+      typedef TiledArray::DistArray<BandD, TiledArray::SparsePolicy> BandArray;
+      const std::size_t half_width = std::max(band_width - 1l, 0l) * block_size;
+
+      // Construct shape
+      TiledArray::Tensor<float> shape_tensor(trange.tiles_range(), 0.0f);
+      for(long i = 0l; i < num_blocks; ++i) {
+        long j = std::max<long>(i - band_width + 1, 0);
+        const long j_end = std::min<long>(i + band_width, num_blocks);
+        long ij = i * num_blocks + j;
+        for(; j < j_end; ++j, ++ij)
+          shape_tensor[ij] = 1.0;
+      }
+
+      TiledArray::SparseShape<float> shape(shape_tensor, trange);
+
+      // Construct and initialize arrays
+      BandArray a(world, trange, shape);
+      BandArray b(world, trange, shape);
+      for(auto it = a.pmap()->begin(); it != a.pmap()->end(); ++it) {
+        if(a.is_zero(*it))
+          continue;
+        const TiledArray::Range range = trange.make_tile_range(*it);
+        a.set(*it, BandD(range, half_width, half_width, 1.0));
+        b.set(*it, BandD(range, half_width, half_width, 1.0));
+      }
+
+      run_gemm(world, a, b, repeat);
     }
 
     TiledArray::finalize();
@@ -0,0 +1,321 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <sys/resource.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+
+// Matrix multiply benchmark harness
+//
+// Runs c("m,n") = a("m,k") * b("k,n") for every combination of the given
+// matrix sizes, block sizes, and sparsities on the current set of nodes, and
+// writes the results to a JSON file. Run it with different numbers of MPI
+// processes to scan node counts, and compare the JSON files of two versions
+// with gemm_bench_compare.py .
+
+namespace {
+
+  /// Benchmark parameters
+  struct Config {
+    std::vector<long> sizes { 2048 };
+    std::vector<long> blocks { 128, 256 };
+    std::vector<double> sparsities { 0.0, 0.5, 0.9 };
+    long repeat = 5;
+    long blas_size = 2048;
+    std::string output = "ta_gemm_bench.json";
+  }; // struct Config
+
+  /// The result of one benchmark case
+  struct Result {
+    long matrix_size;
+    long block_size;
+    double sparsity;
+    double flop; ///< Floating point operations per multiplication
+    double time_avg; ///< Average wall time (s)
+    double time_min; ///< Minimum wall time (s)
+    double gflops; ///< GFLOP/s of the average time
+    double efficiency; ///< gflops / (nodes * single-node BLAS GFLOP/s)
+    double comm_bytes; ///< Bytes sent by all nodes per multiplication
+    double memory_mb; ///< Maximum resident set size of any node (MB)
+  }; // struct Result
+
+  template <typename T>
+  std::vector<T> parse_list(const std::string& str) {
+    std::vector<T> result;
+    std::stringstream ss(str);
+    std::string item;
+    while(std::getline(ss, item, ','))
+      result.push_back(T(std::stod(item)));
+    return result;
+  }
+
+  void usage() {
+    std::cout << "Usage: ta_gemm_bench [-n sizes] [-b block_sizes] [-s sparsities]\n"
+              << "                     [-r repetitions] [-l blas_size] [-o output.json]\n"
+              << "  sizes, block_sizes, and sparsities are comma-separated lists;\n"
+              << "  sparsity is the fraction of zero blocks (0 = dense array).\n";
+  }
+
+  /// Maximum resident set size of this process in MB
+  double memory_high_water() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return double(usage.ru_maxrss) / 1024.0;
+  }
+
+  /// Bytes sent by this process with active messages
+  double bytes_sent() { return double(madness::RMI::get_stats().nbyte_sent); }
+
+  /// Measure the GFLOP/s of a local matrix multiply
+  double blas_gflops(const long n) {
+    std::vector<double> a(n * n, 1.0), b(n * n, 1.0), c(n * n, 0.0);
+    TiledArray::math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans,
+        n, n, n, 1.0, a.data(), n, b.data(), n, 0.0, c.data(), n);
+    const double start = madness::wall_time();
+    TiledArray::math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans,
+        n, n, n, 1.0, a.data(), n, b.data(), n, 0.0, c.data(), n);
+    const double time = madness::wall_time() - start;
+    return 2.0 * double(n) * double(n) * double(n) / time / 1.0e9;
+  }
+
+  /// Construct a block-sparse shape
+
+  /// The pattern only depends on \c seed , so the same blocks are non-zero on
+  /// every node and in every run.
+  TiledArray::Tensor<float> make_norms(const TiledArray::TiledRange& trange,
+      const long block_size, const double sparsity, const unsigned int seed)
+  {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    TiledArray::Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < norms.size(); ++i)
+      if(distribution(generator) >= sparsity)
+        norms[i] = float(block_size);
+    return norms;
+  }
+
+  /// Count the floating point operations of a block-sparse multiply
+  double count_flop(const TiledArray::Tensor<float>& a,
+      const TiledArray::Tensor<float>& b, const long block_size)
+  {
+    const std::size_t nb = a.range().extent_data()[0];
+    std::size_t products = 0ul;
+    for(std::size_t i = 0ul; i < nb; ++i)
+      for(std::size_t k = 0ul; k < nb; ++k)
+        if(a[i * nb + k] > 0.0f)
+          for(std::size_t j = 0ul; j < nb; ++j)
+            if(b[k * nb + j] > 0.0f)
+              ++products;
+    return 2.0 * double(products) * double(block_size) * double(block_size)
+        * double(block_size);
+  }
+
+  /// Time the multiplication of two arrays
+  template <typename Array>
+  void run(TiledArray::World& world, Array& a, Array& b, const Config& config,
+      Result& result)
+  {
+    Array c;
+    a.fill(1.0);
+    b.fill(1.0);
+    world.gop.fence();
+
+    // Warm up
+    c("m,n") = a("m,k") * b("k,n");
+    world.gop.fence();
+
+    double total_time = 0.0, min_time = 0.0;
+    const double bytes_start = bytes_sent();
+    for(long i = 0l; i < config.repeat; ++i) {
+      const double start = madness::wall_time();
+      c("m,n") = a("m,k") * b("k,n");
+      world.gop.fence();
+      const double time = madness::wall_time() - start;
+      total_time += time;
+      min_time = (i == 0l ? time : std::min(min_time, time));
+    }
+    double comm_bytes = bytes_sent() - bytes_start;
+    double memory = memory_high_water();
+    world.gop.sum(comm_bytes);
+    world.gop.max(memory);
+
+    result.time_avg = total_time / double(config.repeat);
+    result.time_min = min_time;
+    result.gflops = result.flop / result.time_avg / 1.0e9;
+    result.comm_bytes = comm_bytes / double(config.repeat);
+    result.memory_mb = memory;
+  }
+
+  void write_json(std::ostream& os, TiledArray::World& world,
+      const double blas_rate, const std::vector<Result>& results)
+  {
+    os << "{\n"
+       << "  \"benchmark\": \"ta_gemm_bench\",\n"
+       << "  \"version\": \"" << TILEDARRAY_VERSION << "\",\n"
+       << "  \"revision\": \"" << TILEDARRAY_REVISION << "\",\n"
+       << "  \"nodes\": " << world.size() << ",\n"
+       << "  \"threads\": " << madness::ThreadPool::size() + 1 << ",\n"
+       << "  \"blas_gflops\": " << blas_rate << ",\n"
+       << "  \"results\": [";
+    for(std::size_t i = 0ul; i < results.size(); ++i) {
+      const Result& r = results[i];
+      os << (i ? ",\n" : "\n")
+         << "    { \"matrix_size\": " << r.matrix_size
+         << ", \"block_size\": " << r.block_size
+         << ", \"sparsity\": " << r.sparsity
+         << ", \"flop\": " << r.flop
+         << ", \"time_avg\": " << r.time_avg
+         << ", \"time_min\": " << r.time_min
+         << ", \"gflops\": " << r.gflops
+         << ", \"efficiency\": " << r.efficiency
+         << ", \"comm_bytes\": " << r.comm_bytes
+         << ", \"memory_mb\": " << r.memory_mb << " }";
+    }
+    os << "\n  ]\n}\n";
+  }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    Config config;
+    for(int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if((arg == "-h") || (i + 1 == argc)) {
+        if(world.rank() == 0)
+          usage();
+        TiledArray::finalize();
+        return 0;
+      }
+      const std::string value = argv[++i];
+      if(arg == "-n")
+        config.sizes = parse_list<long>(value);
+      else if(arg == "-b")
+        config.blocks = parse_list<long>(value);
+      else if(arg == "-s")
+        config.sparsities = parse_list<double>(value);
+      else if(arg == "-r")
+        config.repeat = std::stol(value);
+      else if(arg == "-l")
+        config.blas_size = std::stol(value);
+      else if(arg == "-o")
+        config.output = value;
+      else
+        throw std::runtime_error("unrecognized option " + arg);
+    }
+    if(config.repeat <= 0l) {
+      std::cerr << "Error: number of repetitions must be greater than zero.\n";
+      return 1;
+    }
+
+    // Reference rate of a single-node matrix multiply
+    double blas_rate = (world.rank() == 0 ? blas_gflops(config.blas_size) : 0.0);
+    world.gop.sum(blas_rate);
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: matrix multiply benchmark..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nNumber of nodes     = " << world.size()
+                << "\nBLAS GFLOPS         = " << blas_rate << "\n";
+
+    std::vector<Result> results;
+    for(const long n : config.sizes) {
+      for(const long bs : config.blocks) {
+        if((n <= 0l) || (bs <= 0l) || (n % bs)) {
+          if(world.rank() == 0)
+            std::cout << "Skipping matrix size " << n << " with block size "
+                      << bs << " (must be evenly divisible)\n";
+          continue;
+        }
+
+        // Construct TiledRange
+        std::vector<long> blocking;
+        for(long i = 0l; i <= n; i += bs)
+          blocking.push_back(i);
+        const TiledArray::TiledRange1 tr1(blocking.begin(), blocking.end());
+        const TiledArray::TiledRange trange({tr1, tr1});
+
+        for(const double s : config.sparsities) {
+          Result result { n, bs, s, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+          if(s <= 0.0) {
+            result.flop = 2.0 * double(n) * double(n) * double(n);
+            TiledArray::TArrayD a(world, trange), b(world, trange);
+            run(world, a, b, config, result);
+          } else {
+            const TiledArray::Tensor<float> a_norms = make_norms(trange, bs, s, 23u);
+            const TiledArray::Tensor<float> b_norms = make_norms(trange, bs, s, 42u);
+            result.flop = count_flop(a_norms, b_norms, bs);
+            TiledArray::TSpArrayD
+                a(world, trange, TiledArray::SparseShape<float>(a_norms, trange)),
+                b(world, trange, TiledArray::SparseShape<float>(b_norms, trange));
+            run(world, a, b, config, result);
+          }
+          result.efficiency = result.gflops / (double(world.size()) * blas_rate);
+          results.push_back(result);
+
+          if(world.rank() == 0)
+            std::cout << "n=" << n << " block=" << bs << " sparsity=" << s
+                      << "   time=" << result.time_avg
+                      << "   GFLOPS=" << result.gflops
+                      << "   efficiency=" << result.efficiency
+                      << "   comm=" << result.comm_bytes / 1.0e6 << " MB"
+                      << "   memory=" << result.memory_mb << " MB\n";
+        }
+      }
+    }
+
+    if(world.rank() == 0) {
+      std::ofstream file(config.output);
+      write_json(file, world, blas_rate, results);
+      std::cout << "Results written to " << config.output << "\n";
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
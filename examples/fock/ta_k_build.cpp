@@ -304,6 +304,35 @@ int main(int argc, char** argv) {
   world.gop.fence();
   madness::print_meminfo(world.rank(), "made J+K in 1 shot");
 
+  // build the exchange with the fused DF kernel, which streams the auxiliary
+  // slices of B and does not store the half-transformed W
+  {
+    array_type B;
+    B("X, rho, mu") = M_oh_inv("X,Y") * Eri("rho, mu, Y");
+    world.gop.fence();
+    madness::print_meminfo(world.rank(), "made B");
+
+    if(world.rank() == 0)
+      std::cout << "\nStarting fused DF J+K" << std::endl;
+    const double jk_time_start = madness::wall_time();
+    for(int i = 0; i < repeat; ++i) {
+      // Make J from the fitted density
+      array_type D, J;
+      D("rho, mu") = C("rho, i") * C("mu, i");
+      J("mu, nu") = B("X, mu, nu") * (B("X, rho, sig") * D("rho, sig"));
+
+      array_type K = TA::df_exchange(B, C);
+      array_type G;
+      G("mu, nu") = 2 * J("mu, nu") - K("mu, nu");
+      world.gop.fence();
+    }
+    const double jk_time = madness::wall_time() - jk_time_start;
+    madness::print_meminfo(world.rank(), "made J+K with df_exchange");
+    if(world.rank() == 0)
+      std::cout << "Average fused DF J+K time = " << jk_time / double(repeat)
+                << std::endl;
+  }
+
   TA::finalize();
   return 0;
 }
@@ -0,0 +1,337 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  kernel_bench.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <tiledarray.h>
+#include <TiledArray/version.h>
+#include <TiledArray/math/outer.h>
+#include <TiledArray/math/partial_reduce.h>
+#include <TiledArray/math/transpose.h>
+
+// Tile kernel microbenchmarks
+//
+// Times the local tile kernels (tensor_op, inplace_tensor_op, permute,
+// transpose, partial_reduce, outer, and gemm) on one thread for a range of
+// tensor volumes and ranks. Each result is normalized to the roofline of the
+// machine: the attainable time of a kernel is the larger of its memory
+// traffic divided by the measured memory bandwidth and its floating point
+// operations divided by the measured gemm rate, and the fraction of the
+// roofline is the attainable time divided by the measured time. Kernels that
+// fit in cache may exceed 100%. Use it to check SIMD and layout changes and
+// to select block sizes for a machine.
+
+namespace {
+
+  /// Benchmark parameters
+  struct Config {
+    std::vector<long> volumes { 4096, 262144, 4194304 };
+    std::vector<long> ranks { 2, 3, 4 };
+    double min_time = 0.1;
+    double bandwidth = 0.0; ///< Memory bandwidth (GB/s); measured when zero
+    double peak = 0.0; ///< Peak GFLOP/s; measured when zero
+    std::string output;
+  }; // struct Config
+
+  /// The result of one benchmark case
+  struct Result {
+    std::string kernel;
+    long rank;
+    long volume;
+    double time; ///< Wall time per call (s)
+    double bytes; ///< Memory traffic per call
+    double flop; ///< Floating point operations per call
+    double roofline; ///< Attainable time / measured time
+  }; // struct Result
+
+  template <typename T>
+  std::vector<T> parse_list(const std::string& str) {
+    std::vector<T> result;
+    std::stringstream ss(str);
+    std::string item;
+    while(std::getline(ss, item, ','))
+      result.push_back(T(std::stod(item)));
+    return result;
+  }
+
+  void usage() {
+    std::cout << "Usage: kernel_bench [-v volumes] [-d ranks] [-t min_time]\n"
+              << "                    [-w bandwidth] [-p peak] [-o output.csv]\n"
+              << "  volumes and ranks are comma-separated lists; bandwidth (GB/s)\n"
+              << "  and peak (GFLOP/s) are measured when they are not given.\n";
+  }
+
+  /// The instruction set extensions of this CPU and of this build
+  std::string cpu_features() {
+    std::string result;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse4.2")) result += " sse4.2";
+    if(__builtin_cpu_supports("avx")) result += " avx";
+    if(__builtin_cpu_supports("avx2")) result += " avx2";
+    if(__builtin_cpu_supports("fma")) result += " fma";
+    if(__builtin_cpu_supports("avx512f")) result += " avx512f";
+#endif
+    result += " | build:";
+#if defined(__AVX512F__)
+    result += " avx512f";
+#elif defined(__AVX2__)
+    result += " avx2";
+#elif defined(__AVX__)
+    result += " avx";
+#elif defined(__SSE4_2__)
+    result += " sse4.2";
+#elif defined(__ARM_NEON)
+    result += " neon";
+#else
+    result += " scalar";
+#endif
+#ifdef __FMA__
+    result += " fma";
+#endif
+    return result;
+  }
+
+  /// Time a kernel
+
+  /// The number of calls is doubled until they take at least \c min_time .
+  /// \return The wall time of one call
+  template <typename Fn>
+  double time_kernel(Fn&& fn, const double min_time) {
+    fn(); // Warm up
+    for(std::size_t reps = 1ul; ; reps *= 2ul) {
+      const double start = madness::wall_time();
+      for(std::size_t r = 0ul; r < reps; ++r)
+        fn();
+      const double time = madness::wall_time() - start;
+      if(time >= min_time)
+        return time / double(reps);
+    }
+  }
+
+  /// Measure the memory bandwidth with a triad that does not fit in cache
+  double measure_bandwidth(const double min_time) {
+    const std::size_t n = 1ul << 23;
+    std::vector<double> a(n, 1.0), b(n, 2.0), c(n, 0.0);
+    const double time = time_kernel([&] () {
+      TiledArray::math::vector_op_serial(
+          [] (const double x, const double y) { return x + 3.0 * y; },
+          n, c.data(), a.data(), b.data());
+    }, min_time);
+    return 3.0 * sizeof(double) * double(n) / time / 1.0e9;
+  }
+
+  /// Measure the floating point rate of a local matrix multiply
+  double measure_peak(const double min_time) {
+    const long n = 1024l;
+    std::vector<double> a(n * n, 1.0), b(n * n, 1.0), c(n * n, 0.0);
+    const double time = time_kernel([&] () {
+      TiledArray::math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans,
+          n, n, n, 1.0, a.data(), n, b.data(), n, 0.0, c.data(), n);
+    }, min_time);
+    return 2.0 * double(n) * double(n) * double(n) / time / 1.0e9;
+  }
+
+  /// Tensor with extents of (nearly) equal size
+  TiledArray::Tensor<double> make_tensor(const long volume, const long rank) {
+    const std::size_t extent = std::max(1l,
+        std::lround(std::pow(double(volume), 1.0 / double(rank))));
+    return TiledArray::Tensor<double>(TiledArray::Range(
+        std::vector<std::size_t>(rank, extent)), 1.0);
+  }
+
+  /// The permutation that reverses the dimension order
+  TiledArray::Permutation reverse_perm(const long rank) {
+    std::vector<unsigned int> p(rank);
+    for(long i = 0l; i < rank; ++i)
+      p[i] = rank - i - 1l;
+    return TiledArray::Permutation(p);
+  }
+
+  /// Add a result
+  template <typename Fn>
+  void run(std::vector<Result>& results, const Config& config,
+      const std::string& kernel, const long rank, const long volume,
+      const double bytes, const double flop, Fn&& fn)
+  {
+    Result result { kernel, rank, volume, 0.0, bytes, flop, 0.0 };
+    result.time = time_kernel(fn, config.min_time);
+    const double attainable = std::max(bytes / (config.bandwidth * 1.0e9),
+        flop / (config.peak * 1.0e9));
+    result.roofline = attainable / result.time;
+    results.push_back(result);
+
+    std::cout << std::left << std::setw(18) << kernel << std::right
+              << std::setw(5) << rank << std::setw(10) << volume
+              << std::setw(14) << result.time * 1.0e6
+              << std::setw(10) << bytes / result.time / 1.0e9
+              << std::setw(10) << flop / result.time / 1.0e9
+              << std::setw(9) << result.roofline * 100.0 << "%\n";
+  }
+
+  void write_csv(std::ostream& os, const std::vector<Result>& results) {
+    os << "kernel,rank,volume,time_s,bytes,flop,roofline\n";
+    for(const Result& r : results)
+      os << r.kernel << ',' << r.rank << ',' << r.volume << ',' << r.time << ','
+         << r.bytes << ',' << r.flop << ',' << r.roofline << '\n';
+  }
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    // Initialize runtime
+    TiledArray::World& world = TiledArray::initialize(argc, argv);
+
+    // Get command line arguments
+    Config config;
+    for(int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if((arg == "-h") || (i + 1 == argc)) {
+        if(world.rank() == 0)
+          usage();
+        TiledArray::finalize();
+        return 0;
+      }
+      const std::string value = argv[++i];
+      if(arg == "-v")
+        config.volumes = parse_list<long>(value);
+      else if(arg == "-d")
+        config.ranks = parse_list<long>(value);
+      else if(arg == "-t")
+        config.min_time = std::stod(value);
+      else if(arg == "-w")
+        config.bandwidth = std::stod(value);
+      else if(arg == "-p")
+        config.peak = std::stod(value);
+      else if(arg == "-o")
+        config.output = value;
+      else
+        throw std::runtime_error("unrecognized option " + arg);
+    }
+
+    // The kernels are local, so only the first process runs them.
+    if(world.rank() == 0) {
+      if(config.bandwidth <= 0.0)
+        config.bandwidth = measure_bandwidth(config.min_time);
+      if(config.peak <= 0.0)
+        config.peak = measure_peak(config.min_time);
+
+      std::cout << "TiledArray: tile kernel benchmark..."
+                << "\nGit HASH: " << TILEDARRAY_REVISION
+                << "\nCPU features        =" << cpu_features()
+                << "\nLoop unwind         = " << TILEDARRAY_LOOP_UNWIND
+                << "\nMemory bandwidth    = " << config.bandwidth << " GB/s"
+                << "\nPeak GFLOPS         = " << config.peak << "\n\n"
+                << std::left << std::setw(18) << "kernel" << std::right
+                << std::setw(5) << "rank" << std::setw(10) << "volume"
+                << std::setw(14) << "time (us)" << std::setw(10) << "GB/s"
+                << std::setw(10) << "GFLOPS" << std::setw(10) << "roofline"
+                << "\n" << std::fixed << std::setprecision(2);
+
+      const double word = sizeof(double);
+      std::vector<Result> results;
+      for(const long v : config.volumes) {
+        // Element-wise kernels and permutations of each rank
+        for(const long d : config.ranks) {
+          if(d <= 0l)
+            continue;
+          const TiledArray::Tensor<double> a = make_tensor(v, d);
+          TiledArray::Tensor<double> b = make_tensor(v, d);
+          const double n = a.size();
+          const TiledArray::Permutation perm = reverse_perm(d);
+
+          run(results, config, "tensor_op", d, n, 3.0 * word * n, n,
+              [&] () { TiledArray::Tensor<double> c = a.add(b); });
+          run(results, config, "inplace_tensor_op", d, n, 3.0 * word * n, n,
+              [&] () { b.add_to(a); });
+          run(results, config, "permute", d, n, 2.0 * word * n, 0.0,
+              [&] () { TiledArray::Tensor<double> c = a.permute(perm); });
+          run(results, config, "permute_op", d, n, 3.0 * word * n, n,
+              [&] () { TiledArray::Tensor<double> c = a.add(b, perm); });
+        }
+
+        // Matrix kernels
+        const long m = std::max(1l, std::lround(std::sqrt(double(v))));
+        const double n = double(m) * double(m);
+        std::vector<double> x(m, 1.0), y(m, 1.0), a(m * m, 1.0), c(m * m, 0.0);
+
+        run(results, config, "transpose", 2, n, 2.0 * word * n, 0.0, [&] () {
+          TiledArray::math::transpose([] (const double arg) { return arg; },
+              [] (double* const result, const double arg) { *result = arg; },
+              m, m, m, c.data(), m, a.data());
+        });
+        run(results, config, "partial_reduce", 2, n, word * (n + 2.0 * m),
+            2.0 * n, [&] () {
+          TiledArray::math::row_reduce(m, m, a.data(), x.data(), y.data(),
+              [] (double& result, const double left, const double right)
+              { result += left * right; });
+        });
+        run(results, config, "outer", 2, n, word * (n + 2.0 * m), n, [&] () {
+          TiledArray::math::outer(m, m, x.data(), y.data(), c.data(),
+              [] (double& result, const double left, const double right)
+              { result += left * right; });
+        });
+        run(results, config, "gemm", 2, n, 4.0 * word * n,
+            2.0 * n * double(m), [&] () {
+          TiledArray::math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans,
+              m, m, m, 1.0, a.data(), m, a.data(), m, 1.0, c.data(), m);
+        });
+      }
+
+      if(! config.output.empty()) {
+        std::ofstream file(config.output);
+        write_csv(file, results);
+        std::cout << "Results written to " << config.output << "\n";
+      }
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
+
+  return rc;
+}
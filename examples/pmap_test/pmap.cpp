@@ -17,87 +17,337 @@
  *
  */
 
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <sstream>
 #include "tiledarray.h"
+#include "TiledArray/pmap/blocked_pmap.h"
 #include "TiledArray/pmap/cyclic_pmap.h"
 #include "TiledArray/pmap/hash_pmap.h"
 
-std::vector<ProcessID> make_map(std::size_t m, std::size_t n, std::shared_ptr<TiledArray::Pmap>& pmap) {
-  std::vector<ProcessID> map;
+// Process map analyzer
+//
+// Compares the process maps of the arrays of a contraction, e.g.
+//
+//   pmap -e "i,j=i,k*k,j" -x i=2000,j=2000,k=1000 -b 100 -s 0.5
+//
+// For each process map of the library (blocked, cyclic, hash, Morton, and
+// cost-weighted), all three arrays are distributed with it, and the tool
+// reports the tiles, bytes, and flops of each process, and the predicted
+// communication of the contraction (see TiledArray::PmapAnalysis). The
+// cost-weighted map balances the non-zero volume of the arguments and the
+// flops of the result tiles. With -p, the owners of the tiles of an m x n
+// tile matrix are printed for each map instead.
 
-  const std::size_t end = m * n;
-  map.reserve(end);
-  for(std::size_t i = 0ul; i < end; ++i)
-    map.push_back(pmap->owner(i));
+namespace {
 
-  return map;
-}
+  void usage() {
+    std::cout << "Usage: pmap [-e result=left*right] [-x index=extent,...] [-b block]\n"
+              << "            [-s sparsity] [-v]\n"
+              << "       pmap -p [-m rows] [-n cols]\n"
+              << "  The default expression is i,j=i,k*k,j with all extents 1000;\n"
+              << "  sparsity is the fraction of argument tiles that are zero; -v\n"
+              << "  prints the load of each process.\n";
+  }
+
+  std::vector<ProcessID> make_map(std::size_t m, std::size_t n, std::shared_ptr<TiledArray::Pmap>& pmap) {
+    std::vector<ProcessID> map;
+
+    const std::size_t end = m * n;
+    map.reserve(end);
+    for(std::size_t i = 0ul; i < end; ++i)
+      map.push_back(pmap->owner(i));
 
-void print_map(std::size_t m, std::size_t n, const std::vector<ProcessID>& map) {
-  for(std::size_t i = 0ul; i < m; ++i) {
-    for(std::size_t j = 0ul; j < n; ++j)
-      std::cout << map[i * n + j] << " ";
-    std::cout << "\n";
+    return map;
   }
-}
 
-void print_local(TiledArray::World& world, const std::shared_ptr<TiledArray::Pmap>& pmap) {
-  for(ProcessID r = 0; r < world.size(); ++r) {
-    world.gop.fence();
-    if(r == world.rank()) {
-      std::cout << r << ": { ";
-      for(TiledArray::Pmap::const_iterator it = pmap->begin(); it != pmap->end(); ++it)
-        std::cout << *it << " ";
-      std::cout << "}\n";
+  void print_map(std::size_t m, std::size_t n, const std::vector<ProcessID>& map) {
+    for(std::size_t i = 0ul; i < m; ++i) {
+      for(std::size_t j = 0ul; j < n; ++j)
+        std::cout << map[i * n + j] << " ";
+      std::cout << "\n";
     }
   }
-}
 
-int main(int argc, char** argv) {
-  TiledArray::World& world = TiledArray::initialize(argc,argv);
+  void print_local(TiledArray::World& world, const std::shared_ptr<TiledArray::Pmap>& pmap) {
+    for(ProcessID r = 0; r < world.size(); ++r) {
+      world.gop.fence();
+      if(r == world.rank()) {
+        std::cout << r << ": { ";
+        for(TiledArray::Pmap::const_iterator it = pmap->begin(); it != pmap->end(); ++it)
+          std::cout << *it << " ";
+        std::cout << "}\n";
+      }
+    }
+  }
 
-  std::size_t m = 20;
-  std::size_t n = 10;
-  std::size_t M = 200;
-  std::size_t N = 100;
+  /// Print the owners of the tiles of an m x n tile matrix
+  void print_maps(TiledArray::World& world, const std::size_t m, const std::size_t n) {
+    const std::size_t procs = world.size();
+    const std::size_t proc_rows = std::max<std::size_t>(1ul,
+        std::min<std::size_t>(m, std::sqrt(double(procs))));
+    const std::size_t proc_cols = std::max<std::size_t>(1ul,
+        std::min<std::size_t>(n, procs / proc_rows));
 
-  std::shared_ptr<TiledArray::Pmap> blocked_pmap(new TiledArray::detail::BlockedPmap(world, m * n));
-  std::vector<ProcessID> blocked_map = make_map(m, n, blocked_pmap);
+    const std::pair<const char*, std::shared_ptr<TiledArray::Pmap> > pmaps[] = {
+        { "Block", std::make_shared<TiledArray::detail::BlockedPmap>(world, m * n) },
+        { "Cyclic", std::make_shared<TiledArray::detail::CyclicPmap>(world, m, n,
+            proc_rows, proc_cols) },
+        { "Hash", std::make_shared<TiledArray::detail::HashPmap>(world, m * n) },
+        { "Morton", std::make_shared<TiledArray::detail::MortonPmap>(world,
+            TiledArray::Range(m, n)) } };
 
-  std::shared_ptr<TiledArray::Pmap> cyclic_pmap(new TiledArray::detail::CyclicPmap(world, m, n, M, N));
-  std::vector<ProcessID> cyclic_map = make_map(m, n, cyclic_pmap);
+    for(auto pmap : pmaps) {
+      const std::vector<ProcessID> map = make_map(m, n, pmap.second);
+      if(world.rank() == 0) {
+        std::cout << "\n" << pmap.first << "\n";
+        print_map(m, n, map);
+        std::cout << "\n";
+      }
+      print_local(world, pmap.second);
+      world.gop.fence();
+    }
+  }
 
-  std::shared_ptr<TiledArray::Pmap> hash_pmap(new TiledArray::detail::HashPmap(world, m * n));
-  std::vector<ProcessID> hash_map = make_map(m, n, hash_pmap);
+  /// An array of the contraction
+  struct Array {
+    std::string vars;
+    TiledArray::TiledRange trange;
+    TiledArray::SparseShape<float> shape;
+  }; // struct Array
 
-  if(world.rank() == 0) {
-    std::cout << "Block\n";
-    print_map(m, n, blocked_map);
-    std::cout << "\n";
+  /// Split a string
+  std::vector<std::string> split(const std::string& str, const char delim) {
+    std::vector<std::string> result;
+    std::stringstream ss(str);
+    std::string item;
+    while(std::getline(ss, item, delim))
+      result.push_back(item);
+    return result;
   }
 
-  print_local(world, blocked_pmap);
+  /// Make an array with randomly zero tiles
 
-  world.gop.fence();
+  /// The zero tiles are chosen with a hash of the tile index, so they are
+  /// the same on all processes.
+  Array make_array(const std::string& vars, const std::map<std::string, long>& extents,
+      const long block, const double sparsity, const std::uint64_t seed)
+  {
+    std::vector<TiledArray::TiledRange1> ranges;
+    for(const auto& var : split(vars, ',')) {
+      const auto it = extents.find(var);
+      const long extent = (it != extents.end() ? it->second : 1000l);
+      std::vector<long> bounds;
+      for(long i = 0l; i < extent; i += block)
+        bounds.push_back(i);
+      bounds.push_back(extent);
+      ranges.emplace_back(bounds.begin(), bounds.end());
+    }
+    const TiledArray::TiledRange trange(ranges.begin(), ranges.end());
 
-  if(world.rank() == 0) {
+    TiledArray::Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < norms.size(); ++i) {
+      std::uint64_t x = (seed << 32) + i + 0x9e3779b97f4a7c15ull;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+      x ^= (x >> 31);
+      if(double(x >> 11) * (1.0 / 9007199254740992.0) >= sparsity)
+        norms[i] = trange.make_tile_range(i).volume();
+    }
 
-    std::cout << "\n\nCyclic\n";
-    print_map(m, n, cyclic_map);
-    std::cout << "\n";
+    return Array{ vars, trange, TiledArray::SparseShape<float>(norms, trange) };
   }
 
-  print_local(world, cyclic_pmap);
+  /// Make a process map of an array
 
-  world.gop.fence();
+  /// \param world The world of the process map
+  /// \param name The name of the process map
+  /// \param trange The tiled range of the array
+  /// \param weights The weight of each tile of the array
+  std::shared_ptr<TiledArray::Pmap> make_pmap(TiledArray::World& world,
+      const std::string& name, const TiledArray::TiledRange& trange,
+      const std::vector<double>& weights)
+  {
+    const TiledArray::Range& tiles = trange.tiles_range();
+    const std::size_t size = tiles.volume();
+    if(name == "blocked")
+      return std::make_shared<TiledArray::detail::BlockedPmap>(world, size);
+    if(name == "cyclic") {
+      // Cycle the first dimension over the process rows, and the others
+      // over the process columns
+      const std::size_t rows = tiles.extent(0), cols = size / rows;
+      const std::size_t proc_rows = std::max<std::size_t>(1ul,
+          std::min<std::size_t>(rows, std::sqrt(double(world.size()))));
+      const std::size_t proc_cols = std::max<std::size_t>(1ul,
+          std::min<std::size_t>(cols, world.size() / proc_rows));
+      return std::make_shared<TiledArray::detail::CyclicPmap>(world, rows, cols,
+          proc_rows, proc_cols);
+    }
+    if(name == "hash")
+      return std::make_shared<TiledArray::detail::HashPmap>(world, size);
+    if(name == "morton")
+      return std::make_shared<TiledArray::detail::MortonPmap>(world, tiles);
+    return std::make_shared<TiledArray::detail::WeightedPmap>(world, weights);
+  }
 
-  if(world.rank() == 0) {
-    std::cout << "\n\nHash\n";
-    print_map(m, n, hash_map);
-    std::cout << "\n";
+  /// The non-zero volume of each tile of an array
+  std::vector<double> tile_volumes(const Array& array) {
+    std::vector<double> result(array.trange.tiles_range().volume(), 0.0);
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      if(! array.shape.is_zero(i))
+        result[i] = array.trange.make_tile_range(i).volume();
+    return result;
   }
 
-  print_local(world, hash_pmap);
-  TiledArray::finalize();
+} // namespace
+
+int main(int argc, char** argv) {
+  int rc = 0;
+
+  try {
+    TiledArray::World& world = TiledArray::initialize(argc,argv);
+
+    // Get command line arguments
+    std::string expression = "i,j=i,k*k,j";
+    std::map<std::string, long> extents;
+    long block = 100l;
+    double sparsity = 0.0;
+    bool verbose = false, print = false;
+    std::size_t m = 20ul, n = 10ul;
+    for(int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if(arg == "-v") {
+        verbose = true;
+      } else if(arg == "-p") {
+        print = true;
+      } else if((arg == "-h") || (i + 1 == argc)) {
+        if(world.rank() == 0)
+          usage();
+        TiledArray::finalize();
+        return 0;
+      } else {
+        const std::string value = argv[++i];
+        if(arg == "-e") {
+          expression = value;
+        } else if(arg == "-x") {
+          for(const auto& extent : split(value, ',')) {
+            const std::size_t eq = extent.find('=');
+            if(eq == std::string::npos)
+              throw std::runtime_error("invalid extent " + extent);
+            extents[extent.substr(0, eq)] = std::stol(extent.substr(eq + 1));
+          }
+        } else if(arg == "-b") {
+          block = std::stol(value);
+        } else if(arg == "-s") {
+          sparsity = std::stod(value);
+        } else if(arg == "-m") {
+          m = std::stoul(value);
+        } else if(arg == "-n") {
+          n = std::stoul(value);
+        } else {
+          throw std::runtime_error("unrecognized option " + arg);
+        }
+      }
+    }
+
+    if(print) {
+      print_maps(world, m, n);
+      TiledArray::finalize();
+      return 0;
+    }
+
+    // Parse the contraction
+    const std::size_t eq = expression.find('='), star = expression.find('*');
+    if((eq == std::string::npos) || (star == std::string::npos) || (star < eq))
+      throw std::runtime_error("the expression must have the form result=left*right");
+    if(block <= 0l)
+      throw std::runtime_error("the block size must be positive");
+    const Array left = make_array(expression.substr(eq + 1, star - eq - 1),
+        extents, block, sparsity, 1u);
+    const Array right = make_array(expression.substr(star + 1), extents, block,
+        sparsity, 2u);
+    const std::string result_vars = expression.substr(0, eq);
+    std::vector<TiledArray::TiledRange1> result_ranges;
+    const std::vector<std::string> left_vars = split(left.vars, ','),
+        right_vars = split(right.vars, ',');
+    for(const auto& var : split(result_vars, ',')) {
+      const auto l = std::find(left_vars.begin(), left_vars.end(), var);
+      const auto r = std::find(right_vars.begin(), right_vars.end(), var);
+      if(l != left_vars.end())
+        result_ranges.push_back(left.trange.data()[l - left_vars.begin()]);
+      else if(r != right_vars.end())
+        result_ranges.push_back(right.trange.data()[r - right_vars.begin()]);
+      else
+        throw std::runtime_error("result index " + var + " is not in an argument");
+    }
+    const TiledArray::TiledRange result_trange(result_ranges.begin(), result_ranges.end());
+    const std::vector<double> result_flops = TiledArray::contraction_tile_flops(
+        result_vars, left.vars, left.trange, left.shape, right.vars,
+        right.trange, right.shape);
+
+    if(world.rank() == 0)
+      std::cout << "TiledArray: process map analyzer...\n"
+                << "Number of processes = " << world.size()
+                << "\nExpression          = " << expression
+                << "\nBlock size          = " << block
+                << "\nSparsity            = " << sparsity
+                << "\nResult tiles        = " << result_trange.tiles_range().volume() << "\n\n"
+                << std::setw(10) << "pmap" << std::setw(16) << "max stored (MB)"
+                << std::setw(16) << "stored imbal." << std::setw(14) << "max GFLOP"
+                << std::setw(14) << "flop imbal." << std::setw(16) << "max recv (MB)"
+                << std::setw(16) << "total comm (MB)" << "\n" << std::fixed
+                << std::setprecision(3);
+
+    for(const std::string name : { "blocked", "cyclic", "hash", "morton", "weighted" }) {
+      const auto left_pmap = make_pmap(world, name, left.trange, tile_volumes(left));
+      const auto right_pmap = make_pmap(world, name, right.trange, tile_volumes(right));
+      const auto result_pmap = make_pmap(world, name, result_trange, result_flops);
+
+      TiledArray::PmapAnalysis analysis(world.size());
+      analysis.add_array(left.trange, left.shape, *left_pmap);
+      analysis.add_array(right.trange, right.shape, *right_pmap);
+      analysis.add_contraction(result_vars, *result_pmap, left.vars, left.trange,
+          left.shape, *left_pmap, right.vars, right.trange, right.shape, *right_pmap);
+
+      if(world.rank() == 0) {
+        double max_bytes = 0.0, max_flops = 0.0;
+        for(const auto& load : analysis.load()) {
+          max_bytes = std::max(max_bytes, load.bytes);
+          max_flops = std::max(max_flops, load.flops);
+        }
+        std::cout << std::setw(10) << name << std::setw(16) << max_bytes / 1048576.0
+                  << std::setw(16) << analysis.byte_imbalance()
+                  << std::setw(14) << max_flops * 1.0e-9
+                  << std::setw(14) << analysis.flop_imbalance()
+                  << std::setw(16) << analysis.max_recv_bytes() / 1048576.0
+                  << std::setw(16) << analysis.total().recv_bytes / 1048576.0 << "\n";
+        if(verbose) {
+          analysis.print(std::cout);
+          std::cout << "\n";
+        }
+      }
+    }
+
+    TiledArray::finalize();
+
+  } catch(TiledArray::Exception& e) {
+    std::cerr << "!! TiledArray exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(madness::MadnessException& e) {
+    std::cerr << "!! MADNESS exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(SafeMPI::Exception& e) {
+    std::cerr << "!! SafeMPI exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(std::exception& e) {
+    std::cerr << "!! std exception: " << e.what() << "\n";
+    rc = 1;
+  } catch(...) {
+    std::cerr << "!! exception: unknown exception\n";
+    rc = 1;
+  }
 
-  return 0;
+  return rc;
 }
@@ -0,0 +1,228 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  ao_to_mo.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_AO_TO_MO_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_AO_TO_MO_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <algorithm>
+#include <array>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Order of the quarter transforms of a 4-index transformation
+
+    /// The order minimizes the floating point operations of the four
+    /// quarter transforms; of the orders with the same cost, the one with
+    /// the smallest intermediate is selected. The cost of a quarter
+    /// transform is the volume of its argument times the size of the new
+    /// index.
+    /// \param ao The sizes of the untransformed (AO) dimensions
+    /// \param mo The sizes of the transformed (MO) dimensions
+    /// \return The dimensions in the order they are transformed
+    inline std::array<unsigned int, 4>
+    quarter_transform_order(const std::array<std::size_t, 4>& ao,
+        const std::array<std::size_t, 4>& mo)
+    {
+      std::array<unsigned int, 4> order = {{ 0u, 1u, 2u, 3u }};
+      std::array<unsigned int, 4> best = order;
+      double best_flops = 0.0, best_memory = 0.0;
+      bool first = true;
+      do {
+        double volume = double(ao[0]) * double(ao[1]) * double(ao[2]) * double(ao[3]);
+        double flops = 0.0, memory = 0.0;
+        for(unsigned int d = 0u; d < 3u; ++d) {
+          flops += volume * double(mo[order[d]]);
+          volume = volume / double(ao[order[d]]) * double(mo[order[d]]);
+          memory = std::max(memory, volume);
+        }
+        flops += volume * double(mo[order[3]]);
+        if(first || (flops < best_flops) ||
+            ((flops == best_flops) && (memory < best_memory)))
+        {
+          best = order;
+          best_flops = flops;
+          best_memory = memory;
+          first = false;
+        }
+      } while(std::next_permutation(order.begin(), order.end()));
+
+      return best;
+    }
+
+  } // namespace detail
+
+  /// Transform 4-index integrals from the AO to the MO basis
+
+  /// Evaluate
+  /// \f[
+  ///   (ij|kl) = \sum_{pqrs} (pq|rs) C_{pi} C_{qj} C_{rk} C_{sl}
+  /// \f]
+  /// as four quarter transforms (contractions with Summa), where the order
+  /// of the quarter transforms is selected with
+  /// \c detail::quarter_transform_order() to minimize the operation count,
+  /// regardless of the order of the arguments. The dimension that is
+  /// transformed last is the batch dimension: its tiles are divided into
+  /// batches, and the first three quarter transforms of a batch are
+  /// evaluated with the block of the integrals in that batch. The last
+  /// quarter transform of each batch is accumulated into the result, so the
+  /// intermediates of only one batch are stored at a time. The quarter
+  /// transforms of a batch are evaluated without a fence, and the batch is
+  /// completed before the next one is started. Zero tiles of sparse
+  /// arguments are skipped by the contractions.
+  /// \code
+  /// TiledArray::TSpArrayD mo = ao_to_mo(eri, c_occ, c_vir, c_occ, c_vir, 1ul << 30);
+  /// \endcode
+  /// \tparam Tile The tile type
+  /// \tparam Policy The array policy type
+  /// \param eri The AO integrals, \f$ (pq|rs) \f$
+  /// \param c0 The coefficients of the first dimension, \f$ C_{pi} \f$
+  /// \param c1 The coefficients of the second dimension, \f$ C_{qj} \f$
+  /// \param c2 The coefficients of the third dimension, \f$ C_{rk} \f$
+  /// \param c3 The coefficients of the fourth dimension, \f$ C_{sl} \f$
+  /// \param max_memory The bytes of the largest intermediate of a batch
+  /// summed over all processes. A batch holds at least one tile. If zero,
+  /// the transform is evaluated in one batch [default = 0].
+  /// \return The MO integrals, \f$ (ij|kl) \f$
+  /// \throw TiledArray::Exception When \c eri does not have rank 4, or the
+  /// AO dimension of a coefficient array is not tiled the same way as the
+  /// dimension of \c eri that it transforms.
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  ao_to_mo(const DistArray<Tile, Policy>& eri, const DistArray<Tile, Policy>& c0,
+      const DistArray<Tile, Policy>& c1, const DistArray<Tile, Policy>& c2,
+      const DistArray<Tile, Policy>& c3, const std::size_t max_memory = 0ul)
+  {
+    typedef DistArray<Tile, Policy> array_type;
+    typedef typename Tile::numeric_type numeric_type;
+
+    TA_USER_ASSERT(eri.trange().rank() == 4u,
+        "TiledArray::ao_to_mo(): The integrals must have rank 4.");
+    const std::array<const array_type*, 4> c = {{ &c0, &c1, &c2, &c3 }};
+    std::array<std::size_t, 4> ao, mo;
+    for(unsigned int d = 0u; d < 4u; ++d) {
+      TA_USER_ASSERT((c[d]->trange().rank() == 2u) &&
+          (c[d]->trange().dim(0) == eri.trange().dim(d)),
+          "TiledArray::ao_to_mo(): A coefficient array does not match the dimension of the integrals it transforms.");
+      ao[d] = eri.trange().dim(d).extent();
+      mo[d] = c[d]->trange().dim(1).extent();
+    }
+
+    const std::array<unsigned int, 4> order =
+        detail::quarter_transform_order(ao, mo);
+    const unsigned int batch_dim = order[3];
+
+    // Variables of the integrals and of each intermediate
+    const std::array<std::string, 4> ao_vars = {{ "p", "q", "r", "s" }};
+    const std::array<std::string, 4> mo_vars = {{ "i", "j", "k", "l" }};
+    std::array<std::string, 4> vars = ao_vars;
+    auto var_list = [&vars] () {
+      return vars[0] + "," + vars[1] + "," + vars[2] + "," + vars[3];
+    };
+    const std::string eri_vars = var_list();
+    std::array<std::string, 3> step_vars;
+    for(unsigned int d = 0u; d < 3u; ++d) {
+      vars[order[d]] = mo_vars[order[d]];
+      step_vars[d] = var_list();
+    }
+    vars = mo_vars;
+    const std::string result_vars = var_list();
+
+    // The size of the largest intermediate, per element of the batch dimension
+    double volume = double(ao[0]) * double(ao[1]) * double(ao[2]) * double(ao[3]);
+    double peak = 0.0;
+    for(unsigned int d = 0u; d < 3u; ++d) {
+      volume = volume / double(ao[order[d]]) * double(mo[order[d]]);
+      peak = std::max(peak, volume);
+    }
+    const double batch_element_bytes =
+        peak / double(ao[batch_dim]) * double(sizeof(numeric_type));
+
+    // Divide the tiles of the batch dimension into batches
+    const TiledRange1& batch_trange = eri.trange().dim(batch_dim);
+    std::vector<std::pair<std::size_t, std::size_t> > batches;
+    for(std::size_t t = batch_trange.tiles_range().first;
+        t < batch_trange.tiles_range().second; ++t)
+    {
+      if(! batches.empty() && ((max_memory == 0ul) ||
+          (double(batch_trange.tile(t).second -
+              batch_trange.tile(batches.back().first).first) *
+              batch_element_bytes <= double(max_memory))))
+      {
+        batches.back().second = t + 1ul;
+      } else {
+        batches.emplace_back(t, t + 1ul);
+      }
+    }
+
+    // Tile bounds of the blocks of a batch
+    std::vector<std::size_t> eri_lower, eri_upper;
+    for(unsigned int d = 0u; d < 4u; ++d) {
+      eri_lower.push_back(eri.trange().dim(d).tiles_range().first);
+      eri_upper.push_back(eri.trange().dim(d).tiles_range().second);
+    }
+    const TiledRange1& batch_mo = c[batch_dim]->trange().dim(1);
+    const std::string c_vars = ao_vars[batch_dim] + "," + mo_vars[batch_dim];
+
+    World& world = eri.world();
+    array_type result;
+    for(const auto& batch : batches) {
+      eri_lower[batch_dim] = batch.first;
+      eri_upper[batch_dim] = batch.second;
+
+      // The first three quarter transforms of the batch
+      array_type t0, t1, t2;
+      t0(step_vars[0]) = eri(eri_vars).block(eri_lower, eri_upper)
+          * (*c[order[0]])(ao_vars[order[0]] + "," + mo_vars[order[0]]);
+      t1(step_vars[1]) = t0(step_vars[0])
+          * (*c[order[1]])(ao_vars[order[1]] + "," + mo_vars[order[1]]);
+      t0 = array_type();
+      t2(step_vars[2]) = t1(step_vars[1])
+          * (*c[order[2]])(ao_vars[order[2]] + "," + mo_vars[order[2]]);
+      t1 = array_type();
+
+      // Accumulate the last quarter transform of the batch
+      const std::vector<std::size_t>
+          c_lower = { batch.first, batch_mo.tiles_range().first },
+          c_upper = { batch.second, batch_mo.tiles_range().second };
+      if(result.is_initialized())
+        result(result_vars) += (*c[batch_dim])(c_vars).block(c_lower, c_upper)
+            * t2(step_vars[2]);
+      else
+        result(result_vars) = (*c[batch_dim])(c_vars).block(c_lower, c_upper)
+            * t2(step_vars[2]);
+
+      // Complete the batch before the next one is started
+      if(batches.size() > 1ul)
+        world.gop.fence();
+    }
+
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_AO_TO_MO_H__INCLUDED
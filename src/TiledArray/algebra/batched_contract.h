@@ -0,0 +1,531 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  batched_contract.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_BATCHED_CONTRACT_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_BATCHED_CONTRACT_H__INCLUDED
+
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/expressions/variable_list.h>
+#include <TiledArray/math/blas.h>
+#include <unordered_map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Index layout of a batched contraction
+
+    /// The variables of a batched contraction are classified as batch
+    /// variables, which appear in both arguments and the result, inner
+    /// variables, which appear in both arguments only and are summed, and
+    /// left and right outer variables, which appear in one argument and the
+    /// result. The tile kernel permutes the left argument to
+    /// <tt>(batch, left outer, inner)</tt> order and the right argument to
+    /// <tt>(batch, inner, right outer)</tt> order, evaluates one GEMM per
+    /// batch element, and permutes the <tt>(batch, left outer, right outer)</tt>
+    /// product to the result order.
+    class BatchedContraction {
+    private:
+      /// The origin of an argument dimension: the result dimension or the
+      /// inner dimension with the given position
+      typedef std::pair<bool, unsigned int> source_type;
+
+      unsigned int batch_rank_; ///< Number of batch variables
+      unsigned int left_outer_rank_; ///< Number of left outer variables
+      unsigned int inner_rank_; ///< Number of inner variables
+      unsigned int right_outer_rank_; ///< Number of right outer variables
+      Permutation left_perm_; ///< Permutes left tiles to the kernel order
+      Permutation right_perm_; ///< Permutes right tiles to the kernel order
+      Permutation result_perm_; ///< Permutes kernel results to the result order
+      std::vector<unsigned int> work_dims_; ///< The result dimensions in kernel order
+      std::vector<source_type> left_sources_; ///< The origin of left dimensions
+      std::vector<source_type> right_sources_; ///< The origin of right dimensions
+      std::vector<std::pair<unsigned int, unsigned int> > inner_dims_;
+                        ///< The left and right dimensions of the inner variables
+
+      /// Position of a variable in a variable list
+
+      /// \return The position of \c var in \c vars , or <tt>vars.dim()</tt>
+      static unsigned int find(const expressions::VariableList& vars,
+          const std::string& var)
+      {
+        return std::distance(vars.begin(),
+            std::find(vars.begin(), vars.end(), var));
+      }
+
+      /// Map the dimensions of an argument to result or inner dimensions
+      std::vector<source_type>
+      make_sources(const expressions::VariableList& vars,
+          const expressions::VariableList& result_vars,
+          const std::vector<std::string>& inner_vars) const
+      {
+        std::vector<source_type> sources;
+        for(const auto& var : vars) {
+          const unsigned int r = find(result_vars, var);
+          if(r < result_vars.dim())
+            sources.emplace_back(true, r);
+          else
+            sources.emplace_back(false, std::distance(inner_vars.begin(),
+                std::find(inner_vars.begin(), inner_vars.end(), var)));
+        }
+        return sources;
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param left_vars The variables of the left argument
+      /// \param right_vars The variables of the right argument
+      /// \param result_vars The variables of the result
+      /// \throw TiledArray::Exception When a result variable is not in either
+      /// argument, or when an argument variable is in neither the result nor
+      /// the other argument.
+      BatchedContraction(const expressions::VariableList& left_vars,
+          const expressions::VariableList& right_vars,
+          const expressions::VariableList& result_vars)
+      {
+        std::vector<std::string> batch, left_outer, inner, right_outer;
+        for(const auto& var : left_vars) {
+          const bool in_right = find(right_vars, var) < right_vars.dim();
+          const bool in_result = find(result_vars, var) < result_vars.dim();
+          TA_USER_ASSERT(in_right || in_result,
+              "TiledArray::batched_contract(): A left-hand variable is not in the result or the right-hand argument.");
+          if(in_right && in_result)
+            batch.push_back(var);
+          else if(in_right)
+            inner.push_back(var);
+          else
+            left_outer.push_back(var);
+        }
+        for(const auto& var : right_vars) {
+          const bool in_left = find(left_vars, var) < left_vars.dim();
+          const bool in_result = find(result_vars, var) < result_vars.dim();
+          TA_USER_ASSERT(in_left || in_result,
+              "TiledArray::batched_contract(): A right-hand variable is not in the result or the left-hand argument.");
+          if(! in_left)
+            right_outer.push_back(var);
+        }
+        for(const auto& var : result_vars)
+          TA_USER_ASSERT((find(left_vars, var) < left_vars.dim()) ||
+              (find(right_vars, var) < right_vars.dim()),
+              "TiledArray::batched_contract(): A result variable is not in either argument.");
+
+        batch_rank_ = batch.size();
+        left_outer_rank_ = left_outer.size();
+        inner_rank_ = inner.size();
+        right_outer_rank_ = right_outer.size();
+
+        // Construct the kernel variable lists
+        std::vector<std::string> left_work(batch), right_work(batch), work(batch);
+        left_work.insert(left_work.end(), left_outer.begin(), left_outer.end());
+        left_work.insert(left_work.end(), inner.begin(), inner.end());
+        right_work.insert(right_work.end(), inner.begin(), inner.end());
+        right_work.insert(right_work.end(), right_outer.begin(), right_outer.end());
+        work.insert(work.end(), left_outer.begin(), left_outer.end());
+        work.insert(work.end(), right_outer.begin(), right_outer.end());
+
+        const expressions::VariableList left_work_vars(left_work.begin(), left_work.end());
+        const expressions::VariableList right_work_vars(right_work.begin(), right_work.end());
+        const expressions::VariableList work_vars(work.begin(), work.end());
+        left_perm_ = left_work_vars.permutation(left_vars);
+        right_perm_ = right_work_vars.permutation(right_vars);
+        result_perm_ = result_vars.permutation(work_vars);
+
+        // Identity permutations are not applied
+        for(Permutation* perm : { &left_perm_, &right_perm_, &result_perm_ })
+          if(*perm == perm->identity())
+            *perm = Permutation();
+
+        for(const auto& var : work)
+          work_dims_.push_back(find(result_vars, var));
+        left_sources_ = make_sources(left_vars, result_vars, inner);
+        right_sources_ = make_sources(right_vars, result_vars, inner);
+        for(const auto& var : inner)
+          inner_dims_.emplace_back(find(left_vars, var), find(right_vars, var));
+      }
+
+      /// Inner dimensions accessor
+
+      /// \return The left- and right-hand dimensions of each inner variable
+      const std::vector<std::pair<unsigned int, unsigned int> >& inner_dims() const {
+        return inner_dims_;
+      }
+
+      /// Make the index of an argument tile
+
+      /// \param left If \c true , the index of a left tile is made; otherwise
+      /// the index of a right tile is made
+      /// \param result_index The result tile index
+      /// \param inner_index The tile index of the inner dimensions
+      /// \return The tile index of the argument
+      template <typename Index1, typename Index2>
+      std::vector<std::size_t> make_arg_index(const bool left,
+          const Index1& result_index, const Index2& inner_index) const
+      {
+        const std::vector<source_type>& sources =
+            (left ? left_sources_ : right_sources_);
+        std::vector<std::size_t> index;
+        index.reserve(sources.size());
+        for(const auto& source : sources)
+          index.push_back(source.first ? result_index[source.second] :
+              inner_index[source.second]);
+        return index;
+      }
+
+      /// Evaluate a result tile
+
+      /// \tparam Tile The tile type
+      /// \param range The range of the result tile
+      /// \param left The left argument tiles
+      /// \param right The right argument tiles, where <tt>right[j]</tt> is
+      /// multiplied with <tt>left[j]</tt>
+      /// \return The sum of the batched products of the tile pairs
+      template <typename Tile>
+      Tile operator()(const Range& range, const std::vector<Tile>& left,
+          const std::vector<Tile>& right) const
+      {
+        typedef typename Tile::numeric_type numeric_type;
+
+        // Construct the result tile in kernel order
+        std::vector<std::size_t> lower, upper;
+        for(const auto d : work_dims_) {
+          lower.push_back(range.lobound()[d]);
+          upper.push_back(range.upbound()[d]);
+        }
+        Tile work(Range(lower, upper), numeric_type(0));
+
+        const std::size_t* const extent = work.range().extent_data();
+        std::size_t batch = 1ul, m = 1ul, n = 1ul;
+        unsigned int d = 0u;
+        for(; d < batch_rank_; ++d)
+          batch *= extent[d];
+        for(; d < batch_rank_ + left_outer_rank_; ++d)
+          m *= extent[d];
+        for(; d < work.range().rank(); ++d)
+          n *= extent[d];
+
+        for(std::size_t j = 0ul; j < left.size(); ++j) {
+          const Tile a = (left_perm_ ? left[j].permute(left_perm_) : left[j]);
+          const Tile b = (right_perm_ ? right[j].permute(right_perm_) : right[j]);
+          const std::size_t k = a.size() / (batch * m);
+          for(std::size_t x = 0ul; x < batch; ++x)
+            math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, m, n, k,
+                numeric_type(1), a.data() + x * m * k, k, b.data() + x * k * n, n,
+                numeric_type(1), work.data() + x * m * n, n);
+        }
+
+        return (result_perm_ ? work.permute(result_perm_) : work);
+      }
+
+    }; // class BatchedContraction
+
+    /// The local result tiles of a batched contraction
+    template <typename Tile>
+    struct BatchedContractTiles {
+      TiledRange trange; ///< The tiled range of the result
+      std::shared_ptr<Pmap> pmap; ///< The process map of the result
+      std::vector<std::pair<std::size_t, Future<Tile> > > tiles; ///< The local result tiles
+    }; // struct BatchedContractTiles
+
+    /// Spawn the tasks of a batched contraction
+
+    /// \tparam Tile The tile type
+    /// \tparam Policy The array policy type
+    /// \param left The left-hand argument
+    /// \param left_vars The variables of \c left
+    /// \param right The right-hand argument
+    /// \param right_vars The variables of \c right
+    /// \param result_vars The variables of the result
+    /// \return The tiled range, the process map, and the local tiles of the
+    /// result
+    template <typename Tile, typename Policy>
+    inline BatchedContractTiles<Tile>
+    spawn_batched_contract(const DistArray<Tile, Policy>& left,
+        const expressions::VariableList& left_list,
+        const DistArray<Tile, Policy>& right,
+        const expressions::VariableList& right_list,
+        const expressions::VariableList& result_list)
+    {
+      typedef DistArray<Tile, Policy> array_type;
+      typedef typename array_type::size_type size_type;
+
+      TA_USER_ASSERT(left_list.dim() == left.trange().rank(),
+          "TiledArray::batched_contract(): The number of left-hand variables does not match the array rank.");
+      TA_USER_ASSERT(right_list.dim() == right.trange().rank(),
+          "TiledArray::batched_contract(): The number of right-hand variables does not match the array rank.");
+      const std::shared_ptr<const BatchedContraction> kernel =
+          std::make_shared<const BatchedContraction>(left_list,
+              right_list, result_list);
+
+      // Construct the result tiled range, and check the shared dimensions
+      std::vector<TiledRange1> dims;
+      for(const auto& var : result_list) {
+        const auto l = std::find(left_list.begin(), left_list.end(), var);
+        const auto r = std::find(right_list.begin(), right_list.end(), var);
+        if(l != left_list.end()) {
+          dims.push_back(left.trange().dim(std::distance(left_list.begin(), l)));
+          TA_USER_ASSERT((r == right_list.end()) || (dims.back() ==
+              right.trange().dim(std::distance(right_list.begin(), r))),
+              "TiledArray::batched_contract(): A batch variable is not tiled the same way in both arguments.");
+        } else {
+          dims.push_back(right.trange().dim(std::distance(right_list.begin(), r)));
+        }
+      }
+      std::vector<std::size_t> inner_extent;
+      for(const auto& dim : kernel->inner_dims()) {
+        TA_USER_ASSERT(left.trange().dim(dim.first) == right.trange().dim(dim.second),
+            "TiledArray::batched_contract(): A summed variable is not tiled the same way in both arguments.");
+        inner_extent.push_back(left.trange().dim(dim.first).tiles_range().second -
+            left.trange().dim(dim.first).tiles_range().first);
+      }
+
+      BatchedContractTiles<Tile> result;
+      result.trange = TiledRange(dims.begin(), dims.end());
+      const TiledRange& trange = result.trange;
+
+      // Enumerate the tile indices of the inner dimensions
+      std::vector<std::vector<std::size_t> > inner_indices;
+      if(inner_extent.empty()) {
+        inner_indices.emplace_back();
+      } else {
+        for(const auto& index : Range(inner_extent))
+          inner_indices.emplace_back(index.begin(), index.end());
+      }
+
+      World& world = left.world();
+      result.pmap = Policy::default_pmap(world, trange.tiles_range().volume());
+
+      // Spawn one task per local result tile. Argument tiles are requested once
+      // per process.
+      std::unordered_map<size_type, Future<Tile> > left_tiles, right_tiles;
+      for(const auto ord : *result.pmap) {
+        const auto index = trange.tiles_range().idx(ord);
+        std::vector<Future<Tile> > left_args, right_args;
+        for(const auto& inner_index : inner_indices) {
+          const size_type l = left.trange().tiles_range().ordinal(
+              kernel->make_arg_index(true, index, inner_index));
+          const size_type r = right.trange().tiles_range().ordinal(
+              kernel->make_arg_index(false, index, inner_index));
+          if(left.is_zero(l) || right.is_zero(r))
+            continue;
+
+          auto lit = left_tiles.find(l);
+          if(lit == left_tiles.end())
+            lit = left_tiles.emplace(l, left.find(l)).first;
+          auto rit = right_tiles.find(r);
+          if(rit == right_tiles.end())
+            rit = right_tiles.emplace(r, right.find(r)).first;
+          left_args.push_back(lit->second);
+          right_args.push_back(rit->second);
+        }
+        if(left_args.empty() && ! is_dense<array_type>::value)
+          continue;
+
+        result.tiles.emplace_back(ord, world.taskq.add(
+            [kernel] (const Range& range, const std::vector<Future<Tile> >& left_args,
+                const std::vector<Future<Tile> >& right_args) -> Tile
+            {
+              std::vector<Tile> a, b;
+              a.reserve(left_args.size());
+              b.reserve(right_args.size());
+              for(std::size_t j = 0ul; j < left_args.size(); ++j) {
+                a.push_back(left_args[j].get());
+                b.push_back(right_args[j].get());
+              }
+              return (*kernel)(range, a, b);
+            }, trange.make_tile_range(ord), left_args, right_args));
+      }
+
+      return result;
+    }
+
+    /// Wait for the local tiles of a batched contraction
+
+    /// \tparam Tile The tile type
+    /// \param result The local result tiles
+    /// \return The ordinal index and the data of each local result tile
+    template <typename Tile>
+    inline std::vector<std::pair<std::size_t, Tile> >
+    wait_batched_contract(const BatchedContractTiles<Tile>& result) {
+      std::vector<std::pair<std::size_t, Tile> > tiles;
+      tiles.reserve(result.tiles.size());
+      for(const auto& tile : result.tiles)
+        tiles.emplace_back(tile.first, tile.second.get());
+      return tiles;
+    }
+
+    /// Construct the dense results of a batch of batched contractions
+    template <typename Array,
+        typename std::enable_if<is_dense<Array>::value>::type* = nullptr>
+    inline std::vector<Array> make_batched_contract_arrays(World& world,
+        const std::vector<BatchedContractTiles<typename Array::value_type> >& results)
+    {
+      std::vector<Array> arrays;
+      arrays.reserve(results.size());
+      for(const auto& result : results)
+        arrays.push_back(make_retiled_array<Array>(world, result.trange,
+            result.pmap, wait_batched_contract(result)));
+      return arrays;
+    }
+
+    /// Construct the sparse results of a batch of batched contractions
+
+    /// The tile norms of all results are summed in one reduction.
+    template <typename Array,
+        typename std::enable_if<! is_dense<Array>::value>::type* = nullptr>
+    inline std::vector<Array> make_batched_contract_arrays(World& world,
+        const std::vector<BatchedContractTiles<typename Array::value_type> >& results)
+    {
+      typedef typename Array::shape_type shape_type;
+      typedef typename shape_type::value_type value_type;
+
+      // Compute the tile norms of all results
+      std::vector<std::size_t> offsets(1ul, 0ul);
+      for(const auto& result : results)
+        offsets.push_back(offsets.back() + result.trange.tiles_range().volume());
+      std::vector<value_type> norms(offsets.back(), value_type(0));
+      std::vector<std::vector<std::pair<std::size_t, typename Array::value_type> > > tiles;
+      tiles.reserve(results.size());
+      for(std::size_t i = 0ul; i < results.size(); ++i) {
+        tiles.push_back(wait_batched_contract(results[i]));
+        for(const auto& tile : tiles.back())
+          norms[offsets[i] + tile.first] = tile.second.norm();
+      }
+      if(! norms.empty())
+        world.gop.sum(norms.data(), norms.size());
+
+      std::vector<Array> arrays;
+      arrays.reserve(results.size());
+      for(std::size_t i = 0ul; i < results.size(); ++i) {
+        const TiledRange& trange = results[i].trange;
+        Tensor<value_type> tile_norms(trange.tiles_range(), norms.data() + offsets[i]);
+        Array array(world, trange, shape_type(tile_norms, trange), results[i].pmap);
+        for(const auto& tile : tiles[i])
+          if(! array.is_zero(tile.first))
+            array.set(tile.first, tile.second);
+        arrays.push_back(array);
+      }
+      return arrays;
+    }
+
+  } // namespace detail
+
+  /// Contract two arrays with batch indices
+
+  /// Evaluate products such as
+  /// <tt>c(i,j,k) = sum_l a(i,j,l) * b(j,l,k)</tt>, where an index that
+  /// appears in both arguments and in the result (\c j ) is a batch index,
+  /// and an index that appears only in the arguments (\c l ) is summed.
+  /// Such products cannot be written as a contraction or a Hadamard product
+  /// expression. Each result tile is evaluated by a task on its owner, which
+  /// sums the batched products of the argument tile pairs that share its
+  /// batch and outer tile indices, so all batch tiles are evaluated
+  /// concurrently. Zero tiles of sparse arguments are skipped, and the shape
+  /// of a sparse result is computed from the norms of its tiles. This is a
+  /// collective operation.
+  /// \code
+  /// TiledArray::TArrayD c = batched_contract(a, "i,j,l", b, "j,l,k", "i,j,k");
+  /// \endcode
+  /// \tparam Tile The tile type, which must support \c permute() and
+  /// \c data() in the manner of \c TiledArray::Tensor
+  /// \tparam Policy The array policy type
+  /// \param left The left-hand argument
+  /// \param left_vars The variables of \c left
+  /// \param right The right-hand argument
+  /// \param right_vars The variables of \c right
+  /// \param result_vars The variables of the result
+  /// \return The result array
+  /// \throw TiledArray::Exception When the variables do not define a batched
+  /// contraction, or a variable shared by the arguments is not tiled the
+  /// same way in both.
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  batched_contract(const DistArray<Tile, Policy>& left, const std::string& left_vars,
+      const DistArray<Tile, Policy>& right, const std::string& right_vars,
+      const std::string& result_vars)
+  {
+    typedef DistArray<Tile, Policy> array_type;
+    const detail::BatchedContractTiles<Tile> result =
+        detail::spawn_batched_contract(left, expressions::VariableList(left_vars),
+            right, expressions::VariableList(right_vars),
+            expressions::VariableList(result_vars));
+    return detail::make_retiled_array<array_type>(left.world(), result.trange,
+        result.pmap, detail::wait_batched_contract(result));
+  }
+
+  /// Contract many pairs of arrays with batch indices
+
+  /// Evaluate <tt>result[p] = batched_contract(left[p], left_vars, right[p],
+  /// right_vars, result_vars)</tt> for each pair \c p , e.g. the small
+  /// per-pair contractions of local correlation methods. The tasks of all
+  /// pairs are spawned before any result is waited for, so the tiles of all
+  /// pairs are evaluated concurrently in one pass, without the distributed
+  /// evaluators and fences of one expression per pair, and the shapes of
+  /// sparse results are reduced together. The pairs may have different
+  /// tiled ranges. This is a collective operation.
+  /// \code
+  /// std::vector<TiledArray::TArrayD> c =
+  ///     batched_contract(a, "i,k", b, "k,j", "i,j");
+  /// \endcode
+  /// \tparam Tile The tile type, which must support \c permute() and
+  /// \c data() in the manner of \c TiledArray::Tensor
+  /// \tparam Policy The array policy type
+  /// \param left The left-hand arguments
+  /// \param left_vars The variables of each left-hand argument
+  /// \param right The right-hand arguments
+  /// \param right_vars The variables of each right-hand argument
+  /// \param result_vars The variables of the results
+  /// \return The result of each pair
+  /// \throw TiledArray::Exception When the numbers of arguments differ, the
+  /// variables do not define a batched contraction, or a variable shared by
+  /// the arguments of a pair is not tiled the same way in both.
+  template <typename Tile, typename Policy>
+  inline std::vector<DistArray<Tile, Policy> >
+  batched_contract(const std::vector<DistArray<Tile, Policy> >& left,
+      const std::string& left_vars,
+      const std::vector<DistArray<Tile, Policy> >& right,
+      const std::string& right_vars, const std::string& result_vars)
+  {
+    typedef DistArray<Tile, Policy> array_type;
+    TA_USER_ASSERT(left.size() == right.size(),
+        "TiledArray::batched_contract(): The numbers of left- and right-hand arguments differ.");
+    if(left.empty())
+      return std::vector<array_type>();
+
+    const expressions::VariableList left_list(left_vars), right_list(right_vars),
+        result_list(result_vars);
+    std::vector<detail::BatchedContractTiles<Tile> > results;
+    results.reserve(left.size());
+    for(std::size_t p = 0ul; p < left.size(); ++p)
+      results.push_back(detail::spawn_batched_contract(left[p], left_list,
+          right[p], right_list, result_list));
+
+    return detail::make_batched_contract_arrays<array_type>(left.front().world(),
+        results);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_BATCHED_CONTRACT_H__INCLUDED
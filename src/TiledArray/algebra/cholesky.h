@@ -0,0 +1,171 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  cholesky.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_CHOLESKY_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_CHOLESKY_H__INCLUDED
+
+#include <Eigen/Cholesky>
+#include <TiledArray/conversions/eigen.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+
+  namespace detail {
+
+    // Tile kernels of the tiled Cholesky factorization. Tiles are row-major
+    // matrices; each kernel returns a new tile, so the input tiles are not
+    // modified.
+
+    /// Factorize a diagonal tile
+
+    /// \tparam Tile The tile type
+    /// \param a A symmetric positive definite diagonal tile
+    /// \return The lower triangular factor of \c a ; the upper triangle is zero
+    /// \throw TiledArray::Exception When \c a is not positive definite
+    template <typename Tile>
+    Tile cholesky_potrf(const Tile& a) {
+      typedef typename Tile::value_type value_type;
+      typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic,
+          Eigen::RowMajor> matrix_type;
+      const auto n = a.range().extent(0);
+
+      Eigen::LLT<matrix_type> llt(eigen_map(a, n, n));
+      TA_USER_ASSERT(llt.info() == Eigen::Success,
+          "TiledArray::cholesky(): The matrix is not positive definite.");
+
+      Tile result(a.range());
+      eigen_map(result, n, n) = llt.matrixL().toDenseMatrix();
+      return result;
+    }
+
+    /// Solve for an off-diagonal tile of the factor
+
+    /// \tparam Tile The tile type
+    /// \param a Tile \c (i,j) of the updated matrix
+    /// \param l_jj Diagonal tile \c (j,j) of the factor
+    /// \return Tile \c (i,j) of the factor, <tt>a * l_jj^-T</tt>
+    template <typename Tile>
+    Tile cholesky_trsm(const Tile& a, const Tile& l_jj) {
+      const auto m = a.range().extent(0);
+      const auto n = a.range().extent(1);
+
+      Tile result = a.clone();
+      auto x = eigen_map(result, m, n);
+      eigen_map(l_jj, n, n).template triangularView<Eigen::Lower>().transpose()
+          .template solveInPlace<Eigen::OnTheRight>(x);
+      return result;
+    }
+
+    /// Update a trailing tile with one column of the factor
+
+    /// \tparam Tile The tile type
+    /// \param a Tile \c (i,j) of the matrix
+    /// \param l_ik Tile \c (i,k) of the factor
+    /// \param l_jk Tile \c (j,k) of the factor
+    /// \return <tt>a - l_ik * l_jk^T</tt>
+    template <typename Tile>
+    Tile cholesky_update(const Tile& a, const Tile& l_ik, const Tile& l_jk) {
+      const auto m = a.range().extent(0);
+      const auto n = a.range().extent(1);
+      const auto k = l_ik.range().extent(1);
+
+      Tile result = a.clone();
+      eigen_map(result, m, n).noalias() -=
+          eigen_map(l_ik, m, k) * eigen_map(l_jk, n, k).transpose();
+      return result;
+    }
+
+    /// Construct a zero tile
+
+    /// \tparam Tile The tile type
+    /// \param range The range of the tile
+    /// \return A tile with \c range that is filled with zeros
+    template <typename Tile>
+    Tile cholesky_zero(const typename Tile::range_type& range) {
+      return Tile(range, typename Tile::value_type(0));
+    }
+
+  } // namespace detail
+
+  /// Tiled Cholesky factorization
+
+  /// Computes the lower triangular matrix \c L , where <tt>a = L * L^T</tt> ,
+  /// with the right-looking tiled algorithm. Each tile operation is a task
+  /// on the process that owns the tile in the result, and tiles of \c L are
+  /// exchanged through the futures of the result array, so the steps of the
+  /// factorization overlap and no process holds more than its own tiles and
+  /// the factor tiles it needs. The result has the tiled range and process
+  /// map of \c a , and its tiles above the diagonal are zero.
+  /// \tparam Tile The tile type
+  /// \param a A symmetric positive definite matrix; only the tiles on and
+  /// below the diagonal are used. The row and column tilings must be equal.
+  /// \return The Cholesky factor of \c a
+  /// \throw TiledArray::Exception When \c a is not a matrix with equal row and
+  /// column tilings.
+  template <typename Tile>
+  DistArray<Tile, DensePolicy> cholesky(const DistArray<Tile, DensePolicy>& a) {
+    const auto& trange = a.trange();
+    TA_USER_ASSERT(trange.tiles_range().rank() == 2u,
+        "TiledArray::cholesky(): The array must be a matrix.");
+    TA_USER_ASSERT(trange.data()[0] == trange.data()[1],
+        "TiledArray::cholesky(): The row and column tilings must be equal.");
+
+    World& world = a.world();
+    DistArray<Tile, DensePolicy> l(world, trange, a.pmap());
+
+    const std::size_t nt = trange.tiles_range().extent_data()[0];
+
+    // Each process builds the task graph for its own tiles of the factor.
+    // Tiles of the factor that are owned by other processes are obtained
+    // with find(), which does not block.
+    for(const auto index : *l.pmap()) {
+      const std::size_t i = (index / nt), j = (index % nt);
+
+      if(i < j) {
+        l.set(index, world.taskq.add(& detail::cholesky_zero<Tile>,
+            trange.make_tile_range(index)));
+        continue;
+      }
+
+      // Apply the updates from the columns left of j
+      Future<Tile> tile = a.find(index);
+      for(std::size_t k = 0ul; k < j; ++k)
+        tile = world.taskq.add(& detail::cholesky_update<Tile>, tile,
+            l.find(i * nt + k), l.find(j * nt + k));
+
+      if(i == j)
+        l.set(index, world.taskq.add(& detail::cholesky_potrf<Tile>, tile,
+            madness::TaskAttributes::hipri()));
+      else
+        l.set(index, world.taskq.add(& detail::cholesky_trsm<Tile>, tile,
+            l.find(j * nt + j)));
+    }
+
+    return l;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_CHOLESKY_H__INCLUDED
@@ -48,6 +48,7 @@ namespace TiledArray {
   ///   \li <tt> value_type maxabs_value(const D&) </tt>
   ///   \li <tt> void vec_multiply(D& a, const D& b) </tt> (element-wise multiply of \c a by \c b )
   ///   \li <tt> value_type dot_product(const D& a, const D& b) </tt>
+  ///   \li <tt> Future<value_type> dot_product_async(const D& a, const D& b) </tt>
   ///   \li <tt> void scale(D&, value_type) </tt>
   ///   \li <tt> void axpy(D& y, value_type a, const D& x) </tt>
   ///   \li <tt> void assign(D&, const D&) </tt>
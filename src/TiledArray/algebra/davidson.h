@@ -0,0 +1,351 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Eduard Valeyev
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  davidson.h
+ *  Oct 15, 2016
+ *
+ */
+
+
+#ifndef TILEDARRAY_ALGEBRA_DAVIDSON_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_DAVIDSON_H__INCLUDED
+
+#include <cmath>
+#include <deque>
+#include <stdexcept>
+#include <vector>
+#include <Eigen/Eigenvalues>
+#include <TiledArray/algebra/diis.h>
+#include <TiledArray/algebra/utils.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+
+  /// Block Davidson solver for the lowest eigenpairs of a symmetric operator
+
+  /// Solves <tt>a(x_k) = lambda_k x_k</tt> for the \c n lowest eigenvalues of
+  /// a real symmetric linear operator \c a , e.g. an EOM or CI Hamiltonian,
+  /// where \c n is the number of guess vectors. Each iteration applies \c a
+  /// to a block of trial vectors with one call, so the operator can evaluate
+  /// all products together, e.g. with \c multi_contract() , which broadcasts
+  /// the operator tiles once for the whole block.
+  ///
+  /// The new trial vectors are the preconditioned residuals of the roots
+  /// that are not converged. They are orthogonalized against the subspace
+  /// with two passes of classical Gram-Schmidt, and then orthonormalized
+  /// among themselves from the eigenvectors of their overlap matrix, which
+  /// drops linearly dependent directions. The local parts of all dot
+  /// products of a block (see \c local_dot_product() ) are summed with one
+  /// reduction, so each Gram matrix, and each update of the projected
+  /// matrix, costs one allreduce instead of one per pair of vectors. The
+  /// subspace vectors and their products are held with the storage of
+  /// \c set_storage() , i.e. in memory, in single precision, or on disk (see
+  /// \c DIISStorage ); only one stored vector is accessed at a time. When the
+  /// subspace is full, it is collapsed onto the current Ritz vectors.
+  ///
+  /// \code
+  /// struct Sigma {
+  ///   TArrayD h;
+  ///   void operator()(const std::vector<TArrayD>& c, std::vector<TArrayD>& sigma) {
+  ///     sigma = multi_contract(h, "a,b,c,d", c, "c,d,i,j", "a,b,i,j");
+  ///   }
+  /// };
+  /// // Divide the residual by the denominator of the Ritz value
+  /// auto precond = [&] (double lambda, TArrayD& r) {
+  ///   EnergyDenominator<double>(energies, factors, -lambda)(r);
+  /// };
+  /// DavidsonSolver<TArrayD, Sigma> solver;
+  /// std::vector<double> values = solver(sigma, precond, guesses, 1.0e-6);
+  /// \endcode
+  /// \tparam D The vector type, i.e. a \c DistArray ; in addition to the
+  /// functions used by \c GMRESSolver , \c D must provide
+  /// <tt> value_type local_dot_product(const D&, const D&) </tt>
+  /// \tparam F The operator type, which must implement
+  /// <tt> F::operator()(const std::vector<D>& x, std::vector<D>& result) </tt> ,
+  /// where \c result has the size of \c x on input, and holds the products
+  /// of \c a with the elements of \c x on output
+  template <typename D, typename F>
+  class DavidsonSolver {
+  public:
+    typedef typename D::element_type value_type; ///< The element type
+    typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic> matrix_type;
+                                              ///< The projected matrix type
+
+  private:
+    typedef detail::DIISVector<D> vector_type; ///< A stored subspace vector
+
+    unsigned int max_subspace_; ///< The maximum size of the subspace, or zero
+    unsigned int max_niter_; ///< The maximum number of iterations
+    DIISStorage storage_; ///< The storage of the subspace vectors
+    std::string directory_; ///< The directory of the subspace files
+
+    /// Sum the local parts of a matrix of dot products over all processes
+    static void reduce(World& world, matrix_type& m) {
+      if(m.size())
+        world.gop.sum(m.data(), m.size());
+    }
+
+    /// Local parts of the dot products of the subspace with a block
+
+    /// \param v The subspace vectors
+    /// \param b A block of vectors
+    /// \return The local parts of <tt>v[i] . b[j]</tt>
+    static matrix_type local_overlaps(const std::deque<vector_type>& v,
+        const std::vector<D>& b)
+    {
+      matrix_type result = matrix_type::Zero(v.size(), b.size());
+      for(std::size_t i = 0ul; i < v.size(); ++i) {
+        const D vi = v[i].get();
+        for(std::size_t j = 0ul; j < b.size(); ++j)
+          result(i, j) = local_dot_product(vi, b[j]);
+      }
+      return result;
+    }
+
+    /// Linear combinations of the subspace vectors
+
+    /// \param v The subspace vectors
+    /// \param c The coefficients, where column \c k holds the coefficients of
+    /// result \c k
+    /// \return <tt>result[k] = sum_i v[i] * c(i,k)</tt>
+    static std::vector<D> combine(const std::deque<vector_type>& v,
+        const matrix_type& c)
+    {
+      TA_ASSERT(! v.empty());
+      std::vector<D> result(c.cols());
+      for(std::size_t i = 0ul; i < v.size(); ++i) {
+        const D vi = v[i].get();
+        for(std::size_t k = 0ul; k < result.size(); ++k) {
+          if(i == 0ul) {
+            result[k] = copy(vi);
+            scale(result[k], c(i, k));
+          } else {
+            axpy(result[k], c(i, k), vi);
+          }
+        }
+      }
+      return result;
+    }
+
+    /// Orthonormalize a block of vectors against the subspace
+
+    /// \param world The world of the vectors
+    /// \param v The subspace vectors, which are orthonormal
+    /// \param t The block of vectors, which is modified
+    /// \return An orthonormal basis of the part of the span of \c t that is
+    /// orthogonal to \c v ; directions that are linearly dependent are
+    /// dropped
+    static std::vector<D> orthonormalize(World& world,
+        const std::deque<vector_type>& v, std::vector<D>& t)
+    {
+      const value_type linear_dependence = 1.0e-12;
+
+      // The squared norms of t are summed with the first projection
+      value_type max_norm2 = 0;
+      for(unsigned int pass = 0u; pass < 2u; ++pass) {
+        matrix_type s = matrix_type::Zero(v.size() + 1ul, t.size());
+        s.topRows(v.size()) = local_overlaps(v, t);
+        if(pass == 0u)
+          for(std::size_t k = 0ul; k < t.size(); ++k)
+            s(v.size(), k) = local_dot_product(t[k], t[k]);
+        reduce(world, s);
+        if(pass == 0u)
+          max_norm2 = s.row(v.size()).maxCoeff();
+        if(v.empty())
+          break;
+
+        for(std::size_t i = 0ul; i < v.size(); ++i) {
+          const D vi = v[i].get();
+          for(std::size_t k = 0ul; k < t.size(); ++k)
+            axpy(t[k], -s(i, k), vi);
+        }
+      }
+
+      // Orthonormalize the block with the eigenvectors of its Gram matrix
+      matrix_type g = matrix_type::Zero(t.size(), t.size());
+      for(std::size_t k = 0ul; k < t.size(); ++k)
+        for(std::size_t l = 0ul; l <= k; ++l)
+          g(k, l) = local_dot_product(t[k], t[l]);
+      reduce(world, g);
+      Eigen::SelfAdjointEigenSolver<matrix_type> solver(g, Eigen::ComputeEigenvectors);
+
+      std::vector<D> result;
+      for(std::size_t m = t.size(); m-- > 0ul; ) {
+        const value_type s = solver.eigenvalues()[m];
+        if(! (s > linear_dependence * max_norm2))
+          break;
+        D w = copy(t[0]);
+        scale(w, solver.eigenvectors()(0, m) / std::sqrt(s));
+        for(std::size_t k = 1ul; k < t.size(); ++k)
+          axpy(w, solver.eigenvectors()(k, m) / std::sqrt(s), t[k]);
+        result.push_back(w);
+      }
+
+      return result;
+    }
+
+  public:
+
+    /// \param max_subspace The maximum number of subspace vectors, which must
+    /// be at least twice the number of roots; zero selects eight vectors
+    /// per root [default = 0]
+    /// \param max_niter The maximum number of iterations [default = 100]
+    explicit DavidsonSolver(unsigned int max_subspace = 0,
+        unsigned int max_niter = 100) :
+      max_subspace_(max_subspace), max_niter_(max_niter),
+      storage_(DIISStorage::memory), directory_(".")
+    { }
+
+    /// Set the storage of the subspace vectors
+
+    /// Compressed and disk storage is only available for arrays of
+    /// \c Tensor tiles, see \c DIIS::set_storage() .
+    /// \param storage The storage of the subspace vectors
+    /// \param directory The directory of the subspace files of disk storage,
+    /// which should not be shared with other jobs (default = ".")
+    void set_storage(DIISStorage storage, const std::string& directory = ".") {
+      storage_ = storage;
+      directory_ = directory;
+    }
+
+    /// Find the lowest eigenpairs
+
+    /// This is a collective operation.
+    /// \tparam P The preconditioner type, which must implement
+    /// <tt> P::operator()(value_type lambda, D& r) </tt> , which replaces the
+    /// residual \c r of the root with the Ritz value \c lambda with an
+    /// approximation of <tt>(a - lambda)^-1 r</tt> , e.g. the residual
+    /// divided by the difference of the diagonal of \c a and \c lambda
+    /// \param a The operator
+    /// \param precond The preconditioner
+    /// \param[in,out] x On input, a guess of each eigenvector; on output,
+    /// the eigenvectors
+    /// \param convergence_target The largest 2-norm of a converged residual
+    /// [default = 1e-8]
+    /// \return The lowest <tt>x.size()</tt> eigenvalues, in ascending order
+    /// \throw TiledArray::Exception When \c x is empty, the subspace is too
+    /// small, or the guesses are linearly dependent.
+    /// \throw std::domain_error When the maximum number of iterations is
+    /// exceeded, or the subspace cannot be extended; \c x holds the current
+    /// Ritz vectors.
+    template <typename P>
+    std::vector<value_type> operator()(F& a, const P& precond, std::vector<D>& x,
+        const value_type convergence_target = 1.0e-8)
+    {
+      TA_USER_ASSERT(! x.empty(), "Davidson: No guess vectors are given.");
+      const std::size_t nroots = x.size();
+      const std::size_t max_subspace =
+          (max_subspace_ > 0u ? max_subspace_ : 8ul * nroots);
+      TA_USER_ASSERT(max_subspace >= 2ul * nroots,
+          "Davidson: The subspace must hold at least two vectors per root.");
+      World& world = x.front().world();
+
+      std::deque<vector_type> v, av; // The subspace and its products
+      matrix_type h; // The projected matrix, h(i,j) = v[i] . a(v[j])
+      std::vector<value_type> values(nroots);
+
+      std::vector<D> block = orthonormalize(world, v, x);
+      TA_USER_ASSERT(block.size() == nroots,
+          "Davidson: The guess vectors are linearly dependent.");
+
+      for(unsigned int iter = 1u; ; ++iter) {
+        std::vector<D> ablock(block.size());
+        a(block, ablock);
+        TA_ASSERT(ablock.size() == block.size());
+
+        // Extend the projected matrix with one reduction
+        const std::size_t n0 = v.size(), nb = block.size(), n = n0 + nb;
+        for(const auto& vec : block)
+          v.emplace_back(vec, storage_, directory_);
+        matrix_type c = local_overlaps(v, ablock);
+        reduce(world, c);
+        h.conservativeResize(n, n);
+        h.rightCols(nb) = c;
+        h.bottomLeftCorner(nb, n0) = c.topRows(n0).transpose();
+        h.bottomRightCorner(nb, nb) =
+            value_type(0.5) * (c.bottomRows(nb) + c.bottomRows(nb).transpose());
+        for(auto& vec : ablock)
+          av.emplace_back(vec, storage_, directory_);
+        block.clear();
+        ablock.clear();
+
+        // Rayleigh-Ritz
+        Eigen::SelfAdjointEigenSolver<matrix_type> solver(h, Eigen::ComputeEigenvectors);
+        const matrix_type y = solver.eigenvectors().leftCols(nroots);
+        for(std::size_t k = 0ul; k < nroots; ++k)
+          values[k] = solver.eigenvalues()[k];
+        std::vector<D> ritz = combine(v, y), aritz = combine(av, y);
+
+        // The residuals, r_k = a(x_k) - lambda_k x_k , and their norms
+        std::vector<D> r;
+        r.reserve(nroots);
+        matrix_type rnorm2 = matrix_type::Zero(nroots, 1);
+        for(std::size_t k = 0ul; k < nroots; ++k) {
+          r.push_back(copy(aritz[k]));
+          axpy(r[k], -values[k], ritz[k]);
+          rnorm2(k, 0) = local_dot_product(r[k], r[k]);
+        }
+        reduce(world, rnorm2);
+
+        // Precondition the residuals of the roots that are not converged
+        std::vector<D> t;
+        for(std::size_t k = 0ul; k < nroots; ++k) {
+          if(std::sqrt(std::abs(rnorm2(k, 0))) < convergence_target)
+            continue;
+          precond(values[k], r[k]);
+          t.push_back(r[k]);
+        }
+        r.clear();
+
+        if(t.empty()) {
+          x = std::move(ritz);
+          return values;
+        }
+        if(iter >= max_niter_) {
+          x = std::move(ritz);
+          throw std::domain_error("Davidson: max # of iterations exceeded");
+        }
+
+        // Collapse the subspace onto the Ritz vectors when it is full
+        if(v.size() + t.size() > max_subspace) {
+          v.clear();
+          av.clear();
+          for(std::size_t k = 0ul; k < nroots; ++k) {
+            v.emplace_back(ritz[k], storage_, directory_);
+            av.emplace_back(aritz[k], storage_, directory_);
+          }
+          h = matrix_type::Zero(nroots, nroots);
+          for(std::size_t k = 0ul; k < nroots; ++k)
+            h(k, k) = values[k];
+        }
+
+        block = orthonormalize(world, v, t);
+        if(block.empty()) {
+          x = std::move(ritz);
+          throw std::domain_error("Davidson: the subspace cannot be extended");
+        }
+      }
+    }
+
+  }; // class DavidsonSolver
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_DAVIDSON_H__INCLUDED
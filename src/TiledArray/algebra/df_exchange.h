@@ -0,0 +1,207 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  df_exchange.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_DF_EXCHANGE_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_DF_EXCHANGE_H__INCLUDED
+
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/math/blas.h>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Request the non-zero tiles of an auxiliary slice of a 3-index array
+
+    /// \param b The 3-index array
+    /// \param x The auxiliary (first dimension) tile index of the slice
+    /// \return The ordinal and a future to each non-zero tile of the slice
+    template <typename Tile, typename Policy>
+    std::vector<std::pair<std::size_t, Future<Tile> > >
+    request_aux_slice(const DistArray<Tile, Policy>& b, const std::size_t x) {
+      const auto& aux_tiles = b.trange().dim(0).tiles_range();
+      const std::size_t slice_size = b.trange().tiles_range().volume() /
+          (aux_tiles.second - aux_tiles.first);
+      std::vector<std::pair<std::size_t, Future<Tile> > > slice;
+      for(std::size_t ord = x * slice_size; ord < (x + 1ul) * slice_size; ++ord)
+        if(! b.is_zero(ord))
+          slice.emplace_back(ord, b.find(ord));
+      return slice;
+    }
+
+  } // namespace detail
+
+  /// Density-fitted exchange matrix
+
+  /// Evaluate the density-fitted exchange contraction
+  /// \f[
+  ///   K_{\mu\nu} = \sum_{X i} W_{X i \mu} W_{X i \nu}, \quad
+  ///   W_{X i \mu} = \sum_{\rho} B_{X \rho \mu} C_{\rho i} ,
+  /// \f]
+  /// where \c B are the 3-index integrals contracted with the inverse square
+  /// root of the auxiliary metric, i.e.
+  /// <tt>B("X,rho,mu") = M_oh_inv("X,Y") * Eri("rho,mu,Y")</tt>, and \c C are
+  /// the occupied orbital coefficients. As an expression, this is
+  /// <tt>W("X,i,mu") = B("X,rho,mu") * C("rho,i")</tt> followed by
+  /// <tt>K("mu,nu") = W("X,i,mu") * W("X,i,nu")</tt>, which stores the whole
+  /// half-transformed intermediate \c W and redistributes it for the second
+  /// contraction.
+  ///
+  /// Here the two contractions are fused. Each process handles the auxiliary
+  /// tiles whose first tile, \c (x,0,0) , it owns, so \c B is read where it
+  /// is stored when its auxiliary slices are kept together (e.g. with a
+  /// blocked process map). The slices are streamed: the tiles of the next
+  /// slice are requested before the current one is evaluated, and only the
+  /// intermediate of the current slice, \f$ W_{x i \mu} \f$ , is stored.
+  /// Each process accumulates its part of \c K in a local matrix, and the
+  /// parts are summed over all processes before the result tiles are set.
+  /// \c C and \c K are therefore replicated during the evaluation, which is
+  /// small compared to \c B . Zero tiles of a sparse \c B or \c C are
+  /// skipped. This is a collective operation.
+  /// \code
+  /// TiledArray::TSpArrayD K = df_exchange(B, C);
+  /// \endcode
+  /// \tparam Tile The tile type, which must support \c data() in the manner
+  /// of \c TiledArray::Tensor
+  /// \tparam Policy The array policy type
+  /// \param b The metric-transformed 3-index integrals, with dimensions
+  /// (auxiliary, AO, AO)
+  /// \param c The occupied coefficients, with dimensions (AO, occupied)
+  /// \return The exchange matrix \c K , tiled as the last dimension of \c b
+  /// \throw TiledArray::Exception When the ranks of \c b or \c c are wrong,
+  /// or the AO dimensions of \c b and \c c are not tiled the same way.
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  df_exchange(const DistArray<Tile, Policy>& b, const DistArray<Tile, Policy>& c) {
+    typedef DistArray<Tile, Policy> array_type;
+    typedef typename Tile::numeric_type numeric_type;
+
+    TA_USER_ASSERT(b.trange().rank() == 3u,
+        "TiledArray::df_exchange(): The 3-index array must have rank 3.");
+    TA_USER_ASSERT(c.trange().rank() == 2u,
+        "TiledArray::df_exchange(): The coefficient array must have rank 2.");
+    TA_USER_ASSERT(b.trange().dim(1) == c.trange().dim(0),
+        "TiledArray::df_exchange(): The contracted AO dimension is not tiled the same way in both arrays.");
+
+    World& world = b.world();
+    const TiledRange1& aux = b.trange().dim(0);
+    const TiledRange1& rho = b.trange().dim(1);
+    const TiledRange1& mu = b.trange().dim(2);
+    const TiledRange1& occ = c.trange().dim(1);
+    const std::size_t n_rho = rho.extent(), n_mu = mu.extent(),
+        n_occ = occ.extent();
+    const std::size_t n_aux_tiles = aux.tiles_range().second - aux.tiles_range().first;
+    const std::size_t slice_size = b.trange().tiles_range().volume() / n_aux_tiles;
+
+    // Gather the coefficients into a dense (rho, i) matrix
+    std::vector<numeric_type> c_matrix(n_rho * n_occ, numeric_type(0));
+    {
+      std::vector<Future<Tile> > c_tiles;
+      for(std::size_t ord = 0ul; ord < c.trange().tiles_range().volume(); ++ord)
+        if(! c.is_zero(ord))
+          c_tiles.push_back(c.find(ord));
+      for(auto& future : c_tiles) {
+        const Tile& tile = future.get();
+        const std::size_t r0 = tile.range().lobound()[0] - rho.elements_range().first;
+        const std::size_t i0 = tile.range().lobound()[1] - occ.elements_range().first;
+        const std::size_t nr = tile.range().extent_data()[0],
+            ni = tile.range().extent_data()[1];
+        for(std::size_t r = 0ul; r < nr; ++r)
+          std::copy(tile.data() + r * ni, tile.data() + (r + 1ul) * ni,
+              c_matrix.data() + (r0 + r) * n_occ + i0);
+      }
+    }
+
+    // The auxiliary tiles evaluated by this process
+    std::vector<std::size_t> local_aux;
+    for(std::size_t x = 0ul; x < n_aux_tiles; ++x)
+      if(b.is_local(x * slice_size))
+        local_aux.push_back(x);
+
+    // Stream the local auxiliary slices, and accumulate K(mu,nu)
+    std::vector<numeric_type> k_matrix(n_mu * n_mu, numeric_type(0));
+    std::vector<numeric_type> w;
+    std::vector<std::pair<std::size_t, Future<Tile> > > next_slice;
+    if(! local_aux.empty())
+      next_slice = detail::request_aux_slice(b, local_aux.front());
+    for(std::size_t s = 0ul; s < local_aux.size(); ++s) {
+      std::vector<std::pair<std::size_t, Future<Tile> > > slice;
+      slice.swap(next_slice);
+      if(s + 1ul < local_aux.size())
+        next_slice = detail::request_aux_slice(b, local_aux[s + 1ul]);
+      if(slice.empty())
+        continue;
+
+      // W(X,i,mu) = sum_rho C(rho,i) B(X,rho,mu) for the X of this slice
+      const auto x_tile = aux.tile(local_aux[s] + aux.tiles_range().first);
+      const std::size_t n_x = x_tile.second - x_tile.first;
+      w.assign(n_x * n_occ * n_mu, numeric_type(0));
+      for(auto& b_tile : slice) {
+        const Tile& tile = b_tile.second.get();
+        const std::size_t r0 = tile.range().lobound()[1] - rho.elements_range().first;
+        const std::size_t m0 = tile.range().lobound()[2] - mu.elements_range().first;
+        const std::size_t nr = tile.range().extent_data()[1],
+            nm = tile.range().extent_data()[2];
+        for(std::size_t x = 0ul; x < n_x; ++x)
+          math::gemm(madness::cblas::Trans, madness::cblas::NoTrans, n_occ, nm,
+              nr, numeric_type(1), c_matrix.data() + r0 * n_occ, n_occ,
+              tile.data() + x * nr * nm, nm, numeric_type(1),
+              w.data() + x * n_occ * n_mu + m0, n_mu);
+      }
+
+      // K(mu,nu) += sum_{X,i} W(X,i,mu) W(X,i,nu)
+      math::gemm(madness::cblas::Trans, madness::cblas::NoTrans, n_mu, n_mu,
+          n_x * n_occ, numeric_type(1), w.data(), n_mu, w.data(), n_mu,
+          numeric_type(1), k_matrix.data(), n_mu);
+    }
+    w = std::vector<numeric_type>();
+
+    // Sum the contributions of all processes
+    world.gop.sum(k_matrix.data(), k_matrix.size());
+
+    // Set the local result tiles
+    const TiledRange trange{mu, mu};
+    const std::shared_ptr<typename array_type::pmap_interface> pmap =
+        Policy::default_pmap(world, trange.tiles_range().volume());
+    std::vector<std::pair<std::size_t, Tile> > result_tiles;
+    for(const auto ord : *pmap) {
+      Tile tile(trange.make_tile_range(ord));
+      const std::size_t m0 = tile.range().lobound()[0] - mu.elements_range().first;
+      const std::size_t n0 = tile.range().lobound()[1] - mu.elements_range().first;
+      const std::size_t nm = tile.range().extent_data()[0],
+          nn = tile.range().extent_data()[1];
+      for(std::size_t m = 0ul; m < nm; ++m)
+        std::copy(k_matrix.data() + (m0 + m) * n_mu + n0,
+            k_matrix.data() + (m0 + m) * n_mu + n0 + nn, tile.data() + m * nn);
+      result_tiles.emplace_back(ord, tile);
+    }
+
+    return detail::make_retiled_array<array_type>(world, trange, pmap,
+        result_tiles);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_DF_EXCHANGE_H__INCLUDED
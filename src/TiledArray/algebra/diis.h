@@ -26,13 +26,175 @@
 #ifndef TILEDARRAY_ALGEBRA_DIIS_H__INCLUDED
 #define TILEDARRAY_ALGEBRA_DIIS_H__INCLUDED
 
+#include <cstdio>
 #include <deque>
 #include <TiledArray/math/eigen.h>
 #include <TiledArray/algebra/utils.h>
+#include <TiledArray/checkpoint.h>
+#include <TiledArray/conversions/to_new_tile_type.h>
 #include "../dist_array.h"
 
 namespace TiledArray {
 
+  /// Storage of the DIIS history vectors
+  enum class DIISStorage {
+    memory, ///< The vectors are held in memory
+    compressed, ///< The vectors are held in memory in single precision
+    disk ///< The vectors are written to disk and read back when they are used
+  }; // enum class DIISStorage
+
+  namespace detail {
+
+    /// A DIIS history vector
+
+    /// Vectors of types other than \c DistArray<Tensor<T>,Policy> can only be
+    /// held in memory.
+    /// \tparam D The vector type
+    template <typename D>
+    class DIISVector {
+      D data_; ///< The vector
+
+    public:
+      /// Constructor
+
+      /// \param data The vector
+      /// \param storage The storage of the vector
+      /// \throw TiledArray::Exception When \c storage is not
+      /// \c DIISStorage::memory
+      DIISVector(const D& data, const DIISStorage storage, const std::string&) :
+        data_(data)
+      {
+        TA_USER_ASSERT(storage == DIISStorage::memory,
+            "DIIS: This vector type can only be stored in memory.");
+      }
+
+      /// Vector accessor
+
+      /// \return The vector
+      const D& get() const { return data_; }
+    }; // class DIISVector
+
+    /// Convert the element type of a tensor
+    template <typename To, typename From>
+    struct DIISTileCast {
+      To operator()(const From& tile) const { return To(tile); }
+    }; // struct DIISTileCast
+
+    /// A DIIS history vector of a dense tensor array
+
+    /// A compressed vector is held as an array of single precision tiles, with
+    /// the tiled range, shape, and process map of the original array. A disk
+    /// vector is written with \c write_checkpoint and read back with the
+    /// process map of the original array, so each process reads only its own
+    /// tiles; the files are removed when the vector is destroyed. The
+    /// accessor returns a new array for these vectors, so their memory is
+    /// only used while it is alive.
+    /// \tparam T The element type of the tensor
+    /// \tparam Policy The array policy type
+    template <typename T, typename Policy>
+    class DIISVector<DistArray<Tensor<T>, Policy> > {
+      typedef DistArray<Tensor<T>, Policy> array_type;
+      typedef DistArray<Tensor<float>, Policy> compressed_type;
+
+      DIISStorage storage_; ///< The storage of the vector
+      array_type data_; ///< The vector, if it is held in memory
+      compressed_type compressed_; ///< The compressed vector
+      std::string prefix_; ///< The file prefix of a disk vector
+      World* world_; ///< The world of the vector
+      std::shared_ptr<typename array_type::pmap_interface> pmap_; ///< The process map of the vector
+
+      static compressed_type compress(const array_type& data, std::false_type) {
+        return to_new_tile_type(data, DIISTileCast<Tensor<float>, Tensor<T> >());
+      }
+      static compressed_type compress(const array_type& data, std::true_type) {
+        return data;
+      }
+      static array_type decompress(const compressed_type& data, std::false_type) {
+        return to_new_tile_type(data, DIISTileCast<Tensor<T>, Tensor<float> >());
+      }
+      static array_type decompress(const compressed_type& data, std::true_type) {
+        return data;
+      }
+
+      /// Unique file prefix of a disk vector
+
+      /// The prefix is the same on all processes, since history vectors are
+      /// created collectively in the same order.
+      static std::string make_prefix(const std::string& directory) {
+        static std::size_t counter = 0ul;
+        std::stringstream ss;
+        ss << directory << "/ta_diis." << counter++;
+        return ss.str();
+      }
+
+    public:
+      /// Constructor
+
+      /// This is a collective operation for disk vectors.
+      /// \param data The vector
+      /// \param storage The storage of the vector
+      /// \param directory The directory of the vector files
+      DIISVector(const array_type& data, const DIISStorage storage,
+          const std::string& directory) :
+        storage_(storage), data_(), compressed_(), prefix_(),
+        world_(& data.world()), pmap_(data.pmap())
+      {
+        switch(storage) {
+          case DIISStorage::memory:
+            data_ = data;
+            break;
+          case DIISStorage::compressed:
+            compressed_ = compress(data, std::is_same<T, float>());
+            break;
+          case DIISStorage::disk:
+            prefix_ = make_prefix(directory);
+            write_checkpoint(data, prefix_);
+            break;
+        }
+      }
+
+      DIISVector(const DIISVector&) = delete;
+      DIISVector& operator=(const DIISVector&) = delete;
+
+      DIISVector(DIISVector&& other) :
+        storage_(other.storage_), data_(std::move(other.data_)),
+        compressed_(std::move(other.compressed_)),
+        prefix_(std::move(other.prefix_)), world_(other.world_),
+        pmap_(std::move(other.pmap_))
+      { other.prefix_.clear(); }
+
+      /// Destructor
+
+      /// The files of a disk vector are removed. This does not need to
+      /// synchronize the processes, since reading a vector is a collective
+      /// operation that ends with a fence.
+      ~DIISVector() {
+        if(prefix_.empty())
+          return;
+        std::remove(checkpoint_file_name(prefix_, world_->rank()).c_str());
+        std::remove(checkpoint_file_name(prefix_, world_->rank(), ".idx").c_str());
+        if(world_->rank() == 0)
+          std::remove((prefix_ + ".meta").c_str());
+      }
+
+      /// Vector accessor
+
+      /// This is a collective operation for disk vectors.
+      /// \return The vector
+      array_type get() const {
+        switch(storage_) {
+          case DIISStorage::compressed:
+            return decompress(compressed_, std::is_same<T, float>());
+          case DIISStorage::disk:
+            return read_checkpoint<array_type>(*world_, prefix_, pmap_);
+          default:
+            return data_;
+        }
+      }
+    }; // class DIISVector
+
+  } // namespace detail
+
   /// DIIS (``direct inversion of iterative subspace'') extrapolation
 
   /// The DIIS class provides DIIS extrapolation to an iterative solver of
@@ -76,7 +238,15 @@ namespace TiledArray {
   ///
   /// The original DIIS reference: P. Pulay, Chem. Phys. Lett. 73, 393 (1980).
   ///
-  /// \tparam D type of \c x
+  /// Only the elements of B for the most recent error are computed in each
+  /// iteration, and their reductions are started together. The history
+  /// vectors may be held in single precision or on disk, see
+  /// \c set_storage() ; the B matrix is always computed from the full
+  /// precision error that is given to \c extrapolate() .
+  ///
+  /// \tparam D type of \c x ; in addition to the functions used by
+  /// \c ConjugateGradientSolver , \c D must provide
+  /// <tt> Future<value_type> dot_product_async(const D&, const D&) </tt>
   template <typename D>
   class DIIS {
     public:
@@ -114,7 +284,9 @@ namespace TiledArray {
              iter(0), ngroup(ngr),
              ngroupdiis(ngr),
              damping_factor(dmp),
-             mixing_fraction(mf)
+             mixing_fraction(mf),
+             storage_(DIISStorage::memory),
+             directory_(".")
            {
             init();
            }
@@ -153,23 +325,30 @@ namespace TiledArray {
           B_ = Bcrop;
         }
 
-        // push {x, error} to the set
-        x_.push_back(x);
-        errors_.push_back(error);
-        const unsigned int nvec = errors_.size();
+        // compute the most recent elements of B, B(i,j) = <ei|ej>
+        const unsigned int nvec = errors_.size() + 1;
+        {
+          std::vector<Future<value_type> > b_f;
+          b_f.reserve(nvec);
+          for (unsigned int i=0; i < nvec-1; i++)
+            b_f.push_back(dot_product_async(errors_[i].get(), error));
+          b_f.push_back(dot_product_async(error, error));
+          for (unsigned int i=0; i < nvec-1; i++)
+            B_(i,nvec-1) = B_(nvec-1,i) = b_f[i].get();
+          B_(nvec-1,nvec-1) = b_f[nvec-1].get();
+        }
+
+        // and push {x, error} to the set
+        x_.emplace_back(x, storage_, directory_);
+        errors_.emplace_back(error, storage_, directory_);
         TA_USER_ASSERT(x_.size() == errors_.size(),
                        "DIIS: numbers of guess and error vectors do not match, likely due to a programming error");
 
-        // and compute the most recent elements of B, B(i,j) = <ei|ej>
-        for (unsigned int i=0; i < nvec-1; i++)
-          B_(i,nvec-1) = B_(nvec-1,i) = dot_product(errors_[i], errors_[nvec-1]);
-        B_(nvec-1,nvec-1) = dot_product(errors_[nvec-1], errors_[nvec-1]);
-
         if (iter == 1) { // the first iteration
           if (not x_extrap_.empty() && do_mixing) {
             zero(x);
-            axpy(x, (1.0-mixing_fraction), x_[0]);
-            axpy(x, mixing_fraction, x_extrap_[0]);
+            axpy(x, (1.0-mixing_fraction), x_[0].get());
+            axpy(x, mixing_fraction, x_extrap_[0].get());
           }
         }
         else if (iter > start && (((iter - start) % ngroup) < ngroupdiis)) { // not the first iteration and need to extrapolate?
@@ -237,19 +416,19 @@ namespace TiledArray {
             for (unsigned int k=nskip, kk=1; k < nvec; ++k, ++kk) {
               if (not do_mixing || x_extrap_.empty()) {
                 //std::cout << "contrib " << k << " c=" << c[kk] << ":" << std::endl << x_[k] << std::endl;
-                axpy(x, c[kk], x_[k]);
+                axpy(x, c[kk], x_[k].get());
                 if (extrapolate_error)
-                  axpy(error, c[kk], errors_[k]);
+                  axpy(error, c[kk], errors_[k].get());
               } else {
-                axpy(x, c[kk] * (1.0 - mixing_fraction), x_[k]);
-                axpy(x, c[kk] * mixing_fraction, x_extrap_[k]);
+                axpy(x, c[kk] * (1.0 - mixing_fraction), x_[k].get());
+                axpy(x, c[kk] * mixing_fraction, x_extrap_[k].get());
               }
             }
           }
         } // do DIIS
 
         // only need to keep extrapolated x if doing mixing
-        if (do_mixing) x_extrap_.push_back(x);
+        if (do_mixing) x_extrap_.emplace_back(x, storage_, directory_);
       }
 
       /// calling this function forces the extrapolation to start upon next call
@@ -263,10 +442,22 @@ namespace TiledArray {
         iter=0;
         if (data) {
           const bool do_mixing = (mixing_fraction != 0.0);
-          if (do_mixing) x_extrap_.push_front(*data);
+          if (do_mixing) x_extrap_.emplace_front(*data, storage_, directory_);
         }
       }
 
+      /// Set the storage of the history vectors
+
+      /// Only vectors that are added after this call are affected. Compressed
+      /// and disk storage is only available for arrays of \c Tensor tiles.
+      /// \param storage The storage of the history vectors
+      /// \param directory The directory of the history files of disk
+      /// storage, which should not be shared with other jobs (default = ".")
+      void set_storage(DIISStorage storage, const std::string& directory = ".") {
+        storage_ = storage;
+        directory_ = directory;
+      }
+
     private:
       scalar_type error_;
       bool errorset_;
@@ -278,15 +469,17 @@ namespace TiledArray {
       unsigned int ngroupdiis;
       scalar_type damping_factor;
       scalar_type mixing_fraction;
+      DIISStorage storage_; //!< storage of new history vectors
+      std::string directory_; //!< directory of the history files
 
       typedef Eigen::Matrix<value_type, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> EigenMatrixX;
       typedef Eigen::Matrix<value_type, Eigen::Dynamic, 1> EigenVectorX;
 
       EigenMatrixX B_; //!< B(i,j) = <ei|ej>
 
-      std::deque<D> x_; //!< set of most recent x given as input (i.e. not exrapolated)
-      std::deque<D> errors_; //!< set of most recent errors
-      std::deque<D> x_extrap_; //!< set of most recent extrapolated x
+      std::deque<detail::DIISVector<D> > x_; //!< set of most recent x given as input (i.e. not exrapolated)
+      std::deque<detail::DIISVector<D> > errors_; //!< set of most recent errors
+      std::deque<detail::DIISVector<D> > x_extrap_; //!< set of most recent extrapolated x
 
       void set_error(scalar_type e) { error_ = e; errorset_ = true; }
       scalar_type error() { return error_; }
@@ -0,0 +1,244 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  energy_denominator.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_ENERGY_DENOMINATOR_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_ENERGY_DENOMINATOR_H__INCLUDED
+
+#include <TiledArray/conversions/foreach.h>
+#include <cmath>
+#include <initializer_list>
+#include <utility>
+
+namespace TiledArray {
+
+  /// Division by an energy denominator
+
+  /// Amplitude equations divide the residual by a denominator that is a sum
+  /// of one-index quantities, e.g.
+  /// <tt>t(a,b,i,j) = r(a,b,i,j) / (e_a + e_b - e_i - e_j)</tt> . Instead of
+  /// storing the denominator as an array with the rank of the residual,
+  /// \c EnergyDenominator holds a replicated copy of the orbital energies of
+  /// each mode, and computes the denominator of each row of a tile from the
+  /// sum over the leading modes plus the energies of the last mode, so the
+  /// inner loop is a contiguous division that the compiler vectorizes. The
+  /// 2-norm of the residual is accumulated in the same pass over the data.
+  /// \code
+  /// TiledArray::EnergyDenominator<double> denom({ e_vir, e_vir, e_occ, e_occ },
+  ///     { 1.0, 1.0, -1.0, -1.0 });
+  /// for(...) {
+  ///   r("a,b,i,j") = ...;
+  ///   const double rnorm = denom(r); // r now holds the update of t
+  ///   ...
+  /// }
+  /// \endcode
+  /// \tparam T The numeric type of the energies
+  template <typename T>
+  class EnergyDenominator {
+    std::vector<std::vector<T> > energies_; ///< The scaled energies of each
+                                            ///< mode, by element index
+    T shift_; ///< A constant added to each denominator
+
+  public:
+    typedef T numeric_type; ///< The numeric type of the energies
+
+    /// Constructor
+
+    /// \tparam Tile The tile type of the energy arrays
+    /// \tparam Policy The policy type of the energy arrays
+    /// \param energies The one-dimensional arrays of the energies of each
+    /// mode
+    /// \param factors The factor of the energies of each mode, e.g. \c 1 for
+    /// virtual and \c -1 for occupied orbitals
+    /// \param shift A constant added to each denominator, e.g. a level shift
+    /// \throw TiledArray::Exception When the number of factors is not the
+    /// number of modes, or an energy array is not one-dimensional.
+    /// \note This is a collective operation, since the tiles of the energy
+    /// arrays are fetched by all processes.
+    template <typename Tile, typename Policy>
+    EnergyDenominator(const std::vector<DistArray<Tile, Policy> >& energies,
+        const std::vector<T>& factors, const T shift = T(0)) :
+      energies_(), shift_(shift)
+    {
+      TA_USER_ASSERT(energies.size() == factors.size(),
+          "EnergyDenominator: The number of factors does not match the number of modes.");
+      TA_USER_ASSERT(! energies.empty(),
+          "EnergyDenominator: No modes are given.");
+
+      for(std::size_t d = 0ul; d < energies.size(); ++d) {
+        const DistArray<Tile, Policy>& array = energies[d];
+        TA_USER_ASSERT(array.trange().rank() == 1u,
+            "EnergyDenominator: The energies of a mode must be a one-dimensional array.");
+
+        const auto& range = array.trange().elements_range();
+        std::vector<T> mode(range.upbound(0), T(0));
+        for(std::size_t t = 0ul; t < array.size(); ++t) {
+          if(array.is_zero(t))
+            continue;
+          const Tile tile = array.find(t).get();
+          for(std::size_t i = 0ul; i < tile.size(); ++i)
+            mode[tile.range().lobound(0) + i] = factors[d] * tile[i];
+        }
+        energies_.push_back(std::move(mode));
+      }
+    }
+
+    /// Constructor
+
+    /// \tparam Tile The tile type of the energy arrays
+    /// \tparam Policy The policy type of the energy arrays
+    /// \param energies The one-dimensional arrays of the energies of each
+    /// mode
+    /// \param factors The factor of the energies of each mode
+    /// \param shift A constant added to each denominator
+    template <typename Tile, typename Policy>
+    EnergyDenominator(std::initializer_list<DistArray<Tile, Policy> > energies,
+        const std::vector<T>& factors, const T shift = T(0)) :
+      EnergyDenominator(std::vector<DistArray<Tile, Policy> >(energies),
+          factors, shift)
+    { }
+
+    /// \return The number of modes
+    unsigned int rank() const { return energies_.size(); }
+
+    /// Denominator of an element
+
+    /// \tparam Index The index type
+    /// \param index The element index
+    /// \return The denominator of the element
+    template <typename Index>
+    T denominator(const Index& index) const {
+      T result = shift_;
+      for(unsigned int d = 0u; d < energies_.size(); ++d)
+        result += energies_[d][index[d]];
+      return result;
+    }
+
+    /// Divide the elements of a tile by their denominators
+
+    /// \tparam Tile The tile type
+    /// \param tile The tile that is modified
+    /// \return The squared 2-norms of \c tile before and after the division
+    template <typename Tile>
+    std::pair<double, double> apply(Tile& tile) const {
+      const unsigned int rank = tile.range().rank();
+      TA_ASSERT(rank == energies_.size());
+      const auto* MADNESS_RESTRICT const lower = tile.range().lobound_data();
+      const auto* MADNESS_RESTRICT const extent = tile.range().extent_data();
+      const std::size_t n = extent[rank - 1u];
+      const T* MADNESS_RESTRICT const last =
+          energies_[rank - 1u].data() + lower[rank - 1u];
+
+      auto* MADNESS_RESTRICT data = tile.data();
+      const std::size_t rows = tile.size() / n;
+      std::vector<std::size_t> index(rank, 0ul);
+      double before = 0.0, after = 0.0;
+      for(std::size_t row = 0ul; row < rows; ++row, data += n) {
+        // The denominator of the leading modes
+        T outer = shift_;
+        for(unsigned int d = 0u; d + 1u < rank; ++d)
+          outer += energies_[d][lower[d] + index[d]];
+
+        for(std::size_t j = 0ul; j < n; ++j) {
+          const auto x = data[j];
+          before += x * x;
+          data[j] = x / (outer + last[j]);
+          after += data[j] * data[j];
+        }
+
+        // Increment the index of the leading modes
+        for(unsigned int d = rank - 1u; d-- > 0u; ) {
+          if(++index[d] < extent[d])
+            break;
+          index[d] = 0ul;
+        }
+      }
+
+      return std::make_pair(before, after);
+    }
+
+    /// Divide the elements of an array by their denominators
+
+    /// \tparam Tile The tile type
+    /// \tparam Policy The array policy type
+    /// \param array The array that is modified, e.g. a residual
+    /// \param fence If \c true , fence before the data is modified (see
+    /// \c foreach_inplace() )
+    /// \return The 2-norm of \c array before the division
+    /// \throw TiledArray::Exception When the rank of \c array is not the
+    /// number of modes, or it is larger than the energies of a mode.
+    /// \note This is a collective operation.
+    template <typename Tile, typename Policy>
+    double operator()(DistArray<Tile, Policy>& array, const bool fence = true) const {
+      TA_USER_ASSERT(array.trange().rank() == energies_.size(),
+          "EnergyDenominator: The rank of the array does not match the number of modes.");
+      for(unsigned int d = 0u; d < energies_.size(); ++d)
+        TA_USER_ASSERT(array.trange().elements_range().upbound(d) <= energies_[d].size(),
+            "EnergyDenominator: The array is larger than the energies of a mode.");
+
+      double norm2 = 0.0;
+      madness::Spinlock lock;
+      inplace(array, [&] (Tile& tile) -> double {
+        const std::pair<double, double> norms = apply(tile);
+        madness::ScopedMutex<madness::Spinlock> locker(&lock);
+        norm2 += norms.first;
+        return norms.second;
+      }, fence);
+
+      array.world().gop.sum(norm2);
+      return std::sqrt(norm2);
+    }
+
+  private:
+
+    /// Apply a tile operation to a dense array
+    template <typename Tile, typename Op>
+    static void inplace(DistArray<Tile, DensePolicy>& array, const Op& op,
+        const bool fence)
+    {
+      const auto tile_op = [&op] (Tile& tile) { op(tile); };
+      foreach_inplace(array, tile_op, fence);
+
+      // Wait for the tasks, which refer to op
+      for(const auto t : *array.pmap())
+        array.find(t).get();
+    }
+
+    /// Apply a tile operation to a sparse array
+
+    /// The shape is computed from the norms of the modified tiles.
+    template <typename Tile, typename Op>
+    static void inplace(DistArray<Tile, SparsePolicy>& array, const Op& op,
+        const bool fence)
+    {
+      foreach_inplace(array, [&op] (Tile& tile) -> float {
+        return std::sqrt(op(tile));
+      }, fence);
+    }
+
+  }; // class EnergyDenominator
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_ENERGY_DENOMINATOR_H__INCLUDED
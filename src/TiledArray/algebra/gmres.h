@@ -0,0 +1,247 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Eduard Valeyev
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  gmres.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_GMRES_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_GMRES_H__INCLUDED
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <TiledArray/algebra/utils.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+
+  /// Solves linear system <tt> a(x) = b </tt> using the restarted GMRES
+  /// solver where \c a is a linear function of \c x .
+
+  /// The preconditioner is applied from the right, so the residual that is
+  /// minimized is that of the original system. The Arnoldi basis is
+  /// orthogonalized with classical Gram-Schmidt, which starts the dot
+  /// products of a new vector with all basis vectors, and its norm, together;
+  /// an Arnoldi step therefore waits for one overlapped reduction instead of
+  /// the <tt>j + 2</tt> sequential reductions of modified Gram-Schmidt. The
+  /// norm of the orthogonalized vector is obtained from these products;
+  /// when that loses too many digits, the vector is orthogonalized a second
+  /// time. The residual of the least-squares problem is tracked with Givens
+  /// rotations, so only a restart evaluates the true residual.
+  ///
+  /// \c a may evaluate a TiledArray expression, see
+  /// \c PipelinedConjugateGradientSolver .
+  /// \tparam D type of \c x and \c b, as well as the preconditioner; see
+  /// \c PipelinedConjugateGradientSolver for the required functions
+  /// \tparam F type that evaluates the LHS, will call \c F::operator()(x,result) ,
+  /// \c D must implement <tt> operator()(const D&, D&) const </tt>
+  template <typename D, typename F>
+  struct GMRESSolver {
+    typedef typename D::element_type value_type;
+
+    /// \param restart The size of the Krylov subspace before a restart [default = 30]
+    /// \param max_niter The maximum number of iterations over all restarts;
+    /// zero selects the number of elements in \c x [default = 0]
+    explicit GMRESSolver(unsigned int restart = 30, unsigned int max_niter = 0) :
+      restart_(restart), max_niter_(max_niter)
+    {
+      TA_USER_ASSERT(restart_ > 0u, "GMRES: restart must be positive");
+    }
+
+    /// \param a object of type F
+    /// \param b RHS
+    /// \param x unknown
+    /// \param preconditioner
+    /// \param convergence_target The convergence target [default = -1.0]
+    /// \return The 2-norm of the residual, a(x) - b, divided by the number of
+    /// elements in the residual, as estimated by the least-squares problem.
+    value_type operator()(F& a, const D& b, D& x, const D& preconditioner,
+        value_type convergence_target = -1.0)
+    {
+
+      std::size_t n = size(x);
+      assert(n == size(preconditioner));
+
+      // approximate the condition number as the ratio of the min and max elements of the preconditioner
+      // assuming that preconditioner is the approximate inverse of A in Ax - b =0
+      const value_type precond_min = minabs_value(preconditioner);
+      const value_type precond_max = maxabs_value(preconditioner);
+      const value_type cond_number = precond_max / precond_min;
+      // if convergence target is given, estimate of how tightly the system can be converged
+      if (convergence_target < 0.0) {
+        convergence_target = 1e-15 * cond_number;
+      }
+      else { // else warn if the given system is not sufficiently well conditioned
+        if (convergence_target < 1e-15 * cond_number)
+          std::cout << "WARNING: GMRES convergence target (" << convergence_target
+                    << ") may be too low for 64-bit precision" << std::endl;
+      }
+
+      const unsigned int max_niter = (max_niter_ > 0u ? max_niter_ : n);
+      const std::size_t rhs_size = size(b);
+      const unsigned int m = restart_;
+
+      // starting guess: x_0 = D^-1 . b
+      D XX = copy(b);
+      vec_multiply(XX, preconditioner);
+
+      // Arnoldi basis, Hessenberg matrix (column-major), Givens rotations,
+      // and the right-hand side of the least-squares problem
+      std::vector<D> V;
+      std::vector<value_type> H((m + 1) * m), cs(m), sn(m), g(m + 1), h(m + 1);
+
+      unsigned int iter = 0;
+      while (true) {
+
+        // r = b - a(x)
+        D RR = clone(b);
+        a(XX, RR);
+        scale(RR, -1.0);
+        axpy(RR, 1.0, b);
+
+        const value_type beta = norm2(RR);
+        value_type rnorm = beta / rhs_size;
+        if (rnorm < convergence_target) {
+          assign(x, XX);
+          return rnorm;
+        }
+
+        V.clear();
+        V.push_back(RR);
+        scale(V[0], 1.0 / beta);
+        std::fill(g.begin(), g.end(), 0.0);
+        g[0] = beta;
+
+        unsigned int k = 0;
+        bool converged = false;
+        while (k < m) {
+          const unsigned int j = k;
+
+          // w = a(D^-1 . v_j)
+          D ZZ = copy(V[j]);
+          vec_multiply(ZZ, preconditioner);
+          D WW = clone(b);
+          a(ZZ, WW);
+
+          // classical Gram-Schmidt with all reductions in flight together
+          std::vector<Future<value_type> > h_f;
+          h_f.reserve(j + 1);
+          for (unsigned int i = 0; i <= j; ++i)
+            h_f.push_back(dot_product_async(WW, V[i]));
+          Future<value_type> ww_f = dot_product_async(WW, WW);
+
+          value_type hh = ww_f.get();
+          const value_type ww = hh;
+          for (unsigned int i = 0; i <= j; ++i) {
+            h[i] = h_f[i].get();
+            hh -= h[i] * h[i];
+          }
+          for (unsigned int i = 0; i <= j; ++i)
+            axpy(WW, -h[i], V[i]);
+
+          value_type h_jp1;
+          if (hh > 1e-2 * ww) {
+            h_jp1 = std::sqrt(hh);
+          } else {
+            // too much cancellation: orthogonalize once more
+            h_f.clear();
+            for (unsigned int i = 0; i <= j; ++i)
+              h_f.push_back(dot_product_async(WW, V[i]));
+            for (unsigned int i = 0; i <= j; ++i) {
+              const value_type c = h_f[i].get();
+              h[i] += c;
+              axpy(WW, -c, V[i]);
+            }
+            h_jp1 = norm2(WW);
+          }
+
+          // apply the previous rotations to the new column, then eliminate
+          // its subdiagonal element
+          for (unsigned int i = 0; i < j; ++i) {
+            const value_type t = cs[i] * h[i] + sn[i] * h[i + 1];
+            h[i + 1] = -sn[i] * h[i] + cs[i] * h[i + 1];
+            h[i] = t;
+          }
+          const value_type d = std::sqrt(h[j] * h[j] + h_jp1 * h_jp1);
+          cs[j] = h[j] / d;
+          sn[j] = h_jp1 / d;
+          h[j] = d;
+          for (unsigned int i = 0; i <= j; ++i)
+            H[j * (m + 1) + i] = h[i];
+          g[j + 1] = -sn[j] * g[j];
+          g[j] *= cs[j];
+
+          ++k;
+          ++iter;
+          rnorm = std::abs(g[k]) / rhs_size;
+          // a vanishing h_jp1 means the Krylov subspace is invariant, so the
+          // solution is exact
+          if (rnorm < convergence_target || h_jp1 == 0.0) {
+            converged = true;
+            break;
+          }
+          if (iter >= max_niter)
+            break;
+
+          if (k < m) {
+            scale(WW, 1.0 / h_jp1);
+            V.push_back(WW);
+          }
+        }
+
+        // solve the triangular least-squares system, y = H^-1 . g
+        std::vector<value_type> y(k);
+        for (unsigned int i = k; i-- > 0; ) {
+          value_type yi = g[i];
+          for (unsigned int l = i + 1; l < k; ++l)
+            yi -= H[l * (m + 1) + i] * y[l];
+          y[i] = yi / H[i * (m + 1) + i];
+        }
+
+        // x += D^-1 . V . y
+        D UU = copy(V[0]);
+        scale(UU, y[0]);
+        for (unsigned int i = 1; i < k; ++i)
+          axpy(UU, y[i], V[i]);
+        vec_multiply(UU, preconditioner);
+        axpy(XX, 1.0, UU);
+
+        if (converged) {
+          assign(x, XX);
+          return rnorm;
+        }
+        if (iter >= max_niter) {
+          assign(x, XX);
+          throw std::domain_error("GMRES: max # of iterations exceeded");
+        }
+      } // restart loop
+    }
+
+  private:
+    unsigned int restart_; ///< The size of the Krylov subspace
+    unsigned int max_niter_; ///< The maximum number of iterations
+  };
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_GMRES_H__INCLUDED
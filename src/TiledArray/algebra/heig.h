@@ -0,0 +1,168 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  heig.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_HEIG_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_HEIG_H__INCLUDED
+
+#include <tuple>
+#include <vector>
+#include <Eigen/Eigenvalues>
+#include <TiledArray/conversions/eigen.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// Gather a distributed matrix on one process
+
+    /// Only \c root fetches tiles; the other processes return an empty
+    /// matrix.
+    /// \tparam Tile The tile type
+    /// \tparam Policy The array policy type
+    /// \param a The matrix array
+    /// \param root The process that gathers the matrix
+    /// \return The matrix on \c root , otherwise an empty matrix
+    template <typename Tile, typename Policy>
+    Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic, Eigen::Dynamic>
+    gather_matrix(const DistArray<Tile, Policy>& a, const ProcessID root) {
+      typedef Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic,
+          Eigen::Dynamic> matrix_type;
+      TA_USER_ASSERT(a.trange().tiles_range().rank() == 2u,
+          "TiledArray::gather_matrix(): The array must be a matrix.");
+      if(a.world().rank() != root)
+        return matrix_type();
+      const auto* const extent = a.trange().elements_range().extent_data();
+      return array_to_eigen_block(a, 0ul, extent[0], 0ul, extent[1]);
+    }
+
+    /// Broadcast a vector of real values from one process
+
+    /// \tparam T The value type
+    /// \param world The world of the processes
+    /// \param values The values; on processes other than \c root only the size
+    /// is used
+    /// \param root The process that holds the values
+    template <typename T>
+    void broadcast_values(World& world, std::vector<T>& values, const ProcessID root) {
+      if(world.rank() != root)
+        std::fill(values.begin(), values.end(), T(0));
+      world.gop.sum(values.data(), values.size());
+    }
+
+  } // namespace detail
+
+  /// Hermitian eigenvalue problem
+
+  /// Solves <tt>a * x = x * diag(lambda)</tt> . The matrix is gathered on
+  /// process 0, which solves the problem, and the eigenvectors are sent back
+  /// directly to the owners of their tiles; no process other than 0 holds
+  /// more than its own tiles. This is a collective operation.
+  /// \tparam Tile The tile type
+  /// \tparam Policy The array policy type
+  /// \param a A Hermitian matrix
+  /// \return The eigenvalues in ascending order and the eigenvectors, which
+  /// have the tiled range of \c a
+  /// \throw TiledArray::Exception When \c a is not a square matrix.
+  template <typename Tile, typename Policy>
+  std::tuple<std::vector<typename Eigen::NumTraits<typename Tile::value_type>::Real>,
+      DistArray<Tile, Policy> >
+  heig(const DistArray<Tile, Policy>& a) {
+    typedef Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic, Eigen::Dynamic> matrix_type;
+    typedef typename Eigen::NumTraits<typename Tile::value_type>::Real real_type;
+
+    World& world = a.world();
+    const auto& trange = a.trange();
+    TA_USER_ASSERT((trange.tiles_range().rank() == 2u) &&
+        (trange.elements_range().extent(0) == trange.elements_range().extent(1)),
+        "TiledArray::heig(): The array must be a square matrix.");
+    const std::size_t n = trange.elements_range().extent(0);
+
+    const matrix_type matrix = detail::gather_matrix(a, 0);
+    std::vector<real_type> values(n);
+    matrix_type vectors;
+    if(world.rank() == 0) {
+      Eigen::SelfAdjointEigenSolver<matrix_type> solver(matrix);
+      TA_USER_ASSERT(solver.info() == Eigen::Success,
+          "TiledArray::heig(): The eigensolver did not converge.");
+      std::copy_n(solver.eigenvalues().data(), n, values.begin());
+      vectors = solver.eigenvectors();
+    }
+    detail::broadcast_values(world, values, 0);
+
+    return std::make_tuple(std::move(values),
+        eigen_block_to_array<DistArray<Tile, Policy> >(world, trange, vectors, 0ul, 0ul));
+  }
+
+  /// Generalized Hermitian-definite eigenvalue problem
+
+  /// Solves <tt>a * x = b * x * diag(lambda)</tt> , e.g. the Roothaan-Hall
+  /// equations with the overlap matrix \c b . See \c heig(a) for the
+  /// distribution of the work. This is a collective operation.
+  /// \tparam Tile The tile type
+  /// \tparam Policy The array policy type
+  /// \param a A Hermitian matrix
+  /// \param b A Hermitian positive definite matrix with the tiled range of \c a
+  /// \return The eigenvalues in ascending order and the eigenvectors, which
+  /// have the tiled range of \c a and are normalized so that
+  /// <tt>x^H * b * x = 1</tt>
+  /// \throw TiledArray::Exception When \c a is not a square matrix.
+  /// \throw TiledArray::Exception When the tiled ranges of \c a and \c b differ.
+  template <typename Tile, typename Policy>
+  std::tuple<std::vector<typename Eigen::NumTraits<typename Tile::value_type>::Real>,
+      DistArray<Tile, Policy> >
+  heig(const DistArray<Tile, Policy>& a, const DistArray<Tile, Policy>& b) {
+    typedef Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic, Eigen::Dynamic> matrix_type;
+    typedef typename Eigen::NumTraits<typename Tile::value_type>::Real real_type;
+
+    World& world = a.world();
+    const auto& trange = a.trange();
+    TA_USER_ASSERT((trange.tiles_range().rank() == 2u) &&
+        (trange.elements_range().extent(0) == trange.elements_range().extent(1)),
+        "TiledArray::heig(): The array must be a square matrix.");
+    TA_USER_ASSERT(b.trange() == trange,
+        "TiledArray::heig(): The tiled ranges of a and b must be equal.");
+    const std::size_t n = trange.elements_range().extent(0);
+
+    const matrix_type a_matrix = detail::gather_matrix(a, 0);
+    const matrix_type b_matrix = detail::gather_matrix(b, 0);
+    std::vector<real_type> values(n);
+    matrix_type vectors;
+    if(world.rank() == 0) {
+      Eigen::GeneralizedSelfAdjointEigenSolver<matrix_type> solver(a_matrix, b_matrix);
+      TA_USER_ASSERT(solver.info() == Eigen::Success,
+          "TiledArray::heig(): The eigensolver did not converge.");
+      std::copy_n(solver.eigenvalues().data(), n, values.begin());
+      vectors = solver.eigenvectors();
+    }
+    detail::broadcast_values(world, values, 0);
+
+    return std::make_tuple(std::move(values),
+        eigen_block_to_array<DistArray<Tile, Policy> >(world, trange, vectors, 0ul, 0ul));
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_HEIG_H__INCLUDED
@@ -0,0 +1,195 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  incremental_eval.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_INCREMENTAL_EVAL_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_INCREMENTAL_EVAL_H__INCLUDED
+
+#include <TiledArray/conversions/retile.h>
+#include <string>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Variable list of an array
+
+    /// \param rank The rank of the array
+    /// \return The variable list <tt>"i0,i1,..."</tt> with \c rank variables
+    inline std::string delta_vars(const unsigned int rank) {
+      std::string vars;
+      for(unsigned int d = 0u; d < rank; ++d)
+        vars += (d ? ",i" : "i") + std::to_string(d);
+      return vars;
+    }
+
+  } // namespace detail
+
+  /// Tiles that changed between two versions of an array
+
+  /// \tparam Tile The tile type
+  /// \param array The new version of the array
+  /// \param ref The old version of the array
+  /// \param tolerance The change threshold of a tile
+  /// \return The difference <tt>array - ref</tt> , where the tiles with a
+  /// norm that is not greater than \c tolerance are zero
+  /// \throw TiledArray::Exception When \c array and \c ref do not have the
+  /// same tiled range.
+  /// \note This is a collective operation.
+  template <typename Tile>
+  inline DistArray<Tile, SparsePolicy>
+  delta(const DistArray<Tile, SparsePolicy>& array,
+      const DistArray<Tile, SparsePolicy>& ref, const double tolerance)
+  {
+    typedef DistArray<Tile, SparsePolicy> array_type;
+
+    TA_USER_ASSERT(array.trange() == ref.trange(),
+        "TiledArray::delta(): The arrays must have the same tiled range.");
+    const std::string vars = detail::delta_vars(array.trange().rank());
+    array_type diff;
+    diff(vars) = array(vars) - ref(vars);
+
+    std::vector<std::pair<std::size_t, Tile> > tiles;
+    for(const auto ord : *diff.pmap()) {
+      if(diff.is_zero(ord))
+        continue;
+      const Tile tile = diff.find(ord).get();
+      if(tile.norm() > tolerance)
+        tiles.emplace_back(ord, tile);
+    }
+
+    return detail::make_retiled_array<array_type>(diff.world(), diff.trange(),
+        diff.pmap(), tiles);
+  }
+
+  /// Incremental evaluation of a linear operation
+
+  /// In the last iterations of an iterative solver, most tiles of the
+  /// solution change by less than the convergence threshold, but each
+  /// iteration evaluates all tiles of the operations that depend on it. When
+  /// an operation is linear in its argument, e.g. the contraction
+  /// <tt>r("a,b,i,j") = v("a,b,c,d") * t("c,d,i,j")</tt> , the result of
+  /// the new argument is the result of the old argument plus the result of
+  /// their difference. \c IncrementalEval stores the last argument and
+  /// result, and evaluates the operation with the tiles of the argument that
+  /// changed by more than the tolerance (see \c delta() ). The other tiles
+  /// of the difference are zero, so the sparse contractions skip them, and
+  /// the result tiles that do not depend on a changed tile are reused.
+  ///
+  /// The changes below the tolerance are not dropped: the stored argument is
+  /// the sum of the applied changes, so a tile is updated once its
+  /// accumulated change exceeds the tolerance. The result is therefore the
+  /// operation applied to an argument that differs from the given one by no
+  /// more than the tolerance in each tile.
+  /// \code
+  /// TiledArray::IncrementalEval<TSpArrayD> ladder(1.0e-10);
+  /// for(...) {
+  ///   TSpArrayD r = ladder(t, [&] (const TSpArrayD& x, TSpArrayD& y) {
+  ///     y("a,b,i,j") = v("a,b,c,d") * x("c,d,i,j");
+  ///   });
+  ///   ...
+  /// }
+  /// \endcode
+  /// \tparam Array The array type, which must have a sparse policy
+  template <typename Array>
+  class IncrementalEval {
+    static_assert(! is_dense<Array>::value,
+        "IncrementalEval requires arrays with a sparse policy.");
+
+    double tolerance_; ///< The change threshold of a tile
+    Array arg_; ///< The argument of the stored result
+    Array result_; ///< The last result
+    std::size_t changed_; ///< The number of changed tiles of the last argument
+
+  public:
+
+    /// Constructor
+
+    /// \param tolerance The change threshold of an argument tile
+    explicit IncrementalEval(const double tolerance) :
+      tolerance_(tolerance), arg_(), result_(), changed_(0ul)
+    { }
+
+    /// \return The change threshold of an argument tile
+    double tolerance() const { return tolerance_; }
+
+    /// \return The number of argument tiles that were used by the last
+    /// evaluation
+    std::size_t changed_tiles() const { return changed_; }
+
+    /// Remove the stored argument and result
+
+    /// The next evaluation evaluates all tiles.
+    void reset() {
+      arg_ = Array();
+      result_ = Array();
+      changed_ = 0ul;
+    }
+
+    /// Evaluate the operation
+
+    /// \tparam Op The operation type
+    /// \param arg The argument of the operation
+    /// \param op The operation, with signature
+    /// <tt>void op(const Array& x, Array& y)</tt> , which assigns an
+    /// expression that is linear in \c x to \c y
+    /// \return The result of \c op
+    /// \throw TiledArray::Exception When the tiled range of \c arg is not that
+    /// of the last argument.
+    /// \note This is a collective operation.
+    template <typename Op>
+    Array operator()(const Array& arg, const Op& op) {
+      if(! result_.is_initialized()) {
+        op(arg, result_);
+        arg_ = arg;
+        changed_ = 0ul;
+        for(std::size_t i = 0ul; i < arg.size(); ++i)
+          changed_ += (arg.is_zero(i) ? 0ul : 1ul);
+        return result_;
+      }
+
+      const Array d = delta(arg, arg_, tolerance_);
+      changed_ = 0ul;
+      for(std::size_t i = 0ul; i < d.size(); ++i)
+        changed_ += (d.is_zero(i) ? 0ul : 1ul);
+      if(changed_ == 0ul)
+        return result_;
+
+      Array d_result;
+      op(d, d_result);
+
+      const std::string arg_vars = detail::delta_vars(arg.trange().rank());
+      const std::string vars = detail::delta_vars(result_.trange().rank());
+      Array result, next_arg;
+      result(vars) = result_(vars) + d_result(vars);
+      next_arg(arg_vars) = arg_(arg_vars) + d(arg_vars);
+      result_ = result;
+      arg_ = next_arg;
+      return result;
+    }
+
+  }; // class IncrementalEval
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_INCREMENTAL_EVAL_H__INCLUDED
@@ -0,0 +1,361 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  multi_contract.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_MULTI_CONTRACT_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_MULTI_CONTRACT_H__INCLUDED
+
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/expressions/variable_list.h>
+#include <algorithm>
+#include <string>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Process map of a stack of arrays
+
+    /// A stack of \c n arrays has an extra dimension with \c n tiles of size
+    /// one, which is the first or the last dimension. Each tile of the stack
+    /// is owned by the owner of the corresponding array tile in the process
+    /// map of the arrays, so the stack is assembled from local tiles when the
+    /// arrays have that process map.
+    class StackedPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const std::shared_ptr<Pmap> pmap_; ///< The process map of the arrays
+      const size_type n_; ///< The number of stacked arrays
+      const bool front_; ///< The stack dimension is the first dimension
+
+      /// \return The ordinal of the array tile of stack tile \c tile
+      size_type base(const size_type tile) const {
+        return (front_ ? tile % pmap_->size() : tile / n_);
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct a stacked process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param pmap The process map of the stacked arrays
+      /// \param n The number of stacked arrays
+      /// \param front If \c true , the stack dimension is the first dimension;
+      /// otherwise it is the last dimension
+      StackedPmap(World& world, const std::shared_ptr<Pmap>& pmap,
+          const size_type n, const bool front) :
+        Pmap(world, pmap->size() * n), pmap_(pmap), n_(n), front_(front)
+      {
+        TA_ASSERT(n_ > 0ul);
+        TA_ASSERT(pmap_->procs() == procs_);
+
+        local_.reserve(pmap_->local_size() * n_);
+        for(const size_type t : *pmap_)
+          for(size_type i = 0ul; i < n_; ++i)
+            local_.push_back(front_ ? i * pmap_->size() + t : t * n_ + i);
+        std::sort(local_.begin(), local_.end());
+      }
+
+      virtual ~StackedPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return pmap_->owner(base(tile));
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return pmap_->is_local(base(tile));
+      }
+
+    }; // class StackedPmap
+
+    /// Tiled range of a stack of arrays
+
+    /// \param trange The tiled range of the stacked arrays
+    /// \param n The number of stacked arrays
+    /// \param front If \c true , the stack dimension is the first dimension;
+    /// otherwise it is the last dimension
+    /// \return \c trange with a dimension of \c n tiles of size one
+    inline TiledRange stacked_trange(const TiledRange& trange,
+        const std::size_t n, const bool front)
+    {
+      std::vector<std::size_t> bounds(n + 1ul);
+      for(std::size_t i = 0ul; i <= n; ++i)
+        bounds[i] = i;
+      std::vector<TiledRange1> dims;
+      if(front)
+        dims.emplace_back(bounds.begin(), bounds.end());
+      for(unsigned int d = 0u; d < trange.rank(); ++d)
+        dims.push_back(trange.dim(d));
+      if(! front)
+        dims.emplace_back(bounds.begin(), bounds.end());
+      return TiledRange(dims.begin(), dims.end());
+    }
+
+    /// Stack arrays along a new dimension
+
+    /// The stack dimension has extent one in each tile, so a stack tile has
+    /// the data layout of the array tile it is copied from.
+    /// \tparam Array The array type
+    /// \param arrays The arrays, which have the same tiled range
+    /// \param front If \c true , the stack dimension is the first dimension;
+    /// otherwise it is the last dimension
+    /// \return The stack of \c arrays
+    template <typename Array>
+    inline Array stack_arrays(const std::vector<Array>& arrays, const bool front) {
+      typedef typename Array::value_type value_type;
+      typedef typename Array::size_type size_type;
+
+      const Array& first = arrays.front();
+      World& world = first.world();
+      const size_type n = arrays.size();
+      const size_type tiles = first.size();
+      const TiledRange trange = stacked_trange(first.trange(), n, front);
+      const std::shared_ptr<Pmap> pmap =
+          std::make_shared<StackedPmap>(world, first.pmap(), n, front);
+
+      // Stack tiles of arrays with another process map are fetched
+      std::vector<std::pair<size_type, Future<value_type> > > futures;
+      futures.reserve(pmap->local_size());
+      for(const size_type ord : *pmap) {
+        const size_type i = (front ? ord / tiles : ord % n);
+        const size_type t = (front ? ord % tiles : ord / n);
+        if(! arrays[i].is_zero(t))
+          futures.emplace_back(ord, arrays[i].find(t));
+      }
+
+      std::vector<std::pair<size_type, value_type> > result_tiles;
+      result_tiles.reserve(futures.size());
+      for(auto& tile : futures) {
+        const value_type arg = tile.second.get();
+        result_tiles.emplace_back(tile.first,
+            value_type(trange.make_tile_range(tile.first), arg.data()));
+      }
+
+      return make_retiled_array<Array>(world, trange, pmap, result_tiles);
+    }
+
+    /// Split a stack of arrays
+
+    /// \tparam Array The array type
+    /// \param stack The stack of arrays
+    /// \param n The number of stacked arrays
+    /// \param front If \c true , the stack dimension is the first dimension;
+    /// otherwise it is the last dimension
+    /// \return The arrays of \c stack
+    template <typename Array>
+    inline std::vector<Array> unstack_array(const Array& stack,
+        const std::size_t n, const bool front)
+    {
+      typedef typename Array::value_type value_type;
+      typedef typename Array::size_type size_type;
+
+      World& world = stack.world();
+      std::vector<TiledRange1> dims;
+      for(unsigned int d = (front ? 1u : 0u);
+          d < stack.trange().rank() - (front ? 0u : 1u); ++d)
+        dims.push_back(stack.trange().dim(d));
+      const TiledRange trange(dims.begin(), dims.end());
+      const size_type tiles = trange.tiles_range().volume();
+
+      std::vector<Array> result;
+      result.reserve(n);
+      for(std::size_t i = 0ul; i < n; ++i) {
+        const std::shared_ptr<Pmap> pmap =
+            Array::policy_type::default_pmap(world, tiles);
+
+        std::vector<std::pair<size_type, Future<value_type> > > futures;
+        futures.reserve(pmap->local_size());
+        for(const size_type t : *pmap) {
+          const size_type ord = (front ? i * tiles + t : t * n + i);
+          if(! stack.is_zero(ord))
+            futures.emplace_back(t, stack.find(ord));
+        }
+
+        std::vector<std::pair<size_type, value_type> > result_tiles;
+        result_tiles.reserve(futures.size());
+        for(auto& tile : futures) {
+          const value_type arg = tile.second.get();
+          result_tiles.emplace_back(tile.first,
+              value_type(trange.make_tile_range(tile.first), arg.data()));
+        }
+
+        result.push_back(make_retiled_array<Array>(world, trange, pmap,
+            result_tiles));
+      }
+
+      return result;
+    }
+
+    /// Name of the stack variable
+
+    /// \return A variable that is not in \c left_vars , \c right_vars , or
+    /// \c result_vars
+    inline std::string stack_var(const expressions::VariableList& left_vars,
+        const expressions::VariableList& right_vars,
+        const expressions::VariableList& result_vars)
+    {
+      for(unsigned int i = 0u; ; ++i) {
+        const std::string var = "stack" + std::to_string(i);
+        if((std::find(left_vars.begin(), left_vars.end(), var) == left_vars.end())
+            && (std::find(right_vars.begin(), right_vars.end(), var) == right_vars.end())
+            && (std::find(result_vars.begin(), result_vars.end(), var) == result_vars.end()))
+          return var;
+      }
+    }
+
+    /// Check the arguments of a multi-operand contraction
+
+    /// \param shared The shared argument
+    /// \param arrays The other arguments
+    /// \throw TiledArray::Exception When \c arrays is empty, or the arrays of
+    /// \c arrays do not have the same tiled range.
+    template <typename Array>
+    inline void check_multi_contract(const Array& shared,
+        const std::vector<Array>& arrays)
+    {
+      TA_USER_ASSERT(shared.is_initialized(),
+          "TiledArray::multi_contract(): The shared argument is not initialized.");
+      TA_USER_ASSERT(! arrays.empty(),
+          "TiledArray::multi_contract(): No arrays are given.");
+      for(const auto& array : arrays) {
+        TA_USER_ASSERT(array.is_initialized(),
+            "TiledArray::multi_contract(): An argument is not initialized.");
+        TA_USER_ASSERT(array.trange() == arrays.front().trange(),
+            "TiledArray::multi_contract(): The arrays must have the same tiled range.");
+      }
+    }
+
+  } // namespace detail
+
+  /// Contract one array with several arrays
+
+  /// Evaluates <tt>results[i](result_vars) = left(left_vars) *
+  /// rights[i](right_vars)</tt> for each array of \c rights with one
+  /// contraction. The right arrays are stacked along a new dimension with
+  /// one tile of size one per array, which is a right outer dimension of the
+  /// contraction, so \c Summa broadcasts each block of \c left once for all
+  /// products instead of once per product. Use this when \c left is the
+  /// large operand, e.g. an operator that is applied to many trial vectors.
+  /// The stack and the results are copies of the arguments and the products;
+  /// a tile of the stack is assembled on the owner of the right tiles when
+  /// the right arrays have the same process map. This is a collective
+  /// operation.
+  /// \code
+  /// std::vector<TSpArrayD> sigma =
+  ///     multi_contract(v, "a,b,c,d", trials, "c,d,i,j", "a,b,i,j");
+  /// \endcode
+  /// \tparam Tile The tile type, which must be constructible from a range and
+  /// the pointer returned by \c data() in the manner of \c TiledArray::Tensor
+  /// \tparam Policy The array policy type
+  /// \param left The shared left-hand argument
+  /// \param left_vars The variables of \c left
+  /// \param rights The right-hand arguments, which have the same tiled range
+  /// \param right_vars The variables of the right-hand arguments
+  /// \param result_vars The variables of the results
+  /// \return The products, where element \c i is the product with
+  /// <tt>rights[i]</tt>
+  /// \throw TiledArray::Exception When \c rights is empty, or its arrays do
+  /// not have the same tiled range.
+  template <typename Tile, typename Policy>
+  inline std::vector<DistArray<Tile, Policy> >
+  multi_contract(const DistArray<Tile, Policy>& left, const std::string& left_vars,
+      const std::vector<DistArray<Tile, Policy> >& rights,
+      const std::string& right_vars, const std::string& result_vars)
+  {
+    typedef DistArray<Tile, Policy> array_type;
+
+    detail::check_multi_contract(left, rights);
+    const std::string var = detail::stack_var(
+        expressions::VariableList(left_vars),
+        expressions::VariableList(right_vars),
+        expressions::VariableList(result_vars));
+
+    // The stack variable is the last right outer variable
+    const array_type stack = detail::stack_arrays(rights, false);
+    array_type result;
+    result(result_vars + "," + var) = left(left_vars) * stack(right_vars + "," + var);
+
+    return detail::unstack_array(result, rights.size(), false);
+  }
+
+  /// Contract several arrays with one array
+
+  /// Evaluates <tt>results[i](result_vars) = lefts[i](left_vars) *
+  /// right(right_vars)</tt> for each array of \c lefts with one
+  /// contraction, in which \c Summa broadcasts each block of \c right once
+  /// for all products. See the overload with a shared left-hand argument.
+  /// \tparam Tile The tile type
+  /// \tparam Policy The array policy type
+  /// \param lefts The left-hand arguments, which have the same tiled range
+  /// \param left_vars The variables of the left-hand arguments
+  /// \param right The shared right-hand argument
+  /// \param right_vars The variables of \c right
+  /// \param result_vars The variables of the results
+  /// \return The products, where element \c i is the product with
+  /// <tt>lefts[i]</tt>
+  /// \throw TiledArray::Exception When \c lefts is empty, or its arrays do
+  /// not have the same tiled range.
+  template <typename Tile, typename Policy>
+  inline std::vector<DistArray<Tile, Policy> >
+  multi_contract(const std::vector<DistArray<Tile, Policy> >& lefts,
+      const std::string& left_vars, const DistArray<Tile, Policy>& right,
+      const std::string& right_vars, const std::string& result_vars)
+  {
+    typedef DistArray<Tile, Policy> array_type;
+
+    detail::check_multi_contract(right, lefts);
+    const std::string var = detail::stack_var(
+        expressions::VariableList(left_vars),
+        expressions::VariableList(right_vars),
+        expressions::VariableList(result_vars));
+
+    // The stack variable is the first left outer variable
+    const array_type stack = detail::stack_arrays(lefts, true);
+    array_type result;
+    result(var + "," + result_vars) = stack(var + "," + left_vars) * right(right_vars);
+
+    return detail::unstack_array(result, lefts.size(), true);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_MULTI_CONTRACT_H__INCLUDED
@@ -0,0 +1,187 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2013  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Eduard Valeyev
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  pipelined_conjgrad.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_PIPELINED_CONJGRAD_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_PIPELINED_CONJGRAD_H__INCLUDED
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <TiledArray/algebra/utils.h>
+#include "../dist_array.h"
+
+namespace TiledArray {
+
+  /// Solves linear system <tt> a(x) = b </tt> using the pipelined conjugate
+  /// gradient solver where \c a is a linear function of \c x .
+
+  /// This is the preconditioned pipelined CG method of Ghysels and Vanroose
+  /// (Parallel Computing 40, 224 (2014)). It is mathematically equivalent to
+  /// \c ConjugateGradientSolver , but all global reductions of an iteration
+  /// are started together and their latency is hidden behind the
+  /// preconditioner and the application of \c a , so an iteration waits for
+  /// one overlapped reduction instead of three blocking ones. This costs
+  /// four more vectors and a few more vector updates per iteration, and
+  /// the recurrences are slightly less stable than those of plain CG.
+  ///
+  /// \c a may evaluate a TiledArray expression, e.g.
+  /// \code
+  /// struct Operator {
+  ///   TArrayD A;
+  ///   void operator()(const TArrayD& x, TArrayD& result) const {
+  ///     result("i") = A("i,j") * x("j");
+  ///   }
+  /// };
+  /// \endcode
+  /// \tparam D type of \c x and \c b, as well as the preconditioner; in
+  /// addition to the functions required by \c ConjugateGradientSolver , \c D
+  /// must provide
+  ///   \li <tt> Future<value_type> dot_product_async(const D& a, const D& b) </tt>
+  /// \tparam F type that evaluates the LHS, will call \c F::operator()(x,result) ,
+  /// \c D must implement <tt> operator()(const D&, D&) const </tt>
+  template <typename D, typename F>
+  struct PipelinedConjugateGradientSolver {
+    typedef typename D::element_type value_type;
+
+    /// \param a object of type F
+    /// \param b RHS
+    /// \param x unknown
+    /// \param preconditioner
+    /// \param convergence_target The convergence target [default = -1.0]
+    /// \return The 2-norm of the residual, a(x) - b, divided by the number of
+    /// elements in the residual.
+    value_type operator()(F& a, const D& b, D& x, const D& preconditioner,
+        value_type convergence_target = -1.0)
+    {
+
+      std::size_t n = size(x);
+      assert(n == size(preconditioner));
+
+      // approximate the condition number as the ratio of the min and max elements of the preconditioner
+      // assuming that preconditioner is the approximate inverse of A in Ax - b =0
+      const value_type precond_min = minabs_value(preconditioner);
+      const value_type precond_max = maxabs_value(preconditioner);
+      const value_type cond_number = precond_max / precond_min;
+      // if convergence target is given, estimate of how tightly the system can be converged
+      if (convergence_target < 0.0) {
+        convergence_target = 1e-15 * cond_number;
+      }
+      else { // else warn if the given system is not sufficiently well conditioned
+        if (convergence_target < 1e-15 * cond_number)
+          std::cout << "WARNING: PipelinedConjugateGradient convergence target (" << convergence_target
+                    << ") may be too low for 64-bit precision" << std::endl;
+      }
+
+      const unsigned int max_niter = n;
+      const std::size_t rhs_size = size(b);
+
+      // starting guess: x_0 = D^-1 . b
+      D XX_i = copy(b);
+      vec_multiply(XX_i, preconditioner);
+
+      // r_0 = b - a(x)
+      D RR_i = clone(b);
+      a(XX_i, RR_i);
+      scale(RR_i, -1.0);
+      axpy(RR_i, 1.0, b);
+
+      // u_0 = D^-1 . r_0 , w_0 = a(u_0)
+      D UU_i = copy(RR_i);
+      vec_multiply(UU_i, preconditioner);
+      D WW_i = clone(b);
+      a(UU_i, WW_i);
+
+      // m_i = D^-1 . w_i , n_i = a(m_i)
+      D MM_i;
+      D NN_i = clone(b);
+
+      // direction vector p_i and its recurrences s_i = a(p_i) ,
+      // q_i = D^-1 . s_i , and z_i = a(q_i)
+      D PP_i, SS_i, QQ_i, ZZ_i;
+
+      value_type gamma_im1 = 0.0, alpha_im1 = 0.0;
+      unsigned int iter = 0;
+      while (true) {
+
+        // start the reductions of this iteration ...
+        Future<value_type> gamma_f = dot_product_async(RR_i, UU_i);
+        Future<value_type> delta_f = dot_product_async(WW_i, UU_i);
+        Future<value_type> rr_f = dot_product_async(RR_i, RR_i);
+
+        // ... and overlap them with the preconditioner and operator
+        MM_i = copy(WW_i);
+        vec_multiply(MM_i, preconditioner);
+        a(MM_i, NN_i);
+
+        const value_type gamma_i = gamma_f.get();
+        const value_type delta_i = delta_f.get();
+        const value_type r_i_norm = std::sqrt(rr_f.get()) / rhs_size;
+        if (r_i_norm < convergence_target) {
+          assign(x, XX_i);
+          return r_i_norm;
+        }
+
+        if (iter >= max_niter) {
+          assign(x, XX_i);
+          throw std::domain_error("PipelinedConjugateGradient: max # of iterations exceeded");
+        }
+
+        value_type alpha_i;
+        if (iter == 0) {
+          alpha_i = gamma_i / delta_i;
+          ZZ_i = copy(NN_i);
+          QQ_i = copy(MM_i);
+          SS_i = copy(WW_i);
+          PP_i = copy(UU_i);
+        } else {
+          const value_type beta_i = gamma_i / gamma_im1;
+          alpha_i = gamma_i / (delta_i - beta_i * gamma_i / alpha_im1);
+
+          // z_i = n_i + beta_i z_i-1 , etc.
+          scale(ZZ_i, beta_i);
+          axpy(ZZ_i, 1.0, NN_i);
+          scale(QQ_i, beta_i);
+          axpy(QQ_i, 1.0, MM_i);
+          scale(SS_i, beta_i);
+          axpy(SS_i, 1.0, WW_i);
+          scale(PP_i, beta_i);
+          axpy(PP_i, 1.0, UU_i);
+        }
+
+        axpy(XX_i, alpha_i, PP_i);
+        axpy(RR_i, -alpha_i, SS_i);
+        axpy(UU_i, -alpha_i, QQ_i);
+        axpy(WW_i, -alpha_i, ZZ_i);
+
+        gamma_im1 = gamma_i;
+        alpha_im1 = alpha_i;
+        ++iter;
+      } // solver loop
+    }
+  };
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_PIPELINED_CONJGRAD_H__INCLUDED
@@ -0,0 +1,83 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  svd.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_ALGEBRA_SVD_H__INCLUDED
+#define TILEDARRAY_ALGEBRA_SVD_H__INCLUDED
+
+#include <TiledArray/algebra/heig.h>
+#include <Eigen/SVD>
+
+namespace TiledArray {
+
+  /// Thin singular value decomposition
+
+  /// Computes <tt>a = U * diag(sigma) * VT</tt> , where \c U has
+  /// <tt>k = min(m, n)</tt> orthonormal columns and \c VT has \c k orthonormal
+  /// rows. The matrix is gathered on process 0, which computes the
+  /// decomposition, and the singular vectors are sent back directly to the
+  /// owners of their tiles. This is a collective operation.
+  /// \tparam Tile The tile type
+  /// \tparam Policy The array policy type
+  /// \param a An \c m by \c n matrix
+  /// \return The singular values in descending order, \c U and \c VT . The
+  /// tiling of dimension \c k is the tiling of the smaller dimension of \c a .
+  /// \throw TiledArray::Exception When \c a is not a matrix.
+  template <typename Tile, typename Policy>
+  std::tuple<std::vector<typename Eigen::NumTraits<typename Tile::value_type>::Real>,
+      DistArray<Tile, Policy>, DistArray<Tile, Policy> >
+  svd(const DistArray<Tile, Policy>& a) {
+    typedef Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic, Eigen::Dynamic> matrix_type;
+    typedef typename Eigen::NumTraits<typename Tile::value_type>::Real real_type;
+
+    World& world = a.world();
+    const auto& trange = a.trange();
+    TA_USER_ASSERT(trange.tiles_range().rank() == 2u,
+        "TiledArray::svd(): The array must be a matrix.");
+    const std::size_t m = trange.elements_range().extent(0);
+    const std::size_t n = trange.elements_range().extent(1);
+    const std::size_t k = std::min(m, n);
+    const TiledRange1& k_tr1 = (m <= n ? trange.data()[0] : trange.data()[1]);
+
+    const matrix_type matrix = detail::gather_matrix(a, 0);
+    std::vector<real_type> values(k);
+    matrix_type u, vt;
+    if(world.rank() == 0) {
+      Eigen::JacobiSVD<matrix_type> solver(matrix, Eigen::ComputeThinU | Eigen::ComputeThinV);
+      std::copy_n(solver.singularValues().data(), k, values.begin());
+      u = solver.matrixU();
+      vt = solver.matrixV().adjoint();
+    }
+    detail::broadcast_values(world, values, 0);
+
+    return std::make_tuple(std::move(values),
+        eigen_block_to_array<DistArray<Tile, Policy> >(world,
+            TiledRange({ trange.data()[0], k_tr1 }), u, 0ul, 0ul),
+        eigen_block_to_array<DistArray<Tile, Policy> >(world,
+            TiledRange({ k_tr1, trange.data()[1] }), vt, 0ul, 0ul));
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_ALGEBRA_SVD_H__INCLUDED
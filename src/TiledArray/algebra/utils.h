@@ -91,6 +91,38 @@ namespace TiledArray {
     return a1(vars).dot(a2(vars)).get();
   }
 
+  /// Dot product that does not wait for the global reduction
+
+  /// The local part of the product is evaluated before this function
+  /// returns; the reduction over processes completes in the background, so
+  /// it can be overlapped with other work.
+  /// \return A future to the dot product of \c a1 and \c a2
+  template <typename Tile, typename Policy>
+  inline Future<typename DistArray<Tile,Policy>::element_type>
+  dot_product_async(const DistArray<Tile,Policy>& a1, const DistArray<Tile,Policy>& a2) {
+    const std::string vars = detail::dummy_annotation(a1.trange().tiles_range().rank());
+    return a1(vars).dot(a2(vars));
+  }
+
+  /// Local part of a dot product
+
+  /// The products of the tiles of \c a1 that are owned by this process are
+  /// summed, without a reduction over processes, so the local parts of many
+  /// dot products can be summed with one \c world.gop.sum() . Tiles of \c a2
+  /// that are not local are fetched, so \c a1 and \c a2 should have the same
+  /// process map.
+  /// \return The sum of the products of the local tiles of \c a1 and \c a2
+  template <typename Tile, typename Policy>
+  inline typename DistArray<Tile,Policy>::element_type
+  local_dot_product(const DistArray<Tile,Policy>& a1, const DistArray<Tile,Policy>& a2) {
+    TA_ASSERT(a1.trange() == a2.trange());
+    typename DistArray<Tile,Policy>::element_type result(0);
+    for(const auto index : *a1.pmap())
+      if(! a1.is_zero(index) && ! a2.is_zero(index))
+        result += dot(a1.find(index).get(), a2.find(index).get());
+    return result;
+  }
+
   template <typename Left, typename Right>
   inline typename TiledArray::expressions::ExprTrait<Left>::scalar_type
   dot(const TiledArray::expressions::Expr<Left>& a1,
@@ -104,6 +136,20 @@ namespace TiledArray {
     return a1.dot(a2).get();
   }
 
+  /// Statistics of the elements of an array
+
+  /// \param a The array
+  /// \param flags The selected statistics, a combination of
+  /// \c StatisticsFlags
+  /// \return The selected statistics of the elements of \c a , computed in
+  /// one pass over the tiles
+  template <typename Tile, typename Policy>
+  inline auto statistics(const DistArray<Tile,Policy>& a, const unsigned int flags)
+      -> decltype(a("i").statistics(flags).get())
+  {
+    return a(detail::dummy_annotation(a.trange().tiles_range().rank())).statistics(flags).get();
+  }
+
   template <typename Tile, typename Policy>
   inline void scale(DistArray<Tile,Policy>& a,
                     typename DistArray<Tile,Policy>::element_type scaling_factor) {
@@ -445,6 +445,21 @@ namespace TiledArray {
         return get<std::initializer_list<Integer>>(i);
       }
 
+      /// Tile futures accessor
+
+      /// The requests for remote tiles are aggregated per owner; see
+      /// \c DistributedStorage::get .
+      /// \param ords The ordinals of the tiles
+      /// \return The futures to the tiles, in the order of \c ords
+      /// \throw TiledArray::Exception When a tile is zero
+      std::vector<future> get(const std::vector<size_type>& ords) const {
+#ifndef NDEBUG
+        for(const auto ord : ords)
+          TA_ASSERT(! TensorImpl_::is_zero(ord));
+#endif // NDEBUG
+        return data_.get(ords);
+      }
+
       /// Set tile
 
       /// Set the tile at \c i with \c value . \c Value type may be \c value_type ,
@@ -460,6 +475,89 @@ namespace TiledArray {
         data_.set(TensorImpl_::trange().tiles_range().ordinal(i), value);
       }
 
+      /// Set tiles
+
+      /// The tiles owned by other processes are sent in batches; see
+      /// \c DistributedStorage::set .
+      /// \param ords The ordinals of the tiles
+      /// \param values The tiles, in the order of \c ords
+      void set(const std::vector<size_type>& ords,
+          const std::vector<value_type>& values)
+      {
+#ifndef NDEBUG
+        for(const auto ord : ords)
+          TA_ASSERT(! TensorImpl_::is_zero(ord));
+#endif // NDEBUG
+        data_.set(ords, values);
+      }
+
+      /// Write blocks into tiles in place
+
+      /// The blocks owned by other processes are sent in batches; see
+      /// \c DistributedStorage::write .
+      /// \param ords The ordinals of the tiles
+      /// \param blocks The blocks, in the order of \c ords
+      void write(const std::vector<size_type>& ords,
+          const std::vector<value_type>& blocks)
+      {
+#ifndef NDEBUG
+        for(const auto ord : ords)
+          TA_ASSERT(! TensorImpl_::is_zero(ord));
+#endif // NDEBUG
+        data_.write(ords, blocks);
+      }
+
+      /// Expose the local tiles for one-sided gets
+
+      /// See \c DistributedStorage::expose .
+      /// \return \c true if the local tiles are exposed
+      bool expose() { return data_.expose(); }
+
+      /// Stop one-sided gets of the local tiles
+
+      /// See \c DistributedStorage::conceal .
+      void conceal() { data_.conceal(); }
+
+      /// \return \c true if the local tiles are exposed for one-sided gets
+      bool is_exposed() const { return data_.is_exposed(); }
+
+      /// Compress the local tiles in memory
+
+      /// See \c DistributedStorage::compress .
+      /// \return The number of compressed tiles
+      size_type compress() { return data_.compress(); }
+
+      /// Decompress the local tiles
+
+      /// See \c DistributedStorage::decompress .
+      void decompress() { data_.decompress(); }
+
+      /// \return The number of compressed local tiles
+      size_type compressed_size() const { return data_.compressed_size(); }
+
+      /// \return The memory held by the compressed local tiles, in bytes
+      size_type compressed_bytes() const { return data_.compressed_bytes(); }
+
+      /// Replace the shape and remove tiles that become zero
+
+      /// The local tiles that are non-zero in the current shape and zero in
+      /// \c shape are erased from the tile container; the other tiles are
+      /// kept as they are.
+      /// \param shape The new shape, which may not add non-zero tiles
+      /// \note This must be called collectively with the same \c shape on all
+      /// processes, when no other operation is accessing this array.
+      void truncate(const shape_type& shape) {
+        for(const auto ord : * TensorImpl_::pmap()) {
+          if(shape.is_zero(ord)) {
+            if(! TensorImpl_::is_zero(ord))
+              data_.erase(ord);
+          } else {
+            TA_ASSERT(! TensorImpl_::is_zero(ord));
+          }
+        }
+        TensorImpl_::set_shape(shape);
+      }
+
       /// Array begin iterator
 
       /// \return A const iterator to the first element of the array.
@@ -522,10 +620,14 @@ namespace TiledArray {
     class ArrayImpl<Tensor<int, Eigen::aligned_allocator<int> >, DensePolicy>;
     extern template
     class ArrayImpl<Tensor<long, Eigen::aligned_allocator<long> >, DensePolicy>;
-//    extern template
-//    class ArrayImpl<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>;
-//    extern template
-//    class ArrayImpl<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>;
+    extern template
+    class ArrayImpl<Tensor<double, PoolAllocator<double> >, DensePolicy>;
+    extern template
+    class ArrayImpl<Tensor<float, PoolAllocator<float> >, DensePolicy>;
+    extern template
+    class ArrayImpl<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>;
+    extern template
+    class ArrayImpl<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>;
 
     extern template
     class ArrayImpl<Tensor<double, Eigen::aligned_allocator<double> >, SparsePolicy>;
@@ -535,10 +637,14 @@ namespace TiledArray {
     class ArrayImpl<Tensor<int, Eigen::aligned_allocator<int> >, SparsePolicy>;
     extern template
     class ArrayImpl<Tensor<long, Eigen::aligned_allocator<long> >, SparsePolicy>;
-//    extern template
-//    class ArrayImpl<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>;
-//    extern template
-//    class ArrayImpl<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+    extern template
+    class ArrayImpl<Tensor<double, PoolAllocator<double> >, SparsePolicy>;
+    extern template
+    class ArrayImpl<Tensor<float, PoolAllocator<float> >, SparsePolicy>;
+    extern template
+    class ArrayImpl<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>;
+    extern template
+    class ArrayImpl<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
 
 #endif // TILEDARRAY_HEADER_ONLY
 
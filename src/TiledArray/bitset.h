@@ -25,6 +25,7 @@
 #include <climits>
 #include <iosfwd>
 #include <iomanip>
+#include <type_traits>
 
 namespace TiledArray {
   namespace detail {
@@ -519,16 +520,28 @@ namespace TiledArray {
       /// \return The number of non-zero bits
       size_type count() const {
         size_type c = 0ul;
-        for(size_type i = 0ul; i < blocks_; ++i) {
-          block_type v = set_[i]; // temp
-          v = v - ((v >> 1) & xffff / 3);
-          v = (v & xffff / 15 * 3) + ((v >> 2) & xffff / 15 * 3);
-          v = (v + (v >> 4)) & xffff / 255 * 15;
-          c += block_type(v * (xffff / 255)) >> (sizeof(block_type) - 1) * CHAR_BIT; // count
-        }
+        for(size_type i = 0ul; i < blocks_; ++i)
+          c += popcount(set_[i]);
         return c;
       }
 
+      /// Find the first set bit
+
+      /// \return The index of the first set bit, or \c size() if no bits are
+      /// set
+      size_type find_first() const { return find_from(0ul); }
+
+      /// Find the next set bit
+
+      /// Set bits are found a block at a time, so iterating over the set bits
+      /// with \c find_first() and \c find_next() skips runs of zero bits.
+      /// \param i The bit index after which the search starts
+      /// \return The index of the first set bit after \c i , or \c size() if
+      /// there is none
+      size_type find_next(const size_type i) const {
+        return ((i + 1ul) < size_ ? find_from(i + 1ul) : size_);
+      }
+
       /// Data pointer accessor
 
       /// The pointer to the data points to a contiguous block of memory of type
@@ -566,6 +579,63 @@ namespace TiledArray {
 
     private:
 
+      /// Count the set bits of a block
+
+      /// \param block The block
+      /// \return The number of set bits in \c block
+      static size_type popcount(const block_type block) {
+        typedef typename std::make_unsigned<block_type>::type ublock_type;
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(static_cast<unsigned long long>(
+            static_cast<ublock_type>(block)));
+#else
+        ublock_type v = block;
+        const ublock_type ones = ~ublock_type(0);
+        v = v - ((v >> 1) & ones / 3);
+        v = (v & ones / 15 * 3) + ((v >> 2) & ones / 15 * 3);
+        v = (v + (v >> 4)) & ones / 255 * 15;
+        return ublock_type(v * (ones / 255)) >> (sizeof(block_type) - 1) * CHAR_BIT;
+#endif // defined(__GNUC__) || defined(__clang__)
+      }
+
+      /// Find the lowest set bit of a block
+
+      /// \param block A non-zero block
+      /// \return The index of the lowest set bit in \c block
+      static size_type count_trailing_zeros(const block_type block) {
+        typedef typename std::make_unsigned<block_type>::type ublock_type;
+        TA_ASSERT(block != zero);
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(static_cast<unsigned long long>(
+            static_cast<ublock_type>(block)));
+#else
+        ublock_type v = block;
+        size_type n = 0ul;
+        for(; ! (v & ublock_type(1)); v >>= 1)
+          ++n;
+        return n;
+#endif // defined(__GNUC__) || defined(__clang__)
+      }
+
+      /// Find the first set bit at or after a bit
+
+      /// \param i The bit index where the search starts
+      /// \return The index of the first set bit at or after \c i , or
+      /// \c size() if there is none
+      size_type find_from(const size_type i) const {
+        if(i >= size_)
+          return size_;
+        size_type b = block_index(i);
+        block_type v = set_[b] & (xffff << bit_index(i));
+        while(v == zero) {
+          if(++b == blocks_)
+            return size_;
+          v = set_[b];
+        }
+        const size_type result = b * block_bits + count_trailing_zeros(v);
+        return (result < size_ ? result : size_);
+      }
+
       /// Calculate block index
 
       /// \return The block index that contains the i-th bit
@@ -0,0 +1,904 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  bitset_shape.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_BITSET_SHAPE_H__INCLUDED
+#define TILEDARRAY_BITSET_SHAPE_H__INCLUDED
+
+#include <TiledArray/sparse_shape.h>
+#include <TiledArray/bitset.h>
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <numeric>
+
+namespace TiledArray {
+
+  /// Sparse shape that stores only the pattern of non-zero tiles
+
+  /// BitsetShape holds one bit per tile, which is set when the tile is
+  /// non-zero, instead of the norm of each tile. It is intended for arrays
+  /// whose sparsity is known from their structure, e.g. symmetry blocks or
+  /// locality domains, where the norms carry no information. The shape
+  /// requires 32 times less memory than SparseShape<float> , and shape
+  /// arithmetic works on whole words of the pattern: \c add and \c subt are a
+  /// union, \c mult and \c mask an intersection, and \c gemm a boolean matrix
+  /// product.
+  ///
+  /// Norms are only used when a shape is constructed from them: a tile is
+  /// non-zero when its normalized norm is not below the zero threshold, which
+  /// is shared with SparseShape<float> . The pattern is not changed by
+  /// scaling factors, and the result of an operation has a non-zero tile
+  /// wherever the arguments can produce one, so results may have non-zero
+  /// tiles that SparseShape would screen.
+  class BitsetShape {
+  public:
+    typedef BitsetShape BitsetShape_; ///< This object type
+    typedef float value_type; ///< The norm value type of the constructors
+    typedef Range::size_type size_type; ///< Size type
+    typedef detail::Bitset<> bitset_type; ///< The pattern type
+
+  private:
+
+    typedef bitset_type::block_type block_type;
+    typedef std::vector<std::vector<value_type> > size_vectors_type;
+    typedef std::vector<std::pair<size_type, value_type> > pair_list;
+
+    Range range_; ///< The tiles range
+    std::shared_ptr<const bitset_type> bits_; ///< The non-zero tiles
+
+    BitsetShape(const Range& range, const std::shared_ptr<const bitset_type>& bits) :
+      range_(range), bits_(bits)
+    { }
+
+    /// \return The number of bits in a pattern word
+    static constexpr size_type block_bits() { return CHAR_BIT * sizeof(block_type); }
+
+    /// \param n The number of bits
+    /// \return The number of words that hold \c n bits
+    static size_type words(const size_type n) {
+      return (n + block_bits() - 1ul) / block_bits();
+    }
+
+    /// Compute the number of elements in each tile of each dimension
+
+    /// \param trange The tiled range
+    /// \return The tile sizes of each dimension of \c trange
+    static size_vectors_type size_vectors(const TiledRange& trange) {
+      size_vectors_type result;
+      result.reserve(trange.data().size());
+      for(const auto& trange1 : trange.data()) {
+        std::vector<value_type> sizes;
+        for(const auto& tile : trange1)
+          sizes.push_back(value_type(tile.second - tile.first));
+        result.push_back(std::move(sizes));
+      }
+      return result;
+    }
+
+    /// Compute the number of elements in a tile
+
+    /// \param ordinal The ordinal of the tile in \c range
+    /// \param range The tiles range
+    /// \param sizes The tile sizes of each dimension of \c range
+    /// \return The number of elements in the tile
+    static value_type volume(size_type ordinal, const Range& range,
+        const size_vectors_type& sizes)
+    {
+      const size_type* MADNESS_RESTRICT const extent = range.extent_data();
+      value_type result = 1;
+      for(int d = int(range.rank()) - 1; d >= 0; --d) {
+        result *= sizes[d][ordinal % extent[d]];
+        ordinal /= extent[d];
+      }
+      return result;
+    }
+
+    /// Check that a tile norm is non-zero
+
+    /// \param norm The norm of the tile, which is not normalized
+    /// \param volume The number of elements in the tile
+    /// \return \c true if the normalized norm is not below the zero threshold
+    static bool is_nonzero_norm(const value_type norm, const value_type volume) {
+      return (norm != value_type(0)) && (norm / volume >= threshold());
+    }
+
+    /// Make the pattern of tile norms
+
+    /// \param norms The Frobenius norms of all tiles of \c trange
+    /// \param trange The tiled range
+    /// \return The pattern of the non-zero tiles
+    static std::shared_ptr<const bitset_type>
+    make_bits(const value_type* MADNESS_RESTRICT const norms, const TiledRange& trange) {
+      const Range& range = trange.tiles_range();
+      const size_vectors_type sizes = size_vectors(trange);
+      std::shared_ptr<bitset_type> result = std::make_shared<bitset_type>(range.volume());
+      for(size_type i = 0ul; i < range.volume(); ++i)
+        if(is_nonzero_norm(norms[i], volume(i, range, sizes)))
+          result->set(i);
+      return result;
+    }
+
+    /// Make the pattern of a list of tile norms
+
+    /// The norms of tiles that appear more than once in \c pairs are summed.
+    /// \param pairs A list of <tt>(ordinal, norm)</tt> pairs
+    /// \param trange The tiled range
+    /// \return The pattern of the non-zero tiles
+    static std::shared_ptr<const bitset_type>
+    make_bits(pair_list& pairs, const TiledRange& trange) {
+      std::sort(pairs.begin(), pairs.end(),
+          [] (const pair_list::value_type& left, const pair_list::value_type& right)
+          { return left.first < right.first; });
+
+      const Range& range = trange.tiles_range();
+      const size_vectors_type sizes = size_vectors(trange);
+      std::shared_ptr<bitset_type> result = std::make_shared<bitset_type>(range.volume());
+      for(auto it = pairs.begin(); it != pairs.end();) {
+        const size_type ordinal = it->first;
+        value_type norm = value_type(0);
+        for(; (it != pairs.end()) && (it->first == ordinal); ++it)
+          norm += it->second;
+        if(is_nonzero_norm(norm, volume(ordinal, range, sizes)))
+          result->set(ordinal);
+      }
+      return result;
+    }
+
+    /// Collect tile norms given as a sparse tensor
+
+    /// \tparam SparseNormSequence The sequence of
+    /// <tt>std::pair<index,value_type></tt> objects
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param range The tiles range
+    /// \return A list of <tt>(ordinal, norm)</tt> pairs
+    template <typename SparseNormSequence>
+    static pair_list make_pairs(const SparseNormSequence& tile_norms, const Range& range) {
+      pair_list pairs;
+      for(const auto& pair_idx_norm : tile_norms)
+        pairs.emplace_back(range.ordinal(pair_idx_norm.first),
+            value_type(pair_idx_norm.second));
+      return pairs;
+    }
+
+    /// Read a row of a pattern into whole words
+
+    /// Bit \c i of the row is stored in bit <tt>i % block_bits()</tt> of
+    /// word <tt>i / block_bits()</tt> of \c row , and the bits after the row
+    /// are cleared.
+    /// \param bits The pattern
+    /// \param first The first bit of the row
+    /// \param n The number of bits in the row
+    /// \param[out] row The words of the row, which holds <tt>words(n)</tt>
+    /// words
+    static void get_row(const bitset_type& bits, const size_type first,
+        const size_type n, block_type* MADNESS_RESTRICT const row)
+    {
+      const block_type* MADNESS_RESTRICT const data = bits.get();
+      const size_type row_words = words(n);
+      for(size_type w = 0ul; w < row_words; ++w) {
+        const size_type bit = first + w * block_bits();
+        const size_type b = bit / block_bits();
+        const size_type shift = bit % block_bits();
+        block_type word = data[b] >> shift;
+        if(shift && (b + 1ul < bits.num_blocks()))
+          word |= data[b + 1ul] << (block_bits() - shift);
+        row[w] = word;
+      }
+      const size_type tail = n % block_bits();
+      if(tail)
+        row[row_words - 1ul] &= (block_type(1) << tail) - block_type(1);
+    }
+
+    /// Set the bits of a row of a pattern
+
+    /// \param bits The pattern
+    /// \param first The first bit of the row
+    /// \param n The number of bits in the row
+    /// \param row The words of the row (see \c get_row() ), where the bits
+    /// after the row are clear
+    static void set_row(bitset_type& bits, const size_type first,
+        const size_type n, const block_type* MADNESS_RESTRICT const row)
+    {
+      block_type* MADNESS_RESTRICT const data = bits.get();
+      const size_type row_words = words(n);
+      for(size_type w = 0ul; w < row_words; ++w) {
+        if(! row[w])
+          continue;
+        const size_type bit = first + w * block_bits();
+        const size_type b = bit / block_bits();
+        const size_type shift = bit % block_bits();
+        data[b] |= row[w] << shift;
+        if(shift && (b + 1ul < bits.num_blocks()))
+          data[b + 1ul] |= row[w] >> (block_bits() - shift);
+      }
+    }
+
+    /// Clear the bits of a row of a pattern
+
+    /// \param bits The pattern
+    /// \param first The first bit of the row
+    /// \param n The number of bits in the row
+    static void clear_row(bitset_type& bits, const size_type first, const size_type n) {
+      for(size_type i = first; i < first + n; ++i)
+        bits.reset(i);
+    }
+
+    /// Visit the rows of a block of a range
+
+    /// The rows run along the last dimension of the block.
+    /// \tparam Op The row operation type
+    /// \param range The range
+    /// \param offset The zero-based offset of the block in \c range
+    /// \param extent The extent of the block
+    /// \param op The row operation, with the signature
+    /// <tt>void op(size_type first, size_type row)</tt> , where \c first is
+    /// the ordinal of the first tile of row \c row of the block in \c range
+    template <typename Op>
+    static void for_each_row(const Range& range,
+        const std::vector<size_type>& offset, const std::vector<size_type>& extent,
+        const Op& op)
+    {
+      const unsigned int rank = range.rank();
+      const size_type* MADNESS_RESTRICT const range_extent = range.extent_data();
+      size_type rows = 1ul;
+      for(unsigned int d = 0u; d + 1u < rank; ++d)
+        rows *= extent[d];
+
+      std::vector<size_type> index(rank, 0ul);
+      for(size_type r = 0ul; r < rows; ++r) {
+        size_type first = 0ul;
+        for(unsigned int d = 0u; d < rank; ++d)
+          first = first * range_extent[d] + offset[d] + index[d];
+        op(first, r);
+
+        for(int d = int(rank) - 2; d >= 0; --d) {
+          if(++index[d] < extent[d])
+            break;
+          index[d] = 0ul;
+        }
+      }
+    }
+
+    /// Compute the offset and extent of a block
+
+    /// \tparam Index The bound index type
+    /// \param lower_bound The lower bound of the block
+    /// \param upper_bound The upper bound of the block
+    /// \param[out] offset The zero-based offset of the block
+    /// \param[out] extent The extent of the block
+    template <typename Index>
+    void block_bounds(const Index& lower_bound, const Index& upper_bound,
+        std::vector<size_type>& offset, std::vector<size_type>& extent) const
+    {
+      TA_ASSERT(detail::size(lower_bound) == range_.rank());
+      TA_ASSERT(detail::size(upper_bound) == range_.rank());
+      const unsigned int rank = range_.rank();
+      const auto* MADNESS_RESTRICT const lower = detail::data(lower_bound);
+      const auto* MADNESS_RESTRICT const upper = detail::data(upper_bound);
+      const size_type* MADNESS_RESTRICT const lobound = range_.lobound_data();
+      offset.resize(rank);
+      extent.resize(rank);
+      for(unsigned int d = 0u; d < rank; ++d) {
+        TA_ASSERT(size_type(lower[d]) >= lobound[d]);
+        TA_ASSERT(size_type(lower[d]) < size_type(upper[d]));
+        TA_ASSERT(size_type(upper[d]) <= range_.upbound(d));
+        offset[d] = lower[d] - lobound[d];
+        extent[d] = upper[d] - lower[d];
+      }
+    }
+
+    /// Combine the patterns of two shapes
+
+    /// \tparam Op The word operation type
+    /// \param other The other shape
+    /// \param op The word operation
+    /// \return A shape with the pattern <tt>op(this, other)</tt>
+    template <typename Op>
+    BitsetShape_ combine(const BitsetShape_& other, const Op& op) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(range_ == other.range_);
+      std::shared_ptr<bitset_type> result = std::make_shared<bitset_type>(*bits_);
+      op(*result, *other.bits_);
+      return BitsetShape_(range_, result);
+    }
+
+  public:
+
+    /// Default constructor
+
+    /// Construct a shape with no data.
+    BitsetShape() : range_(), bits_() { }
+
+    /// Constructor
+
+    /// A tile is non-zero when its norm, normalized by the number of
+    /// elements in the tile, is not below the zero threshold.
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    BitsetShape(const Tensor<value_type>& tile_norms, const TiledRange& trange) :
+      range_(trange.tiles_range()), bits_()
+    {
+      TA_ASSERT(! tile_norms.empty());
+      TA_ASSERT(tile_norms.range() == range_);
+
+      bits_ = make_bits(tile_norms.data(), trange);
+    }
+
+    /// "Sparse" constructor
+
+    /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
+    ///         where \c index is a directly-addressable sequence indices.
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    template <typename SparseNormSequence>
+    BitsetShape(const SparseNormSequence& tile_norms, const TiledRange& trange) :
+      range_(trange.tiles_range()), bits_()
+    {
+      pair_list pairs = make_pairs(tile_norms, range_);
+      bits_ = make_bits(pairs, trange);
+    }
+
+    /// Collective "dense" constructor
+
+    /// The tile norms are summed across all processes (via an all reduce)
+    /// before the pattern is made.
+    /// \param world The world where the shape will live
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    BitsetShape(World& world, const Tensor<value_type>& tile_norms,
+        const TiledRange& trange) :
+      range_(trange.tiles_range()), bits_()
+    {
+      TA_ASSERT(! tile_norms.empty());
+      TA_ASSERT(tile_norms.range() == range_);
+
+      Tensor<value_type> norms = tile_norms.clone();
+      detail::sparse_allreduce(world, norms.data(), norms.size());
+      bits_ = make_bits(norms.data(), trange);
+    }
+
+    /// Collective "sparse" constructor
+
+    /// The sparse tile norms of all processes are gathered, and the norms of
+    /// tiles that are given by more than one process are summed.
+    /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
+    ///         where \c index is a directly-addressable sequence of integers.
+    /// \param world The world where the shape will live
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    template <typename SparseNormSequence>
+    BitsetShape(World& world, const SparseNormSequence& tile_norms,
+        const TiledRange& trange) :
+      range_(trange.tiles_range()), bits_()
+    {
+      pair_list pairs = make_pairs(tile_norms, range_);
+      std::vector<size_type> ordinals;
+      std::vector<value_type> norms;
+      ordinals.reserve(pairs.size());
+      norms.reserve(pairs.size());
+      for(const auto& pair : pairs) {
+        ordinals.push_back(pair.first);
+        norms.push_back(pair.second);
+      }
+
+      detail::all_gather_sparse(world, ordinals, norms);
+
+      pairs.clear();
+      pairs.reserve(ordinals.size());
+      for(size_type i = 0ul; i < ordinals.size(); ++i)
+        pairs.emplace_back(ordinals[i], norms[i]);
+      bits_ = make_bits(pairs, trange);
+    }
+
+    /// Pattern constructor
+
+    /// \param pattern The pattern of the tiles of \c trange , where bit \c i
+    /// is set when tile \c i is non-zero
+    /// \param trange The tiled range of the tensor
+    BitsetShape(const bitset_type& pattern, const TiledRange& trange) :
+      range_(trange.tiles_range()),
+      bits_(std::make_shared<const bitset_type>(pattern))
+    {
+      TA_ASSERT(pattern.size() == range_.volume());
+    }
+
+    /// Make the pattern of a sparse shape
+
+    /// \param shape The sparse shape
+    /// \param trange The tiled range of \c shape
+    BitsetShape(const SparseShape<value_type>& shape, const TiledRange& trange) :
+      range_(trange.tiles_range()), bits_()
+    {
+      TA_ASSERT(shape.validate(range_));
+
+      std::shared_ptr<bitset_type> bits = std::make_shared<bitset_type>(range_.volume());
+      for(size_type i = 0ul; i < range_.volume(); ++i)
+        if(! shape.is_zero(i))
+          bits->set(i);
+      bits_ = bits;
+    }
+
+    /// Validate shape range
+
+    /// \return \c true when range matches the range of this shape
+    bool validate(const Range& range) const {
+      if(empty())
+        return false;
+      return (range == range_);
+    }
+
+    /// Check that a tile is zero
+
+    /// \tparam Index The type of the index
+    /// \param i The ordinal or coordinate index of the tile
+    /// \return \c true if tile \c i is not in the pattern
+    template <typename Index>
+    bool is_zero(const Index& i) const {
+      TA_ASSERT(! empty());
+      return ! (*bits_)[range_.ordinal(i)];
+    }
+
+    /// Check density
+
+    /// \return false
+    static constexpr bool is_dense() { return false; }
+
+    /// Sparsity of the shape
+
+    /// \return The fraction of tiles that are zero.
+    float sparsity() const {
+      TA_ASSERT(! empty());
+      return float(range_.volume() - bits_->count()) / float(range_.volume());
+    }
+
+    /// Non-zero tile count accessor
+
+    /// \return The number of non-zero tiles
+    size_type nnz() const {
+      TA_ASSERT(! empty());
+      return bits_->count();
+    }
+
+    /// Threshold accessor
+
+    /// \return The current threshold, which is SparseShape<float>::threshold()
+    static value_type threshold() { return SparseShape<value_type>::threshold(); }
+
+    /// Set threshold to \c thresh
+
+    /// \param thresh The new threshold
+    static void threshold(const value_type thresh) {
+      SparseShape<value_type>::threshold(thresh);
+    }
+
+    /// Pattern accessor
+
+    /// \return The pattern of the non-zero tiles, in row-major order
+    const bitset_type& pattern() const {
+      TA_ASSERT(! empty());
+      return *bits_;
+    }
+
+    /// Tiles range accessor
+
+    /// \return The tiles range of the shape
+    const Range& range() const { return range_; }
+
+    /// Initialization check
+
+    /// \return \c true when this shape has not been initialized.
+    bool empty() const { return ! bits_; }
+
+    /// Mask this shape with another shape
+
+    /// \param mask_shape The input shape, hard zeros are used to mask the output.
+    /// \return The intersection of the shapes
+    BitsetShape_ mask(const BitsetShape_& mask_shape) const {
+      return combine(mask_shape, [] (bitset_type& left, const bitset_type& right)
+          { left &= right; });
+    }
+
+    /// Update sub-block of shape
+
+    /// Update a sub-block shape information with another shape object.
+    /// \tparam Index The bound index type
+    /// \param lower_bound The lower bound of the sub-block to be updated
+    /// \param upper_bound The upper bound of the sub-block to be updated
+    /// \param other The shape that will be used to update the sub-block
+    /// \return A new shape object where the specified sub-block contains the
+    /// data of \c other.
+    template <typename Index>
+    BitsetShape_ update_block(const Index& lower_bound,
+        const Index& upper_bound, const BitsetShape_& other) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      std::vector<size_type> offset, extent;
+      block_bounds(lower_bound, upper_bound, offset, extent);
+      TA_ASSERT(other.range_.volume() ==
+          std::accumulate(extent.begin(), extent.end(), size_type(1),
+          std::multiplies<size_type>()));
+
+      const size_type n = extent.back();
+      std::shared_ptr<bitset_type> result = std::make_shared<bitset_type>(*bits_);
+      std::vector<block_type> row(words(n));
+      for_each_row(range_, offset, extent,
+          [&] (const size_type first, const size_type r) {
+            get_row(*other.bits_, r * n, n, row.data());
+            clear_row(*result, first, n);
+            set_row(*result, first, n, row.data());
+          });
+
+      return BitsetShape_(range_, result);
+    }
+
+    /// Create a scaled copy of a sub-block of the shape
+
+    /// The pattern is not changed by the scaling factor.
+    /// \tparam Index The upper and lower bound array type
+    /// \tparam Factor The scaling factor type
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    template <typename Index, typename Factor>
+    BitsetShape_ block(const Index& lower_bound, const Index& upper_bound,
+        const Factor) const
+    {
+      return block(lower_bound, upper_bound);
+    }
+
+    /// Create a copy of a sub-block of the shape
+
+    /// \tparam Index The upper and lower bound array type
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    template <typename Index>
+    BitsetShape_ block(const Index& lower_bound, const Index& upper_bound) const {
+      TA_ASSERT(! empty());
+      std::vector<size_type> offset, extent;
+      block_bounds(lower_bound, upper_bound, offset, extent);
+
+      const Range block_range(extent);
+      const size_type n = extent.back();
+      std::shared_ptr<bitset_type> result =
+          std::make_shared<bitset_type>(block_range.volume());
+      std::vector<block_type> row(words(n));
+      for_each_row(range_, offset, extent,
+          [&] (const size_type first, const size_type r) {
+            get_row(*bits_, first, n, row.data());
+            set_row(*result, r * n, n, row.data());
+          });
+
+      return BitsetShape_(block_range, result);
+    }
+
+    /// Create a permuted copy of a sub-block of the shape
+
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    /// \param perm The permutation to be applied to the sub-block
+    template <typename Index>
+    BitsetShape_ block(const Index& lower_bound, const Index& upper_bound,
+        const Permutation& perm) const
+    {
+      return block(lower_bound, upper_bound).perm(perm);
+    }
+
+    /// Create a scaled and permuted copy of a sub-block of the shape
+
+    /// \tparam Factor The scaling factor type
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    /// \param perm The permutation to be applied to the sub-block
+    template <typename Index, typename Factor>
+    BitsetShape_ block(const Index& lower_bound, const Index& upper_bound,
+        const Factor, const Permutation& perm) const
+    {
+      return block(lower_bound, upper_bound).perm(perm);
+    }
+
+    /// Create a permuted shape of this shape
+
+    /// The cost is proportional to the number of non-zero tiles.
+    /// \param perm The permutation to be applied
+    /// \return A new, permuted shape
+    BitsetShape_ perm(const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(perm.dim() == range_.rank());
+
+      const unsigned int rank = range_.rank();
+      const Range result_range = perm * range_;
+      const size_type* MADNESS_RESTRICT const extent = range_.extent_data();
+
+      // Compute the stride in the result of each dimension of this shape
+      std::vector<size_type> result_stride(rank);
+      {
+        const size_type* MADNESS_RESTRICT const result_extent = result_range.extent_data();
+        std::vector<size_type> stride(rank);
+        size_type volume = 1ul;
+        for(int d = int(rank) - 1; d >= 0; --d) {
+          stride[d] = volume;
+          volume *= result_extent[d];
+        }
+        for(unsigned int d = 0u; d < rank; ++d)
+          result_stride[d] = stride[perm[d]];
+      }
+
+      // Move the non-zero tiles to their permuted ordinals
+      const bitset_type& bits = *bits_;
+      std::shared_ptr<bitset_type> result = std::make_shared<bitset_type>(bits.size());
+      for(size_type i = bits.find_first(); i < bits.size(); i = bits.find_next(i)) {
+        size_type ordinal = 0ul;
+        size_type j = i;
+        for(int d = int(rank) - 1; d >= 0; --d) {
+          ordinal += (j % extent[d]) * result_stride[d];
+          j /= extent[d];
+        }
+        result->set(ordinal);
+      }
+
+      return BitsetShape_(result_range, result);
+    }
+
+    /// Create a reshaped shape of this shape
+
+    /// \param trange The tiled range of the reshaped array, which has the same
+    /// tiles in row-major order
+    /// \return A new, reshaped shape
+    BitsetShape_ reshape(const TiledRange& trange) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(trange.tiles_range().volume() == range_.volume());
+      return BitsetShape_(trange.tiles_range(), bits_);
+    }
+
+    /// Scale shape
+
+    /// The pattern is not changed by the scaling factor.
+    /// \tparam Factor The scaling factor type
+    /// \return A copy of this shape
+    template <typename Factor>
+    BitsetShape_ scale(const Factor) const {
+      TA_ASSERT(! empty());
+      return *this;
+    }
+
+    /// Scale and permute shape
+
+    /// \tparam Factor The scaling factor type
+    /// \param perm The permutation that will be applied to this shape
+    /// \return A new, permuted shape
+    template <typename Factor>
+    BitsetShape_ scale(const Factor, const Permutation& perm) const {
+      return this->perm(perm);
+    }
+
+    /// Add shapes
+
+    /// \param other The shape to be added to this shape
+    /// \return The union of the shapes
+    BitsetShape_ add(const BitsetShape_& other) const {
+      return combine(other, [] (bitset_type& left, const bitset_type& right)
+          { left |= right; });
+    }
+
+    BitsetShape_ add(const BitsetShape_& other, const Permutation& perm) const {
+      return add(other).perm(perm);
+    }
+
+    template <typename Factor>
+    BitsetShape_ add(const BitsetShape_& other, const Factor) const {
+      return add(other);
+    }
+
+    template <typename Factor>
+    BitsetShape_ add(const BitsetShape_& other, const Factor,
+        const Permutation& perm) const
+    {
+      return add(other).perm(perm);
+    }
+
+    /// Add a constant to the shape
+
+    /// \return A new shape, where every tile is non-zero
+    BitsetShape_ add(const value_type) const {
+      TA_ASSERT(! empty());
+      std::shared_ptr<bitset_type> result = std::make_shared<bitset_type>(range_.volume());
+      result->set();
+      return BitsetShape_(range_, result);
+    }
+
+    BitsetShape_ add(const value_type value, const Permutation& perm) const {
+      return add(value).perm(perm);
+    }
+
+    BitsetShape_ subt(const BitsetShape_& other) const {
+      return add(other);
+    }
+
+    BitsetShape_ subt(const BitsetShape_& other, const Permutation& perm) const {
+      return add(other, perm);
+    }
+
+    template <typename Factor>
+    BitsetShape_ subt(const BitsetShape_& other, const Factor factor) const {
+      return add(other, factor);
+    }
+
+    template <typename Factor>
+    BitsetShape_ subt(const BitsetShape_& other, const Factor factor,
+        const Permutation& perm) const
+    {
+      return add(other, factor, perm);
+    }
+
+    BitsetShape_ subt(const value_type value) const {
+      return add(value);
+    }
+
+    BitsetShape_ subt(const value_type value, const Permutation& perm) const {
+      return add(value, perm);
+    }
+
+    /// Multiply shapes
+
+    /// \param other The right-hand shape
+    /// \return The intersection of the shapes
+    BitsetShape_ mult(const BitsetShape_& other) const {
+      return combine(other, [] (bitset_type& left, const bitset_type& right)
+          { left &= right; });
+    }
+
+    BitsetShape_ mult(const BitsetShape_& other, const Permutation& perm) const {
+      return mult(other).perm(perm);
+    }
+
+    template <typename Factor>
+    BitsetShape_ mult(const BitsetShape_& other, const Factor) const {
+      return mult(other);
+    }
+
+    template <typename Factor>
+    BitsetShape_ mult(const BitsetShape_& other, const Factor,
+        const Permutation& perm) const
+    {
+      return mult(other).perm(perm);
+    }
+
+    /// Contract shapes
+
+    /// The contraction is a boolean matrix product: row \c m of the result
+    /// is the union of the rows \c k of the right-hand pattern for which tile
+    /// <tt>(m,k)</tt> of this shape is non-zero. The rows are combined a word
+    /// at a time, so the cost is proportional to the number of non-zero
+    /// tiles of this shape times the number of words in a result row.
+    /// \tparam Factor The scaling factor type
+    /// \param other The right-hand shape
+    /// \param gemm_helper The contraction data; the arguments must not be
+    /// transposed
+    /// \return The shape of the contraction
+    template <typename Factor>
+    BitsetShape_ gemm(const BitsetShape_& other, const Factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(gemm_helper.left_op() == madness::cblas::NoTrans);
+      TA_ASSERT(gemm_helper.right_op() == madness::cblas::NoTrans);
+
+      integer M = 0, N = 0, K = 0;
+      gemm_helper.compute_matrix_sizes(M, N, K, range_, other.range_);
+      const size_type row_words = words(N);
+
+      // Copy the rows of the right-hand pattern into whole words
+      std::vector<block_type> right_rows(K * row_words);
+      for(integer k = 0; k < K; ++k)
+        get_row(*other.bits_, k * N, N, right_rows.data() + k * row_words);
+
+      // Compute each row of the result as the union of right-hand rows
+      const bitset_type& left = *bits_;
+      std::shared_ptr<bitset_type> result = std::make_shared<bitset_type>(M * N);
+      std::vector<block_type> row(row_words, block_type(0));
+      for(size_type l = left.find_first(); l < left.size();) {
+        const size_type m = l / K;
+        const size_type row_end = (m + 1ul) * K;
+        for(; (l < left.size()) && (l < row_end); l = left.find_next(l)) {
+          const block_type* MADNESS_RESTRICT const right_row =
+              right_rows.data() + (l - m * K) * row_words;
+          for(size_type w = 0ul; w < row_words; ++w)
+            row[w] |= right_row[w];
+        }
+
+        set_row(*result, m * N, N, row.data());
+        std::fill(row.begin(), row.end(), block_type(0));
+      }
+
+      return BitsetShape_(
+          gemm_helper.make_result_range<Range>(range_, other.range_), result);
+    }
+
+    template <typename Factor>
+    BitsetShape_ gemm(const BitsetShape_& other, const Factor factor,
+        const math::GemmHelper& gemm_helper, const Permutation& perm) const
+    {
+      return gemm(other, factor, gemm_helper).perm(perm);
+    }
+
+    /// Output serialization function
+
+    /// This function enables serialization within MADNESS
+    /// \tparam Archive The output archive type
+    /// \param[out] ar The output archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      const unsigned int rank = (empty() ? 0u : range_.rank());
+      ar & rank;
+      if(! rank)
+        return;
+
+      ar & range_ & madness::archive::wrap(bits_->get(), bits_->num_blocks());
+    }
+
+    /// Input serialization function
+
+    /// This function enables serialization within MADNESS
+    /// \tparam Archive The input archive type
+    /// \param[out] ar The input archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      unsigned int rank = 0u;
+      ar & rank;
+      if(! rank) {
+        range_ = Range();
+        bits_.reset();
+        return;
+      }
+
+      ar & range_;
+      std::shared_ptr<bitset_type> bits = std::make_shared<bitset_type>(range_.volume());
+      ar & madness::archive::wrap(bits->get(), bits->num_blocks());
+      bits_ = bits;
+    }
+
+  }; // class BitsetShape
+
+  /// Add the shape to an output stream
+
+  /// \param os The output stream
+  /// \param shape the BitsetShape object
+  /// \return A reference to the output stream
+  inline std::ostream& operator<<(std::ostream& os, const BitsetShape& shape) {
+    os << "BitsetShape:" << std::endl;
+    if(! shape.empty())
+      os << shape.range() << std::endl << shape.pattern() << std::endl;
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_BITSET_SHAPE_H__INCLUDED
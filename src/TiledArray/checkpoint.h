@@ -0,0 +1,534 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  checkpoint.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_CHECKPOINT_H__INCLUDED
+#define TILEDARRAY_CHECKPOINT_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// The version of the checkpoint file format
+
+/// Version 2 stores the normalized norms, size vectors, and zero threshold of
+/// sparse shapes; version 1 stored the unnormalized norms only. Both can be
+/// read.
+#define TILEDARRAY_CHECKPOINT_VERSION 2u
+
+namespace TiledArray {
+
+  // The checkpoint of an array with prefix p consists of the following files:
+  //
+  //   p.meta     The tiled range, the shape, and the number of data files;
+  //              written by rank 0
+  //   p.<r>      The serialized non-zero local tiles of rank r
+  //   p.<r>.idx  The ordinal index, file offset, and size of each tile in p.<r>
+  //
+  // Each rank writes its own data file, so a checkpoint can be written without
+  // communication. A checkpoint can be read by any number of processes and with
+  // any process map, since each rank uses the index files to locate the tiles
+  // it owns and reads only those.
+
+  namespace detail {
+
+    /// The location of a tile in a checkpoint data file
+    struct CheckpointRecord {
+      std::size_t ordinal; ///< The ordinal index of the tile
+      std::size_t offset; ///< The offset of the tile data in the file
+      std::size_t size; ///< The size of the tile data in bytes
+      std::size_t file; ///< The data file index
+
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & ordinal & offset & size; }
+    }; // struct CheckpointRecord
+
+    /// Checkpoint file name
+
+    /// \param prefix The checkpoint prefix
+    /// \param rank The data file index
+    /// \param suffix The file name suffix
+    /// \return <tt>prefix.rank suffix</tt>
+    inline std::string
+    checkpoint_file_name(const std::string& prefix, const std::size_t rank,
+        const char* const suffix = "")
+    {
+      std::stringstream ss;
+      ss << prefix << "." << rank << suffix;
+      return ss.str();
+    }
+
+    /// Write a dense shape to a checkpoint
+
+    /// \param ar The output archive
+    inline void write_checkpoint_shape(
+        const madness::archive::BinaryFstreamOutputArchive& ar,
+        const DenseShape&, const TiledRange&)
+    { ar & false; }
+
+    /// Write a sparse shape to a checkpoint
+
+    /// The shape is stored with its zero threshold, so it is read back
+    /// without normalizing the norms.
+    /// \tparam T The norm type
+    /// \param ar The output archive
+    /// \param shape The shape to be written
+    template <typename T>
+    inline void write_checkpoint_shape(
+        const madness::archive::BinaryFstreamOutputArchive& ar,
+        const SparseShape<T>& shape, const TiledRange&)
+    { ar & true & shape; }
+
+    /// Read a dense shape from a checkpoint
+
+    /// \param ar The input archive
+    /// \return A dense shape
+    inline DenseShape read_checkpoint_shape(
+        const madness::archive::BinaryFstreamInputArchive& ar,
+        const TiledRange&, const unsigned int, const DenseShape*)
+    {
+      bool sparse = true;
+      ar & sparse;
+      TA_USER_ASSERT(! sparse,
+          "read_checkpoint(): The checkpoint holds a sparse array.");
+      return DenseShape();
+    }
+
+    /// Read a sparse shape from a checkpoint
+
+    /// \tparam T The norm type
+    /// \param ar The input archive
+    /// \param trange The tiled range of the array
+    /// \param version The checkpoint format version
+    /// \return The shape stored in the checkpoint
+    template <typename T>
+    inline SparseShape<T> read_checkpoint_shape(
+        const madness::archive::BinaryFstreamInputArchive& ar,
+        const TiledRange& trange, const unsigned int version,
+        const SparseShape<T>*)
+    {
+      bool sparse = false;
+      ar & sparse;
+      TA_USER_ASSERT(sparse,
+          "read_checkpoint(): The checkpoint holds a dense array.");
+      if(version > 1u)
+        return SparseShape<T>(trange, ar);
+
+      // Version 1 holds the unnormalized norms
+      Tensor<T> norms;
+      ar & norms;
+      return SparseShape<T>(norms, trange);
+    }
+
+    /// Write the meta data file of a checkpoint
+
+    /// \tparam Shape The shape type of the array
+    /// \param prefix The checkpoint file prefix
+    /// \param nfiles The number of data files
+    /// \param trange The tiled range of the array
+    /// \param shape The shape of the array
+    template <typename Shape>
+    inline void write_checkpoint_meta(const std::string& prefix,
+        const std::size_t nfiles, const TiledRange& trange, const Shape& shape)
+    {
+      std::vector<std::vector<std::size_t> > boundaries;
+      for(const TiledRange1& trange1 : trange.data()) {
+        std::vector<std::size_t> tile_boundaries;
+        for(const auto& tile : trange1)
+          tile_boundaries.push_back(tile.first);
+        tile_boundaries.push_back(trange1.elements_range().second);
+        boundaries.push_back(tile_boundaries);
+      }
+
+      madness::archive::BinaryFstreamOutputArchive ar((prefix + ".meta").c_str());
+      ar & std::string("TiledArray checkpoint") & TILEDARRAY_CHECKPOINT_VERSION
+         & nfiles & boundaries;
+      write_checkpoint_shape(ar, shape, trange);
+    }
+
+    /// Write the data and index files of a checkpoint
+
+    /// \tparam Tile The tile type
+    /// \param prefix The checkpoint file prefix
+    /// \param rank The data file index
+    /// \param ordinals The ordinal indices of the tiles
+    /// \param tiles The tiles, where <tt>tiles[i]</tt> is tile
+    /// <tt>ordinals[i]</tt>
+    /// \throw TiledArray::Exception When a file cannot be written
+    template <typename Tile>
+    inline void write_checkpoint_tiles(const std::string& prefix,
+        const std::size_t rank, const std::vector<std::size_t>& ordinals,
+        const std::vector<Tile>& tiles)
+    {
+      TA_ASSERT(ordinals.size() == tiles.size());
+
+      // Write the tiles
+      std::vector<CheckpointRecord> records;
+      {
+        std::ofstream file(checkpoint_file_name(prefix, rank).c_str(),
+            std::ios::binary);
+        TA_USER_ASSERT(file.good(),
+            "write_checkpoint(): Unable to open the checkpoint data file.");
+
+        std::vector<unsigned char> buffer;
+        std::size_t offset = 0ul;
+        for(std::size_t i = 0ul; i < tiles.size(); ++i) {
+          madness::archive::BufferOutputArchive count_ar;
+          count_ar & tiles[i];
+          const std::size_t size = count_ar.size();
+
+          buffer.resize(size);
+          madness::archive::BufferOutputArchive ar(buffer.data(), size);
+          ar & tiles[i];
+
+          file.write(reinterpret_cast<const char*>(buffer.data()), size);
+          records.push_back(CheckpointRecord{ ordinals[i], offset, size, 0ul });
+          offset += size;
+        }
+        TA_USER_ASSERT(file.good(),
+            "write_checkpoint(): Unable to write the checkpoint data file.");
+      }
+
+      // Write the tile index
+      madness::archive::BinaryFstreamOutputArchive ar(
+          checkpoint_file_name(prefix, rank, ".idx").c_str());
+      ar & records;
+    }
+
+    /// Background checkpoint writer
+
+    /// Checkpoints are written by a small pool of I/O threads, which are not
+    /// MADNESS threads, so writing a checkpoint does not take a core from
+    /// the task queue. The number of threads is given by the
+    /// \c TA_CHECKPOINT_IO_THREADS environment variable; the default is one.
+    /// The threads are started by the first checkpoint.
+    class CheckpointWriter {
+      std::mutex lock_; ///< Lock for the job queue
+      std::condition_variable ready_; ///< Signals a new job
+      std::deque<std::function<void()> > jobs_; ///< The queued jobs
+      std::vector<std::thread> threads_; ///< The I/O threads
+
+      CheckpointWriter() : lock_(), ready_(), jobs_(), threads_() {
+        const char* const nthreads = getenv("TA_CHECKPOINT_IO_THREADS");
+        const int n = std::max(1, (nthreads ? std::atoi(nthreads) : 1));
+        for(int i = 0; i < n; ++i)
+          threads_.emplace_back([this] () { this->run(); });
+      }
+
+      CheckpointWriter(const CheckpointWriter&) = delete;
+      CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+      /// Run queued jobs
+      void run() {
+        for(;;) {
+          std::function<void()> job;
+          {
+            std::unique_lock<std::mutex> locker(lock_);
+            ready_.wait(locker, [this] () { return ! jobs_.empty(); });
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+          }
+          job();
+        }
+      }
+
+    public:
+
+      /// Writer accessor
+
+      /// \return A reference to the checkpoint writer of this process
+      static CheckpointWriter& instance() {
+        static CheckpointWriter* const writer = new CheckpointWriter();
+        return *writer;
+      }
+
+      /// Queue a job
+
+      /// \param job The job, which must not throw
+      void submit(std::function<void()> job) {
+        {
+          std::lock_guard<std::mutex> locker(lock_);
+          jobs_.push_back(std::move(job));
+        }
+        ready_.notify_one();
+      }
+
+    }; // class CheckpointWriter
+
+    /// The array data of an asynchronous checkpoint
+
+    /// \tparam Shape The shape type of the array
+    template <typename Shape>
+    struct CheckpointSnapshot {
+      std::string prefix; ///< The checkpoint file prefix
+      std::size_t rank; ///< The rank of this process
+      std::size_t nfiles; ///< The number of data files
+      TiledRange trange; ///< The tiled range of the array
+      Shape shape; ///< The shape of the array
+      std::vector<std::size_t> ordinals; ///< The ordinal indices of the local tiles
+      Future<bool> done; ///< Set when the files of this process are written
+    }; // struct CheckpointSnapshot
+
+    /// Queue the files of an asynchronous checkpoint for writing
+
+    /// \tparam Shape The shape type of the array
+    /// \tparam Tile The tile type of the array
+    /// \param snapshot The array data
+    /// \param tiles The local tiles, in the order of <tt>snapshot->ordinals</tt>
+    template <typename Shape, typename Tile>
+    void submit_checkpoint(const std::shared_ptr<CheckpointSnapshot<Shape> >& snapshot,
+        const std::vector<Future<Tile> >& tiles)
+    {
+      std::vector<Tile> values;
+      values.reserve(tiles.size());
+      for(const auto& tile : tiles)
+        values.push_back(tile.get());
+
+      CheckpointWriter::instance().submit([snapshot, values] () {
+        bool success = true;
+        try {
+          write_checkpoint_tiles(snapshot->prefix, snapshot->rank,
+              snapshot->ordinals, values);
+          if(snapshot->rank == 0ul)
+            write_checkpoint_meta(snapshot->prefix, snapshot->nfiles,
+                snapshot->trange, snapshot->shape);
+        } catch(...) {
+          success = false;
+        }
+        snapshot->done.set(success);
+      });
+    }
+
+  } // namespace detail
+
+  /// Write an array checkpoint
+
+  /// The tiled range, the shape, and the non-zero tiles of \c array are
+  /// written to the files <tt>prefix.meta</tt>, <tt>prefix.rank</tt>, and
+  /// <tt>prefix.rank.idx</tt>, where each rank writes the tiles it owns. Tiles
+  /// are written with their MADNESS \c serialize function.
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy type of the array
+  /// \param array The array to be written
+  /// \param prefix The checkpoint file prefix
+  /// \throw TiledArray::Exception When a file cannot be opened
+  /// \note This is a collective operation, which waits for the tiles of
+  /// \c array and fences its world before returning.
+  template <typename Tile, typename Policy>
+  inline void write_checkpoint(const DistArray<Tile, Policy>& array,
+      const std::string& prefix)
+  {
+    World& world = array.world();
+
+    // Write the tiled range and shape
+    if(world.rank() == 0)
+      detail::write_checkpoint_meta(prefix, world.size(), array.trange(),
+          array.shape());
+
+    // Write the local tiles
+    std::vector<std::size_t> ordinals;
+    std::vector<Tile> tiles;
+    for(auto it = array.begin(); it != array.end(); ++it) {
+      ordinals.push_back(it.ordinal());
+      tiles.push_back(it->get());
+    }
+    detail::write_checkpoint_tiles(prefix, world.rank(), ordinals, tiles);
+
+    world.gop.fence();
+  }
+
+  /// Write an array checkpoint in the background
+
+  /// The checkpoint has the format of \c write_checkpoint() , but it is
+  /// written by background I/O threads (see \c detail::CheckpointWriter ),
+  /// so it overlaps with the computation that follows. The array is
+  /// snapshotted when this is called: the local tiles are held by reference
+  /// count, so the array may be reassigned or destroyed, e.g. by the next
+  /// iteration of a solver, before the checkpoint is written. The tiles are
+  /// written once they are ready.
+  /// \code
+  /// Future<bool> t2_done = TiledArray::write_checkpoint_async(t2, "t2");
+  /// t2("a,b,i,j") = ...; // the next iteration
+  /// if(! t2_done.get()) ...
+  /// \endcode
+  /// \tparam Tile The tile type of the array
+  /// \tparam Policy The policy type of the array
+  /// \param array The array to be written
+  /// \param prefix The checkpoint file prefix
+  /// \return A future that is set to \c true when the files of this process
+  /// are written, or \c false if a file could not be written
+  /// \note This is a collective operation, but it does not wait for the
+  /// tiles or fence the world. The checkpoint is complete when the futures
+  /// of all processes are set.
+  /// \note Tiles that are modified in place before they are written are
+  /// written with the modifications.
+  template <typename Tile, typename Policy>
+  inline Future<bool> write_checkpoint_async(const DistArray<Tile, Policy>& array,
+      const std::string& prefix)
+  {
+    typedef typename DistArray<Tile, Policy>::shape_type shape_type;
+    typedef detail::CheckpointSnapshot<shape_type> snapshot_type;
+    World& world = array.world();
+
+    // Snapshot the array
+    std::shared_ptr<snapshot_type> snapshot = std::make_shared<snapshot_type>();
+    snapshot->prefix = prefix;
+    snapshot->rank = world.rank();
+    snapshot->nfiles = world.size();
+    snapshot->trange = array.trange();
+    snapshot->shape = array.shape();
+    std::vector<Future<Tile> > tiles;
+    for(auto it = array.begin(); it != array.end(); ++it) {
+      snapshot->ordinals.push_back(it.ordinal());
+      tiles.push_back(*it);
+    }
+
+    // Write the files when the tiles are ready
+    world.taskq.add(& detail::submit_checkpoint<shape_type, Tile>, snapshot,
+        tiles);
+
+    return snapshot->done;
+  }
+
+  /// Read an array checkpoint
+
+  /// The checkpoint may have been written by a different number of processes
+  /// and with a different process map than those of the new array. Each rank
+  /// reads only the tiles it owns, in the order they appear in the data files.
+  /// \tparam Array The array type, which must match the tile and shape type of
+  /// the array that was written
+  /// \param world The world of the new array
+  /// \param prefix The checkpoint file prefix
+  /// \param pmap The process map of the new array; the default process map is
+  /// used if \c pmap is null
+  /// \return The array stored in the checkpoint
+  /// \throw TiledArray::Exception When a file cannot be opened or does not
+  /// hold a compatible checkpoint
+  template <typename Array>
+  inline Array read_checkpoint(World& world, const std::string& prefix,
+      const std::shared_ptr<typename Array::pmap_interface>& pmap =
+          std::shared_ptr<typename Array::pmap_interface>())
+  {
+    typedef typename Array::value_type value_type;
+    typedef typename Array::shape_type shape_type;
+
+    // Read the tiled range and shape
+    std::size_t nfiles = 0ul;
+    TiledRange trange;
+    shape_type shape;
+    {
+      std::ifstream test((prefix + ".meta").c_str());
+      TA_USER_ASSERT(test.good(),
+          "read_checkpoint(): Unable to open the checkpoint meta data file.");
+    }
+    {
+      madness::archive::BinaryFstreamInputArchive ar((prefix + ".meta").c_str());
+      std::string magic;
+      unsigned int version = 0u;
+      ar & magic & version;
+      TA_USER_ASSERT(magic == "TiledArray checkpoint",
+          "read_checkpoint(): The file is not a TiledArray checkpoint.");
+      TA_USER_ASSERT((version >= 1u) && (version <= TILEDARRAY_CHECKPOINT_VERSION),
+          "read_checkpoint(): The checkpoint version is not supported.");
+
+      std::vector<std::vector<std::size_t> > boundaries;
+      ar & nfiles & boundaries;
+      std::vector<TiledRange1> ranges;
+      for(const std::vector<std::size_t>& tile_boundaries : boundaries)
+        ranges.emplace_back(tile_boundaries.begin(), tile_boundaries.end());
+      trange = TiledRange(ranges.begin(), ranges.end());
+
+      shape = detail::read_checkpoint_shape(ar, trange, version,
+          static_cast<const shape_type*>(nullptr));
+    }
+
+    Array result(world, trange, shape, pmap);
+
+    // Collect the location of the local tiles
+    std::vector<detail::CheckpointRecord> local;
+    for(std::size_t f = 0ul; f < nfiles; ++f) {
+      const std::string name = detail::checkpoint_file_name(prefix, f, ".idx");
+      {
+        std::ifstream test(name.c_str());
+        TA_USER_ASSERT(test.good(),
+            "read_checkpoint(): Unable to open a checkpoint index file.");
+      }
+      std::vector<detail::CheckpointRecord> records;
+      madness::archive::BinaryFstreamInputArchive ar(name.c_str());
+      ar & records;
+      for(detail::CheckpointRecord& record : records) {
+        if(result.is_local(record.ordinal)) {
+          record.file = f;
+          local.push_back(record);
+        }
+      }
+    }
+    std::sort(local.begin(), local.end(),
+        [] (const detail::CheckpointRecord& l, const detail::CheckpointRecord& r)
+        { return (l.file < r.file) || ((l.file == r.file) && (l.offset < r.offset)); });
+
+    // Read the local tiles
+    std::ifstream file;
+    std::size_t current = nfiles;
+    std::vector<unsigned char> buffer;
+    for(const detail::CheckpointRecord& record : local) {
+      if(record.file != current) {
+        file.close();
+        file.open(detail::checkpoint_file_name(prefix, record.file).c_str(),
+            std::ios::binary);
+        TA_USER_ASSERT(file.good(),
+            "read_checkpoint(): Unable to open a checkpoint data file.");
+        current = record.file;
+      }
+
+      buffer.resize(record.size);
+      file.seekg(record.offset);
+      file.read(reinterpret_cast<char*>(buffer.data()), record.size);
+      TA_USER_ASSERT(file.good(),
+          "read_checkpoint(): Unable to read a checkpoint data file.");
+
+      value_type tile;
+      madness::archive::BufferInputArchive ar(buffer.data(), record.size);
+      ar & tile;
+      result.set(record.ordinal, tile);
+    }
+
+    world.gop.fence();
+
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CHECKPOINT_H__INCLUDED
@@ -0,0 +1,324 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  comm_tracker.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_COMM_TRACKER_H__INCLUDED
+#define TILEDARRAY_COMM_TRACKER_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/profiler.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Communication categories
+
+  /// Each category is the kind of operation that caused the traffic.
+  enum class CommCategory : unsigned int {
+    summa_col = 0u, ///< SUMMA broadcast of a column of the left argument
+    summa_row = 1u, ///< SUMMA broadcast of a row of the right argument
+    remote_get = 2u, ///< Remote tile requests (e.g. \c DistArray::find )
+    remote_set = 3u, ///< Remote tile assignments (e.g. \c DistArray::set )
+    replicate = 4u ///< Array replication (see \c detail::Replicator )
+  }; // enum class CommCategory
+
+  /// Communication counters of a category
+  struct CommUsage {
+    std::size_t messages_sent; ///< Number of messages sent
+    std::size_t bytes_sent; ///< Number of tile bytes sent
+    std::size_t messages_received; ///< Number of messages received
+    std::size_t bytes_received; ///< Number of tile bytes received
+    double wait_time; ///< Time, in seconds, from request to arrival of received data
+  }; // struct CommUsage
+
+  /// Communication tracker
+
+  /// The tracker counts the messages and tile bytes sent and received by this
+  /// process in each communication category, and the time that received data
+  /// was waited for, i.e. the time from the request of a remote tile, or the
+  /// start of a SUMMA broadcast, until the tile arrives. Only tile data is
+  /// counted, so tiles of types without a range count as messages of zero
+  /// bytes. Tracking is disabled by default; it is enabled with \c enable()
+  /// or by setting the \c TA_COMM_TRACK environment variable.
+  /// \note There is one tracker per process. Since expressions are evaluated
+  /// asynchronously, the traffic of an expression is complete only after the
+  /// world has been fenced, e.g.
+  /// \code
+  /// CommTracker::instance().reset();
+  /// c("i,j") = a("i,k") * b("k,j");
+  /// world.gop.fence();
+  /// print_comm_usage(world);
+  /// \endcode
+  class CommTracker {
+  public:
+    static constexpr unsigned int num_categories = 5u; ///< Number of communication categories
+    typedef std::chrono::steady_clock clock_type; ///< Clock type
+    typedef clock_type::time_point time_point; ///< Time point type
+
+  private:
+    /// The counters of a category
+    struct Counters {
+      std::atomic<std::size_t> messages_sent;
+      std::atomic<std::size_t> bytes_sent;
+      std::atomic<std::size_t> messages_received;
+      std::atomic<std::size_t> bytes_received;
+      std::atomic<std::size_t> wait_ns;
+    }; // struct Counters
+
+    std::atomic<bool> enabled_; ///< Tracking flag
+    Counters counters_[num_categories]; ///< The counters of each category
+
+    CommTracker() : enabled_(getenv("TA_COMM_TRACK") != nullptr) { reset(); }
+
+    CommTracker(const CommTracker&) = delete;
+    CommTracker& operator=(const CommTracker&) = delete;
+
+    Counters& counters(const CommCategory category) {
+      return counters_[static_cast<unsigned int>(category)];
+    }
+
+  public:
+
+    /// Tracker accessor
+
+    /// \return A reference to the communication tracker of this process
+    static CommTracker& instance() {
+      static CommTracker* const tracker = new CommTracker();
+      return *tracker;
+    }
+
+    /// Category name
+
+    /// \param category The communication category
+    /// \return The name of \c category
+    static const char* name(const CommCategory category) {
+      static const char* const names[num_categories] =
+          { "summa_col", "summa_row", "remote_get", "remote_set", "replicate" };
+      return names[static_cast<unsigned int>(category)];
+    }
+
+    /// Current time
+
+    /// \return The current time point
+    static time_point now() { return clock_type::now(); }
+
+    /// Enable tracking
+    void enable() { enabled_.store(true, std::memory_order_relaxed); }
+
+    /// Disable tracking
+
+    /// The counters are kept.
+    void disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+    /// Tracking status
+
+    /// \return \c true if communication is counted
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Record sent messages
+
+    /// \param category The communication category
+    /// \param bytes The number of tile bytes sent
+    /// \param messages The number of messages sent
+    void send(const CommCategory category, const std::size_t bytes,
+        const std::size_t messages = 1ul)
+    {
+      Counters& c = counters(category);
+      c.messages_sent.fetch_add(messages, std::memory_order_relaxed);
+      c.bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /// Record received messages
+
+    /// \param category The communication category
+    /// \param bytes The number of tile bytes received
+    /// \param start The time that the data was requested
+    /// \param messages The number of messages received
+    void receive(const CommCategory category, const std::size_t bytes,
+        const time_point& start, const std::size_t messages = 1ul)
+    {
+      Counters& c = counters(category);
+      c.messages_received.fetch_add(messages, std::memory_order_relaxed);
+      c.bytes_received.fetch_add(bytes, std::memory_order_relaxed);
+      c.wait_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          now() - start).count(), std::memory_order_relaxed);
+    }
+
+    /// Communication counters of a category
+
+    /// \param category The communication category
+    /// \return The counters of \c category
+    CommUsage usage(const CommCategory category) const {
+      const Counters& c = counters_[static_cast<unsigned int>(category)];
+      return CommUsage{ c.messages_sent.load(std::memory_order_relaxed),
+          c.bytes_sent.load(std::memory_order_relaxed),
+          c.messages_received.load(std::memory_order_relaxed),
+          c.bytes_received.load(std::memory_order_relaxed),
+          double(c.wait_ns.load(std::memory_order_relaxed)) * 1.0e-9 };
+    }
+
+    /// Reset all counters to zero
+    void reset() {
+      for(Counters& c : counters_) {
+        c.messages_sent = 0ul;
+        c.bytes_sent = 0ul;
+        c.messages_received = 0ul;
+        c.bytes_received = 0ul;
+        c.wait_ns = 0ul;
+      }
+    }
+
+  }; // class CommTracker
+
+  namespace detail {
+
+    /// Record a tile that is sent or received when it is ready
+
+    /// \tparam T The tile type
+    template <typename T>
+    class CommCallback : public madness::CallbackInterface {
+      const CommCategory category_; ///< The communication category
+      const bool receive_; ///< \c true for received tiles
+      const CommTracker::time_point start_; ///< The time of the request
+      Future<T> tile_; ///< The tile
+
+    public:
+
+      CommCallback(const CommCategory category, const bool receive,
+          const Future<T>& tile) :
+        category_(category), receive_(receive), start_(CommTracker::now()),
+        tile_(tile)
+      { }
+
+      virtual ~CommCallback() { }
+
+      virtual void notify() {
+        const std::size_t bytes = tile_bytes(tile_.get());
+        if(receive_)
+          CommTracker::instance().receive(category_, bytes, start_);
+        else
+          CommTracker::instance().send(category_, bytes);
+        delete this;
+      }
+    }; // class CommCallback
+
+    /// Count a tile that is sent by this process
+
+    /// The tile is counted when it is ready. Nothing is recorded when
+    /// tracking is disabled.
+    /// \tparam T The tile type
+    /// \param category The communication category
+    /// \param tile The tile
+    template <typename T>
+    inline void comm_send(const CommCategory category, const Future<T>& tile) {
+      if(CommTracker::instance().enabled())
+        const_cast<Future<T>&>(tile).register_callback(
+            new CommCallback<T>(category, false, tile));
+    }
+
+    /// Count a tile that is received by this process
+
+    /// The tile is counted, and its wait time measured, when it arrives.
+    /// Nothing is recorded when tracking is disabled.
+    /// \tparam T The tile type
+    /// \param category The communication category
+    /// \param tile The tile
+    template <typename T>
+    inline void comm_receive(const CommCategory category, const Future<T>& tile) {
+      if(CommTracker::instance().enabled())
+        const_cast<Future<T>&>(tile).register_callback(
+            new CommCallback<T>(category, true, tile));
+    }
+
+  } // namespace detail
+
+  /// Communication counters of this process
+
+  /// \param category The communication category
+  /// \return The counters of \c category on this process
+  inline CommUsage comm_usage(const CommCategory category) {
+    return CommTracker::instance().usage(category);
+  }
+
+  /// Communication counters of all processes
+
+  /// This is a collective operation.
+  /// \param world The world of the processes
+  /// \return The sum of the counters of each category over all processes, in
+  /// the order of \c CommCategory
+  inline std::vector<CommUsage> sum_comm_usage(World& world) {
+    constexpr unsigned int n = CommTracker::num_categories;
+    const CommTracker& tracker = CommTracker::instance();
+    double buffer[5u * n];
+    for(unsigned int c = 0u; c < n; ++c) {
+      const CommUsage usage = tracker.usage(static_cast<CommCategory>(c));
+      buffer[5u * c] = usage.messages_sent;
+      buffer[5u * c + 1u] = usage.bytes_sent;
+      buffer[5u * c + 2u] = usage.messages_received;
+      buffer[5u * c + 3u] = usage.bytes_received;
+      buffer[5u * c + 4u] = usage.wait_time;
+    }
+    world.gop.sum(buffer, 5u * n);
+
+    std::vector<CommUsage> result;
+    result.reserve(n);
+    for(unsigned int c = 0u; c < n; ++c)
+      result.push_back(CommUsage{ std::size_t(buffer[5u * c]),
+          std::size_t(buffer[5u * c + 1u]), std::size_t(buffer[5u * c + 2u]),
+          std::size_t(buffer[5u * c + 3u]), buffer[5u * c + 4u] });
+    return result;
+  }
+
+  /// Print the communication counters of all processes
+
+  /// This is a collective operation; the report is printed by rank 0.
+  /// \param world The world of the processes
+  /// \param os The output stream
+  inline void print_comm_usage(World& world, std::ostream& os = std::cout) {
+    const std::vector<CommUsage> usage = sum_comm_usage(world);
+    if(world.rank() != 0)
+      return;
+
+    os << "Communication (sum over " << world.size() << " processes):\n"
+       << std::setw(12) << "category" << std::setw(12) << "sent"
+       << std::setw(14) << "sent MB" << std::setw(12) << "received"
+       << std::setw(14) << "received MB" << std::setw(14) << "wait s" << "\n";
+    for(unsigned int c = 0u; c < usage.size(); ++c) {
+      os << std::setw(12) << CommTracker::name(static_cast<CommCategory>(c))
+         << std::setw(12) << usage[c].messages_sent
+         << std::setw(14) << double(usage[c].bytes_sent) / 1048576.0
+         << std::setw(12) << usage[c].messages_received
+         << std::setw(14) << double(usage[c].bytes_received) / 1048576.0
+         << std::setw(14) << usage[c].wait_time << "\n";
+    }
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_COMM_TRACKER_H__INCLUDED
@@ -0,0 +1,1053 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  compressed_shape.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_COMPRESSED_SHAPE_H__INCLUDED
+#define TILEDARRAY_COMPRESSED_SHAPE_H__INCLUDED
+
+#include <TiledArray/sparse_shape.h>
+#include <algorithm>
+#include <numeric>
+
+namespace TiledArray {
+
+  /// Sparse shape with compressed norm storage
+
+  /// CompressedShape holds the same normalized tile norms as SparseShape ,
+  /// but it stores only the norms of non-zero tiles, as a list of
+  /// <tt>(ordinal, norm)</tt> pairs that is sorted by tile ordinal. The
+  /// memory required by the shape is proportional to the number of non-zero
+  /// tiles instead of the number of tiles, which makes it suitable for
+  /// arrays with a very large number of tiles and a low density.
+  ///
+  /// Shape arithmetic, i.e. \c gemm , \c mask , \c add , \c mult , \c perm ,
+  /// etc., works directly on the compressed data. Only \c data() and the
+  /// addition of a constant, which produces a dense shape, touch every tile.
+  /// The norm of a single tile is found with a binary search.
+  /// \tparam T The sparse element value type
+  /// \note The zero threshold is shared with SparseShape<T> .
+  /// \note Split norms are not supported.
+  template <typename T>
+  class CompressedShape {
+  public:
+    typedef CompressedShape<T> CompressedShape_; ///< This object type
+    typedef T value_type; ///< The norm value type
+    typedef Range::size_type size_type; ///< Size type
+
+  private:
+
+    // T must be a numeric type
+    static_assert(std::is_floating_point<T>::value,
+        "CompressedShape template type T must be a floating point type");
+
+    // Internal typedefs
+    typedef detail::ValArray<value_type> vector_type;
+
+    /// Norms of the non-zero tiles
+    struct Entries {
+      std::vector<size_type> ordinals; ///< Tile ordinals, in ascending order
+      std::vector<value_type> norms; ///< Normalized norms of the tiles in \c ordinals
+
+      /// Append a norm if it is not below the zero threshold
+
+      /// \param ordinal The tile ordinal, which must be larger than all
+      /// ordinals in the list
+      /// \param norm The normalized norm of the tile
+      void append(const size_type ordinal, const value_type norm) {
+        TA_ASSERT(ordinals.empty() || (ordinals.back() < ordinal));
+        if(norm >= threshold()) {
+          ordinals.push_back(ordinal);
+          norms.push_back(norm);
+        }
+      }
+
+      /// \return The number of non-zero tiles
+      size_type size() const { return ordinals.size(); }
+    }; // struct Entries
+
+    typedef std::vector<std::pair<size_type, value_type> > pair_list;
+
+    Range range_; ///< The tiles range
+    std::shared_ptr<vector_type> size_vectors_; ///< Tile size information; size_vectors_[d][i] reports the size of i-th tile in dimension d
+    std::shared_ptr<const Entries> entries_; ///< Norms of the non-zero tiles
+
+    CompressedShape(const Range& range,
+        const std::shared_ptr<vector_type>& size_vectors,
+        const std::shared_ptr<const Entries>& entries) :
+      range_(range), size_vectors_(size_vectors), entries_(entries)
+    { }
+
+    static std::shared_ptr<vector_type>
+    initialize_size_vectors(const TiledRange& trange) {
+      // Allocate memory for size vectors
+      const unsigned int dim = trange.tiles_range().rank();
+      std::shared_ptr<vector_type> size_vectors(new vector_type[dim],
+          std::default_delete<vector_type[]>());
+
+      // Initialize the size vectors
+      for(unsigned int i = 0ul; i != dim; ++i) {
+        const size_type n = trange.data()[i].tiles_range().second - trange.data()[i].tiles_range().first;
+
+        size_vectors.get()[i] = vector_type(n, & (* trange.data()[i].begin()),
+            [] (const TiledRange1::range_type& tile)
+            { return value_type(tile.second - tile.first); });
+      }
+
+      return size_vectors;
+    }
+
+    std::shared_ptr<vector_type> perm_size_vectors(const Permutation& perm) const {
+      const unsigned int n = range_.rank();
+
+      // Allocate memory for the permuted size vectors
+      std::shared_ptr<vector_type> result_size_vectors(new vector_type[n],
+          std::default_delete<vector_type[]>());
+
+      // Initialize the size vectors
+      for(unsigned int i = 0u; i < n; ++i) {
+        const unsigned int perm_i = perm[i];
+        result_size_vectors.get()[perm_i] = size_vectors_.get()[i];
+      }
+
+      return result_size_vectors;
+    }
+
+    /// Compute the coordinates of a tile
+
+    /// \param ordinal The ordinal of the tile in \c range
+    /// \param range The range of the tile
+    /// \param[out] coordinates The zero-based coordinates of the tile
+    static void coordinates(size_type ordinal, const Range& range,
+        size_type* MADNESS_RESTRICT const coordinates)
+    {
+      const size_type* MADNESS_RESTRICT const extent = range.extent_data();
+      for(int d = int(range.rank()) - 1; d >= 0; --d) {
+        coordinates[d] = ordinal % extent[d];
+        ordinal /= extent[d];
+      }
+    }
+
+    /// Compute the number of elements in a tile
+
+    /// \param ordinal The ordinal of the tile in \c range
+    /// \param range The range of the tile
+    /// \param size_vectors The size vectors of \c range
+    /// \return The number of elements in the tile
+    static value_type volume(size_type ordinal, const Range& range,
+        const vector_type* MADNESS_RESTRICT const size_vectors)
+    {
+      const size_type* MADNESS_RESTRICT const extent = range.extent_data();
+      value_type result = 1;
+      for(int d = int(range.rank()) - 1; d >= 0; --d) {
+        result *= size_vectors[d][ordinal % extent[d]];
+        ordinal /= extent[d];
+      }
+      return result;
+    }
+
+    /// Compute the sizes of the tiles of a product of dimensions
+
+    /// \param size_vectors The size vectors of the dimensions
+    /// \param n The number of dimensions
+    /// \return The number of elements in each tile of the product, in
+    /// row-major order
+    static std::vector<value_type>
+    outer_sizes(const vector_type* const size_vectors, const unsigned int n) {
+      std::vector<value_type> result(1ul, value_type(1));
+      for(unsigned int d = 0u; d < n; ++d) {
+        const vector_type& sizes = size_vectors[d];
+        std::vector<value_type> temp;
+        temp.reserve(result.size() * sizes.size());
+        for(const value_type left : result)
+          for(std::size_t i = 0ul; i < sizes.size(); ++i)
+            temp.push_back(left * sizes[i]);
+        result.swap(temp);
+      }
+      return result;
+    }
+
+    /// Compress normalized tile norms
+
+    /// \param norms The normalized norms of all tiles in \c range_
+    /// \param normalize If \c true , \c norms are divided by the number of
+    /// elements in each tile
+    /// \return The non-zero norms of \c norms
+    std::shared_ptr<const Entries>
+    compress(const value_type* MADNESS_RESTRICT const norms,
+        const bool normalize) const
+    {
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+      const size_type n = range_.volume();
+      for(size_type i = 0ul; i < n; ++i) {
+        if(norms[i] == value_type(0))
+          continue;
+        result->append(i, (normalize ?
+            norms[i] / volume(i, range_, size_vectors_.get()) : norms[i]));
+      }
+      return result;
+    }
+
+    /// Compress a list of tile norms
+
+    /// The norms of tiles that appear more than once in \c pairs are summed.
+    /// \param pairs A list of <tt>(ordinal, norm)</tt> pairs, where the norms
+    /// are not normalized
+    /// \return The non-zero, normalized norms of \c pairs
+    std::shared_ptr<const Entries> compress(pair_list& pairs) const {
+      std::sort(pairs.begin(), pairs.end(),
+          [] (const typename pair_list::value_type& left,
+              const typename pair_list::value_type& right)
+          { return left.first < right.first; });
+
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+      for(auto it = pairs.begin(); it != pairs.end();) {
+        const size_type ordinal = it->first;
+        value_type norm = value_type(0);
+        for(; (it != pairs.end()) && (it->first == ordinal); ++it)
+          norm += it->second;
+        result->append(ordinal, norm / volume(ordinal, range_, size_vectors_.get()));
+      }
+      return result;
+    }
+
+    /// Collect tile norms given as a sparse tensor
+
+    /// \tparam SparseNormSequence The sequence of
+    /// <tt>std::pair<index,value_type></tt> objects
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \return A list of <tt>(ordinal, norm)</tt> pairs
+    template <typename SparseNormSequence>
+    pair_list make_pairs(const SparseNormSequence& tile_norms) const {
+      pair_list pairs;
+      for(const auto& pair_idx_norm : tile_norms)
+        pairs.emplace_back(range_.ordinal(pair_idx_norm.first),
+            value_type(pair_idx_norm.second));
+      return pairs;
+    }
+
+    /// Gather a list of tile norms from all processes
+
+    /// \param world The world where the shape will live
+    /// \param[in,out] pairs The local list on input, and the concatenation of
+    /// the lists of all processes on output
+    static void all_gather(World& world, pair_list& pairs) {
+      std::vector<size_type> ordinals;
+      std::vector<value_type> norms;
+      ordinals.reserve(pairs.size());
+      norms.reserve(pairs.size());
+      for(const auto& pair : pairs) {
+        ordinals.push_back(pair.first);
+        norms.push_back(pair.second);
+      }
+
+      detail::all_gather_sparse(world, ordinals, norms);
+
+      pairs.clear();
+      pairs.reserve(ordinals.size());
+      for(size_type i = 0ul; i < ordinals.size(); ++i)
+        pairs.emplace_back(ordinals[i], norms[i]);
+    }
+
+    /// Merge the non-zero norms of two shapes
+
+    /// \tparam Op The norm operation type
+    /// \param left The left-hand norms
+    /// \param right The right-hand norms
+    /// \param intersect If \c true , only tiles that are non-zero in both
+    /// arguments are evaluated, otherwise tiles that are non-zero in either
+    /// argument are evaluated
+    /// \param op The result norm operation, with the signature
+    /// <tt>value_type op(size_type ordinal, value_type left, value_type right)</tt> ,
+    /// where the norm of a zero tile is zero
+    /// \return The non-zero norms of the result
+    template <typename Op>
+    static std::shared_ptr<const Entries>
+    merge(const Entries& left, const Entries& right, const bool intersect,
+        const Op& op)
+    {
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+      if(! intersect)
+        result->ordinals.reserve(std::max(left.size(), right.size()));
+
+      size_type l = 0ul, r = 0ul;
+      while((l < left.size()) && (r < right.size())) {
+        const size_type left_ordinal = left.ordinals[l];
+        const size_type right_ordinal = right.ordinals[r];
+        if(left_ordinal == right_ordinal) {
+          result->append(left_ordinal, op(left_ordinal, left.norms[l], right.norms[r]));
+          ++l;
+          ++r;
+        } else if(left_ordinal < right_ordinal) {
+          if(! intersect)
+            result->append(left_ordinal, op(left_ordinal, left.norms[l], value_type(0)));
+          ++l;
+        } else {
+          if(! intersect)
+            result->append(right_ordinal, op(right_ordinal, value_type(0), right.norms[r]));
+          ++r;
+        }
+      }
+
+      if(! intersect) {
+        for(; l < left.size(); ++l)
+          result->append(left.ordinals[l], op(left.ordinals[l], left.norms[l], value_type(0)));
+        for(; r < right.size(); ++r)
+          result->append(right.ordinals[r], op(right.ordinals[r], value_type(0), right.norms[r]));
+      }
+
+      return result;
+    }
+
+    /// Find the norm of a tile
+
+    /// \param ordinal The ordinal of the tile
+    /// \return A pointer to the norm of the tile, or \c nullptr if the tile is
+    /// zero
+    const value_type* find(const size_type ordinal) const {
+      const std::vector<size_type>& ordinals = entries_->ordinals;
+      const auto it = std::lower_bound(ordinals.begin(), ordinals.end(), ordinal);
+      if((it == ordinals.end()) || (*it != ordinal))
+        return nullptr;
+      return entries_->norms.data() + (it - ordinals.begin());
+    }
+
+  public:
+
+    /// Default constructor
+
+    /// Construct a shape with no data.
+    CompressedShape() : range_(), size_vectors_(), entries_() { }
+
+    /// Constructor
+
+    /// This constructor will normalize the tile norms, where the
+    /// normalization constant for each tile is the inverse of the number of
+    /// elements in the tile, and store the norms that are not below the zero
+    /// threshold.
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    CompressedShape(const Tensor<value_type>& tile_norms, const TiledRange& trange) :
+      range_(trange.tiles_range()), size_vectors_(initialize_size_vectors(trange)),
+      entries_()
+    {
+      TA_ASSERT(! tile_norms.empty());
+      TA_ASSERT(tile_norms.range() == range_);
+
+      entries_ = compress(tile_norms.data(), true);
+    }
+
+    /// "Sparse" constructor
+
+    /// This constructor uses tile norms given as a sparse tensor, represented
+    /// as a sequence of {index,value_type} data, so the norms of all tiles
+    /// are never stored. The tile norms are normalized to per-element norms
+    /// by dividing each norm by the number of elements in the corresponding
+    /// tile.
+    /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
+    ///         where \c index is a directly-addressable sequence indices.
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    template <typename SparseNormSequence>
+    CompressedShape(const SparseNormSequence& tile_norms,
+        const TiledRange& trange) :
+      range_(trange.tiles_range()), size_vectors_(initialize_size_vectors(trange)),
+      entries_()
+    {
+      pair_list pairs = make_pairs(tile_norms);
+      entries_ = compress(pairs);
+    }
+
+    /// Collective "dense" constructor
+
+    /// The tile norms are summed across all processes (via an all reduce),
+    /// then normalized and compressed.
+    /// \param world The world where the shape will live
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    CompressedShape(World& world, const Tensor<value_type>& tile_norms,
+        const TiledRange& trange) :
+      range_(trange.tiles_range()), size_vectors_(initialize_size_vectors(trange)),
+      entries_()
+    {
+      TA_ASSERT(! tile_norms.empty());
+      TA_ASSERT(tile_norms.range() == range_);
+
+      // reduce norm data from all processors
+      Tensor<value_type> norms = tile_norms.clone();
+      detail::sparse_allreduce(world, norms.data(), norms.size());
+
+      entries_ = compress(norms.data(), true);
+    }
+
+    /// Collective "sparse" constructor
+
+    /// The sparse tile norms of all processes are gathered, so the memory and
+    /// communication required are proportional to the number of non-zero
+    /// tiles. The norms of tiles that are given by more than one process are
+    /// summed.
+    /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
+    ///         where \c index is a directly-addressable sequence of integers.
+    /// \param world The world where the shape will live
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param trange The tiled range of the tensor
+    template <typename SparseNormSequence>
+    CompressedShape(World& world, const SparseNormSequence& tile_norms,
+        const TiledRange& trange) :
+      range_(trange.tiles_range()), size_vectors_(initialize_size_vectors(trange)),
+      entries_()
+    {
+      pair_list pairs = make_pairs(tile_norms);
+      all_gather(world, pairs);
+      entries_ = compress(pairs);
+    }
+
+    /// Compress a sparse shape
+
+    /// \param shape The shape to be compressed
+    /// \param trange The tiled range of \c shape
+    CompressedShape(const SparseShape<value_type>& shape, const TiledRange& trange) :
+      range_(trange.tiles_range()), size_vectors_(initialize_size_vectors(trange)),
+      entries_()
+    {
+      TA_ASSERT(shape.validate(range_));
+
+      entries_ = compress(shape.data().data(), false);
+    }
+
+    /// Validate shape range
+
+    /// \return \c true when range matches the range of this shape
+    bool validate(const Range& range) const {
+      if(empty())
+        return false;
+      return (range == range_);
+    }
+
+    /// Check that a tile is zero
+
+    /// \tparam Index The type of the index
+    /// \param i The ordinal or coordinate index of the tile
+    /// \return \c true if the norm of tile \c i is below the zero threshold
+    template <typename Index>
+    bool is_zero(const Index& i) const {
+      TA_ASSERT(! empty());
+      const value_type* const norm = find(range_.ordinal(i));
+      return (norm == nullptr) || (*norm < threshold());
+    }
+
+    /// Check density
+
+    /// \return false
+    static constexpr bool is_dense() { return false; }
+
+    /// Sparsity of the shape
+
+    /// \return The fraction of tiles that are zero.
+    float sparsity() const {
+      TA_ASSERT(! empty());
+      return float(range_.volume() - entries_->size()) / float(range_.volume());
+    }
+
+    /// Non-zero tile count accessor
+
+    /// \return The number of tiles that have a stored norm
+    size_type nnz() const {
+      TA_ASSERT(! empty());
+      return entries_->size();
+    }
+
+    /// Threshold accessor
+
+    /// \return The current threshold, which is SparseShape<T>::threshold()
+    static value_type threshold() { return SparseShape<T>::threshold(); }
+
+    /// Set threshold to \c thresh
+
+    /// \param thresh The new threshold
+    static void threshold(const value_type thresh) { SparseShape<T>::threshold(thresh); }
+
+    /// Tile norm accessor
+
+    /// \tparam Index The index type
+    /// \param index The ordinal or coordinate index of the tile
+    /// \return The normalized norm of the tile at \c index
+    template <typename Index>
+    value_type operator[](const Index& index) const {
+      TA_ASSERT(! empty());
+      const value_type* const norm = find(range_.ordinal(index));
+      return (norm ? *norm : value_type(0));
+    }
+
+    /// Dense data accessor
+
+    /// \return A tensor with the normalized norms of all tiles
+    /// \note This function stores the norm of every tile, so it should only
+    /// be used when the number of tiles is small.
+    Tensor<value_type> data() const {
+      TA_ASSERT(! empty());
+      Tensor<value_type> result(range_, value_type(0));
+      for(size_type i = 0ul; i < entries_->size(); ++i)
+        result[entries_->ordinals[i]] = entries_->norms[i];
+      return result;
+    }
+
+    /// Initialization check
+
+    /// \return \c true when this shape has not been initialized.
+    bool empty() const { return ! entries_; }
+
+    /// Compute union of two shapes
+
+    /// \param mask_shape The input shape, hard zeros are used to mask the output.
+    /// \return A shape that is masked by the mask.
+    CompressedShape_ mask(const CompressedShape_& mask_shape) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! mask_shape.empty());
+      TA_ASSERT(range_ == mask_shape.range_);
+
+      return CompressedShape_(range_, size_vectors_,
+          merge(*entries_, *mask_shape.entries_, true,
+          [] (const size_type, const value_type left, const value_type)
+          { return left; }));
+    }
+
+    /// Update sub-block of shape
+
+    /// Update a sub-block shape information with another shape object.
+    /// \tparam Index The bound index type
+    /// \param lower_bound The lower bound of the sub-block to be updated
+    /// \param upper_bound The upper bound of the sub-block to be updated
+    /// \param other The shape that will be used to update the sub-block
+    /// \return A new shape object where the specified sub-block contains the
+    /// data of \c other.
+    template <typename Index>
+    CompressedShape_ update_block(const Index& lower_bound,
+        const Index& upper_bound, const CompressedShape_& other) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      const unsigned int rank = range_.rank();
+      const auto* MADNESS_RESTRICT const lower = detail::data(lower_bound);
+      const auto* MADNESS_RESTRICT const upper = detail::data(upper_bound);
+      const size_type* MADNESS_RESTRICT const lobound = range_.lobound_data();
+      const size_type* MADNESS_RESTRICT const extent = range_.extent_data();
+      TA_ASSERT(other.range_.rank() == rank);
+
+      std::vector<size_type> index(rank);
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+
+      // Keep the tiles of this shape that are outside the block
+      for(size_type i = 0ul; i < entries_->size(); ++i) {
+        const size_type ordinal = entries_->ordinals[i];
+        coordinates(ordinal, range_, index.data());
+        bool in_block = true;
+        for(unsigned int d = 0u; in_block && (d < rank); ++d)
+          in_block = (index[d] + lobound[d] >= size_type(lower[d])) &&
+              (index[d] + lobound[d] < size_type(upper[d]));
+        if(! in_block) {
+          result->ordinals.push_back(ordinal);
+          result->norms.push_back(entries_->norms[i]);
+        }
+      }
+
+      // Insert the tiles of other
+      pair_list pairs;
+      pairs.reserve(other.entries_->size());
+      for(size_type i = 0ul; i < other.entries_->size(); ++i) {
+        coordinates(other.entries_->ordinals[i], other.range_, index.data());
+        size_type ordinal = 0ul;
+        for(unsigned int d = 0u; d < rank; ++d)
+          ordinal = ordinal * extent[d] + index[d] + (lower[d] - lobound[d]);
+        pairs.emplace_back(ordinal, other.entries_->norms[i]);
+      }
+
+      // Merge the two sorted lists
+      std::shared_ptr<Entries> merged = std::make_shared<Entries>();
+      merged->ordinals.reserve(result->size() + pairs.size());
+      merged->norms.reserve(result->size() + pairs.size());
+      size_type l = 0ul;
+      for(const auto& pair : pairs) {
+        for(; (l < result->size()) && (result->ordinals[l] < pair.first); ++l)
+          merged->append(result->ordinals[l], result->norms[l]);
+        merged->append(pair.first, pair.second);
+      }
+      for(; l < result->size(); ++l)
+        merged->append(result->ordinals[l], result->norms[l]);
+
+      return CompressedShape_(range_, size_vectors_, merged);
+    }
+
+    /// Create a scaled copy of a sub-block of the shape
+
+    /// \tparam Index The upper and lower bound array type
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    /// \param factor The scaling factor
+    template <typename Index, typename Factor>
+    CompressedShape_ block(const Index& lower_bound, const Index& upper_bound,
+        const Factor factor) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(detail::size(lower_bound) == range_.rank());
+      TA_ASSERT(detail::size(upper_bound) == range_.rank());
+
+      const value_type abs_factor = to_abs_factor(factor);
+      const unsigned int rank = range_.rank();
+      const auto* MADNESS_RESTRICT const lower = detail::data(lower_bound);
+      const auto* MADNESS_RESTRICT const upper = detail::data(upper_bound);
+      const size_type* MADNESS_RESTRICT const lobound = range_.lobound_data();
+
+      // Construct the block range and size vectors
+      std::vector<size_type> block_extent(rank);
+      std::shared_ptr<vector_type> size_vectors(new vector_type[rank],
+          std::default_delete<vector_type[]>());
+      for(unsigned int d = 0u; d < rank; ++d) {
+        TA_ASSERT(size_type(lower[d]) < size_type(upper[d]));
+        TA_ASSERT(size_type(upper[d]) <= range_.upbound(d));
+        block_extent[d] = upper[d] - lower[d];
+        size_vectors.get()[d] = vector_type(block_extent[d],
+            size_vectors_.get()[d].data() + (lower[d] - lobound[d]));
+      }
+      const Range block_range(block_extent);
+
+      // Copy the tiles in the block; the order of the tiles is preserved
+      std::vector<size_type> index(rank);
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+      for(size_type i = 0ul; i < entries_->size(); ++i) {
+        coordinates(entries_->ordinals[i], range_, index.data());
+        size_type ordinal = 0ul;
+        bool in_block = true;
+        for(unsigned int d = 0u; in_block && (d < rank); ++d) {
+          const size_type x = index[d] + lobound[d];
+          in_block = (x >= size_type(lower[d])) && (x < size_type(upper[d]));
+          ordinal = ordinal * block_extent[d] + (x - lower[d]);
+        }
+        if(in_block)
+          result->append(ordinal, entries_->norms[i] * abs_factor);
+      }
+
+      return CompressedShape_(block_range, size_vectors, result);
+    }
+
+    /// Create a copy of a sub-block of the shape
+
+    /// \tparam Index The upper and lower bound array type
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    template <typename Index>
+    CompressedShape_ block(const Index& lower_bound, const Index& upper_bound) const {
+      return block(lower_bound, upper_bound, value_type(1));
+    }
+
+    /// Create a permuted copy of a sub-block of the shape
+
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    /// \param perm The permutation to be applied to the sub-block
+    template <typename Index>
+    CompressedShape_ block(const Index& lower_bound, const Index& upper_bound,
+        const Permutation& perm) const
+    {
+      return block(lower_bound, upper_bound).perm(perm);
+    }
+
+    /// Create a scaled and permuted copy of a sub-block of the shape
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param lower_bound The lower bound of the sub-block
+    /// \param upper_bound The upper bound of the sub-block
+    /// \param factor The scaling factor
+    /// \param perm The permutation to be applied to the sub-block
+    template <typename Index, typename Factor>
+    CompressedShape_ block(const Index& lower_bound, const Index& upper_bound,
+        const Factor factor, const Permutation& perm) const
+    {
+      return block(lower_bound, upper_bound, factor).perm(perm);
+    }
+
+    /// Create a permuted shape of this shape
+
+    /// The non-zero tiles are moved to their permuted ordinals and sorted, so
+    /// the cost is proportional to the number of non-zero tiles.
+    /// \param perm The permutation to be applied
+    /// \return A new, permuted shape
+    CompressedShape_ perm(const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(perm.dim() == range_.rank());
+
+      const unsigned int rank = range_.rank();
+      const Range result_range = perm * range_;
+
+      // Compute the stride in the result of each dimension of this shape
+      std::vector<size_type> result_stride(rank);
+      {
+        const size_type* MADNESS_RESTRICT const result_extent = result_range.extent_data();
+        std::vector<size_type> stride(rank);
+        size_type volume = 1ul;
+        for(int d = int(rank) - 1; d >= 0; --d) {
+          stride[d] = volume;
+          volume *= result_extent[d];
+        }
+        for(unsigned int d = 0u; d < rank; ++d)
+          result_stride[d] = stride[perm[d]];
+      }
+
+      // Move the tiles to their permuted ordinals
+      std::vector<size_type> index(rank);
+      pair_list pairs;
+      pairs.reserve(entries_->size());
+      for(size_type i = 0ul; i < entries_->size(); ++i) {
+        coordinates(entries_->ordinals[i], range_, index.data());
+        size_type ordinal = 0ul;
+        for(unsigned int d = 0u; d < rank; ++d)
+          ordinal += index[d] * result_stride[d];
+        pairs.emplace_back(ordinal, entries_->norms[i]);
+      }
+      std::sort(pairs.begin(), pairs.end(),
+          [] (const typename pair_list::value_type& left,
+              const typename pair_list::value_type& right)
+          { return left.first < right.first; });
+
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+      result->ordinals.reserve(pairs.size());
+      result->norms.reserve(pairs.size());
+      for(const auto& pair : pairs)
+        result->append(pair.first, pair.second);
+
+      return CompressedShape_(result_range, perm_size_vectors(perm), result);
+    }
+
+    /// Scale shape
+
+    /// Construct a new scaled shape as:
+    /// \f[
+    /// {(\rm{result})}_{ij...} = |(\rm{factor})| (\rm{this})_{ij...}
+    /// \f]
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param factor The scaling factor
+    /// \return A new, scaled shape
+    template <typename Factor>
+    CompressedShape_ scale(const Factor factor) const {
+      TA_ASSERT(! empty());
+      const value_type abs_factor = to_abs_factor(factor);
+
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+      for(size_type i = 0ul; i < entries_->size(); ++i)
+        result->append(entries_->ordinals[i], entries_->norms[i] * abs_factor);
+
+      return CompressedShape_(range_, size_vectors_, result);
+    }
+
+    /// Scale and permute shape
+
+    /// \tparam Factor The scaling factor type
+    /// \param factor The scaling factor
+    /// \param perm The permutation that will be applied to this shape
+    /// \return A new, scaled-and-permuted shape
+    template <typename Factor>
+    CompressedShape_ scale(const Factor factor, const Permutation& perm) const {
+      return scale(factor).perm(perm);
+    }
+
+    /// Add shapes
+
+    /// Construct a new sum of shapes as:
+    /// \f[
+    /// {(\rm{result})}_{ij...} = (\rm{this})_{ij...} + (\rm{other})_{ij...}
+    /// \f]
+    /// \param other The shape to be added to this shape
+    /// \return A sum of shapes
+    CompressedShape_ add(const CompressedShape_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(range_ == other.range_);
+      return CompressedShape_(range_, size_vectors_,
+          merge(*entries_, *other.entries_, false,
+          [] (const size_type, const value_type left, const value_type right)
+          { return left + right; }));
+    }
+
+    /// Add and permute shapes
+
+    /// \param other The shape to be added to this shape
+    /// \param perm The permutation that is applied to the result
+    /// \return the new shape, equals \c this + \c other
+    CompressedShape_ add(const CompressedShape_& other, const Permutation& perm) const {
+      return add(other).perm(perm);
+    }
+
+    /// Add and scale shapes
+
+    /// Construct a new sum of shapes as:
+    /// \f[
+    /// {(\rm{result})}_{ij...} = |(\rm{factor})| ((\rm{this})_{ij...} + (\rm{other})_{ij...})
+    /// \f]
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param other The shape to be added to this shape
+    /// \param factor The scaling factor
+    /// \return A scaled sum of shapes
+    template <typename Factor>
+    CompressedShape_ add(const CompressedShape_& other, const Factor factor) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(range_ == other.range_);
+      const value_type abs_factor = to_abs_factor(factor);
+      return CompressedShape_(range_, size_vectors_,
+          merge(*entries_, *other.entries_, false,
+          [abs_factor] (const size_type, const value_type left, const value_type right)
+          { return (left + right) * abs_factor; }));
+    }
+
+    /// Add, scale, and permute shapes
+
+    /// \tparam Factor The scaling factor type
+    /// \param other The shape to be added to this shape
+    /// \param factor The scaling factor
+    /// \param perm The permutation that is applied to the result
+    /// \return A scaled and permuted sum of shapes
+    template <typename Factor>
+    CompressedShape_ add(const CompressedShape_& other, const Factor factor,
+        const Permutation& perm) const
+    {
+      return add(other, factor).perm(perm);
+    }
+
+    /// Add a constant to the shape
+
+    /// \param value The constant to be added to each element
+    /// \return A new shape, where every tile is non-zero
+    /// \note The result has a norm for every tile, so it is not compressed.
+    CompressedShape_ add(value_type value) const {
+      TA_ASSERT(! empty());
+      value = std::abs(value);
+
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+      const size_type n = range_.volume();
+      size_type e = 0ul;
+      for(size_type i = 0ul; i < n; ++i) {
+        value_type norm = value_type(0);
+        if((e < entries_->size()) && (entries_->ordinals[e] == i))
+          norm = entries_->norms[e++];
+        norm += value / std::sqrt(volume(i, range_, size_vectors_.get()));
+        result->append(i, norm);
+      }
+
+      return CompressedShape_(range_, size_vectors_, result);
+    }
+
+    CompressedShape_ add(const value_type value, const Permutation& perm) const {
+      return add(value).perm(perm);
+    }
+
+    CompressedShape_ subt(const CompressedShape_& other) const {
+      return add(other);
+    }
+
+    CompressedShape_ subt(const CompressedShape_& other, const Permutation& perm) const {
+      return add(other, perm);
+    }
+
+    template <typename Factor>
+    CompressedShape_ subt(const CompressedShape_& other, const Factor factor) const {
+      return add(other, factor);
+    }
+
+    template <typename Factor>
+    CompressedShape_ subt(const CompressedShape_& other, const Factor factor,
+        const Permutation& perm) const
+    {
+      return add(other, factor, perm);
+    }
+
+    CompressedShape_ subt(const value_type value) const {
+      return add(value);
+    }
+
+    CompressedShape_ subt(const value_type value, const Permutation& perm) const {
+      return add(value, perm);
+    }
+
+    CompressedShape_ mult(const CompressedShape_& other) const {
+      return mult(other, value_type(1));
+    }
+
+    CompressedShape_ mult(const CompressedShape_& other, const Permutation& perm) const {
+      return mult(other).perm(perm);
+    }
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    template <typename Factor>
+    CompressedShape_ mult(const CompressedShape_& other, const Factor factor) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(range_ == other.range_);
+      const value_type abs_factor = to_abs_factor(factor);
+      const Range& range = range_;
+      const vector_type* const size_vectors = size_vectors_.get();
+      return CompressedShape_(range_, size_vectors_,
+          merge(*entries_, *other.entries_, true,
+          [abs_factor, &range, size_vectors] (const size_type ordinal,
+              const value_type left, const value_type right)
+          { return left * right * abs_factor * volume(ordinal, range, size_vectors); }));
+    }
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    template <typename Factor>
+    CompressedShape_ mult(const CompressedShape_& other, const Factor factor,
+        const Permutation& perm) const
+    {
+      return mult(other, factor).perm(perm);
+    }
+
+    /// Contract shapes
+
+    /// The contraction is a sparse matrix product of the non-zero tiles, so
+    /// the cost is proportional to the number of non-zero tile products.
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    /// \param other The right-hand shape
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction data; the arguments must not be
+    /// transposed
+    /// \return The shape of the contraction
+    template <typename Factor>
+    CompressedShape_ gemm(const CompressedShape_& other, const Factor factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(gemm_helper.left_op() == madness::cblas::NoTrans);
+      TA_ASSERT(gemm_helper.right_op() == madness::cblas::NoTrans);
+
+      const value_type abs_factor = to_abs_factor(factor);
+      integer M = 0, N = 0, K = 0;
+      gemm_helper.compute_matrix_sizes(M, N, K, range_, other.range_);
+
+      // Allocate memory for the contracted size vectors
+      std::shared_ptr<vector_type> result_size_vectors(new vector_type[gemm_helper.result_rank()],
+          std::default_delete<vector_type[]>());
+
+      // Initialize the result size vectors
+      unsigned int x = 0ul;
+      for(unsigned int i = gemm_helper.left_outer_begin(); i < gemm_helper.left_outer_end(); ++i, ++x)
+        result_size_vectors.get()[x] = size_vectors_.get()[i];
+      for(unsigned int i = gemm_helper.right_outer_begin(); i < gemm_helper.right_outer_end(); ++i, ++x)
+        result_size_vectors.get()[x] = other.size_vectors_.get()[i];
+
+      // Compute the scaling factor of each inner tile index
+      const unsigned int k_rank = gemm_helper.left_inner_end() - gemm_helper.left_inner_begin();
+      std::vector<value_type> k_factors =
+          outer_sizes(size_vectors_.get() + gemm_helper.left_inner_begin(), k_rank);
+      TA_ASSERT(k_factors.size() == size_type(K));
+      for(value_type& k_factor : k_factors)
+        k_factor *= k_factor * abs_factor;
+
+      // Find the first entry of each row of the right-hand norms
+      const Entries& left = *entries_;
+      const Entries& right = *other.entries_;
+      std::vector<size_type> right_row(K + 1, 0ul);
+      for(size_type i = 0ul; i < right.size(); ++i)
+        ++right_row[right.ordinals[i] / N + 1];
+      std::partial_sum(right_row.begin(), right_row.end(), right_row.begin());
+
+      // Compute each row of the result with a sparse accumulator
+      std::shared_ptr<Entries> result = std::make_shared<Entries>();
+      std::vector<value_type> row(N, value_type(0));
+      std::vector<bool> row_mask(N, false);
+      std::vector<size_type> row_index;
+      for(size_type l = 0ul; l < left.size();) {
+        const size_type m = left.ordinals[l] / K;
+        const size_type row_end = (m + 1ul) * K;
+        for(; (l < left.size()) && (left.ordinals[l] < row_end); ++l) {
+          const size_type k = left.ordinals[l] - m * K;
+          const value_type left_norm = left.norms[l] * k_factors[k];
+          for(size_type r = right_row[k]; r < right_row[k + 1]; ++r) {
+            const size_type n = right.ordinals[r] - k * N;
+            if(! row_mask[n]) {
+              row_mask[n] = true;
+              row_index.push_back(n);
+            }
+            row[n] += left_norm * right.norms[r];
+          }
+        }
+
+        std::sort(row_index.begin(), row_index.end());
+        for(const size_type n : row_index) {
+          result->append(m * N + n, row[n]);
+          row[n] = value_type(0);
+          row_mask[n] = false;
+        }
+        row_index.clear();
+      }
+
+      return CompressedShape_(
+          gemm_helper.make_result_range<Range>(range_, other.range_),
+          result_size_vectors, result);
+    }
+
+    /// \tparam Factor The scaling factor type
+    /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
+    template <typename Factor>
+    CompressedShape_ gemm(const CompressedShape_& other, const Factor factor,
+        const math::GemmHelper& gemm_helper, const Permutation& perm) const
+    {
+      return gemm(other, factor, gemm_helper).perm(perm);
+    }
+
+  private:
+    template <typename Factor>
+    static value_type to_abs_factor(const Factor factor) {
+      using std::abs;
+      return static_cast<value_type>(abs(factor));
+    }
+
+  }; // class CompressedShape
+
+  /// Add the shape to an output stream
+
+  /// \tparam T the numeric type supporting the type of \c shape
+  /// \param os The output stream
+  /// \param shape the CompressedShape<T> object
+  /// \return A reference to the output stream
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const CompressedShape<T>& shape) {
+    os << "CompressedShape<" << typeid(T).name() << ">:" << std::endl
+       << shape.data() << std::endl;
+    return os;
+  }
+
+
+#ifndef TILEDARRAY_HEADER_ONLY
+
+  extern template class CompressedShape<float>;
+
+#endif // TILEDARRAY_HEADER_ONLY
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_COMPRESSED_SHAPE_H__INCLUDED
@@ -0,0 +1,512 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  block_cyclic.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_BLOCK_CYCLIC_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_BLOCK_CYCLIC_H__INCLUDED
+
+#include <TiledArray/conversions/eigen.h>
+#include <TiledArray/pmap/cyclic_pmap.h>
+
+namespace TiledArray {
+
+  /// 2D block-cyclic matrix layout
+
+  /// This describes the distribution of an \c m x \c n matrix as used by
+  /// ScaLAPACK and ELPA: the matrix is divided into \c mb x \c nb blocks,
+  /// which are dealt cyclically to an \c nprow x \c npcol process grid,
+  /// starting at process row \c rsrc and process column \c csrc . Process
+  /// \c (prow,pcol) is rank <tt>prow * npcol + pcol</tt> (a row-major BLACS
+  /// grid). Each process stores its blocks in one column-major local matrix
+  /// with leading dimension \c lld , i.e. global element \c (i,j) is stored
+  /// at <tt>local[local_row(i) + local_col(j) * lld]</tt> on process
+  /// <tt>owner(i,j)</tt> .
+  struct BlockCyclicDescriptor {
+    typedef std::size_t size_type; ///< Size type
+
+    size_type m; ///< Number of matrix rows
+    size_type n; ///< Number of matrix columns
+    size_type mb; ///< Number of rows in a block
+    size_type nb; ///< Number of columns in a block
+    size_type nprow; ///< Number of process rows
+    size_type npcol; ///< Number of process columns
+    size_type rsrc; ///< Process row of the first block row
+    size_type csrc; ///< Process column of the first block column
+
+    /// Constructor
+
+    /// \param m_ Number of matrix rows
+    /// \param n_ Number of matrix columns
+    /// \param mb_ Number of rows in a block
+    /// \param nb_ Number of columns in a block
+    /// \param nprow_ Number of process rows
+    /// \param npcol_ Number of process columns
+    /// \param rsrc_ Process row of the first block row [default = 0]
+    /// \param csrc_ Process column of the first block column [default = 0]
+    BlockCyclicDescriptor(const size_type m_, const size_type n_,
+        const size_type mb_, const size_type nb_, const size_type nprow_,
+        const size_type npcol_, const size_type rsrc_ = 0ul,
+        const size_type csrc_ = 0ul) :
+      m(m_), n(n_), mb(mb_), nb(nb_), nprow(nprow_), npcol(npcol_),
+      rsrc(rsrc_), csrc(csrc_)
+    {
+      TA_USER_ASSERT((mb > 0ul) && (nb > 0ul),
+          "BlockCyclicDescriptor: The block size must be greater than zero.");
+      TA_USER_ASSERT((nprow > 0ul) && (npcol > 0ul),
+          "BlockCyclicDescriptor: The process grid must not be empty.");
+      TA_USER_ASSERT((rsrc < nprow) && (csrc < npcol),
+          "BlockCyclicDescriptor: The source process is outside of the process grid.");
+    }
+
+    /// Process row that owns a matrix row
+
+    /// \param i The global row index
+    /// \return The process row that owns row \c i
+    size_type row_owner(const size_type i) const { return (i / mb + rsrc) % nprow; }
+
+    /// Process column that owns a matrix column
+
+    /// \param j The global column index
+    /// \return The process column that owns column \c j
+    size_type col_owner(const size_type j) const { return (j / nb + csrc) % npcol; }
+
+    /// Process that owns a matrix element
+
+    /// \param i The global row index
+    /// \param j The global column index
+    /// \return The rank of the process that owns element \c (i,j)
+    size_type owner(const size_type i, const size_type j) const {
+      return row_owner(i) * npcol + col_owner(j);
+    }
+
+    /// Local row index of a matrix row
+
+    /// \param i The global row index
+    /// \return The row of the local matrix of <tt>row_owner(i)</tt> that
+    /// holds row \c i
+    size_type local_row(const size_type i) const { return (i / (mb * nprow)) * mb + i % mb; }
+
+    /// Local column index of a matrix column
+
+    /// \param j The global column index
+    /// \return The column of the local matrix of <tt>col_owner(j)</tt> that
+    /// holds column \c j
+    size_type local_col(const size_type j) const { return (j / (nb * npcol)) * nb + j % nb; }
+
+    /// Number of local rows of a process row (ScaLAPACK \c NUMROC )
+
+    /// \param prow The process row
+    /// \return The number of matrix rows stored by process row \c prow
+    size_type local_rows(const size_type prow) const { return numroc(m, mb, prow, rsrc, nprow); }
+
+    /// Number of local columns of a process column (ScaLAPACK \c NUMROC )
+
+    /// \param pcol The process column
+    /// \return The number of matrix columns stored by process column \c pcol
+    size_type local_cols(const size_type pcol) const { return numroc(n, nb, pcol, csrc, npcol); }
+
+    /// Tiled range that matches the block layout
+
+    /// \return A tiled range with one \c mb x \c nb tile per block
+    TiledRange make_trange() const {
+      return TiledRange({ make_tr1(m, mb), make_tr1(n, nb) });
+    }
+
+    /// Process map that matches the block layout
+
+    /// Arrays with the tiled range of \c make_trange() and this process map
+    /// have the same distribution as the block-cyclic matrix, so conversions
+    /// between them do not communicate.
+    /// \param world The world of the process grid
+    /// \return A cyclic process map of the tiles onto the process grid
+    /// \throw TiledArray::Exception When the source process is not
+    /// <tt>(0,0)</tt> , which cannot be expressed by \c CyclicPmap .
+    std::shared_ptr<Pmap> make_pmap(World& world) const {
+      TA_USER_ASSERT((rsrc == 0ul) && (csrc == 0ul),
+          "BlockCyclicDescriptor::make_pmap(): The source process must be (0,0).");
+      return std::make_shared<detail::CyclicPmap>(world, (m + mb - 1ul) / mb,
+          (n + nb - 1ul) / nb, nprow, npcol);
+    }
+
+    /// Check that an array has the block-cyclic layout
+
+    /// \tparam Tile The array tile type
+    /// \tparam Policy The array policy type
+    /// \param array The array to be checked
+    /// \return \c true when each tile of \c array is one block of this layout
+    /// and is owned by the process that holds the block
+    template <typename Tile, typename Policy>
+    bool matches(const DistArray<Tile, Policy>& array) const {
+      if((rsrc != 0ul) || (csrc != 0ul))
+        return false;
+      if(array.trange() != make_trange())
+        return false;
+      const detail::CyclicPmap* const pmap =
+          dynamic_cast<const detail::CyclicPmap*>(array.pmap().get());
+      return pmap && (pmap->nrows_proc() == nprow) && (pmap->ncols_proc() == npcol);
+    }
+
+  private:
+
+    static size_type numroc(const size_type count, const size_type block,
+        const size_type iproc, const size_type isrc, const size_type nprocs)
+    {
+      const size_type dist = (nprocs + iproc - isrc) % nprocs;
+      const size_type nblocks = count / block;
+      size_type result = (nblocks / nprocs) * block;
+      const size_type extra = nblocks % nprocs;
+      if(dist < extra)
+        result += block;
+      else if(dist == extra)
+        result += count % block;
+      return result;
+    }
+
+    static TiledRange1 make_tr1(const size_type count, const size_type block) {
+      std::vector<size_type> blocking;
+      for(size_type i = 0ul; i < count; i += block)
+        blocking.push_back(i);
+      blocking.push_back(count);
+      return TiledRange1(blocking.begin(), blocking.end());
+    }
+
+  }; // struct BlockCyclicDescriptor
+
+  namespace detail {
+
+    /// Write tile parts into the local matrix of a block-cyclic layout
+
+    /// \tparam T The matrix element type
+    template <typename T>
+    class BlockCyclicWriter : public madness::WorldObject<BlockCyclicWriter<T> > {
+    public:
+      typedef BlockCyclicWriter<T> BlockCyclicWriter_; ///< This object type
+      typedef madness::WorldObject<BlockCyclicWriter_> WorldObject_; ///< Base object type
+      typedef Tensor<T> part_type; ///< Tile part type
+
+    private:
+      const BlockCyclicDescriptor desc_; ///< The matrix layout
+      T* const local_; ///< The local matrix
+      const std::size_t lld_; ///< Leading dimension of the local matrix
+
+      /// Copy a tile part into the local matrix
+
+      /// \param part A tensor with a range that is inside one local block
+      void insert(const part_type& part) {
+        const auto* MADNESS_RESTRICT const lower = part.range().lobound_data();
+        const auto* MADNESS_RESTRICT const extent = part.range().extent_data();
+        T* MADNESS_RESTRICT const dest = local_ + desc_.local_row(lower[0]) +
+            desc_.local_col(lower[1]) * lld_;
+        for(std::size_t i = 0ul; i < extent[0]; ++i)
+          for(std::size_t j = 0ul; j < extent[1]; ++j)
+            dest[i + j * lld_] = part[i * extent[1] + j];
+      }
+
+    public:
+
+      /// Constructor
+
+      /// This is a collective operation.
+      /// \param world The world of the process grid
+      /// \param desc The matrix layout
+      /// \param local The local matrix of this process
+      /// \param lld The leading dimension of \c local
+      BlockCyclicWriter(World& world, const BlockCyclicDescriptor& desc, T* local,
+          const std::size_t lld) :
+        WorldObject_(world), desc_(desc), local_(local), lld_(lld)
+      { WorldObject_::process_pending(); }
+
+      /// Send the parts of a tile to the processes that hold them
+
+      /// \tparam Tile The tile type
+      /// \param tile The tile
+      template <typename Tile>
+      void scatter(const Tile& tile) {
+        const auto* MADNESS_RESTRICT const lower = tile.range().lobound_data();
+        const auto* MADNESS_RESTRICT const upper = tile.range().upbound_data();
+        const auto tile_map = eigen_map(tile, upper[0] - lower[0], upper[1] - lower[1]);
+
+        // Split the tile at block boundaries
+        for(std::size_t r0 = lower[0]; r0 < upper[0]; ) {
+          const std::size_t r1 = std::min<std::size_t>(upper[0], (r0 / desc_.mb + 1ul) * desc_.mb);
+          for(std::size_t c0 = lower[1]; c0 < upper[1]; ) {
+            const std::size_t c1 = std::min<std::size_t>(upper[1], (c0 / desc_.nb + 1ul) * desc_.nb);
+
+            part_type part(Range(std::array<std::size_t, 2>{{r0, c0}},
+                std::array<std::size_t, 2>{{r1, c1}}));
+            eigen_map(part, r1 - r0, c1 - c0) =
+                tile_map.block(r0 - lower[0], c0 - lower[1], r1 - r0, c1 - c0);
+
+            const ProcessID dest = desc_.owner(r0, c0);
+            if(dest == WorldObject_::get_world().rank())
+              insert(part);
+            else
+              WorldObject_::send(dest, & BlockCyclicWriter_::insert, part);
+
+            c0 = c1;
+          }
+          r0 = r1;
+        }
+      }
+
+    }; // class BlockCyclicWriter
+
+    /// Task function that scatters a tile into a block-cyclic matrix
+
+    /// \tparam T The matrix element type
+    /// \tparam Tile The tile type
+    /// \param writer The block-cyclic writer
+    /// \param tile The tile
+    template <typename T, typename Tile>
+    void block_cyclic_scatter(BlockCyclicWriter<T>* writer, const Tile& tile) {
+      writer->scatter(tile);
+    }
+
+    /// Task function that copies a tile into its block of a block-cyclic matrix
+
+    /// \tparam T The matrix element type
+    /// \tparam Tile The tile type
+    /// \param desc The matrix layout
+    /// \param local The local matrix that holds the block of \c tile
+    /// \param lld The leading dimension of \c local
+    /// \param tile The tile, which must be exactly one block
+    /// \param counter The task counter
+    template <typename T, typename Tile>
+    void counted_tile_to_block_cyclic(const BlockCyclicDescriptor* desc,
+        T* local, const std::size_t lld, const Tile& tile,
+        madness::AtomicInt* counter)
+    {
+      const auto* MADNESS_RESTRICT const lower = tile.range().lobound_data();
+      const auto* MADNESS_RESTRICT const extent = tile.range().extent_data();
+      T* MADNESS_RESTRICT const dest = local + desc->local_row(lower[0]) +
+          desc->local_col(lower[1]) * lld;
+      for(std::size_t i = 0ul; i < extent[0]; ++i)
+        for(std::size_t j = 0ul; j < extent[1]; ++j)
+          dest[i + j * lld] = tile[i * extent[1] + j];
+      (*counter)++;
+    }
+
+  } // namespace detail
+
+  /// Copy an array into a block-cyclic distributed matrix
+
+  /// When \c array has the layout of \c desc (see
+  /// \c BlockCyclicDescriptor::matches ) each process copies its tiles into
+  /// its local matrix without communication. Otherwise the tiles are split
+  /// at block boundaries and each part is sent directly to the process that
+  /// holds it. Zero tiles are written as zeros. This is a collective
+  /// operation.
+  /// \tparam Tile The array tile type
+  /// \tparam Policy The array policy type
+  /// \param array The matrix array
+  /// \param desc The layout of the block-cyclic matrix
+  /// \param local The local matrix of this process, which must hold
+  /// <tt>desc.local_rows(prow) x desc.local_cols(pcol)</tt> elements; it is
+  /// ignored on processes outside the process grid
+  /// \param lld The leading dimension of \c local
+  /// \throw TiledArray::Exception When \c array is not a matrix with the
+  /// dimensions of \c desc .
+  /// \throw TiledArray::Exception When the process grid is larger than the
+  /// world of \c array .
+  template <typename Tile, typename Policy>
+  void array_to_block_cyclic(const DistArray<Tile, Policy>& array,
+      const BlockCyclicDescriptor& desc, typename Tile::value_type* local,
+      const std::size_t lld)
+  {
+    typedef typename Tile::value_type value_type;
+    World& world = array.world();
+    const auto& trange = array.trange();
+    TA_USER_ASSERT(trange.tiles_range().rank() == 2u,
+        "TiledArray::array_to_block_cyclic(): The array must be a matrix.");
+    TA_USER_ASSERT((trange.elements_range().extent(0) == desc.m) &&
+        (trange.elements_range().extent(1) == desc.n),
+        "TiledArray::array_to_block_cyclic(): The array dimensions do not match the descriptor.");
+    TA_USER_ASSERT(desc.nprow * desc.npcol <= std::size_t(world.size()),
+        "TiledArray::array_to_block_cyclic(): The process grid is larger than the world.");
+
+    // Zero the local matrix, which covers zero tiles
+    const std::size_t rank = world.rank();
+    const bool in_grid = rank < desc.nprow * desc.npcol;
+    if(in_grid) {
+      const std::size_t local_rows = desc.local_rows(rank / desc.npcol);
+      const std::size_t local_cols = desc.local_cols(rank % desc.npcol);
+      TA_USER_ASSERT((local_rows == 0ul) || (lld >= local_rows),
+          "TiledArray::array_to_block_cyclic(): The leading dimension is smaller than the number of local rows.");
+      for(std::size_t j = 0ul; j < local_cols; ++j)
+        std::fill_n(local + j * lld, local_rows, value_type(0));
+    }
+
+    if(desc.matches(array)) {
+      // Each local tile is one local block
+      madness::AtomicInt counter;
+      counter = 0;
+      std::size_t n = 0ul;
+      for(const auto i : *array.pmap()) {
+        if(array.is_zero(i))
+          continue;
+        world.taskq.add(& detail::counted_tile_to_block_cyclic<value_type, Tile>,
+            &desc, local, lld, array.find(i), &counter);
+        ++n;
+      }
+      world.await([&counter,n] () { return counter == n; });
+      world.gop.fence();
+      return;
+    }
+
+    // Redistribute the tiles to the block-cyclic layout
+    detail::BlockCyclicWriter<value_type> writer(world, desc, local, lld);
+    for(const auto i : *array.pmap()) {
+      if(array.is_zero(i))
+        continue;
+      world.taskq.add(& detail::block_cyclic_scatter<value_type, Tile>,
+          &writer, array.find(i));
+    }
+
+    // Wait for all parts to arrive
+    world.gop.fence();
+  }
+
+  /// Copy a block-cyclic distributed matrix into an array
+
+  /// The result has the tiled range \c trange and process map \c pmap . With
+  /// the defaults, i.e. <tt>desc.make_trange()</tt> and
+  /// <tt>desc.make_pmap(world)</tt> , each process constructs its tiles from
+  /// its local matrix without communication. Otherwise each process sends
+  /// the parts of its blocks that overlap each tile directly to the owner of
+  /// the tile. This is a collective operation.
+  /// \tparam A The array type
+  /// \param world The world where the array will live
+  /// \param desc The layout of the block-cyclic matrix
+  /// \param local The local matrix of this process; it is ignored on
+  /// processes outside the process grid
+  /// \param lld The leading dimension of \c local
+  /// \param trange The tiled range of the result [default = desc.make_trange()]
+  /// \param pmap The process map of the result [default = desc.make_pmap(world)
+  /// when \c trange is the default, otherwise the default process map]
+  /// \return An array that holds the matrix
+  /// \throw TiledArray::Exception When \c trange is not a matrix with the
+  /// dimensions of \c desc .
+  template <typename A>
+  A block_cyclic_to_array(World& world, const BlockCyclicDescriptor& desc,
+      const typename A::value_type::value_type* local, const std::size_t lld,
+      const TiledRange& trange = TiledRange(),
+      std::shared_ptr<typename A::pmap_interface> pmap = nullptr)
+  {
+    typedef typename A::value_type value_type;
+    typedef typename value_type::value_type numeric_type;
+    typedef Eigen::Matrix<numeric_type, Eigen::Dynamic, Eigen::Dynamic,
+        Eigen::ColMajor> matrix_type;
+    typedef Eigen::Map<const matrix_type, Eigen::Unaligned, Eigen::OuterStride<> > map_type;
+
+    TA_USER_ASSERT(desc.nprow * desc.npcol <= std::size_t(world.size()),
+        "TiledArray::block_cyclic_to_array(): The process grid is larger than the world.");
+    const bool default_trange = (trange.tiles_range().rank() == 0u);
+    const TiledRange result_trange = (default_trange ? desc.make_trange() : trange);
+    TA_USER_ASSERT((result_trange.tiles_range().rank() == 2u) &&
+        (result_trange.elements_range().extent(0) == desc.m) &&
+        (result_trange.elements_range().extent(1) == desc.n),
+        "TiledArray::block_cyclic_to_array(): The tiled range does not match the descriptor.");
+    if(! pmap && default_trange && (desc.rsrc == 0ul) && (desc.csrc == 0ul))
+      pmap = desc.make_pmap(world);
+
+    A array(world, result_trange, pmap);
+
+    const std::size_t rank = world.rank();
+    const bool in_grid = rank < desc.nprow * desc.npcol;
+    const std::size_t prow = (in_grid ? rank / desc.npcol : 0ul);
+    const std::size_t pcol = (in_grid ? rank % desc.npcol : 0ul);
+    const std::size_t local_rows = (in_grid ? desc.local_rows(prow) : 0ul);
+    const std::size_t local_cols = (in_grid ? desc.local_cols(pcol) : 0ul);
+
+    if(desc.matches(array)) {
+      // Each local tile is one local block
+      for(const auto i : *array.pmap()) {
+        if(array.is_zero(i))
+          continue;
+        value_type tile(array.trange().make_tile_range(i));
+        const auto* MADNESS_RESTRICT const lower = tile.range().lobound_data();
+        const auto* MADNESS_RESTRICT const extent = tile.range().extent_data();
+        eigen_map(tile, extent[0], extent[1]) = map_type(local + desc.local_row(lower[0])
+            + desc.local_col(lower[1]) * lld, extent[0], extent[1],
+            Eigen::OuterStride<>(lld));
+        array.set(i, tile);
+      }
+      return array;
+    }
+
+    // Send each local block to the owners of the tiles it overlaps
+    detail::EigenBlockAssembler<A> assembler(array);
+    const auto& tr0 = result_trange.data()[0];
+    const auto& tr1 = result_trange.data()[1];
+    for(std::size_t lb0 = 0ul; lb0 < local_rows; lb0 += desc.mb) {
+      // Global rows of this local block row
+      const std::size_t g0 = ((lb0 / desc.mb) * desc.nprow +
+          (desc.nprow + prow - desc.rsrc) % desc.nprow) * desc.mb;
+      const std::size_t g0_last = std::min(g0 + desc.mb, desc.m);
+      const auto row_tiles = detail::overlapping_tiles(tr0, g0, g0_last);
+
+      for(std::size_t lb1 = 0ul; lb1 < local_cols; lb1 += desc.nb) {
+        const std::size_t g1 = ((lb1 / desc.nb) * desc.npcol +
+            (desc.npcol + pcol - desc.csrc) % desc.npcol) * desc.nb;
+        const std::size_t g1_last = std::min(g1 + desc.nb, desc.n);
+        const auto col_tiles = detail::overlapping_tiles(tr1, g1, g1_last);
+
+        const map_type block(local + lb0 + lb1 * lld, g0_last - g0,
+            g1_last - g1, Eigen::OuterStride<>(lld));
+
+        for(std::size_t t0 = row_tiles.first; t0 < row_tiles.second; ++t0) {
+          const std::size_t r0 = std::max<std::size_t>(tr0.tile(t0).first, g0);
+          const std::size_t r1 = std::min<std::size_t>(tr0.tile(t0).second, g0_last);
+          for(std::size_t t1 = col_tiles.first; t1 < col_tiles.second; ++t1) {
+            const std::size_t i = result_trange.tiles_range().ordinal(
+                std::array<std::size_t, 2>{{t0, t1}});
+            if(array.is_zero(i))
+              continue;
+            const std::size_t c0 = std::max<std::size_t>(tr1.tile(t1).first, g1);
+            const std::size_t c1 = std::min<std::size_t>(tr1.tile(t1).second, g1_last);
+
+            value_type part(Range(std::array<std::size_t, 2>{{r0, c0}},
+                std::array<std::size_t, 2>{{r1, c1}}));
+            eigen_map(part, r1 - r0, c1 - c0) =
+                block.block(r0 - g0, c0 - g1, r1 - r0, c1 - c0);
+            assembler.put(i, part);
+          }
+        }
+      }
+    }
+
+    // Wait for all parts to arrive
+    world.gop.fence();
+
+    std::size_t incomplete = assembler.incomplete();
+    world.gop.sum(incomplete);
+    TA_USER_ASSERT(incomplete == 0ul,
+        "TiledArray::block_cyclic_to_array(): The local matrices do not cover the matrix.");
+
+    return array;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_BLOCK_CYCLIC_H__INCLUDED
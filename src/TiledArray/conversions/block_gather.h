@@ -0,0 +1,227 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  block_gather.h
+ *  Oct 15, 2016
+ *
+ */
+
+
+#ifndef TILEDARRAY_CONVERSIONS_BLOCK_GATHER_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_BLOCK_GATHER_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// The tiles that overlap an element block
+
+    /// \param trange The tiled range of the array
+    /// \param lower_bound The lower bound of the element block
+    /// \param upper_bound The upper bound of the element block
+    /// \return The range of the tiles that overlap the block
+    template <typename Index>
+    inline Range block_tiles(const TiledRange& trange, const Index& lower_bound,
+        const Index& upper_bound)
+    {
+      const unsigned int rank = trange.tiles_range().rank();
+      std::vector<std::size_t> lower(rank), upper(rank);
+      for(unsigned int d = 0u; d < rank; ++d) {
+        const TiledRange1& trange1 = trange.data()[d];
+        TA_USER_ASSERT((lower_bound[d] < upper_bound[d]) &&
+            (lower_bound[d] >= trange1.elements_range().first) &&
+            (upper_bound[d] <= trange1.elements_range().second),
+            "The block is empty or not in the range of the array.");
+        lower[d] = trange1.element_to_tile(lower_bound[d]);
+        upper[d] = trange1.element_to_tile(upper_bound[d] - 1ul) + 1ul;
+      }
+      return Range(lower, upper);
+    }
+
+    /// The intersection of a tile and an element block
+
+    /// \param tile The range of the tile
+    /// \param block The range of the block
+    /// \param[out] lower The lower bound of the intersection
+    /// \param[out] upper The upper bound of the intersection
+    inline void block_intersection(const Range& tile, const Range& block,
+        std::vector<std::size_t>& lower, std::vector<std::size_t>& upper)
+    {
+      const unsigned int rank = tile.rank();
+      lower.resize(rank);
+      upper.resize(rank);
+      for(unsigned int d = 0u; d < rank; ++d) {
+        lower[d] = std::max(tile.lobound(d), block.lobound(d));
+        upper[d] = std::min(tile.upbound(d), block.upbound(d));
+      }
+    }
+
+    /// Task function that copies the part of a tile in a block
+
+    /// \tparam T The element type
+    /// \tparam Tile The tile type
+    /// \param result The block, which is written in place
+    /// \param tile The tile
+    /// \return \c true
+    template <typename T, typename Tile>
+    bool gather_tile(Tensor<T> result, const Tile& tile) {
+      std::vector<std::size_t> lower, upper;
+      block_intersection(tile.range(), result.range(), lower, upper);
+      result.block(lower, upper) = tile.block(lower, upper);
+      return true;
+    }
+
+  } // namespace detail
+
+  /// Copy a block of a distributed array into a local tensor
+
+  /// The tiles that overlap the block are requested at once, so the
+  /// requests for remote tiles are aggregated into one message per owner
+  /// (see \c DistributedStorage::get ), and the part of each tile that is
+  /// in the block is copied into the result by a task as soon as the tile
+  /// arrives.
+  /// The elements of zero tiles are zero. Unlike \c array_to_eigen() , this
+  /// is not a collective operation; each process may gather a different
+  /// block.
+  /// \code
+  /// Tensor<double> a_local = gather_block(a, {0, 0}, {n, n});
+  /// // ... pass a_local.data() to a dense solver
+  /// scatter_block(a, a_local);
+  /// \endcode
+  /// \tparam Tile The tile type, which must be a \c Tensor
+  /// \tparam Policy The array policy type
+  /// \tparam Index An array of element indices
+  /// \param array The array
+  /// \param lower_bound The lower bound of the element block
+  /// \param upper_bound The upper bound of the element block
+  /// \return A tensor with the range <tt>[lower_bound, upper_bound)</tt>
+  /// that holds the elements of the block, in row-major order
+  /// \throw TiledArray::Exception When the block is empty or not in the
+  /// range of \c array .
+  template <typename Tile, typename Policy, typename Index>
+  inline Tensor<typename Tile::value_type>
+  gather_block(const DistArray<Tile, Policy>& array, const Index& lower_bound,
+      const Index& upper_bound)
+  {
+    typedef typename Tile::value_type value_type;
+    typedef typename DistArray<Tile, Policy>::size_type size_type;
+
+    const TiledRange& trange = array.trange();
+    const Range tiles = detail::block_tiles(trange, lower_bound, upper_bound);
+    Tensor<value_type> result(Range(lower_bound, upper_bound));
+
+    // Request the non-zero tiles, and zero the parts of the zero tiles
+    std::vector<size_type> ords;
+    std::vector<std::size_t> lower, upper;
+    for(const auto& index : tiles) {
+      const size_type ord = trange.tiles_range().ordinal(index);
+      if(! array.is_zero(ord)) {
+        ords.push_back(ord);
+      } else {
+        detail::block_intersection(trange.make_tile_range(ord), result.range(),
+            lower, upper);
+        result.block(lower, upper) = Tensor<value_type>(Range(lower, upper),
+            value_type(0));
+      }
+    }
+    const std::vector<Future<Tile> > tile_futures = array.pimpl()->get(ords);
+
+    // Copy each tile as it arrives
+    World& world = array.world();
+    std::vector<Future<bool> > done;
+    done.reserve(tile_futures.size());
+    for(const auto& tile : tile_futures)
+      done.push_back(world.taskq.add(& detail::gather_tile<value_type, Tile>,
+          result, tile));
+    for(const auto& copy : done)
+      copy.get();
+
+    return result;
+  }
+
+  /// Copy a block of a distributed array into a local tensor
+
+  /// \tparam Tile The tile type, which must be a \c Tensor
+  /// \tparam Policy The array policy type
+  /// \param array The array
+  /// \param lower_bound The lower bound of the element block
+  /// \param upper_bound The upper bound of the element block
+  /// \return A tensor with the range <tt>[lower_bound, upper_bound)</tt>
+  template <typename Tile, typename Policy>
+  inline Tensor<typename Tile::value_type>
+  gather_block(const DistArray<Tile, Policy>& array,
+      const std::initializer_list<std::size_t>& lower_bound,
+      const std::initializer_list<std::size_t>& upper_bound)
+  {
+    return gather_block(array, std::vector<std::size_t>(lower_bound),
+        std::vector<std::size_t>(upper_bound));
+  }
+
+  /// Copy a local tensor into a block of a distributed array
+
+  /// This is the inverse of \c gather_block() : the elements of \c block are
+  /// copied into the block of \c array with the range of \c block , in
+  /// place. The parts of the non-zero tiles that are in the block are sent
+  /// to the tile owners, aggregated into a few messages per owner (see
+  /// \c DistributedStorage::write ), and copied into the tiles by tasks on
+  /// the owners. The parts of zero tiles are ignored, since zero tiles
+  /// cannot be written; they should be zero. This is not a collective
+  /// operation, and it does not wait for the copies, so a fence is needed
+  /// before the array is read.
+  /// \tparam Tile The tile type, which must be a \c Tensor
+  /// \tparam Policy The array policy type
+  /// \param array The array
+  /// \param block The block, whose range is a sub-block of the element range
+  /// of \c array
+  /// \throw TiledArray::Exception When the block is empty or not in the
+  /// range of \c array .
+  /// \note The block must not overlap the blocks of concurrent scatters, and
+  /// copies of the tiles that are held by other processes, e.g. in the remote
+  /// tile cache, are not updated.
+  template <typename Tile, typename Policy>
+  inline void scatter_block(DistArray<Tile, Policy>& array,
+      const Tensor<typename Tile::value_type>& block)
+  {
+    typedef typename DistArray<Tile, Policy>::size_type size_type;
+
+    const TiledRange& trange = array.trange();
+    const Range tiles = detail::block_tiles(trange, block.range().lobound(),
+        block.range().upbound());
+
+    std::vector<size_type> ords;
+    std::vector<Tile> parts;
+    std::vector<std::size_t> lower, upper;
+    for(const auto& index : tiles) {
+      const size_type ord = trange.tiles_range().ordinal(index);
+      if(array.is_zero(ord))
+        continue;
+      detail::block_intersection(trange.make_tile_range(ord), block.range(),
+          lower, upper);
+      ords.push_back(ord);
+      parts.emplace_back(block.block(lower, upper));
+    }
+
+    array.pimpl()->write(ords, parts);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_BLOCK_GATHER_H__INCLUDED
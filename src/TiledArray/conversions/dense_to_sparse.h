@@ -6,45 +6,97 @@
 
 namespace TiledArray {
 
-  /// Function to convert a dense array into a block sparse array
+  namespace detail {
 
-  /// If the input array is dense then create a copy by checking the norms of the
-  /// tiles in the dense array and then cloning the significant tiles into the
-  /// sparse array.
-  template <typename Tile>
-  DistArray<Tile, SparsePolicy>
-  to_sparse(DistArray<Tile, DensePolicy> const &dense_array) {
+    /// Convert a dense array into a block sparse array
+
+    /// The norms of the local tiles are computed by tasks as the tiles become
+    /// ready, and the sparse shape is built from them with a single reduction.
+    /// The non-zero tiles of the result are set to the futures given by
+    /// \c make_tile , so no tile is waited on by the calling thread.
+    /// \tparam Tile The tile type
+    /// \tparam Op The tile conversion operation type
+    /// \param dense_array The dense array
+    /// \param make_tile The operation that makes a result tile future from a
+    /// source tile future
+    /// \return A sparse array with the same process map as \c dense_array
+    template <typename Tile, typename Op>
+    DistArray<Tile, SparsePolicy>
+    dense_to_sparse(const DistArray<Tile, DensePolicy>& dense_array, const Op& make_tile) {
       typedef DistArray<Tile, SparsePolicy> ArrayType;  // return type
+      World& world = dense_array.world();
 
       // Constructing a tensor to hold the norm of each tile in the Dense Array
       TiledArray::Tensor<float> tile_norms(dense_array.trange().tiles_range(), 0.0);
 
-      const auto end = dense_array.end();
-      const auto begin = dense_array.begin();
-      for (auto it = begin; it != end; ++it) {
-          // write the norm of each local tile to the tensor
-          tile_norms[it.ordinal()] = it->get().norm();
+      // Spawn a task to compute the norm of each local tile. Each task writes
+      // a different element of tile_norms.
+      std::vector<Future<Tile> > tiles;
+      std::vector<Future<bool> > norms;
+      tiles.reserve(dense_array.pmap()->local_size());
+      norms.reserve(dense_array.pmap()->local_size());
+      float* const norms_data = tile_norms.data();
+      for(auto index : * dense_array.pmap()) {
+        tiles.push_back(dense_array.find(index));
+        norms.push_back(world.taskq.add([norms_data, index] (const Tile& tile) {
+              norms_data[index] = tile.norm();
+              return true;
+            }, tiles.back()));
       }
+      for(auto& norm : norms)
+        norm.get();
 
       // Construct a sparse shape the constructor will handle communicating the
       // norms of the local tiles to the other nodes
-      TiledArray::SparseShape<float> shape(dense_array.world(), tile_norms,
+      TiledArray::SparseShape<float> shape(world, tile_norms,
                                            dense_array.trange());
 
-      ArrayType sparse_array(dense_array.world(), dense_array.trange(),
-                             shape);
-
-      // Loop over the local dense tiles and if that tile is in the
-      // sparse_array set the sparse array tile with a clone so as not to hold
-      // a pointer to the original tile.
-      for (auto it = begin; it != end; ++it) {
-          const auto ord = it.ordinal();
-          if (!sparse_array.is_zero(ord)) {
-              sparse_array.set(ord, it->get().clone());
-          }
+      ArrayType sparse_array(world, dense_array.trange(), shape,
+                             dense_array.pmap());
+
+      // Set the local tiles that are in sparse_array
+      auto tile_it = tiles.begin();
+      for(auto index : * dense_array.pmap()) {
+        if(! sparse_array.is_zero(index))
+          sparse_array.set(index, make_tile(*tile_it));
+        ++tile_it;
       }
 
       return sparse_array;
+    }
+
+  } // namespace detail
+
+  /// Function to convert a dense array into a block sparse array
+
+  /// If the input array is dense then create a copy by checking the norms of the
+  /// tiles in the dense array and then cloning the significant tiles into the
+  /// sparse array. The norms and clones are computed by tasks.
+  template <typename Tile>
+  DistArray<Tile, SparsePolicy>
+  to_sparse(DistArray<Tile, DensePolicy> const &dense_array) {
+      World& world = dense_array.world();
+
+      // Lazily clone the tiles so as not to hold a pointer to the original
+      // tile; the data is copied only if either tile is modified.
+      return detail::dense_to_sparse(dense_array, [&world] (const Future<Tile>& tile) {
+        return world.taskq.add([] (const Tile& tile) -> Tile {
+          using TiledArray::lazy_clone;
+          return lazy_clone(tile);
+        }, tile);
+      });
+  }
+
+  /// Function to convert a temporary dense array into a block sparse array
+
+  /// The significant tiles are moved into the sparse array without a copy.
+  /// \note The tiles of \c dense_array must not be shared with another array
+  /// (e.g. a shallow copy of \c dense_array ), since the result references them.
+  template <typename Tile>
+  DistArray<Tile, SparsePolicy>
+  to_sparse(DistArray<Tile, DensePolicy>&& dense_array) {
+      return detail::dense_to_sparse(dense_array,
+          [] (const Future<Tile>& tile) { return tile; });
   }
 
   /// If the array is already sparse return a copy of the array.
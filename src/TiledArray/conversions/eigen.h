@@ -27,6 +27,7 @@
 #define TILEDARRAY_EIGEN_H__INCLUDED
 
 #include <cstdint>
+#include <unordered_map>
 #include <tiledarray_fwd.h>
 #include <TiledArray/tensor.h>
 #include <TiledArray/error.h>
@@ -317,6 +318,148 @@ namespace TiledArray {
       (*counter)++;
     }
 
+    /// Assemble array tiles from distributed blocks of a matrix
+
+    /// Each process contributes the parts of its matrix block that overlap
+    /// each tile; the parts are sent directly to the owner of the tile, which
+    /// copies them into the tile and sets the tile once all of its elements
+    /// have arrived.
+    /// \tparam A The array type
+    template <typename A>
+    class EigenBlockAssembler :
+        public madness::WorldObject<EigenBlockAssembler<A> >,
+        private madness::Spinlock
+    {
+    public:
+      typedef EigenBlockAssembler<A> EigenBlockAssembler_; ///< This object type
+      typedef madness::WorldObject<EigenBlockAssembler_> WorldObject_; ///< Base object type
+      typedef typename A::value_type value_type; ///< Tile type
+      typedef typename A::size_type size_type; ///< Size type
+
+    private:
+      A array_; ///< The result array
+      std::unordered_map<size_type, std::pair<value_type, size_type> > tiles_;
+                        ///< Local tiles and the number of elements they still need
+
+      /// Copy a part of a tile into the local tile
+
+      /// \param i The tile index
+      /// \param part A tensor with a range that is a block of tile \c i
+      void insert(const size_type i, const value_type& part) {
+        auto it = tiles_.find(i);
+        TA_ASSERT(it != tiles_.end());
+        value_type& tile = it->second.first;
+        tile.block(part.range().lobound(), part.range().upbound()) = part;
+
+        lock(); // <<< Begin critical section
+        TA_ASSERT(it->second.second >= part.size());
+        const size_type remaining = (it->second.second -= part.size());
+        unlock(); // <<< End critical section
+
+        if(remaining == 0ul)
+          array_.set(i, tile);
+      }
+
+    public:
+
+      /// Constructor
+
+      /// This is a collective operation.
+      /// \param array The array that will hold the assembled tiles
+      EigenBlockAssembler(const A& array) :
+        WorldObject_(array.world()), madness::Spinlock(), array_(array), tiles_()
+      {
+        for(const auto i : *array_.pmap()) {
+          if(array_.is_zero(i))
+            continue;
+          value_type tile(array_.trange().make_tile_range(i));
+          const size_type volume = tile.size();
+          tiles_.emplace(i, std::make_pair(std::move(tile), volume));
+        }
+        WorldObject_::process_pending();
+      }
+
+      /// Send a part of a tile to its owner
+
+      /// \param i The tile index
+      /// \param part A tensor with a range that is a block of tile \c i
+      void put(const size_type i, const value_type& part) {
+        if(array_.is_local(i))
+          insert(i, part);
+        else
+          WorldObject_::task(array_.owner(i), & EigenBlockAssembler_::insert,
+              i, part, madness::TaskAttributes::hipri());
+      }
+
+      /// Number of local tiles that have not received all of their elements
+
+      /// \return The number of incomplete local tiles
+      size_type incomplete() const {
+        size_type result = 0ul;
+        for(const auto& tile : tiles_)
+          if(tile.second.second)
+            ++result;
+        return result;
+      }
+
+    }; // class EigenBlockAssembler
+
+    /// Tile index bounds of the tiles that overlap an element interval
+
+    /// \param tr1 The tiled range of a dimension
+    /// \param first The first element of the interval
+    /// \param last The end of the interval
+    /// \return The first and one past the last tile that overlap
+    /// <tt>[first, last)</tt>
+    inline std::pair<std::size_t, std::size_t>
+    overlapping_tiles(const TiledRange1& tr1, const std::size_t first,
+        const std::size_t last)
+    {
+      if(first >= last)
+        return std::pair<std::size_t, std::size_t>(0ul, 0ul);
+      return std::pair<std::size_t, std::size_t>(tr1.element_to_tile(first),
+          tr1.element_to_tile(last - 1ul) + 1ul);
+    }
+
+    /// Task function for copying the overlap of a tile into a matrix block
+
+    /// \tparam Derived The matrix type
+    /// \tparam T Tensor type
+    /// \param tensor The tensor to be copied
+    /// \param matrix The matrix block
+    /// \param row_offset The row of the full matrix that is the first row of
+    /// \c matrix
+    /// \param col_offset The column of the full matrix that is the first
+    /// column of \c matrix
+    /// \param counter The task counter
+    template <typename Derived, typename T>
+    void counted_tensor_to_eigen_block(const T& tensor,
+        Eigen::MatrixBase<Derived>* matrix, const std::size_t row_offset,
+        const std::size_t col_offset, madness::AtomicInt* counter)
+    {
+      const auto* MADNESS_RESTRICT const lower = tensor.range().lobound_data();
+      const auto* MADNESS_RESTRICT const upper = tensor.range().upbound_data();
+      const std::size_t row_first = std::max<std::size_t>(lower[0], row_offset);
+      const std::size_t row_last = std::min<std::size_t>(upper[0],
+          row_offset + matrix->rows());
+
+      if(tensor.range().rank() == 2u) {
+        const std::size_t col_first = std::max<std::size_t>(lower[1], col_offset);
+        const std::size_t col_last = std::min<std::size_t>(upper[1],
+            col_offset + matrix->cols());
+        matrix->block(row_first - row_offset, col_first - col_offset,
+            row_last - row_first, col_last - col_first) =
+            eigen_map(tensor, upper[0] - lower[0], upper[1] - lower[1]).block(
+            row_first - lower[0], col_first - lower[1], row_last - row_first,
+            col_last - col_first);
+      } else {
+        for(std::size_t i = row_first; i < row_last; ++i)
+          matrix->derived().coeffRef(i - row_offset) = tensor[i - lower[0]];
+      }
+
+      (*counter)++;
+    }
+
   } // namespace detail
 
   /// Convert an Eigen matrix into an Array object
@@ -355,10 +498,9 @@ namespace TiledArray {
   /// replicated array [default = false].
   /// \return An \c Array object that is a copy of \c matrix
   /// \throw TiledArray::Exception When world size is greater than 1
-  /// \note This function will only work in non-distributed environments. If you
-  /// need to convert an Eigen matrix to an \c Array object, you must implement
-  /// it yourself. However, you may use \c eigen_submatrix_to_tensor to make
-  /// writing such an algorithm easier.
+  /// \note This function will only work in non-distributed environments or
+  /// with replicated data. Use \c eigen_block_to_array to convert a matrix
+  /// that is distributed over the processes.
   template <typename A, typename Derived>
   A eigen_to_array(World& world, const typename A::trange_type& trange,
       const Eigen::MatrixBase<Derived>& matrix, bool replicated = false)
@@ -428,7 +570,8 @@ namespace TiledArray {
   /// \c array is not replicated.
   /// \throw TiledArray::Exception When the number of dimensions of \c array
   /// is not equal to 1 or 2.
-  /// \note This function will only work in non-distributed environments.
+  /// \note This function will only work in non-distributed environments. Use
+  /// \c array_to_eigen_block to gather a block of a distributed array.
   template <typename Tile, typename Policy,
             unsigned int EigenStorageOrder = Eigen::ColMajor>
   Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic, Eigen::Dynamic,
@@ -588,6 +731,246 @@ namespace TiledArray {
         Eigen::AutoAlign>(buffer, m, n), replicated);
   }
 
+
+  /// Convert a matrix that is distributed in blocks into an Array object
+
+  /// Each process provides one block of the matrix, e.g. a slab of rows or
+  /// columns, and the parts of the blocks that overlap each tile are sent
+  /// directly to the owner of the tile. No process needs to hold the full
+  /// matrix. The blocks of all processes must cover the matrix exactly
+  /// once; a process may provide an empty block. This is a collective
+  /// operation, and it will block until the array tiles are set.
+  /// Usage:
+  /// \code
+  /// // This process holds rows [first, last) of a 100 x 100 matrix
+  /// Eigen::MatrixXd slab(last - first, 100);
+  /// // Fill slab with data ...
+  ///
+  /// TiledArray::TArrayD array =
+  ///     eigen_block_to_array<TiledArray::TArrayD>(world, trange, slab, first);
+  /// \endcode
+  /// \tparam A The array type
+  /// \tparam Derived The Eigen matrix derived type
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the new array
+  /// \param block The block of the matrix held by this process; for a one
+  /// dimensional \c trange , a vector
+  /// \param row_offset The row (or vector element) of the full matrix that
+  /// is the first row of \c block
+  /// \param col_offset The column of the full matrix that is the first column
+  /// of \c block [default = 0]
+  /// \return An \c Array object that holds the matrix
+  /// \throw TiledArray::Exception When \c block is not inside the matrix
+  /// described by \c trange .
+  /// \throw TiledArray::Exception When the blocks do not cover the matrix.
+  template <typename A, typename Derived>
+  A eigen_block_to_array(World& world, const typename A::trange_type& trange,
+      const Eigen::MatrixBase<Derived>& block, const std::size_t row_offset,
+      const std::size_t col_offset = 0ul)
+  {
+    typedef typename A::value_type value_type;
+    const auto rank = trange.tiles_range().rank();
+    TA_USER_ASSERT((rank == 2u) || (rank == 1u),
+        "TiledArray::eigen_block_to_array(): The number of dimensions in trange must be equal to 1 or 2.");
+
+    const std::size_t rows = (rank == 2u ? block.rows() : block.size());
+    const std::size_t cols = (rank == 2u ? block.cols() : 1);
+    const auto* MADNESS_RESTRICT const extent = trange.elements_range().extent_data();
+    TA_USER_ASSERT(row_offset + rows <= extent[0],
+        "TiledArray::eigen_block_to_array(): The rows of the block are outside of trange.");
+    TA_USER_ASSERT((rank == 1u ? col_offset == 0ul : col_offset + cols <= extent[1]),
+        "TiledArray::eigen_block_to_array(): The columns of the block are outside of trange.");
+    TA_USER_ASSERT((rank == 2u) || (block.rows() == 1) || (block.cols() == 1),
+        "TiledArray::eigen_block_to_array(): The block must be a vector when trange has one dimension.");
+
+    A array(world, trange);
+    detail::EigenBlockAssembler<A> assembler(array);
+
+    // Send the parts of block that overlap each tile to the tile owner
+    const std::size_t row_last = row_offset + rows, col_last = col_offset + cols;
+    const auto row_tiles = detail::overlapping_tiles(trange.data()[0], row_offset, row_last);
+    const auto col_tiles = (rank == 2u ?
+        detail::overlapping_tiles(trange.data()[1], col_offset, col_last) :
+        std::pair<std::size_t, std::size_t>(0ul, 1ul));
+    for(std::size_t t0 = row_tiles.first; t0 < row_tiles.second; ++t0) {
+      const auto& tile0 = trange.data()[0].tile(t0);
+      const std::size_t r0 = std::max<std::size_t>(tile0.first, row_offset);
+      const std::size_t r1 = std::min<std::size_t>(tile0.second, row_last);
+
+      if(rank == 1u) {
+        const std::size_t i = trange.tiles_range().ordinal(std::array<std::size_t, 1>{{t0}});
+        if(array.is_zero(i))
+          continue;
+        value_type part(Range(std::array<std::size_t, 1>{{r0}},
+            std::array<std::size_t, 1>{{r1}}));
+        for(std::size_t j = r0; j < r1; ++j)
+          part[j - r0] = block.derived().coeff(j - row_offset);
+        assembler.put(i, part);
+        continue;
+      }
+
+      for(std::size_t t1 = col_tiles.first; t1 < col_tiles.second; ++t1) {
+        const std::size_t i = trange.tiles_range().ordinal(std::array<std::size_t, 2>{{t0, t1}});
+        if(array.is_zero(i))
+          continue;
+        const auto& tile1 = trange.data()[1].tile(t1);
+        const std::size_t c0 = std::max<std::size_t>(tile1.first, col_offset);
+        const std::size_t c1 = std::min<std::size_t>(tile1.second, col_last);
+
+        value_type part(Range(std::array<std::size_t, 2>{{r0, c0}},
+            std::array<std::size_t, 2>{{r1, c1}}));
+        eigen_map(part, r1 - r0, c1 - c0) =
+            block.block(r0 - row_offset, c0 - col_offset, r1 - r0, c1 - c0);
+        assembler.put(i, part);
+      }
+    }
+
+    // Wait for all parts to arrive
+    world.gop.fence();
+
+    std::size_t incomplete = assembler.incomplete();
+    world.gop.sum(incomplete);
+    TA_USER_ASSERT(incomplete == 0ul,
+        "TiledArray::eigen_block_to_array(): The blocks of the processes do not cover the matrix.");
+
+    return array;
+  }
+
+  /// Convert a row slab of a row-major matrix buffer into an Array object
+
+  /// Each process provides the rows <tt>[row_first, row_last)</tt> of the
+  /// matrix; see \c eigen_block_to_array for details. This is a collective
+  /// operation.
+  /// \tparam A The array type
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the new array
+  /// \param buffer The row-major buffer that holds the rows of this process
+  /// \param row_first The first row held by this process
+  /// \param row_last One past the last row held by this process
+  /// \return An \c Array object that holds the matrix
+  template <typename A>
+  inline A row_major_slab_to_array(World& world, const typename A::trange_type& trange,
+      const typename A::value_type::value_type* buffer, const std::size_t row_first,
+      const std::size_t row_last)
+  {
+    TA_USER_ASSERT(trange.tiles_range().rank() == 2u,
+        "TiledArray::row_major_slab_to_array(): The number of dimensions in trange must be equal to 2.");
+    TA_USER_ASSERT(row_first <= row_last,
+        "TiledArray::row_major_slab_to_array(): The first row is greater than the last row.");
+
+    typedef Eigen::Matrix<typename A::value_type::value_type, Eigen::Dynamic,
+        Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+    return eigen_block_to_array<A>(world, trange, Eigen::Map<const matrix_type,
+        Eigen::AutoAlign>(buffer, row_last - row_first,
+        trange.elements_range().extent(1)), row_first);
+  }
+
+  /// Convert a column slab of a column-major matrix buffer into an Array object
+
+  /// Each process provides the columns <tt>[col_first, col_last)</tt> of the
+  /// matrix; see \c eigen_block_to_array for details. This is a collective
+  /// operation.
+  /// \tparam A The array type
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the new array
+  /// \param buffer The column-major buffer that holds the columns of this
+  /// process
+  /// \param col_first The first column held by this process
+  /// \param col_last One past the last column held by this process
+  /// \return An \c Array object that holds the matrix
+  template <typename A>
+  inline A column_major_slab_to_array(World& world, const typename A::trange_type& trange,
+      const typename A::value_type::value_type* buffer, const std::size_t col_first,
+      const std::size_t col_last)
+  {
+    TA_USER_ASSERT(trange.tiles_range().rank() == 2u,
+        "TiledArray::column_major_slab_to_array(): The number of dimensions in trange must be equal to 2.");
+    TA_USER_ASSERT(col_first <= col_last,
+        "TiledArray::column_major_slab_to_array(): The first column is greater than the last column.");
+
+    typedef Eigen::Matrix<typename A::value_type::value_type, Eigen::Dynamic,
+        Eigen::Dynamic, Eigen::ColMajor> matrix_type;
+    return eigen_block_to_array<A>(world, trange, Eigen::Map<const matrix_type,
+        Eigen::AutoAlign>(buffer, trange.elements_range().extent(0),
+        col_last - col_first), 0ul, col_first);
+  }
+
+  /// Copy a block of an Array object into an Eigen matrix
+
+  /// Only the tiles that overlap the block are fetched, so each process can
+  /// gather its own slab of a distributed array without replicating the
+  /// array. Zero tiles are not fetched and are zero in the result. This
+  /// function is not collective, but the owners of the tiles must be able to
+  /// process requests for them.
+  /// \tparam Tile The array tile type
+  /// \tparam EigenStorageOrder The storage order of the resulting Eigen::Matrix
+  ///      object; the default is Eigen::ColMajor, i.e. the column-major storage
+  /// \param array The array to be copied
+  /// \param row_offset The first row (or vector element) of the block
+  /// \param rows The number of rows (or vector elements) in the block
+  /// \param col_offset The first column of the block [default = 0]
+  /// \param cols The number of columns of the block; must be 1 for a one
+  /// dimensional array [default = 1]
+  /// \return A \c rows by \c cols matrix that holds the block of \c array
+  /// \throw TiledArray::Exception When the number of dimensions of \c array
+  /// is not equal to 1 or 2.
+  /// \throw TiledArray::Exception When the block is outside of \c array .
+  template <typename Tile, typename Policy,
+            unsigned int EigenStorageOrder = Eigen::ColMajor>
+  Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic, Eigen::Dynamic,
+                EigenStorageOrder>
+  array_to_eigen_block(const DistArray<Tile, Policy>& array,
+      const std::size_t row_offset, const std::size_t rows,
+      const std::size_t col_offset = 0ul, const std::size_t cols = 1ul)
+  {
+    typedef Eigen::Matrix<typename Tile::value_type, Eigen::Dynamic,
+                          Eigen::Dynamic, EigenStorageOrder>
+        EigenMatrix;
+
+    const auto& trange = array.trange();
+    const auto rank = trange.tiles_range().rank();
+    TA_USER_ASSERT((rank == 2u) || (rank == 1u),
+        "TiledArray::array_to_eigen_block(): The array dimensions must be equal to 1 or 2.");
+    const auto* MADNESS_RESTRICT const extent = trange.elements_range().extent_data();
+    TA_USER_ASSERT(row_offset + rows <= extent[0],
+        "TiledArray::array_to_eigen_block(): The rows of the block are outside of the array.");
+    TA_USER_ASSERT((rank == 1u ? (col_offset == 0ul) && (cols == 1ul) :
+        col_offset + cols <= extent[1]),
+        "TiledArray::array_to_eigen_block(): The columns of the block are outside of the array.");
+
+    EigenMatrix matrix = EigenMatrix::Zero(rows, cols);
+
+    // Spawn tasks to copy the overlapping tiles into the matrix block
+    madness::AtomicInt counter;
+    counter = 0;
+    std::size_t n = 0;
+    const auto row_tiles = detail::overlapping_tiles(trange.data()[0], row_offset,
+        row_offset + rows);
+    const auto col_tiles = (rank == 2u ?
+        detail::overlapping_tiles(trange.data()[1], col_offset, col_offset + cols) :
+        std::pair<std::size_t, std::size_t>(0ul, 1ul));
+    for(std::size_t t0 = row_tiles.first; t0 < row_tiles.second; ++t0) {
+      for(std::size_t t1 = col_tiles.first; t1 < col_tiles.second; ++t1) {
+        const std::size_t i = (rank == 2u ?
+            trange.tiles_range().ordinal(std::array<std::size_t, 2>{{t0, t1}}) :
+            trange.tiles_range().ordinal(std::array<std::size_t, 1>{{t0}}));
+        if(array.is_zero(i))
+          continue;
+        array.world().taskq.add(
+            & detail::counted_tensor_to_eigen_block<EigenMatrix,
+            typename DistArray<Tile, Policy>::value_type>,
+            array.find(i), &matrix, row_offset, col_offset, &counter);
+        ++n;
+      }
+    }
+
+    // Wait until the above tasks are complete. Tasks will be processed by this
+    // thread while waiting.
+    array.world().await([&counter,n] () { return counter == n; });
+
+    return matrix;
+  }
+
 } // namespace TiledArray
 
 #endif // TILEDARRAY_EIGEN_H__INCLUDED
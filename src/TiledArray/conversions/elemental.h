@@ -36,6 +36,7 @@
 
 #include <El.hpp>
 
+#include <memory>
 #include <utility>
 
 namespace TiledArray {
@@ -84,13 +85,16 @@ El::DistMatrix<typename Array::element_type> matrix_to_el(
     auto el_A = El::DistMatrix<typename Array::element_type>(nrows, ncols, g);
     El::Zero(el_A);
 
-    // Loop over all tiles
+    // Loop over all tiles; the local tiles are found with one process map
+    // query instead of one per tile.
     const auto vol = trange.tiles_range().volume();
+    std::unique_ptr<bool[]> local(new bool[vol]);
+    A.pmap()->are_local(0ul, vol, local.get());
     for(auto i = 0ul; i < vol; ++i){
 
         // Write local tiles into a queue and allow elemental to do all 
         // communication of elements to the remote nodes.
-        if(!A.is_zero(i) && A.is_local(i)){
+        if(local[i] && !A.is_zero(i)){
             auto tile = A.find(i).get();
             
             auto lo = tile.range().lobound_data();
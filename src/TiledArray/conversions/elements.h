@@ -0,0 +1,262 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  elements.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_ELEMENTS_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_ELEMENTS_H__INCLUDED
+
+#include <TiledArray/conversions/retile.h>
+#include <unordered_map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Assemble array tiles from a distributed list of elements
+
+    /// Each process sorts its elements by the tile that holds them and sends
+    /// them to the tile owners in batches, one message per owner and batch.
+    /// The owners collect the elements of each local tile, and the tiles are
+    /// built by one task per tile once all elements have arrived.
+    /// \tparam Tile The tile type, which must be constructible from a range
+    /// and a fill value and support element access by ordinal
+    template <typename Tile>
+    class ElementAssembler :
+        public madness::WorldObject<ElementAssembler<Tile> >,
+        private madness::Spinlock
+    {
+    public:
+      typedef ElementAssembler<Tile> ElementAssembler_; ///< This object type
+      typedef madness::WorldObject<ElementAssembler_> WorldObject_; ///< Base object type
+      typedef typename Tile::value_type element_type; ///< Element type
+      typedef std::size_t size_type; ///< Size type
+
+      /// The number of elements sent to an owner in one message
+      static const size_type batch_size = 65536ul;
+
+    private:
+      /// The element offsets and values of a tile
+      typedef std::vector<std::pair<size_type, element_type> > elements_type;
+
+      /// Elements that are sent to one owner
+      struct Batch {
+        std::vector<size_type> tiles; ///< Tile ordinals
+        std::vector<size_type> offsets; ///< Element offsets in the tiles
+        std::vector<element_type> values; ///< Element values
+      }; // struct Batch
+
+      const TiledRange trange_; ///< The tiled range
+      const std::shared_ptr<Pmap> pmap_; ///< The process map of the tiles
+      std::unordered_map<size_type, elements_type> elements_;
+                        ///< The elements of the local tiles
+
+      /// Store a batch of elements of local tiles
+
+      /// \param tiles The tile ordinals
+      /// \param offsets The offsets of the elements in their tiles
+      /// \param values The element values
+      void insert(const std::vector<size_type>& tiles,
+          const std::vector<size_type>& offsets,
+          const std::vector<element_type>& values)
+      {
+        lock(); // <<< Begin critical section
+        for(size_type j = 0ul; j < tiles.size(); ++j)
+          elements_[tiles[j]].emplace_back(offsets[j], values[j]);
+        unlock(); // <<< End critical section
+      }
+
+      /// Send a batch to its owner, and clear it
+
+      /// \param proc The owner of the elements in \c batch
+      /// \param batch The batch
+      void flush(const ProcessID proc, Batch& batch) {
+        if(batch.tiles.empty())
+          return;
+        if(proc == WorldObject_::get_world().rank())
+          insert(batch.tiles, batch.offsets, batch.values);
+        else
+          WorldObject_::task(proc, & ElementAssembler_::insert, batch.tiles,
+              batch.offsets, batch.values, madness::TaskAttributes::hipri());
+        batch.tiles.clear();
+        batch.offsets.clear();
+        batch.values.clear();
+      }
+
+    public:
+
+      /// Constructor
+
+      /// This is a collective operation.
+      /// \param world The world where the tiles live
+      /// \param trange The tiled range
+      /// \param pmap The process map of the tiles
+      ElementAssembler(World& world, const TiledRange& trange,
+          const std::shared_ptr<Pmap>& pmap) :
+        WorldObject_(world), madness::Spinlock(), trange_(trange), pmap_(pmap),
+        elements_()
+      {
+        WorldObject_::process_pending();
+      }
+
+      /// Send a sequence of elements to the owners of their tiles
+
+      /// \tparam InIter An input iterator type, where the value type is a
+      /// pair of an element index and an element value
+      /// \param first An iterator to the first element
+      /// \param last An iterator to one past the last element
+      template <typename InIter>
+      void scatter(InIter first, InIter last) {
+        std::vector<Batch> batches(WorldObject_::get_world().size());
+        std::unordered_map<size_type, Range> ranges;
+        for(; first != last; ++first) {
+          const auto& index = first->first;
+          TA_USER_ASSERT(trange_.elements_range().includes(index),
+              "TiledArray::make_array_from_elements(): An element index is not included in the tiled range.");
+
+          // Find the tile that holds the element
+          const size_type tile = trange_.tiles_range().ordinal(trange_.element_to_tile(index));
+          auto it = ranges.find(tile);
+          if(it == ranges.end())
+            it = ranges.emplace(tile, trange_.make_tile_range(tile)).first;
+
+          const ProcessID proc = pmap_->owner(tile);
+          Batch& batch = batches[proc];
+          batch.tiles.push_back(tile);
+          batch.offsets.push_back(it->second.ordinal(index));
+          batch.values.push_back(first->second);
+          if(batch.tiles.size() == batch_size)
+            flush(proc, batch);
+        }
+
+        for(ProcessID proc = 0; proc < ProcessID(batches.size()); ++proc)
+          flush(proc, batches[proc]);
+      }
+
+      /// Build the local tiles
+
+      /// The tiles are built in parallel, with elements that were not given
+      /// set to zero.
+      /// \param accumulate If \c true , the values of repeated elements are
+      /// added; otherwise one of the values is kept
+      /// \param dense If \c true , all local tiles are built; otherwise only
+      /// the local tiles that hold at least one element are built
+      /// \return The ordinal indices and the data of the local tiles
+      /// \note All elements must have arrived, e.g. after a fence.
+      std::vector<std::pair<size_type, Tile> >
+      tiles(const bool accumulate, const bool dense) const {
+        std::vector<std::pair<size_type, Future<Tile> > > futures;
+        for(const auto index : *pmap_) {
+          const auto it = elements_.find(index);
+          if(it == elements_.end() && ! dense)
+            continue;
+          const elements_type* const elements =
+              (it == elements_.end() ? nullptr : &(it->second));
+
+          futures.emplace_back(index, WorldObject_::get_world().taskq.add(
+              [this,index,elements,accumulate] () -> Tile {
+                Tile tile(trange_.make_tile_range(index), element_type(0));
+                if(elements) {
+                  for(const auto& element : *elements) {
+                    if(accumulate)
+                      tile[element.first] += element.second;
+                    else
+                      tile[element.first] = element.second;
+                  }
+                }
+                return tile;
+              }));
+        }
+
+        std::vector<std::pair<size_type, Tile> > result;
+        result.reserve(futures.size());
+        for(auto& tile : futures)
+          result.emplace_back(tile.first, tile.second.get());
+        return result;
+      }
+
+    }; // class ElementAssembler
+
+    template <typename Tile>
+    const typename ElementAssembler<Tile>::size_type
+    ElementAssembler<Tile>::batch_size;
+
+  } // namespace detail
+
+  /// Construct an array from a list of elements
+
+  /// Each process provides a sequence of (element index, value) pairs, for
+  /// example the elements of an input file that it has read. The elements
+  /// are sent to the owners of their tiles in batches, and each owner builds
+  /// its tiles in parallel, so the cost scales with the number of elements
+  /// per process rather than the total number of elements. Elements that
+  /// are not given are zero. The shape of a sparse array is computed from
+  /// the norms of the assembled tiles, so tiles without elements are zero
+  /// tiles. This is a collective operation.
+  /// \code
+  /// std::vector<std::pair<std::array<std::size_t, 2>, double> > elements;
+  /// // ... add the elements read by this process
+  /// auto array = make_array_from_elements<TiledArray::TSpArrayD>(world,
+  ///     trange, elements.begin(), elements.end());
+  /// \endcode
+  /// \tparam Array The `DistArray` type
+  /// \tparam InIter An input iterator type, where the value type is a pair of
+  /// an element index and an element value
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the array
+  /// \param first An iterator to the first element of this process
+  /// \param last An iterator to one past the last element of this process
+  /// \param accumulate If \c true , the values of an element that is given
+  /// more than once, by one or several processes, are added; otherwise the
+  /// value that is kept is unspecified
+  /// \param pmap The process map of the array [default = the default process
+  /// map of the array policy]
+  /// \return An array that holds the elements
+  /// \throw TiledArray::Exception When an element index is not included in
+  /// \c trange .
+  template <typename Array, typename InIter>
+  inline Array
+  make_array_from_elements(World& world, const detail::trange_t<Array>& trange,
+      InIter first, InIter last, const bool accumulate = false,
+      std::shared_ptr<detail::pmap_t<Array> > pmap =
+          std::shared_ptr<detail::pmap_t<Array> >())
+  {
+    typedef typename Array::value_type value_type;
+
+    if(! pmap)
+      pmap = detail::policy_t<Array>::default_pmap(world,
+          trange.tiles_range().volume());
+
+    // Send the elements to the owners of their tiles
+    detail::ElementAssembler<value_type> assembler(world, trange, pmap);
+    assembler.scatter(first, last);
+
+    // Wait for all elements to arrive
+    world.gop.fence();
+
+    return detail::make_retiled_array<Array>(world, trange, pmap,
+        assembler.tiles(accumulate, is_dense<Array>::value));
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_ELEMENTS_H__INCLUDED
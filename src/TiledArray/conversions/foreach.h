@@ -27,6 +27,7 @@
 #define TILEDARRAY_CONVERSIONS_FOREACH_H__INCLUDED
 
 #include <TiledArray/type_traits.h>
+#include <TiledArray/memory_governor.h>
 
 /// Forward declarations
 namespace Eigen {
@@ -123,12 +124,63 @@ namespace TiledArray {
 
     }
 
+    /// Partition tiles into the chunks of a grained foreach
+
+    /// Consecutive tiles are grouped until the chunk contains at least
+    /// \c grain elements, so that the cost of a chunk task, which is
+    /// estimated by its number of elements, exceeds its scheduling overhead.
+    /// \tparam TRange The tiled range type
+    /// \param trange The tiled range of the arrays
+    /// \param indices The ordinal indices of the tiles
+    /// \param grain The minimum number of elements in a chunk
+    /// \return The offsets of the chunks in \c indices , followed by
+    /// <tt>indices.size()</tt>
+    template <typename TRange>
+    inline std::vector<std::size_t>
+    foreach_chunks(const TRange& trange, const std::vector<std::size_t>& indices,
+        const std::size_t grain)
+    {
+      std::vector<std::size_t> offsets(1, 0ul);
+      std::size_t volume = 0ul;
+      for(std::size_t j = 0ul; j < indices.size(); ++j) {
+        volume += trange.make_tile_range(indices[j]).volume();
+        if(volume >= grain) {
+          offsets.push_back(j + 1ul);
+          volume = 0ul;
+        }
+      }
+      if(offsets.back() != indices.size())
+        offsets.push_back(indices.size());
+      return offsets;
+    }
+
+    /// Collect the tiles of a chunk
+
+    /// \tparam A The array type
+    /// \param array The array
+    /// \param indices The ordinal indices of the tiles
+    /// \param first The offset of the first tile of the chunk in \c indices
+    /// \param last The offset of one past the last tile of the chunk
+    /// \return The tile futures of the chunk, where zero tiles are empty
+    template <typename A>
+    inline std::vector<Future<typename A::value_type> >
+    foreach_chunk_tiles(const A& array, const std::vector<std::size_t>& indices,
+        const std::size_t first, const std::size_t last)
+    {
+      std::vector<Future<typename A::value_type> > tiles;
+      tiles.reserve(last - first);
+      for(std::size_t j = first; j < last; ++j)
+        tiles.push_back(get_sparse_tile(indices[j], array));
+      return tiles;
+    }
+
     /// base implementation of dense TiledArray::foreach
 
     /// \note can't autodeduce \c ResultTile from \c void \c Op(ResultTile,ArgTile)
     template <bool inplace = false, typename Op,
         typename ResultTile, typename ArgTile, typename... ArgTiles>
     inline DistArray<ResultTile, DensePolicy> foreach ( Op && op,
+        const std::size_t grain,
         const_if_t<not inplace, DistArray<ArgTile, DensePolicy>>& arg,
         const DistArray<ArgTiles, DensePolicy>&... args) {
 
@@ -142,6 +194,55 @@ namespace TiledArray {
       // Make an empty result array
       result_array_type result(world, arg.trange(), arg.pmap());
 
+      if(grain) {
+        typedef typename arg_array_type::value_type arg_value_type;
+        typedef typename result_array_type::value_type result_value_type;
+        typedef typename result_array_type::size_type size_type;
+        typedef typename std::decay<Op>::type op_type;
+
+        // Evaluate chunks of local tiles, and insert the result tiles of
+        // each chunk with one batched set.
+        const auto indices = std::make_shared<const std::vector<std::size_t> >(
+            arg.pmap()->begin(), arg.pmap()->end());
+        const std::vector<std::size_t> offsets =
+            foreach_chunks(arg.trange(), *indices, grain);
+        const auto shared_op = std::make_shared<op_type>(std::forward<Op>(op));
+
+        detail::MemoryGovernor& governor = detail::MemoryGovernor::instance();
+        for(std::size_t c = 1ul; c < offsets.size(); ++c) {
+          const std::size_t first = offsets[c - 1ul];
+          const std::size_t last = offsets[c];
+          std::size_t bytes = 0ul;
+          if(governor.enabled())
+            for(std::size_t j = first; j < last; ++j)
+              bytes += detail::tile_memory<result_value_type>(
+                  arg.trange().make_tile_range((*indices)[j]));
+          // The task returns a flag, so the memory governor can release
+          // its reservation when the result future is set.
+          detail::governed_task(world, bytes, [result, shared_op, indices, first, last] (
+              const std::vector<Future<arg_value_type> >& arg_tiles,
+              const std::vector<Future<ArgTiles> >&... arg_tiles_list) -> bool
+          {
+            void_op_helper<inplace, op_type&, result_value_type,
+                arg_value_type, ArgTiles...> op_caller;
+            const std::vector<size_type> ords(indices->begin() + first,
+                indices->begin() + last);
+            std::vector<result_value_type> tiles;
+            tiles.reserve(ords.size());
+            for(std::size_t j = 0ul; j < ords.size(); ++j) {
+              arg_value_type arg_tile = arg_tiles[j].get();
+              tiles.push_back(op_caller(*shared_op, arg_tile,
+                  arg_tiles_list[j].get()...));
+            }
+            result.pimpl()->set(ords, tiles);
+            return true;
+          }, foreach_chunk_tiles(arg, *indices, first, last),
+              foreach_chunk_tiles(args, *indices, first, last)...);
+        }
+
+        return result;
+      }
+
       // Construct the task function for making result tiles.
       auto task = [&op](const_if_t<not inplace, typename arg_array_type::value_type>& arg_tile,
           const ArgTiles&... arg_tiles)
@@ -157,7 +258,10 @@ namespace TiledArray {
       for (auto index: *(arg.pmap())) {
         // Spawn a task to evaluate the tile
         Future<typename result_array_type::value_type> tile =
-            world.taskq.add(task, arg.find(index), args.find(index)...);
+            detail::governed_task(world, detail::tile_memory<
+                typename result_array_type::value_type>(
+                    arg.trange().make_tile_range(index)),
+                task, arg.find(index), args.find(index)...);
 
         // Store result tile
         result.set(index, tile);
@@ -172,6 +276,7 @@ namespace TiledArray {
     template <bool inplace = false, typename Op,
         typename ResultTile, typename ArgTile, typename... ArgTiles>
     inline DistArray<ResultTile, SparsePolicy> foreach (Op&& op, const ShapeReductionMethod shape_reduction,
+        const std::size_t grain,
         const_if_t<not inplace, DistArray<ArgTile, SparsePolicy>>& arg,
         const DistArray<ArgTiles, SparsePolicy>&... args) {
 
@@ -214,6 +319,66 @@ namespace TiledArray {
 
       World& world = arg.world();
 
+      if(grain) {
+        // Select the local tiles to be evaluated
+        std::vector<std::size_t> indices;
+        for(auto index: *(arg.pmap())) {
+          const bool zero = (shape_reduction == ShapeReductionMethod::Intersect ?
+              is_zero_intersection({arg.is_zero(index), args.is_zero(index)...}) :
+              is_zero_union({arg.is_zero(index), args.is_zero(index)...}));
+          if(! zero)
+            indices.push_back(index);
+        }
+
+        // Evaluate chunks of tiles. The tile norms are collected in the same
+        // pass, and the result tiles are held until the shape is known.
+        std::vector<result_value_type> results(indices.size());
+        const std::vector<std::size_t> offsets =
+            foreach_chunks(arg.trange(), indices, grain);
+        for(std::size_t c = 1ul; c < offsets.size(); ++c) {
+          const std::size_t first = offsets[c - 1ul];
+          const std::size_t last = offsets[c];
+          world.taskq.add([&op,&counter,&tile_norms,&indices,&results,first,last] (
+              const std::vector<Future<arg_value_type> >& arg_tiles,
+              const std::vector<Future<ArgTiles> >&... arg_tiles_list)
+          {
+            nonvoid_op_helper<inplace, Op,
+                typename shape_type::value_type,
+                result_value_type,
+                arg_value_type,
+                ArgTiles...> op_caller;
+            for(std::size_t j = first; j < last; ++j) {
+              arg_value_type arg_tile = arg_tiles[j - first].get();
+              results[j] = op_caller(std::forward<Op>(op), tile_norms[indices[j]],
+                  arg_tile, arg_tiles_list[j - first].get()...);
+              ++counter;
+            }
+          }, foreach_chunk_tiles(arg, indices, first, last),
+              foreach_chunk_tiles(args, indices, first, last)...);
+        }
+
+        // Wait for tile norm data to be collected.
+        const int tile_count = indices.size();
+        if(tile_count > 0)
+          world.await([&counter,tile_count] () -> bool { return counter == tile_count; });
+
+        // Construct the new array, and insert the non-zero tiles with one
+        // batched set
+        result_array_type result(world, arg.trange(),
+            shape_type(world, tile_norms, arg.trange()), arg.pmap());
+        std::vector<size_type> ords;
+        std::vector<result_value_type> tiles;
+        for(std::size_t j = 0ul; j < indices.size(); ++j) {
+          if(! result.is_zero(indices[j])) {
+            ords.push_back(indices[j]);
+            tiles.push_back(results[j]);
+          }
+        }
+        result.pimpl()->set(ords, tiles);
+
+        return result;
+      }
+
       switch (shape_reduction) {
       case ShapeReductionMethod::Intersect:
         // Get local tile index iterator
@@ -286,11 +451,16 @@ namespace TiledArray {
   /// \tparam ArgTile The tile type of \c arg
   /// \param op The tile function
   /// \param arg The argument array
+  /// \param grain The minimum number of elements evaluated by each task. If
+  /// nonzero, local tiles are grouped into chunks of at least \c grain
+  /// elements and the result tiles of a chunk are inserted together;
+  /// otherwise each tile is evaluated by a separate task.
   template <typename ResultTile, typename ArgTile, typename Op,
             typename = typename std::enable_if<!std::is_same<ResultTile,ArgTile>::value>::type>
   inline DistArray<ResultTile, DensePolicy>
-  foreach(const DistArray<ArgTile, DensePolicy>& arg, Op&& op) {
-    return detail::foreach<false, Op, ResultTile, ArgTile>(std::forward<Op>(op), arg);
+  foreach(const DistArray<ArgTile, DensePolicy>& arg, Op&& op,
+      const std::size_t grain = 0ul) {
+    return detail::foreach<false, Op, ResultTile, ArgTile>(std::forward<Op>(op), grain, arg);
   }
 
   /// Apply a function to each tile of a dense Array
@@ -299,8 +469,9 @@ namespace TiledArray {
   /// the case \c ResultTile == \c ArgTile
   template <typename Tile, typename Op>
   inline DistArray<Tile, DensePolicy>
-  foreach(const DistArray<Tile, DensePolicy>& arg, Op&& op) {
-    return detail::foreach<false, Op, Tile, Tile>(std::forward<Op>(op), arg);
+  foreach(const DistArray<Tile, DensePolicy>& arg, Op&& op,
+      const std::size_t grain = 0ul) {
+    return detail::foreach<false, Op, Tile, Tile>(std::forward<Op>(op), grain, arg);
   }
 
   /// Modify each tile of a dense Array
@@ -324,6 +495,10 @@ namespace TiledArray {
   /// \param arg The argument array to be modified
   /// \param fence A flag that indicates fencing behavior. If \c true this
   /// function will fence before data is modified.
+  /// \param grain The minimum number of elements evaluated by each task. If
+  /// nonzero, local tiles are grouped into chunks of at least \c grain
+  /// elements and the result tiles of a chunk are inserted together;
+  /// otherwise each tile is evaluated by a separate task.
   /// \warning This function fences by default to avoid data race conditions.
   /// Only disable the fence if you can ensure, the data is not being read by
   /// another thread.
@@ -336,13 +511,14 @@ namespace TiledArray {
   template <typename Tile, typename Op,
       typename = typename std::enable_if<! TiledArray::detail::is_array<typename std::decay<Op>::type>::value>::type>
   inline void
-  foreach_inplace(DistArray<Tile, DensePolicy>& arg, Op&& op, bool fence = true) {
+  foreach_inplace(DistArray<Tile, DensePolicy>& arg, Op&& op, bool fence = true,
+      const std::size_t grain = 0ul) {
     // The tile data is being modified in place, which means we may need to
     // fence to ensure no other threads are using the data.
     if(fence)
       arg.world().gop.fence();
 
-    arg = detail::foreach<true, Op, Tile, Tile>(std::forward<Op>(op), arg);
+    arg = detail::foreach<true, Op, Tile, Tile>(std::forward<Op>(op), grain, arg);
   }
 
   /// Apply a function to each tile of a sparse Array
@@ -380,11 +556,16 @@ namespace TiledArray {
   /// \tparam Tile The tile type of the array
   /// \param op The tile function
   /// \param arg The argument array
+  /// \param grain The minimum number of elements evaluated by each task. If
+  /// nonzero, local tiles are grouped into chunks of at least \c grain
+  /// elements and the result tiles of a chunk are inserted together;
+  /// otherwise each tile is evaluated by a separate task.
   template <typename ResultTile, typename ArgTile, typename Op,
             typename = typename std::enable_if<!std::is_same<ResultTile,ArgTile>::value>::type>
   inline DistArray<ResultTile, SparsePolicy>
-  foreach(const DistArray<ArgTile, SparsePolicy> arg, Op&& op) {
-    return detail::foreach<false, Op, ResultTile, ArgTile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+  foreach(const DistArray<ArgTile, SparsePolicy> arg, Op&& op,
+      const std::size_t grain = 0ul) {
+    return detail::foreach<false, Op, ResultTile, ArgTile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, grain, arg);
   }
 
   /// Apply a function to each tile of a sparse Array
@@ -393,8 +574,9 @@ namespace TiledArray {
   /// the case \c ResultTile == \c ArgTile
   template <typename Tile, typename Op>
   inline DistArray<Tile, SparsePolicy>
-  foreach(const DistArray<Tile, SparsePolicy>& arg, Op&& op) {
-    return detail::foreach<false, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+  foreach(const DistArray<Tile, SparsePolicy>& arg, Op&& op,
+      const std::size_t grain = 0ul) {
+    return detail::foreach<false, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, grain, arg);
   }
 
 
@@ -428,6 +610,10 @@ namespace TiledArray {
   /// \param arg The argument array to be modified
   /// \param fence A flag that indicates fencing behavior. If \c true this
   /// function will fence before data is modified.
+  /// \param grain The minimum number of elements evaluated by each task. If
+  /// nonzero, local tiles are grouped into chunks of at least \c grain
+  /// elements and the result tiles of a chunk are inserted together;
+  /// otherwise each tile is evaluated by a separate task.
   /// \warning This function fences by default to avoid data race conditions.
   /// Only disable the fence if you can ensure, the data is not being read by
   /// another thread.
@@ -440,7 +626,8 @@ namespace TiledArray {
   template <typename Tile, typename Op,
       typename = typename std::enable_if<! TiledArray::detail::is_array<typename std::decay<Op>::type>::value>::type>
   inline void
-  foreach_inplace(DistArray<Tile, SparsePolicy>& arg, Op&& op, bool fence = true) {
+  foreach_inplace(DistArray<Tile, SparsePolicy>& arg, Op&& op, bool fence = true,
+      const std::size_t grain = 0ul) {
 
     // The tile data is being modified in place, which means we may need to
     // fence to ensure no other threads are using the data.
@@ -448,18 +635,22 @@ namespace TiledArray {
       arg.world().gop.fence();
 
     // Set the arg with the new array
-    arg = detail::foreach<true, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, arg);
+    arg = detail::foreach<true, Op, Tile, Tile>(std::forward<Op>(op), ShapeReductionMethod::Intersect, grain, arg);
   }
 
   /// Apply a function to each tile of dense Arrays
   /// The following function takes two input tiles
+  /// \note Each \c foreach and \c foreach_inplace overload accepts a
+  /// trailing \c grain argument, which evaluates the local tiles in chunks of
+  /// at least \c grain elements.
   template <typename ResultTile, typename LeftTile, typename RightTile, typename Op,
             typename = typename std::enable_if<!std::is_same<ResultTile, LeftTile>::value>::type>
   inline DistArray<ResultTile, DensePolicy>
   foreach(const DistArray<LeftTile, DensePolicy>& left,
-      const DistArray<RightTile, DensePolicy>& right, Op&& op) {
+      const DistArray<RightTile, DensePolicy>& right, Op&& op,
+      const std::size_t grain = 0ul) {
     return detail::foreach<false, Op, ResultTile, LeftTile, RightTile>(std::forward<Op>(op),
-        left, right);
+        grain, left, right);
   }
 
   /// Specialization of foreach<ResultTile,ArgTile,Op> for
@@ -467,23 +658,25 @@ namespace TiledArray {
   template <typename LeftTile, typename RightTile, typename Op>
   inline DistArray<LeftTile, DensePolicy>
   foreach(const DistArray<LeftTile, DensePolicy>& left,
-      const DistArray<RightTile, DensePolicy>& right, Op&& op) {
+      const DistArray<RightTile, DensePolicy>& right, Op&& op,
+      const std::size_t grain = 0ul) {
     return detail::foreach<false, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
-        left, right);
+        grain, left, right);
   }
 
   /// This function takes two input tiles and put result into the left tile
   template <typename LeftTile, typename RightTile, typename Op>
   inline void
   foreach_inplace(DistArray<LeftTile, DensePolicy>& left,
-      const DistArray<RightTile, DensePolicy>& right, Op&& op, bool fence = true) {
+      const DistArray<RightTile, DensePolicy>& right, Op&& op, bool fence = true,
+      const std::size_t grain = 0ul) {
     // The tile data is being modified in place, which means we may need to
     // fence to ensure no other threads are using the data.
     if(fence)
       left.world().gop.fence();
 
     left = detail::foreach<true, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
-        left, right);
+        grain, left, right);
   }
 
   /// Apply a function to each tile of sparse Arrays
@@ -493,9 +686,10 @@ namespace TiledArray {
   inline DistArray<ResultTile, SparsePolicy>
   foreach(const DistArray<LeftTile, SparsePolicy>& left,
       const DistArray<RightTile, SparsePolicy>& right, Op&& op,
-      const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect) {
+      const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect,
+      const std::size_t grain = 0ul) {
     return detail::foreach<false, Op, ResultTile, LeftTile, RightTile>(std::forward<Op>(op),
-        shape_reduction, left, right);
+        shape_reduction, grain, left, right);
   }
 
   /// Specialization of foreach<ResultTile,ArgTile,Op> for
@@ -504,9 +698,10 @@ namespace TiledArray {
   inline DistArray<LeftTile, SparsePolicy>
   foreach(const DistArray<LeftTile, SparsePolicy>& left,
       const DistArray<RightTile, SparsePolicy>& right, Op&& op,
-      const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect) {
+      const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect,
+      const std::size_t grain = 0ul) {
     return detail::foreach<false, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
-        shape_reduction, left, right);
+        shape_reduction, grain, left, right);
   }
 
   /// This function takes two input tiles and put result into the left tile
@@ -515,7 +710,7 @@ namespace TiledArray {
   foreach_inplace(DistArray<LeftTile, SparsePolicy>& left,
       const DistArray<RightTile, SparsePolicy>& right, Op&& op,
       const ShapeReductionMethod shape_reduction = ShapeReductionMethod::Intersect,
-      bool fence = true) {
+      bool fence = true, const std::size_t grain = 0ul) {
 
     // The tile data is being modified in place, which means we may need to
     // fence to ensure no other threads are using the data.
@@ -524,7 +719,7 @@ namespace TiledArray {
 
     // Set the arg with the new array
     left = detail::foreach<true, Op, LeftTile, LeftTile, RightTile>(std::forward<Op>(op),
-        shape_reduction, left, right);
+        shape_reduction, grain, left, right);
   }
 
 } // namespace TiledArray
@@ -0,0 +1,141 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  redistribute.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_REDISTRIBUTE_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_REDISTRIBUTE_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/tile_cost.h>
+#include <map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Task function that sends a batch of tiles to their new owner
+
+    /// \tparam Array The array type
+    /// \param result The redistributed array
+    /// \param indices The ordinal indices of the tiles
+    /// \param tiles The tiles, where <tt>tiles[j]</tt> is tile
+    /// <tt>indices[j]</tt>
+    template <typename Array>
+    void redistribute_send(Array result,
+        const std::vector<typename Array::size_type>& indices,
+        const std::vector<Future<typename Array::value_type> >& tiles)
+    {
+      std::vector<typename Array::value_type> values;
+      values.reserve(tiles.size());
+      for(const auto& tile : tiles)
+        values.push_back(tile.get());
+      result.set(indices, values);
+    }
+
+  } // namespace detail
+
+  /// Move an array to a different process map
+
+  /// Each process sends the local tiles of \c array that are owned by another
+  /// process in \c pmap directly to their new owner. The tiles of each new
+  /// owner are sent in bulk, with one task per owner that sends them in a
+  /// few large messages once they are ready (see \c DistArray::set ). Tiles
+  /// that stay on the same process are shared with \c array , not copied.
+  /// The result has the tiled range and the shape of \c array . This is a
+  /// collective operation, but it does not wait for the tiles to be moved.
+  /// \tparam Tile The array tile type
+  /// \tparam Policy The array policy type
+  /// \param array The array to be redistributed
+  /// \param pmap The process map of the result
+  /// \return A copy of \c array with the process map \c pmap
+  /// \throw TiledArray::Exception When \c pmap does not have the number of
+  /// tiles of \c array .
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  redistribute(const DistArray<Tile, Policy>& array,
+      const std::shared_ptr<typename DistArray<Tile, Policy>::pmap_interface>& pmap)
+  {
+    typedef DistArray<Tile, Policy> array_type;
+    typedef typename array_type::size_type size_type;
+
+    TA_USER_ASSERT(pmap, "TiledArray::redistribute(): The process map is null.");
+    TA_USER_ASSERT(pmap->size() == array.size(),
+        "TiledArray::redistribute(): The process map size does not match the number of tiles.");
+
+    World& world = array.world();
+    array_type result(world, array.trange(), array.shape(), pmap);
+
+    // Group the local tiles by their new owner
+    std::map<ProcessID, std::pair<std::vector<size_type>,
+        std::vector<Future<Tile> > > > batches;
+    for(const auto index : *array.pmap()) {
+      if(array.is_zero(index))
+        continue;
+      const ProcessID owner = pmap->owner(index);
+      if(owner == world.rank()) {
+        result.set(index, array.find(index));
+      } else {
+        auto& batch = batches[owner];
+        batch.first.push_back(index);
+        batch.second.push_back(array.find(index));
+      }
+    }
+
+    // Send each batch when its tiles are ready
+    for(auto& batch : batches)
+      world.taskq.add(& detail::redistribute_send<array_type>, result,
+          batch.second.first, batch.second.second);
+
+    return result;
+  }
+
+  /// Move an array to a process map that balances measured tile costs
+
+  /// The tiles of \c array are redistributed to a cost weighted process map
+  /// (see \c TileCostRecorder::make_pmap() ) when the load imbalance of its
+  /// current process map exceeds \c threshold . Other arrays that should be
+  /// distributed like \c array can then be moved to its new process map with
+  /// \c redistribute() . This is a collective operation, but it does not
+  /// wait for the tiles to be moved.
+  /// \tparam Tile The array tile type
+  /// \tparam Policy The array policy type
+  /// \param[in,out] array The array to be rebalanced
+  /// \param recorder The recorded costs of the tiles of \c array
+  /// \param threshold The load imbalance above which \c array is moved
+  /// \return \c true if \c array was moved to a new process map
+  template <typename Tile, typename Policy>
+  inline bool rebalance(DistArray<Tile, Policy>& array,
+      const TileCostRecorder& recorder,
+      const double threshold = TILEDARRAY_WEIGHTED_PMAP_THRESHOLD)
+  {
+    const std::shared_ptr<Pmap> pmap =
+        recorder.make_pmap(array.world(), *array.pmap(), threshold);
+    if(! pmap)
+      return false;
+    array = redistribute(array, pmap);
+    return true;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_REDISTRIBUTE_H__INCLUDED
@@ -0,0 +1,176 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  reshape.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_RESHAPE_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_RESHAPE_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// The tile boundaries of a group of fused dimensions
+
+    /// The group is compatible with a fusion when all of its dimensions,
+    /// except the first, are a single tile; then the tiles of the fused
+    /// dimension are the tiles of the first dimension, scaled by the extent of
+    /// the other dimensions.
+    /// \param trange The tiled range
+    /// \param first The first dimension of the group
+    /// \param last One past the last dimension of the group
+    /// \param[out] boundaries The fused tile boundaries, relative to the first
+    /// element
+    /// \return \c true if the group can be fused without moving data
+    inline bool fused_tile_boundaries(const TiledRange& trange,
+        const std::size_t first, const std::size_t last,
+        std::vector<std::size_t>& boundaries)
+    {
+      std::size_t inner = 1ul;
+      for(std::size_t d = first + 1ul; d < last; ++d) {
+        const TiledRange1& trange1 = trange.dim(d);
+        if(trange1.tile_extent() != 1ul)
+          return false;
+        inner *= trange1.extent();
+      }
+
+      const TiledRange1& trange1 = trange.dim(first);
+      boundaries.clear();
+      for(const auto& tile : trange1)
+        boundaries.push_back((tile.first - trange1.elements_range().first) * inner);
+      boundaries.push_back(trange1.extent() * inner);
+      return true;
+    }
+
+    /// Check that a tiled range is a reshape of another
+
+    /// \c to is a reshape of \c from when it fuses or splits groups of
+    /// consecutive dimensions of \c from , and the tiles of each group are
+    /// the same in both. The tiles then have the same ordinal indices and
+    /// volumes, and the row-major data of each tile of \c from is the data of
+    /// the tile of \c to with the same index.
+    /// \param from The tiled range of the data
+    /// \param to The reshaped tiled range
+    /// \return \c true if \c from can be viewed as \c to without moving data
+    inline bool is_reshape_compatible(const TiledRange& from, const TiledRange& to) {
+      const std::size_t from_rank = from.rank(), to_rank = to.rank();
+      std::vector<std::size_t> from_boundaries, to_boundaries;
+      std::size_t i = 0ul, j = 0ul;
+      while((i < from_rank) && (j < to_rank)) {
+        // Find the smallest groups of dimensions with the same extent
+        const std::size_t first_i = i, first_j = j;
+        std::size_t from_extent = from.dim(i++).extent();
+        std::size_t to_extent = to.dim(j++).extent();
+        while(from_extent != to_extent) {
+          if(from_extent < to_extent) {
+            if(i == from_rank)
+              return false;
+            from_extent *= from.dim(i++).extent();
+          } else {
+            if(j == to_rank)
+              return false;
+            to_extent *= to.dim(j++).extent();
+          }
+        }
+
+        if(! fused_tile_boundaries(from, first_i, i, from_boundaries))
+          return false;
+        if(! fused_tile_boundaries(to, first_j, j, to_boundaries))
+          return false;
+        if(from_boundaries != to_boundaries)
+          return false;
+      }
+
+      // The remaining dimensions must be empty of elements, i.e. unit extent
+      for(; i < from_rank; ++i)
+        if(from.dim(i).extent() != 1ul)
+          return false;
+      for(; j < to_rank; ++j)
+        if(to.dim(j).extent() != 1ul)
+          return false;
+
+      return true;
+    }
+
+    /// Task function that reshapes a view of a tile
+
+    /// \tparam Tile The tile type
+    /// \param tile The tile
+    /// \param range The range of the result
+    /// \return A view of \c tile with range \c range
+    template <typename Tile>
+    Tile reshape_tile(const Tile& tile, const typename Tile::range_type& range) {
+      using TiledArray::reshape_view;
+      return reshape_view(tile, range);
+    }
+
+  } // namespace detail
+
+  /// Reshape a view of an array
+
+  /// The result reinterprets the tiles of \c array in the tiled range
+  /// \c trange , which fuses or splits groups of consecutive dimensions of
+  /// the tiled range of \c array , e.g. <tt>[a,b,i,j]</tt> into
+  /// <tt>[ab,ij]</tt> for a matrix-style operation and back. The fused
+  /// dimensions must map onto the existing tiles: every dimension of a group,
+  /// except the first, must be a single tile (see
+  /// \c detail::is_reshape_compatible() ). Then each tile of the result is a
+  /// view of the tile with the same ordinal index, on the same process, so no
+  /// data is copied or moved; the result also shares the process map of
+  /// \c array , and its shape is a view of the shape of \c array .
+  /// \code
+  /// // a has tiled range [a,b,i,j] with a single tile in b and j
+  /// TArrayD m = reshape(a, TiledRange{ab_trange1, ij_trange1});
+  /// \endcode
+  /// \tparam Tile The array tile type, which must support \c reshape_view()
+  /// \tparam Policy The array policy type
+  /// \param array The array to be reshaped
+  /// \param trange The tiled range of the result
+  /// \return A view of \c array with the tiled range \c trange
+  /// \throw TiledArray::Exception When \c trange is not a compatible reshape
+  /// of the tiled range of \c array .
+  /// \note The tiles of the result share data with the tiles of \c array , so
+  /// tiles that are modified in place are modified in both arrays.
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  reshape(const DistArray<Tile, Policy>& array, const TiledRange& trange) {
+    TA_USER_ASSERT(detail::is_reshape_compatible(array.trange(), trange),
+        "TiledArray::reshape(): The tiled range is not a compatible reshape of the array.");
+
+    World& world = array.world();
+    DistArray<Tile, Policy> result(world, trange, array.shape().reshape(trange),
+        array.pmap());
+    for(const auto index : *array.pmap()) {
+      if(array.is_zero(index))
+        continue;
+      result.set(index, world.taskq.add(& detail::reshape_tile<Tile>,
+          array.find(index), trange.make_tile_range(index)));
+    }
+
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_RESHAPE_H__INCLUDED
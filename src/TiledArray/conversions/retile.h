@@ -0,0 +1,264 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  retile.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_CONVERSIONS_RETILE_H__INCLUDED
+#define TILEDARRAY_CONVERSIONS_RETILE_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <unordered_map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// The tiles of a tiled range that overlap an element block
+
+    /// \param trange The tiled range
+    /// \param lower The lower bound of the element block
+    /// \param upper The upper bound of the element block
+    /// \return The range of tile indices of \c trange that overlap the block
+    template <typename Index>
+    inline Range overlapping_tiles(const TiledRange& trange, const Index& lower,
+        const Index& upper)
+    {
+      const std::size_t rank = trange.rank();
+      std::vector<std::size_t> tile_lower(rank), tile_upper(rank);
+      for(std::size_t d = 0ul; d < rank; ++d) {
+        tile_lower[d] = trange.dim(d).element_to_tile(lower[d]);
+        tile_upper[d] = trange.dim(d).element_to_tile(upper[d] - 1ul) + 1ul;
+      }
+      return Range(tile_lower, tile_upper);
+    }
+
+    /// Copy the parts of tiles into the tiles of a new tiled range
+
+    /// Each process splits its local source tiles at the tile boundaries of
+    /// the new tiled range and sends each part directly to the owner of the
+    /// new tile that holds it, so every element is sent at most once and
+    /// parts that stay on the same process are not sent at all. A new tile is
+    /// complete when all of its parts have been copied into it.
+    /// \tparam Tile The tile type, which must support \c block()
+    template <typename Tile>
+    class Retiler : public madness::WorldObject<Retiler<Tile> > {
+    public:
+      typedef Retiler<Tile> Retiler_; ///< This object type
+      typedef madness::WorldObject<Retiler_> WorldObject_; ///< Base object type
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      /// A local tile of the new tiled range
+      struct Target {
+        Tile tile; ///< The tile data
+        madness::AtomicInt parts; ///< The number of parts that have not arrived
+      }; // struct Target
+
+      const TiledRange trange_; ///< The new tiled range
+      const std::shared_ptr<Pmap> pmap_; ///< The process map of the new tiles
+      std::unordered_map<size_type, Target> targets_; ///< The local new tiles
+
+      /// Copy a part into its new tile
+
+      /// \param index The ordinal index of the new tile
+      /// \param part A tile with a range that is inside the new tile
+      void insert(const size_type index, const Tile& part) {
+        typename std::unordered_map<size_type, Target>::iterator it =
+            targets_.find(index);
+        TA_ASSERT(it != targets_.end());
+        it->second.tile.block(part.range().lobound(), part.range().upbound()) = part;
+        --(it->second.parts);
+      }
+
+    public:
+
+      /// Constructor
+
+      /// This is a collective operation. The local tiles of the new tiled
+      /// range that overlap a non-zero source tile are allocated and zeroed.
+      /// \tparam Shape The source shape type
+      /// \param world The world of the arrays
+      /// \param source_trange The tiled range of the source tiles
+      /// \param source_shape The shape of the source tiles
+      /// \param trange The new tiled range
+      /// \param pmap The process map of the new tiles
+      template <typename Shape>
+      Retiler(World& world, const TiledRange& source_trange,
+          const Shape& source_shape, const TiledRange& trange,
+          const std::shared_ptr<Pmap>& pmap) :
+        WorldObject_(world), trange_(trange), pmap_(pmap), targets_()
+      {
+        for(const auto index : *pmap_) {
+          const auto range = trange_.make_tile_range(index);
+          int parts = 0;
+          for(const auto& source_index :
+              overlapping_tiles(source_trange, range.lobound(), range.upbound()))
+            if(! source_shape.is_zero(source_trange.tiles_range().ordinal(source_index)))
+              ++parts;
+          if(parts == 0)
+            continue;
+
+          Target& target = targets_[index];
+          target.tile = Tile(range, typename Tile::value_type(0));
+          target.parts = parts;
+        }
+
+        WorldObject_::process_pending();
+      }
+
+      /// Send the parts of a source tile to the owners of the new tiles
+
+      /// \param tile The source tile
+      void scatter(const Tile& tile) {
+        const auto lower = tile.range().lobound();
+        const auto upper = tile.range().upbound();
+        const std::size_t rank = trange_.rank();
+        std::vector<std::size_t> part_lower(rank), part_upper(rank);
+        for(const auto& index : overlapping_tiles(trange_, lower, upper)) {
+          const size_type ordinal = trange_.tiles_range().ordinal(index);
+          const auto range = trange_.make_tile_range(ordinal);
+          for(std::size_t d = 0ul; d < rank; ++d) {
+            part_lower[d] = std::max<std::size_t>(lower[d], range.lobound()[d]);
+            part_upper[d] = std::min<std::size_t>(upper[d], range.upbound()[d]);
+          }
+
+          const Tile part(tile.block(part_lower, part_upper));
+          const ProcessID dest = pmap_->owner(ordinal);
+          if(dest == WorldObject_::get_world().rank())
+            insert(ordinal, part);
+          else
+            WorldObject_::send(dest, & Retiler_::insert, ordinal, part);
+        }
+      }
+
+      /// Local tiles of the new tiled range
+
+      /// \return The ordinal indices and the data of the local new tiles that
+      /// overlap a non-zero source tile
+      /// \note All parts must have arrived, e.g. after a fence.
+      std::vector<std::pair<size_type, Tile> > tiles() const {
+        std::vector<std::pair<size_type, Tile> > result;
+        result.reserve(targets_.size());
+        for(const auto& target : targets_) {
+          TA_ASSERT(target.second.parts == 0);
+          result.emplace_back(target.first, target.second.tile);
+        }
+        return result;
+      }
+
+    }; // class Retiler
+
+    /// Task function that scatters a source tile into the new tiles
+
+    /// \tparam Tile The tile type
+    /// \param retiler The retiler
+    /// \param tile The source tile
+    template <typename Tile>
+    void retile_scatter(Retiler<Tile>* retiler, const Tile& tile) {
+      retiler->scatter(tile);
+    }
+
+    /// Construct a retiled dense array from its local tiles
+    template <typename Array,
+        typename std::enable_if<is_dense<Array>::value>::type* = nullptr>
+    inline Array make_retiled_array(World& world, const TiledRange& trange,
+        const std::shared_ptr<Pmap>& pmap,
+        const std::vector<std::pair<std::size_t, typename Array::value_type> >& tiles)
+    {
+      Array result(world, trange, pmap);
+      for(const auto& tile : tiles)
+        result.set(tile.first, tile.second);
+      return result;
+    }
+
+    /// Construct a retiled sparse array from its local tiles
+
+    /// The shape is computed from the norms of the new tiles.
+    template <typename Array,
+        typename std::enable_if<! is_dense<Array>::value>::type* = nullptr>
+    inline Array make_retiled_array(World& world, const TiledRange& trange,
+        const std::shared_ptr<Pmap>& pmap,
+        const std::vector<std::pair<std::size_t, typename Array::value_type> >& tiles)
+    {
+      typedef typename Array::shape_type shape_type;
+      Tensor<typename shape_type::value_type> tile_norms(trange.tiles_range(), 0);
+      for(const auto& tile : tiles)
+        tile_norms[tile.first] = tile.second.norm();
+
+      Array result(world, trange, shape_type(world, tile_norms, trange), pmap);
+      for(const auto& tile : tiles)
+        if(! result.is_zero(tile.first))
+          result.set(tile.first, tile.second);
+      return result;
+    }
+
+  } // namespace detail
+
+  /// Copy an array into an array with a different tiled range
+
+  /// The tiled ranges must cover the same elements. Each process splits its
+  /// local tiles at the new tile boundaries and sends each part directly to
+  /// the owner of the new tile that holds it, so every element is moved at
+  /// most once, and not at all when the old and new tile are owned by the
+  /// same process. Zero tiles of a sparse array are not sent, and the shape
+  /// of the result is computed from the norms of the new tiles. This is a
+  /// collective operation.
+  /// \tparam Tile The array tile type, which must support \c block()
+  /// \tparam Policy The array policy type
+  /// \param array The array to be retiled
+  /// \param trange The tiled range of the result
+  /// \param pmap The process map of the result [default = the default process
+  /// map of \c Policy ]
+  /// \return A copy of \c array with the tiled range \c trange
+  /// \throw TiledArray::Exception When \c array and \c trange do not cover the
+  /// same elements.
+  template <typename Tile, typename Policy>
+  inline DistArray<Tile, Policy>
+  retile(const DistArray<Tile, Policy>& array, const TiledRange& trange,
+      std::shared_ptr<typename DistArray<Tile, Policy>::pmap_interface> pmap =
+          std::shared_ptr<typename DistArray<Tile, Policy>::pmap_interface>())
+  {
+    TA_USER_ASSERT(array.trange().elements_range() == trange.elements_range(),
+        "TiledArray::retile(): The tiled ranges do not cover the same elements.");
+
+    World& world = array.world();
+    if(! pmap)
+      pmap = Policy::default_pmap(world, trange.tiles_range().volume());
+
+    // Send the parts of the local tiles to the owners of the new tiles
+    detail::Retiler<Tile> retiler(world, array.trange(), array.shape(), trange, pmap);
+    for(const auto index : *array.pmap()) {
+      if(array.is_zero(index))
+        continue;
+      world.taskq.add(& detail::retile_scatter<Tile>, &retiler, array.find(index));
+    }
+
+    // Wait for all parts to arrive
+    world.gop.fence();
+
+    return detail::make_retiled_array<DistArray<Tile, Policy> >(world, trange,
+        pmap, retiler.tiles());
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_CONVERSIONS_RETILE_H__INCLUDED
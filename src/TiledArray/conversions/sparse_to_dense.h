@@ -30,32 +30,71 @@
 
 namespace TiledArray {
 
-  template <typename Tile>
-  DistArray<Tile, DensePolicy>
-  to_dense(DistArray<Tile, SparsePolicy> const& sparse_array) {
-      typedef DistArray<Tile, DensePolicy> ArrayType;
-      ArrayType dense_array(sparse_array.world(), sparse_array.trange());
+  namespace detail {
 
-      typedef typename ArrayType::pmap_interface pmap_interface;
-      std::shared_ptr<pmap_interface> const& pmap = dense_array.pmap();
+    /// Convert a block sparse array into a dense array
 
-      typename pmap_interface::const_iterator end = pmap->end();
+    /// The non-zero tiles of the result are set to the futures given by
+    /// \c make_tile , and the zero tiles are constructed by tasks, so no tile
+    /// is waited on or filled by the calling thread.
+    /// \tparam Tile The tile type
+    /// \tparam Op The tile conversion operation type
+    /// \param sparse_array The sparse array
+    /// \param make_tile The operation that makes a result tile future from a
+    /// source tile future
+    /// \return A dense array with the same process map as \c sparse_array
+    template <typename Tile, typename Op>
+    DistArray<Tile, DensePolicy>
+    sparse_to_dense(const DistArray<Tile, SparsePolicy>& sparse_array, const Op& make_tile) {
+      typedef DistArray<Tile, DensePolicy> ArrayType;
+      World& world = sparse_array.world();
+      ArrayType dense_array(world, sparse_array.trange(), sparse_array.pmap());
 
       // iterate over sparse tiles
-      for (typename pmap_interface::const_iterator it = pmap->begin(); it != end;
-           ++it) {
-          const std::size_t ord = *it;
-          if (!sparse_array.is_zero(ord)) {
-              // clone because tiles are shallow copied
-              Tile tile(sparse_array.find(ord).get().clone());
-              dense_array.set(ord, tile);
-          } else {
-              // see DistArray::set(ordinal, element_type)
-              dense_array.set(ord, 0);
-          }
+      for(auto ord : * dense_array.pmap()) {
+        if(! sparse_array.is_zero(ord)) {
+          dense_array.set(ord, make_tile(sparse_array.find(ord)));
+        } else {
+          // see DistArray::set(ordinal, element_type)
+          const auto range = dense_array.trange().make_tile_range(ord);
+          dense_array.set(ord, world.taskq.add([range] () -> Tile {
+            return Tile(range, 0);
+          }));
+        }
       }
 
       return dense_array;
+    }
+
+  } // namespace detail
+
+  /// Function to convert a block sparse array into a dense array
+
+  /// The significant tiles are cloned, and the zero tiles are filled, by tasks.
+  template <typename Tile>
+  DistArray<Tile, DensePolicy>
+  to_dense(DistArray<Tile, SparsePolicy> const& sparse_array) {
+      World& world = sparse_array.world();
+
+      // lazily clone because tiles are shallow copied
+      return detail::sparse_to_dense(sparse_array, [&world] (const Future<Tile>& tile) {
+        return world.taskq.add([] (const Tile& tile) -> Tile {
+          using TiledArray::lazy_clone;
+          return lazy_clone(tile);
+        }, tile);
+      });
+  }
+
+  /// Function to convert a temporary block sparse array into a dense array
+
+  /// The significant tiles are moved into the dense array without a copy.
+  /// \note The tiles of \c sparse_array must not be shared with another array
+  /// (e.g. a shallow copy of \c sparse_array ), since the result references them.
+  template <typename Tile>
+  DistArray<Tile, DensePolicy>
+  to_dense(DistArray<Tile, SparsePolicy>&& sparse_array) {
+      return detail::sparse_to_dense(sparse_array,
+          [] (const Future<Tile>& tile) { return tile; });
   }
 
   // If array is already dense just use the copy constructor.
@@ -29,42 +29,147 @@
 #include "../dist_array.h"
 
 namespace TiledArray {
+  namespace detail {
 
-  /// Function to convert an array to a new array with a different tile type.
+    /// Convert a chunk of tiles
 
-  /// \tparam Tile The array tile type
-  /// \tparam Policy The array policy type
-  /// \tparam Op The tile conversion operation type
-  /// \param array The array to be converted
-  /// \param op The tile type conversion operation
-  template <typename Tile, typename Policy, typename Op>
-  inline DistArray<typename std::result_of<Op(Tile)>::type, Policy>
-  to_new_tile_type(DistArray<Tile, Policy> const &old_array, Op &&op) {
-    using OutTileType = typename std::result_of<Op(Tile)>::type;
-    using OutArray = DistArray<OutTileType, Policy>;
+    /// \tparam OutArray The result array type
+    /// \tparam Op The tile conversion operation type
+    /// \tparam Tile The argument tile type
+    /// \param result The result array
+    /// \param op The tile conversion operation
+    /// \param indices The indices of the tiles
+    /// \param tiles The argument tiles
+    /// \param consume If \c true , the argument tiles are moved into \c op
+    template <typename OutArray, typename Op, typename Tile>
+    void to_new_tile_type_chunk(OutArray result, const std::shared_ptr<Op>& op,
+        const std::vector<typename OutArray::size_type>& indices,
+        const std::vector<Future<Tile> >& tiles, const bool consume)
+    {
+      std::vector<typename OutArray::value_type> results;
+      results.reserve(tiles.size());
+      for(Future<Tile> tile : tiles) {
+        if(consume)
+          results.push_back((*op)(std::move(tile.get())));
+        else
+          results.push_back((*op)(static_cast<const Tile&>(tile.get())));
+      }
+      result.pimpl()->set(indices, results);
+    }
 
-    static_assert(!std::is_same<Tile, OutTileType>::value,
-        "Can't call new tile type if tile type does not change.");
+    /// Convert an array to a new array with a different tile type
 
-    auto &world = old_array.world();
+    /// The local tiles are divided into chunks, and each chunk is converted
+    /// by one task once its tiles are ready.
+    /// \tparam Tile The array tile type
+    /// \tparam Policy The array policy type
+    /// \tparam Op The tile conversion operation type
+    /// \param old_array The array to be converted
+    /// \param op The tile type conversion operation
+    /// \param chunk_size The number of tiles in a chunk, or zero to make four
+    /// chunks per thread
+    /// \param consume If \c true , the tiles of \c old_array are moved into
+    /// \c op
+    /// \return The converted array
+    template <typename Tile, typename Policy, typename Op>
+    inline DistArray<typename std::result_of<Op(Tile)>::type, Policy>
+    to_new_tile_type(const DistArray<Tile, Policy>& old_array, Op&& op,
+        typename DistArray<Tile, Policy>::size_type chunk_size, const bool consume)
+    {
+      using OutTileType = typename std::result_of<Op(Tile)>::type;
+      using OutArray = DistArray<OutTileType, Policy>;
+      using size_type = typename OutArray::size_type;
 
-    // Create new array
-    OutArray new_array(world, old_array.trange(), old_array.shape(), old_array.pmap());
+      static_assert(!std::is_same<Tile, OutTileType>::value,
+          "Can't call new tile type if tile type does not change.");
 
-    using pmap_iter = decltype(old_array.pmap()->begin());
-    pmap_iter it = old_array.pmap()->begin();
-    pmap_iter end = old_array.pmap()->end();
+      auto &world = old_array.world();
 
-    for(; it != end; ++it) {
-      // Must check for zero because pmap_iter does not.
-      if(!old_array.is_zero(*it)) {
-        // Spawn a task to evaluate the tile
-        Future<OutTileType> tile = world.taskq.add(op, old_array.find(*it));
-        new_array.set(*it, tile);
+      // Create new array
+      OutArray new_array(world, old_array.trange(), old_array.shape(), old_array.pmap());
+
+      // Collect the local tiles. Must check for zero because pmap_iter does not.
+      std::vector<size_type> indices;
+      std::vector<Future<Tile> > tiles;
+      indices.reserve(old_array.pmap()->local_size());
+      tiles.reserve(old_array.pmap()->local_size());
+      for(const auto index : * old_array.pmap()) {
+        if(! old_array.is_zero(index)) {
+          indices.push_back(index);
+          tiles.push_back(old_array.find(index));
+        }
+      }
+      if(indices.empty())
+        return new_array;
+
+      if(chunk_size == 0ul) {
+        const size_type chunks = 4ul * (madness::ThreadPool::size() + 1ul);
+        chunk_size = std::max<size_type>((indices.size() + chunks - 1ul) / chunks, 1ul);
       }
+
+      // Spawn a task to convert each chunk of tiles
+      typedef typename std::decay<Op>::type op_type;
+      const std::shared_ptr<op_type> shared_op =
+          std::make_shared<op_type>(std::forward<Op>(op));
+      for(size_type first = 0ul; first < indices.size(); first += chunk_size) {
+        const size_type last = std::min(first + chunk_size, indices.size());
+        world.taskq.add(& to_new_tile_type_chunk<OutArray, op_type, Tile>,
+            new_array, shared_op,
+            std::vector<size_type>(indices.begin() + first, indices.begin() + last),
+            std::vector<Future<Tile> >(tiles.begin() + first, tiles.begin() + last),
+            consume);
+      }
+
+      return new_array;
     }
 
-    return new_array;
+  } // namespace detail
+
+  /// Function to convert an array to a new array with a different tile type.
+
+  /// The tiles are converted in chunks by tasks, which are run when the tiles
+  /// of a chunk are ready.
+  /// \tparam Tile The array tile type
+  /// \tparam Policy The array policy type
+  /// \tparam Op The tile conversion operation type
+  /// \param old_array The array to be converted
+  /// \param op The tile type conversion operation, which must be thread safe
+  /// \param chunk_size The number of tiles in a chunk, or zero to make four
+  /// chunks per thread
+  template <typename Tile, typename Policy, typename Op>
+  inline DistArray<typename std::result_of<Op(Tile)>::type, Policy>
+  to_new_tile_type(DistArray<Tile, Policy> const &old_array, Op &&op,
+      const typename DistArray<Tile, Policy>::size_type chunk_size = 0ul)
+  {
+    return detail::to_new_tile_type(old_array, std::forward<Op>(op),
+        chunk_size, false);
+  }
+
+  /// Function to convert a temporary array to a new array with a different tile type.
+
+  /// The tiles of \c old_array are moved into \c op , e.g. a conversion from
+  /// \c Tensor<double> to \c Tile<Tensor<double>> takes the tile data
+  /// without a copy, and a conversion to a compressed tile releases each
+  /// argument tile once it is converted. The tiles are only moved when
+  /// \c old_array holds the only reference to its data; otherwise they are
+  /// passed to \c op as const references.
+  /// \tparam Tile The array tile type
+  /// \tparam Policy The array policy type
+  /// \tparam Op The tile conversion operation type
+  /// \param old_array The array to be converted
+  /// \param op The tile type conversion operation, which must be thread safe
+  /// \param chunk_size The number of tiles in a chunk, or zero to make four
+  /// chunks per thread
+  /// \note The tiles of \c old_array must not be shared with another array,
+  /// e.g. through a tile that was set in both arrays.
+  template <typename Tile, typename Policy, typename Op>
+  inline DistArray<typename std::result_of<Op(Tile)>::type, Policy>
+  to_new_tile_type(DistArray<Tile, Policy>&& old_array, Op &&op,
+      const typename DistArray<Tile, Policy>::size_type chunk_size = 0ul)
+  {
+    const bool consume = old_array.pimpl() && (old_array.pimpl().use_count() == 1l);
+    return detail::to_new_tile_type(old_array, std::forward<Op>(op),
+        chunk_size, consume);
   }
 
 } // namespace TiledArray
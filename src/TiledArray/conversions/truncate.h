@@ -27,6 +27,7 @@
 #define TILEDARRAY_CONVERSIONS_TRUNCATE_H__INCLUDED
 
 #include <TiledArray/conversions/foreach.h>
+#include <vector>
 
 namespace TiledArray {
 
@@ -45,17 +46,40 @@ namespace TiledArray {
 
   /// Truncate a sparse Array
 
+  /// The norms of the local non-zero tiles are computed by tasks, and the
+  /// new shape is built from them with a single reduction. The array is
+  /// modified in place: the shape is replaced, and only the tiles that become
+  /// zero are erased, so no tiles are copied and no new array is constructed.
+  /// \note This function is collective. All shallow copies of \c array are
+  /// truncated, and no other operation may access the array meanwhile.
   /// \tparam Tile The tile type of the array
   /// \param[in,out] array The array object to be truncated
   template <typename Tile>
   inline void truncate(DistArray<Tile, SparsePolicy>& array) {
     typedef typename DistArray<Tile, SparsePolicy>::value_type value_type;
-    array =
-        foreach(array, [] (value_type& result_tile, const value_type& arg_tile) {
-          typename detail::scalar_type<value_type>::type norm = arg_tile.norm();
-          result_tile = arg_tile; // Assume this is shallow copy
-          return norm;
-        });
+    typedef typename DistArray<Tile, SparsePolicy>::shape_type shape_type;
+    typedef typename shape_type::value_type norm_type;
+
+    World& world = array.world();
+
+    // Spawn a task to compute the norm of each local non-zero tile. Each task
+    // writes a different element of tile_norms.
+    Tensor<norm_type> tile_norms(array.trange().tiles_range(), 0);
+    norm_type* const norms_data = tile_norms.data();
+    std::vector<Future<bool> > norms;
+    for(auto index : * array.pmap()) {
+      if(array.is_zero(index))
+        continue;
+      norms.push_back(world.taskq.add([norms_data, index] (const value_type& tile) {
+            norms_data[index] = tile.norm();
+            return true;
+          }, array.find(index)));
+    }
+    for(auto& norm : norms)
+      norm.get();
+
+    // The shape constructor reduces the norms of all processes
+    array.pimpl()->truncate(shape_type(world, tile_norms, array.trange()));
   }
 
 } // namespace TiledArray
@@ -43,6 +43,7 @@ namespace TiledArray {
   } // namespace math
   class Range;
   class Permutation;
+  class TiledRange;
   using madness::World;
 
 
@@ -117,6 +118,8 @@ namespace TiledArray {
 
     static DenseShape perm(const Permutation&) { return DenseShape(); }
 
+    static DenseShape reshape(const TiledRange&) { return DenseShape(); }
+
     template <typename Scalar>
     static DenseShape scale(const Scalar) { return DenseShape(); }
 
@@ -173,6 +176,12 @@ namespace TiledArray {
     static DenseShape gemm(const DenseShape&, const Scalar, const math::GemmHelper&, const Permutation&)
     { return DenseShape(); }
 
+    /// Serialization function
+
+    /// No operation since there is no data.
+    template <typename Archive>
+    void serialize(const Archive&) { }
+
   }; // class DenseShape
 
 } // namespace TiledArray
@@ -0,0 +1,373 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  direct_tile.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_DIRECT_TILE_H__INCLUDED
+#define TILEDARRAY_DIRECT_TILE_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Tile that is generated when it is used
+
+  /// A direct tile holds the range of the tile and a generator function. It
+  /// is a lazy tile (see \c eval_trait ), so arrays of direct tiles may be
+  /// used as arguments in expressions, and the data of each tile is
+  /// generated by the owner of the tile only when the expression needs it,
+  /// e.g. when it is broadcast in a SUMMA iteration. The generated tile is
+  /// released when the expression is done with it, so the data of the array
+  /// is never stored. This is the integral-direct approach for operands that
+  /// are too large to be stored, at the cost of generating each tile once
+  /// per expression that uses it; \c DirectTileCache keeps recently generated
+  /// tiles to avoid regenerating them.
+  /// \tparam T The generated tile type
+  /// \note Direct tiles cannot be sent to another process.
+  template <typename T>
+  class DirectTile {
+  public:
+    typedef DirectTile<T> DirectTile_; ///< This object type
+    typedef T eval_type; ///< The generated tile type
+    typedef typename T::value_type value_type; ///< The element type
+    typedef typename T::numeric_type numeric_type; ///< The numeric type
+    typedef typename T::range_type range_type; ///< The range type
+    typedef std::function<eval_type(const range_type&)> generator_type; ///< The generator type
+
+  private:
+    range_type range_; ///< The tile range
+    std::shared_ptr<const generator_type> generator_; ///< The tile generator
+
+  public:
+
+    DirectTile() = default;
+    DirectTile(const DirectTile_&) = default;
+    DirectTile(DirectTile_&&) = default;
+    DirectTile_& operator=(const DirectTile_&) = default;
+    DirectTile_& operator=(DirectTile_&&) = default;
+
+    /// Constructor
+
+    /// \param range The tile range
+    /// \param generator The function that generates the tile from its range,
+    /// which may be called concurrently by several threads
+    DirectTile(const range_type& range,
+        const std::shared_ptr<const generator_type>& generator) :
+      range_(range), generator_(generator)
+    { }
+
+    /// Tile range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// Check for an empty tile
+
+    /// \return \c true if this tile has no generator
+    bool empty() const { return ! generator_; }
+
+    /// Generate the tile
+
+    /// \return The tile data
+    eval_type eval() const {
+      TA_ASSERT(generator_);
+      return (*generator_)(range_);
+    }
+
+    /// Convert tile to evaluation type
+    operator eval_type() const { return eval(); }
+
+    /// Serialization (not supported)
+
+    /// \tparam Archive The archive type
+    /// \throw TiledArray::Exception Always
+    template <typename Archive>
+    void serialize(const Archive&) {
+      TA_EXCEPTION("DirectTile cannot be serialized.");
+    }
+
+  }; // class DirectTile
+
+  /// Construct an array of direct tiles
+
+  /// Each local non-zero tile of the result is a \c DirectTile that generates
+  /// its data with \c gen when it is used in an expression, e.g.
+  /// \code
+  /// typedef TiledArray::DistArray<TiledArray::DirectTile<TiledArray::TensorD> > DirectArray;
+  /// DirectArray g = make_direct_array<DirectArray>(world, trange,
+  ///     [] (const TiledArray::Range& range) {
+  ///       TiledArray::TensorD tile(range);
+  ///       // compute the integrals of range
+  ///       return tile;
+  ///     });
+  /// r("a,b,i,j") = g("a,b,c,d") * t("c,d,i,j");
+  /// \endcode
+  /// The shape of a sparse array, e.g. from integral screening, must be given
+  /// since the tiles are not generated when the array is constructed.
+  /// \tparam Array The array type, which has \c DirectTile tiles
+  /// \tparam Gen The generator type, with the signature
+  /// <tt>eval_type(const range_type&)</tt>
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the array
+  /// \param gen The tile generator, which may be called concurrently by
+  /// several threads
+  /// \param shape The shape of the array [default = dense shape]
+  /// \param pmap The process map of the array [default = the default process
+  /// map of the array policy]
+  /// \return An array whose tiles are generated by \c gen
+  template <typename Array, typename Gen>
+  inline Array make_direct_array(World& world,
+      const typename Array::trange_type& trange, Gen&& gen,
+      const typename Array::shape_type& shape = typename Array::shape_type(),
+      const std::shared_ptr<typename Array::pmap_interface>& pmap =
+          std::shared_ptr<typename Array::pmap_interface>())
+  {
+    typedef typename Array::value_type tile_type;
+    typedef typename tile_type::generator_type generator_type;
+
+    const std::shared_ptr<const generator_type> generator =
+        std::make_shared<const generator_type>(std::forward<Gen>(gen));
+
+    Array result(world, trange, shape, pmap);
+    for(const auto index : *result.pmap())
+      if(! result.is_zero(index))
+        result.set(index, tile_type(trange.make_tile_range(index), generator));
+
+    return result;
+  }
+
+  /// Memoizing tile generator
+
+  /// Direct tiles are generated each time they are used, so a tile that is
+  /// used by several expressions is generated several times. A
+  /// \c DirectTileCache wraps a generator and keeps the generated tiles of
+  /// this process in a least-recently-used (LRU) cache whose tiles hold at
+  /// most \c capacity() bytes; the least recently used tiles are dropped
+  /// when the cache is full. The capacity trades memory against
+  /// recomputation: zero disables the cache, and a capacity larger than the
+  /// local tiles of the array stores every tile after its first use. The
+  /// cache counts the tiles that are found (hits) and generated (misses).
+  /// \code
+  /// auto cache = std::make_shared<DirectTileCache<TiledArray::TensorD> >(
+  ///     [] (const TiledArray::Range& range) { ... }, 1ul << 30);
+  /// DirectArray g = make_cached_direct_array<DirectArray>(world, trange, cache);
+  /// \endcode
+  /// Tiles are copied out of the cache, since expressions may modify the
+  /// tiles they are given.
+  /// \tparam T The generated tile type
+  template <typename T>
+  class DirectTileCache {
+  public:
+    typedef DirectTileCache<T> DirectTileCache_; ///< This object type
+    typedef T eval_type; ///< The generated tile type
+    typedef typename T::numeric_type numeric_type; ///< The numeric type
+    typedef typename T::range_type range_type; ///< The range type
+    typedef typename DirectTile<T>::generator_type generator_type; ///< The generator type
+    typedef std::size_t size_type; ///< Size type
+
+  private:
+
+    typedef std::vector<size_type> key_type; ///< The lower bound of a tile
+    typedef std::list<key_type> list_type;
+
+    /// A cached tile
+    struct Entry {
+      eval_type tile; ///< The tile
+      typename list_type::iterator position; ///< The position of the tile in the LRU list
+    }; // struct Entry
+
+    const generator_type generator_; ///< The tile generator
+    mutable std::mutex lock_; ///< Lock for the cache
+    size_type capacity_; ///< The maximum number of bytes held by cached tiles
+    size_type bytes_; ///< The number of bytes held by cached tiles
+    size_type hits_; ///< The number of tiles found in the cache
+    size_type misses_; ///< The number of generated tiles
+    list_type lru_; ///< The cached tiles, from the most to least recently used
+    std::map<key_type, Entry> tiles_; ///< The cached tiles
+
+    DirectTileCache(const DirectTileCache_&) = delete;
+    DirectTileCache_& operator=(const DirectTileCache_&) = delete;
+
+    /// The size of a tile
+
+    /// \param range The range of the tile
+    /// \return The number of bytes of the tile elements
+    static size_type tile_bytes(const range_type& range) {
+      return range.volume() * sizeof(numeric_type);
+    }
+
+    /// Drop the least recently used tiles until the cache fits in its capacity
+
+    /// \note The caller must hold \c lock_ .
+    void evict() {
+      while(bytes_ > capacity_) {
+        auto it = tiles_.find(lru_.back());
+        bytes_ -= tile_bytes(it->second.tile.range());
+        tiles_.erase(it);
+        lru_.pop_back();
+      }
+    }
+
+  public:
+
+    /// Constructor
+
+    /// \tparam Gen The generator type, with the signature
+    /// <tt>eval_type(const range_type&)</tt>
+    /// \param gen The tile generator, which may be called concurrently by
+    /// several threads
+    /// \param capacity The maximum number of bytes held by cached tiles; the
+    /// default is the value of the \c TA_DIRECT_TILE_CACHE environment
+    /// variable, or zero
+    template <typename Gen>
+    explicit DirectTileCache(Gen&& gen,
+        const size_type capacity = (getenv("TA_DIRECT_TILE_CACHE") ?
+            std::strtoul(getenv("TA_DIRECT_TILE_CACHE"), nullptr, 10) : 0ul)) :
+      generator_(std::forward<Gen>(gen)), lock_(), capacity_(capacity),
+      bytes_(0ul), hits_(0ul), misses_(0ul), lru_(), tiles_()
+    { }
+
+    /// Get a tile
+
+    /// The tile is copied from the cache, or generated and cached.
+    /// \param range The range of the tile
+    /// \return The tile of \c range
+    eval_type operator()(const range_type& range) {
+      const key_type key(range.lobound_data(), range.lobound_data() + range.rank());
+      {
+        std::lock_guard<std::mutex> locker(lock_);
+        auto it = tiles_.find(key);
+        if(it != tiles_.end()) {
+          ++hits_;
+          lru_.splice(lru_.begin(), lru_, it->second.position);
+          return it->second.tile.clone();
+        }
+        ++misses_;
+      }
+
+      // Generate the tile without the lock, so tiles are generated
+      // concurrently
+      eval_type tile = generator_(range);
+      const size_type bytes = tile_bytes(range);
+
+      std::lock_guard<std::mutex> locker(lock_);
+      if((bytes <= capacity_) && (tiles_.find(key) == tiles_.end())) {
+        lru_.push_front(key);
+        tiles_.emplace(key, Entry{ tile.clone(), lru_.begin() });
+        bytes_ += bytes;
+        evict();
+      }
+      return tile;
+    }
+
+    /// \return The maximum number of bytes held by cached tiles
+    size_type capacity() const {
+      std::lock_guard<std::mutex> locker(lock_);
+      return capacity_;
+    }
+
+    /// Set the capacity
+
+    /// The least recently used tiles are dropped if the cached tiles do not
+    /// fit in the new capacity.
+    /// \param capacity The maximum number of bytes held by cached tiles, or
+    /// zero to disable the cache
+    void capacity(const size_type capacity) {
+      std::lock_guard<std::mutex> locker(lock_);
+      capacity_ = capacity;
+      evict();
+    }
+
+    /// \return The number of bytes held by cached tiles
+    size_type bytes() const {
+      std::lock_guard<std::mutex> locker(lock_);
+      return bytes_;
+    }
+
+    /// \return The number of cached tiles
+    size_type size() const {
+      std::lock_guard<std::mutex> locker(lock_);
+      return tiles_.size();
+    }
+
+    /// \return The number of tiles that were found in the cache
+    size_type hits() const {
+      std::lock_guard<std::mutex> locker(lock_);
+      return hits_;
+    }
+
+    /// \return The number of tiles that were generated
+    size_type misses() const {
+      std::lock_guard<std::mutex> locker(lock_);
+      return misses_;
+    }
+
+    /// Drop all cached tiles and reset the statistics
+    void clear() {
+      std::lock_guard<std::mutex> locker(lock_);
+      lru_.clear();
+      tiles_.clear();
+      bytes_ = hits_ = misses_ = 0ul;
+    }
+
+  }; // class DirectTileCache
+
+  /// Construct an array of direct tiles with memoized generation
+
+  /// The same as \c make_direct_array() , except that the tiles are taken
+  /// from \c cache , so tiles that are used again are not regenerated while
+  /// they are cached.
+  /// \tparam Array The array type, which has \c DirectTile tiles
+  /// \param world The world where the array will live
+  /// \param trange The tiled range of the array
+  /// \param cache The tile cache, which must not be shared with arrays of
+  /// another tiled range
+  /// \param shape The shape of the array [default = dense shape]
+  /// \param pmap The process map of the array [default = the default process
+  /// map of the array policy]
+  /// \return An array whose tiles are taken from \c cache
+  template <typename Array>
+  inline Array make_cached_direct_array(World& world,
+      const typename Array::trange_type& trange,
+      const std::shared_ptr<DirectTileCache<typename Array::value_type::eval_type> >& cache,
+      const typename Array::shape_type& shape = typename Array::shape_type(),
+      const std::shared_ptr<typename Array::pmap_interface>& pmap =
+          std::shared_ptr<typename Array::pmap_interface>())
+  {
+    typedef typename Array::value_type::eval_type eval_type;
+    typedef typename Array::value_type::range_type range_type;
+    TA_USER_ASSERT(cache, "make_cached_direct_array(): The cache is null.");
+    return make_direct_array<Array>(world, trange,
+        [cache] (const range_type& range) -> eval_type { return (*cache)(range); },
+        shape, pmap);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DIRECT_TILE_H__INCLUDED
@@ -21,12 +21,16 @@
 #define TILEDARRAY_ARRAY_H__INCLUDED
 
 #include <TiledArray/replicator.h>
+#include <TiledArray/node_replicator.h>
 #include <TiledArray/pmap/replicated_pmap.h>
 //#include <TiledArray/tensor.h>
 #include <TiledArray/policies/dense_policy.h>
 #include <TiledArray/array_impl.h>
+#include <TiledArray/tile_prefetch.h>
+#include <TiledArray/memory_governor.h>
 #include <TiledArray/conversions/truncate.h>
 #include <TiledArray/conversions/clone.h>
+#include <algorithm>
 
 namespace TiledArray {
 
@@ -34,6 +38,7 @@ namespace TiledArray {
   template <typename, typename> class Tensor;
   namespace expressions {
     template <typename, bool> class TsrExpr;
+    template <char...> struct IndexList;
   } // namespace expressions
 
 
@@ -75,7 +80,15 @@ namespace TiledArray {
     /// Array deleter function
 
     /// This function schedules a task for lazy cleanup. Array objects are
-    /// deleted only after the object has been deleted in all processes.
+    /// deleted only after the object has been deleted in all processes. The
+    /// release is reference counted over the processes with
+    /// \c lazy_sync , which runs the deletion as soon as the last process
+    /// has released its reference, without a fence. An object that cannot
+    /// receive messages from other processes, i.e. of a world with one
+    /// process or with a replicated process map, is deleted by a local task
+    /// instead; this avoids the synchronization messages of the many
+    /// temporary arrays of expressions, and the memory of a replicated array
+    /// is not held until the slowest process releases it.
     /// \param pimpl The implementation pointer to be deleted.
     static void lazy_deleter(const impl_type* const pimpl) {
       if(pimpl) {
@@ -85,10 +98,14 @@ namespace TiledArray {
           cleanup_counter_++;
 
           try {
-            world.gop.lazy_sync(id, [pimpl]() {
+            auto cleanup = [pimpl]() {
               delete pimpl;
               DistArray_::cleanup_counter_--;
-            });
+            };
+            if((world.size() > 1) && ! pimpl->pmap()->is_replicated())
+              world.gop.lazy_sync(id, cleanup);
+            else
+              world.taskq.add(cleanup);
           }
           catch(madness::MadnessException& e) {
             fprintf(stderr, "!! ERROR TiledArray: madness::MadnessException thrown in Array::lazy_deleter().\n"
@@ -266,6 +283,11 @@ namespace TiledArray {
     /// should not rely on this function.
     madness::uniqueidT id() const { return pimpl_->id(); }
 
+    /// Array implementation accessor
+
+    /// \return A const reference to the pointer to the array implementation
+    const std::shared_ptr<impl_type>& pimpl() const { return pimpl_; }
+
     /// Begin iterator factory function
 
     /// \return An iterator to the first local tile.
@@ -321,6 +343,39 @@ namespace TiledArray {
       return find<std::initializer_list<Integer>>(i);
     }
 
+    /// Prefetch local or remote tiles
+
+    /// Starts the gets of a set of tiles and caches them in the returned
+    /// object until it is destroyed. The requests for remote tiles are
+    /// aggregated, so one message is sent to each owner instead of one per
+    /// tile. Zero tiles are skipped.
+    /// \code
+    /// {
+    ///   auto tiles = array.prefetch(array.trange().tiles_range());
+    ///   // ...
+    ///   auto tile = tiles.find(i).get();
+    /// } // prefetched tiles are released here
+    /// \endcode
+    /// \tparam Indices A sequence of tile indices or ordinals, e.g. a tile
+    /// range or a \c std::vector
+    /// \param indices The tiles to be prefetched
+    /// \return The cache of the prefetched tiles
+    template <typename Indices>
+    TilePrefetch<DistArray_> prefetch(const Indices& indices) const {
+      check_pimpl();
+      std::vector<size_type> ords;
+      for(const auto& i : indices) {
+        check_index(i);
+        const size_type ord = pimpl_->trange().tiles_range().ordinal(i);
+        if(! pimpl_->is_zero(ord))
+          ords.push_back(ord);
+      }
+      std::sort(ords.begin(), ords.end());
+      ords.erase(std::unique(ords.begin(), ords.end()), ords.end());
+
+      return TilePrefetch<DistArray_>(*this, ords, pimpl_->get(ords));
+    }
+
     /// Set a tile and fill it using a sequence
 
     /// \tparam Index An index or integral type
@@ -413,12 +468,38 @@ namespace TiledArray {
       set<std::initializer_list<Integer>>(i, v);
     }
 
+    /// Set a batch of tiles using Tile objects
+
+    /// This is equivalent to calling \c set(i,v) for each tile, except that
+    /// the tiles owned by other processes are aggregated and sent to each
+    /// owner in a few large messages instead of one message per tile. Use it
+    /// when many small tiles are computed away from their owners.
+    /// \tparam Index An index or integral type
+    /// \param indices The indices or the ordinals of the tiles to be set
+    /// \param tiles The tile values, where <tt>tiles[j]</tt> is the value of
+    /// tile <tt>indices[j]</tt>
+    template <typename Index>
+    void set(const std::vector<Index>& indices,
+        const std::vector<value_type>& tiles)
+    {
+      check_pimpl();
+      TA_USER_ASSERT(indices.size() == tiles.size(),
+          "The number of tiles does not match the number of tile indices.");
+      std::vector<size_type> ords;
+      ords.reserve(indices.size());
+      for(const auto& i : indices) {
+        check_index(i);
+        ords.push_back(pimpl_->trange().tiles_range().ordinal(i));
+      }
+      pimpl_->set(ords, tiles);
+    }
+
     /// Fill all local tiles
 
     /// \param value The fill value
     /// \param skip_set If false, will throw if any tiles are already set
     void fill_local(const element_type& value = element_type(), bool skip_set = false) {
-      init_tiles([=] (const range_type& range)
+      init_tiles_bulk([=] (const range_type& range)
           { return value_type(range, value); }, skip_set);
     }
 
@@ -474,7 +555,8 @@ namespace TiledArray {
             if (fut.probe())
               continue;
           }
-          Future<value_type> tile = pimpl_->world().taskq.add(
+          Future<value_type> tile = detail::governed_task(pimpl_->world(),
+              detail::tile_memory<value_type>(trange().make_tile_range(index)),
               [] (DistArray_& array, const size_type index, const Op& op) -> value_type
               { return op(array.trange().make_tile_range(index)); },
               *this, index, op);
@@ -483,6 +565,78 @@ namespace TiledArray {
       }
     }
 
+    /// Initialize tiles in chunks with a user provided functor
+
+    /// This function is equivalent to \c init_tiles() , but it is intended for
+    /// arrays with many small local tiles, for which the creation of one task
+    /// and one future per tile dominates the cost. The local non-zero tiles
+    /// are divided into chunks of consecutive tiles, and one task per chunk
+    /// generates the tiles and inserts them with a single batched \c set() .
+    /// The chunks are scheduled by the task queue, so idle threads pick up
+    /// the remaining chunks. Tiles may be accessed with \c find() before they
+    /// are generated, as with \c init_tiles() .
+    /// \tparam Op Tile operation type
+    /// \param op The operation used to generate tiles, which must be thread
+    /// safe; see \c init_tiles()
+    /// \param skip_set If false, will throw if any tiles are already set
+    /// \param chunk_size The number of tiles in a chunk, or zero to make four
+    /// chunks per thread
+    template <typename Op>
+    void init_tiles_bulk(Op&& op, bool skip_set = false,
+        size_type chunk_size = 0ul)
+    {
+      check_pimpl();
+
+      // Collect the local tiles to be initialized
+      std::vector<size_type> indices;
+      indices.reserve(pimpl_->pmap()->local_size());
+      for(const auto index : * pimpl_->pmap()) {
+        if(pimpl_->is_zero(index))
+          continue;
+        if(skip_set && find(index).probe())
+          continue;
+        indices.push_back(index);
+      }
+      if(indices.empty())
+        return;
+
+      if(chunk_size == 0ul) {
+        const size_type chunks = 4ul * (madness::ThreadPool::size() + 1ul);
+        chunk_size = std::max<size_type>((indices.size() + chunks - 1ul) / chunks, 1ul);
+      }
+
+      typedef typename std::decay<Op>::type op_type;
+      std::shared_ptr<const op_type> shared_op =
+          std::make_shared<const op_type>(std::forward<Op>(op));
+      const std::shared_ptr<const std::vector<size_type> > shared_indices =
+          std::make_shared<const std::vector<size_type> >(std::move(indices));
+
+      detail::MemoryGovernor& governor = detail::MemoryGovernor::instance();
+      for(size_type first = 0ul; first < shared_indices->size(); first += chunk_size) {
+        const size_type last = std::min(first + chunk_size, shared_indices->size());
+        std::size_t bytes = 0ul;
+        if(governor.enabled())
+          for(size_type j = first; j < last; ++j)
+            bytes += detail::tile_memory<value_type>(
+                trange().make_tile_range((*shared_indices)[j]));
+        DistArray_ array = *this;
+        governor.submit(bytes, [array, shared_op, shared_indices, first, last]
+            (const std::size_t reserved)
+        {
+          array.world().taskq.add([array, shared_op, shared_indices, first, last, reserved] () {
+            const std::vector<size_type> ords(shared_indices->begin() + first,
+                shared_indices->begin() + last);
+            std::vector<value_type> tiles;
+            tiles.reserve(ords.size());
+            for(const auto ord : ords)
+              tiles.push_back((*shared_op)(array.trange().make_tile_range(ord)));
+            array.pimpl()->set(ords, tiles);
+            detail::MemoryGovernor::instance().release(reserved);
+          });
+        });
+      }
+    }
+
     /// Tiled range accessor
 
     /// \return A const reference to the tiled range object for the array
@@ -563,6 +717,32 @@ namespace TiledArray {
       return TiledArray::expressions::TsrExpr<DistArray_, true>(*this, vars);
     }
 
+    /// Create a tensor expression with a compile-time index list
+
+    /// \tparam Vars The indices
+    /// \return A const tensor expression object
+    template <char... Vars>
+    TiledArray::expressions::TsrExpr<const DistArray_, true>
+    operator ()(const TiledArray::expressions::IndexList<Vars...>&) const {
+      TA_USER_ASSERT((! pimpl_) || (sizeof...(Vars) == pimpl_->trange().tiles_range().rank()),
+          "The number of array annotation variables is not equal to the array dimension.");
+      return TiledArray::expressions::TsrExpr<const DistArray_, true>(*this,
+          TiledArray::expressions::IndexList<Vars...>::string());
+    }
+
+    /// Create a tensor expression with a compile-time index list
+
+    /// \tparam Vars The indices
+    /// \return A non-const tensor expression object
+    template <char... Vars>
+    TiledArray::expressions::TsrExpr<DistArray_, true>
+    operator ()(const TiledArray::expressions::IndexList<Vars...>&) {
+      TA_USER_ASSERT((! pimpl_) || (sizeof...(Vars) == pimpl_->trange().tiles_range().rank()),
+          "The number of array annotation variables is not equal to the array dimension.");
+      return TiledArray::expressions::TsrExpr<DistArray_, true>(*this,
+          TiledArray::expressions::IndexList<Vars...>::string());
+    }
+
     /// \deprecated use DistArray::world()
     DEPRECATED World& get_world() const {
       check_pimpl();
@@ -682,6 +862,10 @@ namespace TiledArray {
     void swap(DistArray_& other) { std::swap(pimpl_, other.pimpl_); }
 
     /// Convert a distributed array into a replicated array
+
+    /// When \c NodeSharedReplication is enabled, the tiles of arrays of
+    /// tensors are held once per node, in shared memory, and this function
+    /// returns after the tiles are replicated.
     void make_replicated() {
       check_pimpl();
       if((! pimpl_->pmap()->is_replicated()) && (world().size() > 1)) {
@@ -689,6 +873,12 @@ namespace TiledArray {
         std::shared_ptr<pmap_interface> pmap(new detail::ReplicatedPmap(world(), size()));
         DistArray_ result = DistArray_(world(), trange(), shape(), pmap);
 
+        // Share one copy of the tiles among the processes of each node
+        if(detail::node_replicate(*this, result)) {
+          DistArray_::operator=(result);
+          return;
+        }
+
         // Create the replicator object that will do an all-to-all broadcast of
         // the local tile data.
         std::shared_ptr<detail::Replicator<DistArray_> > replicator(
@@ -708,6 +898,71 @@ namespace TiledArray {
     /// \note This function is a no-op for dense arrays.
     void truncate() { TiledArray::truncate(*this); }
 
+    /// Let other processes read the local tiles with one-sided gets
+
+    /// Once the array is final, exposing its tiles lets other processes read
+    /// them with \c MPI_Get , without waiting for a task on the owner of
+    /// each tile, which is busy with other work. The tiles are read-only
+    /// until \c conceal() is called, and the array must be concealed before
+    /// it is destroyed. Nothing is done if one-sided gets are not supported
+    /// by MPI or by the tile type. This is collective, and includes a fence.
+    /// \return \c true if the local tiles are exposed
+    bool expose() {
+      check_pimpl();
+      return pimpl_->expose();
+    }
+
+    /// Stop one-sided gets of the local tiles
+
+    /// This is collective, and includes a fence.
+    void conceal() {
+      check_pimpl();
+      pimpl_->conceal();
+    }
+
+    /// \return \c true if the local tiles are exposed for one-sided gets
+    bool is_exposed() const {
+      check_pimpl();
+      return pimpl_->is_exposed();
+    }
+
+    /// Compress the local tiles in memory
+
+    /// Arrays that are kept for later, e.g. DIIS history or old amplitudes,
+    /// can be compressed without loss to reduce the resident memory. Each
+    /// local tile is decompressed in a task when it is first accessed, e.g.
+    /// by \c find() , an expression, or another process, or when
+    /// \c decompress() is called. This is a local operation without
+    /// communication, but the array must not be in use, e.g. call it after
+    /// a fence.
+    /// \note The memory of a tile is only released when all other copies of
+    /// the tile have been destroyed.
+    void compress() {
+      check_pimpl();
+      pimpl_->compress();
+    }
+
+    /// Decompress the local tiles
+
+    /// This is a local operation, without communication, that returns when
+    /// all local tiles have been decompressed.
+    void decompress() {
+      check_pimpl();
+      pimpl_->decompress();
+    }
+
+    /// \return The number of compressed local tiles
+    size_type compressed_size() const {
+      check_pimpl();
+      return pimpl_->compressed_size();
+    }
+
+    /// \return The memory held by the compressed local tiles, in bytes
+    std::size_t compressed_bytes() const {
+      check_pimpl();
+      return pimpl_->compressed_bytes();
+    }
+
     /// Check if the array is initialized
 
     /// \return \c false if the array has been default initialized, otherwise
@@ -761,10 +1016,10 @@ namespace TiledArray {
   class DistArray<Tensor<int, Eigen::aligned_allocator<int> >, DensePolicy>;
   extern template
   class DistArray<Tensor<long, Eigen::aligned_allocator<long> >, DensePolicy>;
-//  extern template
-//  class DistArray<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>;
-//  extern template
-//  class DistArray<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>
+  extern template
+  class DistArray<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, DensePolicy>;
+  extern template
+  class DistArray<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, DensePolicy>;
 
   extern template
   class DistArray<Tensor<double, Eigen::aligned_allocator<double> >, SparsePolicy>;
@@ -774,10 +1029,10 @@ namespace TiledArray {
   class DistArray<Tensor<int, Eigen::aligned_allocator<int> >, SparsePolicy>;
   extern template
   class DistArray<Tensor<long, Eigen::aligned_allocator<long> >, SparsePolicy>;
-//  extern template
-//  class DistArray<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>;
-//  extern template
-//  class DistArray<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
+  extern template
+  class DistArray<Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >, SparsePolicy>;
+  extern template
+  class DistArray<Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >, SparsePolicy>;
 
 #endif // TILEDARRAY_HEADER_ONLY
 
@@ -30,8 +30,30 @@
 #include <TiledArray/block_range.h>
 
 namespace TiledArray {
+
+  // Forward declaration
+  template <typename, typename, bool> class Scal;
+
   namespace detail {
 
+    template <typename> class UnaryWrapper;
+
+    /// Identity test for array tile operations
+
+    /// \return \c false, since the operation may modify the tile
+    template <typename Op>
+    inline bool is_identity_op(const Op&) { return false; }
+
+    /// Identity test for scaling array tile operations
+
+    /// A scaling operation is the identity when its factor has been folded
+    /// into the consuming operation and no permutation is applied.
+    /// \return \c true when \c op leaves the tile unchanged
+    template <typename Arg, typename Scalar, bool Consumable>
+    inline bool is_identity_op(const UnaryWrapper<Scal<Arg, Scalar, Consumable> >& op) {
+      return (! op.permutation()) && (op.op().factor() == Scalar(1));
+    }
+
     /// Lazy tile for on-the-fly evaluation of array tiles.
 
     /// This tile object is used to hold input array tiles and do on-the-fly
@@ -88,10 +110,29 @@ namespace TiledArray {
       bool is_consumable() const { return consume_ || op_->permutation(); }
 
       /// Convert tile to evaluation type
+
+      /// When the operation is the identity and the tile is not consumable,
+      /// the input tile is returned as is instead of a modified copy. The
+      /// result is not consumable (see \c is_consumable() ), so the consumer
+      /// will not modify the shared data.
       operator auto() const {
+        return eval(std::is_same<tile_type, eval_type>());
+      }
+
+    private:
+
+      eval_type eval(std::true_type) const {
+        if((! consume_) && is_identity_op(*op_))
+          return tile_;
+        return eval(std::false_type());
+      }
+
+      eval_type eval(std::false_type) const {
         return (consume_ ? op_->consume(tile_) : (*op_)(tile_));
       }
 
+    public:
+
       /// return ref to input tile
       const tile_type& tile() const { return tile_; }
 
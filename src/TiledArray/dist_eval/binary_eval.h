@@ -21,7 +21,10 @@
 #define TILEDARRAY_DIST_EVAL_BINARY_EVAL_H__INCLUDED
 
 #include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/dist_eval/tile_batch.h>
 #include <TiledArray/zero_tensor.h>
+#include <TiledArray/profiler.h>
+#include <TiledArray/memory_governor.h>
 
 namespace TiledArray {
   namespace detail {
@@ -101,8 +104,7 @@ namespace TiledArray {
         const ProcessID source =  left_.owner(source_index); // Left and right
                                                   // should have the same owner
 
-        const madness::DistributedID key(DistEvalImpl_::id(), i);
-        return TensorImpl_::world().gop.template recv<value_type>(source, key);
+        return DistEvalImpl_::recv_tile(source, i);
       }
 
       /// Discard a tile that is not needed
@@ -114,14 +116,175 @@ namespace TiledArray {
 
     private:
 
+      typedef typename left_type::value_type left_value_type; ///< Left-hand tile type
+      typedef typename right_type::value_type right_value_type; ///< Right-hand tile type
+
+      // Task function argument types
+      typedef typename std::conditional<op_type::left_is_consumable,
+                left_value_type, const left_value_type>::type &
+              left_argument_type;
+      typedef typename std::conditional<op_type::right_is_consumable,
+                right_value_type, const right_value_type>::type &
+              right_argument_type;
+
+      /// Zero argument flags of a tile evaluation
+      enum ZeroArg { no_zero_arg, left_zero_arg, right_zero_arg };
+
+      /// Tile arguments of a batch of tile evaluations
+      struct BatchArgs {
+        std::vector<int> zero_args; ///< The zero argument flags of the tiles
+        std::vector<Future<left_value_type> > left; ///< The left-hand tiles
+        std::vector<Future<right_value_type> > right; ///< The right-hand tiles
+      }; // struct BatchArgs
+
+      /// Evaluate and set a tile
+
+      /// \param i The tile index
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      template <typename L, typename R>
+      void compute_tile(const size_type i, L left, R right) {
+        detail::ProfileScope profile("binary_tile", "tile", i);
+        if(profile.enabled())
+          profile.add_bytes(detail::tile_bytes(left) + detail::tile_bytes(right));
+        value_type result;
+        {
+          detail::TileCostScope cost(DistEvalImpl_::cost_recorder(), i);
+          result = op_(left, right);
+        }
+        DistEvalImpl_::set_tile(i, result);
+      }
+
       /// Task function for evaluating tiles
 
       /// \param i The tile index
+      /// \param reserved The memory reserved for the task by
+      /// \c MemoryGovernor
       /// \param left The left-hand tile
       /// \param right The right-hand tile
       template <typename L, typename R>
-      void eval_tile(const size_type i, L left, R right) {
-        DistEvalImpl_::set_tile(i, op_(left, right));
+      void eval_tile(const size_type i, const std::size_t reserved, L left, R right) {
+        compute_tile<L, R>(i, left, right);
+        MemoryGovernor::instance().release(reserved);
+      }
+
+      /// Task function for evaluating a batch of tiles
+
+      /// \param indices The tile indices
+      /// \param zero_args The zero argument flags of the tiles
+      /// \param reserved The memory reserved for the task by
+      /// \c MemoryGovernor
+      /// \param left The left-hand tiles, where zero tiles are placeholders
+      /// \param right The right-hand tiles, where zero tiles are placeholders
+      void eval_tiles(const std::vector<size_type>& indices,
+          const std::vector<int>& zero_args, const std::size_t reserved,
+          const std::vector<Future<left_value_type> >& left,
+          const std::vector<Future<right_value_type> >& right)
+      {
+        for(std::size_t j = 0ul; j < indices.size(); ++j) {
+          Future<left_value_type> left_tile = left[j];
+          Future<right_value_type> right_tile = right[j];
+          if(zero_args[j] == left_zero_arg)
+            compute_tile<const ZeroTensor, right_argument_type>(indices[j],
+                ZeroTensor(), right_tile.get());
+          else if(zero_args[j] == right_zero_arg)
+            compute_tile<left_argument_type, const ZeroTensor>(indices[j],
+                left_tile.get(), ZeroTensor());
+          else
+            compute_tile<left_argument_type, right_argument_type>(indices[j],
+                left_tile.get(), right_tile.get());
+        }
+        MemoryGovernor::instance().release(reserved);
+      }
+
+      /// Submit a tile evaluation task to the memory governor
+
+      /// \tparam L The left-hand task argument type
+      /// \tparam R The right-hand task argument type
+      /// \tparam LeftTile The left-hand tile type
+      /// \tparam RightTile The right-hand tile type
+      /// \param self A shared pointer to this object
+      /// \param i The tile index
+      /// \param bytes The memory of the result tile
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      template <typename L, typename R, typename LeftTile, typename RightTile>
+      void spawn_tile(const std::shared_ptr<BinaryEvalImpl_>& self,
+          const size_type i, const std::size_t bytes, const LeftTile& left,
+          const RightTile& right)
+      {
+        MemoryGovernor::instance().submit(bytes,
+            [self, i, left, right] (const std::size_t reserved) {
+              self->world().taskq.add(self,
+                  & BinaryEvalImpl_::template eval_tile<L, R>, i, reserved,
+                  left, right);
+            });
+      }
+
+      /// Submit a batch evaluation task to the memory governor
+
+      /// The batch and its arguments are cleared.
+      /// \param self A shared pointer to this object
+      /// \param batch The batch of tile evaluations
+      /// \param args The tile arguments of \c batch
+      void spawn_batch(const std::shared_ptr<BinaryEvalImpl_>& self,
+          TileBatch& batch, BatchArgs& args)
+      {
+        if(batch.empty())
+          return;
+
+        const std::vector<size_type> indices = batch.indices();
+        const std::vector<int> zero_args = std::move(args.zero_args);
+        const std::vector<Future<left_value_type> > left = std::move(args.left);
+        const std::vector<Future<right_value_type> > right = std::move(args.right);
+        MemoryGovernor::instance().submit(batch.bytes(),
+            [self, indices, zero_args, left, right] (const std::size_t reserved) {
+              self->world().taskq.add(self, & BinaryEvalImpl_::eval_tiles,
+                  indices, zero_args, reserved, left, right);
+            });
+
+        batch.clear();
+        args = BatchArgs();
+      }
+
+      /// Schedule the evaluation of a tile
+
+      /// Tiles that are smaller than the batching target are added to
+      /// \c batch , which is submitted when it is full; other tiles are
+      /// evaluated by their own task.
+      /// \param self A shared pointer to this object
+      /// \param batch The current batch of tile evaluations
+      /// \param args The tile arguments of \c batch
+      /// \param i The tile index
+      /// \param zero_arg The zero argument flag of the tile
+      /// \param left The left-hand tile, or a placeholder for a zero tile
+      /// \param right The right-hand tile, or a placeholder for a zero tile
+      void schedule_tile(const std::shared_ptr<BinaryEvalImpl_>& self,
+          TileBatch& batch, BatchArgs& args, const size_type i,
+          const ZeroArg zero_arg, const Future<left_value_type>& left,
+          const Future<right_value_type>& right)
+      {
+        const auto range = TensorImpl_::trange().make_tile_range(i);
+        const std::size_t volume = range.volume();
+        const std::size_t bytes = tile_memory<value_type>(range);
+
+        if(batch.batched(volume)) {
+          batch.add(i, volume, bytes);
+          args.zero_args.push_back(zero_arg);
+          args.left.push_back(left);
+          args.right.push_back(right);
+          if(batch.full())
+            spawn_batch(self, batch, args);
+        } else if(zero_arg == left_zero_arg) {
+          spawn_tile<const ZeroTensor, right_argument_type>(self, i, bytes,
+              ZeroTensor(), right);
+        } else if(zero_arg == right_zero_arg) {
+          spawn_tile<left_argument_type, const ZeroTensor>(self, i, bytes,
+              left, ZeroTensor());
+        } else {
+          spawn_tile<left_argument_type, right_argument_type>(self, i, bytes,
+              left, right);
+        }
       }
 
       /// Evaluate the tiles of this tensor
@@ -129,7 +292,8 @@ namespace TiledArray {
       /// This function will evaluate the children of this distributed evaluator
       /// and evaluate the tiles for this distributed evaluator. It will block
       /// until the tasks for the children are evaluated (not for the tasks of
-      /// this object).
+      /// this object). Consecutive small tiles are evaluated in batches (see
+      /// \c TileBatchPolicy ).
       /// \return The number of tiles that will be set by this process
       virtual int internal_eval() {
 
@@ -137,16 +301,6 @@ namespace TiledArray {
         left_.eval();
         right_.eval();
 
-        // Task function argument types
-        typedef typename std::conditional<op_type::left_is_consumable,
-                  typename left_type::value_type,
-            const typename left_type::value_type>::type &
-                left_argument_type;
-        typedef typename std::conditional<op_type::right_is_consumable,
-                  typename right_type::value_type,
-            const typename right_type::value_type>::type &
-                right_argument_type;
-
         size_type task_count = 0ul;
 
         // Construct local iterator
@@ -154,6 +308,8 @@ namespace TiledArray {
         std::shared_ptr<BinaryEvalImpl_> self = shared_from_this();
         typename pmap_interface::const_iterator it = left_.pmap()->begin();
         const typename pmap_interface::const_iterator end = left_.pmap()->end();
+        TileBatch batch(left_.pmap()->local_size());
+        BatchArgs args;
 
         if(left_.is_dense() && right_.is_dense() && TensorImpl_::is_dense()) {
           // Evaluate tiles where both arguments and the result are dense
@@ -163,9 +319,8 @@ namespace TiledArray {
             const size_type target_index = DistEvalImpl_::perm_index_to_target(source_index);
 
             // Schedule tile evaluation task
-            TensorImpl_::world().taskq.add(self,
-                & BinaryEvalImpl_::template eval_tile<left_argument_type, right_argument_type>,
-                target_index, left_.get(source_index), right_.get(source_index));
+            schedule_tile(self, batch, args, target_index, no_zero_arg,
+                left_.get(source_index), right_.get(source_index));
 
             ++task_count;
           }
@@ -179,17 +334,14 @@ namespace TiledArray {
             if(! TensorImpl_::is_zero(target_index)) {
               // Schedule tile evaluation task
               if(left_.is_zero(index)) {
-                TensorImpl_::world().taskq.add(self,
-                  & BinaryEvalImpl_::template eval_tile<const ZeroTensor, right_argument_type>,
-                  target_index, ZeroTensor(), right_.get(index));
+                schedule_tile(self, batch, args, target_index, left_zero_arg,
+                    Future<left_value_type>(left_value_type()), right_.get(index));
               } else if(right_.is_zero(index)) {
-                TensorImpl_::world().taskq.add(self,
-                  & BinaryEvalImpl_::template eval_tile<left_argument_type, const ZeroTensor>,
-                  target_index, left_.get(index), ZeroTensor());
+                schedule_tile(self, batch, args, target_index, right_zero_arg,
+                    left_.get(index), Future<right_value_type>(right_value_type()));
               } else {
-                TensorImpl_::world().taskq.add(self,
-                  & BinaryEvalImpl_::template eval_tile<left_argument_type, right_argument_type>,
-                  target_index, left_.get(index), right_.get(index));
+                schedule_tile(self, batch, args, target_index, no_zero_arg,
+                    left_.get(index), right_.get(index));
               }
 
               ++task_count;
@@ -202,10 +354,11 @@ namespace TiledArray {
             }
           }
         }
+        spawn_batch(self, batch, args);
 
         // Wait for child tensors to be evaluated, and process tasks while waiting.
-        left_.wait();
-        right_.wait();
+        DistEvalImpl_::wait_arg(left_);
+        DistEvalImpl_::wait_arg(right_);
 
         return task_count;
       }
@@ -20,20 +20,29 @@
 #ifndef TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 #define TILEDARRAY_DIST_EVAL_CONTRACTION_EVAL_H__INCLUDED
 
+#include <algorithm>
 #include <vector>
 
+#include <TiledArray/bitset.h>
 #include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/dist_eval/summa_coalesce.h>
+#include <TiledArray/dist_eval/summa_depth.h>
+#include <TiledArray/dist_eval/summa_priority.h>
+#include <TiledArray/dist_eval/summa_steal.h>
+#include <TiledArray/dist_eval/summa_groups.h>
+#include <TiledArray/dist_eval/summa_persistent.h>
+#include <TiledArray/dist_eval/summa_order.h>
+#include <TiledArray/comm_tracker.h>
+#include <TiledArray/expressions/contraction_plan.h>
+#include <TiledArray/memory_tracker.h>
+#include <TiledArray/profiler.h>
 #include <TiledArray/proc_grid.h>
 #include <TiledArray/reduce_task.h>
+#include <TiledArray/shm_exchange.h>
+#include <TiledArray/summa_trace.h>
 #include <TiledArray/type_traits.h>
 #include <TiledArray/shape.h>
 
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_STEP 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST 1
-//#define TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE 1
-
 namespace TiledArray {
   namespace detail {
 
@@ -48,6 +57,12 @@ namespace TiledArray {
     /// argument and the column phase of the right-hand argument are equal to
     /// the number of rows and columns, respectively, in the \c ProcGrid object
     /// passed to the constructor.
+    /// \note When \c ProcGrid has more than one layer the contraction is
+    /// evaluated with the communication-avoiding (2.5D) algorithm: column and
+    /// row \c k of the left- and right-hand arguments, respectively, must be
+    /// distributed to layer <tt>k % layers</tt>, each layer evaluates the SUMMA
+    /// iterations for its share of \c k, and the partial results are reduced
+    /// onto the first layer, which holds the result tiles.
     template <typename Left, typename Right, typename Op, typename Policy>
     class Summa :
         public DistEvalImpl<typename Op::result_type, Policy>,
@@ -67,10 +82,9 @@ namespace TiledArray {
       typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
       typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
       typedef Op op_type; ///< Tile evaluation operator type
+      typedef DistArray<value_type, Policy> seed_type; ///< Result seed array type
 
     private:
-      static size_type max_memory_; ///< Maximum memory used per node
-      static size_type max_depth_; ///< Maximum number of concurrent SUMMA iterations
 
       // Arguments and operation
       left_type left_; ///< The left-hand argument
@@ -84,9 +98,34 @@ namespace TiledArray {
       // Dimension information
       const size_type k_; ///< Number of tiles in the inner dimension
       const ProcGrid proc_grid_; ///< Process grid for this contraction
+      const std::shared_ptr<const ProcTopology> shm_topology_; ///< Topology for shared memory broadcasts
+      const std::shared_ptr<ContractionPlan> plan_; ///< The plan that caches the broadcast groups (may be null)
+      std::size_t plan_groups_id_; ///< The version of the broadcast groups in plan_
+      const std::shared_ptr<SummaGroupCache> group_cache_; ///< Shared sparse broadcast groups
+      std::shared_ptr<SummaChannels> channels_; ///< Persistent broadcast channels of plan_ (may be null)
 
       // Contraction results
       ReducePairTask<op_type>* reduce_tasks_; ///< A pointer to the reduction tasks
+      size_type reduce_task_count_; ///< The number of reduction tasks
+      std::vector<size_type> reduce_task_rows_; ///< The first reduction task of each local row (sparse results only)
+      std::vector<size_type> reduce_task_cols_; ///< The local column of each reduction task (sparse results only)
+      seed_type seed_; ///< Initial values of the result tiles (if initialized)
+
+      // Iteration depth control
+      const size_type max_depth_; ///< Maximum number of concurrent SUMMA iterations (0 = automatic)
+      const size_type max_memory_; ///< Maximum memory used by concurrent SUMMA iterations (0 = automatic)
+      SummaDepthController::time_point start_time_; ///< Start time of the SUMMA iterations
+      madness::AtomicInt step_count_; ///< Number of SUMMA iterations started
+      volatile size_type front_; ///< The iteration of the most recently started step
+      madness::AtomicInt depth_; ///< Number of SUMMA iterations in flight
+      size_type max_lookahead_; ///< Upper bound of \c depth_
+      std::vector<size_type> k_steps_; ///< The non-empty iterations of a sparse contraction
+
+      // Work stealing
+      typedef SummaStealPool<op_type, typename left_type::eval_type,
+          typename right_type::eval_type> steal_pool_type; ///< Stealable tile pair pool type
+      std::shared_ptr<steal_pool_type> steal_pool_; ///< Stealable tile pairs (may be null)
+      size_type steal_k_; ///< The first iteration whose tile pairs can be stolen
 
       // Constants used to iterate over columns and rows of left_ and right_, respectively.
       const size_type left_start_local_; ///< The starting point of left column iterator ranges (just add k for specific columns)
@@ -109,58 +148,36 @@ namespace TiledArray {
 
     private:
 
-      // Static variable initialization ----------------------------------------
-
-
-      /// Initialize max_memory_ limit for SUMMA
-      static size_type init_max_memory() {
-        const char* max_memory = getenv("TA_SUMMA_MAX_MEMORY");
-        if(max_memory) {
-            // Convert the string into bytes
-            std::stringstream ss(max_memory);
-            double memory = 0.0;
-            if(ss >> memory) {
-                if(memory > 0.0) {
-                    std::string unit;
-                    if(ss >> unit) { // Failure == assume bytes
-                        if(unit == "KB" || unit == "kB") {
-                          memory *= 1000.0;
-                        } else if(unit == "KiB" || unit == "kiB") {
-                          memory *= 1024.0;
-                        } else if(unit == "MB") {
-                          memory *= 1000000.0;
-                        } else if(unit == "MiB") {
-                          memory *= 1048576.0;
-                        } else if(unit == "GB") {
-                          memory *= 1000000000.0;
-                        } else if(unit == "GiB") {
-                          memory *= 1073741824.0;
-                        }
-                    }
-                }
-            }
-
-            memory = std::max(memory, 104857600.0); // Minimum 100 MiB
-            return memory;
-        }
+      // Process groups --------------------------------------------------------
 
-        return 0ul;
-      }
+      /// Flag the non-zero tiles of a strided range of tiles
 
+      /// \tparam Shape The shape type
+      /// \param shape The shape of the tiles
+      /// \param index The first index of the row or column range
+      /// \param end The end of the row or column range
+      /// \param stride The row or column index stride
+      /// \return A bitset in which bit \c i is set when tile
+      /// <tt>index + i * stride</tt> is non-zero
+      template <typename Shape>
+      static Bitset<> make_nonzero_mask(const Shape& shape, size_type index,
+          const size_type end, const size_type stride)
+      {
+        Bitset<> mask(index < end ? (end - index + stride - 1ul) / stride : 0ul);
+        if(shape.is_dense()) {
+          mask.set();
+        } else {
+          for(size_type i = 0ul; index < end; ++i, index += stride)
+            if(! shape.is_zero(index))
+              mask.set(i);
+        }
 
-      static size_type init_max_depth() {
-        const char* max_depth = getenv("TA_SUMMA_MAX_DEPTH");
-        if(max_depth)
-          return std::stoul(max_depth);
-        return 0ul;
+        return mask;
       }
 
+      /// Process group member factory function
 
-      // Process groups --------------------------------------------------------
-
-      /// Process group factory function
-
-      /// This function generates a sparse process group.
+      /// This function generates the process list of a sparse process group.
       /// \tparam Shape The shape type
       /// \tparam ProcMap The process map operation type
       /// \param shape The shape that will be used to select processes that are
@@ -176,15 +193,15 @@ namespace TiledArray {
       /// \param max_group_size The maximum number of processes in the result
       /// group, which is equal to the number of process in this process row or
       /// column as defined by \c proc_grid_.
-      /// \param key_offset The key that will be used to identify the process group
       /// \param proc_map The operator that will convert a process row/column
       /// index into the absolute process index (ProcessID)
-      /// \return A sparse process group that includes process in the row or
-      /// column of this process as defined by \c proc_grid_.
+      /// \return The processes in the row or column of this process, as
+      /// defined by \c proc_grid_ , that are included in the group
       template <typename Shape, typename ProcMap>
-      madness::Group make_group(const Shape& shape, const std::vector<bool>& process_mask, size_type index,
+      std::vector<ProcessID> make_group_procs(const Shape& shape,
+          const std::vector<bool>& process_mask, size_type index,
           const size_type end, const size_type stride, const size_type max_group_size,
-          const size_type k, const size_type key_offset, const ProcMap& proc_map) const
+          const size_type k, const ProcMap& proc_map) const
       {
         // Generate the list of processes in rank_row
         std::vector<ProcessID> proc_list(max_group_size, -1);
@@ -195,11 +212,14 @@ namespace TiledArray {
         proc_list[p] = proc_map(p);
         size_type count = 1ul;
 
-        // Flag all processes that have non-zero tiles
-        for(p = 0ul; (index < end) && (count < max_group_size); index += stride,
-            p = (p + 1u) % max_group_size)
+        // Flag all processes that have non-zero tiles, where the i-th tile
+        // of the range belongs to process i % max_group_size
+        const Bitset<> nonzero = make_nonzero_mask(shape, index, end, stride);
+        for(size_type i = nonzero.find_first(); (i < nonzero.size()) &&
+            (count < max_group_size); i = nonzero.find_next(i))
         {
-          if((proc_list[p] != -1) || (shape.is_zero(index)) || !process_mask.at(p)) continue;
+          p = i % max_group_size;
+          if((proc_list[p] != -1) || !process_mask.at(p)) continue;
 
           proc_list[p] = proc_map(p);
           ++count;
@@ -214,15 +234,57 @@ namespace TiledArray {
         // Truncate invalid process id's
         proc_list.resize(count);
 
-        return madness::Group(TensorImpl_::world(), proc_list,
-            madness::DistributedID(DistEvalImpl_::id(), k + key_offset));
+        return proc_list;
+      }
+
+      /// Process group factory function
+
+      /// Groups with the same members are shared by all iterations, and by
+      /// all evaluations that use the same contraction plan, when the
+      /// membership can be encoded in the group key (see
+      /// \c SummaGroupCache ). Otherwise, a new group is constructed.
+      /// \param proc_list The processes in the group, or an empty list if this
+      /// process is not in the group
+      /// \param key The key that will be used to identify the process group
+      /// when it is not shared
+      /// \param row \c true for a row group and \c false for a column group
+      /// \return A sparse process group that includes the processes in
+      /// \c proc_list
+      madness::Group make_group(const std::vector<ProcessID>& proc_list,
+          const size_type key, const bool row) const
+      {
+        if(proc_list.empty())
+          return madness::Group();
+
+        const size_type group_size =
+            (row ? proc_grid_.proc_cols() : proc_grid_.proc_rows());
+        if(! SummaGroupCache::is_shared(group_size))
+          return madness::Group(TensorImpl_::world(), proc_list,
+              madness::DistributedID(DistEvalImpl_::id(), key));
+
+        // Encode the positions of the members in this process row or column
+        const ProcessID first = (row ? proc_grid_.map_col(0) : proc_grid_.map_row(0));
+        const size_type stride = (row ? 1ul : proc_grid_.proc_cols());
+        size_type mask = 0ul;
+        for(const ProcessID proc : proc_list)
+          mask |= size_type(1) << ((proc - first) / stride);
+
+        return group_cache_->group(TensorImpl_::world(), row, proc_list,
+            madness::DistributedID(DistEvalImpl_::id(),
+            SummaGroupCache::shared_key(k_, mask, row)));
       }
 
       /// Row process group factory function
 
+      /// The processes of the group are taken from the contraction plan when
+      /// it holds them.
       /// \param k The broadcast group index
       /// \return A row process group
       madness::Group make_row_group(const size_type k) const {
+        std::vector<ProcessID> proc_list;
+        if(plan_ && plan_->find_row_group(plan_groups_id_, k, proc_list))
+          return make_group(proc_list, k + k_, true);
+
         // Construct the sparse broadcast group
         const size_type right_begin_k = k * proc_grid_.cols();
         const size_type right_end_k = right_begin_k + proc_grid_.cols();
@@ -230,33 +292,42 @@ namespace TiledArray {
         // for every tile and use of masked broadcasts
         auto result_row_mask_k = make_row_mask(k);
 
-        // return empty group if I am not in this group, otherwise make a group
+        // the group is empty if I am not in this group
         if (result_row_mask_k[proc_grid_.rank_col()])
-          return make_group(right_.shape(), result_row_mask_k, right_begin_k, right_end_k,
-                            right_stride_, proc_grid_.proc_cols(), k, k_,
-                            [&](const ProcGrid::size_type col) { return proc_grid_.map_col(col); });
-        else
-          return madness::Group();
+          proc_list = make_group_procs(right_.shape(), result_row_mask_k,
+              right_begin_k, right_end_k, right_stride_, proc_grid_.proc_cols(), k,
+              [&](const ProcGrid::size_type col) { return proc_grid_.map_col(col); });
+        if(plan_)
+          plan_->insert_row_group(plan_groups_id_, k, proc_list);
+
+        return make_group(proc_list, k + k_, true);
       }
 
 
       /// Column process group factory function
 
+      /// The processes of the group are taken from the contraction plan when
+      /// it holds them.
       /// \param k The broadcast group index
       /// \return A column process group
       madness::Group make_col_group(const size_type k) const {
+        std::vector<ProcessID> proc_list;
+        if(plan_ && plan_->find_col_group(plan_groups_id_, k, proc_list))
+          return make_group(proc_list, k, false);
 
         // make the column mask; using the same mask for all tiles avoids having to compute mask
         // for every tile and use of masked broadcasts
         auto result_col_mask_k = make_col_mask(k);
 
-        // return empty group if I am not in this group, otherwise make a group
+        // the group is empty if I am not in this group
         if (result_col_mask_k[proc_grid_.rank_row()])
-          return make_group(left_.shape(), result_col_mask_k, k, left_end_, left_stride_,
-                            proc_grid_.proc_rows(), k, 0ul,
-                            [&](const ProcGrid::size_type row) { return proc_grid_.map_row(row); });
-        else
-          return madness::Group();
+          proc_list = make_group_procs(left_.shape(), result_col_mask_k, k,
+              left_end_, left_stride_, proc_grid_.proc_rows(), k,
+              [&](const ProcGrid::size_type row) { return proc_grid_.map_row(row); });
+        if(plan_)
+          plan_->insert_col_group(plan_groups_id_, k, proc_list);
+
+        return make_group(proc_list, k, false);
       }
 
       /// Makes the row result mask
@@ -464,6 +535,20 @@ namespace TiledArray {
             arg.get(index), madness::TaskAttributes::hipri());
       }
 
+      /// Set the capacity of the partial result pool of the tile operation
+
+      /// \tparam O The tile operation type
+      /// \param op The tile operation
+      /// \param capacity The maximum number of pooled partial results
+      template <typename O>
+      static auto reserve_result_pool(const O& op, const size_type capacity, int) ->
+          decltype(op.reserve_result_pool(capacity))
+      { return op.reserve_result_pool(capacity); }
+
+      /// Tile operations without a partial result pool are not modified
+      template <typename O>
+      static void reserve_result_pool(const O&, const size_type, long) { }
+
 
       /// Collect non-zero tiles from \c arg
 
@@ -480,17 +565,15 @@ namespace TiledArray {
       {
         TA_ASSERT(vec.size() == 0ul);
 
-        // Iterate over vector of tiles
+        // Iterate over the non-zero tiles of the vector
+        const Bitset<> nonzero = make_nonzero_mask(arg.shape(), index, end, stride);
+        vec.reserve(nonzero.count());
         if(arg.is_local(index)) {
-          for(size_type i = 0ul; index < end; ++i, index += stride) {
-            if(arg.shape().is_zero(index)) continue;
-            vec.emplace_back(i, get_tile(arg, index));
-          }
+          for(size_type i = nonzero.find_first(); i < nonzero.size(); i = nonzero.find_next(i))
+            vec.emplace_back(i, get_tile(arg, index + i * stride));
         } else {
-          for(size_type i = 0ul; index < end; ++i, index += stride) {
-            if(arg.shape().is_zero(index)) continue;
+          for(size_type i = nonzero.find_first(); i < nonzero.size(); i = nonzero.find_next(i))
             vec.emplace_back(i, Future<typename Arg::eval_type>());
-          }
         }
 
         TA_ASSERT(vec.size() > 0ul);
@@ -520,53 +603,231 @@ namespace TiledArray {
         get_vector(right_, begin, end, right_stride_local_, row);
       }
 
+      /// Pack the tiles of a coalesced broadcast
+
+      /// \tparam T The tile type
+      /// \param tiles The tiles of the broadcast
+      /// \return The tiles
+      template <typename T>
+      static std::vector<T> pack_tiles(const std::vector<Future<T> >& tiles) {
+        std::vector<T> result;
+        result.reserve(tiles.size());
+        for(const auto& tile : tiles)
+          result.push_back(tile.get());
+        return result;
+      }
+
+      /// Unpack the tiles of a coalesced broadcast
+
+      /// \tparam T The tile type
+      /// \param packed The tiles of the broadcast
+      /// \param tiles The futures of the tiles, which are set to the elements
+      /// of \c packed
+      template <typename T>
+      static void unpack_tiles(const std::vector<T>& packed,
+          const std::shared_ptr<std::vector<Future<T> > >& tiles)
+      {
+        TA_ASSERT(packed.size() == tiles->size());
+        for(size_type i = 0ul; i < packed.size(); ++i)
+          (*tiles)[i].set(packed[i]);
+      }
+
+      /// Check that the tiles of a broadcast are coalesced
+
+      /// \tparam Arg The argument type
+      /// \tparam Datum The vector datum type
+      /// \param arg The owner of the tiles
+      /// \param start The index of the first tile to be broadcast
+      /// \param stride The stride between tile indices to be broadcast
+      /// \param vec The tiles to be broadcast
+      /// \return \c true if the tiles are broadcast in one message (see
+      /// \c SummaCoalescePolicy )
+      template <typename Arg, typename Datum>
+      bool coalesce(const Arg& arg, const size_type start,
+          const size_type stride, const std::vector<Datum>& vec) const
+      {
+        if(vec.size() < 2ul)
+          return false;
+        size_type elements = 0ul;
+        for(const auto& datum : vec)
+          elements += arg.trange().make_tile_range(datum.first * stride + start).volume();
+        return SummaCoalescePolicy::instance().coalesce(vec.size(), elements);
+      }
+
+      /// Broadcast tiles over persistent channels
+
+      /// \return \c false , since only \c Tensor tiles use channels
+      template <typename Arg, typename Datum>
+      bool persistent_bcast_tiles(const Arg&, const size_type, const size_type,
+          const madness::Group&, const ProcessID, const size_type,
+          std::vector<Datum>&, std::false_type) const
+      { return false; }
+
+      /// Broadcast tensors over persistent channels
+
+      /// The tiles are broadcast when there are persistent channels and all
+      /// tiles are small enough for them (see
+      /// \c SummaChannels::is_persistent ). This depends only on the tiled
+      /// range, so all processes of the group agree on it.
+      /// \tparam Arg The argument type
+      /// \tparam Datum The vector datum type
+      /// \param[in] arg The owner of the tiles
+      /// \param[in] start The index of the first tile to be broadcast
+      /// \param[in] stride The stride between tile indices to be broadcast
+      /// \param[in] group The process group where the tiles will be broadcast
+      /// \param[in] group_root The root process of the broadcast
+      /// \param[in] key_offset The broadcast key offset value
+      /// \param[in,out] vec The tiles, which are set on processes other than
+      /// the root
+      /// \return \c true if the tiles are broadcast
+      template <typename Arg, typename Datum>
+      bool persistent_bcast_tiles(const Arg& arg, const size_type start,
+          const size_type stride, const madness::Group& group,
+          const ProcessID group_root, const size_type key_offset,
+          std::vector<Datum>& vec, std::true_type) const
+      {
+        typedef typename Arg::eval_type tile_type;
+        if(! channels_)
+          return false;
+        for(const auto& datum : vec)
+          if(! SummaChannels::is_persistent(arg.trange().make_tile_range(
+              datum.first * stride + start).volume() *
+              sizeof(typename tile_type::value_type)))
+            return false;
+
+        World& world = TensorImpl_::world();
+        for(auto& datum : vec) {
+          const size_type index = datum.first * stride + start;
+          const typename tile_type::range_type range = arg.trange().make_tile_range(index);
+          persistent_bcast(world, channels_->channel(index + key_offset, group,
+              group_root, range.volume() * sizeof(typename tile_type::value_type)),
+              datum.second, range, group.rank() == group_root);
+        }
+        return true;
+      }
+
+      /// Broadcast the tiles of a column of \c left_ or a row of \c right_
+
+      /// With a contraction plan and persistent broadcasts enabled, each tile
+      /// is broadcast over its persistent channel (see \c SummaChannels ).
+      /// The tiles are packed into one message when they are coalesced (see
+      /// \c coalesce() ), otherwise each tile is broadcast separately.
+      /// \tparam Arg The argument type
+      /// \tparam Datum The vector datum type
+      /// \param[in] arg The owner of the tiles
+      /// \param[in] start The index of the first tile to be broadcast
+      /// \param[in] stride The stride between tile indices to be broadcast
+      /// \param[in] group The process group where the tiles will be broadcast
+      /// \param[in] group_root The root process of the broadcast
+      /// \param[in] key_offset The broadcast key offset value
+      /// \param[in] category The communication category of the broadcast
+      /// \param[in,out] vec The tiles, which are set on processes other than
+      /// the root
+      template <typename Arg, typename Datum>
+      void bcast_tiles(const Arg& arg, const size_type start,
+          const size_type stride, const madness::Group& group,
+          const ProcessID group_root, const size_type key_offset,
+          const CommCategory category, std::vector<Datum>& vec) const
+      {
+        typedef typename Arg::eval_type tile_type;
+        World& world = TensorImpl_::world();
+        const bool root = (group.rank() == group_root);
+
+        if(persistent_bcast_tiles(arg, start, stride, group, group_root,
+            key_offset, vec, std::integral_constant<bool,
+            is_rendezvous_tile<tile_type>::value>()))
+        {
+          // The tiles are broadcast over persistent channels
+        } else if(coalesce(arg, start, stride, vec)) {
+          // The keys of coalesced broadcasts follow the keys of the tiles and
+          // of the layer reductions
+          const madness::DistributedID key(DistEvalImpl_::id(),
+              left_.size() + right_.size() + proc_grid_.layers() * TensorImpl_::size() +
+              vec.front().first * stride + start + key_offset);
+          Future<std::vector<tile_type> > packed;
+          if(root) {
+            std::vector<Future<tile_type> > tiles;
+            tiles.reserve(vec.size());
+            for(const auto& datum : vec)
+              tiles.push_back(datum.second);
+            packed = world.taskq.add(& Summa_::template pack_tiles<tile_type>,
+                tiles, madness::TaskAttributes::hipri());
+          }
+          shm_bcast(world, key, packed, group_root, group, shm_topology_.get());
+          if(! root) {
+            std::shared_ptr<std::vector<Future<tile_type> > > tiles =
+                std::make_shared<std::vector<Future<tile_type> > >();
+            tiles->reserve(vec.size());
+            for(const auto& datum : vec)
+              tiles->push_back(datum.second);
+            world.taskq.add(& Summa_::template unpack_tiles<tile_type>, packed,
+                tiles, madness::TaskAttributes::hipri());
+          }
+        } else {
+          for(auto& datum : vec) {
+            const madness::DistributedID key(DistEvalImpl_::id(),
+                datum.first * stride + start + key_offset);
+            shm_bcast(world, key, datum.second, group_root, group,
+                shm_topology_.get());
+          }
+        }
+
+        // Count the tiles sent or received by this process
+        for(const auto& datum : vec) {
+          if(root)
+            comm_send(category, datum.second);
+          else
+            comm_receive(category, datum.second);
+        }
+      }
+
       /// Broadcast tiles from \c arg
 
+      /// \tparam Arg The argument type
+      /// \tparam Datum The vector datum type
+      /// \param[in] arg The owner of the tiles
+      /// \param[in] k The SUMMA step of the broadcast
       /// \param[in] start The index of the first tile to be broadcast
       /// \param[in] stride The stride between tile indices to be broadcast
       /// \param[in] group The process group where the tiles will be broadcast
       /// \param[in] group_root The root process of the broadcast
       /// \param[in] key_offset The broadcast key offset value
+      /// \param[in] category The communication category of the broadcast
       /// \param[out] vec The vector that will hold broadcast tiles
-      template <typename Datum>
-      void bcast(const size_type start, const size_type stride,
+      template <typename Arg, typename Datum>
+      void bcast(const Arg& arg, const size_type k, const size_type start,
+          const size_type stride,
           const madness::Group& group, const ProcessID group_root,
-          const size_type key_offset, std::vector<Datum>& vec) const
+          const size_type key_offset, const CommCategory category,
+          std::vector<Datum>& vec) const
       {
         TA_ASSERT(vec.size() != 0ul);
         TA_ASSERT(group.size() > 0);
         TA_ASSERT(group_root < group.size());
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-        std::stringstream ss;
-        ss  << "bcast: rank=" << TensorImpl_::world().rank()
-            << " root=" << group.world_rank(group_root)
-            << " groupid=(" << group.id().first << "," << group.id().second
-            << ") keyoffset=" << key_offset << " group={ ";
-        for(ProcessID group_proc = 0; group_proc < group.size(); ++group_proc)
-          ss << group.world_rank(group_proc) << " ";
-        ss << "} tiles={ ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-
-        // Iterate over tiles to be broadcast
-        for(typename std::vector<Datum>::iterator it = vec.begin(); it != vec.end(); ++it) {
-          const size_type index = it->first * stride + start;
-
-          // Broadcast the tile
-          const madness::DistributedID key(DistEvalImpl_::id(), index + key_offset);
-          TensorImpl_::world().gop.bcast(key, it->second, group_root, group);
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-          ss  << index << " ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
+        detail::ProfileScope profile("summa_bcast", "comm", start);
+        const bool trace = SummaTrace::instance().enabled();
+        std::size_t bytes = 0ul;
+
+        // A group of one process, e.g. in a single process world, holds the
+        // tiles already, so they are used without a broadcast.
+        if(group.size() > 1) {
+          bcast_tiles(arg, start, stride, group, group_root, key_offset,
+              category, vec);
+
+          // Count the tiles sent by this process
+          if((profile.enabled() || trace) && (group.rank() == group_root))
+            for(const auto& datum : vec)
+              if(datum.second.probe())
+                bytes += detail::tile_bytes(datum.second.get());
         }
 
         TA_ASSERT(vec.size() > 0ul);
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
-        ss << "}\n";
-        printf(ss.str().c_str());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_BCAST
+        profile.add_bytes(bytes);
+        SummaTrace::instance().record((category == CommCategory::summa_col ?
+            SummaEventKind::bcast_col : SummaEventKind::bcast_row),
+            DistEvalImpl_::id().get_obj_id(), k, bytes, vec.size(), group.size());
       }
 
       // Broadcast specialization for left and right arguments -----------------
@@ -575,7 +836,7 @@ namespace TiledArray {
       ProcessID get_row_group_root(const size_type k, const madness::Group& row_group) const {
         ProcessID group_root = k % proc_grid_.proc_cols();
         if(! right_.shape().is_dense() && row_group.size() < static_cast<ProcessID>(proc_grid_.proc_cols())) {
-          const ProcessID world_root = proc_grid_.rank_row() * proc_grid_.proc_cols() + group_root;
+          const ProcessID world_root = proc_grid_.map_col(group_root);
           group_root = row_group.rank(world_root);
         }
         return group_root;
@@ -584,7 +845,7 @@ namespace TiledArray {
       ProcessID get_col_group_root(const size_type k, const madness::Group& col_group) const {
         ProcessID group_root = k % proc_grid_.proc_rows();
         if(! left_.shape().is_dense() && col_group.size() < static_cast<ProcessID>(proc_grid_.proc_rows())) {
-          const ProcessID world_root = group_root * proc_grid_.proc_cols() + proc_grid_.rank_col();
+          const ProcessID world_root = proc_grid_.map_row(group_root);
           group_root = col_group.rank(world_root);
         }
         return group_root;
@@ -599,7 +860,8 @@ namespace TiledArray {
         if (!row_group.empty()) {
           // Broadcast column k of left_.
           ProcessID group_root = get_row_group_root(k, row_group);
-          bcast(left_start_local_ + k, left_stride_local_, row_group, group_root, 0ul, col);
+          bcast(left_, k, left_start_local_ + k, left_stride_local_, row_group, group_root, 0ul,
+              CommCategory::summa_col, col);
         }
       }
 
@@ -614,26 +876,34 @@ namespace TiledArray {
           ProcessID group_root = get_col_group_root(k, col_group);
 
           // Broadcast row k of right_.
-          bcast(k * proc_grid_.cols() + proc_grid_.rank_col(),
-                right_stride_local_, col_group, group_root, left_.size(), row);
+          bcast(right_, k, k * proc_grid_.cols() + proc_grid_.rank_col(),
+                right_stride_local_, col_group, group_root, left_.size(),
+                CommCategory::summa_row, row);
         }
       }
 
       void bcast_col_range_task(size_type k, const size_type end) const {
-        // Compute the first local row of right
+        // Compute the first local column of left. With more than one layer,
+        // only the columns that belong to this layer are visited.
         const size_type Pcols = proc_grid_.proc_cols();
-        k += (Pcols - ((k + Pcols - proc_grid_.rank_col()) % Pcols)) % Pcols;
+        const size_type layers = proc_grid_.layers();
+        const size_type k_stride = (layers == 1u ? Pcols : layers);
+        if(layers == 1u)
+          k += (Pcols - ((k + Pcols - proc_grid_.rank_col()) % Pcols)) % Pcols;
 
-        for(; k < end; k += Pcols) {
+        for(; k < end; k += k_stride) {
+          if((k % Pcols) != size_type(proc_grid_.rank_col())) continue;
 
           // Compute local iteration limits for column k of left_.
-          size_type index = left_start_local_ + k;
+          const size_type start = left_start_local_ + k;
+          size_type index = start;
 
           // will create broadcast group only if needed
           bool have_group = false;
           madness::Group row_group;
           ProcessID group_root;
           bool do_broadcast;
+          std::vector<col_datum> col;
 
           // Search column k of left for non-zero tiles
           for(; index < left_end_; index += left_stride_local_) {
@@ -650,35 +920,45 @@ namespace TiledArray {
             }
 
             if(do_broadcast) {
-              // Broadcast the tile
-              const madness::DistributedID key(DistEvalImpl_::id(), index);
-              auto tile = get_tile(left_, index);
-              TensorImpl_::world().gop.bcast(key, tile, group_root, row_group);
+              // Collect the tile
+              col.emplace_back((index - start) / left_stride_local_,
+                  get_tile(left_, index));
             } else {
               // Discard the tile
               left_.discard(index);
             }
           }
+
+          // Broadcast the tiles
+          if(! col.empty())
+            bcast_tiles(left_, start, left_stride_local_, row_group, group_root,
+                0ul, CommCategory::summa_col, col);
         }
       }
 
       void bcast_row_range_task(size_type k, const size_type end) const {
-        // Compute the first local row of right
+        // Compute the first local row of right. With more than one layer,
+        // only the rows that belong to this layer are visited.
         const size_type Prows = proc_grid_.proc_rows();
-        k += (Prows - ((k + Prows - proc_grid_.rank_row()) % Prows)) % Prows;
+        const size_type layers = proc_grid_.layers();
+        const size_type k_stride = (layers == 1u ? Prows : layers);
+        if(layers == 1u)
+          k += (Prows - ((k + Prows - proc_grid_.rank_row()) % Prows)) % Prows;
 
-        for(; k < end; k += Prows) {
+        for(; k < end; k += k_stride) {
+          if((k % Prows) != size_type(proc_grid_.rank_row())) continue;
 
           // Compute local iteration limits for row k of right_.
-          size_type index = k * proc_grid_.cols();
-          const size_type row_end = index + proc_grid_.cols();
-          index += proc_grid_.rank_col();
+          const size_type start = k * proc_grid_.cols() + proc_grid_.rank_col();
+          const size_type row_end = k * proc_grid_.cols() + proc_grid_.cols();
+          size_type index = start;
 
           // will create broadcast group only if needed
           bool have_group = false;
           madness::Group col_group;
           ProcessID group_root;
           bool do_broadcast;
+          std::vector<row_datum> row;
 
           // Search for and broadcast non-zero row
           for(; index < row_end; index += right_stride_local_) {
@@ -695,103 +975,94 @@ namespace TiledArray {
             }
 
             if(do_broadcast) {
-              // Broadcast the tile
-              const madness::DistributedID key(DistEvalImpl_::id(), index + left_.size());
-              auto tile = get_tile(right_, index);
-              TensorImpl_::world().gop.bcast(key, tile, group_root, col_group);
+              // Collect the tile
+              row.emplace_back((index - start) / right_stride_local_,
+                  get_tile(right_, index));
             } else {
               // Discard the tile
               right_.discard(index);
             }
           }
+
+          // Broadcast the tiles
+          if(! row.empty())
+            bcast_tiles(right_, start, right_stride_local_, col_group, group_root,
+                left_.size(), CommCategory::summa_row, row);
         }
       }
 
 
       // Row and column iteration functions ------------------------------------
 
-      /// Find next non-zero row of \c right_ for a sparse shape
-
-      /// Starting at the k-th row of the right-hand argument, find the next row
-      /// that contains at least one non-zero tile. This search only checks for
-      /// non-zero tiles in this processes column.
-      /// \param k The first row to search
-      /// \return The first row, greater than or equal to \c k with non-zero
-      /// tiles, or \c k_ if none is found.
-      size_type iterate_row(size_type k) const {
-        // Iterate over k's until a non-zero tile is found or the end of the
-        // matrix is reached.
-        size_type end = k * proc_grid_.cols();
-        for(; k < k_; ++k) {
-          // Search for non-zero tiles in row k of right
-          size_type i = end + proc_grid_.rank_col();
-          end += proc_grid_.cols();
-          for(; i < end; i += right_stride_local_)
-            if(! right_.shape().is_zero(i))
-              return k;
-        }
-
-        return k;
+      /// Check for non-zero tiles in row \c k of \c right_
+
+      /// This search only checks for non-zero tiles in this process's column.
+      /// \param k The row to search
+      /// \return \c true if row \c k has a local non-zero tile
+      bool is_nonzero_row(const size_type k) const {
+        size_type i = k * proc_grid_.cols();
+        const size_type end = i + proc_grid_.cols();
+        i += proc_grid_.rank_col();
+        for(; i < end; i += right_stride_local_)
+          if(! right_.shape().is_zero(i))
+            return true;
+        return false;
       }
 
-      /// Find the next non-zero column of \c left_ for an arbitrary shape type
-
-      /// Starting at the k-th column of the left-hand argument, find the next
-      /// column that contains at least one non-zero tile. This search only
-      /// checks for non-zero tiles in this process's row.
-      /// \param k The first column to test for non-zero tiles
-      /// \return The first column, greater than or equal to \c k, that contains
-      /// a non-zero tile. If no non-zero tile is not found, return \c k_.
-      size_type iterate_col(size_type k) const {
-        // Iterate over k's until a non-zero tile is found or the end of the
-        // matrix is reached.
-        for(; k < k_; ++k)
-          // Search row k for non-zero tiles
-          for(size_type i = left_start_local_ + k; i < left_end_; i += left_stride_local_)
-            if(! left_.shape().is_zero(i))
-              return k;
-
-        return k;
+      /// Check for non-zero tiles in column \c k of \c left_
+
+      /// This search only checks for non-zero tiles in this process's row.
+      /// \param k The column to search
+      /// \return \c true if column \c k has a local non-zero tile
+      bool is_nonzero_col(const size_type k) const {
+        for(size_type i = left_start_local_ + k; i < left_end_; i += left_stride_local_)
+          if(! left_.shape().is_zero(i))
+            return true;
+        return false;
       }
 
+      /// Find the SUMMA iterations of a sparse contraction
+
+      /// The iterations of this process's layer where the local column of
+      /// \c left_ and the local row of \c right_ both have non-zero tiles are
+      /// stored in \c k_steps_ , so the step tasks skip empty iterations
+      /// without searching the shapes.
+      void init_k_steps() {
+        k_steps_.clear();
+        for(size_type k = proc_grid_.rank_layer(); k < k_; k += proc_grid_.layers())
+          if(is_nonzero_col(k) && is_nonzero_row(k))
+            k_steps_.push_back(k);
+      }
 
       /// Find the next k where the left- and right-hand argument have non-zero tiles
 
       /// Search for the next k-th column and row of the left- and right-hand
-      /// arguments, respectively, that both contain non-zero tiles. This search
-      /// only checks for non-zero tiles in this process's row or column. If a
-      /// non-zero, local tile is found that does not contribute to local
+      /// arguments, respectively, that both contain non-zero tiles in this
+      /// process's row or column (see \c init_k_steps() ). If a non-zero,
+      /// local tile is skipped that does not contribute to local
       /// contractions, the tiles will be immediately broadcast.
       /// \param k The first row/column to check
       /// \return The next k-th column and row of the left- and right-hand
-      /// arguments, respectively, that both have non-zero tiles
+      /// arguments, respectively, that both have non-zero tiles, or \c k_ if
+      /// there are none
       size_type iterate_sparse(const size_type k) const {
-        // Initial step for k_col and k_row.
-        size_type k_col = iterate_col(k);
-        size_type k_row = iterate_row(k_col);
-
-        // Search for a row and column that both have non-zero tiles
-        while(k_col != k_row) {
-          if(k_col < k_row) {
-            k_col = iterate_col(k_row);
-          } else {
-            k_row = iterate_row(k_col);
-          }
-        }
+        const typename std::vector<size_type>::const_iterator it =
+            std::lower_bound(k_steps_.begin(), k_steps_.end(), k);
+        const size_type k_next = (it != k_steps_.end() ? *it : k_);
 
-        if(k < k_row) {
+        if(k < k_next) {
           // Spawn a task to broadcast any local columns of left that were skipped
           TensorImpl_::world().taskq.add(shared_from_this(),
-              & Summa_::bcast_col_range_task, k, k_row,
+              & Summa_::bcast_col_range_task, k, k_next,
               madness::TaskAttributes::hipri());
 
           // Spawn a task to broadcast any local rows of right that were skipped
           TensorImpl_::world().taskq.add(shared_from_this(),
-              & Summa_::bcast_row_range_task, k, k_col,
+              & Summa_::bcast_row_range_task, k, k_next,
               madness::TaskAttributes::hipri());
         }
 
-        return k_col;
+        return k_next;
       }
 
 
@@ -821,203 +1092,340 @@ namespace TiledArray {
         const madness::DistributedID row_did(DistEvalImpl_::id(), k_);
         row_group_ = proc_grid_.make_row_group(row_did);
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        std::stringstream ss;
-        ss << "init: rank=" << TensorImpl_::world().rank()
-           << "\n    col_group_=(" << col_did.first << ", " << col_did.second << ") { ";
-        for(ProcessID gproc = 0ul; gproc < col_group_.size(); ++gproc)
-          ss << col_group_.world_rank(gproc) << " ";
-        ss << "}\n    row_group_=(" << row_did.first << ", " << row_did.second << ") { ";
-        for(ProcessID gproc = 0ul; gproc < row_group_.size(); ++gproc)
-          ss << row_group_.world_rank(gproc) << " ";
-        ss << "}\n";
-        printf(ss.str().c_str());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-
         // Allocate memory for the reduce pair tasks.
         std::allocator<ReducePairTask<op_type> > alloc;
-        reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
+        reduce_task_count_ = proc_grid_.local_size();
+        reduce_tasks_ = alloc.allocate(reduce_task_count_);
 
         // Iterate over all local tiles
-        const size_type n = proc_grid_.local_size();
-        for(size_type t = 0ul; t < n; ++t) {
-          // Initialize the reduction task
-          ReducePairTask<op_type>* MADNESS_RESTRICT const reduce_task = reduce_tasks_ + t;
-          new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
-        }
+        const size_type local_rows = proc_grid_.local_rows();
+        const size_type local_cols = proc_grid_.local_cols();
+        ReducePairTask<op_type>* MADNESS_RESTRICT reduce_task = reduce_tasks_;
+        for(size_type i = 0ul; i < local_rows; ++i)
+          for(size_type j = 0ul; j < local_cols; ++j, ++reduce_task)
+            construct_reduce_task(reduce_task, reduce_task_tile(i, j));
 
         return proc_grid_.local_size();
       }
 
       /// Initialize reduce tasks
+
+      /// Reduce tasks are only allocated for the local tiles that are
+      /// non-zero in \c shape . They are stored row by row, where
+      /// \c reduce_task_rows_ holds the first task of each local row and
+      /// \c reduce_task_cols_ holds the local column of each task, so the
+      /// memory and the cost of finalizing the tasks are proportional to the
+      /// number of non-zero result tiles.
+      /// \tparam Shape The result shape type
+      /// \param shape The result shape
+      /// \return The number of reduce tasks
       template <typename Shape>
       size_type initialize(const Shape& shape) {
+        // Find the non-zero local tiles
+        const size_type local_rows = proc_grid_.local_rows();
+        const size_type local_cols = proc_grid_.local_cols();
+        reduce_task_rows_.clear();
+        reduce_task_rows_.reserve(local_rows + 1ul);
+        reduce_task_rows_.push_back(0ul);
+        reduce_task_cols_.clear();
+        for(size_type i = 0ul; i < local_rows; ++i) {
+          for(size_type j = 0ul; j < local_cols; ++j) {
+            const size_type index = reduce_task_tile(i, j);
+            if(! shape.is_zero(DistEvalImpl_::perm_index_to_target(index))) {
+              reduce_task_cols_.push_back(j);
+            }
+          }
+          reduce_task_rows_.push_back(reduce_task_cols_.size());
+        }
+        reduce_task_cols_.shrink_to_fit();
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        std::stringstream ss;
-        ss << "    initialize rank=" << TensorImpl_::world().rank() << " tiles={ ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-
-        // Allocate memory for the reduce pair tasks.
+        // Allocate and initialize the reduce pair tasks.
         std::allocator<ReducePairTask<op_type> > alloc;
-        reduce_tasks_ = alloc.allocate(proc_grid_.local_size());
-
-        // Initialize iteration variables
-        size_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
-        size_type row_end = row_start + proc_grid_.cols();
-        row_start += proc_grid_.rank_col();
-        const size_type col_stride = // The stride to iterate down a column
-            proc_grid_.proc_rows() * proc_grid_.cols();
-        const size_type row_stride = // The stride to iterate across a row
-            proc_grid_.proc_cols();
-        const size_type end = TensorImpl_::size();
-
-        // Iterate over all local tiles
-        size_type tile_count = 0ul;
-        ReducePairTask<op_type>* MADNESS_RESTRICT reduce_task = reduce_tasks_;
-        // this loops over result tiles arranged in block-cyclic order
-        // index = tile index (row major)
-        for(; row_start < end; row_start += col_stride, row_end += col_stride) {
-          for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
-
-            // Initialize the reduction task
+        reduce_task_count_ = reduce_task_cols_.size();
+        reduce_tasks_ = alloc.allocate(reduce_task_count_);
+        for(size_type i = 0ul; i < local_rows; ++i)
+          for(size_type t = reduce_task_rows_[i]; t < reduce_task_rows_[i + 1ul]; ++t)
+            construct_reduce_task(reduce_tasks_ + t,
+                reduce_task_tile(i, reduce_task_cols_[t]));
+
+        return reduce_task_count_;
+      }
 
-            // Skip zero tiles
-            if(! shape.is_zero(DistEvalImpl_::perm_index_to_target(index))) {
+      /// Result tile index of a local tile
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-              ss << index << " ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+      /// \param row The local row of the tile
+      /// \param col The local column of the tile
+      /// \return The (unpermuted) index of the result tile
+      size_type reduce_task_tile(const size_type row, const size_type col) const {
+        return (proc_grid_.rank_row() + row * proc_grid_.proc_rows()) * proc_grid_.cols()
+            + proc_grid_.rank_col() + col * proc_grid_.proc_cols();
+      }
 
-              new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
-              ++tile_count;
-            } else {
-              // Construct an empty task to represent zero tiles.
-              new(reduce_task) ReducePairTask<op_type>();
-            }
-          }
+      /// Visit the reduce tasks
+
+      /// \tparam Op The visitor type
+      /// \param op The visitor, which is called with the (unpermuted) index of
+      /// the result tile and its reduce task, in row-major order
+      template <typename Op>
+      void for_each_reduce_task(const Op& op) {
+        const size_type local_rows = proc_grid_.local_rows();
+        const size_type local_cols = proc_grid_.local_cols();
+        if(reduce_task_rows_.empty()) {
+          // Every local tile has a reduce task
+          ReducePairTask<op_type>* MADNESS_RESTRICT reduce_task = reduce_tasks_;
+          for(size_type i = 0ul; i < local_rows; ++i)
+            for(size_type j = 0ul; j < local_cols; ++j, ++reduce_task)
+              op(reduce_task_tile(i, j), *reduce_task);
+        } else {
+          for(size_type i = 0ul; i < local_rows; ++i)
+            for(size_type t = reduce_task_rows_[i]; t < reduce_task_rows_[i + 1ul]; ++t)
+              op(reduce_task_tile(i, reduce_task_cols_[t]), reduce_tasks_[t]);
         }
+      }
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        ss << "}\n";
-        printf(ss.str().c_str());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+      /// Construct a reduce task
 
-        return tile_count;
+      /// When the costs of the result tiles are recorded, the task records
+      /// the time of its tile pair contractions.
+      /// \param reduce_task The memory of the task
+      /// \param index The (unpermuted) index of the result tile of the task
+      void construct_reduce_task(ReducePairTask<op_type>* const reduce_task,
+          const size_type index)
+      {
+        TileCostRecorder* const cost_recorder = DistEvalImpl_::cost_recorder();
+        if(cost_recorder)
+          new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(),
+              ReducePairOpWrapper<op_type>(op_, cost_recorder,
+              DistEvalImpl_::perm_index_to_target(index)));
+        else
+          new(reduce_task) ReducePairTask<op_type>(TensorImpl_::world(), op_);
       }
 
-      size_type initialize() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        printf("init: start rank=%i\n", TensorImpl_::world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+      /// Destroy the reduce tasks and deallocate their memory
+      void destroy_reduce_tasks() {
+        for(size_type t = 0ul; t < reduce_task_count_; ++t)
+          reduce_tasks_[t].~ReducePairTask<op_type>();
+        std::allocator<ReducePairTask<op_type> >().deallocate(reduce_tasks_,
+            reduce_task_count_);
+        reduce_task_count_ = 0ul;
+        reduce_task_rows_ = std::vector<size_type>();
+        reduce_task_cols_ = std::vector<size_type>();
+      }
 
-        const size_type result = initialize(TensorImpl_::shape());
+      /// Seed the local reduce tasks with the initial result tiles
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
-        printf("init: finish rank=%i\n", TensorImpl_::world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_INITIALIZE
+      /// Only the first layer is seeded, since the partial results of the
+      /// other layers are added to its result.
+      void seed_reduce_tasks() {
+        if(! seed_.is_initialized() || (proc_grid_.rank_layer() > 0u))
+          return;
 
-        return result;
+        for_each_reduce_task([this] (const size_type index,
+            ReducePairTask<op_type>& reduce_task)
+        {
+          const size_type perm_index = DistEvalImpl_::perm_index_to_target(index);
+          if(reduce_task && ! seed_.is_zero(perm_index))
+            reduce_task.seed(seed_.find(perm_index));
+        });
       }
 
+      size_type initialize() { return initialize(TensorImpl_::shape()); }
+
 
       // Finalize functions ----------------------------------------------------
 
-      /// Set the result tiles, destroy reduce tasks, and destroy broadcast groups
-      void finalize(const DenseShape&) {
-        // Initialize iteration variables
-        size_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
-        size_type row_end = row_start + proc_grid_.cols();
-        row_start += proc_grid_.rank_col();
-        const size_type col_stride = // The stride to iterate down a column
-            proc_grid_.proc_rows() * proc_grid_.cols();
-        const size_type row_stride = // The stride to iterate across a row
-            proc_grid_.proc_cols();
-        const size_type end = TensorImpl_::size();
+      /// Number of SUMMA iterations evaluated by this process's layer
 
-        // Iterate over all local tiles
-        for(ReducePairTask<op_type>* reduce_task = reduce_tasks_;
-            row_start < end; row_start += col_stride, row_end += col_stride) {
-          for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
+      /// \return The number of \c k in <tt>[0,k_)</tt> that belong to the
+      /// layer of this process
+      size_type layer_k_size() const {
+        const size_type layer = proc_grid_.rank_layer();
+        return (layer < k_ ?
+            (k_ - layer + proc_grid_.layers() - 1ul) / proc_grid_.layers() : 0ul);
+      }
+
+      /// Reduce a partial result tile from another layer
 
+      /// \param tile The partial result of this layer
+      /// \param partial The partial result of another layer
+      /// \return The sum of \c tile and \c partial
+      value_type reduce_layer_tiles(const value_type& tile, const value_type& partial) const {
+        using TiledArray::empty;
+        if(empty(tile))
+          return partial;
 
-            // Set the result tile
-            DistEvalImpl_::set_tile(DistEvalImpl_::perm_index_to_target(index),
-                reduce_task->submit());
+        value_type result = tile;
+        if(! empty(partial))
+          op_(result, partial);
+        return result;
+      }
+
+      /// Construct a zero result tile
+
+      /// \param perm_index The permuted index of the result tile
+      /// \return A tile of \c perm_index that is filled with zeros
+      value_type zero_tile(const size_type perm_index) const {
+        return value_type(TensorImpl_::trange().make_tile_range(perm_index),
+            typename numeric_type<value_type>::type(0));
+      }
 
-            // Destroy the reduce task
-            reduce_task->~ReducePairTask<op_type>();
+      /// Set the result tile with the result of a reduce task
+
+      /// For a single layer process grid, the result of \c reduce_task is the
+      /// result tile. Otherwise, the result of \c reduce_task is a partial
+      /// result; it is sent to the process in the first layer with the same
+      /// grid coordinate, which sums the partial results of all layers before
+      /// setting the result tile.
+      /// \param perm_index The permuted index of the result tile
+      /// \param reduce_task The reduce task for the result tile
+      void set_tile(const size_type perm_index, ReducePairTask<op_type>& reduce_task) {
+        SummaTrace::instance().record(SummaEventKind::reduce_submit,
+            DistEvalImpl_::id().get_obj_id(), perm_index, 0ul, reduce_task.count());
+
+        // The tile pairs of a non-zero tile may all be skipped by the
+        // contraction filter, in which case the result tile is zero.
+        const size_type layers = proc_grid_.layers();
+        const size_type layer = proc_grid_.rank_layer();
+        if(layers == 1u) {
+          DistEvalImpl_::set_tile(perm_index, (reduce_task.count() ?
+              reduce_task.submit() : Future<value_type>(zero_tile(perm_index))));
+          return;
+        }
+
+        // Other layers that have no tile pairs for this tile contribute an
+        // empty tile
+        Future<value_type> tile = (reduce_task.count() ? reduce_task.submit() :
+            Future<value_type>(layer == 0u ? zero_tile(perm_index) : value_type()));
+
+        World& world = TensorImpl_::world();
+        if(layer == 0u) {
+          for(size_type l = 1ul; l < layers; ++l) {
+            const madness::DistributedID key(DistEvalImpl_::id(),
+                perm_index + l * TensorImpl_::size());
+            Future<value_type> partial =
+                world.gop.template recv<value_type>(proc_grid_.map_layer(l), key);
+            tile = world.taskq.add(shared_from_this(),
+                & Summa_::reduce_layer_tiles, tile, partial,
+                madness::TaskAttributes::hipri());
           }
+
+          DistEvalImpl_::set_tile(perm_index, tile);
+        } else {
+          const madness::DistributedID key(DistEvalImpl_::id(),
+              perm_index + layer * TensorImpl_::size());
+          world.gop.send(proc_grid_.map_layer(0ul), key, tile);
         }
+      }
 
-        // Deallocate the memory for the reduce pair tasks.
-        std::allocator<ReducePairTask<op_type> >().deallocate(reduce_tasks_,
-            proc_grid_.local_size());
+      /// Set the result tiles, destroy reduce tasks, and destroy broadcast groups
+      void finalize(const DenseShape&) {
+        for_each_reduce_task([this] (const size_type index,
+            ReducePairTask<op_type>& reduce_task)
+        { set_tile(DistEvalImpl_::perm_index_to_target(index), reduce_task); });
+
+        destroy_reduce_tasks();
       }
 
       /// Set the result tiles and destroy reduce tasks
+
+      /// Only the non-zero tiles of the result have reduce tasks (see
+      /// \c initialize() ), so zero tiles are not visited.
       template <typename Shape>
-      void finalize(const Shape& shape) {
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-        std::stringstream ss;
-        ss << "    finalize rank=" << TensorImpl_::world().rank() << " tiles={ ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-
-        // Initialize iteration variables
-        size_type row_start = proc_grid_.rank_row() * proc_grid_.cols();
-        size_type row_end = row_start + proc_grid_.cols();
-        row_start += proc_grid_.rank_col();
-        const size_type col_stride = // The stride to iterate down a column
-            proc_grid_.proc_rows() * proc_grid_.cols();
-        const size_type row_stride = // The stride to iterate across a row
-            proc_grid_.proc_cols();
-        const size_type end = TensorImpl_::size();
+      void finalize(const Shape&) {
+        for_each_reduce_task([this] (const size_type index,
+            ReducePairTask<op_type>& reduce_task)
+        {
+          // Set the result tile
+          this->set_tile(DistEvalImpl_::perm_index_to_target(index), reduce_task);
+        });
 
-        // Iterate over all local tiles
-        for(ReducePairTask<op_type>* reduce_task = reduce_tasks_;
-            row_start < end; row_start += col_stride, row_end += col_stride) {
-          for(size_type index = row_start; index < row_end; index += row_stride, ++reduce_task) {
-            // Compute the permuted index
-            const size_type perm_index = DistEvalImpl_::perm_index_to_target(index);
+        destroy_reduce_tasks();
+      }
 
-            // Skip zero tiles
-            if(! shape.is_zero(perm_index)) {
+      void finalize() {
+        // Record the average time between SUMMA steps
+        const int step_count = step_count_;
+        if(step_count > 0)
+          SummaDepthController::instance().record_step_time(
+              SummaDepthController::elapsed(start_time_) / double(step_count));
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-              ss << index << " ";
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
+        finalize(TensorImpl_::shape());
 
-              // Set the result tile
-              DistEvalImpl_::set_tile(perm_index, reduce_task->submit());
-            }
+        // All tile pairs of this process have been added, so this process
+        // may steal pairs once its own pairs are taken.
+        if(steal_pool_)
+          steal_pool_->close();
+      }
+
+      /// Broadcast latency timer
+
+      /// This object records the time from the start of a SUMMA step until all
+      /// argument tiles of the step have arrived with \c SummaDepthController
+      /// and \c SummaTrace .
+      class BcastTimer : public madness::CallbackInterface {
+      private:
+        const SummaDepthController::time_point start_; ///< Start time of the step
+        const std::uint64_t trace_start_; ///< Trace time of the start of the step
+        const std::uint64_t object_; ///< The id of the contraction
+        const size_type k_; ///< The step
+        madness::AtomicInt count_; ///< Number of tiles that have not arrived
+
+        BcastTimer(const std::uint64_t object, const size_type k) :
+          start_(SummaDepthController::now()),
+          trace_start_(SummaTrace::instance().now()), object_(object), k_(k),
+          count_()
+        {
+          count_ = 1;
+        }
 
-            // Destroy the reduce task
-            reduce_task->~ReducePairTask<op_type>();
+        template <typename Datum>
+        void register_callbacks(std::vector<Datum>& vec) {
+          for(typename std::vector<Datum>::iterator it = vec.begin(); it != vec.end(); ++it) {
+            if(it->second.probe()) continue;
+            ++count_;
+            it->second.register_callback(this);
           }
         }
 
-        // Deallocate the memory for the reduce pair tasks.
-        std::allocator<ReducePairTask<op_type> >().deallocate(reduce_tasks_,
-            proc_grid_.local_size());
+      public:
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-        ss << "}\n";
-        printf(ss.str().c_str());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-      }
+        virtual ~BcastTimer() { }
 
-      void finalize() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-        printf("finalize: start rank=%i\n", TensorImpl_::world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
+        /// Start timing the arrival of the tiles of a step
 
-        finalize(TensorImpl_::shape());
+        /// Nothing is recorded by \c SummaDepthController if all tiles are
+        /// already available.
+        /// \param object The id of the contraction
+        /// \param k The step
+        /// \param col The column of tiles from the left-hand argument
+        /// \param row The row of tiles from the right-hand argument
+        static void start(const std::uint64_t object, const size_type k,
+            std::vector<col_datum>& col, std::vector<row_datum>& row)
+        {
+          BcastTimer* const timer = new BcastTimer(object, k);
+          timer->register_callbacks(col);
+          timer->register_callbacks(row);
+          if(timer->count_ == 1) {
+            SummaTrace::instance().record(SummaEventKind::tiles_ready, object, k);
+            delete timer;
+          } else {
+            timer->notify();
+          }
+        }
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-        printf("finalize: finish rank=%i\n", TensorImpl_::world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_FINALIZE
-      }
+        virtual void notify() {
+          if((--count_) == 0) {
+            SummaDepthController::instance().record_latency(
+                SummaDepthController::elapsed(start_));
+            SummaTrace& trace = SummaTrace::instance();
+            if(trace.enabled())
+              trace.record(SummaEventKind::tiles_ready, object_, k_,
+                  trace.now() - trace_start_);
+            delete this;
+          }
+        }
+
+      }; // class BcastTimer
 
       /// SUMMA finalization task
 
@@ -1041,6 +1449,88 @@ namespace TiledArray {
 
       // Contraction functions -------------------------------------------------
 
+      /// The block size of the tile contractions of a SUMMA step
+
+      /// The size is chosen by \c SummaOrderPolicy from the sizes of the first
+      /// tiles of \c col and \c row .
+      /// \param k The SUMMA step
+      /// \param col A column of tiles from the left-hand argument
+      /// \param row A row of tiles from the right-hand argument
+      /// \return The number of rows and columns of a block of contractions
+      size_type block_size(const size_type k, const std::vector<col_datum>& col,
+          const std::vector<row_datum>& row) const
+      {
+        typedef typename numeric_type<typename left_type::eval_type>::type left_numeric_type;
+        typedef typename numeric_type<typename right_type::eval_type>::type right_numeric_type;
+
+        if(col.empty() || row.empty())
+          return 1ul;
+        const size_type left_index = left_start_local_ + k +
+            col.front().first * left_stride_local_;
+        const size_type right_index = k * proc_grid_.cols() +
+            proc_grid_.rank_col() + row.front().first * right_stride_local_;
+        return SummaOrderPolicy::instance().block_size(
+            left_.trange().make_tile_range(left_index).volume() *
+                sizeof(left_numeric_type),
+            right_.trange().make_tile_range(right_index).volume() *
+                sizeof(right_numeric_type));
+      }
+
+      /// Volume of the contracted modes of a SUMMA step
+
+      /// \param k The SUMMA step
+      /// \return The product of the extents of the contracted (i.e. leading)
+      /// modes of the right-hand tiles of step \c k
+      size_type k_volume(const size_type k) const {
+        const unsigned int k_rank = op_.gemm_helper().num_contract_ranks();
+        const auto index = right_.trange().tiles_range().idx(k * proc_grid_.cols());
+        size_type volume = 1ul;
+        for(unsigned int d = 0u; d < k_rank; ++d) {
+          const auto& tile = right_.trange().dim(d).tile(index[d]);
+          volume *= tile.second - tile.first;
+        }
+        return volume;
+      }
+
+      /// Processes that are asked for stealable tile pairs
+
+      /// \return The other processes of the row and column of this process
+      /// in the process grid, or an empty list if this process is not in the
+      /// grid
+      std::vector<ProcessID> steal_victims() const {
+        std::vector<ProcessID> victims;
+        if(proc_grid_.local_size() == 0ul)
+          return victims;
+        for(size_type col = 0ul; col < proc_grid_.proc_cols(); ++col)
+          if(ProcessID(col) != proc_grid_.rank_col())
+            victims.push_back(proc_grid_.map_col(col));
+        for(size_type row = 0ul; row < proc_grid_.proc_rows(); ++row)
+          if(ProcessID(row) != proc_grid_.rank_row())
+            victims.push_back(proc_grid_.map_row(row));
+        return victims;
+      }
+
+      /// Add a tile pair to a reduce task
+
+      /// The pairs of the last iterations are added to the stealable pair
+      /// pool when work stealing is enabled (see \c SummaStealPolicy ), and
+      /// their partial results are added to the reduce task.
+      /// \param k The SUMMA step
+      /// \param reduce_task The reduce task of the result tile
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      /// \param task The task that depends on the tile contraction
+      /// \param hipri The high priority flag of the tile contraction
+      void add_pair(const size_type k, ReducePairTask<op_type>& reduce_task,
+          const left_future& left, const right_future& right,
+          madness::TaskInterface* const task, const bool hipri)
+      {
+        if(steal_pool_ && (k >= steal_k_))
+          reduce_task.add_result(steal_pool_->add(left, right, hipri), task, hipri);
+        else
+          reduce_task.add(left, right, task, hipri);
+      }
+
       /// Schedule local contraction tasks for \c col and \c row tile pairs
 
       /// Schedule tile contractions for each tile pair of \c row and \c col. A
@@ -1049,25 +1539,36 @@ namespace TiledArray {
       /// \param col A column of tiles from the left-hand argument
       /// \param row A row of tiles from the right-hand argument
       /// \param task The task that depends on tile contraction tasks
-      void contract(const DenseShape&, const size_type,
+      void contract(const DenseShape&, const size_type k,
           const std::vector<col_datum>& col, const std::vector<row_datum>& row,
           madness::TaskInterface* const task)
       {
-        // Iterate over the row
-        for(size_type i = 0ul; i < col.size(); ++i) {
-          // Compute the local, result-tile offset
-          const size_type reduce_task_offset = col[i].first * proc_grid_.local_cols();
-
-          // Iterate over columns
-          for(size_type j = 0ul; j < row.size(); ++j) {
-            const size_type reduce_task_index = reduce_task_offset + row[j].first;
-
-            // Schedule task for contraction pairs
-            if(task)
-              task->inc();
-            const left_future left = col[i].second;
-            const right_future right = row[j].second;
-            reduce_tasks_[reduce_task_index].add(left, right, task);
+        const bool hipri = SummaPriorityPolicy::instance().reduce_hipri(k, k_);
+        const size_type block = block_size(k, col, row);
+
+        // Iterate over blocks of rows and columns
+        for(size_type i0 = 0ul; i0 < col.size(); i0 += block) {
+          const size_type i1 = i0 + std::min(block, col.size() - i0);
+          for(size_type j0 = 0ul; j0 < row.size(); j0 += block) {
+            const size_type j1 = j0 + std::min(block, row.size() - j0);
+
+            // Iterate over the rows of the block
+            for(size_type i = i0; i < i1; ++i) {
+              // Compute the local, result-tile offset
+              const size_type reduce_task_offset = col[i].first * proc_grid_.local_cols();
+
+              // Iterate over the columns of the block
+              for(size_type j = j0; j < j1; ++j) {
+                const size_type reduce_task_index = reduce_task_offset + row[j].first;
+
+                // Schedule task for contraction pairs
+                if(task)
+                  task->inc();
+                const left_future left = col[i].second;
+                const right_future right = row[j].second;
+                add_pair(k, reduce_tasks_[reduce_task_index], left, right, task, hipri);
+              }
+            }
           }
         }
       }
@@ -1081,34 +1582,58 @@ namespace TiledArray {
       /// \param row A row of tiles from the right-hand argument
       /// \param task The task that depends on tile contraction tasks
       template <typename Shape>
-      void contract(const Shape&, const size_type,
+      void contract(const Shape&, const size_type k,
           const std::vector<col_datum>& col, const std::vector<row_datum>& row,
           madness::TaskInterface* const task)
       {
-        // Iterate over the row
-        for(size_type i = 0ul; i < col.size(); ++i) {
-          // Compute the local, result-tile offset
-          const size_type reduce_task_offset = col[i].first * proc_grid_.local_cols();
-
-          // Iterate over columns
-          for(size_type j = 0ul; j < row.size(); ++j) {
-            const size_type reduce_task_index = reduce_task_offset + row[j].first;
-
-            // Skip zero tiles
-            if(! reduce_tasks_[reduce_task_index])
-              continue;
-
-            // Schedule task for contraction pairs
-            if(task)
-              task->inc();
-            const left_future left = col[i].second;
-            const right_future right = row[j].second;
-            reduce_tasks_[reduce_task_index].add(left, right, task);
+        const bool hipri = SummaPriorityPolicy::instance().reduce_hipri(k, k_);
+        const size_type block = block_size(k, col, row);
+
+        // The position of each row of a block in the row and its reduce tasks
+        std::vector<size_type> rows_j, rows_t;
+
+        // Iterate over blocks of rows and columns
+        for(size_type i0 = 0ul; i0 < col.size(); i0 += block) {
+          const size_type i1 = i0 + std::min(block, col.size() - i0);
+          rows_j.assign(i1 - i0, 0ul);
+          rows_t.resize(i1 - i0);
+          for(size_type i = i0; i < i1; ++i)
+            rows_t[i - i0] = reduce_task_rows_[col[i].first];
+
+          for(size_type j0 = 0ul; j0 < row.size(); j0 += block) {
+            const size_type j1 = j0 + std::min(block, row.size() - j0);
+
+            // Iterate over the rows of the block
+            for(size_type i = i0; i < i1; ++i) {
+              // The reduce tasks of the non-zero result tiles in this row
+              size_type& t = rows_t[i - i0];
+              size_type& j = rows_j[i - i0];
+              const size_type t_end = reduce_task_rows_[col[i].first + 1ul];
+
+              // Iterate over the columns of the block that have both a tile
+              // and a reduce task; both are sorted by local column.
+              while((j < j1) && (t < t_end)) {
+                if(reduce_task_cols_[t] < row[j].first) {
+                  ++t;
+                } else if(row[j].first < reduce_task_cols_[t]) {
+                  ++j;
+                } else {
+                  // Schedule task for contraction pairs
+                  if(task)
+                    task->inc();
+                  const left_future left = col[i].second;
+                  const right_future right = row[j].second;
+                  add_pair(k, reduce_tasks_[t], left, right, task, hipri);
+                  ++t;
+                  ++j;
+                }
+              }
+              j = j1;
+            }
           }
         }
       }
 
-#define TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
 #ifndef TILEDARRAY_DISABLE_TILE_CONTRACTION_FILTER
       /// Schedule local contraction tasks for \c col and \c row tile pairs
 
@@ -1128,38 +1653,76 @@ namespace TiledArray {
           const std::vector<col_datum>& col, const std::vector<row_datum>& row,
           madness::TaskInterface* const task)
       {
+        typedef typename SparseShape<T>::value_type value_type;
+
+        // Use split norms for a tighter bound when both arguments have them.
+        // The split norms are stored for the tile layout of the arguments, so
+        // they match the matricized tiles only when neither tile is
+        // transposed; otherwise the tile norms are used.
+        const math::GemmHelper& gemm_helper = op_.gemm_helper();
+        const bool use_split_norms =
+            (gemm_helper.left_op() == madness::cblas::NoTrans) &&
+            (gemm_helper.right_op() == madness::cblas::NoTrans) &&
+            left_.shape().has_split_norms() && right_.shape().has_split_norms();
+        const unsigned int k_rank = gemm_helper.num_contract_ranks();
+        const Tensor<value_type>& left_split_norms = (use_split_norms ?
+            left_.shape().split_norms(gemm_helper.left_rank() - k_rank) :
+            left_.shape().data());
+        const Tensor<value_type>& right_split_norms = (use_split_norms ?
+            right_.shape().split_norms(k_rank) : right_.shape().data());
+
         // Cache row shape data.
-        std::vector<typename SparseShape<T>::value_type> row_shape_values;
+        std::vector<value_type> row_shape_values;
+        std::vector<value_type> row_split_values;
         row_shape_values.reserve(row.size());
+        if(use_split_norms)
+          row_split_values.reserve(row.size());
         const size_type row_start = k * proc_grid_.cols() + proc_grid_.rank_col();
-        for(size_type j = 0ul; j < row.size(); ++j)
-          row_shape_values.push_back(right_.shape()[row_start + (row[j].first * right_stride_local_)]);
+        for(size_type j = 0ul; j < row.size(); ++j) {
+          const size_type index = row_start + (row[j].first * right_stride_local_);
+          row_shape_values.push_back(right_.shape()[index]);
+          if(use_split_norms)
+            row_split_values.push_back(right_split_norms[index]);
+        }
+
+        // The shape data are norms per element, so the norm of the result
+        // tile contribution of a pair is scaled by the square of the volume of
+        // the contracted modes (see SparseShape::gemm).
+        const value_type k_vol = k_volume(k);
+        const value_type k_factor = k_vol * k_vol;
 
         const size_type col_start = left_start_local_ + k;
-        const float threshold_k = TensorImpl_::shape().threshold() / typename SparseShape<T>::value_type(k_);
+        const value_type threshold_k = TensorImpl_::shape().threshold() / value_type(k_);
+        const bool hipri = SummaPriorityPolicy::instance().reduce_hipri(k, k_);
         // Iterate over the row
         for(size_type i = 0ul; i != col.size(); ++i) {
-          // Compute the local, result-tile offset
-          const size_type offset = col[i].first * proc_grid_.local_cols();
-
           // Get the shape data for col_it tile
-          const typename SparseShape<T>::value_type col_shape_value =
-              left_.shape()[col_start + (col[i].first * left_stride_local_)];
-
-          // Iterate over columns
-          for(size_type j = 0ul; j < row.size(); ++j) {
-            if((col_shape_value * row_shape_values[j]) < threshold_k)
+          const size_type col_index = col_start + (col[i].first * left_stride_local_);
+          const value_type col_shape_value = left_.shape()[col_index];
+          const value_type col_split_value =
+              (use_split_norms ? left_split_norms[col_index] : col_shape_value);
+
+          // Iterate over the columns that have both a tile and a reduce task
+          size_type t = reduce_task_rows_[col[i].first];
+          const size_type t_end = reduce_task_rows_[col[i].first + 1ul];
+          for(size_type j = 0ul; (j < row.size()) && (t < t_end); ++j) {
+            while((t < t_end) && (reduce_task_cols_[t] < row[j].first))
+              ++t;
+            if((t == t_end) || (row[j].first < reduce_task_cols_[t]))
               continue;
 
-            const size_type reduce_task_index = offset + row[j].first;
-
-            // Skip zero tiles
-            if(! reduce_tasks_[reduce_task_index])
+            // Skip contractions with a negligible norm bound, where
+            //   ||A B||_F <= min(||A||_F ||B||_2, ||A||_2 ||B||_F)
+            const value_type bound = k_factor * (use_split_norms ?
+                std::min(col_shape_value * row_split_values[j],
+                    col_split_value * row_shape_values[j]) :
+                col_shape_value * row_shape_values[j]);
+            if(bound < threshold_k)
               continue;
 
             if(task)
               task->inc();
-            reduce_tasks_[reduce_task_index].add(col[i].second, row[j].second, task);
+            add_pair(k, reduce_tasks_[t], col[i].second, row[j].second, task, hipri);
           }
         }
       }
@@ -1187,6 +1750,8 @@ namespace TiledArray {
         FinalizeTask* finalize_task_; ///< The SUMMA finalization task
         StepTask* next_step_task_ = nullptr; ///< The next SUMMA step task
         StepTask* tail_step_task_ = nullptr; ///< The next SUMMA step task
+        size_type bcast_bytes_ = 0ul; ///< Broadcast memory released when this task is done
+        std::vector<size_type> trace_steps_{}; ///< Traced steps that are done when this task is done
 
         void get_col(const size_type k) {
           owner_->get_col(k, col_);
@@ -1222,16 +1787,29 @@ namespace TiledArray {
           parent->next_step_task_ = this;
         }
 
-        virtual ~StepTask() { }
+        virtual ~StepTask() {
+          // The contractions of the steps that this task waited on are done,
+          // so their argument tiles are no longer held by SUMMA.
+          if(bcast_bytes_)
+            MemoryTracker::instance().deallocate(MemoryCategory::broadcast, bcast_bytes_);
+          for(const size_type k : trace_steps_)
+            SummaTrace::instance().record(SummaEventKind::step_end,
+                owner_->id().get_obj_id(), k);
+        }
 
         void spawn_get_row_col_tasks(const size_type k) {
+          // Tiles of iterations near the front of the pipeline are collected
+          // with high priority
+          const madness::TaskAttributes attr =
+              SummaPriorityPolicy::instance().bcast_attributes(k, owner_->front_);
+
           // Submit the task to collect column tiles of left for iteration k
           madness::DependencyInterface::inc();
-          world_.taskq.add(this, & StepTask::get_col, k, madness::TaskAttributes::hipri());
+          world_.taskq.add(this, & StepTask::get_col, k, attr);
 
           // Submit the task to collect row tiles of right for iteration k
           madness::DependencyInterface::inc();
-          world_.taskq.add(this, & StepTask::get_row, k, madness::TaskAttributes::hipri());
+          world_.taskq.add(this, & StepTask::get_row, k, attr);
         }
 
         template <typename Derived>
@@ -1254,15 +1832,22 @@ namespace TiledArray {
 
         template <typename Derived, typename GroupType>
         void run(const size_type k, const GroupType& row_group, const GroupType& col_group) {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
-          printf("step:  start rank=%i k=%lu\n", owner_->world().rank(), k);
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
+          detail::ProfileScope profile("summa_step", "summa", k);
 
           if(k < owner_->k_) {
-            // Initialize next tail task and submit next task
+            owner_->front_ = k;
+            SummaTrace::instance().record(SummaEventKind::step_begin,
+                owner_->id().get_obj_id(), k);
+
+            // Initialize next tail task and submit next task. When the
+            // broadcasts take longer than the steps in flight, an extra step
+            // is added ahead of the tail, which does not wait for the
+            // contractions of an earlier step.
             TA_ASSERT(next_step_task_);
-            next_step_task_->tail_step_task_ =
-                new Derived(static_cast<Derived*>(tail_step_task_), 1);
+            Derived* tail_step_task = static_cast<Derived*>(tail_step_task_);
+            if(owner_->extend_lookahead())
+              tail_step_task = new Derived(tail_step_task, 0);
+            next_step_task_->tail_step_task_ = new Derived(tail_step_task, 1);
             world_.taskq.add(next_step_task_);
             next_step_task_ = nullptr;
 
@@ -1272,9 +1857,21 @@ namespace TiledArray {
             world_.taskq.add(owner_, & Summa_::bcast_row, k, row_, col_group,
                              madness::TaskAttributes::hipri());
 
+            // Charge the argument tiles of this step to broadcast memory
+            // until the contractions of this step are done.
+            const size_type bcast_bytes = owner_->step_memory(k);
+            MemoryTracker::instance().allocate(MemoryCategory::broadcast, bcast_bytes);
+            tail_step_task_->bcast_bytes_ += bcast_bytes;
+            if(SummaTrace::instance().enabled())
+              tail_step_task_->trace_steps_.push_back(k);
+
             // Submit tasks for the contraction of col and row tiles.
             owner_->contract(k, col_, row_, tail_step_task_);
 
+            // Measure the time until the tiles for this step have arrived
+            ++(owner_->step_count_);
+            BcastTimer::start(owner_->id().get_obj_id(), k, col_, row_);
+
             // Notify task dependencies
             TA_ASSERT(tail_step_task_);
             tail_step_task_->notify();
@@ -1297,10 +1894,6 @@ namespace TiledArray {
 
             tail_step_task_->notify();
           }
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
-          printf("step: finish rank=%i k=%lu\n", owner_->world().rank(), k);
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_STEP
         }
 
       }; // class StepTask
@@ -1312,14 +1905,15 @@ namespace TiledArray {
 
       public:
         DenseStepTask(const std::shared_ptr<Summa_>& owner, const size_type depth) :
-          StepTask(owner, owner->k_ + 1ul), k_(0)
+          StepTask(owner, owner->layer_k_size() + 1ul),
+          k_(owner->proc_grid_.rank_layer())
         {
           StepTask::make_next_step_tasks(this, depth);
           StepTask::spawn_get_row_col_tasks(k_);
         }
 
         DenseStepTask(DenseStepTask* const parent, const int ndep) :
-          StepTask(parent, ndep), k_(parent->k_ + 1ul)
+          StepTask(parent, ndep), k_(parent->k_ + owner_->proc_grid_.layers())
         {
           // Spawn tasks to get k-th row and column tiles
           if(k_ < owner_->k_)
@@ -1383,7 +1977,8 @@ namespace TiledArray {
           // Spawn a task to find the next non-zero iteration
           madness::DependencyInterface::inc();
           world_.taskq.add(this, & SparseStepTask::iterate_task,
-              0ul, 0ul, madness::TaskAttributes::hipri());
+              size_type(owner_->proc_grid_.rank_layer()), 0ul,
+              madness::TaskAttributes::hipri());
         }
 
         SparseStepTask(SparseStepTask* const parent, const int ndep) :
@@ -1396,7 +1991,8 @@ namespace TiledArray {
             // Spawn a task to find the next non-zero iteration
             madness::DependencyInterface::inc();
             world_.taskq.add(this, & SparseStepTask::iterate_task,
-                parent->k_, 1ul, madness::TaskAttributes::hipri());
+                parent->k_, owner_->proc_grid_.layers(),
+                madness::TaskAttributes::hipri());
           }
         }
 
@@ -1422,28 +2018,73 @@ namespace TiledArray {
       /// \param k The number of tiles in the inner dimension
       /// \param proc_grid The process grid that defines the layout of the tiles
       ///                  during the contraction evaluation
+      /// \param max_depth The maximum number of concurrent SUMMA iterations;
+      ///                  if zero, the \c SummaDepthController default is used
+      /// \param max_memory The maximum memory, in bytes, used by the argument
+      ///                   tiles of concurrent SUMMA iterations; if zero, the
+      ///                   \c SummaDepthController default is used
+      /// \param plan The contraction plan that caches the broadcast groups;
+      ///             it is not used if empty
       /// \note The trange, shape, and pmap refer to the final,
       ///       permuted, state for the result, NOT to the result during
       ///       the SUMMA evaluation.
       Summa(const left_type& left, const right_type& right,
           World& world, const trange_type trange, const shape_type& shape,
           const std::shared_ptr<pmap_interface>& pmap, const Permutation& perm,
-          const op_type& op, const size_type k, const ProcGrid& proc_grid) :
+          const op_type& op, const size_type k, const ProcGrid& proc_grid,
+          const size_type max_depth = 0ul, const size_type max_memory = 0ul,
+          const std::shared_ptr<ContractionPlan>& plan =
+              std::shared_ptr<ContractionPlan>()) :
         DistEvalImpl_(world, trange, shape, pmap, perm),
         left_(left), right_(right), op_(op),
         row_group_(), col_group_(),
-        k_(k), proc_grid_(proc_grid),
-        reduce_tasks_(NULL),
+        k_(k), proc_grid_(proc_grid), shm_topology_(shm_topology(world)),
+        plan_(plan), plan_groups_id_(0ul),
+        group_cache_(plan ? plan->group_cache() : std::make_shared<SummaGroupCache>()),
+        channels_(), reduce_tasks_(NULL), reduce_task_count_(0ul), reduce_task_rows_(),
+        reduce_task_cols_(), seed_(),
+        max_depth_(max_depth), max_memory_(max_memory),
+        start_time_(), step_count_(), front_(0ul), depth_(), max_lookahead_(0ul),
+        k_steps_(), steal_pool_(), steal_k_(k),
         left_start_local_(proc_grid_.rank_row() * k),
         left_end_(left.size()),
         left_stride_(k),
         left_stride_local_(proc_grid.proc_rows() * k),
         right_stride_(1ul),
         right_stride_local_(proc_grid.proc_cols())
-      { }
+      {
+        if(plan_) {
+          plan_groups_id_ = plan_->init_groups(left_.shape(), left_.size(), right_.shape(),
+              right_.size(), shape, TensorImpl_::size(), perm);
+          if(is_rendezvous_tile<typename left_type::eval_type>::value ||
+              is_rendezvous_tile<typename right_type::eval_type>::value)
+            channels_ = plan_->channels(world, plan_groups_id_,
+                left_.size() + right_.size());
+        }
+
+        // Stealable pair pools are world objects, so they are constructed by
+        // all processes, including those that are not in the process grid.
+        if(SummaStealPolicy::instance().enabled() && (world.size() > 1))
+          steal_pool_ = steal_pool_type::make(world, op_, steal_victims());
+      }
 
       virtual ~Summa() { }
 
+      /// Set the initial values of the result tiles
+
+      /// The contraction is accumulated into the non-zero tiles of \c seed ,
+      /// instead of into new tiles, so local tiles of \c seed are modified in
+      /// place. \c seed must have the tiled range of the result and no
+      /// permutation may be applied to the result tiles. The shape of this
+      /// evaluator must include the non-zero tiles of \c seed . This must be
+      /// called before the evaluator is evaluated.
+      /// \param seed The array that holds the initial values of the result
+      void seed(const seed_type& seed) {
+        TA_ASSERT(reduce_tasks_ == NULL);
+        TA_ASSERT(seed.trange() == TensorImpl_::trange());
+        seed_ = seed;
+      }
+
       /// Get tile at index \c i
 
       /// \param i The index of the tile
@@ -1465,8 +2106,7 @@ namespace TiledArray {
         // Compute the process that owns tile
         const ProcessID source = proc_row * proc_grid_.proc_cols() + proc_col;
 
-        const madness::DistributedID key(DistEvalImpl_::id(), i);
-        return TensorImpl_::world().gop.template recv<value_type>(source, key);
+        return DistEvalImpl_::recv_tile(source, i);
       }
 
 
@@ -1479,34 +2119,123 @@ namespace TiledArray {
 
     private:
 
+      /// Memory required by the argument tiles of SUMMA step \c k
+
+      /// The memory is computed from the sizes of the non-zero tiles in this
+      /// process's row of \c left_ and column of \c right_ .
+      /// \param k The SUMMA step
+      /// \return The number of bytes held by the argument tiles of step \c k
+      /// on this process
+      size_type step_memory(const size_type k) const {
+        typedef typename numeric_type<typename left_type::eval_type>::type left_numeric_type;
+        typedef typename numeric_type<typename right_type::eval_type>::type right_numeric_type;
+
+        size_type memory = 0ul;
+
+        // Sum the sizes of the non-zero tiles in column k of left_
+        for(size_type index = left_start_local_ + k; index < left_end_;
+            index += left_stride_local_)
+        {
+          if(left_.shape().is_zero(index)) continue;
+          memory += left_.trange().make_tile_range(index).volume() *
+              sizeof(left_numeric_type);
+        }
+
+        // Sum the sizes of the non-zero tiles in row k of right_
+        size_type index = k * proc_grid_.cols();
+        const size_type end = index + proc_grid_.cols();
+        for(index += proc_grid_.rank_col(); index < end; index += right_stride_local_) {
+          if(right_.shape().is_zero(index)) continue;
+          memory += right_.trange().make_tile_range(index).volume() *
+              sizeof(right_numeric_type);
+        }
+
+        return memory;
+      }
+
+      /// Memory required by the argument tiles of a SUMMA iteration
+
+      /// \return The largest number of bytes held by the argument tiles of a
+      /// single SUMMA iteration evaluated by this process's layer
+      size_type iteration_memory() const {
+        size_type result = 0ul;
+        for(size_type k = proc_grid_.rank_layer(); k < k_; k += proc_grid_.layers())
+          result = std::max(result, step_memory(k));
+
+        return result;
+      }
+
+      /// Maximum number of concurrent SUMMA iterations
+
+      /// \param k_size The number of SUMMA iterations of this process
+      /// \return The largest depth allowed by the number of iterations, the
+      /// available memory, and the user defined depth bound
+      size_type max_lookahead(const size_type k_size) const {
+        const SummaDepthController& controller = SummaDepthController::instance();
+        size_type result = std::max<size_type>(k_size, 1ul);
+
+        const size_type available_memory =
+            (max_memory_ ? max_memory_ : controller.max_memory());
+        if(available_memory) {
+          const size_type memory_per_iter = iteration_memory();
+          if(memory_per_iter)
+            result = std::min(result, std::max<size_type>(
+                available_memory / memory_per_iter, 1ul));
+        }
+
+        const size_type max_depth =
+            (max_depth_ ? max_depth_ : controller.max_depth());
+        if(max_depth) result = std::min(result, max_depth);
+
+        return result;
+      }
+
+      /// Increase the number of concurrent SUMMA iterations
+
+      /// The depth is increased by one when the broadcast latency, measured
+      /// during this and previous contractions, is longer than the time taken
+      /// by the steps in flight, and it is below the bound given by
+      /// \c max_lookahead() .
+      /// \return \c true if the depth was increased, in which case the caller
+      /// must add a step task
+      bool extend_lookahead() {
+        const int step_count = step_count_;
+        if(step_count < 2)
+          return false;
+
+        const size_type target = SummaDepthController::instance().latency_depth(
+            SummaDepthController::elapsed(start_time_) / double(step_count));
+        if(target <= size_type(int(depth_)))
+          return false;
+
+        if(size_type(int(++depth_)) > max_lookahead_) {
+          --depth_;
+          return false;
+        }
+        return true;
+      }
+
       /// Adjust iteration depth based on memory constraints
 
       /// \param depth The unbounded iteration depth
-      /// \param left_sparsity The fraction of zero tiles in the left-hand matrix
-      /// \param right_sparsity The fraction of zero tiles in the right-hand matrix
       /// \return The memory bounded iteration depth
-      /// \thorw TiledArray::Exception When the memory bounded iteration depth
-      /// is less than 1.
-      size_type mem_bound_depth(size_type depth, const float left_sparsity, const float right_sparsity) {
+      /// \throw TiledArray::Exception When a user defined memory limit is too
+      /// small for a single SUMMA iteration.
+      size_type mem_bound_depth(size_type depth) const {
+        const SummaDepthController& controller = SummaDepthController::instance();
 
         // Check if a memory bound has been set
-        const size_type available_memory = max_memory_;
+        const size_type available_memory =
+            (max_memory_ ? max_memory_ : controller.max_memory());
         if(available_memory) {
 
-          // Compute the average memory requirement per iteration of this process
-          const std::size_t local_memory_per_iter_left =
-              (left_.trange().elements_range().volume() / left_.trange().tiles_range().volume()) *
-              sizeof(typename numeric_type<typename left_type::eval_type>::type) *
-              proc_grid_.local_rows() * (1.0f - left_sparsity);
-          const std::size_t local_memory_per_iter_right =
-              (right_.trange().elements_range().volume() / right_.trange().tiles_range().volume()) *
-              sizeof(typename numeric_type<typename right_type::eval_type>::type) *
-              proc_grid_.local_cols() * (1.0f - right_sparsity);
+          // Compute the memory requirement per iteration of this process
+          const size_type memory_per_iter = iteration_memory();
+          if(memory_per_iter == 0ul)
+            return depth;
 
           // Compute the maximum number of iterations based on available memory
-          const size_type mem_bound_depth =
-              ((local_memory_per_iter_left + local_memory_per_iter_right) /
-              available_memory);
+          const size_type mem_bound_depth = available_memory / memory_per_iter;
 
           // Check if the memory bounded depth is less than the optimal depth
           if(depth > mem_bound_depth) {
@@ -1514,13 +2243,17 @@ namespace TiledArray {
             // Adjust the depth based on the available memory
             switch(mem_bound_depth) {
               case 0:
-                // When memory bound depth is
-                TA_EXCEPTION("Insufficient memory available for SUMMA");
-                break;
+                // When the memory limit is given by the user, it must be
+                // large enough for one iteration.
+                if(max_memory_ || controller.user_max_memory())
+                  TA_EXCEPTION("Insufficient memory available for SUMMA");
+                // Fall through
               case 1:
                 if(TensorImpl_::world().rank() == 0)
                   printf("!! WARNING TiledArray: Memory constraints limit the SUMMA depth depth to 1.\n"
                          "!! WARNING TiledArray: Performance may be slow.\n");
+                depth = 1ul;
+                break;
               default:
                 depth = mem_bound_depth;
             }
@@ -1538,21 +2271,43 @@ namespace TiledArray {
       /// this object).
       /// \return The number of tiles that will be set by this process
       virtual int internal_eval() {
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-        printf("eval: start eval children rank=%i\n", TensorImpl_::world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-
         // Start evaluate child tensors
         left_.eval();
         right_.eval();
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-        printf("eval: finished eval children rank=%i\n", TensorImpl_::world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-
         size_type tile_count = 0ul;
         if(proc_grid_.local_size() > 0ul) {
           tile_count = initialize();
+          seed_reduce_tasks();
+
+          // Keep about one recycled partial result per thread, which is
+          // enough to reuse the tiles of the local reduce tasks.
+          reserve_result_pool(op_, std::min<size_type>(tile_count,
+              madness::ThreadPool::size() + 1ul), 0);
+
+          // Only the first layer sets result tiles, the other layers send
+          // their partial results to it.
+          if(proc_grid_.rank_layer() > 0)
+            tile_count = 0ul;
+
+          // The number of SUMMA iterations evaluated by this layer; empty
+          // iterations of sparse contractions are skipped.
+          size_type k_size = layer_k_size();
+          if(! TensorImpl_::shape().is_dense()) {
+            init_k_steps();
+            k_size = k_steps_.size();
+          }
+
+          // The tile pairs of the last iterations can be stolen
+          if(steal_pool_) {
+            const size_type n = SummaStealPolicy::instance().steps(k_size);
+            if(n == 0ul)
+              steal_k_ = k_;
+            else if(TensorImpl_::shape().is_dense())
+              steal_k_ = proc_grid_.rank_layer() + (k_size - n) * proc_grid_.layers();
+            else
+              steal_k_ = k_steps_[k_size - n];
+          }
 
           // depth controls the number of simultaneous SUMMA iterations
           // that are scheduled.
@@ -1562,24 +2317,8 @@ namespace TiledArray {
           size_type depth =
               std::max(ProcGrid::size_type(2), std::min(proc_grid_.proc_rows(), proc_grid_.proc_cols()));
 
-          // Construct the first SUMMA iteration task
-          if(TensorImpl_::shape().is_dense()) {
-            // We cannot have more iterations than there are blocks in the k
-            // dimension
-            if(depth > k_) depth = k_;
-
-            // Modify the number of concurrent iterations based on the available
-            // memory.
-            depth = mem_bound_depth(depth, 0.0f, 0.0f);
-
-            // Enforce user defined depth bound
-            if(max_depth_) std::min(depth, max_depth_);
-
-            TensorImpl_::world().taskq.add(new DenseStepTask(shared_from_this(),
-                                                             depth));
-          } else {
-            // Increase the depth based on the amount of sparsity in an iteration.
-
+          // Increase the depth based on the amount of sparsity in an iteration.
+          if(! TensorImpl_::shape().is_dense()) {
             // Get the sparsity fractions for the left- and right-hand arguments.
             const float left_sparsity = left_.shape().sparsity();
             const float right_sparsity = right_.shape().sparsity();
@@ -1590,34 +2329,44 @@ namespace TiledArray {
 
             // Compute the new depth based on sparsity of the arguments
             depth = float(depth) * (1.0f - 1.35638f * std::log2(frac_non_zero)) + 0.5f;
+          }
+
+          // Increase the depth to hide the broadcast latency measured in
+          // previous contractions.
+          SummaDepthController& controller = SummaDepthController::instance();
+          depth = std::max(depth, controller.latency_depth());
 
-            // We cannot have more iterations than there are blocks in the k
-            // dimension
-            if(depth > k_) depth = k_;
+          // We cannot have more iterations than there are blocks in the k
+          // dimension
+          if(depth > k_size) depth = std::max<size_type>(k_size, 1ul);
 
-            // Modify the number of concurrent iterations based on the available
-            // memory and sparsity of the argument tensors.
-            depth = mem_bound_depth(depth, left_sparsity, right_sparsity);
+          // Modify the number of concurrent iterations based on the available
+          // memory and the size of the argument tiles.
+          depth = mem_bound_depth(depth);
 
-            // Enforce user defined depth bound
-            if(max_depth_) std::min(depth, max_depth_);
+          // Enforce user defined depth bound
+          const size_type max_depth =
+              (max_depth_ ? max_depth_ : controller.max_depth());
+          if(max_depth) depth = std::min(depth, max_depth);
 
+          // The depth may grow at run time up to the bound given by the
+          // number of iterations, memory, and the user.
+          depth_ = depth;
+          max_lookahead_ = std::max(depth, max_lookahead(k_size));
+
+          // Construct the first SUMMA iteration task
+          start_time_ = SummaDepthController::now();
+          if(TensorImpl_::shape().is_dense())
+            TensorImpl_::world().taskq.add(new DenseStepTask(shared_from_this(),
+                                                             depth));
+          else
             TensorImpl_::world().taskq.add(new SparseStepTask(shared_from_this(),
                                                               depth));
-          }
         }
 
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-        printf("eval: start wait children rank=%i\n", TensorImpl_::world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-
         // Wait for child tensors to be evaluated, and process tasks while waiting.
-        left_.wait();
-        right_.wait();
-
-#ifdef TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
-        printf("eval: finished wait children rank=%i\n", TensorImpl_::world().rank());
-#endif // TILEDARRAY_ENABLE_SUMMA_TRACE_EVAL
+        DistEvalImpl_::wait_arg(left_);
+        DistEvalImpl_::wait_arg(right_);
 
         return tile_count;
       }
@@ -1625,17 +2374,6 @@ namespace TiledArray {
     }; // class Summa
 
 
-    // Initialize static member variables for Summa
-
-    template <typename Left, typename Right, typename Op, typename Policy>
-    typename Summa<Left, Right, Op, Policy>::size_type
-    Summa<Left, Right, Op, Policy>::max_depth_ =
-        Summa<Left, Right, Op, Policy>::init_max_depth();
-
-    template <typename Left, typename Right, typename Op, typename Policy>
-    typename Summa<Left, Right, Op, Policy>::size_type
-    Summa<Left, Right, Op, Policy>::max_memory_ =
-        Summa<Left, Right, Op, Policy>::init_max_memory();
   } // namespace detail
 }  // namespace TiledArray
 
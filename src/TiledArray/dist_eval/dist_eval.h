@@ -24,10 +24,53 @@
 #include <TiledArray/permutation.h>
 #include <TiledArray/perm_index.h>
 #include <TiledArray/type_traits.h>
+#include <TiledArray/tile_cost.h>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
 
+    // Forward declaration
+    template <typename, typename> class DistEval;
+
+    /// Dataflow evaluation depth accessor
+
+    /// \return A reference to the number of active dataflow scopes
+    inline int& dataflow_depth() {
+      static int depth = 0;
+      return depth;
+    }
+
+    /// Dataflow evaluation query
+
+    /// In dataflow mode, the evaluation of an expression does not wait for
+    /// the tiles of its arguments. The arguments are waited on with the
+    /// result, so consumers of the result tiles start as soon as the
+    /// tiles they need are ready.
+    /// \return \c true if dataflow evaluation is active
+    inline bool dataflow_eval() { return dataflow_depth() > 0; }
+
+    /// Interface of distributed evaluators that can be waited on
+    class DistEvalWaitable {
+    public:
+      virtual ~DistEvalWaitable() { }
+
+      /// Probe the evaluation
+
+      /// \return \c true if all local tiles have been evaluated
+      virtual bool probe() const = 0;
+
+      /// Wait for all local tiles to be evaluated
+      virtual void wait() const = 0;
+
+      /// Register a completion callback
+
+      /// \c callback->notify() is called once, when \c probe() becomes
+      /// \c true , or immediately when the evaluation is already complete.
+      /// \param callback The completion callback
+      virtual void register_callback(madness::CallbackInterface* callback) const = 0;
+    }; // class DistEvalWaitable
+
     /// Distributed evaluator implementation object
 
     /// This class is used as the base class for other distributed evaluation
@@ -37,7 +80,9 @@ namespace TiledArray {
     /// \tparam Tile The output tile type
     /// \tparam Policy The tensor policy class
     template <typename Tile, typename Policy>
-    class DistEvalImpl : public TensorImpl<Policy>, public madness::CallbackInterface {
+    class DistEvalImpl : public TensorImpl<Policy>,
+        public madness::CallbackInterface, public DistEvalWaitable
+    {
     public:
       typedef DistEvalImpl<Tile, Policy> DistEvalImpl_; ///< This object type
       typedef TiledArray::detail::TensorImpl<Policy> TensorImpl_;
@@ -52,9 +97,18 @@ namespace TiledArray {
       typedef typename eval_trait<value_type>::type eval_type; ///< Tile evaluation type
 
     private:
+      typedef madness::ConcurrentHashMap<size_type, Future<value_type> >
+          handoff_container; ///< Local tile handoff container type
+
       madness::uniqueidT id_; ///< Globally unique object identifier.
+      const bool local_only_; ///< All tiles are local, so they are handed
+                              ///< off directly instead of through messages
+      mutable handoff_container handoff_; ///< Tiles that are handed off
       PermIndex source_to_target_; ///< Functor used to permute a source index to a target index.
       PermIndex target_to_source_; ///< Functor used to permute a target index to a source index.
+      std::shared_ptr<const std::vector<std::size_t> > source_to_target_table_;
+                        ///< Permuted target index of each source index, or
+                        ///< null if the table is not used
 
       // The following variables are used to track the total number of tasks run
       // on the local node, task_count_, and the number of tiles set on this
@@ -64,6 +118,58 @@ namespace TiledArray {
 
       volatile int task_count_; ///< Total number of local tasks
       madness::AtomicInt set_counter_; ///< The number of tiles set by this node
+      std::vector<std::shared_ptr<const DistEvalWaitable> > deferred_args_;
+                        ///< Arguments that are waited on with this object
+      mutable madness::Spinlock completion_lock_; ///< Completion callback lock
+      mutable bool complete_; ///< Set when the completion callbacks were called
+      mutable std::vector<madness::CallbackInterface*> callbacks_;
+                        ///< Completion callbacks
+      std::shared_ptr<TileCostRecorder> cost_recorder_;
+                        ///< Recorder of the compute time of the tiles (may be null)
+
+      /// Callback that checks the completion of this object when a deferred
+      /// argument completes
+      class ArgCallback : public madness::CallbackInterface {
+        const DistEvalImpl_* parent_; ///< The object that waits for the argument
+
+      public:
+        explicit ArgCallback(const DistEvalImpl_* parent) : parent_(parent) { }
+
+        virtual void notify() {
+          parent_->complete();
+          delete this;
+        }
+      }; // class ArgCallback
+
+      /// Call the completion callbacks if the evaluation is complete
+      void complete() const {
+        std::vector<madness::CallbackInterface*> callbacks;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(completion_lock_);
+          if(complete_ || ! probe())
+            return;
+          complete_ = true;
+          callbacks.swap(callbacks_);
+        }
+        for(madness::CallbackInterface* callback : callbacks)
+          callback->notify();
+      }
+
+      /// Hand off a tile between the producer and the consumer
+
+      /// The first of \c set_tile() and \c recv_tile() inserts the future of
+      /// the tile, and the second removes it, like the matching
+      /// <tt>gop.send()</tt> and <tt>gop.recv()</tt> .
+      /// \param i The index of the tile
+      /// \return The future of tile \c i
+      Future<value_type> handoff(const size_type i) const {
+        typename handoff_container::accessor acc;
+        if(handoff_.insert(acc, i))
+          return acc->second;
+        Future<value_type> result = acc->second;
+        handoff_.erase(acc);
+        return result;
+      }
 
     protected:
 
@@ -74,6 +180,8 @@ namespace TiledArray {
       /// \return The ordinal index in the target index space
       size_type perm_index_to_target(size_type index) const {
         TA_ASSERT(index < TensorImpl_::trange().tiles_range().volume());
+        if(source_to_target_table_)
+          return (*source_to_target_table_)[index];
         return (source_to_target_ ? source_to_target_(index) : index);
       }
 
@@ -86,6 +194,41 @@ namespace TiledArray {
         return (target_to_source_ ? target_to_source_(index) : index);
       }
 
+      /// Cost recorder accessor
+
+      /// \return The recorder of the compute time of the result tiles, or
+      /// null if the costs are not recorded
+      TileCostRecorder* cost_recorder() const { return cost_recorder_.get(); }
+
+      /// Wait for the local tiles of an argument
+
+      /// In dataflow mode the argument is not waited on here, but with this
+      /// object, so evaluation of the result is not blocked by its arguments.
+      /// \tparam T The tile type of the argument
+      /// \tparam P The policy of the argument
+      /// \param arg The argument distributed evaluator
+      template <typename T, typename P>
+      void wait_arg(const DistEval<T, P>& arg) {
+        if(dataflow_eval())
+          deferred_args_.push_back(arg.pimpl_);
+        else
+          arg.wait();
+      }
+
+      /// Receive a tile that is set with \c set_tile()
+
+      /// In a single process world the tile is handed off directly, without
+      /// the distributed object registry of the world.
+      /// \param source The process that sets the tile
+      /// \param i The index of the tile
+      /// \return The future of tile \c i
+      Future<value_type> recv_tile(const ProcessID source, const size_type i) const {
+        if(local_only_)
+          return handoff(i);
+        const madness::DistributedID key(id_, i);
+        return TensorImpl_::world().gop.template recv<value_type>(source, key);
+      }
+
     public:
       /// Constructor
 
@@ -101,10 +244,18 @@ namespace TiledArray {
           const Permutation& perm) :
         TensorImpl_(world, trange, shape, pmap),
         id_(world.unique_obj_id()),
+        local_only_(world.size() == 1),
+        handoff_(local_only_ ? (trange.tiles_range().volume() / 4ul + 11ul) : 11ul),
         source_to_target_(),
         target_to_source_(),
+        source_to_target_table_(),
         task_count_(-1),
-        set_counter_()
+        set_counter_(),
+        deferred_args_(),
+        completion_lock_(),
+        complete_(false),
+        callbacks_(),
+        cost_recorder_()
       {
         set_counter_ = 0;
 
@@ -113,6 +264,8 @@ namespace TiledArray {
           range_type source_range = inv_perm * trange.tiles_range();
           source_to_target_ = PermIndex(source_range, perm);
           target_to_source_ = PermIndex(trange.tiles_range(), inv_perm);
+          source_to_target_table_ =
+              PermIndexTableCache::instance().get(source_range, perm);
         }
       }
 
@@ -124,6 +277,18 @@ namespace TiledArray {
       /// \return This object's unique identifier
       const madness::uniqueidT& id() const { return id_; }
 
+      /// Record the compute time of the result tiles
+
+      /// \param recorder The recorder, which has the number of tiles of this
+      /// tensor
+      /// \note This must be called before \c eval() .
+      void set_cost_recorder(const std::shared_ptr<TileCostRecorder>& recorder) {
+        TA_ASSERT(task_count_ == -1);
+        TA_USER_ASSERT(! recorder || (recorder->size() == TensorImpl_::size()),
+            "The cost recorder does not have the number of tiles of the result.");
+        cost_recorder_ = recorder;
+      }
+
       /// Get tile at index \c i
 
       /// \param i The index of the tile
@@ -145,8 +310,12 @@ namespace TiledArray {
       /// \param value The value to be stored at index \c i
       void set_tile(size_type i, const value_type& value) {
         // Store value
-        madness::DistributedID id(id_, i);
-        TensorImpl_::world().gop.send(TensorImpl_::owner(i), id, value);
+        if(local_only_) {
+          handoff(i).set(value);
+        } else {
+          madness::DistributedID id(id_, i);
+          TensorImpl_::world().gop.send(TensorImpl_::owner(i), id, value);
+        }
 
         // Record the assignment of a tile
         DistEvalImpl_::notify();
@@ -160,18 +329,70 @@ namespace TiledArray {
       /// \param f The future value to be stored at index \c i
       void set_tile(size_type i, Future<value_type> f) {
         // Store value
-        madness::DistributedID id(id_, i);
-        TensorImpl_::world().gop.send(TensorImpl_::owner(i), id, f);
+        if(local_only_) {
+          handoff(i).set(f);
+        } else {
+          madness::DistributedID id(id_, i);
+          TensorImpl_::world().gop.send(TensorImpl_::owner(i), id, f);
+        }
 
         // Record the assignment of a tile
         f.register_callback(this);
       }
 
       /// Tile set notification
-      virtual void notify() { set_counter_++; }
+      virtual void notify() {
+        if((++set_counter_) == task_count_)
+          complete();
+      }
+
+      /// Probe tile assignment
+
+      /// \return \c true if this object has been evaluated and all local
+      /// tiles have been assigned
+      virtual bool probe() const {
+        const int task_count = task_count_;
+        if((task_count < 0) || (set_counter_ != task_count))
+          return false;
+        for(const auto& arg : deferred_args_)
+          if(! arg->probe())
+            return false;
+        return true;
+      }
 
       /// Wait for all tiles to be assigned
-      void wait() const {
+
+      /// In dataflow mode, this also waits for the arguments of this object.
+      virtual void wait() const {
+        wait_local();
+        for(const auto& arg : deferred_args_)
+          arg->wait();
+      }
+
+      /// Register a completion callback
+
+      /// \c callback->notify() is called once all local tiles have been
+      /// assigned (and, in dataflow mode, the arguments of this object are
+      /// complete). It is called by the thread that completes the
+      /// evaluation, which is usually a task thread, or immediately when the
+      /// evaluation is already complete. The callback must not block.
+      /// \param callback The completion callback
+      virtual void register_callback(madness::CallbackInterface* callback) const {
+        TA_ASSERT(callback);
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(completion_lock_);
+          if(! complete_) {
+            callbacks_.push_back(callback);
+            return;
+          }
+        }
+        callback->notify();
+      }
+
+    private:
+
+      /// Wait for the local tiles of this object
+      void wait_local() const {
         const int task_count = task_count_;
         if(task_count > 0) {
           try {
@@ -188,14 +409,12 @@ namespace TiledArray {
         }
       }
 
-    private:
-
       /// Evaluate the tiles of this tensor
 
       /// This function will evaluate the children of this distributed evaluator
       /// and evaluate the tiles for this distributed evaluator. It will block
       /// until the tasks for the children are evaluated (not for the tasks of
-      /// this object).
+      /// this object), unless dataflow evaluation is active.
       /// \return The number of tiles that will be set by this process
       virtual int internal_eval() = 0;
 
@@ -211,6 +430,12 @@ namespace TiledArray {
         TA_ASSERT(task_count_ == -1);
         task_count_ = this->internal_eval();
         TA_ASSERT(task_count_ >= 0);
+
+        // Check for completion, since the tiles may have been set before
+        // the task count was known.
+        for(const auto& arg : deferred_args_)
+          arg->register_callback(new ArgCallback(this));
+        complete();
       }
 
     }; // class DistEvalImpl
@@ -238,6 +463,8 @@ namespace TiledArray {
       typedef Future<value_type> future; ///< Future of tile type
 
     private:
+      template <typename, typename> friend class DistEvalImpl;
+
       std::shared_ptr<impl_type> pimpl_; ///< pointer to the implementation object
 
     public:
@@ -273,6 +500,14 @@ namespace TiledArray {
       /// The returned future will be evaluated once the tensor has been evaluated.
       void eval() { return pimpl_->eval(); }
 
+      /// Record the compute time of the result tiles
+
+      /// \param recorder The recorder of the tile costs
+      /// \note This must be called before \c eval() .
+      void set_cost_recorder(const std::shared_ptr<TileCostRecorder>& recorder) {
+        pimpl_->set_cost_recorder(recorder);
+      }
+
 
       /// Tensor tile size array accessor
 
@@ -346,9 +581,22 @@ namespace TiledArray {
       /// \return The unique id for this object
       madness::uniqueidT id() const { return pimpl_->id(); }
 
+      /// Probe local tile evaluation
+
+      /// \return \c true if all local tiles have been evaluated
+      bool probe() const { return pimpl_->probe(); }
+
       /// Wait for all local tiles to be evaluated
       void wait() const { pimpl_->wait(); }
 
+      /// Register a completion callback
+
+      /// \param callback The callback that is notified when all local tiles
+      /// have been evaluated
+      void register_callback(madness::CallbackInterface* callback) const {
+        pimpl_->register_callback(callback);
+      }
+
     }; // class DistEval
 
   }  // namespace detail
@@ -0,0 +1,177 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  fused_eval.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
+
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/tile_op/fused.h>
+#include <TiledArray/profiler.h>
+
+namespace TiledArray {
+
+  // Forward declaration
+  template <typename, typename> class DistArray;
+
+  namespace detail {
+
+    /// Fused element-wise, distributed tensor evaluator
+
+    /// This object evaluates an element-wise expression over the tiles of
+    /// several arrays with one fused kernel per tile, so no intermediate
+    /// tiles are evaluated. The arrays and the result have the same tiled
+    /// range, and the result is not permuted.
+    /// \tparam Tile The tile type of the arguments and the result
+    /// \tparam Kernel The fused kernel type
+    /// \tparam Policy The tensor policy class
+    template <typename Tile, typename Kernel, typename Policy>
+    class FusedEvalImpl :
+      public DistEvalImpl<Tile, Policy>,
+      public std::enable_shared_from_this<FusedEvalImpl<Tile, Kernel, Policy> >
+    {
+    public:
+      typedef FusedEvalImpl<Tile, Kernel, Policy> FusedEvalImpl_; ///< This object type
+      typedef DistEvalImpl<Tile, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef DistArray<Tile, Policy> array_type; ///< The argument array type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef Kernel kernel_type; ///< Fused kernel type
+
+      using std::enable_shared_from_this<FusedEvalImpl_>::shared_from_this;
+
+    private:
+
+      std::vector<array_type> args_; ///< The argument arrays
+      kernel_type kernel_; ///< The fused kernel
+
+    public:
+
+      /// Construct a fused evaluator
+
+      /// \param args The argument arrays, in the order of the argument indices
+      /// of \c kernel
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range object
+      /// \param shape The tensor shape object
+      /// \param pmap The tile-process map
+      /// \param kernel The fused kernel
+      FusedEvalImpl(const std::vector<array_type>& args, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const kernel_type& kernel) :
+        DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        args_(args), kernel_(kernel)
+      {
+        TA_ASSERT(! args_.empty());
+      }
+
+      virtual ~FusedEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+
+        return DistEvalImpl_::recv_tile(TensorImpl_::world().rank(), i);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Task function for evaluating tiles
+
+      /// \param i The tile index
+      /// \param args The argument tiles; zero tiles are empty
+      void eval_tile(const size_type i, const std::vector<Future<value_type> >& args) {
+        detail::ProfileScope profile("fused_tile", "tile", i);
+
+        std::vector<value_type> tiles;
+        tiles.reserve(args.size());
+        for(const Future<value_type>& arg : args) {
+          tiles.push_back(arg.get());
+          if(profile.enabled())
+            profile.add_bytes(detail::tile_bytes(tiles.back()));
+        }
+
+        value_type result;
+        {
+          detail::TileCostScope cost(DistEvalImpl_::cost_recorder(), i);
+          result = fused_tile(kernel_, TensorImpl_::trange().make_tile_range(i), tiles);
+        }
+        DistEvalImpl_::set_tile(i, result);
+      }
+
+      /// Evaluate the tiles of this tensor
+
+      /// The tiles of the arguments are read directly from the argument
+      /// arrays, which fetches remote tiles when the arrays are distributed
+      /// differently than the result.
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        size_type task_count = 0ul;
+
+        std::shared_ptr<FusedEvalImpl_> self = shared_from_this();
+        typename pmap_interface::const_iterator it = TensorImpl_::pmap()->begin();
+        const typename pmap_interface::const_iterator end = TensorImpl_::pmap()->end();
+        for(; it != end; ++it) {
+          const size_type index = *it;
+          if(TensorImpl_::is_zero(index))
+            continue;
+
+          std::vector<Future<value_type> > args;
+          args.reserve(args_.size());
+          for(const array_type& arg : args_)
+            args.push_back(arg.is_zero(index) ? Future<value_type>(value_type()) :
+                arg.find(index));
+
+          TensorImpl_::world().taskq.add(self, & FusedEvalImpl_::eval_tile,
+              index, args);
+
+          ++task_count;
+        }
+
+        return task_count;
+      }
+
+    }; // class FusedEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_FUSED_EVAL_H__INCLUDED
@@ -0,0 +1,409 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  gemv_eval.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_GEMV_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_GEMV_EVAL_H__INCLUDED
+
+#include <TiledArray/comm_tracker.h>
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/reduce_task.h>
+#include <algorithm>
+#include <unordered_map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Distributed evaluator of matrix-vector and tensor-vector contractions
+
+    /// This evaluates contractions where all outer indices of the result
+    /// belong to one argument, the matrix, so the other argument, the vector,
+    /// has only contracted indices, e.g. <tt>v("i") = a("i,j") * x("j")</tt>
+    /// or <tt>w("i,j") = x("k") * t("k,i,j")</tt> . The matrix is not
+    /// redistributed: each non-zero matrix tile is contracted by the process
+    /// that owns it, so the large argument is read once and never moved.
+    /// Each non-zero vector tile is broadcast once, to the processes that
+    /// own a matrix tile in its column. The products of a process are summed
+    /// locally for each result tile, and the partial sums are sent to the
+    /// owner of the result tile, which adds them; this is the only
+    /// reduction. SUMMA instead broadcasts both arguments over a process grid
+    /// sized for a matrix result.
+    /// \tparam Left The left-hand argument evaluator type
+    /// \tparam Right The right-hand argument evaluator type
+    /// \tparam Op The contraction/reduction operation type
+    /// \tparam Policy The tensor policy class
+    /// \note Result tiles are not permuted.
+    template <typename Left, typename Right, typename Op, typename Policy>
+    class GemvEvalImpl :
+        public DistEvalImpl<typename Op::result_type, Policy>,
+        public std::enable_shared_from_this<GemvEvalImpl<Left, Right, Op, Policy> >
+    {
+    public:
+      typedef GemvEvalImpl<Left, Right, Op, Policy> GemvEvalImpl_; ///< This object type
+      typedef DistEvalImpl<typename Op::result_type, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Left left_type; ///< The left-hand argument type
+      typedef Right right_type; ///< The right-hand argument type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
+      typedef Op op_type; ///< Tile evaluation operator type
+
+    private:
+      typedef typename left_type::eval_type left_eval_type; ///< Left-hand tile type
+      typedef typename right_type::eval_type right_eval_type; ///< Right-hand tile type
+
+      left_type left_; ///< The left-hand argument
+      right_type right_; ///< The right-hand argument
+      op_type op_; ///< The contraction/reduction operation
+      const size_type k_; ///< The number of tiles in the contracted dimension
+      const size_type m_; ///< The number of rows of result tiles
+      const size_type n_; ///< The number of columns of result tiles
+      const bool left_trans_; ///< The contracted dimensions of left come first
+      const bool right_trans_; ///< The contracted dimensions of right come last
+      const bool right_vector_; ///< The right-hand argument is the vector
+
+      /// Tile conversion task function
+
+      /// \tparam Tile The input tile type
+      /// \param tile The input tile
+      /// \return The evaluated version of the lazy tile
+      template <typename Tile>
+      static typename eval_trait<Tile>::type convert_tile_task(const Tile& tile) { return tile; }
+
+      /// Get an argument tile that is not lazy
+
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return A future to the tile
+      template <typename Arg>
+      static typename std::enable_if<
+          ! is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_arg_tile(Arg& arg, const size_type index) { return arg.get(index); }
+
+      /// Get and evaluate a lazy argument tile
+
+      /// \tparam Arg The type of the argument that holds the input tiles
+      /// \param arg The argument that holds the tiles
+      /// \param index The tile index of arg
+      /// \return A future to the evaluated tile
+      template <typename Arg>
+      static typename std::enable_if<
+          is_lazy_tile<typename Arg::value_type>::value,
+          Future<typename Arg::eval_type> >::type
+      get_arg_tile(Arg& arg, const size_type index) {
+        return arg.world().taskq.add(
+            & GemvEvalImpl_::template convert_tile_task<typename Arg::value_type>,
+            arg.get(index), madness::TaskAttributes::hipri());
+      }
+
+      /// \param i The row of the result
+      /// \param k The index of the contracted dimension
+      /// \return The ordinal index of left-hand tile <tt>(i,k)</tt>
+      size_type left_index(const size_type i, const size_type k) const {
+        return (left_trans_ ? k * m_ + i : i * k_ + k);
+      }
+
+      /// \param k The index of the contracted dimension
+      /// \param j The column of the result
+      /// \return The ordinal index of right-hand tile <tt>(k,j)</tt>
+      size_type right_index(const size_type k, const size_type j) const {
+        return (right_trans_ ? j * k_ + k : k * n_ + j);
+      }
+
+      /// \param index The ordinal index of a result tile
+      /// \param k The index of the contracted dimension
+      /// \return \c true if the product of the matrix and vector tiles of
+      /// result tile \c index at \c k is zero
+      bool product_is_zero(const size_type index, const size_type k) const {
+        const size_type i = index / n_, j = index % n_;
+        return left_.is_zero(left_index(i, k)) || right_.is_zero(right_index(k, j));
+      }
+
+      /// \param index The ordinal index of a result tile
+      /// \param k The index of the contracted dimension
+      /// \return The owner of the matrix tile of result tile \c index at \c k
+      ProcessID matrix_owner(const size_type index, const size_type k) const {
+        const size_type i = index / n_, j = index % n_;
+        return (right_vector_ ? left_.owner(left_index(i, k)) :
+            right_.owner(right_index(k, j)));
+      }
+
+      /// The processes that need a vector tile
+
+      /// \param k The index of the vector tile
+      /// \return The sorted list of the owner of vector tile \c k and the
+      /// processes that own a non-zero matrix tile that it is contracted with
+      std::vector<ProcessID> vector_procs(const size_type k) const {
+        std::vector<ProcessID> procs(1, (right_vector_ ? right_.owner(k) :
+            left_.owner(k)));
+        const size_type volume = TensorImpl_::size();
+        for(size_type index = 0ul; index < volume; ++index)
+          if(! TensorImpl_::is_zero(index) && ! product_is_zero(index, k))
+            procs.push_back(matrix_owner(index, k));
+        std::sort(procs.begin(), procs.end());
+        procs.erase(std::unique(procs.begin(), procs.end()), procs.end());
+        return procs;
+      }
+
+      /// The processes that contribute to a result tile
+
+      /// \param index The ordinal index of the result tile
+      /// \return The sorted list of the owners of the non-zero matrix tiles
+      /// of result tile \c index
+      std::vector<ProcessID> result_procs(const size_type index) const {
+        std::vector<ProcessID> procs;
+        for(size_type k = 0ul; k < k_; ++k)
+          if(! product_is_zero(index, k))
+            procs.push_back(matrix_owner(index, k));
+        std::sort(procs.begin(), procs.end());
+        procs.erase(std::unique(procs.begin(), procs.end()), procs.end());
+        return procs;
+      }
+
+      /// Broadcast a vector tile
+
+      /// \tparam Arg The vector argument type
+      /// \param arg The vector argument
+      /// \param k The index of the vector tile
+      /// \param category The communication category of the broadcast
+      /// \return A future to vector tile \c k
+      template <typename Arg>
+      Future<typename Arg::eval_type>
+      bcast_vector_tile(Arg& arg, const size_type k, const CommCategory category) const {
+        World& world = TensorImpl_::world();
+        const ProcessID rank = world.rank();
+        const ProcessID root = arg.owner(k);
+        const std::vector<ProcessID> procs = vector_procs(k);
+
+        Future<typename Arg::eval_type> tile = (root == rank ?
+            get_arg_tile(arg, k) : Future<typename Arg::eval_type>());
+        if(procs.size() > 1ul) {
+          const size_type volume = TensorImpl_::size();
+          const madness::Group group(world, procs,
+              madness::DistributedID(DistEvalImpl_::id(), volume + k));
+          const madness::DistributedID key(DistEvalImpl_::id(), volume + k_ + k);
+          world.gop.bcast(key, tile, group.rank(root), group);
+          if(root == rank)
+            comm_send(category, tile);
+          else
+            comm_receive(category, tile);
+        }
+        return tile;
+      }
+
+      /// Add a partial result tile from another process
+
+      /// \param tile The partial result of this process
+      /// \param partial The partial result of another process
+      /// \return The sum of \c tile and \c partial
+      value_type reduce_partial(const value_type& tile, const value_type& partial) const {
+        using TiledArray::empty;
+        if(empty(tile))
+          return partial;
+
+        value_type result = tile;
+        if(! empty(partial))
+          op_(result, partial);
+        return result;
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param left The left-hand argument, a matrix of <tt>m x k</tt>
+      /// tiles, or of <tt>k x m</tt> tiles when \c left_trans is \c true
+      /// \param right The right-hand argument, a matrix of <tt>k x n</tt>
+      /// tiles, or of <tt>n x k</tt> tiles when \c right_trans is \c true
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range object
+      /// \param shape The tensor shape object
+      /// \param pmap The tile-process map
+      /// \param op The tile contraction operation
+      /// \param k The number of tiles in the contracted dimension
+      /// \param left_trans \c true if the contracted dimensions of \c left
+      /// come first
+      /// \param right_trans \c true if the contracted dimensions of \c right
+      /// come last
+      /// \param right_vector \c true if \c right is the vector, i.e. it has
+      /// no outer dimensions, and \c false if \c left is the vector
+      GemvEvalImpl(const left_type& left, const right_type& right, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const op_type& op,
+          const size_type k, const bool left_trans, const bool right_trans,
+          const bool right_vector) :
+        DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        left_(left), right_(right), op_(op), k_(k),
+        m_(right_vector ? trange.tiles_range().volume() : 1ul),
+        n_(right_vector ? 1ul : trange.tiles_range().volume()),
+        left_trans_(left_trans), right_trans_(right_trans),
+        right_vector_(right_vector)
+      {
+        TA_ASSERT(left.size() == m_ * k_);
+        TA_ASSERT(right.size() == k_ * n_);
+      }
+
+      /// Virtual destructor
+      virtual ~GemvEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        return DistEvalImpl_::recv_tile(TensorImpl_::world().rank(), i);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the children of this distributed evaluator
+      /// and evaluate the tiles for this distributed evaluator. It will block
+      /// until the tasks for the children are evaluated (not for the tasks of
+      /// this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        std::shared_ptr<GemvEvalImpl_> self =
+            std::enable_shared_from_this<GemvEvalImpl_>::shared_from_this();
+        World& world = TensorImpl_::world();
+        const ProcessID rank = world.rank();
+        const size_type volume = TensorImpl_::size();
+
+        // Evaluate arguments
+        left_.eval();
+        right_.eval();
+
+        // Broadcast each non-zero vector tile to the owners of the matrix
+        // tiles in its column.
+        std::unordered_map<size_type, Future<left_eval_type> > left_tiles;
+        std::unordered_map<size_type, Future<right_eval_type> > right_tiles;
+        for(size_type k = 0ul; k < k_; ++k) {
+          if(right_vector_ ? right_.is_zero(k) : left_.is_zero(k))
+            continue;
+          const std::vector<ProcessID> procs = vector_procs(k);
+          if(! std::binary_search(procs.begin(), procs.end(), rank))
+            continue;
+
+          if(right_vector_)
+            right_tiles.emplace(k, bcast_vector_tile(right_, k, CommCategory::summa_row));
+          else
+            left_tiles.emplace(k, bcast_vector_tile(left_, k, CommCategory::summa_col));
+        }
+
+        // Contract the local matrix tiles, and reduce the partial results
+        // onto the owners of the result tiles
+        const size_type key_offset = volume + 2ul * k_;
+        int tile_count = 0;
+        for(size_type index = 0ul; index < volume; ++index) {
+          if(TensorImpl_::is_zero(index))
+            continue;
+
+          const ProcessID owner = TensorImpl_::owner(index);
+          const std::vector<ProcessID> procs = result_procs(index);
+          const bool contributes = std::binary_search(procs.begin(), procs.end(), rank);
+          if(! contributes && (owner != rank))
+            continue;
+
+          // Sum the products of the local matrix tiles of this result tile
+          const size_type i = index / n_, j = index % n_;
+          ReducePairTask<op_type> reduce_task(world, op_);
+          for(size_type k = 0ul; contributes && (k < k_); ++k) {
+            if(product_is_zero(index, k) || (matrix_owner(index, k) != rank))
+              continue;
+            if(right_vector_)
+              reduce_task.add(get_arg_tile(left_, left_index(i, k)),
+                  right_tiles.find(k)->second);
+            else
+              reduce_task.add(left_tiles.find(k)->second,
+                  get_arg_tile(right_, right_index(k, j)));
+          }
+          Future<value_type> tile = reduce_task.submit();
+
+          if(owner == rank) {
+            for(const ProcessID source : procs) {
+              if(source == rank)
+                continue;
+              const madness::DistributedID key(DistEvalImpl_::id(),
+                  key_offset + source * volume + index);
+              Future<value_type> partial =
+                  world.gop.template recv<value_type>(source, key);
+              tile = world.taskq.add(self, & GemvEvalImpl_::reduce_partial,
+                  tile, partial, madness::TaskAttributes::hipri());
+            }
+
+            DistEvalImpl_::set_tile(index, tile);
+            ++tile_count;
+          } else {
+            const madness::DistributedID key(DistEvalImpl_::id(),
+                key_offset + rank * volume + index);
+            world.gop.send(owner, key, tile);
+          }
+        }
+
+        // Discard the local matrix tiles that are not contracted
+        for(size_type index = 0ul; index < volume; ++index) {
+          const size_type i = index / n_, j = index % n_;
+          for(size_type k = 0ul; k < k_; ++k) {
+            if((matrix_owner(index, k) != rank) || (! TensorImpl_::is_zero(index) &&
+                ! product_is_zero(index, k)))
+              continue;
+            if(right_vector_ && ! left_.is_zero(left_index(i, k)))
+              left_.discard(left_index(i, k));
+            else if(! right_vector_ && ! right_.is_zero(right_index(k, j)))
+              right_.discard(right_index(k, j));
+          }
+        }
+
+        // Wait for local tiles of arguments to be evaluated
+        DistEvalImpl_::wait_arg(left_);
+        DistEvalImpl_::wait_arg(right_);
+
+        return tile_count;
+      }
+
+    }; // class GemvEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_GEMV_EVAL_H__INCLUDED
@@ -0,0 +1,99 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_coalesce.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_COALESCE_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_COALESCE_H__INCLUDED
+
+#include <cstdlib>
+#include <string>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Message coalescing policy of SUMMA broadcasts
+
+    /// Each SUMMA step broadcasts the tiles of a column of the left-hand
+    /// argument along the process rows, and the tiles of a row of the
+    /// right-hand argument along the process columns. With small tiles, one
+    /// broadcast per tile makes the steps latency bound, so the tiles that
+    /// the root process contributes to a broadcast are packed into one
+    /// message when their mean volume is at most \c max_elements() . The
+    /// decision depends only on the shape and the tiled range of the
+    /// argument, so all processes of a broadcast group agree on it. The
+    /// default is 4096 elements, or the value of the
+    /// \c TA_SUMMA_COALESCE_ELEMENTS environment variable; zero disables
+    /// coalescing.
+    /// \note There is one policy per process, which is shared by all
+    /// contractions. It must be the same on all processes.
+    class SummaCoalescePolicy {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type max_elements_; ///< The largest mean volume of coalesced tiles
+
+      SummaCoalescePolicy() :
+        max_elements_(getenv("TA_SUMMA_COALESCE_ELEMENTS") ?
+            std::stoul(getenv("TA_SUMMA_COALESCE_ELEMENTS")) : 4096ul)
+      { }
+
+      SummaCoalescePolicy(const SummaCoalescePolicy&) = delete;
+      SummaCoalescePolicy& operator=(const SummaCoalescePolicy&) = delete;
+
+    public:
+
+      /// Policy accessor
+
+      /// \return A reference to the policy of this process
+      static SummaCoalescePolicy& instance() {
+        static SummaCoalescePolicy policy;
+        return policy;
+      }
+
+      /// \return The largest mean volume of the tiles of a coalesced
+      /// broadcast, or zero if coalescing is disabled
+      size_type max_elements() const { return max_elements_; }
+
+      /// Set the largest mean volume of coalesced tiles
+
+      /// \param max_elements The new volume, or zero to disable coalescing
+      /// \note This must be called on all processes between contractions.
+      void max_elements(const size_type max_elements) { max_elements_ = max_elements; }
+
+      /// Coalescing test
+
+      /// \param tiles The number of tiles of a broadcast
+      /// \param elements The total volume of the tiles
+      /// \return \c true if the tiles are broadcast in one message
+      bool coalesce(const size_type tiles, const size_type elements) const {
+        return (tiles > 1ul) && (elements <= max_elements_ * tiles);
+      }
+
+    }; // class SummaCoalescePolicy
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_COALESCE_H__INCLUDED
@@ -0,0 +1,242 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_depth.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Runtime controller for the number of concurrent SUMMA iterations
+
+    /// This object collects timing data from completed SUMMA steps. It tracks
+    /// the broadcast latency, which is the time from the start of a step until
+    /// all of its argument tiles have arrived, and the time between the start
+    /// of consecutive steps. The number of concurrent iterations needed to
+    /// hide the broadcast latency is the ratio of the two. The controller also
+    /// provides the default memory and depth limits, which are given by the
+    /// \c TA_SUMMA_MAX_MEMORY and \c TA_SUMMA_MAX_DEPTH environment variables.
+    /// When \c TA_SUMMA_MAX_MEMORY is not set, the memory limit is half of the
+    /// available physical memory of the node.
+    /// \note There is one controller per process, which is shared by all
+    /// contractions.
+    class SummaDepthController {
+    public:
+      typedef std::size_t size_type; ///< Size type
+      typedef std::chrono::steady_clock clock_type; ///< Clock type
+      typedef clock_type::time_point time_point; ///< Time point type
+
+    private:
+      mutable madness::Spinlock lock_; ///< Lock for timing data
+      double latency_; ///< Smoothed broadcast latency (in seconds)
+      double step_time_; ///< Smoothed time between SUMMA steps (in seconds)
+      const size_type max_memory_; ///< User defined memory limit
+      const size_type max_depth_; ///< User defined depth limit
+
+      /// Weight of new samples in the smoothed timing data
+      static constexpr double sample_weight = 0.25;
+
+      SummaDepthController() :
+        lock_(), latency_(0.0), step_time_(0.0),
+        max_memory_(parse_memory(getenv("TA_SUMMA_MAX_MEMORY"))),
+        max_depth_(parse_depth(getenv("TA_SUMMA_MAX_DEPTH")))
+      { }
+
+      SummaDepthController(const SummaDepthController&) = delete;
+      SummaDepthController& operator=(const SummaDepthController&) = delete;
+
+      /// Add a sample to a smoothed value
+
+      /// \param value The smoothed value
+      /// \param sample The new sample
+      void update(double& value, const double sample) {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        value = (value > 0.0 ?
+            (1.0 - sample_weight) * value + sample_weight * sample : sample);
+      }
+
+    public:
+
+      /// Controller accessor
+
+      /// \return A reference to the SUMMA depth controller of this process
+      static SummaDepthController& instance() {
+        static SummaDepthController controller;
+        return controller;
+      }
+
+      /// Current time
+
+      /// \return The current time point
+      static time_point now() { return clock_type::now(); }
+
+      /// Time since \c start
+
+      /// \param start The start time
+      /// \return The number of seconds elapsed since \c start
+      static double elapsed(const time_point& start) {
+        return std::chrono::duration<double>(now() - start).count();
+      }
+
+      /// Convert a memory size string into bytes
+
+      /// The string contains a number followed by an optional unit; accepted
+      /// units are kB, KiB, MB, MiB, GB, and GiB. Numbers without a unit are
+      /// given in bytes.
+      /// \param str The memory size string
+      /// \return The memory size in bytes, but no less than 100 MiB, or zero
+      /// if \c str is \c nullptr .
+      static size_type parse_memory(const char* str) {
+        if(! str)
+          return 0ul;
+
+        // Convert the string into bytes
+        std::stringstream ss(str);
+        double memory = 0.0;
+        if(ss >> memory) {
+          if(memory > 0.0) {
+            std::string unit;
+            if(ss >> unit) { // Failure == assume bytes
+              if(unit == "KB" || unit == "kB") {
+                memory *= 1000.0;
+              } else if(unit == "KiB" || unit == "kiB") {
+                memory *= 1024.0;
+              } else if(unit == "MB") {
+                memory *= 1000000.0;
+              } else if(unit == "MiB") {
+                memory *= 1048576.0;
+              } else if(unit == "GB") {
+                memory *= 1000000000.0;
+              } else if(unit == "GiB") {
+                memory *= 1073741824.0;
+              }
+            }
+          }
+        }
+
+        memory = std::max(memory, 104857600.0); // Minimum 100 MiB
+        return memory;
+      }
+
+      /// Convert a depth string into a number
+
+      /// \param str The depth string
+      /// \return The depth, or zero if \c str is \c nullptr
+      static size_type parse_depth(const char* str) {
+        if(str)
+          return std::stoul(str);
+        return 0ul;
+      }
+
+      /// Available physical memory
+
+      /// \return The available physical memory of this node in bytes, or zero
+      /// when it is not known
+      static size_type available_memory() {
+#if defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+        const long pages = sysconf(_SC_AVPHYS_PAGES);
+        const long page_size = sysconf(_SC_PAGESIZE);
+        if((pages > 0l) && (page_size > 0l))
+          return size_type(pages) * size_type(page_size);
+#endif // defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+        return 0ul;
+      }
+
+      /// Default memory limit for SUMMA iterations
+
+      /// \return The number of bytes that may be used by the arguments of
+      /// concurrent SUMMA iterations, or zero if there is no limit
+      size_type max_memory() const {
+        return (max_memory_ ? max_memory_ : available_memory() / 2ul);
+      }
+
+      /// Check for a user defined memory limit
+
+      /// \return \c true if the memory limit was given by the user
+      bool user_max_memory() const { return max_memory_ != 0ul; }
+
+      /// Default limit on the number of concurrent SUMMA iterations
+
+      /// \return The maximum SUMMA depth, or zero if there is no limit
+      size_type max_depth() const { return max_depth_; }
+
+      /// Record the broadcast latency of a SUMMA step
+
+      /// \param latency The time, in seconds, from the start of a step until
+      /// all of its argument tiles have arrived
+      void record_latency(const double latency) { update(latency_, latency); }
+
+      /// Record the average time between SUMMA steps of a contraction
+
+      /// \param step_time The time, in seconds, between steps
+      void record_step_time(const double step_time) {
+        if(step_time > 0.0)
+          update(step_time_, step_time);
+      }
+
+      /// Number of concurrent SUMMA iterations that hide broadcast latency
+
+      /// \return The measured depth, or zero if no timing data is available
+      size_type latency_depth() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        if((latency_ <= 0.0) || (step_time_ <= 0.0))
+          return 0ul;
+        return size_type(std::ceil(latency_ / step_time_)) + 1ul;
+      }
+
+      /// Number of concurrent SUMMA iterations that hide broadcast latency
+
+      /// \param step_time The time, in seconds, between the steps of the
+      /// running contraction
+      /// \return The depth needed for the measured latency, or zero if no
+      /// timing data is available
+      size_type latency_depth(const double step_time) const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        if((latency_ <= 0.0) || (step_time <= 0.0))
+          return 0ul;
+        return size_type(std::ceil(latency_ / step_time)) + 1ul;
+      }
+
+      /// Discard all timing data
+      void reset() {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        latency_ = 0.0;
+        step_time_ = 0.0;
+      }
+
+    }; // class SummaDepthController
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_DEPTH_H__INCLUDED
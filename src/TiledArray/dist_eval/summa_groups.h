@@ -0,0 +1,127 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_groups.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_GROUPS_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_GROUPS_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <map>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Broadcast groups of sparse SUMMA
+
+    /// The sparse SUMMA algorithm broadcasts the tiles of each iteration to
+    /// a group of processes in a process row or column, and most iterations
+    /// have the same group. This cache holds one \c madness::Group for each
+    /// group membership, so a group is constructed and registered once
+    /// instead of once per iteration.
+    ///
+    /// The members of a group must agree on its id. Groups are only shared
+    /// when the membership can be encoded as a bit mask of the positions of
+    /// the members in the process row or column, which is used as the group
+    /// id; see \c SummaGroupCache::is_shared and
+    /// \c SummaGroupCache::shared_key .
+    class SummaGroupCache {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      typedef std::pair<bool, std::vector<ProcessID> > key_type; ///< Group key (row flag and members)
+
+      mutable madness::Spinlock lock_; ///< Cache lock
+      std::map<key_type, madness::Group> groups_; ///< Cached groups
+
+      SummaGroupCache(const SummaGroupCache&) = delete;
+      SummaGroupCache& operator=(const SummaGroupCache&) = delete;
+
+    public:
+
+      /// Shared group check
+
+      /// \param size The number of processes in the process row or column
+      /// \return \c true if the groups of the row or column can be shared
+      static constexpr bool is_shared(const size_type size) {
+        return size <= 60ul;
+      }
+
+      /// Construct an empty cache
+      SummaGroupCache() : lock_(), groups_() { }
+
+      /// Shared group key
+
+      /// The key is unique for each membership of a row or column group, and
+      /// it does not overlap with the per-iteration keys of SUMMA, which are
+      /// smaller than <tt>2 * k</tt> .
+      /// \param k The number of SUMMA iterations
+      /// \param mask The bit mask of the positions of the members in the
+      /// process row or column
+      /// \param row \c true for row groups and \c false for column groups
+      /// \return The key of the group
+      static size_type shared_key(const size_type k, const size_type mask,
+          const bool row)
+      {
+        return 2ul * k + 2ul * mask + (row ? 0ul : 1ul);
+      }
+
+      /// Find or construct a group
+
+      /// \param world The world of the group
+      /// \param row \c true for row groups and \c false for column groups
+      /// \param procs The members of the group
+      /// \param did The id of the group, which is used if the group is not
+      /// cached
+      /// \return The group with members \c procs
+      madness::Group group(World& world, const bool row,
+          const std::vector<ProcessID>& procs, const madness::DistributedID& did)
+      {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        key_type key(row, procs);
+        auto it = groups_.find(key);
+        if(it == groups_.end())
+          it = groups_.emplace(std::move(key), madness::Group(world, procs, did)).first;
+        return it->second;
+      }
+
+      /// Remove all groups
+      void clear() {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        groups_.clear();
+      }
+
+      /// \return The number of cached groups
+      size_type size() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        return groups_.size();
+      }
+
+    }; // class SummaGroupCache
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_GROUPS_H__INCLUDED
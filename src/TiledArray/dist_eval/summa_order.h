@@ -0,0 +1,105 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_order.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_ORDER_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_ORDER_H__INCLUDED
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Local task order policy of SUMMA
+
+    /// In each SUMMA step a process contracts every tile of its column of the
+    /// left-hand argument with every tile of its row of the right-hand
+    /// argument. The tile contractions are scheduled in blocks of
+    /// \c block_size() rows by \c block_size() columns, so the argument tiles
+    /// of a block fit in \c cache_bytes() and stay in cache across the GEMMs
+    /// that use them; this matters for medium tiles, where GEMMs are memory
+    /// bound. The default cache size is 1 MiB, or the value of the
+    /// \c TA_SUMMA_CACHE_BYTES environment variable; zero disables blocking,
+    /// so contractions are scheduled row by row.
+    /// \note There is one policy per process, which is shared by all
+    /// contractions.
+    class SummaOrderPolicy {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type cache_bytes_; ///< The cache size of a block of tiles
+
+      SummaOrderPolicy() :
+        cache_bytes_(getenv("TA_SUMMA_CACHE_BYTES") ?
+            std::stoul(getenv("TA_SUMMA_CACHE_BYTES")) : (1ul << 20))
+      { }
+
+      SummaOrderPolicy(const SummaOrderPolicy&) = delete;
+      SummaOrderPolicy& operator=(const SummaOrderPolicy&) = delete;
+
+    public:
+
+      /// Policy accessor
+
+      /// \return A reference to the policy of this process
+      static SummaOrderPolicy& instance() {
+        static SummaOrderPolicy policy;
+        return policy;
+      }
+
+      /// \return The cache size of a block of argument tiles, or zero if
+      /// blocking is disabled
+      size_type cache_bytes() const { return cache_bytes_; }
+
+      /// Set the cache size of a block of argument tiles
+
+      /// \param cache_bytes The new cache size, or zero to disable blocking
+      void cache_bytes(const size_type cache_bytes) { cache_bytes_ = cache_bytes; }
+
+      /// Block size
+
+      /// \param left_bytes The size of a left-hand argument tile
+      /// \param right_bytes The size of a right-hand argument tile
+      /// \return The number of rows and columns of a block of tile
+      /// contractions, which is at least one
+      size_type block_size(const size_type left_bytes,
+          const size_type right_bytes) const
+      {
+        if(cache_bytes_ == 0ul)
+          return std::numeric_limits<size_type>::max();
+        const size_type pair_bytes = left_bytes + right_bytes;
+        return (pair_bytes == 0ul ? std::numeric_limits<size_type>::max() :
+            std::max<size_type>(cache_bytes_ / pair_bytes, 1ul));
+      }
+
+    }; // class SummaOrderPolicy
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_ORDER_H__INCLUDED
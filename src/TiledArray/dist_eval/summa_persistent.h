@@ -0,0 +1,410 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_persistent.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_PERSISTENT_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_PERSISTENT_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/rendezvous_exchange.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <vector>
+
+/// The largest tile (in bytes) that is broadcast over a persistent channel
+#ifndef TILEDARRAY_SUMMA_PERSISTENT_MAX_BYTES
+#define TILEDARRAY_SUMMA_PERSISTENT_MAX_BYTES 65536ul
+#endif // TILEDARRAY_SUMMA_PERSISTENT_MAX_BYTES
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Persistent broadcast policy of SUMMA
+
+    /// By default each SUMMA broadcast is an active message broadcast, which
+    /// serializes the tile and computes the broadcast tree at every hop.
+    /// When the persistent broadcasts are enabled, contractions that are
+    /// evaluated with a \c ContractionPlan broadcast each tile over a
+    /// persistent channel (see \c SummaChannel ): the broadcast tree of the
+    /// tile, a buffer for its elements and persistent MPI requests to the
+    /// parent and children in the tree are set up by the first evaluation
+    /// and restarted by the following ones. This removes most of the
+    /// per-message software overhead of latency bound contractions. Only
+    /// \c Tensor tiles of at most \c TILEDARRAY_SUMMA_PERSISTENT_MAX_BYTES
+    /// bytes are broadcast this way, and only when MPI supports
+    /// \c MPI_THREAD_MULTIPLE . The channels hold one buffer per tile that
+    /// passes through this process, which is freed with the broadcast groups
+    /// of the plan. The broadcasts are disabled by default; they are enabled
+    /// with \c enable() or by setting the \c TA_SUMMA_PERSISTENT_BCAST
+    /// environment variable.
+    /// \note There is one policy per process, which is shared by all
+    /// contractions. It must be the same on all processes.
+    class SummaPersistentPolicy {
+      bool enabled_; ///< Persistent broadcast flag
+
+      SummaPersistentPolicy() :
+        enabled_(getenv("TA_SUMMA_PERSISTENT_BCAST") != nullptr)
+      { }
+
+      SummaPersistentPolicy(const SummaPersistentPolicy&) = delete;
+      SummaPersistentPolicy& operator=(const SummaPersistentPolicy&) = delete;
+
+    public:
+
+      /// Policy accessor
+
+      /// \return A reference to the policy of this process
+      static SummaPersistentPolicy& instance() {
+        static SummaPersistentPolicy policy;
+        return policy;
+      }
+
+      /// Enable the persistent broadcasts
+      void enable() { enabled_ = true; }
+
+      /// Disable the persistent broadcasts
+      void disable() { enabled_ = false; }
+
+      /// \return \c true if the persistent broadcasts are enabled
+      bool enabled() const { return enabled_; }
+
+    }; // class SummaPersistentPolicy
+
+    /// Persistent broadcast channel of one tile
+
+    /// The channel holds the position of this process in the broadcast tree
+    /// of a tile, which is a binary tree over the broadcast group rooted at
+    /// the group root, a buffer for the elements of the tile, and persistent
+    /// requests that receive the buffer from the parent and send it to the
+    /// children. A channel is used by one broadcast at a time; a broadcast
+    /// of a later evaluation waits until the previous one is complete, and
+    /// MPI matches the messages of the evaluations in order.
+    class SummaChannel {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      std::vector<char> buffer_; ///< The elements of the tile
+#ifndef STUBOUTMPI
+      MPI_Request recv_; ///< Receive request from the parent (null at the root)
+      std::vector<MPI_Request> sends_; ///< Send requests to the children
+#endif // STUBOUTMPI
+      std::atomic<bool> busy_; ///< Broadcast in progress flag
+
+      SummaChannel(const SummaChannel&) = delete;
+      SummaChannel& operator=(const SummaChannel&) = delete;
+
+      /// Wait for requests
+
+      /// The calling thread runs other tasks while it waits.
+      /// \param world The world of the broadcast
+      /// \param n The number of requests
+      /// \param requests The requests
+#ifndef STUBOUTMPI
+      static void wait(World& world, const int n, MPI_Request* const requests) {
+        if(n == 0)
+          return;
+        world.await([n, requests] () -> bool {
+          int flag = 0;
+          MPI_Testall(n, requests, & flag, MPI_STATUSES_IGNORE);
+          return flag != 0;
+        });
+      }
+#endif // STUBOUTMPI
+
+      /// Send the buffer to the children and release the channel
+
+      /// \param world The world of the broadcast
+      void forward(World& world) {
+#ifndef STUBOUTMPI
+        if(! sends_.empty()) {
+          MPI_Startall(sends_.size(), sends_.data());
+          wait(world, sends_.size(), sends_.data());
+        }
+#endif // STUBOUTMPI
+        busy_ = false;
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param comm The communicator of the channel
+      /// \param tag The message tag of the channel
+      /// \param bytes The size of the tile elements
+      /// \param parent The parent of this process in the tree, or -1 at the
+      /// root
+      /// \param children The children of this process in the tree
+#ifndef STUBOUTMPI
+      SummaChannel(MPI_Comm comm, const int tag, const size_type bytes,
+          const ProcessID parent, const std::vector<ProcessID>& children) :
+        buffer_(bytes), recv_(MPI_REQUEST_NULL), sends_(children.size(), MPI_REQUEST_NULL),
+        busy_(false)
+      {
+        TA_ASSERT(bytes <= size_type(INT_MAX));
+        if(parent >= 0)
+          MPI_Recv_init(buffer_.data(), bytes, MPI_BYTE, parent, tag, comm, & recv_);
+        for(std::size_t i = 0ul; i < children.size(); ++i)
+          MPI_Send_init(buffer_.data(), bytes, MPI_BYTE, children[i], tag, comm,
+              & sends_[i]);
+      }
+#endif // STUBOUTMPI
+
+      /// Free the persistent requests, which are inactive
+      ~SummaChannel() {
+#ifndef STUBOUTMPI
+        if(recv_ != MPI_REQUEST_NULL)
+          MPI_Request_free(& recv_);
+        for(MPI_Request& request : sends_)
+          MPI_Request_free(& request);
+#endif // STUBOUTMPI
+      }
+
+      /// \return The size of the tile elements
+      size_type bytes() const { return buffer_.size(); }
+
+      /// Broadcast a tile from the root
+
+      /// \tparam T The tile type
+      /// \param world The world of the broadcast
+      /// \param tile The tile
+      template <typename T>
+      void send(World& world, const T& tile) {
+        TA_ASSERT(tile.range().volume() * sizeof(typename T::value_type) == buffer_.size());
+        world.await([this] () -> bool { return ! busy_.exchange(true); });
+        std::copy_n(reinterpret_cast<const char*>(tile.data()), buffer_.size(),
+            buffer_.data());
+        forward(world);
+      }
+
+      /// Receive a tile from the parent and forward it to the children
+
+      /// \tparam T The tile type
+      /// \param world The world of the broadcast
+      /// \param range The range of the tile
+      /// \param[out] tile The future that is set to the received tile
+      template <typename T>
+      void recv(World& world, const typename T::range_type& range, Future<T> tile) {
+        world.await([this] () -> bool { return ! busy_.exchange(true); });
+#ifndef STUBOUTMPI
+        MPI_Start(& recv_);
+        wait(world, 1, & recv_);
+#endif // STUBOUTMPI
+        T result(range);
+        TA_ASSERT(result.range().volume() * sizeof(typename T::value_type) == buffer_.size());
+        std::copy_n(buffer_.data(), buffer_.size(), reinterpret_cast<char*>(result.data()));
+        tile.set(std::move(result));
+        forward(world);
+      }
+
+    }; // class SummaChannel
+
+    /// The persistent broadcast channels of a contraction plan
+
+    /// The channels of a plan are keyed by the SUMMA broadcast keys of the
+    /// tiles, and each plan gets a distinct block of message tags on a
+    /// communicator that is duplicated once per world, so the channels do
+    /// not match messages of other plans or of MADNESS. The channels are
+    /// constructed when a tile is first broadcast, and freed with the
+    /// broadcast groups of the plan, since the trees depend on the groups.
+    class SummaChannels {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+#ifndef STUBOUTMPI
+      MPI_Comm comm_; ///< The communicator of the channels
+#endif // STUBOUTMPI
+      int tag_base_; ///< The tag of the first broadcast key
+      size_type keys_; ///< The number of broadcast keys
+      mutable madness::Spinlock lock_; ///< Channel map lock
+      std::map<size_type, std::shared_ptr<SummaChannel> > channels_; ///< The channels of the broadcast keys
+
+      SummaChannels(const SummaChannels&) = delete;
+      SummaChannels& operator=(const SummaChannels&) = delete;
+
+#ifndef STUBOUTMPI
+      /// The communicator and the next free tag of a world
+      struct WorldComm {
+        MPI_Comm comm; ///< Duplicate of the world communicator
+        int tag_ub; ///< The largest tag of \c comm
+        int next_tag; ///< The first tag of the next plan
+      }; // struct WorldComm
+
+      /// Communicator accessor
+
+      /// The communicator is duplicated the first time it is requested for
+      /// \c world , so this is collective then. It is not freed, since that
+      /// would be collective too; MPI frees it when it is finalized.
+      /// \param world The world
+      /// \return The communicator and tags of \c world
+      static WorldComm& world_comm(World& world) {
+        static madness::Spinlock lock;
+        static std::map<unsigned long, WorldComm> comms;
+        madness::ScopedMutex<madness::Spinlock> locker(&lock);
+        auto it = comms.find(world.id());
+        if(it == comms.end()) {
+          WorldComm comm = { MPI_COMM_NULL, 0, 0 };
+          MPI_Comm_dup(world.mpi.comm().Get_mpi_comm(), & comm.comm);
+          int* tag_ub = nullptr;
+          int flag = 0;
+          MPI_Comm_get_attr(comm.comm, MPI_TAG_UB, & tag_ub, & flag);
+          comm.tag_ub = (flag ? *tag_ub : 32767);
+          it = comms.emplace(world.id(), comm).first;
+        }
+        return it->second;
+      }
+
+      SummaChannels(MPI_Comm comm, const int tag_base, const size_type keys) :
+        comm_(comm), tag_base_(tag_base), keys_(keys), lock_(), channels_()
+      { }
+#endif // STUBOUTMPI
+
+    public:
+
+      /// Persistent broadcast check
+
+      /// \param world The world of the contraction
+      /// \return \c true if SUMMA broadcasts in \c world may use persistent
+      /// channels
+      static bool supported(World& world) {
+#ifndef STUBOUTMPI
+        if((world.size() == 1) || ! SummaPersistentPolicy::instance().enabled())
+          return false;
+        int provided = MPI_THREAD_SINGLE;
+        MPI_Query_thread(& provided);
+        return provided == MPI_THREAD_MULTIPLE;
+#else
+        return false;
+#endif // STUBOUTMPI
+      }
+
+      /// Construct the channels of a plan
+
+      /// The tags of the channels are allocated in the same order on all
+      /// processes, so this must be called by all processes of \c world in
+      /// the same order, e.g. when a contraction is constructed.
+      /// \param world The world of the contraction
+      /// \param keys The number of broadcast keys of the contraction
+      /// \return The channels, or a null pointer if the keys do not fit in
+      /// the message tags
+      static std::shared_ptr<SummaChannels> make(World& world, const size_type keys) {
+#ifndef STUBOUTMPI
+        WorldComm& comm = world_comm(world);
+        if(keys > size_type(comm.tag_ub))
+          return std::shared_ptr<SummaChannels>();
+        if(size_type(comm.next_tag) + keys > size_type(comm.tag_ub))
+          comm.next_tag = 0;
+        const int tag_base = comm.next_tag;
+        comm.next_tag += int(keys);
+        return std::shared_ptr<SummaChannels>(
+            new SummaChannels(comm.comm, tag_base, keys));
+#else
+        return std::shared_ptr<SummaChannels>();
+#endif // STUBOUTMPI
+      }
+
+      /// Persistent tile check
+
+      /// \param bytes The size of the elements of a tile
+      /// \return \c true if the tile is broadcast over a persistent channel
+      static bool is_persistent(const size_type bytes) {
+        return (bytes > 0ul) && (bytes <= TILEDARRAY_SUMMA_PERSISTENT_MAX_BYTES);
+      }
+
+      /// Find or construct the channel of a broadcast
+
+      /// \param key The broadcast key of the tile
+      /// \param group The broadcast group
+      /// \param root The root of the broadcast, in \c group
+      /// \param bytes The size of the elements of the tile
+      /// \return The channel of \c key
+      std::shared_ptr<SummaChannel> channel(const size_type key,
+          const madness::Group& group, const ProcessID root, const size_type bytes)
+      {
+        TA_ASSERT(key < keys_);
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        std::shared_ptr<SummaChannel>& result = channels_[key];
+#ifndef STUBOUTMPI
+        if(! result) {
+          // The binary tree over the group ranks relative to the root
+          const ProcessID size = group.size();
+          const ProcessID rel = (group.rank() - root + size) % size;
+          const ProcessID parent = (rel == 0 ? -1 :
+              group.world_rank((((rel - 1) / 2) + root) % size));
+          std::vector<ProcessID> children;
+          for(ProcessID child = 2 * rel + 1; (child < size) && (child <= 2 * rel + 2); ++child)
+            children.push_back(group.world_rank((child + root) % size));
+          result = std::make_shared<SummaChannel>(comm_, tag_base_ + int(key),
+              bytes, parent, children);
+        }
+#endif // STUBOUTMPI
+        TA_ASSERT(result->bytes() == bytes);
+        return result;
+      }
+
+      /// \return The number of channels of this process
+      size_type size() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        return channels_.size();
+      }
+
+    }; // class SummaChannels
+
+    /// Broadcast a tile over a persistent channel
+
+    /// The root sends the tile when it is ready, and the other processes
+    /// receive it into \c tile , in high priority tasks.
+    /// \tparam T The tile type
+    /// \param world The world of the broadcast
+    /// \param channel The channel of the tile
+    /// \param tile The tile, which is set on processes other than the root
+    /// \param range The range of the tile
+    /// \param root \c true on the root of the broadcast
+    template <typename T>
+    void persistent_bcast(World& world, const std::shared_ptr<SummaChannel>& channel,
+        Future<T>& tile, const typename T::range_type& range, const bool root)
+    {
+      World* const world_ptr = & world;
+      if(root) {
+        world.taskq.add([world_ptr, channel] (const T& t) {
+          channel->send(*world_ptr, t);
+        }, tile, madness::TaskAttributes::hipri());
+      } else {
+        Future<T> result = tile;
+        world.taskq.add([world_ptr, channel, range, result] () {
+          channel->recv(*world_ptr, range, result);
+        }, madness::TaskAttributes::hipri());
+      }
+    }
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_PERSISTENT_H__INCLUDED
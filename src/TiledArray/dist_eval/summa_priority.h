@@ -0,0 +1,160 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_priority.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_PRIORITY_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_PRIORITY_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <cstdlib>
+#include <string>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Task priority policy of SUMMA
+
+    /// MADNESS has two task priorities, so SUMMA tasks are given high
+    /// priority only when they are on the critical path of the pipeline, and
+    /// otherwise run in order with other work. The priority of a task depends
+    /// on the distance of its SUMMA iteration \c k from the front of the
+    /// pipeline, which is the iteration of the step that started most
+    /// recently:
+    /// \li The tasks that collect the argument tiles of iteration \c k have
+    /// high priority when <tt>k < front + bcast_distance</tt>. The broadcasts
+    /// of a step have high priority, since the step only starts when its
+    /// tiles are needed.
+    /// \li The tile contractions of iteration \c k have high priority when
+    /// <tt>k + reduce_distance >= k_end</tt>, i.e. when the result tiles are
+    /// nearing completion.
+    ///
+    /// A distance of zero gives all tasks of that kind high priority. The
+    /// defaults are given by the \c TA_SUMMA_BCAST_DISTANCE and
+    /// \c TA_SUMMA_REDUCE_DISTANCE environment variables; otherwise they are
+    /// 2 and 1.
+    /// \note There is one policy per process, which is shared by all
+    /// contractions.
+    class SummaPriorityPolicy {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type bcast_distance_; ///< The distance of high priority tile collection
+      size_type reduce_distance_; ///< The distance of high priority contractions
+
+      SummaPriorityPolicy() :
+        bcast_distance_(parse_distance(getenv("TA_SUMMA_BCAST_DISTANCE"), 2ul)),
+        reduce_distance_(parse_distance(getenv("TA_SUMMA_REDUCE_DISTANCE"), 1ul))
+      { }
+
+      SummaPriorityPolicy(const SummaPriorityPolicy&) = delete;
+      SummaPriorityPolicy& operator=(const SummaPriorityPolicy&) = delete;
+
+      /// Convert a distance string into a number
+
+      /// \param str The distance string
+      /// \param default_distance The distance when \c str is \c nullptr
+      /// \return The distance
+      static size_type parse_distance(const char* str,
+          const size_type default_distance)
+      {
+        if(str)
+          return std::stoul(str);
+        return default_distance;
+      }
+
+      /// Task attributes for a priority
+
+      /// \param hipri The high priority flag
+      /// \return The task attributes
+      static madness::TaskAttributes attributes(const bool hipri) {
+        return (hipri ? madness::TaskAttributes::hipri() :
+            madness::TaskAttributes());
+      }
+
+    public:
+
+      /// Policy accessor
+
+      /// \return A reference to the policy of this process
+      static SummaPriorityPolicy& instance() {
+        static SummaPriorityPolicy policy;
+        return policy;
+      }
+
+      /// \return The distance from the front of the pipeline within which
+      /// argument tiles are collected with high priority
+      size_type bcast_distance() const { return bcast_distance_; }
+
+      /// \return The number of final iterations whose contractions have high
+      /// priority
+      size_type reduce_distance() const { return reduce_distance_; }
+
+      /// Set the tile collection distance
+
+      /// \param distance The new distance, or zero for high priority at any
+      /// distance
+      void bcast_distance(const size_type distance) { bcast_distance_ = distance; }
+
+      /// Set the contraction distance
+
+      /// \param distance The new distance, or zero for high priority at any
+      /// distance
+      void reduce_distance(const size_type distance) { reduce_distance_ = distance; }
+
+      /// Tile collection priority
+
+      /// \param k The SUMMA iteration of the tiles
+      /// \param front The front of the SUMMA pipeline
+      /// \return \c true if the tiles of \c k are collected with high priority
+      bool bcast_hipri(const size_type k, const size_type front) const {
+        return (bcast_distance_ == 0ul) || (k < front + bcast_distance_);
+      }
+
+      /// Contraction priority
+
+      /// \param k The SUMMA iteration of the contraction
+      /// \param k_end The number of SUMMA iterations
+      /// \return \c true if the contractions of \c k have high priority
+      bool reduce_hipri(const size_type k, const size_type k_end) const {
+        return (reduce_distance_ == 0ul) || (k + reduce_distance_ >= k_end);
+      }
+
+      /// Tile collection task attributes
+
+      /// \param k The SUMMA iteration of the tiles
+      /// \param front The front of the SUMMA pipeline
+      /// \return The attributes of the tasks that collect the tiles of \c k
+      madness::TaskAttributes bcast_attributes(const size_type k,
+          const size_type front) const
+      {
+        return attributes(bcast_hipri(k, front));
+      }
+
+    }; // class SummaPriorityPolicy
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_PRIORITY_H__INCLUDED
@@ -0,0 +1,427 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_steal.h
+ *  Oct 15, 2016
+ *
+ */
+
+
+#ifndef TILEDARRAY_DIST_EVAL_SUMMA_STEAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SUMMA_STEAL_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Work stealing policy of SUMMA contractions
+
+    /// Load imbalance that is not captured by the process map, e.g. uneven
+    /// screening or operating system noise, leaves processes idle at the end
+    /// of each contraction while others still contract tile pairs. When work
+    /// stealing is enabled, the tile pairs of the last \c fraction() of the
+    /// SUMMA iterations of each contraction are contracted into separate
+    /// partial results, and a process that has no pending pairs after its
+    /// last iteration steals ready pairs from the processes in its row and
+    /// column of the process grid (see \c SummaStealPool ). Stealing is
+    /// disabled by default; it is enabled with \c fraction() or by setting
+    /// the \c TA_SUMMA_STEAL environment variable to the fraction of
+    /// iterations, e.g. 0.25.
+    /// \note There is one policy per process, which is shared by all
+    /// contractions. It must be the same on all processes.
+    class SummaStealPolicy {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      double fraction_; ///< The fraction of stealable iterations
+      size_type max_batch_; ///< The maximum number of pairs of a steal
+
+      SummaStealPolicy() :
+        fraction_(getenv("TA_SUMMA_STEAL") ?
+            std::min(std::max(std::stod(getenv("TA_SUMMA_STEAL")), 0.0), 1.0) : 0.0),
+        max_batch_(4ul)
+      { }
+
+      SummaStealPolicy(const SummaStealPolicy&) = delete;
+      SummaStealPolicy& operator=(const SummaStealPolicy&) = delete;
+
+    public:
+
+      /// Policy accessor
+
+      /// \return A reference to the policy of this process
+      static SummaStealPolicy& instance() {
+        static SummaStealPolicy policy;
+        return policy;
+      }
+
+      /// \return \c true if work stealing is enabled
+      bool enabled() const { return fraction_ > 0.0; }
+
+      /// \return The fraction of the SUMMA iterations whose tile pairs can
+      /// be stolen, or zero if work stealing is disabled
+      double fraction() const { return fraction_; }
+
+      /// Set the fraction of stealable iterations
+
+      /// \param fraction The fraction in <tt>[0,1]</tt> , or zero to disable
+      /// work stealing
+      /// \note This must be called on all processes between contractions.
+      void fraction(const double fraction) {
+        TA_ASSERT((fraction >= 0.0) && (fraction <= 1.0));
+        fraction_ = fraction;
+      }
+
+      /// \return The maximum number of tile pairs taken by a steal
+      size_type max_batch() const { return max_batch_; }
+
+      /// Set the maximum number of tile pairs taken by a steal
+
+      /// \param max_batch The number of pairs, which must be positive
+      void max_batch(const size_type max_batch) {
+        TA_ASSERT(max_batch > 0ul);
+        max_batch_ = max_batch;
+      }
+
+      /// Number of stealable iterations
+
+      /// \param steps The number of SUMMA iterations of a process
+      /// \return The number of iterations at the end of \c steps whose tile
+      /// pairs can be stolen
+      size_type steps(const size_type steps) const {
+        const size_type result = fraction_ * double(steps) + 0.999999;
+        return std::min(result, steps);
+      }
+
+    }; // class SummaStealPolicy
+
+    /// Pool of stealable SUMMA tile pairs
+
+    /// Each tile pair that is added to the pool is contracted into its own
+    /// partial result, which is reduced by the reduce task of its result
+    /// tile (see \c ReduceTask::add_result() ). The pair is contracted by a
+    /// local task when its tiles are ready, unless it is stolen before the
+    /// task runs. Once the pool is closed, i.e. after the last SUMMA
+    /// iteration of this process, and all local pairs have been taken, this
+    /// process becomes a thief: it requests pairs from the processes of its
+    /// row and column of the process grid, one at a time. A victim hands
+    /// over up to half of its ready pairs, together with their tiles, and
+    /// the thief contracts them and sends the partial results back. The
+    /// thief asks the same victim again until the victim has no ready pairs,
+    /// and stops after each victim has been asked once without success.
+    /// \tparam Op The tile pair contraction operation type
+    /// \tparam Left The left-hand tile type
+    /// \tparam Right The right-hand tile type
+    /// \note Pools must be constructed with \c make() in the same order on
+    /// all processes, and they are destroyed when all processes have
+    /// released them.
+    template <typename Op, typename Left, typename Right>
+    class SummaStealPool :
+        public madness::WorldObject<SummaStealPool<Op, Left, Right> >,
+        public std::enable_shared_from_this<SummaStealPool<Op, Left, Right> >
+    {
+    public:
+      typedef SummaStealPool<Op, Left, Right> SummaStealPool_; ///< This object type
+      typedef madness::WorldObject<SummaStealPool_> WorldObject_; ///< Base object type
+      typedef typename Op::result_type result_type; ///< The partial result type
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+
+      /// A tile pair that has not been taken
+      struct Pair {
+        Future<Left> left; ///< The left-hand tile
+        Future<Right> right; ///< The right-hand tile
+        Future<result_type> partial; ///< The partial result of the pair
+      }; // struct Pair
+
+      const Op op_; ///< The tile pair contraction operation
+      const std::vector<ProcessID> victims_; ///< The processes that are asked for pairs
+      madness::Spinlock lock_; ///< Lock for the pairs
+      std::map<size_type, Pair> pending_; ///< Pairs that have not been taken, oldest first
+      std::unordered_map<size_type, Future<result_type> > stolen_;
+                        ///< Partial results of the pairs that were stolen
+      size_type next_id_; ///< The id of the next pair
+      bool closed_; ///< Set when no more pairs are added
+      bool stealing_; ///< Set when this process started stealing
+      size_type tries_; ///< The number of victims that were asked without success
+      std::shared_ptr<SummaStealPool_> self_; ///< Holds this object while stealing
+      madness::AtomicInt stolen_pairs_; ///< The number of pairs contracted for other processes
+
+      /// Construct a pool
+
+      /// \param world The world of the contraction
+      /// \param op The tile pair contraction operation
+      /// \param victims The processes that are asked for pairs
+      SummaStealPool(World& world, const Op& op, const std::vector<ProcessID>& victims) :
+        WorldObject_(world), op_(op), victims_(victims), lock_(), pending_(),
+        stolen_(), next_id_(0ul), closed_(false), stealing_(false), tries_(0ul),
+        self_()
+      {
+        stolen_pairs_ = 0;
+        WorldObject_::process_pending();
+      }
+
+      /// Pool deleter
+
+      /// The pool is deleted when all processes have released it, so no
+      /// messages are in flight.
+      /// \param pool The pool to be deleted
+      static void deleter(SummaStealPool_* const pool) {
+        if(madness::initialized())
+          pool->get_world().gop.lazy_sync(pool->id(), [pool] () { delete pool; });
+        else
+          delete pool;
+      }
+
+      /// Contract a tile pair
+
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      /// \return The partial result of the pair
+      result_type contract(const Left& left, const Right& right) const {
+        result_type result = op_();
+        op_(result, left, right);
+        return result;
+      }
+
+      /// Start stealing when all local pairs have been taken
+
+      /// \note The caller must hold \c lock_ .
+      /// \return \c true if this process should start stealing
+      bool become_thief() {
+        if(! closed_ || stealing_ || ! pending_.empty())
+          return false;
+        stealing_ = true;
+        return ! victims_.empty();
+      }
+
+      /// Ask the next victim for pairs
+      void request() {
+        const ProcessID rank = WorldObject_::get_world().rank();
+        const ProcessID victim = victims_[(rank + tries_) % victims_.size()];
+        WorldObject_::send(victim, & SummaStealPool_::steal, rank);
+      }
+
+      /// Start stealing
+      void start_stealing() {
+        self_ = this->shared_from_this();
+        request();
+      }
+
+      /// Task function that contracts a local pair
+
+      /// Nothing is done if the pair was stolen.
+      /// \param id The id of the pair
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      void run(const size_type id, const Left& left, const Right& right) {
+        Future<result_type> partial;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          auto it = pending_.find(id);
+          if(it == pending_.end())
+            return;
+          partial = it->second.partial;
+          pending_.erase(it);
+        }
+
+        partial.set(contract(left, right));
+
+        bool thief = false;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          thief = become_thief();
+        }
+        if(thief)
+          start_stealing();
+      }
+
+      /// Hand over ready pairs to a thief
+
+      /// \param thief The process that asks for pairs
+      void steal(const ProcessID thief) {
+        std::vector<size_type> ids;
+        std::vector<Left> lefts;
+        std::vector<Right> rights;
+        bool become = false;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          std::vector<typename std::map<size_type, Pair>::iterator> ready;
+          for(auto it = pending_.begin(); it != pending_.end(); ++it)
+            if(it->second.left.probe() && it->second.right.probe())
+              ready.push_back(it);
+
+          // Keep half of the ready pairs for the local tasks
+          const size_type n = std::min((ready.size() + 1ul) / 2ul,
+              SummaStealPolicy::instance().max_batch());
+          ids.reserve(n);
+          lefts.reserve(n);
+          rights.reserve(n);
+          for(size_type i = 0ul; i < n; ++i) {
+            const auto it = ready[i];
+            ids.push_back(it->first);
+            lefts.push_back(it->second.left.get());
+            rights.push_back(it->second.right.get());
+            stolen_.emplace(it->first, it->second.partial);
+            pending_.erase(it);
+          }
+          become = become_thief();
+        }
+
+        if(ids.empty())
+          WorldObject_::send(thief, & SummaStealPool_::steal_failed);
+        else
+          WorldObject_::task(thief, & SummaStealPool_::compute,
+              WorldObject_::get_world().rank(), ids, lefts, rights);
+        if(become)
+          start_stealing();
+      }
+
+      /// Contract stolen pairs and return the partial results
+
+      /// \param victim The process that handed over the pairs
+      /// \param ids The ids of the pairs
+      /// \param lefts The left-hand tiles of the pairs
+      /// \param rights The right-hand tiles of the pairs
+      void compute(const ProcessID victim, const std::vector<size_type>& ids,
+          const std::vector<Left>& lefts, const std::vector<Right>& rights)
+      {
+        std::vector<result_type> results;
+        results.reserve(ids.size());
+        for(size_type i = 0ul; i < ids.size(); ++i)
+          results.push_back(contract(lefts[i], rights[i]));
+        stolen_pairs_ += ids.size();
+        WorldObject_::send(victim, & SummaStealPool_::set_results, ids, results);
+
+        // Ask the same victim again
+        request();
+      }
+
+      /// Receive the partial results of stolen pairs
+
+      /// \param ids The ids of the pairs
+      /// \param results The partial results of the pairs
+      void set_results(const std::vector<size_type>& ids,
+          const std::vector<result_type>& results)
+      {
+        std::vector<Future<result_type> > partials;
+        partials.reserve(ids.size());
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          for(const size_type id : ids) {
+            auto it = stolen_.find(id);
+            TA_ASSERT(it != stolen_.end());
+            partials.push_back(it->second);
+            stolen_.erase(it);
+          }
+        }
+        for(size_type i = 0ul; i < ids.size(); ++i)
+          partials[i].set(results[i]);
+      }
+
+      /// Ask the next victim, or stop stealing after all victims were asked
+      void steal_failed() {
+        if(++tries_ < victims_.size()) {
+          request();
+        } else {
+          // This may delete this object, so it must be done last
+          std::shared_ptr<SummaStealPool_> self;
+          self.swap(self_);
+        }
+      }
+
+    public:
+
+      /// Construct a pool
+
+      /// This is a collective operation.
+      /// \param world The world of the contraction
+      /// \param op The tile pair contraction operation
+      /// \param victims The processes that are asked for pairs, i.e. the
+      /// other processes of the row and column of this process in the
+      /// process grid
+      /// \return A shared pointer to the pool
+      static std::shared_ptr<SummaStealPool_>
+      make(World& world, const Op& op, const std::vector<ProcessID>& victims) {
+        return std::shared_ptr<SummaStealPool_>(
+            new SummaStealPool_(world, op, victims), & SummaStealPool_::deleter);
+      }
+
+      virtual ~SummaStealPool() { }
+
+      /// Add a tile pair
+
+      /// \param left The left-hand tile
+      /// \param right The right-hand tile
+      /// \param hipri The high priority flag of the local contraction
+      /// \return The future of the partial result of the pair
+      Future<result_type> add(const Future<Left>& left, const Future<Right>& right,
+          const bool hipri)
+      {
+        Future<result_type> partial;
+        size_type id = 0ul;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          TA_ASSERT(! closed_);
+          id = next_id_++;
+          pending_.emplace(id, Pair{ left, right, partial });
+        }
+        WorldObject_::get_world().taskq.add(this->shared_from_this(),
+            & SummaStealPool_::run, id, left, right,
+            (hipri ? madness::TaskAttributes::hipri() : madness::TaskAttributes()));
+        return partial;
+      }
+
+      /// Close the pool
+
+      /// No pairs are added after this call. This process starts stealing
+      /// once the local pairs have been taken.
+      void close() {
+        bool thief = false;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          closed_ = true;
+          thief = become_thief();
+        }
+        if(thief)
+          start_stealing();
+      }
+
+      /// \return The number of pairs that this process contracted for
+      /// other processes
+      size_type stolen_pairs() const { return stolen_pairs_; }
+
+    }; // class SummaStealPool
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SUMMA_STEAL_H__INCLUDED
@@ -0,0 +1,284 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  symmetric_eval.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_SYMMETRIC_EVAL_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_SYMMETRIC_EVAL_H__INCLUDED
+
+#include <TiledArray/comm_tracker.h>
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/reduce_task.h>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Distributed evaluator of the product of an array with its transpose
+
+    /// This evaluates contractions of an array with itself, where the
+    /// contracted indices are the same in both arguments, e.g.
+    /// <tt>s("i,j") = c("i,k") * c("j,k")</tt> or
+    /// <tt>s("i,j") = c("k,i") * c("k,j")</tt> . The result is symmetric, so
+    /// only the tiles in the upper triangle of the (fused) result matrix are
+    /// computed; each lower tile is the transpose of its mirror tile and is
+    /// set by the process that computes the mirror. The products of the
+    /// diagonal tiles are computed with the \c herk tile kernel, since both of
+    /// their arguments are the same tile. Each non-zero argument tile is
+    /// broadcast once, to the processes that compute a result tile in its row
+    /// or column, where SUMMA broadcasts it twice, as left- and right-hand
+    /// argument. This halves the flops and the communication of the
+    /// contraction.
+    /// \tparam Arg The argument evaluator type
+    /// \tparam Op The contraction/reduction operation type
+    /// \tparam Policy The tensor policy class
+    /// \note The argument tiles that a process needs are held until the
+    /// evaluation is complete, so the memory use is not bounded like that of
+    /// SUMMA.
+    template <typename Arg, typename Op, typename Policy>
+    class SymmetricEvalImpl :
+        public DistEvalImpl<typename Op::result_type, Policy>,
+        public std::enable_shared_from_this<SymmetricEvalImpl<Arg, Op, Policy> >
+    {
+    public:
+      typedef SymmetricEvalImpl<Arg, Op, Policy> SymmetricEvalImpl_; ///< This object type
+      typedef DistEvalImpl<typename Op::result_type, Policy> DistEvalImpl_; ///< The base class type
+      typedef typename DistEvalImpl_::TensorImpl_ TensorImpl_; ///< The base, base class type
+      typedef Arg arg_type; ///< The argument tensor type
+      typedef typename DistEvalImpl_::size_type size_type; ///< Size type
+      typedef typename DistEvalImpl_::range_type range_type; ///< Range type
+      typedef typename DistEvalImpl_::shape_type shape_type; ///< Shape type
+      typedef typename DistEvalImpl_::pmap_interface pmap_interface; ///< Process map interface type
+      typedef typename DistEvalImpl_::trange_type trange_type; ///< Tiled range type
+      typedef typename DistEvalImpl_::value_type value_type; ///< Tile type
+      typedef typename DistEvalImpl_::eval_type eval_type; ///< Tile evaluation type
+      typedef Op op_type; ///< Tile evaluation operator type
+
+    private:
+      typedef typename arg_type::value_type arg_value_type; ///< Argument tile type
+
+      arg_type arg_; ///< The argument
+      op_type op_; ///< The contraction/reduction operation
+      const size_type m_; ///< The number of rows and columns of result tiles
+      const size_type k_; ///< The number of tiles in the contracted dimension
+      const bool trans_; ///< The contracted dimensions of the argument come first
+      Permutation mirror_; ///< Permutation from a result tile to its mirror
+
+      /// Argument tile index
+
+      /// \param i The row or column of the result
+      /// \param k The index of the contracted dimension
+      /// \return The ordinal index of the argument tile
+      size_type arg_index(const size_type i, const size_type k) const {
+        return (trans_ ? k * m_ + i : i * k_ + k);
+      }
+
+      /// The process that computes result tile <tt>(i,j)</tt> and its mirror
+
+      /// \param i The row of the result tile
+      /// \param j The column of the result tile
+      /// \return The owner of the upper triangle tile of the pair
+      ProcessID pair_owner(const size_type i, const size_type j) const {
+        return TensorImpl_::owner(std::min(i, j) * m_ + std::max(i, j));
+      }
+
+      /// \param i The row of the result tile
+      /// \param j The column of the result tile
+      /// \return \c true if result tile <tt>(i,j)</tt> and its mirror are zero
+      bool pair_is_zero(const size_type i, const size_type j) const {
+        return TensorImpl_::is_zero(i * m_ + j) && TensorImpl_::is_zero(j * m_ + i);
+      }
+
+      /// The processes that need an argument tile
+
+      /// \param i The row or column of the result
+      /// \param k The index of the contracted dimension
+      /// \return The sorted list of the owner of argument tile <tt>(i,k)</tt>
+      /// and the processes that compute a result tile with it
+      std::vector<ProcessID> arg_procs(const size_type i, const size_type k) const {
+        std::vector<ProcessID> procs(1, arg_.owner(arg_index(i, k)));
+        for(size_type j = 0ul; j < m_; ++j)
+          if(! arg_.is_zero(arg_index(j, k)) && ! pair_is_zero(i, j))
+            procs.push_back(pair_owner(i, j));
+        std::sort(procs.begin(), procs.end());
+        procs.erase(std::unique(procs.begin(), procs.end()), procs.end());
+        return procs;
+      }
+
+      /// Set an upper triangle tile and its mirror
+
+      /// \param i The row of the result tile
+      /// \param j The column of the result tile, where <tt>i <= j</tt>
+      /// \param tile The result tile <tt>(i,j)</tt>
+      void set_pair(const size_type i, const size_type j, const value_type& tile) {
+        using TiledArray::empty;
+        using TiledArray::permute;
+        const size_type upper = i * m_ + j, lower = j * m_ + i;
+        if(! TensorImpl_::is_zero(upper))
+          DistEvalImpl_::set_tile(upper, tile);
+        if((i != j) && ! TensorImpl_::is_zero(lower))
+          DistEvalImpl_::set_tile(lower, (empty(tile) ? tile : permute(tile, mirror_)));
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param arg The argument, a matrix of <tt>m x k</tt> tiles, or of
+      /// <tt>k x m</tt> tiles when \c trans is \c true
+      /// \param world The world where the tensor lives
+      /// \param trange The tiled range object
+      /// \param shape The tensor shape object
+      /// \param pmap The tile-process map
+      /// \param op The tile contraction operation
+      /// \param trans \c true if the contracted dimensions of \c arg come first
+      SymmetricEvalImpl(const arg_type& arg, World& world,
+          const trange_type& trange, const shape_type& shape,
+          const std::shared_ptr<pmap_interface>& pmap, const op_type& op,
+          const bool trans) :
+        DistEvalImpl_(world, trange, shape, pmap, Permutation()),
+        arg_(arg), op_(op),
+        m_(std::sqrt(double(trange.tiles_range().volume())) + 0.5),
+        k_(m_ ? arg.size() / m_ : 0ul), trans_(trans), mirror_()
+      {
+        TA_ASSERT(m_ * m_ == trange.tiles_range().volume());
+        TA_ASSERT(m_ * k_ == arg.size());
+
+        // Swap the row and column dimensions of a result tile
+        const unsigned int rank = trange.tiles_range().rank();
+        std::vector<unsigned int> mirror(rank);
+        for(unsigned int d = 0u; d < rank; ++d)
+          mirror[d] = (d + rank / 2u) % rank;
+        mirror_ = Permutation(mirror);
+      }
+
+      /// Virtual destructor
+      virtual ~SymmetricEvalImpl() { }
+
+      /// Get tile at index \c i
+
+      /// \param i The index of the tile
+      /// \return A \c Future to the tile at index i
+      /// \throw TiledArray::Exception When tile \c i is owned by a remote node.
+      /// \throw TiledArray::Exception When tile \c i a zero tile.
+      virtual Future<value_type> get_tile(size_type i) const {
+        TA_ASSERT(TensorImpl_::is_local(i));
+        TA_ASSERT(! TensorImpl_::is_zero(i));
+        return DistEvalImpl_::recv_tile(pair_owner(i / m_, i % m_), i);
+      }
+
+      /// Discard a tile that is not needed
+
+      /// This function handles the cleanup for tiles that are not needed in
+      /// subsequent computation.
+      /// \param i The index of the tile
+      virtual void discard_tile(size_type i) const { get_tile(i); }
+
+    private:
+
+      /// Evaluate the tiles of this tensor
+
+      /// This function will evaluate the children of this distributed evaluator
+      /// and evaluate the tiles for this distributed evaluator. It will block
+      /// until the tasks for the children are evaluated (not for the tasks of
+      /// this object).
+      /// \return The number of tiles that will be set by this process
+      virtual int internal_eval() {
+        std::shared_ptr<SymmetricEvalImpl_> self =
+            std::enable_shared_from_this<SymmetricEvalImpl_>::shared_from_this();
+        World& world = TensorImpl_::world();
+        const ProcessID rank = world.rank();
+        const size_type volume = TensorImpl_::size();
+
+        // Evaluate argument
+        arg_.eval();
+
+        // Broadcast each non-zero argument tile once, to the processes that
+        // need it as the left- or right-hand argument of a result tile.
+        std::unordered_map<size_type, Future<arg_value_type> > tiles;
+        for(size_type k = 0ul; k < k_; ++k) {
+          for(size_type i = 0ul; i < m_; ++i) {
+            const size_type index = arg_index(i, k);
+            if(arg_.is_zero(index))
+              continue;
+
+            const ProcessID root = arg_.owner(index);
+            const std::vector<ProcessID> procs = arg_procs(i, k);
+            if(! std::binary_search(procs.begin(), procs.end(), rank))
+              continue;
+
+            Future<arg_value_type> tile = (root == rank ? arg_.get(index) :
+                Future<arg_value_type>());
+            if(procs.size() > 1ul) {
+              const madness::Group group(world, procs,
+                  madness::DistributedID(DistEvalImpl_::id(), volume + index));
+              const madness::DistributedID key(DistEvalImpl_::id(),
+                  volume + arg_.size() + index);
+              world.gop.bcast(key, tile, group.rank(root), group);
+              if(root == rank)
+                comm_send(CommCategory::summa_col, tile);
+              else
+                comm_receive(CommCategory::summa_col, tile);
+            }
+            tiles.emplace(index, tile);
+          }
+        }
+
+        // Reduce the upper triangle tiles of this process
+        int tile_count = 0;
+        const typename std::unordered_map<size_type, Future<arg_value_type> >::const_iterator
+            end = tiles.end();
+        for(const auto index : *TensorImpl_::pmap()) {
+          const size_type i = index / m_, j = index % m_;
+          if((i > j) || pair_is_zero(i, j))
+            continue;
+
+          ReducePairTask<op_type> reduce_task(world, op_);
+          for(size_type k = 0ul; k < k_; ++k) {
+            const auto left = tiles.find(arg_index(i, k));
+            const auto right = tiles.find(arg_index(j, k));
+            if((left != end) && (right != end))
+              reduce_task.add(left->second, right->second);
+          }
+          world.taskq.add(self, & SymmetricEvalImpl_::set_pair, i, j,
+              reduce_task.submit());
+
+          tile_count += (TensorImpl_::is_zero(index) ? 0 : 1);
+          if(i != j)
+            tile_count += (TensorImpl_::is_zero(j * m_ + i) ? 0 : 1);
+        }
+
+        // Wait for local tiles of argument to be evaluated
+        DistEvalImpl_::wait_arg(arg_);
+
+        return tile_count;
+      }
+
+    }; // class SymmetricEvalImpl
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_SYMMETRIC_EVAL_H__INCLUDED
@@ -0,0 +1,186 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_batch.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_DIST_EVAL_TILE_BATCH_H__INCLUDED
+#define TILEDARRAY_DIST_EVAL_TILE_BATCH_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Task batching policy of element-wise tile evaluations
+
+    /// Unary and binary evaluators spawn one task per tile. For small tiles
+    /// the cost of spawning a task and its futures is comparable to the
+    /// cost of the tile operation, so consecutive local tiles with a volume
+    /// smaller than \c max_elements() are evaluated by one task, until the
+    /// total volume of the batch reaches \c max_elements() . Each tile of a
+    /// batch is still set individually. The default is 16384 elements, or
+    /// the value of the \c TA_TILE_BATCH_ELEMENTS environment variable; zero
+    /// disables batching. So that batching does not reduce parallelism, the
+    /// number of tiles in a batch is limited to keep at least
+    /// \c tasks_per_thread() tasks per thread (4 by default), when there are
+    /// enough local tiles.
+    /// \note There is one policy per process, which is shared by all
+    /// evaluators.
+    class TileBatchPolicy {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type max_elements_; ///< The target volume of a batch
+      size_type tasks_per_thread_; ///< The least number of tasks per thread
+
+      TileBatchPolicy() :
+        max_elements_(getenv("TA_TILE_BATCH_ELEMENTS") ?
+            std::stoul(getenv("TA_TILE_BATCH_ELEMENTS")) : 16384ul),
+        tasks_per_thread_(4ul)
+      { }
+
+      TileBatchPolicy(const TileBatchPolicy&) = delete;
+      TileBatchPolicy& operator=(const TileBatchPolicy&) = delete;
+
+    public:
+
+      /// Policy accessor
+
+      /// \return A reference to the policy of this process
+      static TileBatchPolicy& instance() {
+        static TileBatchPolicy policy;
+        return policy;
+      }
+
+      /// \return The target volume of a batch, or zero if batching is
+      /// disabled
+      size_type max_elements() const { return max_elements_; }
+
+      /// Set the target volume of a batch
+
+      /// \param max_elements The new volume, or zero to disable batching
+      void max_elements(const size_type max_elements) { max_elements_ = max_elements; }
+
+      /// \return The least number of tasks per thread, or zero if the number
+      /// of tiles in a batch is not limited
+      size_type tasks_per_thread() const { return tasks_per_thread_; }
+
+      /// Set the least number of tasks per thread
+
+      /// \param tasks The new number of tasks, or zero to not limit the number
+      /// of tiles in a batch
+      void tasks_per_thread(const size_type tasks) { tasks_per_thread_ = tasks; }
+
+      /// Batch size limit
+
+      /// \param local_tiles The number of local tiles of an evaluator
+      /// \return The largest number of tiles in a batch
+      size_type max_tiles(const size_type local_tiles) const {
+        if(tasks_per_thread_ == 0ul)
+          return std::numeric_limits<size_type>::max();
+        return std::max<size_type>(local_tiles /
+            (tasks_per_thread_ * (madness::ThreadPool::size() + 1ul)), 1ul);
+      }
+
+    }; // class TileBatchPolicy
+
+    /// A batch of tile evaluations
+
+    /// The batch collects the target indices of consecutive tile evaluations
+    /// that are run by one task, with the limits of \c TileBatchPolicy .
+    class TileBatch {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type max_elements_; ///< The target volume of the batch
+      size_type max_tiles_; ///< The largest number of tiles in the batch
+      std::vector<size_type> indices_; ///< The target indices of the tiles
+      size_type elements_; ///< The total volume of the tiles
+      size_type bytes_; ///< The total memory of the result tiles
+
+    public:
+
+      /// Constructor
+
+      /// \param local_tiles The number of local tiles of the evaluator
+      explicit TileBatch(const size_type local_tiles) :
+        max_elements_(TileBatchPolicy::instance().max_elements()),
+        max_tiles_(TileBatchPolicy::instance().max_tiles(local_tiles)),
+        indices_(), elements_(0ul), bytes_(0ul)
+      { }
+
+      /// Batching test
+
+      /// \param volume The volume of a tile
+      /// \return \c true if the tile should be evaluated in a batch
+      bool batched(const size_type volume) const {
+        return (max_tiles_ > 1ul) && (volume < max_elements_);
+      }
+
+      /// Add a tile to the batch
+
+      /// \param index The target index of the tile
+      /// \param volume The volume of the tile
+      /// \param bytes The memory of the result tile
+      void add(const size_type index, const size_type volume,
+          const size_type bytes)
+      {
+        indices_.push_back(index);
+        elements_ += volume;
+        bytes_ += bytes;
+      }
+
+      /// \return \c true if the batch should be submitted
+      bool full() const {
+        return (elements_ >= max_elements_) || (indices_.size() >= max_tiles_);
+      }
+
+      /// \return \c true if there are no tiles in the batch
+      bool empty() const { return indices_.empty(); }
+
+      /// \return The target indices of the tiles
+      const std::vector<size_type>& indices() const { return indices_; }
+
+      /// \return The total memory of the result tiles
+      size_type bytes() const { return bytes_; }
+
+      /// Remove all tiles from the batch
+      void clear() {
+        indices_.clear();
+        elements_ = 0ul;
+        bytes_ = 0ul;
+      }
+
+    }; // class TileBatch
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_DIST_EVAL_TILE_BATCH_H__INCLUDED
@@ -21,6 +21,9 @@
 #define TILEDARRAY_DIST_EVAL_UNARY_EVAL_H__INCLUDED
 
 #include <TiledArray/dist_eval/dist_eval.h>
+#include <TiledArray/profiler.h>
+#include <TiledArray/memory_governor.h>
+#include <TiledArray/dist_eval/tile_batch.h>
 
 namespace TiledArray {
   namespace detail {
@@ -81,8 +84,7 @@ namespace TiledArray {
         TA_ASSERT(TensorImpl_::is_local(i));
         TA_ASSERT(! TensorImpl_::is_zero(i));
         const size_type source = arg_.owner(DistEvalImpl_::perm_index_to_source(i));
-        const madness::DistributedID key(DistEvalImpl_::id(), i);
-        return TensorImpl_::world().gop.template recv<value_type>(source, key);
+        return DistEvalImpl_::recv_tile(source, i);
       }
 
       /// Discard a tile that is not needed
@@ -103,12 +105,76 @@ namespace TiledArray {
           const typename arg_type::value_type&>::type
               tile_argument_type;
 
+      /// Evaluate and set a tile
+
+      /// \param i The tile index
+      /// \param tile The tile to be evaluated
+      void compute_tile(const size_type i, tile_argument_type tile) {
+        detail::ProfileScope profile("unary_tile", "tile", i);
+        if(profile.enabled())
+          profile.add_bytes(detail::tile_bytes(tile));
+        value_type result;
+        {
+          detail::TileCostScope cost(DistEvalImpl_::cost_recorder(), i);
+          result = op_(tile);
+        }
+        DistEvalImpl_::set_tile(i, result);
+      }
+
       /// Task function for evaluating tiles
 
       /// \param i The tile index
+      /// \param reserved The memory reserved for the task by
+      /// \c MemoryGovernor
       /// \param tile The tile to be evaluated
-      void eval_tile(const size_type i, tile_argument_type tile) {
-        DistEvalImpl_::set_tile(i, op_(tile));
+      void eval_tile(const size_type i, const std::size_t reserved,
+          tile_argument_type tile)
+      {
+        compute_tile(i, tile);
+        MemoryGovernor::instance().release(reserved);
+      }
+
+      /// Task function for evaluating a batch of tiles
+
+      /// \param indices The tile indices
+      /// \param reserved The memory reserved for the task by
+      /// \c MemoryGovernor
+      /// \param tiles The tiles to be evaluated
+      void eval_tiles(const std::vector<size_type>& indices,
+          const std::size_t reserved,
+          const std::vector<Future<typename arg_type::value_type> >& tiles)
+      {
+        for(std::size_t j = 0ul; j < indices.size(); ++j) {
+          Future<typename arg_type::value_type> tile = tiles[j];
+          compute_tile(indices[j], tile.get());
+        }
+        MemoryGovernor::instance().release(reserved);
+      }
+
+      /// Submit a batch evaluation task to the memory governor
+
+      /// The batch and its tiles are cleared.
+      /// \param self A shared pointer to this object
+      /// \param batch The batch of tile evaluations
+      /// \param tiles The argument tiles of \c batch
+      void spawn_batch(const std::shared_ptr<UnaryEvalImpl_>& self,
+          TileBatch& batch,
+          std::vector<Future<typename arg_type::value_type> >& tiles)
+      {
+        if(batch.empty())
+          return;
+
+        const std::vector<size_type> indices = batch.indices();
+        const std::vector<Future<typename arg_type::value_type> > batch_tiles =
+            std::move(tiles);
+        MemoryGovernor::instance().submit(batch.bytes(),
+            [self, indices, batch_tiles] (const std::size_t reserved) {
+              self->world().taskq.add(self, & UnaryEvalImpl_::eval_tiles,
+                  indices, reserved, batch_tiles);
+            });
+
+        batch.clear();
+        tiles.clear();
       }
 
       /// Evaluate the tiles of this tensor
@@ -116,7 +182,8 @@ namespace TiledArray {
       /// This function will evaluate the children of this distributed evaluator
       /// and evaluate the tiles for this distributed evaluator. It will block
       /// until the tasks for the children are evaluated (not for the tasks of
-      /// this object).
+      /// this object). Consecutive small tiles are evaluated in batches (see
+      /// \c TileBatchPolicy ).
       /// \return The number of tiles that will be set by this process
       virtual int internal_eval() {
         // Convert pimpl to this object type so it can be used in tasks
@@ -129,6 +196,10 @@ namespace TiledArray {
         // Counter for the number of tasks submitted by this object
         size_type task_count = 0ul;
 
+        // The current batch of small tiles
+        TileBatch batch(arg_.pmap()->local_size());
+        std::vector<Future<typename arg_type::value_type> > batch_tiles;
+
         // Make sure all local tiles are present.
         const typename pmap_interface::const_iterator end = arg_.pmap()->end();
         typename pmap_interface::const_iterator it = arg_.pmap()->begin();
@@ -139,17 +210,31 @@ namespace TiledArray {
           if(! arg_.is_zero(index)) {
             // Get target tile index
             const size_type target_index = DistEvalImpl_::perm_index_to_target(index);
+            const auto range = TensorImpl_::trange().make_tile_range(target_index);
+            const std::size_t bytes = tile_memory<value_type>(range);
 
             // Schedule tile evaluation task
-            TensorImpl_::world().taskq.add(self, & UnaryEvalImpl_::eval_tile,
-                target_index, arg_.get(index));
+            const auto tile = arg_.get(index);
+            if(batch.batched(range.volume())) {
+              batch.add(target_index, range.volume(), bytes);
+              batch_tiles.push_back(tile);
+              if(batch.full())
+                spawn_batch(self, batch, batch_tiles);
+            } else {
+              MemoryGovernor::instance().submit(bytes,
+                  [self, target_index, tile] (const std::size_t reserved) {
+                    self->world().taskq.add(self, & UnaryEvalImpl_::eval_tile,
+                        target_index, reserved, tile);
+                  });
+            }
 
             ++task_count;
           }
         }
+        spawn_batch(self, batch, batch_tiles);
 
         // Wait for local tiles of argument to be evaluated
-        arg_.wait();
+        DistEvalImpl_::wait_arg(arg_);
 
         return task_count;
       }
@@ -20,7 +20,20 @@
 #ifndef TILEDARRAY_DISTRIBUTED_STORAGE_H__INCLUDED
 #define TILEDARRAY_DISTRIBUTED_STORAGE_H__INCLUDED
 
+#include <TiledArray/comm_tracker.h>
+#include <TiledArray/hot_tiles.h>
 #include <TiledArray/pmap/pmap.h>
+#include <TiledArray/shm_exchange.h>
+#include <TiledArray/remote_cache.h>
+#include <TiledArray/rendezvous_exchange.h>
+#include <TiledArray/replicator.h>
+#include <TiledArray/rma_window.h>
+#include <TiledArray/tensor/wire_codec.h>
+#include <TiledArray/tile_compression.h>
+#include <TiledArray/tile_spill.h>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
@@ -40,8 +53,32 @@ namespace TiledArray {
     /// can easily be achieved by only constructing world objects in the main
     /// thread. DO NOT construct world objects within tasks where the order of
     /// execution is nondeterministic.
+    /// \note When the shared memory exchange is enabled (see \c ShmExchange ),
+    /// elements that are owned by another process on the same node are read
+    /// from shared memory.
+    /// \note When tile spilling is enabled (see \c TileSpill ) at construction,
+    /// local elements that are not recently used may be written to a spill file
+    /// and removed from the local container. They are read back in a task the
+    /// next time they are accessed.
+    /// \note When the remote tile cache is enabled (see \c RemoteTileCache )
+    /// at construction, remote elements are kept after they are received, so
+    /// later gets of the same element do not communicate.
+    /// \note When hot tile replication is enabled (see
+    /// \c HotTileReplication ) at construction, local elements that are read
+    /// by other processes many times are broadcast to all processes, and the
+    /// replicas are dropped when the element is erased.
+    /// \note Local elements that will not be used for a while can be
+    /// compressed in memory with \c compress() . A compressed element is
+    /// decompressed in a task the next time it is accessed.
+    /// \note When the local elements are exposed with \c expose() , remote
+    /// elements are read with one-sided MPI gets (see \c RmaWindow ), without
+    /// involving their owners.
     template <typename T>
-    class DistributedStorage : public madness::WorldObject<DistributedStorage<T> > {
+    class DistributedStorage :
+      public madness::WorldObject<DistributedStorage<T> >,
+      public TileSpill::Client,
+      public RemoteTileCache::Client
+    {
     public:
       typedef DistributedStorage<T> DistributedStorage_; ///< This object type
       typedef madness::WorldObject<DistributedStorage_> WorldObject_; ///< Base object type
@@ -60,18 +97,263 @@ namespace TiledArray {
       const size_type max_size_; ///< The maximum number of elements that can be stored by this container
       std::shared_ptr<pmap_interface> pmap_; ///< The process map that defines the element distribution
       mutable container_type data_; ///< The local data container
+      std::unique_ptr<SpillFile<value_type> > spill_file_; ///< The spill file of local elements
+      mutable CompressedTiles<value_type> compressed_; ///< The compressed local elements
+      std::shared_ptr<const ProcTopology> shm_topology_; ///< The topology used for shared memory gets
+      const bool rendezvous_; ///< Send large remote elements by rendezvous
+      const bool cache_remote_; ///< Cache remote elements
+
+      /// A cached remote element
+      struct CacheEntry {
+        future value; ///< The element
+        size_type version; ///< The cache version when the element was requested
+      }; // struct CacheEntry
+
+      mutable madness::Spinlock cache_lock_; ///< Lock for the cached elements
+      mutable std::unordered_map<size_type, CacheEntry> cache_; ///< The cached remote elements
+      const size_type hot_threshold_; ///< The number of remote reads of a hot element, or zero
+
+      /// The replication state of a local element
+      struct HotElement {
+        size_type reads = 0ul; ///< The number of remote reads
+        size_type generation = 0ul; ///< The number of replications and invalidations
+        bool replicated = false; ///< The element is replicated
+      }; // struct HotElement
+
+      /// A replica of a remote element
+      struct Replica {
+        future value; ///< The element
+        size_type generation = 0ul; ///< The generation of the replica
+        bool valid = false; ///< The replica holds the current element
+      }; // struct Replica
+
+      mutable madness::Spinlock hot_lock_; ///< Lock for the replication state
+      std::unordered_map<size_type, HotElement> hot_; ///< The replication state of local elements
+      std::unordered_map<size_type, Replica> replicas_; ///< The replicas of remote elements
+      std::unique_ptr<RmaWindow<value_type> > rma_; ///< The window of exposed elements
 
       // not allowed
       DistributedStorage(const DistributedStorage_&);
       DistributedStorage_& operator=(const DistributedStorage_&);
 
+      /// Mark a local element as used by the spill policy
+
+      /// \param i The index of the element
+      /// \param value The value of the element
+      /// \note The caller must not hold an accessor to \c data_ .
+      void touch(const size_type i, const value_type& value) const {
+        if(! spill_file_)
+          return;
+        const std::size_t bytes = tile_bytes(value);
+        if(bytes)
+          TileSpill::instance().touch(const_cast<DistributedStorage_*>(this), i, bytes);
+      }
+
+      /// Find a cached remote element
+
+      /// \param i The index of the element
+      /// \param[out] result The cached element
+      /// \return \c true if element \c i is cached
+      bool find_cached(const size_type i, future& result) const {
+        if(! cache_remote_)
+          return false;
+        const size_type version = RemoteTileCache::instance().version();
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&cache_lock_);
+          auto it = cache_.find(i);
+          if(it == cache_.end())
+            return false;
+          if(it->second.version != version) {
+            // The element was requested before the cache was invalidated
+            cache_.erase(it);
+            return false;
+          }
+          result = it->second.value;
+        }
+        RemoteTileCache::instance().touch(const_cast<DistributedStorage_*>(this), i);
+        return true;
+      }
+
+      /// Cache a remote element
+
+      /// The element is tracked by the cache policy when it arrives.
+      /// \param i The index of the element
+      /// \param f The future of the element
+      void cache(const size_type i, const future& f) const {
+        if(! cache_remote_)
+          return;
+        const size_type version = RemoteTileCache::instance().version();
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&cache_lock_);
+          cache_[i] = CacheEntry{ f, version };
+        }
+        if(f.probe())
+          cached(i, version, f.get());
+        else
+          const_cast<future&>(f).register_callback(new DelayedCache(*this, i, version, f));
+      }
+
+      /// Track a cached remote element that arrived
+
+      /// \param i The index of the element
+      /// \param version The cache version when the element was requested
+      /// \param value The value of the element
+      /// \note The caller must not hold \c cache_lock_ .
+      void cached(const size_type i, const size_type version,
+          const value_type& value) const
+      {
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&cache_lock_);
+          auto it = cache_.find(i);
+          if((it == cache_.end()) || (it->second.version != version))
+            return;
+          if(version != RemoteTileCache::instance().version()) {
+            cache_.erase(it);
+            return;
+          }
+        }
+        const std::size_t bytes = tile_bytes(value);
+        RemoteTileCache::instance().insert(const_cast<DistributedStorage_*>(this),
+            i, (bytes ? bytes : sizeof(value_type)));
+      }
+
+      /// Find a replica of a remote element
+
+      /// \param i The index of the element
+      /// \param[out] result The replica
+      /// \return \c true if this process holds a replica of element \c i
+      bool find_replica(const size_type i, future& result) const {
+        if(! hot_threshold_)
+          return false;
+        madness::ScopedMutex<madness::Spinlock> locker(&hot_lock_);
+        auto it = replicas_.find(i);
+        if((it == replicas_.end()) || ! it->second.valid)
+          return false;
+        result = it->second.value;
+        return true;
+      }
+
+      /// The children of this process in the broadcast tree of \c root
+      std::vector<ProcessID> broadcast_children(const ProcessID root) const {
+        return detail::broadcast_children(get_world().rank(), get_world().size(),
+            root, ReplicatorConfig::instance().algorithm());
+      }
+
+      /// Count a remote read of a local element
+
+      /// The element is replicated on all processes when it has been read
+      /// \c hot_threshold_ times.
+      /// \param i The index of the element
+      /// \param f The future of the element
+      void count_read(const size_type i, const future& f) {
+        if(! hot_threshold_)
+          return;
+        size_type generation = 0ul;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&hot_lock_);
+          HotElement& element = hot_[i];
+          if(element.replicated || (++element.reads < hot_threshold_))
+            return;
+          element.replicated = true;
+          generation = ++element.generation;
+        }
+        if(f.probe())
+          forward_replica(get_world().rank(), i, generation, f.get());
+        else
+          const_cast<future&>(f).register_callback(
+              new DelayedReplicate(*this, i, generation, f));
+      }
+
+      /// Send a replica to the children of this process in the broadcast tree
+
+      /// \param root The owner of the element
+      /// \param i The index of the element
+      /// \param generation The generation of the replica
+      /// \param value The value of the element
+      void forward_replica(const ProcessID root, const size_type i,
+          const size_type generation, const value_type& value)
+      {
+        const std::vector<ProcessID> procs = broadcast_children(root);
+        for(const ProcessID child : procs)
+          WorldObject_::task(child, & DistributedStorage_::replica_handler, root,
+              i, generation, value, madness::TaskAttributes::hipri());
+
+        if(! procs.empty() && CommTracker::instance().enabled())
+          CommTracker::instance().send(CommCategory::replicate,
+              procs.size() * tile_bytes(value), procs.size());
+      }
+
+      void replica_handler(const ProcessID root, const size_type i,
+          const size_type generation, const value_type& value)
+      {
+        if(CommTracker::instance().enabled())
+          CommTracker::instance().receive(CommCategory::replicate,
+              tile_bytes(value), CommTracker::now());
+        {
+          // Replicas and invalidations may arrive out of order, so only newer
+          // generations are kept.
+          madness::ScopedMutex<madness::Spinlock> locker(&hot_lock_);
+          Replica& replica = replicas_[i];
+          if(generation > replica.generation) {
+            replica.value = future(value);
+            replica.generation = generation;
+            replica.valid = true;
+          }
+        }
+        forward_replica(root, i, generation, value);
+      }
+
+      void invalidate_handler(const ProcessID root, const size_type i,
+          const size_type generation)
+      {
+        if(root != get_world().rank()) {
+          madness::ScopedMutex<madness::Spinlock> locker(&hot_lock_);
+          Replica& replica = replicas_[i];
+          if(generation > replica.generation) {
+            replica.value = future();
+            replica.generation = generation;
+            replica.valid = false;
+          }
+        }
+        for(const ProcessID child : broadcast_children(root))
+          WorldObject_::task(child, & DistributedStorage_::invalidate_handler,
+              root, i, generation, madness::TaskAttributes::hipri());
+      }
+
       future get_local(const size_type i) const {
         TA_ASSERT(pmap_->is_local(i));
 
         // Return the local element.
         const_accessor acc;
-        data_.insert(acc, i);
-        return acc->second;
+        const bool inserted = data_.insert(acc, i);
+        future result = acc->second;
+        acc.release();
+
+        if(inserted && compressed_.contains(i)) {
+          // Decompress the element
+          const DistributedStorage_* const self = this;
+          result.set(get_world().taskq.add([self, i] () -> value_type {
+            value_type value = self->compressed_.read(i);
+            self->touch(i, value);
+            return value;
+          }));
+        } else if(spill_file_) {
+          if(inserted) {
+            // Read the element if it was spilled
+            if(spill_file_->contains(i)) {
+              const DistributedStorage_* const self = this;
+              result.set(get_world().taskq.add([self, i] () -> value_type {
+                value_type value = self->spill_file_->read(i);
+                self->touch(i, value);
+                return value;
+              }));
+            }
+          } else if(result.probe()) {
+            touch(i, result.get());
+          }
+        }
+
+        return result;
       }
 
       void set_handler(const size_type i, const value_type& value) {
@@ -84,19 +366,149 @@ namespace TiledArray {
 #endif // NDEBUG
 
         f.set(value);
+        touch(i, value);
       }
 
       void get_handler(const size_type i, const typename future::remote_refT& ref) {
         future f = get_local(i);
+        count_read(i, f);
+        comm_send(CommCategory::remote_get, f);
         future remote_f(ref);
         remote_f.set(f);
       }
 
+      void get_wire_handler(const size_type i,
+          const typename Future<WireTile<value_type> >::remote_refT& ref)
+      {
+        future f = get_local(i);
+        count_read(i, f);
+        comm_send(CommCategory::remote_get, f);
+        Future<WireTile<value_type> > remote_f(ref);
+        remote_f.set(get_world().taskq.add(& wire_pack<value_type>, f,
+            madness::TaskAttributes::hipri()));
+      }
+
+      void get_rendezvous_handler(const size_type i, const ProcessID dest,
+          const typename Future<RendezvousHandle>::remote_refT& ref)
+      {
+        future f = get_local(i);
+        count_read(i, f);
+        comm_send(CommCategory::remote_get, f);
+        Future<RendezvousHandle> remote_f(ref);
+        remote_f.set(get_world().taskq.add(& rendezvous_send<value_type>,
+            & get_world(), f, dest, madness::TaskAttributes::hipri()));
+      }
+
+      void get_shm_handler(const size_type i,
+          const typename Future<ShmHandle>::remote_refT& ref)
+      {
+        future f = get_local(i);
+        count_read(i, f);
+        comm_send(CommCategory::remote_get, f);
+        Future<ShmHandle> remote_f(ref);
+        remote_f.set(get_world().taskq.add(& shm_write<value_type>, f, 1));
+      }
+
+      static std::vector<value_type>
+      get_batch_reply(const std::vector<future>& elements) {
+        std::vector<value_type> result;
+        result.reserve(elements.size());
+        std::size_t bytes = 0ul;
+        for(const auto& element : elements) {
+          result.push_back(element.get());
+          bytes += tile_bytes(result.back());
+        }
+        if(CommTracker::instance().enabled())
+          CommTracker::instance().send(CommCategory::remote_get, bytes);
+        return result;
+      }
+
+      void get_batch_handler(const std::vector<size_type>& indices,
+          const typename Future<std::vector<value_type> >::remote_refT& ref)
+      {
+        std::vector<future> elements;
+        elements.reserve(indices.size());
+        for(const auto i : indices) {
+          elements.push_back(get_local(i));
+          count_read(i, elements.back());
+        }
+        Future<std::vector<value_type> > remote_f(ref);
+        remote_f.set(get_world().taskq.add(& DistributedStorage_::get_batch_reply,
+            elements, madness::TaskAttributes::hipri()));
+      }
+
+      void set_remote_handler(const size_type i, const value_type& value) {
+        if(CommTracker::instance().enabled())
+          CommTracker::instance().receive(CommCategory::remote_set,
+              tile_bytes(value), CommTracker::now());
+        set_handler(i, value);
+      }
+
       void set_remote(const size_type i, const value_type& value) {
-        WorldObject_::task(owner(i), & DistributedStorage_::set_handler,
+        if(CommTracker::instance().enabled())
+          CommTracker::instance().send(CommCategory::remote_set, tile_bytes(value));
+        WorldObject_::task(owner(i), & DistributedStorage_::set_remote_handler,
             i, value, madness::TaskAttributes::hipri());
       }
 
+      void set_batch_handler(const std::vector<size_type>& indices,
+          const std::vector<value_type>& values)
+      {
+        TA_ASSERT(indices.size() == values.size());
+        if(CommTracker::instance().enabled()) {
+          std::size_t bytes = 0ul;
+          for(const auto& value : values)
+            bytes += tile_bytes(value);
+          CommTracker::instance().receive(CommCategory::remote_set, bytes,
+              CommTracker::now());
+        }
+        for(size_type j = 0ul; j < indices.size(); ++j)
+          set_handler(indices[j], values[j]);
+      }
+
+      /// A batch of elements that will be sent to one owner
+      struct SetBatch {
+        std::vector<size_type> indices; ///< The indices of the elements
+        std::vector<value_type> values; ///< The values of the elements
+        std::size_t bytes = 0ul; ///< The size of the element data in bytes
+      }; // struct SetBatch
+
+      void set_batch_remote(const ProcessID proc, SetBatch& batch) {
+        if(CommTracker::instance().enabled())
+          CommTracker::instance().send(CommCategory::remote_set, batch.bytes);
+        WorldObject_::task(proc, & DistributedStorage_::set_batch_handler,
+            batch.indices, batch.values, madness::TaskAttributes::hipri());
+        batch.indices.clear();
+        batch.values.clear();
+        batch.bytes = 0ul;
+      }
+
+      /// Task function that writes a block into an element in place
+      static void write_element(value_type element, const value_type& block) {
+        element.block(block.range().lobound(), block.range().upbound()) = block;
+      }
+
+      void write_local(const size_type i, const value_type& block) {
+        TA_ASSERT(! rma_);
+        get_world().taskq.add(& DistributedStorage_::write_element,
+            get_local(i), block);
+      }
+
+      void write_batch_handler(const std::vector<size_type>& indices,
+          const std::vector<value_type>& blocks)
+      {
+        TA_ASSERT(indices.size() == blocks.size());
+        if(CommTracker::instance().enabled()) {
+          std::size_t bytes = 0ul;
+          for(const auto& block : blocks)
+            bytes += tile_bytes(block);
+          CommTracker::instance().receive(CommCategory::remote_set, bytes,
+              CommTracker::now());
+        }
+        for(size_type j = 0ul; j < indices.size(); ++j)
+          write_local(indices[j], blocks[j]);
+      }
+
       struct DelayedSet : public madness::CallbackInterface {
       private:
         DistributedStorage_& ds_; ///< A reference to the owning object
@@ -117,6 +529,160 @@ namespace TiledArray {
         }
       }; // struct DelayedSet
 
+      struct DelayedBatch : public madness::CallbackInterface {
+      private:
+        Future<std::vector<value_type> > batch_; ///< The elements received from the owner
+        std::vector<future> elements_; ///< The futures that will be set with the batch
+        const CommTracker::time_point start_; ///< The time of the request
+
+      public:
+
+        DelayedBatch(const Future<std::vector<value_type> >& batch,
+            std::vector<future>&& elements) :
+            batch_(batch), elements_(std::move(elements)),
+            start_(CommTracker::now())
+        { }
+
+        virtual ~DelayedBatch() { }
+
+        virtual void notify() {
+          const std::vector<value_type>& values = batch_.get();
+          TA_ASSERT(values.size() == elements_.size());
+          std::size_t bytes = 0ul;
+          for(size_type j = 0ul; j < elements_.size(); ++j) {
+            elements_[j].set(values[j]);
+            bytes += tile_bytes(values[j]);
+          }
+          if(CommTracker::instance().enabled())
+            CommTracker::instance().receive(CommCategory::remote_get, bytes, start_);
+          delete this;
+        }
+      }; // struct DelayedBatch
+
+      struct DelayedTouch : public madness::CallbackInterface {
+      private:
+        DistributedStorage_& ds_; ///< A reference to the owning object
+        size_type index_; ///< The index of the element
+        future future_; ///< The future that we are waiting on.
+
+      public:
+
+        DelayedTouch(DistributedStorage_& ds, size_type i, const future& f) :
+            ds_(ds), index_(i), future_(f)
+        { }
+
+        virtual ~DelayedTouch() { }
+
+        virtual void notify() {
+          ds_.touch(index_, future_.get());
+          delete this;
+        }
+      }; // struct DelayedTouch
+
+      struct DelayedCache : public madness::CallbackInterface {
+      private:
+        const DistributedStorage_& ds_; ///< A reference to the owning object
+        size_type index_; ///< The index of the element
+        size_type version_; ///< The cache version when the element was requested
+        future future_; ///< The future that we are waiting on.
+
+      public:
+
+        DelayedCache(const DistributedStorage_& ds, size_type i,
+            size_type version, const future& f) :
+            ds_(ds), index_(i), version_(version), future_(f)
+        { }
+
+        virtual ~DelayedCache() { }
+
+        virtual void notify() {
+          ds_.cached(index_, version_, future_.get());
+          delete this;
+        }
+      }; // struct DelayedCache
+
+      struct DelayedReplicate : public madness::CallbackInterface {
+      private:
+        DistributedStorage_& ds_; ///< A reference to the owning object
+        size_type index_; ///< The index of the element
+        size_type generation_; ///< The generation of the replica
+        future future_; ///< The future that we are waiting on.
+
+      public:
+
+        DelayedReplicate(DistributedStorage_& ds, size_type i,
+            size_type generation, const future& f) :
+            ds_(ds), index_(i), generation_(generation), future_(f)
+        { }
+
+        virtual ~DelayedReplicate() { }
+
+        virtual void notify() {
+          ds_.forward_replica(ds_.get_world().rank(), index_, generation_,
+              future_.get());
+          delete this;
+        }
+      }; // struct DelayedReplicate
+
+      /// Request a remote element
+
+      /// \param i The index of the element
+      /// \return A future to element \c i
+      future get_remote(const size_type i) const {
+        if(rma_ && rma_->has(i)) {
+          // Read the element from the window of its owner.
+          const RmaWindow<value_type>* const window = rma_.get();
+          const ProcessID proc = owner(i);
+          future result = get_world().taskq.add([window, i, proc] () -> value_type {
+            return window->get(i, proc);
+          }, madness::TaskAttributes::hipri());
+          comm_receive(CommCategory::remote_get, result);
+          return result;
+        } else if(shm_topology_ && (shm_topology_->node(owner(i))
+            == shm_topology_->node(get_world().rank())))
+        {
+          // Send a request to the owner of i, which is on this node, for a
+          // shared memory handle of the element.
+          Future<ShmHandle> handle;
+          WorldObject_::task(owner(i), & DistributedStorage_::get_shm_handler, i,
+              handle.remote_ref(get_world()), madness::TaskAttributes::hipri());
+
+          future result = get_world().taskq.add(& shm_read<value_type>, handle);
+          comm_receive(CommCategory::remote_get, result);
+          return result;
+        } else if(rendezvous_) {
+          // Send a request to the owner of i for the range of the element;
+          // the elements are received directly into the new element.
+          Future<RendezvousHandle> handle;
+          WorldObject_::task(owner(i), & DistributedStorage_::get_rendezvous_handler,
+              i, get_world().rank(), handle.remote_ref(get_world()),
+              madness::TaskAttributes::hipri());
+
+          future result = get_world().taskq.add(& rendezvous_recv<value_type>,
+              & get_world(), handle, owner(i), madness::TaskAttributes::hipri());
+          comm_receive(CommCategory::remote_get, result);
+          return result;
+        } else if(is_wire_tile<value_type>::value && WireCodec::instance().enabled()) {
+          // Send a request to the owner of i for the encoded element.
+          Future<WireTile<value_type> > wire;
+          WorldObject_::task(owner(i), & DistributedStorage_::get_wire_handler, i,
+              wire.remote_ref(get_world()), madness::TaskAttributes::hipri());
+
+          future result = get_world().taskq.add(& wire_unpack<value_type>, wire,
+              madness::TaskAttributes::hipri());
+          comm_receive(CommCategory::remote_get, result);
+          return result;
+        } else {
+          // Send a request to the owner of i for the element.
+          future result;
+          WorldObject_::task(owner(i), & DistributedStorage_::get_handler, i,
+              result.remote_ref(get_world()), madness::TaskAttributes::hipri());
+          comm_receive(CommCategory::remote_get, result);
+
+          return result;
+        }
+      }
+
     public:
 
       /// Makes an initialized, empty container with default data distribution (no communication)
@@ -132,7 +698,17 @@ namespace TiledArray {
           const std::shared_ptr<pmap_interface>& pmap) :
         WorldObject_(world), max_size_(max_size),
         pmap_(pmap),
-        data_((max_size / world.size()) + 11)
+        data_((max_size / world.size()) + 11),
+        spill_file_(TileSpill::instance().enabled() ?
+            new SpillFile<value_type>(TileSpill::instance().directory()) : nullptr),
+        compressed_(),
+        shm_topology_(shm_topology(world)),
+        rendezvous_(RendezvousExchange::instance().enabled() &&
+            is_rendezvous_tile<value_type>::value),
+        cache_remote_(RemoteTileCache::instance().enabled()),
+        cache_lock_(), cache_(),
+        hot_threshold_(HotTileReplication::instance().threshold()),
+        hot_lock_(), hot_(), replicas_(), rma_()
       {
         // Check that the process map is appropriate for this storage object
         TA_ASSERT(pmap_);
@@ -142,7 +718,12 @@ namespace TiledArray {
         WorldObject_::process_pending();
       }
 
-      virtual ~DistributedStorage() { }
+      virtual ~DistributedStorage() {
+        if(spill_file_)
+          TileSpill::instance().remove(this);
+        if(cache_remote_)
+          RemoteTileCache::instance().remove(this);
+      }
 
       using WorldObject_::get_world;
 
@@ -180,6 +761,222 @@ namespace TiledArray {
       /// \throw nothing
       size_type size() const { return data_.size(); }
 
+      /// Spill a local element
+
+      /// The element is written to the spill file and removed from the local
+      /// container. Nothing is done if the element is not set.
+      /// \param i The index of the element
+      /// \note This function is called by the spill policy.
+      virtual void spill(const size_type i) {
+        TA_ASSERT(spill_file_);
+        accessor acc;
+        if(! data_.find(acc, i))
+          return;
+        if(! acc->second.probe())
+          return;
+        spill_file_->write(i, acc->second.get());
+        data_.erase(acc);
+      }
+
+      /// Remove a local element
+
+      /// Nothing is done if the element is not set. If the element is
+      /// replicated, the replicas held by other processes are dropped.
+      /// \param i The index of the element
+      /// \throw TiledArray::Exception If \c i is not local.
+      void erase(const size_type i) {
+        TA_ASSERT(is_local(i));
+        {
+          accessor acc;
+          if(data_.find(acc, i))
+            data_.erase(acc);
+        }
+        compressed_.erase(i);
+
+        if(hot_threshold_) {
+          // Drop the replicas of the element
+          size_type generation = 0ul;
+          {
+            madness::ScopedMutex<madness::Spinlock> locker(&hot_lock_);
+            auto it = hot_.find(i);
+            if(it != hot_.end()) {
+              if(it->second.replicated)
+                generation = ++it->second.generation;
+              it->second.replicated = false;
+              it->second.reads = 0ul;
+            }
+          }
+          if(generation)
+            invalidate_handler(get_world().rank(), i, generation);
+        }
+      }
+
+      /// Spilling status
+
+      /// \return \c true if local elements may be spilled
+      bool spilling() const { return bool(spill_file_); }
+
+      /// Compress the local elements
+
+      /// The local elements that are set are compressed in memory without
+      /// loss (see \c CompressedTiles ) and removed from the local container.
+      /// A compressed element is decompressed in a task the next time it is
+      /// accessed, e.g. by \c get() or by a remote process. The elements are
+      /// compressed by tasks, and this function returns when they are done.
+      /// Nothing is done if the local elements are exposed. This is a local
+      /// operation, without communication.
+      /// \return The number of compressed elements
+      /// \note The local elements should not be accessed while they are
+      /// compressed. The memory of an element is only released when all other
+      /// copies of the element, e.g. those held by tasks, have been destroyed.
+      size_type compress() {
+        if(rma_)
+          return 0ul;
+
+        std::vector<size_type> keys;
+        for(auto it = data_.begin(); it != data_.end(); ++it)
+          if(it->second.probe())
+            keys.push_back(it->first);
+
+        std::vector<Future<bool> > done;
+        done.reserve(keys.size());
+        DistributedStorage_* const self = this;
+        for(const size_type i : keys)
+          done.push_back(get_world().taskq.add([self, i] () -> bool {
+            {
+              accessor acc;
+              if(! self->data_.find(acc, i))
+                return false;
+              self->compressed_.write(i, acc->second.get());
+              self->data_.erase(acc);
+            }
+            if(self->spill_file_)
+              TileSpill::instance().remove(self, i);
+            return true;
+          }));
+
+        size_type count = 0ul;
+        for(auto& f : done)
+          count += (f.get() ? 1ul : 0ul);
+        return count;
+      }
+
+      /// Decompress the local elements
+
+      /// Every compressed element is decompressed by a task, and this function
+      /// returns when they are done. This is a local operation, without
+      /// communication.
+      void decompress() {
+        std::vector<future> values;
+        for(const size_type i : compressed_.keys())
+          values.push_back(get_local(i));
+        for(auto& value : values)
+          value.get();
+      }
+
+      /// \return The number of compressed local elements
+      size_type compressed_size() const { return compressed_.size(); }
+
+      /// \return The memory held by the compressed local elements, in bytes
+      size_type compressed_bytes() const { return compressed_.bytes(); }
+
+      /// Drop a cached remote element
+
+      /// \param i The index of the element
+      /// \note This function is called by the cache policy.
+      virtual void evict(const size_type i) {
+        madness::ScopedMutex<madness::Spinlock> locker(&cache_lock_);
+        cache_.erase(i);
+      }
+
+      /// Drop all cached remote elements
+
+      /// Call this when the owners of remote elements modified them, e.g.
+      /// after the tiles of an array were modified in place.
+      void invalidate_cache() {
+        if(! cache_remote_)
+          return;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&cache_lock_);
+          cache_.clear();
+        }
+        RemoteTileCache::instance().remove(this);
+      }
+
+      /// Replication status
+
+      /// \return \c true if local elements that are read often are replicated
+      bool replicating() const { return hot_threshold_ != 0ul; }
+
+      /// Replica query
+
+      /// \param i The index of the element
+      /// \return \c true if local element \c i is replicated, or this process
+      /// holds a replica of remote element \c i
+      bool is_replicated(const size_type i) const {
+        TA_ASSERT(i < max_size_);
+        madness::ScopedMutex<madness::Spinlock> locker(&hot_lock_);
+        if(is_local(i)) {
+          auto it = hot_.find(i);
+          return (it != hot_.end()) && it->second.replicated;
+        }
+        auto it = replicas_.find(i);
+        return (it != replicas_.end()) && it->second.valid;
+      }
+
+      /// Expose the local elements for one-sided gets
+
+      /// The local elements that are set are attached to an \c RmaWindow ,
+      /// and gets of them by other processes use \c MPI_Get , until
+      /// \c conceal() is called. Nothing is done when one-sided gets are not
+      /// supported (see \c RmaWindow::supported() ) or elements are spilled.
+      /// Compressed elements are decompressed first.
+      /// This is collective, and includes a fence.
+      /// \return \c true if the local elements are exposed
+      /// \note The exposed elements are read-only: they must not be modified
+      /// in place, or written with \c write() , until \c conceal() is
+      /// called. The elements that are erased, or set, after \c expose() are
+      /// not updated in the window.
+      bool expose() {
+        if(rma_)
+          return true;
+        if(spill_file_ || ! RmaWindow<value_type>::supported(get_world()))
+          return false;
+
+        get_world().gop.fence();
+        decompress();
+        std::vector<std::pair<size_type, value_type> > elements;
+        for(auto it = data_.begin(); it != data_.end(); ++it)
+          if(it->second.probe())
+            elements.emplace_back(it->first, it->second.get());
+        rma_.reset(new RmaWindow<value_type>(get_world()));
+        rma_->open(elements, max_size_);
+        return true;
+      }
+
+      /// Stop one-sided gets of the local elements
+
+      /// Gets use messages to the owners again. Nothing is done if the
+      /// elements are not exposed. This is collective, and includes a fence.
+      void conceal() {
+        if(! rma_)
+          return;
+        get_world().gop.fence();
+        rma_->close();
+        rma_.reset();
+      }
+
+      /// Exposure status
+
+      /// \return \c true if the local elements are exposed for one-sided
+      /// gets
+      bool is_exposed() const { return bool(rma_); }
+
+      /// Caching status
+
+      /// \return \c true if remote elements are cached
+      bool caching() const { return cache_remote_; }
+
       /// Max size accessor
 
       /// The maximum size is the total number of elements that can be held by
@@ -195,16 +992,69 @@ namespace TiledArray {
       /// \throw TiledArray::Exception If \c i is greater than or equal to \c max_size() .
       future get(size_type i) const {
         TA_ASSERT(i < max_size_);
-        if(is_local(i)) {
+        if(is_local(i))
           return get_local(i);
-        } else {
-          // Send a request to the owner of i for the element.
-          future result;
-          WorldObject_::task(owner(i), & DistributedStorage_::get_handler, i,
-              result.remote_ref(get_world()), madness::TaskAttributes::hipri());
 
+        future result;
+        if(find_replica(i, result) || find_cached(i, result))
           return result;
+        result = get_remote(i);
+        cache(i, result);
+        return result;
+      }
+
+      /// Get a batch of local or remote elements
+
+      /// This is equivalent to calling \c get() for each element, except that
+      /// the requests for elements owned by other nodes are aggregated, so
+      /// one message is sent to each owner and one reply is received from it,
+      /// instead of one of each per element. Elements that are sent through
+      /// shared memory, by rendezvous, or with one-sided gets are requested
+      /// one at a time.
+      /// \param indices The elements to get
+      /// \return The futures to the elements, where <tt>result[j]</tt> is the
+      /// future to element <tt>indices[j]</tt>
+      /// \throw TiledArray::Exception If an index is greater than or equal to
+      /// \c max_size() .
+      std::vector<future> get(const std::vector<size_type>& indices) const {
+        std::vector<future> result;
+        result.reserve(indices.size());
+
+        // The indices and the futures of the remote elements of each owner
+        std::map<ProcessID, std::pair<std::vector<size_type>,
+            std::vector<future> > > batches;
+
+        const ProcessID rank = get_world().rank();
+        for(const auto i : indices) {
+          TA_ASSERT(i < max_size_);
+          const ProcessID proc = owner(i);
+          if((proc == rank) || rendezvous_ || (rma_ && rma_->has(i)) ||
+              (shm_topology_ &&
+                (shm_topology_->node(proc) == shm_topology_->node(rank))))
+          {
+            result.push_back(get(i));
+          } else {
+            result.push_back(future());
+            if(find_replica(i, result.back()) || find_cached(i, result.back()))
+              continue;
+            auto& batch = batches[proc];
+            batch.first.push_back(i);
+            batch.second.push_back(result.back());
+            cache(i, result.back());
+          }
+        }
+
+        // Send one request to each owner
+        for(auto& batch : batches) {
+          Future<std::vector<value_type> > values;
+          WorldObject_::task(batch.first, & DistributedStorage_::get_batch_handler,
+              batch.second.first, values.remote_ref(get_world()),
+              madness::TaskAttributes::hipri());
+          values.register_callback(new DelayedBatch(values,
+              std::move(batch.second.second)));
         }
+
+        return result;
       }
 
       /// Set element \c i with \c value
@@ -221,6 +1071,106 @@ namespace TiledArray {
           set_remote(i, value);
       }
 
+      /// Maximum message size of the batched set
+
+      /// \return The size of the element data, in bytes, above which a batch
+      /// of elements is sent to its owner
+      static constexpr std::size_t max_batch_bytes() { return 1ul << 20; }
+
+      /// Set a batch of local or remote elements
+
+      /// This is equivalent to calling \c set() for each element, except that
+      /// the elements owned by other nodes are aggregated, so they are sent
+      /// to each owner in messages of about \c max_batch_bytes() bytes
+      /// instead of one message per element.
+      /// \param indices The elements to be set
+      /// \param values The values of the elements, where <tt>values[j]</tt>
+      /// is the value of element <tt>indices[j]</tt>
+      /// \throw TiledArray::Exception If an index is greater than or equal to
+      /// \c max_size() .
+      /// \throw madness::MadnessException If an element has already been set.
+      void set(const std::vector<size_type>& indices,
+          const std::vector<value_type>& values)
+      {
+        TA_ASSERT(indices.size() == values.size());
+
+        std::map<ProcessID, SetBatch> batches;
+        for(size_type j = 0ul; j < indices.size(); ++j) {
+          const size_type i = indices[j];
+          TA_ASSERT(i < max_size_);
+          if(is_local(i)) {
+            set_handler(i, values[j]);
+          } else {
+            const ProcessID proc = owner(i);
+            SetBatch& batch = batches[proc];
+            batch.indices.push_back(i);
+            batch.values.push_back(values[j]);
+            batch.bytes += tile_bytes(values[j]);
+            if(batch.bytes >= max_batch_bytes())
+              set_batch_remote(proc, batch);
+          }
+        }
+
+        // Send the remaining elements
+        for(auto& batch : batches)
+          if(! batch.second.indices.empty())
+            set_batch_remote(batch.first, batch.second);
+      }
+
+      /// Write blocks into elements in place
+
+      /// Block <tt>blocks[j]</tt> is copied into the sub-block of element
+      /// <tt>indices[j]</tt> with the same range, once the element is set.
+      /// The blocks of elements owned by other nodes are aggregated and sent
+      /// to each owner in messages of about \c max_batch_bytes() bytes. The
+      /// copies are done by tasks on the owners, so they are complete after
+      /// the next fence.
+      /// \param indices The elements to be written
+      /// \param blocks The blocks, whose ranges are sub-blocks of the ranges
+      /// of their elements
+      /// \throw TiledArray::Exception If an index is greater than or equal to
+      /// \c max_size() .
+      /// \note Remote copies of the elements, e.g. cached or replicated
+      /// elements, are not updated.
+      void write(const std::vector<size_type>& indices,
+          const std::vector<value_type>& blocks)
+      {
+        TA_ASSERT(! rma_);
+        TA_ASSERT(indices.size() == blocks.size());
+
+        auto send = [this] (const ProcessID proc, SetBatch& batch) {
+          if(CommTracker::instance().enabled())
+            CommTracker::instance().send(CommCategory::remote_set, batch.bytes);
+          WorldObject_::task(proc, & DistributedStorage_::write_batch_handler,
+              batch.indices, batch.values, madness::TaskAttributes::hipri());
+          batch.indices.clear();
+          batch.values.clear();
+          batch.bytes = 0ul;
+        };
+
+        std::map<ProcessID, SetBatch> batches;
+        for(size_type j = 0ul; j < indices.size(); ++j) {
+          const size_type i = indices[j];
+          TA_ASSERT(i < max_size_);
+          if(is_local(i)) {
+            write_local(i, blocks[j]);
+          } else {
+            const ProcessID proc = owner(i);
+            SetBatch& batch = batches[proc];
+            batch.indices.push_back(i);
+            batch.values.push_back(blocks[j]);
+            batch.bytes += tile_bytes(blocks[j]);
+            if(batch.bytes >= max_batch_bytes())
+              send(proc, batch);
+          }
+        }
+
+        // Send the remaining blocks
+        for(auto& batch : batches)
+          if(! batch.second.indices.empty())
+            send(batch.first, batch.second);
+      }
+
       /// Set element \c i with a \c Future \c f
 
       /// The owner of \c i may be local or remote. If \c i is remote, a task
@@ -247,6 +1197,14 @@ namespace TiledArray {
             // Set the future
             existing_f.set(f);
           }
+          acc.release();
+
+          if(spill_file_) {
+            if(f.probe())
+              touch(i, f.get());
+            else
+              const_cast<future&>(f).register_callback(new DelayedTouch(*this, i, f));
+          }
         } else {
           if(f.probe()) {
             set_remote(i, f);
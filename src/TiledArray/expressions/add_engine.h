@@ -179,6 +179,31 @@ namespace TiledArray {
 
     }; // class AddEngine
 
+    /// Fused kernel trait of a addition expression engine
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    template <typename Left, typename Right>
+    struct FusedKernel<AddEngine<Left, Right> > :
+      public FusedBinaryKernel<Left, Right, typename EngineTrait<AddEngine<Left, Right> >::value_type>
+    {
+      typedef AddEngine<Left, Right> engine_type;
+      typedef FusedBinaryKernel<Left, Right,
+          typename EngineTrait<engine_type>::value_type> FusedBinaryKernel_;
+      typedef TiledArray::detail::FusedAdd<typename FusedKernel<Left>::type,
+          typename FusedKernel<Right>::type> type;
+
+      template <typename Array>
+      static type make(const engine_type& engine, std::vector<Array>& args) {
+        // The argument order of the kernel is the order of the leaves
+        const typename FusedKernel<Left>::type left =
+            FusedKernel<Left>::make(engine.left(), args);
+        const typename FusedKernel<Right>::type right =
+            FusedKernel<Right>::make(engine.right(), args);
+        return type(left, right);
+      }
+    }; // struct FusedKernel
+
 
     /// Addition expression engine
 
@@ -261,7 +286,7 @@ namespace TiledArray {
       /// Scaling factor accessor
 
       /// \return The scaling factor
-      scalar_type factor() { return factor_; }
+      scalar_type factor() const { return factor_; }
 
       /// Expression identification tag
 
@@ -274,6 +299,34 @@ namespace TiledArray {
 
     }; // class ScalAddEngine
 
+    /// Fused kernel trait of a scaled addition expression engine
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam Scalar The scaling factor type
+    template <typename Left, typename Right, typename Scalar>
+    struct FusedKernel<ScalAddEngine<Left, Right, Scalar> > :
+      public FusedBinaryKernel<Left, Right, typename EngineTrait<ScalAddEngine<Left, Right, Scalar> >::value_type>
+    {
+      typedef ScalAddEngine<Left, Right, Scalar> engine_type;
+      typedef FusedBinaryKernel<Left, Right,
+          typename EngineTrait<engine_type>::value_type> FusedBinaryKernel_;
+      typedef TiledArray::detail::FusedScal<TiledArray::detail::FusedAdd<
+          typename FusedKernel<Left>::type, typename FusedKernel<Right>::type>,
+          typename EngineTrait<engine_type>::scalar_type> type;
+
+      template <typename Array>
+      static type make(const engine_type& engine, std::vector<Array>& args) {
+        // The argument order of the kernel is the order of the leaves
+        const typename FusedKernel<Left>::type left =
+            FusedKernel<Left>::make(engine.left(), args);
+        const typename FusedKernel<Right>::type right =
+            FusedKernel<Right>::make(engine.right(), args);
+        return type(TiledArray::detail::FusedAdd<typename FusedKernel<Left>::type,
+            typename FusedKernel<Right>::type>(left, right), engine.factor());
+      }
+    }; // struct FusedKernel
+
   }  // namespace expressions
 } // namespace TiledArray
 
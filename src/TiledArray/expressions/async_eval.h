@@ -0,0 +1,360 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  async_eval.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_ASYNC_EVAL_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_ASYNC_EVAL_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/region_timer.h>
+#include <TiledArray/dist_eval/dist_eval.h>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    // An asynchronous assignment returns as soon as the tasks that evaluate
+    // the result tiles have been submitted, instead of waiting for the local
+    // tiles of the result. The result array holds futures to its tiles, so an
+    // expression that uses the result of an earlier asynchronous assignment
+    // waits for the tiles it needs, and assignments that do not depend on
+    // each other are evaluated concurrently by the task queue. The arguments
+    // of an assignment are held by its evaluator, so an array may be assigned
+    // while a pending assignment still reads its previous value.
+
+    namespace detail {
+
+      /// Base class for pending expression evaluations
+      class PendingEval {
+      public:
+        virtual ~PendingEval() { }
+
+        /// Probe the evaluation
+
+        /// \return \c true if all local tiles have been evaluated
+        virtual bool probe() const = 0;
+
+        /// Wait for all local tiles to be evaluated
+        virtual void wait() const = 0;
+
+        /// Register a completion callback
+
+        /// \param callback The callback that is notified when all local
+        /// tiles have been evaluated
+        virtual void register_callback(madness::CallbackInterface* callback) const = 0;
+      }; // class PendingEval
+
+      /// A pending distributed evaluator
+
+      /// \tparam DistEval The distributed evaluator type
+      template <typename DistEval>
+      class PendingDistEval : public PendingEval {
+        DistEval dist_eval_; ///< The evaluator of the assignment
+
+      public:
+
+        /// Constructor
+
+        /// \param dist_eval The evaluator of the assignment
+        explicit PendingDistEval(const DistEval& dist_eval) :
+          dist_eval_(dist_eval)
+        { }
+
+        virtual ~PendingDistEval() { }
+
+        virtual bool probe() const { return dist_eval_.probe(); }
+
+        virtual void wait() const {
+          TiledArray::detail::RegionWait wait;
+          dist_eval_.wait();
+        }
+
+        virtual void register_callback(madness::CallbackInterface* callback) const {
+          dist_eval_.register_callback(callback);
+        }
+      }; // class PendingDistEval
+
+      /// Completion callback that calls a function object
+
+      /// The callback deletes itself after the function is called.
+      class FunctionCallback : public madness::CallbackInterface {
+        std::function<void()> fn_; ///< The function called on completion
+
+      public:
+
+        /// Constructor
+
+        /// \param fn The function called on completion
+        explicit FunctionCallback(const std::function<void()>& fn) : fn_(fn) { }
+
+        virtual void notify() {
+          fn_();
+          delete this;
+        }
+      }; // class FunctionCallback
+
+      /// The asynchronous evaluations of this process
+
+      /// Pending evaluations are held until they are waited on, so the
+      /// distributed evaluators are not destroyed while tasks still use them.
+      class AsyncEvalQueue {
+        madness::Mutex mutex_; ///< Queue lock
+        std::vector<std::shared_ptr<PendingEval> > pending_; ///< Pending evaluations
+        int depth_; ///< The number of active asynchronous scopes
+
+        AsyncEvalQueue() : mutex_(), pending_(), depth_(0) { }
+
+        AsyncEvalQueue(const AsyncEvalQueue&) = delete;
+        AsyncEvalQueue& operator=(const AsyncEvalQueue&) = delete;
+
+      public:
+
+        /// Queue accessor
+
+        /// \return A reference to the queue of this process
+        static AsyncEvalQueue& instance() {
+          static AsyncEvalQueue* const queue = new AsyncEvalQueue();
+          return *queue;
+        }
+
+        /// Asynchronous mode query
+
+        /// \return \c true if an asynchronous scope is active
+        bool enabled() const { return depth_ > 0; }
+
+        /// Enter an asynchronous scope
+        void enter() { ++depth_; }
+
+        /// Leave an asynchronous scope
+
+        /// \return \c true if no asynchronous scopes are active
+        bool leave() {
+          TA_ASSERT(depth_ > 0);
+          return --depth_ == 0;
+        }
+
+        /// Add a pending evaluation
+
+        /// Evaluations that have completed are removed from the queue.
+        /// \param eval The pending evaluation
+        void push(const std::shared_ptr<PendingEval>& eval) {
+          madness::ScopedMutex<madness::Mutex> locker(&mutex_);
+          pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+              [] (const std::shared_ptr<PendingEval>& p) { return p->probe(); }),
+              pending_.end());
+          pending_.push_back(eval);
+        }
+
+        /// The number of pending evaluations
+
+        /// \return The number of evaluations that have not been waited on
+        std::size_t size() {
+          madness::ScopedMutex<madness::Mutex> locker(&mutex_);
+          return pending_.size();
+        }
+
+        /// Wait for all pending evaluations
+        void wait() {
+          std::vector<std::shared_ptr<PendingEval> > pending;
+          {
+            madness::ScopedMutex<madness::Mutex> locker(&mutex_);
+            pending.swap(pending_);
+          }
+          for(const std::shared_ptr<PendingEval>& eval : pending)
+            eval->wait();
+        }
+
+      }; // class AsyncEvalQueue
+
+    } // namespace detail
+
+    /// The handle of an asynchronous assignment
+    class EvalHandle {
+      std::shared_ptr<detail::PendingEval> eval_; ///< The pending evaluation
+
+    public:
+
+      /// Construct the handle of a completed assignment
+      EvalHandle() : eval_() { }
+
+      /// Construct the handle of a pending assignment
+
+      /// \param eval The pending evaluation
+      explicit EvalHandle(const std::shared_ptr<detail::PendingEval>& eval) :
+        eval_(eval)
+      { }
+
+      /// Probe the assignment
+
+      /// \return \c true if the local tiles of the result have been evaluated
+      bool probe() const { return (! eval_) || eval_->probe(); }
+
+      /// Wait for the local tiles of the result to be evaluated
+
+      /// Tasks are processed while waiting.
+      void wait() const { if(eval_) eval_->wait(); }
+
+      /// Register a completion callback
+
+      /// \c callback->notify() is called once the local tiles of the result
+      /// have been evaluated. It is called by the task thread that completes
+      /// the assignment, or immediately when the assignment is already
+      /// complete, so it must not block; the application may continue with
+      /// other work instead of waiting for the assignment.
+      /// \param callback The completion callback
+      void register_callback(madness::CallbackInterface* callback) const {
+        if(eval_)
+          eval_->register_callback(callback);
+        else
+          callback->notify();
+      }
+
+      /// Call a function when the assignment is complete
+
+      /// \param fn The function called on completion (see
+      /// \c register_callback() )
+      void on_completion(const std::function<void()>& fn) const {
+        register_callback(new detail::FunctionCallback(fn));
+      }
+
+      /// Completion future
+
+      /// The future is set when the local tiles of the result have been
+      /// evaluated, so tasks that depend on the result of the assignment may
+      /// be submitted before it completes.
+      /// \return A future that is set to \c true on completion
+      Future<bool> completion() const {
+        Future<bool> result;
+        on_completion([result] () mutable { result.set(true); });
+        return result;
+      }
+
+    }; // class EvalHandle
+
+    /// Asynchronous assignment scope
+
+    /// Array assignments made while an \c AsyncEval object exists return
+    /// without waiting for their results. All pending assignments are waited
+    /// on when the outermost scope is destroyed, or when \c wait() is called.
+    /// A single fence of the world may then be used for all assignments of
+    /// the scope.
+    /// \code
+    /// {
+    ///   TA::expressions::AsyncEval async;
+    ///   a("i,j") = b("i,k") * c("k,j");
+    ///   d("i,j") = e("i,k") * f("k,j"); // Evaluated concurrently with a
+    ///   g("i,j") = a("i,j") + d("i,j"); // Waits for the tiles of a and d
+    /// }
+    /// world.gop.fence();
+    /// \endcode
+    class AsyncEval {
+
+      AsyncEval(const AsyncEval&) = delete;
+      AsyncEval& operator=(const AsyncEval&) = delete;
+
+    public:
+
+      /// Enter an asynchronous scope
+      AsyncEval() { detail::AsyncEvalQueue::instance().enter(); }
+
+      /// Leave the asynchronous scope
+
+      /// Pending assignments are waited on unless another scope is active or
+      /// an exception is being handled.
+      ~AsyncEval() noexcept(false) {
+        if(detail::AsyncEvalQueue::instance().leave() && ! std::uncaught_exception())
+          detail::AsyncEvalQueue::instance().wait();
+      }
+
+      /// Wait for all pending assignments
+      void wait() const { detail::AsyncEvalQueue::instance().wait(); }
+
+    }; // class AsyncEval
+
+    /// Asynchronous mode query
+
+    /// \return \c true if array assignments are asynchronous
+    inline bool async_eval() { return detail::AsyncEvalQueue::instance().enabled(); }
+
+    /// Wait for all pending asynchronous assignments of this process
+    inline void wait_async() { detail::AsyncEvalQueue::instance().wait(); }
+
+    /// Dataflow assignment scope
+
+    /// Array assignments made while a \c DataflowEval object exists are
+    /// asynchronous (see \c AsyncEval ), and, in addition, an assignment
+    /// does not wait for the tiles of its arguments before it returns. An
+    /// expression that uses the result of an earlier assignment starts as
+    /// soon as the first tiles of that result are ready; e.g. the SUMMA of a
+    /// contraction broadcasts the finished tiles of its arguments while the
+    /// other tiles are still being computed. The arguments are waited on with
+    /// the result.
+    /// \code
+    /// {
+    ///   TA::expressions::DataflowEval dataflow;
+    ///   a("i,j") = b("i,k") * c("k,j");
+    ///   d("i,j") = a("i,k") * e("k,j"); // Starts with the first tiles of a
+    ///   f("i,j") = d("i,k") * g("k,j"); // Starts with the first tiles of d
+    /// }
+    /// world.gop.fence();
+    /// \endcode
+    class DataflowEval {
+      AsyncEval async_; ///< The asynchronous scope of the assignments
+
+      DataflowEval(const DataflowEval&) = delete;
+      DataflowEval& operator=(const DataflowEval&) = delete;
+
+    public:
+
+      /// Enter a dataflow scope
+      DataflowEval() : async_() { ++TiledArray::detail::dataflow_depth(); }
+
+      /// Leave the dataflow scope
+
+      /// Pending assignments are waited on unless another asynchronous scope
+      /// is active.
+      ~DataflowEval() noexcept(false) {
+        TA_ASSERT(TiledArray::detail::dataflow_depth() > 0);
+        --TiledArray::detail::dataflow_depth();
+      }
+
+      /// Wait for all pending assignments
+      void wait() const { async_.wait(); }
+
+    }; // class DataflowEval
+
+    /// Dataflow mode query
+
+    /// \return \c true if array assignments do not wait for their arguments
+    inline bool dataflow_eval() { return TiledArray::detail::dataflow_eval(); }
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_ASYNC_EVAL_H__INCLUDED
@@ -28,6 +28,8 @@
 
 #include <TiledArray/expressions/expr_engine.h>
 #include <TiledArray/dist_eval/binary_eval.h>
+#include <TiledArray/expressions/fused_kernel.h>
+#include <TiledArray/expressions/eval_placement.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -169,15 +171,41 @@ namespace TiledArray {
         ExprEngine_::init_struct(target_vars);
       }
 
+      /// Restrict the arguments to the tiles of the result shape
+
+      /// An argument tile is used only by the result tile with the same
+      /// index, so the arguments are masked with the result shape.
+      void mask_args() {
+        if(shape_.is_dense())
+          return;
+        const shape_type mask = (perm_ ? shape_.perm(-perm_) : shape_);
+        left_.mask_shape(mask);
+        right_.mask_shape(mask);
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
-      /// tensor.
+      /// tensor. When the result is permuted, the arguments may be
+      /// distributed so that each tile is evaluated by the owner of the result
+      /// tile (see \c EvalPlacement ).
       /// \param world The world were the result will be distributed
       /// \param pmap The process map for the result tensor tiles
       void init_distribution(World* world,
           const std::shared_ptr<pmap_interface>& pmap)
       {
+        if(pmap && perm_ && detail::result_owner_placement(*world, *pmap, perm_,
+            trange_.tiles_range(), shape_, { detail::home_pmap(left_, 0),
+            detail::home_pmap(right_, 0) }))
+        {
+          left_.init_distribution(world, std::make_shared<
+              TiledArray::detail::PermutedPmap>(*world, pmap,
+              left_.trange().tiles_range(), perm_));
+          right_.init_distribution(world, left_.pmap());
+          ExprEngine_::init_distribution(world, pmap);
+          return;
+        }
+
         left_.init_distribution(world, pmap);
         right_.init_distribution(world, left_.pmap());
         ExprEngine_::init_distribution(world, left_.pmap());
@@ -196,10 +224,34 @@ namespace TiledArray {
         return perm * left_.trange();
       }
 
-      /// Construct the distributed evaluator for this expression
+      /// Left-hand argument accessor
+
+      /// \return The left-hand argument engine
+      const left_type& left() const { return left_; }
+
+      /// Right-hand argument accessor
+
+      /// \return The right-hand argument engine
+      const right_type& right() const { return right_; }
+
+    private:
+
+      /// Construct a fused distributed evaluator when possible
+
+      /// \return The fused distributed evaluator when this expression and its
+      /// children are element-wise operations over congruent tiles, otherwise
+      /// the binary distributed evaluator
+      dist_eval_type make_dist_eval(std::true_type) const {
+        if(expression_fusion() && FusedKernel<Derived>::fusable(
+            ExprEngine_::derived(), vars_))
+          return make_fused_dist_eval(ExprEngine_::derived());
+        return make_dist_eval(std::false_type());
+      }
+
+      /// Construct the binary distributed evaluator
 
       /// \return The distributed evaluator that will evaluate this expression
-      dist_eval_type make_dist_eval() const {
+      dist_eval_type make_dist_eval(std::false_type) const {
         typedef TiledArray::detail::BinaryEvalImpl<typename left_type::dist_eval_type,
             typename right_type::dist_eval_type, op_type, policy> impl_type;
 
@@ -215,6 +267,18 @@ namespace TiledArray {
         return dist_eval_type(pimpl);
       }
 
+    public:
+
+      /// Construct the distributed evaluator for this expression
+
+      /// Element-wise subexpressions over congruent tiles are evaluated with
+      /// one fused kernel per tile (see \c FusedKernel ).
+      /// \return The distributed evaluator that will evaluate this expression
+      dist_eval_type make_dist_eval() const {
+        return make_dist_eval(std::integral_constant<bool,
+            FusedKernel<Derived>::value>());
+      }
+
       /// Expression print
 
       /// \param os The output stream
@@ -226,6 +290,34 @@ namespace TiledArray {
         right_.print(os, vars_);
         os.dec();
       }
+
+      /// Estimate the cost of this expression
+
+      /// Each non-zero result tile is computed by one task from the
+      /// congruent tiles of the arguments, which are sent to the result owner
+      /// when they are held by another process.
+      /// \param est The estimate that the nodes of this expression are added to
+      /// \return The peak intermediate memory of this expression on any
+      /// process
+      double estimate(ExprEstimate& est) const {
+        const std::size_t index = ExprEngine_::estimate_node(est);
+        est.inc();
+        const std::size_t left_index = est.nodes().size();
+        const double left_peak = left_.estimate(est);
+        const std::size_t right_index = est.nodes().size();
+        const double right_peak = right_.estimate(est);
+        est.dec();
+        const double left_memory = est.node(left_index).memory;
+        const double right_memory = est.node(right_index).memory;
+
+        ExprEstimate::Node& node = est.node(index);
+        node.flops = ExprEngine_::estimate_result(node);
+        node.tasks = node.tiles;
+        node.comm_bytes = ExprEngine_::estimate_arg_comm(left_) +
+            ExprEngine_::estimate_arg_comm(right_);
+        return std::max(std::max(left_peak, left_memory + right_peak),
+            left_memory + right_memory + node.memory);
+      }
     }; // class BinaryEngine
 
   }  // namespace expressions
@@ -48,9 +48,12 @@ namespace TiledArray {
       typedef DistArray<Tile, Policy> array_type; ///< The array type
 
       // Operational typedefs
+      // Note: Non-permuted tiles are views of the array tiles, which avoids
+      // a copy of each tile. This is OK because the result consumable flag
+      // is set to false, as for tensor expressions.
       typedef typename TiledArray::detail::scalar_type<DistArray<Tile, Policy> >::type scalar_type;
       typedef TiledArray::Shift<typename array_type::eval_type,
-          ! Alias> op_base_type; ///< The base tile operation
+          ! Alias, true> op_base_type; ///< The base tile operation
       typedef TiledArray::detail::UnaryWrapper<op_base_type> op_type; ///< The tile operation
       typedef TiledArray::detail::LazyArrayTile<typename array_type::value_type,
           op_type> value_type;  ///< Tile type
@@ -64,7 +67,7 @@ namespace TiledArray {
       typedef typename policy::shape_type shape_type; ///< Shape type
       typedef typename policy::pmap_interface pmap_interface; ///< Process map interface type
 
-      static constexpr bool consumable = true;
+      static constexpr bool consumable = ! Alias;
       static constexpr unsigned int leaves = 1;
     };
 
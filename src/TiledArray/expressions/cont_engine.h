@@ -28,8 +28,16 @@
 
 #include <TiledArray/expressions/binary_engine.h>
 #include <TiledArray/dist_eval/contraction_eval.h>
+#include <TiledArray/dist_eval/symmetric_eval.h>
+#include <TiledArray/dist_eval/gemv_eval.h>
 #include <TiledArray/tile_op/contract_reduce.h>
 #include <TiledArray/proc_grid.h>
+#include <TiledArray/pmap/weighted_pmap.h>
+#include <TiledArray/expressions/contraction_plan.h>
+#include <TiledArray/dense_shape.h>
+#include <TiledArray/sparse_shape.h>
+#include <TiledArray/bitset_shape.h>
+#include <limits>
 
 namespace TiledArray {
   namespace expressions {
@@ -37,6 +45,219 @@ namespace TiledArray {
     // Forward declarations
     template <typename, typename> class MultExpr;
     template <typename, typename, typename> class ScalMultExpr;
+    template <typename, bool> class TsrEngine;
+
+    /// Fold the complex conjugation of a contraction argument into \c op
+
+    /// This is a noop for arguments that are not conjugated.
+    template <typename Scalar, typename Engine>
+    inline void fold_conj(Scalar&, madness::cblas::CBLAS_TRANSPOSE&, Engine&) { }
+
+    /// Scaling factor of a complex conjugate operation
+
+    /// \return The factor that is applied to the conjugated elements
+    template <typename Scalar, typename S>
+    inline Scalar conj_factor(const TiledArray::detail::ComplexConjugate<S>& op) {
+      return op.factor();
+    }
+
+    template <typename Scalar>
+    inline Scalar conj_factor(const TiledArray::detail::ComplexConjugate<void>&) {
+      return Scalar(1);
+    }
+
+    template <typename Scalar>
+    inline Scalar
+    conj_factor(const TiledArray::detail::ComplexConjugate<TiledArray::detail::ComplexNegTag>&) {
+      return Scalar(-1);
+    }
+
+    /// Fold the complex conjugation of a conjugated leaf argument into \c op
+
+    /// A transposed argument is conjugated by the BLAS \c ConjTrans operation,
+    /// so the leaf tiles are passed to the contraction kernel without an
+    /// intermediate conjugated copy, and any scaling factor of the leaf is
+    /// folded into \c alpha . BLAS has no conjugate operation for arguments
+    /// that are not transposed, which are conjugated by the leaf as usual.
+    /// \param alpha The contraction scaling factor
+    /// \param op The BLAS operation of the argument
+    /// \param engine The conjugated leaf engine
+    template <typename Scalar, typename Array, typename S,
+        typename std::enable_if<std::is_arithmetic<Scalar>::value ||
+            TiledArray::detail::is_complex<Scalar>::value>::type* = nullptr>
+    inline void fold_conj(Scalar& alpha, madness::cblas::CBLAS_TRANSPOSE& op,
+        ScalTsrEngine<Array, TiledArray::detail::ComplexConjugate<S> >& engine)
+    {
+      if((op == madness::cblas::Trans) && engine.fold()) {
+        op = madness::cblas::ConjTrans;
+        alpha *= conj_factor<Scalar>(engine.factor());
+      }
+    }
+
+    /// Check that two contraction arguments are the same array
+
+    /// This is \c false for arguments that are not plain leaves.
+    template <typename Left, typename Right>
+    inline bool same_leaf(const Left&, const Right&) { return false; }
+
+    /// Check that two leaf arguments are the same array
+
+    /// \param left The left-hand leaf engine
+    /// \param right The right-hand leaf engine
+    /// \return \c true if \c left and \c right refer to the same array
+    template <typename Array, bool Alias>
+    inline bool same_leaf(const TsrEngine<Array, Alias>& left,
+        const TsrEngine<Array, Alias>& right)
+    {
+      return left.array().is_initialized() && right.array().is_initialized() &&
+          (left.array().id() == right.array().id());
+    }
+
+    /// Contract the argument shapes of a contraction
+
+    /// Shapes that provide a cooperative \c gemm , which divides the work
+    /// among the processes of \c world , use it when \c world is known.
+    /// \param world The world where the contraction is evaluated, or null
+    /// \param left The left-hand argument shape
+    /// \param right The right-hand argument shape
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction data
+    /// \return The result shape
+    template <typename Shape, typename Factor>
+    inline auto shape_gemm(World* world, const Shape& left, const Shape& right,
+        const Factor factor, const TiledArray::math::GemmHelper& gemm_helper, int)
+        -> decltype(left.gemm(*world, right, factor, gemm_helper))
+    {
+      return (world ? left.gemm(*world, right, factor, gemm_helper) :
+          left.gemm(right, factor, gemm_helper));
+    }
+
+    template <typename Shape, typename Factor>
+    inline auto shape_gemm(World*, const Shape& left, const Shape& right,
+        const Factor factor, const TiledArray::math::GemmHelper& gemm_helper, long)
+        -> decltype(left.gemm(right, factor, gemm_helper))
+    {
+      return left.gemm(right, factor, gemm_helper);
+    }
+
+    /// Screen the result shape of a contraction with an error budget
+
+    /// \param shape The result shape
+    /// \param error The absolute error budget
+    /// \return The screened shape (see \c SparseShape::screen )
+    template <typename Shape>
+    inline auto shape_screen(const Shape& shape, const double error, int)
+        -> decltype(shape.screen(error))
+    {
+      return shape.screen(error);
+    }
+
+    /// Shapes without screening are not changed
+    template <typename Shape>
+    inline Shape shape_screen(const Shape& shape, const double, long) {
+      return shape;
+    }
+
+    /// Argument masks of a contraction
+
+    /// A left-hand tile <tt>(i,k)</tt> is used only if row \c i of the result
+    /// has a non-zero tile, and a right-hand tile <tt>(k,j)</tt> only if
+    /// column \c j of the result has a non-zero tile.
+    /// \param result The result shape, in <tt>(left outer, right outer)</tt>
+    /// order
+    /// \param left_trange The tiled range of the left-hand argument, in
+    /// <tt>(left outer, inner)</tt> order
+    /// \param right_trange The tiled range of the right-hand argument, in
+    /// <tt>(inner, right outer)</tt> order
+    /// \param left_outer_rank The number of left outer dimensions
+    /// \return The masks of the left- and right-hand arguments
+    template <typename T>
+    inline std::pair<SparseShape<T>, SparseShape<T> >
+    contraction_arg_masks(const SparseShape<T>& result,
+        const TiledRange& left_trange, const TiledRange& right_trange,
+        const unsigned int left_outer_rank)
+    {
+      const Range& range = result.data().range();
+      std::size_t m = 1ul;
+      for(unsigned int d = 0u; d < left_outer_rank; ++d)
+        m *= range.extent_data()[d];
+      const std::size_t n = range.volume() / m;
+      const std::size_t k = left_trange.tiles_range().volume() / m;
+      TA_ASSERT(right_trange.tiles_range().volume() == k * n);
+
+      // Find the non-zero rows and columns of the result
+      std::vector<bool> rows(m, false), cols(n, false);
+      for(std::size_t i = 0ul, ij = 0ul; i < m; ++i)
+        for(std::size_t j = 0ul; j < n; ++j, ++ij)
+          if(! result.is_zero(ij))
+            rows[i] = cols[j] = true;
+
+      const T one = std::numeric_limits<T>::max();
+      Tensor<T> left_norms(left_trange.tiles_range(), T(0));
+      for(std::size_t i = 0ul; i < m; ++i)
+        if(rows[i])
+          std::fill_n(left_norms.data() + i * k, k, one);
+      Tensor<T> right_norms(right_trange.tiles_range(), T(0));
+      for(std::size_t l = 0ul, lj = 0ul; l < k; ++l)
+        for(std::size_t j = 0ul; j < n; ++j, ++lj)
+          if(cols[j])
+            right_norms[lj] = one;
+
+      return std::make_pair(SparseShape<T>(left_norms, left_trange),
+          SparseShape<T>(right_norms, right_trange));
+    }
+
+    /// Argument masks of a contraction with pattern shapes
+
+    /// \param result The result shape, in <tt>(left outer, right outer)</tt>
+    /// order
+    /// \param left_trange The tiled range of the left-hand argument, in
+    /// <tt>(left outer, inner)</tt> order
+    /// \param right_trange The tiled range of the right-hand argument, in
+    /// <tt>(inner, right outer)</tt> order
+    /// \param left_outer_rank The number of left outer dimensions
+    /// \return The masks of the left- and right-hand arguments
+    inline std::pair<BitsetShape, BitsetShape>
+    contraction_arg_masks(const BitsetShape& result,
+        const TiledRange& left_trange, const TiledRange& right_trange,
+        const unsigned int left_outer_rank)
+    {
+      const Range& range = result.range();
+      std::size_t m = 1ul;
+      for(unsigned int d = 0u; d < left_outer_rank; ++d)
+        m *= range.extent_data()[d];
+      const std::size_t n = range.volume() / m;
+      const std::size_t k = left_trange.tiles_range().volume() / m;
+      TA_ASSERT(right_trange.tiles_range().volume() == k * n);
+
+      // Find the non-zero rows and columns of the result
+      const BitsetShape::bitset_type& pattern = result.pattern();
+      std::vector<bool> rows(m, false), cols(n, false);
+      for(std::size_t ij = pattern.find_first(); ij < pattern.size();
+          ij = pattern.find_next(ij))
+        rows[ij / n] = cols[ij % n] = true;
+
+      BitsetShape::bitset_type left(m * k), right(k * n);
+      for(std::size_t i = 0ul; i < m; ++i)
+        if(rows[i])
+          for(std::size_t l = 0ul; l < k; ++l)
+            left.set(i * k + l);
+      for(std::size_t l = 0ul, lj = 0ul; l < k; ++l)
+        for(std::size_t j = 0ul; j < n; ++j, ++lj)
+          if(cols[j])
+            right.set(lj);
+
+      return std::make_pair(BitsetShape(left, left_trange),
+          BitsetShape(right, right_trange));
+    }
+
+    /// Dense arguments are not masked
+    inline std::pair<DenseShape, DenseShape>
+    contraction_arg_masks(const DenseShape&, const TiledRange&,
+        const TiledRange&, const unsigned int)
+    {
+      return std::make_pair(DenseShape(), DenseShape());
+    }
 
     /// Multiplication expression engine
 
@@ -59,7 +280,13 @@ namespace TiledArray {
       typedef TiledArray::ContractReduce<
           typename eval_trait<typename left_type::value_type>::type,
           typename eval_trait<typename right_type::value_type>::type,
-          scalar_type> op_type; ///< The tile operation type
+          scalar_type> contract_type; ///< The argument precision tile operation type
+      typedef typename std::conditional<
+          std::is_same<value_type, typename contract_type::result_type>::value,
+          contract_type, TiledArray::MixedContractReduce<value_type,
+            typename eval_trait<typename left_type::value_type>::type,
+            typename eval_trait<typename right_type::value_type>::type,
+            scalar_type> >::type op_type; ///< The tile operation type
       typedef typename EngineTrait<Derived>::policy policy; ///< The result policy type
       typedef typename EngineTrait<Derived>::dist_eval_type dist_eval_type; ///< The distributed evaluator type
 
@@ -104,6 +331,11 @@ namespace TiledArray {
       op_type op_; ///< Tile operation
       TiledArray::detail::ProcGrid proc_grid_; ///< Process grid for the contraction
       size_type K_; ///< Inner dimension size
+      DistArray<value_type, policy> seed_; ///< The array that the result is accumulated into
+      bool symmetric_; ///< The result is the product of an array with its
+                       ///< transpose, and is evaluated with \c SymmetricEvalImpl
+      bool gemv_; ///< One argument has no outer dimensions, and the result
+                  ///< is evaluated with \c GemvEvalImpl
 
 
       static unsigned int
@@ -127,7 +359,7 @@ namespace TiledArray {
       ContEngine(const MultExpr<L, R>& expr) :
         BinaryEngine_(expr), factor_(1), left_vars_(), right_vars_(),
         left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
-        proc_grid_(), K_(1u)
+        proc_grid_(), K_(1u), seed_(), symmetric_(false), gemv_(false)
       { }
 
       /// Constructor
@@ -140,7 +372,7 @@ namespace TiledArray {
       ContEngine(const ScalMultExpr<L, R, S>& expr) :
         BinaryEngine_(expr), factor_(expr.factor()), left_vars_(), right_vars_(),
         left_op_(permute_to_no_trans), right_op_(permute_to_no_trans), op_(),
-        proc_grid_(), K_(1u)
+        proc_grid_(), K_(1u), seed_(), symmetric_(false), gemv_(false)
       { }
 
       // Pull base class functions into this class.
@@ -355,30 +587,63 @@ namespace TiledArray {
         // Initialize the tile operation in this function because it is used to
         // evaluate the tiled range and shape.
 
-        const madness::cblas::CBLAS_TRANSPOSE left_op =
+        // Fold the scaling factors of scaled arguments into the GEMM alpha.
+        // The argument shapes are already scaled, so shapes use factor_ only.
+        scalar_type alpha = factor_;
+        fold_factor(alpha, left_);
+        fold_factor(alpha, right_);
+
+        // Conjugated, transposed leaf arguments use ConjTrans (i.e. zgemm
+        // conjugates them) instead of a separate conjugation pass.
+        madness::cblas::CBLAS_TRANSPOSE left_op =
             (left_op_ == trans ? madness::cblas::Trans : madness::cblas::NoTrans);
-        const madness::cblas::CBLAS_TRANSPOSE right_op =
+        madness::cblas::CBLAS_TRANSPOSE right_op =
             (right_op_ == trans ? madness::cblas::Trans : madness::cblas::NoTrans);
+        fold_conj(alpha, left_op, left_);
+        fold_conj(alpha, right_op, right_);
 
 
         if(target_vars != vars_) {
           // Initialize permuted structure
           perm_ = ExprEngine_::make_perm(target_vars);
-          op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
+          op_ = op_type(left_op, right_op, alpha, vars_.dim(), left_vars_.dim(),
               right_vars_.dim(), (permute_tiles_ ? perm_ : Permutation()));
           trange_ = ContEngine_::make_trange(perm_);
           shape_ = ContEngine_::make_shape(perm_);
         } else {
           // Initialize non-permuted structure
-          op_ = op_type(left_op, right_op, factor_, vars_.dim(), left_vars_.dim(),
+          op_ = op_type(left_op, right_op, alpha, vars_.dim(), left_vars_.dim(),
               right_vars_.dim());
           trange_ = ContEngine_::make_trange();
           shape_ = ContEngine_::make_shape();
         }
 
-        if(ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape){
-            shape_ = shape_.mask(*ExprEngine_::override_ptr_->shape);
-        } 
+        // The product of an array and its transpose, e.g.
+        // s("i,j") = c("i,k") * c("j,k"), is symmetric
+        symmetric_ = ! perm_ && (((left_op_ == no_trans) && (right_op_ == trans)) ||
+            ((left_op_ == trans) && (right_op_ == no_trans))) &&
+            same_leaf(left_, right_);
+
+        if(ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape)
+          ExprEngine_::mask_shape(*ExprEngine_::override_ptr_->shape);
+      }
+
+      /// Restrict the arguments to the tiles of the result shape
+
+      /// The argument tiles of the rows and columns of the result that have
+      /// no non-zero tiles are masked (see \c contraction_arg_masks() ), so
+      /// \c Summa neither evaluates nor broadcasts them.
+      void mask_args() {
+        // A masked result is not symmetric
+        symmetric_ = false;
+        if(shape_.is_dense())
+          return;
+        const auto masks = contraction_arg_masks(
+            (perm_ ? shape_.perm(-perm_) : shape_), left_.trange(),
+            right_.trange(), op_.gemm_helper().left_rank() -
+            op_.gemm_helper().num_contract_ranks());
+        left_.mask_shape(masks.first);
+        right_.mask_shape(masks.second);
       }
 
       /// Initialize result tensor distribution
@@ -404,32 +669,122 @@ namespace TiledArray {
             right_.trange().elements_range().extent_data();
 
         // Compute the fused sizes of the contraction
-        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul;
+        size_type M = 1ul, m = 1ul, N = 1ul, n = 1ul, k = 1ul;
         unsigned int i = 0u;
         for(; i < left_outer_rank; ++i) {
           M *= left_tiles_size[i];
           m *= left_element_size[i];
         }
-        for(; i < left_rank; ++i)
+        for(; i < left_rank; ++i) {
           K_ *= left_tiles_size[i];
+          k *= left_element_size[i];
+        }
         for(i = inner_rank; i < right_rank; ++i) {
           N *= right_tiles_size[i];
           n *= right_element_size[i];
         }
 
-        // Construct the process grid.
-        proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n);
+        // Get the number of process layers; it cannot exceed the number of
+        // processes or the number of tiles in the contracted dimension. When
+        // it is not set, contractions with few result tiles and a long
+        // contracted dimension are split over layers.
+        size_type layers = (ExprEngine_::override_ptr_ ?
+            ExprEngine_::override_ptr_->contraction_layers : 0u);
+        if(layers == 0u)
+          layers = TiledArray::detail::ProcGrid::default_layers(world->size(),
+              M, N, K_, m, n, k);
+        layers = std::min<size_type>(layers, world->size());
+        layers = std::max<size_type>(std::min(layers, K_), 1ul);
+
+        // Construct the process grid, or reuse the grid of the plan.
+        const std::shared_ptr<ContractionPlan> plan =
+            ContEngine_::contraction_plan();
+        if(plan || (layers > 1ul))
+          symmetric_ = false;
+
+        // Matrix-vector and tensor-vector products, where all outer indices
+        // of the result belong to one argument, are evaluated without
+        // redistributing the matrix, unless the process grid is fixed by a
+        // plan or by the number of layers.
+        gemv_ = ! perm_ && ! plan && (layers == 1ul) && ! symmetric_ &&
+            ((left_outer_rank == 0u) != (right_rank == inner_rank));
+        if(plan) {
+          if(! plan->find_grid(*world, M, N, K_, m, n, layers))
+            plan->insert_grid(*world, M, N, K_, m, n, layers,
+                TiledArray::detail::ProcGrid(*world, M, N, m, n, layers));
+          proc_grid_ = plan->proc_grid();
+        } else {
+          proc_grid_ = TiledArray::detail::ProcGrid(*world, M, N, m, n, layers);
+
+          // When the result is stored with a cyclic process map, use its
+          // process grid if that is cheaper than moving the result tiles
+          // after SUMMA.
+          const TiledArray::detail::CyclicPmap* const cyclic = (pmap && ! perm_ ?
+              dynamic_cast<const TiledArray::detail::CyclicPmap*>(pmap.get()) : nullptr);
+          if(cyclic && (cyclic->nrows() == M) && (cyclic->ncols() == N))
+            proc_grid_.match_layout(cyclic->nrows_proc(), cyclic->ncols_proc(),
+                m, n, k);
+        }
 
-        // Initialize children
-        left_.init_distribution(world, proc_grid_.make_row_phase_pmap(K_));
-        right_.init_distribution(world, proc_grid_.make_col_phase_pmap(K_));
+        // Initialize children. The argument of a symmetric product and the
+        // arguments of a matrix-vector product are read from their own
+        // distributions.
+        if(symmetric_ || gemv_) {
+          left_.init_distribution(world, std::shared_ptr<pmap_interface>());
+          right_.init_distribution(world, std::shared_ptr<pmap_interface>());
+        } else {
+          left_.init_distribution(world, (plan ? plan->left_pmap() :
+              proc_grid_.make_row_phase_pmap(K_)));
+          right_.init_distribution(world, (plan ? plan->right_pmap() :
+              proc_grid_.make_col_phase_pmap(K_)));
+        }
 
         // Initialize the process map in not already defined
-        if(! pmap)
+        if(! pmap && plan)
+          pmap = plan->find_result_pmap(shape_);
+        if(! pmap) {
           pmap = proc_grid_.make_pmap();
+          if(! shape_type::is_dense() && (world->size() > 1))
+            pmap = ContEngine_::balance_pmap(*world, pmap);
+          if(plan)
+            plan->insert_result_pmap(shape_, pmap);
+        }
         ExprEngine_::init_distribution(world, pmap);
       }
 
+      /// Contraction plan accessor
+
+      /// \return A pointer to the plan of this contraction, which is empty if
+      /// the plan was not set
+      std::shared_ptr<ContractionPlan> contraction_plan() const {
+        return (ExprEngine_::override_ptr_ ?
+            ExprEngine_::override_ptr_->contraction_plan :
+            std::shared_ptr<ContractionPlan>());
+      }
+
+      /// Balance the result process map of a sparse contraction
+
+      /// The weight of each result tile is its volume if it is non-zero and
+      /// zero otherwise. When the load imbalance of \c pmap exceeds
+      /// \c TILEDARRAY_WEIGHTED_PMAP_THRESHOLD , the result is distributed
+      /// with a \c WeightedPmap instead.
+      /// \param world The world were the result will be distributed
+      /// \param pmap The default process map of the result
+      /// \return The process map for the result tiles
+      std::shared_ptr<pmap_interface>
+      balance_pmap(World& world, const std::shared_ptr<pmap_interface>& pmap) const {
+        const size_type tiles = trange_.tiles_range().volume();
+        std::vector<double> weights(tiles, 0.0);
+        for(size_type i = 0ul; i < tiles; ++i)
+          if(! shape_.is_zero(i))
+            weights[i] = trange_.make_tile_range(i).volume();
+
+        if(TiledArray::detail::WeightedPmap::imbalance(*pmap, weights)
+            <= TILEDARRAY_WEIGHTED_PMAP_THRESHOLD)
+          return pmap;
+        return std::make_shared<TiledArray::detail::WeightedPmap>(world, weights);
+      }
+
       /// Tiled range factory function
 
       /// \param perm The permutation to be applied to the array
@@ -498,7 +853,8 @@ namespace TiledArray {
         shape_gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
             op_.gemm_helper().result_rank(), op_.gemm_helper().left_rank(),
             op_.gemm_helper().right_rank());
-        return left_.shape().gemm(right_.shape(), factor_, shape_gemm_helper);
+        return screen_shape(shape_gemm(world_, left_.shape(), right_.shape(),
+            factor_, shape_gemm_helper, 0));
       }
 
       /// Permuting shape factory function
@@ -510,21 +866,91 @@ namespace TiledArray {
         shape_gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
             op_.gemm_helper().result_rank(), op_.gemm_helper().left_rank(),
             op_.gemm_helper().right_rank());
-        return left_.shape().gemm(right_.shape(), factor_, shape_gemm_helper,
-                                  perm);
+        return screen_shape(shape_gemm(world_, left_.shape(), right_.shape(),
+            factor_, shape_gemm_helper, 0)).perm(perm);
+      }
+
+      /// Apply the error-controlled screening of the result shape
+
+      /// \param shape The result shape
+      /// \return \c shape , screened when an error budget is set
+      shape_type screen_shape(const shape_type& shape) const {
+        const double error = (ExprEngine_::override_ptr_ ?
+            ExprEngine_::override_ptr_->screening_error : 0.0);
+        return (error > 0.0 ? shape_screen(shape, error, 0) : shape);
+      }
+
+      /// Accumulate the result into an array
+
+      /// The contraction is added to the tiles of \c array in place, so no
+      /// temporary result tiles are allocated for the non-zero tiles of
+      /// \c array . The result shape is the sum of the contraction shape and
+      /// the shape of \c array . This must be called after \c init() ; it has
+      /// no effect when the result tiles are permuted, when the tiled range of
+      /// \c array does not match the result, or when the result shape is
+      /// overridden.
+      /// \param array The array that is accumulated into
+      /// \return \c true if the result will be accumulated into \c array
+      bool seed(const DistArray<value_type, policy>& array) {
+        if(perm_ || ! array.is_initialized() || ! (array.trange() == trange_))
+          return false;
+        if(ExprEngine_::override_ptr_ && ExprEngine_::override_ptr_->shape)
+          return false;
+
+        shape_ = shape_.add(array.shape());
+        seed_ = array;
+        return true;
       }
 
       dist_eval_type make_dist_eval() const {
         // Define the impl type
         typedef TiledArray::detail::Summa<typename left_type::dist_eval_type,
             typename right_type::dist_eval_type, op_type, typename Derived::policy> impl_type;
+        typedef TiledArray::detail::SymmetricEvalImpl<typename left_type::dist_eval_type,
+            op_type, typename Derived::policy> symmetric_impl_type;
+        typedef TiledArray::detail::GemvEvalImpl<typename left_type::dist_eval_type,
+            typename right_type::dist_eval_type, op_type,
+            typename Derived::policy> gemv_impl_type;
 
         typename left_type::dist_eval_type left = left_.make_dist_eval();
+
+        // Get the user defined SUMMA iteration limits
+        std::size_t max_depth = 0ul, max_memory = 0ul;
+        if(ExprEngine_::override_ptr_) {
+          max_depth = ExprEngine_::override_ptr_->summa_max_depth;
+          max_memory = ExprEngine_::override_ptr_->summa_max_memory;
+        }
+
+        // Evaluate only the upper triangle of a symmetric product
+        if(symmetric_ && ! seed_.is_initialized() && (max_depth == 0ul) &&
+            (max_memory == 0ul))
+        {
+          std::shared_ptr<symmetric_impl_type> pimpl(
+              new symmetric_impl_type(left, *world_, trange_, shape_, pmap_,
+              op_, left_op_ == madness::cblas::Trans));
+          return dist_eval_type(pimpl);
+        }
+
         typename right_type::dist_eval_type right = right_.make_dist_eval();
 
+        // Stream the matrix of a matrix-vector product. A seeded result is
+        // evaluated with SUMMA, which reads the arguments from any
+        // distribution.
+        if(gemv_ && ! seed_.is_initialized()) {
+          std::shared_ptr<gemv_impl_type> pimpl(
+              new gemv_impl_type(left, right, *world_, trange_, shape_, pmap_,
+              op_, K_, left_op_ == trans, right_op_ == trans,
+              op_.gemm_helper().right_rank() ==
+              op_.gemm_helper().num_contract_ranks()));
+          return dist_eval_type(pimpl);
+        }
+
         std::shared_ptr<impl_type> pimpl(
             new impl_type(left, right, *world_, trange_, shape_, pmap_, perm_,
-            op_, K_, proc_grid_));
+            op_, K_, proc_grid_, max_depth, max_memory,
+            ContEngine_::contraction_plan()));
+        if(seed_.is_initialized())
+          pimpl->seed(seed_);
 
         return dist_eval_type(pimpl);
       }
@@ -553,6 +979,88 @@ namespace TiledArray {
         os.dec();
       }
 
+      /// Estimate the cost of this expression
+
+      /// The flops and tile tasks are those of the products of the non-zero
+      /// argument tiles. SUMMA broadcasts each non-zero left-hand tile to the
+      /// other process columns and each non-zero right-hand tile to the other
+      /// process rows of its layer, and the partial results of the layers
+      /// are sent to the first layer.
+      /// \param est The estimate that the nodes of this expression are added to
+      /// \return The peak intermediate memory of this expression on any
+      /// process
+      double estimate(ExprEstimate& est) const {
+        const std::size_t index = ExprEngine_::estimate_node(est);
+        est.inc();
+        const std::size_t left_index = est.nodes().size();
+        const double left_peak = left_.estimate(est);
+        const std::size_t right_index = est.nodes().size();
+        const double right_peak = right_.estimate(est);
+        est.dec();
+        const double left_memory = est.node(left_index).memory;
+        const double right_memory = est.node(right_index).memory;
+
+        ExprEstimate::Node& node = est.node(index);
+        const double elements = ExprEngine_::estimate_result(node);
+
+        // Compute the fused tile sizes of the arguments
+        const unsigned int inner_rank = op_.gemm_helper().num_contract_ranks();
+        const unsigned int left_rank = op_.gemm_helper().left_rank();
+        const unsigned int right_rank = op_.gemm_helper().right_rank();
+        const unsigned int left_outer_rank = left_rank - inner_rank;
+        const unsigned int right_outer_rank = right_rank - inner_rank;
+        const bool left_trans = (left_op_ == trans);
+        const bool right_trans = (right_op_ == trans);
+        const std::vector<double> m = detail::fused_tile_volumes(left_.trange(),
+            (left_trans ? inner_rank : 0u), (left_trans ? left_rank : left_outer_rank));
+        const std::vector<double> k = detail::fused_tile_volumes(left_.trange(),
+            (left_trans ? 0u : left_outer_rank), (left_trans ? inner_rank : left_rank));
+        const std::vector<double> n = detail::fused_tile_volumes(right_.trange(),
+            (right_trans ? 0u : inner_rank), (right_trans ? right_outer_rank : right_rank));
+        const std::size_t M = m.size(), K = k.size(), N = n.size();
+
+        const double left_element_size = sizeof(typename TiledArray::detail::numeric_type<
+            typename EngineTrait<left_type>::eval_type>::type);
+        const double right_element_size = sizeof(typename TiledArray::detail::numeric_type<
+            typename EngineTrait<right_type>::eval_type>::type);
+        const double result_element_size = sizeof(typename TiledArray::detail::numeric_type<
+            typename EngineTrait<Derived>::eval_type>::type);
+        const double proc_rows = proc_grid_.proc_rows();
+        const double proc_cols = proc_grid_.proc_cols();
+
+        // Sum the non-zero right-hand tiles of each row of the inner dimension
+        std::vector<double> right_size(K, 0.0);
+        std::vector<std::size_t> right_count(K, 0ul);
+        for(std::size_t kk = 0ul; kk < K; ++kk) {
+          for(std::size_t j = 0ul; j < N; ++j) {
+            if(right_.shape().is_zero(right_trans ? j * K + kk : kk * N + j))
+              continue;
+            right_size[kk] += n[j];
+            ++right_count[kk];
+            node.comm_bytes += k[kk] * n[j] * right_element_size * (proc_rows - 1.0);
+          }
+        }
+
+        // Multiply by the non-zero left-hand tiles
+        for(std::size_t i = 0ul; i < M; ++i) {
+          for(std::size_t kk = 0ul; kk < K; ++kk) {
+            if(left_.shape().is_zero(left_trans ? kk * M + i : i * K + kk))
+              continue;
+            node.flops += 2.0 * m[i] * k[kk] * right_size[kk];
+            node.tasks += right_count[kk];
+            node.comm_bytes += m[i] * k[kk] * left_element_size * (proc_cols - 1.0);
+          }
+        }
+
+        // Reduce tasks and the reduction of the layers
+        node.tasks += node.tiles;
+        node.comm_bytes += elements * result_element_size *
+            double(std::max<size_type>(proc_grid_.layers(), 1ul) - 1ul);
+
+        return std::max(std::max(left_peak, left_memory + right_peak),
+            left_memory + right_memory + node.memory);
+      }
+
     }; // class ContEngine
 
   }  // namespace expressions
@@ -0,0 +1,674 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  cont_order.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_CONT_ORDER_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_CONT_ORDER_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// The maximum number of operands of a contraction chain that is reordered
+#ifndef TILEDARRAY_CONT_ORDER_MAX_OPERANDS
+#define TILEDARRAY_CONT_ORDER_MAX_OPERANDS 10u
+#endif // TILEDARRAY_CONT_ORDER_MAX_OPERANDS
+
+namespace TiledArray {
+  namespace expressions {
+    namespace detail {
+
+      /// A contraction of two nodes of a contraction chain
+
+      /// Nodes are identified by the set of chain operands they contain.
+      struct ContStep {
+        std::uint64_t left; ///< The operands of the left-hand node
+        std::uint64_t right; ///< The operands of the right-hand node
+      }; // struct ContStep
+
+    } // namespace detail
+
+    /// Contraction order optimization policy
+
+    /// When the optimization is enabled, the operands of a chain of three or
+    /// more contracted arrays, e.g. <tt>b("i,k") * c("k,l") * d("l,j")</tt>,
+    /// are contracted in the order with the smallest estimated cost instead
+    /// of the order given by the expression. The cost of each pairwise
+    /// contraction is its dense flop count scaled by the fraction of non-zero
+    /// tiles of both arguments, with the memory of the intermediate used to
+    /// break ties. A chain is only reordered when the estimated cost is lower
+    /// than that of the given order, so the evaluation of expressions that
+    /// are already well ordered is unchanged. The optimization is enabled by
+    /// default; it is disabled with \c disable() or by setting the
+    /// \c TA_DISABLE_CONT_ORDER environment variable.
+    ///
+    /// The optimal order of a chain is cached, keyed by the operand and
+    /// result variables, the index extents, and the densities of the operands
+    /// rounded to 5%, so a chain that is evaluated repeatedly, e.g. once per
+    /// iteration of a coupled cluster solver, is optimized once. The cache is
+    /// used by the main thread when an expression is evaluated.
+    class ContOrder {
+      bool enabled_; ///< Optimization flag
+      std::map<std::string, std::vector<detail::ContStep> > paths_; ///< Cached contraction orders
+
+      ContOrder() :
+        enabled_(getenv("TA_DISABLE_CONT_ORDER") == nullptr), paths_()
+      { }
+
+      ContOrder(const ContOrder&) = delete;
+      ContOrder& operator=(const ContOrder&) = delete;
+
+    public:
+
+      /// Optimization policy accessor
+
+      /// \return A reference to the optimization policy of this process
+      static ContOrder& instance() {
+        static ContOrder* const order = new ContOrder();
+        return *order;
+      }
+
+      /// Enable the contraction order optimization
+      void enable() { enabled_ = true; }
+
+      /// Disable the contraction order optimization
+      void disable() { enabled_ = false; }
+
+      /// Optimization status
+
+      /// \return \c true if the contraction order optimization is enabled
+      bool enabled() const { return enabled_; }
+
+      /// Cached contraction order accessor
+
+      /// \param key The key of the contraction chain
+      /// \return A pointer to the cached order of the chain, or \c nullptr if
+      /// the chain has not been optimized
+      const std::vector<detail::ContStep>* find_path(const std::string& key) const {
+        const auto it = paths_.find(key);
+        return (it != paths_.end() ? &(it->second) : nullptr);
+      }
+
+      /// Cache a contraction order
+
+      /// \param key The key of the contraction chain
+      /// \param path The optimal order of the chain
+      void insert_path(const std::string& key, const std::vector<detail::ContStep>& path) {
+        paths_[key] = path;
+      }
+
+      /// \return The number of cached contraction orders
+      std::size_t paths() const { return paths_.size(); }
+
+      /// Remove the cached contraction orders
+      void clear_paths() { paths_.clear(); }
+
+    }; // class ContOrder
+
+    namespace detail {
+
+      /// The cost of a contraction order
+      struct ContCost {
+        double flops; ///< The estimated number of floating point operations
+        double memory; ///< The estimated size of the intermediates
+        double density; ///< The estimated fraction of non-zero tiles of the result
+
+        /// Cost comparison
+
+        /// \param other The cost to compare with
+        /// \return \c true if this cost is less than \c other
+        bool operator<(const ContCost& other) const {
+          return (flops < other.flops) ||
+              ((flops == other.flops) && (memory < other.memory));
+        }
+      }; // struct ContCost
+
+      /// The operands of a contraction chain
+
+      /// \tparam A The array type of the chain
+      template <typename A>
+      class ContChain {
+      public:
+        typedef typename A::element_type element_type; ///< The array element type
+
+      private:
+        std::vector<const A*> arrays_; ///< The operand arrays
+        std::vector<std::vector<std::string> > vars_; ///< The operand variables
+        std::vector<ContStep> steps_; ///< The contraction order of the expression
+        element_type factor_; ///< The product of the scaling factors
+
+        std::vector<std::string> indices_; ///< The names of all indices
+        std::vector<double> extent_; ///< The number of elements of each index
+        std::vector<double> tiles_; ///< The number of tiles of each index
+        std::vector<std::uint64_t> leaf_indices_; ///< The indices of each operand
+        std::uint64_t target_; ///< The indices of the result
+
+        /// Add an array operand
+
+        /// \param array The operand array
+        /// \param vars The variable list of the operand
+        /// \return The operand set of the new node
+        std::uint64_t add(const A& array, const std::string& vars) {
+          if(arrays_.size() >= TILEDARRAY_CONT_ORDER_MAX_OPERANDS)
+            return 0ul;
+          arrays_.push_back(&array);
+          vars_.push_back(VariableList(vars).data());
+          return std::uint64_t(1) << (arrays_.size() - 1ul);
+        }
+
+        /// Operand collection
+
+        /// Expressions that are not array operands cannot be reordered.
+        /// \return Zero
+        template <typename D>
+        std::uint64_t collect(const Expr<D>&) { return 0ul; }
+
+        /// Collect an array operand
+
+        /// \tparam B The array type of the expression
+        /// \tparam Alias The tile alias flag
+        /// \param expr The array expression
+        /// \return The operand set of the new node, or zero when the array
+        /// type is not \c A
+        template <typename B, bool Alias>
+        std::uint64_t collect(const TsrExpr<B, Alias>& expr) {
+          return collect_array(expr.array(), expr.vars(),
+              std::is_same<typename std::remove_const<B>::type, A>());
+        }
+
+        /// Collect a scaled array operand
+
+        /// \tparam B The array type of the expression
+        /// \tparam Scalar The scaling factor type
+        /// \param expr The scaled array expression
+        /// \return The operand set of the new node, or zero when the array
+        /// type is not \c A
+        template <typename B, typename Scalar,
+            typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type* = nullptr>
+        std::uint64_t collect(const ScalTsrExpr<B, Scalar>& expr) {
+          factor_ *= expr.factor();
+          return collect_array(expr.array(), expr.vars(),
+              std::is_same<typename std::remove_const<B>::type, A>());
+        }
+
+        template <typename B>
+        std::uint64_t collect_array(const B& array, const std::string& vars, std::true_type) {
+          return add(array, vars);
+        }
+
+        template <typename B>
+        std::uint64_t collect_array(const B&, const std::string&, std::false_type) {
+          return 0ul;
+        }
+
+        /// Collect the operands of a product
+
+        /// \tparam Left The left-hand expression type
+        /// \tparam Right The right-hand expression type
+        /// \param expr The product expression
+        /// \return The operand set of the product, or zero when the product
+        /// cannot be reordered, e.g. when its evaluation parameters are set
+        template <typename Left, typename Right>
+        std::uint64_t collect(const MultExpr<Left, Right>& expr) {
+          if(expr.has_override())
+            return 0ul;
+          return collect_product(expr.left(), expr.right());
+        }
+
+        /// Collect the operands of a scaled product
+
+        /// \tparam Left The left-hand expression type
+        /// \tparam Right The right-hand expression type
+        /// \tparam Scalar The scaling factor type
+        /// \param expr The product expression
+        /// \return The operand set of the product, or zero when the product
+        /// cannot be reordered
+        template <typename Left, typename Right, typename Scalar>
+        std::uint64_t collect(const ScalMultExpr<Left, Right, Scalar>& expr) {
+          if(expr.has_override())
+            return 0ul;
+          factor_ *= expr.factor();
+          return collect_product(expr.left(), expr.right());
+        }
+
+        template <typename Left, typename Right>
+        std::uint64_t collect_product(const Left& left, const Right& right) {
+          const std::uint64_t l = collect(left);
+          if(l == 0ul) return 0ul;
+          const std::uint64_t r = collect(right);
+          if(r == 0ul) return 0ul;
+          steps_.push_back(ContStep{ l, r });
+          return l | r;
+        }
+
+        /// Index id accessor
+
+        /// \param index The index name
+        /// \return The id of \c index
+        std::size_t index_id(const std::string& index) {
+          std::size_t i = 0ul;
+          for(; i < indices_.size(); ++i)
+            if(indices_[i] == index)
+              return i;
+          indices_.push_back(index);
+          return i;
+        }
+
+        /// The variables of a node
+
+        /// \param node The operand set of the node
+        /// \return The indices of the node that are not summed within it
+        std::uint64_t node_indices(const std::uint64_t node) const {
+          std::uint64_t inside = 0ul, outside = target_;
+          for(std::size_t i = 0ul; i < arrays_.size(); ++i) {
+            if(node & (std::uint64_t(1) << i))
+              inside |= leaf_indices_[i];
+            else
+              outside |= leaf_indices_[i];
+          }
+          return inside & outside;
+        }
+
+        /// The product of the extents of a set of indices
+
+        /// \param indices The set of indices
+        /// \param extent The extent of each index
+        /// \return The product of the extents of \c indices
+        static double volume(const std::uint64_t indices, const std::vector<double>& extent) {
+          double result = 1.0;
+          for(std::size_t i = 0ul; i < extent.size(); ++i)
+            if(indices & (std::uint64_t(1) << i))
+              result *= extent[i];
+          return result;
+        }
+
+        /// The cost of a contraction
+
+        /// \param left The operand set of the left-hand node
+        /// \param right The operand set of the right-hand node
+        /// \param left_cost The cost of the left-hand node
+        /// \param right_cost The cost of the right-hand node
+        /// \return The cost of the contraction, including its arguments
+        ContCost step_cost(const std::uint64_t left, const std::uint64_t right,
+            const ContCost& left_cost, const ContCost& right_cost) const
+        {
+          const std::uint64_t result = node_indices(left | right);
+          const std::uint64_t all = node_indices(left) | node_indices(right);
+          const double density = left_cost.density * right_cost.density;
+
+          // The probability that a result tile is non-zero is estimated from
+          // the number of tile products that contribute to it.
+          const double products = volume(all & ~result, tiles_);
+          const double result_density = (density < 1.0 ?
+              1.0 - std::pow(1.0 - density, products) : 1.0);
+
+          ContCost cost;
+          cost.flops = left_cost.flops + right_cost.flops
+              + 2.0 * volume(all, extent_) * density;
+          cost.memory = left_cost.memory + right_cost.memory
+              + volume(result, extent_) * result_density;
+          cost.density = result_density;
+          return cost;
+        }
+
+        /// The cost of an operand
+
+        /// \param i The operand
+        /// \return The cost of an operand, which is zero except for its density
+        ContCost leaf_cost(const std::size_t i) const {
+          return ContCost{ 0.0, 0.0, 1.0 - double(arrays_[i]->shape().sparsity()) };
+        }
+
+        /// Initialize the index data of the chain
+
+        /// \param target The result variables
+        /// \return \c false if the chain is not a pure contraction
+        bool init_indices(const std::vector<std::string>& target) {
+          leaf_indices_.assign(arrays_.size(), 0ul);
+          std::vector<unsigned int> count;
+          for(std::size_t i = 0ul; i < arrays_.size(); ++i) {
+            for(std::size_t j = 0ul; j < vars_[i].size(); ++j) {
+              const std::size_t id = index_id(vars_[i][j]);
+              if(id >= 64ul) return false;
+              if(id == extent_.size()) {
+                const TiledRange1& trange1 = arrays_[i]->trange().data()[j];
+                extent_.push_back(trange1.extent());
+                tiles_.push_back(trange1.tile_extent());
+                count.push_back(0u);
+              }
+              if(leaf_indices_[i] & (std::uint64_t(1) << id))
+                return false;
+              leaf_indices_[i] |= std::uint64_t(1) << id;
+              ++count[id];
+            }
+          }
+
+          target_ = 0ul;
+          for(const std::string& index : target) {
+            const std::size_t id = index_id(index);
+            if((id >= extent_.size()) || (count[id] != 1u))
+              return false;
+            target_ |= std::uint64_t(1) << id;
+          }
+
+          // Every other index must be summed over exactly two operands.
+          for(std::size_t id = 0ul; id < count.size(); ++id)
+            if(! (target_ & (std::uint64_t(1) << id)) && (count[id] != 2u))
+              return false;
+
+          return true;
+        }
+
+        /// Find the contraction order with the lowest cost
+
+        /// \param[out] plan The optimal contraction order
+        /// \return The cost of \c plan
+        ContCost optimize(std::vector<ContStep>& plan) const {
+          const std::uint64_t size = std::uint64_t(1) << arrays_.size();
+          std::vector<ContCost> best(size, ContCost{
+              std::numeric_limits<double>::max(), 0.0, 1.0 });
+          std::vector<std::uint64_t> split(size, 0ul);
+          for(std::size_t i = 0ul; i < arrays_.size(); ++i)
+            best[std::uint64_t(1) << i] = leaf_cost(i);
+
+          for(std::uint64_t node = 1ul; node < size; ++node) {
+            if((node & (node - 1ul)) == 0ul)
+              continue;
+
+            // Visit each split of node once, with the lowest operand on the left
+            const std::uint64_t low = node & (~node + 1ul);
+            for(std::uint64_t left = (node - 1ul) & node; left != 0ul; left = (left - 1ul) & node) {
+              if(! (left & low))
+                continue;
+              const std::uint64_t right = node & ~left;
+              const ContCost cost = step_cost(left, right, best[left], best[right]);
+              if(cost < best[node]) {
+                best[node] = cost;
+                split[node] = left;
+              }
+            }
+          }
+
+          plan.clear();
+          make_plan(size - 1ul, split, plan);
+          return best[size - 1ul];
+        }
+
+        /// Construct the steps of a contraction order
+
+        /// \param node The node to be evaluated
+        /// \param split The left-hand operands of the optimal split of each node
+        /// \param plan The steps of the contraction order
+        static void make_plan(const std::uint64_t node,
+            const std::vector<std::uint64_t>& split, std::vector<ContStep>& plan)
+        {
+          if((node & (node - 1ul)) == 0ul)
+            return;
+          const std::uint64_t left = split[node];
+          make_plan(left, split, plan);
+          make_plan(node & ~left, split, plan);
+          plan.push_back(ContStep{ left, node & ~left });
+        }
+
+        /// The cost of a contraction order
+
+        /// \param plan The contraction order
+        /// \return The cost of \c plan
+        ContCost plan_cost(const std::vector<ContStep>& plan) const {
+          std::map<std::uint64_t, ContCost> cost;
+          for(std::size_t i = 0ul; i < arrays_.size(); ++i)
+            cost[std::uint64_t(1) << i] = leaf_cost(i);
+          for(const ContStep& step : plan)
+            cost[step.left | step.right] =
+                step_cost(step.left, step.right, cost[step.left], cost[step.right]);
+          return cost[(std::uint64_t(1) << arrays_.size()) - 1ul];
+        }
+
+        /// Variable string
+
+        /// \param vars The variables
+        /// \return A comma separated list of \c vars
+        static std::string make_vars(const std::vector<std::string>& vars) {
+          std::string result;
+          for(std::size_t i = 0ul; i < vars.size(); ++i)
+            result += (i ? "," : "") + vars[i];
+          return result;
+        }
+
+        /// The cache key of the chain
+
+        /// \param target The result variables
+        /// \return A key that identifies the operand and result variables,
+        /// the index extents, and the operand densities rounded to 5%
+        std::string path_key(const std::vector<std::string>& target) const {
+          std::string key = make_vars(target);
+          for(std::size_t i = 0ul; i < arrays_.size(); ++i)
+            key += ";" + make_vars(vars_[i]) + ":" +
+                std::to_string(int(leaf_cost(i).density * 20.0 + 0.5));
+          for(std::size_t i = 0ul; i < extent_.size(); ++i)
+            key += ";" + indices_[i] + "=" + std::to_string(std::size_t(extent_[i]))
+                + "/" + std::to_string(std::size_t(tiles_[i]));
+          return key;
+        }
+
+      public:
+
+        /// Collect the operands of a product
+
+        /// \tparam D The expression type
+        /// \param expr The product expression
+        template <typename D>
+        explicit ContChain(const Expr<D>& expr) :
+          arrays_(), vars_(), steps_(), factor_(1), indices_(), extent_(),
+          tiles_(), leaf_indices_(), target_(0ul)
+        {
+          if(collect(expr.derived()) == 0ul) {
+            arrays_.clear();
+            steps_.clear();
+          }
+        }
+
+        /// Evaluate the chain in the optimal order
+
+        /// \tparam Alias The tile alias flag of the result
+        /// \param tsr The result expression
+        /// \param async The asynchronous assignment flag
+        /// \param[out] handle The handle of the assignment
+        /// \return \c false if the chain was not evaluated, because it cannot
+        /// be reordered or the order of the expression is already optimal
+        template <bool Alias>
+        bool eval_to(TsrExpr<A, Alias>& tsr, const bool async, EvalHandle& handle) {
+          if(arrays_.size() < 3ul)
+            return false;
+
+          const std::vector<std::string> target = VariableList(tsr.vars()).data();
+          if(! init_indices(target))
+            return false;
+
+          std::vector<ContStep> plan;
+          const std::string key = path_key(target);
+          const std::vector<ContStep>* const path =
+              ContOrder::instance().find_path(key);
+          if(path) {
+            plan = *path;
+          } else {
+            optimize(plan);
+            ContOrder::instance().insert_path(key, plan);
+          }
+          if(! (plan_cost(plan).flops < 0.99 * plan_cost(steps_).flops))
+            return false;
+
+          // Evaluate the intermediates
+          std::map<std::uint64_t, std::pair<const A*, std::vector<std::string> > > nodes;
+          std::vector<std::shared_ptr<A> > temps;
+          for(std::size_t i = 0ul; i < arrays_.size(); ++i)
+            nodes[std::uint64_t(1) << i] = std::make_pair(arrays_[i], vars_[i]);
+
+          for(std::size_t s = 0ul; s < plan.size(); ++s) {
+            const ContStep& step = plan[s];
+            const auto& left = nodes[step.left];
+            const auto& right = nodes[step.right];
+            TsrExpr<const A, true> left_expr(*left.first, make_vars(left.second));
+            TsrExpr<const A, true> right_expr(*right.first, make_vars(right.second));
+
+            if(s + 1ul == plan.size()) {
+              // The last contraction is assigned to the result
+              if(factor_ == element_type(1))
+                handle = (left_expr * right_expr).eval_to(tsr, async);
+              else
+                handle = (factor_ * (left_expr * right_expr)).eval_to(tsr, async);
+            } else {
+              // The free indices of the intermediate, in the order of the arguments
+              const std::uint64_t result = node_indices(step.left | step.right);
+              std::vector<std::string> vars;
+              for(const std::vector<std::string>* arg : { &left.second, &right.second })
+                for(const std::string& index : *arg)
+                  if(result & (std::uint64_t(1) << index_id(index)))
+                    vars.push_back(index);
+
+              temps.push_back(std::make_shared<A>());
+              TsrExpr<A, true> temp((*temps.back()), make_vars(vars));
+              (left_expr * right_expr).eval_to(temp, async);
+              nodes[step.left | step.right] = std::make_pair(temps.back().get(), vars);
+            }
+          }
+
+          return true;
+        }
+
+      }; // class ContChain
+
+      /// Product expression trait
+
+      /// \tparam D The expression type
+      template <typename D>
+      struct is_mult_expr : public std::false_type { };
+
+      template <typename Left, typename Right>
+      struct is_mult_expr<MultExpr<Left, Right> > : public std::true_type { };
+
+      template <typename Left, typename Right, typename Scalar>
+      struct is_mult_expr<ScalMultExpr<Left, Right, Scalar> > : public std::true_type { };
+
+      template <typename D, typename A, bool Alias>
+      inline bool reorder_contraction(const Expr<D>&, TsrExpr<A, Alias>&,
+          const bool, EvalHandle&, std::false_type)
+      { return false; }
+
+      template <typename D, typename A, bool Alias>
+      inline bool reorder_contraction(const Expr<D>& expr,
+          TsrExpr<A, Alias>& tsr, const bool async, EvalHandle& handle,
+          std::true_type)
+      {
+        // The evaluation parameters of the expression, e.g. set_shape() or
+        // set_world(), apply to the product in the written order.
+        if(! ContOrder::instance().enabled() || expr.has_override())
+          return false;
+        ContChain<A> chain(expr);
+        return chain.eval_to(tsr, async, handle);
+      }
+
+      /// Evaluate a product in the optimal contraction order
+
+      /// \tparam D The expression type
+      /// \tparam A The result array type
+      /// \tparam Alias The tile alias flag of the result
+      /// \param expr The expression
+      /// \param tsr The result expression
+      /// \param async The asynchronous assignment flag
+      /// \param[out] handle The handle of the assignment
+      /// \return \c true if \c expr is a contraction chain that was evaluated
+      /// in a different order
+      template <typename D, typename A, bool Alias>
+      inline bool reorder_contraction(const Expr<D>& expr,
+          TsrExpr<A, Alias>& tsr, const bool async, EvalHandle& handle)
+      {
+        return reorder_contraction(expr, tsr, async, handle, is_mult_expr<D>());
+      }
+
+      /// The product of one operand
+
+      /// \tparam Arg The operand expression type
+      /// \param arg The operand
+      /// \return A copy of \c arg
+      template <typename Arg>
+      inline Arg einsum_product(const Arg& arg) { return arg; }
+
+      /// The left-to-right product of the operands
+
+      /// \tparam Left The first operand expression type
+      /// \tparam Right The second operand expression type
+      /// \tparam Args The other operand expression types
+      /// \param left The first operand
+      /// \param right The second operand
+      /// \param args The other operands
+      /// \return The product expression <tt>((left * right) * ...)</tt>
+      template <typename Left, typename Right, typename... Args>
+      inline auto einsum_product(const Left& left, const Right& right,
+          const Args&... args)
+      {
+        return einsum_product(left * right, args...);
+      }
+
+    } // namespace detail
+  } // namespace expressions
+
+  /// Contract a network of tensors
+
+  /// The operands are contracted into \c result in the order with the
+  /// lowest estimated cost, which is selected globally over all pairwise
+  /// contraction trees of the operands from the sizes of the indices and the
+  /// sparsity of the operand shapes (see \c expressions::ContOrder ). The
+  /// optimal order is cached, so it is selected once for a term that is
+  /// evaluated in every iteration. The result annotation is the target: an
+  /// index that is in the result must be in exactly one operand, and every
+  /// other index is summed and must be in exactly two operands. Otherwise,
+  /// or when the optimization is disabled, the operands are contracted from
+  /// left to right.
+  /// \code
+  /// einsum(r("a,b,i,j"), t("a,i"), t("b,j"), 0.5 * v("k,l,c,d"),
+  ///     t2("c,d,k,l"));
+  /// \endcode
+  /// \tparam A The result array type
+  /// \tparam Alias The tile alias flag of the result
+  /// \tparam Args The operand expression types, which are array or scaled
+  /// array expressions
+  /// \param result The result expression, which sets the target indices
+  /// \param args The operands
+  /// \return A reference to the result array
+  template <typename A, bool Alias, typename... Args>
+  inline A& einsum(expressions::TsrExpr<A, Alias>&& result, const Args&... args) {
+    static_assert(sizeof...(Args) > 0ul, "einsum() requires at least one operand");
+    return result = expressions::detail::einsum_product(args...);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_CONT_ORDER_H__INCLUDED
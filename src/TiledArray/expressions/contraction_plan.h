@@ -0,0 +1,444 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  contraction_plan.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_CONTRACTION_PLAN_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_CONTRACTION_PLAN_H__INCLUDED
+
+#include <TiledArray/proc_grid.h>
+#include <TiledArray/dist_eval/summa_groups.h>
+#include <TiledArray/dist_eval/summa_persistent.h>
+#include <TiledArray/permutation.h>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Contraction plan
+
+    /// A contraction plan holds the data that a contraction computes from the
+    /// structure of its arguments before any tiles are contracted: the SUMMA
+    /// process grid and argument process maps, the result process map, and
+    /// the sparse broadcast groups of each SUMMA iteration. When the same
+    /// contraction is evaluated repeatedly, e.g. once per iteration of an
+    /// iterative solver, a plan that is given to the expression is filled by
+    /// the first evaluation and reused by the following ones:
+    /// \code
+    /// auto plan = std::make_shared<TiledArray::ContractionPlan>();
+    /// for(...) {
+    ///   r("i,j") = (t("i,k") * v("k,j")).set_contraction_plan(plan);
+    ///   ...
+    /// }
+    /// \endcode
+    /// Each part of the plan is stored with the data it was computed from,
+    /// i.e. the contraction sizes and process layers, and the zero tiles of
+    /// the argument and result shapes, and it is recomputed when that data
+    /// changes. A plan therefore never changes the result of a contraction,
+    /// it only skips work when the structure is unchanged. With persistent
+    /// SUMMA broadcasts (see \c TiledArray::detail::SummaPersistentPolicy ),
+    /// the plan also holds the broadcast channels of the tiles.
+    /// \note A plan should be used by a single contraction; otherwise, the
+    /// contractions recompute each other's data. Plans are modified by the
+    /// main thread when an expression is evaluated.
+    /// \note A plan holds process groups of its world, so it must be
+    /// destroyed before the world is finalized.
+    class ContractionPlan {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      // Process grid key
+      World* world_; ///< The world of the process grid
+      size_type M_; ///< Number of result tile rows
+      size_type N_; ///< Number of result tile columns
+      size_type K_; ///< Number of tiles in the contracted dimension
+      size_type m_; ///< Number of result element rows
+      size_type n_; ///< Number of result element columns
+      size_type layers_; ///< Number of process layers
+
+      // Process grid data
+      TiledArray::detail::ProcGrid proc_grid_; ///< The SUMMA process grid
+      std::shared_ptr<Pmap> left_pmap_; ///< Left-hand argument process map
+      std::shared_ptr<Pmap> right_pmap_; ///< Right-hand argument process map
+
+      // Result process map
+      std::shared_ptr<Pmap> result_pmap_; ///< The default result process map
+      std::vector<bool> result_pmap_zero_; ///< Zero result tiles of result_pmap_
+
+      // SUMMA broadcast groups
+      bool has_groups_; ///< Broadcast group key flag
+      size_type groups_id_; ///< The version of the broadcast groups
+      Permutation groups_perm_; ///< Result permutation of the groups
+      std::vector<bool> left_zero_; ///< Zero left-hand tiles of the groups
+      std::vector<bool> right_zero_; ///< Zero right-hand tiles of the groups
+      std::vector<bool> result_zero_; ///< Zero result tiles of the groups
+      std::vector<std::vector<ProcessID> > row_groups_; ///< Row group processes of each iteration
+      std::vector<std::vector<ProcessID> > col_groups_; ///< Column group processes of each iteration
+      std::vector<char> has_row_group_; ///< Row group flags
+      std::vector<char> has_col_group_; ///< Column group flags
+      mutable madness::Spinlock lock_; ///< Lock for the broadcast groups
+      std::shared_ptr<TiledArray::detail::SummaGroupCache> group_cache_; ///< Shared broadcast groups
+      std::shared_ptr<TiledArray::detail::SummaChannels> channels_; ///< Persistent broadcast channels of the groups (may be null)
+
+      size_type hits_; ///< The number of evaluations that reused the plan
+      size_type misses_; ///< The number of evaluations that computed the plan
+
+      ContractionPlan(const ContractionPlan&) = delete;
+      ContractionPlan& operator=(const ContractionPlan&) = delete;
+
+      /// Collect the zero tiles of a shape
+
+      /// \tparam Shape The shape type
+      /// \param shape The shape
+      /// \param n The number of tiles in \c shape
+      /// \return The zero tile flags of \c shape , which are empty when
+      /// \c shape is dense
+      template <typename Shape>
+      static std::vector<bool> zero_tiles(const Shape& shape, const size_type n) {
+        std::vector<bool> result;
+        if(! shape.is_dense()) {
+          result.resize(n);
+          for(size_type i = 0ul; i < n; ++i)
+            result[i] = shape.is_zero(i);
+        }
+        return result;
+      }
+
+      /// Find the cached processes of a broadcast group
+
+      /// \param id The version of the broadcast groups
+      /// \param k The SUMMA iteration
+      /// \param flags The group flags
+      /// \param groups The group processes
+      /// \param[out] procs The processes of the group
+      /// \return \c true if the group of \c k is cached
+      bool find_group(const size_type id, const size_type k,
+          const std::vector<char>& flags,
+          const std::vector<std::vector<ProcessID> >& groups,
+          std::vector<ProcessID>& procs) const
+      {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        if((id != groups_id_) || (k >= flags.size()) || ! flags[k])
+          return false;
+        procs = groups[k];
+        return true;
+      }
+
+      /// Cache the processes of a broadcast group
+
+      /// \param id The version of the broadcast groups
+      /// \param k The SUMMA iteration
+      /// \param flags The group flags
+      /// \param groups The group processes
+      /// \param procs The processes of the group
+      void insert_group(const size_type id, const size_type k,
+          std::vector<char>& flags, std::vector<std::vector<ProcessID> >& groups,
+          const std::vector<ProcessID>& procs)
+      {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        if((id != groups_id_) || (k >= flags.size()))
+          return;
+        groups[k] = procs;
+        flags[k] = 1;
+      }
+
+    public:
+
+      /// Construct an empty plan
+      ContractionPlan() :
+        world_(nullptr), M_(0ul), N_(0ul), K_(0ul), m_(0ul), n_(0ul),
+        layers_(0ul), proc_grid_(), left_pmap_(), right_pmap_(),
+        result_pmap_(), result_pmap_zero_(), has_groups_(false),
+        groups_id_(0ul), groups_perm_(), left_zero_(), right_zero_(), result_zero_(),
+        row_groups_(), col_groups_(), has_row_group_(), has_col_group_(),
+        lock_(), group_cache_(std::make_shared<TiledArray::detail::SummaGroupCache>()),
+        channels_(), hits_(0ul), misses_(0ul)
+      { }
+
+      /// Remove all data from the plan
+      void clear() {
+        world_ = nullptr;
+        M_ = N_ = K_ = m_ = n_ = layers_ = 0ul;
+        proc_grid_ = TiledArray::detail::ProcGrid();
+        left_pmap_.reset();
+        right_pmap_.reset();
+        result_pmap_.reset();
+        result_pmap_zero_.clear();
+        clear_groups();
+        group_cache_ = std::make_shared<TiledArray::detail::SummaGroupCache>();
+      }
+
+      /// Hit count accessor
+
+      /// \return The number of evaluations that reused the process grid of
+      /// the plan
+      size_type hits() const { return hits_; }
+
+      /// Miss count accessor
+
+      /// \return The number of evaluations that computed the process grid of
+      /// the plan
+      size_type misses() const { return misses_; }
+
+      // The following functions are used by the contraction engine and the
+      // SUMMA evaluator.
+
+      /// Process grid lookup
+
+      /// \param world The world of the contraction
+      /// \param M The number of result tile rows
+      /// \param N The number of result tile columns
+      /// \param K The number of tiles in the contracted dimension
+      /// \param m The number of result element rows
+      /// \param n The number of result element columns
+      /// \param layers The number of process layers
+      /// \return \c true if the plan holds the process grid for these sizes
+      bool find_grid(World& world, const size_type M, const size_type N,
+          const size_type K, const size_type m, const size_type n,
+          const size_type layers)
+      {
+        const bool found = (world_ == &world) && (M_ == M) && (N_ == N) &&
+            (K_ == K) && (m_ == m) && (n_ == n) && (layers_ == layers);
+        if(found)
+          ++hits_;
+        else
+          ++misses_;
+        return found;
+      }
+
+      /// Store the process grid
+
+      /// All other data in the plan depends on the process grid, so it is
+      /// removed.
+      /// \param world The world of the contraction
+      /// \param M The number of result tile rows
+      /// \param N The number of result tile columns
+      /// \param K The number of tiles in the contracted dimension
+      /// \param m The number of result element rows
+      /// \param n The number of result element columns
+      /// \param layers The number of process layers
+      /// \param proc_grid The process grid for these sizes
+      void insert_grid(World& world, const size_type M, const size_type N,
+          const size_type K, const size_type m, const size_type n,
+          const size_type layers, const TiledArray::detail::ProcGrid& proc_grid)
+      {
+        clear();
+        world_ = &world;
+        M_ = M;
+        N_ = N;
+        K_ = K;
+        m_ = m;
+        n_ = n;
+        layers_ = layers;
+        proc_grid_ = proc_grid;
+        left_pmap_ = proc_grid_.make_row_phase_pmap(K);
+        right_pmap_ = proc_grid_.make_col_phase_pmap(K);
+      }
+
+      /// \return The process grid of the plan
+      const TiledArray::detail::ProcGrid& proc_grid() const { return proc_grid_; }
+
+      /// \return The process map of the left-hand argument
+      const std::shared_ptr<Pmap>& left_pmap() const { return left_pmap_; }
+
+      /// \return The process map of the right-hand argument
+      const std::shared_ptr<Pmap>& right_pmap() const { return right_pmap_; }
+
+      /// Result process map lookup
+
+      /// \tparam Shape The result shape type
+      /// \param shape The result shape
+      /// \return The result process map for \c shape , or an empty pointer
+      /// if the plan does not hold it
+      template <typename Shape>
+      std::shared_ptr<Pmap> find_result_pmap(const Shape& shape) const {
+        if(result_pmap_ && (result_pmap_zero_ ==
+            zero_tiles(shape, result_pmap_->size())))
+          return result_pmap_;
+        return std::shared_ptr<Pmap>();
+      }
+
+      /// Store the result process map
+
+      /// \tparam Shape The result shape type
+      /// \param shape The result shape
+      /// \param pmap The result process map for \c shape
+      template <typename Shape>
+      void insert_result_pmap(const Shape& shape, const std::shared_ptr<Pmap>& pmap) {
+        result_pmap_ = pmap;
+        result_pmap_zero_ = zero_tiles(shape, pmap->size());
+      }
+
+      /// Prepare the broadcast groups of a SUMMA evaluation
+
+      /// The cached groups are kept if they were computed for the same
+      /// argument and result shapes; otherwise they are removed. Groups are
+      /// only found and stored with the version returned by this function,
+      /// so an earlier evaluation that is still running does not use or
+      /// store groups of a different structure.
+      /// \tparam LeftShape The left-hand shape type
+      /// \tparam RightShape The right-hand shape type
+      /// \tparam ResultShape The result shape type
+      /// \param left The left-hand shape
+      /// \param left_size The number of left-hand tiles
+      /// \param right The right-hand shape
+      /// \param right_size The number of right-hand tiles
+      /// \param result The result shape
+      /// \param result_size The number of result tiles
+      /// \param perm The permutation that is applied to the result
+      /// \return The version of the broadcast groups
+      template <typename LeftShape, typename RightShape, typename ResultShape>
+      size_type init_groups(const LeftShape& left, const size_type left_size,
+          const RightShape& right, const size_type right_size,
+          const ResultShape& result, const size_type result_size,
+          const Permutation& perm)
+      {
+        std::vector<bool> left_zero = zero_tiles(left, left_size);
+        std::vector<bool> right_zero = zero_tiles(right, right_size);
+        std::vector<bool> result_zero = zero_tiles(result, result_size);
+
+        if(has_groups_ && (groups_perm_ == perm) && (left_zero_ == left_zero) &&
+            (right_zero_ == right_zero) && (result_zero_ == result_zero))
+          return groups_id_;
+
+        clear_groups();
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        has_groups_ = true;
+        groups_perm_ = perm;
+        left_zero_.swap(left_zero);
+        right_zero_.swap(right_zero);
+        result_zero_.swap(result_zero);
+        row_groups_.resize(K_);
+        col_groups_.resize(K_);
+        has_row_group_.resize(K_, 0);
+        has_col_group_.resize(K_, 0);
+        return groups_id_;
+      }
+
+      /// Remove the broadcast groups
+      void clear_groups() {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        ++groups_id_;
+        has_groups_ = false;
+        groups_perm_ = Permutation();
+        left_zero_.clear();
+        right_zero_.clear();
+        result_zero_.clear();
+        row_groups_.clear();
+        col_groups_.clear();
+        has_row_group_.clear();
+        has_col_group_.clear();
+        channels_.reset();
+      }
+
+      /// Shared broadcast group accessor
+
+      /// The \c madness::Group objects of the broadcast groups depend only on
+      /// their members and the process grid, so they are kept when the shapes
+      /// change.
+      /// \return The broadcast groups that are shared by the evaluations
+      const std::shared_ptr<TiledArray::detail::SummaGroupCache>& group_cache() const {
+        return group_cache_;
+      }
+
+      /// Persistent broadcast channels of the groups
+
+      /// The channels of the broadcast trees depend on the groups, so they
+      /// are constructed by the first evaluation of each version of the
+      /// groups (see \c TiledArray::detail::SummaPersistentPolicy ). This is
+      /// collective; it must be called by all processes when a contraction
+      /// is constructed.
+      /// \param world The world of the contraction
+      /// \param id The version of the broadcast groups
+      /// \param keys The number of broadcast keys of the contraction
+      /// \return The channels of the groups, or a null pointer if persistent
+      /// broadcasts are not used
+      std::shared_ptr<TiledArray::detail::SummaChannels>
+      channels(World& world, const size_type id, const size_type keys) {
+        if(! TiledArray::detail::SummaChannels::supported(world))
+          return std::shared_ptr<TiledArray::detail::SummaChannels>();
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        if((id == groups_id_) && ! channels_)
+          channels_ = TiledArray::detail::SummaChannels::make(world, keys);
+        return (id == groups_id_ ? channels_ :
+            std::shared_ptr<TiledArray::detail::SummaChannels>());
+      }
+
+      /// Row group lookup
+
+      /// \param id The version of the broadcast groups
+      /// \param k The SUMMA iteration
+      /// \param[out] procs The processes of the row group of \c k , which is
+      /// empty if this process is not in the group
+      /// \return \c true if the row group of \c k is cached
+      bool find_row_group(const size_type id, const size_type k,
+          std::vector<ProcessID>& procs) const
+      {
+        return find_group(id, k, has_row_group_, row_groups_, procs);
+      }
+
+      /// Column group lookup
+
+      /// \param id The version of the broadcast groups
+      /// \param k The SUMMA iteration
+      /// \param[out] procs The processes of the column group of \c k , which
+      /// is empty if this process is not in the group
+      /// \return \c true if the column group of \c k is cached
+      bool find_col_group(const size_type id, const size_type k,
+          std::vector<ProcessID>& procs) const
+      {
+        return find_group(id, k, has_col_group_, col_groups_, procs);
+      }
+
+      /// Store a row group
+
+      /// \param id The version of the broadcast groups
+      /// \param k The SUMMA iteration
+      /// \param procs The processes of the row group of \c k
+      void insert_row_group(const size_type id, const size_type k,
+          const std::vector<ProcessID>& procs)
+      {
+        insert_group(id, k, has_row_group_, row_groups_, procs);
+      }
+
+      /// Store a column group
+
+      /// \param id The version of the broadcast groups
+      /// \param k The SUMMA iteration
+      /// \param procs The processes of the column group of \c k
+      void insert_col_group(const size_type id, const size_type k,
+          const std::vector<ProcessID>& procs)
+      {
+        insert_group(id, k, has_col_group_, col_groups_, procs);
+      }
+
+    }; // class ContractionPlan
+
+  } // namespace expressions
+
+  using expressions::ContractionPlan;
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_CONTRACTION_PLAN_H__INCLUDED
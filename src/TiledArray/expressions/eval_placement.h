@@ -0,0 +1,156 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  eval_placement.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EVAL_PLACEMENT_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EVAL_PLACEMENT_H__INCLUDED
+
+#include <TiledArray/pmap/permuted_pmap.h>
+#include <TiledArray/madness.h>
+#include <initializer_list>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Placement of the tile evaluations of permuted element-wise expressions
+
+    /// The tiles of an element-wise expression with a permuted result are
+    /// evaluated either by the owners of the argument tiles, which send each
+    /// result tile to its owner, or by the owners of the result tiles, which
+    /// fetch the argument tiles.
+    enum class EvalPlacement {
+      argument_owner, ///< Evaluate tiles on the owners of the arguments
+      result_owner, ///< Evaluate tiles on the owners of the results
+      automatic ///< Select the placement that moves fewer tiles
+    }; // enum class EvalPlacement
+
+    namespace detail {
+
+      /// Evaluation placement accessor
+      inline EvalPlacement& placement_flag() {
+        static EvalPlacement placement = EvalPlacement::automatic;
+        return placement;
+      }
+
+      /// Process map of the tiles a leaf engine reads
+
+      /// \tparam Engine An expression engine type with an array
+      /// \param engine The expression engine
+      /// \return The process map of the array of \c engine when the engine
+      /// reads the array tiles with the same index, otherwise an empty pointer
+      template <typename Engine>
+      auto home_pmap(const Engine& engine, int) ->
+          decltype(engine.array().pmap(), std::shared_ptr<const Pmap>())
+      {
+        if((! engine.perm()) && (engine.array().trange() == engine.trange()))
+          return engine.array().pmap();
+        return std::shared_ptr<const Pmap>();
+      }
+
+      /// Process map of the tiles of an engine without an array
+
+      /// \return An empty pointer, since the tiles are evaluated where they
+      /// are placed
+      template <typename Engine>
+      std::shared_ptr<const Pmap> home_pmap(const Engine&, long) {
+        return std::shared_ptr<const Pmap>();
+      }
+
+      /// Select the owners of the result tiles for evaluation
+
+      /// The cost of each placement is the number of tiles sent between
+      /// processes for the non-zero result tiles: the arguments that are not
+      /// read on the evaluating process plus, when tiles are evaluated by the
+      /// argument owners, the results that are not owned by that process. The
+      /// tiles of arguments that are not array leaves are assumed to live on
+      /// the argument owner. This is a collective operation.
+      /// \tparam Shape The result shape type
+      /// \param world The world where the expression is evaluated
+      /// \param pmap The process map of the result tiles
+      /// \param perm The permutation from the argument to the result index
+      /// space
+      /// \param target_range The tiles range of the result
+      /// \param shape The result shape
+      /// \param homes The process maps of the tiles that the arguments read
+      /// (see \c home_pmap )
+      /// \return \c true if the result tiles should be evaluated by their owner
+      template <typename Shape>
+      bool result_owner_placement(World& world, const Pmap& pmap,
+          const Permutation& perm, const Range& target_range, const Shape& shape,
+          std::initializer_list<std::shared_ptr<const Pmap> > homes)
+      {
+        switch(placement_flag()) {
+          case EvalPlacement::argument_owner:
+            return false;
+          case EvalPlacement::result_owner:
+            return true;
+          default:
+            break;
+        }
+
+        const TiledArray::detail::PermIndex target_to_source(target_range, -perm);
+
+        // Count the tiles sent by each placement for the local result tiles
+        long cost[2] = { 0l, 0l }; // argument owner, result owner
+        for(const Pmap::size_type target : pmap) {
+          if(shape.is_zero(target))
+            continue;
+
+          const Pmap::size_type source = target_to_source(target);
+          const Pmap::size_type source_owner = pmap.owner(source);
+          if(source_owner != pmap.rank())
+            ++cost[0];
+          for(const auto& home : homes) {
+            const Pmap::size_type home_owner =
+                (home ? home->owner(source) : source_owner);
+            if(home_owner != source_owner)
+              ++cost[0];
+            if(home_owner != pmap.rank())
+              ++cost[1];
+          }
+        }
+        world.gop.sum(cost, 2);
+
+        return cost[1] < cost[0];
+      }
+
+    } // namespace detail
+
+    /// Set the placement of the tile evaluations of permuted element-wise expressions
+
+    /// The placement is selected automatically by default.
+    /// \param placement The new evaluation placement
+    inline void set_eval_placement(const EvalPlacement placement) {
+      detail::placement_flag() = placement;
+    }
+
+    /// Evaluation placement of permuted element-wise expressions
+
+    /// \return The evaluation placement
+    inline EvalPlacement eval_placement() { return detail::placement_flag(); }
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EVAL_PLACEMENT_H__INCLUDED
@@ -26,7 +26,10 @@
 #ifndef TILEDARRAY_EXPRESSIONS_EXPR_H__INCLUDED
 #define TILEDARRAY_EXPRESSIONS_EXPR_H__INCLUDED
 
+#include <TiledArray/expressions/async_eval.h>
 #include <TiledArray/expressions/expr_engine.h>
+#include <TiledArray/expressions/fused_kernel.h>
+#include <TiledArray/pmap/sub_block_pmap.h>
 #include <TiledArray/reduce_task.h>
 #include <TiledArray/tile_op/unary_reduction.h>
 #include <TiledArray/tile_op/binary_reduction.h>
@@ -42,11 +45,54 @@ namespace TiledArray {
     template <typename, bool> class TsrExpr;
     template <typename, bool> class BlkTsrExpr;
     template <typename> struct is_aliased;
+    class ContractionPlan;
+
+    namespace detail {
+      template <typename D, typename A, bool Alias>
+      bool reorder_contraction(const Expr<D>&, TsrExpr<A, Alias>&, const bool, EvalHandle&);
+      template <typename D, typename A, bool Alias>
+      bool schedule_sum(const Expr<D>&, TsrExpr<A, Alias>&, const bool, EvalHandle&);
+
+      /// The engine that evaluates an expression into an array
+
+      /// \tparam Engine The engine type of the expression
+      /// \tparam Tile The tile type of the result array
+      template <typename Engine, typename Tile>
+      struct result_engine {
+        typedef Engine type; ///< The evaluation engine type
+      };
+
+      /// Check that an engine can accumulate its result into an array in place
+
+      /// \tparam Engine The engine type of the expression
+      /// \tparam Tile The tile type of the result array
+      template <typename Engine, typename Tile>
+      struct can_accumulate : public std::false_type { };
+    } // namespace detail
 
     template <typename Engine>
     struct EngineParamOverride {
 
-      EngineParamOverride() : world(nullptr), pmap(), shape(nullptr) {}
+      EngineParamOverride() :
+        world(nullptr), pmap(), shape(nullptr), contraction_layers(0u),
+        summa_max_depth(0ul), summa_max_memory(0ul), contraction_plan(),
+        screening_error(0.0), cost_recorder()
+      { }
+
+      /// Copy the parameters of an engine with another result tile type
+
+      /// \tparam E The engine type of \c other
+      /// \param other The parameters to be copied
+      template <typename E>
+      explicit EngineParamOverride(const EngineParamOverride<E>& other) :
+        world(other.world), pmap(other.pmap), shape(convert_shape(other.shape)),
+        contraction_layers(other.contraction_layers),
+        summa_max_depth(other.summa_max_depth),
+        summa_max_memory(other.summa_max_memory),
+        contraction_plan(other.contraction_plan),
+        screening_error(other.screening_error),
+        cost_recorder(other.cost_recorder)
+      { }
 
       typedef typename EngineTrait<Engine>::policy policy; ///< The result policy type
       typedef typename EngineTrait<Engine>::shape_type shape_type; ///< Tensor shape type
@@ -55,6 +101,22 @@ namespace TiledArray {
        World* world;
        std::shared_ptr<pmap_interface> pmap;
        const shape_type* shape;
+       unsigned int contraction_layers; ///< Number of process layers used by contractions (0 = automatic)
+       std::size_t summa_max_depth; ///< Maximum number of concurrent SUMMA iterations (0 = automatic)
+       std::size_t summa_max_memory; ///< Maximum memory used by concurrent SUMMA iterations (0 = automatic)
+       std::shared_ptr<ContractionPlan> contraction_plan; ///< The plan reused by contractions (may be null)
+       double screening_error; ///< Error budget of the contraction shape screening (0 = no screening)
+       std::shared_ptr<TileCostRecorder> cost_recorder; ///< Recorder of the result tile costs (may be null)
+
+    private:
+
+      static const shape_type* convert_shape(const shape_type* shape) {
+        return shape;
+      }
+
+      /// The shape of an engine with another policy is not used
+      template <typename S>
+      static const shape_type* convert_shape(const S*) { return nullptr; }
     };
 
     /// \brief type trait checks if T has array() member
@@ -94,6 +156,16 @@ namespace TiledArray {
       std::shared_ptr<override_type> override_ptr_;
 
     public:
+      /// Restrict the result to the non-zero tiles of a shape
+
+      /// Only the tiles of the result that are non-zero in both \c shape and
+      /// the computed shape are evaluated. The mask is propagated to the
+      /// arguments, e.g. a contraction evaluates and broadcasts only the
+      /// argument tiles of the rows and columns of the result that have
+      /// requested tiles. Masks have no effect on dense arrays.
+      /// \code
+      /// c("i,j") = (a("i,k") * b("k,j")).set_shape(diagonal_blocks);
+      /// \endcode
       /// \param shape the shape to use for the result
      /// \internal \c shape is taken by const reference, but converted to a
      /// pointer; passing by const ref ensures lifetime management for temporary
@@ -129,6 +201,64 @@ namespace TiledArray {
         }
         return derived();
       }
+      /// \param layers The number of process layers used to evaluate a
+      /// contraction; more than one layer selects the 2.5D SUMMA algorithm,
+      /// and zero selects the number of layers automatically
+      Expr<Derived>& set_contraction_layers(const unsigned int layers) {
+        if (! override_ptr_)
+          override_ptr_ = std::make_shared<override_type>();
+        override_ptr_->contraction_layers = layers;
+        return derived();
+      }
+      /// \param depth The maximum number of concurrent SUMMA iterations used
+      /// to evaluate a contraction; zero selects the depth automatically
+      Expr<Derived>& set_summa_depth(const std::size_t depth) {
+        if (! override_ptr_)
+          override_ptr_ = std::make_shared<override_type>();
+        override_ptr_->summa_max_depth = depth;
+        return derived();
+      }
+      /// \param memory The maximum memory, in bytes, used by the argument tiles
+      /// of concurrent SUMMA iterations; zero uses the default limit
+      Expr<Derived>& set_summa_memory(const std::size_t memory) {
+        if (! override_ptr_)
+          override_ptr_ = std::make_shared<override_type>();
+        override_ptr_->summa_max_memory = memory;
+        return derived();
+      }
+      /// \param plan The plan of a contraction that is evaluated repeatedly;
+      /// it is filled by the first evaluation and reused by the following
+      /// evaluations with the same structure. See \c ContractionPlan .
+      Expr<Derived>& set_contraction_plan(const std::shared_ptr<ContractionPlan>& plan) {
+        if (! override_ptr_)
+          override_ptr_ = std::make_shared<override_type>();
+        override_ptr_->contraction_plan = plan;
+        return derived();
+      }
+      /// \param error The absolute error budget of a contraction; the result
+      /// tiles with the smallest norms are not computed while the estimated
+      /// norm of the omitted tiles is within \c error (see
+      /// \c SparseShape::screen ). Zero disables the screening.
+      Expr<Derived>& set_screening_error(const double error) {
+        TA_ASSERT(error >= 0.0);
+        if (! override_ptr_)
+          override_ptr_ = std::make_shared<override_type>();
+        override_ptr_->screening_error = error;
+        return derived();
+      }
+      /// \param recorder The recorder of the compute time of the result
+      /// tiles, which is used to balance the cost of the tiles of the next
+      /// evaluation (see \c TileCostRecorder ); it must have the number of
+      /// tiles of the result
+      Expr<Derived>& set_cost_recorder(const std::shared_ptr<TileCostRecorder>& recorder) {
+        if (! override_ptr_)
+          override_ptr_ = std::make_shared<override_type>();
+        override_ptr_->cost_recorder = recorder;
+        return derived();
+      }
+      /// \return \c true if an evaluation parameter of this expression was
+      /// set, e.g. with \c set_shape() or \c set_world()
+      bool has_override() const { return static_cast<bool>(override_ptr_); }
 
     private:
 
@@ -208,6 +338,98 @@ namespace TiledArray {
               & Expr_::template eval_tile<typename A::value_type, T, Op>, tile, op));
       }
 
+      /// Complete an assignment
+
+      /// When \c async is \c true , the result is assigned immediately and
+      /// the evaluator is added to the queue of pending evaluations. Otherwise,
+      /// this function waits for the local tiles of \c dist_eval before
+      /// assigning the result.
+      /// \tparam DistEval The distributed evaluator type
+      /// \tparam A The array type
+      /// \param dist_eval The evaluator of the assignment
+      /// \param result The result array
+      /// \param array The assigned array
+      /// \param async The asynchronous assignment flag
+      /// \return The handle of the assignment
+      template <typename DistEval, typename A>
+      static EvalHandle finish_eval(const DistEval& dist_eval, A& result,
+          A& array, const bool async)
+      {
+        if(async) {
+          result.swap(array);
+          std::shared_ptr<detail::PendingEval> pending =
+              std::make_shared<detail::PendingDistEval<DistEval> >(dist_eval);
+          detail::AsyncEvalQueue::instance().push(pending);
+          return EvalHandle(pending);
+        }
+
+        // Wait for child expressions of dist_eval
+        {
+          TiledArray::detail::RegionWait wait;
+          dist_eval.wait();
+        }
+
+        // Swap the new array with the result array object.
+        result.swap(array);
+
+        return EvalHandle();
+      }
+
+      /// Record the tile costs of an evaluation
+
+      /// \tparam DistEval The distributed evaluator type
+      /// \param dist_eval The distributed evaluator of the result, which
+      /// records the costs if a cost recorder was set
+      template <typename DistEval>
+      void record_cost(DistEval& dist_eval) const {
+        if(override_ptr_ && override_ptr_->cost_recorder)
+          dist_eval.set_cost_recorder(override_ptr_->cost_recorder);
+      }
+
+      /// Accumulate into an array (fall back)
+
+      /// \return \c false
+      template <typename A>
+      bool accumulate_to(TsrExpr<A, false>&, const bool, std::false_type) const {
+        return false;
+      }
+
+      /// Accumulate into an array
+
+      /// \tparam A The array type
+      /// \param tsr The tensor that is accumulated into
+      /// \param async The asynchronous assignment flag
+      /// \return \c true if this expression was evaluated into \c tsr
+      template <typename A>
+      bool accumulate_to(TsrExpr<A, false>& tsr, const bool async, std::true_type) const {
+        if(! tsr.array().is_initialized())
+          return false;
+
+        // Construct the expression engine with the distribution of the array
+        engine_type engine(derived());
+        engine.init(tsr.array().world(), tsr.array().pmap(),
+            VariableList(tsr.vars()));
+        if(! engine.seed(tsr.array()))
+          return false;
+        RegionTimer::instance().add_expression();
+
+        // Create the distributed evaluator from this expression
+        typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        record_cost(dist_eval);
+        dist_eval.eval();
+
+        // Create the result array, which shares the (updated) tiles of tsr
+        A result(dist_eval.world(), dist_eval.trange(),
+            dist_eval.shape(), dist_eval.pmap());
+        for(const auto index : *dist_eval.pmap()) {
+          if(! dist_eval.is_zero(index))
+            set_tile(result, index, dist_eval.get(index));
+        }
+
+        finish_eval(dist_eval, result, tsr.array(), async);
+        return true;
+      }
+
     public:
 
       // Compiler generated functions
@@ -232,11 +454,26 @@ namespace TiledArray {
       /// \tparam A The array type
       /// \tparam Alias Tile alias flag
       /// \param tsr The tensor to be assigned
+      /// \param async If \c true , return without waiting for the result
+      /// tiles; the default is \c true inside an \c AsyncEval scope
+      /// \return The handle of the assignment
       template <typename A, bool Alias>
-      void eval_to(TsrExpr<A, Alias>& tsr) const {
+      EvalHandle eval_to(TsrExpr<A, Alias>& tsr,
+          const bool async = async_eval()) const
+      {
         static_assert(! is_lazy_tile<typename A::value_type>::value,
             "Assignment to an array of lazy tiles is not supported.");
 
+        // Evaluate contraction chains in the optimal order
+        EvalHandle handle;
+        if(detail::reorder_contraction(*this, tsr, async, handle))
+          return handle;
+
+        // Evaluate the terms of sums within the memory cap
+        if(detail::schedule_sum(*this, tsr, async, handle))
+          return handle;
+        RegionTimer::instance().add_expression();
+
         // Get the target world
         // 1. result's world is assigned, use it
         // 2. if this expression's world was assigned by set_world(), use it
@@ -256,12 +493,17 @@ namespace TiledArray {
         // Get result variable list.
         VariableList target_vars(tsr.vars());
 
-        // Construct the expression engine
-        engine_type engine(derived());
+        // Construct the expression engine. Contractions that are assigned
+        // to an array with a different tile type accumulate the result in
+        // the tiles of the array.
+        typedef typename detail::result_engine<engine_type,
+            typename A::value_type>::type eval_engine_type;
+        eval_engine_type engine(derived());
         engine.init(world, pmap, target_vars);
 
         // Create the distributed evaluator from this expression
-        typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        typename eval_engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        record_cost(dist_eval);
         dist_eval.eval();
 
         // Create the result array
@@ -275,24 +517,172 @@ namespace TiledArray {
             set_tile(result, index, dist_eval.get(index));
         }
 
-        // Wait for child expressions of dist_eval
-        dist_eval.wait();
+        return finish_eval(dist_eval, result, tsr.array(), async);
+      }
 
-        // Swap the new array with the result array object.
-        result.swap(tsr.array());
+      /// Estimate the cost of assigning this object to \c tsr
+
+      /// The expression engines are initialized as in \c eval_to() , which
+      /// computes the tiled ranges, shapes, and process maps of all
+      /// subexpressions, but no tiles are evaluated and \c tsr is not
+      /// modified. The contraction order of the expression is not optimized.
+      /// This is a collective operation.
+      /// \tparam A The array type
+      /// \tparam Alias Tile alias flag
+      /// \param tsr The tensor that would be assigned
+      /// \return The estimated flops, communication, memory, and tasks of
+      /// each subexpression
+      template <typename A, bool Alias>
+      ExprEstimate estimate(const TsrExpr<A, Alias>& tsr) const {
+        const auto has_set_world = override_ptr_ && override_ptr_->world;
+        World& world = (tsr.array().is_initialized() ?
+            tsr.array().world() :
+            (has_set_world ? *override_ptr_->world : TiledArray::get_default_world()));
+
+        std::shared_ptr<typename TsrExpr<A, Alias>::array_type::pmap_interface> pmap;
+        if(tsr.array().is_initialized())
+          pmap = tsr.array().pmap();
+
+        typedef typename detail::result_engine<engine_type,
+            typename A::value_type>::type eval_engine_type;
+        eval_engine_type engine(derived());
+        engine.init(world, pmap, VariableList(tsr.vars()));
+
+        ExprEstimate result;
+        result.peak_memory(engine.estimate(result));
+        return result;
+      }
+
+
+      /// Evaluate this object and add it to \c tsr in place
+
+      /// When this expression is a contraction, its result is accumulated
+      /// directly into the tiles of \c tsr , i.e. the reduction of each result
+      /// tile starts from the existing tile of \c tsr instead of an empty
+      /// tile, so no temporary result array is created. Since the local tiles
+      /// of \c tsr are modified while the expression is evaluated, this is
+      /// only available for non-aliased targets (see TsrExpr::no_alias() ).
+      /// \tparam A The array type
+      /// \param tsr The tensor that is accumulated into
+      /// \param async If \c true , return without waiting for the result
+      /// tiles; the default is \c true inside an \c AsyncEval scope
+      /// \return \c true if this expression was added to \c tsr ; when
+      /// \c false , \c tsr is unchanged and the caller must evaluate the sum
+      /// with a temporary.
+      template <typename A>
+      bool accumulate_to(TsrExpr<A, false>& tsr,
+          const bool async = async_eval()) const
+      {
+        static_assert(! is_lazy_tile<typename A::value_type>::value,
+            "Assignment to an array of lazy tiles is not supported.");
+        return accumulate_to(tsr, async, std::integral_constant<bool,
+            detail::can_accumulate<engine_type, typename A::value_type>::value>());
       }
 
+      /// Task function used to write a result tile into an array tile
+
+      /// \tparam T The tile type
+      /// \param target The array tile
+      /// \param tile The result tile
+      /// \return \c true
+      template <typename T>
+      static bool assign_tile(T target, const T& tile) {
+        TiledArray::shift(target) = tile;
+        return true;
+      }
+
+      /// Assign this expression to an aliased array block in place
+
+      /// Aliased blocks and tile types that cannot be written in place are
+      /// always assigned with a new array.
+      /// \return \c false
+      template <typename A, bool Alias>
+      bool assign_block_in_place(BlkTsrExpr<A, Alias>&, std::false_type) const {
+        return false;
+      }
+
+      /// Assign this expression to a non-aliased array block in place
+
+      /// The expression is evaluated with the process map of the target tiles
+      /// (see \c SubBlockPmap ), and the result tiles are written into the
+      /// existing tiles of the array, so the tiles outside the block are not
+      /// copied and the result tiles are not moved. Target tiles of the block
+      /// that become zero are erased after the evaluation. This is not
+      /// possible when the result has a non-zero tile where the array has a
+      /// zero tile, or when the expression overrides the world or the process
+      /// map.
+      /// \tparam A The array type
+      /// \param tsr The block to be assigned
+      /// \return \c true if the block was assigned, otherwise \c false and
+      /// \c tsr is unchanged
+      template <typename A>
+      bool assign_block_in_place(BlkTsrExpr<A, false>& tsr, std::true_type) const {
+        A& array = tsr.array();
+        World& world = array.world();
+        const BlockRange blk_range(array.trange().tiles_range(),
+            tsr.lower_bound(), tsr.upper_bound());
+        const std::shared_ptr<typename A::pmap_interface> pmap =
+            std::make_shared<TiledArray::detail::SubBlockPmap>(world, array.pmap(), blk_range);
+
+        // Construct the expression engine with the sub-block process map
+        engine_type engine(derived());
+        engine.init(world, pmap, VariableList(tsr.vars()));
+        if((engine.world() != & world) || (engine.pmap() != pmap))
+          return false;
+
+        // Check that the non-zero result tiles have a target tile
+        for(std::size_t index = 0ul; index < blk_range.volume(); ++index)
+          if(! engine.shape().is_zero(index) && array.is_zero(blk_range.ordinal(index)))
+            return false;
+
+        // Create the distributed evaluator from this expression
+        typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
+        dist_eval.eval();
+
+        // Write the local result tiles into the target tiles. There is no
+        // communication in this step.
+        std::vector<Future<bool> > done;
+        done.reserve(dist_eval.pmap()->local_size());
+        for(const auto index : *dist_eval.pmap()) {
+          if(! dist_eval.is_zero(index))
+            done.push_back(world.taskq.add(
+                & Expr_::template assign_tile<typename A::value_type>,
+                array.find(blk_range.ordinal(index)), dist_eval.get(index)));
+        }
+        {
+          TiledArray::detail::RegionWait wait;
+          for(auto& tile_done : done)
+            tile_done.get();
+
+          // Wait for child expressions of dist_eval
+          dist_eval.wait();
+        }
+
+        // Erase the target tiles that become zero
+        array.pimpl()->truncate(array.shape().update_block(tsr.lower_bound(),
+            tsr.upper_bound(), dist_eval.shape()));
+
+        return true;
+      }
 
       /// Evaluate this object and assign it to \c tsr
 
       /// This expression is evaluated in parallel in distributed environments,
       /// where the content of \c tsr will be replace by the results of the
-      /// evaluated tensor expression.
+      /// evaluated tensor expression. A synchronous assignment to a non-aliased
+      /// block (see \c BlkTsrExpr::no_alias() ) writes the result tiles into
+      /// the existing tiles of the array when the result does not add non-zero
+      /// tiles; the tiles of the array are then modified, and not replaced.
       /// \tparam A The array type
       /// \tparam Alias Tile alias flag
       /// \param tsr The tensor to be assigned
+      /// \param async If \c true , return without waiting for the result
+      /// tiles; the default is \c true inside an \c AsyncEval scope
+      /// \return The handle of the assignment
       template <typename A, bool Alias>
-      void eval_to(BlkTsrExpr<A, Alias>& tsr) const {
+      EvalHandle eval_to(BlkTsrExpr<A, Alias>& tsr,
+          const bool async = async_eval()) const
+      {
         typedef TiledArray::Shift<typename EngineTrait<engine_type>::eval_type,
             EngineTrait<engine_type>::consumable> shift_op_type;
         typedef TiledArray::detail::UnaryWrapper<shift_op_type> op_type;
@@ -314,6 +704,13 @@ namespace TiledArray {
         // set even though this is a requirement.
 #endif // NDEBUG
 
+        RegionTimer::instance().add_expression();
+        if(! async && assign_block_in_place(tsr, std::integral_constant<bool,
+            ! Alias && std::is_same<typename EngineTrait<engine_type>::eval_type,
+            typename A::value_type>::value &&
+            TiledArray::detail::is_tensor<typename A::value_type>::value>()))
+          return EvalHandle();
+
         // Get the target world.
         World& world = tsr.array().world();
 
@@ -368,11 +765,7 @@ namespace TiledArray {
           }
         }
 
-        // Wait for child expressions of dist_eval
-        dist_eval.wait();
-
-        // Swap the new array with the result array object.
-        result.swap(tsr.array());
+        return finish_eval(dist_eval, result, tsr.array(), async);
       }
 
       /// Expression print
@@ -407,8 +800,68 @@ namespace TiledArray {
         return default_world_helper<Derived>(this->derived()).get();
       }
 
+      /// Add the fused tiles of an expression to a reduction
+
+      /// Each local, non-zero tile is evaluated from the leaf arrays by a
+      /// fused kernel and passed to the reduction, which releases it once it
+      /// has been reduced, so the result of the expression is never stored.
+      /// \tparam E The expression engine type
+      /// \tparam ReduceTask The reduction task type
+      /// \param engine The initialized, fusable expression engine
+      /// \param reduce_task The local reduction task
+      template <typename E, typename ReduceTask>
+      static void reduce_fused(const E& engine, ReduceTask& reduce_task,
+          std::true_type)
+      {
+        const FusedTiles<E> tiles(engine);
+        for(const auto index : *engine.pmap())
+          if(! engine.shape().is_zero(index))
+            reduce_task.add(tiles(index));
+      }
+
+      template <typename E, typename ReduceTask>
+      static void reduce_fused(const E&, ReduceTask&, std::false_type) {
+        TA_ASSERT(false);
+      }
+
+      /// Add the fused tile pairs of two expressions to a reduction
+
+      /// Tiles that are zero in either expression are skipped.
+      /// \tparam L The left-hand expression engine type
+      /// \tparam R The right-hand expression engine type
+      /// \tparam ReduceTask The pair reduction task type
+      /// \param left The initialized, fusable left-hand expression engine
+      /// \param right The initialized, fusable right-hand expression engine,
+      /// with the same process map and tiled range as \c left
+      /// \param reduce_task The local reduction task
+      template <typename L, typename R, typename ReduceTask>
+      static void reduce_fused(const L& left, const R& right,
+          ReduceTask& reduce_task, std::true_type)
+      {
+        const FusedTiles<L> left_tiles(left);
+        const FusedTiles<R> right_tiles(right);
+        for(const auto index : *left.pmap())
+          if(! (left.shape().is_zero(index) || right.shape().is_zero(index)))
+            reduce_task.add(left_tiles(index), right_tiles(index));
+      }
+
+      template <typename L, typename R, typename ReduceTask>
+      static void reduce_fused(const L&, const R&, ReduceTask&, std::false_type) {
+        TA_ASSERT(false);
+      }
+
     public:
 
+      /// Reduce the tiles of this expression
+
+      /// When this expression is fusable, e.g. \c (a("i,j")-b("i,j")).norm() ,
+      /// each tile is evaluated from the leaf arrays and reduced as soon as it
+      /// is available, and this function returns without waiting for the
+      /// tiles. Otherwise the expression is evaluated first.
+      /// \tparam Op The reduction operation type
+      /// \param op The reduction operation
+      /// \param world The world where the expression is reduced
+      /// \return A future to the result of the reduction
       template <typename Op>
       Future<typename Op::result_type>
       reduce(const Op& op, World& world) const {
@@ -422,6 +875,16 @@ namespace TiledArray {
         engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
             VariableList());
 
+        // Reduce element-wise expressions without evaluating the result
+        if(fused_evaluable(engine)) {
+          reduction_op_type wrapped_op(op);
+          TiledArray::detail::ReduceTask<reduction_op_type> reduce_task(world, wrapped_op);
+          reduce_fused(engine, reduce_task,
+              std::integral_constant<bool, FusedKernel<engine_type>::value>());
+          return world.gop.all_reduce(key_type(world.unique_obj_id()),
+              reduce_task.submit(), op);
+        }
+
         // Create the distributed evaluator from this expression
         typename engine_type::dist_eval_type dist_eval = engine.make_dist_eval();
         dist_eval.eval();
@@ -465,20 +928,32 @@ namespace TiledArray {
         typedef TiledArray::math::BinaryReduceWrapper<typename engine_type::value_type,
             typename D::engine_type::value_type, Op> reduction_op_type;
 
-        // Evaluate this expression
+        // Construct the expression engines
         engine_type left_engine(derived());
         left_engine.init(world, std::shared_ptr<typename engine_type::pmap_interface>(),
             VariableList());
+        typename D::engine_type right_engine(right_expr.derived());
+        right_engine.init(world, left_engine.pmap(), left_engine.vars());
+
+        // Reduce element-wise expressions without evaluating the arguments
+        if(fused_evaluable(left_engine) && fused_evaluable(right_engine)) {
+          TA_USER_ASSERT(left_engine.trange() == right_engine.trange(),
+              "The TiledRange objects of a binary expression are not equal.");
+          reduction_op_type wrapped_op(op);
+          TiledArray::detail::ReducePairTask<reduction_op_type>
+              local_reduce_task(world, wrapped_op);
+          reduce_fused(left_engine, right_engine, local_reduce_task,
+              std::integral_constant<bool, FusedKernel<engine_type>::value &&
+              FusedKernel<typename D::engine_type>::value>());
+          return world.gop.all_reduce(key_type(world.unique_obj_id()),
+              local_reduce_task.submit(), op);
+        }
 
         // Create the distributed evaluator for this expression
         typename engine_type::dist_eval_type left_dist_eval =
             left_engine.make_dist_eval();
         left_dist_eval.eval();
 
-        // Evaluate the right-hand expression
-        typename D::engine_type right_engine(right_expr.derived());
-        right_engine.init(world, left_engine.pmap(), left_engine.vars());
-
         // Create the distributed evaluator for the right-hand expression
         typename D::engine_type::dist_eval_type right_dist_eval =
             right_engine.make_dist_eval();
@@ -678,6 +1153,67 @@ namespace TiledArray {
         return dot(right_expr, default_world());
       }
 
+      /// Statistics of the elements of this expression
+
+      /// The selected statistics are computed in one pass over each tile and
+      /// one global reduction, instead of one pass and one reduction per
+      /// statistic, e.g.
+      /// \code
+      /// auto stats = r("i,j").statistics(TiledArray::stat_squared_norm |
+      ///     TiledArray::stat_abs_max).get();
+      /// converged = (stats.norm() < 1e-8) && (stats.abs_max() < 1e-6);
+      /// \endcode
+      /// \param flags The selected statistics, a combination of
+      /// \c StatisticsFlags
+      /// \param world The world where the expression is reduced
+      /// \return A future to the statistics
+      Future<typename TiledArray::StatisticsReduction<
+          typename EngineTrait<engine_type>::eval_type>::result_type>
+      statistics(const unsigned int flags, World& world) const {
+        typedef typename EngineTrait<engine_type>::eval_type value_type;
+        return reduce(TiledArray::StatisticsReduction<value_type>(flags), world);
+      }
+
+      Future<typename TiledArray::StatisticsReduction<
+          typename EngineTrait<engine_type>::eval_type>::result_type>
+      statistics(const unsigned int flags) const {
+        return statistics(flags, default_world());
+      }
+
+      /// Statistics of the elements of this expression, and its dot product
+
+      /// The selected statistics and the dot product with \c right_expr are
+      /// computed in one pass over each pair of tiles and one global
+      /// reduction.
+      /// \param right_expr The right-hand expression of the dot product
+      /// \param flags The selected statistics, a combination of
+      /// \c StatisticsFlags
+      /// \param world The world where the expressions are reduced
+      /// \return A future to the statistics
+      /// \note Tiles of this expression are reduced only if the matching tile
+      /// of \c right_expr is not zero, so this is intended for dense arrays,
+      /// or for arrays with the same sparsity.
+      template <typename D>
+      Future<typename TiledArray::StatisticsDotReduction<
+          typename EngineTrait<engine_type>::eval_type,
+          typename EngineTrait<typename D::engine_type>::eval_type>::result_type>
+      statistics(const Expr<D>& right_expr, const unsigned int flags,
+          World& world) const
+      {
+        typedef typename EngineTrait<engine_type>::eval_type left_value_type;
+        typedef typename EngineTrait<typename D::engine_type>::eval_type right_value_type;
+        return reduce(right_expr, TiledArray::StatisticsDotReduction<
+            left_value_type, right_value_type>(flags | stat_dot), world);
+      }
+
+      template <typename D>
+      Future<typename TiledArray::StatisticsDotReduction<
+          typename EngineTrait<engine_type>::eval_type,
+          typename EngineTrait<typename D::engine_type>::eval_type>::result_type>
+      statistics(const Expr<D>& right_expr, const unsigned int flags) const {
+        return statistics(right_expr, flags, default_world());
+      }
+
     }; // class Expr
 
   } // namespace expressions
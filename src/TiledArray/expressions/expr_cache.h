@@ -0,0 +1,190 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  expr_cache.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_CACHE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_CACHE_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+#include <TiledArray/dist_array.h>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Intermediate expression cache
+
+    /// The cache holds the results of subexpressions that are used in
+    /// several expressions, e.g. an intermediate that appears in several
+    /// terms of a set of equations. An expression is cached by wrapping it
+    /// with \c cached() :
+    /// \code
+    /// r1("a,b,i,j") = cached(t2("a,b,i,j") + t1("a,i") * t1("b,j")) * v("a,b,c,d") ...;
+    /// r2("a,b,i,j") = cached(t2("a,b,i,j") + t1("a,i") * t1("b,j")) * w("a,b,c,d") ...;
+    /// \endcode
+    /// The first call evaluates the expression and stores the result; the
+    /// second call reuses it. The result is used with the variable list of
+    /// the expression, i.e. the variables of the first leaf of a sum, or the
+    /// outer variables of a contraction.
+    ///
+    /// Entries are keyed on the structure of the expression tree and the ids
+    /// of its arrays. Since array tiles can only be set once, an array is
+    /// modified by assigning an expression to it, which replaces the
+    /// implementation (and id) of the array. The id of an array therefore
+    /// serves as its version; an expression that uses a reassigned array has
+    /// a new key and is evaluated again. Entries are removed once one of their
+    /// arrays has been destroyed, so an intermediate is evaluated once per
+    /// iteration of an iterative solver without explicit invalidation.
+    /// \note Cache lookups that evaluate an expression are collective
+    /// operations, so the same sequence of lookups must be made on all
+    /// processes. The cache must only be used by the main thread.
+    class ExprCache {
+      /// A cached intermediate
+      struct Entry {
+        std::shared_ptr<void> array; ///< The result of the expression
+        std::vector<ExprLeaf> leaves; ///< The arrays used by the expression
+      }; // struct Entry
+
+      std::unordered_map<std::string, Entry> entries_; ///< Cached intermediates
+      std::size_t hits_; ///< The number of reused intermediates
+      std::size_t misses_; ///< The number of evaluated intermediates
+
+      ExprCache() : entries_(), hits_(0ul), misses_(0ul) { }
+
+      ExprCache(const ExprCache&) = delete;
+      ExprCache& operator=(const ExprCache&) = delete;
+
+      /// Remove entries with destroyed arrays
+      void prune() {
+        for(auto it = entries_.begin(); it != entries_.end();) {
+          bool expired = false;
+          for(const ExprLeaf& leaf : it->second.leaves)
+            expired = expired || leaf.pimpl.expired();
+          if(expired)
+            it = entries_.erase(it);
+          else
+            ++it;
+        }
+      }
+
+    public:
+
+      /// Cache accessor
+
+      /// \return A reference to the cache of this process
+      static ExprCache& instance() {
+        static ExprCache* const cache = new ExprCache();
+        return *cache;
+      }
+
+      /// Cached expression evaluation
+
+      /// \tparam D The derived expression type
+      /// \param expr The expression to be evaluated
+      /// \return A tensor expression of the cached result of \c expr
+      /// \note This is a collective operation.
+      template <typename D>
+      TsrExpr<const DistArray<typename EngineTrait<typename ExprTrait<D>::engine_type>::eval_type,
+          typename EngineTrait<typename ExprTrait<D>::engine_type>::policy>, true>
+      operator()(const Expr<D>& expr) {
+        typedef typename ExprTrait<D>::engine_type engine_type;
+        typedef DistArray<typename EngineTrait<engine_type>::eval_type,
+            typename EngineTrait<engine_type>::policy> array_type;
+
+        // Construct the key from the expression structure and its arrays
+        engine_type engine(expr.derived());
+        engine.init_vars();
+        const VariableList vars = engine.vars();
+        engine.init_struct(vars);
+
+        std::vector<ExprLeaf> leaves;
+        std::stringstream ss;
+        ss << typeid(array_type).name() << "\n";
+        ExprOStream os(ss, leaves);
+        engine.print(os, vars);
+        const std::string key = ss.str();
+        TA_ASSERT(! leaves.empty());
+
+        prune();
+
+        auto it = entries_.find(key);
+        if(it == entries_.end()) {
+          ++misses_;
+          it = entries_.emplace(key,
+              Entry{ std::make_shared<array_type>(), leaves }).first;
+          TsrExpr<array_type, true> result(
+              *std::static_pointer_cast<array_type>(it->second.array), vars.string());
+          expr.derived().eval_to(result);
+        } else {
+          ++hits_;
+        }
+
+        return TsrExpr<const array_type, true>(
+            *std::static_pointer_cast<array_type>(it->second.array), vars.string());
+      }
+
+      /// Remove all cached intermediates
+      void clear() { entries_.clear(); }
+
+      /// Cache size accessor
+
+      /// \return The number of cached intermediates
+      std::size_t size() const { return entries_.size(); }
+
+      /// Hit count accessor
+
+      /// \return The number of times a cached intermediate was reused
+      std::size_t hits() const { return hits_; }
+
+      /// Miss count accessor
+
+      /// \return The number of times an intermediate was evaluated
+      std::size_t misses() const { return misses_; }
+
+    }; // class ExprCache
+
+    /// Cached expression evaluation
+
+    /// The result of \c expr is stored in the intermediate cache and reused
+    /// by later calls with the same expression, until one of the arrays of
+    /// \c expr is reassigned. See \c ExprCache for details.
+    /// \tparam D The derived expression type
+    /// \param expr The expression to be evaluated
+    /// \return A tensor expression of the cached result of \c expr
+    /// \note This is a collective operation.
+    template <typename D>
+    inline TsrExpr<const DistArray<typename EngineTrait<typename ExprTrait<D>::engine_type>::eval_type,
+        typename EngineTrait<typename ExprTrait<D>::engine_type>::policy>, true>
+    cached(const Expr<D>& expr) {
+      return ExprCache::instance()(expr);
+    }
+
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EXPR_CACHE_H__INCLUDED
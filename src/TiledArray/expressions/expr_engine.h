@@ -27,7 +27,12 @@
 #define TILEDARRAY_EXPRESSIONS_EXPR_ENGINE_H__INCLUDED
 
 #include <TiledArray/madness.h>
+#include <TiledArray/memory_tracker.h>
 #include <TiledArray/expressions/expr_trace.h>
+#include <TiledArray/expressions/expr_estimate.h>
+#include <TiledArray/perm_index.h>
+#include <TiledArray/type_traits.h>
+#include <sstream>
 
 namespace TiledArray {
   namespace expressions {
@@ -36,6 +41,8 @@ namespace TiledArray {
     template <typename> struct EngineParamOverride;
     template <typename> class Expr;
     template <typename> struct EngineTrait;
+    template <typename, typename> class ScalEngine;
+    template <typename, typename> class ScalTsrEngine;
 
     /// Expression engine
     template <typename Derived>
@@ -69,6 +76,32 @@ namespace TiledArray {
       std::shared_ptr<pmap_interface> pmap_; ///< The process map for the result tensor
       std::shared_ptr<EngineParamOverride<Derived> > override_ptr_; ///< The engine params overriding the default
 
+    private:
+
+      /// Engine parameter accessor
+
+      /// \param override_ptr The parameters of the expression
+      /// \return \c override_ptr
+      static const std::shared_ptr<EngineParamOverride<Derived> >&
+      make_override(const std::shared_ptr<EngineParamOverride<Derived> >& override_ptr) {
+        return override_ptr;
+      }
+
+      /// Convert the parameters of an expression with another engine type
+
+      /// An expression may be evaluated by an engine that differs from its
+      /// own, e.g. a mixed precision contraction.
+      /// \tparam E The engine type of the expression
+      /// \param override_ptr The parameters of the expression
+      /// \return A copy of the parameters of \c override_ptr
+      template <typename E>
+      static std::shared_ptr<EngineParamOverride<Derived> >
+      make_override(const std::shared_ptr<EngineParamOverride<E> >& override_ptr) {
+        if(! override_ptr)
+          return std::shared_ptr<EngineParamOverride<Derived> >();
+        return std::make_shared<EngineParamOverride<Derived> >(*override_ptr);
+      }
+
     public:
 
       /// Default constructor
@@ -77,7 +110,7 @@ namespace TiledArray {
       template <typename D>
       ExprEngine(const Expr<D> &expr) :
         world_(NULL), vars_(), permute_tiles_(true), perm_(), trange_(), shape_(),
-        pmap_(), override_ptr_(expr.override_ptr_)
+        pmap_(), override_ptr_(make_override(expr.override_ptr_))
       { }
 
       /// Construct and initialize the expression engine
@@ -92,17 +125,24 @@ namespace TiledArray {
       void init(World& world, std::shared_ptr<pmap_interface> pmap,
           const VariableList& target_vars)
       {
-        if(target_vars.dim()) {
-          derived().init_vars(target_vars);
-          derived().init_struct(target_vars);
-        } else {
-          derived().init_vars();
-          derived().init_struct(vars_);
-        }
-
+        // The world is set first, so the structure of the result (e.g. the
+        // shape) may be computed collectively
         auto override_world = override_ptr_ != nullptr && override_ptr_->world;
         auto override_pmap = override_ptr_ != nullptr && override_ptr_->pmap;
         world_ = override_world ? override_ptr_->world : &world;
+
+        {
+          // Charge the shape data of the expression graph to shape memory
+          TiledArray::detail::MemoryScope memory_scope(MemoryCategory::shape);
+          if(target_vars.dim()) {
+            derived().init_vars(target_vars);
+            derived().init_struct(target_vars);
+          } else {
+            derived().init_vars();
+            derived().init_struct(vars_);
+          }
+        }
+
         pmap_ = override_pmap ? override_ptr_->pmap : pmap;
 
         // Check for a valid process map.
@@ -138,9 +178,27 @@ namespace TiledArray {
         }
 
         if(override_ptr_ && override_ptr_->shape)
-          shape_ = shape_.mask(*override_ptr_->shape);
+          mask_shape(*override_ptr_->shape);
+      }
+
+      /// Restrict the result to the non-zero tiles of a mask
+
+      /// The arguments of this expression are restricted to the tiles that
+      /// contribute to the masked result (see \c mask_args() ), so the tiles
+      /// that are not requested are neither evaluated nor communicated. This
+      /// must be called after \c init_struct() .
+      /// \param mask The mask, where the zero tiles are not evaluated
+      void mask_shape(const shape_type& mask) {
+        shape_ = shape_.mask(mask);
+        derived().mask_args();
       }
 
+      /// Restrict the arguments to the tiles of the result shape
+
+      /// Leaves have no arguments. Derived classes with arguments mask them
+      /// with the tiles that contribute to the non-zero tiles of the result.
+      void mask_args() { }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
@@ -241,8 +299,110 @@ namespace TiledArray {
       /// \return An expression tag used to identify this expression
       const char* make_tag() const { return ""; }
 
+      /// Estimate the cost of this expression
+
+      /// The tiles of a leaf are read from an existing array, so only a
+      /// permuted leaf, which makes permuted copies of the tiles, has a cost.
+      /// \param est The estimate that the node of this expression is added to
+      /// \return The peak intermediate memory of this expression on any
+      /// process
+      double estimate(ExprEstimate& est) const {
+        ExprEstimate::Node& node = est.node(estimate_node(est));
+        estimate_result(node);
+        if(perm_ && permute_tiles_)
+          node.tasks = node.tiles;
+        else
+          node.memory = 0.0;
+        return node.memory;
+      }
+
+    protected:
+
+      /// Add the node of this expression to an estimate
+
+      /// \param est The estimate
+      /// \return The index of the node of this expression
+      std::size_t estimate_node(ExprEstimate& est) const {
+        std::stringstream ss;
+        ss << derived().make_tag() << vars_;
+        return est.push(ss.str());
+      }
+
+      /// Estimate the size of the result of this expression
+
+      /// \param[out] node The node of this expression, which receives the
+      /// number of non-zero tiles and the result memory
+      /// \return The number of elements of the non-zero result tiles
+      double estimate_result(ExprEstimate::Node& node) const {
+        double elements = 0.0;
+        node.memory = detail::estimate_result_memory(derived(),
+            sizeof(typename TiledArray::detail::numeric_type<
+              typename EngineTrait<Derived>::eval_type>::type),
+            node.tiles, elements);
+        return elements;
+      }
+
+      /// Estimate the bytes of an argument sent to the result owners
+
+      /// The non-zero tiles of \c arg that are needed by non-zero result tiles
+      /// owned by another process are counted.
+      /// \tparam Arg The argument engine type
+      /// \param arg The argument engine of an element-wise expression
+      /// \return The bytes of \c arg sent between processes
+      template <typename Arg>
+      double estimate_arg_comm(const Arg& arg) const {
+        const std::size_t element_size = sizeof(typename
+            TiledArray::detail::numeric_type<typename EngineTrait<Arg>::eval_type>::type);
+        const TiledArray::detail::PermIndex target_to_source(
+            (perm_ ? TiledArray::detail::PermIndex(trange_.tiles_range(), -perm_) :
+            TiledArray::detail::PermIndex()));
+        double result = 0.0;
+        const std::size_t volume = trange_.tiles_range().volume();
+        for(std::size_t i = 0ul; i < volume; ++i) {
+          if(shape_.is_zero(i))
+            continue;
+          const std::size_t source = (target_to_source ? target_to_source(i) : i);
+          if(arg.shape().is_zero(source) ||
+              (arg.pmap()->owner(source) == pmap_->owner(i)))
+            continue;
+          result += double(trange_.make_tile_range(i).volume()) * double(element_size);
+        }
+        return result;
+      }
+
     }; // class ExprEngine
 
+    /// Fold the scaling factor of an argument into \c alpha
+
+    /// This is a noop for arguments that do not have a foldable factor.
+    template <typename Scalar, typename Engine>
+    inline void fold_factor(Scalar&, Engine&) { }
+
+    /// Fold the scaling factor of a scaled leaf argument into \c alpha
+
+    /// The leaf tiles are then passed to the consumer without an intermediate
+    /// scaled copy.
+    /// \param alpha The scaling factor of the consuming operation
+    /// \param engine The scaled leaf engine
+    template <typename Scalar, typename Array, typename S,
+        typename std::enable_if<std::is_convertible<S, Scalar>::value>::type* = nullptr>
+    inline void fold_factor(Scalar& alpha, ScalTsrEngine<Array, S>& engine) {
+      alpha *= engine.fold_factor();
+    }
+
+    /// Fold the scaling factor of a scaled expression into \c alpha
+
+    /// The factors of nested scaled expressions are multiplied together, so
+    /// the argument tiles are passed to the consumer without a scaling pass.
+    /// \param alpha The scaling factor of the consuming operation
+    /// \param engine The scaled expression engine
+    template <typename Scalar, typename Arg, typename S,
+        typename std::enable_if<std::is_convertible<
+            typename EngineTrait<ScalEngine<Arg, S> >::scalar_type, Scalar>::value>::type* = nullptr>
+    inline void fold_factor(Scalar& alpha, ScalEngine<Arg, S>& engine) {
+      alpha *= engine.fold_factor();
+    }
+
   }  // namespace expressions
 } // namespace TiledArray
 
@@ -0,0 +1,221 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  expr_estimate.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_EXPR_ESTIMATE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_EXPR_ESTIMATE_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/pmap/pmap.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Estimated cost of an expression evaluation
+
+    /// The estimate is computed from the tiled ranges, shapes, and process
+    /// maps of the expression engines, without evaluating any tiles (see
+    /// \c Expr::estimate() ). Each node of the expression tree records the
+    /// floating point operations and tile tasks of its own evaluation, the
+    /// bytes it sends between processes, and the size of its result on the
+    /// process that holds the largest part of it. The peak memory is an upper
+    /// bound of the memory used by the intermediate results on any process,
+    /// assuming that the results of the arguments of an expression are
+    /// released once it is evaluated. The tiles of leaf arrays are not
+    /// included, since they are allocated before the evaluation.
+    class ExprEstimate {
+    public:
+
+      /// The estimate of one expression node
+      struct Node {
+        std::string expr; ///< The expression tag and variable list
+        unsigned int depth; ///< The depth of the node in the expression tree
+        double flops; ///< Floating point operations
+        double comm_bytes; ///< Bytes sent between processes
+        double memory; ///< Bytes of the result on the largest process
+        std::size_t tasks; ///< Number of tile tasks
+        std::size_t tiles; ///< Number of non-zero result tiles
+      }; // struct Node
+
+    private:
+      std::vector<Node> nodes_; ///< Node estimates, in expression order
+      unsigned int depth_; ///< The depth of the current node
+      double peak_memory_; ///< Peak intermediate memory on any process
+
+    public:
+
+      /// Construct an empty estimate
+      ExprEstimate() : nodes_(), depth_(0u), peak_memory_(0.0) { }
+
+      /// Add a node at the current depth
+
+      /// \param expr The expression tag and variable list of the node
+      /// \return The index of the new node
+      std::size_t push(const std::string& expr) {
+        nodes_.push_back(Node { expr, depth_, 0.0, 0.0, 0.0, 0ul, 0ul });
+        return nodes_.size() - 1ul;
+      }
+
+      /// Node accessor
+
+      /// \param i The index of the node
+      /// \return A reference to node \c i
+      Node& node(const std::size_t i) {
+        TA_ASSERT(i < nodes_.size());
+        return nodes_[i];
+      }
+
+      /// Increment the depth of the added nodes
+      void inc() { ++depth_; }
+
+      /// Decrement the depth of the added nodes
+      void dec() { TA_ASSERT(depth_ > 0u); --depth_; }
+
+      /// Set the peak memory
+
+      /// \param memory The peak intermediate memory on any process
+      void peak_memory(const double memory) { peak_memory_ = memory; }
+
+      /// \return The node estimates, in the order of the expression
+      const std::vector<Node>& nodes() const { return nodes_; }
+
+      /// \return The total number of floating point operations
+      double flops() const {
+        double result = 0.0;
+        for(const Node& n : nodes_)
+          result += n.flops;
+        return result;
+      }
+
+      /// \return The total number of bytes sent between processes
+      double comm_bytes() const {
+        double result = 0.0;
+        for(const Node& n : nodes_)
+          result += n.comm_bytes;
+        return result;
+      }
+
+      /// \return The total number of tile tasks
+      std::size_t tasks() const {
+        std::size_t result = 0ul;
+        for(const Node& n : nodes_)
+          result += n.tasks;
+        return result;
+      }
+
+      /// \return The peak intermediate memory (bytes) on any process
+      double peak_memory() const { return peak_memory_; }
+
+    }; // class ExprEstimate
+
+    /// Print an expression estimate
+
+    /// \param os The output stream
+    /// \param est The estimate
+    /// \return \c os
+    inline std::ostream& operator<<(std::ostream& os, const ExprEstimate& est) {
+      const std::ios::fmtflags flags = os.flags();
+      const std::streamsize precision = os.precision();
+      os << std::scientific << std::setprecision(3);
+      for(const ExprEstimate::Node& n : est.nodes()) {
+        os << std::string(2u * n.depth, ' ') << n.expr
+           << "  flops=" << n.flops << " comm=" << n.comm_bytes
+           << "B memory=" << n.memory << "B tasks=" << n.tasks
+           << " tiles=" << n.tiles << "\n";
+      }
+      os << "total: flops=" << est.flops() << " comm=" << est.comm_bytes()
+         << "B peak memory=" << est.peak_memory() << "B tasks=" << est.tasks()
+         << "\n";
+      os.flags(flags);
+      os.precision(precision);
+      return os;
+    }
+
+    namespace detail {
+
+      /// Volumes of the tiles of a fused range of dimensions
+
+      /// \tparam TRange The tiled range type
+      /// \param trange The tiled range
+      /// \param first The first dimension of the fused range
+      /// \param last The end of the fused range of dimensions
+      /// \return The volume of each fused tile, in row-major order
+      template <typename TRange>
+      std::vector<double> fused_tile_volumes(const TRange& trange,
+          const unsigned int first, const unsigned int last)
+      {
+        std::vector<double> result(1ul, 1.0);
+        for(unsigned int d = first; d < last; ++d) {
+          const auto& tr1 = trange.data()[d];
+          std::vector<double> next;
+          next.reserve(result.size() * tr1.tiles_range().second);
+          for(const double v : result)
+            for(auto t = tr1.tiles_range().first; t < tr1.tiles_range().second; ++t)
+              next.push_back(v * double(tr1.tile(t).second - tr1.tile(t).first));
+          result.swap(next);
+        }
+        return result;
+      }
+
+      /// Size of the result of an engine on the largest process
+
+      /// \tparam Engine The expression engine type
+      /// \param engine The expression engine
+      /// \param element_size The size of a tile element
+      /// \param[out] tiles The number of non-zero tiles
+      /// \param[out] elements The number of elements in the non-zero tiles
+      /// \return The bytes of the non-zero local tiles of the process with
+      /// the largest part of the result
+      template <typename Engine>
+      double estimate_result_memory(const Engine& engine,
+          const std::size_t element_size, std::size_t& tiles, double& elements)
+      {
+        const auto& trange = engine.trange();
+        const Pmap& pmap = *engine.pmap();
+        std::vector<double> local(pmap.procs(), 0.0);
+        tiles = 0ul;
+        elements = 0.0;
+        const std::size_t volume = trange.tiles_range().volume();
+        for(std::size_t i = 0ul; i < volume; ++i) {
+          if(engine.shape().is_zero(i))
+            continue;
+          const double size = trange.make_tile_range(i).volume();
+          ++tiles;
+          elements += size;
+          local[pmap.owner(i)] += size * double(element_size);
+        }
+        return *std::max_element(local.begin(), local.end());
+      }
+
+    } // namespace detail
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_EXPR_ESTIMATE_H__INCLUDED
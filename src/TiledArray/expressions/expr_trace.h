@@ -28,6 +28,8 @@
 
 #include <TiledArray/expressions/variable_list.h>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 namespace TiledArray {
   namespace expressions {
@@ -35,22 +37,40 @@ namespace TiledArray {
     template <typename> class Expr;
     template <typename, bool> class TsrExpr;
 
+    /// The array of an expression leaf
+    struct ExprLeaf {
+      std::weak_ptr<const void> pimpl; ///< The array implementation
+    }; // struct ExprLeaf
+
     /// Expression output stream
     class ExprOStream {
       std::ostream& os_; ///< output stream
       unsigned int tab_; ///< Number of leading tabs
+      std::vector<ExprLeaf>* leaves_; ///< The leaf arrays of the expression
 
     public:
 
       /// Constructor
 
       /// \param os The output stream
-      ExprOStream(std::ostream& os) : os_(os), tab_(0u) { }
+      ExprOStream(std::ostream& os) : os_(os), tab_(0u), leaves_(nullptr) { }
+
+      /// Constructor that records leaf arrays
+
+      /// The arrays of the expression leaves are appended to \c leaves , and
+      /// their ids are added to the output.
+      /// \param os The output stream
+      /// \param leaves The leaf arrays of the printed expression
+      ExprOStream(std::ostream& os, std::vector<ExprLeaf>& leaves) :
+        os_(os), tab_(0u), leaves_(&leaves)
+      { }
 
       /// Copy constructor
 
       /// \param other The stream object to be copied
-      ExprOStream(const ExprOStream& other) : os_(other.os_), tab_(other.tab_) { }
+      ExprOStream(const ExprOStream& other) :
+        os_(other.os_), tab_(other.tab_), leaves_(other.leaves_)
+      { }
 
       /// Output operator
 
@@ -75,6 +95,19 @@ namespace TiledArray {
       /// Output stream accessor
       std::ostream& get_stream() const { return os_; }
 
+      /// Record a leaf array
+
+      /// This function does nothing unless this stream records leaf arrays.
+      /// \tparam A The array type
+      /// \param array The array of an expression leaf
+      template <typename A>
+      void leaf(const A& array) {
+        if(leaves_) {
+          leaves_->push_back(ExprLeaf{ array.pimpl() });
+          *this << "#" << array.id() << "\n";
+        }
+      }
+
     }; // class ExprOStream
 
     /// Expression trace target
@@ -0,0 +1,229 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  fused_kernel.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_FUSED_KERNEL_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_FUSED_KERNEL_H__INCLUDED
+
+#include <TiledArray/dist_eval/fused_eval.h>
+#include <TiledArray/expressions/variable_list.h>
+
+namespace TiledArray {
+
+  // Forward declaration
+  template <typename, typename> class DistArray;
+
+  namespace expressions {
+
+    namespace detail {
+
+      /// Expression fusion flag accessor
+      inline bool& fusion_flag() {
+        static bool flag = true;
+        return flag;
+      }
+
+    } // namespace detail
+
+    /// Enable or disable expression fusion
+
+    /// Fusion is enabled by default. Disabling it evaluates every node of an
+    /// expression separately, which is useful for comparisons.
+    /// \param status The new fusion status
+    inline void set_expression_fusion(const bool status) {
+      detail::fusion_flag() = status;
+    }
+
+    /// Expression fusion status
+
+    /// \return \c true if element-wise expressions are fused
+    inline bool expression_fusion() { return detail::fusion_flag(); }
+
+    /// Fused kernel trait of an expression engine
+
+    /// An engine can be fused when it and all of its children are
+    /// element-wise operations or array leaves with the same \c Tensor tile
+    /// type. Specializations of fusable engines provide
+    /// \code
+    /// static constexpr bool value = true;
+    /// typedef ... tile_type; // The tile type of the arguments and the result
+    /// typedef ... type;      // The fused kernel type
+    ///
+    /// // Check that the engine and its children do not permute tiles, use the
+    /// // target variable list, and are element-wise (e.g. a multiplication is
+    /// // not a contraction)
+    /// static bool fusable(const Engine& engine, const VariableList& vars);
+    ///
+    /// // Construct the fused kernel and append the leaf arrays to args
+    /// static type make(const Engine& engine,
+    ///     std::vector<DistArray<tile_type, policy> >& args);
+    /// \endcode
+    /// \tparam Engine The expression engine type
+    template <typename Engine>
+    struct FusedKernel {
+      static constexpr bool value = false;
+      typedef void tile_type;
+      typedef void type;
+    }; // struct FusedKernel
+
+    /// Fused kernel trait of a binary engine
+
+    /// \tparam Left The left-hand engine type
+    /// \tparam Right The right-hand engine type
+    /// \tparam ValueType The result tile type of the engine
+    template <typename Left, typename Right, typename ValueType>
+    struct FusedBinaryKernel {
+      static constexpr bool value = FusedKernel<Left>::value &&
+          FusedKernel<Right>::value &&
+          std::is_same<typename FusedKernel<Left>::tile_type,
+              typename FusedKernel<Right>::tile_type>::value &&
+          std::is_same<typename FusedKernel<Left>::tile_type, ValueType>::value;
+      typedef typename FusedKernel<Left>::tile_type tile_type;
+
+      /// Check the engine and its children for fusion
+      template <typename Engine>
+      static bool fusable(const Engine& engine, const VariableList& vars) {
+        return (! engine.perm()) && (engine.vars() == vars) &&
+            FusedKernel<Left>::fusable(engine.left(), vars) &&
+            FusedKernel<Right>::fusable(engine.right(), vars);
+      }
+    }; // struct FusedBinaryKernel
+
+    /// Construct a fused distributed evaluator
+
+    /// \tparam Engine The expression engine type, which must be fusable
+    /// \param engine The expression engine
+    /// \return A distributed evaluator that evaluates \c engine with one
+    /// fused kernel per tile
+    template <typename Engine>
+    typename Engine::dist_eval_type make_fused_dist_eval(const Engine& engine) {
+      typedef FusedKernel<Engine> fused_type;
+      typedef typename fused_type::tile_type tile_type;
+      typedef typename Engine::policy policy;
+      typedef TiledArray::detail::FusedEvalImpl<tile_type,
+          typename fused_type::type, policy> impl_type;
+
+      std::vector<DistArray<tile_type, policy> > args;
+      const typename fused_type::type kernel = fused_type::make(engine, args);
+
+      std::shared_ptr<impl_type> pimpl(new impl_type(args, *engine.world(),
+          engine.trange(), engine.shape(), engine.pmap(), kernel));
+
+      return typename Engine::dist_eval_type(pimpl);
+    }
+
+    namespace detail {
+
+      template <typename Engine>
+      inline bool fusable_engine(const Engine&, std::false_type) { return false; }
+
+      template <typename Engine>
+      inline bool fusable_engine(const Engine& engine, std::true_type) {
+        return FusedKernel<Engine>::fusable(engine, engine.vars());
+      }
+
+    } // namespace detail
+
+    /// Check that an initialized engine can be evaluated with a fused kernel
+
+    /// \tparam Engine The expression engine type
+    /// \param engine The initialized expression engine
+    /// \return \c true if fusion is enabled and \c engine is fusable
+    template <typename Engine>
+    inline bool fused_evaluable(const Engine& engine) {
+      return expression_fusion() && detail::fusable_engine(engine,
+          std::integral_constant<bool, FusedKernel<Engine>::value>());
+    }
+
+    /// Fused tile evaluator
+
+    /// This object evaluates single tiles of a fusable expression with one
+    /// fused kernel per tile, reading the argument tiles directly from the
+    /// leaf arrays. Unlike \c FusedEvalImpl , it does not store the tiles, so
+    /// it is suited to consumers, such as reductions, that discard each tile
+    /// after using it.
+    /// \tparam Engine The expression engine type, which must be fusable
+    template <typename Engine>
+    class FusedTiles {
+      typedef FusedKernel<Engine> fused_type;
+
+    public:
+      typedef typename fused_type::tile_type tile_type; ///< Tile type
+      typedef typename fused_type::type kernel_type; ///< Fused kernel type
+      typedef DistArray<tile_type, typename Engine::policy> array_type;
+                                                    ///< Argument array type
+      typedef typename Engine::trange_type trange_type; ///< Tiled range type
+
+    private:
+      World& world_; ///< The world of the expression
+      trange_type trange_; ///< The tiled range of the expression
+      std::vector<array_type> args_; ///< The argument arrays
+      kernel_type kernel_; ///< The fused kernel
+
+    public:
+
+      /// Constructor
+
+      /// \param engine The initialized expression engine
+      explicit FusedTiles(const Engine& engine) :
+        world_(*engine.world()), trange_(engine.trange()), args_(),
+        kernel_(fused_type::make(engine, args_))
+      {
+        TA_ASSERT(! args_.empty());
+      }
+
+      /// Evaluate a tile
+
+      /// The tile is evaluated by a task that runs when the argument tiles are
+      /// available, which fetches remote argument tiles when needed.
+      /// \param index The ordinal index of the tile
+      /// \return A future to tile \c index
+      Future<tile_type> operator()(const std::size_t index) const {
+        std::vector<Future<tile_type> > tiles;
+        tiles.reserve(args_.size());
+        for(const array_type& arg : args_)
+          tiles.push_back(arg.is_zero(index) ? Future<tile_type>(tile_type()) :
+              arg.find(index));
+
+        // The argument arrays are held by the task until it has run
+        const std::vector<array_type> args = args_;
+        const kernel_type kernel = kernel_;
+        const typename tile_type::range_type range = trange_.make_tile_range(index);
+        return world_.taskq.add([args,kernel,range] (
+            const std::vector<Future<tile_type> >& arg_tiles) -> tile_type
+        {
+          std::vector<tile_type> data;
+          data.reserve(arg_tiles.size());
+          for(const Future<tile_type>& tile : arg_tiles)
+            data.push_back(tile.get());
+          return TiledArray::detail::fused_tile(kernel, range, data);
+        }, tiles);
+      }
+
+    }; // class FusedTiles
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_FUSED_KERNEL_H__INCLUDED
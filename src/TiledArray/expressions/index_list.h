@@ -0,0 +1,258 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  index_list.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_INDEX_LIST_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_INDEX_LIST_H__INCLUDED
+
+#include <TiledArray/expressions/variable_list.h>
+#include <TiledArray/math/gemm_helper.h>
+
+namespace TiledArray {
+  namespace expressions {
+
+    namespace detail {
+
+      /// Check that a character is a valid single character index
+      constexpr bool valid_index(const char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9');
+      }
+
+      /// Find the position of an index in a list
+
+      /// \return The position of \c c in \c vars , or \c n if \c c is not in
+      /// the list
+      constexpr unsigned int index_position(const char* vars,
+          const unsigned int n, const char c)
+      {
+        unsigned int i = 0u;
+        for(; i < n; ++i)
+          if(vars[i] == c)
+            break;
+        return i;
+      }
+
+      /// Check that all indices of a list are valid and unique
+      constexpr bool valid_index_list(const char* vars, const unsigned int n) {
+        for(unsigned int i = 0u; i < n; ++i) {
+          if(! valid_index(vars[i]))
+            return false;
+          if(index_position(vars, i, vars[i]) != i)
+            return false;
+        }
+        return true;
+      }
+
+      /// Check that two index lists are permutations of each other
+      constexpr bool is_index_permutation(const char* vars1, const unsigned int n1,
+          const char* vars2, const unsigned int n2)
+      {
+        if(n1 != n2)
+          return false;
+        for(unsigned int i = 0u; i < n1; ++i)
+          if(index_position(vars2, n2, vars1[i]) == n2)
+            return false;
+        return true;
+      }
+
+      /// Count the indices of one list that are also in another list
+      constexpr unsigned int common_indices(const char* vars1, const unsigned int n1,
+          const char* vars2, const unsigned int n2)
+      {
+        unsigned int count = 0u;
+        for(unsigned int i = 0u; i < n1; ++i)
+          if(index_position(vars2, n2, vars1[i]) != n2)
+            ++count;
+        return count;
+      }
+
+    } // namespace detail
+
+    /// Compile-time index list
+
+    /// An alternative to the string annotation of arrays, where each index is
+    /// a single character, e.g. <tt>a(IndexList<'i','j'>())</tt> is
+    /// equivalent to <tt>a("i,j")</tt> . The indices are checked at compile
+    /// time, and the annotation string and variable list are constructed once
+    /// per program, so expressions that are evaluated many times do not
+    /// repeat that work.
+    /// \tparam Vars The indices
+    template <char... Vars>
+    struct IndexList {
+      static constexpr unsigned int rank = sizeof...(Vars); ///< The number of indices
+      static constexpr char vars[sizeof...(Vars) + 1u] = { Vars..., '\0' }; ///< The indices
+
+      static_assert(rank > 0u, "IndexList must contain at least one index.");
+      static_assert(detail::valid_index_list(vars, rank),
+          "IndexList indices must be unique letters or digits.");
+
+      /// Annotation string accessor
+
+      /// \return The comma separated annotation, e.g. \c "i,j"
+      static const std::string& string() {
+        static const std::string result = make_string();
+        return result;
+      }
+
+      /// Variable list accessor
+
+      /// \return The variable list of this index list
+      static const VariableList& variable_list() {
+        static const VariableList result(string());
+        return result;
+      }
+
+    private:
+
+      static std::string make_string() {
+        std::string result;
+        result.reserve(2u * rank);
+        for(unsigned int i = 0u; i < rank; ++i) {
+          if(i)
+            result += ',';
+          result += vars[i];
+        }
+        return result;
+      }
+    }; // struct IndexList
+
+    template <char... Vars>
+    constexpr unsigned int IndexList<Vars...>::rank;
+    template <char... Vars>
+    constexpr char IndexList<Vars...>::vars[sizeof...(Vars) + 1u];
+
+    /// Compile-time permutation between two index lists
+
+    /// The permutation has the same meaning as
+    /// <tt>VariableList::permutation()</tt> , i.e. \c p , where
+    /// <tt>To == p ^ From</tt> as variable lists. It is computed at compile
+    /// time and constructed once per program.
+    /// \tparam From The index list of the argument
+    /// \tparam To The target index list
+    template <typename From, typename To>
+    struct IndexPermutation {
+      static_assert(detail::is_index_permutation(From::vars, From::rank,
+          To::vars, To::rank),
+          "IndexPermutation requires index lists that are permutations of each other.");
+
+      static constexpr unsigned int rank = From::rank; ///< The rank of the permutation
+
+      /// Element accessor
+
+      /// \param i The element index
+      /// \return Element \c i of the permutation
+      static constexpr unsigned int element(const unsigned int i) {
+        return detail::index_position(From::vars, From::rank, To::vars[i]);
+      }
+
+      /// Identity check
+
+      /// \return \c true if the permutation is the identity
+      static constexpr bool is_identity() {
+        for(unsigned int i = 0u; i < rank; ++i)
+          if(element(i) != i)
+            return false;
+        return true;
+      }
+
+      /// Permutation accessor
+
+      /// \return The permutation from \c From to \c To
+      static const Permutation& permutation() {
+        static const Permutation result = make_permutation();
+        return result;
+      }
+
+    private:
+
+      static Permutation make_permutation() {
+        std::vector<unsigned int> p(rank);
+        for(unsigned int i = 0u; i < rank; ++i)
+          p[i] = element(i);
+        return Permutation(p);
+      }
+    }; // struct IndexPermutation
+
+    template <typename From, typename To>
+    constexpr unsigned int IndexPermutation<From, To>::rank;
+
+    /// Compile-time contraction of two index lists
+
+    /// Indices of \c Left and \c Right that are not in \c Result are
+    /// contracted. The ranks are checked at compile time, so the GEMM helper
+    /// of the contraction is constructed without the runtime checks.
+    /// \tparam Result The index list of the result
+    /// \tparam Left The index list of the left-hand argument
+    /// \tparam Right The index list of the right-hand argument
+    template <typename Result, typename Left, typename Right>
+    struct IndexContraction {
+      static constexpr unsigned int result_rank = Result::rank; ///< Result rank
+      static constexpr unsigned int left_rank = Left::rank; ///< Left-hand rank
+      static constexpr unsigned int right_rank = Right::rank; ///< Right-hand rank
+      /// The number of contracted indices
+      static constexpr unsigned int contract_rank =
+          left_rank - detail::common_indices(Left::vars, left_rank,
+              Result::vars, result_rank);
+
+      static_assert(detail::common_indices(Left::vars, left_rank, Right::vars,
+          right_rank) == contract_rank,
+          "IndexContraction: the contracted indices of the arguments differ.");
+      static_assert(detail::common_indices(Result::vars, result_rank, Left::vars,
+          left_rank) + detail::common_indices(Result::vars, result_rank,
+          Right::vars, right_rank) == result_rank,
+          "IndexContraction: each result index must be in exactly one argument.");
+      static_assert(left_rank + right_rank - 2u * contract_rank == result_rank,
+          "IndexContraction: invalid contraction ranks.");
+
+      /// Construct the GEMM helper of this contraction
+
+      /// \param left_op The transpose operation of the left-hand argument
+      /// \param right_op The transpose operation of the right-hand argument
+      /// \return The GEMM helper
+      static math::GemmHelper
+      gemm_helper(const madness::cblas::CBLAS_TRANSPOSE left_op = madness::cblas::NoTrans,
+          const madness::cblas::CBLAS_TRANSPOSE right_op = madness::cblas::NoTrans)
+      {
+        return math::GemmHelper(left_op, right_op, result_rank, left_rank,
+            right_rank);
+      }
+    }; // struct IndexContraction
+
+    template <typename Result, typename Left, typename Right>
+    constexpr unsigned int IndexContraction<Result, Left, Right>::result_rank;
+    template <typename Result, typename Left, typename Right>
+    constexpr unsigned int IndexContraction<Result, Left, Right>::left_rank;
+    template <typename Result, typename Left, typename Right>
+    constexpr unsigned int IndexContraction<Result, Left, Right>::right_rank;
+    template <typename Result, typename Left, typename Right>
+    constexpr unsigned int IndexContraction<Result, Left, Right>::contract_rank;
+
+  } // namespace expressions
+
+  using expressions::IndexList;
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_INDEX_LIST_H__INCLUDED
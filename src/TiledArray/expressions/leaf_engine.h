@@ -28,6 +28,7 @@
 
 #include <TiledArray/expressions/expr_engine.h>
 #include <TiledArray/dist_eval/array_eval.h>
+#include <TiledArray/expressions/fused_kernel.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -152,6 +153,11 @@ namespace TiledArray {
       make_shape(const Permutation& perm) { return array_.shape().perm(perm); }
 
 
+      /// Array accessor
+
+      /// \return The array of this leaf
+      const array_type& array() const { return array_; }
+
       /// Construct the distributed evaluator for array
       dist_eval_type make_dist_eval() const {
         // Define the distributed evaluator implementation type
@@ -165,6 +171,15 @@ namespace TiledArray {
         return dist_eval_type(pimpl);
       }
 
+      /// Expression print
+
+      /// \param os The output stream
+      /// \param target_vars The target variable list for this expression
+      void print(ExprOStream& os, const VariableList& target_vars) const {
+        ExprEngine_::print(os, target_vars);
+        os.leaf(array_);
+      }
+
     }; // class LeafEngine
 
   }  // namespace expressions
@@ -39,6 +39,7 @@ namespace TiledArray {
     template <typename, typename, typename> class ScalMultExpr;
     template <typename, typename> class MultEngine;
     template <typename, typename, typename> class ScalMultEngine;
+    template <typename, typename, typename, typename> class MixedContEngine;
 
     template <typename Left, typename Right>
     struct EngineTrait<MultEngine<Left, Right> > {
@@ -112,6 +113,40 @@ namespace TiledArray {
     };
 
 
+    template <typename Left, typename Right, typename Scalar, typename Result>
+    struct EngineTrait<MixedContEngine<Left, Right, Scalar, Result> > {
+      static_assert(std::is_same<typename EngineTrait<Left>::policy,
+          typename EngineTrait<Right>::policy>::value,
+          "The left- and right-hand expressions must use the same policy class");
+
+      // Argument typedefs
+      typedef Left left_type; ///< The left-hand expression type
+      typedef Right right_type; ///< The right-hand expression type
+
+      // Operational typedefs
+      typedef Scalar scalar_type; ///< Tile scalar type
+      typedef Result value_type; ///< The result tile type
+      typedef typename eval_trait<value_type>::type eval_type;  ///< Evaluation tile type
+      typedef TiledArray::ScalMult<typename EngineTrait<Left>::eval_type,
+          typename EngineTrait<Right>::eval_type, scalar_type,
+          EngineTrait<Left>::consumable, EngineTrait<Right>::consumable> op_base_type; ///< The base tile operation type (unused)
+      typedef TiledArray::detail::BinaryWrapper<op_base_type> op_type; ///< The tile operation type (unused)
+      typedef typename Left::policy policy; ///< The result policy type
+      typedef TiledArray::detail::DistEval<value_type, policy> dist_eval_type; ///< The distributed evaluator type
+
+      // Meta data typedefs
+      typedef typename policy::size_type size_type; ///< Size type
+      typedef typename policy::trange_type trange_type; ///< Tiled range type
+      typedef typename policy::shape_type shape_type; ///< Shape type
+      typedef typename policy::pmap_interface pmap_interface; ///< Process map interface type
+
+      static constexpr bool consumable = is_consumable_tile<eval_type>::value;
+      static constexpr unsigned int leaves =
+          EngineTrait<Left>::leaves + EngineTrait<Right>::leaves;
+    };
+
+
+
     /// Multiplication expression engine
 
     /// \tparam Left The left-hand engine type
@@ -229,6 +264,14 @@ namespace TiledArray {
           BinaryEngine_::init_struct(target_vars);
       }
 
+      /// Restrict the arguments to the tiles of the result shape
+      void mask_args() {
+        if(contract_)
+          ContEngine_::mask_args();
+        else
+          BinaryEngine_::mask_args();
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
@@ -289,6 +332,21 @@ namespace TiledArray {
       /// \return The tile operation
       static op_type make_tile_op(const Permutation& perm) { return op_type(op_base_type(), perm); }
 
+      /// Accumulate the result of a contraction into an array
+
+      /// \tparam A The array type
+      /// \param array The array that is accumulated into
+      /// \return \c true if this is a contraction and its result will be
+      /// accumulated into \c array
+      template <typename A>
+      bool seed(const A& array) { return contract_ && ContEngine_::seed(array); }
+
+      /// Contraction flag accessor
+
+      /// \return \c true if this expression is a contraction, \c false if it
+      /// is an element-wise product
+      bool contract() const { return contract_; }
+
       /// Construct the distributed evaluator for this expression
 
       /// \return The distributed evaluator that will evaluate this expression
@@ -315,8 +373,49 @@ namespace TiledArray {
           return BinaryEngine_::print(os, target_vars);
       }
 
+      /// Estimate the cost of this expression
+
+      /// \param est The estimate that the nodes of this expression are added to
+      /// \return The peak intermediate memory of this expression on any
+      /// process
+      double estimate(ExprEstimate& est) const {
+        if(contract_)
+          return ContEngine_::estimate(est);
+        else
+          return BinaryEngine_::estimate(est);
+      }
+
     }; // class MultEngine
 
+    /// Fused kernel trait of a multiplication expression engine
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    template <typename Left, typename Right>
+    struct FusedKernel<MultEngine<Left, Right> > :
+      public FusedBinaryKernel<Left, Right, typename EngineTrait<MultEngine<Left, Right> >::value_type>
+    {
+      typedef MultEngine<Left, Right> engine_type;
+      typedef FusedBinaryKernel<Left, Right,
+          typename EngineTrait<engine_type>::value_type> FusedBinaryKernel_;
+      typedef TiledArray::detail::FusedMult<typename FusedKernel<Left>::type,
+          typename FusedKernel<Right>::type> type;
+
+      static bool fusable(const engine_type& engine, const VariableList& vars) {
+        return (! engine.contract()) && FusedBinaryKernel_::fusable(engine, vars);
+      }
+
+      template <typename Array>
+      static type make(const engine_type& engine, std::vector<Array>& args) {
+        // The argument order of the kernel is the order of the leaves
+        const typename FusedKernel<Left>::type left =
+            FusedKernel<Left>::make(engine.left(), args);
+        const typename FusedKernel<Right>::type right =
+            FusedKernel<Right>::make(engine.right(), args);
+        return type(left, right);
+      }
+    }; // struct FusedKernel
+
 
     /// Scaled multiplication expression engine
 
@@ -436,6 +535,14 @@ namespace TiledArray {
           BinaryEngine_::init_struct(target_vars);
       }
 
+      /// Restrict the arguments to the tiles of the result shape
+      void mask_args() {
+        if(contract_)
+          ContEngine_::mask_args();
+        else
+          BinaryEngine_::mask_args();
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
@@ -449,6 +556,26 @@ namespace TiledArray {
           BinaryEngine_::init_distribution(world, pmap);
       }
 
+      /// Accumulate the result of a contraction into an array
+
+      /// \tparam A The array type
+      /// \param array The array that is accumulated into
+      /// \return \c true if this is a contraction and its result will be
+      /// accumulated into \c array
+      template <typename A>
+      bool seed(const A& array) { return contract_ && ContEngine_::seed(array); }
+
+      /// Contraction flag accessor
+
+      /// \return \c true if this expression is a contraction, \c false if it
+      /// is an element-wise product
+      bool contract() const { return contract_; }
+
+      /// Scaling factor accessor
+
+      /// \return The scaling factor
+      scalar_type factor() const { return ContEngine_::factor_; }
+
       /// Construct the distributed evaluator for this expression
 
       /// \return The distributed evaluator that will evaluate this expression
@@ -532,8 +659,191 @@ namespace TiledArray {
           return BinaryEngine_::print(os, target_vars);
       }
 
+      /// Estimate the cost of this expression
+
+      /// \param est The estimate that the nodes of this expression are added to
+      /// \return The peak intermediate memory of this expression on any
+      /// process
+      double estimate(ExprEstimate& est) const {
+        if(contract_)
+          return ContEngine_::estimate(est);
+        else
+          return BinaryEngine_::estimate(est);
+      }
+
     }; // class ScalMultEngine
 
+    /// Fused kernel trait of a scaled multiplication expression engine
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam Scalar The scaling factor type
+    template <typename Left, typename Right, typename Scalar>
+    struct FusedKernel<ScalMultEngine<Left, Right, Scalar> > :
+      public FusedBinaryKernel<Left, Right, typename EngineTrait<ScalMultEngine<Left, Right, Scalar> >::value_type>
+    {
+      typedef ScalMultEngine<Left, Right, Scalar> engine_type;
+      typedef FusedBinaryKernel<Left, Right,
+          typename EngineTrait<engine_type>::value_type> FusedBinaryKernel_;
+      typedef TiledArray::detail::FusedScal<TiledArray::detail::FusedMult<
+          typename FusedKernel<Left>::type, typename FusedKernel<Right>::type>,
+          typename EngineTrait<engine_type>::scalar_type> type;
+
+      static bool fusable(const engine_type& engine, const VariableList& vars) {
+        return (! engine.contract()) && FusedBinaryKernel_::fusable(engine, vars);
+      }
+
+      template <typename Array>
+      static type make(const engine_type& engine, std::vector<Array>& args) {
+        // The argument order of the kernel is the order of the leaves
+        const typename FusedKernel<Left>::type left =
+            FusedKernel<Left>::make(engine.left(), args);
+        const typename FusedKernel<Right>::type right =
+            FusedKernel<Right>::make(engine.right(), args);
+        return type(TiledArray::detail::FusedMult<typename FusedKernel<Left>::type,
+            typename FusedKernel<Right>::type>(left, right), engine.factor());
+      }
+    }; // struct FusedKernel
+
+
+    /// Mixed precision contraction expression engine
+
+    /// The argument tiles are contracted with their own precision, and the
+    /// contracted tiles are accumulated in \c Result tiles, e.g. single
+    /// precision arrays are contracted with sgemm and summed in double
+    /// precision. The argument tiles are broadcast with their own precision,
+    /// so the memory and communication of the arguments are not increased.
+    /// This engine is used when a contraction is assigned to an array with a
+    /// different tile type than that of the contraction.
+    /// \tparam Left The left-hand engine type
+    /// \tparam Right The Right-hand engine type
+    /// \tparam Scalar The scaling factor type
+    /// \tparam Result The result tile type
+    template <typename Left, typename Right, typename Scalar, typename Result>
+    class MixedContEngine :
+        public ContEngine<MixedContEngine<Left, Right, Scalar, Result> >
+    {
+    public:
+      // Class hierarchy typedefs
+      typedef MixedContEngine<Left, Right, Scalar, Result> MixedContEngine_; ///< This class type
+      typedef ContEngine<MixedContEngine_> ContEngine_; ///< Contraction engine base class
+      typedef BinaryEngine<MixedContEngine_> BinaryEngine_; ///< Binary base class type
+
+      // Argument typedefs
+      typedef typename EngineTrait<MixedContEngine_>::left_type left_type; ///< The left-hand expression type
+      typedef typename EngineTrait<MixedContEngine_>::right_type right_type; ///< The right-hand expression type
+
+      // Operational typedefs
+      typedef typename EngineTrait<MixedContEngine_>::value_type value_type; ///< The result tile type
+      typedef typename EngineTrait<MixedContEngine_>::scalar_type scalar_type; ///< Tile scalar type
+      typedef typename EngineTrait<MixedContEngine_>::policy policy; ///< The result policy type
+      typedef typename EngineTrait<MixedContEngine_>::dist_eval_type dist_eval_type; ///< The distributed evaluator type
+
+      // Meta data typedefs
+      typedef typename EngineTrait<MixedContEngine_>::size_type size_type; ///< Size type
+      typedef typename EngineTrait<MixedContEngine_>::trange_type trange_type; ///< Tiled range type
+      typedef typename EngineTrait<MixedContEngine_>::shape_type shape_type; ///< Shape type
+      typedef typename EngineTrait<MixedContEngine_>::pmap_interface pmap_interface; ///< Process map interface type
+
+    private:
+
+      /// Check that the arguments are contracted
+
+      /// \throw TiledArray::Exception When the expression is a Hadamard
+      /// product
+      void check_contraction() const {
+        if(BinaryEngine_::left_.vars().is_permutation(BinaryEngine_::right_.vars()))
+          TA_EXCEPTION("A Hadamard product can not be assigned to an array "
+              "with a different tile type.");
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \tparam L The left-hand argument expression type
+      /// \tparam R The right-hand argument expression type
+      /// \param expr The parent expression
+      template <typename L, typename R>
+      MixedContEngine(const MultExpr<L, R>& expr) : ContEngine_(expr) { }
+
+      /// Constructor
+
+      /// \tparam L The left-hand argument expression type
+      /// \tparam R The right-hand argument expression type
+      /// \tparam S The expression scalar type
+      /// \param expr The parent expression
+      template <typename L, typename R, typename S>
+      MixedContEngine(const ScalMultExpr<L, R, S>& expr) : ContEngine_(expr) { }
+
+      /// Initialize the variable list of this expression
+
+      /// \param target_vars The target variable list for this expression
+      /// \throw TiledArray::Exception When the expression is a Hadamard
+      /// product
+      void init_vars(const VariableList& target_vars) {
+        BinaryEngine_::left_.init_vars();
+        BinaryEngine_::right_.init_vars();
+        check_contraction();
+        ContEngine_::init_vars();
+        ContEngine_::perm_vars(target_vars);
+      }
+
+      /// Initialize the variable list of this expression
+
+      /// \throw TiledArray::Exception When the expression is a Hadamard
+      /// product
+      void init_vars() {
+        BinaryEngine_::left_.init_vars();
+        BinaryEngine_::right_.init_vars();
+        check_contraction();
+        ContEngine_::init_vars();
+      }
+
+    }; // class MixedContEngine
+
+    namespace detail {
+
+      /// Mixed precision contraction trait
+
+      /// \tparam Engine The engine type of the expression
+      /// \tparam Tile The tile type of the result array
+      template <typename Engine, typename Tile>
+      struct is_mixed_contraction :
+          public std::integral_constant<bool,
+              (! std::is_same<typename EngineTrait<Engine>::value_type, Tile>::value) &&
+              TiledArray::detail::is_tensor<typename EngineTrait<Engine>::value_type>::value &&
+              TiledArray::detail::is_tensor<Tile>::value>
+      { };
+
+      template <typename Left, typename Right, typename Tile>
+      struct result_engine<MultEngine<Left, Right>, Tile> {
+        typedef MultEngine<Left, Right> engine_type;
+        typedef typename std::conditional<is_mixed_contraction<engine_type, Tile>::value,
+            MixedContEngine<Left, Right, typename EngineTrait<engine_type>::scalar_type, Tile>,
+            engine_type>::type type;
+      };
+
+      template <typename Left, typename Right, typename Scalar, typename Tile>
+      struct result_engine<ScalMultEngine<Left, Right, Scalar>, Tile> {
+        typedef ScalMultEngine<Left, Right, Scalar> engine_type;
+        typedef typename std::conditional<is_mixed_contraction<engine_type, Tile>::value,
+            MixedContEngine<Left, Right, Scalar, Tile>, engine_type>::type type;
+      };
+
+      template <typename Left, typename Right, typename Tile>
+      struct can_accumulate<MultEngine<Left, Right>, Tile> :
+          public std::is_same<typename EngineTrait<MultEngine<Left, Right> >::value_type, Tile>
+      { };
+
+      template <typename Left, typename Right, typename Scalar, typename Tile>
+      struct can_accumulate<ScalMultEngine<Left, Right, Scalar>, Tile> :
+          public std::is_same<typename EngineTrait<ScalMultEngine<Left, Right,
+              Scalar> >::value_type, Tile>
+      { };
+
+    } // namespace detail
+
   }  // namespace expressions
 } // namespace TiledArray
 
@@ -28,6 +28,7 @@
 
 #include <TiledArray/expressions/binary_expr.h>
 #include <TiledArray/expressions/mult_engine.h>
+#include <TiledArray/expressions/policy_cast_engine.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -49,8 +50,11 @@ namespace TiledArray {
     struct ExprTrait<MultExpr<Left, Right> > {
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
-      typedef MultEngine<typename ExprTrait<Left>::engine_type,
+      typedef common_policy_engines<typename ExprTrait<Left>::engine_type,
           typename ExprTrait<Right>::engine_type>
+          arg_engines; ///< The argument engines with the result policy
+      typedef MultEngine<typename arg_engines::left_type,
+          typename arg_engines::right_type>
           engine_type; ///< Expression engine type
       typedef numeric_t<typename EngineTrait<engine_type>::eval_type>
           numeric_type; ///< Multiplication result numeric type
@@ -62,8 +66,11 @@ namespace TiledArray {
     struct ExprTrait<ScalMultExpr<Left, Right, Scalar> > {
       typedef Left left_type; ///< The left-hand expression type
       typedef Right right_type; ///< The right-hand expression type
-      typedef ScalMultEngine<typename ExprTrait<Left>::engine_type,
-          typename ExprTrait<Right>::engine_type, Scalar> engine_type; ///< Expression engine type
+      typedef common_policy_engines<typename ExprTrait<Left>::engine_type,
+          typename ExprTrait<Right>::engine_type>
+          arg_engines; ///< The argument engines with the result policy
+      typedef ScalMultEngine<typename arg_engines::left_type,
+          typename arg_engines::right_type, Scalar> engine_type; ///< Expression engine type
       typedef numeric_t<typename EngineTrait<engine_type>::eval_type>
           numeric_type; ///< Multiplication result numeric type
       typedef Scalar scalar_type;  ///< Tile scalar type
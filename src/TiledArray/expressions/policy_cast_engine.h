@@ -0,0 +1,237 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2014  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  policy_cast_engine.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_POLICY_CAST_ENGINE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_POLICY_CAST_ENGINE_H__INCLUDED
+
+#include <cmath>
+#include <limits>
+#include <TiledArray/expressions/unary_engine.h>
+#include <TiledArray/policies/dense_policy.h>
+#include <TiledArray/policies/sparse_policy.h>
+#include <TiledArray/tile_op/noop.h>
+#include <TiledArray/tile_op/unary_wrapper.h>
+
+namespace TiledArray {
+  namespace expressions {
+
+    // Forward declarations
+    template <typename, typename> class PolicyCastEngine;
+
+    /// Result policy of a binary expression
+
+    /// The result of an expression with a dense and a sparse argument is
+    /// sparse. Other combinations of different policies are not supported.
+    /// \tparam Left The policy of the left-hand argument
+    /// \tparam Right The policy of the right-hand argument
+    template <typename Left, typename Right>
+    struct result_policy;
+
+    template <typename Policy>
+    struct result_policy<Policy, Policy> {
+      typedef Policy type;
+    };
+
+    template <>
+    struct result_policy<DensePolicy, SparsePolicy> {
+      typedef SparsePolicy type;
+    };
+
+    template <>
+    struct result_policy<SparsePolicy, DensePolicy> {
+      typedef SparsePolicy type;
+    };
+
+    /// The engine that evaluates an argument with the given policy
+
+    /// \tparam Engine The argument expression engine type
+    /// \tparam Policy The policy of the result
+    template <typename Engine, typename Policy>
+    struct policy_cast_engine {
+      typedef typename std::conditional<std::is_same<
+          typename EngineTrait<Engine>::policy, Policy>::value, Engine,
+          PolicyCastEngine<Engine, Policy> >::type type;
+    };
+
+    /// The engines of the arguments of a binary expression with a common policy
+
+    /// \tparam Left The left-hand expression engine type
+    /// \tparam Right The right-hand expression engine type
+    template <typename Left, typename Right>
+    struct common_policy_engines {
+      typedef typename result_policy<typename EngineTrait<Left>::policy,
+          typename EngineTrait<Right>::policy>::type policy; ///< The result policy type
+      typedef typename policy_cast_engine<Left, policy>::type left_type; ///< The left-hand engine type
+      typedef typename policy_cast_engine<Right, policy>::type right_type; ///< The right-hand engine type
+    };
+
+
+    template <typename Arg, typename Policy>
+    struct EngineTrait<PolicyCastEngine<Arg, Policy> > {
+      static_assert(std::is_same<typename EngineTrait<Arg>::policy, DensePolicy>::value &&
+          std::is_same<Policy, SparsePolicy>::value,
+          "Only dense expressions can be evaluated with the sparse policy");
+
+      // Argument typedefs
+      typedef Arg argument_type; ///< The argument expression engine type
+
+      // Operational typedefs
+      typedef typename EngineTrait<Arg>::scalar_type scalar_type; ///< Tile scalar type
+      typedef typename EngineTrait<Arg>::eval_type value_type; ///< The result tile type
+      typedef typename eval_trait<value_type>::type eval_type;  ///< Evaluation tile type
+      typedef TiledArray::Noop<typename EngineTrait<Arg>::eval_type,
+          EngineTrait<Arg>::consumable> op_base_type; ///< The tile base operation type
+      typedef TiledArray::detail::UnaryWrapper<op_base_type> op_type; ///< The tile operation type
+      typedef Policy policy; ///< The result policy type
+      typedef TiledArray::detail::DistEval<value_type, policy> dist_eval_type; ///< The distributed evaluator type
+
+      // Meta data typedefs
+      typedef typename policy::size_type size_type; ///< Size type
+      typedef typename policy::trange_type trange_type; ///< Tiled range type
+      typedef typename policy::shape_type shape_type; ///< Shape type
+      typedef typename policy::pmap_interface pmap_interface; ///< Process map interface type
+
+      static constexpr bool consumable = EngineTrait<Arg>::consumable;
+      static constexpr unsigned int leaves = EngineTrait<Arg>::leaves;
+    };
+
+
+    /// Policy conversion expression engine
+
+    /// Evaluates a dense expression as an argument of a sparse expression,
+    /// e.g. the dense operand of a contraction with a sparse array, without
+    /// converting the dense array first. The tiles are passed through
+    /// unchanged. The norms of the tiles are not computed; every tile is
+    /// non-zero with a placeholder norm (see \c norm_bound() ), so the
+    /// result shape of a contraction keeps every tile that is not screened
+    /// out by the sparse argument. The norms of the result can be
+    /// recomputed with \c truncate() .
+    /// \tparam Arg The argument expression engine type
+    /// \tparam Policy The result policy type
+    template <typename Arg, typename Policy>
+    class PolicyCastEngine : public UnaryEngine<PolicyCastEngine<Arg, Policy> > {
+    public:
+      // Class hierarchy typedefs
+      typedef PolicyCastEngine<Arg, Policy> PolicyCastEngine_; ///< This class type
+      typedef UnaryEngine<PolicyCastEngine_> UnaryEngine_; ///< Unary expression engine base type
+      typedef typename UnaryEngine_::ExprEngine_ ExprEngine_; ///< Expression engine base type
+
+      // Argument typedefs
+      typedef typename EngineTrait<PolicyCastEngine_>::argument_type argument_type; ///< The argument expression engine type
+
+      // Operational typedefs
+      typedef typename EngineTrait<PolicyCastEngine_>::value_type value_type; ///< The result tile type
+      typedef typename EngineTrait<PolicyCastEngine_>::op_base_type op_base_type; ///< The tile base operation type
+      typedef typename EngineTrait<PolicyCastEngine_>::op_type op_type; ///< The tile operation type
+      typedef typename EngineTrait<PolicyCastEngine_>::policy policy; ///< The result policy type
+      typedef typename EngineTrait<PolicyCastEngine_>::dist_eval_type dist_eval_type; ///< The distributed evaluator type
+
+      // Meta data typedefs
+      typedef typename EngineTrait<PolicyCastEngine_>::size_type size_type; ///< Size type
+      typedef typename EngineTrait<PolicyCastEngine_>::trange_type trange_type; ///< Tiled range type
+      typedef typename EngineTrait<PolicyCastEngine_>::shape_type shape_type; ///< Shape type
+      typedef typename EngineTrait<PolicyCastEngine_>::pmap_interface pmap_interface; ///< Process map interface type
+
+    private:
+
+      /// Shape with the placeholder norm in every tile
+
+      /// \param trange The tiled range of the shape
+      /// \return A shape where every tile is non-zero
+      static shape_type make_bound_shape(const trange_type& trange) {
+        typedef typename shape_type::value_type norm_type;
+        const auto& tiles_range = trange.tiles_range();
+        Tensor<norm_type> tile_norms(tiles_range);
+        for(std::size_t i = 0ul; i < tiles_range.volume(); ++i)
+          tile_norms[i] = norm_bound() * norm_type(trange.make_tile_range(i).volume());
+        return shape_type(tile_norms, trange);
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \tparam D The argument expression type
+      /// \param expr The argument expression
+      template <typename D>
+      PolicyCastEngine(const Expr<D>& expr) :
+        UnaryEngine_(expr, typename UnaryEngine_::arg_expr_tag())
+      { }
+
+      /// Placeholder norm of the tiles of the dense argument
+
+      /// The norm is large enough that no product with a non-zero tile is
+      /// screened out, and small enough that products of a few bounds stay
+      /// finite.
+      /// \return The per-element norm of every tile
+      static float norm_bound() {
+        return std::sqrt(std::sqrt(std::numeric_limits<float>::max()));
+      }
+
+      /// Non-permuting shape factory function
+
+      /// \return The result shape
+      shape_type make_shape() const {
+        return make_bound_shape(UnaryEngine_::arg_.trange());
+      }
+
+      /// Permuting shape factory function
+
+      /// \param perm The permutation to be applied to the array
+      /// \return The result shape
+      shape_type make_shape(const Permutation& perm) const {
+        return make_bound_shape(perm ^ UnaryEngine_::arg_.trange());
+      }
+
+      /// Restrict the argument to the tiles of the result shape
+
+      /// Every tile of a dense argument is evaluated, so there is nothing to
+      /// restrict.
+      void mask_args() { }
+
+      /// Non-permuting tile operation factory function
+
+      /// \return The tile operation
+      op_type make_tile_op() const { return op_type(op_base_type()); }
+
+      /// Permuting tile operation factory function
+
+      /// \param perm The permutation to be applied to tiles
+      /// \return The tile operation
+      op_type make_tile_op(const Permutation& perm) const {
+        return op_type(op_base_type(), perm);
+      }
+
+      /// Expression identification tag
+
+      /// \return An expression tag used to identify this expression
+      const char* make_tag() const { return "[sparse] "; }
+
+    }; // class PolicyCastEngine
+
+  }  // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_POLICY_CAST_ENGINE_H__INCLUDED
@@ -82,6 +82,7 @@ namespace TiledArray {
       // Operational typedefs
       typedef typename EngineTrait<ScalEngine_>::value_type value_type; ///< The result tile type
       typedef typename EngineTrait<ScalEngine_>::scalar_type scalar_type; ///< Tile scalar type
+      typedef typename EngineTrait<ScalEngine_>::op_base_type op_base_type; ///< The tile base operation type
       typedef typename EngineTrait<ScalEngine_>::op_type op_type; ///< The tile operation type
       typedef typename EngineTrait<ScalEngine_>::policy policy; ///< The result policy type
       typedef typename EngineTrait<ScalEngine_>::dist_eval_type dist_eval_type; ///< The distributed evaluator type
@@ -95,6 +96,8 @@ namespace TiledArray {
     private:
 
       scalar_type factor_; ///< Scaling factor
+      scalar_type op_factor_; ///< Scaling factor applied by the tile operation
+      bool folded_; ///< If true, the factor is applied by the consumer
 
     public:
 
@@ -104,7 +107,24 @@ namespace TiledArray {
       /// \tparam S The expression scalar type
       /// \param expr The parent expression
       template <typename A, typename S>
-      ScalEngine(const ScalExpr<A, S>& expr) : UnaryEngine_(expr), factor_(expr.factor()) { }
+      ScalEngine(const ScalExpr<A, S>& expr) :
+        UnaryEngine_(expr), factor_(expr.factor()), op_factor_(factor_),
+        folded_(false)
+      { }
+
+      /// Initialize result tensor structure
+
+      /// When the tiles of this expression are permuted, the scaling factor of
+      /// a scaled argument is folded into the permute-scale operation, so both
+      /// factors and the permutation are applied in one pass. The argument
+      /// shape is already scaled, so the shape uses \c factor_ only.
+      /// \param target_vars The target variable list for the result tensor
+      void init_struct(const VariableList& target_vars) {
+        UnaryEngine_::init_struct(target_vars);
+        op_factor_ = factor_;
+        if(ExprEngine_::perm_ && ExprEngine_::permute_tiles_)
+          expressions::fold_factor(op_factor_, UnaryEngine_::arg_);
+      }
 
       /// Non-permuting shape factory function
 
@@ -124,13 +144,48 @@ namespace TiledArray {
       /// Non-permuting tile operation factory function
 
       /// \return The tile operation
-      op_type make_tile_op() const { return op_type(factor_); }
+      op_type make_tile_op() const {
+        return op_type(op_base_type(op_factor_, folded_));
+      }
 
       /// Permuting tile operation factory function
 
       /// \param perm The permutation to be applied to tiles
       /// \return The tile operation
-      op_type make_tile_op(const Permutation& perm) const { return op_type(perm, factor_); }
+      op_type make_tile_op(const Permutation& perm) const {
+        return op_type(op_base_type(op_factor_), perm);
+      }
+
+      /// Scaling factor accessor
+
+      /// \return The scaling factor
+      scalar_type factor() const { return factor_; }
+
+      /// Fold the scaling factor into the consuming operation
+
+      /// After this call the argument tiles are passed to the consumer
+      /// unscaled, and the consumer must apply the returned factor itself
+      /// (e.g. as the GEMM \c alpha ). The returned factor includes the
+      /// factors of nested scaled arguments. The factor is only folded when
+      /// tiles are not permuted, since a permuted copy is required in any
+      /// case. This must be called after \c init_struct() , and the shape is
+      /// unaffected.
+      /// \return The factor that the consumer must apply
+      scalar_type fold_factor() {
+        if((ExprEngine_::perm_ && ExprEngine_::permute_tiles_) ||
+            ! std::is_same<typename op_base_type::result_type,
+                typename op_base_type::argument_type>::value)
+          return scalar_type(1);
+        folded_ = true;
+        scalar_type factor = factor_;
+        expressions::fold_factor(factor, UnaryEngine_::arg_);
+        return factor;
+      }
+
+      /// Folded factor flag accessor
+
+      /// \return \c true if the factor is applied by the consumer
+      bool folded() const { return folded_; }
 
       /// Expression identification tag
 
@@ -143,6 +198,32 @@ namespace TiledArray {
 
     }; // class ScalEngine
 
+    /// Fused kernel trait of a scaling expression engine
+
+    /// \tparam Arg The argument expression type
+    /// \tparam Scalar The scaling factor type
+    template <typename Arg, typename Scalar>
+    struct FusedKernel<ScalEngine<Arg, Scalar> > {
+      typedef ScalEngine<Arg, Scalar> engine_type;
+      static constexpr bool value = FusedKernel<Arg>::value &&
+          std::is_same<typename FusedKernel<Arg>::tile_type,
+              typename EngineTrait<engine_type>::value_type>::value;
+      typedef typename FusedKernel<Arg>::tile_type tile_type;
+      typedef TiledArray::detail::FusedScal<typename FusedKernel<Arg>::type,
+          typename EngineTrait<engine_type>::scalar_type> type;
+
+      static bool fusable(const engine_type& engine, const VariableList& vars) {
+        return (! engine.perm()) && (! engine.folded()) &&
+            (engine.vars() == vars) &&
+            FusedKernel<Arg>::fusable(engine.arg(), vars);
+      }
+
+      template <typename Array>
+      static type make(const engine_type& engine, std::vector<Array>& args) {
+        return type(FusedKernel<Arg>::make(engine.arg(), args), engine.factor());
+      }
+    }; // struct FusedKernel
+
 
   }  // namespace expressions
 } // namespace TiledArray
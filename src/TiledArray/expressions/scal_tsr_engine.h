@@ -31,6 +31,10 @@
 #include <TiledArray/tile_op/unary_wrapper.h>
 
 namespace TiledArray {
+
+  // Forward declaration
+  template <typename, typename> class Tensor;
+
   namespace expressions {
 
     template <typename, typename> class ScalTsrExpr;
@@ -96,12 +100,13 @@ namespace TiledArray {
     private:
 
       scalar_type factor_; ///< The scaling factor
+      bool folded_; ///< If true, the factor is applied by the consumer
 
     public:
 
       template <typename A, typename S>
       ScalTsrEngine(const ScalTsrExpr<A, S>& expr) :
-        LeafEngine_(expr), factor_(expr.factor())
+        LeafEngine_(expr), factor_(expr.factor()), folded_(false)
       { }
 
       /// Non-permuting shape factory function
@@ -121,7 +126,7 @@ namespace TiledArray {
 
       /// \return The tile operation
       op_type make_tile_op() const {
-        return op_type(op_base_type(factor_));
+        return op_type(op_base_type(factor_, folded_));
       }
 
       /// Permuting tile operation factory function
@@ -132,6 +137,44 @@ namespace TiledArray {
         return op_type(op_base_type(factor_), perm);
       }
 
+      /// Scaling factor accessor
+
+      /// \return The scaling factor
+      scalar_type factor() const { return factor_; }
+
+      /// Fold the scaling factor into the consuming operation
+
+      /// After this call the tiles of this expression are passed to the
+      /// consumer unscaled, without an intermediate copy, and the consumer
+      /// must apply the returned factor itself (e.g. as the GEMM \c alpha ).
+      /// The factor is only folded when tiles are not permuted, since a
+      /// permuted copy is required in any case. This must be called after
+      /// \c init_struct() , and the shape is unaffected.
+      /// \return The factor that the consumer must apply
+      scalar_type fold_factor() {
+        if(! fold())
+          return scalar_type(1);
+        return factor_;
+      }
+
+      /// Fold the tile operation into the consuming operation
+
+      /// After a successful call the tiles of this expression are passed to
+      /// the consumer unmodified, and the consumer must apply \c factor()
+      /// itself (e.g. a complex conjugate as a BLAS \c ConjTrans operation).
+      /// The operation is only folded when tiles are not permuted and the
+      /// tile operation does not change the tile type. This must be called
+      /// after \c init_struct() , and the shape is unaffected.
+      /// \return \c true if the operation was folded
+      bool fold() {
+        if((ExprEngine_::perm_ && ExprEngine_::permute_tiles_) ||
+            ! std::is_same<typename op_base_type::result_type,
+                typename op_base_type::argument_type>::value)
+          return false;
+        folded_ = true;
+        return true;
+      }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -143,6 +186,33 @@ namespace TiledArray {
 
     }; // class ScalTsrEngine
 
+    /// Fused kernel trait of a scaled tensor expression engine
+
+    /// \tparam T The tensor element type
+    /// \tparam A The tensor allocator type
+    /// \tparam Policy The array policy type
+    /// \tparam Scalar The scaling factor type
+    template <typename T, typename A, typename Policy, typename Scalar>
+    struct FusedKernel<ScalTsrEngine<DistArray<Tensor<T, A>, Policy>, Scalar> > {
+      typedef ScalTsrEngine<DistArray<Tensor<T, A>, Policy>, Scalar> engine_type;
+      static constexpr bool value = TiledArray::detail::is_numeric<T>::value;
+      typedef Tensor<T, A> tile_type;
+      typedef TiledArray::detail::FusedScal<TiledArray::detail::FusedArg<T>,
+          Scalar> type;
+
+      static bool fusable(const engine_type& engine, const VariableList& vars) {
+        return (! engine.perm()) && (engine.vars() == vars);
+      }
+
+      static type make(const engine_type& engine,
+          std::vector<DistArray<tile_type, Policy> >& args)
+      {
+        args.push_back(engine.array());
+        return type(TiledArray::detail::FusedArg<T>(args.size() - 1u),
+            engine.factor());
+      }
+    }; // struct FusedKernel
+
   }  // namespace expressions
 } // namespace TiledArray
 
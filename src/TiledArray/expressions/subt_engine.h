@@ -179,6 +179,31 @@ namespace TiledArray {
 
     }; // class SubtEngine
 
+    /// Fused kernel trait of a subtraction expression engine
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    template <typename Left, typename Right>
+    struct FusedKernel<SubtEngine<Left, Right> > :
+      public FusedBinaryKernel<Left, Right, typename EngineTrait<SubtEngine<Left, Right> >::value_type>
+    {
+      typedef SubtEngine<Left, Right> engine_type;
+      typedef FusedBinaryKernel<Left, Right,
+          typename EngineTrait<engine_type>::value_type> FusedBinaryKernel_;
+      typedef TiledArray::detail::FusedSubt<typename FusedKernel<Left>::type,
+          typename FusedKernel<Right>::type> type;
+
+      template <typename Array>
+      static type make(const engine_type& engine, std::vector<Array>& args) {
+        // The argument order of the kernel is the order of the leaves
+        const typename FusedKernel<Left>::type left =
+            FusedKernel<Left>::make(engine.left(), args);
+        const typename FusedKernel<Right>::type right =
+            FusedKernel<Right>::make(engine.right(), args);
+        return type(left, right);
+      }
+    }; // struct FusedKernel
+
 
     /// Subtraction expression engine
 
@@ -257,6 +282,11 @@ namespace TiledArray {
         return op_type(op_base_type(factor_), perm);
       }
 
+      /// Scaling factor accessor
+
+      /// \return The scaling factor
+      scalar_type factor() const { return factor_; }
+
       /// Expression identification tag
 
       /// \return An expression tag used to identify this expression
@@ -268,6 +298,34 @@ namespace TiledArray {
 
     }; // class ScalSubtEngine
 
+    /// Fused kernel trait of a scaled subtraction expression engine
+
+    /// \tparam Left The left-hand expression type
+    /// \tparam Right The right-hand expression type
+    /// \tparam Scalar The scaling factor type
+    template <typename Left, typename Right, typename Scalar>
+    struct FusedKernel<ScalSubtEngine<Left, Right, Scalar> > :
+      public FusedBinaryKernel<Left, Right, typename EngineTrait<ScalSubtEngine<Left, Right, Scalar> >::value_type>
+    {
+      typedef ScalSubtEngine<Left, Right, Scalar> engine_type;
+      typedef FusedBinaryKernel<Left, Right,
+          typename EngineTrait<engine_type>::value_type> FusedBinaryKernel_;
+      typedef TiledArray::detail::FusedScal<TiledArray::detail::FusedSubt<
+          typename FusedKernel<Left>::type, typename FusedKernel<Right>::type>,
+          typename EngineTrait<engine_type>::scalar_type> type;
+
+      template <typename Array>
+      static type make(const engine_type& engine, std::vector<Array>& args) {
+        // The argument order of the kernel is the order of the leaves
+        const typename FusedKernel<Left>::type left =
+            FusedKernel<Left>::make(engine.left(), args);
+        const typename FusedKernel<Right>::type right =
+            FusedKernel<Right>::make(engine.right(), args);
+        return type(TiledArray::detail::FusedSubt<typename FusedKernel<Left>::type,
+            typename FusedKernel<Right>::type>(left, right), engine.factor());
+      }
+    }; // struct FusedKernel
+
   }  // namespace expressions
 } // namespace TiledArray
 
@@ -0,0 +1,490 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  sum_schedule.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_EXPRESSIONS_SUM_SCHEDULE_H__INCLUDED
+#define TILEDARRAY_EXPRESSIONS_SUM_SCHEDULE_H__INCLUDED
+
+#include <TiledArray/expressions/tsr_expr.h>
+#include <TiledArray/dist_eval/summa_depth.h>
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace TiledArray {
+  namespace expressions {
+
+    /// Memory scheduling policy of sums
+
+    /// The terms of a sum, e.g. <tt>r("i,j") = a("i,k") * b("k,j") +
+    /// c("i,k,l") * d("k,l,j") - e("i,j")</tt> , are evaluated concurrently.
+    /// A sum with two or more product terms is evaluated in one pass: the
+    /// first product is assigned to the result, the other products are
+    /// accumulated into its tiles by their reduce tasks, and the remaining
+    /// terms are added last, so the products share one result tile set
+    /// instead of each allocating its own result. The intermediates of all
+    /// terms are still allocated at the same time.
+    ///
+    /// When a memory cap is set, the terms of a sum are instead evaluated in
+    /// batches whose intermediates fit within the cap. The memory of each
+    /// term is estimated from the shapes of its arguments (see
+    /// \c Expr::estimate() ), plus the size of the result for terms that are
+    /// added with a temporary. The terms are packed into batches in
+    /// decreasing order of their memory (first fit), the terms of a batch
+    /// are evaluated concurrently and accumulated into the result, and the
+    /// intermediates of a batch are released before the next batch starts.
+    /// A term that does not fit within the cap is evaluated alone. Sums that
+    /// fit within the cap are evaluated in one pass, or as usual.
+    ///
+    /// The cap is given in bytes per process by the \c TA_SUM_MEMORY_CAP
+    /// environment variable, in the format of \c TA_SUMMA_MAX_MEMORY , or by
+    /// \c set_memory_cap() ; it should exclude the memory of the arrays that
+    /// are already allocated. There is no cap by default.
+    /// \note Asynchronous assignments (e.g. in an \c AsyncEval scope) are not
+    /// scheduled, since the batches of a scheduled sum are waited on. Sums
+    /// with evaluation parameters (e.g. \c Expr::set_shape() ) are not
+    /// scheduled either, since the terms are evaluated separately.
+    class SumSchedule {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      size_type memory_cap_; ///< The memory cap (0 = no cap)
+      bool active_; ///< A sum is being scheduled
+
+      SumSchedule() :
+        memory_cap_(TiledArray::detail::SummaDepthController::parse_memory(
+            getenv("TA_SUM_MEMORY_CAP"))),
+        active_(false)
+      { }
+
+      SumSchedule(const SumSchedule&) = delete;
+      SumSchedule& operator=(const SumSchedule&) = delete;
+
+    public:
+
+      /// Scheduling policy accessor
+
+      /// \return A reference to the scheduling policy of this process
+      static SumSchedule& instance() {
+        static SumSchedule* const schedule = new SumSchedule();
+        return *schedule;
+      }
+
+      /// \return The memory cap, in bytes per process, or zero if sums are
+      /// not scheduled
+      size_type memory_cap() const { return memory_cap_; }
+
+      /// Set the memory cap
+
+      /// \param bytes The memory cap, in bytes per process, or zero to not
+      /// schedule sums
+      void set_memory_cap(const size_type bytes) { memory_cap_ = bytes; }
+
+      /// \return \c true if a sum is being scheduled by this process
+      bool active() const { return active_; }
+
+      /// Set the scheduling flag
+
+      /// The terms of a scheduled sum are not scheduled again.
+      /// \param active \c true while a sum is being scheduled
+      void active(const bool active) { active_ = active; }
+
+    }; // class SumSchedule
+
+    namespace detail {
+
+      /// Array expression trait
+
+      /// \tparam D The expression type
+      template <typename D>
+      struct is_array_expr : public std::false_type { };
+
+      template <typename A, bool Alias>
+      struct is_array_expr<TsrExpr<A, Alias> > : public std::true_type { };
+
+      /// A term of a sum
+
+      /// \tparam A The result array type
+      template <typename A>
+      class SumTerm {
+      public:
+        virtual ~SumTerm() { }
+
+        /// Estimate the cost of the term
+
+        /// \param tsr The result expression
+        /// \return The estimate of the term
+        virtual ExprEstimate estimate(const TsrExpr<A, true>& tsr) const = 0;
+
+        /// \return \c true if the term may be added to the result in place
+        virtual bool accumulates() const = 0;
+
+        /// \return \c true if the result tiles of the term are not shared
+        /// with an array
+        virtual bool fresh() const = 0;
+
+        /// Assign the term
+
+        /// \param tsr The result expression
+        virtual void assign(TsrExpr<A, true>& tsr) const = 0;
+
+        /// Add the term to the tiles of the result
+
+        /// \param tsr The result expression
+        /// \return \c true if the term was added in place
+        virtual bool accumulate(TsrExpr<A, false>& tsr) const = 0;
+
+        /// Add the term to the result with a temporary
+
+        /// \param tsr The result expression
+        virtual void add(TsrExpr<A, true>& tsr) const = 0;
+
+      }; // class SumTerm
+
+      /// A term expression of a sum
+
+      /// \tparam A The result array type
+      /// \tparam D The term expression type
+      template <typename A, typename D>
+      class SumTermImpl : public SumTerm<A> {
+        D expr_; ///< The term
+        bool negate_; ///< The term is subtracted
+
+      public:
+
+        /// Constructor
+
+        /// \param expr The term
+        /// \param negate \c true if the term is subtracted
+        SumTermImpl(const D& expr, const bool negate) :
+          expr_(expr), negate_(negate)
+        { }
+
+        virtual ~SumTermImpl() { }
+
+        virtual ExprEstimate estimate(const TsrExpr<A, true>& tsr) const {
+          return expr_.estimate(tsr);
+        }
+
+        virtual bool accumulates() const {
+          return can_accumulate<typename ExprTrait<D>::engine_type,
+              typename A::value_type>::value;
+        }
+
+        virtual bool fresh() const { return ! is_array_expr<D>::value; }
+
+        virtual void assign(TsrExpr<A, true>& tsr) const {
+          if(negate_)
+            (-expr_).eval_to(tsr, true);
+          else
+            expr_.eval_to(tsr, true);
+        }
+
+        virtual bool accumulate(TsrExpr<A, false>& tsr) const {
+          return (negate_ ? (-expr_).accumulate_to(tsr, true) :
+              expr_.accumulate_to(tsr, true));
+        }
+
+        virtual void add(TsrExpr<A, true>& tsr) const {
+          if(negate_)
+            (tsr - expr_).eval_to(tsr, true);
+          else
+            (tsr + expr_).eval_to(tsr, true);
+        }
+
+      }; // class SumTermImpl
+
+      /// The terms of a sum
+
+      /// \tparam A The result array type
+      template <typename A>
+      class SumTerms {
+        std::vector<std::shared_ptr<SumTerm<A> > > terms_; ///< The terms
+
+        /// Collect a term
+
+        /// \tparam D The term expression type
+        /// \param expr The term
+        /// \param negate \c true if the term is subtracted
+        template <typename D>
+        void collect(const Expr<D>& expr, const bool negate) {
+          terms_.push_back(std::make_shared<SumTermImpl<A, D> >(expr.derived(), negate));
+        }
+
+        /// Collect the terms of a sum
+
+        /// \tparam Left The left-hand expression type
+        /// \tparam Right The right-hand expression type
+        /// \param expr The sum
+        /// \param negate \c true if the sum is subtracted
+        template <typename Left, typename Right>
+        void collect(const AddExpr<Left, Right>& expr, const bool negate) {
+          if(expr.has_override()) {
+            // The sum is evaluated as one term with its parameters
+            terms_.push_back(std::make_shared<SumTermImpl<A, AddExpr<Left, Right> > >(
+                expr, negate));
+            return;
+          }
+          collect(expr.left(), negate);
+          collect(expr.right(), negate);
+        }
+
+        /// Collect the terms of a difference
+
+        /// \tparam Left The left-hand expression type
+        /// \tparam Right The right-hand expression type
+        /// \param expr The difference
+        /// \param negate \c true if the difference is subtracted
+        template <typename Left, typename Right>
+        void collect(const SubtExpr<Left, Right>& expr, const bool negate) {
+          if(expr.has_override()) {
+            // The difference is evaluated as one term with its parameters
+            terms_.push_back(std::make_shared<SumTermImpl<A, SubtExpr<Left, Right> > >(
+                expr, negate));
+            return;
+          }
+          collect(expr.left(), negate);
+          collect(expr.right(), ! negate);
+        }
+
+        /// Wait for the local tiles of an array
+
+        /// \param array The array
+        static void wait(const A& array) {
+          for(const auto index : *array.pmap())
+            if(! array.is_zero(index))
+              array.find(index).get();
+        }
+
+      public:
+
+        /// Collect the terms of a sum
+
+        /// \tparam D The expression type
+        /// \param expr The sum
+        template <typename D>
+        explicit SumTerms(const Expr<D>& expr) : terms_() {
+          collect(expr.derived(), false);
+        }
+
+        /// \return The number of terms
+        std::size_t size() const { return terms_.size(); }
+
+        /// Evaluate the sum in batches
+
+        /// \tparam Alias The tile alias flag of the result
+        /// \param tsr The result expression
+        /// \param result_memory The estimated memory of the result
+        /// \param memory_cap The memory cap
+        /// \return \c false if the sum was not evaluated, because all terms
+        /// fit within \c memory_cap
+        template <bool Alias>
+        bool eval_to(TsrExpr<A, Alias>& tsr, const double result_memory,
+            const double memory_cap)
+        {
+          // Estimate the memory of each term with the current result
+          A result = tsr.array();
+          TsrExpr<A, true> result_expr(result, tsr.vars());
+          const std::size_t n = terms_.size();
+          std::vector<double> memory(n, 0.0);
+          for(std::size_t t = 0ul; t < n; ++t)
+            memory[t] = terms_[t]->estimate(result_expr).peak_memory() +
+                (terms_[t]->accumulates() ? 0.0 : result_memory);
+
+          // Pack the terms into batches, in decreasing order of memory
+          std::vector<std::size_t> order(n);
+          std::iota(order.begin(), order.end(), 0ul);
+          std::stable_sort(order.begin(), order.end(),
+              [&memory] (const std::size_t l, const std::size_t r)
+              { return memory[l] > memory[r]; });
+          const double available = memory_cap - result_memory;
+          std::vector<std::vector<std::size_t> > batches;
+          std::vector<double> loads;
+          for(const std::size_t t : order) {
+            std::size_t b = 0ul;
+            while((b < batches.size()) && (loads[b] + memory[t] > available))
+              ++b;
+            if(b == batches.size()) {
+              batches.emplace_back();
+              loads.push_back(0.0);
+            }
+            batches[b].push_back(t);
+            loads[b] += memory[t];
+          }
+          if(batches.size() < 2ul)
+            return false;
+
+          eval_batches(tsr, batches);
+          return true;
+        }
+
+        /// Evaluate the sum in one pass
+
+        /// The product terms are evaluated first, so all but the first of
+        /// them are accumulated into the tiles of the first one, and the
+        /// other terms are added to the result with a temporary.
+        /// \tparam Alias The tile alias flag of the result
+        /// \param tsr The result expression
+        /// \return \c false if the sum was not evaluated, because it has fewer
+        /// than two product terms
+        template <bool Alias>
+        bool accumulate_to(TsrExpr<A, Alias>& tsr) {
+          std::vector<std::size_t> batch;
+          batch.reserve(terms_.size());
+          for(std::size_t t = 0ul; t < terms_.size(); ++t)
+            if(terms_[t]->accumulates() && terms_[t]->fresh())
+              batch.push_back(t);
+          if(batch.size() < 2ul)
+            return false;
+          for(std::size_t t = 0ul; t < terms_.size(); ++t)
+            if(! (terms_[t]->accumulates() && terms_[t]->fresh()))
+              batch.push_back(t);
+
+          eval_batches(tsr, std::vector<std::vector<std::size_t> >(1ul, batch));
+          return true;
+        }
+
+      private:
+
+        /// Evaluate batches of terms
+
+        /// The terms of a batch are evaluated concurrently, and the local
+        /// tiles of the result are waited on after each batch.
+        /// \tparam Alias The tile alias flag of the result
+        /// \param tsr The result expression
+        /// \param batches The terms of each batch
+        template <bool Alias>
+        void eval_batches(TsrExpr<A, Alias>& tsr,
+            const std::vector<std::vector<std::size_t> >& batches) const
+        {
+          // The result is accumulated in a separate array, since the terms
+          // may use the current result.
+          A result = tsr.array();
+          TsrExpr<A, true> result_expr(result, tsr.vars());
+
+          // Evaluate the batches. Terms are added in place once the result
+          // tiles are not shared with an argument array.
+          bool first = true, fresh = false;
+          for(const std::vector<std::size_t>& batch : batches) {
+            for(const std::size_t t : batch) {
+              const SumTerm<A>& term = *terms_[t];
+              if(first) {
+                term.assign(result_expr);
+                fresh = term.fresh();
+                first = false;
+                continue;
+              }
+
+              if(fresh && term.accumulates()) {
+                TsrExpr<A, false> accumulate_expr(result, tsr.vars());
+                if(term.accumulate(accumulate_expr))
+                  continue;
+              }
+              term.add(result_expr);
+              fresh = true;
+            }
+
+            // Release the intermediates of the batch
+            wait(result);
+          }
+
+          tsr.array() = result;
+        }
+
+      }; // class SumTerms
+
+      /// Sum expression trait
+
+      /// \tparam D The expression type
+      template <typename D>
+      struct is_sum_expr : public std::false_type { };
+
+      template <typename Left, typename Right>
+      struct is_sum_expr<AddExpr<Left, Right> > : public std::true_type { };
+
+      template <typename Left, typename Right>
+      struct is_sum_expr<SubtExpr<Left, Right> > : public std::true_type { };
+
+      template <typename D, typename A, bool Alias>
+      inline bool schedule_sum(const Expr<D>&, TsrExpr<A, Alias>&,
+          const bool, EvalHandle&, std::false_type)
+      { return false; }
+
+      template <typename D, typename A, bool Alias>
+      inline bool schedule_sum(const Expr<D>& expr, TsrExpr<A, Alias>& tsr,
+          const bool async, EvalHandle& handle, std::true_type)
+      {
+        SumSchedule& schedule = SumSchedule::instance();
+        if(schedule.active() || async || expr.has_override())
+          return false;
+
+        SumTerms<A> terms(expr);
+        if(terms.size() < 2ul)
+          return false;
+
+        // The terms of the sum are not scheduled again
+        struct ActiveGuard {
+          SumSchedule& schedule;
+          explicit ActiveGuard(SumSchedule& s) : schedule(s) { schedule.active(true); }
+          ~ActiveGuard() { schedule.active(false); }
+        } guard(schedule);
+
+        bool done = false;
+        if(schedule.memory_cap()) {
+          const double result_memory = expr.estimate(tsr).nodes().front().memory;
+          done = terms.eval_to(tsr, result_memory, double(schedule.memory_cap()));
+        }
+        if(! (done || terms.accumulate_to(tsr)))
+          return false;
+
+        handle = EvalHandle();
+        return true;
+      }
+
+      /// Evaluate a sum within the memory cap
+
+      /// \tparam D The expression type
+      /// \tparam A The result array type
+      /// \tparam Alias The tile alias flag of the result
+      /// \param expr The expression
+      /// \param tsr The result expression
+      /// \param async The asynchronous assignment flag
+      /// \param[out] handle The handle of the assignment
+      /// \return \c true if \c expr is a sum that was evaluated in batches
+      /// or in one pass (see \c SumSchedule )
+      template <typename D, typename A, bool Alias>
+      inline bool schedule_sum(const Expr<D>& expr, TsrExpr<A, Alias>& tsr,
+          const bool async, EvalHandle& handle)
+      {
+        return schedule_sum(expr, tsr, async, handle, is_sum_expr<D>());
+      }
+
+    } // namespace detail
+  } // namespace expressions
+} // namespace TiledArray
+
+#endif // TILEDARRAY_EXPRESSIONS_SUM_SCHEDULE_H__INCLUDED
@@ -34,6 +34,7 @@ namespace TiledArray {
 
   // Forward declaration
   template <typename, typename> class DistArray;
+  template <typename, typename> class Tensor;
 
   namespace expressions {
 
@@ -118,6 +119,31 @@ namespace TiledArray {
 
     }; // class TsrEngine
 
+    /// Fused kernel trait of a tensor expression engine
+
+    /// \tparam T The tensor element type
+    /// \tparam A The tensor allocator type
+    /// \tparam Policy The array policy type
+    /// \tparam Alias The alias flag of the engine
+    template <typename T, typename A, typename Policy, bool Alias>
+    struct FusedKernel<TsrEngine<DistArray<Tensor<T, A>, Policy>, Alias> > {
+      typedef TsrEngine<DistArray<Tensor<T, A>, Policy>, Alias> engine_type;
+      static constexpr bool value = TiledArray::detail::is_numeric<T>::value;
+      typedef Tensor<T, A> tile_type;
+      typedef TiledArray::detail::FusedArg<T> type;
+
+      static bool fusable(const engine_type& engine, const VariableList& vars) {
+        return (! engine.perm()) && (engine.vars() == vars);
+      }
+
+      static type make(const engine_type& engine,
+          std::vector<DistArray<tile_type, Policy> >& args)
+      {
+        args.push_back(engine.array());
+        return type(args.size() - 1u);
+      }
+    }; // struct FusedKernel
+
   }  // namespace expressions
 } // namespace TiledArray
 
@@ -31,6 +31,7 @@
 #include <TiledArray/expressions/mult_expr.h>
 #include <TiledArray/expressions/tsr_engine.h>
 #include <TiledArray/expressions/blk_tsr_expr.h>
+#include <TiledArray/expressions/index_list.h>
 #include <TiledArray/expressions/scal_tsr_expr.h>
 
 namespace TiledArray {
@@ -127,8 +128,50 @@ namespace TiledArray {
         return array_;
       }
 
+      /// Asynchronous expression assignment
+
+      /// The assignment returns without waiting for the result tiles, which
+      /// are evaluated by the task queue. Subsequent expressions that use this
+      /// array wait for the tiles they need.
+      /// \tparam D The derived expression type
+      /// \param other The expression that will be assigned to this array
+      /// \return The handle of the assignment
+      template <typename D>
+      EvalHandle assign_async(const Expr<D>& other) {
+        static_assert(TiledArray::expressions::is_aliased<D>::value,
+            "no_alias() expressions are not allowed on the right-hand side of "
+            "the assignment operator.");
+        return other.derived().eval_to(*this, true);
+      }
+
+    private:
+
+      /// Accumulate an expression into an aliased array
+
+      /// The tiles of an aliased array may be used by \c other , so they
+      /// cannot be modified in place.
+      /// \return \c false
+      template <typename D>
+      bool accumulate(const Expr<D>&, std::true_type) { return false; }
+
+      /// Accumulate an expression into a non-aliased array
+
+      /// \tparam D The derived expression type
+      /// \param other The expression that will be added to this array
+      /// \return \c true if \c other was added to this array in place
+      template <typename D>
+      bool accumulate(const Expr<D>& other, std::false_type) {
+        return other.derived().accumulate_to(*this);
+      }
+
+    public:
+
       /// Expression plus-assignment operator
 
+      /// For a non-aliased expression, e.g.
+      /// <tt>a("i,j").no_alias() += b("i,k") * c("k,j")</tt> , a contraction
+      /// is accumulated directly into the tiles of the array without a
+      /// temporary array.
       /// \tparam D The derived expression type
       /// \param other The expression that will be added to this array
       template <typename D>
@@ -136,11 +179,15 @@ namespace TiledArray {
         static_assert(TiledArray::expressions::is_aliased<D>::value,
             "no_alias() expressions are not allowed on the right-hand side of "
             "the assignment operator.");
+        if(accumulate(other, std::integral_constant<bool, Alias>()))
+          return array_;
         return operator=(AddExpr<TsrExpr_, D>(*this, other.derived()));
       }
 
       /// Expression minus-assignment operator
 
+      /// For a non-aliased expression, a contraction is accumulated directly
+      /// into the tiles of the array (see \c operator+= ).
       /// \tparam D The derived expression type
       /// \param other The expression that will be subtracted from this array
       template <typename D>
@@ -148,6 +195,8 @@ namespace TiledArray {
         static_assert(TiledArray::expressions::is_aliased<D>::value,
             "no_alias() expressions are not allowed on the right-hand side of "
             "the assignment operator.");
+        if(accumulate(-other.derived(), std::integral_constant<bool, Alias>()))
+          return array_;
         return operator=(SubtExpr<TsrExpr_, D>(*this, other.derived()));
       }
 
@@ -323,4 +372,7 @@ namespace TiledArray {
   }  // namespace expressions
 } // namespace TiledArray
 
+#include <TiledArray/expressions/cont_order.h>
+#include <TiledArray/expressions/sum_schedule.h>
+
 #endif // TILEDARRAY_EXPRESSIONS_TSR_EXPR_H__INCLUDED
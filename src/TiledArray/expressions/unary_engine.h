@@ -28,6 +28,8 @@
 
 #include <TiledArray/expressions/expr_engine.h>
 #include <TiledArray/dist_eval/unary_eval.h>
+#include <TiledArray/expressions/fused_kernel.h>
+#include <TiledArray/expressions/eval_placement.h>
 
 namespace TiledArray {
   namespace expressions {
@@ -89,9 +91,30 @@ namespace TiledArray {
         ExprEngine_(expr), arg_(expr.arg())
       { }
 
+      /// Tag of the constructor that evaluates an expression as the argument
+      struct arg_expr_tag { };
+
+      /// Constructor
+
+      /// The argument engine is constructed from \c expr itself, so the
+      /// derived engine transforms the result of \c expr , e.g. to evaluate
+      /// it with another policy.
+      /// \tparam D The argument expression type
+      /// \param expr The argument expression
+      template <typename D>
+      UnaryEngine(const Expr<D>& expr, arg_expr_tag) :
+        ExprEngine_(expr), arg_(expr.derived())
+      { }
+
       // Pull base class functions into this class.
       using ExprEngine_::derived;
       using ExprEngine_::vars;
+      using ExprEngine_::perm;
+      using ExprEngine_::world;
+      using ExprEngine_::trange;
+      using ExprEngine_::shape;
+      using ExprEngine_::pmap;
+      using ExprEngine_::mask_shape;
 
       /// Set the variable list for this expression
 
@@ -131,15 +154,34 @@ namespace TiledArray {
         ExprEngine_::init_struct(target_vars);
       }
 
+      /// Restrict the argument to the tiles of the result shape
+      void mask_args() {
+        if(shape_.is_dense())
+          return;
+        arg_.mask_shape(perm_ ? shape_.perm(-perm_) : shape_);
+      }
+
       /// Initialize result tensor distribution
 
       /// This function will initialize the world and process map for the result
-      /// tensor.
+      /// tensor. When the result is permuted, the argument may be distributed
+      /// so that each tile is evaluated by the owner of the result tile (see
+      /// \c EvalPlacement ).
       /// \param world The world were the result will be distributed
       /// \param pmap The process map for the result tensor tiles
       void init_distribution(World* world,
           const std::shared_ptr<pmap_interface>& pmap)
       {
+        if(pmap && perm_ && detail::result_owner_placement(*world, *pmap, perm_,
+            trange_.tiles_range(), shape_, { detail::home_pmap(arg_, 0) }))
+        {
+          arg_.init_distribution(world, std::make_shared<
+              TiledArray::detail::PermutedPmap>(*world, pmap,
+              arg_.trange().tiles_range(), perm_));
+          ExprEngine_::init_distribution(world, pmap);
+          return;
+        }
+
         arg_.init_distribution(world, pmap);
         ExprEngine_::init_distribution(world, arg_.pmap());
       }
@@ -157,10 +199,28 @@ namespace TiledArray {
         return perm ^ arg_.trange();
       }
 
-      /// Construct the distributed evaluator for this expression
+      /// Argument accessor
+
+      /// \return The argument engine
+      const argument_type& arg() const { return arg_; }
+
+    private:
+
+      /// Construct a fused distributed evaluator when possible
+
+      /// \return The fused distributed evaluator when this expression and its
+      /// argument are element-wise operations over congruent tiles, otherwise
+      /// the unary distributed evaluator
+      dist_eval_type make_dist_eval(std::true_type) const {
+        if(expression_fusion() && FusedKernel<Derived>::fusable(derived(), vars_))
+          return make_fused_dist_eval(derived());
+        return make_dist_eval(std::false_type());
+      }
+
+      /// Construct the unary distributed evaluator
 
       /// \return The distributed evaluator that will evaluate this expression
-      dist_eval_type make_dist_eval() const {
+      dist_eval_type make_dist_eval(std::false_type) const {
         typedef TiledArray::detail::UnaryEvalImpl<typename argument_type::dist_eval_type,
             typename Derived::op_type, typename dist_eval_type::policy> impl_type;
 
@@ -175,6 +235,18 @@ namespace TiledArray {
         return dist_eval_type(pimpl);
       }
 
+    public:
+
+      /// Construct the distributed evaluator for this expression
+
+      /// Element-wise subexpressions over congruent tiles are evaluated with
+      /// one fused kernel per tile (see \c FusedKernel ).
+      /// \return The distributed evaluator that will evaluate this expression
+      dist_eval_type make_dist_eval() const {
+        return make_dist_eval(std::integral_constant<bool,
+            FusedKernel<Derived>::value>());
+      }
+
       /// Expression print
 
       /// \param os The output stream
@@ -186,6 +258,28 @@ namespace TiledArray {
         os.dec();
       }
 
+      /// Estimate the cost of this expression
+
+      /// Each non-zero result tile is computed by one task from the
+      /// congruent tile of the argument.
+      /// \param est The estimate that the nodes of this expression are added to
+      /// \return The peak intermediate memory of this expression on any
+      /// process
+      double estimate(ExprEstimate& est) const {
+        const std::size_t index = ExprEngine_::estimate_node(est);
+        est.inc();
+        const std::size_t arg_index = est.nodes().size();
+        const double arg_peak = arg_.estimate(est);
+        est.dec();
+        const double arg_memory = est.node(arg_index).memory;
+
+        ExprEstimate::Node& node = est.node(index);
+        node.flops = ExprEngine_::estimate_result(node);
+        node.tasks = node.tiles;
+        node.comm_bytes = ExprEngine_::estimate_arg_comm(arg_);
+        return std::max(arg_peak, arg_memory + node.memory);
+      }
+
     }; // class UnaryEngine
 
   }  // namespace expressions
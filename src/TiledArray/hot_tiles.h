@@ -0,0 +1,96 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  hot_tiles.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_HOT_TILES_H__INCLUDED
+#define TILEDARRAY_HOT_TILES_H__INCLUDED
+
+#include <cstdlib>
+
+namespace TiledArray {
+
+  /// Replication policy of frequently read tiles
+
+  /// Tiles that are read by many processes, e.g. the occupied-occupied
+  /// blocks of the Fock matrix, make their owner a hot spot that serializes
+  /// the tasks of the readers. When hot tile replication is enabled, the
+  /// distributed storage objects that are constructed afterwards count the
+  /// remote reads of their local tiles, and a tile that is read
+  /// \c threshold() times is broadcast to all processes (see
+  /// \c detail::ReplicatorConfig for the broadcast algorithm). Later reads
+  /// of the tile are served by the local replica. The replicas of a tile are
+  /// dropped when the owner erases it. Replication is disabled by default;
+  /// it is enabled with \c enable() or by setting the
+  /// \c TA_HOT_TILE_THRESHOLD environment variable to the number of reads.
+  /// \note Replicas are not updated when a tile is modified in place, so
+  /// replication should only be enabled for arrays whose tiles are set once,
+  /// or erased and set again.
+  class HotTileReplication {
+    std::size_t threshold_; ///< The number of reads of a hot tile, or zero
+
+    HotTileReplication() :
+      threshold_(getenv("TA_HOT_TILE_THRESHOLD") ?
+          std::strtoul(getenv("TA_HOT_TILE_THRESHOLD"), nullptr, 10) : 0ul)
+    { }
+
+    HotTileReplication(const HotTileReplication&) = delete;
+    HotTileReplication& operator=(const HotTileReplication&) = delete;
+
+  public:
+
+    /// Replication policy accessor
+
+    /// \return A reference to the replication policy of this process
+    static HotTileReplication& instance() {
+      static HotTileReplication* const replication = new HotTileReplication();
+      return *replication;
+    }
+
+    /// Enable hot tile replication
+
+    /// \param threshold The number of remote reads after which a tile is
+    /// replicated on all processes
+    void enable(const std::size_t threshold) {
+      threshold_ = (threshold ? threshold : 1ul);
+    }
+
+    /// Disable hot tile replication
+    void disable() { threshold_ = 0ul; }
+
+    /// Replication status
+
+    /// \return \c true if hot tile replication is enabled
+    bool enabled() const { return threshold_ != 0ul; }
+
+    /// Threshold accessor
+
+    /// \return The number of remote reads after which a tile is replicated,
+    /// or zero if replication is disabled
+    std::size_t threshold() const { return threshold_; }
+
+  }; // class HotTileReplication
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_HOT_TILES_H__INCLUDED
@@ -32,6 +32,9 @@
 #include <madness/tensor/cblas.h>
 #pragma GCC diagnostic pop
 #include <TiledArray/error.h>
+#include <TiledArray/op_stats.h>
+#include <TiledArray/summa_trace.h>
+#include <TiledArray/thread_layout.h>
 
 namespace TiledArray {
 // Import some MADNESS classes into TiledArray for convenience.
@@ -125,9 +128,45 @@ namespace TiledArray {
   inline World& initialize(int& argc, char**& argv, const SafeMPI::Intracomm& comm) {
     auto& default_world = madness::initialize(argc, argv, comm);
     TiledArray::set_default_world(default_world);
+    detail::thread_layout().compute_threads = madness::ThreadPool::size();
     return default_world;
   }
 
+  /// Initialize with a thread layout
+
+  /// The layout is chosen from \c options and the cores of the node, and it
+  /// is applied before the MADNESS runtime is started (see
+  /// \c ThreadLayoutOptions ). The chosen layout is returned by
+  /// \c thread_layout() .
+  /// \code
+  /// TiledArray::ThreadLayoutOptions options;
+  /// options.bind = true;
+  /// options.numa = true;
+  /// options.report = true;
+  /// auto& world = TiledArray::initialize(argc, argv, options);
+  /// \endcode
+  inline World& initialize(int& argc, char**& argv, const SafeMPI::Intracomm& comm,
+      const ThreadLayoutOptions& options)
+  {
+    const std::pair<int, int> local = detail::launcher_local_rank();
+    ThreadLayout layout = detail::make_thread_layout(options,
+        detail::numa_domains(), local.first, local.second);
+    detail::apply_thread_layout(layout);
+
+    auto& default_world = TiledArray::initialize(argc, argv, comm);
+    layout.compute_threads = madness::ThreadPool::size();
+    detail::thread_layout() = layout;
+    if(options.report)
+      layout.print(std::cout, default_world.rank());
+    return default_world;
+  }
+
+  inline World& initialize(int& argc, char**& argv,
+      const ThreadLayoutOptions& options)
+  {
+    return TiledArray::initialize(argc, argv, SafeMPI::COMM_WORLD, options);
+  }
+
   inline World& initialize(int& argc, char**& argv) {
     return TiledArray::initialize(argc, argv, SafeMPI::COMM_WORLD);
   }
@@ -137,6 +176,8 @@ namespace TiledArray {
   }
 
   inline void finalize() {
+    write_op_stats(get_default_world().rank());
+    write_summa_trace(get_default_world().rank());
     madness::finalize();
     TiledArray::reset_default_world();
   }
@@ -29,12 +29,17 @@
 #include <madness/tensor/cblas.h>
 #include <TiledArray/type_traits.h>
 #include <TiledArray/math/eigen.h>
+#include <TiledArray/math/small_gemm.h>
+#include <TiledArray/math/gemm_backend.h>
 
 namespace TiledArray {
   namespace math {
 
     // BLAS _GEMM wrapper functions
 
+    // Matrix multiplications of BLAS types are routed to a backend by
+    // GemmDispatcher (see gemm_backend.h)
+
     template <typename S1, typename T1, typename T2, typename S2, typename T3>
     inline void gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
         madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
@@ -134,7 +139,7 @@ namespace TiledArray {
         const integer k, const float alpha, const float* a, const integer lda,
         const float* b, const integer ldb, const float beta, float* c, const integer ldc)
     {
-      madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+      dispatch_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
     }
 
     inline void gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
@@ -142,7 +147,7 @@ namespace TiledArray {
         const integer k, const double alpha, const double* a, const integer lda,
         const double* b, const integer ldb, const double beta, double* c, const integer ldc)
     {
-      madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+      dispatch_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
     }
 
     inline void gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
@@ -151,7 +156,7 @@ namespace TiledArray {
         const integer lda, const std::complex<float>* b, const integer ldb,
         const std::complex<float> beta, std::complex<float>* c, const integer ldc)
     {
-      madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+      dispatch_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
     }
 
     inline void gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
@@ -160,7 +165,105 @@ namespace TiledArray {
         const integer lda, const std::complex<double>* b, const integer ldb,
         const std::complex<double> beta, std::complex<double>* c, const integer ldc)
     {
-      madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+      dispatch_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
+
+
+    // BLAS _HERK wrapper functions
+
+    /// Hermitian rank-k update
+
+    /// Compute <tt>c = alpha * op(a) * op(a)^H + beta * c</tt>, where \c c is
+    /// an <tt>n x n</tt> row-major matrix and <tt>op(a)</tt> is <tt>n x k</tt>.
+    /// For real matrices this is a symmetric rank-k update (*SYRK). Only the
+    /// lower triangle of the product is computed, which is then mirrored into
+    /// the upper triangle, so this is about half the cost of \c gemm .
+    /// \param op The operation applied to \c a , which is \c NoTrans or a
+    /// (conjugate) transpose
+    /// \param n The number of rows and columns in \c c
+    /// \param k The number of columns in <tt>op(a)</tt>
+    /// \param alpha The real scaling factor applied to <tt>op(a) * op(a)^H</tt>
+    /// \param a The matrix
+    /// \param lda The leading dimension of \c a
+    /// \param beta The scaling factor applied to \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T, typename S2>
+    inline void herk(madness::cblas::CBLAS_TRANSPOSE op, const integer n,
+        const integer k, const S1 alpha, const T* a, const integer lda,
+        const S2 beta, T* c, const integer ldc)
+    {
+      typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+      typedef typename Eigen::NumTraits<T>::Real real_type;
+      TA_ASSERT(std::imag(alpha) == 0);
+
+      Eigen::Map<const matrix_type, Eigen::AutoAlign, Eigen::OuterStride<> > A(a,
+          (op == madness::cblas::NoTrans ? n : k),
+          (op == madness::cblas::NoTrans ? k : n),
+          Eigen::OuterStride<>(lda));
+      Eigen::Map<matrix_type, Eigen::AutoAlign, Eigen::OuterStride<> >
+          C(c, n, n, Eigen::OuterStride<>(ldc));
+
+      // The upper triangle of c is not necessarily the adjoint of its lower
+      // triangle, so the product is accumulated into c via a temporary.
+      matrix_type x = matrix_type::Zero(n, n);
+      if(op == madness::cblas::NoTrans)
+        x.template selfadjointView<Eigen::Lower>().rankUpdate(A, real_type(std::real(alpha)));
+      else
+        x.template selfadjointView<Eigen::Lower>().rankUpdate(A.adjoint(), real_type(std::real(alpha)));
+      for(integer i = 0; i < n; ++i)
+        for(integer j = i + 1; j < n; ++j)
+          x(i, j) = TiledArray::detail::conj(x(j, i));
+
+      if(beta == static_cast<S2>(0))
+        C = x;
+      else
+        C = T(beta) * C + x;
+    }
+
+    /// Hermitian matrix product
+
+    /// This is a noop for arguments of different or integral types.
+    /// \return \c false
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline bool herk_product(madness::cblas::CBLAS_TRANSPOSE,
+        madness::cblas::CBLAS_TRANSPOSE, const integer, const integer,
+        const integer, const S1, const T1*, const integer, const T2*,
+        const integer, const S2, T3*, const integer)
+    { return false; }
+
+    /// Hermitian matrix product
+
+    /// Compute <tt>c = alpha * op_a(a) * op_b(b) + beta * c</tt> with \c herk
+    /// when the product is Hermitian, that is \c a and \c b are the same
+    /// matrix, one of the operations is \c NoTrans and the other is the
+    /// conjugate transpose, and \c alpha is real. For real matrices the
+    /// transpose is the conjugate transpose. The arguments are the same as
+    /// those of \c gemm .
+    /// \return \c true if the product was computed, otherwise \c c is not
+    /// modified
+    template <typename S1, typename T, typename S2,
+        typename std::enable_if<std::is_floating_point<T>::value ||
+            TiledArray::detail::is_complex<T>::value>::type* = nullptr>
+    inline bool herk_product(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T* a, const integer lda,
+        const T* b, const integer ldb, const S2 beta, T* c, const integer ldc)
+    {
+      if((a != b) || (lda != ldb) || (m != n) || (std::imag(alpha) != 0))
+        return false;
+
+      const bool complex = TiledArray::detail::is_complex<T>::value;
+      const bool adjoint_a = (op_a == madness::cblas::ConjTrans) ||
+          (! complex && (op_a == madness::cblas::Trans));
+      const bool adjoint_b = (op_b == madness::cblas::ConjTrans) ||
+          (! complex && (op_b == madness::cblas::Trans));
+      if(! (((op_a == madness::cblas::NoTrans) && adjoint_b) ||
+          (adjoint_a && (op_b == madness::cblas::NoTrans))))
+        return false;
+
+      herk(op_a, n, k, alpha, a, lda, beta, c, ldc);
+      return true;
     }
 
 
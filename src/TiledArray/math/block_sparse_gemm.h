@@ -0,0 +1,258 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  block_sparse_gemm.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_BLOCK_SPARSE_GEMM_H__INCLUDED
+#define TILEDARRAY_MATH_BLOCK_SPARSE_GEMM_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/math/parallel_gemm.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+/* The number of rows and columns in the sub-blocks screened by a block-sparse gemm. */
+#ifndef TILEDARRAY_BLOCK_SPARSE_GEMM_BLOCK_SIZE
+#define TILEDARRAY_BLOCK_SPARSE_GEMM_BLOCK_SIZE 64l
+#endif // TILEDARRAY_BLOCK_SPARSE_GEMM_BLOCK_SIZE
+
+namespace TiledArray {
+  namespace math {
+
+    /// Runtime settings for intra-tile (sub-block) screening of matrix multiplications
+
+    /// Sparse shapes screen whole tiles, so large tiles that are mostly zero
+    /// are still multiplied with a full GEMM. When sub-block screening is
+    /// enabled, the tile GEMMs of contractions are divided into square
+    /// sub-blocks of \c block_size() rows and columns, and the products of
+    /// sub-blocks for which the product of the Frobenius norms is less than
+    /// \c threshold() are skipped. Screening is disabled when the threshold
+    /// is zero, which is the default. The initial threshold is given by the
+    /// \c TA_BLOCK_SPARSE_GEMM environment variable.
+    /// \note The settings are shared by all threads of a process, and should
+    /// only be changed when no contraction is running.
+    class BlockSparseGemm {
+    private:
+      double threshold_; ///< The screening threshold
+      integer block_size_; ///< The sub-block size
+
+      BlockSparseGemm() :
+        threshold_(getenv("TA_BLOCK_SPARSE_GEMM") ?
+            std::strtod(getenv("TA_BLOCK_SPARSE_GEMM"), nullptr) : 0.0),
+        block_size_(TILEDARRAY_BLOCK_SPARSE_GEMM_BLOCK_SIZE)
+      { }
+
+      BlockSparseGemm(const BlockSparseGemm&) = delete;
+      BlockSparseGemm& operator=(const BlockSparseGemm&) = delete;
+
+    public:
+
+      /// Settings accessor
+
+      /// \return A reference to the block-sparse gemm settings of this process
+      static BlockSparseGemm& instance() {
+        static BlockSparseGemm settings;
+        return settings;
+      }
+
+      /// Screening state accessor
+
+      /// \return \c true if sub-block screening is enabled
+      bool enabled() const { return threshold_ > 0.0; }
+
+      /// Screening threshold accessor
+
+      /// \return The threshold for the product of sub-block norms
+      double threshold() const { return threshold_; }
+
+      /// Set the screening threshold
+
+      /// \param threshold The threshold for the product of sub-block norms,
+      /// where zero disables screening
+      void set_threshold(const double threshold) {
+        TA_ASSERT(threshold >= 0.0);
+        threshold_ = threshold;
+      }
+
+      /// Sub-block size accessor
+
+      /// \return The number of rows and columns in a sub-block
+      integer block_size() const { return block_size_; }
+
+      /// Set the sub-block size
+
+      /// \param block_size The number of rows and columns in a sub-block
+      void set_block_size(const integer block_size) {
+        TA_ASSERT(block_size > 0l);
+        block_size_ = block_size;
+      }
+
+    }; // class BlockSparseGemm
+
+    /// Compute the Frobenius norms of the sub-blocks of a matrix
+
+    /// \tparam T The matrix element type
+    /// \param op The operation applied to \c x
+    /// \param rows The number of rows in <tt>op(x)</tt>
+    /// \param cols The number of columns in <tt>op(x)</tt>
+    /// \param x The matrix data (row-major)
+    /// \param ldx The leading dimension of \c x
+    /// \param block_size The number of rows and columns in a sub-block
+    /// \return The row-major grid of sub-block norms of <tt>op(x)</tt>
+    template <typename T>
+    std::vector<double> block_norms(const madness::cblas::CBLAS_TRANSPOSE op,
+        const integer rows, const integer cols, const T* x, const integer ldx,
+        const integer block_size)
+    {
+      const integer block_rows = (rows + block_size - 1l) / block_size;
+      const integer block_cols = (cols + block_size - 1l) / block_size;
+      std::vector<double> norms(block_rows * block_cols, 0.0);
+
+      // Traverse x in storage order; the rows of x are the columns of op(x)
+      // when x is transposed.
+      const bool no_trans = (op == madness::cblas::NoTrans);
+      const integer x_rows = (no_trans ? rows : cols);
+      const integer x_cols = (no_trans ? cols : rows);
+      for(integer i = 0l; i < x_rows; ++i) {
+        const T* const x_i = x + i * ldx;
+        for(integer j = 0l; j < x_cols; ++j) {
+          const double value = std::abs(x_i[j]);
+          const integer block = (no_trans ?
+              (i / block_size) * block_cols + (j / block_size) :
+              (j / block_size) * block_cols + (i / block_size));
+          norms[block] += value * value;
+        }
+      }
+
+      for(double& norm : norms)
+        norm = std::sqrt(norm);
+
+      return norms;
+    }
+
+    /// Check if a matrix multiplication should be screened by sub-blocks
+
+    /// \param m The number of rows in the result matrix
+    /// \param n The number of columns in the result matrix
+    /// \param k The inner dimension of the multiplication
+    /// \return \c true if sub-block screening is enabled and the
+    /// multiplication has more than one sub-block in some dimension
+    inline bool use_block_sparse_gemm(const integer m, const integer n, const integer k) {
+      const BlockSparseGemm& settings = BlockSparseGemm::instance();
+      if(! settings.enabled())
+        return false;
+      const integer block_size = settings.block_size();
+      return (m > block_size) || (n > block_size) || (k > block_size);
+    }
+
+    /// Matrix multiplication with sub-block screening
+
+    /// Compute <tt>c = alpha * op_a(a) * op_b(b) + beta * c</tt>, where all
+    /// matrices are row-major. When \c use_block_sparse_gemm returns \c true ,
+    /// the norms of the sub-blocks of <tt>op_a(a)</tt> and <tt>op_b(b)</tt> are
+    /// computed, and each block of \c c only accumulates the block products
+    /// for which <tt>|alpha| * norm(a_ik) * norm(b_kj)</tt> is at least
+    /// \c BlockSparseGemm::threshold() . Since the norm product bounds the
+    /// norm of the block product, the error of the result is controlled by
+    /// the threshold. The norms cost <tt>O(mk + kn)</tt>, compared to the
+    /// <tt>O(mnk)</tt> multiplication. Otherwise, \c parallel_gemm is called.
+    /// \param op_a The operation applied to \c a
+    /// \param op_b The operation applied to \c b
+    /// \param m The number of rows in <tt>op_a(a)</tt> and \c c
+    /// \param n The number of columns in <tt>op_b(b)</tt> and \c c
+    /// \param k The number of columns in <tt>op_a(a)</tt> and rows in <tt>op_b(b)</tt>
+    /// \param alpha The scaling factor applied to <tt>op_a(a) * op_b(b)</tt>
+    /// \param a The left-hand matrix
+    /// \param lda The leading dimension of \c a
+    /// \param b The right-hand matrix
+    /// \param ldb The leading dimension of \c b
+    /// \param beta The scaling factor applied to \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline void block_sparse_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const T2* b, const integer ldb, const S2 beta, T3* c, const integer ldc)
+    {
+      if(! use_block_sparse_gemm(m, n, k)) {
+        parallel_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+      }
+
+      const BlockSparseGemm& settings = BlockSparseGemm::instance();
+      const integer block_size = settings.block_size();
+      const double threshold = settings.threshold() / std::abs(alpha);
+
+      const std::vector<double> a_norms =
+          block_norms(op_a, m, k, a, lda, block_size);
+      const std::vector<double> b_norms =
+          block_norms(op_b, k, n, b, ldb, block_size);
+      const integer mb = (m + block_size - 1l) / block_size;
+      const integer nb = (n + block_size - 1l) / block_size;
+      const integer kb = (k + block_size - 1l) / block_size;
+
+      for(integer ib = 0l; ib < mb; ++ib) {
+        const integer i = ib * block_size;
+        const integer block_m = std::min(block_size, m - i);
+        const T1* const a_i = a + (op_a == madness::cblas::NoTrans ? i * lda : i);
+
+        for(integer jb = 0l; jb < nb; ++jb) {
+          const integer j = jb * block_size;
+          const integer block_n = std::min(block_size, n - j);
+          const T2* const b_j = b + (op_b == madness::cblas::NoTrans ? j : j * ldb);
+          T3* const c_ij = c + i * ldc + j;
+
+          // The first block product that is not screened applies beta
+          bool first = true;
+          for(integer lb = 0l; lb < kb; ++lb) {
+            if((a_norms[ib * kb + lb] * b_norms[lb * nb + jb]) < threshold)
+              continue;
+
+            const integer l = lb * block_size;
+            const integer block_k = std::min(block_size, k - l);
+            gemm(op_a, op_b, block_m, block_n, block_k, alpha,
+                a_i + (op_a == madness::cblas::NoTrans ? l : l * lda), lda,
+                b_j + (op_b == madness::cblas::NoTrans ? l * ldb : l), ldb,
+                (first ? beta : S2(1)), c_ij, ldc);
+            first = false;
+          }
+
+          // Every block product was screened, so only scale c
+          if(first && (beta != S2(1))) {
+            for(integer ii = 0l; ii < block_m; ++ii) {
+              T3* const c_row = c_ij + ii * ldc;
+              for(integer jj = 0l; jj < block_n; ++jj)
+                c_row[jj] = (beta == S2(0) ? T3(0) : c_row[jj] * beta);
+            }
+          }
+        }
+      }
+    }
+
+  }  // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_BLOCK_SPARSE_GEMM_H__INCLUDED
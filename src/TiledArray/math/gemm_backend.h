@@ -0,0 +1,414 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  gemm_backend.h
+ *  Oct 15, 2026
+ *
+ */
+
+
+#ifndef TILEDARRAY_MATH_GEMM_BACKEND_H__INCLUDED
+#define TILEDARRAY_MATH_GEMM_BACKEND_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/math/small_gemm.h>
+#include <madness/tensor/cblas.h>
+#include <atomic>
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace TiledArray {
+  namespace math {
+
+    /// Matrix multiplication backends
+    enum class GemmBackend : unsigned int {
+      small = 0u, ///< The built-in kernel for small matrices ( \c small_gemm )
+      blas = 1u, ///< The BLAS library linked with MADNESS
+      external = 2u ///< A user registered function (e.g. libxsmm or a GPU library)
+    }; // enum class GemmBackend
+
+    /// Statistics of the calls to a matrix multiplication backend
+    struct GemmStats {
+      std::size_t calls; ///< The number of calls
+      double flops; ///< The number of floating point operations, \c 2mnk
+      double seconds; ///< The time spent in the backend
+    }; // struct GemmStats
+
+    /// Matrix multiplication function of an external backend
+
+    /// The arguments are those of \c gemm , for row-major matrices.
+    /// \tparam T The matrix element type
+    template <typename T>
+    using external_gemm_function = void (*)(madness::cblas::CBLAS_TRANSPOSE,
+        madness::cblas::CBLAS_TRANSPOSE, const integer, const integer,
+        const integer, const T, const T*, const integer, const T*,
+        const integer, const T, T*, const integer);
+
+    /// Runtime routing of matrix multiplications to backends
+
+    /// The matrix multiplications of BLAS types are routed by the volume of
+    /// the product, \c m*n*k : products no larger than \c small_threshold()
+    /// use the built-in small matrix kernel; products that are at least
+    /// \c external_threshold() use the external backend of the element type,
+    /// if one is registered with \c set_external() ; all others use BLAS.
+    /// The routing can be overridden with \c force() , e.g. to measure one
+    /// backend. The initial settings are given by the environment variables
+    /// \c TA_GEMM_BACKEND ( \c small , \c blas , or \c external ),
+    /// \c TA_SMALL_GEMM_THRESHOLD , and \c TA_EXTERNAL_GEMM_THRESHOLD .
+    ///
+    /// When statistics are enabled (with \c enable_stats() or the
+    /// \c TA_GEMM_STATS environment variable), the number of calls,
+    /// operations, and time of each backend are recorded, so the thresholds
+    /// can be tuned from measurements.
+    /// \note The settings are shared by all threads of a process, and should
+    /// only be changed when no contraction is running.
+    class GemmDispatcher {
+    public:
+      static constexpr unsigned int num_backends = 3u; ///< Number of backends
+
+    private:
+      integer small_threshold_; ///< Largest product volume for the small kernel
+      integer external_threshold_; ///< Smallest product volume for the external backend
+      int forced_; ///< The forced backend, or -1 for size based routing
+      std::atomic<bool> stats_; ///< Statistics are recorded when true
+      std::atomic<std::size_t> calls_[num_backends]; ///< Calls of each backend
+      std::atomic<std::uint64_t> flops_[num_backends]; ///< Operations of each backend
+      std::atomic<std::uint64_t> nanoseconds_[num_backends]; ///< Time of each backend
+
+      GemmDispatcher() :
+        small_threshold_(getenv("TA_SMALL_GEMM_THRESHOLD") ?
+            std::strtol(getenv("TA_SMALL_GEMM_THRESHOLD"), nullptr, 10) :
+            TILEDARRAY_SMALL_GEMM_THRESHOLD),
+        external_threshold_(getenv("TA_EXTERNAL_GEMM_THRESHOLD") ?
+            std::strtol(getenv("TA_EXTERNAL_GEMM_THRESHOLD"), nullptr, 10) : 0l),
+        forced_(parse_backend(getenv("TA_GEMM_BACKEND"))),
+        stats_(getenv("TA_GEMM_STATS") != nullptr)
+      {
+        reset_stats();
+      }
+
+      GemmDispatcher(const GemmDispatcher&) = delete;
+      GemmDispatcher& operator=(const GemmDispatcher&) = delete;
+
+      /// Convert a backend name into a backend
+
+      /// \param str The backend name
+      /// \return The backend, or -1 if \c str is \c nullptr or not a backend
+      static int parse_backend(const char* str) {
+        if(str)
+          for(unsigned int b = 0u; b < num_backends; ++b)
+            if(std::string(str) == name(static_cast<GemmBackend>(b)))
+              return b;
+        return -1;
+      }
+
+      /// External backend accessor
+
+      /// \tparam T The matrix element type
+      /// \return A reference to the external function of \c T
+      template <typename T>
+      static external_gemm_function<T>& external_function() {
+        static external_gemm_function<T> fn = nullptr;
+        return fn;
+      }
+
+    public:
+
+      /// Dispatcher accessor
+
+      /// \return A reference to the matrix multiplication dispatcher of this
+      /// process
+      static GemmDispatcher& instance() {
+        static GemmDispatcher dispatcher;
+        return dispatcher;
+      }
+
+      /// Backend name
+
+      /// \param backend The backend
+      /// \return The name of \c backend
+      static const char* name(const GemmBackend backend) {
+        static const char* const names[num_backends] =
+            { "small", "blas", "external" };
+        return names[static_cast<unsigned int>(backend)];
+      }
+
+      /// \return The largest product volume, \c m*n*k , that uses the small
+      /// matrix kernel
+      integer small_threshold() const { return small_threshold_; }
+
+      /// Set the largest product volume that uses the small matrix kernel
+
+      /// \param threshold The product volume, where zero disables the small
+      /// matrix kernel
+      void set_small_threshold(const integer threshold) {
+        TA_ASSERT(threshold >= 0l);
+        small_threshold_ = threshold;
+      }
+
+      /// \return The smallest product volume, \c m*n*k , that uses the
+      /// external backend
+      integer external_threshold() const { return external_threshold_; }
+
+      /// Set the smallest product volume that uses the external backend
+
+      /// \param threshold The product volume
+      void set_external_threshold(const integer threshold) {
+        TA_ASSERT(threshold >= 0l);
+        external_threshold_ = threshold;
+      }
+
+      /// Register an external backend
+
+      /// \tparam T The matrix element type
+      /// \param fn The matrix multiplication function for \c T , or
+      /// \c nullptr to remove the external backend of \c T
+      template <typename T>
+      void set_external(const external_gemm_function<T> fn) {
+        external_function<T>() = fn;
+      }
+
+      /// External backend accessor
+
+      /// \tparam T The matrix element type
+      /// \return The external matrix multiplication function for \c T , or
+      /// \c nullptr if none is registered
+      template <typename T>
+      external_gemm_function<T> external() const { return external_function<T>(); }
+
+      /// Check for an external backend
+
+      /// \tparam T The matrix element type
+      /// \return \c true if an external backend is registered for \c T
+      template <typename T>
+      bool has_external() const { return external_function<T>() != nullptr; }
+
+      /// Route all matrix multiplications to one backend
+
+      /// Products that are forced to the external backend use BLAS when no
+      /// external backend is registered for their element type.
+      /// \param backend The backend
+      void force(const GemmBackend backend) {
+        forced_ = static_cast<int>(backend);
+      }
+
+      /// Route matrix multiplications by their size
+      void unforce() { forced_ = -1; }
+
+      /// Select the backend of a matrix multiplication
+
+      /// \tparam T The matrix element type
+      /// \param m The number of rows in the result matrix
+      /// \param n The number of columns in the result matrix
+      /// \param k The inner dimension of the multiplication
+      /// \return The backend that computes the product
+      template <typename T>
+      GemmBackend select(const integer m, const integer n, const integer k) const {
+        GemmBackend backend = GemmBackend::blas;
+        if(forced_ >= 0) {
+          backend = static_cast<GemmBackend>(forced_);
+        } else {
+          // The volume may not fit in an integer
+          const std::int64_t volume =
+              std::int64_t(m) * std::int64_t(n) * std::int64_t(k);
+          if(volume <= std::int64_t(small_threshold_))
+            backend = GemmBackend::small;
+          else if(volume >= std::int64_t(external_threshold_))
+            backend = GemmBackend::external;
+        }
+        if((backend == GemmBackend::external) && ! has_external<T>())
+          backend = GemmBackend::blas;
+        return backend;
+      }
+
+      /// \return \c true if statistics are recorded
+      bool stats_enabled() const { return stats_.load(std::memory_order_relaxed); }
+
+      /// Enable or disable statistics
+
+      /// \param enable Statistics are recorded when \c true
+      void enable_stats(const bool enable = true) {
+        stats_.store(enable, std::memory_order_relaxed);
+      }
+
+      /// Record a matrix multiplication
+
+      /// \param backend The backend that computed the product
+      /// \param m The number of rows in the result matrix
+      /// \param n The number of columns in the result matrix
+      /// \param k The inner dimension of the multiplication
+      /// \param nanoseconds The time of the multiplication
+      void record(const GemmBackend backend, const integer m, const integer n,
+          const integer k, const std::uint64_t nanoseconds)
+      {
+        const unsigned int b = static_cast<unsigned int>(backend);
+        calls_[b].fetch_add(1ul, std::memory_order_relaxed);
+        flops_[b].fetch_add(2ul * std::uint64_t(m) * std::uint64_t(n) *
+            std::uint64_t(k), std::memory_order_relaxed);
+        nanoseconds_[b].fetch_add(nanoseconds, std::memory_order_relaxed);
+      }
+
+      /// Statistics of a backend
+
+      /// \param backend The backend
+      /// \return The calls, operations, and time of \c backend since the
+      /// statistics were reset
+      GemmStats stats(const GemmBackend backend) const {
+        const unsigned int b = static_cast<unsigned int>(backend);
+        return GemmStats{ calls_[b].load(std::memory_order_relaxed),
+            double(flops_[b].load(std::memory_order_relaxed)),
+            double(nanoseconds_[b].load(std::memory_order_relaxed)) * 1.0e-9 };
+      }
+
+      /// Reset the statistics of all backends
+      void reset_stats() {
+        for(unsigned int b = 0u; b < num_backends; ++b) {
+          calls_[b] = 0ul;
+          flops_[b] = 0ul;
+          nanoseconds_[b] = 0ul;
+        }
+      }
+
+      /// Print the statistics of all backends
+
+      /// \param os The output stream
+      void print_stats(std::ostream& os = std::cout) const {
+        os << std::setw(10) << "backend" << std::setw(12) << "calls"
+           << std::setw(14) << "GFLOP" << std::setw(12) << "seconds"
+           << std::setw(12) << "GFLOP/s" << "\n";
+        for(unsigned int b = 0u; b < num_backends; ++b) {
+          const GemmStats s = stats(static_cast<GemmBackend>(b));
+          os << std::setw(10) << name(static_cast<GemmBackend>(b))
+             << std::setw(12) << s.calls
+             << std::setw(14) << s.flops * 1.0e-9
+             << std::setw(12) << s.seconds
+             << std::setw(12) << (s.seconds > 0.0 ? s.flops * 1.0e-9 / s.seconds : 0.0)
+             << "\n";
+        }
+      }
+
+    }; // class GemmDispatcher
+
+    /// Compute a matrix-vector product with BLAS
+
+    /// Products where \c C has one row or one column are evaluated with
+    /// \c gemv , which streams the matrix once instead of running the
+    /// blocked \c gemm kernel on a degenerate panel. Products that need the
+    /// conjugate of the vector, or of a row-major matrix that is not
+    /// transposed, are left to \c gemm .
+    /// The arguments are those of \c gemm .
+    /// \return \c true if the product was evaluated
+    template <typename T>
+    inline bool blas_gemv(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const T alpha, const T* a, const integer lda,
+        const T* b, const integer ldb, const T beta, T* c, const integer ldc)
+    {
+      // The column-major view of a row-major matrix is its transpose, so
+      // a row-major y = A * x is the column-major y = A^T * x .
+      if((n == 1) && (m > 1) && (op_a != madness::cblas::ConjTrans) &&
+          (op_b != madness::cblas::ConjTrans))
+      {
+        madness::cblas::gemv((op_a == madness::cblas::NoTrans ?
+            madness::cblas::Trans : madness::cblas::NoTrans), (op_a ==
+            madness::cblas::NoTrans ? k : m), (op_a == madness::cblas::NoTrans ?
+            m : k), alpha, a, lda, b, (op_b == madness::cblas::NoTrans ? ldb : 1),
+            beta, c, ldc);
+        return true;
+      }
+
+      // A row-major y^T = x^T * B is the column-major y = B^T * x
+      if((m == 1) && (n > 1) && (op_a != madness::cblas::ConjTrans) &&
+          (op_b != madness::cblas::ConjTrans))
+      {
+        madness::cblas::gemv((op_b == madness::cblas::NoTrans ?
+            madness::cblas::NoTrans : madness::cblas::Trans), (op_b ==
+            madness::cblas::NoTrans ? n : k), (op_b == madness::cblas::NoTrans ?
+            k : n), alpha, b, ldb, a, (op_a == madness::cblas::NoTrans ? 1 : lda),
+            beta, c, 1);
+        return true;
+      }
+
+      return false;
+    }
+
+    /// Compute a matrix multiplication with a backend
+
+    /// \param backend The backend
+    /// The other arguments are those of \c gemm
+    template <typename T>
+    inline void backend_gemm(const GemmBackend backend,
+        madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const T alpha, const T* a, const integer lda,
+        const T* b, const integer ldb, const T beta, T* c, const integer ldc)
+    {
+      switch(backend) {
+        case GemmBackend::small:
+          small_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+          break;
+        case GemmBackend::external:
+          GemmDispatcher::instance().external<T>()(op_a, op_b,
+              m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+          break;
+        default:
+          if(blas_gemv(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc))
+            break;
+
+          // Row-major C = A * B is evaluated as column-major C^T = B^T * A^T
+          madness::cblas::gemm(op_b, op_a, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+          break;
+      }
+    }
+
+    /// Route a matrix multiplication to a backend
+
+    /// The backend is selected by \c GemmDispatcher , and the call is recorded
+    /// when statistics are enabled. The arguments are those of \c gemm .
+    /// \tparam T A BLAS element type
+    template <typename T>
+    inline void dispatch_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const T alpha, const T* a, const integer lda,
+        const T* b, const integer ldb, const T beta, T* c, const integer ldc)
+    {
+      GemmDispatcher& dispatcher = GemmDispatcher::instance();
+      const GemmBackend backend = dispatcher.select<T>(m, n, k);
+      if(! dispatcher.stats_enabled()) {
+        backend_gemm(backend, op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+      backend_gemm(backend, op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+      const auto finish = std::chrono::steady_clock::now();
+      dispatcher.record(backend, m, n, k, std::chrono::duration_cast<
+          std::chrono::nanoseconds>(finish - start).count());
+    }
+
+  }  // namespace math
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_GEMM_BACKEND_H__INCLUDED
@@ -270,8 +270,74 @@ namespace TiledArray {
           n *= right_extent[i];
       }
 
+      /// Compute the leading dimension of the left-hand matrix
+
+      /// \tparam Left The left-hand range type
+      /// \param left The left-hand range object, which may be a strided block
+      /// \return The leading dimension of the left-hand matrix, or 0 if
+      /// \c left is not a uniformly strided matrix
+      template <typename Left>
+      integer left_leading_dimension(const Left& left) const {
+        TA_ASSERT(left.rank() == left_.rank);
+        return leading_dimension(left, (left_op_ == madness::cblas::NoTrans ?
+            left_.inner[0] : left_.outer[0]));
+      }
+
+      /// Compute the leading dimension of the right-hand matrix
+
+      /// \tparam Right The right-hand range type
+      /// \param right The right-hand range object, which may be a strided block
+      /// \return The leading dimension of the right-hand matrix, or 0 if
+      /// \c right is not a uniformly strided matrix
+      template <typename Right>
+      integer right_leading_dimension(const Right& right) const {
+        TA_ASSERT(right.rank() == right_.rank);
+        return leading_dimension(right, (right_op_ == madness::cblas::NoTrans ?
+            right_.outer[0] : right_.inner[0]));
+      }
+
       madness::cblas::CBLAS_TRANSPOSE left_op() const { return left_op_; }
       madness::cblas::CBLAS_TRANSPOSE right_op() const { return right_op_; }
+
+    private:
+
+      /// Compute the leading dimension of a matrix stored in \c range
+
+      /// The dimensions of \c range before \c col_begin are fused into the rows
+      /// of the matrix, and the remaining dimensions are fused into its
+      /// columns. The columns must be contiguous and the rows must have a
+      /// uniform stride for the matrix to be passed to *GEMM in place.
+      /// \tparam R The range type
+      /// \param range The range object
+      /// \param col_begin The first dimension of the matrix columns
+      /// \return The row stride of the matrix, or 0 if it cannot be expressed
+      /// with a leading dimension
+      template <typename R>
+      static integer leading_dimension(const R& range, const unsigned int col_begin) {
+        const auto* MADNESS_RESTRICT const extent = range.extent_data();
+        const auto* MADNESS_RESTRICT const stride = range.stride_data();
+
+        // Unit extent dimensions do not affect the layout of the matrix.
+        integer cols = 1;
+        for(unsigned int i = range.rank(); i > col_begin; --i) {
+          if((extent[i - 1u] != 1u) && (integer(stride[i - 1u]) != cols))
+            return 0;
+          cols *= extent[i - 1u];
+        }
+
+        integer ld = 0, next_stride = 0;
+        for(unsigned int i = col_begin; i > 0u; --i) {
+          if(extent[i - 1u] == 1u)
+            continue;
+          if(ld == 0)
+            ld = next_stride = stride[i - 1u];
+          else if(integer(stride[i - 1u]) != next_stride)
+            return 0;
+          next_stride *= extent[i - 1u];
+        }
+
+        return (ld == 0 ? cols : ld);
+      }
     }; // class GemmHelper
 
   }  // namespace math
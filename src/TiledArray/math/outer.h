@@ -164,7 +164,7 @@ namespace TiledArray {
     typedef OuterVectorOpUnwind<TILEDARRAY_LOOP_UNWIND - 1> OuterVectorOpUnwindN;
 
 
-    /// Compute and store outer of \c x and \c y in \c a
+    /// Compute and store outer of \c x and \c y in a block of \c a
 
     /// <tt>a[i][j] = op(x[i], y[j])</tt>.
     /// \tparam X The left-hand vector element type
@@ -175,17 +175,19 @@ namespace TiledArray {
     /// \param[in] x The left-hand vector
     /// \param[in] y The right-hand vector
     /// \param[out] a The result matrix of size \c m*n
+    /// \param[in] lda The row stride of \c a
     /// \param[in] op The operation that will compute the outer product elements
     template <typename X, typename Y, typename A, typename Op>
-    void outer_fill(const std::size_t m, const std::size_t n,
-        const X* const x, const Y* const y, A* a, const Op& op)
+    void outer_fill_block(const std::size_t m, const std::size_t n,
+        const X* const x, const Y* const y, A* a, const std::size_t lda,
+        const Op& op)
     {
       std::size_t i = 0ul;
 
       // Compute block iteration limit
       const std::size_t mx = m & index_mask::value; // = m - m % TILEDARRAY_LOOP_UNWIND
       const std::size_t nx = n & index_mask::value; // = n - n % TILEDARRAY_LOOP_UNWIND
-      const std::size_t a_block_stride = n * TILEDARRAY_LOOP_UNWIND;
+      const std::size_t a_block_stride = lda * TILEDARRAY_LOOP_UNWIND;
 
       for(; i < mx; i += TILEDARRAY_LOOP_UNWIND, a += a_block_stride) {
 
@@ -201,7 +203,7 @@ namespace TiledArray {
           copy_block(y_block, y + j);
 
           // Compute and store a block
-          OuterVectorOpUnwindN::fill(x_block, y_block, a + j, n, op);
+          OuterVectorOpUnwindN::fill(x_block, y_block, a + j, lda, op);
 
         }
 
@@ -217,11 +219,11 @@ namespace TiledArray {
           for_each_block(bind_first_op, a_block, x_block);
 
           // Store a block
-          scatter_block(a + j, n, a_block);
+          scatter_block(a + j, lda, a_block);
         }
       }
 
-      for(; i < m; ++i, a += n) {
+      for(; i < m; ++i, a += lda) {
 
         const X x_i = x[i];
         vector_op([x_i,&op] (const Y y_j) -> decltype(op(x_i, y_j))
@@ -230,7 +232,7 @@ namespace TiledArray {
       }
     }
 
-    /// Compute the outer of \c x and \c y to modify \c a
+    /// Compute the outer of \c x and \c y to modify a block of \c a
 
     /// Compute <tt>op(a[i][j], x[i], y[j])</tt> for each \c i and \c j pair,
     /// where \c a[i][j] is modified by \c op.
@@ -243,17 +245,19 @@ namespace TiledArray {
     /// \param[in] x The left-hand vector
     /// \param[in] y The right-hand vector
     /// \param[in,out] a The result matrix of size \c m*n
+    /// \param[in] lda The row stride of \c a
     /// \param[in] op The operation used to generate the result
     template <typename X, typename Y, typename A, typename Op>
-    void outer(const std::size_t m, const std::size_t n,
-        const X* const x, const Y* const y, A* a, const Op& op)
+    void outer_block(const std::size_t m, const std::size_t n,
+        const X* const x, const Y* const y, A* a, const std::size_t lda,
+        const Op& op)
     {
       std::size_t i = 0ul;
 
       // Compute block iteration limit
       const std::size_t mx = m & index_mask::value; // = m - m % TILEDARRAY_LOOP_UNWIND
       const std::size_t nx = n & index_mask::value; // = n - n % TILEDARRAY_LOOP_UNWIND
-      const std::size_t a_block_stride = n * TILEDARRAY_LOOP_UNWIND;
+      const std::size_t a_block_stride = lda * TILEDARRAY_LOOP_UNWIND;
 
       for(; i < mx; i += TILEDARRAY_LOOP_UNWIND, a += a_block_stride) {
 
@@ -269,7 +273,7 @@ namespace TiledArray {
           copy_block(y_block, y + j);
 
           // Load, compute, and store a block
-          OuterVectorOpUnwindN::outer(x_block, y_block, a + j, n, op);
+          OuterVectorOpUnwindN::outer(x_block, y_block, a + j, lda, op);
 
         }
 
@@ -278,7 +282,7 @@ namespace TiledArray {
           // Load a block
           A* const a_ij = a + j;
           TILEDARRAY_ALIGNED_STORAGE A a_block[TILEDARRAY_LOOP_UNWIND];
-          gather_block(a_block, a_ij, n);
+          gather_block(a_block, a_ij, lda);
 
           // Load y block
           const Y y_j = y[j];
@@ -294,7 +298,7 @@ namespace TiledArray {
         }
       }
 
-      for(; i < m; ++i, a += n) {
+      for(; i < m; ++i, a += lda) {
         const X x_i = x[i];
         inplace_vector_op([x_i,&op] (A& a_ij, const Y y_j) -> decltype(op(a_ij, x_i, y_j))
             { return op(a_ij, x_i, y_j); },
@@ -303,7 +307,7 @@ namespace TiledArray {
     }
 
 
-    /// Compute the outer of \c x, \c y, and \c a, and store the result in \c b
+    /// Compute the outer of \c x, \c y, and a block of \c a, and store the result in \c b
 
     /// Store a modified copy of \c a in \c b, where modified elements are
     /// generated using the following algorithm:
@@ -324,18 +328,20 @@ namespace TiledArray {
     /// \param[in] y The right-hand vector
     /// \param[in] a The input matrix of size \c m*n
     /// \param[out] b The output matrix of size \c m*n
+    /// \param[in] lda The row stride of \c a and \c b
     /// \param[in] op The operation that will compute the outer product elements
     template <typename X, typename Y, typename A, typename B, typename Op>
-    void outer_fill(const std::size_t m, const std::size_t n,
+    void outer_fill_block(const std::size_t m, const std::size_t n,
         const X* MADNESS_RESTRICT const x, const Y* MADNESS_RESTRICT const y,
-        const A* MADNESS_RESTRICT a, B* MADNESS_RESTRICT b, const Op& op)
+        const A* MADNESS_RESTRICT a, B* MADNESS_RESTRICT b, const std::size_t lda,
+        const Op& op)
     {
       std::size_t i = 0ul;
 
       // Compute block iteration limit
       const std::size_t mx = m & index_mask::value; // = m - m % TILEDARRAY_LOOP_UNWIND
       const std::size_t nx = n & index_mask::value; // = n - n % TILEDARRAY_LOOP_UNWIND
-      const std::size_t a_block_stride = n * TILEDARRAY_LOOP_UNWIND;
+      const std::size_t a_block_stride = lda * TILEDARRAY_LOOP_UNWIND;
 
       for(; i < mx; i += TILEDARRAY_LOOP_UNWIND, a += a_block_stride, b += a_block_stride) {
 
@@ -351,7 +357,7 @@ namespace TiledArray {
           copy_block(y_block, y + j);
 
           // Load, compute, and store a block
-          OuterVectorOpUnwindN::fill(x_block, y_block, a + j, b + j, n, op);
+          OuterVectorOpUnwindN::fill(x_block, y_block, a + j, b + j, lda, op);
 
         }
 
@@ -359,7 +365,7 @@ namespace TiledArray {
 
           // Load a block
           TILEDARRAY_ALIGNED_STORAGE A a_block[TILEDARRAY_LOOP_UNWIND];
-          gather_block(a_block, a + j, n);
+          gather_block(a_block, a + j, lda);
 
           // Load y block
           const Y y_j = y[j];
@@ -370,11 +376,11 @@ namespace TiledArray {
               a_block, x_block);
 
           // Store a block
-          scatter_block(b + j, n, a_block);
+          scatter_block(b + j, lda, a_block);
         }
       }
 
-      for(; i < m; ++i, a += n, b += n) {
+      for(; i < m; ++i, a += lda, b += lda) {
 
         // Load x block
         const X x_i = x[i];
@@ -411,6 +417,85 @@ namespace TiledArray {
       }
     }
 
+    /// Compute and store outer of \c x and \c y in \c a
+
+    /// <tt>a[i][j] = op(x[i], y[j])</tt>. The matrix is computed in cache
+    /// blocks, and panels of rows are computed in parallel (see
+    /// \c matrix_block_op() ).
+    /// \tparam X The left-hand vector element type
+    /// \tparam Y The right-hand vector element type
+    /// \tparam A The a matrix element type
+    /// \param[in] m The size of the left-hand vector
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] x The left-hand vector
+    /// \param[in] y The right-hand vector
+    /// \param[out] a The result matrix of size \c m*n
+    /// \param[in] op The operation that will compute the outer product elements
+    template <typename X, typename Y, typename A, typename Op>
+    void outer_fill(const std::size_t m, const std::size_t n,
+        const X* const x, const Y* const y, A* a, const Op& op)
+    {
+      matrix_block_op([=,&op] (const std::size_t i, const std::size_t mi,
+          const std::size_t j, const std::size_t nj)
+          { outer_fill_block(mi, nj, x + i, y + j, a + (i * n + j), n, op); },
+          m, n, false);
+    }
+
+    /// Compute the outer of \c x and \c y to modify \c a
+
+    /// Compute <tt>op(a[i][j], x[i], y[j])</tt> for each \c i and \c j pair,
+    /// where \c a[i][j] is modified by \c op. The matrix is computed in cache
+    /// blocks, and panels of rows are computed in parallel (see
+    /// \c matrix_block_op() ).
+    /// \tparam X The left hand vector element type
+    /// \tparam Y The right-hand vector element type
+    /// \tparam A The a matrix element type
+    /// \tparam Op The operation that will compute outer product elements
+    /// \param[in] m The size of the left-hand vector
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] x The left-hand vector
+    /// \param[in] y The right-hand vector
+    /// \param[in,out] a The result matrix of size \c m*n
+    /// \param[in] op The operation used to generate the result
+    template <typename X, typename Y, typename A, typename Op>
+    void outer(const std::size_t m, const std::size_t n,
+        const X* const x, const Y* const y, A* a, const Op& op)
+    {
+      matrix_block_op([=,&op] (const std::size_t i, const std::size_t mi,
+          const std::size_t j, const std::size_t nj)
+          { outer_block(mi, nj, x + i, y + j, a + (i * n + j), n, op); },
+          m, n, false);
+    }
+
+    /// Compute the outer of \c x, \c y, and \c a, and store the result in \c b
+
+    /// <tt>b[i][j] = op(a[i][j], x[i], y[j])</tt>, where \c op modifies a copy
+    /// of \c a[i][j] . The matrix is computed in cache blocks, and panels of
+    /// rows are computed in parallel (see \c matrix_block_op() ).
+    /// \tparam X The left hand vector element type
+    /// \tparam Y The right-hand vector element type
+    /// \tparam A The a matrix element type
+    /// \tparam B The b matrix element type
+    /// \tparam Op The operation that will compute outer product elements
+    /// \param[in] m The size of the left-hand vector
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] x The left-hand vector
+    /// \param[in] y The right-hand vector
+    /// \param[in] a The input matrix of size \c m*n
+    /// \param[out] b The output matrix of size \c m*n
+    /// \param[in] op The operation that will compute the outer product elements
+    template <typename X, typename Y, typename A, typename B, typename Op>
+    void outer_fill(const std::size_t m, const std::size_t n,
+        const X* MADNESS_RESTRICT const x, const Y* MADNESS_RESTRICT const y,
+        const A* MADNESS_RESTRICT a, B* MADNESS_RESTRICT b, const Op& op)
+    {
+      matrix_block_op([=,&op] (const std::size_t i, const std::size_t mi,
+          const std::size_t j, const std::size_t nj)
+          { outer_fill_block(mi, nj, x + i, y + j, a + (i * n + j), b + (i * n + j),
+              n, op); },
+          m, n, false);
+    }
+
   } // namespace math
 } // namespace TiledArray
 
@@ -27,143 +27,207 @@
 #define TILEDARRAY_PARALLEL_GEMM_H__INCLUDED
 
 #include <TiledArray/madness.h>
-#include <TiledArray/vector_op.h>
-#include <TiledArray/blas.h>
+#include <TiledArray/math/blas.h>
+#include <cstdint>
+#include <cstdlib>
 
-#define TILEDARRAY_DYNAMIC_BLOCK_SIZE std::numeric_limits<std::size_t>::max();
+/* The smallest m*n*k for which a matrix multiplication is divided into tasks. */
+#ifndef TILEDARRAY_PARALLEL_GEMM_THRESHOLD
+#define TILEDARRAY_PARALLEL_GEMM_THRESHOLD 16777216l
+#endif // TILEDARRAY_PARALLEL_GEMM_THRESHOLD
+
+/* The number of rows and columns in the result blocks of a parallel gemm. */
+#ifndef TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE
+#define TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE 256l
+#endif // TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE
 
 namespace TiledArray {
   namespace math {
 
-//#ifdef HAVE_INTEL_TBB
-
+    /// Runtime settings for the two-level (supertile/subtile) tiling of tile GEMMs
+
+    /// The tiles of an array are the unit of data distribution and
+    /// communication. By default they are also the unit of computation, and
+    /// a tile GEMM is divided into tasks only when it is large and the thread
+    /// pool is starved. For hierarchical tiling, the array is tiled with
+    /// large supertiles, which sets the process map granularity and message
+    /// sizes, and the tile GEMMs of contractions are always divided into
+    /// result blocks of \c subtile_size() rows and columns that are computed
+    /// by the local thread pool. The BLAS block size is then tuned with
+    /// \c set_subtile_size() independently of the tiling. Element-wise tile
+    /// operations already run in parallel over chunks of each tile.
+    /// Hierarchical tiling is enabled at startup when the \c TA_SUBTILE_SIZE
+    /// environment variable is set to the subtile size.
+    /// \note The settings are shared by all threads of a process, and should
+    /// only be changed when no contraction is running. Subtiles are computed
+    /// in parallel only in builds with TBB.
+    class Subtiling {
+    private:
+      integer subtile_size_; ///< The number of rows and columns in a subtile
+      integer threshold_; ///< The smallest m*n*k that is divided into subtiles
+      bool always_; ///< Divide tile GEMMs even when the thread pool is busy
+
+      Subtiling() :
+        subtile_size_(TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE),
+        threshold_(TILEDARRAY_PARALLEL_GEMM_THRESHOLD), always_(false)
+      {
+        const char* const size = getenv("TA_SUBTILE_SIZE");
+        if(size && (std::atol(size) > 0l))
+          enable(std::atol(size));
+      }
 
-    template <typename T, integer Size>
-    class MatrixBlockTask : public tbb::task {
+      Subtiling(const Subtiling&) = delete;
+      Subtiling& operator=(const Subtiling&) = delete;
 
-      const integer rows_;
-      const integer cols_;
-      T* data_;
-      const integer ld_;
-      std::shared_ptr<T> result_;
+    public:
 
-      /// Copy a \c Size^2 block from \c data to \c result
+      /// Settings accessor
 
-      /// \param[out] result A pointer to the first element of the result block
-      /// \param[in] data A pointer to the first element of the block to be copied
-      /// \param[in] ld The leading dimension stride for the \c data block
-      void copy_block(T* result, const T* data, const integer ld) {
-        const T* const block_end = result + (TILEDARRAY_LOOP_UNWIND * Size);
-        for(; result < block_end; result += Size, data += ld)
-          TiledArray::math::copy_block(result, data);
+      /// \return A reference to the subtiling settings of this process
+      static Subtiling& instance() {
+        static Subtiling settings;
+        return settings;
       }
 
-      /// Copy a rectangular \c m*n block from \c data to \c result
+      /// Enable hierarchical tiling
 
-      /// \param[in] m The number of rows to copy
-      /// \param[in] n The number of columns to copy
-      /// \param[out] result A pointer to the first element of the result block
-      /// \param[in] data A pointer to the first element of the block to be copied
-      /// \param[in] ld The leading dimension stride for the \c data block
-      void copy_block(const integer m, const integer n, T* result,
-          const T* data, const integer ld)
-      {
-        const T* const block_end = result + (m * Size);
-        for(; result < block_end; result += Size, data += ld)
-          TiledArray::math::copy_block(n, result, data);
+      /// All tile GEMMs with more than one subtile in the result are divided
+      /// into subtiles, regardless of the thread pool load.
+      /// \param subtile_size The number of rows and columns in a subtile
+      void enable(const integer subtile_size) {
+        set_subtile_size(subtile_size);
+        threshold_ = 0l;
+        always_ = true;
       }
 
-    public:
-      MatrixBlockTask(const integer rows, const integer cols,
-          const T* const data, const integer ld) :
-        rows_(rows), cols_(cols), data_(data), ld_(ld)
-      { }
-
-      /// Task body
-      virtual tbb::task* execut() {
-
-        // Compute block iteration limit
-        constexpr integer index_mask = ~integer(TILEDARRAY_LOOP_UNWIND - 1ul);
-        const integer mx = rows_ & index_mask; // = rows - rows % TILEDARRAY_LOOP_UNWIND
-        const integer nx = cols_ & index_mask; // = cols - cols % TILEDARRAY_LOOP_UNWIND
-        const integer m_tail = rows_ - mx;
-        const integer n_tail = cols_ - nx;
-
-        // Copy data into block_
-        integer i = 0ul;
-        T* result_i = result_.get();
-        const T* data_i = data_;
-        for(; i < mx; i += TILEDARRAY_LOOP_UNWIND, result_i += Size, data_i += ld_) {
+      /// Restore the default settings
 
-          integer j = 0ul;
-          for(; j < nx; j += TILEDARRAY_LOOP_UNWIND)
-            copy_block(result_i + j, data_i + j);
+      /// Large tile GEMMs are divided into blocks of
+      /// \c TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE only when the thread pool is
+      /// starved.
+      void disable() {
+        subtile_size_ = TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE;
+        threshold_ = TILEDARRAY_PARALLEL_GEMM_THRESHOLD;
+        always_ = false;
+      }
 
-          if(n_tail)
-            copy_block(TILEDARRAY_LOOP_UNWIND, n_tail, result_i + j, data_i + j);
-        }
+      /// Hierarchical tiling state accessor
 
-        if(m_tail) {
+      /// \return \c true if tile GEMMs are divided regardless of the thread
+      /// pool load
+      bool always() const { return always_; }
 
-          integer j = 0ul;
-          for(; j < nx; j += TILEDARRAY_LOOP_UNWIND)
-            copy_block(m_tail, TILEDARRAY_LOOP_UNWIND, result_i + j, data_i + j);
+      /// Subtile size accessor
 
-          if(n_tail)
-            copy_block(m_tail, n_tail, result_i + j, data_i + j);
+      /// \return The number of rows and columns in a subtile
+      integer subtile_size() const { return subtile_size_; }
 
-        }
+      /// Set the subtile size
 
-        return nullptr;
+      /// \param subtile_size The number of rows and columns in a subtile
+      void set_subtile_size(const integer subtile_size) {
+        TA_ASSERT(subtile_size > 0l);
+        subtile_size_ = subtile_size;
       }
 
-      std::shared_ptr<T> result() {
-        constexpr integer size = Size * Size;
-        constexpr integer bytes = size * sizeof(T);
+      /// Size threshold accessor
 
-        T* result_ptr = nullptr;
-        if(! posix_memalign(result_ptr, TILEARRAY_ALIGNMENT, bytes))
-          throw std::bad_alloc();
+      /// \return The smallest <tt>m*n*k</tt> that is divided into subtiles
+      integer threshold() const { return threshold_; }
 
-        result_.reset(result_ptr);
+      /// Set the size threshold
 
-        return result_;
+      /// \param threshold The smallest <tt>m*n*k</tt> that is divided into
+      /// subtiles
+      void set_threshold(const integer threshold) {
+        TA_ASSERT(threshold >= 0l);
+        threshold_ = threshold;
       }
 
-    }; // class MatrixBlockTask
-
-
-    template <integer Size, typename C, typename A = C, typename B = C, typename Alpha = C, typename Beta = C>
-    class GemmTask : public tbb::task {
-      const madness::cblas::CBLAS_TRANSPOSE op_a_, op_b_;
-      const integer m_, n_, k_;
-      const Alpha alpha_;
-      std::shared_ptr<A> a_;
-      constexpr integer lda_ = Size;
-      std::shared_ptr<B> b_;
-      const Beta beta_;
-      std::shared_ptr<C> c_;
-      const integer ldc_;
-
-    public:
-
-
-      GemmTask(madness::cblas::CBLAS_TRANSPOSE op_a,
-          madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
-          const integer k, const Alpha alpha, const std::shared_ptr<A>& a,
-          const std::shared_ptr<B>& b, const Beta beta,
-          const std::shared_ptr<C>& c, const integer ldc) :
-            op_a_(op_a), op_b_(op_b), m_(m), n_(n), k_(k), alpha_(alpha), a_(a),
-            b_(b), beta_(beta), c_(c), ldc_(c)
-      { }
-
-      virtual tbb::task execute() {
-        gemm(op_a_, op_b_, m_, n_, k_, alpha_, a_.get(), Size, b_.get(), Size, c_, ldc_);
+    }; // class Subtiling
+
+    /// Check if a matrix multiplication should be divided into tasks
+
+    /// By default, a large multiplication is run in parallel when the thread
+    /// pool does not have enough queued tasks to keep all threads busy.
+    /// Otherwise the multiplication runs on the calling thread, and the
+    /// parallelism comes from the other tile tasks. With hierarchical tiling
+    /// (see \c Subtiling ) the multiplication is always divided.
+    /// \param m The number of rows in the result matrix
+    /// \param n The number of columns in the result matrix
+    /// \param k The inner dimension of the multiplication
+    /// \return \c true if <tt>m*n*k</tt> is at least
+    /// \c Subtiling::threshold() , the result has more than one subtile, and
+    /// hierarchical tiling is enabled or there are fewer queued tasks than
+    /// threads
+    inline bool use_parallel_gemm(const integer m, const integer n, const integer k) {
+#ifdef HAVE_INTEL_TBB
+      const Subtiling& settings = Subtiling::instance();
+      const integer subtile_size = settings.subtile_size();
+      return ((std::int64_t(m) * std::int64_t(n) * std::int64_t(k)) >=
+              std::int64_t(settings.threshold()))
+          && ((m > subtile_size) || (n > subtile_size))
+          && (settings.always() ||
+              (madness::ThreadPool::queue_size() < madness::ThreadPool::size()));
+#else
+      return false;
+#endif // HAVE_INTEL_TBB
+    }
+
+    /// Cache blocked, task parallel matrix multiplication
+
+    /// Compute <tt>c = alpha * op_a(a) * op_b(b) + beta * c</tt>, where all
+    /// matrices are row-major. When \c use_parallel_gemm returns \c true , the
+    /// result matrix is divided into blocks of at most
+    /// \c Subtiling::subtile_size() rows and columns, and the blocks
+    /// are computed by TBB tasks with \c gemm . Each task reads a panel of
+    /// rows of <tt>op_a(a)</tt> and columns of <tt>op_b(b)</tt> and writes a
+    /// disjoint block of \c c , so the tasks need no synchronization.
+    /// Otherwise \c gemm is called directly.
+    /// \note The BLAS library should run single threaded, so its threads do
+    /// not compete with the thread pool.
+    /// \param op_a The operation applied to \c a
+    /// \param op_b The operation applied to \c b
+    /// \param m The number of rows in <tt>op_a(a)</tt> and \c c
+    /// \param n The number of columns in <tt>op_b(b)</tt> and \c c
+    /// \param k The number of columns in <tt>op_a(a)</tt> and rows in <tt>op_b(b)</tt>
+    /// \param alpha The scaling factor applied to <tt>op_a(a) * op_b(b)</tt>
+    /// \param a The left-hand matrix
+    /// \param lda The leading dimension of \c a
+    /// \param b The right-hand matrix
+    /// \param ldb The leading dimension of \c b
+    /// \param beta The scaling factor applied to \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline void parallel_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const T2* b, const integer ldb, const S2 beta, T3* c, const integer ldc)
+    {
+#ifdef HAVE_INTEL_TBB
+      if(use_parallel_gemm(m, n, k)) {
+        const integer block_size = Subtiling::instance().subtile_size();
+        const tbb::blocked_range2d<integer> range(0, m, block_size, 0, n, block_size);
+
+        tbb::parallel_for(range, [=] (const tbb::blocked_range2d<integer>& block) {
+          const integer i = block.rows().begin();
+          const integer j = block.cols().begin();
+
+          // Offsets of the first row of op_a(a) and column of op_b(b)
+          const T1* const a_i = a + (op_a == madness::cblas::NoTrans ? i * lda : i);
+          const T2* const b_j = b + (op_b == madness::cblas::NoTrans ? j : j * ldb);
+
+          gemm(op_a, op_b, block.rows().size(), block.cols().size(), k, alpha,
+              a_i, lda, b_j, ldb, beta, c + i * ldc + j, ldc);
+        }, tbb::simple_partitioner());
+
+        return;
       }
+#endif // HAVE_INTEL_TBB
 
-    }; // class GemmTask
-
-//#endif // HAVE_INTEL_TBB
+      gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+    }
 
   }  // namespace math
 } // namespace TiledArray
@@ -188,7 +188,7 @@ namespace TiledArray {
 
 
     //TODO reduce_op
-    /// Reduce the rows of a matrix
+    /// Reduce the rows of a block of a matrix
 
     /// <tt>op(result[i], left[i][j], right[j])</tt>.
     /// \tparam Left The left-hand matrix element type
@@ -199,11 +199,13 @@ namespace TiledArray {
     /// \param[in] left An m*n matrix
     /// \param[in] right A vector of size n
     /// \param[out] result The result vector of size m
+    /// \param[in] ld The row stride of the matrix
     /// \param[in] op The operation that will reduce the rows of left
     template <typename Left, typename Right, typename Result, typename Op>
-    void row_reduce(const std::size_t m, const std::size_t n,
+    void row_reduce_block(const std::size_t m, const std::size_t n,
         const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
-        Result* MADNESS_RESTRICT const result, const Op& op)
+        Result* MADNESS_RESTRICT const result, const std::size_t ld,
+        const Op& op)
     {
       std::size_t i = 0ul;
 
@@ -218,7 +220,7 @@ namespace TiledArray {
         copy_block(result_block, result + i);
 
         // Compute left pointer offset
-        const Left* MADNESS_RESTRICT const left_i = left + (i * n);
+        const Left* MADNESS_RESTRICT const left_i = left + (i * ld);
 
         std::size_t j = 0ul;
         for(; j < nx; j += TILEDARRAY_LOOP_UNWIND) {
@@ -228,7 +230,7 @@ namespace TiledArray {
           copy_block(right_block, right + j);
 
           // Compute and store a block
-          PartialReduceUnwindN::row_reduce(left_i + j, n, right_block, result_block, op);
+          PartialReduceUnwindN::row_reduce(left_i + j, ld, right_block, result_block, op);
 
         }
 
@@ -239,7 +241,7 @@ namespace TiledArray {
 
           // Compute a block
           TILEDARRAY_ALIGNED_STORAGE Left left_block[TILEDARRAY_LOOP_UNWIND];
-          gather_block(left_block, left_i + j, n);
+          gather_block(left_block, left_i + j, ld);
           for_each_block([right_j,&op] (Result& result_ij, const Left left_i)
               { op(result_ij, left_i, right_j); }, result_block, left_block);
 
@@ -253,13 +255,13 @@ namespace TiledArray {
 
         // Load result block
         Result result_block = result[i];
-        reduce_op_serial(op, n, result_block, left + (i * n), right);
+        reduce_op_serial(op, n, result_block, left + (i * ld), right);
         result[i] = result_block;
       }
     }
 
 
-    /// Reduce the rows of a matrix
+    /// Reduce the rows of a block of a matrix
 
     /// <tt>op(result[i], arg[i][j])</tt>.
     /// \tparam Arg The left-hand vector element type
@@ -269,10 +271,12 @@ namespace TiledArray {
     /// \param[in] n The size of the right-hand vector
     /// \param[in] arg An m*n matrix
     /// \param[out] result The result vector of size m
+    /// \param[in] ld The row stride of the matrix
     /// \param[in] op The operation that will reduce the rows of left
     template <typename Arg, typename Result, typename Op>
-    void row_reduce(const std::size_t m, const std::size_t n,
-        const Arg* MADNESS_RESTRICT const arg,  Result* MADNESS_RESTRICT const result, const Op& op)
+    void row_reduce_block(const std::size_t m, const std::size_t n,
+        const Arg* MADNESS_RESTRICT const arg,  Result* MADNESS_RESTRICT const result,
+        const std::size_t ld, const Op& op)
     {
       std::size_t i = 0ul;
 
@@ -287,13 +291,13 @@ namespace TiledArray {
         copy_block(result_block, result + i);
 
         // Compute left pointer offset
-        const Arg* MADNESS_RESTRICT const arg_i = arg + (i * n);
+        const Arg* MADNESS_RESTRICT const arg_i = arg + (i * ld);
 
         std::size_t j = 0ul;
         for(; j < nx; j += TILEDARRAY_LOOP_UNWIND) {
 
           // Compute and store a block
-          PartialReduceUnwindN::row_reduce(arg_i + j, n, result_block, op);
+          PartialReduceUnwindN::row_reduce(arg_i + j, ld, result_block, op);
 
         }
 
@@ -301,7 +305,7 @@ namespace TiledArray {
 
           // Compute a block
           TILEDARRAY_ALIGNED_STORAGE Arg arg_block[TILEDARRAY_LOOP_UNWIND];
-          gather_block(arg_block, arg_i + j, n);
+          gather_block(arg_block, arg_i + j, ld);
           for_each_block(op, result_block, arg_block);
 
         }
@@ -314,12 +318,12 @@ namespace TiledArray {
 
         // Load result block
         Result result_block = result[i];
-        reduce_op_serial(op, n, result_block, arg + (i * n));
+        reduce_op_serial(op, n, result_block, arg + (i * ld));
         result[i] = result_block;
       }
     }
 
-    /// Reduce the columns of a matrix
+    /// Reduce the columns of a block of a matrix
 
     /// <tt>op(result[j], left[i][j], right[i])</tt>.
     /// \tparam Left The left-hand vector element type
@@ -331,11 +335,13 @@ namespace TiledArray {
     /// \param[in] left An m*n matrix
     /// \param[in] right A vector of size m
     /// \param[out] result The result vector of size n
+    /// \param[in] ld The row stride of the matrix
     /// \param[in] op The operation that will reduce the columns of left
     template <typename Left, typename Right, typename Result, typename Op>
-    void col_reduce(const std::size_t m, const std::size_t n,
+    void col_reduce_block(const std::size_t m, const std::size_t n,
         const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
-        Result* MADNESS_RESTRICT const result, const Op& op)
+        Result* MADNESS_RESTRICT const result, const std::size_t ld,
+        const Op& op)
     {
       std::size_t i = 0ul;
 
@@ -350,7 +356,7 @@ namespace TiledArray {
         copy_block(right_block, right + i);
 
         // Compute left pointer offset
-        const Left* MADNESS_RESTRICT const left_i = left + (i * n);
+        const Left* MADNESS_RESTRICT const left_i = left + (i * ld);
 
         std::size_t j = 0ul;
         for(; j < nx; j += TILEDARRAY_LOOP_UNWIND) {
@@ -360,7 +366,7 @@ namespace TiledArray {
           copy_block(result_block, result + j);
 
           // Compute and store a block
-          PartialReduceUnwindN::col_reduce(left_i + j, n, right_block, result_block, op);
+          PartialReduceUnwindN::col_reduce(left_i + j, ld, right_block, result_block, op);
 
           // Store the result
           copy_block(result + j, result_block);
@@ -373,7 +379,7 @@ namespace TiledArray {
 
           // Compute a block
           TILEDARRAY_ALIGNED_STORAGE Left left_block[TILEDARRAY_LOOP_UNWIND];
-          gather_block(left_block, left_i + j, n);
+          gather_block(left_block, left_i + j, ld);
           reduce_block(op, result_block, left_block, right_block);
 
           result[j] = result_block;
@@ -387,13 +393,13 @@ namespace TiledArray {
         const Right right_i = right[i];
 
         // Reduce row i to result
-        inplace_vector_op([&op,right_i] (Result& result_j, const Left left_ij) {
+        inplace_vector_op_serial([&op,right_i] (Result& result_j, const Left left_ij) {
           op(result_j, left_ij, right_i);
-        }, n, result, left + (i * n));
+        }, n, result, left + (i * ld));
       }
     }
 
-    /// Reduce the columns of a matrix
+    /// Reduce the columns of a block of a matrix
 
     /// <tt>op(result[j], arg[i][j])</tt>.
     /// \tparam Arg The argument vector element type
@@ -403,10 +409,12 @@ namespace TiledArray {
     /// \param[in] n The size of the right-hand vector
     /// \param[in] arg An m*n matrix
     /// \param[out] result The result vector of size n
+    /// \param[in] ld The row stride of the matrix
     /// \param[in] op The operation that will reduce the columns of left
     template <typename Arg, typename Result, typename Op>
-    void col_reduce(const std::size_t m, const std::size_t n,
-        const Arg* MADNESS_RESTRICT const arg, Result* MADNESS_RESTRICT const result, const Op& op)
+    void col_reduce_block(const std::size_t m, const std::size_t n,
+        const Arg* MADNESS_RESTRICT const arg, Result* MADNESS_RESTRICT const result,
+        const std::size_t ld, const Op& op)
     {
       std::size_t i = 0ul;
 
@@ -417,7 +425,7 @@ namespace TiledArray {
       for(; i < mx; i += TILEDARRAY_LOOP_UNWIND) {
 
         // Compute left pointer offset
-        const Arg* MADNESS_RESTRICT const arg_i = arg + (i * n);
+        const Arg* MADNESS_RESTRICT const arg_i = arg + (i * ld);
 
         std::size_t j = 0ul;
         for(; j < nx; j += TILEDARRAY_LOOP_UNWIND) {
@@ -427,7 +435,7 @@ namespace TiledArray {
           copy_block(result_block, result + j);
 
           // Compute and store a block
-          PartialReduceUnwindN::col_reduce(arg_i + j, n, result_block, op);
+          PartialReduceUnwindN::col_reduce(arg_i + j, ld, result_block, op);
 
           // Store the result
           copy_block(result + j, result_block);
@@ -440,7 +448,7 @@ namespace TiledArray {
 
           // Compute a block
           TILEDARRAY_ALIGNED_STORAGE Arg arg_block[TILEDARRAY_LOOP_UNWIND];
-          gather_block(arg_block, arg_i + j, n);
+          gather_block(arg_block, arg_i + j, ld);
           reduce_block(op, result_block, arg_block);
 
           result[j] = result_block;
@@ -452,10 +460,107 @@ namespace TiledArray {
       for(; i < m; ++i) {
 
         // Reduce row i to result
-        inplace_vector_op(op, n, result, arg + (i * n));
+        inplace_vector_op_serial(op, n, result, arg + (i * ld));
       }
     }
 
+    /// Reduce the rows of a matrix
+
+    /// <tt>op(result[i], left[i][j], right[j])</tt>. The matrix is reduced in
+    /// cache blocks, and panels of rows are reduced in parallel (see
+    /// \c matrix_block_op() ).
+    /// \tparam Left The left-hand matrix element type
+    /// \tparam Right The right-hand vector element type
+    /// \tparam Result The result vector element type
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] left An m*n matrix
+    /// \param[in] right A vector of size n
+    /// \param[out] result The result vector of size m
+    /// \param[in] op The operation that will reduce the rows of left
+    template <typename Left, typename Right, typename Result, typename Op>
+    void row_reduce(const std::size_t m, const std::size_t n,
+        const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
+        Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      matrix_block_op([=,&op] (const std::size_t i, const std::size_t mi,
+          const std::size_t j, const std::size_t nj)
+          { row_reduce_block(mi, nj, left + (i * n + j), right + j, result + i, n, op); },
+          m, n, false);
+    }
+
+    /// Reduce the rows of a matrix
+
+    /// <tt>op(result[i], arg[i][j])</tt>. The matrix is reduced in cache
+    /// blocks, and panels of rows are reduced in parallel (see
+    /// \c matrix_block_op() ).
+    /// \tparam Arg The left-hand vector element type
+    /// \tparam Result The a matrix element type
+    /// \tparam Op The operator type
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] arg An m*n matrix
+    /// \param[out] result The result vector of size m
+    /// \param[in] op The operation that will reduce the rows of left
+    template <typename Arg, typename Result, typename Op>
+    void row_reduce(const std::size_t m, const std::size_t n,
+        const Arg* MADNESS_RESTRICT const arg,  Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      matrix_block_op([=,&op] (const std::size_t i, const std::size_t mi,
+          const std::size_t j, const std::size_t nj)
+          { row_reduce_block(mi, nj, arg + (i * n + j), result + i, n, op); },
+          m, n, false);
+    }
+
+    /// Reduce the columns of a matrix
+
+    /// <tt>op(result[j], left[i][j], right[i])</tt>. The matrix is reduced in
+    /// cache blocks, and panels of columns are reduced in parallel (see
+    /// \c matrix_block_op() ).
+    /// \tparam Left The left-hand vector element type
+    /// \tparam Right The right-hand vector element type
+    /// \tparam Result The a matrix element type
+    /// \tparam Op The operator type
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] left An m*n matrix
+    /// \param[in] right A vector of size m
+    /// \param[out] result The result vector of size n
+    /// \param[in] op The operation that will reduce the columns of left
+    template <typename Left, typename Right, typename Result, typename Op>
+    void col_reduce(const std::size_t m, const std::size_t n,
+        const Left* MADNESS_RESTRICT const left, const Right* MADNESS_RESTRICT const right,
+        Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      matrix_block_op([=,&op] (const std::size_t i, const std::size_t mi,
+          const std::size_t j, const std::size_t nj)
+          { col_reduce_block(mi, nj, left + (i * n + j), right + i, result + j, n, op); },
+          m, n, true);
+    }
+
+    /// Reduce the columns of a matrix
+
+    /// <tt>op(result[j], arg[i][j])</tt>. The matrix is reduced in cache
+    /// blocks, and panels of columns are reduced in parallel (see
+    /// \c matrix_block_op() ).
+    /// \tparam Arg The argument vector element type
+    /// \tparam Result The a matrix element type
+    /// \tparam Op The operator type
+    /// \param[in] m The number of rows in left
+    /// \param[in] n The size of the right-hand vector
+    /// \param[in] arg An m*n matrix
+    /// \param[out] result The result vector of size n
+    /// \param[in] op The operation that will reduce the columns of left
+    template <typename Arg, typename Result, typename Op>
+    void col_reduce(const std::size_t m, const std::size_t n,
+        const Arg* MADNESS_RESTRICT const arg, Result* MADNESS_RESTRICT const result, const Op& op)
+    {
+      matrix_block_op([=,&op] (const std::size_t i, const std::size_t mi,
+          const std::size_t j, const std::size_t nj)
+          { col_reduce_block(mi, nj, arg + (i * n + j), result + j, n, op); },
+          m, n, true);
+    }
+
   }  // namespace math
 } // namespace TiledArray
 
@@ -0,0 +1,1052 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  simd.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SIMD_H__INCLUDED
+#define TILEDARRAY_MATH_SIMD_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/tensor/complex.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// Select the instruction sets that may be used at runtime. The x86 kernels
+// are compiled with function target attributes, so they do not require
+// architecture flags at compile time. Define TILEDARRAY_DISABLE_SIMD to use
+// the generic vector operations only.
+#ifndef TILEDARRAY_DISABLE_SIMD
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define TILEDARRAY_HAVE_SIMD_X86 1
+#include <immintrin.h>
+#define TILEDARRAY_SIMD_AVX2_TARGET __attribute__((target("avx2,fma")))
+#define TILEDARRAY_SIMD_AVX512_TARGET __attribute__((target("avx512f,avx2,fma")))
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define TILEDARRAY_HAVE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif // TILEDARRAY_DISABLE_SIMD
+
+// Transposed matrices of at least this number of bytes are written with
+// non-temporal stores, so they do not evict the argument from the cache.
+#ifndef TILEDARRAY_SIMD_STREAM_BYTES
+#define TILEDARRAY_SIMD_STREAM_BYTES 1048576
+#endif // TILEDARRAY_SIMD_STREAM_BYTES
+
+namespace TiledArray {
+  namespace math {
+
+    /// Instruction sets of the SIMD vector kernels
+    enum class SimdIsa {
+      scalar, ///< Generic vector operations
+      neon,   ///< ARM NEON (AArch64)
+      avx2,   ///< x86 AVX2 and FMA
+      avx512  ///< x86 AVX-512F
+    };
+
+    /// Element-wise binary operations with SIMD kernels
+    enum class SimdBinary { add, subt, mult };
+
+    /// Output modes of the SIMD transpose kernels
+    enum class SimdTransposeOutput {
+      assign, ///< <tt>result = x</tt>
+      stream, ///< <tt>result = x</tt> , with non-temporal stores
+      add     ///< <tt>result += x</tt>
+    };
+
+    /// Tag type for SIMD binary operations
+    template <SimdBinary Op>
+    using SimdBinaryTag = std::integral_constant<SimdBinary, Op>;
+
+    /// Check if an instruction set is supported by this process
+
+    /// \param isa The instruction set
+    /// \return \c true if the SIMD kernels for \c isa were compiled and the
+    /// processor supports \c isa
+    inline bool simd_supported(const SimdIsa isa) {
+      switch(isa) {
+        case SimdIsa::scalar:
+          return true;
+#ifdef TILEDARRAY_HAVE_SIMD_NEON
+        case SimdIsa::neon:
+          return true;
+#endif // TILEDARRAY_HAVE_SIMD_NEON
+#ifdef TILEDARRAY_HAVE_SIMD_X86
+        case SimdIsa::avx2:
+          __builtin_cpu_init();
+          return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case SimdIsa::avx512:
+          __builtin_cpu_init();
+          return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2")
+              && __builtin_cpu_supports("fma");
+#endif // TILEDARRAY_HAVE_SIMD_X86
+        default:
+          return false;
+      }
+    }
+
+    namespace simd {
+
+      /// The best instruction set supported by this process
+
+      /// The \c TA_SIMD environment variable, which may be \c scalar ,
+      /// \c neon , \c avx2 , or \c avx512 , limits the selection.
+      /// \return The default instruction set of the vector kernels
+      inline SimdIsa default_isa() {
+        SimdIsa isa = SimdIsa::avx512;
+        if(const char* const env = getenv("TA_SIMD")) {
+          if(! strcmp(env, "scalar"))
+            isa = SimdIsa::scalar;
+          else if(! strcmp(env, "neon"))
+            isa = SimdIsa::neon;
+          else if(! strcmp(env, "avx2"))
+            isa = SimdIsa::avx2;
+        }
+
+        for(; isa != SimdIsa::scalar; isa = SimdIsa(int(isa) - 1))
+          if(simd_supported(isa))
+            break;
+
+        return isa;
+      }
+
+      /// Instruction set accessor
+
+      /// \return A reference to the instruction set used by the vector kernels
+      inline SimdIsa& isa_ref() {
+        static SimdIsa isa = default_isa();
+        return isa;
+      }
+
+      /// Element types with SIMD kernels
+      template <typename T>
+      struct is_simd_type :
+          public std::integral_constant<bool, std::is_same<T, double>::value
+          || std::is_same<T, float>::value>
+      { };
+
+      /// Element types with SIMD transpose kernels
+      template <typename T>
+      struct is_simd_transpose_type :
+          public std::integral_constant<bool, is_simd_type<T>::value
+          || std::is_same<T, std::complex<double> >::value
+          || std::is_same<T, std::complex<float> >::value>
+      { };
+
+    } // namespace simd
+
+    /// The instruction set used by the vector kernels
+
+    /// \return The current instruction set
+    inline SimdIsa simd_isa() { return simd::isa_ref(); }
+
+    /// Set the instruction set used by the vector kernels
+
+    /// \param isa The new instruction set
+    /// \throw TiledArray::Exception When \c isa is not supported
+    /// \note This function is not thread safe; it should only be called when
+    /// no vector operations are running.
+    inline void simd_isa(const SimdIsa isa) {
+      TA_USER_ASSERT(simd_supported(isa),
+          "TiledArray::math::simd_isa(): The instruction set is not supported.");
+      simd::isa_ref() = isa;
+    }
+
+    // Element-wise operations of Tensor. The operations are implemented as
+    // named types, instead of lambdas, so the vector operations can select a
+    // SIMD kernel for them.
+
+    /// Binary element operation
+
+    /// \tparam Op The binary operation
+    template <SimdBinary Op> struct SimdBinaryOp;
+
+    template <>
+    struct SimdBinaryOp<SimdBinary::add> {
+      template <typename L, typename R>
+      static auto eval(const L l, const R r) -> decltype(l + r) { return l + r; }
+
+      template <typename L, typename R>
+      static L& eval_to(L& l, const R r) { return l += r; }
+    }; // struct SimdBinaryOp<SimdBinary::add>
+
+    template <>
+    struct SimdBinaryOp<SimdBinary::subt> {
+      template <typename L, typename R>
+      static auto eval(const L l, const R r) -> decltype(l - r) { return l - r; }
+
+      template <typename L, typename R>
+      static L& eval_to(L& l, const R r) { return l -= r; }
+    }; // struct SimdBinaryOp<SimdBinary::subt>
+
+    template <>
+    struct SimdBinaryOp<SimdBinary::mult> {
+      template <typename L, typename R>
+      static auto eval(const L l, const R r) -> decltype(l * r) { return l * r; }
+
+      template <typename L, typename R>
+      static L& eval_to(L& l, const R r) { return l *= r; }
+    }; // struct SimdBinaryOp<SimdBinary::mult>
+
+    /// Binary vector operation: <tt>l op r</tt>
+
+    /// \tparam Op The binary operation
+    /// \tparam T The result element type
+    template <SimdBinary Op, typename T>
+    struct BinaryVectorOp {
+      template <typename L, typename R>
+      T operator()(const L l, const R r) const { return SimdBinaryOp<Op>::eval(l, r); }
+    }; // struct BinaryVectorOp
+
+    /// Scaled binary vector operation: <tt>(l op r) * factor</tt>
+
+    /// \tparam Op The binary operation
+    /// \tparam T The result element type
+    /// \tparam Scalar The scaling factor type
+    template <SimdBinary Op, typename T, typename Scalar>
+    struct ScalBinaryVectorOp {
+      Scalar factor; ///< The scaling factor
+
+      template <typename L, typename R>
+      T operator()(const L l, const R r) const
+      { return SimdBinaryOp<Op>::eval(l, r) * factor; }
+    }; // struct ScalBinaryVectorOp
+
+    /// In-place binary vector operation: <tt>l op= r</tt>
+
+    /// \tparam Op The binary operation
+    /// \tparam T The result element type
+    template <SimdBinary Op, typename T>
+    struct InplaceBinaryVectorOp {
+      template <typename R>
+      void operator()(T& MADNESS_RESTRICT l, const R r) const
+      { SimdBinaryOp<Op>::eval_to(l, r); }
+    }; // struct InplaceBinaryVectorOp
+
+    /// Scaled in-place binary vector operation: <tt>(l op= r) *= factor</tt>
+
+    /// \tparam Op The binary operation
+    /// \tparam T The result element type
+    /// \tparam Scalar The scaling factor type
+    template <SimdBinary Op, typename T, typename Scalar>
+    struct ScalInplaceBinaryVectorOp {
+      Scalar factor; ///< The scaling factor
+
+      template <typename R>
+      void operator()(T& MADNESS_RESTRICT l, const R r) const
+      { SimdBinaryOp<Op>::eval_to(l, r) *= factor; }
+    }; // struct ScalInplaceBinaryVectorOp
+
+    /// Scale vector operation: <tt>a * factor</tt>
+
+    /// \tparam T The result element type
+    /// \tparam Scalar The scaling factor type
+    template <typename T, typename Scalar>
+    struct ScalVectorOp {
+      Scalar factor; ///< The scaling factor
+
+      template <typename A>
+      T operator()(const A a) const { return a * factor; }
+    }; // struct ScalVectorOp
+
+    /// Copy vector operation: <tt>a</tt>
+
+    /// \tparam T The result element type
+    template <typename T>
+    struct CopyVectorOp {
+      template <typename A>
+      T operator()(const A a) const { return a; }
+    }; // struct CopyVectorOp
+
+    /// Initializing output operation: <tt>new(result) T(x)</tt>
+
+    /// \tparam T The result element type
+    template <typename T>
+    struct InitOutputOp {
+      void operator()(T* MADNESS_RESTRICT const result, const T& x) const
+      { new(result) T(x); }
+    }; // struct InitOutputOp
+
+    /// Accumulating output operation: <tt>*result += x</tt>
+
+    /// \tparam T The result element type
+    template <typename T>
+    struct AddToOutputOp {
+      void operator()(T* MADNESS_RESTRICT const result, const T& x) const
+      { *result += x; }
+    }; // struct AddToOutputOp
+
+    /// In-place scale vector operation: <tt>a *= factor</tt>
+
+    /// \tparam T The result element type
+    /// \tparam Scalar The scaling factor type
+    template <typename T, typename Scalar>
+    struct ScalInplaceVectorOp {
+      Scalar factor; ///< The scaling factor
+
+      void operator()(T& MADNESS_RESTRICT a) const { a *= factor; }
+    }; // struct ScalInplaceVectorOp
+
+    /// Dot product reduction operation: <tt>res += l * r</tt>
+
+    /// \tparam T The result type
+    template <typename T>
+    struct DotReduceOp {
+      template <typename L, typename R>
+      void operator()(T& res, const L l, const R r) const { res += l * r; }
+    }; // struct DotReduceOp
+
+    /// Squared norm reduction operation: <tt>res += norm(a)</tt>
+
+    /// \tparam T The result type
+    template <typename T>
+    struct SquaredNormReduceOp {
+      template <typename A>
+      void operator()(T& MADNESS_RESTRICT res, const A a) const
+      { res += TiledArray::detail::norm(a); }
+    }; // struct SquaredNormReduceOp
+
+    namespace simd {
+
+#ifdef TILEDARRAY_HAVE_SIMD_X86
+
+      /// AVX2 vector traits
+      template <typename T> struct Avx2Vector;
+
+      template <>
+      struct Avx2Vector<double> {
+        typedef __m256d reg_type;
+        static constexpr std::size_t width = 4ul;
+
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type mask(const std::size_t m)
+        { return _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_set1_epi64x(m),
+              _mm256_setr_epi64x(0, 1, 2, 3))); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type zero() { return _mm256_setzero_pd(); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type set1(const double x) { return _mm256_set1_pd(x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type load(const double* p) { return _mm256_loadu_pd(p); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type load_n(const double* p, const std::size_t m)
+        { return _mm256_maskload_pd(p, _mm256_castpd_si256(mask(m))); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void store(double* p, const reg_type x) { _mm256_storeu_pd(p, x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void store_n(double* p, const reg_type x, const std::size_t m)
+        { _mm256_maskstore_pd(p, _mm256_castpd_si256(mask(m)), x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type add(const reg_type a, const reg_type b) { return _mm256_add_pd(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type sub(const reg_type a, const reg_type b) { return _mm256_sub_pd(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type mul(const reg_type a, const reg_type b) { return _mm256_mul_pd(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type fmadd(const reg_type a, const reg_type b, const reg_type c)
+        { return _mm256_fmadd_pd(a, b, c); }
+        TILEDARRAY_SIMD_AVX2_TARGET static double sum(const reg_type x) {
+          const __m128d s = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+          return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+        }
+        TILEDARRAY_SIMD_AVX2_TARGET static void stream(double* p, const reg_type x) { _mm256_stream_pd(p, x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void transpose(reg_type* const r) {
+          const reg_type t0 = _mm256_unpacklo_pd(r[0], r[1]);
+          const reg_type t1 = _mm256_unpackhi_pd(r[0], r[1]);
+          const reg_type t2 = _mm256_unpacklo_pd(r[2], r[3]);
+          const reg_type t3 = _mm256_unpackhi_pd(r[2], r[3]);
+          r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+          r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+          r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+          r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+        }
+      }; // struct Avx2Vector<double>
+
+      template <>
+      struct Avx2Vector<float> {
+        typedef __m256 reg_type;
+        static constexpr std::size_t width = 8ul;
+
+        TILEDARRAY_SIMD_AVX2_TARGET static __m256i mask(const std::size_t m)
+        { return _mm256_cmpgt_epi32(_mm256_set1_epi32(m), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type zero() { return _mm256_setzero_ps(); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type set1(const float x) { return _mm256_set1_ps(x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type load(const float* p) { return _mm256_loadu_ps(p); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type load_n(const float* p, const std::size_t m)
+        { return _mm256_maskload_ps(p, mask(m)); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void store(float* p, const reg_type x) { _mm256_storeu_ps(p, x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void store_n(float* p, const reg_type x, const std::size_t m)
+        { _mm256_maskstore_ps(p, mask(m), x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type add(const reg_type a, const reg_type b) { return _mm256_add_ps(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type sub(const reg_type a, const reg_type b) { return _mm256_sub_ps(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type mul(const reg_type a, const reg_type b) { return _mm256_mul_ps(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type fmadd(const reg_type a, const reg_type b, const reg_type c)
+        { return _mm256_fmadd_ps(a, b, c); }
+        TILEDARRAY_SIMD_AVX2_TARGET static float sum(const reg_type x) {
+          __m128 s = _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+          s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+          return _mm_cvtss_f32(_mm_add_ss(s, _mm_movehdup_ps(s)));
+        }
+        TILEDARRAY_SIMD_AVX2_TARGET static void stream(float* p, const reg_type x) { _mm256_stream_ps(p, x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void transpose(reg_type* const r) {
+          reg_type t[8];
+          for(std::size_t k = 0ul; k < 8ul; k += 2ul) {
+            t[k] = _mm256_unpacklo_ps(r[k], r[k + 1ul]);
+            t[k + 1ul] = _mm256_unpackhi_ps(r[k], r[k + 1ul]);
+          }
+          for(std::size_t k = 0ul; k < 8ul; k += 4ul) {
+            r[k] = _mm256_shuffle_ps(t[k], t[k + 2ul], 0x44);
+            r[k + 1ul] = _mm256_shuffle_ps(t[k], t[k + 2ul], 0xee);
+            r[k + 2ul] = _mm256_shuffle_ps(t[k + 1ul], t[k + 3ul], 0x44);
+            r[k + 3ul] = _mm256_shuffle_ps(t[k + 1ul], t[k + 3ul], 0xee);
+          }
+          for(std::size_t k = 0ul; k < 4ul; ++k) {
+            t[k] = _mm256_permute2f128_ps(r[k], r[k + 4ul], 0x20);
+            t[k + 4ul] = _mm256_permute2f128_ps(r[k], r[k + 4ul], 0x31);
+          }
+          std::copy(t, t + 8, r);
+        }
+      }; // struct Avx2Vector<float>
+
+      // The complex traits provide the operations of the transpose kernel,
+      // where the scaling factor is real. Complex elements are moved as
+      // 64-bit or 128-bit lanes.
+
+      template <>
+      struct Avx2Vector<std::complex<float> > {
+        typedef __m256 reg_type;
+        static constexpr std::size_t width = 4ul;
+
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type set1(const float x) { return _mm256_set1_ps(x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type load(const std::complex<float>* p)
+        { return _mm256_loadu_ps(reinterpret_cast<const float*>(p)); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void store(std::complex<float>* p, const reg_type x)
+        { _mm256_storeu_ps(reinterpret_cast<float*>(p), x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void stream(std::complex<float>* p, const reg_type x)
+        { _mm256_stream_ps(reinterpret_cast<float*>(p), x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type add(const reg_type a, const reg_type b) { return _mm256_add_ps(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type mul(const reg_type a, const reg_type b) { return _mm256_mul_ps(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void transpose(reg_type* const r) {
+          __m256d d[4];
+          for(std::size_t k = 0ul; k < 4ul; ++k)
+            d[k] = _mm256_castps_pd(r[k]);
+          Avx2Vector<double>::transpose(d);
+          for(std::size_t k = 0ul; k < 4ul; ++k)
+            r[k] = _mm256_castpd_ps(d[k]);
+        }
+      }; // struct Avx2Vector<std::complex<float> >
+
+      template <>
+      struct Avx2Vector<std::complex<double> > {
+        typedef __m256d reg_type;
+        static constexpr std::size_t width = 2ul;
+
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type set1(const double x) { return _mm256_set1_pd(x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type load(const std::complex<double>* p)
+        { return _mm256_loadu_pd(reinterpret_cast<const double*>(p)); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void store(std::complex<double>* p, const reg_type x)
+        { _mm256_storeu_pd(reinterpret_cast<double*>(p), x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void stream(std::complex<double>* p, const reg_type x)
+        { _mm256_stream_pd(reinterpret_cast<double*>(p), x); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type add(const reg_type a, const reg_type b) { return _mm256_add_pd(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static reg_type mul(const reg_type a, const reg_type b) { return _mm256_mul_pd(a, b); }
+        TILEDARRAY_SIMD_AVX2_TARGET static void transpose(reg_type* const r) {
+          const reg_type t0 = _mm256_permute2f128_pd(r[0], r[1], 0x20);
+          r[1] = _mm256_permute2f128_pd(r[0], r[1], 0x31);
+          r[0] = t0;
+        }
+      }; // struct Avx2Vector<std::complex<double> >
+
+      /// AVX-512 vector traits
+      template <typename T> struct Avx512Vector;
+
+      template <>
+      struct Avx512Vector<double> {
+        typedef __m512d reg_type;
+        static constexpr std::size_t width = 8ul;
+
+        TILEDARRAY_SIMD_AVX512_TARGET static __mmask8 mask(const std::size_t m)
+        { return __mmask8((1u << m) - 1u); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type zero() { return _mm512_setzero_pd(); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type set1(const double x) { return _mm512_set1_pd(x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type load(const double* p) { return _mm512_loadu_pd(p); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type load_n(const double* p, const std::size_t m)
+        { return _mm512_maskz_loadu_pd(mask(m), p); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void store(double* p, const reg_type x) { _mm512_storeu_pd(p, x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void store_n(double* p, const reg_type x, const std::size_t m)
+        { _mm512_mask_storeu_pd(p, mask(m), x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type add(const reg_type a, const reg_type b) { return _mm512_add_pd(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type sub(const reg_type a, const reg_type b) { return _mm512_sub_pd(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type mul(const reg_type a, const reg_type b) { return _mm512_mul_pd(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type fmadd(const reg_type a, const reg_type b, const reg_type c)
+        { return _mm512_fmadd_pd(a, b, c); }
+        TILEDARRAY_SIMD_AVX512_TARGET static double sum(const reg_type x) { return _mm512_reduce_add_pd(x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void stream(double* p, const reg_type x) { _mm512_stream_pd(p, x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void transpose(reg_type* const r) {
+          reg_type t[8];
+          for(std::size_t k = 0ul; k < 8ul; k += 2ul) {
+            t[k] = _mm512_unpacklo_pd(r[k], r[k + 1ul]);
+            t[k + 1ul] = _mm512_unpackhi_pd(r[k], r[k + 1ul]);
+          }
+          // t[2k] and t[2k+1] hold the even and odd columns of rows 2k and 2k+1
+          // in 128-bit lanes, which are transposed as a 4x4 lane matrix.
+          for(std::size_t k = 0ul; k < 2ul; ++k) {
+            const reg_type u0 = _mm512_shuffle_f64x2(t[k], t[k + 2ul], 0x88);
+            const reg_type u1 = _mm512_shuffle_f64x2(t[k], t[k + 2ul], 0xdd);
+            const reg_type u2 = _mm512_shuffle_f64x2(t[k + 4ul], t[k + 6ul], 0x88);
+            const reg_type u3 = _mm512_shuffle_f64x2(t[k + 4ul], t[k + 6ul], 0xdd);
+            r[k] = _mm512_shuffle_f64x2(u0, u2, 0x88);
+            r[k + 2ul] = _mm512_shuffle_f64x2(u1, u3, 0x88);
+            r[k + 4ul] = _mm512_shuffle_f64x2(u0, u2, 0xdd);
+            r[k + 6ul] = _mm512_shuffle_f64x2(u1, u3, 0xdd);
+          }
+        }
+      }; // struct Avx512Vector<double>
+
+      template <>
+      struct Avx512Vector<float> {
+        typedef __m512 reg_type;
+        static constexpr std::size_t width = 16ul;
+
+        TILEDARRAY_SIMD_AVX512_TARGET static __mmask16 mask(const std::size_t m)
+        { return __mmask16((1u << m) - 1u); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type zero() { return _mm512_setzero_ps(); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type set1(const float x) { return _mm512_set1_ps(x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type load(const float* p) { return _mm512_loadu_ps(p); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type load_n(const float* p, const std::size_t m)
+        { return _mm512_maskz_loadu_ps(mask(m), p); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void store(float* p, const reg_type x) { _mm512_storeu_ps(p, x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void store_n(float* p, const reg_type x, const std::size_t m)
+        { _mm512_mask_storeu_ps(p, mask(m), x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type add(const reg_type a, const reg_type b) { return _mm512_add_ps(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type sub(const reg_type a, const reg_type b) { return _mm512_sub_ps(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type mul(const reg_type a, const reg_type b) { return _mm512_mul_ps(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type fmadd(const reg_type a, const reg_type b, const reg_type c)
+        { return _mm512_fmadd_ps(a, b, c); }
+        TILEDARRAY_SIMD_AVX512_TARGET static float sum(const reg_type x) { return _mm512_reduce_add_ps(x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void stream(float* p, const reg_type x) { _mm512_stream_ps(p, x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void transpose(reg_type* const r) {
+          reg_type t[16];
+          for(std::size_t k = 0ul; k < 16ul; k += 2ul) {
+            t[k] = _mm512_unpacklo_ps(r[k], r[k + 1ul]);
+            t[k + 1ul] = _mm512_unpackhi_ps(r[k], r[k + 1ul]);
+          }
+          for(std::size_t k = 0ul; k < 16ul; k += 4ul) {
+            r[k] = _mm512_shuffle_ps(t[k], t[k + 2ul], 0x44);
+            r[k + 1ul] = _mm512_shuffle_ps(t[k], t[k + 2ul], 0xee);
+            r[k + 2ul] = _mm512_shuffle_ps(t[k + 1ul], t[k + 3ul], 0x44);
+            r[k + 3ul] = _mm512_shuffle_ps(t[k + 1ul], t[k + 3ul], 0xee);
+          }
+          // Lane l of r[4g+e] holds column 4l+e of rows 4g to 4g+3, so the
+          // 128-bit lanes of r[e], r[4+e], r[8+e], r[12+e] are transposed.
+          for(std::size_t e = 0ul; e < 4ul; ++e) {
+            const reg_type u0 = _mm512_shuffle_f32x4(r[e], r[e + 4ul], 0x88);
+            const reg_type u1 = _mm512_shuffle_f32x4(r[e], r[e + 4ul], 0xdd);
+            const reg_type u2 = _mm512_shuffle_f32x4(r[e + 8ul], r[e + 12ul], 0x88);
+            const reg_type u3 = _mm512_shuffle_f32x4(r[e + 8ul], r[e + 12ul], 0xdd);
+            t[e] = _mm512_shuffle_f32x4(u0, u2, 0x88);
+            t[e + 4ul] = _mm512_shuffle_f32x4(u1, u3, 0x88);
+            t[e + 8ul] = _mm512_shuffle_f32x4(u0, u2, 0xdd);
+            t[e + 12ul] = _mm512_shuffle_f32x4(u1, u3, 0xdd);
+          }
+          std::copy(t, t + 16, r);
+        }
+      }; // struct Avx512Vector<float>
+
+      template <>
+      struct Avx512Vector<std::complex<float> > {
+        typedef __m512 reg_type;
+        static constexpr std::size_t width = 8ul;
+
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type set1(const float x) { return _mm512_set1_ps(x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type load(const std::complex<float>* p)
+        { return _mm512_loadu_ps(reinterpret_cast<const float*>(p)); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void store(std::complex<float>* p, const reg_type x)
+        { _mm512_storeu_ps(reinterpret_cast<float*>(p), x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void stream(std::complex<float>* p, const reg_type x)
+        { _mm512_stream_ps(reinterpret_cast<float*>(p), x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type add(const reg_type a, const reg_type b) { return _mm512_add_ps(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type mul(const reg_type a, const reg_type b) { return _mm512_mul_ps(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void transpose(reg_type* const r) {
+          __m512d d[8];
+          for(std::size_t k = 0ul; k < 8ul; ++k)
+            d[k] = _mm512_castps_pd(r[k]);
+          Avx512Vector<double>::transpose(d);
+          for(std::size_t k = 0ul; k < 8ul; ++k)
+            r[k] = _mm512_castpd_ps(d[k]);
+        }
+      }; // struct Avx512Vector<std::complex<float> >
+
+      template <>
+      struct Avx512Vector<std::complex<double> > {
+        typedef __m512d reg_type;
+        static constexpr std::size_t width = 4ul;
+
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type set1(const double x) { return _mm512_set1_pd(x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type load(const std::complex<double>* p)
+        { return _mm512_loadu_pd(reinterpret_cast<const double*>(p)); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void store(std::complex<double>* p, const reg_type x)
+        { _mm512_storeu_pd(reinterpret_cast<double*>(p), x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void stream(std::complex<double>* p, const reg_type x)
+        { _mm512_stream_pd(reinterpret_cast<double*>(p), x); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type add(const reg_type a, const reg_type b) { return _mm512_add_pd(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static reg_type mul(const reg_type a, const reg_type b) { return _mm512_mul_pd(a, b); }
+        TILEDARRAY_SIMD_AVX512_TARGET static void transpose(reg_type* const r) {
+          const reg_type u0 = _mm512_shuffle_f64x2(r[0], r[1], 0x88);
+          const reg_type u1 = _mm512_shuffle_f64x2(r[0], r[1], 0xdd);
+          const reg_type u2 = _mm512_shuffle_f64x2(r[2], r[3], 0x88);
+          const reg_type u3 = _mm512_shuffle_f64x2(r[2], r[3], 0xdd);
+          r[0] = _mm512_shuffle_f64x2(u0, u2, 0x88);
+          r[1] = _mm512_shuffle_f64x2(u1, u3, 0x88);
+          r[2] = _mm512_shuffle_f64x2(u0, u2, 0xdd);
+          r[3] = _mm512_shuffle_f64x2(u1, u3, 0xdd);
+        }
+      }; // struct Avx512Vector<std::complex<double> >
+
+#define TILEDARRAY_SIMD_NAMESPACE avx2
+#define TILEDARRAY_SIMD_TARGET TILEDARRAY_SIMD_AVX2_TARGET
+#define TILEDARRAY_SIMD_VECTOR Avx2Vector
+#include <TiledArray/math/simd_kernels.h>
+#undef TILEDARRAY_SIMD_VECTOR
+#undef TILEDARRAY_SIMD_TARGET
+#undef TILEDARRAY_SIMD_NAMESPACE
+
+#define TILEDARRAY_SIMD_NAMESPACE avx512
+#define TILEDARRAY_SIMD_TARGET TILEDARRAY_SIMD_AVX512_TARGET
+#define TILEDARRAY_SIMD_VECTOR Avx512Vector
+#include <TiledArray/math/simd_kernels.h>
+#undef TILEDARRAY_SIMD_VECTOR
+#undef TILEDARRAY_SIMD_TARGET
+#undef TILEDARRAY_SIMD_NAMESPACE
+
+#endif // TILEDARRAY_HAVE_SIMD_X86
+
+#ifdef TILEDARRAY_HAVE_SIMD_NEON
+
+      /// NEON vector traits
+      template <typename T> struct NeonVector;
+
+      template <>
+      struct NeonVector<double> {
+        typedef float64x2_t reg_type;
+        static constexpr std::size_t width = 2ul;
+
+        static reg_type zero() { return vdupq_n_f64(0.0); }
+        static reg_type set1(const double x) { return vdupq_n_f64(x); }
+        static reg_type load(const double* p) { return vld1q_f64(p); }
+        static reg_type load_n(const double* p, const std::size_t)
+        { return vsetq_lane_f64(*p, zero(), 0); }
+        static void store(double* p, const reg_type x) { vst1q_f64(p, x); }
+        static void store_n(double* p, const reg_type x, const std::size_t)
+        { *p = vgetq_lane_f64(x, 0); }
+        static reg_type add(const reg_type a, const reg_type b) { return vaddq_f64(a, b); }
+        static reg_type sub(const reg_type a, const reg_type b) { return vsubq_f64(a, b); }
+        static reg_type mul(const reg_type a, const reg_type b) { return vmulq_f64(a, b); }
+        static reg_type fmadd(const reg_type a, const reg_type b, const reg_type c)
+        { return vfmaq_f64(c, a, b); }
+        static double sum(const reg_type x) { return vaddvq_f64(x); }
+        static void stream(double* p, const reg_type x) { vst1q_f64(p, x); }
+        static void transpose(reg_type* const r) {
+          const reg_type t0 = vzip1q_f64(r[0], r[1]);
+          r[1] = vzip2q_f64(r[0], r[1]);
+          r[0] = t0;
+        }
+      }; // struct NeonVector<double>
+
+      template <>
+      struct NeonVector<float> {
+        typedef float32x4_t reg_type;
+        static constexpr std::size_t width = 4ul;
+
+        static reg_type zero() { return vdupq_n_f32(0.0f); }
+        static reg_type set1(const float x) { return vdupq_n_f32(x); }
+        static reg_type load(const float* p) { return vld1q_f32(p); }
+        static reg_type load_n(const float* p, const std::size_t m) {
+          float temp[width] = { 0.0f, 0.0f, 0.0f, 0.0f };
+          std::copy(p, p + m, temp);
+          return vld1q_f32(temp);
+        }
+        static void store(float* p, const reg_type x) { vst1q_f32(p, x); }
+        static void store_n(float* p, const reg_type x, const std::size_t m) {
+          float temp[width];
+          vst1q_f32(temp, x);
+          std::copy(temp, temp + m, p);
+        }
+        static reg_type add(const reg_type a, const reg_type b) { return vaddq_f32(a, b); }
+        static reg_type sub(const reg_type a, const reg_type b) { return vsubq_f32(a, b); }
+        static reg_type mul(const reg_type a, const reg_type b) { return vmulq_f32(a, b); }
+        static reg_type fmadd(const reg_type a, const reg_type b, const reg_type c)
+        { return vfmaq_f32(c, a, b); }
+        static float sum(const reg_type x) { return vaddvq_f32(x); }
+        static void stream(float* p, const reg_type x) { vst1q_f32(p, x); }
+        static void transpose(reg_type* const r) {
+          const float32x4x2_t t0 = vtrnq_f32(r[0], r[1]);
+          const float32x4x2_t t1 = vtrnq_f32(r[2], r[3]);
+          r[0] = vcombine_f32(vget_low_f32(t0.val[0]), vget_low_f32(t1.val[0]));
+          r[1] = vcombine_f32(vget_low_f32(t0.val[1]), vget_low_f32(t1.val[1]));
+          r[2] = vcombine_f32(vget_high_f32(t0.val[0]), vget_high_f32(t1.val[0]));
+          r[3] = vcombine_f32(vget_high_f32(t0.val[1]), vget_high_f32(t1.val[1]));
+        }
+      }; // struct NeonVector<float>
+
+      template <>
+      struct NeonVector<std::complex<float> > {
+        typedef float32x4_t reg_type;
+        static constexpr std::size_t width = 2ul;
+
+        static reg_type set1(const float x) { return vdupq_n_f32(x); }
+        static reg_type load(const std::complex<float>* p)
+        { return vld1q_f32(reinterpret_cast<const float*>(p)); }
+        static void store(std::complex<float>* p, const reg_type x)
+        { vst1q_f32(reinterpret_cast<float*>(p), x); }
+        static void stream(std::complex<float>* p, const reg_type x) { store(p, x); }
+        static reg_type add(const reg_type a, const reg_type b) { return vaddq_f32(a, b); }
+        static reg_type mul(const reg_type a, const reg_type b) { return vmulq_f32(a, b); }
+        static void transpose(reg_type* const r) {
+          const float64x2_t r0 = vreinterpretq_f64_f32(r[0]);
+          const float64x2_t r1 = vreinterpretq_f64_f32(r[1]);
+          r[0] = vreinterpretq_f32_f64(vzip1q_f64(r0, r1));
+          r[1] = vreinterpretq_f32_f64(vzip2q_f64(r0, r1));
+        }
+      }; // struct NeonVector<std::complex<float> >
+
+      template <>
+      struct NeonVector<std::complex<double> > {
+        typedef float64x2_t reg_type;
+        static constexpr std::size_t width = 1ul;
+
+        static reg_type set1(const double x) { return vdupq_n_f64(x); }
+        static reg_type load(const std::complex<double>* p)
+        { return vld1q_f64(reinterpret_cast<const double*>(p)); }
+        static void store(std::complex<double>* p, const reg_type x)
+        { vst1q_f64(reinterpret_cast<double*>(p), x); }
+        static void stream(std::complex<double>* p, const reg_type x) { store(p, x); }
+        static reg_type add(const reg_type a, const reg_type b) { return vaddq_f64(a, b); }
+        static reg_type mul(const reg_type a, const reg_type b) { return vmulq_f64(a, b); }
+        static void transpose(reg_type* const) { }
+      }; // struct NeonVector<std::complex<double> >
+
+#define TILEDARRAY_SIMD_NAMESPACE neon
+#define TILEDARRAY_SIMD_TARGET
+#define TILEDARRAY_SIMD_VECTOR NeonVector
+#include <TiledArray/math/simd_kernels.h>
+#undef TILEDARRAY_SIMD_VECTOR
+#undef TILEDARRAY_SIMD_TARGET
+#undef TILEDARRAY_SIMD_NAMESPACE
+
+#endif // TILEDARRAY_HAVE_SIMD_NEON
+
+      /// Transpose output operation traits
+
+      /// \tparam Op The output operation type
+      /// \tparam T The result element type
+      template <typename Op, typename T>
+      struct transpose_output : public std::false_type { };
+
+      template <typename T>
+      struct transpose_output<InitOutputOp<T>, T> : public std::true_type {
+        /// \param bytes The size of the result matrix
+        /// \return The output mode of the transpose kernel
+        static SimdTransposeOutput mode(const std::size_t bytes) {
+          return (bytes >= TILEDARRAY_SIMD_STREAM_BYTES ?
+              SimdTransposeOutput::stream : SimdTransposeOutput::assign);
+        }
+      }; // struct transpose_output<InitOutputOp<T>, T>
+
+      template <typename T>
+      struct transpose_output<AddToOutputOp<T>, T> : public std::true_type {
+        /// \return The output mode of the transpose kernel
+        static SimdTransposeOutput mode(const std::size_t)
+        { return SimdTransposeOutput::add; }
+      }; // struct transpose_output<AddToOutputOp<T>, T>
+
+      /// Dispatch a binary vector kernel
+
+      /// \return \c false if the generic vector operation should be used
+      template <SimdBinary Op, bool Scaled, typename T>
+      inline bool binary(const std::size_t n, const T* const left,
+          const T* const right, const T factor, T* const result)
+      {
+        switch(simd_isa()) {
+#ifdef TILEDARRAY_HAVE_SIMD_X86
+          case SimdIsa::avx512:
+            avx512::binary<Op, Scaled>(n, left, right, factor, result);
+            return true;
+          case SimdIsa::avx2:
+            avx2::binary<Op, Scaled>(n, left, right, factor, result);
+            return true;
+#endif // TILEDARRAY_HAVE_SIMD_X86
+#ifdef TILEDARRAY_HAVE_SIMD_NEON
+          case SimdIsa::neon:
+            neon::binary<Op, Scaled>(n, left, right, factor, result);
+            return true;
+#endif // TILEDARRAY_HAVE_SIMD_NEON
+          default:
+            return false;
+        }
+      }
+
+      /// Dispatch a scale vector kernel
+
+      /// \return \c false if the generic vector operation should be used
+      template <typename T>
+      inline bool scale(const std::size_t n, const T* const arg, const T factor,
+          T* const result)
+      {
+        switch(simd_isa()) {
+#ifdef TILEDARRAY_HAVE_SIMD_X86
+          case SimdIsa::avx512:
+            avx512::scale(n, arg, factor, result);
+            return true;
+          case SimdIsa::avx2:
+            avx2::scale(n, arg, factor, result);
+            return true;
+#endif // TILEDARRAY_HAVE_SIMD_X86
+#ifdef TILEDARRAY_HAVE_SIMD_NEON
+          case SimdIsa::neon:
+            neon::scale(n, arg, factor, result);
+            return true;
+#endif // TILEDARRAY_HAVE_SIMD_NEON
+          default:
+            return false;
+        }
+      }
+
+      /// Dispatch a dot product kernel
+
+      /// \return \c false if the generic vector operation should be used
+      template <typename T>
+      inline bool dot(const std::size_t n, const T* const left,
+          const T* const right, T& result)
+      {
+        switch(simd_isa()) {
+#ifdef TILEDARRAY_HAVE_SIMD_X86
+          case SimdIsa::avx512:
+            result += avx512::dot(n, left, right);
+            return true;
+          case SimdIsa::avx2:
+            result += avx2::dot(n, left, right);
+            return true;
+#endif // TILEDARRAY_HAVE_SIMD_X86
+#ifdef TILEDARRAY_HAVE_SIMD_NEON
+          case SimdIsa::neon:
+            result += neon::dot(n, left, right);
+            return true;
+#endif // TILEDARRAY_HAVE_SIMD_NEON
+          default:
+            return false;
+        }
+      }
+
+      /// Dispatch a transpose kernel
+
+      /// Streamed results are only written with non-temporal stores when the
+      /// result and its rows are aligned to the register size.
+      /// \return \c false if the generic transpose should be used
+      template <typename T, typename S>
+      inline bool transpose(const std::size_t m, const std::size_t n,
+          const std::size_t result_stride, T* const result,
+          const std::size_t arg_stride, const T* const arg, const S factor,
+          const bool scaled, SimdTransposeOutput output)
+      {
+        const auto aligned = [=] (const std::size_t bytes) {
+          return ((reinterpret_cast<std::uintptr_t>(result) % bytes) == 0ul)
+              && (((result_stride * sizeof(T)) % bytes) == 0ul);
+        };
+
+        switch(simd_isa()) {
+#ifdef TILEDARRAY_HAVE_SIMD_X86
+          case SimdIsa::avx512:
+            if((output == SimdTransposeOutput::stream) && ! aligned(64ul))
+              output = SimdTransposeOutput::assign;
+            avx512::transpose(m, n, result_stride, result, arg_stride, arg,
+                factor, scaled, output);
+            if(output == SimdTransposeOutput::stream)
+              _mm_sfence();
+            return true;
+          case SimdIsa::avx2:
+            if((output == SimdTransposeOutput::stream) && ! aligned(32ul))
+              output = SimdTransposeOutput::assign;
+            avx2::transpose(m, n, result_stride, result, arg_stride, arg,
+                factor, scaled, output);
+            if(output == SimdTransposeOutput::stream)
+              _mm_sfence();
+            return true;
+#endif // TILEDARRAY_HAVE_SIMD_X86
+#ifdef TILEDARRAY_HAVE_SIMD_NEON
+          case SimdIsa::neon:
+            neon::transpose(m, n, result_stride, result, arg_stride, arg,
+                factor, scaled, output);
+            return true;
+#endif // TILEDARRAY_HAVE_SIMD_NEON
+          default:
+            return false;
+        }
+      }
+
+    } // namespace simd
+
+    // SIMD vector operation hooks. The generic overloads return false, which
+    // selects the generic vector operations. The overloads for the element-wise
+    // operations above apply a SIMD kernel when the arguments have the same
+    // float or double element type; the scaling factor is converted to the
+    // element type.
+
+    /// Vector operation hook
+
+    /// \return \c false
+    template <typename Op, typename Result, typename... Args>
+    inline bool simd_vector_op(const Op&, const std::size_t, Result* const,
+        const Args* const...)
+    { return false; }
+
+    /// Binary vector operation hook
+
+    /// \return \c true if the operation was applied
+    template <SimdBinary Op, typename T,
+        typename std::enable_if<simd::is_simd_type<T>::value>::type* = nullptr>
+    inline bool simd_vector_op(const BinaryVectorOp<Op, T>&, const std::size_t n,
+        T* const result, const T* const left, const T* const right)
+    { return simd::binary<Op, false>(n, left, right, T(1), result); }
+
+    /// Scaled binary vector operation hook
+
+    /// \return \c true if the operation was applied
+    template <SimdBinary Op, typename T, typename Scalar,
+        typename std::enable_if<simd::is_simd_type<T>::value &&
+        std::is_arithmetic<Scalar>::value>::type* = nullptr>
+    inline bool simd_vector_op(const ScalBinaryVectorOp<Op, T, Scalar>& op,
+        const std::size_t n, T* const result, const T* const left,
+        const T* const right)
+    { return simd::binary<Op, true>(n, left, right, T(op.factor), result); }
+
+    /// Scale vector operation hook
+
+    /// \return \c true if the operation was applied
+    template <typename T, typename Scalar,
+        typename std::enable_if<simd::is_simd_type<T>::value &&
+        std::is_arithmetic<Scalar>::value>::type* = nullptr>
+    inline bool simd_vector_op(const ScalVectorOp<T, Scalar>& op,
+        const std::size_t n, T* const result, const T* const arg)
+    { return simd::scale(n, arg, T(op.factor), result); }
+
+    /// In-place vector operation hook
+
+    /// \return \c false
+    template <typename Op, typename Result, typename... Args>
+    inline bool simd_inplace_vector_op(const Op&, const std::size_t,
+        Result* const, const Args* const...)
+    { return false; }
+
+    /// In-place binary vector operation hook
+
+    /// \return \c true if the operation was applied
+    template <SimdBinary Op, typename T,
+        typename std::enable_if<simd::is_simd_type<T>::value>::type* = nullptr>
+    inline bool simd_inplace_vector_op(const InplaceBinaryVectorOp<Op, T>&,
+        const std::size_t n, T* const result, const T* const arg)
+    { return simd::binary<Op, false>(n, result, arg, T(1), result); }
+
+    /// Scaled in-place binary vector operation hook
+
+    /// \return \c true if the operation was applied
+    template <SimdBinary Op, typename T, typename Scalar,
+        typename std::enable_if<simd::is_simd_type<T>::value &&
+        std::is_arithmetic<Scalar>::value>::type* = nullptr>
+    inline bool simd_inplace_vector_op(const ScalInplaceBinaryVectorOp<Op, T, Scalar>& op,
+        const std::size_t n, T* const result, const T* const arg)
+    { return simd::binary<Op, true>(n, result, arg, T(op.factor), result); }
+
+    /// In-place scale vector operation hook
+
+    /// \return \c true if the operation was applied
+    template <typename T, typename Scalar,
+        typename std::enable_if<simd::is_simd_type<T>::value &&
+        std::is_arithmetic<Scalar>::value>::type* = nullptr>
+    inline bool simd_inplace_vector_op(const ScalInplaceVectorOp<T, Scalar>& op,
+        const std::size_t n, T* const result)
+    { return simd::scale(n, result, T(op.factor), result); }
+
+    /// Reduction operation hook
+
+    /// \return \c false
+    template <typename Op, typename Result, typename... Args>
+    inline bool simd_reduce_op(const Op&, const std::size_t, Result&,
+        const Args* const...)
+    { return false; }
+
+    /// Dot product reduction hook
+
+    /// \return \c true if the operation was applied
+    template <typename T,
+        typename std::enable_if<simd::is_simd_type<T>::value>::type* = nullptr>
+    inline bool simd_reduce_op(const DotReduceOp<T>&, const std::size_t n,
+        T& result, const T* const left, const T* const right)
+    { return simd::dot(n, left, right, result); }
+
+    /// Squared norm reduction hook
+
+    /// \return \c true if the operation was applied
+    template <typename T,
+        typename std::enable_if<simd::is_simd_type<T>::value>::type* = nullptr>
+    inline bool simd_reduce_op(const SquaredNormReduceOp<T>&, const std::size_t n,
+        T& result, const T* const arg)
+    { return simd::dot(n, arg, arg, result); }
+
+    /// Transpose hook
+
+    /// \return \c false
+    template <typename InputOp, typename OutputOp, typename Result, typename... Args>
+    inline bool simd_transpose(const InputOp&, const OutputOp&, const std::size_t,
+        const std::size_t, const std::size_t, Result* const, const std::size_t,
+        const Args* const...)
+    { return false; }
+
+    /// Copy transpose hook
+
+    /// \return \c true if the transpose was applied
+    template <typename T, typename OutputOp,
+        typename std::enable_if<simd::is_simd_transpose_type<T>::value &&
+        simd::transpose_output<OutputOp, T>::value>::type* = nullptr>
+    inline bool simd_transpose(const CopyVectorOp<T>&, const OutputOp&,
+        const std::size_t m, const std::size_t n, const std::size_t result_stride,
+        T* const result, const std::size_t arg_stride, const T* const arg)
+    {
+      return simd::transpose(m, n, result_stride, result, arg_stride, arg,
+          TiledArray::detail::scalar_t<T>(1), false,
+          simd::transpose_output<OutputOp, T>::mode(m * n * sizeof(T)));
+    }
+
+    /// Scale transpose hook
+
+    /// \return \c true if the transpose was applied
+    template <typename T, typename Scalar, typename OutputOp,
+        typename std::enable_if<simd::is_simd_transpose_type<T>::value &&
+        std::is_arithmetic<Scalar>::value &&
+        simd::transpose_output<OutputOp, T>::value>::type* = nullptr>
+    inline bool simd_transpose(const ScalVectorOp<T, Scalar>& op, const OutputOp&,
+        const std::size_t m, const std::size_t n, const std::size_t result_stride,
+        T* const result, const std::size_t arg_stride, const T* const arg)
+    {
+      return simd::transpose(m, n, result_stride, result, arg_stride, arg,
+          TiledArray::detail::scalar_t<T>(op.factor), true,
+          simd::transpose_output<OutputOp, T>::mode(m * n * sizeof(T)));
+    }
+
+  }  // namespace math
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_SIMD_H__INCLUDED
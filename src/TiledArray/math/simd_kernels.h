@@ -0,0 +1,309 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  simd_kernels.h
+ *  Oct 14, 2016
+ *
+ */
+
+// This header has no include guard. It is included by TiledArray/math/simd.h
+// once for each instruction set, where the following macros are defined:
+//
+//   TILEDARRAY_SIMD_NAMESPACE  The namespace of the kernels
+//   TILEDARRAY_SIMD_TARGET     The function attributes of the kernels
+//   TILEDARRAY_SIMD_VECTOR     The vector traits template of the instruction set
+//
+// The vector traits provide the register type, the register width (in
+// elements), and the load, store, arithmetic, and horizontal sum operations.
+// load_n and store_n access the first m < width elements of a register, where
+// the remaining elements are not read or written.
+//
+// The transpose kernel also uses stream, a non-temporal store to an address
+// that is aligned to the register size, and transpose, which transposes a
+// width x width block of elements that is held in width registers. It is
+// instantiated for complex elements, whose traits only provide these
+// operations.
+
+#ifndef TILEDARRAY_SIMD_NAMESPACE
+#error "TiledArray/math/simd_kernels.h must be included by TiledArray/math/simd.h"
+#endif // TILEDARRAY_SIMD_NAMESPACE
+
+namespace TILEDARRAY_SIMD_NAMESPACE {
+
+  /// Element-wise binary register operation
+
+  /// \tparam V The vector traits type
+  /// \param l The left-hand register
+  /// \param r The right-hand register
+  /// \return <tt>l + r</tt>
+  template <typename V>
+  TILEDARRAY_SIMD_TARGET inline typename V::reg_type
+  apply(const typename V::reg_type l, const typename V::reg_type r,
+      SimdBinaryTag<SimdBinary::add>)
+  { return V::add(l, r); }
+
+  /// Element-wise binary register operation
+
+  /// \tparam V The vector traits type
+  /// \param l The left-hand register
+  /// \param r The right-hand register
+  /// \return <tt>l - r</tt>
+  template <typename V>
+  TILEDARRAY_SIMD_TARGET inline typename V::reg_type
+  apply(const typename V::reg_type l, const typename V::reg_type r,
+      SimdBinaryTag<SimdBinary::subt>)
+  { return V::sub(l, r); }
+
+  /// Element-wise binary register operation
+
+  /// \tparam V The vector traits type
+  /// \param l The left-hand register
+  /// \param r The right-hand register
+  /// \return <tt>l * r</tt>
+  template <typename V>
+  TILEDARRAY_SIMD_TARGET inline typename V::reg_type
+  apply(const typename V::reg_type l, const typename V::reg_type r,
+      SimdBinaryTag<SimdBinary::mult>)
+  { return V::mul(l, r); }
+
+  /// Binary vector kernel
+
+  /// Compute <tt>result[i] = (left[i] op right[i]) * factor</tt>, where the
+  /// scaling is only applied when \c Scaled is \c true . \c result may be
+  /// equal to \c left .
+  /// \tparam Op The binary operation
+  /// \tparam Scaled The scaling flag
+  /// \tparam T The element type
+  /// \param n The number of elements
+  /// \param left The left-hand argument
+  /// \param right The right-hand argument
+  /// \param factor The scaling factor
+  /// \param result The result vector
+  template <SimdBinary Op, bool Scaled, typename T>
+  TILEDARRAY_SIMD_TARGET void binary(const std::size_t n, const T* const left,
+      const T* const right, const T factor, T* const result)
+  {
+    typedef TILEDARRAY_SIMD_VECTOR<T> V;
+    typedef typename V::reg_type reg_type;
+    constexpr std::size_t width = V::width;
+    constexpr SimdBinaryTag<Op> op = {};
+
+    const reg_type f = V::set1(factor);
+    std::size_t i = 0ul;
+
+    // Unrolled loop
+    const std::size_t nx = n - (n % (4ul * width));
+    for(; i < nx; i += 4ul * width) {
+      reg_type r0 = apply<V>(V::load(left + i), V::load(right + i), op);
+      reg_type r1 = apply<V>(V::load(left + i + width), V::load(right + i + width), op);
+      reg_type r2 = apply<V>(V::load(left + i + 2ul * width), V::load(right + i + 2ul * width), op);
+      reg_type r3 = apply<V>(V::load(left + i + 3ul * width), V::load(right + i + 3ul * width), op);
+      if(Scaled) {
+        r0 = V::mul(r0, f);
+        r1 = V::mul(r1, f);
+        r2 = V::mul(r2, f);
+        r3 = V::mul(r3, f);
+      }
+      V::store(result + i, r0);
+      V::store(result + i + width, r1);
+      V::store(result + i + 2ul * width, r2);
+      V::store(result + i + 3ul * width, r3);
+    }
+
+    // Full registers
+    for(; (i + width) <= n; i += width) {
+      reg_type r0 = apply<V>(V::load(left + i), V::load(right + i), op);
+      if(Scaled)
+        r0 = V::mul(r0, f);
+      V::store(result + i, r0);
+    }
+
+    // Remainder
+    if(i < n) {
+      const std::size_t m = n - i;
+      reg_type r0 = apply<V>(V::load_n(left + i, m), V::load_n(right + i, m), op);
+      if(Scaled)
+        r0 = V::mul(r0, f);
+      V::store_n(result + i, r0, m);
+    }
+  }
+
+  /// Scale vector kernel
+
+  /// Compute <tt>result[i] = arg[i] * factor</tt>. \c result may be equal to
+  /// \c arg .
+  /// \tparam T The element type
+  /// \param n The number of elements
+  /// \param arg The argument vector
+  /// \param factor The scaling factor
+  /// \param result The result vector
+  template <typename T>
+  TILEDARRAY_SIMD_TARGET void scale(const std::size_t n, const T* const arg,
+      const T factor, T* const result)
+  {
+    typedef TILEDARRAY_SIMD_VECTOR<T> V;
+    typedef typename V::reg_type reg_type;
+    constexpr std::size_t width = V::width;
+
+    const reg_type f = V::set1(factor);
+    std::size_t i = 0ul;
+
+    // Unrolled loop
+    const std::size_t nx = n - (n % (4ul * width));
+    for(; i < nx; i += 4ul * width) {
+      const reg_type r0 = V::mul(V::load(arg + i), f);
+      const reg_type r1 = V::mul(V::load(arg + i + width), f);
+      const reg_type r2 = V::mul(V::load(arg + i + 2ul * width), f);
+      const reg_type r3 = V::mul(V::load(arg + i + 3ul * width), f);
+      V::store(result + i, r0);
+      V::store(result + i + width, r1);
+      V::store(result + i + 2ul * width, r2);
+      V::store(result + i + 3ul * width, r3);
+    }
+
+    // Full registers
+    for(; (i + width) <= n; i += width)
+      V::store(result + i, V::mul(V::load(arg + i), f));
+
+    // Remainder
+    if(i < n) {
+      const std::size_t m = n - i;
+      V::store_n(result + i, V::mul(V::load_n(arg + i, m), f), m);
+    }
+  }
+
+  /// Dot product kernel
+
+  /// Four independent accumulators are used to hide the latency of the fused
+  /// multiply-add operations.
+  /// \tparam T The element type
+  /// \param n The number of elements
+  /// \param left The left-hand argument
+  /// \param right The right-hand argument
+  /// \return The sum of <tt>left[i] * right[i]</tt>
+  template <typename T>
+  TILEDARRAY_SIMD_TARGET T dot(const std::size_t n, const T* const left,
+      const T* const right)
+  {
+    typedef TILEDARRAY_SIMD_VECTOR<T> V;
+    typedef typename V::reg_type reg_type;
+    constexpr std::size_t width = V::width;
+
+    reg_type s0 = V::zero(), s1 = V::zero(), s2 = V::zero(), s3 = V::zero();
+    std::size_t i = 0ul;
+
+    // Unrolled loop
+    const std::size_t nx = n - (n % (4ul * width));
+    for(; i < nx; i += 4ul * width) {
+      s0 = V::fmadd(V::load(left + i), V::load(right + i), s0);
+      s1 = V::fmadd(V::load(left + i + width), V::load(right + i + width), s1);
+      s2 = V::fmadd(V::load(left + i + 2ul * width), V::load(right + i + 2ul * width), s2);
+      s3 = V::fmadd(V::load(left + i + 3ul * width), V::load(right + i + 3ul * width), s3);
+    }
+
+    // Full registers
+    for(; (i + width) <= n; i += width)
+      s0 = V::fmadd(V::load(left + i), V::load(right + i), s0);
+
+    // Remainder
+    if(i < n) {
+      const std::size_t m = n - i;
+      s1 = V::fmadd(V::load_n(left + i, m), V::load_n(right + i, m), s1);
+    }
+
+    return V::sum(V::add(V::add(s0, s1), V::add(s2, s3)));
+  }
+
+  /// Transpose kernel
+
+  /// Compute <tt>result[j * result_stride + i] = arg[i * arg_stride + j] *
+  /// factor</tt>, or add it to the result, for an \c m x \c n argument matrix.
+  /// Blocks of width x width elements are transposed in registers, and the
+  /// remaining rows and columns are transposed element by element. Streamed
+  /// results require a result pointer and stride that are aligned to the
+  /// register size.
+  /// \tparam T The element type
+  /// \tparam S The scaling factor type
+  /// \param m The number of rows of the argument matrix
+  /// \param n The number of columns of the argument matrix
+  /// \param result_stride The stride between result rows
+  /// \param result The result matrix
+  /// \param arg_stride The stride between argument rows
+  /// \param arg The argument matrix
+  /// \param factor The scaling factor
+  /// \param scaled The scaling flag
+  /// \param output The output mode
+  template <typename T, typename S>
+  TILEDARRAY_SIMD_TARGET void transpose(const std::size_t m, const std::size_t n,
+      const std::size_t result_stride, T* const result,
+      const std::size_t arg_stride, const T* const arg, const S factor,
+      const bool scaled, const SimdTransposeOutput output)
+  {
+    typedef TILEDARRAY_SIMD_VECTOR<T> V;
+    typedef typename V::reg_type reg_type;
+    constexpr std::size_t width = V::width;
+
+    const reg_type f = V::set1(factor);
+    const std::size_t mx = m - (m % width);
+    const std::size_t nx = n - (n % width);
+
+    // Register blocks
+    for(std::size_t i = 0ul; i < mx; i += width) {
+      for(std::size_t j = 0ul; j < nx; j += width) {
+        reg_type r[width];
+        for(std::size_t k = 0ul; k < width; ++k)
+          r[k] = V::load(arg + (i + k) * arg_stride + j);
+        V::transpose(r);
+        for(std::size_t k = 0ul; k < width; ++k) {
+          T* const result_k = result + (j + k) * result_stride + i;
+          const reg_type x = (scaled ? V::mul(r[k], f) : r[k]);
+          switch(output) {
+            case SimdTransposeOutput::assign:
+              V::store(result_k, x);
+              break;
+            case SimdTransposeOutput::stream:
+              V::stream(result_k, x);
+              break;
+            case SimdTransposeOutput::add:
+              V::store(result_k, V::add(V::load(result_k), x));
+              break;
+          }
+        }
+      }
+    }
+
+    // Remaining rows and columns
+    const auto transpose_element = [=] (const std::size_t i, const std::size_t j) {
+      const T x = (scaled ? T(arg[i * arg_stride + j] * factor) : arg[i * arg_stride + j]);
+      T* const result_ji = result + j * result_stride + i;
+      if(output == SimdTransposeOutput::add)
+        *result_ji += x;
+      else
+        *result_ji = x;
+    };
+    for(std::size_t i = 0ul; i < mx; ++i)
+      for(std::size_t j = nx; j < n; ++j)
+        transpose_element(i, j);
+    for(std::size_t i = mx; i < m; ++i)
+      for(std::size_t j = 0ul; j < n; ++j)
+        transpose_element(i, j);
+  }
+
+} // namespace TILEDARRAY_SIMD_NAMESPACE
@@ -0,0 +1,260 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  small_gemm.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_MATH_SMALL_GEMM_H__INCLUDED
+#define TILEDARRAY_MATH_SMALL_GEMM_H__INCLUDED
+
+#include <madness/tensor/cblas.h>
+#include <TiledArray/tensor/complex.h>
+#include <cstdint>
+#include <utility>
+
+/* The largest m*n*k for which the built-in kernel is used instead of BLAS. */
+#ifndef TILEDARRAY_SMALL_GEMM_THRESHOLD
+#define TILEDARRAY_SMALL_GEMM_THRESHOLD 32768
+#endif // TILEDARRAY_SMALL_GEMM_THRESHOLD
+
+/* The largest n and k for which fixed size kernels are generated. */
+#ifndef TILEDARRAY_FIXED_GEMM_MAX_SIZE
+#define TILEDARRAY_FIXED_GEMM_MAX_SIZE 8
+#endif // TILEDARRAY_FIXED_GEMM_MAX_SIZE
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Element accessor for a matrix argument of \c small_gemm
+
+    /// \tparam T The matrix element type
+    /// \param op The matrix operation
+    /// \param x The matrix data
+    /// \param ldx The leading dimension of \c x
+    /// \param i The row index of <tt>op(x)</tt>
+    /// \param j The column index of <tt>op(x)</tt>
+    /// \return Element <tt>(i,j)</tt> of <tt>op(x)</tt>
+    template <typename T>
+    TILEDARRAY_FORCE_INLINE T
+    small_gemm_element(const madness::cblas::CBLAS_TRANSPOSE op, const T* x,
+        const integer ldx, const integer i, const integer j)
+    {
+      switch(op) {
+        case madness::cblas::NoTrans:
+          return x[i * ldx + j];
+        case madness::cblas::Trans:
+          return x[j * ldx + i];
+        default:
+          return TiledArray::detail::conj(x[j * ldx + i]);
+      }
+    }
+
+    /// Fixed size matrix multiplication kernel
+
+    /// Compute <tt>c = alpha * op_a(a) * b + beta * c</tt> for a result with
+    /// \c N columns and an inner dimension of \c K , one row of \c c at a
+    /// time. The loops over \c N and \c K are unrolled by the compiler, so a
+    /// row of \c c is accumulated in registers.
+    /// \tparam N The number of columns in \c b and \c c
+    /// \tparam K The number of columns in <tt>op_a(a)</tt> and rows in \c b
+    /// \param m The number of rows in <tt>op_a(a)</tt> and \c c
+    /// \param alpha The scaling factor applied to <tt>op_a(a) * b</tt>
+    /// \param a The left-hand matrix
+    /// \param a_row The stride between rows of <tt>op_a(a)</tt>
+    /// \param a_col The stride between columns of <tt>op_a(a)</tt>
+    /// \param b The right-hand matrix
+    /// \param ldb The leading dimension of \c b
+    /// \param beta The scaling factor applied to \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <integer N, integer K, typename S1, typename T1, typename T2,
+        typename S2, typename T3>
+    void fixed_gemm_kernel(const integer m, const S1 alpha, const T1* a,
+        const integer a_row, const integer a_col, const T2* b, const integer ldb,
+        const S2 beta, T3* c, const integer ldc)
+    {
+      for(integer i = 0; i < m; ++i) {
+        const T1* MADNESS_RESTRICT const a_i = a + i * a_row;
+        T3 c_i[N];
+        for(integer j = 0; j < N; ++j)
+          c_i[j] = T3(0);
+        for(integer p = 0; p < K; ++p) {
+          const T1 a_ip = a_i[p * a_col];
+          const T2* MADNESS_RESTRICT const b_p = b + p * ldb;
+          for(integer j = 0; j < N; ++j)
+            c_i[j] += a_ip * b_p[j];
+        }
+
+        T3* MADNESS_RESTRICT const c_out = c + i * ldc;
+        if(beta == static_cast<S2>(0))
+          for(integer j = 0; j < N; ++j)
+            c_out[j] = alpha * c_i[j];
+        else
+          for(integer j = 0; j < N; ++j)
+            c_out[j] = alpha * c_i[j] + beta * c_out[j];
+      }
+    }
+
+    /// Select a fixed size kernel
+
+    /// \param n The number of columns in the result, in the range
+    /// <tt>[1, TILEDARRAY_FIXED_GEMM_MAX_SIZE]</tt>
+    /// \param k The inner dimension, in the range
+    /// <tt>[1, TILEDARRAY_FIXED_GEMM_MAX_SIZE]</tt>
+    /// \return A pointer to the kernel for \c n and \c k
+    template <typename S1, typename T1, typename T2, typename S2, typename T3,
+        std::size_t... I>
+    inline auto fixed_gemm_kernel_select(const integer n, const integer k,
+        std::index_sequence<I...>)
+        -> decltype(& fixed_gemm_kernel<1, 1, S1, T1, T2, S2, T3>)
+    {
+      constexpr integer max_size = TILEDARRAY_FIXED_GEMM_MAX_SIZE;
+      static decltype(& fixed_gemm_kernel<1, 1, S1, T1, T2, S2, T3>) const
+      kernels[] = { & fixed_gemm_kernel<integer(I) / max_size + 1,
+          integer(I) % max_size + 1, S1, T1, T2, S2, T3>... };
+      return kernels[(n - 1) * max_size + (k - 1)];
+    }
+
+  } // namespace detail
+
+  namespace math {
+
+    /// Check if a matrix multiplication should use the small matrix kernel
+
+    /// For small matrices, the cost of a BLAS call is dominated by its
+    /// overhead (argument checking, dispatch, and packing), so a simple loop
+    /// kernel is faster.
+    /// \param m The number of rows in the result matrix
+    /// \param n The number of columns in the result matrix
+    /// \param k The inner dimension of the multiplication
+    /// \return \c true if <tt>m*n*k</tt> is no larger than
+    /// \c TILEDARRAY_SMALL_GEMM_THRESHOLD
+    inline bool use_small_gemm(const integer m, const integer n, const integer k) {
+      return (std::int64_t(m) * std::int64_t(n) * std::int64_t(k)) <=
+          std::int64_t(TILEDARRAY_SMALL_GEMM_THRESHOLD);
+    }
+
+    /// Matrix multiplication with fixed size kernels
+
+    /// Fixed size kernels are generated for all \c n and \c k up to
+    /// \c TILEDARRAY_FIXED_GEMM_MAX_SIZE , and selected by the exact sizes at
+    /// runtime; the rows of the result are a runtime loop. They are used when
+    /// \c op_b is \c NoTrans and \c op_a is not \c ConjTrans .
+    /// \return \c true if the multiplication was computed, or \c false if
+    /// there is no fixed size kernel for it
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline bool fixed_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const T2* b, const integer ldb, const S2 beta, T3* c, const integer ldc)
+    {
+      constexpr integer max_size = TILEDARRAY_FIXED_GEMM_MAX_SIZE;
+      if((op_b != madness::cblas::NoTrans) || (op_a == madness::cblas::ConjTrans)
+          || (n < 1) || (n > max_size) || (k < 1) || (k > max_size))
+        return false;
+
+      const bool no_trans_a = (op_a == madness::cblas::NoTrans);
+      TiledArray::detail::fixed_gemm_kernel_select<S1, T1, T2, S2, T3>(n, k,
+          std::make_index_sequence<std::size_t(max_size * max_size)>())(m,
+          alpha, a, (no_trans_a ? lda : 1), (no_trans_a ? 1 : lda), b, ldb,
+          beta, c, ldc);
+      return true;
+    }
+
+    /// Matrix multiplication kernel for small, row-major matrices
+
+    /// Compute <tt>c = alpha * op_a(a) * op_b(b) + beta * c</tt> with a
+    /// \c fixed_gemm kernel when there is one, or with plain loops otherwise.
+    /// When \c op_b is \c NoTrans the innermost loop runs over
+    /// contiguous rows of \c b and \c c, otherwise it is a dot product over
+    /// contiguous rows of \c b.
+    /// \param op_a The operation applied to \c a
+    /// \param op_b The operation applied to \c b
+    /// \param m The number of rows in <tt>op_a(a)</tt> and \c c
+    /// \param n The number of columns in <tt>op_b(b)</tt> and \c c
+    /// \param k The number of columns in <tt>op_a(a)</tt> and rows in <tt>op_b(b)</tt>
+    /// \param alpha The scaling factor applied to <tt>op_a(a) * op_b(b)</tt>
+    /// \param a The left-hand matrix
+    /// \param lda The leading dimension of \c a
+    /// \param b The right-hand matrix
+    /// \param ldb The leading dimension of \c b
+    /// \param beta The scaling factor applied to \c c
+    /// \param c The result matrix
+    /// \param ldc The leading dimension of \c c
+    template <typename S1, typename T1, typename T2, typename S2, typename T3>
+    inline void small_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+        madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+        const integer k, const S1 alpha, const T1* a, const integer lda,
+        const T2* b, const integer ldb, const S2 beta, T3* c, const integer ldc)
+    {
+      if(fixed_gemm(op_a, op_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc))
+        return;
+
+      // Scale the result matrix
+      if(beta != static_cast<S2>(1)) {
+        for(integer i = 0; i < m; ++i) {
+          T3* MADNESS_RESTRICT const c_i = c + i * ldc;
+          if(beta == static_cast<S2>(0))
+            for(integer j = 0; j < n; ++j)
+              c_i[j] = T3(0);
+          else
+            for(integer j = 0; j < n; ++j)
+              c_i[j] *= beta;
+        }
+      }
+
+      if(op_b == madness::cblas::NoTrans) {
+        // c(i,:) += alpha * op_a(a)(i,p) * b(p,:)
+        for(integer i = 0; i < m; ++i) {
+          T3* MADNESS_RESTRICT const c_i = c + i * ldc;
+          for(integer p = 0; p < k; ++p) {
+            const T3 a_ip = alpha * TiledArray::detail::small_gemm_element(op_a, a, lda, i, p);
+            const T2* MADNESS_RESTRICT const b_p = b + p * ldb;
+            for(integer j = 0; j < n; ++j)
+              c_i[j] += a_ip * b_p[j];
+          }
+        }
+      } else {
+        // c(i,j) += alpha * dot(op_a(a)(i,:), op_b(b)(:,j))
+        const bool conj_b = (op_b != madness::cblas::Trans);
+        for(integer i = 0; i < m; ++i) {
+          T3* MADNESS_RESTRICT const c_i = c + i * ldc;
+          for(integer j = 0; j < n; ++j) {
+            const T2* MADNESS_RESTRICT const b_j = b + j * ldb;
+            T3 c_ij = T3(0);
+            if(conj_b)
+              for(integer p = 0; p < k; ++p)
+                c_ij += TiledArray::detail::small_gemm_element(op_a, a, lda, i, p) *
+                    TiledArray::detail::conj(b_j[p]);
+            else
+              for(integer p = 0; p < k; ++p)
+                c_ij += TiledArray::detail::small_gemm_element(op_a, a, lda, i, p) * b_j[p];
+            c_i[j] += alpha * c_ij;
+          }
+        }
+      }
+    }
+
+  }  // namespace math
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_MATH_SMALL_GEMM_H__INCLUDED
@@ -172,12 +172,20 @@ namespace TiledArray {
     /// \param[in] arg_stride The stride between argument rows
     /// \param[in] args A pointer to the first element of the argument matrix
     /// \note The data layout is expected to be row-major.
+    /// \note Copies and scaled copies of a \c float , \c double , or complex
+    /// matrix, which are initialized with \c InitOutputOp or accumulated with
+    /// \c AddToOutputOp , are transposed by a SIMD kernel (see
+    /// \c simd_transpose() ).
     template <typename InputOp, typename OutputOp, typename Result, typename... Args>
     void transpose(InputOp&& input_op, OutputOp&& output_op,
         const std::size_t m, const std::size_t n,
         const std::size_t result_stride, Result* result,
         const std::size_t arg_stride, const Args* const... args)
     {
+      if(simd_transpose(input_op, output_op, m, n, result_stride, result,
+          arg_stride, args...))
+        return;
+
       // Compute block iteration control variables
       constexpr std::size_t index_mask = ~std::size_t(TILEDARRAY_LOOP_UNWIND - 1ul);
       const std::size_t mx = m & index_mask; // = m - m % TILEDARRAY_LOOP_UNWIND
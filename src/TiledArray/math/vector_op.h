@@ -29,9 +29,33 @@
 #include <TiledArray/type_traits.h>
 #include <TiledArray/madness.h>
 #include <TiledArray/config.h>
+#include <TiledArray/math/simd.h>
 
 #define TILEDARRAY_LOOP_UNWIND ::TiledArray::math::LoopUnwind::value
 
+/* The minimum number of elements reduced by each task of a parallel reduction. */
+#ifndef TILEDARRAY_REDUCE_GRAIN_SIZE
+#define TILEDARRAY_REDUCE_GRAIN_SIZE 4096ul
+#endif // TILEDARRAY_REDUCE_GRAIN_SIZE
+
+/* The number of columns of the cache blocks of matrix kernels (outer products
+   and partial reductions). */
+#ifndef TILEDARRAY_MATRIX_BLOCK_SIZE
+#define TILEDARRAY_MATRIX_BLOCK_SIZE 512ul
+#endif // TILEDARRAY_MATRIX_BLOCK_SIZE
+
+/* The minimum number of elements of a matrix kernel that is computed in
+   parallel, and of each parallel task. */
+#ifndef TILEDARRAY_MATRIX_GRAIN_SIZE
+#define TILEDARRAY_MATRIX_GRAIN_SIZE 65536ul
+#endif // TILEDARRAY_MATRIX_GRAIN_SIZE
+
+/* The minimum number of elements of a strided or permuting tensor kernel that
+   is divided among the threads when the thread pool is starved. */
+#ifndef TILEDARRAY_TILE_PARALLEL_SIZE
+#define TILEDARRAY_TILE_PARALLEL_SIZE 1048576ul
+#endif // TILEDARRAY_TILE_PARALLEL_SIZE
+
 
 namespace TiledArray {
   namespace math {
@@ -298,10 +322,14 @@ namespace TiledArray {
 
       size_t lower;
       size_t upper;
+      size_t grain_size = GRAIN_SIZE;
 
       SizeTRange(const size_t start, const size_t end)
               : lower(start), upper(end) { }
 
+      SizeTRange(const size_t start, const size_t end, const size_t grain)
+              : lower(start), upper(end), grain_size(grain) { }
+
 //      SizeTRange(const size_t n, const size_t g_size)
 //              : lower(0), upper(n - 1), grain_size(g_size) { }
 
@@ -316,7 +344,7 @@ namespace TiledArray {
 
       bool empty() const { return lower > upper; }
 
-      bool is_divisible() const { return size() >= 2 * GRAIN_SIZE; }
+      bool is_divisible() const { return size() >= 2 * grain_size; }
 
       size_t begin() const { return lower; }
 
@@ -329,6 +357,7 @@ namespace TiledArray {
         nblock = (nblock + 1) / 2;
         lower = r.lower + nblock * block_size;
         upper = r.upper;
+        grain_size = r.grain_size;
         r.upper = lower;
       }
 
@@ -357,6 +386,9 @@ namespace TiledArray {
     void inplace_vector_op_serial(Op&& op, const std::size_t n, Result* const result,
         const Args* const... args)
     {
+      if(simd_inplace_vector_op(op, n, result, args...))
+        return;
+
       std::size_t i = 0ul;
 
       // Compute block iteration limit
@@ -510,10 +542,54 @@ namespace TiledArray {
       #endif
     }
 
+    /// Element initialization operation
+
+    /// Constructs the result elements, in uninitialized memory, from the
+    /// results of an element operation.
+    /// \tparam Op The element operation type
+    /// \tparam Result The result element type
+    template <typename Op, typename Result>
+    class InitVectorOp {
+      Op op_; ///< The element operation
+
+    public:
+      /// \param op The element operation
+      explicit InitVectorOp(const Op& op) : op_(op) { }
+
+      /// \return The element operation
+      const Op& op() const { return op_; }
+
+      template <typename... Args>
+      void operator()(Result* MADNESS_RESTRICT const result, const Args&... args) const {
+        new(result) Result(op_(args...));
+      }
+    }; // class InitVectorOp
+
+    /// Pointer vector operation hook
+
+    /// \return \c false
+    template <typename Op, typename Result, typename... Args>
+    inline bool simd_vector_ptr_op(const Op&, const std::size_t, Result* const,
+        const Args* const...)
+    { return false; }
+
+    /// Element initialization hook
+
+    /// Elements of the SIMD types are trivial, so the SIMD kernel of the
+    /// element operation initializes them.
+    /// \return \c true if the SIMD kernel of the element operation was applied
+    template <typename Op, typename Result, typename... Args>
+    inline bool simd_vector_ptr_op(const InitVectorOp<Op, Result>& op,
+        const std::size_t n, Result* const result, const Args* const... args)
+    { return simd_vector_op(op.op(), n, result, args...); }
+
     template <typename Op, typename Result, typename... Args>
     void vector_ptr_op_serial(Op&& op, const std::size_t n, Result* const result,
         const Args* const... args)
     {
+      if(simd_vector_ptr_op(op, n, result, args...))
+        return;
+
       std::size_t i = 0ul;
 
       // Compute block iteration limit
@@ -580,6 +656,9 @@ namespace TiledArray {
     void reduce_op_serial(Op&& op, const std::size_t n, Result& result,
         const Args* const... args)
     {
+      if(simd_reduce_op(op, n, result, args...))
+        return;
+
       std::size_t i = 0ul;
 
       // Compute block iteration limit
@@ -647,18 +726,29 @@ namespace TiledArray {
     };
 #endif
 
+    /// Reduce vector elements
+
+    /// With TBB, the vector is divided into blocks of at least
+    /// \c TILEDARRAY_REDUCE_GRAIN_SIZE elements that are reduced in parallel.
+    /// The block boundaries depend only on \c n , and the partial results are
+    /// joined in a fixed order, so the result does not depend on the number of
+    /// threads or on task scheduling.
+    /// \param reduce_op The element reduction operation
+    /// \param join_op The operation that joins partial results
+    /// \param identity The identity of the reduction
+    /// \param n The number of elements
+    /// \param result The reduction result, which is combined with the elements
+    /// \param args The argument vectors
     template <typename ReduceOp, typename JoinOp, typename Result, typename... Args>
     void reduce_op(ReduceOp&& reduce_op, JoinOp&& join_op, const Result& identity, const std::size_t n, Result& result,
                    const Args* const... args)
     {
-      //TODO implement reduce operation with TBB
       #ifdef HAVE_INTEL_TBB
-//      std::cout << "TBB_Reduce_OP" << std::endl;
-        SizeTRange range(0, n);
+        SizeTRange range(0, n, TILEDARRAY_REDUCE_GRAIN_SIZE);
 
         auto apply_reduce_op = ApplyReduceOp<ReduceOp,JoinOp,Result,Args...>(reduce_op, join_op, identity, result, args...);
 
-        tbb::parallel_reduce(range,apply_reduce_op, tbb::auto_partitioner());
+        tbb::parallel_deterministic_reduce(range, apply_reduce_op);
 
         result = apply_reduce_op.result();
       #else
@@ -779,6 +869,121 @@ namespace TiledArray {
       vector_op(op, n, result, left, right);
     }
 
+    /// Apply a kernel to the cache blocks of a row-major matrix
+
+    /// The \c m*n matrix is divided into panels of rows, or of columns when
+    /// \c split_cols is \c true , and each panel is divided into blocks of
+    /// \c TILEDARRAY_MATRIX_BLOCK_SIZE columns, which are passed to
+    /// <tt>op(i, mi, j, nj)</tt> for the rows <tt>[i, i + mi)</tt> and the
+    /// columns <tt>[j, j + nj)</tt> in order of \c j . The blocks of a panel
+    /// are applied by one thread, and the panels are applied in parallel
+    /// when the matrix has at least \c TILEDARRAY_MATRIX_GRAIN_SIZE elements.
+    /// Panels and blocks (except the last) are a multiple of
+    /// \c TILEDARRAY_LOOP_UNWIND rows and columns, so the kernel runs its
+    /// unwound loops on all but the edges of the matrix.
+    /// \tparam Op The block kernel type
+    /// \param op The block kernel
+    /// \param m The number of rows
+    /// \param n The number of columns
+    /// \param split_cols Divide the matrix into panels of columns, e.g.
+    /// when the kernel accumulates the rows of the matrix into a vector
+    template <typename Op>
+    void matrix_block_op(Op&& op, const std::size_t m, const std::size_t n,
+        const bool split_cols)
+    {
+      if((m == 0ul) || (n == 0ul))
+        return;
+
+      // Divide the columns of a panel into cache blocks
+      auto panel_op = [&op,n] (const std::size_t i, const std::size_t mi,
+          const std::size_t j_first, const std::size_t j_last)
+      {
+        for(std::size_t j = j_first; j < j_last; j += TILEDARRAY_MATRIX_BLOCK_SIZE)
+          op(i, mi, j, std::min(TILEDARRAY_MATRIX_BLOCK_SIZE, j_last - j));
+      };
+
+#ifdef HAVE_INTEL_TBB
+      if(m * n >= TILEDARRAY_MATRIX_GRAIN_SIZE) {
+        // The panel width, in rows or columns, rounded up to the loop unwind
+        const std::size_t other = (split_cols ? m : n);
+        const std::size_t extent = (split_cols ? n : m);
+        std::size_t width = (TILEDARRAY_MATRIX_GRAIN_SIZE + other - 1ul) / other;
+        width = (width + TILEDARRAY_LOOP_UNWIND - 1ul) & index_mask::value;
+        const std::size_t panels = (extent + width - 1ul) / width;
+
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0ul, panels, 1ul),
+            [&,width,extent] (const tbb::blocked_range<std::size_t>& range) {
+          for(std::size_t p = range.begin(); p != range.end(); ++p) {
+            const std::size_t first = p * width;
+            const std::size_t size = std::min(width, extent - first);
+            if(split_cols)
+              panel_op(0ul, m, first, first + size);
+            else
+              panel_op(first, size, 0ul, n);
+          }
+        }, tbb::simple_partitioner());
+
+        return;
+      }
+#endif // HAVE_INTEL_TBB
+
+      panel_op(0ul, m, 0ul, n);
+    }
+
+    /// Check if a tensor kernel should be divided among threads
+
+    /// A tensor kernel runs in the task of its tile, so it normally runs on
+    /// one thread while the other threads run the tasks of other tiles. When
+    /// a few large tiles are left, the thread pool has fewer queued tasks
+    /// than threads, and the kernels of these tiles are divided among the
+    /// idle threads. The kernels are divided with TBB, which is the
+    /// scheduler of the thread pool, so the threads are not oversubscribed.
+    /// \param n The number of elements of the kernel
+    /// \return \c true if \c n is at least \c TILEDARRAY_TILE_PARALLEL_SIZE
+    /// and there are fewer queued tasks than threads
+    inline bool use_parallel_tile_op(const std::size_t n) {
+#ifdef HAVE_INTEL_TBB
+      return (n >= TILEDARRAY_TILE_PARALLEL_SIZE) &&
+          (madness::ThreadPool::queue_size() < madness::ThreadPool::size());
+#else
+      return false;
+#endif // HAVE_INTEL_TBB
+    }
+
+    /// Apply a kernel to the subranges of an index range
+
+    /// The kernel is called with <tt>op(first, last)</tt> for subranges that
+    /// cover <tt>[0, n)</tt>, where each index stands for \c elements tensor
+    /// elements, e.g. a block of a strided tensor. When
+    /// \c use_parallel_tile_op is \c true for the <tt>n * elements</tt>
+    /// elements, the subranges are applied in parallel, each with at least
+    /// \c TILEDARRAY_MATRIX_GRAIN_SIZE elements; otherwise the kernel is
+    /// called once for the whole range.
+    /// \tparam Op The kernel type
+    /// \param op The kernel, which must write disjoint elements for disjoint
+    /// subranges
+    /// \param n The number of indices
+    /// \param elements The number of elements of each index
+    template <typename Op>
+    void range_block_op(Op&& op, const std::size_t n, const std::size_t elements) {
+      if(n == 0ul)
+        return;
+
+#ifdef HAVE_INTEL_TBB
+      if((n > 1ul) && use_parallel_tile_op(n * elements)) {
+        const std::size_t grain = std::max<std::size_t>(1ul,
+            TILEDARRAY_MATRIX_GRAIN_SIZE / std::max<std::size_t>(1ul, elements));
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(0ul, n, grain),
+            [&op] (const tbb::blocked_range<std::size_t>& range) {
+          op(range.begin(), range.end());
+        }, tbb::auto_partitioner());
+        return;
+      }
+#endif // HAVE_INTEL_TBB
+
+      op(0ul, n);
+    }
+
   }  // namespace math
 } // namespace TiledArray
 
@@ -0,0 +1,318 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  memory_governor.h
+ *  Oct 15, 2026
+ *
+ */
+
+
+#ifndef TILEDARRAY_MEMORY_GOVERNOR_H__INCLUDED
+#define TILEDARRAY_MEMORY_GOVERNOR_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/memory_tracker.h>
+#include <TiledArray/dist_eval/summa_depth.h>
+#include <TiledArray/range.h>
+#include <TiledArray/type_traits.h>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Memory governor that throttles the spawning of tile tasks
+
+    /// Evaluators spawn one task per local tile, and nothing limits the
+    /// number of tiles that are allocated at the same time, except for the
+    /// SUMMA depth limiter. The governor bounds the memory of this process:
+    /// each tile task is submitted with an estimate of the memory it
+    /// allocates, and it is only spawned when the live memory counted by
+    /// \c MemoryTracker , plus the estimates of the governed tasks that are
+    /// running, fits within the limit. Other tasks are deferred, and spawned
+    /// in submission order as running tasks complete. One task is always
+    /// allowed to run, so the evaluation makes progress even when the live
+    /// memory exceeds the limit; the limit is therefore a soft bound, which
+    /// should be set below a hard (e.g. cgroup) limit by the size of a few
+    /// tiles. The limit is given by the \c TA_MAX_MEMORY environment
+    /// variable, in the format of \c TA_SUMMA_MAX_MEMORY , or by
+    /// \c set_limit() . When there is no limit, tasks are spawned immediately.
+    /// \note Deferred tasks are spawned in submission order, and a task that
+    /// is submitted while others are deferred is deferred too. Since the
+    /// arguments of an evaluator are submitted before the evaluator itself,
+    /// running tasks never wait for deferred tasks.
+    /// \note There is one governor per process, which is shared by all
+    /// evaluations.
+    class MemoryGovernor {
+    public:
+      typedef std::size_t size_type; ///< Size type
+
+    private:
+      /// Deferred task launcher and its memory estimate
+      typedef std::pair<size_type, std::function<void(size_type)> > deferred_type;
+
+      /// Completion callback that releases a reservation
+
+      /// The callback deletes itself after the reservation is released.
+      class ReleaseCallback : public madness::CallbackInterface {
+        const size_type bytes_; ///< The reserved memory
+
+      public:
+        /// Constructor
+
+        /// \param bytes The reserved memory
+        explicit ReleaseCallback(const size_type bytes) : bytes_(bytes) { }
+
+        virtual void notify() {
+          MemoryGovernor::instance().release(bytes_);
+          delete this;
+        }
+      }; // class ReleaseCallback
+
+      madness::Spinlock lock_; ///< Lock for the reservations and deferred tasks
+      std::atomic<size_type> limit_; ///< Memory limit (0 = no limit)
+      size_type reserved_; ///< Memory reserved by running tasks
+      size_type running_; ///< Number of governed tasks that are running
+      std::deque<deferred_type> deferred_; ///< Deferred task launchers
+      std::atomic<size_type> deferrals_; ///< Number of tasks that were deferred
+
+      MemoryGovernor() :
+        lock_(), limit_(SummaDepthController::parse_memory(getenv("TA_MAX_MEMORY"))),
+        reserved_(0ul), running_(0ul), deferred_(), deferrals_(0ul)
+      { }
+
+      MemoryGovernor(const MemoryGovernor&) = delete;
+      MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+      /// Check that a task fits within the limit
+
+      /// The lock must be held by the caller.
+      /// \param bytes The memory estimate of the task
+      /// \return \c true when there is no limit, when no governed task is
+      /// running, or when the live memory and the reservations, including
+      /// \c bytes , fit within the limit
+      bool admit(const size_type bytes) const {
+        const size_type limit = limit_.load(std::memory_order_relaxed);
+        return (limit == 0ul) || (running_ == 0ul) ||
+            (MemoryTracker::instance().total().live + reserved_ + bytes <= limit);
+      }
+
+      /// Spawn the deferred tasks that fit within the limit
+      void drain() {
+        std::vector<deferred_type> launch;
+        lock_.lock(); // <<< Begin critical section
+        while(! deferred_.empty() && admit(deferred_.front().first)) {
+          reserved_ += deferred_.front().first;
+          ++running_;
+          launch.push_back(std::move(deferred_.front()));
+          deferred_.pop_front();
+        }
+        lock_.unlock(); // <<< End critical section
+
+        for(auto& task : launch)
+          task.second(task.first);
+      }
+
+    public:
+
+      /// Governor accessor
+
+      /// \return A reference to the memory governor of this process
+      static MemoryGovernor& instance() {
+        static MemoryGovernor* const governor = new MemoryGovernor();
+        return *governor;
+      }
+
+      /// Memory limit accessor
+
+      /// \return The memory limit of this process in bytes, or zero if there
+      /// is no limit
+      size_type limit() const { return limit_.load(std::memory_order_relaxed); }
+
+      /// Set the memory limit
+
+      /// Deferred tasks that fit within the new limit are spawned.
+      /// \param limit The memory limit of this process in bytes, or zero to
+      /// remove the limit
+      void set_limit(const size_type limit) {
+        limit_.store(limit, std::memory_order_relaxed);
+        drain();
+      }
+
+      /// Check for a memory limit
+
+      /// \return \c true if tasks are governed
+      bool enabled() const { return limit() != 0ul; }
+
+      /// Number of deferred tasks
+
+      /// \return The number of tasks that were deferred since the governor
+      /// was created
+      size_type deferrals() const { return deferrals_.load(std::memory_order_relaxed); }
+
+      /// Submit a tile task
+
+      /// \c launch is called, with the memory reserved for the task, when the
+      /// task fits within the limit; it must spawn the task, and the task must
+      /// call <tt>release(reserved)</tt> when it is done (see also
+      /// \c release_on() ). When there is no limit, \c launch is called
+      /// immediately with zero reserved bytes.
+      /// \tparam Launch The launcher type, <tt>void(size_type)</tt>
+      /// \param bytes The estimated memory allocated by the task
+      /// \param launch The task launcher
+      template <typename Launch>
+      void submit(size_type bytes, Launch&& launch) {
+        if(! enabled()) {
+          launch(size_type(0));
+          return;
+        }
+
+        bytes = std::max<size_type>(bytes, 1ul); // Zero marks ungoverned tasks
+        lock_.lock(); // <<< Begin critical section
+        if(deferred_.empty() && admit(bytes)) {
+          reserved_ += bytes;
+          ++running_;
+          lock_.unlock(); // <<< End critical section
+          launch(bytes);
+        } else {
+          deferred_.emplace_back(bytes,
+              std::function<void(size_type)>(std::forward<Launch>(launch)));
+          deferrals_.fetch_add(1ul, std::memory_order_relaxed);
+          lock_.unlock(); // <<< End critical section
+        }
+      }
+
+      /// Release the memory reserved for a task
+
+      /// Deferred tasks that now fit within the limit are spawned.
+      /// \param reserved The memory reserved for the task, as given to its
+      /// launcher
+      void release(const size_type reserved) {
+        if(reserved == 0ul)
+          return;
+
+        lock_.lock(); // <<< Begin critical section
+        TA_ASSERT(running_ > 0ul);
+        TA_ASSERT(reserved_ >= reserved);
+        reserved_ -= reserved;
+        --running_;
+        lock_.unlock(); // <<< End critical section
+
+        drain();
+      }
+
+      /// Release the memory reserved for a task when its result is set
+
+      /// \tparam T The result type of the task
+      /// \param result The result of the task
+      /// \param reserved The memory reserved for the task
+      template <typename T>
+      void release_on(const Future<T>& result, const size_type reserved) {
+        if(reserved == 0ul)
+          return;
+        if(result.probe())
+          release(reserved);
+        else
+          result.register_callback(new ReleaseCallback(reserved));
+      }
+
+    }; // class MemoryGovernor
+
+    /// Memory estimate of a tile
+
+    /// \tparam Tile The tile type
+    /// \param range The range of the tile
+    /// \return The number of bytes of the elements of a tile with \c range
+    template <typename Tile>
+    inline std::size_t tile_memory(const Range& range) {
+      return range.volume() * sizeof(numeric_t<Tile>);
+    }
+
+    /// Spawn a task with a stored function and arguments
+    template <typename Tuple, std::size_t... Is>
+    inline auto governed_add(World& world, Tuple& call, std::index_sequence<Is...>)
+        -> decltype(world.taskq.add(std::get<0>(call), std::get<Is + 1ul>(call)...))
+    {
+      return world.taskq.add(std::get<0>(call), std::get<Is + 1ul>(call)...);
+    }
+
+    /// Spawn a task that returns a tile through the memory governor
+
+    /// This is equivalent to <tt>world.taskq.add(fn, args...)</tt>, except
+    /// that the task may be deferred by \c MemoryGovernor . The memory
+    /// reserved for the task is released when its result is set.
+    /// \param world The world that will run the task
+    /// \param bytes The estimated memory allocated by the task
+    /// \param fn The task function
+    /// \param args The task arguments
+    /// \return A future to the result of the task
+    template <typename Fn, typename... Args>
+    inline auto governed_task(World& world, const std::size_t bytes, Fn&& fn,
+        Args&&... args)
+        -> decltype(world.taskq.add(std::forward<Fn>(fn), std::forward<Args>(args)...))
+    {
+      typedef decltype(world.taskq.add(std::forward<Fn>(fn),
+          std::forward<Args>(args)...)) future_type;
+
+      MemoryGovernor& governor = MemoryGovernor::instance();
+      if(! governor.enabled())
+        return world.taskq.add(std::forward<Fn>(fn), std::forward<Args>(args)...);
+
+      auto call = std::make_shared<std::tuple<typename std::decay<Fn>::type,
+          typename std::decay<Args>::type...> >(std::forward<Fn>(fn),
+          std::forward<Args>(args)...);
+      future_type result;
+      World* const w = & world;
+      governor.submit(bytes, [w, call, result] (const std::size_t reserved) mutable {
+        future_type tile = governed_add(*w, *call, std::index_sequence_for<Args...>());
+        result.set(tile);
+        MemoryGovernor::instance().release_on(tile, reserved);
+      });
+
+      return result;
+    }
+
+  } // namespace detail
+
+  /// Memory limit of this process
+
+  /// \return The limit of the memory governor in bytes, or zero if there is
+  /// no limit (see \c detail::MemoryGovernor )
+  inline std::size_t max_memory() {
+    return detail::MemoryGovernor::instance().limit();
+  }
+
+  /// Set the memory limit of this process
+
+  /// Tile tasks of evaluators, \c init_tiles() , and \c foreach() are
+  /// deferred while the live memory of this process exceeds the limit
+  /// (see \c detail::MemoryGovernor ).
+  /// \param limit The memory limit in bytes, or zero to remove the limit
+  inline void set_max_memory(const std::size_t limit) {
+    detail::MemoryGovernor::instance().set_limit(limit);
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MEMORY_GOVERNOR_H__INCLUDED
@@ -0,0 +1,283 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  memory_tracker.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_MEMORY_TRACKER_H__INCLUDED
+#define TILEDARRAY_MEMORY_TRACKER_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/profiler.h>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace TiledArray {
+
+  // Forward declaration
+  template <typename, typename> class DistArray;
+  namespace detail {
+    class MemoryScope;
+  } // namespace detail
+
+  /// Memory usage categories
+  enum class MemoryCategory : unsigned int {
+    tile = 0u, ///< Tile data that is not in another category
+    broadcast = 1u, ///< Argument tiles held by SUMMA iterations (not in the total)
+    reduce = 2u, ///< Tiles allocated by reduction tasks (e.g. contraction results)
+    shape = 3u, ///< Shape data computed by expressions
+    pool = 4u ///< Free blocks cached by the tile memory pools (see \c detail::TilePool )
+  }; // enum class MemoryCategory
+
+  /// Memory usage of a category
+  struct MemoryUsage {
+    std::size_t live; ///< Bytes currently allocated
+    std::size_t peak; ///< Largest number of bytes allocated at any time
+  }; // struct MemoryUsage
+
+  /// Memory high-water tracker
+
+  /// The tracker counts the live and peak bytes of each memory category of
+  /// this process. Tensor data is counted when it is allocated, and charged
+  /// to the category of the calling thread (see \c detail::MemoryScope ),
+  /// which is \c MemoryCategory::tile by default. SUMMA counts the argument
+  /// tiles of each iteration from the start of the iteration until all of its
+  /// tile contractions are done, which is the memory bounded by the SUMMA
+  /// depth limiter ( \c TA_SUMMA_MAX_MEMORY ). Since these tiles are also
+  /// counted in the category they were allocated in, broadcast memory is not
+  /// included in the total. Freed tile data that is cached by a tile memory
+  /// pool is counted as pool memory until the pool frees or reuses it.
+  /// \note There is one tracker per process. The counters are updated
+  /// atomically, so the peak of a category is exact, but the peak of the
+  /// total is the largest sum observed by an update.
+  class MemoryTracker {
+  public:
+    static constexpr unsigned int num_categories = 5u; ///< Number of memory categories
+
+  private:
+    std::atomic<std::size_t> live_[num_categories + 1u]; ///< Live bytes of each category and the total
+    std::atomic<std::size_t> peak_[num_categories + 1u]; ///< Peak bytes of each category and the total
+
+    MemoryTracker() {
+      for(unsigned int c = 0u; c <= num_categories; ++c) {
+        live_[c] = 0ul;
+        peak_[c] = 0ul;
+      }
+    }
+
+    MemoryTracker(const MemoryTracker&) = delete;
+    MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    /// Add to a counter and update its peak
+    void add(const unsigned int c, const std::size_t bytes) {
+      const std::size_t live = live_[c].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+      std::size_t peak = peak_[c].load(std::memory_order_relaxed);
+      while((live > peak) && ! peak_[c].compare_exchange_weak(peak, live,
+          std::memory_order_relaxed))
+      { }
+    }
+
+    /// Thread category accessor
+    static MemoryCategory& thread_category() {
+      static thread_local MemoryCategory category = MemoryCategory::tile;
+      return category;
+    }
+
+    friend class detail::MemoryScope;
+
+  public:
+
+    /// Tracker accessor
+
+    /// \return A reference to the memory tracker of this process
+    static MemoryTracker& instance() {
+      static MemoryTracker* const tracker = new MemoryTracker();
+      return *tracker;
+    }
+
+    /// Category name
+
+    /// \param category The memory category
+    /// \return The name of \c category
+    static const char* name(const MemoryCategory category) {
+      static const char* const names[num_categories] =
+          { "tile", "broadcast", "reduce", "shape", "pool" };
+      return names[static_cast<unsigned int>(category)];
+    }
+
+    /// Memory category of the calling thread
+
+    /// \return The category that allocations of this thread are charged to
+    static MemoryCategory category() { return thread_category(); }
+
+    /// Record an allocation
+
+    /// \param category The memory category
+    /// \param bytes The number of bytes allocated
+    void allocate(const MemoryCategory category, const std::size_t bytes) {
+      add(static_cast<unsigned int>(category), bytes);
+      if(category != MemoryCategory::broadcast)
+        add(num_categories, bytes);
+    }
+
+    /// Record a deallocation
+
+    /// \param category The memory category that the allocation was charged to
+    /// \param bytes The number of bytes deallocated
+    void deallocate(const MemoryCategory category, const std::size_t bytes) {
+      live_[static_cast<unsigned int>(category)].fetch_sub(bytes, std::memory_order_relaxed);
+      if(category != MemoryCategory::broadcast)
+        live_[num_categories].fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    /// Memory usage of a category
+
+    /// \param category The memory category
+    /// \return The live and peak bytes of \c category
+    MemoryUsage usage(const MemoryCategory category) const {
+      const unsigned int c = static_cast<unsigned int>(category);
+      return MemoryUsage{ live_[c].load(std::memory_order_relaxed),
+          peak_[c].load(std::memory_order_relaxed) };
+    }
+
+    /// Memory usage of all categories
+
+    /// \return The live and peak bytes of all categories together, except
+    /// broadcast memory
+    MemoryUsage total() const {
+      return MemoryUsage{ live_[num_categories].load(std::memory_order_relaxed),
+          peak_[num_categories].load(std::memory_order_relaxed) };
+    }
+
+    /// Reset the peaks to the current live bytes
+    void reset_peak() {
+      for(unsigned int c = 0u; c <= num_categories; ++c)
+        peak_[c].store(live_[c].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+  }; // class MemoryTracker
+
+  namespace detail {
+
+    /// Charge the allocations of a scope to a memory category
+
+    /// Tensor data allocated by the calling thread while this object exists
+    /// is charged to the given category. Scopes may be nested.
+    class MemoryScope {
+      const MemoryCategory previous_; ///< The category of the enclosing scope
+
+    public:
+      /// Constructor
+
+      /// \param category The category of allocations in this scope
+      explicit MemoryScope(const MemoryCategory category) :
+        previous_(MemoryTracker::thread_category())
+      { MemoryTracker::thread_category() = category; }
+
+      MemoryScope(const MemoryScope&) = delete;
+      MemoryScope& operator=(const MemoryScope&) = delete;
+
+      ~MemoryScope() { MemoryTracker::thread_category() = previous_; }
+
+    }; // class MemoryScope
+
+  } // namespace detail
+
+  /// Memory usage of this process
+
+  /// \param category The memory category
+  /// \return The live and peak bytes of \c category on this process
+  inline MemoryUsage memory_usage(const MemoryCategory category) {
+    return MemoryTracker::instance().usage(category);
+  }
+
+  /// Largest memory usage of any process
+
+  /// This is a collective operation.
+  /// \param world The world of the processes
+  /// \return The largest live and peak bytes of each category in the order
+  /// of \c MemoryCategory , followed by the total
+  inline std::vector<MemoryUsage> max_memory_usage(World& world) {
+    constexpr unsigned int n = MemoryTracker::num_categories + 1u;
+    const MemoryTracker& tracker = MemoryTracker::instance();
+    std::size_t buffer[2u * n];
+    for(unsigned int c = 0u; c < n; ++c) {
+      const MemoryUsage usage = (c < MemoryTracker::num_categories ?
+          tracker.usage(static_cast<MemoryCategory>(c)) : tracker.total());
+      buffer[2u * c] = usage.live;
+      buffer[2u * c + 1u] = usage.peak;
+    }
+    world.gop.max(buffer, 2u * n);
+
+    std::vector<MemoryUsage> result;
+    result.reserve(n);
+    for(unsigned int c = 0u; c < n; ++c)
+      result.push_back(MemoryUsage{ buffer[2u * c], buffer[2u * c + 1u] });
+    return result;
+  }
+
+  /// Print the largest memory usage of any process
+
+  /// This is a collective operation; the report is printed by rank 0.
+  /// \param world The world of the processes
+  /// \param os The output stream
+  inline void print_memory_usage(World& world, std::ostream& os = std::cout) {
+    const std::vector<MemoryUsage> usage = max_memory_usage(world);
+    if(world.rank() != 0)
+      return;
+
+    os << "Memory usage (max over " << world.size() << " processes, MB):\n"
+       << std::setw(12) << "category" << std::setw(14) << "live" << std::setw(14) << "peak" << "\n";
+    for(unsigned int c = 0u; c < usage.size(); ++c) {
+      os << std::setw(12) << (c < MemoryTracker::num_categories ?
+              MemoryTracker::name(static_cast<MemoryCategory>(c)) : "total")
+         << std::setw(14) << double(usage[c].live) / 1048576.0
+         << std::setw(14) << double(usage[c].peak) / 1048576.0 << "\n";
+    }
+  }
+
+  /// Memory held by the local tiles of an array
+
+  /// Only tiles that have been evaluated are counted; tiles of types without
+  /// a range are not counted.
+  /// \tparam Tile The tile type
+  /// \tparam Policy The array policy type
+  /// \param array The array
+  /// \return The number of bytes held by the local tiles of \c array
+  template <typename Tile, typename Policy>
+  inline std::size_t local_memory(const DistArray<Tile, Policy>& array) {
+    std::size_t result = 0ul;
+    for(const auto index : *array.pmap()) {
+      if(array.is_zero(index))
+        continue;
+      const Future<Tile> tile = array.find(index);
+      if(tile.probe())
+        result += detail::tile_bytes(tile.get());
+    }
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_MEMORY_TRACKER_H__INCLUDED
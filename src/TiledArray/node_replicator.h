@@ -0,0 +1,358 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  node_replicator.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_NODE_REPLICATOR_H__INCLUDED
+#define TILEDARRAY_NODE_REPLICATOR_H__INCLUDED
+
+#include <TiledArray/comm_tracker.h>
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/proc_topology.h>
+#include <TiledArray/rendezvous_exchange.h>
+#include <TiledArray/replicator.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace TiledArray {
+
+  /// Node-shared replication policy
+
+  /// When node-shared replication is enabled, \c DistArray::make_replicated()
+  /// keeps one copy of the replicated tiles per node instead of one per
+  /// process. The tiles are held in a POSIX shared memory segment that is
+  /// mapped by all processes of the node, and each tile is broadcast once
+  /// to each node (see \c detail::NodeReplicator ). The tiles of the
+  /// replicated array reference the segment as read-only external data, so
+  /// a tile is copied to private memory by the first operation that modifies
+  /// it. Only arrays of \c Tensor tiles of numbers are replicated this way.
+  /// Node-shared replication is disabled by default; it is enabled with
+  /// \c enable() or by setting the \c TA_NODE_SHARED_REPLICATION environment
+  /// variable.
+  /// \note The policy must be enabled or disabled on all processes.
+  class NodeSharedReplication {
+    bool enabled_; ///< Replication flag
+
+    NodeSharedReplication() :
+      enabled_(getenv("TA_NODE_SHARED_REPLICATION") != nullptr)
+    { }
+
+    NodeSharedReplication(const NodeSharedReplication&) = delete;
+    NodeSharedReplication& operator=(const NodeSharedReplication&) = delete;
+
+  public:
+
+    /// Replication policy accessor
+
+    /// \return A reference to the replication policy of this process
+    static NodeSharedReplication& instance() {
+      static NodeSharedReplication* const policy = new NodeSharedReplication();
+      return *policy;
+    }
+
+    /// Enable node-shared replication
+    void enable() { enabled_ = true; }
+
+    /// Disable node-shared replication
+    void disable() { enabled_ = false; }
+
+    /// Replication status
+
+    /// \return \c true if node-shared replication is enabled
+    bool enabled() const { return enabled_; }
+
+  }; // class NodeSharedReplication
+
+  namespace detail {
+
+    /// A mapped POSIX shared memory segment
+
+    /// The segment is unmapped when this object is destroyed.
+    class ShmSegment {
+      void* data_; ///< The mapped memory
+      std::size_t size_; ///< The size of the segment
+
+      ShmSegment(const ShmSegment&) = delete;
+      ShmSegment& operator=(const ShmSegment&) = delete;
+
+    public:
+
+      /// Map a shared memory segment
+
+      /// \param name The name of the segment
+      /// \param size The size of the segment
+      /// \param create If \c true , the segment is created
+      /// \throw TiledArray::Exception When the segment cannot be created or
+      /// mapped
+      ShmSegment(const std::string& name, const std::size_t size, const bool create) :
+        data_(nullptr), size_(size)
+      {
+        const int fd = shm_open(name.c_str(),
+            (create ? O_RDWR | O_CREAT | O_EXCL : O_RDWR), 0600);
+        if(fd < 0)
+          TA_EXCEPTION("ShmSegment: Unable to open a shared memory segment.");
+        if(create && (ftruncate(fd, size) != 0)) {
+          close(fd);
+          shm_unlink(name.c_str());
+          TA_EXCEPTION("ShmSegment: Unable to resize a shared memory segment.");
+        }
+        data_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if(data_ == MAP_FAILED) {
+          if(create)
+            shm_unlink(name.c_str());
+          TA_EXCEPTION("ShmSegment: Unable to map a shared memory segment.");
+        }
+      }
+
+      ~ShmSegment() { munmap(data_, size_); }
+
+      /// \return A pointer to the first byte of the segment
+      unsigned char* data() const { return static_cast<unsigned char*>(data_); }
+
+      /// \return The size of the segment in bytes
+      std::size_t size() const { return size_; }
+
+    }; // class ShmSegment
+
+    /// Replicate an array with one copy of the tiles per node
+
+    /// The first process of each node creates a shared memory segment that
+    /// holds all non-zero tiles of the array, at offsets that every process
+    /// computes from the tiled range and the shape. The owner of a tile
+    /// writes it into the segment of its node, and broadcasts it to the
+    /// first process of each other node with the algorithm of
+    /// \c ReplicatorConfig , where each receiver writes it into its segment
+    /// and forwards it. Hence each tile crosses the network once per node,
+    /// not once per process.
+    /// \tparam A The array type
+    template <typename A>
+    class NodeReplicator : public madness::WorldObject<NodeReplicator<A> > {
+    private:
+      typedef NodeReplicator<A> NodeReplicator_; ///< This object type
+      typedef madness::WorldObject<NodeReplicator_> wobj_type; ///< The base object type
+      typedef typename A::size_type size_type; ///< Tile index type
+      typedef typename A::value_type value_type; ///< Tile type
+      typedef typename value_type::value_type numeric_type; ///< Element type
+
+      static constexpr std::size_t alignment = 64ul; ///< Alignment of the tiles in the segment
+      static constexpr std::size_t npos = ~std::size_t(0); ///< Offset of zero tiles
+
+      World& world_; ///< The world of the array
+      std::shared_ptr<const ProcTopology> topology_; ///< The process topology
+      std::vector<ProcessID> nodes_; ///< The first process of each node
+      std::size_t node_; ///< The index of the node of this process in \c nodes_
+      std::vector<std::size_t> offsets_; ///< The offset of each tile in the segment
+      std::size_t bytes_; ///< The size of the segment
+      std::shared_ptr<ShmSegment> segment_; ///< The segment of this node
+      const ReplicateAlgorithm algorithm_; ///< The broadcast algorithm
+
+      /// \param p A process
+      /// \return The index of the node of \c p in \c nodes_
+      std::size_t node_index(const ProcessID p) const {
+        return std::lower_bound(nodes_.begin(), nodes_.end(), topology_->node(p))
+            - nodes_.begin();
+      }
+
+      /// Write a tile into the segment of this node
+
+      /// \param i The tile index
+      /// \param tile The tile
+      void store(const size_type i, const value_type& tile) {
+        TA_ASSERT(offsets_[i] != npos);
+        std::memcpy(segment_->data() + offsets_[i], tile.data(),
+            tile.range().volume() * sizeof(numeric_type));
+      }
+
+      /// Send a tile to the children of this node in the broadcast tree
+
+      /// \param root The owner of the tile
+      /// \param i The tile index
+      /// \param tile The tile
+      void forward(const ProcessID root, const size_type i, const value_type& tile) {
+        const std::vector<ProcessID> children = broadcast_children(ProcessID(node_),
+            ProcessID(nodes_.size()), ProcessID(node_index(root)), algorithm_);
+        for(const ProcessID child : children)
+          wobj_type::task(nodes_[child], & NodeReplicator_::send_handler, root,
+              i, tile, madness::TaskAttributes::hipri());
+
+        if(! children.empty() && CommTracker::instance().enabled())
+          CommTracker::instance().send(CommCategory::replicate,
+              children.size() * tile_bytes(tile), children.size());
+      }
+
+      void send_handler(const ProcessID root, const size_type i, const value_type& tile) {
+        // Pass the tile on before storing it, to keep the broadcast moving
+        forward(root, i, tile);
+        if(CommTracker::instance().enabled())
+          CommTracker::instance().receive(CommCategory::replicate,
+              tile_bytes(tile), CommTracker::now());
+        store(i, tile);
+      }
+
+      /// Task that stores and broadcasts a local tile
+      static void send(NodeReplicator_* const self, const size_type i,
+          const value_type& tile)
+      {
+        self->store(i, tile);
+        self->forward(self->world_.rank(), i, tile);
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param source The distributed array
+      /// \note This is a collective operation.
+      explicit NodeReplicator(const A& source) :
+        wobj_type(source.world()), world_(source.world()),
+        topology_(ProcTopology::get(source.world())), nodes_(), node_(0ul),
+        offsets_(source.size(), std::size_t(npos)), bytes_(0ul), segment_(),
+        algorithm_(ReplicatorConfig::instance().algorithm())
+      {
+        for(ProcessID p = 0; p < world_.size(); ++p)
+          nodes_.push_back(topology_->node(p));
+        std::sort(nodes_.begin(), nodes_.end());
+        nodes_.erase(std::unique(nodes_.begin(), nodes_.end()), nodes_.end());
+        node_ = node_index(world_.rank());
+
+        // Place the non-zero tiles in the segment
+        for(size_type i = 0ul; i < source.size(); ++i) {
+          if(source.is_zero(i))
+            continue;
+          offsets_[i] = bytes_;
+          const std::size_t bytes =
+              source.trange().make_tile_range(i).volume() * sizeof(numeric_type);
+          bytes_ += (bytes + alignment - 1ul) / alignment * alignment;
+        }
+
+        wobj_type::process_pending();
+      }
+
+      /// Replicate the tiles
+
+      /// The tiles of \c source are set in \c result , as references to the
+      /// shared memory segment of this node. This is a collective operation,
+      /// which includes fences.
+      /// \param source The distributed array
+      /// \param result The replicated array
+      void replicate(const A& source, A& result) {
+        const ProcessID rank = world_.rank();
+        const ProcessID leader = topology_->node(rank);
+
+        // Name the segment of each node after the process id of its first
+        // process, which is gathered from all processes
+        std::vector<long> pids(world_.size(), 0l);
+        pids[rank] = long(getpid());
+        world_.gop.sum(pids.data(), pids.size());
+        static std::size_t count = 0ul;
+        std::stringstream ss;
+        ss << "/ta_replica." << pids[leader] << "." << count++;
+        const std::string name = ss.str();
+
+        const std::size_t size = (bytes_ > alignment ? bytes_ : alignment);
+        if(rank == leader)
+          segment_ = std::make_shared<ShmSegment>(name, size, true);
+        world_.gop.fence();
+        if(rank != leader)
+          segment_ = std::make_shared<ShmSegment>(name, size, false);
+
+        // Store and broadcast the local tiles when they are ready
+        for(const size_type i : *source.pmap())
+          if(! source.is_zero(i))
+            world_.taskq.add(& NodeReplicator_::send, this, i, source.find(i),
+                madness::TaskAttributes::hipri());
+        world_.gop.fence();
+
+        // All processes of the node have mapped the segment, so it is
+        // removed when the last mapping is released
+        if(rank == leader)
+          shm_unlink(name.c_str());
+
+        const std::shared_ptr<ShmSegment> segment = segment_;
+        for(size_type i = 0ul; i < offsets_.size(); ++i)
+          if(offsets_[i] != npos)
+            result.set(i, value_type(result.trange().make_tile_range(i),
+                reinterpret_cast<const numeric_type*>(segment->data() + offsets_[i]),
+                [segment] (const numeric_type*) { }));
+      }
+
+    }; // class NodeReplicator
+
+    /// Arrays of other tiles are not replicated per node
+    template <typename A>
+    inline bool node_replicate(const A&, A&, std::false_type) { return false; }
+
+    /// Replicate an array of tensors with one copy per node, if enabled
+
+    /// \tparam A The array type
+    /// \param source The distributed array
+    /// \param result The replicated array
+    /// \return \c true if the tiles were replicated
+    template <typename A>
+    inline bool node_replicate(const A& source, A& result, std::true_type) {
+      World& world = source.world();
+      if(! NodeSharedReplication::instance().enabled() || (world.size() == 1))
+        return false;
+
+      // Replicate per node only if a node has more than one process
+      std::shared_ptr<const ProcTopology> topology = ProcTopology::get(world);
+      ProcessID p = 0;
+      while((p < world.size()) && (topology->node(p) == p))
+        ++p;
+      if(p == world.size())
+        return false;
+
+      NodeReplicator<A> replicator(source);
+      replicator.replicate(source, result);
+      return true;
+    }
+
+    /// Replicate an array with one copy per node, if enabled
+
+    /// See \c NodeSharedReplication .
+    /// \tparam A The array type
+    /// \param source The distributed array
+    /// \param result The replicated array, with a replicated process map
+    /// \return \c true if the tiles were replicated; otherwise nothing is
+    /// done
+    /// \note This is a collective operation.
+    template <typename A>
+    inline bool node_replicate(const A& source, A& result) {
+      return node_replicate(source, result, std::integral_constant<bool,
+          is_rendezvous_tile<typename A::value_type>::value>());
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_NODE_REPLICATOR_H__INCLUDED
@@ -0,0 +1,365 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  op_stats.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_OP_STATS_H__INCLUDED
+#define TILEDARRAY_OP_STATS_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Tile operation types that are counted by \c OpStats
+  enum class TileOpKind : unsigned int {
+    contract, ///< Tile contraction (\c ContractReduce )
+    add, ///< Tile addition (\c Add and \c ScalAdd )
+    subt, ///< Tile subtraction (\c Subt and \c ScalSubt )
+    mult, ///< Tile Hadamard product (\c Mult and \c ScalMult )
+    scal, ///< Tile scaling and negation (\c Scal and \c Neg )
+    shift, ///< Tile range shift (\c Shift and \c ScalShift )
+    permute ///< Tile permutation (\c Noop and contraction results)
+  }; // enum class TileOpKind
+
+  /// Tile operation statistics
+
+  /// \c OpStats counts the calls, floating point operations, and bytes
+  /// of the tile operations of each type, and the time of each call in a
+  /// histogram with power of two bins. Unlike \c TaskProfiler , which stores
+  /// every event, the counters have a fixed size, so the statistics can be
+  /// collected by long production runs. The counters are enabled by default;
+  /// they are disabled with \c disable() or by setting the
+  /// \c TA_DISABLE_OP_STATS environment variable. When the \c TA_OP_STATS
+  /// environment variable is set, \c TiledArray::finalize() writes the
+  /// statistics of each process to <tt>$TA_OP_STATS.rank.txt</tt>.
+  /// \note Each thread updates its own counters without locks or atomic
+  /// read-modify-write operations; a lock is only taken when a thread
+  /// records its first operation.
+  class OpStats {
+  public:
+    static constexpr unsigned int kinds = 7u; ///< The number of operation types
+    static constexpr unsigned int bins = 32u; ///< The number of histogram bins
+
+    /// Counters of one operation type
+    struct Counters {
+      std::uint64_t calls; ///< The number of calls
+      std::uint64_t flops; ///< The number of floating point operations
+      std::uint64_t bytes; ///< The number of bytes read and written
+      std::uint64_t nanoseconds; ///< The total time of the calls
+      std::array<std::uint64_t, bins> histogram;
+          ///< Bin \c i counts the calls that took [2^i, 2^(i+1)) ns
+    }; // struct Counters
+
+  private:
+
+    /// The counters of a thread, which are only modified by that thread
+    struct ThreadCounters {
+      std::array<std::array<std::atomic<std::uint64_t>, 4u + bins>, kinds> data;
+
+      ThreadCounters() {
+        for(auto& kind : data)
+          for(auto& value : kind)
+            value.store(0ul, std::memory_order_relaxed);
+      }
+    }; // struct ThreadCounters
+
+    std::atomic<bool> enabled_; ///< Statistics flag
+    mutable std::mutex lock_; ///< Lock for the thread list
+    std::vector<std::unique_ptr<ThreadCounters> > threads_; ///< Counters of all threads
+
+    OpStats() :
+      enabled_(getenv("TA_DISABLE_OP_STATS") == nullptr), lock_(), threads_()
+    { }
+
+    OpStats(const OpStats&) = delete;
+    OpStats& operator=(const OpStats&) = delete;
+
+    /// Counter accessor
+
+    /// \return The counters of the calling thread
+    ThreadCounters& thread_counters() {
+      static thread_local ThreadCounters* counters = nullptr;
+      if(! counters) {
+        std::lock_guard<std::mutex> locker(lock_);
+        threads_.emplace_back(new ThreadCounters());
+        counters = threads_.back().get();
+      }
+      return *counters;
+    }
+
+    /// Add to a counter of the calling thread
+    static void add(std::atomic<std::uint64_t>& counter, const std::uint64_t value) {
+      counter.store(counter.load(std::memory_order_relaxed) + value,
+          std::memory_order_relaxed);
+    }
+
+  public:
+
+    /// Statistics accessor
+
+    /// \return A reference to the operation statistics of this process
+    static OpStats& instance() {
+      static OpStats* const stats = new OpStats();
+      return *stats;
+    }
+
+    /// Enable the statistics
+    void enable() { enabled_.store(true, std::memory_order_relaxed); }
+
+    /// Disable the statistics
+
+    /// The recorded counts are kept.
+    void disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+    /// Statistics status
+
+    /// \return \c true if operations are counted
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Record an operation
+
+    /// \param kind The operation type
+    /// \param flops The floating point operations of the call
+    /// \param bytes The bytes read and written by the call
+    /// \param nanoseconds The time of the call
+    void record(const TileOpKind kind, const std::uint64_t flops,
+        const std::uint64_t bytes, const std::uint64_t nanoseconds)
+    {
+      auto& data = thread_counters().data[static_cast<unsigned int>(kind)];
+      add(data[0], 1ul);
+      add(data[1], flops);
+      add(data[2], bytes);
+      add(data[3], nanoseconds);
+      unsigned int bin = 0u;
+      for(std::uint64_t t = nanoseconds >> 1; (t != 0ul) && (bin + 1u < bins); t >>= 1)
+        ++bin;
+      add(data[4u + bin], 1ul);
+    }
+
+    /// Counters of an operation type
+
+    /// \param kind The operation type
+    /// \return The sum of the counters of \c kind over all threads
+    Counters counters(const TileOpKind kind) const {
+      Counters result = Counters();
+      std::lock_guard<std::mutex> locker(lock_);
+      for(const std::unique_ptr<ThreadCounters>& thread : threads_) {
+        const auto& data = thread->data[static_cast<unsigned int>(kind)];
+        result.calls += data[0].load(std::memory_order_relaxed);
+        result.flops += data[1].load(std::memory_order_relaxed);
+        result.bytes += data[2].load(std::memory_order_relaxed);
+        result.nanoseconds += data[3].load(std::memory_order_relaxed);
+        for(unsigned int i = 0u; i < bins; ++i)
+          result.histogram[i] += data[4u + i].load(std::memory_order_relaxed);
+      }
+      return result;
+    }
+
+    /// Reset all counters
+
+    /// \note Counts that are recorded concurrently may be lost.
+    void clear() {
+      std::lock_guard<std::mutex> locker(lock_);
+      for(std::unique_ptr<ThreadCounters>& thread : threads_)
+        for(auto& kind : thread->data)
+          for(auto& value : kind)
+            value.store(0ul, std::memory_order_relaxed);
+    }
+
+    /// Name of an operation type
+
+    /// \param kind The operation type
+    /// \return The name of \c kind
+    static const char* name(const TileOpKind kind) {
+      static const char* const names[kinds] =
+          { "contract", "add", "subt", "mult", "scal", "shift", "permute" };
+      return names[static_cast<unsigned int>(kind)];
+    }
+
+    /// Write the statistics
+
+    /// One line is written per operation type that was called, with the
+    /// number of calls, flops, bytes, total time, the flop rate, and the
+    /// non-empty histogram bins as <tt>2^i:count</tt> (time in ns).
+    /// \param os The output stream
+    void write(std::ostream& os) const {
+      for(unsigned int k = 0u; k < kinds; ++k) {
+        const TileOpKind kind = static_cast<TileOpKind>(k);
+        const Counters c = counters(kind);
+        if(c.calls == 0ul)
+          continue;
+        const double seconds = double(c.nanoseconds) * 1.0e-9;
+        os << std::left << std::setw(9) << name(kind) << std::right
+           << " calls=" << c.calls << " flops=" << c.flops
+           << " bytes=" << c.bytes << " time=" << seconds << "s"
+           << " gflops=" << (seconds > 0.0 ? double(c.flops) * 1.0e-9 / seconds : 0.0)
+           << " histogram=";
+        bool first = true;
+        for(unsigned int i = 0u; i < bins; ++i) {
+          if(c.histogram[i] == 0ul)
+            continue;
+          os << (first ? "" : ",") << "2^" << i << ":" << c.histogram[i];
+          first = false;
+        }
+        os << "\n";
+      }
+    }
+
+    /// Write the statistics of this process to a file
+
+    /// The statistics are written to <tt>prefix.rank.txt</tt>.
+    /// \param rank The rank of this process
+    /// \param prefix The file name prefix
+    /// \throw TiledArray::Exception When the file cannot be opened
+    void write(const int rank, const std::string& prefix) const {
+      std::stringstream ss;
+      ss << prefix << "." << rank << ".txt";
+      std::ofstream file(ss.str().c_str());
+      TA_USER_ASSERT(file.good(), "OpStats::write(): Unable to open statistics file.");
+      write(file);
+    }
+
+  }; // class OpStats
+
+  namespace detail {
+
+    /// Number of elements of a tile with a range
+
+    /// \tparam T The tile type
+    /// \param tile The tile
+    /// \return The number of elements of \c tile
+    template <typename T>
+    inline auto op_stats_size(const T& tile, int) ->
+        decltype(tile.empty(), std::uint64_t(tile.range().volume()))
+    { return (tile.empty() ? 0ul : tile.range().volume()); }
+
+    /// Number of elements of other tiles, e.g. \c ZeroTensor
+
+    /// \return Zero
+    template <typename T>
+    inline std::uint64_t op_stats_size(const T&, long) { return 0ul; }
+
+    /// Size of the elements of a tile
+
+    /// \tparam T The tile type
+    /// \return The size of an element of \c T , or zero if it is not known
+    template <typename T>
+    inline auto op_stats_element_size(const T&, int) ->
+        decltype(std::uint64_t(sizeof(typename T::value_type)))
+    { return sizeof(typename T::value_type); }
+
+    template <typename T>
+    inline std::uint64_t op_stats_element_size(const T&, long) { return 0ul; }
+
+    /// Count a tile operation in the lifetime of a scope
+
+    /// The operation is timed from construction to destruction. Nothing is
+    /// recorded when the statistics are disabled at construction.
+    class OpStatsScope {
+      TileOpKind kind_; ///< The operation type
+      std::uint64_t flops_; ///< The floating point operations
+      std::uint64_t bytes_; ///< The bytes read and written
+      bool enabled_; ///< Statistics flag
+      std::chrono::steady_clock::time_point begin_; ///< Start time
+
+    public:
+
+      /// Element-wise operation constructor
+
+      /// The operation is counted as one flop per element (none for shifts
+      /// and permutations), and as reading each argument and writing the
+      /// result.
+      /// \tparam Args The tile argument types
+      /// \param kind The operation type
+      /// \param args The tile arguments
+      template <typename... Args>
+      explicit OpStatsScope(const TileOpKind kind, const Args&... args) :
+        kind_(kind), flops_(0ul), bytes_(0ul),
+        enabled_(OpStats::instance().enabled())
+      {
+        if(enabled_) {
+          std::uint64_t elements = 0ul;
+          for(const std::uint64_t n : { op_stats_size(args, 0)... })
+            elements = std::max(elements, n);
+          for(const std::uint64_t n : { (op_stats_size(args, 0) * op_stats_element_size(args, 0))... })
+            bytes_ += n;
+          bytes_ += elements * std::max({ op_stats_element_size(args, 0)... });
+          flops_ = ((kind == TileOpKind::shift) || (kind == TileOpKind::permute) ?
+              0ul : elements);
+          begin_ = std::chrono::steady_clock::now();
+        }
+      }
+
+      /// Contraction constructor
+
+      /// \param flops The floating point operations of the contraction
+      /// \param bytes The bytes read and written by the contraction
+      OpStatsScope(const std::uint64_t flops, const std::uint64_t bytes) :
+        kind_(TileOpKind::contract), flops_(flops), bytes_(bytes),
+        enabled_(OpStats::instance().enabled()),
+        begin_(enabled_ ? std::chrono::steady_clock::now() :
+            std::chrono::steady_clock::time_point())
+      { }
+
+      OpStatsScope(const OpStatsScope&) = delete;
+      OpStatsScope& operator=(const OpStatsScope&) = delete;
+
+      ~OpStatsScope() {
+        if(enabled_)
+          OpStats::instance().record(kind_, flops_, bytes_,
+              std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - begin_).count());
+      }
+
+    }; // class OpStatsScope
+
+  }  // namespace detail
+
+  /// Write the operation statistics of this process when requested
+
+  /// The statistics are written when the \c TA_OP_STATS environment variable
+  /// is set (see \c OpStats ); this is called by \c TiledArray::finalize() .
+  /// \param rank The rank of this process
+  inline void write_op_stats(const int rank) {
+    const char* const prefix = getenv("TA_OP_STATS");
+    if(prefix && (prefix[0] != '\0'))
+      OpStats::instance().write(rank, prefix);
+  }
+
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_OP_STATS_H__INCLUDED
@@ -27,6 +27,11 @@
 #define TILEDARRAY_PERM_INDEX_H__INCLUDED
 
 #include <TiledArray/range.h>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace TiledArray {
   namespace detail {
@@ -167,6 +172,172 @@ namespace TiledArray {
       operator bool() const { return ndim_; }
     }; // class PermIndex
 
+
+    /// Construct a table of permuted ordinal indices
+
+    /// Element \c i of the result is <tt>PermIndex(range, perm)(i)</tt> . The
+    /// table is filled in ordinal order, with the permuted index of each
+    /// element updated from that of the previous element with additions of the
+    /// output strides, so there are no divisions.
+    /// \param range The input range of ordinal indices
+    /// \param perm The permutation
+    /// \return The permuted ordinal index of each ordinal index of \c range
+    inline std::vector<std::size_t>
+    make_perm_index_table(const Range& range, const Permutation& perm) {
+      const PermIndex perm_index(range, perm);
+      const std::size_t volume = range.volume();
+      std::vector<std::size_t> result(volume);
+      if(! perm_index) {
+        for(std::size_t i = 0ul; i < volume; ++i)
+          result[i] = i;
+        return result;
+      }
+
+      const int ndim = perm_index.dim();
+      const std::size_t* MADNESS_RESTRICT const output_weight =
+          perm_index.data() + ndim;
+      const auto* MADNESS_RESTRICT const extent = range.extent_data();
+      std::vector<std::size_t> index(ndim, 0ul);
+
+      std::size_t perm_ordinal = 0ul;
+      for(std::size_t i = 0ul; i < volume; ++i) {
+        result[i] = perm_ordinal;
+
+        // Increment the coordinate index of the input, and the permuted
+        // ordinal index with it
+        for(int d = ndim - 1; d >= 0; --d) {
+          perm_ordinal += output_weight[d];
+          if(++index[d] < std::size_t(extent[d]))
+            break;
+          perm_ordinal -= index[d] * output_weight[d];
+          index[d] = 0ul;
+        }
+      }
+
+      return result;
+    }
+
+    /// Cache of permuted ordinal index tables
+
+    /// Expressions that are evaluated repeatedly, e.g. in each iteration of a
+    /// coupled-cluster solver, permute the same tile ranges with the same
+    /// permutations. The tables of the most recently used (range,
+    /// permutation) pairs are kept, so distributed evaluators look up
+    /// permuted tile indices instead of computing them per tile. Ranges with
+    /// more than \c max_volume() tiles are not tabulated. The limits are set
+    /// with the \c TA_PERM_TABLE_MAX_VOLUME (default 2^20 tiles) and
+    /// \c TA_PERM_TABLE_CACHE (default 32 tables) environment variables; a
+    /// zero limit disables the tables.
+    class PermIndexTableCache {
+    public:
+      typedef std::vector<std::size_t> table_type; ///< Table type
+
+    private:
+      typedef std::pair<std::vector<std::size_t>, std::vector<unsigned int> >
+          key_type; ///< The extents of the range, and the permutation
+      typedef std::pair<key_type, std::shared_ptr<const table_type> > entry_type;
+
+      std::size_t max_volume_; ///< The maximum volume of a tabulated range
+      std::size_t capacity_; ///< The maximum number of cached tables
+      madness::Mutex lock_; ///< Lock for the cached tables
+      std::list<entry_type> tables_; ///< The cached tables, from the most to
+                                     ///< least recently used
+
+      static std::size_t getenv_size(const char* const name,
+          const std::size_t default_value)
+      {
+        const char* const value = getenv(name);
+        return (value ? std::strtoul(value, nullptr, 10) : default_value);
+      }
+
+      PermIndexTableCache() :
+        max_volume_(getenv_size("TA_PERM_TABLE_MAX_VOLUME", 1ul << 20)),
+        capacity_(getenv_size("TA_PERM_TABLE_CACHE", 32ul)),
+        lock_(), tables_()
+      { }
+
+      PermIndexTableCache(const PermIndexTableCache&) = delete;
+      PermIndexTableCache& operator=(const PermIndexTableCache&) = delete;
+
+    public:
+
+      /// Cache accessor
+
+      /// \return A reference to the table cache of this process
+      static PermIndexTableCache& instance() {
+        static PermIndexTableCache* const cache = new PermIndexTableCache();
+        return *cache;
+      }
+
+      /// \return The maximum number of tiles of a tabulated range
+      std::size_t max_volume() const { return max_volume_; }
+
+      /// \return The maximum number of cached tables
+      std::size_t capacity() const { return capacity_; }
+
+      /// Set the limits of the cache
+
+      /// Cached tables that exceed the new limits are dropped.
+      /// \param max_volume The maximum number of tiles of a tabulated range
+      /// \param capacity The maximum number of cached tables
+      void set(const std::size_t max_volume, const std::size_t capacity) {
+        madness::ScopedMutex<madness::Mutex> locker(&lock_);
+        max_volume_ = max_volume;
+        capacity_ = capacity;
+        tables_.remove_if([=] (const entry_type& entry) {
+          return entry.second->size() > max_volume; });
+        while(tables_.size() > capacity_)
+          tables_.pop_back();
+      }
+
+      /// \return The number of cached tables
+      std::size_t size() {
+        madness::ScopedMutex<madness::Mutex> locker(&lock_);
+        return tables_.size();
+      }
+
+      /// Get the permuted ordinal index table of a range
+
+      /// \param range The input range of ordinal indices
+      /// \param perm The permutation
+      /// \return The table of <tt>PermIndex(range, perm)</tt> , or a null
+      /// pointer if \c range is too large to be tabulated
+      std::shared_ptr<const table_type>
+      get(const Range& range, const Permutation& perm) {
+        const std::size_t volume = range.volume();
+        key_type key(std::vector<std::size_t>(range.extent_data(),
+            range.extent_data() + range.rank()),
+            std::vector<unsigned int>(perm.data().begin(), perm.data().end()));
+
+        {
+          madness::ScopedMutex<madness::Mutex> locker(&lock_);
+          if((volume > max_volume_) || (capacity_ == 0ul))
+            return std::shared_ptr<const table_type>();
+          for(auto it = tables_.begin(); it != tables_.end(); ++it) {
+            if(it->first == key) {
+              tables_.splice(tables_.begin(), tables_, it);
+              return tables_.front().second;
+            }
+          }
+        }
+
+        // Build the table without holding the lock; when two threads build
+        // the same table, the first one is kept.
+        std::shared_ptr<const table_type> table =
+            std::make_shared<const table_type>(make_perm_index_table(range, perm));
+
+        madness::ScopedMutex<madness::Mutex> locker(&lock_);
+        for(const auto& entry : tables_)
+          if(entry.first == key)
+            return entry.second;
+        tables_.emplace_front(std::move(key), table);
+        while(tables_.size() > capacity_)
+          tables_.pop_back();
+        return table;
+      }
+
+    }; // class PermIndexTableCache
+
   }  // namespace detail
 } // namespace TiledArray
 
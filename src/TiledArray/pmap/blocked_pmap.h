@@ -27,6 +27,7 @@
 #define TILEDARRAY_PMAP_BLOCKED_PMAP_H__INCLUDED
 
 #include <TiledArray/pmap/pmap.h>
+#include <algorithm>
 
 namespace TiledArray {
   namespace detail {
@@ -35,7 +36,9 @@ namespace TiledArray {
 
     /// Map N elements among P processes into blocks that are approximately N/P
     /// elements in size. A minimum block size may also be specified.
-    class BlockedPmap : public Pmap {
+    /// \note This class is \c final , so calls through a \c BlockedPmap
+    /// reference are not virtual.
+    class BlockedPmap final : public Pmap {
     protected:
 
       // Import Pmap protected variables
@@ -100,6 +103,43 @@ namespace TiledArray {
       virtual bool is_local(const size_type tile) const {
         return ((tile >= local_first_) && (tile < local_last_));
       }
+
+      /// Maps a range of tiles to the processors that own them
+
+      /// The owner is computed once per block in the range.
+      /// \param first The first tile to be queried
+      /// \param last The last tile + 1 to be queried
+      /// \param[out] result A buffer of at least <tt>last - first</tt>
+      /// elements where <tt>result[i - first] == owner(i)</tt>
+      virtual void owners(size_type first, const size_type last,
+          size_type* result) const override
+      {
+        TA_ASSERT(first <= last);
+        TA_ASSERT(last <= size_);
+        while(first < last) {
+          const size_type proc = BlockedPmap::owner(first);
+          const size_type block_last =
+              std::min(last, (proc + 1) * block_size_ +
+              std::min<size_type>(proc + 1, remainder_));
+          result = std::fill_n(result, block_last - first, proc);
+          first = block_last;
+        }
+      }
+
+      /// Check that a range of tiles is owned by this process
+
+      /// \param first The first tile to be checked
+      /// \param last The last tile + 1 to be checked
+      /// \param[out] result A buffer of at least <tt>last - first</tt>
+      /// elements where <tt>result[i - first] == is_local(i)</tt>
+      virtual void are_local(size_type first, const size_type last,
+          bool* result) const override
+      {
+        TA_ASSERT(first <= last);
+        TA_ASSERT(last <= size_);
+        for(; first < last; ++first, ++result)
+          *result = BlockedPmap::is_local(first);
+      }
     }; // class BlockedPmap
 
   }  // namespace detail
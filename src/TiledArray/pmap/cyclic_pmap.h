@@ -43,7 +43,9 @@ namespace TiledArray {
     /// \f$ \{ p_{\rm row}, p_{\rm col} \} = \{ k_{\rm row} \% N_{\rm row}, k_{\rm col} \% N_{\rm col} \} \f$
     ///
     /// \note This class is used to map <em>tile</em> indices to processes.
-    class CyclicPmap : public Pmap {
+    /// \note This class is \c final , so calls through a \c CyclicPmap
+    /// reference are not virtual.
+    class CyclicPmap final : public Pmap {
     protected:
 
       // Import Pmap protected variables
@@ -151,6 +153,56 @@ namespace TiledArray {
         return (CyclicPmap::owner(tile) == rank_);
       }
 
+      /// Maps a range of tiles to the processors that own them
+
+      /// The process coordinates are advanced tile by tile, so the owners
+      /// are computed without division.
+      /// \param first The first tile to be queried
+      /// \param last The last tile + 1 to be queried
+      /// \param[out] result A buffer of at least <tt>last - first</tt>
+      /// elements where <tt>result[i - first] == owner(i)</tt>
+      virtual void owners(size_type first, const size_type last,
+          size_type* result) const override
+      {
+        TA_ASSERT(first <= last);
+        TA_ASSERT(last <= size_);
+        if(first == last)
+          return;
+
+        size_type tile_col = first % cols_;
+        size_type proc_row = (first / cols_) % proc_rows_;
+        size_type proc_col = tile_col % proc_cols_;
+        for(; first < last; ++first, ++result) {
+          *result = proc_row * proc_cols_ + proc_col;
+          TA_ASSERT(*result == CyclicPmap::owner(first));
+
+          // Advance to the next tile
+          if(++tile_col == cols_) {
+            tile_col = 0ul;
+            proc_col = 0ul;
+            if(++proc_row == proc_rows_)
+              proc_row = 0ul;
+          } else if(++proc_col == proc_cols_) {
+            proc_col = 0ul;
+          }
+        }
+      }
+
+      /// Check that a range of tiles is owned by this process
+
+      /// \param first The first tile to be checked
+      /// \param last The last tile + 1 to be checked
+      /// \param[out] result A buffer of at least <tt>last - first</tt>
+      /// elements where <tt>result[i - first] == is_local(i)</tt>
+      virtual void are_local(size_type first, const size_type last,
+          bool* result) const override
+      {
+        TA_ASSERT(first <= last);
+        TA_ASSERT(last <= size_);
+        for(; first < last; ++first, ++result)
+          *result = (CyclicPmap::owner(first) == rank_);
+      }
+
     }; // class CyclicPmap
 
   }  // namespace detail
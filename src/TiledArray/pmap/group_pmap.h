@@ -0,0 +1,118 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  group_pmap.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_GROUP_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_GROUP_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <algorithm>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// A blocked process map on a group of processes
+
+    /// Map N elements into blocks among the P' processes
+    /// <tt>[first, first + P')</tt> of a world, where process
+    /// <tt>first + r</tt> owns the tiles that process \c r owns in a
+    /// \c BlockedPmap of P' processes. Processes outside the group own no
+    /// tiles. This maps the tiles of an array in a world onto the processes
+    /// of a sub-world (see \c SubWorld ).
+    class GroupPmap final : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const size_type first_; ///< The first process of the group
+      const size_type group_procs_; ///< The number of processes in the group
+      const size_type block_size_; ///< block size (= size_ / group_procs_)
+      const size_type remainder_; ///< tile remainder (= size_ % group_procs_)
+      const size_type block_size_plus_1_; ///< Cached value
+      const size_type block_size_plus_1_times_remainder_; ///< Cached value
+
+    public:
+      typedef Pmap::size_type size_type; ///< Key type
+
+      /// Construct a group map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param size The number of tiles to be mapped
+      /// \param first The first process of the group
+      /// \param procs The number of processes in the group
+      GroupPmap(World& world, size_type size, size_type first, size_type procs) :
+          Pmap(world, size), first_(first), group_procs_(procs),
+          block_size_(size_ / procs),
+          remainder_(size_ % procs),
+          block_size_plus_1_(block_size_ + 1),
+          block_size_plus_1_times_remainder_(remainder_ * block_size_plus_1_)
+      {
+        TA_ASSERT(procs > 0ul);
+        TA_ASSERT(first + procs <= procs_);
+
+        if((rank_ >= first_) && (rank_ < first_ + group_procs_)) {
+          const size_type r = rank_ - first_;
+          const size_type local_first = r * block_size_ + std::min<size_type>(r, remainder_);
+          const size_type local_last = (r + 1) * block_size_ + std::min<size_type>(r + 1, remainder_);
+          local_.reserve(local_last - local_first);
+          for(size_type tile = local_first; tile < local_last; ++tile) {
+            TA_ASSERT(GroupPmap::owner(tile) == rank_);
+            local_.push_back(tile);
+          }
+        }
+      }
+
+      virtual ~GroupPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return first_ + (tile < block_size_plus_1_times_remainder_ ?
+            tile / block_size_plus_1_ :
+            ((tile - block_size_plus_1_times_remainder_) / block_size_) + remainder_);
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return GroupPmap::owner(tile) == rank_;
+      }
+
+    }; // class GroupPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_GROUP_PMAP_H__INCLUDED
@@ -32,7 +32,10 @@ namespace TiledArray {
   namespace detail {
 
     /// Hashed process map
-    class HashPmap : public Pmap {
+
+    /// \note This class is \c final , so calls through a \c HashPmap
+    /// reference are not virtual.
+    class HashPmap final : public Pmap {
     protected:
 
       // Import Pmap protected variables
@@ -86,6 +89,36 @@ namespace TiledArray {
         return HashPmap::owner(tile) == rank_;
       }
 
+      /// Maps a range of tiles to the processors that own them
+
+      /// \param first The first tile to be queried
+      /// \param last The last tile + 1 to be queried
+      /// \param[out] result A buffer of at least <tt>last - first</tt>
+      /// elements where <tt>result[i - first] == owner(i)</tt>
+      virtual void owners(size_type first, const size_type last,
+          size_type* result) const override
+      {
+        TA_ASSERT(first <= last);
+        TA_ASSERT(last <= size_);
+        for(; first < last; ++first, ++result)
+          *result = HashPmap::owner(first);
+      }
+
+      /// Check that a range of tiles is owned by this process
+
+      /// \param first The first tile to be checked
+      /// \param last The last tile + 1 to be checked
+      /// \param[out] result A buffer of at least <tt>last - first</tt>
+      /// elements where <tt>result[i - first] == is_local(i)</tt>
+      virtual void are_local(size_type first, const size_type last,
+          bool* result) const override
+      {
+        TA_ASSERT(first <= last);
+        TA_ASSERT(last <= size_);
+        for(; first < last; ++first, ++result)
+          *result = (HashPmap::owner(first) == rank_);
+      }
+
     }; // class HashPmap
 
   } // namespace detail
@@ -0,0 +1,174 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  layered_pmap.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_LAYERED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_LAYERED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Maps cyclically a matrix of tiles onto a stack of 2-d process matrices
+
+    /// This process map is the 3-d analog of \c CyclicPmap used by
+    /// communication-avoiding (2.5D) contractions. The processes are
+    /// partitioned into \c layers groups of \c layer_stride processes; each
+    /// layer holds a \f$ P_{\rm row} \times P_{\rm col} \f$ process matrix.
+    /// Tile \f$ \{ k_{\rm row}, k_{\rm col} \} \f$ is assigned to layer
+    /// \f$ l = k_{\rm row} \% L \f$ when the layer is selected by row, or
+    /// \f$ l = k_{\rm col} \% L \f$ when it is selected by column, and to
+    /// process \f$ \{ k_{\rm row} \% P_{\rm row}, k_{\rm col} \% P_{\rm col} \} \f$
+    /// within that layer.
+    /// \note This class is used to map <em>tile</em> indices to processes.
+    class LayeredCyclicPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const size_type rows_; ///< Number of tile rows to be mapped
+      const size_type cols_; ///< Number of tile columns to be mapped
+      const size_type proc_cols_; ///< Number of process columns in each layer
+      const size_type proc_rows_; ///< Number of process rows in each layer
+      const size_type layers_; ///< Number of process layers
+      const size_type layer_stride_; ///< Rank offset between layers
+      const bool layer_by_row_; ///< Select the layer by tile row (\c true) or column (\c false)
+
+      size_type layer(const size_type tile_row, const size_type tile_col) const {
+        return (layer_by_row_ ? tile_row : tile_col) % layers_;
+      }
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param rows The number of tile rows to be mapped
+      /// \param cols The number of tile columns to be mapped
+      /// \param proc_rows The number of process rows in each layer
+      /// \param proc_cols The number of process columns in each layer
+      /// \param layers The number of process layers
+      /// \param layer_stride The rank offset between the first processes of
+      /// adjacent layers
+      /// \param layer_by_row If \c true, the layer of a tile is selected by its
+      /// row index, otherwise it is selected by its column index
+      /// \throw TiledArray::Exception When <tt>proc_rows * proc_cols > layer_stride</tt>
+      /// \throw TiledArray::Exception When <tt>layers * layer_stride > world.size()</tt>
+      LayeredCyclicPmap(World& world, size_type rows, size_type cols,
+          size_type proc_rows, size_type proc_cols, size_type layers,
+          size_type layer_stride, bool layer_by_row) :
+        Pmap(world, rows * cols), rows_(rows), cols_(cols),
+        proc_cols_(proc_cols), proc_rows_(proc_rows), layers_(layers),
+        layer_stride_(layer_stride), layer_by_row_(layer_by_row)
+      {
+        // Check that the size is non-zero
+        TA_ASSERT(rows_ >= 1ul);
+        TA_ASSERT(cols_ >= 1ul);
+
+        // Check limits of process rows, columns, and layers
+        TA_ASSERT(proc_rows_ >= 1ul);
+        TA_ASSERT(proc_cols_ >= 1ul);
+        TA_ASSERT(layers_ >= 1ul);
+        TA_ASSERT((proc_rows_ * proc_cols_) <= layer_stride_);
+        TA_ASSERT((layers_ * layer_stride_) <= procs_);
+
+        // Initialize local tile list
+        const size_type rank_layer = rank_ / layer_stride_;
+        const size_type layer_rank = rank_ % layer_stride_;
+        if((rank_layer < layers_) && (layer_rank < (proc_rows_ * proc_cols_))) {
+          // Compute rank coordinates
+          const size_type rank_row = layer_rank / proc_cols_;
+          const size_type rank_col = layer_rank % proc_cols_;
+
+          // Iterate over tiles in this process's row and column, and keep the
+          // ones that belong to this layer
+          for(size_type i = rank_row; i < rows_; i += proc_rows_) {
+            for(size_type j = rank_col; j < cols_; j += proc_cols_) {
+              if(layer(i, j) != rank_layer) continue;
+
+              TA_ASSERT(LayeredCyclicPmap::owner(i * cols_ + j) == rank_);
+              local_.push_back(i * cols_ + j);
+            }
+          }
+        }
+      }
+
+      virtual ~LayeredCyclicPmap() { }
+
+      /// Access number of rows in the tile index matrix
+      size_type nrows() const { return rows_; }
+      /// Access number of columns in the tile index matrix
+      size_type ncols() const { return cols_; }
+      /// Access number of rows in the process matrix of each layer
+      size_type nrows_proc() const { return proc_rows_; }
+      /// Access number of columns in the process matrix of each layer
+      size_type ncols_proc() const { return proc_cols_; }
+      /// Access number of process layers
+      size_type nlayers() const { return layers_; }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        // Compute tile coordinate in tile grid
+        const size_type tile_row = tile / cols_;
+        const size_type tile_col = tile % cols_;
+        // Compute process coordinate of tile in the process grid
+        const size_type proc_row = tile_row % proc_rows_;
+        const size_type proc_col = tile_col % proc_cols_;
+        // Compute the process that owns tile
+        const size_type proc = layer(tile_row, tile_col) * layer_stride_ +
+            proc_row * proc_cols_ + proc_col;
+
+        TA_ASSERT(proc < procs_);
+
+        return proc;
+      }
+
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return (LayeredCyclicPmap::owner(tile) == rank_);
+      }
+
+    }; // class LayeredCyclicPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+
+#endif // TILEDARRAY_PMAP_LAYERED_PMAP_H__INCLUDED
@@ -0,0 +1,243 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  morton_pmap.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_MORTON_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_MORTON_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/range.h>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// A Morton order process map
+
+    /// Tiles are ordered along a Morton (Z-order) curve over the tile range,
+    /// and the curve is divided among processes into blocks that are
+    /// approximately N/P tiles in size. Unlike the row-major blocks of
+    /// \c BlockedPmap , each block is a compact region of the array in all
+    /// dimensions, so the tiles of a block slice, or the neighbors of a tile,
+    /// are held by few processes. The Morton key of a tile is computed by
+    /// interleaving the bits of its tile coordinates, and the owner of a tile
+    /// is found with a binary search of the keys of the first tile of each
+    /// block. The first tiles of the blocks and the local tiles are found by
+    /// descending the hierarchy of the curve, so the map is constructed
+    /// without visiting the tiles of other processes.
+    class MortonPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+    private:
+
+      std::vector<size_type> extent_; ///< The extent of each dimension of the tile range
+      unsigned int bits_; ///< The number of key bits per dimension
+      std::vector<std::uint64_t> first_key_; ///< The key of the first tile of processes 1 to P-1
+
+      /// Key bits required for \c extent
+
+      /// \param extent The extent of a dimension
+      /// \return The number of bits needed to store a coordinate in \c extent
+      static unsigned int key_bits(size_type extent) {
+        unsigned int bits = 0u;
+        for(--extent; extent != 0ul; extent >>= 1)
+          ++bits;
+        return bits;
+      }
+
+      /// The number of tiles in a block of the curve
+
+      /// The tiles of a block share the leading bits of their coordinates.
+      /// \param prefix The leading bits of the coordinates in each dimension
+      /// \param level The number of trailing bits of the coordinates
+      /// \return The number of tiles of the tile range in the block
+      size_type block_volume(const std::vector<size_type>& prefix,
+          const unsigned int level) const
+      {
+        size_type result = 1ul;
+        for(std::size_t d = 0ul; d < extent_.size(); ++d) {
+          const size_type first = prefix[d] << level;
+          if(first >= extent_[d])
+            return 0ul;
+          result *= std::min(extent_[d] - first, size_type(1ul) << level);
+        }
+        return result;
+      }
+
+      /// Key of the n-th tile along the curve
+
+      /// The blocks of the curve are searched from the top, so the tiles are
+      /// not sorted.
+      /// \param n The position of the tile along the curve
+      /// \return The Morton key of the tile
+      std::uint64_t select(size_type n) const {
+        TA_ASSERT(n < size_);
+        const unsigned int rank = extent_.size();
+        std::vector<size_type> prefix(rank, 0ul), child(rank);
+        std::uint64_t result = 0ul;
+        for(unsigned int level = bits_; level > 0u; --level) {
+          for(std::uint64_t c = 0ul; c < (std::uint64_t(1) << rank); ++c) {
+            for(unsigned int d = 0u; d < rank; ++d)
+              child[d] = (prefix[d] << 1) | ((c >> (rank - 1u - d)) & 1ul);
+            const size_type volume = block_volume(child, level - 1u);
+            if(n < volume) {
+              result = (result << rank) | c;
+              prefix.swap(child);
+              break;
+            }
+            n -= volume;
+          }
+        }
+        return result;
+      }
+
+      /// Collect the local tiles of a block of the curve
+
+      /// Only the blocks that overlap the keys of this process are visited.
+      /// \param prefix The leading bits of the coordinates of the block
+      /// \param key The leading bits of the keys of the block
+      /// \param level The number of trailing bits of the coordinates
+      /// \param first The key of the first local tile
+      /// \param last The key after the last local tile
+      void collect_local(const std::vector<size_type>& prefix,
+          const std::uint64_t key, const unsigned int level,
+          const std::uint64_t first, const std::uint64_t last)
+      {
+        const unsigned int rank = extent_.size();
+        if(((key + 1ul) << (level * rank)) <= first ||
+            (key << (level * rank)) >= last || (block_volume(prefix, level) == 0ul))
+          return;
+
+        if(level == 0u) {
+          size_type tile = 0ul;
+          for(unsigned int d = 0u; d < rank; ++d)
+            tile = tile * extent_[d] + prefix[d];
+          local_.push_back(tile);
+          return;
+        }
+
+        std::vector<size_type> child(rank);
+        for(std::uint64_t c = 0ul; c < (std::uint64_t(1) << rank); ++c) {
+          for(unsigned int d = 0u; d < rank; ++d)
+            child[d] = (prefix[d] << 1) | ((c >> (rank - 1u - d)) & 1ul);
+          collect_local(child, (key << rank) | c, level - 1u, first, last);
+        }
+      }
+
+    public:
+
+      /// Construct a Morton order process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param range The range of the tiles to be mapped
+      /// \throw TiledArray::Exception When the Morton keys of \c range do not
+      /// fit in 63 bits
+      MortonPmap(World& world, const Range& range) :
+        Pmap(world, range.volume()),
+        extent_(range.extent_data(), range.extent_data() + range.rank()),
+        bits_(0u), first_key_()
+      {
+        for(const size_type extent : extent_)
+          bits_ = std::max(bits_, key_bits(extent));
+        TA_USER_ASSERT(bits_ * extent_.size() < 64ul,
+            "MortonPmap::MortonPmap(): The tile range is too large for a 64-bit Morton key.");
+
+        // Divide the curve into blocks and record the key of the first tile
+        // of each block.
+        const size_type block_size = size_ / procs_;
+        const size_type remainder = size_ % procs_;
+        const std::uint64_t end_key = select(size_ - 1ul) + 1ul;
+        first_key_.reserve(procs_ - 1ul);
+        for(size_type p = 1ul; p < procs_; ++p) {
+          const size_type first = p * block_size + std::min(p, remainder);
+          first_key_.push_back(first < size_ ? select(first) : end_key);
+        }
+
+        // Construct a list of local tiles from the block of this process
+        const size_type local_first = rank_ * block_size + std::min(rank_, remainder);
+        const size_type local_last = (rank_ + 1ul) * block_size + std::min(rank_ + 1ul, remainder);
+        local_.reserve(local_last - local_first);
+        std::vector<size_type> prefix(extent_.size(), 0ul);
+        collect_local(prefix, 0ul, bits_,
+            (rank_ == 0ul ? 0ul : first_key_[rank_ - 1ul]),
+            (rank_ + 1ul < procs_ ? first_key_[rank_] : end_key));
+        TA_ASSERT(local_.size() == (local_last - local_first));
+        std::sort(local_.begin(), local_.end());
+      }
+
+      virtual ~MortonPmap() { }
+
+      /// Morton key accessor
+
+      /// \param tile The tile ordinal
+      /// \return The position of \c tile on the Morton curve
+      std::uint64_t key(size_type tile) const {
+        TA_ASSERT(tile < size_);
+        const unsigned int rank = extent_.size();
+        std::uint64_t result = 0ul;
+        for(unsigned int d = rank; d > 0u; --d) {
+          const size_type coord = tile % extent_[d - 1u];
+          tile /= extent_[d - 1u];
+          for(unsigned int b = 0u; b < bits_; ++b)
+            result |= std::uint64_t((coord >> b) & 1ul) << (b * rank + (rank - d));
+        }
+        return result;
+      }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return std::upper_bound(first_key_.begin(), first_key_.end(),
+            MortonPmap::key(tile)) - first_key_.begin();
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        return MortonPmap::owner(tile) == rank_;
+      }
+
+    }; // class MortonPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_MORTON_PMAP_H__INCLUDED
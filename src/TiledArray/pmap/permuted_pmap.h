@@ -0,0 +1,110 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  permuted_pmap.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_PERMUTED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_PERMUTED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/perm_index.h>
+#include <algorithm>
+#include <memory>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Process map of the arguments of a permuted tensor
+
+    /// Tile \c i of the source index space is owned by the owner of the
+    /// permuted tile in the target process map, so an operation that permutes
+    /// its arguments into the target index space finds the arguments of each
+    /// result tile on the process that owns the result.
+    class PermutedPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const std::shared_ptr<Pmap> pmap_; ///< The target process map
+      const PermIndex source_to_target_; ///< Source to target index functor
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct permuted process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param pmap The process map of the target index space
+      /// \param source_range The tiles range of the source index space
+      /// \param perm The permutation from the source to the target index space
+      PermutedPmap(World& world, const std::shared_ptr<Pmap>& pmap,
+          const Range& source_range, const Permutation& perm) :
+        Pmap(world, source_range.volume()), pmap_(pmap),
+        source_to_target_(source_range, perm)
+      {
+        TA_ASSERT(pmap_);
+        TA_ASSERT(pmap_->size() == size_);
+        TA_ASSERT(pmap_->procs() == procs_);
+
+        // The local tiles are the source indices of the local target tiles
+        const PermIndex target_to_source(perm * source_range, -perm);
+        local_.reserve(pmap_->local_size());
+        for(const size_type target : *pmap_) {
+          TA_ASSERT(PermutedPmap::owner(target_to_source(target)) == rank_);
+          local_.push_back(target_to_source(target));
+        }
+        std::sort(local_.begin(), local_.end());
+      }
+
+      virtual ~PermutedPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return pmap_->owner(source_to_target_(tile));
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return pmap_->is_local(source_to_target_(tile));
+      }
+
+    }; // class PermutedPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_PERMUTED_PMAP_H__INCLUDED
@@ -85,6 +85,43 @@ namespace TiledArray {
     /// \return \c true if \c tile is owned by this process, otherwise \c false .
     virtual bool is_local(const size_type tile) const = 0;
 
+    /// Maps a range of tiles to the processors that own them
+
+    /// This is equivalent to calling \c owner() for each tile in the range,
+    /// but it costs one virtual call per range instead of one per tile.
+    /// Derived classes should override it with a loop that computes the
+    /// owners directly.
+    /// \param first The first tile to be queried
+    /// \param last The last tile + 1 to be queried
+    /// \param[out] result A buffer of at least <tt>last - first</tt> elements
+    /// where <tt>result[i - first] == owner(i)</tt>
+    virtual void owners(size_type first, const size_type last,
+        size_type* result) const
+    {
+      TA_ASSERT(first <= last);
+      TA_ASSERT(last <= size_);
+      for(; first < last; ++first, ++result)
+        *result = owner(first);
+    }
+
+    /// Check that a range of tiles is owned by this process
+
+    /// This is equivalent to calling \c is_local() for each tile in the
+    /// range, but it costs one virtual call per range instead of one per
+    /// tile.
+    /// \param first The first tile to be checked
+    /// \param last The last tile + 1 to be checked
+    /// \param[out] result A buffer of at least <tt>last - first</tt> elements
+    /// where <tt>result[i - first] == is_local(i)</tt>
+    virtual void are_local(size_type first, const size_type last,
+        bool* result) const
+    {
+      TA_ASSERT(first <= last);
+      TA_ASSERT(last <= size_);
+      for(; first < last; ++first, ++result)
+        *result = is_local(first);
+    }
+
     /// Size accessor
 
     /// \return The number of elements
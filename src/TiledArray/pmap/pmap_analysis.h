@@ -0,0 +1,496 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  pmap_analysis.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_PMAP_ANALYSIS_H__INCLUDED
+#define TILEDARRAY_PMAP_PMAP_ANALYSIS_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/tiled_range.h>
+#include <TiledArray/expressions/variable_list.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace TiledArray {
+
+  /// Forward declarations
+  template <typename, typename> class DistArray;
+
+  /// The load of one process under a process map
+  struct PmapLoad {
+    std::size_t tiles = 0ul; ///< Number of non-zero tiles stored
+    double bytes = 0.0; ///< Bytes of the non-zero tiles stored
+    double flops = 0.0; ///< Floating point operations of the owned result tiles
+    double recv_bytes = 0.0; ///< Bytes of argument tiles received
+    double send_bytes = 0.0; ///< Bytes of owned tiles sent to other processes
+  }; // struct PmapLoad
+
+  namespace detail {
+
+    /// Row-major ordinal of a tile of a sub-list of dimensions
+
+    /// \param index The tile index of the argument
+    /// \param dims The dimensions of the argument in the sub-list
+    /// \param extents The number of tiles of each dimension of the sub-list
+    /// \param lobound The first tile of each dimension of the argument
+    template <typename Index>
+    inline std::size_t pmap_analysis_ordinal(const Index& index,
+        const std::vector<unsigned int>& dims, const std::vector<std::size_t>& extents,
+        const std::vector<std::size_t>& lobound)
+    {
+      std::size_t result = 0ul;
+      for(unsigned int d = 0u; d < dims.size(); ++d)
+        result = result * extents[d] + (index[dims[d]] - lobound[dims[d]]);
+      return result;
+    }
+
+    /// The first tile of each dimension of a tiled range
+    inline std::vector<std::size_t> tile_lobound(const TiledRange& trange) {
+      std::vector<std::size_t> result;
+      for(const auto& trange1 : trange.data())
+        result.push_back(trange1.tiles_range().first);
+      return result;
+    }
+
+    /// Visit the non-zero tile pairs of a contraction
+
+    /// \c op is called with the ordinals of the left-hand tile, the
+    /// right-hand tile, and the result tile of each pair of non-zero argument
+    /// tiles, the number of floating point operations of their product, and
+    /// the volume of the result tile. The ordinal of a result tile is its
+    /// row-major ordinal in the tile range of the result.
+    /// \param result_vars The indices of the result, e.g. <tt>"i,j"</tt>
+    /// \param left_vars The indices of the left-hand argument
+    /// \param left_trange The tiled range of the left-hand argument
+    /// \param left_shape The shape of the left-hand argument
+    /// \param right_vars The indices of the right-hand argument
+    /// \param right_trange The tiled range of the right-hand argument
+    /// \param right_shape The shape of the right-hand argument
+    /// \param op The pair visitor
+    /// \return The number of tiles of the result
+    /// \throw TiledArray::Exception When the indices are not a contraction,
+    /// i.e. an index of the result is not in exactly one argument, or a
+    /// contracted index is not in both arguments, or the tilings of a
+    /// contracted index differ.
+    template <typename LeftShape, typename RightShape, typename Op>
+    std::size_t for_each_tile_pair(const std::string& result_vars,
+        const std::string& left_vars, const TiledRange& left_trange,
+        const LeftShape& left_shape, const std::string& right_vars,
+        const TiledRange& right_trange, const RightShape& right_shape, Op&& op)
+    {
+      const expressions::VariableList result(result_vars), left(left_vars),
+          right(right_vars);
+      TA_USER_ASSERT(left.dim() == left_trange.tiles_range().rank(),
+          "PmapAnalysis: The left-hand indices do not match the rank of the array.");
+      TA_USER_ASSERT(right.dim() == right_trange.tiles_range().rank(),
+          "PmapAnalysis: The right-hand indices do not match the rank of the array.");
+      auto find = [] (const expressions::VariableList& vars, const std::string& var) {
+        return unsigned(std::find(vars.begin(), vars.end(), var) - vars.begin());
+      };
+
+      // Classify the dimensions; result_dims holds the dimension of each
+      // result index in the left-hand argument, or the dimension in the
+      // right-hand argument plus the rank of the left-hand argument.
+      std::vector<unsigned int> result_dims, left_inner, right_inner;
+      std::vector<std::size_t> inner_extents, result_extents;
+      for(const auto& var : result) {
+        const unsigned int l = find(left, var), r = find(right, var);
+        TA_USER_ASSERT((l < left.dim()) != (r < right.dim()),
+            "PmapAnalysis: A result index must be in exactly one argument.");
+        const TiledRange1& trange1 = (l < left.dim() ? left_trange.data()[l] :
+            right_trange.data()[r]);
+        result_extents.push_back(trange1.tiles_range().second - trange1.tiles_range().first);
+        result_dims.push_back(l < left.dim() ? l : left.dim() + r);
+      }
+      for(unsigned int l = 0u; l < left.dim(); ++l) {
+        if(find(result, left[l]) < result.dim())
+          continue;
+        const unsigned int r = find(right, left[l]);
+        TA_USER_ASSERT(r < right.dim(),
+            "PmapAnalysis: A contracted index must be in both arguments.");
+        TA_USER_ASSERT(left_trange.data()[l] == right_trange.data()[r],
+            "PmapAnalysis: The tilings of a contracted index differ.");
+        left_inner.push_back(l);
+        right_inner.push_back(r);
+        const auto& tiles = left_trange.data()[l].tiles_range();
+        inner_extents.push_back(tiles.second - tiles.first);
+      }
+      for(const auto& var : right)
+        TA_USER_ASSERT((find(result, var) < result.dim()) || (find(left, var) < left.dim()),
+            "PmapAnalysis: A right-hand index is neither in the result nor in the left-hand argument.");
+
+      std::size_t inner_size = 1ul, result_size = 1ul;
+      for(const auto extent : inner_extents)
+        inner_size *= extent;
+      for(const auto extent : result_extents)
+        result_size *= extent;
+
+      // Group the non-zero tiles of the arguments by their contracted tile
+      const std::vector<std::size_t> left_lobound = tile_lobound(left_trange),
+          right_lobound = tile_lobound(right_trange);
+      std::vector<std::vector<std::size_t> > left_tiles(inner_size), right_tiles(inner_size);
+      std::vector<double> left_volume(left_trange.tiles_range().volume(), 0.0),
+          left_inner_volume(left_volume.size(), 0.0),
+          right_volume(right_trange.tiles_range().volume(), 0.0);
+      for(std::size_t i = 0ul; i < left_volume.size(); ++i) {
+        if(left_shape.is_zero(i))
+          continue;
+        const auto index = left_trange.tiles_range().idx(i);
+        left_tiles[pmap_analysis_ordinal(index, left_inner, inner_extents, left_lobound)].push_back(i);
+        const auto range = left_trange.make_tile_range(i);
+        left_volume[i] = range.volume();
+        left_inner_volume[i] = 1.0;
+        for(const unsigned int l : left_inner)
+          left_inner_volume[i] *= range.extent(l);
+      }
+      for(std::size_t i = 0ul; i < right_volume.size(); ++i) {
+        if(right_shape.is_zero(i))
+          continue;
+        const auto index = right_trange.tiles_range().idx(i);
+        right_tiles[pmap_analysis_ordinal(index, right_inner, inner_extents, right_lobound)].push_back(i);
+        right_volume[i] = right_trange.make_tile_range(i).volume();
+      }
+
+      // Visit the pairs
+      for(std::size_t k = 0ul; k < inner_size; ++k) {
+        for(const std::size_t l : left_tiles[k]) {
+          const auto left_index = left_trange.tiles_range().idx(l);
+          for(const std::size_t r : right_tiles[k]) {
+            const auto right_index = right_trange.tiles_range().idx(r);
+            std::size_t c = 0ul;
+            for(unsigned int d = 0u; d < result_dims.size(); ++d) {
+              const unsigned int dim = result_dims[d];
+              c = c * result_extents[d] + (dim < left.dim() ?
+                  left_index[dim] - left_lobound[dim] :
+                  right_index[dim - left.dim()] - right_lobound[dim - left.dim()]);
+            }
+            const double inner = left_inner_volume[l];
+            op(l, r, c, 2.0 * left_volume[l] * right_volume[r] / inner,
+                left_volume[l] * right_volume[r] / (inner * inner));
+          }
+        }
+      }
+
+      return result_size;
+    }
+
+  } // namespace detail
+
+  /// Load and communication analysis of process maps
+
+  /// A process map decides how much each process stores and computes, and
+  /// how much data it exchanges with the others, but these depend on the
+  /// sparsity of the arrays and on the expressions that use them. This
+  /// analyzer accumulates the load of each process for a set of arrays and
+  /// contractions under given process maps, so that alternative maps can be
+  /// compared before they are used:
+  /// \code
+  /// TiledArray::PmapAnalysis analysis(world.size());
+  /// analysis.add_contraction("i,j", *c_pmap, "i,k", a.trange(), a.shape(),
+  ///     *a.pmap(), "k,j", b.trange(), b.shape(), *b.pmap());
+  /// if(world.rank() == 0)
+  ///   analysis.print(std::cout);
+  /// \endcode
+  /// Contractions are modeled with the owner-computes rule: each product of
+  /// a pair of non-zero argument tiles is computed by the owner of its result
+  /// tile, and each argument tile is sent once to every other process that
+  /// needs it. This is the minimum communication of any algorithm that keeps
+  /// the result in place; SUMMA may send more, since it forwards the tiles of
+  /// a row or column of the process grid to all of its processes. The
+  /// analysis is local, i.e. no communication is needed, and its cost is
+  /// proportional to the number of non-zero tile pairs.
+  class PmapAnalysis {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+  private:
+    std::vector<PmapLoad> load_; ///< The load of each process
+    double element_size_; ///< The number of bytes of an element
+
+    /// Ratio of the maximum to the average of a load component
+    template <typename Op>
+    double imbalance(Op&& op) const {
+      double total = 0.0, max = 0.0;
+      for(const PmapLoad& load : load_) {
+        total += op(load);
+        max = std::max(max, op(load));
+      }
+      return (total > 0.0 ? max * double(load_.size()) / total : 1.0);
+    }
+
+  public:
+
+    /// Constructor
+
+    /// \param procs The number of processes
+    /// \param element_size The number of bytes of an element
+    explicit PmapAnalysis(const size_type procs,
+        const double element_size = sizeof(double)) :
+      load_(procs), element_size_(element_size)
+    {
+      TA_USER_ASSERT(procs > 0ul, "PmapAnalysis: The number of processes must be positive.");
+    }
+
+    /// Add the storage of an array
+
+    /// \tparam Shape The shape type
+    /// \param trange The tiled range of the array
+    /// \param shape The shape of the array
+    /// \param pmap The process map of the array
+    template <typename Shape>
+    void add_array(const TiledRange& trange, const Shape& shape, const Pmap& pmap) {
+      TA_USER_ASSERT(pmap.size() == trange.tiles_range().volume(),
+          "PmapAnalysis::add_array(): The process map does not match the tiled range.");
+      TA_USER_ASSERT(pmap.procs() == load_.size(),
+          "PmapAnalysis::add_array(): The process map has a different number of processes.");
+      for(size_type i = 0ul; i < pmap.size(); ++i) {
+        if(shape.is_zero(i))
+          continue;
+        PmapLoad& load = load_[pmap.owner(i)];
+        ++load.tiles;
+        load.bytes += double(trange.make_tile_range(i).volume()) * element_size_;
+      }
+    }
+
+    /// Add the storage of an array
+
+    /// \tparam Tile The tile type of the array
+    /// \tparam Policy The policy type of the array
+    /// \param array The array
+    template <typename Tile, typename Policy>
+    void add_array(const DistArray<Tile, Policy>& array) {
+      add_array(array.trange(), array.shape(), *array.pmap());
+    }
+
+    /// Add a contraction
+
+    /// The flops of each result tile are added to its owner, and the bytes
+    /// of each argument tile that is needed by other processes are added to
+    /// their received bytes and to the bytes sent by its owner. The storage
+    /// of the arguments is not added (see \c add_array() ), but the storage
+    /// of the result tiles that have a non-zero product is.
+    /// \tparam LeftShape The shape type of the left-hand argument
+    /// \tparam RightShape The shape type of the right-hand argument
+    /// \param result_vars The indices of the result, e.g. <tt>"i,j"</tt>
+    /// \param result_pmap The process map of the result
+    /// \param left_vars The indices of the left-hand argument
+    /// \param left_trange The tiled range of the left-hand argument
+    /// \param left_shape The shape of the left-hand argument
+    /// \param left_pmap The process map of the left-hand argument
+    /// \param right_vars The indices of the right-hand argument
+    /// \param right_trange The tiled range of the right-hand argument
+    /// \param right_shape The shape of the right-hand argument
+    /// \param right_pmap The process map of the right-hand argument
+    /// \throw TiledArray::Exception When the indices are not a contraction,
+    /// or a process map does not match its array.
+    template <typename LeftShape, typename RightShape>
+    void add_contraction(const std::string& result_vars, const Pmap& result_pmap,
+        const std::string& left_vars, const TiledRange& left_trange,
+        const LeftShape& left_shape, const Pmap& left_pmap,
+        const std::string& right_vars, const TiledRange& right_trange,
+        const RightShape& right_shape, const Pmap& right_pmap)
+    {
+      TA_USER_ASSERT(left_pmap.size() == left_trange.tiles_range().volume(),
+          "PmapAnalysis::add_contraction(): The left-hand process map does not match the tiled range.");
+      TA_USER_ASSERT(right_pmap.size() == right_trange.tiles_range().volume(),
+          "PmapAnalysis::add_contraction(): The right-hand process map does not match the tiled range.");
+      TA_USER_ASSERT((result_pmap.procs() == load_.size()) &&
+          (left_pmap.procs() == load_.size()) && (right_pmap.procs() == load_.size()),
+          "PmapAnalysis::add_contraction(): A process map has a different number of processes.");
+
+      // The processes that need each argument tile, and the result tiles
+      // with a non-zero product
+      std::vector<std::vector<size_type> > left_users(left_pmap.size()),
+          right_users(right_pmap.size());
+      std::vector<char> nonzero(result_pmap.size(), 0);
+      const size_type result_size = detail::for_each_tile_pair(result_vars,
+          left_vars, left_trange, left_shape, right_vars, right_trange, right_shape,
+          [&] (const size_type l, const size_type r, const size_type c,
+              const double flops, const double volume)
+          {
+            TA_USER_ASSERT(c < nonzero.size(),
+                "PmapAnalysis::add_contraction(): The result process map does not match the result.");
+            const size_type owner = result_pmap.owner(c);
+            load_[owner].flops += flops;
+            left_users[l].push_back(owner);
+            right_users[r].push_back(owner);
+            if(! nonzero[c]) {
+              nonzero[c] = 1;
+              ++load_[owner].tiles;
+              load_[owner].bytes += volume * element_size_;
+            }
+          });
+      TA_USER_ASSERT(result_size == result_pmap.size(),
+          "PmapAnalysis::add_contraction(): The result process map does not match the result.");
+
+      // Argument communication
+      auto send = [&] (std::vector<std::vector<size_type> >& users,
+          const TiledRange& trange, const Pmap& pmap) {
+        for(size_type i = 0ul; i < users.size(); ++i) {
+          std::vector<size_type>& procs = users[i];
+          if(procs.empty())
+            continue;
+          std::sort(procs.begin(), procs.end());
+          procs.erase(std::unique(procs.begin(), procs.end()), procs.end());
+          const double bytes = double(trange.make_tile_range(i).volume()) * element_size_;
+          const size_type owner = pmap.owner(i);
+          for(const size_type p : procs) {
+            if(p == owner)
+              continue;
+            load_[p].recv_bytes += bytes;
+            load_[owner].send_bytes += bytes;
+          }
+        }
+      };
+      send(left_users, left_trange, left_pmap);
+      send(right_users, right_trange, right_pmap);
+    }
+
+    /// Add a contraction of arrays
+
+    /// \tparam Tile The tile type of the arrays
+    /// \tparam Policy The policy type of the arrays
+    /// \param result_vars The indices of the result
+    /// \param result_pmap The process map of the result
+    /// \param left_vars The indices of the left-hand argument
+    /// \param left The left-hand argument
+    /// \param right_vars The indices of the right-hand argument
+    /// \param right The right-hand argument
+    template <typename Tile, typename Policy>
+    void add_contraction(const std::string& result_vars, const Pmap& result_pmap,
+        const std::string& left_vars, const DistArray<Tile, Policy>& left,
+        const std::string& right_vars, const DistArray<Tile, Policy>& right)
+    {
+      add_contraction(result_vars, result_pmap, left_vars, left.trange(),
+          left.shape(), *left.pmap(), right_vars, right.trange(), right.shape(),
+          *right.pmap());
+    }
+
+    /// Discard the accumulated loads
+    void reset() { std::fill(load_.begin(), load_.end(), PmapLoad()); }
+
+    /// \return The load of each process
+    const std::vector<PmapLoad>& load() const { return load_; }
+
+    /// \return The sum of the loads of all processes
+    PmapLoad total() const {
+      PmapLoad result;
+      for(const PmapLoad& load : load_) {
+        result.tiles += load.tiles;
+        result.bytes += load.bytes;
+        result.flops += load.flops;
+        result.recv_bytes += load.recv_bytes;
+        result.send_bytes += load.send_bytes;
+      }
+      return result;
+    }
+
+    /// \return The ratio of the maximum to the average number of bytes stored
+    double byte_imbalance() const {
+      return imbalance([] (const PmapLoad& load) { return load.bytes; });
+    }
+
+    /// \return The ratio of the maximum to the average number of flops
+    double flop_imbalance() const {
+      return imbalance([] (const PmapLoad& load) { return load.flops; });
+    }
+
+    /// \return The ratio of the maximum to the average number of bytes
+    /// received
+    double recv_imbalance() const {
+      return imbalance([] (const PmapLoad& load) { return load.recv_bytes; });
+    }
+
+    /// \return The maximum number of bytes received by a process
+    double max_recv_bytes() const {
+      double result = 0.0;
+      for(const PmapLoad& load : load_)
+        result = std::max(result, load.recv_bytes);
+      return result;
+    }
+
+    /// Print the load of each process and the imbalances
+
+    /// \param os The output stream
+    void print(std::ostream& os) const {
+      const auto flags = os.flags();
+      const auto precision = os.precision();
+      os << std::setw(8) << "rank" << std::setw(10) << "tiles" << std::setw(14)
+         << "stored (MB)" << std::setw(12) << "GFLOP" << std::setw(12) << "recv (MB)"
+         << std::setw(12) << "sent (MB)" << "\n" << std::fixed << std::setprecision(3);
+      for(size_type p = 0ul; p < load_.size(); ++p)
+        os << std::setw(8) << p << std::setw(10) << load_[p].tiles << std::setw(14)
+           << load_[p].bytes / 1048576.0 << std::setw(12) << load_[p].flops * 1.0e-9
+           << std::setw(12) << load_[p].recv_bytes / 1048576.0 << std::setw(12)
+           << load_[p].send_bytes / 1048576.0 << "\n";
+      const PmapLoad sum = total();
+      os << std::setw(8) << "total" << std::setw(10) << sum.tiles << std::setw(14)
+         << sum.bytes / 1048576.0 << std::setw(12) << sum.flops * 1.0e-9
+         << std::setw(12) << sum.recv_bytes / 1048576.0 << std::setw(12)
+         << sum.send_bytes / 1048576.0 << "\n"
+         << "imbalance (max/average): stored " << byte_imbalance() << ", flops "
+         << flop_imbalance() << ", received " << recv_imbalance() << "\n";
+      os.flags(flags);
+      os.precision(precision);
+    }
+
+  }; // class PmapAnalysis
+
+  /// Flops of each result tile of a contraction
+
+  /// The flops can be used as the weights of a \c detail::WeightedPmap that
+  /// balances the work of the contraction.
+  /// \tparam LeftShape The shape type of the left-hand argument
+  /// \tparam RightShape The shape type of the right-hand argument
+  /// \param result_vars The indices of the result, e.g. <tt>"i,j"</tt>
+  /// \param left_vars The indices of the left-hand argument
+  /// \param left_trange The tiled range of the left-hand argument
+  /// \param left_shape The shape of the left-hand argument
+  /// \param right_vars The indices of the right-hand argument
+  /// \param right_trange The tiled range of the right-hand argument
+  /// \param right_shape The shape of the right-hand argument
+  /// \return The number of floating point operations of each result tile, in
+  /// row-major order
+  template <typename LeftShape, typename RightShape>
+  inline std::vector<double>
+  contraction_tile_flops(const std::string& result_vars,
+      const std::string& left_vars, const TiledRange& left_trange,
+      const LeftShape& left_shape, const std::string& right_vars,
+      const TiledRange& right_trange, const RightShape& right_shape)
+  {
+    std::vector<std::pair<std::size_t, double> > flops;
+    const std::size_t size = detail::for_each_tile_pair(result_vars, left_vars,
+        left_trange, left_shape, right_vars, right_trange, right_shape,
+        [&] (const std::size_t, const std::size_t, const std::size_t c,
+            const double f, const double) { flops.emplace_back(c, f); });
+    std::vector<double> result(size, 0.0);
+    for(const auto& tile : flops)
+      result[tile.first] += tile.second;
+    return result;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_PMAP_ANALYSIS_H__INCLUDED
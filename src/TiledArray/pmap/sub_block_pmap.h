@@ -0,0 +1,101 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  sub_block_pmap.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_SUB_BLOCK_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_SUB_BLOCK_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <TiledArray/block_range.h>
+#include <memory>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Process map of a block of an array
+
+    /// Tile \c i of the block is owned by the owner of the corresponding tile
+    /// of the array, so the result tiles of an expression that is assigned to
+    /// the block are evaluated on the processes that own the target tiles.
+    class SubBlockPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    private:
+
+      const std::shared_ptr<Pmap> pmap_; ///< The process map of the array
+      const BlockRange block_; ///< The tiles range of the block
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+      /// Construct a sub-block process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param pmap The process map of the array
+      /// \param block The block of the tiles range of the array
+      SubBlockPmap(World& world, const std::shared_ptr<Pmap>& pmap,
+          const BlockRange& block) :
+        Pmap(world, block.volume()), pmap_(pmap), block_(block)
+      {
+        TA_ASSERT(pmap_);
+        TA_ASSERT(pmap_->procs() == procs_);
+
+        // The local tiles are the block tiles of the local array tiles
+        for(size_type tile = 0ul; tile < size_; ++tile)
+          if(pmap_->is_local(block_.ordinal(tile)))
+            local_.push_back(tile);
+      }
+
+      virtual ~SubBlockPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return pmap_->owner(block_.ordinal(tile));
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return pmap_->is_local(block_.ordinal(tile));
+      }
+
+    }; // class SubBlockPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_SUB_BLOCK_PMAP_H__INCLUDED
@@ -0,0 +1,168 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  weighted_pmap.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
+#define TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
+
+#include <TiledArray/pmap/pmap.h>
+#include <algorithm>
+#include <vector>
+
+/// The load imbalance above which the result of a sparse contraction is
+/// distributed with a \c WeightedPmap
+#ifndef TILEDARRAY_WEIGHTED_PMAP_THRESHOLD
+#define TILEDARRAY_WEIGHTED_PMAP_THRESHOLD 1.25
+#endif // TILEDARRAY_WEIGHTED_PMAP_THRESHOLD
+
+namespace TiledArray {
+  namespace detail {
+
+    /// A cost weighted process map
+
+    /// Tiles are mapped to processes in contiguous blocks of approximately
+    /// equal total weight, where the weight of a tile is an estimate of the
+    /// cost of storing and operating on it (e.g. the volume of the non-zero
+    /// tiles of a sparse array). Blocks of tile ordinals follow the row-major
+    /// order of the tiles, so tiles that are near each other in the array
+    /// are kept on the same process. The owner of a tile is found with a
+    /// binary search of the block boundaries.
+    class WeightedPmap : public Pmap {
+    protected:
+
+      // Import Pmap protected variables
+      using Pmap::rank_; ///< The rank of this process
+      using Pmap::procs_; ///< The number of processes
+      using Pmap::size_; ///< The number of tiles mapped among all processes
+      using Pmap::local_; ///< A list of local tiles
+
+    public:
+      typedef Pmap::size_type size_type; ///< Size type
+
+    private:
+
+      std::vector<size_type> first_; ///< The first tile of each process, and the tile count
+
+    public:
+
+      /// Partition weighted tiles
+
+      /// \param weights The weight of each tile
+      /// \param procs The number of processes
+      /// \return The first tile of each process, followed by the number of
+      /// tiles
+      static std::vector<size_type>
+      partition(const std::vector<double>& weights, const size_type procs) {
+        TA_ASSERT(procs > 0ul);
+        const size_type size = weights.size();
+
+        double total = 0.0;
+        for(const double w : weights) {
+          TA_ASSERT(w >= 0.0);
+          total += w;
+        }
+
+        std::vector<size_type> first(procs + 1ul, size);
+        first[0] = 0ul;
+        if(total == 0.0) {
+          // Without weights, distribute the tiles evenly
+          for(size_type p = 1ul; p < procs; ++p)
+            first[p] = (p * size) / procs;
+          return first;
+        }
+
+        // Process p starts at the first tile where the sum of the weights of
+        // the preceding tiles exceeds p/procs of the total weight.
+        double sum = 0.0;
+        size_type p = 1ul;
+        for(size_type i = 0ul; (i < size) && (p < procs); ++i) {
+          const double boundary = sum + 0.5 * weights[i];
+          for(; (p < procs) && (boundary * double(procs) >= double(p) * total); ++p)
+            first[p] = i;
+          sum += weights[i];
+        }
+
+        return first;
+      }
+
+      /// Load imbalance of a process map
+
+      /// \param pmap The process map
+      /// \param weights The weight of each tile
+      /// \return The ratio of the maximum process load to the average load
+      static double imbalance(const Pmap& pmap, const std::vector<double>& weights) {
+        TA_ASSERT(pmap.size() == weights.size());
+        std::vector<double> load(pmap.procs(), 0.0);
+        double total = 0.0;
+        for(size_type i = 0ul; i < weights.size(); ++i) {
+          load[pmap.owner(i)] += weights[i];
+          total += weights[i];
+        }
+        if(total == 0.0)
+          return 1.0;
+        return *std::max_element(load.begin(), load.end()) * double(pmap.procs()) / total;
+      }
+
+      /// Construct a weighted process map
+
+      /// \param world The world where the tiles will be mapped
+      /// \param weights The weight of each tile, which must be the same on
+      /// all processes
+      WeightedPmap(World& world, const std::vector<double>& weights) :
+        Pmap(world, weights.size()), first_(partition(weights, procs_))
+      {
+        local_.reserve(first_[rank_ + 1ul] - first_[rank_]);
+        for(size_type i = first_[rank_]; i < first_[rank_ + 1ul]; ++i) {
+          TA_ASSERT(WeightedPmap::owner(i) == rank_);
+          local_.push_back(i);
+        }
+      }
+
+      virtual ~WeightedPmap() { }
+
+      /// Maps \c tile to the processor that owns it
+
+      /// \param tile The tile to be queried
+      /// \return Processor that logically owns \c tile
+      virtual size_type owner(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return (std::upper_bound(first_.begin() + 1, first_.end() - 1, tile)
+            - (first_.begin() + 1));
+      }
+
+      /// Check that the tile is owned by this process
+
+      /// \param tile The tile to be checked
+      /// \return \c true if \c tile is owned by this process, otherwise \c false .
+      virtual bool is_local(const size_type tile) const {
+        TA_ASSERT(tile < size_);
+        return (tile >= first_[rank_]) && (tile < first_[rank_ + 1ul]);
+      }
+
+    }; // class WeightedPmap
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PMAP_WEIGHTED_PMAP_H__INCLUDED
@@ -0,0 +1,64 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  bitset_sparse_policy.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_POLICIES_BITSET_SPARSE_POLICY_H__INCLUDED
+#define TILEDARRAY_POLICIES_BITSET_SPARSE_POLICY_H__INCLUDED
+
+#include <TiledArray/tiled_range.h>
+#include <TiledArray/pmap/blocked_pmap.h>
+#include <TiledArray/bitset_shape.h>
+
+namespace TiledArray {
+
+  /// Policy of sparse arrays with a pattern shape
+
+  /// Arrays with this policy store only the pattern of their non-zero tiles
+  /// (see BitsetShape ), which is preferable to SparsePolicy when the
+  /// sparsity is known from the structure of the array and the norms of the
+  /// tiles are not needed to screen contractions.
+  class BitsetSparsePolicy {
+  public:
+    typedef TiledArray::TiledRange trange_type;
+    typedef trange_type::range_type range_type;
+    typedef range_type::size_type size_type;
+    typedef TiledArray::BitsetShape shape_type;
+    typedef TiledArray::Pmap pmap_interface;
+    typedef TiledArray::detail::BlockedPmap default_pmap_type;
+
+    /// Create a default process map
+
+    /// \param world The world of the process map
+    /// \param size The number of tiles in the array
+    /// \return A shared pointer to a process map
+    static std::shared_ptr<pmap_interface>
+    default_pmap(World& world, const std::size_t size) {
+      return std::shared_ptr<pmap_interface>(new default_pmap_type(world, size));
+    }
+
+  }; // class BitsetSparsePolicy
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_POLICIES_BITSET_SPARSE_POLICY_H__INCLUDED
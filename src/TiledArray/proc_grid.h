@@ -27,7 +27,9 @@
 #define TILEDARRAY_GRID_H__INCLUDED
 
 #include <TiledArray/pmap/cyclic_pmap.h>
+#include <TiledArray/pmap/layered_pmap.h>
 #include <TiledArray/math/eigen.h>
+#include <TiledArray/proc_topology.h>
 
 namespace TiledArray {
   namespace detail {
@@ -56,6 +58,21 @@ namespace TiledArray {
     /// \f]
     /// where the positive, real root of \f$P_{\rm{row}}\f$ give the optimal
     /// optimal communication time.
+    ///
+    /// For communication-avoiding (2.5D) contractions the processes may be
+    /// split into \f$c\f$ layers, each of which holds a 2D grid of
+    /// \f$P/c\f$ processes. The grid dimensions are then optimized for
+    /// \f$P/c\f$ processes, and the row and column groups, and process
+    /// coordinate maps refer to processes in the layer of this process.
+    ///
+    /// When the processes are spread over several nodes (or sockets), the
+    /// grid dimensions are also chosen to reduce the number of row and column
+    /// broadcast messages that cross node (or socket) boundaries, as estimated
+    /// by \c ProcTopology . The grid is only changed if it does not increase
+    /// the number of unused processes. Process \c p is still at grid coordinate
+    /// <tt>(p / proc_cols, p % proc_cols)</tt>, so with the usual block
+    /// placement of ranks, row groups stay inside a node when the number of
+    /// process columns divides the number of processes per node.
     class ProcGrid {
     public:
       typedef uint_fast32_t size_type;
@@ -74,6 +91,9 @@ namespace TiledArray {
       size_type local_rows_; ///< The number of local element rows
       size_type local_cols_; ///< The number of local element columns
       size_type local_size_; ///< Number of local elements
+      size_type layers_; ///< Number of process grid layers
+      size_type layer_stride_; ///< Rank offset between the first processes of adjacent layers
+      ProcessID rank_layer_; ///< This process's layer in the process grid
 
 
       /// Compute the number of process rows that minimizes communication
@@ -168,12 +188,70 @@ namespace TiledArray {
         }
       }
 
+      /// Topology-aware grid selection
+
+      /// Search for the grid dimensions that minimize the estimated SUMMA
+      /// communication cost, where the cost of the row and column broadcasts
+      /// is given by \c topology . The candidate grids are limited to those
+      /// with no more unused processes than the current grid and with a number
+      /// of process rows within a factor of two of the current grid. The
+      /// cost is evaluated for the first layer, so that all processes choose
+      /// the same grid.
+      /// \param topology The process topology
+      /// \param nprocs The number of processes in the grid
+      /// \param min_proc_rows The minimum number of process rows
+      /// \param max_proc_rows The maximum number of process rows
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      void optimize_topology(const ProcTopology& topology, const size_type nprocs,
+          const size_type min_proc_rows, const size_type max_proc_rows,
+          const double row_size, const double col_size)
+      {
+        // Compute the average broadcast cost of all rows and columns
+        auto cost = [&] (const size_type proc_rows, const size_type proc_cols) {
+          double row_cost = 0.0, col_cost = 0.0;
+          for(size_type row = 0u; row < proc_rows; ++row)
+            row_cost += topology.broadcast_cost(proc_cols,
+                [=] (const size_type i) { return ProcessID(row * proc_cols + i); });
+          for(size_type col = 0u; col < proc_cols; ++col)
+            col_cost += topology.broadcast_cost(proc_rows,
+                [=] (const size_type i) { return ProcessID(i * proc_cols + col); });
+          return (row_size / proc_rows) * (row_cost / proc_rows)
+              + (col_size / proc_cols) * (col_cost / proc_cols);
+        };
+
+        const size_type unused = nprocs - proc_rows_ * proc_cols_;
+        double min_cost = cost(proc_rows_, proc_cols_);
+
+        const size_type first = std::max<size_type>(min_proc_rows, proc_rows_ / 2u);
+        const size_type last = std::min<size_type>(max_proc_rows, proc_rows_ * 2u);
+        for(size_type proc_rows = first; proc_rows <= last; ++proc_rows) {
+          const size_type proc_cols = std::min<size_type>(nprocs / proc_rows, cols_);
+          if((nprocs - proc_rows * proc_cols) > unused)
+            continue;
+
+          // Only accept grids with a significant improvement
+          const double test_cost = cost(proc_rows, proc_cols);
+          if(test_cost < (0.99 * min_cost)) {
+            proc_rows_ = proc_rows;
+            proc_cols_ = proc_cols;
+            min_cost = test_cost;
+          }
+        }
+      }
+
       /// Member variable initialization
 
       /// This function initializes the member variables with with the optimal
       /// sizes.
+      /// \param rank The rank of this process in the grid
+      /// \param nprocs The number of processes in the grid
+      /// \param row_size The number of element rows
+      /// \param col_size The number of element columns
+      /// \param topology The topology of the processes of the first layer
       void init(const size_type rank, const size_type nprocs,
-          const std::size_t row_size, const std::size_t col_size)
+          const std::size_t row_size, const std::size_t col_size,
+          const ProcTopology& topology)
       {
         // Check for the simple cases first ...
         if(nprocs == 1u) { // Only one process
@@ -231,6 +309,10 @@ namespace TiledArray {
                 min_proc_rows, max_proc_rows);
           }
 
+          if(! topology.trivial())
+            optimize_topology(topology, nprocs, min_proc_rows, max_proc_rows,
+                row_size, col_size);
+
           proc_size_ = proc_rows_ * proc_cols_;
 
           if(rank < proc_size_) {
@@ -253,7 +335,8 @@ namespace TiledArray {
       ProcGrid() :
         world_(NULL), rows_(0u), cols_(0u), size_(0u), proc_rows_(0u),
         proc_cols_(0u), proc_size_(0u), rank_row_(0), rank_col_(0),
-        local_rows_(0u), local_cols_(0u), local_size_(0u)
+        local_rows_(0u), local_cols_(0u), local_size_(0u), layers_(1u),
+        layer_stride_(0u), rank_layer_(0)
       { }
 
       /// Construct a process grid
@@ -266,20 +349,46 @@ namespace TiledArray {
       /// \param cols The number of tile columns
       /// \param row_size The number of element rows
       /// \param col_size The number of element columns
+      /// \param layers The number of process grid layers [ default = 1 ]
+      /// \note When \c layers is greater than one, processes that are not
+      /// included in any layer (i.e. <tt>rank >= layers * (P / layers)</tt>)
+      /// have no local elements.
       ProcGrid(World& world, const size_type rows, const size_type cols,
-          const std::size_t row_size, const std::size_t col_size) :
+          const std::size_t row_size, const std::size_t col_size,
+          const size_type layers = 1u) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0ul), proc_cols_(0ul), proc_size_(0ul),
         rank_row_(-1), rank_col_(-1),
-        local_rows_(0ul), local_cols_(0ul), local_size_(0ul)
+        local_rows_(0ul), local_cols_(0ul), local_size_(0ul),
+        layers_(layers), layer_stride_(world.size() / layers), rank_layer_(-1)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows_ >= 1u);
         TA_ASSERT(cols_ >= 1u);
         TA_ASSERT(row_size >= 1ul);
         TA_ASSERT(col_size >= 1ul);
-
-        init(world_->rank(), world_->size(), row_size, col_size);
+        TA_ASSERT(layers_ >= 1u);
+        TA_ASSERT(layers_ <= size_type(world_->size()));
+
+        // Get the node and socket placement of processes
+        std::shared_ptr<const ProcTopology> topology =
+            (world_->size() > 1 ? ProcTopology::get(world) :
+                std::make_shared<const ProcTopology>());
+
+        const size_type rank = world_->rank();
+        if(rank < (layers_ * layer_stride_)) {
+          rank_layer_ = rank / layer_stride_;
+          init(rank % layer_stride_, layer_stride_, row_size, col_size, *topology);
+        } else {
+          // This process is not a member of any layer, so only the grid
+          // dimensions are computed.
+          init(0u, layer_stride_, row_size, col_size, *topology);
+          rank_row_ = -1;
+          rank_col_ = -1;
+          local_rows_ = 0u;
+          local_cols_ = 0u;
+          local_size_ = 0u;
+        }
       }
 
 #ifdef TILEDARRAY_ENABLE_TEST_PROC_GRID
@@ -300,12 +409,15 @@ namespace TiledArray {
       /// \param cols The number of tile columns
       /// \param row_size The number of element rows
       /// \param col_size The number of element columns
+      /// \param topology The test process topology
       ProcGrid(World& world, const size_type test_rank, size_type test_nprocs,
           const size_type rows, const size_type cols,
-          const std::size_t row_size, const std::size_t col_size) :
+          const std::size_t row_size, const std::size_t col_size,
+          const ProcTopology& topology = ProcTopology()) :
         world_(&world), rows_(rows), cols_(cols), size_(rows_ * cols_),
         proc_rows_(0u), proc_cols_(0u), proc_size_(0u), rank_row_(-1),
-        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u)
+        rank_col_(-1), local_rows_(0u), local_cols_(0u), local_size_(0u),
+        layers_(1u), layer_stride_(test_nprocs), rank_layer_(0)
       {
         // Check for non-zero sizes
         TA_ASSERT(rows >= 1u);
@@ -314,7 +426,7 @@ namespace TiledArray {
         TA_ASSERT(col_size >= 1u);
         TA_ASSERT(test_rank < test_nprocs);
 
-        init(test_rank, test_nprocs, row_size, col_size);
+        init(test_rank, test_nprocs, row_size, col_size, topology);
       }
 #endif // TILEDARRAY_ENABLE_TEST_PROC_GRID
 
@@ -330,7 +442,8 @@ namespace TiledArray {
         proc_cols_(other.proc_cols_), proc_size_(other.proc_size_),
         rank_row_(other.rank_row_), rank_col_(other.rank_col_),
         local_rows_(other.local_rows_), local_cols_(other.local_cols_),
-        local_size_(other.local_size_)
+        local_size_(other.local_size_), layers_(other.layers_),
+        layer_stride_(other.layer_stride_), rank_layer_(other.rank_layer_)
       { }
 
       /// Copy assignment operator
@@ -349,10 +462,70 @@ namespace TiledArray {
         local_rows_ = other.local_rows_;
         local_cols_ = other.local_cols_;
         local_size_ = other.local_size_;
+        layers_ = other.layers_;
+        layer_stride_ = other.layer_stride_;
+        rank_layer_ = other.rank_layer_;
 
         return *this;
       }
 
+      /// Adopt the dimensions of the process grid of a result layout
+
+      /// When the result of a contraction is stored with a cyclic process map
+      /// over a different process grid, every result tile computed on this
+      /// grid is moved to its owner after SUMMA. This function switches to
+      /// the given grid dimensions when the extra SUMMA broadcast volume of
+      /// that grid is less than the volume of the result tiles that would be
+      /// moved, i.e. when
+      /// <tt>k (m/pr' + n/pc') - k (m/pr + n/pc) <= m n / (pr pc)</tt> .
+      /// Grids with more than one layer are not changed.
+      /// \param proc_rows The number of process rows of the result layout
+      /// \param proc_cols The number of process columns of the result layout
+      /// \param row_size The number of element rows ( \c m )
+      /// \param col_size The number of element columns ( \c n )
+      /// \param inner_size The number of elements in the contracted dimension ( \c k )
+      /// \return \c true if this grid has the dimensions
+      /// <tt>proc_rows x proc_cols</tt>
+      bool match_layout(const size_type proc_rows, const size_type proc_cols,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size)
+      {
+        TA_ASSERT(world_);
+        if((proc_rows == proc_rows_) && (proc_cols == proc_cols_))
+          return true;
+        if((layers_ != 1u) || (proc_rows < 1u) || (proc_cols < 1u) ||
+            (proc_rows > rows_) || (proc_cols > cols_) ||
+            ((proc_rows * proc_cols) > size_type(world_->size())))
+          return false;
+
+        // Compare the broadcast volumes of the grids with the result volume
+        const double m = row_size, n = col_size, k = inner_size;
+        const double bcast = k * (m / proc_rows_ + n / proc_cols_);
+        const double layout_bcast = k * (m / proc_rows + n / proc_cols);
+        if((layout_bcast - bcast) > (m * n / (proc_rows_ * proc_cols_)))
+          return false;
+
+        proc_rows_ = proc_rows;
+        proc_cols_ = proc_cols;
+        proc_size_ = proc_rows_ * proc_cols_;
+        const size_type rank = world_->rank();
+        if(rank < proc_size_) {
+          rank_row_ = rank / proc_cols_;
+          rank_col_ = rank % proc_cols_;
+          local_rows_ = (rows_ / proc_rows_) + (size_type(rank_row_) < (rows_ % proc_rows_) ? 1u : 0u);
+          local_cols_ = (cols_ / proc_cols_) + (size_type(rank_col_) < (cols_ % proc_cols_) ? 1u : 0u);
+          local_size_ = local_rows_ * local_cols_;
+        } else {
+          rank_row_ = -1;
+          rank_col_ = -1;
+          local_rows_ = 0u;
+          local_cols_ = 0u;
+          local_size_ = 0u;
+        }
+
+        return true;
+      }
+
       /// Element row count accessor
 
       /// \return The number of element rows
@@ -409,6 +582,64 @@ namespace TiledArray {
       /// less than the number of process in world).
       size_type proc_size() const { return proc_size_; }
 
+      /// Select the number of layers for a contraction
+
+      /// A 2D grid can keep at most one process busy per result tile, so when
+      /// the result has fewer tiles than there are processes and the
+      /// contracted dimension is at least as large as the result dimensions
+      /// (e.g. a tall-skinny contraction with a long \c k ), the contracted
+      /// tiles are split over several layers, and the partial results of the
+      /// layers are reduced onto the first layer. Each layer holds a grid of
+      /// about one process per result tile. Otherwise a single layer is used,
+      /// since the reduction would move more data than the arguments.
+      /// \param nprocs The number of processes
+      /// \param rows The number of result tile rows
+      /// \param cols The number of result tile columns
+      /// \param inner The number of contracted tiles
+      /// \param row_size The number of result element rows
+      /// \param col_size The number of result element columns
+      /// \param inner_size The number of contracted elements
+      /// \return The number of process grid layers
+      static size_type default_layers(const size_type nprocs,
+          const size_type rows, const size_type cols, const size_type inner,
+          const std::size_t row_size, const std::size_t col_size,
+          const std::size_t inner_size)
+      {
+        const std::size_t size = std::size_t(rows) * std::size_t(cols);
+        if((nprocs < 2u) || (inner < 2u) || (size * 2ul > nprocs) ||
+            (inner_size < std::max(row_size, col_size)))
+          return 1u;
+
+        return std::max<size_type>(std::min<size_type>(nprocs / size, inner), 1u);
+      }
+
+      /// Process grid layer count accessor
+
+      /// \return The number of process grid layers
+      size_type layers() const { return layers_; }
+
+      /// Layer stride accessor
+
+      /// \return The rank offset between the first processes of adjacent
+      /// layers
+      size_type layer_stride() const { return layer_stride_; }
+
+      /// Rank layer accessor
+
+      /// \return The layer of this process in the process grid, or -1 if this
+      /// process is not included in any layer
+      ProcessID rank_layer() const { return rank_layer_; }
+
+      /// Map a layer to the process at this process's grid coordinate
+
+      /// \param layer The layer to be mapped
+      /// \return The process that corresponds to the process coordinate
+      /// \c (rank_row,rank_col) in \c layer
+      ProcessID map_layer(const size_type layer) const {
+        TA_ASSERT(layer < layers_);
+        return (layer * layer_stride_) + (rank_row_ * proc_cols_) + rank_col_;
+      }
+
 
       /// Construct a row group
 
@@ -425,7 +656,7 @@ namespace TiledArray {
           proc_list.reserve(proc_cols_);
 
           // Populate the row process list
-          size_type p = rank_row_ * proc_cols_;
+          size_type p = rank_layer_ * layer_stride_ + rank_row_ * proc_cols_;
           const size_type row_end = p + proc_cols_;
           for(; p < row_end; ++p)
             proc_list.push_back(p);
@@ -452,8 +683,9 @@ namespace TiledArray {
           proc_list.reserve(proc_rows_);
 
           // Populate the column process list
+          const size_type layer_offset = rank_layer_ * layer_stride_;
           for(size_type p = rank_col_; p < proc_size_; p += proc_cols_)
-            proc_list.push_back(p);
+            proc_list.push_back(layer_offset + p);
 
           // Construct the group
           if(proc_list.size() != 0)
@@ -469,7 +701,7 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (row,rank_col)
       ProcessID map_row(const size_type row) const {
         TA_ASSERT(row < proc_rows_);
-        return rank_col_ + row * proc_cols_;
+        return rank_layer_ * layer_stride_ + rank_col_ + row * proc_cols_;
       }
 
       /// Map a column to the process in this process's row
@@ -478,12 +710,13 @@ namespace TiledArray {
       /// \return The process the corresponds to the process coordinate \c (rank_row,col)
       ProcessID map_col(const size_type col) const {
         TA_ASSERT(col < proc_cols_);
-        return rank_row_ * proc_cols_ + col;
+        return rank_layer_ * layer_stride_ + rank_row_ * proc_cols_ + col;
       }
 
       /// Construct a cyclic process
 
       /// Construct a cyclic process map with the same phase as the process grid.
+      /// The result tiles are always mapped to the first layer.
       /// \return Cyclic process map
       std::shared_ptr<Pmap> make_pmap() const {
         TA_ASSERT(world_);
@@ -494,24 +727,34 @@ namespace TiledArray {
       /// Construct column phased a cyclic process
 
       /// Construct a cyclic process map where the column phase of the process
-      /// matches that of this process grid.
+      /// matches that of this process grid. If the grid has more than one layer,
+      /// row \c k is mapped to layer <tt>k % layers()</tt>.
       /// \param rows The number of rows in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_col_phase_pmap(const size_type rows) const {
         TA_ASSERT(world_);
 
+        if(layers_ > 1u)
+          return std::shared_ptr<Pmap>(new LayeredCyclicPmap(*world_, rows,
+              cols_, proc_rows_, proc_cols_, layers_, layer_stride_, true));
+
         return std::shared_ptr<Pmap>(new CyclicPmap(*world_, rows, cols_, proc_rows_, proc_cols_));
       }
 
       /// Construct row phased a cyclic process
 
       /// Construct a cyclic process map where the column phase of the process
-      /// matches that of this process grid.
+      /// matches that of this process grid. If the grid has more than one layer,
+      /// column \c k is mapped to layer <tt>k % layers()</tt>.
       /// \param cols The number of columns in the process map
       /// \return Cyclic process map with matching column phase
       std::shared_ptr<Pmap> make_row_phase_pmap(const size_type cols) const {
         TA_ASSERT(world_);
 
+        if(layers_ > 1u)
+          return std::shared_ptr<Pmap>(new LayeredCyclicPmap(*world_, rows_,
+              cols, proc_rows_, proc_cols_, layers_, layer_stride_, false));
+
         return std::shared_ptr<Pmap>(new CyclicPmap(*world_, rows_, cols, proc_rows_, proc_cols_));
       }
     }; // class Grid
@@ -0,0 +1,232 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  proc_topology.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PROC_TOPOLOGY_H__INCLUDED
+#define TILEDARRAY_PROC_TOPOLOGY_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// The node and socket placement of processes
+
+    /// Processes that share a node (or socket) are identified by the lowest
+    /// rank on that node (or socket). Nodes are detected with MPI shared
+    /// memory communicators. Sockets are detected with the Open MPI socket
+    /// communicator type when it is available; otherwise each node is treated
+    /// as a single socket.
+    ///
+    /// The topology is used to estimate the relative cost of a broadcast among
+    /// a group of processes. A broadcast to \f$g\f$ processes that span
+    /// \f$n_{\rm node}\f$ nodes and \f$n_{\rm socket}\f$ sockets requires
+    /// \f$n_{\rm node} - 1\f$ messages between nodes,
+    /// \f$n_{\rm socket} - n_{\rm node}\f$ messages between sockets of a node,
+    /// and \f$g - n_{\rm socket}\f$ messages within a socket.
+    class ProcTopology {
+    public:
+      typedef std::size_t size_type;
+
+      static constexpr double node_cost = 1.0; ///< Relative cost of a message between nodes
+      static constexpr double socket_cost = 0.5; ///< Relative cost of a message between sockets
+      static constexpr double core_cost = 0.25; ///< Relative cost of a message within a socket
+
+    private:
+      std::vector<ProcessID> node_; ///< The first process of the node of each process
+      std::vector<ProcessID> socket_; ///< The first process of the socket of each process
+      bool trivial_; ///< All messages have the same cost
+
+      /// Check for a trivial topology
+
+      /// \return \c true if all processes share a socket, or if each process
+      /// has its own node
+      bool is_trivial() const {
+        const std::size_t nprocs = node_.size();
+        bool one_socket = true, one_per_node = true;
+        for(std::size_t p = 0ul; p < nprocs; ++p) {
+          one_socket = one_socket && (socket_[p] == socket_[0]);
+          one_per_node = one_per_node && (node_[p] == ProcessID(p));
+        }
+        return one_socket || one_per_node;
+      }
+
+      /// Detect the topology of \c world
+
+      /// \param world The world to be examined
+      /// \note This is a collective operation.
+      void detect(World& world) {
+        const std::size_t nprocs = world.size();
+        const ProcessID rank = world.rank();
+        std::vector<ProcessID> ids(2ul * nprocs, 0);
+
+#if MPI_VERSION >= 3
+        {
+#ifdef SAFE_MPI_GLOBAL_MUTEX
+          SAFE_MPI_GLOBAL_MUTEX;
+#endif // SAFE_MPI_GLOBAL_MUTEX
+          MPI_Comm comm = world.mpi.comm().Get_mpi_comm();
+
+          // Find the first process on this node
+          MPI_Comm node_comm;
+          MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+          ProcessID node = rank;
+          MPI_Allreduce(& rank, & node, 1, MPI_INT, MPI_MIN, node_comm);
+          ids[rank] = node;
+
+          // Find the first process on this socket
+          ProcessID socket = node;
+#ifdef OMPI_COMM_TYPE_SOCKET
+          MPI_Comm socket_comm;
+          MPI_Comm_split_type(node_comm, OMPI_COMM_TYPE_SOCKET, rank, MPI_INFO_NULL, &socket_comm);
+          MPI_Allreduce(& rank, & socket, 1, MPI_INT, MPI_MIN, socket_comm);
+          MPI_Comm_free(& socket_comm);
+#endif // OMPI_COMM_TYPE_SOCKET
+          ids[nprocs + rank] = socket;
+
+          MPI_Comm_free(& node_comm);
+        }
+#else
+        // Each process is treated as a separate node
+        ids[rank] = rank;
+        ids[nprocs + rank] = rank;
+#endif // MPI_VERSION >= 3
+
+        // Gather the placement of all processes
+        world.gop.sum(ids.data(), ids.size());
+
+        node_.assign(ids.begin(), ids.begin() + nprocs);
+        socket_.assign(ids.begin() + nprocs, ids.end());
+      }
+
+    public:
+
+      /// Construct a trivial topology
+      ProcTopology() : node_(), socket_(), trivial_(true) { }
+
+      /// Construct a topology from process placement
+
+      /// \param node The first process of the node of each process
+      /// \param socket The first process of the socket of each process
+      ProcTopology(const std::vector<ProcessID>& node,
+          const std::vector<ProcessID>& socket) :
+        node_(node), socket_(socket), trivial_(true)
+      {
+        TA_ASSERT(node_.size() == socket_.size());
+        trivial_ = is_trivial();
+      }
+
+      /// Construct the topology of \c world
+
+      /// \param world The world to be examined
+      /// \note This is a collective operation.
+      explicit ProcTopology(World& world) :
+        node_(), socket_(), trivial_(true)
+      {
+        detect(world);
+        trivial_ = is_trivial();
+      }
+
+      /// Topology accessor
+
+      /// The topology of each world is detected once, the first time this
+      /// function is called for that world.
+      /// \param world The world to be examined
+      /// \return The topology of \c world
+      /// \note The first call for a given world is a collective operation.
+      static std::shared_ptr<const ProcTopology> get(World& world) {
+        static madness::Mutex lock;
+        static std::map<unsigned long, std::shared_ptr<const ProcTopology> > cache;
+
+        madness::ScopedMutex<madness::Mutex> locker(&lock);
+        std::shared_ptr<const ProcTopology>& result = cache[world.id()];
+        if(! result)
+          result = std::make_shared<const ProcTopology>(world);
+        return result;
+      }
+
+      /// Trivial topology query
+
+      /// \return \c true if all messages have the same cost
+      bool trivial() const { return trivial_; }
+
+      /// Process count accessor
+
+      /// \return The number of processes in the topology
+      size_type size() const { return node_.size(); }
+
+      /// Node accessor
+
+      /// \param p The process
+      /// \return The first process on the node of \c p
+      ProcessID node(const ProcessID p) const { return node_[p]; }
+
+      /// Socket accessor
+
+      /// \param p The process
+      /// \return The first process on the socket of \c p
+      ProcessID socket(const ProcessID p) const { return socket_[p]; }
+
+      /// Relative cost of a broadcast
+
+      /// \tparam Op The process generator type
+      /// \param size The number of processes in the broadcast group
+      /// \param op The process generator, where <tt>op(i)</tt> is the
+      /// <tt>i</tt>-th process of the group
+      /// \return The relative cost of a broadcast among the group
+      template <typename Op>
+      double broadcast_cost(const size_type size, const Op& op) const {
+        if(size == 0ul)
+          return 0.0;
+        if(trivial_)
+          return node_cost * double(size - 1ul);
+
+        std::vector<ProcessID> nodes, sockets;
+        nodes.reserve(size);
+        sockets.reserve(size);
+        for(size_type i = 0ul; i < size; ++i) {
+          const ProcessID p = op(i);
+          nodes.push_back(node_[p]);
+          sockets.push_back(socket_[p]);
+        }
+        std::sort(nodes.begin(), nodes.end());
+        std::sort(sockets.begin(), sockets.end());
+        const double n_node = std::unique(nodes.begin(), nodes.end()) - nodes.begin();
+        const double n_socket = std::unique(sockets.begin(), sockets.end()) - sockets.begin();
+
+        return node_cost * (n_node - 1.0) + socket_cost * (n_socket - n_node)
+            + core_cost * (double(size) - n_socket);
+      }
+
+    }; // class ProcTopology
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_PROC_TOPOLOGY_H__INCLUDED
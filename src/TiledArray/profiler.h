@@ -0,0 +1,309 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  profiler.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_PROFILER_H__INCLUDED
+#define TILEDARRAY_PROFILER_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Tile task profiler
+
+  /// The profiler records the begin and end time of tile tasks, e.g. SUMMA
+  /// steps, broadcasts, tile contractions, and element-wise tile operations,
+  /// together with the thread that ran the task and the number of bytes it
+  /// moved. The events can be written in the Chrome trace event format, which
+  /// can be viewed with \c chrome://tracing or Perfetto. Profiling is
+  /// disabled by default; it is enabled with \c enable() or by setting the
+  /// \c TA_PROFILE environment variable.
+  /// \note There is one profiler per process. Events are stored per thread, so
+  /// recording events does not require global synchronization.
+  class TaskProfiler {
+  public:
+    typedef std::chrono::steady_clock clock_type; ///< Clock type
+    typedef clock_type::time_point time_point; ///< Time point type
+
+    /// The value of an event index that is not set
+    static constexpr std::size_t no_index = std::numeric_limits<std::size_t>::max();
+
+    /// Profile event data
+    struct Event {
+      const char* name; ///< The event name
+      const char* category; ///< The event category
+      time_point begin; ///< The event start time
+      time_point end; ///< The event finish time
+      std::size_t index; ///< The tile or step index of the event
+      std::size_t bytes; ///< The number of bytes moved by the event
+    }; // struct Event
+
+  private:
+
+    /// The events of a thread
+    struct ThreadEvents {
+      madness::Spinlock lock; ///< Lock for events
+      std::vector<Event> events; ///< The recorded events
+      const unsigned int thread; ///< The thread index
+
+      ThreadEvents(const unsigned int t) : lock(), events(), thread(t) { }
+    }; // struct ThreadEvents
+
+    std::atomic<bool> enabled_; ///< Profiling flag
+    const time_point start_; ///< The time origin of the trace
+    mutable madness::Spinlock lock_; ///< Lock for the thread list
+    std::vector<std::unique_ptr<ThreadEvents> > threads_; ///< Events of all threads
+
+    TaskProfiler() :
+      enabled_(getenv("TA_PROFILE") != nullptr), start_(clock_type::now()),
+      lock_(), threads_()
+    { }
+
+    TaskProfiler(const TaskProfiler&) = delete;
+    TaskProfiler& operator=(const TaskProfiler&) = delete;
+
+    /// Event list accessor
+
+    /// \return The event list of the calling thread
+    ThreadEvents& thread_events() {
+      static thread_local ThreadEvents* events = nullptr;
+      if(! events) {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        threads_.emplace_back(new ThreadEvents(threads_.size()));
+        events = threads_.back().get();
+      }
+      return *events;
+    }
+
+    /// Convert a time point into trace time
+
+    /// \param t The time point
+    /// \return The number of microseconds from the start of the trace to \c t
+    double trace_time(const time_point& t) const {
+      return std::chrono::duration<double, std::micro>(t - start_).count();
+    }
+
+  public:
+
+    /// Profiler accessor
+
+    /// \return A reference to the task profiler of this process
+    static TaskProfiler& instance() {
+      static TaskProfiler* const profiler = new TaskProfiler();
+      return *profiler;
+    }
+
+    /// Current time
+
+    /// \return The current time point
+    static time_point now() { return clock_type::now(); }
+
+    /// Enable profiling
+    void enable() { enabled_.store(true, std::memory_order_relaxed); }
+
+    /// Disable profiling
+
+    /// Recorded events are kept.
+    void disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+    /// Profiling status
+
+    /// \return \c true if events are recorded
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Record an event
+
+    /// \param name The event name, which must be a string literal
+    /// \param category The event category, which must be a string literal
+    /// \param begin The event start time
+    /// \param end The event finish time
+    /// \param index The tile or step index of the event
+    /// \param bytes The number of bytes moved by the event
+    void record(const char* const name, const char* const category,
+        const time_point& begin, const time_point& end,
+        const std::size_t index = no_index, const std::size_t bytes = 0ul)
+    {
+      ThreadEvents& events = thread_events();
+      madness::ScopedMutex<madness::Spinlock> locker(&events.lock);
+      events.events.push_back(Event{ name, category, begin, end, index, bytes });
+    }
+
+    /// Number of recorded events
+
+    /// \return The number of events recorded by all threads
+    std::size_t size() const {
+      madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+      std::size_t result = 0ul;
+      for(const std::unique_ptr<ThreadEvents>& events : threads_) {
+        madness::ScopedMutex<madness::Spinlock> events_locker(&events->lock);
+        result += events->events.size();
+      }
+      return result;
+    }
+
+    /// Discard all recorded events
+    void clear() {
+      madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+      for(std::unique_ptr<ThreadEvents>& events : threads_) {
+        madness::ScopedMutex<madness::Spinlock> events_locker(&events->lock);
+        events->events.clear();
+      }
+    }
+
+    /// Write the events in the Chrome trace event format
+
+    /// Each event is written as a complete ("X") event, where the process id
+    /// is \c rank and the thread id is the index of the thread that recorded
+    /// the event. Times are given in microseconds.
+    /// \param os The output stream
+    /// \param rank The rank of this process
+    void write(std::ostream& os, const int rank) const {
+      madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+      os << "{\"traceEvents\":[";
+      bool first = true;
+      for(const std::unique_ptr<ThreadEvents>& events : threads_) {
+        madness::ScopedMutex<madness::Spinlock> events_locker(&events->lock);
+        for(const Event& event : events->events) {
+          if(! first)
+            os << ",";
+          first = false;
+          os << "\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+             << "\",\"ph\":\"X\",\"ts\":" << trace_time(event.begin)
+             << ",\"dur\":" << trace_time(event.end) - trace_time(event.begin)
+             << ",\"pid\":" << rank << ",\"tid\":" << events->thread
+             << ",\"args\":{\"bytes\":" << event.bytes;
+          if(event.index != no_index)
+            os << ",\"index\":" << event.index;
+          os << "}}";
+        }
+      }
+      os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    /// Write the events of this process to a Chrome trace file
+
+    /// The events are written to <tt>prefix.rank.json</tt>, where \c rank is
+    /// the rank of this process in \c world .
+    /// \param world The world of this process
+    /// \param prefix The file name prefix
+    /// \throw TiledArray::Exception When the file cannot be opened
+    void write(World& world, const std::string& prefix) const {
+      std::stringstream ss;
+      ss << prefix << "." << world.rank() << ".json";
+      std::ofstream file(ss.str().c_str());
+      TA_USER_ASSERT(file.good(), "TaskProfiler::write(): Unable to open trace file.");
+      write(file, world.rank());
+    }
+
+  }; // class TaskProfiler
+
+  namespace detail {
+
+    /// Size of the tile data in bytes for tiles with a range
+
+    /// \tparam T The tile type
+    /// \param tile The tile
+    /// \return The number of bytes held by \c tile
+    template <typename T>
+    inline auto tile_bytes(const T& tile, int) ->
+        decltype(tile.empty(), tile.range().volume() * sizeof(typename T::value_type))
+    { return (tile.empty() ? 0ul : tile.range().volume() * sizeof(typename T::value_type)); }
+
+    /// Size of the tile data in bytes for other tiles
+
+    /// \return Zero
+    template <typename T>
+    inline std::size_t tile_bytes(const T&, long) { return 0ul; }
+
+    /// Size of the tile data in bytes
+
+    /// \tparam T The tile type
+    /// \param tile The tile
+    /// \return The number of bytes held by \c tile , or zero if it is not known
+    template <typename T>
+    inline std::size_t tile_bytes(const T& tile) { return tile_bytes(tile, 0); }
+
+    /// Profile the lifetime of a scope
+
+    /// The profile event begins when the object is constructed and ends when
+    /// it is destroyed. Nothing is recorded when profiling is disabled at
+    /// construction.
+    class ProfileScope {
+      const char* const name_; ///< The event name
+      const char* const category_; ///< The event category
+      const std::size_t index_; ///< The tile or step index
+      std::size_t bytes_; ///< The number of bytes moved
+      const bool enabled_; ///< Profiling flag
+      TaskProfiler::time_point begin_; ///< Event start time
+
+    public:
+      /// Constructor
+
+      /// \param name The event name, which must be a string literal
+      /// \param category The event category, which must be a string literal
+      /// \param index The tile or step index of the event
+      /// \param bytes The number of bytes moved by the event
+      ProfileScope(const char* const name, const char* const category,
+          const std::size_t index = TaskProfiler::no_index,
+          const std::size_t bytes = 0ul) :
+        name_(name), category_(category), index_(index), bytes_(bytes),
+        enabled_(TaskProfiler::instance().enabled()),
+        begin_(enabled_ ? TaskProfiler::now() : TaskProfiler::time_point())
+      { }
+
+      ProfileScope(const ProfileScope&) = delete;
+      ProfileScope& operator=(const ProfileScope&) = delete;
+
+      ~ProfileScope() {
+        if(enabled_)
+          TaskProfiler::instance().record(name_, category_, begin_,
+              TaskProfiler::now(), index_, bytes_);
+      }
+
+      /// Profiling status
+
+      /// \return \c true if this event will be recorded
+      bool enabled() const { return enabled_; }
+
+      /// Add to the number of bytes moved
+
+      /// \param bytes The number of bytes
+      void add_bytes(const std::size_t bytes) { bytes_ += bytes; }
+
+    }; // class ProfileScope
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_PROFILER_H__INCLUDED
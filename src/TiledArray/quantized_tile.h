@@ -0,0 +1,311 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  quantized_tile.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_QUANTIZED_TILE_H__INCLUDED
+#define TILEDARRAY_QUANTIZED_TILE_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/conversions/to_new_tile_type.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Tile that is stored with quantized elements
+
+  /// A quantized tile stores the elements of a real tile as integer codes,
+  /// \c c , and a per-tile scale, \c s , where each element is \c c*s . The
+  /// codes are 8-bit integers when the elements are within the tolerance of
+  /// the codes, 16-bit integers when the 8-bit codes are not accurate
+  /// enough, and otherwise the tile is stored unmodified. The tolerance is
+  /// an absolute bound of the error of each element, and it is usually the
+  /// zero threshold of \c SparseShape , since elements of that size are
+  /// already dropped by screening. Tiles of large read-only arrays with a
+  /// limited range of values within each tile, e.g. integrals, are then
+  /// stored in 1/8 or 1/4 of the memory of double precision tiles.
+  ///
+  /// A quantized tile is a lazy tile (see \c eval_trait ) that is converted
+  /// to a \c Tensor when it is used in an expression, so the elements are
+  /// decoded right before each contraction and the decoded tile is released
+  /// when the expression is done with it:
+  /// \code
+  /// auto v = TiledArray::quantize(integrals);
+  /// r("a,b,i,j") = v("a,b,c,d") * t("c,d,i,j");
+  /// \endcode
+  /// The copy semantics are those of \c Tensor : copies share the codes.
+  /// \tparam T The element type of the decoded tile
+  template <typename T>
+  class QuantizedTile {
+    static_assert(std::is_floating_point<T>::value,
+        "QuantizedTile only supports real floating point elements.");
+  public:
+    typedef QuantizedTile<T> QuantizedTile_; ///< This object type
+    typedef Tensor<T> eval_type; ///< The decoded tile type
+    typedef T value_type; ///< The element type
+    typedef T numeric_type; ///< The numeric type
+    typedef T scalar_type; ///< The scalar type
+    typedef Range range_type; ///< The range type
+    typedef range_type::size_type size_type; ///< Size type
+
+    /// Storage format of the elements
+    typedef enum {
+      raw = 0, ///< Unmodified elements
+      int8 = 1, ///< 8-bit codes
+      int16 = 2 ///< 16-bit codes
+    } format_type;
+
+  private:
+    range_type range_; ///< The tile range
+    format_type format_; ///< The storage format
+    scalar_type scale_; ///< The value of a unit code
+    std::shared_ptr<std::vector<std::int8_t> > codes8_; ///< The 8-bit codes
+    std::shared_ptr<std::vector<std::int16_t> > codes16_; ///< The 16-bit codes
+    Tensor<T> raw_; ///< The elements of a tile in \c raw format
+
+    /// Encode elements
+
+    /// \tparam Code The code type
+    /// \param tensor The elements
+    /// \param scale The value of a unit code
+    /// \return The codes of the elements of \c tensor
+    template <typename Code>
+    static std::shared_ptr<std::vector<Code> >
+    encode(const Tensor<T>& tensor, const scalar_type scale) {
+      std::shared_ptr<std::vector<Code> > codes =
+          std::make_shared<std::vector<Code> >(tensor.size(), Code(0));
+      if(scale > scalar_type(0)) {
+        const scalar_type inv_scale = scalar_type(1) / scale;
+        for(size_type i = 0ul; i < tensor.size(); ++i)
+          (*codes)[i] = static_cast<Code>(std::lround(tensor[i] * inv_scale));
+      }
+      return codes;
+    }
+
+    /// Decode elements
+
+    /// \tparam Code The code type
+    /// \param codes The codes of the elements
+    /// \return The decoded tile
+    template <typename Code>
+    Tensor<T> decode(const std::vector<Code>& codes) const {
+      Tensor<T> result(range_);
+      for(size_type i = 0ul; i < codes.size(); ++i)
+        result[i] = scale_ * scalar_type(codes[i]);
+      return result;
+    }
+
+    /// Code limit
+
+    /// \tparam Code The code type
+    /// \return The largest code magnitude
+    template <typename Code>
+    static scalar_type code_max() {
+      return scalar_type(std::numeric_limits<Code>::max());
+    }
+
+  public:
+
+    /// Construct an empty tile
+    QuantizedTile() :
+      range_(), format_(raw), scale_(0), codes8_(), codes16_(), raw_()
+    { }
+
+    QuantizedTile(const QuantizedTile_&) = default;
+    QuantizedTile(QuantizedTile_&&) = default;
+    QuantizedTile_& operator=(const QuantizedTile_&) = default;
+    QuantizedTile_& operator=(QuantizedTile_&&) = default;
+
+    /// Quantize a tile
+
+    /// The most compact format whose error is within \c tolerance is used.
+    /// \param tensor The tile to be quantized
+    /// \param tolerance The largest absolute error of an element; the
+    /// default is the zero threshold of \c SparseShape
+    explicit QuantizedTile(const Tensor<T>& tensor,
+        const scalar_type tolerance = SparseShape<float>::threshold()) :
+      range_(tensor.range()), format_(raw), scale_(0), codes8_(), codes16_(),
+      raw_()
+    {
+      TA_USER_ASSERT(tolerance >= scalar_type(0),
+          "QuantizedTile: The tolerance must be non-negative.");
+      TA_ASSERT(! tensor.empty());
+
+      // The rounding error of a code is half of the scale
+      const scalar_type abs_max = tensor.abs_max();
+      if(abs_max <= code_max<std::int8_t>() * scalar_type(2) * tolerance) {
+        format_ = int8;
+        scale_ = abs_max / code_max<std::int8_t>();
+        codes8_ = encode<std::int8_t>(tensor, scale_);
+      } else if(abs_max <= code_max<std::int16_t>() * scalar_type(2) * tolerance) {
+        format_ = int16;
+        scale_ = abs_max / code_max<std::int16_t>();
+        codes16_ = encode<std::int16_t>(tensor, scale_);
+      } else {
+        raw_ = tensor;
+      }
+    }
+
+    /// Tile range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// Check for an empty tile
+
+    /// \return \c true if this tile has no data
+    bool empty() const { return range_.rank() == 0u; }
+
+    /// Storage format accessor
+
+    /// \return The storage format of the elements
+    format_type format() const { return format_; }
+
+    /// Scale accessor
+
+    /// \return The value of a unit code, or zero in \c raw format
+    scalar_type scale() const { return scale_; }
+
+    /// Error bound accessor
+
+    /// \return The largest absolute error of a decoded element
+    scalar_type max_error() const { return scale_ / scalar_type(2); }
+
+    /// Storage size
+
+    /// \return The number of bytes of the stored elements
+    size_type bytes() const {
+      switch(format_) {
+        case int8: return codes8_->size() * sizeof(std::int8_t);
+        case int16: return codes16_->size() * sizeof(std::int16_t);
+        default: return raw_.size() * sizeof(T);
+      }
+    }
+
+    /// Decode the tile
+
+    /// \return The decoded elements
+    eval_type eval() const {
+      TA_ASSERT(! empty());
+      switch(format_) {
+        case int8: return decode(*codes8_);
+        case int16: return decode(*codes16_);
+        default: return raw_;
+      }
+    }
+
+    /// Convert tile to evaluation type
+    operator eval_type() const { return eval(); }
+
+    /// Output serialization function
+
+    /// \tparam Archive The output archive type
+    /// \param ar The output archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      const int format = format_;
+      ar & range_ & format & scale_;
+      switch(format_) {
+        case int8: ar & *codes8_; break;
+        case int16: ar & *codes16_; break;
+        default: ar & raw_;
+      }
+    }
+
+    /// Input serialization function
+
+    /// \tparam Archive The input archive type
+    /// \param ar The input archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      int format = raw;
+      ar & range_ & format & scale_;
+      format_ = static_cast<format_type>(format);
+      codes8_.reset();
+      codes16_.reset();
+      raw_ = Tensor<T>();
+      switch(format_) {
+        case int8:
+          codes8_ = std::make_shared<std::vector<std::int8_t> >();
+          ar & *codes8_;
+          break;
+        case int16:
+          codes16_ = std::make_shared<std::vector<std::int16_t> >();
+          ar & *codes16_;
+          break;
+        default:
+          ar & raw_;
+      }
+    }
+
+  }; // class QuantizedTile
+
+  /// Quantized tile output operator
+
+  /// The tile is printed decoded.
+  /// \tparam T The element type
+  /// \param os The output stream
+  /// \param tile The tile to be output
+  /// \return A reference to the output stream
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const QuantizedTile<T>& tile) {
+    if(tile.empty())
+      os << "[ ]";
+    else
+      os << tile.eval();
+    return os;
+  }
+
+  /// Quantize the tiles of an array
+
+  /// Each tile of \c array is stored as a \c QuantizedTile , and the result
+  /// has the shape and the process map of \c array . The result is intended
+  /// for large read-only arrays, e.g. integrals, that are used as arguments
+  /// of expressions.
+  /// \tparam T The element type
+  /// \tparam Policy The array policy type
+  /// \param array The array to be quantized
+  /// \param tolerance The largest absolute error of an element; the default
+  /// is the zero threshold of \c SparseShape
+  /// \return An array with the quantized tiles of \c array
+  template <typename T, typename Policy>
+  inline DistArray<QuantizedTile<T>, Policy>
+  quantize(const DistArray<Tensor<T>, Policy>& array,
+      const T tolerance = SparseShape<float>::threshold())
+  {
+    return to_new_tile_type(array, [tolerance] (const Tensor<T>& tile) {
+      return QuantizedTile<T>(tile, tolerance);
+    });
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_QUANTIZED_TILE_H__INCLUDED
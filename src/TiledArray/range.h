@@ -24,6 +24,11 @@
 #include <TiledArray/permutation.h>
 #include <TiledArray/size_array.h>
 
+/* The largest rank for which the range data is stored inline. */
+#ifndef TILEDARRAY_RANGE_SMALL_RANK
+#define TILEDARRAY_RANGE_SMALL_RANK 6
+#endif // TILEDARRAY_RANGE_SMALL_RANK
+
 namespace TiledArray {
 
   /// \brief A (hyperrectangular) interval on \f$ Z^n \f$, space of integer n-indices
@@ -62,6 +67,67 @@ namespace TiledArray {
     size_type offset_ = 0ul; ///< Ordinal index offset correction
     size_type volume_ = 0ul; ///< Total number of elements
     unsigned int rank_ = 0u; ///< The rank (or number of dimensions) in the range
+    size_type small_data_[TILEDARRAY_RANGE_SMALL_RANK << 2];
+                      ///< Inline storage for \c data_ when
+                      ///< <tt>rank_ <= TILEDARRAY_RANGE_SMALL_RANK</tt>
+
+    /// Allocate range data
+
+    /// Ranges with rank up to \c TILEDARRAY_RANGE_SMALL_RANK use the inline
+    /// buffer, so constructing, copying, and destroying low-rank ranges does
+    /// not touch the heap.
+    /// \pre \c data_ does not hold any memory
+    /// \param n The rank of the range
+    /// \post \c data_ holds <tt>4*n</tt> elements and \c rank_ is \c n
+    /// \throw std::bad_alloc When memory allocation fails.
+    void alloc_data(const unsigned int n) {
+      data_ = (n == 0u ? nullptr :
+          (n <= TILEDARRAY_RANGE_SMALL_RANK ? small_data_ : new size_type[n << 2]));
+      rank_ = n;
+    }
+
+    /// Release range data
+
+    /// \post \c data_ is \c nullptr and \c rank_ is zero
+    void free_data() {
+      if(data_ != small_data_)
+        delete [] data_;
+      data_ = nullptr;
+      rank_ = 0u;
+    }
+
+    /// Reallocate range data for a new rank
+
+    /// The data is reused when the rank does not change.
+    /// \param n The rank of the range
+    void realloc_data(const unsigned int n) {
+      if(rank_ != n) {
+        free_data();
+        alloc_data(n);
+      }
+    }
+
+    /// Take the data of another range
+
+    /// \pre \c data_ does not hold any memory
+    /// \param other The range whose data is taken
+    /// \post \c other is empty
+    void move_data(Range_& other) {
+      if(other.data_ == other.small_data_) {
+        alloc_data(other.rank_);
+        memcpy(small_data_, other.small_data_, (sizeof(size_type) << 2) * other.rank_);
+      } else {
+        data_ = other.data_;
+        rank_ = other.rank_;
+      }
+      offset_ = other.offset_;
+      volume_ = other.volume_;
+
+      other.data_ = nullptr;
+      other.offset_ = 0ul;
+      other.volume_ = 0ul;
+      other.rank_ = 0u;
+    }
 
   private:
 
@@ -261,8 +327,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(lower_bound, upper_bound);
       }
     }
@@ -285,8 +350,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(lower_bound, upper_bound);
       }
     }
@@ -305,8 +369,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(extent);
       }
     }
@@ -323,8 +386,7 @@ namespace TiledArray {
       const size_type n = detail::size(extent);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(extent);
       }
     }
@@ -345,8 +407,7 @@ namespace TiledArray {
       const size_type n = detail::size(bounds);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(bounds);
       }
     }
@@ -365,8 +426,7 @@ namespace TiledArray {
       const size_type n = detail::size(bounds);
       if(n) {
         // Initialize array memory
-        data_ = new size_type[n << 2];
-        rank_ = n;
+        alloc_data(n);
         init_range_data(bounds);
       }
     }
@@ -389,10 +449,9 @@ namespace TiledArray {
     /// \throw std::bad_alloc When memory allocation fails.
     Range(const Range_& other) {
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
+        alloc_data(other.rank_);
         offset_ = other.offset_;
         volume_ = other.volume_;
-        rank_ = other.rank_;
         memcpy(data_, other.data_, (sizeof(size_type) << 2) * other.rank_);
       }
     }
@@ -401,15 +460,7 @@ namespace TiledArray {
 
     /// \param other The range to be copied
     /// \throw std::bad_alloc When memory allocation fails.
-    Range(Range_&& other) :
-      data_(other.data_), offset_(other.offset_), volume_(other.volume_),
-      rank_(other.rank_)
-    {
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
-    }
+    Range(Range_&& other) { move_data(other); }
 
     /// Permuting copy constructor
 
@@ -420,8 +471,7 @@ namespace TiledArray {
       TA_ASSERT(perm.dim() == other.rank_);
 
       if(other.rank_ > 0ul) {
-        data_ = new size_type[other.rank_ << 2];
-        rank_ = other.rank_;
+        alloc_data(other.rank_);
 
         if(perm) {
           init_range_data(perm, other.data_, other.data_ + rank_);
@@ -435,7 +485,7 @@ namespace TiledArray {
     }
 
     /// Destructor
-    ~Range() { delete [] data_; }
+    ~Range() { free_data(); }
 
     /// Copy assignment operator
 
@@ -443,11 +493,7 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw std::bad_alloc When memory allocation fails.
     Range_& operator=(const Range_& other) {
-      if(rank_ != other.rank_) {
-        delete [] data_;
-        data_ = (other.rank_ > 0ul ? new size_type[other.rank_ << 2] : nullptr);
-        rank_ = other.rank_;
-      }
+      realloc_data(other.rank_);
       memcpy(data_, other.data_, (sizeof(size_type) << 2) * rank_);
       offset_ = other.offset_;
       volume_ = other.volume_;
@@ -461,15 +507,10 @@ namespace TiledArray {
     /// \return A reference to this object
     /// \throw nothing
     Range_& operator=(Range_&& other) {
-      data_ = other.data_;
-      offset_ = other.offset_;
-      volume_ = other.volume_;
-      rank_ = other.rank_;
-
-      other.data_ = nullptr;
-      other.offset_ = 0ul;
-      other.volume_ = 0ul;
-      other.rank_ = 0u;
+      if(this != &other) {
+        free_data();
+        move_data(other);
+      }
 
       return *this;
     }
@@ -695,11 +736,7 @@ namespace TiledArray {
       TA_ASSERT(n == detail::size(upper_bound));
 
       // Reallocate memory for range arrays
-      if(rank_ != n) {
-        delete [] data_;
-        data_ = (n > 0ul ? new size_type[n << 2] : nullptr);
-        rank_ = n;
-      }
+      realloc_data(n);
       if(n > 0ul)
         init_range_data(lower_bound, upper_bound);
       else
@@ -864,11 +901,7 @@ namespace TiledArray {
 
       // Reallocate the array
       const unsigned int four_x_rank = rank << 2;
-      if(rank_ != rank) {
-        delete [] data_;
-        data_ = (rank > 0u ? new size_type[four_x_rank] : nullptr);
-        rank_ = rank;
-      }
+      realloc_data(rank);
 
       // Get range data
       ar & madness::archive::wrap(data_, four_x_rank) & offset_ & volume_;
@@ -881,11 +914,10 @@ namespace TiledArray {
     }
 
     void swap(Range_& other) {
-      // Get temp data
-      std::swap(data_, other.data_);
-      std::swap(offset_, other.offset_);
-      std::swap(volume_, other.volume_);
-      std::swap(rank_, other.rank_);
+      // Inline data cannot be exchanged by pointer, so swap by moving
+      Range_ temp(std::move(other));
+      other.move_data(*this);
+      move_data(temp);
     }
 
   private:
@@ -972,14 +1004,17 @@ namespace TiledArray {
     TA_ASSERT(perm.dim() == rank_);
     if(rank_ > 1ul) {
       // Copy the lower and upper bound data into a temporary array
-      size_type* MADNESS_RESTRICT const temp_lower = new size_type[rank_ << 1];
+      size_type small_temp[TILEDARRAY_RANGE_SMALL_RANK << 1];
+      size_type* MADNESS_RESTRICT const temp_lower =
+          (rank_ <= TILEDARRAY_RANGE_SMALL_RANK ? small_temp : new size_type[rank_ << 1]);
       const size_type* MADNESS_RESTRICT const temp_upper = temp_lower + rank_;
       std::memcpy(temp_lower, data_, (sizeof(size_type) << 1) * rank_);
 
       init_range_data(perm, temp_lower, temp_upper);
 
       // Cleanup old memory.
-      delete[] temp_lower;
+      if(temp_lower != small_temp)
+        delete[] temp_lower;
     }
     return *this;
   }
@@ -22,6 +22,9 @@
 
 #include <TiledArray/error.h>
 #include <TiledArray/madness.h>
+#include <TiledArray/memory_tracker.h>
+#include <TiledArray/profiler.h>
+#include <TiledArray/tile_cost.h>
 
 namespace TiledArray {
   namespace detail {
@@ -41,6 +44,22 @@ namespace TiledArray {
       typedef std::pair<Future<T>, Future<U> > type;
     }; // struct ArgumentHelper
 
+    /// Return a result that is no longer used to a reduction operation
+
+    /// Reduction operations that provide <tt>recycle(result_type&)</tt> may
+    /// reuse the data of partial results that were added to other results.
+    /// \param op The reduction operation
+    /// \param result The partial result
+    template <typename Op, typename Result>
+    inline auto recycle_result(const Op& op, Result& result, int) ->
+        decltype(op.recycle(result))
+    {
+      return op.recycle(result);
+    }
+
+    template <typename Op, typename Result>
+    inline void recycle_result(const Op&, Result&, long) { }
+
     /// Wrapper that to convert a pair-wise reduction into a standard reduction
 
     /// \tparam opT The pair-wise reduction operation to be reduced
@@ -61,21 +80,38 @@ namespace TiledArray {
 
     private:
       opT op_; ///< The pairwise reduction operation
+      TileCostRecorder* cost_recorder_; ///< Recorder of the time of the pair
+                                        ///< reductions (may be null)
+      std::size_t cost_tile_; ///< The tile whose cost is recorded
 
     public:
       /// Default constructor
-      ReducePairOpWrapper() : op_() { }
+      ReducePairOpWrapper() : op_(), cost_recorder_(nullptr), cost_tile_(0ul) { }
 
       /// Constructor
 
       /// \param op The base operation
-      ReducePairOpWrapper(const opT& op) : op_(op) { }
+      ReducePairOpWrapper(const opT& op) :
+        op_(op), cost_recorder_(nullptr), cost_tile_(0ul)
+      { }
+
+      /// Constructor
+
+      /// The time of the pair reductions is recorded as the cost of \c tile .
+      /// \param op The base operation
+      /// \param cost_recorder The recorder of the cost, which may be null
+      /// \param tile The ordinal index of the tile whose cost is recorded
+      ReducePairOpWrapper(const opT& op, TileCostRecorder* const cost_recorder,
+          const std::size_t tile) :
+        op_(op), cost_recorder_(cost_recorder), cost_tile_(tile)
+      { }
 
       /// Copy constructor
 
       /// \param other The other operation to be copied
       ReducePairOpWrapper(const ReducePairOpWrapper<opT>& other) :
-        op_(other.op_)
+        op_(other.op_), cost_recorder_(other.cost_recorder_),
+        cost_tile_(other.cost_tile_)
       { }
 
       /// Destructor
@@ -87,6 +123,8 @@ namespace TiledArray {
       /// \return This operation
       ReducePairOpWrapper<opT>& operator=(const ReducePairOpWrapper<opT>& other) {
         op_ = other.op_;
+        cost_recorder_ = other.cost_recorder_;
+        cost_tile_ = other.cost_tile_;
         return *this;
       }
 
@@ -108,9 +146,20 @@ namespace TiledArray {
       /// \param[out] result The object that will hold the result of this reduction
       /// \param[in] arg The argument pair to be reduced
       void operator()(result_type& result, const argument_type& arg) const {
+        detail::ProfileScope profile("contract_pair", "tile");
+        if(profile.enabled())
+          profile.add_bytes(detail::tile_bytes(arg.first) + detail::tile_bytes(arg.second));
+        detail::TileCostScope cost(cost_recorder_, cost_tile_);
         op_(result, arg.first, arg.second);
       }
 
+      /// Return a partial result that is no longer used
+
+      /// \param result The partial result
+      void recycle(result_type& result) const {
+        recycle_result(op_, result, 0);
+      }
+
     }; // class ReducePairOpWrapper
 
 
@@ -214,9 +263,11 @@ namespace TiledArray {
         private:
 
           ReduceTaskImpl* parent_; ///< The parent task
+          ReduceObject* next_; ///< The next object in the ready list
           typename ArgumentHelper<argument_type>::type arg_; ///< The reduction argument
           madness::CallbackInterface* callback_; ///< Reduction callback
           madness::AtomicInt count_; ///< Dependency counter
+          bool hipri_; ///< High priority flag of the reduction of this argument
 
           /// Register a future as a dependency
 
@@ -256,9 +307,12 @@ namespace TiledArray {
           /// \param parent The owner of this object
           /// \param arg The reduction argument
           /// \param callback The callback to invoke when this argument has been reduced
+          /// \param hipri The high priority flag of the reduction of this argument
           template <typename Arg>
-          ReduceObject(ReduceTaskImpl* parent, const Arg& arg, madness::CallbackInterface* callback) :
-          parent_(parent), arg_(arg), callback_(callback)
+          ReduceObject(ReduceTaskImpl* parent, const Arg& arg,
+              madness::CallbackInterface* callback, const bool hipri) :
+          parent_(parent), next_(nullptr), arg_(arg), callback_(callback),
+          hipri_(hipri)
           {
             MADNESS_ASSERT(parent_);
             register_callbacks(arg_);
@@ -274,6 +328,16 @@ namespace TiledArray {
           /// \return A const reference to the reduction argument
           const argument_type& arg() const { return arg_; }
 
+          /// Ready list link accessor
+
+          /// \return A reference to the next object in the ready list
+          ReduceObject*& next() { return next_; }
+
+          /// Priority accessor
+
+          /// \return \c true if this argument is reduced with high priority
+          bool hipri() const { return hipri_; }
+
           /// Destroy the \c object
 
           /// This function will invoke the callback and delete object.
@@ -293,36 +357,44 @@ namespace TiledArray {
         /// Check for ready reduce arguments and reduce them
 
         /// This function will check for and reduce data that is ready until
-        /// there is no more data to be reduced. Once there is no more data
-        /// that is ready to be reduced, result will be placed in the ready
-        /// state.
+        /// there is no more data to be reduced. All arguments that are ready
+        /// are taken from the ready list at once and reduced without spawning
+        /// tasks. Once there is no more data that is ready to be reduced,
+        /// result will be placed in the ready state.
         /// \param result The result object that will be used to reduce
         /// other data
         void reduce(std::shared_ptr<result_type>& result) {
           while(result) {
             lock_.lock(); // <<< Begin critical section
-            if(ready_object_) {
-              // Get the ready argument
-              ReduceObject* ready_object = const_cast<ReduceObject*>(ready_object_);
-              ready_object_ = nullptr;
+            if(ready_objects_) {
+              // Get the ready arguments
+              ReduceObject* ready_object = ready_objects_;
+              ready_objects_ = nullptr;
               lock_.unlock(); // <<< End critical section
 
-              // Reduce the argument that was held by ready_object_
-              op_(*result, ready_object->arg());
+              // Reduce the arguments that were held by ready_objects_
+              while(ready_object) {
+                ReduceObject* const next = ready_object->next();
+                op_(*result, ready_object->arg());
 
-              // cleanup the argument
-              ReduceObject::destroy(ready_object);
-              this->dec();
+                // cleanup the argument
+                ReduceObject::destroy(ready_object);
+                this->dec();
+                ready_object = next;
+              }
             } else if(ready_result_) {
               // Get the ready result
               std::shared_ptr<result_type> ready_result = ready_result_;
               ready_result_.reset();
+              --results_;
               lock_.unlock(); // <<< End critical section
 
               // Reduce the result that was held by ready_result_
               op_(*result, *ready_result);
 
-              // cleanup the result
+              // cleanup the result; the seed is not owned by this task
+              if(ready_result.get() != seed_result_)
+                recycle_result(op_, *ready_result, 0);
               ready_result.reset();
             } else {
               // Nothing is ready, so place result in the ready state.
@@ -338,6 +410,8 @@ namespace TiledArray {
         /// \param result The target of the reduction
         /// \param object The reduction argument to be reduced
         void reduce_result_object(std::shared_ptr<result_type> result, const ReduceObject* object) {
+          detail::MemoryScope memory_scope(MemoryCategory::reduce);
+
           // Reduce the argument
           op_(*result, object->arg());
 
@@ -354,6 +428,8 @@ namespace TiledArray {
 
         /// Reduce two reduction arguments
         void reduce_object_object(const ReduceObject* object1, const ReduceObject* object2) {
+          detail::MemoryScope memory_scope(MemoryCategory::reduce);
+
           // Construct an empty result object
           auto result = std::make_shared<result_type>(op_());
 
@@ -374,10 +450,53 @@ namespace TiledArray {
           this->dec();
         }
 
+        /// Reduce a partial result that was computed outside of this task
+
+        /// \param partial The partial result
+        /// \param callback The callback that is invoked when \c partial has
+        /// been taken by this task
+        void reduce_partial(const result_type& partial,
+            madness::CallbackInterface* const callback)
+        {
+          detail::MemoryScope memory_scope(MemoryCategory::reduce);
+          auto result = std::make_shared<result_type>(partial);
+          lock_.lock(); // <<< Begin critical section
+          ++results_;
+          lock_.unlock(); // <<< End critical section
+          if(callback)
+            callback->notify();
+
+          // Check for more reductions
+          reduce(result);
+
+          // Decrement the dependency counter for the partial result. This must
+          // be done after the reduce call to avoid a race condition.
+          this->dec();
+        }
+
+        /// Reduce the initial result
+
+        /// \param seed The initial result
+        void reduce_seed(const result_type& seed) {
+          detail::MemoryScope memory_scope(MemoryCategory::reduce);
+          auto result = std::make_shared<result_type>(seed);
+          seed_result_ = result.get();
+
+          // Check for more reductions
+          reduce(result);
+
+          // Decrement the dependency counter for the seed. This must be done
+          // after the reduce call to avoid a race condition.
+          this->dec();
+        }
+
         World& world_; ///< The world that owns this task
         opT op_; ///< The reduction operation
         std::shared_ptr<result_type> ready_result_; ///< Result object that is ready to be reduced
-        volatile ReduceObject* ready_object_; ///< Reduction argument that is ready to be reduced
+        ReduceObject* ready_objects_; ///< Reduction arguments that are ready to be reduced
+        const result_type* seed_result_; ///< The result that holds the seed, if any
+        std::size_t results_; ///< The number of result objects
+        const std::size_t max_results_; ///< The maximum number of result objects
         Future<result_type> result_; ///< The result of the reduction task
         madness::Spinlock lock_; ///< Task lock
         madness::CallbackInterface* callback_; ///< The completion callback
@@ -390,10 +509,15 @@ namespace TiledArray {
         /// \param op The reduction operation
         /// \param callback The callback that will be invoked when this task
         /// has completed
-        ReduceTaskImpl(World& world, opT op, madness::CallbackInterface* callback) :
+        /// \param max_results The maximum number of partial results that are
+        /// reduced concurrently, or 0 for one per thread
+        ReduceTaskImpl(World& world, opT op, madness::CallbackInterface* callback,
+            const std::size_t max_results) :
           madness::TaskInterface(1, TaskAttributes::hipri()),
           world_(world), op_(op), ready_result_(std::make_shared<result_type>(op())),
-          ready_object_(nullptr), result_(), lock_(), callback_(callback)
+          ready_objects_(nullptr), seed_result_(nullptr), results_(1ul),
+          max_results_(max_results ? max_results : madness::ThreadPool::size() + 1ul),
+          result_(), lock_(), callback_(callback)
         { }
 
         virtual ~ReduceTaskImpl() { }
@@ -401,16 +525,32 @@ namespace TiledArray {
         /// Task function
         virtual void run(const madness::TaskThreadEnv&) {
           MADNESS_ASSERT(ready_result_);
-          result_.set(op_(*ready_result_));
+          {
+            detail::MemoryScope memory_scope(MemoryCategory::reduce);
+            result_.set(op_(*ready_result_));
+          }
           if(callback_)
             callback_->notify();
         }
 
+        /// Reduction task attributes
+
+        /// \param hipri The high priority flag
+        /// \return The attributes of a reduction task
+        static TaskAttributes attributes(const bool hipri) {
+          return (hipri ? TaskAttributes::hipri() : TaskAttributes());
+        }
+
         /// Callback function invoked by \c ReductionObject
 
-        /// This function will place \c object in the ready state. If
-        /// another object is already in the ready state, then both objects
-        /// are used to spawn a task
+        /// This function will reduce \c object with a result object that is
+        /// in the ready state, if any. Otherwise, if another object is in the
+        /// ready state and fewer than the maximum number of partial results
+        /// exist, both objects are used to spawn a task that starts a new
+        /// partial result. Otherwise \c object is added to the ready list,
+        /// which is drained by the task that holds a partial result, so
+        /// arguments that arrive faster than they are reduced do not spawn
+        /// additional tasks.
         /// \param object The reduction object that is ready to be reduced
         void ready(ReduceObject* object) {
           MADNESS_ASSERT(object);
@@ -421,20 +561,55 @@ namespace TiledArray {
             lock_.unlock(); // <<< End critical section
             MADNESS_ASSERT(ready_result);
             world_.taskq.add(this, & ReduceTaskImpl::reduce_result_object,
-                ready_result, object, TaskAttributes::hipri());
-          } else if(ready_object_) {
-            ReduceObject* ready_object = const_cast<ReduceObject*>(ready_object_);
-            ready_object_ = nullptr;
+                ready_result, object, attributes(object->hipri()));
+          } else if(ready_objects_ && (results_ < max_results_)) {
+            ReduceObject* ready_object = ready_objects_;
+            ready_objects_ = ready_object->next();
+            ++results_;
             lock_.unlock(); // <<< End critical section
-            MADNESS_ASSERT(ready_object);
             world_.taskq.add(this, & ReduceTaskImpl::reduce_object_object,
-                object, ready_object, TaskAttributes::hipri());
+                object, ready_object,
+                attributes(object->hipri() || ready_object->hipri()));
           } else {
-            ready_object_ = object;
+            object->next() = ready_objects_;
+            ready_objects_ = object;
             lock_.unlock(); // <<< End critical section
           }
         }
 
+        /// Replace the empty result object with an initial result
+
+        /// When \c seed is ready, all arguments are reduced into it.
+        /// Otherwise, arguments that are ready before \c seed may be reduced
+        /// into a separate result, to which \c seed is added later.
+        /// \param seed The initial result
+        void seed(const Future<result_type>& seed) {
+          MADNESS_ASSERT(ready_result_ && ! ready_objects_);
+          if(seed.probe()) {
+            ready_result_ = std::make_shared<result_type>(seed.get());
+            seed_result_ = ready_result_.get();
+          } else {
+            ready_result_.reset();
+            this->inc();
+            world_.taskq.add(this, & ReduceTaskImpl::reduce_seed, seed,
+                TaskAttributes::hipri());
+          }
+        }
+
+        /// Add a partial result
+
+        /// \param partial The partial result
+        /// \param callback The callback that is invoked when \c partial has
+        /// been taken by this task
+        /// \param hipri The high priority flag of the reduction of \c partial
+        void add_result(const Future<result_type>& partial,
+            madness::CallbackInterface* const callback, const bool hipri)
+        {
+          this->inc();
+          world_.taskq.add(this, & ReduceTaskImpl::reduce_partial, partial,
+              callback, attributes(hipri));
+        }
+
         /// Task result accessor
 
         /// \return A future that will hold the result of the reduction task
@@ -463,9 +638,14 @@ namespace TiledArray {
       /// \param op The reduction operation [ default = opT() ]
       /// \param callback The callback that will be invoked when this task is
       /// complete
+      /// \param max_results The maximum number of partial results that are
+      /// reduced concurrently [ default = 0, i.e. one per thread ]. Use 1 to
+      /// accumulate all arguments into a single result, e.g. for sums of
+      /// large GEMM results where temporaries are expensive.
       ReduceTask(World& world, const opT& op = opT(),
-          madness::CallbackInterface* callback = nullptr) :
-        pimpl_(new ReduceTaskImpl(world, op, callback)), count_(0ul)
+          madness::CallbackInterface* callback = nullptr,
+          const std::size_t max_results = 0ul) :
+        pimpl_(new ReduceTaskImpl(world, op, callback, max_results)), count_(0ul)
       { }
 
       /// Move constructor
@@ -508,11 +688,49 @@ namespace TiledArray {
       /// \param arg The argument that will be reduced
       /// \param callback The callback that will be invoked when this argument
       /// pair has been reduced [ default = nullptr ]
+      /// \param hipri If \c true , the reduction of this argument is a high
+      /// priority task [ default = \c true ]
       template <typename Arg>
-      int add(const Arg& arg, madness::CallbackInterface* callback = nullptr) {
+      int add(const Arg& arg, madness::CallbackInterface* callback = nullptr,
+          const bool hipri = true)
+      {
         MADNESS_ASSERT(pimpl_);
         pimpl_->inc();
-        new typename ReduceTaskImpl::ReduceObject(pimpl_, arg, callback);
+        new typename ReduceTaskImpl::ReduceObject(pimpl_, arg, callback, hipri);
+        return ++count_;
+      }
+
+      /// Add a partial result to the reduction task
+
+      /// \c partial is reduced with the other partial results of this task,
+      /// e.g. the reduction of a subset of the arguments that was computed
+      /// by another process.
+      /// \param partial The partial result
+      /// \param callback The callback that will be invoked when \c partial
+      /// has been taken by this task [ default = nullptr ]
+      /// \param hipri If \c true , the reduction of \c partial is a high
+      /// priority task [ default = \c true ]
+      /// \return The total number of arguments held by this task
+      int add_result(const Future<result_type>& partial,
+          madness::CallbackInterface* callback = nullptr, const bool hipri = true)
+      {
+        MADNESS_ASSERT(pimpl_);
+        pimpl_->add_result(partial, callback, hipri);
+        return ++count_;
+      }
+
+      /// Seed the reduction with an initial result
+
+      /// The arguments of this task are reduced into \c result instead of an
+      /// empty result object, e.g. to accumulate into an existing tile. This
+      /// must be called before any argument is added to the task. The seed is
+      /// included in the argument count.
+      /// \param result The initial result
+      /// \return The total number of arguments held by this task
+      int seed(const Future<result_type>& result) {
+        MADNESS_ASSERT(pimpl_);
+        MADNESS_ASSERT(count_ == 0ul);
+        pimpl_->seed(result);
         return ++count_;
       }
 
@@ -654,8 +872,27 @@ namespace TiledArray {
       /// \param op The pair reduction operation [ default = opT() ]
       /// \param callback The callback that will be invoked when this task is
       /// complete
-      ReducePairTask(World& world, const opT& op = opT(), madness::CallbackInterface* callback = nullptr) :
-        ReduceTask_(world, op_type(op), callback)
+      /// \param max_results The maximum number of partial results that are
+      /// reduced concurrently [ default = 0, i.e. one per thread ]
+      ReducePairTask(World& world, const opT& op = opT(),
+          madness::CallbackInterface* callback = nullptr,
+          const std::size_t max_results = 0ul) :
+        ReduceTask_(world, op_type(op), callback, max_results)
+      { }
+
+      /// Constructor
+
+      /// \param world The world that owns this task
+      /// \param op The wrapped pair reduction operation, e.g. an operation
+      /// that records the cost of the reductions
+      /// \param callback The callback that will be invoked when this task is
+      /// complete
+      /// \param max_results The maximum number of partial results that are
+      /// reduced concurrently [ default = 0, i.e. one per thread ]
+      ReducePairTask(World& world, const ReducePairOpWrapper<opT>& op,
+          madness::CallbackInterface* callback = nullptr,
+          const std::size_t max_results = 0ul) :
+        ReduceTask_(world, op, callback, max_results)
       { }
 
       /// Move constructor
@@ -689,10 +926,14 @@ namespace TiledArray {
       /// \param right The right-hand argument that will be reduced
       /// \param callback The callback that will be invoked when this argument
       /// pair has been reduced [ default = nullptr ]
+      /// \param hipri If \c true , the reduction of this pair is a high
+      /// priority task [ default = \c true ]
       template <typename L, typename R>
-      void add(const L& left, const R& right, madness::CallbackInterface* callback = nullptr) {
+      void add(const L& left, const R& right,
+          madness::CallbackInterface* callback = nullptr, const bool hipri = true)
+      {
         ReduceTask_::add(argument_type(Future<first_argument_type>(left),
-            Future<second_argument_type>(right)), callback);
+            Future<second_argument_type>(right)), callback, hipri);
       }
 
     }; // class ReducePairTask
@@ -0,0 +1,375 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  region_timer.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_REGION_TIMER_H__INCLUDED
+#define TILEDARRAY_REGION_TIMER_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Times of a region on all processes
+  struct RegionTimes {
+    std::string path; ///< The names of the region and its enclosing regions, separated by '/'
+    unsigned int depth; ///< The number of enclosing regions
+    std::size_t calls; ///< The largest number of times a process entered the region
+    std::size_t expressions; ///< The largest number of expressions a process assigned in the region
+    double min; ///< The smallest time of a process in seconds
+    double max; ///< The largest time of a process in seconds
+    double avg; ///< The average time of the processes in seconds
+    double wait_fraction; ///< The fraction of the time that the processes waited
+  }; // struct RegionTimes
+
+  /// Named region timer
+
+  /// The timer accumulates the wall time of named regions of this process,
+  /// which are opened and closed by \c TimedRegion objects. Regions opened
+  /// while another region is open on the same thread are nested in it, and a
+  /// region is identified by its path, e.g. \c "ccsd/t2/ladder" , so a
+  /// region name may be used in several enclosing regions. Times are
+  /// inclusive of nested regions.
+  ///
+  /// Expressions assigned while a region is open are attributed to the
+  /// region and its enclosing regions: the number of assignments is
+  /// counted, and the time the calling thread waits for their results, for
+  /// the pending assignments of \c AsyncEval scopes, or in
+  /// \c TimedRegion::fence() , is counted as waiting time. Waiting time that
+  /// differs between processes with the same region time is the load
+  /// imbalance of the region.
+  /// \note There is one timer per process. Regions are meant to be opened
+  /// around collective work, e.g. a term of a solver; opening and closing a
+  /// region takes a lock.
+  class RegionTimer {
+  public:
+    typedef std::chrono::steady_clock clock_type; ///< Clock type
+    typedef clock_type::time_point time_point; ///< Time point type
+
+    /// Times of a region on this process
+    struct Times {
+      std::string path; ///< The region path
+      std::size_t calls; ///< The number of times the region was entered
+      std::size_t expressions; ///< The number of expressions assigned in the region
+      double time; ///< The time in the region in seconds
+      double wait; ///< The time waited in the region in seconds
+    }; // struct Times
+
+  private:
+    mutable std::mutex lock_; ///< Lock for the region data
+    std::vector<Times> regions_; ///< The regions, in the order they were first entered
+    std::map<std::string, std::size_t> index_; ///< The region index of each path
+
+    RegionTimer() : lock_(), regions_(), index_() { }
+
+    RegionTimer(const RegionTimer&) = delete;
+    RegionTimer& operator=(const RegionTimer&) = delete;
+
+    /// Open region accessor
+
+    /// \return The indices of the regions that are open on the calling
+    /// thread, outermost first
+    static std::vector<std::size_t>& thread_regions() {
+      static thread_local std::vector<std::size_t> regions;
+      return regions;
+    }
+
+  public:
+
+    /// Timer accessor
+
+    /// \return A reference to the region timer of this process
+    static RegionTimer& instance() {
+      static RegionTimer* const timer = new RegionTimer();
+      return *timer;
+    }
+
+    /// Current time
+
+    /// \return The current time point
+    static time_point now() { return clock_type::now(); }
+
+    /// Elapsed time
+
+    /// \param begin The start time
+    /// \return The number of seconds from \c begin to now
+    static double seconds_since(const time_point& begin) {
+      return std::chrono::duration<double>(now() - begin).count();
+    }
+
+    /// Open a region on the calling thread
+
+    /// \param name The region name
+    /// \return The index of the region
+    std::size_t enter(const std::string& name) {
+      std::vector<std::size_t>& open = thread_regions();
+      std::lock_guard<std::mutex> locker(lock_);
+      const std::string path = (open.empty() ? name :
+          regions_[open.back()].path + "/" + name);
+      auto it = index_.find(path);
+      if(it == index_.end()) {
+        it = index_.emplace(path, regions_.size()).first;
+        regions_.push_back(Times{ path, 0ul, 0ul, 0.0, 0.0 });
+      }
+      ++regions_[it->second].calls;
+      open.push_back(it->second);
+      return it->second;
+    }
+
+    /// Close the innermost region of the calling thread
+
+    /// \param region The index of the region, which must be the innermost
+    /// open region of the calling thread
+    /// \param time The time spent in the region in seconds
+    void exit(const std::size_t region, const double time) {
+      std::vector<std::size_t>& open = thread_regions();
+      TA_ASSERT(! open.empty());
+      TA_ASSERT(open.back() == region);
+      open.pop_back();
+      std::lock_guard<std::mutex> locker(lock_);
+      regions_[region].time += time;
+    }
+
+    /// Check for open regions
+
+    /// \return \c true if a region is open on the calling thread
+    static bool active() { return ! thread_regions().empty(); }
+
+    /// Attribute an expression assignment to the open regions
+
+    /// Nothing is recorded when no region is open on the calling thread.
+    void add_expression() {
+      const std::vector<std::size_t>& open = thread_regions();
+      if(open.empty())
+        return;
+      std::lock_guard<std::mutex> locker(lock_);
+      for(const std::size_t region : open)
+        ++regions_[region].expressions;
+    }
+
+    /// Attribute waiting time to the open regions
+
+    /// \param time The time waited in seconds
+    void add_wait(const double time) {
+      const std::vector<std::size_t>& open = thread_regions();
+      if(open.empty())
+        return;
+      std::lock_guard<std::mutex> locker(lock_);
+      for(const std::size_t region : open)
+        regions_[region].wait += time;
+    }
+
+    /// Times of a region of this process
+
+    /// \param path The region path
+    /// \return The times of the region; all times are zero if the region
+    /// has not been entered
+    Times times(const std::string& path) const {
+      std::lock_guard<std::mutex> locker(lock_);
+      const auto it = index_.find(path);
+      if(it == index_.end())
+        return Times{ path, 0ul, 0ul, 0.0, 0.0 };
+      return regions_[it->second];
+    }
+
+    /// Times of all regions of this process
+
+    /// \return The times of the regions, in the order they were first entered
+    std::vector<Times> times() const {
+      std::lock_guard<std::mutex> locker(lock_);
+      return regions_;
+    }
+
+    /// Discard the times of all regions
+
+    /// Must not be called while a region is open.
+    void clear() {
+      std::lock_guard<std::mutex> locker(lock_);
+      regions_.clear();
+      index_.clear();
+    }
+
+  }; // class RegionTimer
+
+  /// Time a named region
+
+  /// The region is open from the construction of this object until it is
+  /// destroyed; see \c RegionTimer .
+  /// \code
+  /// {
+  ///   TiledArray::TimedRegion region("t2");
+  ///   {
+  ///     TiledArray::TimedRegion ladder("ladder");
+  ///     r("a,b,i,j") = v("a,b,c,d") * t("c,d,i,j");
+  ///   }
+  ///   region.fence(world);
+  /// }
+  /// TiledArray::print_region_times(world);
+  /// \endcode
+  class TimedRegion {
+    const RegionTimer::time_point begin_; ///< The time the region was opened
+    const std::size_t region_; ///< The region index
+
+  public:
+    /// Constructor
+
+    /// \param name The region name, which must not contain '/'
+    explicit TimedRegion(const std::string& name) :
+      begin_(RegionTimer::now()), region_(RegionTimer::instance().enter(name))
+    { }
+
+    TimedRegion(const TimedRegion&) = delete;
+    TimedRegion& operator=(const TimedRegion&) = delete;
+
+    ~TimedRegion() {
+      RegionTimer::instance().exit(region_, RegionTimer::seconds_since(begin_));
+    }
+
+    /// Fence a world
+
+    /// The time of the fence is waiting time of the open regions.
+    /// \param world The world to be fenced
+    void fence(World& world) const {
+      const RegionTimer::time_point begin = RegionTimer::now();
+      world.gop.fence();
+      RegionTimer::instance().add_wait(RegionTimer::seconds_since(begin));
+    }
+
+  }; // class TimedRegion
+
+  namespace detail {
+
+    /// Count the lifetime of a scope as waiting time of the open regions
+
+    /// The clock is only read when a region is open on the calling thread.
+    class RegionWait {
+      const bool active_; ///< Region flag
+      const RegionTimer::time_point begin_; ///< The start time of the wait
+
+    public:
+      RegionWait() :
+        active_(RegionTimer::active()),
+        begin_(active_ ? RegionTimer::now() : RegionTimer::time_point())
+      { }
+
+      RegionWait(const RegionWait&) = delete;
+      RegionWait& operator=(const RegionWait&) = delete;
+
+      ~RegionWait() {
+        if(active_)
+          RegionTimer::instance().add_wait(RegionTimer::seconds_since(begin_));
+      }
+    }; // class RegionWait
+
+  } // namespace detail
+
+  /// Times of the regions of all processes
+
+  /// The regions of rank 0 are reduced over the processes of \c world , in
+  /// the order that rank 0 first entered them; regions that rank 0 did not
+  /// enter are not included. Processes that did not enter a region count
+  /// with zero time.
+  /// This is a collective operation.
+  /// \param world The world of the processes
+  /// \return The times of the regions of rank 0
+  inline std::vector<RegionTimes> region_times(World& world) {
+    const RegionTimer& timer = RegionTimer::instance();
+
+    // Use the regions of rank 0
+    std::vector<std::string> paths;
+    if(world.rank() == 0)
+      for(const RegionTimer::Times& times : timer.times())
+        paths.push_back(times.path);
+    world.gop.broadcast_serializable(paths, 0);
+    const std::size_t n = paths.size();
+    if(n == 0ul)
+      return std::vector<RegionTimes>();
+
+    // Reduce the times; the counts are reduced as doubles
+    std::vector<double> min(n), max(3ul * n), sum(2ul * n);
+    for(std::size_t i = 0ul; i < n; ++i) {
+      const RegionTimer::Times times = timer.times(paths[i]);
+      min[i] = times.time;
+      max[i] = times.time;
+      max[n + i] = times.calls;
+      max[2ul * n + i] = times.expressions;
+      sum[i] = times.time;
+      sum[n + i] = times.wait;
+    }
+    world.gop.min(min.data(), n);
+    world.gop.max(max.data(), 3ul * n);
+    world.gop.sum(sum.data(), 2ul * n);
+
+    std::vector<RegionTimes> result;
+    result.reserve(n);
+    for(std::size_t i = 0ul; i < n; ++i)
+      result.push_back(RegionTimes{ paths[i],
+          (unsigned int)std::count(paths[i].begin(), paths[i].end(), '/'),
+          std::size_t(max[n + i]), std::size_t(max[2ul * n + i]), min[i],
+          max[i], sum[i] / double(world.size()),
+          (sum[i] > 0.0 ? sum[n + i] / sum[i] : 0.0) });
+    return result;
+  }
+
+  /// Print the times of the regions of all processes
+
+  /// Nested regions are indented below their enclosing region. The
+  /// imbalance is the largest time of a process divided by the average.
+  /// This is a collective operation; the report is printed by rank 0.
+  /// \param world The world of the processes
+  /// \param os The output stream
+  inline void print_region_times(World& world, std::ostream& os = std::cout) {
+    const std::vector<RegionTimes> times = region_times(world);
+    if(world.rank() != 0)
+      return;
+
+    os << "Region times (over " << world.size() << " processes, s):\n"
+       << std::left << std::setw(32) << "region" << std::right
+       << std::setw(8) << "calls" << std::setw(8) << "exprs"
+       << std::setw(12) << "min" << std::setw(12) << "avg"
+       << std::setw(12) << "max" << std::setw(10) << "imbal"
+       << std::setw(10) << "wait %" << "\n";
+    for(const RegionTimes& region : times) {
+      const std::size_t slash = region.path.rfind('/');
+      const std::string name = std::string(2u * region.depth, ' ') +
+          (slash == std::string::npos ? region.path : region.path.substr(slash + 1ul));
+      os << std::left << std::setw(32) << name << std::right
+         << std::setw(8) << region.calls << std::setw(8) << region.expressions
+         << std::setw(12) << region.min << std::setw(12) << region.avg
+         << std::setw(12) << region.max
+         << std::setw(10) << (region.avg > 0.0 ? region.max / region.avg : 1.0)
+         << std::setw(10) << 100.0 * region.wait_fraction << "\n";
+    }
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_REGION_TIMER_H__INCLUDED
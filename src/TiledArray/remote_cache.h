@@ -0,0 +1,276 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  remote_cache.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_REMOTE_CACHE_H__INCLUDED
+#define TILEDARRAY_REMOTE_CACHE_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <cstdlib>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace TiledArray {
+
+  /// Cache of remote tiles
+
+  /// When the cache is enabled, distributed storage objects that are
+  /// constructed afterwards keep the remote tiles that this process gets, so
+  /// repeated gets of a remote tile, e.g. of the tiles of an integral array
+  /// that are read by many tasks, do not send another request to the owner.
+  /// The cached tiles are tracked in a least-recently-used (LRU) list, and
+  /// the least recently used tiles are evicted when the cached tiles hold
+  /// more than the capacity. The cache is disabled by default; it is enabled
+  /// with \c enable() or by setting the \c TA_REMOTE_CACHE environment
+  /// variable to the capacity (in bytes).
+  ///
+  /// Tiles are set once, so a cached tile is stale only if its owner
+  /// modified the tile data in place, or erased and set the tile again. The
+  /// cached tiles of a storage object are dropped with its
+  /// \c invalidate_cache() , and all cached tiles are dropped with
+  /// \c invalidate() or \c fence() , which increment the cache version.
+  /// \code
+  /// TiledArray::RemoteTileCache::instance().enable(1ul << 30);
+  /// TArrayD eri = ...; // the remote tiles of eri are cached
+  /// ...
+  /// TiledArray::RemoteTileCache::instance().fence(world);
+  /// \endcode
+  /// \note There is one cache per process, so the capacity applies to the
+  /// remote tiles of all arrays of this process.
+  class RemoteTileCache {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+    /// Cache client interface
+
+    /// Clients hold the cached tiles.
+    class Client {
+    public:
+      virtual ~Client() { }
+
+      /// Drop a cached tile
+
+      /// \param key The key of the tile
+      virtual void evict(const size_type key) = 0;
+    }; // class Client
+
+  private:
+
+    typedef std::pair<Client*, size_type> entry_type;
+    typedef std::list<entry_type> list_type;
+
+    /// The hash function of an entry
+    struct hash_entry {
+      std::size_t operator()(const entry_type& entry) const {
+        return std::hash<Client*>()(entry.first) ^ (entry.second * 0x9e3779b97f4a7c15ul);
+      }
+    }; // struct hash_entry
+
+    /// The location and size of a cached tile
+    struct Position {
+      list_type::iterator iterator; ///< The position of the tile in the LRU list
+      size_type bytes; ///< The size of the tile
+    }; // struct Position
+
+    typedef std::unordered_map<entry_type, Position, hash_entry> map_type;
+
+    bool enabled_; ///< Cache flag
+    size_type capacity_; ///< The maximum number of bytes held by cached tiles
+    size_type bytes_; ///< The number of bytes held by cached tiles
+    size_type version_; ///< The number of invalidations
+    mutable madness::Mutex lock_; ///< Lock for the LRU list
+    list_type lru_; ///< The cached tiles, from the most to least recently used
+    map_type positions_; ///< Cached tile positions
+
+    RemoteTileCache() :
+      enabled_(getenv("TA_REMOTE_CACHE") != nullptr),
+      capacity_(enabled_ ? std::strtoul(getenv("TA_REMOTE_CACHE"), nullptr, 10) : 0ul),
+      bytes_(0ul), version_(0ul), lock_(), lru_(), positions_()
+    { }
+
+    RemoteTileCache(const RemoteTileCache&) = delete;
+    RemoteTileCache& operator=(const RemoteTileCache&) = delete;
+
+    /// Remove a cached tile
+
+    /// \param it The position of the tile
+    /// \note The caller must hold \c lock_ .
+    void erase(const map_type::iterator& it) {
+      bytes_ -= it->second.bytes;
+      lru_.erase(it->second.iterator);
+      positions_.erase(it);
+    }
+
+  public:
+
+    /// Cache accessor
+
+    /// \return A reference to the remote tile cache of this process
+    static RemoteTileCache& instance() {
+      static RemoteTileCache* const cache = new RemoteTileCache();
+      return *cache;
+    }
+
+    /// Enable the cache
+
+    /// Only storage objects that are constructed after this call cache
+    /// remote tiles.
+    /// \param capacity The maximum number of bytes held by cached tiles
+    void enable(const size_type capacity) {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      capacity_ = capacity;
+      enabled_ = true;
+    }
+
+    /// Disable the cache
+
+    /// Storage objects that were constructed while the cache was enabled
+    /// continue to cache remote tiles.
+    void disable() {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      enabled_ = false;
+    }
+
+    /// Cache status
+
+    /// \return \c true if new storage objects cache remote tiles
+    bool enabled() const {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      return enabled_;
+    }
+
+    /// Capacity accessor
+
+    /// \return The maximum number of bytes held by cached tiles
+    size_type capacity() const {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      return capacity_;
+    }
+
+    /// Cached memory accessor
+
+    /// \return The number of bytes held by cached tiles
+    size_type bytes() const {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      return bytes_;
+    }
+
+    /// Cache version accessor
+
+    /// \return The number of times all cached tiles were dropped
+    size_type version() const {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      return version_;
+    }
+
+    /// Add a tile to the cache, or mark it as used
+
+    /// The tile is moved to the front of the LRU list, or inserted if it is
+    /// not cached. Least recently used tiles are then evicted until the cached
+    /// tiles fit in the capacity; a tile that is larger than the capacity is
+    /// evicted immediately.
+    /// \param client The holder of the tile
+    /// \param key The key of the tile
+    /// \param bytes The size of the tile
+    /// \note The caller must not hold any lock of \c client that is
+    /// acquired by <tt>Client::evict()</tt> .
+    void insert(Client* const client, const size_type key, const size_type bytes) {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+
+      const entry_type entry(client, key);
+      auto it = positions_.find(entry);
+      if(it != positions_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.iterator);
+      } else {
+        lru_.push_front(entry);
+        positions_.emplace(entry, Position{ lru_.begin(), bytes });
+        bytes_ += bytes;
+      }
+
+      // Evict the least recently used tiles. The lock is held while tiles are
+      // evicted, so clients cannot be destroyed while they evict a tile.
+      while(bytes_ > capacity_) {
+        const entry_type victim = lru_.back();
+        erase(positions_.find(victim));
+        victim.first->evict(victim.second);
+      }
+    }
+
+    /// Mark a cached tile as used
+
+    /// Nothing is done if the tile is not tracked, e.g. before it arrived.
+    /// \param client The holder of the tile
+    /// \param key The key of the tile
+    void touch(Client* const client, const size_type key) {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      auto it = positions_.find(entry_type(client, key));
+      if(it != positions_.end())
+        lru_.splice(lru_.begin(), lru_, it->second.iterator);
+    }
+
+    /// Stop tracking the tiles of a client
+
+    /// \param client The client that is removed
+    /// \note The tiles are not evicted from \c client .
+    void remove(Client* const client) {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      for(auto it = lru_.begin(); it != lru_.end();) {
+        const entry_type entry = *it++;
+        if(entry.first == client)
+          erase(positions_.find(entry));
+      }
+    }
+
+    /// Drop all cached tiles
+
+    /// The cache version is incremented. Tiles that are in flight when this
+    /// is called are not cached.
+    void invalidate() {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      ++version_;
+      while(! lru_.empty()) {
+        const entry_type victim = lru_.back();
+        erase(positions_.find(victim));
+        victim.first->evict(victim.second);
+      }
+    }
+
+    /// Fence a world and drop all cached tiles
+
+    /// After the fence all modifications of tiles are complete, so the
+    /// tiles that are read afterwards are current. This is a collective
+    /// operation.
+    /// \param world The world to be fenced
+    void fence(World& world) {
+      world.gop.fence();
+      invalidate();
+    }
+
+  }; // class RemoteTileCache
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_REMOTE_CACHE_H__INCLUDED
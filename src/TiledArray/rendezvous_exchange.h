@@ -0,0 +1,279 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *
+ *  rendezvous_exchange.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_RENDEZVOUS_EXCHANGE_H__INCLUDED
+#define TILEDARRAY_RENDEZVOUS_EXCHANGE_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/type_traits.h>
+#include <climits>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+/// The minimum size (in bytes) of tiles that are sent by rendezvous
+#ifndef TILEDARRAY_RENDEZVOUS_THRESHOLD
+#define TILEDARRAY_RENDEZVOUS_THRESHOLD 262144ul
+#endif // TILEDARRAY_RENDEZVOUS_THRESHOLD
+
+namespace TiledArray {
+
+  // Forward declaration
+  template <typename, typename> class Tensor;
+
+  /// Rendezvous tile exchange policy
+
+  /// When the rendezvous exchange is enabled, a large \c Tensor tile that is
+  /// sent to another process is not serialized into the active message
+  /// buffer. Only its range and an MPI tag are sent with the message, and the
+  /// elements are sent with a separate \c MPI_Isend from the memory of the
+  /// tile, which the receiver posts an \c MPI_Irecv for, directly into the
+  /// memory of the new tile. This avoids two copies of the elements, and
+  /// lets MPI use its zero-copy (rendezvous or RDMA) protocol. It is used for
+  /// remote \c DistributedStorage gets. Tiles smaller than
+  /// \c TILEDARRAY_RENDEZVOUS_THRESHOLD bytes, tiles larger than \c INT_MAX
+  /// bytes (the largest count of an MPI message), and other tile types, are
+  /// sent with the message. The exchange is disabled by default; it is
+  /// enabled with \c enable() or by setting the \c TA_RENDEZVOUS_EXCHANGE
+  /// environment variable.
+  /// \note The exchange must be enabled or disabled on all processes, and
+  /// only affects distributed objects that are constructed afterwards.
+  class RendezvousExchange {
+    bool enabled_; ///< Exchange flag
+
+    RendezvousExchange() :
+      enabled_(getenv("TA_RENDEZVOUS_EXCHANGE") != nullptr)
+    { }
+
+    RendezvousExchange(const RendezvousExchange&) = delete;
+    RendezvousExchange& operator=(const RendezvousExchange&) = delete;
+
+  public:
+
+    /// Exchange policy accessor
+
+    /// \return A reference to the exchange policy of this process
+    static RendezvousExchange& instance() {
+      static RendezvousExchange* const exchange = new RendezvousExchange();
+      return *exchange;
+    }
+
+    /// Enable the rendezvous exchange
+    void enable() { enabled_ = true; }
+
+    /// Disable the rendezvous exchange
+    void disable() { enabled_ = false; }
+
+    /// Exchange status
+
+    /// \return \c true if the rendezvous exchange is enabled
+    bool enabled() const { return enabled_; }
+
+  }; // class RendezvousExchange
+
+  namespace detail {
+
+    /// Rendezvous tile check
+
+    /// \tparam T The tile type
+    template <typename T>
+    struct is_rendezvous_tile : public std::false_type { };
+
+    /// Tensors of numbers hold their elements in one contiguous buffer
+    template <typename T, typename A>
+    struct is_rendezvous_tile<Tensor<T, A> > :
+        public std::integral_constant<bool, is_numeric<T>::value> { };
+
+    /// A tile that is sent by rendezvous
+
+    /// The handle holds the serialized range of the tile and the tag of the
+    /// message with its elements, or, for small tiles, the serialized tile.
+    struct RendezvousHandle {
+      int tag; ///< The tag of the element message, or -1 if \c data holds the tile
+      std::size_t size; ///< The size of the elements, or of the serialized tile
+      std::vector<unsigned char> data; ///< The serialized range or tile
+
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & tag & size & data; }
+    }; // struct RendezvousHandle
+
+    /// Serialize an object into a byte vector
+
+    /// \tparam T The object type
+    /// \param object The object
+    /// \param[out] data The serialized object
+    template <typename T>
+    void rendezvous_store(const T& object, std::vector<unsigned char>& data) {
+      madness::archive::BufferOutputArchive count_ar;
+      count_ar & object;
+      data.resize(count_ar.size());
+      madness::archive::BufferOutputArchive ar(data.data(), data.size());
+      ar & object;
+    }
+
+    /// Deserialize an object from a byte vector
+
+    /// \tparam T The object type
+    /// \param data The serialized object
+    /// \param[out] object The object
+    template <typename T>
+    void rendezvous_load(const std::vector<unsigned char>& data, T& object) {
+      madness::archive::BufferInputArchive ar(data.data(), data.size());
+      ar & object;
+    }
+
+    /// Wait for an MPI request
+
+    /// The calling thread runs other tasks while it waits.
+    /// \param world The world of the request
+    /// \param request The request
+    inline void rendezvous_wait(World& world, SafeMPI::Request& request) {
+      world.await([&request] () -> bool { return request.Test(); });
+    }
+
+    /// Send a tile
+
+    /// \tparam T The tile type
+    /// \param world The world of the sender and receiver
+    /// \param tile The tile
+    /// \return The handle of a tile that is sent with the message
+    template <typename T>
+    RendezvousHandle send_tile(World*, const T& tile, ProcessID, std::false_type) {
+      RendezvousHandle handle;
+      handle.tag = -1;
+      rendezvous_store(tile, handle.data);
+      handle.size = handle.data.size();
+      return handle;
+    }
+
+    /// Send a tensor
+
+    /// The elements of large tensors are sent with \c MPI_Isend . The tensor
+    /// is held by a task until the send is complete.
+    /// \tparam T The tensor type
+    /// \param world The world of the sender and receiver
+    /// \param tile The tensor
+    /// \param dest The receiver
+    /// \return The handle of the tensor
+    template <typename T>
+    RendezvousHandle send_tile(World* world, const T& tile,
+        const ProcessID dest, std::true_type)
+    {
+      const std::size_t bytes =
+          (tile.empty() ? 0ul : tile.range().volume() * sizeof(typename T::value_type));
+      // The count of an MPI message is an int, so tiles of INT_MAX bytes or
+      // more are sent with the message.
+      if((bytes < TILEDARRAY_RENDEZVOUS_THRESHOLD) || (bytes > std::size_t(INT_MAX)))
+        return send_tile(world, tile, dest, std::false_type());
+
+      RendezvousHandle handle;
+      {
+        static madness::Spinlock lock;
+        madness::ScopedMutex<madness::Spinlock> locker(&lock);
+        handle.tag = world->mpi.unique_tag();
+      }
+      handle.size = bytes;
+      rendezvous_store(tile.range(), handle.data);
+
+      std::shared_ptr<SafeMPI::Request> request = std::make_shared<SafeMPI::Request>(
+          world->mpi.Isend(tile.data(), int(bytes), MPI_BYTE, dest, handle.tag));
+      world->taskq.add([world, request, tile] () {
+        rendezvous_wait(*world, *request);
+      }, madness::TaskAttributes::hipri());
+
+      return handle;
+    }
+
+    /// Send a tile to another process
+
+    /// \tparam T The tile type
+    /// \param world The world of the sender and receiver
+    /// \param tile The tile
+    /// \param dest The receiver
+    /// \return The handle that is sent to \c dest
+    template <typename T>
+    RendezvousHandle rendezvous_send(World* world, const T& tile, const ProcessID dest) {
+      return send_tile(world, tile, dest,
+          std::integral_constant<bool, is_rendezvous_tile<T>::value>());
+    }
+
+    /// Receive a tile
+
+    /// \tparam T The tile type
+    /// \param handle The handle of a tile that is sent with the message
+    /// \return The tile
+    template <typename T>
+    T recv_tile(World*, const RendezvousHandle& handle, ProcessID, std::false_type) {
+      TA_ASSERT(handle.tag < 0);
+      T tile;
+      rendezvous_load(handle.data, tile);
+      return tile;
+    }
+
+    /// Receive a tensor
+
+    /// \tparam T The tensor type
+    /// \param world The world of the sender and receiver
+    /// \param handle The handle of the tensor
+    /// \param src The sender
+    /// \return The tensor
+    template <typename T>
+    T recv_tile(World* world, const RendezvousHandle& handle,
+        const ProcessID src, std::true_type)
+    {
+      if(handle.tag < 0)
+        return recv_tile<T>(world, handle, src, std::false_type());
+
+      typename T::range_type range;
+      rendezvous_load(handle.data, range);
+      T tile(range);
+      TA_ASSERT(tile.range().volume() * sizeof(typename T::value_type) == handle.size);
+      TA_ASSERT(handle.size <= std::size_t(INT_MAX));
+      SafeMPI::Request request =
+          world->mpi.Irecv(tile.data(), int(handle.size), MPI_BYTE, src, handle.tag);
+      rendezvous_wait(*world, request);
+      return tile;
+    }
+
+    /// Receive a tile from another process
+
+    /// \tparam T The tile type
+    /// \param world The world of the sender and receiver
+    /// \param handle The handle received from \c src
+    /// \param src The sender
+    /// \return The tile
+    template <typename T>
+    T rendezvous_recv(World* world, const RendezvousHandle& handle, const ProcessID src) {
+      return recv_tile<T>(world, handle, src,
+          std::integral_constant<bool, is_rendezvous_tile<T>::value>());
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_RENDEZVOUS_EXCHANGE_H__INCLUDED
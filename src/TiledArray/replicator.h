@@ -20,31 +20,141 @@
 #ifndef TILEDARRAY_REPLICATOR_H__INCLUDED
 #define TILEDARRAY_REPLICATOR_H__INCLUDED
 
+#include <TiledArray/comm_tracker.h>
 #include <TiledArray/madness.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
 namespace TiledArray {
+
+  /// Broadcast algorithms of array replication
+  enum class ReplicateAlgorithm {
+    tree, ///< Binomial tree broadcast, O(log P) steps per source
+    flat  ///< Each source sends its tiles to every process, O(P) sends per source
+  };
+
   namespace detail {
 
+    /// Replication settings
+
+    /// The defaults are given by the \c TA_REPLICATE_ALGORITHM ( \c "tree" or
+    /// \c "flat" ) and \c TA_REPLICATE_CHUNK (the number of tiles per
+    /// message) environment variables; otherwise the binomial tree is used
+    /// and each message holds 16 tiles.
+    class ReplicatorConfig {
+      ReplicateAlgorithm algorithm_; ///< The broadcast algorithm
+      std::size_t chunk_size_; ///< The maximum number of tiles per message
+
+      ReplicatorConfig() :
+        algorithm_(parse_algorithm(getenv("TA_REPLICATE_ALGORITHM"))),
+        chunk_size_(getenv("TA_REPLICATE_CHUNK") ?
+            std::stoul(getenv("TA_REPLICATE_CHUNK")) : 16ul)
+      { }
+
+      ReplicatorConfig(const ReplicatorConfig&) = delete;
+      ReplicatorConfig& operator=(const ReplicatorConfig&) = delete;
+
+      static ReplicateAlgorithm parse_algorithm(const char* str) {
+        if(str && (std::strcmp(str, "flat") == 0))
+          return ReplicateAlgorithm::flat;
+        return ReplicateAlgorithm::tree;
+      }
+
+    public:
+
+      /// Settings accessor
+
+      /// \return A reference to the replication settings of this process
+      static ReplicatorConfig& instance() {
+        static ReplicatorConfig config;
+        return config;
+      }
+
+      /// \return The broadcast algorithm
+      ReplicateAlgorithm algorithm() const { return algorithm_; }
+
+      /// \return The maximum number of tiles per message, or zero if all local
+      /// tiles are sent in one message
+      std::size_t chunk_size() const { return chunk_size_; }
+
+      /// Set the broadcast algorithm
+
+      /// \param algorithm The broadcast algorithm
+      void algorithm(const ReplicateAlgorithm algorithm) { algorithm_ = algorithm; }
+
+      /// Set the number of tiles per message
+
+      /// Smaller messages pipeline the broadcast through the levels of the
+      /// tree.
+      /// \param chunk_size The maximum number of tiles per message, or zero to
+      /// send all local tiles in one message
+      void chunk_size(const std::size_t chunk_size) { chunk_size_ = chunk_size; }
+
+    }; // class ReplicatorConfig
+
+    /// The children of a process in a broadcast tree
+
+    /// \param rank The process
+    /// \param size The number of processes
+    /// \param root The source process of the broadcast
+    /// \param algorithm The broadcast algorithm
+    /// \return The processes that \c rank sends the data of \c root to
+    inline std::vector<ProcessID> broadcast_children(const ProcessID rank,
+        const ProcessID size, const ProcessID root,
+        const ReplicateAlgorithm algorithm)
+    {
+      const ProcessID relative = (rank - root + size) % size;
+      std::vector<ProcessID> result;
+
+      if(algorithm == ReplicateAlgorithm::flat) {
+        if(relative == 0)
+          for(ProcessID r = 1; r < size; ++r)
+            result.push_back((r + root) % size);
+        return result;
+      }
+
+      // The children of relative are relative + 2^j for each 2^j below the
+      // lowest set bit of relative. The largest subtree is sent first.
+      ProcessID mask = 1;
+      while((mask < size) && ! (relative & mask))
+        mask <<= 1;
+      for(mask >>= 1; mask > 0; mask >>= 1)
+        if(relative + mask < size)
+          result.push_back((relative + mask + root) % size);
+
+      return result;
+    }
+
     /// Replicate a \c Array object
 
     /// This object will create a replicated \c Array from a distributed
-    /// \c Array.
+    /// \c Array. The local tiles of each process are broadcast to all other
+    /// processes in chunks, with a binomial tree rooted at the source
+    /// process (see \c ReplicatorConfig ). The chunks are sent as their tiles
+    /// are ready, and each process forwards a chunk to its children in the
+    /// tree as soon as it arrives, so the broadcast is pipelined.
     /// \tparam A The array type
-    /// Homeworld = M7R-227
     template <typename A>
     class Replicator : public madness::WorldObject<Replicator<A> >, private madness::Spinlock {
     private:
       typedef Replicator<A> Replicator_; ///< This object type
       typedef madness::WorldObject<Replicator_> wobj_type; ///< The base object type
       typedef std::stack<madness::CallbackInterface*, std::vector<madness::CallbackInterface*> > callback_type; ///< Callback interface
+      typedef typename A::size_type size_type; ///< Tile index type
+      typedef std::vector<size_type> index_list; ///< A list of tile indices
+      typedef std::vector<Future<typename A::value_type> > data_list; ///< A list of tiles
 
       A destination_; ///< The replicated array
-      std::vector<typename A::size_type> indices_; ///< List of local tile indices
-      std::vector<Future<typename A::value_type> > data_; ///< List of local tiles
-      madness::AtomicInt sent_; ///< The number of nodes the data has been sent to
+      index_list indices_; ///< List of local tile indices
+      data_list data_; ///< List of local tiles
+      const ReplicateAlgorithm algorithm_; ///< The broadcast algorithm
+      const std::size_t chunk_size_; ///< The number of tiles per chunk
+      std::size_t chunks_; ///< The number of local chunks
+      madness::AtomicInt sent_; ///< The number of local chunks that have been sent
       World& world_;
       volatile callback_type callbacks_; ///< A callback stack
-      volatile mutable bool probe_; ///< Cache for local data probe
 
       /// \note Assume object is already locked
       void do_callbacks() {
@@ -55,26 +165,27 @@ namespace TiledArray {
         }
       }
 
-      /// Task that will call send when all local tiles are ready to be sent
+      /// Task that will send a chunk when its local tiles are ready
       class DelaySend : public madness::TaskInterface {
       private:
         Replicator_& parent_; ///< The parent replicator operation
+        const std::size_t chunk_; ///< The chunk to be sent
 
       public:
 
         /// Constructor
-        DelaySend(Replicator_& parent) :
+
+        /// \param parent The parent replicator operation
+        /// \param chunk The chunk to be sent
+        DelaySend(Replicator_& parent, const std::size_t chunk) :
           madness::TaskInterface(madness::TaskAttributes::hipri()),
-          parent_(parent)
+          parent_(parent), chunk_(chunk)
         {
-          typename std::vector<Future<typename A::value_type> >::iterator it =
-              parent_.data_.begin();
-          typename std::vector<Future<typename A::value_type> >::iterator end =
-              parent_.data_.end();
-          for(; it != end; ++it) {
-            if(! it->probe()) {
+          const std::size_t last = parent_.chunk_end(chunk_);
+          for(std::size_t i = parent_.chunk_begin(chunk_); i < last; ++i) {
+            if(! parent_.data_[i].probe()) {
               madness::DependencyInterface::inc();
-              it->register_callback(this);
+              parent_.data_[i].register_callback(this);
             }
           }
         }
@@ -83,78 +194,114 @@ namespace TiledArray {
         virtual ~DelaySend() { }
 
         /// Task send task function
-        virtual void run(const madness::TaskThreadEnv&) { parent_.send(); }
+        virtual void run(const madness::TaskThreadEnv&) { parent_.send(chunk_); }
 
       }; // class DelaySend
 
-      /// Probe all local data has been set
+      /// \return The first local tile of \c chunk
+      std::size_t chunk_begin(const std::size_t chunk) const {
+        return chunk * chunk_size_;
+      }
 
-      /// \return \c true when all local tiles have been set
-      bool probe() const {
-        madness::ScopedMutex<madness::Spinlock> locker(this);
+      /// \return One past the last local tile of \c chunk
+      std::size_t chunk_end(const std::size_t chunk) const {
+        return std::min((chunk + 1ul) * chunk_size_, data_.size());
+      }
 
-        if(! probe_) {
-          typename std::vector<Future<typename A::value_type> >::const_iterator it =
-              data_.begin();
-          typename std::vector<Future<typename A::value_type> >::const_iterator end =
-              data_.end();
-          for(; it != end; ++it)
-            if(! it->probe())
-              break;
+      /// The children of this process in the broadcast tree of \c root
 
-          probe_ = (it == end);
-        }
+      /// \param root The source process of the broadcast
+      /// \return The processes that this process sends the data of \c root to
+      std::vector<ProcessID> children(const ProcessID root) const {
+        return broadcast_children(world_.rank(), world_.size(), root, algorithm_);
+      }
+
+      /// Send data of \c root to the children of this process
+
+      /// \param root The source process of the data
+      /// \param indices The tile indices
+      /// \param data The tiles
+      void forward(const ProcessID root, const index_list& indices,
+          const data_list& data)
+      {
+        const std::vector<ProcessID> procs = children(root);
+        for(const ProcessID child : procs)
+          wobj_type::task(child, & Replicator_::send_handler, root, indices,
+              data, madness::TaskAttributes::hipri());
+
+        if(! procs.empty() && CommTracker::instance().enabled())
+          CommTracker::instance().send(CommCategory::replicate,
+              procs.size() * bytes(data), procs.size());
+      }
 
-        return probe_;
+      /// \return The size of the tile data in \c data in bytes
+      static std::size_t bytes(const data_list& data) {
+        std::size_t result = 0ul;
+        for(const auto& tile : data)
+          result += detail::tile_bytes(tile.get());
+        return result;
       }
 
-      /// Send data to the next node when it is ready
-      void delay_send() {
-        if(probe()) {
+      /// Send a local chunk
+      void send(const std::size_t chunk) {
+        const std::size_t first = chunk_begin(chunk);
+        const std::size_t last = chunk_end(chunk);
+        forward(world_.rank(),
+            index_list(indices_.begin() + first, indices_.begin() + last),
+            data_list(data_.begin() + first, data_.begin() + last));
+
+        if(std::size_t(++sent_) == chunks_) {
+          madness::ScopedMutex<madness::Spinlock> locker(this);
+          do_callbacks(); // Replication is done
+        }
+      }
+
+      /// Send a local chunk when its tiles are ready
+      void delay_send(const std::size_t chunk) {
+        const std::size_t last = chunk_end(chunk);
+        std::size_t i = chunk_begin(chunk);
+        for(; i < last; ++i)
+          if(! data_[i].probe())
+            break;
+
+        if(i == last) {
           // The data is ready so send it now.
-          send(); // Replication is done
+          send(chunk);
         } else {
           // The local data is not ready to be sent, so create a task that will
           // send it when it is ready.
-          DelaySend* delay_send_task = new DelaySend(*this);
-          world_.taskq.add(delay_send_task);
+          world_.taskq.add(new DelaySend(*this, chunk));
         }
       }
 
-      /// Send all local data to the next node
-      void send() {
-        const long sent = ++sent_;
-        const ProcessID dest = (world_.rank() + sent) % world_.size();
+      void send_handler(const ProcessID root, const index_list& indices,
+          const data_list& data)
+      {
+        // Pass the data on before storing it, to keep the broadcast moving
+        forward(root, indices, data);
 
-        if(dest != world_.rank()) {
-          wobj_type::task(dest, &  Replicator_::send_handler, indices_, data_,
-              madness::TaskAttributes::hipri());
-        } else
-          do_callbacks(); // Replication is done
-      }
+        if(CommTracker::instance().enabled())
+          CommTracker::instance().receive(CommCategory::replicate, bytes(data),
+              CommTracker::now());
 
-      void send_handler(const std::vector<typename A::size_type>& indices,
-          const std::vector<Future<typename A::value_type> >& data)
-      {
-        typename std::vector<typename A::size_type>::const_iterator index_it =
-            indices.begin();
-        typename std::vector<Future<typename A::value_type> >::const_iterator data_it =
-            data.begin();
-        typename std::vector<Future<typename A::value_type> >::const_iterator data_end =
-            data.end();
+        typename index_list::const_iterator index_it = indices.begin();
+        typename data_list::const_iterator data_it = data.begin();
+        typename data_list::const_iterator data_end = data.end();
 
         for(; data_it != data_end; ++data_it, ++index_it)
           destination_.set(*index_it, data_it->get());
-
-        delay_send();
       }
 
     public:
 
       Replicator(const A& source, const A destination) :
         wobj_type(source.world()), madness::Spinlock(),
-        destination_(destination), indices_(), data_(), sent_(),
-        world_(source.world()), callbacks_(), probe_(false)
+        destination_(destination), indices_(), data_(),
+        algorithm_(ReplicatorConfig::instance().algorithm()),
+        chunk_size_(ReplicatorConfig::instance().chunk_size() ?
+            ReplicatorConfig::instance().chunk_size() :
+            std::max<std::size_t>(source.pmap()->local_size(), 1ul)),
+        chunks_(0ul), sent_(), world_(source.world()), callbacks_()
       {
         sent_ = 0;
 
@@ -180,31 +327,34 @@ namespace TiledArray {
             }
         }
 
-        /// Send the data to the first node
-        delay_send();
+        /// Send the data down the broadcast tree
+        chunks_ = (data_.size() + chunk_size_ - 1ul) / chunk_size_;
+        for(std::size_t chunk = 0ul; chunk < chunks_; ++chunk)
+          delay_send(chunk);
 
         // Process any pending messages
         wobj_type::process_pending();
       }
 
-      /// Check that the replication is complete
+      /// Check that the local data has been sent
 
-      /// \return \c true when all data has been transfered.
+      /// \return \c true when all local tiles have been sent to the children
+      /// of this process in the broadcast tree
       bool done() {
         madness::ScopedMutex<madness::Spinlock> locker(this);
-        return sent_ == world_.size();
+        return std::size_t(sent_) == chunks_;
       }
 
 
       /// Add a callback
 
-      /// The callback is called when the local data has been sent to all
-      /// nodes. If the data has already been sent to all nodes, the callback
-      /// is notified immediately.
+      /// The callback is called when the local data has been sent to the
+      /// children of this process in the broadcast tree. If the data has
+      /// already been sent, the callback is notified immediately.
       /// \param callback The callback object
       void register_callback(madness::CallbackInterface* callback) {
           madness::ScopedMutex<madness::Spinlock> locker(this);
-          if(sent_ == world_.size())
+          if(std::size_t(sent_) == chunks_)
             callback->notify();
           else
             const_cast<callback_type&>(callbacks_).push(callback);
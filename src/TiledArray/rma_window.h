@@ -0,0 +1,295 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *
+ *  rma_window.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_RMA_WINDOW_H__INCLUDED
+#define TILEDARRAY_RMA_WINDOW_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/rendezvous_exchange.h>
+#include <algorithm>
+#include <climits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// One-sided access to the local tiles of a distributed object
+
+    /// The window attaches the memory of the local tiles, and of their
+    /// serialized ranges, to a dynamic MPI window, and gives every process a
+    /// directory of the addresses of all tiles. A tile owned by another
+    /// process is then read with \c MPI_Get , without involving the owner,
+    /// so the latency of a remote read does not depend on the load of the
+    /// owner. Only contiguous tiles (see \c is_rendezvous_tile ) are exposed,
+    /// and only when MPI supports \c MPI_THREAD_MULTIPLE , since the gets are
+    /// made from tasks; \c supported() checks both.
+    ///
+    /// The window holds a reference to each exposed tile, so the tiles are
+    /// exposed as they were when the window was opened: the tiles must not be
+    /// modified in place while the window is open. \c open() and \c close()
+    /// are collective.
+    /// \tparam T The tile type
+    template <typename T>
+    class RmaWindow {
+    public:
+      typedef std::size_t size_type; ///< Size type
+      typedef T value_type; ///< Tile type
+
+    private:
+      World& world_; ///< The world of the window
+#ifndef STUBOUTMPI
+      MPI_Win win_; ///< The MPI window
+#endif // STUBOUTMPI
+      bool open_; ///< The window is open
+      std::vector<value_type> tiles_; ///< The exposed local tiles
+      std::vector<unsigned char> ranges_; ///< The serialized ranges of the local tiles
+
+      /// The directory of all exposed tiles, where entry \c 4*i holds the
+      /// address of the range of tile \c i , and the next three entries hold
+      /// the size of the range, the address of the elements, and the size of
+      /// the elements, in bytes. The size of the range is zero when tile
+      /// \c i is not exposed.
+      std::vector<std::size_t> directory_;
+
+      RmaWindow(const RmaWindow&) = delete;
+      RmaWindow& operator=(const RmaWindow&) = delete;
+
+#ifndef STUBOUTMPI
+      /// Read bytes from the window of another process
+
+      /// \param[out] data The buffer that receives the bytes
+      /// \param bytes The number of bytes
+      /// \param owner The process that owns the bytes
+      /// \param address The address of the bytes in the window of \c owner
+      void read(void* const data, const std::size_t bytes,
+          const ProcessID owner, const std::size_t address) const
+      {
+        unsigned char* const buffer = static_cast<unsigned char*>(data);
+        for(std::size_t first = 0ul; first < bytes; first += std::size_t(INT_MAX)) {
+          const int count = int(std::min(bytes - first, std::size_t(INT_MAX)));
+          MPI_Get(buffer + first, count, MPI_BYTE, owner,
+              MPI_Aint(address + first), count, MPI_BYTE, win_);
+        }
+        MPI_Win_flush(owner, win_);
+      }
+
+      /// Release the local memory of the window
+      void detach() {
+        MPI_Win_unlock_all(win_);
+        if(! ranges_.empty())
+          MPI_Win_detach(win_, ranges_.data());
+        for(auto& tile : tiles_)
+          MPI_Win_detach(win_, tile.data());
+      }
+#endif // STUBOUTMPI
+
+      /// Add the local tiles that can be exposed to the window
+
+      /// \param tiles The indices and values of the local tiles
+      void attach(const std::vector<std::pair<size_type, value_type> >& tiles,
+          std::true_type)
+      {
+        // Serialize the ranges, and record their position in ranges_
+        std::vector<std::pair<size_type, std::size_t> > offsets;
+        for(const auto& tile : tiles) {
+          if(tile.second.empty() || (tile.second.range().volume() == 0ul))
+            continue;
+          std::vector<unsigned char> range;
+          rendezvous_store(tile.second.range(), range);
+          offsets.emplace_back(tile.first, ranges_.size());
+          ranges_.insert(ranges_.end(), range.begin(), range.end());
+          directory_[4ul * tile.first + 1ul] = range.size();
+          tiles_.push_back(tile.second);
+        }
+
+#ifndef STUBOUTMPI
+        if(! ranges_.empty())
+          MPI_Win_attach(win_, ranges_.data(), ranges_.size());
+        MPI_Aint base = 0;
+        MPI_Get_address(ranges_.data(), & base);
+
+        for(std::size_t t = 0ul; t < tiles_.size(); ++t) {
+          value_type& tile = tiles_[t];
+          const std::size_t bytes =
+              tile.range().volume() * sizeof(typename value_type::value_type);
+          MPI_Win_attach(win_, tile.data(), bytes);
+          MPI_Aint address = 0;
+          MPI_Get_address(tile.data(), & address);
+
+          std::size_t* const entry = directory_.data() + 4ul * offsets[t].first;
+          entry[0] = std::size_t(base) + offsets[t].second;
+          entry[2] = std::size_t(address);
+          entry[3] = bytes;
+        }
+#endif // STUBOUTMPI
+      }
+
+      /// Tiles that are not contiguous are not exposed
+      void attach(const std::vector<std::pair<size_type, value_type> >&,
+          std::false_type)
+      { }
+
+      /// Read a tile from the window of another process
+
+      /// \param i The index of the tile
+      /// \param owner The process that owns tile \c i
+      /// \return Tile \c i
+      value_type get(const size_type i, const ProcessID owner, std::true_type) const {
+        const std::size_t* const entry = directory_.data() + 4ul * i;
+        std::vector<unsigned char> range_data(entry[1]);
+#ifndef STUBOUTMPI
+        read(range_data.data(), range_data.size(), owner, entry[0]);
+#endif // STUBOUTMPI
+        typename value_type::range_type range;
+        rendezvous_load(range_data, range);
+
+        value_type tile(range);
+        TA_ASSERT(tile.range().volume() * sizeof(typename value_type::value_type)
+            == entry[3]);
+#ifndef STUBOUTMPI
+        read(tile.data(), entry[3], owner, entry[2]);
+#endif // STUBOUTMPI
+        return tile;
+      }
+
+      value_type get(const size_type, const ProcessID, std::false_type) const {
+        TA_ASSERT(false);
+        return value_type();
+      }
+
+    public:
+
+      /// Construct a closed window
+
+      /// \param world The world of the window
+      explicit RmaWindow(World& world) :
+        world_(world), open_(false), tiles_(), ranges_(), directory_()
+      { }
+
+      /// Destructor
+
+      /// \c MPI_Win_free is collective, so an open window should be closed
+      /// with \c close() before it is destroyed. Otherwise the local memory
+      /// is detached, and the MPI window is not freed.
+      ~RmaWindow() {
+#ifndef STUBOUTMPI
+        if(open_)
+          detach();
+#endif // STUBOUTMPI
+      }
+
+      /// One-sided access check
+
+      /// \param world The world of the window
+      /// \return \c true if tiles of type \c T can be read with one-sided
+      /// gets in \c world
+      static bool supported(World& world) {
+#ifndef STUBOUTMPI
+        if(! is_rendezvous_tile<value_type>::value || (world.size() == 1))
+          return false;
+        int provided = MPI_THREAD_SINGLE;
+        MPI_Query_thread(& provided);
+        return provided == MPI_THREAD_MULTIPLE;
+#else
+        return false;
+#endif // STUBOUTMPI
+      }
+
+      /// Open the window
+
+      /// The local tiles are attached to the window, and the directory of
+      /// the tiles of all processes is assembled. This is collective.
+      /// \param tiles The indices and values of the local tiles
+      /// \param max_size The number of tiles of all processes
+      /// \note \c supported() must be \c true .
+      void open(const std::vector<std::pair<size_type, value_type> >& tiles,
+          const size_type max_size)
+      {
+        TA_ASSERT(! open_);
+        TA_ASSERT(supported(world_));
+        directory_.assign(4ul * max_size, 0ul);
+#ifndef STUBOUTMPI
+        MPI_Win_create_dynamic(MPI_INFO_NULL, world_.mpi.comm().Get_mpi_comm(), & win_);
+#endif // STUBOUTMPI
+        attach(tiles, std::integral_constant<bool, is_rendezvous_tile<value_type>::value>());
+#ifndef STUBOUTMPI
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, win_);
+#endif // STUBOUTMPI
+
+        // Each entry is only set by the owner of its tile; the sum also
+        // ensures that all tiles are attached before they are read.
+        world_.gop.sum(directory_.data(), directory_.size());
+        open_ = true;
+      }
+
+      /// Close the window
+
+      /// The gets of all processes must be complete. This is collective.
+      void close() {
+        TA_ASSERT(open_);
+#ifndef STUBOUTMPI
+        detach();
+        MPI_Win_free(& win_);
+#endif // STUBOUTMPI
+        open_ = false;
+        tiles_.clear();
+        ranges_.clear();
+        directory_.clear();
+      }
+
+      /// \return \c true if the window is open
+      bool is_open() const { return open_; }
+
+      /// Tile exposure check
+
+      /// \param i The index of a tile
+      /// \return \c true if tile \c i can be read from the window
+      bool has(const size_type i) const {
+        return open_ && (directory_[4ul * i + 1ul] != 0ul);
+      }
+
+      /// Read a tile
+
+      /// The tile is read from the window of its owner; the calling thread
+      /// waits until the tile is received.
+      /// \param i The index of a tile, which must be exposed
+      /// \param owner The process that owns tile \c i
+      /// \return Tile \c i
+      value_type get(const size_type i, const ProcessID owner) const {
+        TA_ASSERT(has(i));
+        return get(i, owner,
+            std::integral_constant<bool, is_rendezvous_tile<value_type>::value>());
+      }
+
+    }; // class RmaWindow
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_RMA_WINDOW_H__INCLUDED
@@ -0,0 +1,300 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  shm_exchange.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_SHM_EXCHANGE_H__INCLUDED
+#define TILEDARRAY_SHM_EXCHANGE_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/proc_topology.h>
+#include <TiledArray/tensor/wire_codec.h>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/// The minimum size (in bytes) of tiles that are exchanged in shared memory
+#ifndef TILEDARRAY_SHM_EXCHANGE_THRESHOLD
+#define TILEDARRAY_SHM_EXCHANGE_THRESHOLD 65536ul
+#endif // TILEDARRAY_SHM_EXCHANGE_THRESHOLD
+
+namespace TiledArray {
+
+  /// Shared memory tile exchange policy
+
+  /// When the shared memory exchange is enabled, tiles that are sent between
+  /// processes on the same node are written into a POSIX shared memory
+  /// segment by the sender and read directly from that segment by the
+  /// receivers. Only the name of the segment is sent through MPI. This is
+  /// used for remote \c DistributedStorage gets and for SUMMA broadcasts
+  /// where all processes of the broadcast group share a node. Tiles smaller
+  /// than \c TILEDARRAY_SHM_EXCHANGE_THRESHOLD bytes are sent with the
+  /// message. The exchange is disabled by default; it is enabled with
+  /// \c enable() or by setting the \c TA_SHM_EXCHANGE environment variable.
+  /// \note The exchange must be enabled or disabled on all processes, and
+  /// only affects distributed objects that are constructed afterwards.
+  class ShmExchange {
+    bool enabled_; ///< Exchange flag
+
+    ShmExchange() : enabled_(getenv("TA_SHM_EXCHANGE") != nullptr) { }
+
+    ShmExchange(const ShmExchange&) = delete;
+    ShmExchange& operator=(const ShmExchange&) = delete;
+
+  public:
+
+    /// Exchange policy accessor
+
+    /// \return A reference to the exchange policy of this process
+    static ShmExchange& instance() {
+      static ShmExchange* const exchange = new ShmExchange();
+      return *exchange;
+    }
+
+    /// Enable the shared memory exchange
+    void enable() { enabled_ = true; }
+
+    /// Disable the shared memory exchange
+    void disable() { enabled_ = false; }
+
+    /// Exchange status
+
+    /// \return \c true if the shared memory exchange is enabled
+    bool enabled() const { return enabled_; }
+
+  }; // class ShmExchange
+
+  namespace detail {
+
+    /// Topology used by the shared memory exchange
+
+    /// \param world The world of the distributed object
+    /// \return The topology of \c world , or a null pointer if the shared
+    /// memory exchange is disabled or each process is on a separate node
+    /// \note This is a collective operation the first time it is called with
+    /// the exchange enabled.
+    inline std::shared_ptr<const ProcTopology> shm_topology(World& world) {
+      if((world.size() == 1) || (! ShmExchange::instance().enabled()))
+        return std::shared_ptr<const ProcTopology>();
+      std::shared_ptr<const ProcTopology> result = ProcTopology::get(world);
+      for(ProcessID p = 0; p < world.size(); ++p)
+        if(result->node(p) != ProcessID(p))
+          return result;
+      return std::shared_ptr<const ProcTopology>();
+    }
+
+    /// A tile that is held in shared memory
+
+    /// The handle holds the name of the shared memory segment, or, for small
+    /// tiles, the serialized tile.
+    struct ShmHandle {
+      std::string name; ///< The segment name, which is empty when the tile is held by \c data
+      std::size_t size; ///< The size of the serialized tile
+      std::vector<unsigned char> data; ///< The serialized data of small tiles
+
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & name & size & data; }
+    }; // struct ShmHandle
+
+    /// The header of a shared memory segment
+    struct ShmHeader {
+      std::atomic<int> readers; ///< The number of processes that have not read the tile
+    }; // struct ShmHeader
+
+    /// The offset of the tile data in a shared memory segment
+    constexpr std::size_t shm_data_offset = 64ul;
+
+    /// Write a tile for other processes on this node
+
+    /// \tparam T The tile type
+    /// \param tile The tile to be written
+    /// \param readers The number of processes that will read the tile
+    /// \return The handle of the tile
+    /// \throw TiledArray::Exception When the shared memory segment cannot be
+    /// created
+    template <typename T>
+    ShmHandle shm_write(const T& tile, const int readers) {
+      madness::archive::BufferOutputArchive count_ar;
+      count_ar & tile;
+
+      ShmHandle handle;
+      handle.size = count_ar.size();
+
+      if(handle.size < TILEDARRAY_SHM_EXCHANGE_THRESHOLD) {
+        handle.data.resize(handle.size);
+        madness::archive::BufferOutputArchive ar(handle.data.data(), handle.size);
+        ar & tile;
+        return handle;
+      }
+
+      static madness::AtomicInt count;
+      std::stringstream ss;
+      ss << "/ta_shm." << getpid() << "." << count++;
+      handle.name = ss.str();
+
+      const std::size_t size = shm_data_offset + handle.size;
+      const int fd = shm_open(handle.name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+      if(fd < 0)
+        TA_EXCEPTION("shm_write(): Unable to create a shared memory segment.");
+      if(ftruncate(fd, size) != 0) {
+        close(fd);
+        shm_unlink(handle.name.c_str());
+        TA_EXCEPTION("shm_write(): Unable to resize a shared memory segment.");
+      }
+      void* const pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+      if(pointer == MAP_FAILED) {
+        shm_unlink(handle.name.c_str());
+        TA_EXCEPTION("shm_write(): Unable to map a shared memory segment.");
+      }
+
+      unsigned char* const data = static_cast<unsigned char*>(pointer);
+      new(data) ShmHeader{ { readers } };
+      madness::archive::BufferOutputArchive ar(data + shm_data_offset, handle.size);
+      ar & tile;
+      munmap(pointer, size);
+
+      return handle;
+    }
+
+    /// Read a tile written by another process on this node
+
+    /// The shared memory segment is removed by the last reader.
+    /// \tparam T The tile type
+    /// \param handle The handle of the tile
+    /// \return The tile
+    /// \throw TiledArray::Exception When the shared memory segment cannot be
+    /// opened
+    template <typename T>
+    T shm_read(const ShmHandle& handle) {
+      T tile;
+
+      if(handle.name.empty()) {
+        madness::archive::BufferInputArchive ar(handle.data.data(), handle.size);
+        ar & tile;
+        return tile;
+      }
+
+      const std::size_t size = shm_data_offset + handle.size;
+      const int fd = shm_open(handle.name.c_str(), O_RDWR, 0600);
+      if(fd < 0)
+        TA_EXCEPTION("shm_read(): Unable to open a shared memory segment.");
+      void* const pointer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      close(fd);
+      if(pointer == MAP_FAILED)
+        TA_EXCEPTION("shm_read(): Unable to map a shared memory segment.");
+
+      unsigned char* const data = static_cast<unsigned char*>(pointer);
+      madness::archive::BufferInputArchive ar(data + shm_data_offset, handle.size);
+      ar & tile;
+
+      if(--reinterpret_cast<ShmHeader*>(data)->readers == 0)
+        shm_unlink(handle.name.c_str());
+      munmap(pointer, size);
+
+      return tile;
+    }
+
+    /// Check that a group is inside a node
+
+    /// \param topology The process topology
+    /// \param group The process group
+    /// \return \c true if all processes of \c group share a node
+    inline bool shm_group(const ProcTopology& topology, const madness::Group& group) {
+      const ProcessID node = topology.node(group.world_rank(0));
+      for(ProcessID p = 1; p < group.size(); ++p)
+        if(topology.node(group.world_rank(p)) != node)
+          return false;
+      return true;
+    }
+
+    /// Broadcast a tile between nodes
+
+    /// When the wire codec is enabled (see \c WireCodec ), the tile is encoded
+    /// by the root process, and decoded by the other processes.
+    /// \tparam T The tile type
+    /// \param world The world of the group
+    /// \param key The broadcast key
+    /// \param tile The tile, which is set on processes other than the root
+    /// \param root The root process of the broadcast, in \c group
+    /// \param group The broadcast group
+    template <typename T>
+    void wire_bcast(World& world, const madness::DistributedID& key,
+        Future<T>& tile, const ProcessID root, const madness::Group& group)
+    {
+      if(is_wire_tile<T>::value && WireCodec::instance().enabled()) {
+        Future<WireTile<T> > wire = (group.rank() == root ?
+            world.taskq.add(& wire_pack<T>, tile, madness::TaskAttributes::hipri()) :
+            Future<WireTile<T> >());
+        world.gop.bcast(key, wire, root, group);
+        if(group.rank() != root)
+          tile.set(world.taskq.add(& wire_unpack<T>, wire,
+              madness::TaskAttributes::hipri()));
+      } else {
+        world.gop.bcast(key, tile, root, group);
+      }
+    }
+
+    /// Broadcast a tile
+
+    /// When \c topology is not null and all members of \c group share a node,
+    /// the tile is written to shared memory by the root process and only its
+    /// handle is broadcast. Otherwise the tile is broadcast with
+    /// \c wire_bcast() .
+    /// \tparam T The tile type
+    /// \param world The world of the group
+    /// \param key The broadcast key
+    /// \param tile The tile, which is set on processes other than the root
+    /// \param root The root process of the broadcast, in \c group
+    /// \param group The broadcast group
+    /// \param topology The process topology used for the shared memory exchange
+    template <typename T>
+    void shm_bcast(World& world, const madness::DistributedID& key,
+        Future<T>& tile, const ProcessID root, const madness::Group& group,
+        const ProcTopology* const topology)
+    {
+      if(topology && shm_group(*topology, group)) {
+        Future<ShmHandle> handle = (group.rank() == root ?
+            world.taskq.add(& shm_write<T>, tile, int(group.size() - 1)) :
+            Future<ShmHandle>());
+        world.gop.bcast(key, handle, root, group);
+        if(group.rank() != root)
+          tile.set(world.taskq.add(& shm_read<T>, handle));
+      } else {
+        wire_bcast(world, key, tile, root, group);
+      }
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SHM_EXCHANGE_H__INCLUDED
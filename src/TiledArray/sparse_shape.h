@@ -32,9 +32,118 @@
 #include <TiledArray/tensor/shift_wrapper.h>
 #include <TiledArray/tensor/tensor_interface.h>
 #include <typeinfo>
+#include <numeric>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+
+/* The smallest m*n*k of a shape contraction that is divided among processes. */
+#ifndef TILEDARRAY_SHAPE_GEMM_COOPERATIVE_THRESHOLD
+#define TILEDARRAY_SHAPE_GEMM_COOPERATIVE_THRESHOLD 67108864l
+#endif // TILEDARRAY_SHAPE_GEMM_COOPERATIVE_THRESHOLD
 
 namespace TiledArray {
 
+  namespace detail {
+
+    /// Gather sparse data from all processes
+
+    /// \tparam T The value type
+    /// \param world The world where the data is gathered
+    /// \param[in,out] ordinals The local ordinals on input, and the
+    /// concatenation of the ordinals of all processes on output
+    /// \param[in,out] values The local values on input, and the concatenation
+    /// of the values of all processes on output
+    /// \param counts The number of local elements of each process
+    template <typename T>
+    void all_gather_sparse(World& world, std::vector<std::size_t>& ordinals,
+        std::vector<T>& values, const std::vector<std::size_t>& counts)
+    {
+      TA_ASSERT(ordinals.size() == values.size());
+      TA_ASSERT(counts.size() == std::size_t(world.size()));
+      TA_ASSERT(counts[world.rank()] == ordinals.size());
+
+      // Compute the offset of the local data in the concatenated data
+      const std::size_t offset = std::accumulate(counts.begin(),
+          counts.begin() + world.rank(), std::size_t(0));
+      const std::size_t total = std::accumulate(
+          counts.begin() + world.rank(), counts.end(), offset);
+
+      // Concatenate the data with a sum, where each process contributes its
+      // own segment
+      std::vector<std::size_t> all_ordinals(total, 0ul);
+      std::vector<T> all_values(total, T(0));
+      std::copy(ordinals.begin(), ordinals.end(), all_ordinals.begin() + offset);
+      std::copy(values.begin(), values.end(), all_values.begin() + offset);
+      if(total > 0ul) {
+        world.gop.sum(all_ordinals.data(), total);
+        world.gop.sum(all_values.data(), total);
+      }
+
+      ordinals.swap(all_ordinals);
+      values.swap(all_values);
+    }
+
+    /// Gather sparse data from all processes
+
+    /// \tparam T The value type
+    /// \param world The world where the data is gathered
+    /// \param[in,out] ordinals The local ordinals on input, and the
+    /// concatenation of the ordinals of all processes on output
+    /// \param[in,out] values The local values on input, and the concatenation
+    /// of the values of all processes on output
+    template <typename T>
+    void all_gather_sparse(World& world, std::vector<std::size_t>& ordinals,
+        std::vector<T>& values)
+    {
+      std::vector<std::size_t> counts(world.size(), 0ul);
+      counts[world.rank()] = ordinals.size();
+      world.gop.sum(counts.data(), counts.size());
+      all_gather_sparse(world, ordinals, values, counts);
+    }
+
+    /// Sum a mostly-zero buffer over all processes
+
+    /// When the non-zero elements of all processes, together with their
+    /// ordinals, are smaller than the buffer, only the non-zero elements are
+    /// exchanged. Otherwise, the whole buffer is summed as with
+    /// \c world.gop.sum .
+    /// \tparam T The value type
+    /// \param world The world where the buffer is summed
+    /// \param[in,out] data The local buffer on input, and the sum of the
+    /// buffers of all processes on output
+    /// \param n The number of elements in \c data
+    template <typename T>
+    void sparse_allreduce(World& world, T* const data, const std::size_t n) {
+      // Collect the non-zero local elements
+      std::vector<std::size_t> ordinals;
+      std::vector<T> values;
+      for(std::size_t i = 0ul; i < n; ++i) {
+        if(data[i] != T(0)) {
+          ordinals.push_back(i);
+          values.push_back(data[i]);
+        }
+      }
+
+      // Choose the smaller exchange
+      std::vector<std::size_t> counts(world.size(), 0ul);
+      counts[world.rank()] = ordinals.size();
+      world.gop.sum(counts.data(), counts.size());
+      const std::size_t total =
+          std::accumulate(counts.begin(), counts.end(), std::size_t(0));
+      if(total * (sizeof(std::size_t) + sizeof(T)) >= n * sizeof(T)) {
+        world.gop.sum(data, n);
+        return;
+      }
+
+      all_gather_sparse(world, ordinals, values, counts);
+      std::fill_n(data, n, T(0));
+      for(std::size_t i = 0ul; i < total; ++i)
+        data[ordinals[i]] += values[i];
+    }
+
+  } // namespace detail
+
   /// Arbitrary sparse shape
 
   /// Sparse shape uses a \c Tensor of Frobenius norms to estimate the magnitude
@@ -47,6 +156,15 @@ namespace TiledArray {
   /// where \f$ij...\f$ are tile indices, \f$\|A_{ij}\|\f$ is norm of tile
   /// \f$ij...\f$, and \f$N_i N_j ...\f$ is the product of tile \f$ij...\f$ in
   /// each dimension.
+  ///
+  /// Optionally, the shape may also hold <em>split norms</em>, which are
+  /// normalized upper bounds on the spectral norm of each tile matricized with
+  /// its first \c s modes as rows, for \c s in <tt>[1, rank)</tt>. Since the
+  /// spectral norm of a matrix is never larger than its Frobenius norm,
+  /// SparseShape<T>::gemm uses them to compute a tighter bound on the norm of
+  /// the result tiles, and \c Summa uses them to skip tile contractions that
+  /// are negligible. Split norms are computed from tile data with
+  /// SparseShape<T>::split_norm .
   /// \tparam T The sparse element value type
   /// \note Scaling operations, such as SparseShape<T>::scale , SparseShape<T>::gemm , etc.
   ///       accept generic scaling factors; internally (modulus of) the scaling factor is first
@@ -72,7 +190,9 @@ namespace TiledArray {
     Tensor<value_type> tile_norms_; ///< Tile magnitude data
     std::shared_ptr<vector_type> size_vectors_; ///< Tile size information; size_vectors_[d][i] reports the size of i-th tile in dimension d
     size_type zero_tile_count_; ///< Number of zero tiles
-    static value_type threshold_; ///< The zero threshold
+    std::shared_ptr<std::vector<Tensor<value_type> > > split_norms_; ///< Split norm data; split_norms_[s-1] holds the split norms for split \c s
+    value_type zero_threshold_; ///< The zero threshold of this shape
+    static value_type threshold_; ///< The default zero threshold
 
     template <typename Op>
     static vector_type
@@ -107,20 +227,15 @@ namespace TiledArray {
     /// tile. If the normalized norm is less than threshold, the value is set to
     /// zero.
     void normalize() {
-      const value_type threshold = threshold_;
+      const value_type threshold = zero_threshold_;
       const unsigned int dim = tile_norms_.range().rank();
       const vector_type* MADNESS_RESTRICT const size_vectors = size_vectors_.get();
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
 
       if(dim == 1u) {
-        auto normalize_op = [threshold, &zero_tile_count] (value_type& norm, const value_type size) {
+        auto normalize_op = [threshold] (value_type& norm, const value_type size) {
           TA_ASSERT(norm >= value_type(0));
           norm /= size;
-          if(norm < threshold) {
-            norm = value_type(0);
-            ++zero_tile_count;
-          }
+          norm = hard_zero(norm, threshold);
         };
 
         // This is the easy case where the data is a vector and can be
@@ -143,22 +258,50 @@ namespace TiledArray {
         const vector_type left = recursive_outer_product(size_vectors, middle, inv_vec_op);
         const vector_type right = recursive_outer_product(size_vectors + middle, dim - middle, inv_vec_op);
 
-        auto normalize_op = [threshold, &zero_tile_count] (value_type& norm,
+        auto normalize_op = [threshold] (value_type& norm,
             const value_type x, const value_type y)
         {
           TA_ASSERT(norm >= value_type(0));
           norm *= x * y;
-          if(norm < threshold) {
-            norm = value_type(0);
-            ++zero_tile_count;
-          }
+          norm = hard_zero(norm, threshold);
         };
 
         math::outer(left.size(), right.size(), left.data(), right.data(),
             tile_norms_.data(), normalize_op);
       }
 
-      zero_tile_count_ = zero_tile_count;
+      zero_tile_count_ = zero_count(tile_norms_, zero_threshold_);
+    }
+
+    /// Normalize split norms
+
+    /// This function will divide each split norm by the number of elements in
+    /// the tile, and limit it to the normalized Frobenius norm of the tile.
+    /// \note This function must be called after \c normalize() .
+    void normalize_split_norms() {
+      const auto& range = tile_norms_.range();
+      const unsigned int dim = range.rank();
+      const vector_type* MADNESS_RESTRICT const size_vectors = size_vectors_.get();
+
+      TA_ASSERT(split_norms_->size() == (dim - 1u));
+      for(Tensor<value_type>& split_norms : *split_norms_) {
+        TA_ASSERT(split_norms.range() == range);
+        for(size_type i = 0ul; i < range.volume(); ++i) {
+          const value_type norm = tile_norms_[i];
+          if(norm == value_type(0)) {
+            split_norms[i] = value_type(0);
+            continue;
+          }
+
+          // Compute the number of elements in the tile
+          const auto index = range.idx(i);
+          value_type volume = 1;
+          for(unsigned int d = 0u; d < dim; ++d)
+            volume *= size_vectors[d][index[d] - range.lobound(d)];
+
+          split_norms[i] = std::min(split_norms[i] / volume, norm);
+        }
+      }
     }
 
     static std::shared_ptr<vector_type>
@@ -197,17 +340,101 @@ namespace TiledArray {
     }
 
     SparseShape(const Tensor<T>& tile_norms, const std::shared_ptr<vector_type>& size_vectors,
-        const size_type zero_tile_count) :
+        const size_type zero_tile_count, const value_type zero_threshold,
+        const std::shared_ptr<std::vector<Tensor<value_type> > >& split_norms =
+            std::shared_ptr<std::vector<Tensor<value_type> > >()) :
       tile_norms_(tile_norms), size_vectors_(size_vectors),
-      zero_tile_count_(zero_tile_count)
+      zero_tile_count_(zero_tile_count), split_norms_(split_norms),
+      zero_threshold_(zero_threshold)
     { }
 
+    /// Deep copy split norm data
+
+    /// \param split_norms The split norms of each split
+    /// \return A pointer to a copy of \c split_norms
+    static std::shared_ptr<std::vector<Tensor<value_type> > >
+    clone_split_norms(const std::vector<Tensor<value_type> >& split_norms) {
+      std::shared_ptr<std::vector<Tensor<value_type> > > result =
+          std::make_shared<std::vector<Tensor<value_type> > >();
+      result->reserve(split_norms.size());
+      for(const Tensor<value_type>& norms : split_norms)
+        result->push_back(norms.clone());
+      return result;
+    }
+
+    /// Apply the zero threshold to a norm
+
+    /// This is branch free, so that the thresholding loops of the shape
+    /// operations can be vectorized.
+    /// \param norm The norm
+    /// \param threshold The zero threshold
+    /// \return \c norm , or zero if \c norm is below \c threshold
+    static value_type hard_zero(const value_type norm, const value_type threshold) {
+      return (norm < threshold ? value_type(0) : norm);
+    }
+
+    /// Count the zero norms
+
+    /// The shape operations count the zero tiles with this reduction after
+    /// the norms are thresholded, instead of incrementing a shared counter
+    /// from the (parallel) thresholding loops.
+    /// \param norms The thresholded norms
+    /// \param threshold The zero threshold
+    /// \return The number of norms in \c norms that are below \c threshold
+    static size_type zero_count(const Tensor<value_type>& norms,
+        const value_type threshold)
+    {
+      size_type result = 0ul;
+      math::reduce_op([threshold] (size_type& count, const value_type norm)
+          { count += (norm < threshold ? 1ul : 0ul); },
+          [] (size_type& count, const size_type other) { count += other; },
+          size_type(0ul), norms.range().volume(), result, norms.data());
+      return result;
+    }
+
+    /// Set the norms below a threshold to zero
+
+    /// \param thresh The norms below \c thresh are set to zero
+    /// \param zero_threshold The zero threshold of the result
+    /// \return A copy of this shape with the truncated norms
+    SparseShape_ truncate(const value_type thresh,
+        const value_type zero_threshold) const
+    {
+      Tensor<value_type> result_tile_norms = tile_norms_.unary(
+          [thresh] (const value_type norm) { return hard_zero(norm, thresh); });
+
+      std::shared_ptr<std::vector<Tensor<value_type> > > result_split_norms;
+      if(split_norms_) {
+        result_split_norms = std::make_shared<std::vector<Tensor<value_type> > >();
+        result_split_norms->reserve(split_norms_->size());
+        for(const Tensor<value_type>& norms : *split_norms_)
+          result_split_norms->push_back(norms.binary(result_tile_norms,
+              [] (const value_type value, const value_type norm)
+              { return (norm > value_type(0) ? value : value_type(0)); }));
+      }
+
+      return SparseShape_(result_tile_norms, size_vectors_,
+          zero_count(result_tile_norms, zero_threshold), zero_threshold,
+          result_split_norms);
+    }
+
+    /// Zero threshold of the result of a binary operation
+
+    /// \param other The other argument of the operation
+    /// \return The larger of the zero thresholds of this shape and \c other
+    value_type result_threshold(const SparseShape_& other) const {
+      return std::max(zero_threshold_, other.zero_threshold_);
+    }
+
   public:
 
     /// Default constructor
 
     /// Construct a shape with no data.
-    SparseShape() : tile_norms_(), size_vectors_(), zero_tile_count_(0ul) { }
+    SparseShape() :
+      tile_norms_(), size_vectors_(), zero_tile_count_(0ul), split_norms_(),
+      zero_threshold_(threshold_)
+    { }
 
     /// Constructor
 
@@ -216,9 +443,11 @@ namespace TiledArray {
     /// tile.
     /// \param tile_norms The Frobenius norm of tiles
     /// \param trange The tiled range of the tensor
-    SparseShape(const Tensor<value_type>& tile_norms, const TiledRange& trange) :
+    /// \param zero_threshold The zero threshold of the shape
+    SparseShape(const Tensor<value_type>& tile_norms, const TiledRange& trange,
+        const value_type zero_threshold = threshold_) :
       tile_norms_(tile_norms.clone()), size_vectors_(initialize_size_vectors(trange)),
-      zero_tile_count_(0ul)
+      zero_tile_count_(0ul), zero_threshold_(zero_threshold)
     {
       TA_ASSERT(! tile_norms_.empty());
       TA_ASSERT(tile_norms_.range() == trange.tiles_range());
@@ -226,6 +455,32 @@ namespace TiledArray {
       normalize();
     }
 
+    /// Constructor with split norms
+
+    /// This constructor will normalize the tile norms and split norms, where
+    /// the normalization constant for each tile is the inverse of the number
+    /// of elements in the tile.
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param split_norms The split norms of tiles, where
+    /// <tt>split_norms[s-1]</tt> holds the split norms for split \c s (see
+    /// SparseShape<T>::split_norm ), for \c s in <tt>[1, rank)</tt>
+    /// \param trange The tiled range of the tensor
+    /// \param zero_threshold The zero threshold of the shape
+    SparseShape(const Tensor<value_type>& tile_norms,
+        const std::vector<Tensor<value_type> >& split_norms, const TiledRange& trange,
+        const value_type zero_threshold = threshold_) :
+      tile_norms_(tile_norms.clone()), size_vectors_(initialize_size_vectors(trange)),
+      zero_tile_count_(0ul), split_norms_(clone_split_norms(split_norms)),
+      zero_threshold_(zero_threshold)
+    {
+      TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(tile_norms_.range() == trange.tiles_range());
+      TA_ASSERT(split_norms_->size() == (trange.tiles_range().rank() - 1u));
+
+      normalize();
+      normalize_split_norms();
+    }
+
     /// "Sparse" constructor
 
     /// This constructor uses tile norms given as a sparse tensor,
@@ -236,11 +491,13 @@ namespace TiledArray {
     ///         where \c index is a directly-addressable sequence indices.
     /// \param tile_norms The Frobenius norm of tiles
     /// \param trange The tiled range of the tensor
+    /// \param zero_threshold The zero threshold of the shape
     template<typename SparseNormSequence>
     SparseShape(const SparseNormSequence& tile_norms,
-                const TiledRange& trange) :
+                const TiledRange& trange,
+                const value_type zero_threshold = threshold_) :
       tile_norms_(trange.tiles_range(), value_type(0)), size_vectors_(initialize_size_vectors(trange)),
-      zero_tile_count_(trange.tiles_range().volume())
+      zero_tile_count_(trange.tiles_range().volume()), zero_threshold_(zero_threshold)
     {
       const auto dim = tile_norms_.range().rank();
       for(const auto& pair_idx_norm: tile_norms) {
@@ -251,7 +508,7 @@ namespace TiledArray {
           return tile_volume;
         };
         auto norm_per_element = pair_idx_norm.second / compute_tile_volume();
-        if (norm_per_element >= threshold()) {
+        if (norm_per_element >= zero_threshold_) {
           tile_norms_[pair_idx_norm.first] = norm_per_element;
           --zero_tile_count_;
         }
@@ -268,38 +525,126 @@ namespace TiledArray {
     /// \param world The world where the shape will live
     /// \param tile_norms The Frobenius norm of tiles
     /// \param trange The tiled range of the tensor
+    /// \param zero_threshold The zero threshold of the shape
+    SparseShape(World& world, const Tensor<value_type>& tile_norms,
+                const TiledRange& trange,
+                const value_type zero_threshold = threshold_) :
+      tile_norms_(tile_norms.clone()), size_vectors_(initialize_size_vectors(trange)),
+      zero_tile_count_(0ul), zero_threshold_(zero_threshold)
+    {
+      TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(tile_norms_.range() == trange.tiles_range());
+
+      // reduce norm data from all processors
+      detail::sparse_allreduce(world, tile_norms_.data(), tile_norms_.size());
+
+      normalize();
+    }
+
+    /// Collective constructor with split norms
+
+    /// The tile norms and split norms are summed across all processes (via an
+    /// all reduce) and then normalized, where the normalization constant for
+    /// each tile is the inverse of the number of elements in the tile.
+    /// \param world The world where the shape will live
+    /// \param tile_norms The Frobenius norm of tiles
+    /// \param split_norms The split norms of tiles, where
+    /// <tt>split_norms[s-1]</tt> holds the split norms for split \c s (see
+    /// SparseShape<T>::split_norm ), for \c s in <tt>[1, rank)</tt>
+    /// \param trange The tiled range of the tensor
+    /// \param zero_threshold The zero threshold of the shape
     SparseShape(World& world, const Tensor<value_type>& tile_norms,
-                const TiledRange& trange) :
+        const std::vector<Tensor<value_type> >& split_norms, const TiledRange& trange,
+        const value_type zero_threshold = threshold_) :
       tile_norms_(tile_norms.clone()), size_vectors_(initialize_size_vectors(trange)),
-      zero_tile_count_(0ul)
+      zero_tile_count_(0ul), split_norms_(clone_split_norms(split_norms)),
+      zero_threshold_(zero_threshold)
     {
       TA_ASSERT(! tile_norms_.empty());
       TA_ASSERT(tile_norms_.range() == trange.tiles_range());
+      TA_ASSERT(split_norms_->size() == (trange.tiles_range().rank() - 1u));
 
       // reduce norm data from all processors
-      world.gop.sum(tile_norms_.data(), tile_norms_.size());
+      detail::sparse_allreduce(world, tile_norms_.data(), tile_norms_.size());
+      for(Tensor<value_type>& norms : *split_norms_)
+        detail::sparse_allreduce(world, norms.data(), norms.size());
 
       normalize();
+      normalize_split_norms();
     }
 
     /// Collective "sparse" constructor
 
     /// This constructor uses tile norms given as a sparse tensor,
     /// represented as a sequence of {index,value_type} data.
-    /// The tile norms are normalized to per-element norms by dividing each
-    /// norm by the number of elements in the corresponding tile.
-    /// Lastly, he norms are sum-reduced across all processors.
+    /// Only the given norms are exchanged among processes, and the norms of
+    /// tiles that are given by more than one process are summed. Next, the
+    /// norms are converted to per-element norms by dividing each norm by the
+    /// number of elements in the corresponding tile.
     /// \tparam SparseNormSequence the sequence of \c std::pair<index,value_type> objects,
     ///         where \c index is a directly-addressable sequence of integers.
     /// \param world The world where the shape will live
     /// \param tile_norms The Frobenius norm of tiles
     /// \param trange The tiled range of the tensor
+    /// \param zero_threshold The zero threshold of the shape
     template<typename SparseNormSequence>
     SparseShape(World& world,
                 const SparseNormSequence& tile_norms,
-                const TiledRange& trange) : SparseShape(tile_norms, trange)
+                const TiledRange& trange,
+                const value_type zero_threshold = threshold_) :
+      tile_norms_(trange.tiles_range(), value_type(0)), size_vectors_(initialize_size_vectors(trange)),
+      zero_tile_count_(0ul), zero_threshold_(zero_threshold)
     {
-      world.gop.sum(tile_norms_.data(), tile_norms_.size());
+      // Gather the norms of all processors
+      std::vector<std::size_t> ordinals;
+      std::vector<value_type> norms;
+      for(const auto& pair_idx_norm: tile_norms) {
+        ordinals.push_back(tile_norms_.range().ordinal(pair_idx_norm.first));
+        norms.push_back(pair_idx_norm.second);
+      }
+      detail::all_gather_sparse(world, ordinals, norms);
+
+      for(std::size_t i = 0ul; i < ordinals.size(); ++i)
+        tile_norms_[ordinals[i]] += norms[i];
+
+      normalize();
+    }
+
+    /// Load constructor
+
+    /// Read a shape that was written with \c serialize , e.g. by
+    /// <tt>ar & shape</tt> , together with its zero threshold, so a shape
+    /// that does not change between jobs is constructed without computing
+    /// the norms of the tiles and without communication.
+    /// \code
+    /// madness::archive::BinaryFstreamInputArchive ar("v.shape");
+    /// TiledArray::SparseShape<float> shape(trange, ar);
+    /// \endcode
+    /// \tparam Archive The input archive type
+    /// \param trange The tiled range of the tensor
+    /// \param ar The input archive
+    /// \throw TiledArray::Exception When the archive does not hold a shape
+    /// with the tiled range \c trange
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    SparseShape(const TiledRange& trange, const Archive& ar) :
+      tile_norms_(), size_vectors_(), zero_tile_count_(0ul), split_norms_(),
+      zero_threshold_(threshold_)
+    {
+      serialize(ar);
+
+      TA_USER_ASSERT(! tile_norms_.empty(),
+          "SparseShape::SparseShape(): The archive holds an empty shape.");
+      TA_USER_ASSERT(tile_norms_.range() == trange.tiles_range(),
+          "SparseShape::SparseShape(): The shape does not match the tiles range.");
+      for(unsigned int d = 0u; d < trange.tiles_range().rank(); ++d) {
+        const vector_type& size_vector = size_vectors_.get()[d];
+        auto tile = trange.data()[d].begin();
+        for(std::size_t i = 0ul; i < size_vector.size(); ++i, ++tile)
+          TA_USER_ASSERT(size_vector[i] == value_type(tile->second - tile->first),
+              "SparseShape::SparseShape(): The shape does not match the tile sizes.");
+      }
     }
 
     /// Copy constructor
@@ -308,7 +653,8 @@ namespace TiledArray {
     /// \param other The other shape object to be copied
     SparseShape(const SparseShape<T>& other) :
       tile_norms_(other.tile_norms_), size_vectors_(other.size_vectors_),
-      zero_tile_count_(other.zero_tile_count_)
+      zero_tile_count_(other.zero_tile_count_), split_norms_(other.split_norms_),
+      zero_threshold_(other.zero_threshold_)
     { }
 
     /// Copy assignment operator
@@ -320,6 +666,8 @@ namespace TiledArray {
       tile_norms_ = other.tile_norms_;
       size_vectors_ = other.size_vectors_;
       zero_tile_count_ = other.zero_tile_count_;
+      split_norms_ = other.split_norms_;
+      zero_threshold_ = other.zero_threshold_;
       return *this;
     }
 
@@ -339,7 +687,7 @@ namespace TiledArray {
     template <typename Index>
     bool is_zero(const Index& i) const {
       TA_ASSERT(! tile_norms_.empty());
-      return tile_norms_[i] < threshold_;
+      return tile_norms_[i] < zero_threshold_;
     }
 
     /// Check density
@@ -355,16 +703,86 @@ namespace TiledArray {
       return float(zero_tile_count_) / float(tile_norms_.size());
     }
 
-    /// Threshold accessor
+    /// Default threshold accessor
 
-    /// \return The current threshold
+    /// \return The default zero threshold of new shapes
     static value_type threshold() { return threshold_; }
 
-    /// Set threshold to \c thresh
+    /// Set the default threshold to \c thresh
 
-    /// \param thresh The new threshold
+    /// The default threshold is used by shapes constructed after this call,
+    /// the threshold of existing shapes is not changed.
+    /// \param thresh The new default threshold
     static void threshold(const value_type thresh) { threshold_ = thresh; }
 
+    /// Zero threshold accessor
+
+    /// Tiles with a normalized norm below the zero threshold of the shape are
+    /// zero. The result of an operation on shapes uses the larger (looser) of
+    /// the thresholds of its arguments, since it is not more accurate than its
+    /// least accurate argument.
+    /// \return The zero threshold of this shape
+    value_type zero_threshold() const { return zero_threshold_; }
+
+    /// Copy this shape with a different zero threshold
+
+    /// The norms below \c thresh are set to zero. Tiles that are already zero
+    /// are not restored by a smaller threshold.
+    /// \param thresh The zero threshold of the result
+    /// \return A copy of this shape with the zero threshold \c thresh
+    SparseShape_ with_threshold(const value_type thresh) const {
+      TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(thresh >= value_type(0));
+      return truncate(thresh, thresh);
+    }
+
+    /// Error-controlled screening
+
+    /// The tiles with the smallest norms are set to zero, as long as the
+    /// Frobenius norm of the zeroed tiles, estimated from the tile norms, does
+    /// not exceed \c error . This selects a threshold for the tiles of this
+    /// shape only; the zero threshold of the result is the zero threshold of
+    /// this shape, so the screening does not affect the shapes computed from
+    /// the result. The result is the same on all processes that hold the same
+    /// shape.
+    /// \param error The absolute error budget
+    /// \return A copy of this shape where the smallest tiles are zero
+    SparseShape_ screen(const value_type error) const {
+      TA_ASSERT(! tile_norms_.empty());
+      TA_ASSERT(error >= value_type(0));
+
+      // Estimate the Frobenius norms of the tiles
+      Tensor<value_type> frobenius_norms = tile_norms_.clone();
+      scale_by_size(frobenius_norms, size_vectors_.get(), value_type(0));
+
+      // Sort the non-zero tiles by their normalized norms
+      std::vector<size_type> order;
+      order.reserve(tile_norms_.size() - zero_tile_count_);
+      for(size_type i = 0ul; i < tile_norms_.size(); ++i)
+        if(tile_norms_[i] >= zero_threshold_)
+          order.push_back(i);
+      std::sort(order.begin(), order.end(),
+          [this] (const size_type left, const size_type right)
+          { return tile_norms_[left] < tile_norms_[right]; });
+
+      // Select the smallest norm that must be kept to stay within the budget.
+      // Tiles with the same norm as the first kept tile are kept too.
+      const value_type budget = error * error;
+      value_type squared_error = 0;
+      value_type thresh = std::numeric_limits<value_type>::infinity();
+      for(const size_type i : order) {
+        squared_error += frobenius_norms[i] * frobenius_norms[i];
+        if(squared_error > budget) {
+          thresh = tile_norms_[i];
+          break;
+        }
+      }
+
+      if(thresh <= zero_threshold_)
+        return *this;
+      return truncate(thresh, zero_threshold_);
+    }
+
     /// Tile norm accessor
 
     /// \tparam Index The index type
@@ -376,6 +794,71 @@ namespace TiledArray {
       return tile_norms_[index];
     }
 
+    /// Check for split norm data
+
+    /// \return \c true when this shape holds split norms
+    bool has_split_norms() const { return bool(split_norms_); }
+
+    /// Split norm accessor
+
+    /// \param split The number of leading tile modes that are rows of the
+    /// matricized tiles
+    /// \return The normalized split norms for \c split . If this shape has no
+    /// split norms, or \c split is \c 0 or the rank of the tiles, the tile norms
+    /// are returned.
+    const Tensor<value_type>& split_norms(const unsigned int split) const {
+      TA_ASSERT(! tile_norms_.empty());
+      if(split_norms_ && (split > 0u) && (split < tile_norms_.range().rank()))
+        return (*split_norms_)[split - 1u];
+      return tile_norms_;
+    }
+
+    /// Compute the split norm of a tile
+
+    /// The split norm is an upper bound on the spectral norm of \c tile
+    /// matricized with its first \c split modes as rows and its remaining
+    /// modes as columns. It is computed as
+    /// \f[
+    /// \min\left(\sqrt{\|A\|_1 \|A\|_\infty}, \|A\|_F\right)
+    /// \f]
+    /// where \f$\|A\|_1\f$ and \f$\|A\|_\infty\f$ are the maximum absolute
+    /// column and row sums of the matricized tile, respectively.
+    /// \tparam Tile The tile type
+    /// \param tile The tile
+    /// \param split The number of leading tile modes that are rows
+    /// \return The split norm of \c tile
+    template <typename Tile>
+    static value_type split_norm(const Tile& tile, const unsigned int split) {
+      TA_ASSERT(! tile.empty());
+      TA_ASSERT(split <= tile.range().rank());
+
+      // Compute the matricized tile sizes
+      size_type rows = 1ul;
+      for(unsigned int d = 0u; d < split; ++d)
+        rows *= tile.range().extent(d);
+      const size_type cols = tile.range().volume() / rows;
+
+      // Compute the maximum absolute row and column sums, and Frobenius norm
+      using std::abs;
+      std::vector<value_type> col_sums(cols, value_type(0));
+      value_type max_row_sum = 0, squared_norm = 0;
+      const auto* MADNESS_RESTRICT data = tile.data();
+      for(size_type i = 0ul; i < rows; ++i, data += cols) {
+        value_type row_sum = 0;
+        for(size_type j = 0ul; j < cols; ++j) {
+          const value_type value = abs(data[j]);
+          row_sum += value;
+          col_sums[j] += value;
+          squared_norm += value * value;
+        }
+        max_row_sum = std::max(max_row_sum, row_sum);
+      }
+      const value_type max_col_sum = (cols ?
+          *std::max_element(col_sums.begin(), col_sums.end()) : value_type(0));
+
+      return std::min(std::sqrt(max_row_sum * max_col_sum), std::sqrt(squared_norm));
+    }
+
     /// Transform the norm tensor with an operation
 
     /// \return A deep copy of the norms of the object having 
@@ -389,23 +872,19 @@ namespace TiledArray {
     SparseShape_ transform(Op &&op) const { 
 
         Tensor<T> new_norms = op(tile_norms_);
-        madness::AtomicInt zero_tile_count;
-        zero_tile_count = 0;
 
-        const value_type threshold = threshold_;
-        auto apply_threshold = [threshold, &zero_tile_count](value_type &norm){
+        const value_type threshold = zero_threshold_;
+        auto apply_threshold = [threshold](value_type &norm){
             TA_ASSERT(norm >= value_type(0));
-            if(norm < threshold){
-                norm = value_type(0);
-                ++zero_tile_count;
-            }
+            norm = hard_zero(norm, threshold);
         };
 
         math::inplace_vector_op(apply_threshold, new_norms.range().volume(), 
                 new_norms.data());
 
-        return SparseShape_(std::move(new_norms), size_vectors_, 
-                            zero_tile_count); 
+        const size_type zero_tile_count = zero_count(new_norms, threshold);
+        return SparseShape_(std::move(new_norms), size_vectors_,
+                            zero_tile_count, threshold);
     }
 
     /// Data accessor
@@ -427,24 +906,17 @@ namespace TiledArray {
       TA_ASSERT(!mask_shape.empty());
       TA_ASSERT(tile_norms_.range() == mask_shape.tile_norms_.range());
 
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = zero_tile_count_;
-      auto op = [threshold, &zero_tile_count] (value_type left,
-          const value_type right)
-      {
-        if(left >= threshold && right < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
-
-        return left;
+      const value_type threshold = zero_threshold_;
+      const value_type mask_threshold = mask_shape.zero_threshold_;
+      auto op = [mask_threshold] (const value_type left, const value_type right) {
+        return (right < mask_threshold ? value_type(0) : left);
       };
 
       Tensor<value_type> result_tile_norms =
           tile_norms_.binary(mask_shape.tile_norms_, op);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_count(result_tile_norms, threshold),
+          threshold);
     }
 
     /// Update sub-block of shape
@@ -463,7 +935,7 @@ namespace TiledArray {
       Tensor<value_type> result_tile_norms = tile_norms_.clone();
 
       auto result_tile_norms_blk = result_tile_norms.block(lower_bound, upper_bound);
-      const value_type threshold = threshold_;
+      const value_type threshold = zero_threshold_;
       madness::AtomicInt zero_tile_count;
       zero_tile_count = zero_tile_count_;
       result_tile_norms_blk.inplace_binary(other.tile_norms_,
@@ -478,7 +950,8 @@ namespace TiledArray {
             l = r;
           });
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count,
+          threshold);
     }
 
   private:
@@ -532,15 +1005,11 @@ namespace TiledArray {
           block_range(lower_bound, upper_bound);
 
       // Copy the data from arg to result
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto copy_op = [threshold,&zero_tile_count] (value_type& MADNESS_RESTRICT result,
+      const value_type threshold = zero_threshold_;
+      auto copy_op = [threshold] (value_type& MADNESS_RESTRICT result,
           const value_type arg)
       {
-        result = arg;
-        if(arg < threshold)
-          ++zero_tile_count;
+        result = hard_zero(arg, threshold);
       };
 
 
@@ -550,7 +1019,8 @@ namespace TiledArray {
       Tensor<value_type> result_norms((Range(block_view.range().extent())));
       result_norms.inplace_binary(shift(block_view), copy_op);
 
-      return SparseShape(result_norms, size_vectors, zero_tile_count);
+      return SparseShape(result_norms, size_vectors, zero_count(result_norms, threshold),
+          threshold);
     }
 
 
@@ -570,17 +1040,11 @@ namespace TiledArray {
           block_range(lower_bound, upper_bound);
 
       // Copy the data from arg to result
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto copy_op = [abs_factor,threshold,&zero_tile_count] (value_type& MADNESS_RESTRICT result,
+      const value_type threshold = zero_threshold_;
+      auto copy_op = [abs_factor,threshold] (value_type& MADNESS_RESTRICT result,
               const value_type arg)
       {
-        result = arg * abs_factor;
-        if(result < threshold) {
-          ++zero_tile_count;
-          result = value_type(0);
-        }
+        result = hard_zero(arg * abs_factor, threshold);
       };
 
       // Construct the result norms tensor
@@ -589,7 +1053,8 @@ namespace TiledArray {
       Tensor<value_type> result_norms((Range(block_view.range().extent())));
       result_norms.inplace_binary(shift(block_view), copy_op);
 
-      return SparseShape(result_norms, size_vectors, zero_tile_count);
+      return SparseShape(result_norms, size_vectors, zero_count(result_norms, threshold),
+          threshold);
     }
 
     /// Create a copy of a sub-block of the shape
@@ -623,7 +1088,21 @@ namespace TiledArray {
     /// \return A new, permuted shape
     SparseShape_ perm(const Permutation& perm) const {
       return SparseShape_(tile_norms_.permute(perm), perm_size_vectors(perm),
-          zero_tile_count_);
+          zero_tile_count_, zero_threshold_);
+    }
+
+    /// Create a reshaped shape of this shape
+
+    /// The tile norms are shared with this shape and reinterpreted in the
+    /// tiled range \c trange , which must have the same number of tiles and
+    /// the same tile volumes, in ordinal order, as the tiled range of this
+    /// shape (see \c reshape() ).
+    /// \param trange The tiled range of the result
+    /// \return A new, reshaped shape
+    SparseShape_ reshape(const TiledRange& trange) const {
+      TA_ASSERT(trange.tiles_range().volume() == tile_norms_.range().volume());
+      return SparseShape_(tile_norms_.reshape_view(trange.tiles_range()),
+          initialize_size_vectors(trange), zero_tile_count_, zero_threshold_);
     }
 
     /// Scale shape
@@ -639,22 +1118,29 @@ namespace TiledArray {
     template <typename Factor>
     SparseShape_ scale(const Factor factor) const {
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
+      const value_type threshold = zero_threshold_;
       const value_type abs_factor = to_abs_factor(factor);
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count, abs_factor] (value_type value) {
+      auto op = [threshold, abs_factor] (value_type value) {
         value *= abs_factor;
-        if(value < threshold) {
-          value = value_type(0);
-          ++zero_tile_count;
-        }
+        value = hard_zero(value, threshold);
         return value;
       };
 
       Tensor<value_type> result_tile_norms = tile_norms_.unary(op);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      // Scale the split norms
+      std::shared_ptr<std::vector<Tensor<value_type> > > result_split_norms;
+      if(split_norms_) {
+        result_split_norms = std::make_shared<std::vector<Tensor<value_type> > >();
+        result_split_norms->reserve(split_norms_->size());
+        for(const Tensor<value_type>& norms : *split_norms_)
+          result_split_norms->push_back(norms.binary(result_tile_norms,
+              [abs_factor] (const value_type value, const value_type norm)
+              { return (norm > value_type(0) ? value * abs_factor : value_type(0)); }));
+      }
+
+      return SparseShape_(result_tile_norms, size_vectors_, zero_count(result_tile_norms, threshold),
+          threshold, result_split_norms);
     }
 
     /// Scale and permute shape
@@ -671,23 +1157,18 @@ namespace TiledArray {
     template <typename Factor>
     SparseShape_ scale(const Factor factor, const Permutation& perm) const {
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
+      const value_type threshold = zero_threshold_;
       const value_type abs_factor = to_abs_factor(factor);
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count, abs_factor] (value_type value) {
+      auto op = [threshold, abs_factor] (value_type value) {
         value *= abs_factor;
-        if(value < threshold) {
-          value = value_type(0);
-          ++zero_tile_count;
-        }
+        value = hard_zero(value, threshold);
         return value;
       };
 
       Tensor<value_type> result_tile_norms = tile_norms_.unary(op, perm);
 
       return SparseShape_(result_tile_norms, perm_size_vectors(perm),
-          zero_tile_count);
+          zero_count(result_tile_norms, threshold), threshold);
     }
 
     /// Add shapes
@@ -700,24 +1181,20 @@ namespace TiledArray {
     /// \return A sum of shapes
     SparseShape_ add(const SparseShape_& other) const {
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count] (value_type left,
+      const value_type threshold = result_threshold(other);
+      auto op = [threshold] (value_type left,
           const value_type right)
       {
         left += right;
-        if(left < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
+        left = hard_zero(left, threshold);
         return left;
       };
 
       Tensor<value_type> result_tile_norms =
           tile_norms_.binary(other.tile_norms_, op);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_count(result_tile_norms, threshold),
+          threshold);
     }
 
     /// Add and permute shapes
@@ -731,17 +1208,12 @@ namespace TiledArray {
     /// \return the new shape, equals \c this + \c other
     SparseShape_ add(const SparseShape_& other, const Permutation& perm) const {
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count] (value_type left,
+      const value_type threshold = result_threshold(other);
+      auto op = [threshold] (value_type left,
           const value_type right)
       {
         left += right;
-        if(left < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
+        left = hard_zero(left, threshold);
         return left;
       };
 
@@ -749,7 +1221,7 @@ namespace TiledArray {
           tile_norms_.binary(other.tile_norms_, op, perm);
 
       return SparseShape_(result_tile_norms, perm_size_vectors(perm),
-          zero_tile_count);
+          zero_count(result_tile_norms, threshold), threshold);
     }
 
     /// Add and scale shapes
@@ -766,26 +1238,22 @@ namespace TiledArray {
     template <typename Factor>
     SparseShape_ add(const SparseShape_& other, const Factor factor) const {
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
+      const value_type threshold = result_threshold(other);
       const value_type abs_factor = to_abs_factor(factor);
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count, abs_factor] (value_type left,
+      auto op = [threshold, abs_factor] (value_type left,
           const value_type right)
       {
         left += right;
         left *= abs_factor;
-        if(left < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
+        left = hard_zero(left, threshold);
         return left;
       };
 
       Tensor<value_type> result_tile_norms =
           tile_norms_.binary(other.tile_norms_, op);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_count(result_tile_norms, threshold),
+          threshold);
     }
 
     /// Add, scale, and permute shapes
@@ -805,19 +1273,14 @@ namespace TiledArray {
         const Permutation& perm) const
     {
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
+      const value_type threshold = result_threshold(other);
       const value_type abs_factor = to_abs_factor(factor);
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
-      auto op = [threshold, &zero_tile_count, abs_factor]
+      auto op = [threshold, abs_factor]
                  (value_type left, const value_type right)
       {
         left += right;
         left *= abs_factor;
-        if(left < threshold) {
-          left = value_type(0);
-          ++zero_tile_count;
-        }
+        left = hard_zero(left, threshold);
         return left;
       };
 
@@ -825,14 +1288,12 @@ namespace TiledArray {
           tile_norms_.binary(other.tile_norms_, op, perm);
 
       return SparseShape_(result_tile_norms, perm_size_vectors(perm),
-          zero_tile_count);
+          zero_count(result_tile_norms, threshold), threshold);
     }
 
     SparseShape_ add(value_type value) const {
       TA_ASSERT(! tile_norms_.empty());
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
+      const value_type threshold = zero_threshold_;
 
       Tensor<T> result_tile_norms(tile_norms_.range());
 
@@ -841,14 +1302,11 @@ namespace TiledArray {
       const vector_type* MADNESS_RESTRICT const size_vectors = size_vectors_.get();
 
       if(dim == 1u) {
-        auto add_const_op = [threshold, &zero_tile_count, value] (value_type norm,
+        auto add_const_op = [threshold, value] (value_type norm,
             const value_type size)
         {
           norm += value / std::sqrt(size);
-          if(norm < threshold) {
-            norm = 0;
-            ++zero_tile_count;
-          }
+          norm = hard_zero(norm, threshold);
           return norm;
         };
 
@@ -874,18 +1332,16 @@ namespace TiledArray {
 
         math::outer_fill(left.size(), right.size(), left.data(), right.data(),
             tile_norms_.data(), result_tile_norms.data(),
-            [threshold, &zero_tile_count, value] (value_type& norm,
+            [threshold, value] (value_type& norm,
                 const value_type x, const value_type y)
             {
               norm += value * x * y;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
+              norm = hard_zero(norm, threshold);
             });
       }
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_count(result_tile_norms, threshold),
+          threshold);
     }
 
     SparseShape_ add(const value_type value, const Permutation& perm) const {
@@ -925,23 +1381,18 @@ namespace TiledArray {
   private:
 
     static size_type scale_by_size(Tensor<T>& tile_norms,
-        const vector_type* MADNESS_RESTRICT const size_vectors)
+        const vector_type* MADNESS_RESTRICT const size_vectors,
+        const value_type threshold)
     {
       const unsigned int dim = tile_norms.range().rank();
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
 
       if(dim == 1u) {
         // This is the easy case where the data is a vector and can be
         // normalized directly.
         math::inplace_vector_op(
-            [threshold, &zero_tile_count] (value_type& norm, const value_type size) {
+            [threshold] (value_type& norm, const value_type size) {
               norm *= size;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
+              norm = hard_zero(norm, threshold);
             },
             size_vectors[0].size(), tile_norms.data(), size_vectors[0].data());
       } else {
@@ -959,18 +1410,15 @@ namespace TiledArray {
         const vector_type right = recursive_outer_product(size_vectors + middle, dim - middle, noop);
 
         math::outer(left.size(), right.size(), left.data(), right.data(), tile_norms.data(),
-            [threshold, &zero_tile_count] (value_type& norm, const value_type x,
+            [threshold] (value_type& norm, const value_type x,
                 const value_type y)
             {
               norm *= x * y;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
+              norm = hard_zero(norm, threshold);
             });
       }
 
-      return zero_tile_count;
+      return zero_count(tile_norms, threshold);
     }
 
   public:
@@ -980,11 +1428,13 @@ namespace TiledArray {
       // scale_by_size operations are performed in one step instead of two.
 
       TA_ASSERT(! tile_norms_.empty());
+      const value_type threshold = result_threshold(other);
       Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_);
       const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, size_vectors_.get());
+          scale_by_size(result_tile_norms, size_vectors_.get(), threshold);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count,
+          threshold);
     }
 
     SparseShape_ mult(const SparseShape_& other, const Permutation& perm) const {
@@ -992,12 +1442,14 @@ namespace TiledArray {
       // scale_by_size operations are performed in one step instead of two.
 
       TA_ASSERT(! tile_norms_.empty());
+      const value_type threshold = result_threshold(other);
       Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, perm);
       std::shared_ptr<vector_type> result_size_vector = perm_size_vectors(perm);
       const size_type zero_tile_count =
-                scale_by_size(result_tile_norms, result_size_vector.get());
+                scale_by_size(result_tile_norms, result_size_vector.get(), threshold);
 
-      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count);
+      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count,
+          threshold);
     }
 
     /// \tparam Factor The scaling factor type
@@ -1008,12 +1460,14 @@ namespace TiledArray {
       // scale_by_size operations are performed in one step instead of two.
 
       TA_ASSERT(! tile_norms_.empty());
+      const value_type threshold = result_threshold(other);
       const value_type abs_factor = to_abs_factor(factor);
       Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, abs_factor);
       const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, size_vectors_.get());
+          scale_by_size(result_tile_norms, size_vectors_.get(), threshold);
 
-      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count);
+      return SparseShape_(result_tile_norms, size_vectors_, zero_tile_count,
+          threshold);
     }
 
     /// \tparam Factor The scaling factor type
@@ -1026,30 +1480,104 @@ namespace TiledArray {
       // scale_by_size operations are performed in one step instead of two.
 
       TA_ASSERT(! tile_norms_.empty());
+      const value_type threshold = result_threshold(other);
       const value_type abs_factor = to_abs_factor(factor);
       Tensor<T> result_tile_norms = tile_norms_.mult(other.tile_norms_, abs_factor, perm);
       std::shared_ptr<vector_type> result_size_vector = perm_size_vectors(perm);
       const size_type zero_tile_count =
-          scale_by_size(result_tile_norms, result_size_vector.get());
+          scale_by_size(result_tile_norms, result_size_vector.get(), threshold);
 
-      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count);
+      return SparseShape_(result_tile_norms, result_size_vector, zero_tile_count,
+          threshold);
     }
 
+    /// When both this shape and \c other hold split norms, the result norms
+    /// are bounded with the split norms of the matricized argument tiles, and
+    /// the result holds split norms for the split between the left- and
+    /// right-hand outer modes.
     /// \tparam Factor The scaling factor type
     /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
     template <typename Factor>
     SparseShape_ gemm(const SparseShape_& other, const Factor factor,
         const math::GemmHelper& gemm_helper) const
+    {
+      return gemm(nullptr, other, factor, gemm_helper);
+    }
+
+    /// Cooperative contraction of shapes
+
+    /// Every process of \c world holds the same shapes and must call this
+    /// function collectively. When the contraction is at least
+    /// \c TILEDARRAY_SHAPE_GEMM_COOPERATIVE_THRESHOLD (<tt>m*n*k</tt> of the
+    /// matricized norms), each process computes only a block of rows of the
+    /// result norms, and the blocks are combined with a sparse allreduce.
+    /// Otherwise, or in a single process world, every process computes the
+    /// whole product. The result is the same as that of the non-cooperative
+    /// \c gemm .
+    /// \tparam Factor The scaling factor type
+    /// \param world The world that holds the shapes
+    /// \param other The right-hand argument
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction data
+    /// \return The result shape
+    template <typename Factor>
+    SparseShape_ gemm(World& world, const SparseShape_& other,
+        const Factor factor, const math::GemmHelper& gemm_helper) const
+    {
+      return gemm(&world, other, factor, gemm_helper);
+    }
+
+    /// Cooperative contraction of shapes with a permutation
+
+    /// \tparam Factor The scaling factor type
+    /// \param world The world that holds the shapes
+    /// \param other The right-hand argument
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction data
+    /// \param perm The permutation applied to the result
+    /// \return The result shape
+    template <typename Factor>
+    SparseShape_ gemm(World& world, const SparseShape_& other,
+        const Factor factor, const math::GemmHelper& gemm_helper,
+        const Permutation& perm) const
+    {
+      return gemm(&world, other, factor, gemm_helper).perm(perm);
+    }
+
+  private:
+
+    /// Contraction of shapes
+
+    /// When \c world is not null and the contraction is large, the rows
+    /// <tt>[m_first, m_last)</tt> of the matricized result norms are computed
+    /// by this process, and the rows of all processes are summed.
+    /// \param world The world that holds the shapes, or null
+    template <typename Factor>
+    SparseShape_ gemm(World* const world, const SparseShape_& other,
+        const Factor factor, const math::GemmHelper& gemm_helper) const
     {
       TA_ASSERT(! tile_norms_.empty());
 
       const value_type abs_factor = to_abs_factor(factor);
-      const value_type threshold = threshold_;
-      madness::AtomicInt zero_tile_count;
-      zero_tile_count = 0;
+      const value_type threshold = result_threshold(other);
       integer M = 0, N = 0, K = 0;
       gemm_helper.compute_matrix_sizes(M, N, K, tile_norms_.range(), other.tile_norms_.range());
 
+      // Select the rows of the result computed by this process; the choice
+      // depends only on data that is the same on all processes.
+      const bool cooperative = world && (world->size() > 1) &&
+          (gemm_helper.left_op() == madness::cblas::NoTrans) &&
+          (gemm_helper.right_op() == madness::cblas::NoTrans) &&
+          ((std::int64_t(M) * std::int64_t(N) * std::int64_t(std::max<integer>(K, 1l)))
+              >= std::int64_t(TILEDARRAY_SHAPE_GEMM_COOPERATIVE_THRESHOLD));
+      integer m_first = 0l, m_last = M;
+      if(cooperative) {
+        const std::int64_t nprocs = world->size();
+        const std::int64_t rank = world->rank();
+        m_first = (std::int64_t(M) * rank) / nprocs;
+        m_last = (std::int64_t(M) * (rank + 1l)) / nprocs;
+      }
+
       // Allocate memory for the contracted size vectors
       std::shared_ptr<vector_type> result_size_vectors(new vector_type[gemm_helper.result_rank()],
           std::default_delete<vector_type[]>());
@@ -1068,62 +1596,140 @@ namespace TiledArray {
       Tensor<value_type> result_norms(gemm_helper.make_result_range<typename Tensor<T>::range_type>(
           tile_norms_.range(), other.tile_norms_.range()), 0);
 
-      if(k_rank > 0u) {
+      // Result split norms
+      std::shared_ptr<std::vector<Tensor<value_type> > > result_split_norms;
 
+      if((k_rank > 0u) && split_norms_ && other.split_norms_ &&
+          (gemm_helper.left_op() == madness::cblas::NoTrans) &&
+          (gemm_helper.right_op() == madness::cblas::NoTrans))
+      {
         // Compute size vector
         const vector_type k_sizes =
             recursive_outer_product(size_vectors_.get() + gemm_helper.left_inner_begin(),
                 k_rank, [] (const vector_type& size_vector) -> const vector_type&
                 { return size_vector; });
 
-        // TODO: Make this faster. It can be done without using temporaries
-        // for the arguments, but requires a custom matrix multiply.
+        // Get the split norms of the matricized argument tiles
+        const value_type* MADNESS_RESTRICT const left_norms = tile_norms_.data();
+        const value_type* MADNESS_RESTRICT const left_split_norms =
+            split_norms(gemm_helper.left_inner_begin()).data();
+        const value_type* MADNESS_RESTRICT const right_norms = other.tile_norms_.data();
+        const value_type* MADNESS_RESTRICT const right_split_norms =
+            other.split_norms(k_rank).data();
+
+        // The split norms of the result tiles are known only for the split
+        // between the left- and right-hand outer modes.
+        const unsigned int result_rank = gemm_helper.result_rank();
+        const unsigned int result_split = gemm_helper.left_outer_end() - gemm_helper.left_outer_begin();
+        Tensor<value_type> split_result_norms(result_norms.range(), 0);
+        value_type* MADNESS_RESTRICT const result_data = result_norms.data();
+        value_type* MADNESS_RESTRICT const split_result_data = split_result_norms.data();
+
+        // Compute the result norms with
+        //   ||A B||_F <= min(||A||_F ||B||_2, ||A||_2 ||B||_F)
+        //   ||A B||_2 <= ||A||_2 ||B||_2
+        for(integer k = 0; k < K; ++k) {
+          const value_type k_factor = k_sizes[k] * k_sizes[k] * abs_factor;
+          for(integer m = m_first; m < m_last; ++m) {
+            const value_type left = left_norms[m * K + k];
+            if(left == value_type(0)) continue;
+            const value_type left_split = left_split_norms[m * K + k];
+            value_type* MADNESS_RESTRICT const result_m = result_data + m * N;
+            value_type* MADNESS_RESTRICT const split_result_m = split_result_data + m * N;
+            const value_type* MADNESS_RESTRICT const right_k = right_norms + k * N;
+            const value_type* MADNESS_RESTRICT const right_split_k = right_split_norms + k * N;
+            for(integer n = 0; n < N; ++n) {
+              result_m[n] += k_factor * std::min(left * right_split_k[n], left_split * right_k[n]);
+              split_result_m[n] += k_factor * left_split * right_split_k[n];
+            }
+          }
+        }
+
+        // Hard zero tiles that are below the zero threshold.
+        result_norms.inplace_unary(
+            [threshold] (value_type& value) {
+              value = hard_zero(value, threshold);
+            });
+
+        if(cooperative) {
+          detail::sparse_allreduce(*world, result_norms.data(), result_norms.size());
+          detail::sparse_allreduce(*world, split_result_norms.data(),
+              split_result_norms.size());
+        }
+
+        // Construct the result split norms
+        result_split_norms = std::make_shared<std::vector<Tensor<value_type> > >();
+        result_split_norms->reserve(result_rank - 1u);
+        for(unsigned int split = 1u; split < result_rank; ++split) {
+          if(split == result_split)
+            result_split_norms->push_back(split_result_norms.binary(result_norms,
+                [] (const value_type split_norm, const value_type norm)
+                { return std::min(split_norm, norm); }));
+          else
+            result_split_norms->push_back(result_norms.clone());
+        }
+
+      } else if(k_rank > 0u) {
 
+        // Compute size vector
+        const vector_type k_sizes =
+            recursive_outer_product(size_vectors_.get() + gemm_helper.left_inner_begin(),
+                k_rank, [] (const vector_type& size_vector) -> const vector_type&
+                { return size_vector; });
+
+        // Both inner size factors are folded into the left-hand norms, so
+        // the right-hand norms are used directly. The product goes through
+        // Tensor::gemm, which uses the parallel tiled BLAS kernel.
         Tensor<value_type> left(tile_norms_.range());
-        const size_type mk = M * K;
+        const size_type mk = m_last * K;
         auto left_op = [] (const value_type left, const value_type right)
-            { return left * right; };
-        for(size_type i = 0ul; i < mk; i += K)
+            { return left * right * right; };
+        for(size_type i = m_first * K; i < mk; i += K)
           math::vector_op(left_op, K, left.data() + i,
               tile_norms_.data() + i, k_sizes.data());
 
-        Tensor<value_type> right(other.tile_norms_.range());
-        for(integer i = 0ul, k = 0; k < K; i += N, ++k) {
-          const value_type factor = k_sizes[k];
-          auto right_op = [=] (const value_type arg) { return arg * factor; };
-          math::vector_op(right_op, N, right.data() + i, other.tile_norms_.data() + i);
+        if(cooperative) {
+          if(m_first < m_last)
+            math::parallel_gemm(madness::cblas::NoTrans, madness::cblas::NoTrans,
+                m_last - m_first, N, K, abs_factor, left.data() + m_first * K, K,
+                other.tile_norms_.data(), N, value_type(0),
+                result_norms.data() + m_first * N, N);
+        } else {
+          result_norms = left.gemm(other.tile_norms_, abs_factor, gemm_helper);
         }
 
-        result_norms = left.gemm(right, abs_factor, gemm_helper);
-
         // Hard zero tiles that are below the zero threshold.
         result_norms.inplace_unary(
-            [threshold, &zero_tile_count] (value_type& value) {
-              if(value < threshold) {
-                value = value_type(0);
-                ++zero_tile_count;
-              }
+            [threshold] (value_type& value) {
+              value = hard_zero(value, threshold);
             });
 
+        if(cooperative)
+          detail::sparse_allreduce(*world, result_norms.data(), result_norms.size());
+
       } else {
 
         // This is an outer product, so the inputs can be used directly
-        math::outer_fill(M, N, tile_norms_.data(), other.tile_norms_.data(), result_norms.data(),
-            [threshold, &zero_tile_count, abs_factor] (const value_type left,
+        math::outer_fill(m_last - m_first, N, tile_norms_.data() + m_first,
+            other.tile_norms_.data(), result_norms.data() + m_first * N,
+            [threshold, abs_factor] (const value_type left,
                 const value_type right)
             {
               value_type norm = left * right * abs_factor;
-              if(norm < threshold) {
-                norm = value_type(0);
-                ++zero_tile_count;
-              }
+              norm = hard_zero(norm, threshold);
               return norm;
             });
+
+        if(cooperative)
+          detail::sparse_allreduce(*world, result_norms.data(), result_norms.size());
       }
 
-      return SparseShape_(result_norms, result_size_vectors, zero_tile_count);
+      return SparseShape_(result_norms, result_size_vectors, zero_count(result_norms, threshold),
+          threshold, result_split_norms);
     }
 
+  public:
+
     /// \tparam Factor The scaling factor type
     /// \note expression abs(Factor) must be well defined (by default, std::abs will be used)
     template <typename Factor>
@@ -1133,6 +1739,73 @@ namespace TiledArray {
       return gemm(other, factor, gemm_helper).perm(perm);
     }
 
+    /// Output serialization function
+
+    /// This function enables serialization within MADNESS
+    /// \tparam Archive The output archive type
+    /// \param[out] ar The output archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(const Archive& ar) {
+      const unsigned int rank =
+          (tile_norms_.empty() ? 0u : tile_norms_.range().rank());
+      ar & rank & zero_threshold_;
+      if(! rank)
+        return;
+
+      ar & tile_norms_ & zero_tile_count_;
+      for(unsigned int d = 0u; d < rank; ++d) {
+        const vector_type& size_vector = size_vectors_.get()[d];
+        ar & size_vector.size()
+           & madness::archive::wrap(size_vector.data(), size_vector.size());
+      }
+      const std::size_t splits = (split_norms_ ? split_norms_->size() : 0ul);
+      ar & splits;
+      for(std::size_t s = 0ul; s < splits; ++s)
+        ar & (*split_norms_)[s];
+    }
+
+    /// Input serialization function
+
+    /// This function enables serialization within MADNESS
+    /// \tparam Archive The input archive type
+    /// \param[out] ar The input archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    void serialize(const Archive& ar) {
+      unsigned int rank = 0u;
+      ar & rank & zero_threshold_;
+      if(! rank) {
+        tile_norms_ = Tensor<value_type>();
+        size_vectors_.reset();
+        zero_tile_count_ = 0ul;
+        split_norms_.reset();
+        return;
+      }
+
+      ar & tile_norms_ & zero_tile_count_;
+      size_vectors_.reset(new vector_type[rank],
+          std::default_delete<vector_type[]>());
+      for(unsigned int d = 0u; d < rank; ++d) {
+        std::size_t n = 0ul;
+        ar & n;
+        vector_type size_vector(n);
+        ar & madness::archive::wrap(size_vector.data(), n);
+        size_vectors_.get()[d] = size_vector;
+      }
+      std::size_t splits = 0ul;
+      ar & splits;
+      if(splits) {
+        split_norms_ = std::make_shared<std::vector<Tensor<value_type> > >(splits);
+        for(std::size_t s = 0ul; s < splits; ++s)
+          ar & (*split_norms_)[s];
+      } else {
+        split_norms_.reset();
+      }
+    }
+
   private:
     template <typename Factor>
     static value_type to_abs_factor(const Factor factor) {
@@ -29,6 +29,7 @@
 #include <TiledArray/dist_array.h>
 #include <TiledArray/range.h>
 #include <TiledArray/tensor.h>
+#include <TiledArray/tensor/band_tensor.h>
 #include <TiledArray/tiled_range.h>
 
 #include <vector>
@@ -85,31 +86,43 @@ Tensor<float> diagonal_shape(TiledRange const &trange, T val) {
     return shape;
 }
 
+// Write the diagonal elements of a dense tile
+template <typename T>
+void make_diagonal_tile(Range const &rng, T val, Tensor<T> &tile) {
+    const auto ndims = rng.rank();
+
+    // Compute range of diagonal elements in the tile
+    auto diags = detail::diagonal_range(rng);
+
+    tile = Tensor<T>(rng, 0.0);
+
+    if (diags.volume() > 0) { // If the tile has diagonal elems
+
+        // Loop over the elements and write val into them
+        auto diag_lo = diags.lobound_data()[0];
+        auto diag_hi = diags.upbound_data()[0];
+        for (auto elem = diag_lo; elem < diag_hi; ++elem) {
+            tile(std::vector<int>(ndims, elem)) = val;
+        }
+    }
+}
+
+// Banded tiles store only the diagonal, or nothing when the tile does not
+// intersect the diagonal
+template <typename T>
+void make_diagonal_tile(Range const &rng, T val, BandTensor<T> &tile) {
+    tile = BandTensor<T>(rng, 0ul, 0ul, val);
+}
+
 // Actually do all the work of writing the diagonal tiles
 template<typename Array, typename T>
 void write_tiles_to_array(Array &A, T val){
     auto const &trange = A.trange();
-    const auto ndims = trange.rank();
 
     // Task to create each tile
-    auto tile_task = [val, &trange, ndims](unsigned long ord){
-            auto rng = trange.make_tile_range(ord);
-            
-            // Compute range of diagonal elements in the tile
-            auto diags = detail::diagonal_range(rng);
-
-            Tensor<T> tile(rng, 0.0);
-
-            if (diags.volume() > 0) { // If the tile has diagonal elems 
-
-                // Loop over the elements and write val into them
-                auto diag_lo = diags.lobound_data()[0];
-                auto diag_hi = diags.upbound_data()[0];
-                for (auto elem = diag_lo; elem < diag_hi; ++elem) {
-                    tile(std::vector<int>(ndims, elem)) = val;
-                }
-            }
-
+    auto tile_task = [val, &trange](unsigned long ord){
+            typename Array::value_type tile;
+            make_diagonal_tile(trange.make_tile_range(ord), val, tile);
             return tile;
     };
 
@@ -124,6 +137,22 @@ void write_tiles_to_array(Array &A, T val){
     }
 }
 
+// Construct an empty diagonal array with a dense shape
+template <typename Array, typename T>
+Array diagonal_array_shell(World &world, TiledRange const &trange, T,
+                           std::true_type) {
+    return Array(world, trange);
+}
+
+// Construct an empty diagonal array with a shape that contains only the tiles
+// on the diagonal
+template <typename Array, typename T>
+Array diagonal_array_shell(World &world, TiledRange const &trange, T val,
+                           std::false_type) {
+    SparseShape<float> shape(diagonal_shape(trange, val), trange);
+    return Array(world, trange, shape);
+}
+
 }  // namespace detail
 
 
@@ -186,6 +215,33 @@ diagonal_array(World &world, TiledRange const &trange, T val = 1) {
   return sparse_diagonal_array<T>(world, trange, val);
 }
 
+/// Create a DistArray of banded tiles with only diagonal elements
+
+/// Only the diagonal elements of the tiles are stored, so the array costs
+/// O(n) memory, and contractions with it cost O(n) flops per row of the other
+/// argument (see \c BandTensor ). Use it to multiply by, e.g., denominators
+/// or other diagonal matrices.
+/// \tparam T The element type
+/// \tparam Policy The array policy [default = DensePolicy]
+/// \param world The world for the array
+/// \param trange The trange for the array, which must have a rank of 2
+/// \param val The value to be written along the diagonal elements
+template <typename T, typename Policy = DensePolicy>
+DistArray<BandTensor<T>, Policy>
+band_diagonal_array(World &world, TiledRange const &trange, T val = 1) {
+    TA_USER_ASSERT(trange.rank() == 2u,
+        "TiledArray::band_diagonal_array(): The tiled range must have a rank of 2.");
+    typedef DistArray<BandTensor<T>, Policy> array_type;
+
+    array_type A = detail::diagonal_array_shell<array_type>(world, trange, val,
+        std::integral_constant<bool, is_dense<array_type>::value>());
+
+    detail::write_tiles_to_array(A, val);
+
+    world.gop.fence();
+    return A;
+}
+
 }  // namespace TiledArray
 
 #endif  // TILEDARRAY_SPECIALARRAYS_DIAGONAL_ARRAY_H__INCLUDED
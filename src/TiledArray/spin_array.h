@@ -0,0 +1,203 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  spin_array.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_SPIN_ARRAY_H__INCLUDED
+#define TILEDARRAY_SPIN_ARRAY_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/expressions/async_eval.h>
+#include <cctype>
+#include <map>
+#include <string>
+
+namespace TiledArray {
+
+  /// Spin-blocked distributed array
+
+  /// SpinArray holds the spin blocks of one tensor of an unrestricted
+  /// method, e.g. the \f$ \alpha\alpha \f$ , \f$ \alpha\beta \f$ , and
+  /// \f$ \beta\beta \f$ blocks of \f$ t^{ab}_{ij} \f$ . Each block is an
+  /// ordinary array, and it is identified by the spin of its modes, one
+  /// character per mode: \c 'a' for \f$ \alpha \f$ and \c 'b' for
+  /// \f$ \beta \f$ (e.g. \c "abab" ). Blocks may share their data; e.g. the
+  /// \c "bbbb" block of a closed shell tensor may be the \c "aaaa" block.
+  ///
+  /// In expressions, the block of a spin array is selected by the last
+  /// character of each variable, so the spin cases of an equation are
+  /// written with the usual spin-labeled variables. The spin cases of an
+  /// iteration are assigned within one asynchronous scope (see
+  /// \c expressions::AsyncEval ), so they are evaluated concurrently and
+  /// need a single fence:
+  /// \code
+  /// SpinArray<TensorD> t, v, r;
+  /// ...
+  /// r.assign_blocks([&] () {
+  ///   r("p1a,p2a,h1a,h2a") = v("p1a,p2a,h1a,h2a") + ... ;
+  ///   r("p1a,p2b,h1a,h2b") = v("p1a,p2b,h1a,h2b")
+  ///       + v("p1a,h3b,h1a,p3b") * t("p2b,p3b,h2b,h3b") + ... ;
+  ///   r("p1b,p2b,h1b,h2b") = v("p1b,p2b,h1b,h2b") + ... ;
+  /// });
+  /// world.gop.fence();
+  /// \endcode
+  /// \tparam Tile The tile type
+  /// \tparam Policy The array policy type
+  template <typename Tile, typename Policy = SparsePolicy>
+  class SpinArray {
+  public:
+    typedef SpinArray<Tile, Policy> SpinArray_; ///< This object type
+    typedef DistArray<Tile, Policy> array_type; ///< Block array type
+    typedef std::map<std::string, array_type> map_type; ///< Block map type
+
+  private:
+
+    map_type blocks_; ///< The spin blocks
+
+  public:
+
+    SpinArray() = default;
+    SpinArray(const SpinArray_&) = default;
+    SpinArray(SpinArray_&&) = default;
+    SpinArray_& operator=(const SpinArray_&) = default;
+    SpinArray_& operator=(SpinArray_&&) = default;
+
+    /// Spin labels of a variable list
+
+    /// \param vars A comma-separated list of variables, where the last
+    /// character of each variable is its spin, \c 'a' or \c 'b'
+    /// \return The spin of each variable, e.g. \c "abab" for
+    /// \c "p1a,p2b,h1a,h2b"
+    /// \throw TiledArray::Exception When a variable does not end with a spin
+    /// label.
+    static std::string spins(const std::string& vars) {
+      std::string result;
+      std::string::size_type first = 0ul;
+      while(first <= vars.size()) {
+        std::string::size_type last = vars.find(',', first);
+        if(last == std::string::npos)
+          last = vars.size();
+
+        // Find the last non-space character of the variable
+        std::string::size_type end = last;
+        while((end > first) && std::isspace(vars[end - 1ul]))
+          --end;
+        TA_USER_ASSERT((end > first) &&
+            ((vars[end - 1ul] == 'a') || (vars[end - 1ul] == 'b')),
+            "SpinArray::spins(): Each variable must end with a spin label, 'a' or 'b'.");
+        result.push_back(vars[end - 1ul]);
+
+        first = last + 1ul;
+      }
+      return result;
+    }
+
+    /// Block check
+
+    /// \param spins The spin labels of the block
+    /// \return \c true if the block has been set
+    bool has_block(const std::string& spins) const {
+      return blocks_.find(spins) != blocks_.end();
+    }
+
+    /// Block accessor
+
+    /// \param spins The spin labels of the block
+    /// \return A const reference to the block
+    /// \throw TiledArray::Exception When the block has not been set.
+    const array_type& block(const std::string& spins) const {
+      typename map_type::const_iterator it = blocks_.find(spins);
+      TA_USER_ASSERT(it != blocks_.end(),
+          "SpinArray::block(): The spin block has not been set.");
+      return it->second;
+    }
+
+    /// Block accessor
+
+    /// An empty block is added if it has not been set, so it may be the
+    /// result of an expression.
+    /// \param spins The spin labels of the block
+    /// \return A reference to the block
+    array_type& block(const std::string& spins) { return blocks_[spins]; }
+
+    /// Set a block
+
+    /// The tiles of \c array are shared with the block.
+    /// \param spins The spin labels of the block
+    /// \param array The block data
+    void set_block(const std::string& spins, const array_type& array) {
+      blocks_[spins] = array;
+    }
+
+    /// \return The spin blocks
+    const map_type& blocks() const { return blocks_; }
+
+    /// \return The number of spin blocks
+    std::size_t size() const { return blocks_.size(); }
+
+    /// Create a tensor expression of a spin block
+
+    /// \param vars A comma-separated list of spin-labeled variables
+    /// \return A const tensor expression of the block selected by \c vars
+    TiledArray::expressions::TsrExpr<const array_type, true>
+    operator()(const std::string& vars) const { return block(spins(vars))(vars); }
+
+    /// Create a tensor expression of a spin block
+
+    /// \param vars A comma-separated list of spin-labeled variables
+    /// \return A tensor expression of the block selected by \c vars
+    TiledArray::expressions::TsrExpr<array_type, true>
+    operator()(const std::string& vars) { return block(spins(vars))(vars); }
+
+    /// Assign the spin blocks concurrently
+
+    /// \c op is called in an asynchronous scope, so the assignments made by
+    /// \c op (e.g. one per spin case) do not wait for each other. This
+    /// function returns when the local tiles of all assignments have been
+    /// evaluated; a fence is still needed before the remote tiles are used.
+    /// \tparam Op The assignment function type
+    /// \param op The function that makes the assignments, with signature
+    /// <tt>void op()</tt>
+    template <typename Op>
+    void assign_blocks(Op&& op) const {
+      expressions::AsyncEval async;
+      op();
+      async.wait();
+    }
+
+    /// Apply a function to each spin block
+
+    /// \tparam Op The function type
+    /// \param op The function, with signature
+    /// <tt>void op(const std::string& spins, array_type& block)</tt>
+    template <typename Op>
+    void for_each_block(Op&& op) {
+      for(typename map_type::iterator it = blocks_.begin(); it != blocks_.end(); ++it)
+        op(it->first, it->second);
+    }
+
+  }; // class SpinArray
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SPIN_ARRAY_H__INCLUDED
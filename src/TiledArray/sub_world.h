@@ -0,0 +1,282 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  sub_world.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_SUB_WORLD_H__INCLUDED
+#define TILEDARRAY_SUB_WORLD_H__INCLUDED
+
+#include <TiledArray/conversions/redistribute.h>
+#include <TiledArray/pmap/blocked_pmap.h>
+#include <TiledArray/pmap/group_pmap.h>
+#include <algorithm>
+#include <memory>
+#include <numeric>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Tile boundaries of a tiled range
+
+    /// \param trange The tiled range
+    /// \return The tile boundaries of each dimension of \c trange
+    inline std::vector<std::vector<std::size_t> >
+    tile_boundaries(const TiledRange& trange) {
+      std::vector<std::vector<std::size_t> > result;
+      result.reserve(trange.data().size());
+      for(const auto& trange1 : trange.data()) {
+        std::vector<std::size_t> boundaries;
+        boundaries.reserve(trange1.tiles_range().second - trange1.tiles_range().first + 1ul);
+        for(const auto& tile : trange1)
+          boundaries.push_back(tile.first);
+        boundaries.push_back(trange1.elements_range().second);
+        result.push_back(std::move(boundaries));
+      }
+      return result;
+    }
+
+    /// Construct a tiled range from its tile boundaries
+
+    /// \param boundaries The tile boundaries of each dimension
+    /// \return The tiled range with \c boundaries
+    inline TiledRange
+    make_tiled_range(const std::vector<std::vector<std::size_t> >& boundaries) {
+      std::vector<TiledRange1> ranges;
+      ranges.reserve(boundaries.size());
+      for(const auto& dim : boundaries)
+        ranges.emplace_back(dim.begin(), dim.end());
+      return TiledRange(ranges.begin(), ranges.end());
+    }
+
+  } // namespace detail
+
+  /// A split of a world into groups of processes
+
+  /// Terms that are independent of each other, e.g. the small contractions
+  /// of a coupled-cluster residual, scale poorly when each runs on all
+  /// processes. \c SubWorld splits a world into groups of consecutive
+  /// processes, each with its own world (sub-world), so independent
+  /// expressions are evaluated concurrently on right-sized groups. Operands
+  /// are moved onto a group with \c to_group() and results are moved back
+  /// with \c from_group() ; both redistribute the tiles in bulk (see
+  /// \c redistribute() ), and tiles that stay on a process are not copied.
+  /// \code
+  /// TiledArray::SubWorld sub(world, 2);
+  /// TArrayD a0 = sub.to_group(a, 0), b0 = sub.to_group(b, 0);
+  /// TArrayD a1 = sub.to_group(a, 1), c1 = sub.to_group(c, 1);
+  /// TArrayD r0, r1;
+  /// if(sub.color() == 0)
+  ///   r0("i,j") = a0("i,k") * b0("k,j");
+  /// else
+  ///   r1("i,j") = a1("i,k") * c1("k,j");
+  /// TArrayD x = sub.from_group(r0, 0), y = sub.from_group(r1, 1);
+  /// \endcode
+  /// \note The arrays of a sub-world must be destroyed before the
+  /// \c SubWorld object.
+  /// \note Moving arrays with a \c CompressedShape is not supported.
+  class SubWorld {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+  private:
+    World& parent_; ///< The world that is split
+    std::vector<ProcessID> first_; ///< The first process of each group, and
+                                   ///< the number of processes
+    size_type color_; ///< The group of this process
+    std::unique_ptr<World> world_; ///< The world of this group
+
+    SubWorld(const SubWorld&) = delete;
+    SubWorld& operator=(const SubWorld&) = delete;
+
+    /// Split the parent world
+    void split() {
+      const ProcessID rank = parent_.rank();
+      color_ = std::upper_bound(first_.begin(), first_.end(), rank)
+          - first_.begin() - 1ul;
+      world_.reset(new World(parent_.mpi.comm().Split(color_, rank)));
+    }
+
+  public:
+
+    /// Split a world into groups of equal size
+
+    /// \param parent The world that is split
+    /// \param groups The number of groups
+    /// \throw TiledArray::Exception When \c groups is zero or larger than the
+    /// number of processes.
+    /// \note This is a collective operation.
+    SubWorld(World& parent, const size_type groups) :
+      parent_(parent), first_(), color_(0ul), world_()
+    {
+      TA_USER_ASSERT((groups > 0ul) && (groups <= size_type(parent.size())),
+          "SubWorld: The number of groups must be in [1, number of processes].");
+      for(size_type g = 0ul; g <= groups; ++g)
+        first_.push_back((g * parent.size()) / groups);
+      split();
+    }
+
+    /// Split a world into groups of the given sizes
+
+    /// \param parent The world that is split
+    /// \param sizes The number of processes of each group
+    /// \throw TiledArray::Exception When a size is zero, or the sizes do not
+    /// add up to the number of processes.
+    /// \note This is a collective operation.
+    SubWorld(World& parent, const std::vector<size_type>& sizes) :
+      parent_(parent), first_(1ul, 0), color_(0ul), world_()
+    {
+      TA_USER_ASSERT(std::accumulate(sizes.begin(), sizes.end(), size_type(0ul))
+          == size_type(parent.size()),
+          "SubWorld: The group sizes do not add up to the number of processes.");
+      for(const auto size : sizes) {
+        TA_USER_ASSERT(size > 0ul, "SubWorld: A group is empty.");
+        first_.push_back(first_.back() + size);
+      }
+      split();
+    }
+
+    /// Destructor
+
+    /// \note This is a collective operation.
+    ~SubWorld() {
+      world_->gop.fence();
+      world_.reset();
+      parent_.gop.fence();
+    }
+
+    /// \return The world that is split
+    World& parent() const { return parent_; }
+
+    /// \return The world of the group of this process
+    World& world() const { return *world_; }
+
+    /// \return The number of groups
+    size_type groups() const { return first_.size() - 1ul; }
+
+    /// \return The group of this process
+    size_type color() const { return color_; }
+
+    /// \param color A group
+    /// \return The first process of group \c color in the parent world
+    ProcessID first(const size_type color) const {
+      TA_ASSERT(color < groups());
+      return first_[color];
+    }
+
+    /// \param color A group
+    /// \return The number of processes of group \c color
+    ProcessID size(const size_type color) const {
+      TA_ASSERT(color < groups());
+      return first_[color + 1ul] - first_[color];
+    }
+
+    /// Move an array onto a group
+
+    /// The tiles of \c array are redistributed onto the processes of group
+    /// \c color , and the result is an array of its sub-world with a
+    /// blocked process map.
+    /// \tparam Tile The array tile type
+    /// \tparam Policy The array policy type
+    /// \param array An array of the parent world
+    /// \param color The group
+    /// \return A copy of \c array in the sub-world of \c color on its
+    /// processes; an uninitialized array on the other processes
+    /// \note This is a collective operation of the parent world, but it does
+    /// not wait for the tiles to be moved.
+    template <typename Tile, typename Policy>
+    DistArray<Tile, Policy>
+    to_group(const DistArray<Tile, Policy>& array, const size_type color) const {
+      typedef DistArray<Tile, Policy> array_type;
+      TA_USER_ASSERT(color < groups(), "SubWorld::to_group(): Invalid group.");
+      TA_USER_ASSERT(& array.world() == & parent_,
+          "SubWorld::to_group(): The array is not in the parent world.");
+
+      const size_type size = array.size();
+      const array_type moved = redistribute(array,
+          std::make_shared<detail::GroupPmap>(parent_, size, first(color),
+          this->size(color)));
+      if(color != color_)
+        return array_type();
+
+      // The sub-world blocked map has the same local tiles as the group map
+      array_type result(*world_, array.trange(), array.shape(),
+          std::make_shared<detail::BlockedPmap>(*world_, size));
+      for(const auto index : *result.pmap())
+        if(! result.is_zero(index))
+          result.set(index, moved.find(index));
+
+      return result;
+    }
+
+    /// Move an array from a group
+
+    /// \tparam Tile The array tile type
+    /// \tparam Policy The array policy type
+    /// \param array An array of the sub-world of \c color on its processes;
+    /// ignored on the other processes
+    /// \param color The group
+    /// \return A copy of \c array in the parent world with the default
+    /// process map
+    /// \note This is a collective operation of the parent world, but it does
+    /// not wait for the tiles to be moved.
+    template <typename Tile, typename Policy>
+    DistArray<Tile, Policy>
+    from_group(const DistArray<Tile, Policy>& array, const size_type color) const {
+      typedef DistArray<Tile, Policy> array_type;
+      typedef typename array_type::shape_type shape_type;
+      TA_USER_ASSERT(color < groups(), "SubWorld::from_group(): Invalid group.");
+
+      // Broadcast the tiled range and the shape from the group
+      std::vector<std::vector<std::size_t> > boundaries;
+      shape_type shape;
+      if(color == color_) {
+        TA_USER_ASSERT(& array.world() == world_.get(),
+            "SubWorld::from_group(): The array is not in the world of the group.");
+        boundaries = detail::tile_boundaries(array.trange());
+        shape = array.shape();
+      }
+      parent_.gop.broadcast_serializable(boundaries, first(color));
+      parent_.gop.broadcast_serializable(shape, first(color));
+      const TiledRange trange = detail::make_tiled_range(boundaries);
+      const size_type size = trange.tiles_range().volume();
+
+      // Alias the tiles of the group in the parent world
+      array_type moved(parent_, trange, shape,
+          std::make_shared<detail::GroupPmap>(parent_, size, first(color),
+          this->size(color)));
+      if(color == color_) {
+        const array_type blocked = redistribute(array,
+            std::make_shared<detail::BlockedPmap>(*world_, size));
+        for(const auto index : *moved.pmap())
+          if(! moved.is_zero(index))
+            moved.set(index, blocked.find(index));
+      }
+
+      return redistribute(moved, Policy::default_pmap(parent_, size));
+    }
+
+  }; // class SubWorld
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SUB_WORLD_H__INCLUDED
@@ -0,0 +1,470 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_trace.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_SUMMA_TRACE_H__INCLUDED
+#define TILEDARRAY_SUMMA_TRACE_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+  /// SUMMA event types
+  enum class SummaEventKind : std::uint8_t {
+    step_begin, ///< A SUMMA step was started
+    step_end, ///< The tile contractions of a step are done
+    tiles_ready, ///< The argument tiles of a step have arrived
+    bcast_col, ///< A column of left-hand tiles was broadcast
+    bcast_row, ///< A row of right-hand tiles was broadcast
+    reduce_submit ///< The reduction of a result tile was submitted
+  }; // enum class SummaEventKind
+
+  /// SUMMA event trace
+
+  /// \c SummaTrace records the events of the SUMMA pipeline of each
+  /// contraction: the start and end of each step \c k , the broadcasts of
+  /// each step with the number of tiles, the bytes sent, and the size of the
+  /// broadcast group, the time a step waited for its argument tiles, and the
+  /// submission of each result tile reduction. Events are fixed-size records
+  /// that are appended to per-thread buffers, so tracing can be enabled in
+  /// production builds. Tracing is disabled by default; it is enabled with
+  /// \c enable() or by setting the \c TA_SUMMA_TRACE environment variable,
+  /// in which case \c TiledArray::finalize() writes the events of each
+  /// process to the binary file <tt>$TA_SUMMA_TRACE.rank.bin</tt> .
+  ///
+  /// A trace file is converted with \c read() and either \c write_timeline()
+  /// , which writes the Chrome trace event format, or \c write_report() ,
+  /// which lists the duration, wait time, broadcast volume, and efficiency of
+  /// each step.
+  class SummaTrace {
+  public:
+    typedef std::chrono::steady_clock clock_type; ///< Clock type
+
+    /// Trace event record
+    struct Event {
+      std::uint64_t time; ///< Nanoseconds since the start of the trace
+      std::uint64_t k; ///< The step, or the result tile of a reduction
+      std::uint64_t value; ///< Bytes of a broadcast, or ns waited for tiles
+      std::uint32_t count; ///< Tiles of a broadcast, or pairs of a reduction
+      std::uint32_t group; ///< The size of the broadcast group
+      std::uint32_t object; ///< The id of the contraction
+      std::uint16_t thread; ///< The index of the recording thread
+      SummaEventKind kind; ///< The event type
+      std::uint8_t reserved; ///< Padding
+    }; // struct Event
+
+  private:
+
+    /// The events of a thread
+    struct ThreadEvents {
+      std::mutex lock; ///< Lock for events, which is only contended by \c events()
+      std::vector<Event> events; ///< The recorded events
+      const std::uint16_t thread; ///< The thread index
+
+      explicit ThreadEvents(const std::uint16_t t) : lock(), events(), thread(t) { }
+    }; // struct ThreadEvents
+
+    std::atomic<bool> enabled_; ///< Tracing flag
+    const clock_type::time_point start_; ///< The time origin of the trace
+    mutable std::mutex lock_; ///< Lock for the thread list
+    std::vector<std::unique_ptr<ThreadEvents> > threads_; ///< Events of all threads
+
+    SummaTrace() :
+      enabled_(getenv("TA_SUMMA_TRACE") != nullptr), start_(clock_type::now()),
+      lock_(), threads_()
+    { }
+
+    SummaTrace(const SummaTrace&) = delete;
+    SummaTrace& operator=(const SummaTrace&) = delete;
+
+    /// Event list accessor
+
+    /// \return The event list of the calling thread
+    ThreadEvents& thread_events() {
+      static thread_local ThreadEvents* events = nullptr;
+      if(! events) {
+        std::lock_guard<std::mutex> locker(lock_);
+        threads_.emplace_back(new ThreadEvents(threads_.size()));
+        events = threads_.back().get();
+      }
+      return *events;
+    }
+
+    /// The file header of a binary trace
+    static const char* magic() { return "TASUMMA1"; }
+
+    /// Trace time of an event in microseconds
+    static double micro(const std::uint64_t ns) { return double(ns) * 1.0e-3; }
+
+  public:
+
+    /// Trace accessor
+
+    /// \return A reference to the SUMMA trace of this process
+    static SummaTrace& instance() {
+      static SummaTrace* const trace = new SummaTrace();
+      return *trace;
+    }
+
+    /// Enable tracing
+    void enable() { enabled_.store(true, std::memory_order_relaxed); }
+
+    /// Disable tracing
+
+    /// Recorded events are kept.
+    void disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+    /// Tracing status
+
+    /// \return \c true if events are recorded
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    /// Current trace time
+
+    /// \return The number of nanoseconds since the start of the trace
+    std::uint64_t now() const {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          clock_type::now() - start_).count();
+    }
+
+    /// Record an event
+
+    /// Nothing is recorded when tracing is disabled.
+    /// \param kind The event type
+    /// \param object The id of the contraction
+    /// \param k The step, or the result tile of a reduction
+    /// \param value The bytes of a broadcast, or the nanoseconds a step
+    /// waited for its tiles
+    /// \param count The tiles of a broadcast, or the pairs of a reduction
+    /// \param group The size of the broadcast group
+    void record(const SummaEventKind kind, const std::uint64_t object,
+        const std::uint64_t k, const std::uint64_t value = 0ul,
+        const std::uint64_t count = 0ul, const std::uint64_t group = 0ul)
+    {
+      if(! enabled())
+        return;
+      ThreadEvents& events = thread_events();
+      const Event event = { now(), k, value, std::uint32_t(count),
+          std::uint32_t(group), std::uint32_t(object), events.thread, kind, 0u };
+      std::lock_guard<std::mutex> locker(events.lock);
+      events.events.push_back(event);
+    }
+
+    /// Recorded events
+
+    /// \return The events of all threads, ordered by time
+    std::vector<Event> events() const {
+      std::vector<Event> result;
+      {
+        std::lock_guard<std::mutex> locker(lock_);
+        for(const std::unique_ptr<ThreadEvents>& events : threads_) {
+          std::lock_guard<std::mutex> events_locker(events->lock);
+          result.insert(result.end(), events->events.begin(), events->events.end());
+        }
+      }
+      std::stable_sort(result.begin(), result.end(),
+          [] (const Event& a, const Event& b) { return a.time < b.time; });
+      return result;
+    }
+
+    /// Discard all recorded events
+    void clear() {
+      std::lock_guard<std::mutex> locker(lock_);
+      for(std::unique_ptr<ThreadEvents>& events : threads_) {
+        std::lock_guard<std::mutex> events_locker(events->lock);
+        events->events.clear();
+      }
+    }
+
+    /// Write the events in the binary trace format
+
+    /// \param os The output stream, which must be opened in binary mode
+    void write(std::ostream& os) const {
+      const std::vector<Event> events = this->events();
+      const std::uint64_t header[2] = { sizeof(Event), events.size() };
+      os.write(magic(), 8);
+      os.write(reinterpret_cast<const char*>(header), sizeof(header));
+      if(! events.empty())
+        os.write(reinterpret_cast<const char*>(events.data()),
+            events.size() * sizeof(Event));
+    }
+
+    /// Write the events of this process to a binary trace file
+
+    /// The events are written to <tt>prefix.rank.bin</tt> .
+    /// \param rank The rank of this process
+    /// \param prefix The file name prefix
+    /// \throw TiledArray::Exception When the file cannot be opened
+    void write(const int rank, const std::string& prefix) const {
+      std::stringstream ss;
+      ss << prefix << "." << rank << ".bin";
+      std::ofstream file(ss.str().c_str(), std::ios::binary);
+      TA_USER_ASSERT(file.good(), "SummaTrace::write(): Unable to open trace file.");
+      write(file);
+    }
+
+    /// Read a binary trace
+
+    /// \param is The input stream, which must be opened in binary mode
+    /// \return The events of the trace
+    /// \throw TiledArray::Exception When \c is does not hold a trace written
+    /// by \c write() with the same event layout
+    static std::vector<Event> read(std::istream& is) {
+      char head[8];
+      std::uint64_t header[2] = { 0ul, 0ul };
+      is.read(head, 8);
+      is.read(reinterpret_cast<char*>(header), sizeof(header));
+      TA_USER_ASSERT(is.good() && (std::memcmp(head, magic(), 8) == 0) &&
+          (header[0] == sizeof(Event)),
+          "SummaTrace::read(): The stream does not hold a SUMMA trace.");
+      std::vector<Event> events(header[1]);
+      if(! events.empty())
+        is.read(reinterpret_cast<char*>(events.data()), events.size() * sizeof(Event));
+      TA_USER_ASSERT(is.good(), "SummaTrace::read(): The trace is truncated.");
+      return events;
+    }
+
+    /// Write a timeline of events in the Chrome trace event format
+
+    /// Each step is a complete event from its start to the end of its tile
+    /// contractions, preceded by a \c summa_wait event for the time it
+    /// waited for its argument tiles. Broadcasts and reductions are instant
+    /// events. The timeline can be viewed with \c chrome://tracing or
+    /// Perfetto.
+    /// \param os The output stream
+    /// \param events The events of one process
+    /// \param rank The rank of the process
+    static void write_timeline(std::ostream& os, const std::vector<Event>& events,
+        const int rank)
+    {
+      std::map<std::pair<std::uint32_t, std::uint64_t>, const Event*> begins;
+      os << "{\"traceEvents\":[";
+      bool first = true;
+      auto separate = [&] () {
+        if(! first)
+          os << ",";
+        first = false;
+        os << "\n";
+      };
+      for(const Event& event : events) {
+        const std::pair<std::uint32_t, std::uint64_t> key(event.object, event.k);
+        switch(event.kind) {
+          case SummaEventKind::step_begin:
+            begins[key] = &event;
+            break;
+          case SummaEventKind::step_end:
+          {
+            const auto it = begins.find(key);
+            if(it == begins.end())
+              break;
+            separate();
+            os << "{\"name\":\"summa_step\",\"cat\":\"summa\",\"ph\":\"X\",\"ts\":"
+               << micro(it->second->time) << ",\"dur\":"
+               << micro(event.time - it->second->time) << ",\"pid\":" << rank
+               << ",\"tid\":\"summa " << event.object << "\",\"args\":{\"k\":"
+               << event.k << "}}";
+            begins.erase(it);
+            break;
+          }
+          case SummaEventKind::tiles_ready:
+            separate();
+            os << "{\"name\":\"summa_wait\",\"cat\":\"summa\",\"ph\":\"X\",\"ts\":"
+               << micro(event.time - std::min(event.value, event.time))
+               << ",\"dur\":" << micro(event.value) << ",\"pid\":" << rank
+               << ",\"tid\":\"wait " << event.object << "\",\"args\":{\"k\":"
+               << event.k << "}}";
+            break;
+          case SummaEventKind::bcast_col:
+          case SummaEventKind::bcast_row:
+            separate();
+            os << "{\"name\":\""
+               << (event.kind == SummaEventKind::bcast_col ? "bcast_col" : "bcast_row")
+               << "\",\"cat\":\"comm\",\"ph\":\"i\",\"s\":\"t\",\"ts\":"
+               << micro(event.time) << ",\"pid\":" << rank << ",\"tid\":"
+               << event.thread << ",\"args\":{\"k\":" << event.k << ",\"tiles\":"
+               << event.count << ",\"bytes\":" << event.value << ",\"group\":"
+               << event.group << "}}";
+            break;
+          case SummaEventKind::reduce_submit:
+            separate();
+            os << "{\"name\":\"reduce_submit\",\"cat\":\"summa\",\"ph\":\"i\",\"s\":\"t\",\"ts\":"
+               << micro(event.time) << ",\"pid\":" << rank << ",\"tid\":"
+               << event.thread << ",\"args\":{\"tile\":" << event.k
+               << ",\"pairs\":" << event.count << "}}";
+            break;
+        }
+      }
+      os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    }
+
+    /// Per-step statistics of a trace
+    struct Step {
+      std::uint32_t object; ///< The id of the contraction
+      std::uint64_t k; ///< The step
+      std::uint64_t begin; ///< The start time of the step in ns
+      std::uint64_t end; ///< The end time of the step in ns, or zero if unknown
+      std::uint64_t wait; ///< The time the step waited for its tiles in ns
+      std::uint64_t tiles; ///< The number of tiles broadcast
+      std::uint64_t bytes; ///< The number of bytes sent
+      std::uint32_t group; ///< The size of the largest broadcast group
+
+      /// The fraction of the step that was not spent waiting for tiles
+      double efficiency() const {
+        const std::uint64_t duration = (end > begin ? end - begin : 0ul);
+        return (duration ?
+            1.0 - double(std::min(wait, duration)) / double(duration) : 1.0);
+      }
+    }; // struct Step
+
+    /// Collect the per-step statistics of a trace
+
+    /// \param events The events of one process
+    /// \return The statistics of each step, ordered by contraction and step
+    static std::vector<Step> steps(const std::vector<Event>& events) {
+      std::map<std::pair<std::uint32_t, std::uint64_t>, Step> steps;
+      auto step = [&] (const Event& event) -> Step& {
+        const std::pair<std::uint32_t, std::uint64_t> key(event.object, event.k);
+        auto it = steps.find(key);
+        if(it == steps.end())
+          it = steps.emplace(key, Step{ event.object, event.k, event.time, 0ul,
+              0ul, 0ul, 0ul, 0u }).first;
+        return it->second;
+      };
+      for(const Event& event : events) {
+        switch(event.kind) {
+          case SummaEventKind::step_begin:
+            step(event).begin = event.time;
+            break;
+          case SummaEventKind::step_end:
+            step(event).end = std::max(step(event).end, event.time);
+            break;
+          case SummaEventKind::tiles_ready:
+            step(event).wait = event.value;
+            break;
+          case SummaEventKind::bcast_col:
+          case SummaEventKind::bcast_row:
+          {
+            Step& s = step(event);
+            s.tiles += event.count;
+            s.bytes += event.value;
+            s.group = std::max(s.group, event.group);
+            break;
+          }
+          case SummaEventKind::reduce_submit:
+            break;
+        }
+      }
+
+      std::vector<Step> result;
+      result.reserve(steps.size());
+      for(const auto& s : steps)
+        result.push_back(s.second);
+      return result;
+    }
+
+    /// Write the per-step efficiency report of a trace
+
+    /// One line is written for each step, with the start time and duration
+    /// of the step, the time it waited for its argument tiles, the tiles and
+    /// bytes broadcast, the largest broadcast group, and the efficiency,
+    /// which is the fraction of the step that was not spent waiting. The last
+    /// line of each contraction gives the totals.
+    /// \param os The output stream
+    /// \param events The events of one process
+    static void write_report(std::ostream& os, const std::vector<Event>& events) {
+      const std::vector<Step> steps = SummaTrace::steps(events);
+      os << std::setw(8) << "summa" << std::setw(8) << "k"
+         << std::setw(14) << "begin(us)" << std::setw(14) << "time(us)"
+         << std::setw(14) << "wait(us)" << std::setw(8) << "tiles"
+         << std::setw(14) << "bytes" << std::setw(7) << "group"
+         << std::setw(8) << "eff" << "\n";
+      const std::ios::fmtflags flags = os.flags();
+      const std::streamsize precision = os.precision();
+      os << std::fixed << std::setprecision(1);
+      for(std::size_t i = 0ul; i < steps.size(); ++i) {
+        const Step& s = steps[i];
+        const std::uint64_t duration = (s.end > s.begin ? s.end - s.begin : 0ul);
+        os << std::setw(8) << s.object << std::setw(8) << s.k
+           << std::setw(14) << micro(s.begin) << std::setw(14) << micro(duration)
+           << std::setw(14) << micro(s.wait) << std::setw(8) << s.tiles
+           << std::setw(14) << s.bytes << std::setw(7) << s.group
+           << std::setw(8) << std::setprecision(3) << s.efficiency()
+           << std::setprecision(1) << "\n";
+
+        // Totals of the contraction
+        if((i + 1ul == steps.size()) || (steps[i + 1ul].object != s.object)) {
+          std::uint64_t begin = s.begin, end = s.end, wait = 0ul, tiles = 0ul,
+              bytes = 0ul;
+          for(std::size_t j = i + 1ul; j > 0ul && steps[j - 1ul].object == s.object; --j) {
+            const Step& t = steps[j - 1ul];
+            begin = std::min(begin, t.begin);
+            end = std::max(end, t.end);
+            wait += t.wait;
+            tiles += t.tiles;
+            bytes += t.bytes;
+          }
+          os << std::setw(8) << s.object << std::setw(8) << "total"
+             << std::setw(14) << micro(begin)
+             << std::setw(14) << micro(end > begin ? end - begin : 0ul)
+             << std::setw(14) << micro(wait) << std::setw(8) << tiles
+             << std::setw(14) << bytes << "\n";
+        }
+      }
+      os.flags(flags);
+      os.precision(precision);
+    }
+
+  }; // class SummaTrace
+
+  /// Write the SUMMA trace of this process when requested
+
+  /// The trace is written when the \c TA_SUMMA_TRACE environment variable is
+  /// set (see \c SummaTrace ); this is called by \c TiledArray::finalize() .
+  /// \param rank The rank of this process
+  inline void write_summa_trace(const int rank) {
+    const char* const prefix = getenv("TA_SUMMA_TRACE");
+    if(prefix && (prefix[0] != '\0'))
+      SummaTrace::instance().write(rank, prefix);
+  }
+
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_SUMMA_TRACE_H__INCLUDED
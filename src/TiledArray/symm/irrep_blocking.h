@@ -0,0 +1,240 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  irrep_blocking.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_SYMM_IRREP_BLOCKING_H__INCLUDED
+#define TILEDARRAY_SYMM_IRREP_BLOCKING_H__INCLUDED
+
+#include <vector>
+
+#include <TiledArray/sparse_shape.h>
+#include <TiledArray/tiled_range.h>
+#include <TiledArray/math/gemm_helper.h>
+
+namespace TiledArray {
+
+  namespace symmetry {
+
+    /**
+     * \addtogroup symmetry
+     * @{
+     */
+
+    /// Point group symmetry blocking of a tiled range
+
+    /// IrrepBlocking assigns an irreducible representation of an abelian
+    /// point group (\f$ D_{2h} \f$ and its subgroups) to every tile of each
+    /// TiledRange1 of a tiled range, i.e. each tile must hold basis functions
+    /// of a single irrep. The irreps of these groups are labeled by
+    /// \c [0,8) (with \c 0 the totally symmetric irrep) so that the direct
+    /// product of two irreps is the bitwise exclusive or of their labels.
+    /// A tile of a tensor that transforms as irrep \c s is structurally zero
+    /// unless the direct product of its tile irreps is \c s .
+    /// \note The symmetric group irreps in irrep.h describe permutational
+    /// symmetry and are not used here.
+    class IrrepBlocking {
+    public:
+      typedef std::vector<unsigned int> labels_type; ///< Tile irreps of one dimension
+
+    private:
+      std::vector<labels_type> labels_; ///< The irrep of each tile, per dimension
+      unsigned int symmetry_; ///< The irrep of the tensor
+
+    public:
+
+      IrrepBlocking() = default;
+      IrrepBlocking(const IrrepBlocking&) = default;
+      IrrepBlocking(IrrepBlocking&&) = default;
+      IrrepBlocking& operator=(const IrrepBlocking&) = default;
+      IrrepBlocking& operator=(IrrepBlocking&&) = default;
+
+      /// Constructor
+
+      /// \param labels The irrep of each tile, where <tt>labels[d][t]</tt> is
+      /// the irrep of tile \c t of dimension \c d
+      /// \param symmetry The irrep of the tensor
+      IrrepBlocking(std::vector<labels_type> labels, const unsigned int symmetry = 0u) :
+        labels_(std::move(labels)), symmetry_(symmetry)
+      { }
+
+      /// Rank accessor
+
+      /// \return The number of dimensions
+      unsigned int rank() const { return labels_.size(); }
+
+      /// Tensor irrep accessor
+
+      /// \return The irrep of the tensor
+      unsigned int symmetry() const { return symmetry_; }
+
+      /// Tile irrep labels accessor
+
+      /// \param d The dimension
+      /// \return The irrep labels of the tiles in dimension \c d
+      const labels_type& labels(const unsigned int d) const {
+        TA_ASSERT(d < labels_.size());
+        return labels_[d];
+      }
+
+      /// Check that this blocking matches a tiled range
+
+      /// \param trange The tiled range
+      /// \return \c true when there is one label for each tile of \c trange
+      /// and the tile indices of \c trange start at zero
+      bool validate(const TiledRange& trange) const {
+        if(labels_.size() != trange.tiles_range().rank())
+          return false;
+        for(unsigned int d = 0u; d < labels_.size(); ++d)
+          if((trange.data()[d].tiles_range().first != 0ul) ||
+              (labels_[d].size() != trange.data()[d].tile_extent()))
+            return false;
+        return true;
+      }
+
+      /// Irrep of a tile
+
+      /// \tparam Index The tile coordinate index type
+      /// \param index The tile coordinate index
+      /// \return The direct product of the irreps of the tile dimensions
+      template <typename Index>
+      unsigned int irrep(const Index& index) const {
+        TA_ASSERT(index.size() == labels_.size());
+        unsigned int result = 0u;
+        unsigned int d = 0u;
+        for(auto it = std::begin(index); it != std::end(index); ++it, ++d) {
+          TA_ASSERT(std::size_t(*it) < labels_[d].size());
+          result ^= labels_[d][*it];
+        }
+        return result;
+      }
+
+      /// Structural zero check
+
+      /// \tparam Index The tile coordinate index type
+      /// \param index The tile coordinate index
+      /// \return \c true when the tile at \c index is zero by symmetry
+      template <typename Index>
+      bool is_zero(const Index& index) const {
+        return irrep(index) != symmetry_;
+      }
+
+      /// Permute the blocking
+
+      /// \param perm The permutation to be applied
+      /// \return A permuted copy of this blocking
+      IrrepBlocking perm(const Permutation& perm) const {
+        return IrrepBlocking(perm * labels_, symmetry_);
+      }
+
+      /// Blocking of a contraction result
+
+      /// The contracted dimensions of the arguments must have the same
+      /// labels; the result transforms as the direct product of the argument
+      /// irreps.
+      /// \param other The right-hand argument blocking
+      /// \param gemm_helper The helper that describes the contraction
+      /// \return The blocking of the result
+      IrrepBlocking gemm(const IrrepBlocking& other, const math::GemmHelper& gemm_helper) const {
+        TA_ASSERT(gemm_helper.left_rank() == rank());
+        TA_ASSERT(gemm_helper.right_rank() == other.rank());
+
+        std::vector<labels_type> result;
+        result.reserve(gemm_helper.result_rank());
+        for(unsigned int d = gemm_helper.left_outer_begin(); d < gemm_helper.left_outer_end(); ++d)
+          result.push_back(labels_[d]);
+        for(unsigned int d = gemm_helper.right_outer_begin(); d < gemm_helper.right_outer_end(); ++d)
+          result.push_back(other.labels_[d]);
+
+        return IrrepBlocking(std::move(result), symmetry_ ^ other.symmetry_);
+      }
+
+    }; // class IrrepBlocking
+
+    /// Construct a shape that is blocked by point group symmetry
+
+    /// \c tile_norm is evaluated only for tiles that are allowed by symmetry;
+    /// all other tiles are set to exactly zero, so they are skipped by
+    /// SparseShape::gemm and the contraction evaluator independent of the
+    /// zero threshold.
+    /// \tparam Op The tile norm operation type
+    /// \param trange The tiled range of the array
+    /// \param blocking The irrep blocking of \c trange
+    /// \param tile_norm A function that takes the ordinal index of a tile and
+    /// returns its Frobenius norm
+    /// \return The shape of the array
+    template <typename Op>
+    inline SparseShape<float> make_shape(const TiledRange& trange,
+        const IrrepBlocking& blocking, Op&& tile_norm)
+    {
+      TA_USER_ASSERT(blocking.validate(trange),
+          "symmetry::make_shape(): The irrep blocking does not match the tiled range.");
+
+      const auto& tiles_range = trange.tiles_range();
+      Tensor<float> norms(tiles_range, 0.0f);
+      for(std::size_t i = 0ul; i < tiles_range.volume(); ++i)
+        if(! blocking.is_zero(tiles_range.idx(i)))
+          norms[i] = tile_norm(i);
+
+      return SparseShape<float>(norms, trange);
+    }
+
+    /// Construct a shape that is dense within the symmetry blocks
+
+    /// \param trange The tiled range of the array
+    /// \param blocking The irrep blocking of \c trange
+    /// \return A shape where exactly the tiles allowed by symmetry are
+    /// non-zero
+    inline SparseShape<float> make_shape(const TiledRange& trange,
+        const IrrepBlocking& blocking)
+    {
+      return make_shape(trange, blocking, [&] (const std::size_t i) -> float {
+        return trange.make_tile_range(i).volume();
+      });
+    }
+
+    /// Mask a shape with point group symmetry
+
+    /// \param shape The shape to be masked
+    /// \param blocking The irrep blocking of the array
+    /// \return A copy of \c shape where tiles that are zero by symmetry are
+    /// exactly zero
+    inline SparseShape<float> mask(const SparseShape<float>& shape,
+        const IrrepBlocking& blocking)
+    {
+      return shape.transform([&] (const Tensor<float>& norms) {
+        Tensor<float> result = norms.clone();
+        const auto& tiles_range = norms.range();
+        for(std::size_t i = 0ul; i < tiles_range.volume(); ++i)
+          if(blocking.is_zero(tiles_range.idx(i)))
+            result[i] = 0.0f;
+        return result;
+      });
+    }
+
+    /** @}*/
+
+  } // namespace symmetry
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SYMM_IRREP_BLOCKING_H__INCLUDED
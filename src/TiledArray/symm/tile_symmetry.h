@@ -0,0 +1,241 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Edward F Valeev, Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_symmetry.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+#define TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include <TiledArray/permutation.h>
+#include <TiledArray/symm/permutation_group.h>
+#include <TiledArray/symm/representation.h>
+
+namespace TiledArray {
+
+  namespace symmetry {
+
+    /**
+     * \addtogroup symmetry
+     * @{
+     */
+
+    /// The identity of the sign representation
+    template <> inline int identity<int>() { return 1; }
+
+    /// Permutational symmetry of the tiles of an array
+
+    /// TileSymmetry describes a tensor \f$ t \f$ that satisfies
+    /// \f$ t_{g x} = \chi(g) t_{x} \f$ for every element \f$ g \f$ of a
+    /// PermutationGroup, where \f$ \chi(g) = \pm 1 \f$ . Since the modes
+    /// related by the group are tiled identically, the same relation holds
+    /// for tiles. The tile whose index is lexicographically smallest in its
+    /// orbit is the \em unique tile; every other tile in the orbit is obtained
+    /// from it by a permutation and the factor \f$ \chi \f$ .
+    class TileSymmetry {
+    public:
+      typedef PermutationGroup::Permutation Permutation; ///< Group element type
+      typedef std::vector<std::size_t> index; ///< Tile index type
+
+      /// The relation between a tile and the unique tile of its orbit
+
+      /// The tile at index \c i is equal to
+      /// <tt>factor * permute(tile(unique), perm)</tt>
+      struct TileMap {
+        index unique; ///< The index of the unique tile
+        Permutation perm; ///< The permutation that maps \c unique to \c i
+        int factor; ///< The sign of the mapping
+      }; // struct TileMap
+
+    private:
+      PermutationGroup group_; ///< The symmetry group
+      std::map<Permutation, int> factors_; ///< The sign of each group element
+
+      /// Compute the parity of a permutation
+
+      /// \param p The permutation
+      /// \return \c -1 if \c p is odd, otherwise \c 1
+      static int parity(const Permutation& p) {
+        std::size_t transpositions = 0ul;
+        for(const auto& cycle : p.cycles())
+          transpositions += cycle.size() - 1ul;
+        return (transpositions & 1ul ? -1 : 1);
+      }
+
+      template <typename Index>
+      static index make_index(const Index& i) {
+        return index(std::begin(i), std::end(i));
+      }
+
+    public:
+
+      TileSymmetry() = delete;
+      TileSymmetry(const TileSymmetry&) = default;
+      TileSymmetry(TileSymmetry&&) = default;
+      TileSymmetry& operator=(const TileSymmetry&) = default;
+      TileSymmetry& operator=(TileSymmetry&&) = default;
+
+      /// Construct a symmetric or antisymmetric tile symmetry
+
+      /// \param group The permutation group of the tensor modes
+      /// \param antisymmetric When \c true, odd permutations flip the sign
+      /// of the tensor; otherwise the tensor is symmetric under \c group
+      TileSymmetry(PermutationGroup group, const bool antisymmetric) :
+        group_(std::move(group)), factors_()
+      {
+        for(const auto& g : group_)
+          factors_.emplace(g, (antisymmetric ? parity(g) : 1));
+      }
+
+      /// Construct a tile symmetry from a sign representation
+
+      /// \param rep The representation of the group, where each element is
+      /// represented by \c 1 or \c -1
+      TileSymmetry(const Representation<PermutationGroup, int>& rep) :
+        group_(* rep.group()), factors_(rep.representatives())
+      {
+#ifndef NDEBUG
+        for(const auto& g_factor : factors_)
+          TA_ASSERT((g_factor.second == 1) || (g_factor.second == -1));
+#endif // NDEBUG
+      }
+
+      /// Symmetry group accessor
+
+      /// \return A const reference to the symmetry group
+      const PermutationGroup& group() const { return group_; }
+
+      /// Sign accessor
+
+      /// \param g An element of the symmetry group
+      /// \return The sign of \c g
+      int factor(const Permutation& g) const {
+        TA_ASSERT(factors_.find(g) != factors_.end());
+        return factors_.find(g)->second;
+      }
+
+      /// Check that the symmetric modes are tiled identically
+
+      /// \tparam TRange The tiled range type
+      /// \param trange The tiled range of the array
+      /// \return \c true when every group element maps each mode onto a mode
+      /// with the same tiling
+      template <typename TRange>
+      bool validate(const TRange& trange) const {
+        const std::size_t rank = trange.tiles_range().rank();
+        for(const auto& g : group_.generators()) {
+          for(const auto& i_gi : g.data()) {
+            if((i_gi.first >= rank) || (i_gi.second >= rank))
+              return false;
+            if(! (trange.data()[i_gi.first] == trange.data()[i_gi.second]))
+              return false;
+          }
+        }
+        return true;
+      }
+
+      /// Check for a unique tile
+
+      /// \tparam Index The tile index type
+      /// \param i The tile index
+      /// \return \c true when \c i is the lexicographically smallest index in
+      /// its orbit
+      template <typename Index>
+      bool is_unique(const Index& i) const {
+        return is_lexicographically_smallest(make_index(i), group_);
+      }
+
+      /// Map a tile onto the unique tile of its orbit
+
+      /// \tparam Index The tile index type
+      /// \param i The tile index
+      /// \return The unique tile index and the transformation that produces
+      /// tile \c i from it
+      template <typename Index>
+      TileMap map(const Index& i) const {
+        const index idx = make_index(i);
+        TileMap result{idx, Permutation(), 1};
+        Permutation g_min;
+        for(const auto& g : group_) {
+          index gi = g * idx;
+          if(gi < result.unique) {
+            result.unique = std::move(gi);
+            g_min = g;
+          }
+        }
+
+        // tile(i) = tile(g^-1 unique) = factor(g^-1) * permute(tile(unique), g^-1)
+        result.perm = g_min.inv();
+        result.factor = factor(result.perm);
+        return result;
+      }
+
+      /// Number of distinct tiles in an orbit restricted to a set of modes
+
+      /// The orbit is generated by the subgroup of elements that act only on
+      /// \c modes , i.e. that leave every other mode in the domain of the
+      /// group fixed. This is the number of tiles of a contraction over
+      /// \c modes that are represented by tile \c i .
+      /// \tparam Index The tile index type
+      /// \param i The tile index
+      /// \param modes The modes of the subgroup
+      /// \return The number of distinct tile indices in the orbit
+      template <typename Index>
+      std::size_t orbit_size(const Index& i, const std::vector<unsigned int>& modes) const {
+        std::set<unsigned int> fixed = group_.domain<std::set<unsigned int> >();
+        for(const unsigned int m : modes)
+          fixed.erase(m);
+        const PermutationGroup subgroup = stabilizer(group_, fixed);
+
+        const index idx = make_index(i);
+        std::set<index> orbit;
+        for(const auto& h : subgroup)
+          orbit.insert(h * idx);
+        return orbit.size();
+      }
+
+      /// Convert a group element to a TiledArray::Permutation
+
+      /// \param g A group element
+      /// \param rank The rank of the tensor
+      /// \return The one-line form of \c g on <tt>[0, rank)</tt>
+      static TiledArray::Permutation to_permutation(const Permutation& g,
+          const unsigned int rank)
+      {
+        std::vector<unsigned int> p(rank);
+        for(unsigned int i = 0u; i < rank; ++i)
+          p[i] = g[i];
+        return TiledArray::Permutation(std::move(p));
+      }
+
+    }; // class TileSymmetry
+
+    /** @}*/
+
+  } // namespace symmetry
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SYMM_TILE_SYMMETRY_H__INCLUDED
@@ -0,0 +1,258 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  symm_array.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_SYMM_ARRAY_H__INCLUDED
+#define TILEDARRAY_SYMM_ARRAY_H__INCLUDED
+
+#include <TiledArray/dist_array.h>
+#include <TiledArray/symm/tile_symmetry.h>
+
+namespace TiledArray {
+
+  /// Symmetry-packed distributed array
+
+  /// SymmArray stores only the unique tiles of an array with permutational
+  /// symmetry (e.g. the tiles with \f$ I \le J, A \le B \f$ of
+  /// \f$ t^{ab}_{ij} \f$ ). The packed array is an ordinary sparse array in
+  /// which every non-unique tile is zero, so it may be used directly in
+  /// expressions; the shape screening then restricts all work to the unique
+  /// tiles. Non-unique tiles are reconstructed on demand by \c find .
+  ///
+  /// A contraction over a set of symmetric modes visits each orbit of the
+  /// contracted tiles once. To obtain the full sum, one of the operands is
+  /// weighted by the orbit size with \c contraction_operand :
+  /// \code
+  /// // v and t are packed with the group generated by (01) and (23)
+  /// r("a,b,i,j") = v.contraction_operand({2,3})("a,b,c,d") * t("c,d,i,j");
+  /// \endcode
+  /// The result is again packed with respect to the uncontracted modes.
+  /// \tparam Tile The tile type
+  template <typename Tile>
+  class SymmArray {
+  public:
+    typedef SymmArray<Tile> SymmArray_; ///< This object type
+    typedef DistArray<Tile, SparsePolicy> array_type; ///< Packed array type
+    typedef typename array_type::value_type value_type; ///< Tile type
+    typedef typename array_type::size_type size_type; ///< Size type
+    typedef typename array_type::shape_type shape_type; ///< Shape type
+    typedef symmetry::TileSymmetry symmetry_type; ///< Tile symmetry type
+
+  private:
+
+    array_type array_; ///< The packed array
+    std::shared_ptr<symmetry_type> symm_; ///< The tile symmetry
+
+  public:
+
+    SymmArray() = default;
+    SymmArray(const SymmArray_&) = default;
+    SymmArray(SymmArray_&&) = default;
+    SymmArray_& operator=(const SymmArray_&) = default;
+    SymmArray_& operator=(SymmArray_&&) = default;
+
+    /// Pack an array
+
+    /// The unique tiles of \c arg are shared with the packed array; the other
+    /// tiles of \c arg are not referenced.
+    /// \param arg The full array
+    /// \param symm The symmetry of \c arg
+    /// \throw TiledArray::Exception When the symmetric modes of \c arg are not
+    /// tiled identically.
+    SymmArray(const array_type& arg, const symmetry_type& symm) :
+      array_(), symm_(std::make_shared<symmetry_type>(symm))
+    {
+      TA_USER_ASSERT(symm_->validate(arg.trange()),
+          "SymmArray::SymmArray(): The symmetric modes must have identical tilings.");
+
+      const auto& tiles_range = arg.trange().tiles_range();
+      const symmetry_type& s = *symm_;
+      const shape_type shape = arg.shape().transform(
+          [&] (const Tensor<typename shape_type::value_type>& norms) {
+            Tensor<typename shape_type::value_type> result = norms.clone();
+            for(size_type i = 0ul; i < tiles_range.volume(); ++i)
+              if(! s.is_unique(tiles_range.idx(i)))
+                result[i] = 0;
+            return result;
+          });
+
+      array_ = array_type(arg.world(), arg.trange(), shape, arg.pmap());
+      for(auto index : * array_.pmap()) {
+        if(array_.is_zero(index))
+          continue;
+        array_.set(index, arg.find(index));
+      }
+    }
+
+    /// Packed array accessor
+
+    /// \return A const reference to the array that holds the unique tiles
+    const array_type& array() const { return array_; }
+
+    /// Tile symmetry accessor
+
+    /// \return A const reference to the tile symmetry
+    const symmetry_type& symmetry() const { return *symm_; }
+
+    /// World accessor
+
+    /// \return A reference to the world that owns the array
+    World& world() const { return array_.world(); }
+
+    /// Tiled range accessor
+
+    /// \return A const reference to the tiled range of the (full) array
+    const TiledRange& trange() const { return array_.trange(); }
+
+    /// Unique tile check
+
+    /// \tparam Index The index type
+    /// \param i The tile index
+    /// \return \c true when tile \c i is stored in the packed array
+    template <typename Index>
+    bool is_unique(const Index& i) const {
+      return symm_->is_unique(array_.trange().tiles_range().idx(i));
+    }
+
+    /// Zero tile check
+
+    /// \tparam Index The index type
+    /// \param i The tile index
+    /// \return \c true when tile \c i of the full array is zero
+    template <typename Index>
+    bool is_zero(const Index& i) const {
+      return array_.is_zero(symm_->map(array_.trange().tiles_range().idx(i)).unique);
+    }
+
+    /// Find a tile of the full array
+
+    /// A unique tile is returned as stored. Any other tile is constructed
+    /// from the unique tile of its orbit by a permutation and a sign change.
+    /// \tparam Index The index type
+    /// \param i The tile index
+    /// \return A future to tile \c i
+    template <typename Index>
+    Future<value_type> find(const Index& i) const {
+      const auto tile_map = symm_->map(array_.trange().tiles_range().idx(i));
+      Future<value_type> tile = array_.find(tile_map.unique);
+      if(tile_map.perm == symmetry::TileSymmetry::Permutation())
+        return tile;
+
+      const Permutation perm = symmetry_type::to_permutation(tile_map.perm,
+          array_.trange().tiles_range().rank());
+      const int factor = tile_map.factor;
+      return world().taskq.add([perm, factor] (const value_type& arg) -> value_type {
+            using TiledArray::permute;
+            using TiledArray::scale;
+            return (factor == 1 ? permute(arg, perm) : scale(arg, factor, perm));
+          }, tile);
+    }
+
+    /// Find a tile of the full array
+
+    /// \tparam Integer An integer type
+    /// \param i The tile index
+    /// \return A future to tile \c i
+    template <typename Integer>
+    Future<value_type> find(const std::initializer_list<Integer>& i) const {
+      return find<std::initializer_list<Integer> >(i);
+    }
+
+    /// Reconstruct the full array
+
+    /// \return An array that holds every tile
+    array_type unpack() const {
+      const auto& tiles_range = array_.trange().tiles_range();
+      const symmetry_type& s = *symm_;
+      const shape_type shape = array_.shape().transform(
+          [&] (const Tensor<typename shape_type::value_type>& norms) {
+            Tensor<typename shape_type::value_type> result(norms.range());
+            for(size_type i = 0ul; i < tiles_range.volume(); ++i)
+              result[i] = norms[s.map(tiles_range.idx(i)).unique];
+            return result;
+          });
+
+      array_type result(world(), array_.trange(), shape, array_.pmap());
+      for(auto index : * result.pmap()) {
+        if(result.is_zero(index))
+          continue;
+        result.set(index, find(index));
+      }
+
+      return result;
+    }
+
+    /// Weight the packed array for a contraction over symmetric modes
+
+    /// Each unique tile is scaled by the number of tiles it represents in a
+    /// sum over \c modes (see symmetry::TileSymmetry::orbit_size ).
+    /// \param modes The modes that will be contracted
+    /// \return A weighted copy of the packed array
+    array_type contraction_operand(const std::vector<unsigned int>& modes) const {
+      const auto& tiles_range = array_.trange().tiles_range();
+      const symmetry_type& s = *symm_;
+      const shape_type shape = array_.shape().transform(
+          [&] (const Tensor<typename shape_type::value_type>& norms) {
+            Tensor<typename shape_type::value_type> result = norms.clone();
+            for(size_type i = 0ul; i < tiles_range.volume(); ++i)
+              if(result[i] > 0)
+                result[i] *= s.orbit_size(tiles_range.idx(i), modes);
+            return result;
+          });
+
+      array_type result(world(), array_.trange(), shape, array_.pmap());
+      for(auto index : * result.pmap()) {
+        if(result.is_zero(index))
+          continue;
+        const std::size_t weight = s.orbit_size(tiles_range.idx(index), modes);
+        result.set(index, world().taskq.add([weight] (const value_type& arg) -> value_type {
+              using TiledArray::scale;
+              return scale(arg, weight);
+            }, array_.find(index)));
+      }
+
+      return result;
+    }
+
+    /// Create a tensor expression of the packed array
+
+    /// \param vars A string with a comma-separated list of variables
+    /// \return A const tensor expression object
+    TiledArray::expressions::TsrExpr<const array_type, true>
+    operator ()(const std::string& vars) const { return array_(vars); }
+
+    /// Create a tensor expression of the packed array
+
+    /// Assigning to this expression replaces the packed data; the assigned
+    /// result must respect the symmetry of this array.
+    /// \param vars A string with a comma-separated list of variables
+    /// \return A non-const tensor expression object
+    TiledArray::expressions::TsrExpr<array_type, true>
+    operator ()(const std::string& vars) { return array_(vars); }
+
+  }; // class SymmArray
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_SYMM_ARRAY_H__INCLUDED
@@ -31,6 +31,10 @@
 #include <TiledArray/tensor/tensor_interface.h>
 #include <TiledArray/tensor/shift_wrapper.h>
 #include <TiledArray/tensor/operators.h>
+#include <TiledArray/tensor/low_rank_tensor.h>
+#include <TiledArray/tensor/band_tensor.h>
+#include <TiledArray/tensor/csr_tensor.h>
+#include <TiledArray/tensor/device_tensor.h>
 #include <TiledArray/block_range.h>
 
 namespace TiledArray {
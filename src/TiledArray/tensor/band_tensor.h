@@ -0,0 +1,963 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  band_tensor.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_BAND_TENSOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_BAND_TENSOR_H__INCLUDED
+
+#include <TiledArray/tensor/tensor.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+namespace TiledArray {
+
+  /// A banded matrix tile
+
+  /// Only the elements of a band of diagonals are stored, where a diagonal is
+  /// the set of elements <tt>(i,j)</tt> with a constant offset <tt>j - i</tt>
+  /// in the element indices of the array (not of the tile), so the band of a
+  /// tile is consistent with the band of the array it belongs to. The band is
+  /// stored row by row, with one element per diagonal, and is clipped to the
+  /// diagonals that intersect the tile, so a tile that does not intersect the
+  /// band stores nothing. A diagonal matrix is a band of one diagonal.
+  ///
+  /// Scaling, addition, element-wise multiplication, and reductions cost
+  /// O(n*b) for an \c n by \c n tile with \c b diagonals, and a contraction
+  /// of tiles with \c b1 and \c b2 diagonals costs O(n*b1*b2), instead of the
+  /// O(n^2) and O(n^3) of a dense tile. The band of a sum is the union of the
+  /// bands of the arguments, and the band of a product is their sum.
+  ///
+  /// This tile type implements the tile interface, and may be used as the
+  /// tile type of \c DistArray :
+  /// \code
+  /// typedef TiledArray::DistArray<TiledArray::BandTensor<double> > BandArray;
+  /// \endcode
+  /// \note Only matrix (rank 2) tiles are supported. Contractions must
+  /// contract one index of each argument.
+  /// \tparam T The element type of the tile
+  template <typename T>
+  class BandTensor {
+    static_assert(std::is_arithmetic<T>::value,
+        "BandTensor only supports real elements.");
+  public:
+    typedef BandTensor<T> BandTensor_; ///< This class type
+    typedef Range range_type; ///< Tile range type
+    typedef typename range_type::size_type size_type; ///< Size type
+    typedef long offset_type; ///< Diagonal offset type
+    typedef T value_type; ///< Element type
+    typedef T numeric_type; ///< Numeric type
+    typedef T scalar_type; ///< Scalar type
+
+  private:
+
+    range_type range_; ///< The range of the tile
+    offset_type first_; ///< The offset of the first stored diagonal
+    size_type width_; ///< The number of stored diagonals
+    Tensor<T> band_; ///< The band, a \c rows() by \c width_ matrix
+
+    /// Row count accessor
+
+    /// \return The number of rows of the tile
+    size_type rows() const { return range_.extent_data()[0]; }
+
+    /// Column count accessor
+
+    /// \return The number of columns of the tile
+    size_type cols() const { return range_.extent_data()[1]; }
+
+    /// First row accessor
+
+    /// \return The element index of the first row of the tile
+    offset_type row_begin() const { return range_.lobound_data()[0]; }
+
+    /// First column accessor
+
+    /// \return The element index of the first column of the tile
+    offset_type col_begin() const { return range_.lobound_data()[1]; }
+
+    /// Last stored diagonal accessor
+
+    /// \return The offset of one past the last stored diagonal
+    offset_type last() const { return first_ + offset_type(width_); }
+
+    /// Check the range of a tile argument
+
+    /// \param range The range of the argument
+    static void check_range(const range_type& range) {
+      TA_USER_ASSERT(range.rank() == 2u,
+          "BandTensor: The tile range must have a rank of 2.");
+    }
+
+    /// Construct a zero band
+
+    /// The band is clipped to the diagonals that intersect \c range .
+    /// \param range The range of the tile
+    /// \param first The offset of the first diagonal of the band
+    /// \param last The offset of one past the last diagonal of the band
+    /// \return A tile with a zero band
+    static BandTensor_ make_tile(const range_type& range, offset_type first,
+        offset_type last)
+    {
+      BandTensor_ result(range);
+      if(result.size()) {
+        first = std::max(first, result.col_begin() - result.row_begin() -
+            offset_type(result.rows()) + 1l);
+        last = std::min(last, result.col_begin() + offset_type(result.cols()) -
+            result.row_begin());
+        if(first < last) {
+          result.first_ = first;
+          result.width_ = last - first;
+          result.band_ = Tensor<T>(range_type(result.rows(), result.width_),
+              numeric_type(0));
+        }
+      }
+      return result;
+    }
+
+    /// Stored diagonals of a row
+
+    /// \param i The local row index
+    /// \param[out] begin The offset of the first stored diagonal in the tile
+    /// \param[out] end The offset of one past the last stored diagonal in
+    /// the tile
+    void row_offsets(const size_type i, offset_type& begin, offset_type& end) const {
+      const offset_type row = row_begin() + offset_type(i);
+      begin = std::max(first_, col_begin() - row);
+      end = std::min(last(), col_begin() + offset_type(cols()) - row);
+    }
+
+    /// Element accessor
+
+    /// \param i The local row index
+    /// \param d The diagonal offset, which must be stored
+    /// \return A reference to the element of row \c i on diagonal \c d
+    numeric_type& at(const size_type i, const offset_type d) {
+      return band_[i * width_ + size_type(d - first_)];
+    }
+
+    /// Element accessor
+
+    /// \param i The local row index
+    /// \param d The diagonal offset, which must be stored
+    /// \return The element of row \c i on diagonal \c d
+    numeric_type at(const size_type i, const offset_type d) const {
+      return band_[i * width_ + size_type(d - first_)];
+    }
+
+    /// Accumulate a scaled tile into this tile
+
+    /// The band of \c arg must be included in the band of this tile.
+    /// \param arg The tile to be added
+    /// \param factor The scaling factor of \c arg
+    void axpy(const BandTensor_& arg, const numeric_type factor) {
+      for(size_type i = 0ul; i < rows(); ++i) {
+        offset_type begin, end;
+        arg.row_offsets(i, begin, end);
+        for(offset_type d = begin; d < end; ++d)
+          at(i, d) += arg.at(i, d) * factor;
+      }
+    }
+
+    /// Add a scaled tile to this tile
+
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor applied to \c other
+    /// \return A tile equal to <tt>this + other * factor</tt>
+    BandTensor_ combine(const BandTensor_& other, const numeric_type factor) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "BandTensor: The ranges of the tiles do not match.");
+      if(! other.width_)
+        return clone();
+      if(! width_)
+        return other.scale(factor);
+
+      BandTensor_ result = make_tile(range_, std::min(first_, other.first_),
+          std::max(last(), other.last()));
+      result.axpy(*this, numeric_type(1));
+      result.axpy(other, factor);
+      return result;
+    }
+
+    /// Add a constant to a tile
+
+    /// The band of the result spans the whole tile.
+    /// \param value The constant
+    /// \return A tile equal to <tt>this + value</tt>
+    BandTensor_ add_constant(const numeric_type value) const {
+      TA_ASSERT(! empty());
+      BandTensor_ result = make_tile(range_, col_begin() - row_begin() -
+          offset_type(rows()) + 1l, col_begin() + offset_type(cols()) - row_begin());
+      for(size_type i = 0ul; i < rows(); ++i) {
+        offset_type begin, end;
+        result.row_offsets(i, begin, end);
+        for(offset_type d = begin; d < end; ++d)
+          result.at(i, d) = value;
+      }
+      result.axpy(*this, numeric_type(1));
+      return result;
+    }
+
+    /// Apply a matrix operation to a contraction argument
+
+    /// \param arg The contraction argument
+    /// \param op The matrix operation applied to \c arg
+    /// \return <tt>op(arg)</tt>
+    static BandTensor_ apply_op(const BandTensor_& arg,
+        const madness::cblas::CBLAS_TRANSPOSE op)
+    {
+      if(op == madness::cblas::NoTrans)
+        return arg;
+      return arg.permute(Permutation({1, 0}));
+    }
+
+  public:
+
+    /// Compiler generated functions
+    BandTensor() : range_(), first_(0l), width_(0ul), band_() { }
+    BandTensor(const BandTensor_&) = default;
+    BandTensor(BandTensor_&&) = default;
+    ~BandTensor() = default;
+    BandTensor_& operator=(const BandTensor_&) = default;
+    BandTensor_& operator=(BandTensor_&&) = default;
+
+    /// Construct a zero tile
+
+    /// \param range The range of the tile
+    explicit BandTensor(const range_type& range) :
+      range_(range), first_(0l), width_(0ul), band_()
+    { check_range(range_); }
+
+    /// Construct a band of zeros
+
+    /// \param range The range of the tile
+    /// \param lower The number of diagonals below the main diagonal
+    /// \param upper The number of diagonals above the main diagonal
+    BandTensor(const range_type& range, const size_type lower,
+        const size_type upper) :
+      BandTensor(make_tile(range, -offset_type(lower), offset_type(upper) + 1l))
+    { }
+
+    /// Construct a constant band
+
+    /// \param range The range of the tile
+    /// \param lower The number of diagonals below the main diagonal
+    /// \param upper The number of diagonals above the main diagonal
+    /// \param value The value of the elements in the band
+    BandTensor(const range_type& range, const size_type lower,
+        const size_type upper, const numeric_type value) :
+      BandTensor(range, lower, upper)
+    {
+      for(size_type i = 0ul; i < rows(); ++i) {
+        offset_type begin, end;
+        row_offsets(i, begin, end);
+        for(offset_type d = begin; d < end; ++d)
+          at(i, d) = value;
+      }
+    }
+
+    /// Copy the band of a dense tile
+
+    /// The elements of \c tensor outside the band are dropped.
+    /// \param tensor The dense tile
+    /// \param lower The number of diagonals below the main diagonal
+    /// \param upper The number of diagonals above the main diagonal
+    BandTensor(const Tensor<T>& tensor, const size_type lower,
+        const size_type upper) :
+      BandTensor(tensor.range(), lower, upper)
+    {
+      for(size_type i = 0ul; i < rows(); ++i) {
+        offset_type begin, end;
+        row_offsets(i, begin, end);
+        const offset_type row = row_begin() + offset_type(i);
+        for(offset_type d = begin; d < end; ++d)
+          at(i, d) = tensor[i * cols() + size_type(row + d - col_begin())];
+      }
+    }
+
+    /// Range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// Tile size accessor
+
+    /// \return The number of elements of the tile
+    size_type size() const { return range_.volume(); }
+
+    /// First diagonal accessor
+
+    /// \return The offset, <tt>j - i</tt>, of the first stored diagonal
+    offset_type first_diagonal() const { return first_; }
+
+    /// Band width accessor
+
+    /// \return The number of stored diagonals
+    size_type band_width() const { return width_; }
+
+    /// Band data accessor
+
+    /// \return The band, stored as a <tt>rows</tt> by \c band_width() matrix,
+    /// where element <tt>(i,d)</tt> is the tile element in row \c i on
+    /// diagonal <tt>first_diagonal() + d</tt> (empty if nothing is stored)
+    const Tensor<T>& band() const { return band_; }
+
+    /// Test if the tile is empty
+
+    /// \return \c true if this tile was default constructed
+    bool empty() const { return range_.rank() == 0u; }
+
+    /// Test if an element is stored
+
+    /// \param i The row element index
+    /// \param j The column element index
+    /// \return \c true if element <tt>(i,j)</tt> is in the band
+    bool in_band(const size_type i, const size_type j) const {
+      TA_ASSERT(range_.includes(std::array<size_type, 2>{{i, j}}));
+      const offset_type d = offset_type(j) - offset_type(i);
+      return (d >= first_) && (d < last());
+    }
+
+    /// Element accessor
+
+    /// \param i The row element index
+    /// \param j The column element index
+    /// \return Element <tt>(i,j)</tt>, which is zero outside the band
+    numeric_type operator()(const size_type i, const size_type j) const {
+      return (in_band(i, j) ? at(i - row_begin(), offset_type(j) - offset_type(i)) :
+          numeric_type(0));
+    }
+
+    /// Element accessor
+
+    /// \param i The row element index
+    /// \param j The column element index, such that <tt>(i,j)</tt> is in
+    /// the band
+    /// \return A reference to element <tt>(i,j)</tt>
+    numeric_type& operator()(const size_type i, const size_type j) {
+      TA_USER_ASSERT(in_band(i, j),
+          "BandTensor: The element is not in the band of the tile.");
+      return at(i - row_begin(), offset_type(j) - offset_type(i));
+    }
+
+    /// Construct a dense copy of the tile
+
+    /// \return A dense tile with the elements of this tile
+    Tensor<T> dense() const {
+      TA_ASSERT(! empty());
+      Tensor<T> result(range_, numeric_type(0));
+      for(size_type i = 0ul; i < rows(); ++i) {
+        offset_type begin, end;
+        row_offsets(i, begin, end);
+        const offset_type row = row_begin() + offset_type(i);
+        for(offset_type d = begin; d < end; ++d)
+          result[i * cols() + size_type(row + d - col_begin())] = at(i, d);
+      }
+      return result;
+    }
+
+    /// Construct a deep copy of the tile
+
+    /// \return A copy of this tile
+    BandTensor_ clone() const {
+      BandTensor_ result(*this);
+      if(width_)
+        result.band_ = band_.clone();
+      return result;
+    }
+
+    /// Serialization function
+
+    /// \tparam Archive The archive type
+    /// \param ar The archive
+    template <typename Archive>
+    void serialize(Archive& ar) {
+      ar & range_;
+      ar & first_;
+      ar & width_;
+      ar & band_;
+    }
+
+    // Permutation operations --------------------------------------------------
+
+    /// Create a permuted copy of this tile
+
+    /// \param perm The permutation
+    /// \return A permuted copy of this tile
+    BandTensor_ permute(const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(perm.dim() == 2u);
+      if(perm[0] == 0u)
+        return clone();
+
+      // Element (i,j) on diagonal d is element (j,i) on diagonal -d
+      BandTensor_ result = make_tile(perm * range_, 1l - last(), 1l - first_);
+      for(size_type i = 0ul; i < rows(); ++i) {
+        offset_type begin, end;
+        row_offsets(i, begin, end);
+        for(offset_type d = begin; d < end; ++d)
+          result.at(size_type(row_begin() + offset_type(i) + d - result.row_begin()),
+              -d) = at(i, d);
+      }
+      return result;
+    }
+
+    /// Shift the range of this tile
+
+    /// \tparam Index An index type
+    /// \param bound_shift The shift to be applied to the range
+    /// \return A copy of this tile with a shifted range
+    template <typename Index>
+    BandTensor_ shift(const Index& bound_shift) const {
+      BandTensor_ result = clone();
+      result.shift_to(bound_shift);
+      return result;
+    }
+
+    /// Shift the range of this tile
+
+    /// The stored elements keep their position in the tile, so the offsets
+    /// of their diagonals change when the rows and columns are shifted by
+    /// different amounts.
+    /// \tparam Index An index type
+    /// \param bound_shift The shift to be applied to the range
+    /// \return A reference to this tile
+    template <typename Index>
+    BandTensor_& shift_to(const Index& bound_shift) {
+      const offset_type offset = col_begin() - row_begin();
+      range_.inplace_shift(bound_shift);
+      first_ += col_begin() - row_begin() - offset;
+      return *this;
+    }
+
+    // Scaling operations ------------------------------------------------------
+
+    /// Scale this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>this * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ scale(const Scalar factor) const {
+      return clone().scale_to(factor);
+    }
+
+    /// Scale and permute this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ scale(const Scalar factor, const Permutation& perm) const {
+      return permute(perm).scale_to(factor);
+    }
+
+    /// Scale this tile in place
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_& scale_to(const Scalar factor) {
+      TA_ASSERT(! empty());
+      if(width_)
+        band_.scale_to(factor);
+      return *this;
+    }
+
+    /// Negate this tile
+
+    /// \return A tile equal to <tt>-this</tt>
+    BandTensor_ neg() const { return scale(numeric_type(-1)); }
+
+    /// Negate and permute this tile
+
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ -this</tt>
+    BandTensor_ neg(const Permutation& perm) const {
+      return scale(numeric_type(-1), perm);
+    }
+
+    /// Negate this tile in place
+
+    /// \return A reference to this tile
+    BandTensor_& neg_to() { return scale_to(numeric_type(-1)); }
+
+    // Addition operations -----------------------------------------------------
+
+    /// Add this and \c other
+
+    /// \param other The tile to be added to this tile
+    /// \return A tile equal to <tt>this + other</tt>
+    BandTensor_ add(const BandTensor_& other) const {
+      return combine(other, numeric_type(1));
+    }
+
+    /// Add this and \c other, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this + other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ add(const BandTensor_& other, const Scalar factor) const {
+      return combine(other, numeric_type(1)).scale_to(factor);
+    }
+
+    /// Add and permute this and \c other
+
+    /// \param other The tile to be added to this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this + other)</tt>
+    BandTensor_ add(const BandTensor_& other, const Permutation& perm) const {
+      return add(other).permute(perm);
+    }
+
+    /// Add, scale, and permute this and \c other
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this + other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ add(const BandTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return add(other, factor).permute(perm);
+    }
+
+    /// Add a constant to this tile
+
+    /// \param value The constant to be added
+    /// \return A tile equal to <tt>this + value</tt>
+    BandTensor_ add(const numeric_type value) const {
+      return add_constant(value);
+    }
+
+    /// Add a constant to this tile, and permute the result
+
+    /// \param value The constant to be added
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this + value)</tt>
+    BandTensor_ add(const numeric_type value, const Permutation& perm) const {
+      return add_constant(value).permute(perm);
+    }
+
+    /// Add \c other to this tile
+
+    /// \param other The tile to be added to this tile
+    /// \return A reference to this tile
+    BandTensor_& add_to(const BandTensor_& other) {
+      return (*this = add(other));
+    }
+
+    /// Add \c other to this tile, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_& add_to(const BandTensor_& other, const Scalar factor) {
+      return (*this = add(other, factor));
+    }
+
+    /// Add a constant to this tile
+
+    /// \param value The constant to be added
+    /// \return A reference to this tile
+    BandTensor_& add_to(const numeric_type value) {
+      return (*this = add_constant(value));
+    }
+
+    // Subtraction operations --------------------------------------------------
+
+    /// Subtract \c other from this
+
+    /// \param other The tile to be subtracted from this tile
+    /// \return A tile equal to <tt>this - other</tt>
+    BandTensor_ subt(const BandTensor_& other) const {
+      return combine(other, numeric_type(-1));
+    }
+
+    /// Subtract \c other from this, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this - other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ subt(const BandTensor_& other, const Scalar factor) const {
+      return combine(other, numeric_type(-1)).scale_to(factor);
+    }
+
+    /// Subtract \c other from this, and permute the result
+
+    /// \param other The tile to be subtracted from this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this - other)</tt>
+    BandTensor_ subt(const BandTensor_& other, const Permutation& perm) const {
+      return subt(other).permute(perm);
+    }
+
+    /// Subtract \c other from this, and scale and permute the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this - other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ subt(const BandTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return subt(other, factor).permute(perm);
+    }
+
+    /// Subtract a constant from this tile
+
+    /// \param value The constant to be subtracted
+    /// \return A tile equal to <tt>this - value</tt>
+    BandTensor_ subt(const numeric_type value) const {
+      return add_constant(-value);
+    }
+
+    /// Subtract a constant from this tile, and permute the result
+
+    /// \param value The constant to be subtracted
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this - value)</tt>
+    BandTensor_ subt(const numeric_type value, const Permutation& perm) const {
+      return add_constant(-value).permute(perm);
+    }
+
+    /// Subtract \c other from this tile
+
+    /// \param other The tile to be subtracted from this tile
+    /// \return A reference to this tile
+    BandTensor_& subt_to(const BandTensor_& other) {
+      return (*this = subt(other));
+    }
+
+    /// Subtract \c other from this tile, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_& subt_to(const BandTensor_& other, const Scalar factor) {
+      return (*this = subt(other, factor));
+    }
+
+    /// Subtract a constant from this tile
+
+    /// \param value The constant to be subtracted
+    /// \return A reference to this tile
+    BandTensor_& subt_to(const numeric_type value) {
+      return (*this = add_constant(-value));
+    }
+
+    // Multiplication operations -----------------------------------------------
+
+    /// Multiply this by \c other element-wise
+
+    /// The band of the product is the intersection of the bands of the
+    /// arguments.
+    /// \param other The tile to be multiplied by this tile
+    /// \return A tile equal to <tt>this * other</tt> (element-wise)
+    BandTensor_ mult(const BandTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "BandTensor: The ranges of the tiles do not match.");
+
+      BandTensor_ result = make_tile(range_, std::max(first_, other.first_),
+          std::min(last(), other.last()));
+      for(size_type i = 0ul; i < rows(); ++i) {
+        offset_type begin, end;
+        result.row_offsets(i, begin, end);
+        for(offset_type d = begin; d < end; ++d)
+          result.at(i, d) = at(i, d) * other.at(i, d);
+      }
+      return result;
+    }
+
+    /// Multiply this by \c other element-wise, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this * other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ mult(const BandTensor_& other, const Scalar factor) const {
+      return mult(other).scale_to(factor);
+    }
+
+    /// Multiply this by \c other element-wise, and permute the result
+
+    /// \param other The tile to be multiplied by this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this * other)</tt>
+    BandTensor_ mult(const BandTensor_& other, const Permutation& perm) const {
+      return mult(other).permute(perm);
+    }
+
+    /// Multiply this by \c other element-wise, and scale and permute the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this * other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ mult(const BandTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return mult(other, factor).permute(perm);
+    }
+
+    /// Multiply this tile by \c other element-wise
+
+    /// \param other The tile to be multiplied by this tile
+    /// \return A reference to this tile
+    BandTensor_& mult_to(const BandTensor_& other) {
+      return (*this = mult(other));
+    }
+
+    /// Multiply this tile by \c other element-wise, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_& mult_to(const BandTensor_& other, const Scalar factor) {
+      return (*this = mult(other, factor));
+    }
+
+    // Contraction operations --------------------------------------------------
+
+    /// Contract this tile with \c other
+
+    /// Each stored element of the left-hand tile is multiplied by the stored
+    /// elements of the matching row of the right-hand tile, so the cost is
+    /// proportional to the number of rows times the product of the band
+    /// widths.
+    /// \tparam Scalar A scalar type
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction parameters
+    /// \return A tile equal to <tt>this * other * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_ gemm(const BandTensor_& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT((gemm_helper.left_rank() == 2u) &&
+          (gemm_helper.right_rank() == 2u) && (gemm_helper.result_rank() == 2u),
+          "BandTensor::gemm(): Only matrix products are supported.");
+
+      const range_type range =
+          gemm_helper.make_result_range<range_type>(range_, other.range_);
+      if(! (width_ && other.width_))
+        return BandTensor_(range);
+
+      const BandTensor_ left = apply_op(*this, gemm_helper.left_op());
+      const BandTensor_ right = apply_op(other, gemm_helper.right_op());
+
+      // The offset of the result element (i,k) is the sum of the offsets of
+      // the argument elements (i,j) and (j,k)
+      BandTensor_ result = make_tile(range, left.first_ + right.first_,
+          left.last() + right.last() - 1l);
+      if(! result.width_)
+        return result;
+
+      for(size_type i = 0ul; i < left.rows(); ++i) {
+        const offset_type row = left.row_begin() + offset_type(i);
+        offset_type first_j, last_j;
+        left.row_offsets(i, first_j, last_j);
+        for(offset_type d1 = first_j; d1 < last_j; ++d1) {
+          const numeric_type a = left.at(i, d1) * numeric_type(factor);
+          const size_type j = size_type(row + d1 - right.row_begin());
+          offset_type first_k, last_k;
+          right.row_offsets(j, first_k, last_k);
+          for(offset_type d2 = first_k; d2 < last_k; ++d2)
+            result.at(i, d1 + d2) += a * right.at(j, d2);
+        }
+      }
+
+      return result;
+    }
+
+    /// Contract \c left and \c right, and add the result to this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction parameters
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    BandTensor_& gemm(const BandTensor_& left, const BandTensor_& right,
+        const Scalar factor, const math::GemmHelper& gemm_helper)
+    {
+      if(empty())
+        return (*this = left.gemm(right, factor, gemm_helper));
+      return add_to(left.gemm(right, factor, gemm_helper));
+    }
+
+    // Reduction operations ----------------------------------------------------
+
+    /// Sum the diagonal elements of this tile
+
+    /// \return The sum of the elements <tt>(i,i)</tt>
+    numeric_type trace() const {
+      TA_ASSERT(! empty());
+      numeric_type result(0);
+      if((first_ <= 0l) && (last() > 0l)) {
+        for(size_type i = 0ul; i < rows(); ++i) {
+          offset_type begin, end;
+          row_offsets(i, begin, end);
+          if((begin <= 0l) && (end > 0l))
+            result += at(i, 0l);
+        }
+      }
+      return result;
+    }
+
+    /// Sum the elements of this tile
+
+    /// \return The sum of the elements
+    numeric_type sum() const {
+      TA_ASSERT(! empty());
+      return (width_ ? band_.sum() : numeric_type(0));
+    }
+
+    /// Multiply the elements of this tile
+
+    /// \return The product of the elements
+    numeric_type product() const { return dense().product(); }
+
+    /// Squared Frobenius norm
+
+    /// \return The squared Frobenius norm of this tile
+    scalar_type squared_norm() const {
+      TA_ASSERT(! empty());
+      return (width_ ? band_.squared_norm() : scalar_type(0));
+    }
+
+    /// Frobenius norm
+
+    /// \return The Frobenius norm of this tile
+    scalar_type norm() const { return std::sqrt(squared_norm()); }
+
+    /// Maximum element
+
+    /// \return The maximum element of this tile
+    numeric_type max() const { return dense().max(); }
+
+    /// Minimum element
+
+    /// \return The minimum element of this tile
+    numeric_type min() const { return dense().min(); }
+
+    /// Absolute maximum element
+
+    /// \return The maximum absolute value of the elements of this tile
+    scalar_type abs_max() const {
+      TA_ASSERT(! empty());
+      return (width_ ? band_.abs_max() : scalar_type(0));
+    }
+
+    /// Absolute minimum element
+
+    /// \return The minimum absolute value of the elements of this tile
+    scalar_type abs_min() const { return dense().abs_min(); }
+
+    /// Vector dot product
+
+    /// \param other The other tile
+    /// \return The sum of the products of the elements of this tile and
+    /// \c other
+    numeric_type dot(const BandTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "BandTensor: The ranges of the tiles do not match.");
+      const offset_type first_d = std::max(first_, other.first_);
+      const offset_type last_d = std::min(last(), other.last());
+      numeric_type result(0);
+      for(size_type i = 0ul; i < rows(); ++i) {
+        offset_type begin, end;
+        row_offsets(i, begin, end);
+        begin = std::max(begin, first_d);
+        end = std::min(end, last_d);
+        for(offset_type d = begin; d < end; ++d)
+          result += at(i, d) * other.at(i, d);
+      }
+      return result;
+    }
+
+  }; // class BandTensor
+
+  /// Banded tile output operator
+
+  /// The tile is printed as a dense matrix.
+  /// \tparam T The element type
+  /// \param os The output stream
+  /// \param tile The tile to be output
+  /// \return A reference to the output stream
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const BandTensor<T>& tile) {
+    if(tile.empty())
+      os << "[ ]";
+    else
+      os << tile.dense();
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_BAND_TENSOR_H__INCLUDED
@@ -0,0 +1,1177 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  csr_tensor.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_CSR_TENSOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_CSR_TENSOR_H__INCLUDED
+
+#include <TiledArray/tensor/tensor.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// The fill ratio threshold of \c CsrTensor
+
+    /// The default is 0.1 , or the value of the \c TA_CSR_FILL_THRESHOLD
+    /// environment variable.
+    /// \return A reference to the threshold
+    inline double& csr_fill_threshold() {
+      static double threshold = (getenv("TA_CSR_FILL_THRESHOLD") ?
+          std::strtod(getenv("TA_CSR_FILL_THRESHOLD"), nullptr) : 0.1);
+      return threshold;
+    }
+
+  } // namespace detail
+
+  /// An element-sparse matrix tile
+
+  /// Blocks that are sparse below the tile level, e.g. with 1% non-zero
+  /// elements, waste memory and flops when they are stored as dense tiles,
+  /// and block-sparse screening cannot remove them. A \c CsrTensor stores
+  /// the non-zero elements of such a tile in compressed sparse row (CSR)
+  /// format, and the other tiles as a dense \c Tensor . The format of a tile
+  /// is chosen from its fill ratio, the fraction of non-zero elements: tiles
+  /// with a fill ratio at or below \c fill_threshold() are sparse. The
+  /// format of the result of an operation is chosen the same way, except
+  /// that the results of dense operations (e.g. the sum of a sparse and a
+  /// dense tile) are dense.
+  ///
+  /// Operations on mixed dense and sparse arguments are dispatched by the
+  /// tile, so arrays of \c CsrTensor tiles mix the two formats freely, and
+  /// contractions use dense \c gemm , sparse-dense products (SpMM), or
+  /// sparse-sparse products (SpGEMM) for each pair of tiles. The copy
+  /// semantics are those of \c Tensor : copies share the elements, and
+  /// \c clone() makes a deep copy.
+  ///
+  /// This tile type implements the tile interface, and may be used as the
+  /// tile type of \c DistArray . An array of dense tiles is converted with
+  /// \code
+  /// auto csr = TiledArray::to_new_tile_type(array,
+  ///     [] (const TiledArray::Tensor<double>& tile) {
+  ///       return TiledArray::CsrTensor<double>(tile);
+  ///     });
+  /// \endcode
+  /// \note Only matrix (rank 2) tiles are supported. Contractions must
+  /// contract one index of each argument.
+  /// \tparam T The element type of the tile
+  template <typename T>
+  class CsrTensor {
+    static_assert(std::is_arithmetic<T>::value,
+        "CsrTensor only supports real elements.");
+  public:
+    typedef CsrTensor<T> CsrTensor_; ///< This class type
+    typedef Range range_type; ///< Tile range type
+    typedef typename range_type::size_type size_type; ///< Size type
+    typedef T value_type; ///< Element type
+    typedef T numeric_type; ///< Numeric type
+    typedef T scalar_type; ///< Scalar type
+
+  private:
+
+    /// Compressed sparse row storage
+    struct Csr {
+      std::vector<size_type> row_ptr; ///< The position of the first element
+                                      ///< of each row, and the number of elements
+      std::vector<size_type> col; ///< The local column index of each element
+      std::vector<T> value; ///< The value of each element
+    }; // struct Csr
+
+    range_type range_; ///< The range of the tile
+    Tensor<T> dense_; ///< The elements of a dense tile
+    std::shared_ptr<Csr> csr_; ///< The elements of a sparse tile, or null if
+                               ///< the tile is dense
+
+    /// Row count accessor
+
+    /// \return The number of rows of the tile
+    size_type rows() const { return range_.extent_data()[0]; }
+
+    /// Column count accessor
+
+    /// \return The number of columns of the tile
+    size_type cols() const { return range_.extent_data()[1]; }
+
+    /// Check the range of a tile argument
+
+    /// \param range The range of the argument
+    static void check_range(const range_type& range) {
+      TA_USER_ASSERT(range.rank() == 2u,
+          "CsrTensor: The tile range must have a rank of 2.");
+    }
+
+    /// Construct a dense tile
+
+    /// \param tensor The elements of the tile
+    /// \return A dense tile with the elements of \c tensor
+    static CsrTensor_ make_dense(const Tensor<T>& tensor) {
+      CsrTensor_ result;
+      result.range_ = tensor.range();
+      result.dense_ = tensor;
+      return result;
+    }
+
+    /// Construct a tile from its sparse elements
+
+    /// The tile is dense if the fill ratio of \c csr is above
+    /// \c fill_threshold() .
+    /// \param range The range of the tile
+    /// \param csr The non-zero elements of the tile
+    /// \return A tile with the elements of \c csr
+    static CsrTensor_ make_sparse(const range_type& range,
+        const std::shared_ptr<Csr>& csr)
+    {
+      CsrTensor_ result;
+      result.range_ = range;
+      result.csr_ = csr;
+      if(double(csr->value.size()) > fill_threshold() * double(range.volume())) {
+        result.dense_ = result.dense();
+        result.csr_.reset();
+      }
+      return result;
+    }
+
+    /// Element accessor
+
+    /// \param i The local row index
+    /// \param j The local column index
+    /// \return The element <tt>(i,j)</tt> of the tile
+    numeric_type at(const size_type i, const size_type j) const {
+      if(! csr_)
+        return dense_.data()[i * cols() + j];
+      const auto first = csr_->col.begin() + csr_->row_ptr[i];
+      const auto last = csr_->col.begin() + csr_->row_ptr[i + 1ul];
+      const auto it = std::lower_bound(first, last, j);
+      return ((it != last) && (*it == j) ?
+          csr_->value[it - csr_->col.begin()] : numeric_type(0));
+    }
+
+    /// Combine the elements of two sparse tiles
+
+    /// The rows of the tiles are merged, and the elements of the result are
+    /// <tt>op(this, other)</tt> , where the elements that are not stored are
+    /// zero. Zero elements of the result are dropped.
+    /// \tparam Op The element operation type
+    /// \param other The other sparse tile
+    /// \param op The element operation
+    /// \param intersect Only combine the elements that are stored in both tiles
+    /// \return The non-zero elements of the result
+    template <typename Op>
+    std::shared_ptr<Csr> merge(const CsrTensor_& other, const Op& op,
+        const bool intersect) const
+    {
+      const Csr& left = *csr_;
+      const Csr& right = *other.csr_;
+      std::shared_ptr<Csr> result = std::make_shared<Csr>();
+      result->row_ptr.reserve(rows() + 1ul);
+      result->row_ptr.push_back(0ul);
+      for(size_type i = 0ul; i < rows(); ++i) {
+        size_type a = left.row_ptr[i], b = right.row_ptr[i];
+        const size_type a_end = left.row_ptr[i + 1ul], b_end = right.row_ptr[i + 1ul];
+        while((a < a_end) || (b < b_end)) {
+          size_type j;
+          numeric_type value;
+          if((b == b_end) || ((a < a_end) && (left.col[a] < right.col[b]))) {
+            if(intersect) { ++a; continue; }
+            j = left.col[a];
+            value = op(left.value[a++], numeric_type(0));
+          } else if((a == a_end) || (right.col[b] < left.col[a])) {
+            if(intersect) { ++b; continue; }
+            j = right.col[b];
+            value = op(numeric_type(0), right.value[b++]);
+          } else {
+            j = left.col[a];
+            value = op(left.value[a++], right.value[b++]);
+          }
+          if(value != numeric_type(0)) {
+            result->col.push_back(j);
+            result->value.push_back(value);
+          }
+        }
+        result->row_ptr.push_back(result->col.size());
+      }
+      return result;
+    }
+
+    /// Add a scaled tile to this tile
+
+    /// The result is sparse if both tiles are sparse.
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor applied to \c other
+    /// \return A tile equal to <tt>this + other * factor</tt>
+    CsrTensor_ combine(const CsrTensor_& other, const numeric_type factor) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "CsrTensor: The ranges of the tiles do not match.");
+
+      if(csr_ && other.csr_)
+        return make_sparse(range_, merge(other,
+            [=] (const numeric_type l, const numeric_type r) { return l + r * factor; },
+            false));
+
+      // Accumulate the other tile into a dense copy of this tile
+      Tensor<T> result = dense().clone();
+      numeric_type* MADNESS_RESTRICT const data = result.data();
+      if(other.csr_) {
+        for(size_type i = 0ul; i < rows(); ++i)
+          for(size_type e = other.csr_->row_ptr[i]; e < other.csr_->row_ptr[i + 1ul]; ++e)
+            data[i * cols() + other.csr_->col[e]] += other.csr_->value[e] * factor;
+      } else {
+        const numeric_type* MADNESS_RESTRICT const other_data = other.dense_.data();
+        for(size_type i = 0ul; i < size(); ++i)
+          data[i] += other_data[i] * factor;
+      }
+      return make_dense(result);
+    }
+
+    /// Transpose the elements of a sparse tile
+
+    /// \return The elements of the transposed tile
+    std::shared_ptr<Csr> transpose() const {
+      const Csr& arg = *csr_;
+      std::shared_ptr<Csr> result = std::make_shared<Csr>();
+      result->row_ptr.assign(cols() + 1ul, 0ul);
+      for(const size_type j : arg.col)
+        ++result->row_ptr[j + 1ul];
+      std::partial_sum(result->row_ptr.begin(), result->row_ptr.end(),
+          result->row_ptr.begin());
+
+      // Rows are visited in order, so the columns of each result row are sorted
+      result->col.resize(arg.col.size());
+      result->value.resize(arg.value.size());
+      std::vector<size_type> next(result->row_ptr.begin(), result->row_ptr.end() - 1l);
+      for(size_type i = 0ul; i < rows(); ++i) {
+        for(size_type e = arg.row_ptr[i]; e < arg.row_ptr[i + 1ul]; ++e) {
+          const size_type pos = next[arg.col[e]]++;
+          result->col[pos] = i;
+          result->value[pos] = arg.value[e];
+        }
+      }
+      return result;
+    }
+
+    /// Apply a matrix operation to a contraction argument
+
+    /// \param arg The contraction argument
+    /// \param op The matrix operation applied to \c arg
+    /// \return <tt>op(arg)</tt>
+    static CsrTensor_ apply_op(const CsrTensor_& arg,
+        const madness::cblas::CBLAS_TRANSPOSE op)
+    {
+      if(op == madness::cblas::NoTrans)
+        return arg;
+      return arg.permute(Permutation({1, 0}));
+    }
+
+  public:
+
+    /// Compiler generated functions
+    CsrTensor() : range_(), dense_(), csr_() { }
+    CsrTensor(const CsrTensor_&) = default;
+    CsrTensor(CsrTensor_&&) = default;
+    ~CsrTensor() = default;
+    CsrTensor_& operator=(const CsrTensor_&) = default;
+    CsrTensor_& operator=(CsrTensor_&&) = default;
+
+    /// Construct a zero tile
+
+    /// \param range The range of the tile
+    explicit CsrTensor(const range_type& range) :
+      range_(range), dense_(), csr_(std::make_shared<Csr>())
+    {
+      check_range(range_);
+      csr_->row_ptr.assign(rows() + 1ul, 0ul);
+    }
+
+    /// Copy the elements of a dense tile
+
+    /// The tile is sparse if the fill ratio of \c tensor is at or below
+    /// \c fill_threshold() , otherwise it shares the elements of \c tensor .
+    /// \param tensor The dense tile
+    explicit CsrTensor(const Tensor<T>& tensor) :
+      CsrTensor(tensor.range())
+    {
+      const numeric_type* MADNESS_RESTRICT const data = tensor.data();
+      const size_type n = tensor.size();
+      const size_type nnz = n - std::count(data, data + n, numeric_type(0));
+      if(double(nnz) > fill_threshold() * double(n)) {
+        dense_ = tensor;
+        csr_.reset();
+        return;
+      }
+
+      csr_->col.reserve(nnz);
+      csr_->value.reserve(nnz);
+      for(size_type i = 0ul; i < rows(); ++i) {
+        for(size_type j = 0ul; j < cols(); ++j) {
+          const numeric_type value = data[i * cols() + j];
+          if(value != numeric_type(0)) {
+            csr_->col.push_back(j);
+            csr_->value.push_back(value);
+          }
+        }
+        csr_->row_ptr[i + 1ul] = csr_->col.size();
+      }
+    }
+
+    /// Construct a sparse tile from CSR arrays
+
+    /// The tile is sparse, regardless of its fill ratio.
+    /// \param range The range of the tile
+    /// \param row_ptr The position of the first element of each row in \c col
+    /// and \c value , followed by the number of elements
+    /// \param col The local column index of each element, sorted in each row
+    /// \param value The value of each element
+    CsrTensor(const range_type& range, std::vector<size_type> row_ptr,
+        std::vector<size_type> col, std::vector<T> value) :
+      CsrTensor(range)
+    {
+      TA_USER_ASSERT(row_ptr.size() == rows() + 1ul,
+          "CsrTensor: The size of row_ptr must be the number of rows plus one.");
+      TA_USER_ASSERT((col.size() == value.size()) && (row_ptr.back() == col.size()),
+          "CsrTensor: The sizes of col and value do not match row_ptr.");
+      csr_->row_ptr = std::move(row_ptr);
+      csr_->col = std::move(col);
+      csr_->value = std::move(value);
+    }
+
+    /// Fill ratio threshold accessor
+
+    /// \return The largest fill ratio of a sparse tile
+    static double fill_threshold() { return detail::csr_fill_threshold(); }
+
+    /// Set the fill ratio threshold
+
+    /// The threshold applies to the tiles that are constructed afterwards.
+    /// \param threshold The largest fill ratio of a sparse tile
+    static void set_fill_threshold(const double threshold) {
+      detail::csr_fill_threshold() = threshold;
+    }
+
+    /// Range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// Tile size accessor
+
+    /// \return The number of elements of the tile
+    size_type size() const { return range_.volume(); }
+
+    /// Test if the tile is empty
+
+    /// \return \c true if this tile was default constructed
+    bool empty() const { return range_.rank() == 0u; }
+
+    /// Test if the elements are stored densely
+
+    /// \return \c true if the tile is stored as a dense \c Tensor
+    bool is_dense() const { return ! csr_; }
+
+    /// Stored element count accessor
+
+    /// \return The number of stored elements, which is the size of a dense tile
+    size_type nnz() const { return (csr_ ? csr_->value.size() : size()); }
+
+    /// Fill ratio accessor
+
+    /// \return The fraction of the elements that are stored
+    double fill_ratio() const {
+      return (size() ? double(nnz()) / double(size()) : 0.0);
+    }
+
+    /// CSR row pointer accessor
+
+    /// \return The position of the first element of each row, and the number
+    /// of elements, of a sparse tile
+    const std::vector<size_type>& row_ptr() const {
+      TA_ASSERT(csr_);
+      return csr_->row_ptr;
+    }
+
+    /// CSR column index accessor
+
+    /// \return The local column index of each element of a sparse tile
+    const std::vector<size_type>& col() const {
+      TA_ASSERT(csr_);
+      return csr_->col;
+    }
+
+    /// CSR value accessor
+
+    /// \return The value of each element of a sparse tile
+    const std::vector<T>& value() const {
+      TA_ASSERT(csr_);
+      return csr_->value;
+    }
+
+    /// Element accessor
+
+    /// \param i The row element index
+    /// \param j The column element index
+    /// \return Element <tt>(i,j)</tt>
+    numeric_type operator()(const size_type i, const size_type j) const {
+      TA_ASSERT(range_.includes(std::array<size_type, 2>{{i, j}}));
+      return at(i - range_.lobound_data()[0], j - range_.lobound_data()[1]);
+    }
+
+    /// Construct a dense copy of the tile
+
+    /// \return A dense tile with the elements of this tile, which shares the
+    /// elements of a dense tile
+    Tensor<T> dense() const {
+      TA_ASSERT(! empty());
+      if(! csr_)
+        return dense_;
+      Tensor<T> result(range_, numeric_type(0));
+      numeric_type* MADNESS_RESTRICT const data = result.data();
+      for(size_type i = 0ul; i < rows(); ++i)
+        for(size_type e = csr_->row_ptr[i]; e < csr_->row_ptr[i + 1ul]; ++e)
+          data[i * cols() + csr_->col[e]] = csr_->value[e];
+      return result;
+    }
+
+    /// Construct a deep copy of the tile
+
+    /// \return A copy of this tile
+    CsrTensor_ clone() const {
+      CsrTensor_ result(*this);
+      if(csr_)
+        result.csr_ = std::make_shared<Csr>(*csr_);
+      else
+        result.dense_ = dense_.clone();
+      return result;
+    }
+
+    /// Output serialization function
+
+    /// \tparam Archive The output archive type
+    /// \param ar The output archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      const bool sparse = static_cast<bool>(csr_);
+      ar & range_ & sparse;
+      if(sparse)
+        ar & csr_->row_ptr & csr_->col & csr_->value;
+      else
+        ar & dense_;
+    }
+
+    /// Input serialization function
+
+    /// \tparam Archive The input archive type
+    /// \param ar The input archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      bool sparse = false;
+      ar & range_ & sparse;
+      if(sparse) {
+        csr_ = std::make_shared<Csr>();
+        ar & csr_->row_ptr & csr_->col & csr_->value;
+        dense_ = Tensor<T>();
+      } else {
+        csr_.reset();
+        ar & dense_;
+      }
+    }
+
+    // Permutation operations --------------------------------------------------
+
+    /// Create a permuted copy of this tile
+
+    /// \param perm The permutation
+    /// \return A permuted copy of this tile
+    CsrTensor_ permute(const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(perm.dim() == 2u);
+      if(perm[0] == 0u)
+        return clone();
+      if(! csr_)
+        return make_dense(dense_.permute(perm));
+
+      CsrTensor_ result;
+      result.range_ = perm * range_;
+      result.csr_ = transpose();
+      return result;
+    }
+
+    /// Shift the range of this tile
+
+    /// \tparam Index An index type
+    /// \param bound_shift The shift to be applied to the range
+    /// \return A copy of this tile with a shifted range
+    template <typename Index>
+    CsrTensor_ shift(const Index& bound_shift) const {
+      CsrTensor_ result = clone();
+      result.shift_to(bound_shift);
+      return result;
+    }
+
+    /// Shift the range of this tile
+
+    /// \tparam Index An index type
+    /// \param bound_shift The shift to be applied to the range
+    /// \return A reference to this tile
+    template <typename Index>
+    CsrTensor_& shift_to(const Index& bound_shift) {
+      range_.inplace_shift(bound_shift);
+      if(! csr_)
+        dense_.shift_to(bound_shift);
+      return *this;
+    }
+
+    // Scaling operations ------------------------------------------------------
+
+    /// Scale this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>this * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ scale(const Scalar factor) const {
+      return clone().scale_to(factor);
+    }
+
+    /// Scale and permute this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ scale(const Scalar factor, const Permutation& perm) const {
+      return permute(perm).scale_to(factor);
+    }
+
+    /// Scale this tile in place
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_& scale_to(const Scalar factor) {
+      TA_ASSERT(! empty());
+      if(csr_) {
+        for(numeric_type& value : csr_->value)
+          value *= factor;
+      } else {
+        dense_.scale_to(factor);
+      }
+      return *this;
+    }
+
+    /// Negate this tile
+
+    /// \return A tile equal to <tt>-this</tt>
+    CsrTensor_ neg() const { return scale(numeric_type(-1)); }
+
+    /// Negate and permute this tile
+
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ -this</tt>
+    CsrTensor_ neg(const Permutation& perm) const {
+      return scale(numeric_type(-1), perm);
+    }
+
+    /// Negate this tile in place
+
+    /// \return A reference to this tile
+    CsrTensor_& neg_to() { return scale_to(numeric_type(-1)); }
+
+    // Addition operations -----------------------------------------------------
+
+    /// Add this and \c other
+
+    /// \param other The tile to be added to this tile
+    /// \return A tile equal to <tt>this + other</tt>
+    CsrTensor_ add(const CsrTensor_& other) const {
+      return combine(other, numeric_type(1));
+    }
+
+    /// Add this and \c other, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this + other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ add(const CsrTensor_& other, const Scalar factor) const {
+      return combine(other, numeric_type(1)).scale_to(factor);
+    }
+
+    /// Add and permute this and \c other
+
+    /// \param other The tile to be added to this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this + other)</tt>
+    CsrTensor_ add(const CsrTensor_& other, const Permutation& perm) const {
+      return add(other).permute(perm);
+    }
+
+    /// Add, scale, and permute this and \c other
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this + other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ add(const CsrTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return add(other, factor).permute(perm);
+    }
+
+    /// Add a constant to this tile
+
+    /// The result is dense.
+    /// \param value The constant to be added
+    /// \return A tile equal to <tt>this + value</tt>
+    CsrTensor_ add(const numeric_type value) const {
+      return make_dense(dense().add(value));
+    }
+
+    /// Add a constant to this tile, and permute the result
+
+    /// \param value The constant to be added
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this + value)</tt>
+    CsrTensor_ add(const numeric_type value, const Permutation& perm) const {
+      return add(value).permute(perm);
+    }
+
+    /// Add \c other to this tile
+
+    /// \param other The tile to be added to this tile
+    /// \return A reference to this tile
+    CsrTensor_& add_to(const CsrTensor_& other) {
+      return (*this = add(other));
+    }
+
+    /// Add \c other to this tile, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_& add_to(const CsrTensor_& other, const Scalar factor) {
+      return (*this = add(other, factor));
+    }
+
+    /// Add a constant to this tile
+
+    /// \param value The constant to be added
+    /// \return A reference to this tile
+    CsrTensor_& add_to(const numeric_type value) {
+      return (*this = add(value));
+    }
+
+    // Subtraction operations --------------------------------------------------
+
+    /// Subtract \c other from this
+
+    /// \param other The tile to be subtracted from this tile
+    /// \return A tile equal to <tt>this - other</tt>
+    CsrTensor_ subt(const CsrTensor_& other) const {
+      return combine(other, numeric_type(-1));
+    }
+
+    /// Subtract \c other from this, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this - other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ subt(const CsrTensor_& other, const Scalar factor) const {
+      return combine(other, numeric_type(-1)).scale_to(factor);
+    }
+
+    /// Subtract \c other from this, and permute the result
+
+    /// \param other The tile to be subtracted from this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this - other)</tt>
+    CsrTensor_ subt(const CsrTensor_& other, const Permutation& perm) const {
+      return subt(other).permute(perm);
+    }
+
+    /// Subtract \c other from this, and scale and permute the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this - other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ subt(const CsrTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return subt(other, factor).permute(perm);
+    }
+
+    /// Subtract a constant from this tile
+
+    /// \param value The constant to be subtracted
+    /// \return A tile equal to <tt>this - value</tt>
+    CsrTensor_ subt(const numeric_type value) const { return add(-value); }
+
+    /// Subtract a constant from this tile, and permute the result
+
+    /// \param value The constant to be subtracted
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this - value)</tt>
+    CsrTensor_ subt(const numeric_type value, const Permutation& perm) const {
+      return add(-value, perm);
+    }
+
+    /// Subtract \c other from this tile
+
+    /// \param other The tile to be subtracted from this tile
+    /// \return A reference to this tile
+    CsrTensor_& subt_to(const CsrTensor_& other) {
+      return (*this = subt(other));
+    }
+
+    /// Subtract \c other from this tile, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_& subt_to(const CsrTensor_& other, const Scalar factor) {
+      return (*this = subt(other, factor));
+    }
+
+    /// Subtract a constant from this tile
+
+    /// \param value The constant to be subtracted
+    /// \return A reference to this tile
+    CsrTensor_& subt_to(const numeric_type value) {
+      return (*this = add(-value));
+    }
+
+    // Multiplication operations -----------------------------------------------
+
+    /// Multiply this by \c other element-wise
+
+    /// The product is sparse if either argument is sparse.
+    /// \param other The tile to be multiplied by this tile
+    /// \return A tile equal to <tt>this * other</tt> (element-wise)
+    CsrTensor_ mult(const CsrTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "CsrTensor: The ranges of the tiles do not match.");
+
+      if(! (csr_ || other.csr_))
+        return make_dense(dense_.mult(other.dense_));
+      if(csr_ && other.csr_)
+        return make_sparse(range_, merge(other,
+            [] (const numeric_type l, const numeric_type r) { return l * r; },
+            true));
+
+      // Scale the elements of the sparse argument
+      const CsrTensor_& sparse = (csr_ ? *this : other);
+      const numeric_type* MADNESS_RESTRICT const data =
+          (csr_ ? other.dense_.data() : dense_.data());
+      std::shared_ptr<Csr> result = std::make_shared<Csr>();
+      result->row_ptr.reserve(rows() + 1ul);
+      result->row_ptr.push_back(0ul);
+      for(size_type i = 0ul; i < rows(); ++i) {
+        for(size_type e = sparse.csr_->row_ptr[i]; e < sparse.csr_->row_ptr[i + 1ul]; ++e) {
+          const size_type j = sparse.csr_->col[e];
+          const numeric_type value = sparse.csr_->value[e] * data[i * cols() + j];
+          if(value != numeric_type(0)) {
+            result->col.push_back(j);
+            result->value.push_back(value);
+          }
+        }
+        result->row_ptr.push_back(result->col.size());
+      }
+      return make_sparse(range_, result);
+    }
+
+    /// Multiply this by \c other element-wise, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this * other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ mult(const CsrTensor_& other, const Scalar factor) const {
+      return mult(other).scale_to(factor);
+    }
+
+    /// Multiply this by \c other element-wise, and permute the result
+
+    /// \param other The tile to be multiplied by this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this * other)</tt>
+    CsrTensor_ mult(const CsrTensor_& other, const Permutation& perm) const {
+      return mult(other).permute(perm);
+    }
+
+    /// Multiply this by \c other element-wise, and scale and permute the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this * other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ mult(const CsrTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return mult(other, factor).permute(perm);
+    }
+
+    /// Multiply this tile by \c other element-wise
+
+    /// \param other The tile to be multiplied by this tile
+    /// \return A reference to this tile
+    CsrTensor_& mult_to(const CsrTensor_& other) {
+      return (*this = mult(other));
+    }
+
+    /// Multiply this tile by \c other element-wise, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_& mult_to(const CsrTensor_& other, const Scalar factor) {
+      return (*this = mult(other, factor));
+    }
+
+    // Contraction operations --------------------------------------------------
+
+    /// Contract this tile with \c other
+
+    /// Dense tiles are contracted with \c Tensor::gemm() . A sparse tile and
+    /// a dense tile are contracted row by row (SpMM), with a dense result,
+    /// and two sparse tiles are contracted with Gustavson's algorithm
+    /// (SpGEMM), where the result is sparse unless its fill ratio is above
+    /// \c fill_threshold() .
+    /// \tparam Scalar A scalar type
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction parameters
+    /// \return A tile equal to <tt>this * other * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_ gemm(const CsrTensor_& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT((gemm_helper.left_rank() == 2u) &&
+          (gemm_helper.right_rank() == 2u) && (gemm_helper.result_rank() == 2u),
+          "CsrTensor::gemm(): Only matrix products are supported.");
+
+      if(! (csr_ || other.csr_))
+        return make_dense(dense_.gemm(other.dense_, factor, gemm_helper));
+
+      const range_type range =
+          gemm_helper.make_result_range<range_type>(range_, other.range_);
+      const CsrTensor_ left = apply_op(*this, gemm_helper.left_op());
+      const CsrTensor_ right = apply_op(other, gemm_helper.right_op());
+      const size_type m = left.rows(), k = left.cols(), n = right.cols();
+
+      if(left.csr_ && right.csr_) {
+        // Accumulate each result row in a dense row, and record its pattern
+        std::shared_ptr<Csr> result = std::make_shared<Csr>();
+        result->row_ptr.reserve(m + 1ul);
+        result->row_ptr.push_back(0ul);
+        std::vector<numeric_type> row(n, numeric_type(0));
+        std::vector<size_type> marker(n, m);
+        std::vector<size_type> pattern;
+        for(size_type i = 0ul; i < m; ++i) {
+          pattern.clear();
+          for(size_type a = left.csr_->row_ptr[i]; a < left.csr_->row_ptr[i + 1ul]; ++a) {
+            const size_type j = left.csr_->col[a];
+            const numeric_type x = left.csr_->value[a] * numeric_type(factor);
+            for(size_type b = right.csr_->row_ptr[j]; b < right.csr_->row_ptr[j + 1ul]; ++b) {
+              const size_type c = right.csr_->col[b];
+              if(marker[c] != i) {
+                marker[c] = i;
+                pattern.push_back(c);
+                row[c] = x * right.csr_->value[b];
+              } else {
+                row[c] += x * right.csr_->value[b];
+              }
+            }
+          }
+          std::sort(pattern.begin(), pattern.end());
+          for(const size_type c : pattern) {
+            if(row[c] != numeric_type(0)) {
+              result->col.push_back(c);
+              result->value.push_back(row[c]);
+            }
+          }
+          result->row_ptr.push_back(result->col.size());
+        }
+        return make_sparse(range, result);
+      }
+
+      Tensor<T> result(range, numeric_type(0));
+      numeric_type* MADNESS_RESTRICT const c = result.data();
+      if(left.csr_) {
+        // Add the scaled rows of the right-hand tile
+        const numeric_type* MADNESS_RESTRICT const b = right.dense_.data();
+        for(size_type i = 0ul; i < m; ++i) {
+          for(size_type e = left.csr_->row_ptr[i]; e < left.csr_->row_ptr[i + 1ul]; ++e) {
+            const numeric_type x = left.csr_->value[e] * numeric_type(factor);
+            const numeric_type* MADNESS_RESTRICT const b_row = b + left.csr_->col[e] * n;
+            numeric_type* MADNESS_RESTRICT const c_row = c + i * n;
+            for(size_type j = 0ul; j < n; ++j)
+              c_row[j] += x * b_row[j];
+          }
+        }
+      } else {
+        // Scatter the rows of the right-hand tile
+        const numeric_type* MADNESS_RESTRICT const a = left.dense_.data();
+        for(size_type i = 0ul; i < m; ++i) {
+          numeric_type* MADNESS_RESTRICT const c_row = c + i * n;
+          for(size_type j = 0ul; j < k; ++j) {
+            if(a[i * k + j] == numeric_type(0))
+              continue;
+            const numeric_type x = a[i * k + j] * numeric_type(factor);
+            for(size_type e = right.csr_->row_ptr[j]; e < right.csr_->row_ptr[j + 1ul]; ++e)
+              c_row[right.csr_->col[e]] += x * right.csr_->value[e];
+          }
+        }
+      }
+      return make_dense(result);
+    }
+
+    /// Contract \c left and \c right, and add the result to this tile
+
+    /// Products of dense tiles are accumulated in place into a dense tile.
+    /// \tparam Scalar A scalar type
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction parameters
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    CsrTensor_& gemm(const CsrTensor_& left, const CsrTensor_& right,
+        const Scalar factor, const math::GemmHelper& gemm_helper)
+    {
+      if(empty())
+        return (*this = left.gemm(right, factor, gemm_helper));
+      if(! (csr_ || left.csr_ || right.csr_)) {
+        dense_.gemm(left.dense_, right.dense_, factor, gemm_helper);
+        return *this;
+      }
+      return add_to(left.gemm(right, factor, gemm_helper));
+    }
+
+    // Reduction operations ----------------------------------------------------
+
+    /// Sum the diagonal elements of this tile
+
+    /// \return The sum of the elements <tt>(i,i)</tt>
+    numeric_type trace() const {
+      TA_ASSERT(! empty());
+      const size_type row_begin = range_.lobound_data()[0];
+      const size_type col_begin = range_.lobound_data()[1];
+      numeric_type result(0);
+      for(size_type i = std::max(row_begin, col_begin);
+          i < std::min(row_begin + rows(), col_begin + cols()); ++i)
+        result += at(i - row_begin, i - col_begin);
+      return result;
+    }
+
+    /// Sum the elements of this tile
+
+    /// \return The sum of the elements
+    numeric_type sum() const {
+      TA_ASSERT(! empty());
+      if(! csr_)
+        return dense_.sum();
+      return std::accumulate(csr_->value.begin(), csr_->value.end(),
+          numeric_type(0));
+    }
+
+    /// Multiply the elements of this tile
+
+    /// \return The product of the elements
+    numeric_type product() const {
+      TA_ASSERT(! empty());
+      if(! csr_)
+        return dense_.product();
+      if(csr_->value.size() < size())
+        return numeric_type(0);
+      return std::accumulate(csr_->value.begin(), csr_->value.end(),
+          numeric_type(1), std::multiplies<numeric_type>());
+    }
+
+    /// Squared Frobenius norm
+
+    /// \return The squared Frobenius norm of this tile
+    scalar_type squared_norm() const {
+      TA_ASSERT(! empty());
+      if(! csr_)
+        return dense_.squared_norm();
+      scalar_type result(0);
+      for(const numeric_type value : csr_->value)
+        result += value * value;
+      return result;
+    }
+
+    /// Frobenius norm
+
+    /// \return The Frobenius norm of this tile
+    scalar_type norm() const { return std::sqrt(squared_norm()); }
+
+    /// Maximum element
+
+    /// \return The maximum element of this tile
+    numeric_type max() const {
+      TA_ASSERT(! empty());
+      if(! csr_)
+        return dense_.max();
+      numeric_type result = (csr_->value.size() < size() ? numeric_type(0) :
+          csr_->value.front());
+      for(const numeric_type value : csr_->value)
+        result = std::max(result, value);
+      return result;
+    }
+
+    /// Minimum element
+
+    /// \return The minimum element of this tile
+    numeric_type min() const {
+      TA_ASSERT(! empty());
+      if(! csr_)
+        return dense_.min();
+      numeric_type result = (csr_->value.size() < size() ? numeric_type(0) :
+          csr_->value.front());
+      for(const numeric_type value : csr_->value)
+        result = std::min(result, value);
+      return result;
+    }
+
+    /// Absolute maximum element
+
+    /// \return The maximum absolute value of the elements of this tile
+    scalar_type abs_max() const {
+      TA_ASSERT(! empty());
+      if(! csr_)
+        return dense_.abs_max();
+      scalar_type result(0);
+      for(const numeric_type value : csr_->value)
+        result = std::max<scalar_type>(result, std::abs(value));
+      return result;
+    }
+
+    /// Absolute minimum element
+
+    /// \return The minimum absolute value of the elements of this tile
+    scalar_type abs_min() const {
+      TA_ASSERT(! empty());
+      if(! csr_)
+        return dense_.abs_min();
+      if(csr_->value.size() < size())
+        return scalar_type(0);
+      scalar_type result = std::abs(csr_->value.front());
+      for(const numeric_type value : csr_->value)
+        result = std::min<scalar_type>(result, std::abs(value));
+      return result;
+    }
+
+    /// Vector dot product
+
+    /// \param other The other tile
+    /// \return The sum of the products of the elements of this tile and
+    /// \c other
+    numeric_type dot(const CsrTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "CsrTensor: The ranges of the tiles do not match.");
+      if(! (csr_ || other.csr_))
+        return dense_.dot(other.dense_);
+      if(! csr_)
+        return other.dot(*this);
+
+      numeric_type result(0);
+      for(size_type i = 0ul; i < rows(); ++i)
+        for(size_type e = csr_->row_ptr[i]; e < csr_->row_ptr[i + 1ul]; ++e)
+          result += csr_->value[e] * other.at(i, csr_->col[e]);
+      return result;
+    }
+
+  }; // class CsrTensor
+
+  /// Element-sparse tile output operator
+
+  /// The tile is printed as a dense matrix.
+  /// \tparam T The element type
+  /// \param os The output stream
+  /// \param tile The tile to be output
+  /// \return A reference to the output stream
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const CsrTensor<T>& tile) {
+    if(tile.empty())
+      os << "[ ]";
+    else
+      os << tile.dense();
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_CSR_TENSOR_H__INCLUDED
@@ -0,0 +1,906 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  device_tensor.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_DEVICE_TENSOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_DEVICE_TENSOR_H__INCLUDED
+
+#include <TiledArray/config.h>
+
+#ifdef TILEDARRAY_HAS_CUDA
+
+#include <TiledArray/tensor/tensor.h>
+#include <TiledArray/tensor/pool_allocator.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <cuda_runtime.h>
+#include <cublas_v2.h>
+#include <iostream>
+#include <memory>
+
+namespace TiledArray {
+
+  namespace detail {
+
+    /// Check the status of a CUDA runtime call
+
+    /// \param status The status returned by the call
+    /// \throw TiledArray::Exception When \c status is not \c cudaSuccess
+    inline void cuda_check(const cudaError_t status) {
+      TA_USER_ASSERT(status == cudaSuccess, "A CUDA runtime call failed.");
+    }
+
+    /// Check the status of a cuBLAS call
+
+    /// \param status The status returned by the call
+    /// \throw TiledArray::Exception When \c status is not
+    /// \c CUBLAS_STATUS_SUCCESS
+    inline void cuda_check(const cublasStatus_t status) {
+      TA_USER_ASSERT(status == CUBLAS_STATUS_SUCCESS, "A cuBLAS call failed.");
+    }
+
+    /// The device used by the tile operations of this process
+
+    /// \return A reference to the device id, which is 0 by default
+    inline int& cuda_device() {
+      static int device = 0;
+      return device;
+    }
+
+    /// The CUDA stream and cuBLAS handle of a thread
+
+    /// Each thread enqueues its device tile operations on its own stream, so
+    /// the operations of different MADNESS tasks run concurrently on the
+    /// device. The context is created the first time a thread uses it.
+    class CudaContext {
+    private:
+      int device_; ///< The device of the stream
+      cudaStream_t stream_; ///< The stream of this thread
+      cublasHandle_t handle_; ///< The cuBLAS handle bound to \c stream_
+
+      CudaContext() : device_(cuda_device()), stream_(), handle_() {
+        cuda_check(cudaSetDevice(device_));
+        cuda_check(cudaStreamCreateWithFlags(& stream_, cudaStreamNonBlocking));
+        cuda_check(cublasCreate(& handle_));
+        cuda_check(cublasSetStream(handle_, stream_));
+      }
+
+      CudaContext(const CudaContext&) = delete;
+      CudaContext& operator=(const CudaContext&) = delete;
+
+    public:
+
+      ~CudaContext() {
+        // Errors are ignored since the CUDA runtime may already be shut down
+        cublasDestroy(handle_);
+        cudaStreamDestroy(stream_);
+      }
+
+      /// \return The context of the calling thread
+      static CudaContext& instance() {
+        static thread_local CudaContext context;
+        return context;
+      }
+
+      /// \return The stream of this thread
+      cudaStream_t stream() const { return stream_; }
+
+      /// \return The cuBLAS handle of this thread
+      cublasHandle_t handle() const { return handle_; }
+
+      /// Wait for the enqueued operations of this thread to finish
+      void synchronize() const { cuda_check(cudaStreamSynchronize(stream_)); }
+
+    }; // class CudaContext
+
+    /// A CUDA event that marks the completion of a tile operation
+    class CudaEvent {
+    private:
+      cudaEvent_t event_; ///< The event
+
+      CudaEvent(const CudaEvent&) = delete;
+      CudaEvent& operator=(const CudaEvent&) = delete;
+
+    public:
+
+      /// Record an event on a stream
+
+      /// \param stream The stream of the operation
+      explicit CudaEvent(cudaStream_t stream) : event_() {
+        cuda_check(cudaEventCreateWithFlags(& event_, cudaEventDisableTiming));
+        cuda_check(cudaEventRecord(event_, stream));
+      }
+
+      ~CudaEvent() { cudaEventDestroy(event_); }
+
+      /// Make \c stream wait for this event
+
+      /// \param stream The stream that will wait
+      void wait(cudaStream_t stream) const {
+        cuda_check(cudaStreamWaitEvent(stream, event_, 0));
+      }
+
+    }; // class CudaEvent
+
+    // cuBLAS wrappers for float and double elements
+
+    inline cublasStatus_t cublas_gemm(cublasHandle_t h, cublasOperation_t ta,
+        cublasOperation_t tb, int m, int n, int k, const float* alpha,
+        const float* a, int lda, const float* b, int ldb, const float* beta,
+        float* c, int ldc)
+    { return cublasSgemm(h, ta, tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc); }
+
+    inline cublasStatus_t cublas_gemm(cublasHandle_t h, cublasOperation_t ta,
+        cublasOperation_t tb, int m, int n, int k, const double* alpha,
+        const double* a, int lda, const double* b, int ldb, const double* beta,
+        double* c, int ldc)
+    { return cublasDgemm(h, ta, tb, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc); }
+
+    inline cublasStatus_t cublas_geam(cublasHandle_t h, cublasOperation_t ta,
+        cublasOperation_t tb, int m, int n, const float* alpha, const float* a,
+        int lda, const float* beta, const float* b, int ldb, float* c, int ldc)
+    { return cublasSgeam(h, ta, tb, m, n, alpha, a, lda, beta, b, ldb, c, ldc); }
+
+    inline cublasStatus_t cublas_geam(cublasHandle_t h, cublasOperation_t ta,
+        cublasOperation_t tb, int m, int n, const double* alpha, const double* a,
+        int lda, const double* beta, const double* b, int ldb, double* c, int ldc)
+    { return cublasDgeam(h, ta, tb, m, n, alpha, a, lda, beta, b, ldb, c, ldc); }
+
+    inline cublasStatus_t cublas_dgmm(cublasHandle_t h, int n, const float* a,
+        const float* x, float* c)
+    { return cublasSdgmm(h, CUBLAS_SIDE_RIGHT, 1, n, a, 1, x, 1, c, 1); }
+
+    inline cublasStatus_t cublas_dgmm(cublasHandle_t h, int n, const double* a,
+        const double* x, double* c)
+    { return cublasDdgmm(h, CUBLAS_SIDE_RIGHT, 1, n, a, 1, x, 1, c, 1); }
+
+    inline cublasStatus_t cublas_axpy(cublasHandle_t h, int n, const float* alpha,
+        const float* x, float* y)
+    { return cublasSaxpy(h, n, alpha, x, 1, y, 1); }
+
+    inline cublasStatus_t cublas_axpy(cublasHandle_t h, int n, const double* alpha,
+        const double* x, double* y)
+    { return cublasDaxpy(h, n, alpha, x, 1, y, 1); }
+
+    inline cublasStatus_t cublas_scal(cublasHandle_t h, int n, const float* alpha,
+        float* x)
+    { return cublasSscal(h, n, alpha, x, 1); }
+
+    inline cublasStatus_t cublas_scal(cublasHandle_t h, int n, const double* alpha,
+        double* x)
+    { return cublasDscal(h, n, alpha, x, 1); }
+
+    inline cublasStatus_t cublas_nrm2(cublasHandle_t h, int n, const float* x,
+        float* result)
+    { return cublasSnrm2(h, n, x, 1, result); }
+
+    inline cublasStatus_t cublas_nrm2(cublasHandle_t h, int n, const double* x,
+        double* result)
+    { return cublasDnrm2(h, n, x, 1, result); }
+
+    inline cublasStatus_t cublas_dot(cublasHandle_t h, int n, const float* x,
+        const float* y, float* result)
+    { return cublasSdot(h, n, x, 1, y, 1, result); }
+
+    inline cublasStatus_t cublas_dot(cublasHandle_t h, int n, const double* x,
+        const double* y, double* result)
+    { return cublasDdot(h, n, x, 1, y, 1, result); }
+
+  } // namespace detail
+
+  /// Select the device used by device tiles
+
+  /// The device must be selected before device tiles are used by any thread;
+  /// a common choice is the rank of the process on its node modulo the number
+  /// of devices.
+  /// \param device The CUDA device id
+  inline void set_cuda_device(const int device) {
+    detail::cuda_device() = device;
+  }
+
+  /// A tile stored in GPU memory
+
+  /// The elements are stored in row-major order in device memory. Products
+  /// are evaluated with cuBLAS \c gemm , and element-wise operations and
+  /// matrix transposes with cuBLAS \c geam , \c axpy , \c scal , and \c dgmm .
+  ///
+  /// Operations are asynchronous: they are enqueued on the CUDA stream of the
+  /// calling thread, and the tile they produce records an event on that
+  /// stream. An operation that uses the tile on another stream first waits
+  /// for its event, so a MADNESS future to a tile may be set before the
+  /// device has computed it, and the task that computes the next operation
+  /// does not block. The host only waits when elements are copied to it,
+  /// e.g. by \c host() , a reduction, or serialization.
+  ///
+  /// This tile type implements the tile interface, and may be used as the
+  /// tile type of \c DistArray :
+  /// \code
+  /// typedef TiledArray::DistArray<TiledArray::DeviceTensor<double> > DeviceArray;
+  /// \endcode
+  /// \note Like \c Tensor , copies share their data; use \c clone() for a
+  /// deep copy. Permutations of tiles with more than two dimensions, and
+  /// reductions other than norms and dot products, are evaluated on the
+  /// host.
+  /// \tparam T The element type, \c float or \c double
+  template <typename T>
+  class DeviceTensor {
+    static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+        "DeviceTensor only supports float and double elements.");
+  public:
+    typedef DeviceTensor<T> DeviceTensor_; ///< This class type
+    typedef Range range_type; ///< Tile range type
+    typedef typename range_type::size_type size_type; ///< Size type
+    typedef T value_type; ///< Element type
+    typedef T numeric_type; ///< Numeric type
+    typedef T scalar_type; ///< Scalar type
+
+  private:
+
+    range_type range_; ///< The range of the tile
+    std::shared_ptr<T> data_; ///< The device memory of the elements
+    std::shared_ptr<const detail::CudaEvent> ready_; ///< Completion event of the last operation on \c data_
+
+    /// Allocate device memory for the elements of \c range_
+    void allocate() {
+      T* data = nullptr;
+      if(range_.volume())
+        detail::cuda_check(cudaMalloc(& data, range_.volume() * sizeof(T)));
+      data_.reset(data, [] (T* p) { cudaFree(p); });
+    }
+
+    /// Number of elements as a cuBLAS dimension
+    int n() const { return static_cast<int>(range_.volume()); }
+
+    /// Make the stream of \c context wait for pending operations on this tile
+    void wait(const detail::CudaContext& context) const {
+      if(ready_)
+        ready_->wait(context.stream());
+    }
+
+    /// Mark the operations enqueued on the stream of \c context
+    void record(const detail::CudaContext& context) {
+      ready_ = std::make_shared<const detail::CudaEvent>(context.stream());
+    }
+
+    /// Compute <tt>alpha * a + beta * b</tt> element-wise
+
+    /// \param alpha The factor of \c a
+    /// \param a The first argument
+    /// \param beta The factor of \c b
+    /// \param b The second argument
+    /// \return The sum
+    static DeviceTensor_ geam(const T alpha, const DeviceTensor_& a,
+        const T beta, const DeviceTensor_& b)
+    {
+      TA_ASSERT(! a.empty());
+      TA_ASSERT(! b.empty());
+      TA_ASSERT(a.range_ == b.range_);
+      DeviceTensor_ result(a.range_);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      a.wait(context);
+      b.wait(context);
+      detail::cuda_check(detail::cublas_geam(context.handle(), CUBLAS_OP_N,
+          CUBLAS_OP_N, a.n(), 1, & alpha, a.data(), a.n(), & beta, b.data(),
+          a.n(), result.data(), a.n()));
+      result.record(context);
+      return result;
+    }
+
+    /// Add <tt>alpha * arg</tt> to this tile
+
+    /// \param alpha The factor of \c arg
+    /// \param arg The tile to be added
+    /// \return A reference to this tile
+    DeviceTensor_& axpy(const T alpha, const DeviceTensor_& arg) {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! arg.empty());
+      TA_ASSERT(range_ == arg.range_);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      arg.wait(context);
+      detail::cuda_check(detail::cublas_axpy(context.handle(), n(), & alpha,
+          arg.data(), data()));
+      record(context);
+      return *this;
+    }
+
+    /// Permute a tile
+
+    /// Matrix transposes are evaluated on the device; other permutations are
+    /// evaluated on the host.
+    /// \param arg The tile to be permuted
+    /// \param perm The permutation
+    /// \return The permuted tile
+    static DeviceTensor_ permute(const DeviceTensor_& arg, const Permutation& perm) {
+      TA_ASSERT(! arg.empty());
+      TA_ASSERT(perm.dim() == arg.range_.rank());
+      if(perm.dim() != 2u)
+        return DeviceTensor_(arg.host().permute(perm));
+      if(perm[0] == 0u)
+        return arg.clone();
+
+      // The row-major m x n argument is a column-major n x m matrix, and the
+      // row-major n x m result is a column-major m x n matrix.
+      const int m = arg.range_.extent_data()[0];
+      const int n = arg.range_.extent_data()[1];
+      DeviceTensor_ result(perm * arg.range_);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      arg.wait(context);
+      const T one(1), zero(0);
+      detail::cuda_check(detail::cublas_geam(context.handle(), CUBLAS_OP_T,
+          CUBLAS_OP_N, m, n, & one, arg.data(), n, & zero, result.data(), m,
+          result.data(), m));
+      result.record(context);
+      return result;
+    }
+
+  public:
+
+    DeviceTensor() = default;
+    DeviceTensor(const DeviceTensor_&) = default;
+    DeviceTensor(DeviceTensor_&&) = default;
+    ~DeviceTensor() = default;
+    DeviceTensor_& operator=(const DeviceTensor_&) = default;
+    DeviceTensor_& operator=(DeviceTensor_&&) = default;
+
+    /// Construct an uninitialized tile
+
+    /// \param range The range of the tile
+    explicit DeviceTensor(const range_type& range) :
+      range_(range), data_(), ready_()
+    { allocate(); }
+
+    /// Construct a tile filled with a value
+
+    /// \param range The range of the tile
+    /// \param value The value of the elements
+    DeviceTensor(const range_type& range, const numeric_type value) :
+      range_(range), data_(), ready_()
+    {
+      if(value != numeric_type(0)) {
+        *this = DeviceTensor_(Tensor<T>(range, value));
+        return;
+      }
+
+      allocate();
+      if(range_.volume()) {
+        const detail::CudaContext& context = detail::CudaContext::instance();
+        detail::cuda_check(cudaMemsetAsync(data(), 0, range_.volume() * sizeof(T),
+            context.stream()));
+        record(context);
+      }
+    }
+
+    /// Copy a host tile to the device
+
+    /// Tiles allocated with \c PinnedAllocator are copied directly by the
+    /// device, without a staging copy.
+    /// \tparam A The allocator type of the host tile
+    /// \param tensor The host tile
+    template <typename A>
+    explicit DeviceTensor(const Tensor<T, A>& tensor) :
+      range_(), data_(), ready_()
+    {
+      if(tensor.empty())
+        return;
+      range_ = tensor.range();
+      allocate();
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      detail::cuda_check(cudaMemcpyAsync(data(), tensor.data(),
+          range_.volume() * sizeof(T), cudaMemcpyHostToDevice, context.stream()));
+      record(context);
+    }
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// \return The number of elements of the tile
+    size_type size() const { return range_.volume(); }
+
+    /// \return \c true if this tile is not initialized
+    bool empty() const { return ! data_; }
+
+    /// \return A device pointer to the elements
+    T* data() const { return data_.get(); }
+
+    /// Copy this tile to the host
+
+    /// The calling thread waits for the pending operations on this tile.
+    /// \tparam A The allocator type of the host tile; use \c PinnedAllocator
+    /// to copy the elements without a staging copy
+    /// \return A host tile with the elements of this tile
+    template <typename A = Eigen::aligned_allocator<T> >
+    Tensor<T, A> host() const {
+      if(empty())
+        return Tensor<T, A>();
+      Tensor<T, A> result(range_);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      detail::cuda_check(cudaMemcpyAsync(result.data(), data(),
+          range_.volume() * sizeof(T), cudaMemcpyDeviceToHost, context.stream()));
+      context.synchronize();
+      return result;
+    }
+
+    /// \return A copy of this tile
+    DeviceTensor_ clone() const {
+      if(empty())
+        return DeviceTensor_();
+      DeviceTensor_ result(range_);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      detail::cuda_check(cudaMemcpyAsync(result.data(), data(),
+          range_.volume() * sizeof(T), cudaMemcpyDeviceToDevice, context.stream()));
+      result.record(context);
+      return result;
+    }
+
+    /// Output serialization function
+
+    /// The elements are copied to pinned host memory and serialized as a
+    /// \c Tensor .
+    /// \tparam Archive The output archive type
+    /// \param ar The output archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      ar & host<PinnedAllocator<T> >();
+    }
+
+    /// Input serialization function
+
+    /// \tparam Archive The input archive type
+    /// \param ar The input archive
+    template <typename Archive,
+        typename std::enable_if<
+          madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+    void serialize(Archive& ar) {
+      Tensor<T, PinnedAllocator<T> > tensor;
+      ar & tensor;
+      *this = DeviceTensor_(tensor);
+    }
+
+    // Permutation operations --------------------------------------------------
+
+    /// Create a permuted copy of this tile
+
+    /// \param perm The permutation
+    /// \return A permuted copy of this tile
+    DeviceTensor_ permute(const Permutation& perm) const {
+      return permute(*this, perm);
+    }
+
+    /// Shift the range of this tile
+
+    /// \tparam Index An index type
+    /// \param bound_shift The shift to be applied to the range
+    /// \return A copy of this tile with a shifted range
+    template <typename Index>
+    DeviceTensor_ shift(const Index& bound_shift) const {
+      DeviceTensor_ result = clone();
+      result.range_.inplace_shift(bound_shift);
+      return result;
+    }
+
+    /// Shift the range of this tile
+
+    /// \tparam Index An index type
+    /// \param bound_shift The shift to be applied to the range
+    /// \return A reference to this tile
+    template <typename Index>
+    DeviceTensor_& shift_to(const Index& bound_shift) {
+      range_.inplace_shift(bound_shift);
+      return *this;
+    }
+
+    // Scaling operations ------------------------------------------------------
+
+    /// Scale this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>this * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ scale(const Scalar factor) const {
+      return geam(T(factor), *this, T(0), *this);
+    }
+
+    /// Scale and permute this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm * (this * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ scale(const Scalar factor, const Permutation& perm) const {
+      return permute(scale(factor), perm);
+    }
+
+    /// Scale this tile in place
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_& scale_to(const Scalar factor) {
+      TA_ASSERT(! empty());
+      const T alpha(factor);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      detail::cuda_check(detail::cublas_scal(context.handle(), n(), & alpha, data()));
+      record(context);
+      return *this;
+    }
+
+    /// \return A tile equal to <tt>-this</tt>
+    DeviceTensor_ neg() const { return scale(numeric_type(-1)); }
+
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm * -this</tt>
+    DeviceTensor_ neg(const Permutation& perm) const {
+      return scale(numeric_type(-1), perm);
+    }
+
+    /// \return A reference to this tile, after it is negated
+    DeviceTensor_& neg_to() { return scale_to(numeric_type(-1)); }
+
+    // Addition operations -----------------------------------------------------
+
+    /// \param other The tile to be added
+    /// \return A tile equal to <tt>this + other</tt>
+    DeviceTensor_ add(const DeviceTensor_& other) const {
+      return geam(T(1), *this, T(1), other);
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this + other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ add(const DeviceTensor_& other, const Scalar factor) const {
+      return geam(T(factor), *this, T(factor), other);
+    }
+
+    /// \param other The tile to be added
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm * (this + other)</tt>
+    DeviceTensor_ add(const DeviceTensor_& other, const Permutation& perm) const {
+      return permute(add(other), perm);
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm * ((this + other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ add(const DeviceTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return permute(add(other, factor), perm);
+    }
+
+    /// \param other The tile to be added
+    /// \return A reference to this tile
+    DeviceTensor_& add_to(const DeviceTensor_& other) {
+      return axpy(T(1), other);
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added
+    /// \param factor The scaling factor
+    /// \return A reference to this tile, after it is set to
+    /// <tt>(this + other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_& add_to(const DeviceTensor_& other, const Scalar factor) {
+      return add_to(other).scale_to(factor);
+    }
+
+    // Subtraction operations --------------------------------------------------
+
+    /// \param other The tile to be subtracted
+    /// \return A tile equal to <tt>this - other</tt>
+    DeviceTensor_ subt(const DeviceTensor_& other) const {
+      return geam(T(1), *this, T(-1), other);
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this - other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ subt(const DeviceTensor_& other, const Scalar factor) const {
+      return geam(T(factor), *this, -T(factor), other);
+    }
+
+    /// \param other The tile to be subtracted
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm * (this - other)</tt>
+    DeviceTensor_ subt(const DeviceTensor_& other, const Permutation& perm) const {
+      return permute(subt(other), perm);
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm * ((this - other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ subt(const DeviceTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return permute(subt(other, factor), perm);
+    }
+
+    /// \param other The tile to be subtracted
+    /// \return A reference to this tile
+    DeviceTensor_& subt_to(const DeviceTensor_& other) {
+      return axpy(T(-1), other);
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted
+    /// \param factor The scaling factor
+    /// \return A reference to this tile, after it is set to
+    /// <tt>(this - other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_& subt_to(const DeviceTensor_& other, const Scalar factor) {
+      return subt_to(other).scale_to(factor);
+    }
+
+    // Multiplication operations -----------------------------------------------
+
+    /// \param other The right-hand tile
+    /// \return The element-wise product of this tile and \c other
+    DeviceTensor_ mult(const DeviceTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(range_ == other.range_);
+      DeviceTensor_ result(range_);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      other.wait(context);
+      detail::cuda_check(detail::cublas_dgmm(context.handle(), n(), data(),
+          other.data(), result.data()));
+      result.record(context);
+      return result;
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \return The element-wise product of this tile and \c other , scaled by
+    /// \c factor
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ mult(const DeviceTensor_& other, const Scalar factor) const {
+      return mult(other).scale_to(factor);
+    }
+
+    /// \param other The right-hand tile
+    /// \param perm The permutation
+    /// \return The permuted element-wise product of this tile and \c other
+    DeviceTensor_ mult(const DeviceTensor_& other, const Permutation& perm) const {
+      return permute(mult(other), perm);
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return The permuted element-wise product of this tile and \c other ,
+    /// scaled by \c factor
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ mult(const DeviceTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return permute(mult(other, factor), perm);
+    }
+
+    /// \param other The right-hand tile
+    /// \return A reference to this tile, after it is multiplied element-wise
+    /// by \c other
+    DeviceTensor_& mult_to(const DeviceTensor_& other) {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(range_ == other.range_);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      other.wait(context);
+      detail::cuda_check(detail::cublas_dgmm(context.handle(), n(), data(),
+          other.data(), data()));
+      record(context);
+      return *this;
+    }
+
+    /// \tparam Scalar A scalar type
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile, after it is multiplied element-wise
+    /// by \c other and scaled by \c factor
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_& mult_to(const DeviceTensor_& other, const Scalar factor) {
+      return mult_to(other).scale_to(factor);
+    }
+
+    // Contraction operations --------------------------------------------------
+
+    /// Contract this tile with \c other
+
+    /// \tparam Scalar A scalar type
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction parameters
+    /// \return The contraction of this tile and \c other
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_ gemm(const DeviceTensor_& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      DeviceTensor_ result;
+      return result.gemm(*this, other, factor, gemm_helper);
+    }
+
+    /// Contract \c left and \c right, and add the result to this tile
+
+    /// An empty tile is allocated and set to the product, without being
+    /// cleared first.
+    /// \tparam Scalar A scalar type
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction parameters
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    DeviceTensor_& gemm(const DeviceTensor_& left, const DeviceTensor_& right,
+        const Scalar factor, const math::GemmHelper& gemm_helper)
+    {
+      TA_ASSERT(! left.empty());
+      TA_ASSERT(left.range_.rank() == gemm_helper.left_rank());
+      TA_ASSERT(! right.empty());
+      TA_ASSERT(right.range_.rank() == gemm_helper.right_rank());
+      // An empty tile is allocated without being cleared, and overwritten
+      const bool overwrite = empty();
+      if(overwrite)
+        *this = DeviceTensor_(gemm_helper.make_result_range<range_type>(
+            left.range_, right.range_));
+      TA_ASSERT(range_.rank() == gemm_helper.result_rank());
+
+      // Compute gemm dimensions
+      integer m, n, k;
+      gemm_helper.compute_matrix_sizes(m, n, k, left.range_, right.range_);
+
+      // Get the leading dimension for left and right matrices.
+      const integer lda =
+          (gemm_helper.left_op() == madness::cblas::NoTrans ? k : m);
+      const integer ldb =
+          (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
+
+      // Row-major C = A * B is evaluated as column-major C^T = B^T * A^T
+      const cublasOperation_t op_a =
+          (gemm_helper.left_op() == madness::cblas::NoTrans ? CUBLAS_OP_N : CUBLAS_OP_T);
+      const cublasOperation_t op_b =
+          (gemm_helper.right_op() == madness::cblas::NoTrans ? CUBLAS_OP_N : CUBLAS_OP_T);
+      const T alpha(factor), beta(overwrite ? 0 : 1);
+
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      left.wait(context);
+      right.wait(context);
+      detail::cuda_check(detail::cublas_gemm(context.handle(), op_b, op_a, n, m,
+          k, & alpha, right.data(), ldb, left.data(), lda, & beta, data(), n));
+      record(context);
+      return *this;
+    }
+
+    // Reduction operations ----------------------------------------------------
+
+    /// \return The sum of the diagonal elements
+    numeric_type trace() const { return host().trace(); }
+
+    /// \return The sum of the elements
+    numeric_type sum() const { return host().sum(); }
+
+    /// \return The product of the elements
+    numeric_type product() const { return host().product(); }
+
+    /// \return The vector 2-norm of the elements
+    scalar_type norm() const {
+      TA_ASSERT(! empty());
+      scalar_type result(0);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      detail::cuda_check(detail::cublas_nrm2(context.handle(), n(), data(), & result));
+      return result;
+    }
+
+    /// \return The square of the vector 2-norm of the elements
+    scalar_type squared_norm() const {
+      const scalar_type result = norm();
+      return result * result;
+    }
+
+    /// \return The minimum element
+    numeric_type min() const { return host().min(); }
+
+    /// \return The maximum element
+    numeric_type max() const { return host().max(); }
+
+    /// \return The minimum absolute value of the elements
+    scalar_type abs_min() const { return host().abs_min(); }
+
+    /// \return The maximum absolute value of the elements
+    scalar_type abs_max() const { return host().abs_max(); }
+
+    /// \param other The other tile
+    /// \return The inner product of this tile and \c other
+    numeric_type dot(const DeviceTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(range_ == other.range_);
+      numeric_type result(0);
+      const detail::CudaContext& context = detail::CudaContext::instance();
+      wait(context);
+      other.wait(context);
+      detail::cuda_check(detail::cublas_dot(context.handle(), n(), data(),
+          other.data(), & result));
+      return result;
+    }
+
+  }; // class DeviceTensor
+
+  /// Device tile output operator
+
+  /// \tparam T The element type
+  /// \param os The output stream
+  /// \param tile The tile to be output
+  /// \return A reference to the output stream
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const DeviceTensor<T>& tile) {
+    if(tile.empty())
+      os << "[ ]";
+    else
+      os << tile.host();
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_HAS_CUDA
+
+#endif // TILEDARRAY_TENSOR_DEVICE_TENSOR_H__INCLUDED
@@ -245,9 +245,15 @@ namespace TiledArray {
       const auto stride = inner_size(result, tensors...);
       const auto volume = result.range().volume();
 
-      for(decltype(result.range().volume()) i = 0ul; i < volume; i += stride)
-        math::inplace_vector_op(op, stride, result.data() + result.range().ordinal(i),
-          (tensors.data() + tensors.range().ordinal(i))...);
+      // Strided blocks of large tensors are divided among idle threads
+      auto block_op = [&] (const std::size_t first, const std::size_t last) {
+        for(std::size_t b = first; b < last; ++b) {
+          const auto i = b * stride;
+          math::inplace_vector_op(op, stride, result.data() + result.range().ordinal(i),
+            (tensors.data() + tensors.range().ordinal(i))...);
+        }
+      };
+      math::range_block_op(block_op, volume / stride, stride);
     }
 
     /// In-place tensor of tensors operations with non-contiguous data
@@ -307,9 +313,10 @@ namespace TiledArray {
 
       const auto volume = result.range().volume();
 
-      auto wrapper_op = [=] (typename TR::pointer MADNESS_RESTRICT result,
-              typename Ts::const_reference MADNESS_RESTRICT... ts)
-          { new(result) typename TR::value_type(op(ts...)); };
+      // Each block of the partition is initialized with the SIMD kernel of
+      // op, where there is one
+      math::InitVectorOp<typename std::decay<Op>::type,
+          typename TR::value_type> wrapper_op(op);
 
       math::vector_ptr_op(wrapper_op, volume, result.data(), tensors.data()...);
     }
@@ -366,11 +373,8 @@ namespace TiledArray {
       TA_ASSERT(perm);
       TA_ASSERT(perm.dim() == result.range().rank());
 
-      auto output_op = [=] (typename TR::pointer MADNESS_RESTRICT result,
-          typename TR::const_reference  MADNESS_RESTRICT temp)
-          { new(result) typename TR::value_type(temp); };
-
-      permute(op, output_op, result, perm, tensor1, tensors...);
+      permute(op, math::InitOutputOp<typename TR::value_type>(), result, perm,
+          tensor1, tensors...);
     }
 
 
@@ -441,10 +445,16 @@ namespace TiledArray {
               const typename Ts::value_type... values)
           { new(result_ptr) typename T1::value_type(op(value1, values...)); };
 
-      for(decltype(tensor1.range().volume()) i = 0ul; i < volume; i += stride)
-        math::vector_ptr_op(wrapper_op, stride, result.data() + i,
-            (tensor1.data() + tensor1.range().ordinal(i)),
-            (tensors.data() + tensors.range().ordinal(i))...);
+      // Strided blocks of large tensors are divided among idle threads
+      auto block_op = [&] (const std::size_t first, const std::size_t last) {
+        for(std::size_t b = first; b < last; ++b) {
+          const auto i = b * stride;
+          math::vector_ptr_op(wrapper_op, stride, result.data() + i,
+              (tensor1.data() + tensor1.range().ordinal(i)),
+              (tensors.data() + tensors.range().ordinal(i))...);
+        }
+      };
+      math::range_block_op(block_op, volume / stride, stride);
     }
 
     /// Initialize tensor with one or more non-contiguous tensor arguments
@@ -0,0 +1,953 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  low_rank_tensor.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_LOW_RANK_TENSOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_LOW_RANK_TENSOR_H__INCLUDED
+
+#include <TiledArray/tensor/tensor.h>
+#include <TiledArray/math/eigen.h>
+#include <Eigen/QR>
+#include <Eigen/SVD>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace TiledArray {
+
+  /// A low-rank matrix tile
+
+  /// The tile data is stored as the product of a left factor, \c L , and a
+  /// right factor, \c R , where \c L is an \c m by \c k matrix and \c R is a
+  /// \c k by \c n matrix. The numerical rank, \c k , of the tile is chosen
+  /// adaptively: the factors are recompressed, with QR decompositions of the
+  /// factors and a singular value decomposition of the small \c k by \c k
+  /// core matrix, after every operation that increases the rank, and the
+  /// singular values are truncated such that the error of the tile (in the
+  /// Frobenius norm) relative to its norm, or to the norms of the arguments of
+  /// a sum, is less than \c tolerance() . The memory and the
+  /// flops of the tile operations are then proportional to \c k instead of
+  /// \c m or \c n .
+  ///
+  /// This tile type implements the tile interface, and may be used as the
+  /// tile type of \c DistArray :
+  /// \code
+  /// typedef TiledArray::DistArray<TiledArray::LowRankTensor<double> > LowRankArray;
+  /// \endcode
+  /// \note Only matrix (rank 2) tiles with real elements are supported.
+  /// Contractions must contract one index of each argument.
+  /// \tparam T The element type of the tile
+  template <typename T>
+  class LowRankTensor {
+    static_assert(std::is_floating_point<T>::value,
+        "LowRankTensor only supports real floating point elements.");
+  public:
+    typedef LowRankTensor<T> LowRankTensor_; ///< This class type
+    typedef Range range_type; ///< Tile range type
+    typedef typename range_type::size_type size_type; ///< Size type
+    typedef T value_type; ///< Element type
+    typedef T numeric_type; ///< Numeric type
+    typedef T scalar_type; ///< Scalar type
+    typedef Tensor<T> matrix_type; ///< Factor matrix type
+
+  private:
+
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> eigen_matrix; ///< Column-major matrix type
+    typedef Eigen::Matrix<T, Eigen::Dynamic, 1> eigen_vector; ///< Vector type
+
+    static scalar_type tolerance_; ///< The relative truncation tolerance
+
+    range_type range_; ///< The range of the tile
+    matrix_type left_; ///< The left factor (empty when the rank is zero)
+    matrix_type right_; ///< The right factor (empty when the rank is zero)
+
+    /// Construct a tile from factors without recompression
+
+    /// \param range The range of the tile
+    /// \param left The left factor
+    /// \param right The right factor
+    /// \return A tile equal to <tt>left * right</tt>
+    static LowRankTensor_ make_tile(const range_type& range,
+        const matrix_type& left, const matrix_type& right)
+    {
+      LowRankTensor_ result;
+      result.range_ = range;
+      result.left_ = left;
+      result.right_ = right;
+      return result;
+    }
+
+    /// Row count accessor
+
+    /// \return The number of rows of the tile
+    size_type rows() const { return range_.extent_data()[0]; }
+
+    /// Column count accessor
+
+    /// \return The number of columns of the tile
+    size_type cols() const { return range_.extent_data()[1]; }
+
+    /// Check the range of a tile argument
+
+    /// \param range The range of the argument
+    static void check_range(const range_type& range) {
+      TA_USER_ASSERT(range.rank() == 2u,
+          "LowRankTensor: The tile range must have a rank of 2.");
+    }
+
+    /// Copy a factor into an Eigen matrix
+
+    /// \param factor The factor
+    /// \param m The number of rows of \c factor
+    /// \param n The number of columns of \c factor
+    /// \return A copy of \c factor
+    static eigen_matrix to_eigen(const matrix_type& factor, const size_type m,
+        const size_type n)
+    {
+      if((m == 0ul) || (n == 0ul) || factor.empty())
+        return eigen_matrix(m, n);
+      return math::eigen_map(factor.data(), m, n);
+    }
+
+    /// Copy an Eigen matrix into a factor
+
+    /// \param matrix The matrix
+    /// \return A factor that holds a copy of \c matrix
+    static matrix_type to_factor(const eigen_matrix& matrix) {
+      if(matrix.size() == 0)
+        return matrix_type();
+      matrix_type result(range_type(size_type(matrix.rows()), size_type(matrix.cols())));
+      math::eigen_map(result.data(), matrix.rows(), matrix.cols()) = matrix;
+      return result;
+    }
+
+    /// Left factor accessor
+
+    /// \return A copy of the left factor
+    eigen_matrix left_matrix() const { return to_eigen(left_, rows(), rank()); }
+
+    /// Right factor accessor
+
+    /// \return A copy of the right factor
+    eigen_matrix right_matrix() const { return to_eigen(right_, rank(), cols()); }
+
+    /// Truncated rank
+
+    /// \param s The singular values, in decreasing order
+    /// \param tolerance The relative truncation tolerance
+    /// \param reference The squared norm that the error is relative to, if it
+    /// is larger than the squared norm of the singular values
+    /// \return The number of singular values that are kept
+    static Eigen::Index truncate(const eigen_vector& s, const scalar_type tolerance,
+        const scalar_type reference = scalar_type(0))
+    {
+      const scalar_type limit = tolerance * tolerance *
+          std::max(scalar_type(s.squaredNorm()), reference);
+      Eigen::Index k = s.size();
+      scalar_type tail = 0;
+      while((k > 0) && (tail + s[k - 1] * s[k - 1] <= limit)) {
+        tail += s[k - 1] * s[k - 1];
+        --k;
+      }
+      return k;
+    }
+
+    /// Construct a recompressed tile
+
+    /// \param range The range of the tile
+    /// \param left The left factor
+    /// \param right The right factor
+    /// \param reference The squared norm that the error is relative to, if it
+    /// is larger than the squared norm of the tile
+    /// \return A tile equal to <tt>left * right</tt> with a rank that is
+    /// truncated to \c tolerance()
+    static LowRankTensor_ compress(const range_type& range, const eigen_matrix& left,
+        const eigen_matrix& right, const scalar_type reference = scalar_type(0))
+    {
+      const Eigen::Index m = left.rows();
+      const Eigen::Index n = right.cols();
+      const Eigen::Index k = left.cols();
+      if(k == 0)
+        return LowRankTensor_(range);
+
+      // Orthogonalize the factors: left = q_left * r_left,
+      // right = r_right^T * q_right^T
+      Eigen::HouseholderQR<eigen_matrix> qr_left(left);
+      Eigen::HouseholderQR<eigen_matrix> qr_right(right.transpose());
+      const Eigen::Index k_left = std::min(m, k);
+      const Eigen::Index k_right = std::min(n, k);
+      const eigen_matrix q_left =
+          qr_left.householderQ() * eigen_matrix::Identity(m, k_left);
+      const eigen_matrix q_right =
+          qr_right.householderQ() * eigen_matrix::Identity(n, k_right);
+      const eigen_matrix r_left =
+          qr_left.matrixQR().topRows(k_left).template triangularView<Eigen::Upper>();
+      const eigen_matrix r_right =
+          qr_right.matrixQR().topRows(k_right).template triangularView<Eigen::Upper>();
+
+      // Truncate the singular values of the core matrix
+      Eigen::JacobiSVD<eigen_matrix> svd(r_left * r_right.transpose(),
+          Eigen::ComputeThinU | Eigen::ComputeThinV);
+      const Eigen::Index rank = truncate(svd.singularValues(), tolerance_, reference);
+      if(rank == 0)
+        return LowRankTensor_(range);
+
+      return make_tile(range,
+          to_factor(q_left * svd.matrixU().leftCols(rank) *
+              svd.singularValues().head(rank).asDiagonal()),
+          to_factor(svd.matrixV().leftCols(rank).transpose() * q_right.transpose()));
+    }
+
+    /// Transposed factors of a contraction argument
+
+    /// \param arg The contraction argument
+    /// \param op The matrix operation applied to \c arg
+    /// \param[out] left The left factor of <tt>op(arg)</tt>
+    /// \param[out] right The right factor of <tt>op(arg)</tt>
+    static void factors(const LowRankTensor_& arg,
+        const madness::cblas::CBLAS_TRANSPOSE op, eigen_matrix& left,
+        eigen_matrix& right)
+    {
+      if(op == madness::cblas::NoTrans) {
+        left = arg.left_matrix();
+        right = arg.right_matrix();
+      } else {
+        left = arg.right_matrix().transpose();
+        right = arg.left_matrix().transpose();
+      }
+    }
+
+    /// Concatenate the factors of two tiles
+
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor applied to the factors of \c other
+    /// \return A tile equal to <tt>this + other * factor</tt>
+    LowRankTensor_ concat(const LowRankTensor_& other, const scalar_type factor) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "LowRankTensor: The ranges of the tiles do not match.");
+      eigen_matrix left(rows(), rank() + other.rank());
+      eigen_matrix right(rank() + other.rank(), cols());
+      left << left_matrix(), other.left_matrix() * factor;
+      right << right_matrix(), other.right_matrix();
+
+      // The truncation error is relative to the arguments, so the rank of
+      // tiles that cancel is reduced
+      return compress(range_, left, right,
+          squared_norm() + factor * factor * other.squared_norm());
+    }
+
+    /// Add a constant to a tile
+
+    /// \param value The constant
+    /// \return A tile equal to <tt>this + value</tt>
+    LowRankTensor_ add_constant(const numeric_type value) const {
+      TA_ASSERT(! empty());
+      eigen_matrix left(rows(), rank() + 1ul);
+      eigen_matrix right(rank() + 1ul, cols());
+      left << left_matrix(), eigen_matrix::Constant(rows(), 1, value);
+      right << right_matrix(), eigen_matrix::Ones(1, cols());
+      return compress(range_, left, right);
+    }
+
+  public:
+
+    /// Truncation tolerance accessor
+
+    /// \return The relative truncation tolerance of the tile recompression
+    static scalar_type tolerance() { return tolerance_; }
+
+    /// Set the truncation tolerance
+
+    /// \param tolerance The relative truncation tolerance of the tile
+    /// recompression
+    static void tolerance(const scalar_type tolerance) {
+      TA_USER_ASSERT(tolerance >= scalar_type(0),
+          "LowRankTensor::tolerance(): The tolerance must be non-negative.");
+      tolerance_ = tolerance;
+    }
+
+    /// Compiler generated functions
+    LowRankTensor() = default;
+    LowRankTensor(const LowRankTensor_&) = default;
+    LowRankTensor(LowRankTensor_&&) = default;
+    ~LowRankTensor() = default;
+    LowRankTensor_& operator=(const LowRankTensor_&) = default;
+    LowRankTensor_& operator=(LowRankTensor_&&) = default;
+
+    /// Construct a zero tile
+
+    /// \param range The range of the tile
+    explicit LowRankTensor(const range_type& range) :
+      range_(range), left_(), right_()
+    { check_range(range_); }
+
+    /// Construct a constant tile
+
+    /// \param range The range of the tile
+    /// \param value The value of the elements
+    LowRankTensor(const range_type& range, const numeric_type value) :
+      range_(range), left_(), right_()
+    {
+      check_range(range_);
+      if(value != numeric_type(0)) {
+        left_ = matrix_type(range_type(rows(), 1ul), value);
+        right_ = matrix_type(range_type(1ul, cols()), numeric_type(1));
+      }
+    }
+
+    /// Compress a dense tile
+
+    /// \param tensor The dense tile
+    /// \param tolerance The relative truncation tolerance
+    explicit LowRankTensor(const Tensor<T>& tensor,
+        const scalar_type tolerance = tolerance_) :
+      range_(tensor.range()), left_(), right_()
+    {
+      check_range(range_);
+      if(range_.volume() == 0ul)
+        return;
+
+      Eigen::JacobiSVD<eigen_matrix> svd(to_eigen(tensor, rows(), cols()),
+          Eigen::ComputeThinU | Eigen::ComputeThinV);
+      const Eigen::Index rank = truncate(svd.singularValues(), tolerance);
+      if(rank) {
+        left_ = to_factor(svd.matrixU().leftCols(rank) *
+            svd.singularValues().head(rank).asDiagonal());
+        right_ = to_factor(svd.matrixV().leftCols(rank).transpose());
+      }
+    }
+
+    /// Construct a tile from factors
+
+    /// The factors are recompressed.
+    /// \param range The range of the tile
+    /// \param left The left factor, an \c m by \c k matrix
+    /// \param right The right factor, a \c k by \c n matrix
+    LowRankTensor(const range_type& range, const Tensor<T>& left,
+        const Tensor<T>& right) :
+      range_(range), left_(), right_()
+    {
+      check_range(range_);
+      TA_USER_ASSERT((left.range().rank() == 2u) && (right.range().rank() == 2u),
+          "LowRankTensor: The factors must be matrices.");
+      const size_type k = left.range().extent_data()[1];
+      TA_USER_ASSERT((left.range().extent_data()[0] == rows()) &&
+          (right.range().extent_data()[0] == k) &&
+          (right.range().extent_data()[1] == cols()),
+          "LowRankTensor: The factor dimensions do not match the tile range.");
+      *this = compress(range_, to_eigen(left, rows(), k), to_eigen(right, k, cols()));
+    }
+
+    /// Range accessor
+
+    /// \return The range of the tile
+    const range_type& range() const { return range_; }
+
+    /// Tile size accessor
+
+    /// \return The number of elements of the tile
+    size_type size() const { return range_.volume(); }
+
+    /// Numerical rank accessor
+
+    /// \return The number of columns of the left factor
+    size_type rank() const {
+      return (left_.empty() ? 0ul : left_.range().extent_data()[1]);
+    }
+
+    /// Left factor accessor
+
+    /// \return The left factor (empty if the rank is zero)
+    const matrix_type& left() const { return left_; }
+
+    /// Right factor accessor
+
+    /// \return The right factor (empty if the rank is zero)
+    const matrix_type& right() const { return right_; }
+
+    /// Test if the tile is empty
+
+    /// \return \c true if this tile was default constructed
+    bool empty() const { return range_.rank() == 0u; }
+
+    /// Construct a dense copy of the tile
+
+    /// \return A dense tile with the elements of this tile
+    Tensor<T> dense() const {
+      TA_ASSERT(! empty());
+      Tensor<T> result(range_, numeric_type(0));
+      if(rank() && size())
+        math::eigen_map(result.data(), rows(), cols()) =
+            left_matrix() * right_matrix();
+      return result;
+    }
+
+    /// Construct a deep copy of the tile
+
+    /// \return A copy of this tile
+    LowRankTensor_ clone() const {
+      return make_tile(range_, left_.clone(), right_.clone());
+    }
+
+    /// Serialization function
+
+    /// \tparam Archive The archive type
+    /// \param ar The archive
+    template <typename Archive>
+    void serialize(Archive& ar) {
+      ar & range_;
+      ar & left_;
+      ar & right_;
+    }
+
+    // Permutation operations --------------------------------------------------
+
+    /// Create a permuted copy of this tile
+
+    /// \param perm The permutation
+    /// \return A permuted copy of this tile
+    LowRankTensor_ permute(const Permutation& perm) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(perm.dim() == 2u);
+      if(perm[0] == 0u)
+        return clone();
+      if(! rank())
+        return LowRankTensor_(perm * range_);
+      return make_tile(perm * range_, right_.permute(perm), left_.permute(perm));
+    }
+
+    /// Shift the range of this tile
+
+    /// \tparam Index An index type
+    /// \param bound_shift The shift to be applied to the range
+    /// \return A copy of this tile with a shifted range
+    template <typename Index>
+    LowRankTensor_ shift(const Index& bound_shift) const {
+      LowRankTensor_ result = clone();
+      result.range_.inplace_shift(bound_shift);
+      return result;
+    }
+
+    /// Shift the range of this tile
+
+    /// \tparam Index An index type
+    /// \param bound_shift The shift to be applied to the range
+    /// \return A reference to this tile
+    template <typename Index>
+    LowRankTensor_& shift_to(const Index& bound_shift) {
+      range_.inplace_shift(bound_shift);
+      return *this;
+    }
+
+    // Scaling operations ------------------------------------------------------
+
+    /// Scale this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>this * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ scale(const Scalar factor) const {
+      TA_ASSERT(! empty());
+      if(! rank())
+        return LowRankTensor_(range_);
+      return make_tile(range_, left_.scale(factor), right_);
+    }
+
+    /// Scale and permute this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ scale(const Scalar factor, const Permutation& perm) const {
+      return scale(factor).permute(perm);
+    }
+
+    /// Scale this tile in place
+
+    /// \tparam Scalar A scalar type
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& scale_to(const Scalar factor) {
+      TA_ASSERT(! empty());
+      if(rank())
+        left_.scale_to(factor);
+      return *this;
+    }
+
+    /// Negate this tile
+
+    /// \return A tile equal to <tt>-this</tt>
+    LowRankTensor_ neg() const { return scale(numeric_type(-1)); }
+
+    /// Negate and permute this tile
+
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ -this</tt>
+    LowRankTensor_ neg(const Permutation& perm) const {
+      return scale(numeric_type(-1), perm);
+    }
+
+    /// Negate this tile in place
+
+    /// \return A reference to this tile
+    LowRankTensor_& neg_to() { return scale_to(numeric_type(-1)); }
+
+    // Addition operations -----------------------------------------------------
+
+    /// Add this and \c other
+
+    /// \param other The tile to be added to this tile
+    /// \return A tile equal to <tt>this + other</tt>
+    LowRankTensor_ add(const LowRankTensor_& other) const {
+      return concat(other, numeric_type(1));
+    }
+
+    /// Add this and \c other, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this + other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ add(const LowRankTensor_& other, const Scalar factor) const {
+      return concat(other, numeric_type(1)).scale_to(factor);
+    }
+
+    /// Add and permute this and \c other
+
+    /// \param other The tile to be added to this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this + other)</tt>
+    LowRankTensor_ add(const LowRankTensor_& other, const Permutation& perm) const {
+      return add(other).permute(perm);
+    }
+
+    /// Add, scale, and permute this and \c other
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this + other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ add(const LowRankTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return add(other, factor).permute(perm);
+    }
+
+    /// Add a constant to this tile
+
+    /// \param value The constant to be added
+    /// \return A tile equal to <tt>this + value</tt>
+    LowRankTensor_ add(const numeric_type value) const {
+      return add_constant(value);
+    }
+
+    /// Add a constant to this tile, and permute the result
+
+    /// \param value The constant to be added
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this + value)</tt>
+    LowRankTensor_ add(const numeric_type value, const Permutation& perm) const {
+      return add_constant(value).permute(perm);
+    }
+
+    /// Add \c other to this tile
+
+    /// \param other The tile to be added to this tile
+    /// \return A reference to this tile
+    LowRankTensor_& add_to(const LowRankTensor_& other) {
+      return (*this = add(other));
+    }
+
+    /// Add \c other to this tile, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be added to this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& add_to(const LowRankTensor_& other, const Scalar factor) {
+      return (*this = add(other, factor));
+    }
+
+    /// Add a constant to this tile
+
+    /// \param value The constant to be added
+    /// \return A reference to this tile
+    LowRankTensor_& add_to(const numeric_type value) {
+      return (*this = add_constant(value));
+    }
+
+    // Subtraction operations --------------------------------------------------
+
+    /// Subtract \c other from this
+
+    /// \param other The tile to be subtracted from this tile
+    /// \return A tile equal to <tt>this - other</tt>
+    LowRankTensor_ subt(const LowRankTensor_& other) const {
+      return concat(other, numeric_type(-1));
+    }
+
+    /// Subtract \c other from this, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this - other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ subt(const LowRankTensor_& other, const Scalar factor) const {
+      return concat(other, numeric_type(-1)).scale_to(factor);
+    }
+
+    /// Subtract \c other from this, and permute the result
+
+    /// \param other The tile to be subtracted from this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this - other)</tt>
+    LowRankTensor_ subt(const LowRankTensor_& other, const Permutation& perm) const {
+      return subt(other).permute(perm);
+    }
+
+    /// Subtract \c other from this, and scale and permute the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this - other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ subt(const LowRankTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return subt(other, factor).permute(perm);
+    }
+
+    /// Subtract a constant from this tile
+
+    /// \param value The constant to be subtracted
+    /// \return A tile equal to <tt>this - value</tt>
+    LowRankTensor_ subt(const numeric_type value) const {
+      return add_constant(-value);
+    }
+
+    /// Subtract a constant from this tile, and permute the result
+
+    /// \param value The constant to be subtracted
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this - value)</tt>
+    LowRankTensor_ subt(const numeric_type value, const Permutation& perm) const {
+      return add_constant(-value).permute(perm);
+    }
+
+    /// Subtract \c other from this tile
+
+    /// \param other The tile to be subtracted from this tile
+    /// \return A reference to this tile
+    LowRankTensor_& subt_to(const LowRankTensor_& other) {
+      return (*this = subt(other));
+    }
+
+    /// Subtract \c other from this tile, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be subtracted from this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& subt_to(const LowRankTensor_& other, const Scalar factor) {
+      return (*this = subt(other, factor));
+    }
+
+    /// Subtract a constant from this tile
+
+    /// \param value The constant to be subtracted
+    /// \return A reference to this tile
+    LowRankTensor_& subt_to(const numeric_type value) {
+      return (*this = add_constant(-value));
+    }
+
+    // Multiplication operations -----------------------------------------------
+
+    /// Multiply this by \c other element-wise
+
+    /// The rank of the product is the product of the ranks of the arguments
+    /// before it is recompressed.
+    /// \param other The tile to be multiplied by this tile
+    /// \return A tile equal to <tt>this * other</tt> (element-wise)
+    LowRankTensor_ mult(const LowRankTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "LowRankTensor: The ranges of the tiles do not match.");
+
+      // The factors of the product are the row-wise (left) and column-wise
+      // (right) Kronecker products of the factors of the arguments
+      const eigen_matrix left1 = left_matrix(), left2 = other.left_matrix();
+      const eigen_matrix right1 = right_matrix(), right2 = other.right_matrix();
+      const Eigen::Index k1 = left1.cols(), k2 = left2.cols();
+      eigen_matrix left(left1.rows(), k1 * k2);
+      eigen_matrix right(k1 * k2, right1.cols());
+      for(Eigen::Index a = 0; a < k1; ++a) {
+        for(Eigen::Index b = 0; b < k2; ++b) {
+          left.col(a * k2 + b) = left1.col(a).cwiseProduct(left2.col(b));
+          right.row(a * k2 + b) = right1.row(a).cwiseProduct(right2.row(b));
+        }
+      }
+      return compress(range_, left, right);
+    }
+
+    /// Multiply this by \c other element-wise, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \return A tile equal to <tt>(this * other) * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ mult(const LowRankTensor_& other, const Scalar factor) const {
+      return mult(other).scale_to(factor);
+    }
+
+    /// Multiply this by \c other element-wise, and permute the result
+
+    /// \param other The tile to be multiplied by this tile
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ (this * other)</tt>
+    LowRankTensor_ mult(const LowRankTensor_& other, const Permutation& perm) const {
+      return mult(other).permute(perm);
+    }
+
+    /// Multiply this by \c other element-wise, and scale and permute the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \param perm The permutation
+    /// \return A tile equal to <tt>perm ^ ((this * other) * factor)</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ mult(const LowRankTensor_& other, const Scalar factor,
+        const Permutation& perm) const
+    {
+      return mult(other, factor).permute(perm);
+    }
+
+    /// Multiply this tile by \c other element-wise
+
+    /// \param other The tile to be multiplied by this tile
+    /// \return A reference to this tile
+    LowRankTensor_& mult_to(const LowRankTensor_& other) {
+      return (*this = mult(other));
+    }
+
+    /// Multiply this tile by \c other element-wise, and scale the result
+
+    /// \tparam Scalar A scalar type
+    /// \param other The tile to be multiplied by this tile
+    /// \param factor The scaling factor
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& mult_to(const LowRankTensor_& other, const Scalar factor) {
+      return (*this = mult(other, factor));
+    }
+
+    // Contraction operations --------------------------------------------------
+
+    /// Contract this tile with \c other
+
+    /// The product of <tt>L1 * R1</tt> and <tt>L2 * R2</tt> is computed as
+    /// <tt>L1 * (R1 * L2) * R2</tt>, so no dense matrix is formed.
+    /// \tparam Scalar A scalar type
+    /// \param other The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction parameters
+    /// \return A tile equal to <tt>this * other * factor</tt>
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_ gemm(const LowRankTensor_& other, const Scalar factor,
+        const math::GemmHelper& gemm_helper) const
+    {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT((gemm_helper.left_rank() == 2u) &&
+          (gemm_helper.right_rank() == 2u) && (gemm_helper.result_rank() == 2u),
+          "LowRankTensor::gemm(): Only matrix products are supported.");
+
+      const range_type range =
+          gemm_helper.make_result_range<range_type>(range_, other.range_);
+      if(! (rank() && other.rank()))
+        return LowRankTensor_(range);
+
+      eigen_matrix left1, right1, left2, right2;
+      factors(*this, gemm_helper.left_op(), left1, right1);
+      factors(other, gemm_helper.right_op(), left2, right2);
+      const eigen_matrix core = right1 * left2;
+      if(left1.cols() <= right2.rows())
+        return compress(range, left1 * numeric_type(factor), core * right2);
+      return compress(range, left1 * core * numeric_type(factor), right2);
+    }
+
+    /// Contract \c left and \c right, and add the result to this tile
+
+    /// \tparam Scalar A scalar type
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \param factor The scaling factor
+    /// \param gemm_helper The contraction parameters
+    /// \return A reference to this tile
+    template <typename Scalar,
+        typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+    LowRankTensor_& gemm(const LowRankTensor_& left, const LowRankTensor_& right,
+        const Scalar factor, const math::GemmHelper& gemm_helper)
+    {
+      if(empty())
+        return (*this = left.gemm(right, factor, gemm_helper));
+      return add_to(left.gemm(right, factor, gemm_helper));
+    }
+
+    // Reduction operations ----------------------------------------------------
+
+    /// Sum the diagonal elements of this tile
+
+    /// \return The sum of the diagonal elements
+    numeric_type trace() const {
+      TA_ASSERT(! empty());
+      if(! rank())
+        return numeric_type(0);
+      const Eigen::Index n = std::min(rows(), cols());
+      const eigen_matrix left = left_matrix(), right = right_matrix();
+      return (left.topRows(n).cwiseProduct(right.leftCols(n).transpose())).sum();
+    }
+
+    /// Sum the elements of this tile
+
+    /// \return The sum of the elements
+    numeric_type sum() const {
+      TA_ASSERT(! empty());
+      if(! rank())
+        return numeric_type(0);
+      return left_matrix().colwise().sum().dot(right_matrix().rowwise().sum());
+    }
+
+    /// Multiply the elements of this tile
+
+    /// \return The product of the elements
+    numeric_type product() const { return dense().product(); }
+
+    /// Squared Frobenius norm
+
+    /// \return The squared Frobenius norm of this tile
+    scalar_type squared_norm() const {
+      TA_ASSERT(! empty());
+      if(! rank())
+        return scalar_type(0);
+      const eigen_matrix left = left_matrix(), right = right_matrix();
+      return ((left.transpose() * left).cwiseProduct(right * right.transpose())).sum();
+    }
+
+    /// Frobenius norm
+
+    /// \return The Frobenius norm of this tile
+    scalar_type norm() const { return std::sqrt(std::max(squared_norm(), scalar_type(0))); }
+
+    /// Maximum element
+
+    /// \return The maximum element of this tile
+    numeric_type max() const { return dense().max(); }
+
+    /// Minimum element
+
+    /// \return The minimum element of this tile
+    numeric_type min() const { return dense().min(); }
+
+    /// Absolute maximum element
+
+    /// \return The maximum absolute value of the elements of this tile
+    scalar_type abs_max() const { return dense().abs_max(); }
+
+    /// Absolute minimum element
+
+    /// \return The minimum absolute value of the elements of this tile
+    scalar_type abs_min() const { return dense().abs_min(); }
+
+    /// Vector dot product
+
+    /// \param other The other tile
+    /// \return The sum of the products of the elements of this tile and
+    /// \c other
+    numeric_type dot(const LowRankTensor_& other) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_USER_ASSERT(range_ == other.range_,
+          "LowRankTensor: The ranges of the tiles do not match.");
+      if(! (rank() && other.rank()))
+        return numeric_type(0);
+      return ((left_matrix().transpose() * other.left_matrix()).cwiseProduct(
+          right_matrix() * other.right_matrix().transpose())).sum();
+    }
+
+  }; // class LowRankTensor
+
+  template <typename T>
+  typename LowRankTensor<T>::scalar_type LowRankTensor<T>::tolerance_ =
+      std::sqrt(std::numeric_limits<T>::epsilon());
+
+  /// Low-rank tile output operator
+
+  /// The tile is printed as a dense matrix.
+  /// \tparam T The element type
+  /// \param os The output stream
+  /// \param tile The tile to be output
+  /// \return A reference to the output stream
+  template <typename T>
+  inline std::ostream& operator<<(std::ostream& os, const LowRankTensor<T>& tile) {
+    if(tile.empty())
+      os << "[ ]";
+    else
+      os << tile.dense();
+    return os;
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_LOW_RANK_TENSOR_H__INCLUDED
@@ -128,6 +128,8 @@ namespace TiledArray {
       const unsigned int ndim = arg0.range().rank();
       const unsigned int ndim1 = ndim - 1;
       const typename Result::size_type volume = arg0.range().volume();
+      if(volume == 0ul)
+        return;
 
       // Get pointer to arg extent
       const auto* MADNESS_RESTRICT const arg0_extent = arg0.range().extent_data();
@@ -150,14 +152,19 @@ namespace TiledArray {
             typename Arg0::const_reference a0, typename Args::const_reference... as)
         { output_op(result, input_op(a0, as...)); };
 
-        // Permute the data
-        for(typename Result::size_type index = 0ul; index < volume; index += block_size) {
-          const typename Result::size_type perm_index = perm_index_op(index);
+        // Permute the data, dividing the blocks among idle threads when the
+        // tensor is large
+        auto block_op = [&] (const std::size_t first, const std::size_t last) {
+          for(std::size_t b = first; b < last; ++b) {
+            const typename Result::size_type index = b * block_size;
+            const typename Result::size_type perm_index = perm_index_op(index);
 
-          // Copy the block
-          math::vector_ptr_op(op, block_size, result.data() + perm_index,
-              arg0.data() + index, (args.data() + index)...);
-        }
+            // Copy the block
+            math::vector_ptr_op(op, block_size, result.data() + perm_index,
+                arg0.data() + index, (args.data() + index)...);
+          }
+        };
+        math::range_block_op(block_op, volume / block_size, block_size);
 
       } else {
         // This is the more complicated case. Here we permute in terms of matrix
@@ -186,20 +193,42 @@ namespace TiledArray {
         for(unsigned int i = perm[ndim1] + 1u; i < ndim; ++i)
           result_outer_stride *= result_extent[i];
 
+        // When the tensor is large, the rows of the input matrices are divided
+        // into blocks that are transposed by idle threads. The block height is
+        // a multiple of the loop unwind, so only the last block of a matrix
+        // has a partial tail.
+        const std::size_t m = other_fused_size[1];
+        const std::size_t n = other_fused_size[3];
+        std::size_t rows = m;
+        if(math::use_parallel_tile_op(volume)) {
+          rows = (TILEDARRAY_MATRIX_GRAIN_SIZE + n - 1ul) / n;
+          rows = (rows + TILEDARRAY_LOOP_UNWIND - 1ul) & math::index_mask::value;
+          rows = std::min(rows, m);
+        }
+        const std::size_t row_blocks = (m + rows - 1ul) / rows;
+
         // Copy data from the input to the output matrix via a series of matrix
         // transposes.
-        for(typename Result::size_type i = 0ul; i < other_fused_size[0]; ++i) {
-          typename Result::size_type index = i * other_fused_weight[0];
-          for(typename Result::size_type j = 0ul; j < other_fused_size[2]; ++j, index += other_fused_weight[2]) {
+        auto block_op = [&] (const std::size_t first, const std::size_t last) {
+          for(std::size_t b = first; b < last; ++b) {
             // Compute the ordinal index of the input and output matrices.
-            typename Result::size_type perm_index = perm_index_op(index);
-
+            const std::size_t matrix = b / row_blocks;
+            const std::size_t row = (b % row_blocks) * rows;
+            const typename Result::size_type index =
+                (matrix / other_fused_size[2]) * other_fused_weight[0] +
+                (matrix % other_fused_size[2]) * other_fused_weight[2];
+            const typename Result::size_type perm_index = perm_index_op(index);
+
+            // Rows of the input matrix are columns of the output matrix
+            const typename Result::size_type offset = index + row * other_fused_weight[1];
             math::transpose(input_op, output_op,
-                other_fused_size[1], other_fused_size[3],
-                result_outer_stride, result.data() + perm_index,
-                other_fused_weight[1], arg0.data() + index, (args.data() + index)...);
+                std::min(rows, m - row), n,
+                result_outer_stride, result.data() + perm_index + row,
+                other_fused_weight[1], arg0.data() + offset, (args.data() + offset)...);
           }
-        }
+        };
+        math::range_block_op(block_op,
+            other_fused_size[0] * other_fused_size[2] * row_blocks, rows * n);
       }
     }
 
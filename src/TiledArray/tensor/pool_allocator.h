@@ -0,0 +1,816 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  pool_allocator.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+#define TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
+
+#include <TiledArray/config.h>
+#include <TiledArray/error.h>
+#include <TiledArray/memory_tracker.h>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <memory>
+#include <sys/mman.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+#ifdef TILEDARRAY_HAS_CUDA
+#include <cuda_runtime.h>
+#endif // TILEDARRAY_HAS_CUDA
+
+/* The default limit of the free blocks cached by each tile pool, in bytes. */
+#ifndef TILEDARRAY_POOL_MAX_CACHED_BYTES
+#define TILEDARRAY_POOL_MAX_CACHED_BYTES 1073741824ul
+#endif // TILEDARRAY_POOL_MAX_CACHED_BYTES
+
+namespace TiledArray {
+
+  /// Tile memory pool statistics
+  struct PoolStatistics {
+    std::size_t hits; ///< Allocations that reused a cached block
+    std::size_t misses; ///< Allocations that required a new block
+    std::size_t unpooled; ///< Allocations too large to be pooled
+    std::size_t cached_bytes; ///< Bytes held in free blocks by the pool
+  }; // struct PoolStatistics
+
+  namespace detail {
+
+    /// Size-class memory pool for tile data
+
+    /// Requests are rounded up to one of four size classes per power of two,
+    /// so no more than 25% of a block is wasted. Each thread keeps a small
+    /// cache of free blocks for every size class, which is refilled from and
+    /// spilled to a shared, locked cache. Only when both caches are empty is
+    /// a new block allocated. Requests larger than \c max_bytes bypass the
+    /// pool. All blocks are aligned to the cache line size.
+    ///
+    /// The shared cache is split by NUMA domain. A thread cache belongs to the
+    /// domain its thread was running on when the cache was created, and it
+    /// only exchanges blocks with the shared cache of that domain. New blocks
+    /// are placed by the operating system on the domain of the thread that
+    /// first writes to them, so recycled blocks stay on the domain where they
+    /// were first touched instead of migrating to threads on other sockets.
+    ///
+    /// There are two pools: \c instance() allocates pageable memory, and
+    /// \c pinned_instance() allocates page-locked memory, which devices and
+    /// network adapters can access directly. Pinned blocks are allocated
+    /// with \c cudaHostAlloc when CUDA is enabled, and locked with \c mlock
+    /// otherwise. Since pinning is expensive, and registration of memory
+    /// with the network is cached by MPI, recycling pinned blocks saves the
+    /// cost of pinning and registering memory for each tile.
+    ///
+    /// A third pool, \c huge_instance() , backs blocks of at least
+    /// \c huge_threshold() bytes with huge pages, which reduces the TLB misses
+    /// of GEMM and permutation on large tiles. These blocks are mapped with
+    /// \c mmap , rounded up to a multiple of \c huge_page_bytes and aligned to
+    /// it, and marked with \c madvise(MADV_HUGEPAGE) so the kernel backs them
+    /// with transparent huge pages. When the \c TA_HUGETLB environment
+    /// variable is set, blocks are first mapped from the reserved hugetlbfs
+    /// pages (1 GB pages for blocks of at least 1 GB), and fall back to
+    /// transparent huge pages when the reservation is exhausted. The threshold
+    /// is set with the \c TA_HUGE_PAGE_THRESHOLD environment variable (in
+    /// bytes, 2 MB by default). Huge blocks are recycled like other blocks, so
+    /// their pages are not returned to the operating system and faulted in
+    /// again for each tile.
+    ///
+    /// The free blocks held by all caches of a pool are limited to
+    /// \c max_cached_bytes() (1 GB by default, or the \c TA_POOL_MAX_CACHED
+    /// environment variable in bytes). A freed block that does not fit within
+    /// the limit is returned to the system. The cached bytes are counted by
+    /// \c MemoryTracker as \c MemoryCategory::pool , so they are included in
+    /// the live memory seen by the memory governor.
+    /// \note There is one pool per process; it is never destroyed so that
+    /// thread caches may be flushed at any time during program exit.
+    class TilePool {
+    public:
+#ifdef TILEDARRAY_CACHELINE_SIZE
+      static constexpr std::size_t alignment = TILEDARRAY_CACHELINE_SIZE; ///< Block alignment
+#else
+      static constexpr std::size_t alignment = 64ul; ///< Block alignment
+#endif // TILEDARRAY_CACHELINE_SIZE
+      static constexpr std::size_t min_bytes = 64ul; ///< Smallest block size
+      static constexpr unsigned int max_exponent = 26u; ///< Base-2 log of the largest block size
+      static constexpr std::size_t max_bytes = 1ul << max_exponent; ///< Largest block size
+      static constexpr std::size_t thread_cache_size = 8ul; ///< Free blocks per size class in each thread cache
+      static constexpr std::size_t shared_cache_size = 256ul; ///< Free blocks per size class in the shared cache
+      static constexpr std::size_t num_classes = (max_exponent - 6u) * 4u + 1u; ///< Number of size classes
+      static constexpr unsigned int max_domains = 8u; ///< Number of shared caches; larger domain ids wrap around
+      static constexpr std::size_t huge_page_bytes = 1ul << 21; ///< Size of a huge page
+      static constexpr std::size_t gigantic_page_bytes = 1ul << 30; ///< Size of a gigantic (hugetlbfs) page
+
+    private:
+
+      /// Free blocks of one size class
+      typedef std::vector<void*> block_list;
+
+      /// The free blocks and counters of a thread
+      struct ThreadCache {
+        block_list blocks[num_classes]; ///< Free blocks for each size class
+        std::atomic<std::size_t> hits; ///< Allocations that reused a cached block
+        std::atomic<std::size_t> misses; ///< Allocations that required a new block
+        std::atomic<std::size_t> unpooled; ///< Allocations too large to be pooled
+        std::atomic<std::size_t> cached_bytes; ///< Bytes held by this cache
+        const unsigned int domain; ///< The NUMA domain of the thread
+        TilePool& pool; ///< The pool that owns this cache
+
+        explicit ThreadCache(TilePool& p) :
+          hits(0ul), misses(0ul), unpooled(0ul), cached_bytes(0ul),
+          domain(TilePool::domain()), pool(p)
+        {
+          pool.register_cache(this);
+        }
+
+        ~ThreadCache() { pool.unregister_cache(this); }
+      }; // struct ThreadCache
+
+      mutable std::mutex mutex_; ///< Lock for the shared cache and cache registry
+      block_list blocks_[max_domains][num_classes]; ///< Shared free blocks for each domain and size class
+      std::vector<ThreadCache*> caches_; ///< Thread caches of running threads
+      std::size_t hits_; ///< Hits of threads that have exited
+      std::size_t misses_; ///< Misses of threads that have exited
+      std::size_t unpooled_; ///< Unpooled allocations of threads that have exited
+      std::size_t cached_bytes_; ///< Bytes held by the shared cache
+      std::atomic<std::size_t> cached_total_; ///< Bytes held by the shared and thread caches
+      std::atomic<std::size_t> max_cached_bytes_; ///< Limit of cached_total_
+      const bool pinned_; ///< Allocate page-locked blocks
+      const bool huge_; ///< Back large blocks with huge pages
+      const std::size_t huge_threshold_; ///< The smallest block backed by huge pages
+      const bool hugetlb_; ///< Map huge blocks from hugetlbfs first
+
+      TilePool(const bool pinned, const bool huge) :
+        mutex_(), blocks_(), caches_(), hits_(0ul), misses_(0ul), unpooled_(0ul),
+        cached_bytes_(0ul), cached_total_(0ul),
+        max_cached_bytes_(getenv("TA_POOL_MAX_CACHED") ?
+            std::strtoul(getenv("TA_POOL_MAX_CACHED"), nullptr, 10) :
+            TILEDARRAY_POOL_MAX_CACHED_BYTES),
+        pinned_(pinned), huge_(huge),
+        huge_threshold_(getenv("TA_HUGE_PAGE_THRESHOLD") ?
+            std::strtoul(getenv("TA_HUGE_PAGE_THRESHOLD"), nullptr, 10) :
+            huge_page_bytes),
+        hugetlb_(getenv("TA_HUGETLB") != nullptr)
+      { }
+
+      TilePool(const TilePool&) = delete;
+      TilePool& operator=(const TilePool&) = delete;
+
+      /// \param bytes The size of a block
+      /// \return \c true if the block is backed by huge pages
+      bool is_huge(const std::size_t bytes) const {
+        return huge_ && (bytes >= huge_threshold_);
+      }
+
+      /// \param bytes The size of a huge block
+      /// \return The size of the mapping of the block
+      std::size_t huge_bytes(const std::size_t bytes) const {
+        const std::size_t page = (hugetlb_ && (bytes >= gigantic_page_bytes) ?
+            gigantic_page_bytes : huge_page_bytes);
+        return (bytes + page - 1ul) & ~(page - 1ul);
+      }
+
+      /// Map a block backed by huge pages
+
+      /// \param bytes The size of the block
+      /// \return The block
+      /// \throw std::bad_alloc When memory could not be mapped
+      void* map_huge_block(const std::size_t bytes) const {
+        const std::size_t size = huge_bytes(bytes);
+#ifdef MAP_HUGETLB
+        if(hugetlb_) {
+          int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_HUGE_1GB
+          if(size >= gigantic_page_bytes)
+            flags |= MAP_HUGE_1GB;
+#endif // MAP_HUGE_1GB
+          void* const block = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+          if(block != MAP_FAILED)
+            return block;
+        }
+#endif // MAP_HUGETLB
+
+        // Map an extra huge page, and trim the mapping to a huge page boundary
+        char* const base = static_cast<char*>(mmap(nullptr, size + huge_page_bytes,
+            PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if(static_cast<void*>(base) == MAP_FAILED)
+          throw std::bad_alloc();
+        char* const block = reinterpret_cast<char*>(
+            (reinterpret_cast<std::uintptr_t>(base) + huge_page_bytes - 1ul) &
+            ~std::uintptr_t(huge_page_bytes - 1ul));
+        const std::size_t head = block - base;
+        if(head)
+          munmap(base, head);
+        munmap(block + size, huge_page_bytes - head);
+#ifdef MADV_HUGEPAGE
+        madvise(block, size, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+        return block;
+      }
+
+      /// Allocate an aligned block
+
+      /// \param bytes The size of the block
+      /// \return The block
+      /// \throw std::bad_alloc When memory could not be allocated
+      void* malloc_block(const std::size_t bytes) const {
+        if(is_huge(bytes))
+          return map_huge_block(bytes);
+
+        void* block = nullptr;
+#ifdef TILEDARRAY_HAS_CUDA
+        if(pinned_) {
+          if(cudaHostAlloc(& block, bytes, cudaHostAllocPortable) != cudaSuccess)
+            throw std::bad_alloc();
+          return block;
+        }
+#endif // TILEDARRAY_HAS_CUDA
+        if(posix_memalign(& block, alignment, bytes) != 0)
+          throw std::bad_alloc();
+#ifndef TILEDARRAY_HAS_CUDA
+        // The block is still usable if it cannot be locked, e.g. when
+        // RLIMIT_MEMLOCK is exceeded.
+        if(pinned_)
+          mlock(block, bytes);
+#endif // TILEDARRAY_HAS_CUDA
+        return block;
+      }
+
+      /// Free a block
+
+      /// \param block The block returned by \c malloc_block
+      /// \param bytes The size of the block
+      void free_block(void* const block, const std::size_t bytes) const {
+        if(is_huge(bytes)) {
+          munmap(block, huge_bytes(bytes));
+          return;
+        }
+#ifdef TILEDARRAY_HAS_CUDA
+        static_cast<void>(bytes);
+        if(pinned_) {
+          cudaFreeHost(block);
+          return;
+        }
+#else
+        if(pinned_)
+          munlock(block, bytes);
+#endif // TILEDARRAY_HAS_CUDA
+        free(block);
+      }
+
+      /// Count blocks that enter the caches
+
+      /// \param bytes The size of the blocks
+      void add_cached(const std::size_t bytes) {
+        cached_total_.fetch_add(bytes, std::memory_order_relaxed);
+        MemoryTracker::instance().allocate(MemoryCategory::pool, bytes);
+      }
+
+      /// Count blocks that leave the caches
+
+      /// \param bytes The size of the blocks
+      void remove_cached(const std::size_t bytes) {
+        if(bytes == 0ul)
+          return;
+        cached_total_.fetch_sub(bytes, std::memory_order_relaxed);
+        MemoryTracker::instance().deallocate(MemoryCategory::pool, bytes);
+      }
+
+      /// Thread cache accessor
+
+      /// \return The cache of the calling thread
+      ThreadCache& thread_cache() {
+        static thread_local std::unique_ptr<ThreadCache> caches[3];
+        std::unique_ptr<ThreadCache>& cache = caches[pinned_ ? 1 : (huge_ ? 2 : 0)];
+        if(! cache)
+          cache.reset(new ThreadCache(*this));
+        return *cache;
+      }
+
+      /// Add \c cache to the list of running thread caches
+      void register_cache(ThreadCache* cache) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        caches_.push_back(cache);
+      }
+
+      /// Move the contents of \c cache to the shared cache
+      void unregister_cache(ThreadCache* cache) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(unsigned int c = 0u; c < num_classes; ++c)
+          spill(c, cache->blocks[c], 0ul, cache->domain);
+        trim();
+        hits_ += cache->hits;
+        misses_ += cache->misses;
+        unpooled_ += cache->unpooled;
+        for(std::vector<ThreadCache*>::iterator it = caches_.begin(); it != caches_.end(); ++it) {
+          if(*it == cache) {
+            caches_.erase(it);
+            break;
+          }
+        }
+      }
+
+      /// Move blocks from \c blocks to the shared cache
+
+      /// Blocks that do not fit in the shared cache are freed.
+      /// \param c The size class of the blocks
+      /// \param blocks The blocks to be moved
+      /// \param keep The number of blocks left in \c blocks
+      /// \param d The NUMA domain of the blocks
+      /// \note The caller must hold \c mutex_ .
+      void spill(const unsigned int c, block_list& blocks, const std::size_t keep,
+          const unsigned int d)
+      {
+        const std::size_t bytes = class_bytes(c);
+        std::size_t freed = 0ul;
+        while(blocks.size() > keep) {
+          if(blocks_[d][c].size() < shared_cache_size) {
+            blocks_[d][c].push_back(blocks.back());
+            cached_bytes_ += bytes;
+          } else {
+            free_block(blocks.back(), bytes);
+            freed += bytes;
+          }
+          blocks.pop_back();
+        }
+        remove_cached(freed);
+      }
+
+      /// Free shared blocks until the cached bytes fit within the limit
+
+      /// The blocks of the largest size classes are freed first.
+      /// \note The caller must hold \c mutex_ .
+      void trim() {
+        const std::size_t limit = max_cached_bytes_.load(std::memory_order_relaxed);
+        for(unsigned int c = num_classes; c-- > 0u;) {
+          const std::size_t bytes = class_bytes(c);
+          for(unsigned int d = 0u; d < max_domains; ++d) {
+            block_list& blocks = blocks_[d][c];
+            while(! blocks.empty() &&
+                (cached_total_.load(std::memory_order_relaxed) > limit))
+            {
+              free_block(blocks.back(), bytes);
+              blocks.pop_back();
+              cached_bytes_ -= bytes;
+              remove_cached(bytes);
+            }
+          }
+        }
+      }
+
+    public:
+
+      /// Pool accessor
+
+      /// \return A reference to the pageable tile pool of this process
+      static TilePool& instance() {
+        static TilePool* const pool = new TilePool(false, false);
+        return *pool;
+      }
+
+      /// Pinned pool accessor
+
+      /// \return A reference to the pinned tile pool of this process
+      static TilePool& pinned_instance() {
+        static TilePool* const pool = new TilePool(true, false);
+        return *pool;
+      }
+
+      /// Huge page pool accessor
+
+      /// \return A reference to the huge page tile pool of this process
+      static TilePool& huge_instance() {
+        static TilePool* const pool = new TilePool(false, true);
+        return *pool;
+      }
+
+      /// \return \c true if this pool allocates page-locked memory
+      bool pinned() const { return pinned_; }
+
+      /// \return \c true if this pool backs large blocks with huge pages
+      bool huge() const { return huge_; }
+
+      /// \return The size of the smallest block that is backed by huge pages
+      std::size_t huge_threshold() const { return huge_threshold_; }
+
+      /// NUMA domain of the calling thread
+
+      /// \return The NUMA node of the processor the calling thread is running
+      /// on, modulo \c max_domains , or zero when it cannot be determined
+      static unsigned int domain() {
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned int cpu = 0u, node = 0u;
+        if(syscall(SYS_getcpu, & cpu, & node, nullptr) == 0)
+          return node % max_domains;
+#endif // defined(__linux__) && defined(SYS_getcpu)
+        return 0u;
+      }
+
+      /// Size class of a request
+
+      /// \param bytes The number of bytes requested
+      /// \return The size class index of \c bytes
+      static unsigned int size_class(const std::size_t bytes) {
+        TA_ASSERT(bytes <= max_bytes);
+        if(bytes <= min_bytes)
+          return 0u;
+
+        // bytes is in the range (2^e, 2^(e+1)]
+        const unsigned int e =
+            std::numeric_limits<unsigned long>::digits - 1 - __builtin_clzl(bytes - 1ul);
+        const std::size_t step = 1ul << (e - 2u);
+        const unsigned int q = ((bytes - 1ul) - (1ul << e)) / step;
+        return (e - 6u) * 4u + q + 1u;
+      }
+
+      /// Block size of a size class
+
+      /// \param c The size class index
+      /// \return The number of bytes in a block of size class \c c
+      static std::size_t class_bytes(const unsigned int c) {
+        TA_ASSERT(c < num_classes);
+        if(c == 0u)
+          return min_bytes;
+        const unsigned int e = (c - 1u) / 4u + 6u;
+        const unsigned int q = (c - 1u) % 4u;
+        return (1ul << e) + (q + 1ul) * (1ul << (e - 2u));
+      }
+
+      /// Allocate a block
+
+      /// \param bytes The number of bytes requested
+      /// \return A pointer to a block of at least \c bytes bytes
+      /// \throw std::bad_alloc When memory could not be allocated
+      void* allocate(const std::size_t bytes) {
+        ThreadCache& cache = thread_cache();
+
+        // Bypass the pool for large requests
+        if(bytes > max_bytes) {
+          cache.unpooled.fetch_add(1ul, std::memory_order_relaxed);
+          return malloc_block(bytes);
+        }
+
+        const unsigned int c = size_class(bytes);
+        block_list& blocks = cache.blocks[c];
+
+        // Refill the thread cache from the shared cache
+        if(blocks.empty()) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          block_list& shared_blocks = blocks_[cache.domain][c];
+          const std::size_t n = std::min(shared_blocks.size(), thread_cache_size / 2ul);
+          for(std::size_t i = 0ul; i < n; ++i) {
+            blocks.push_back(shared_blocks.back());
+            shared_blocks.pop_back();
+          }
+          cached_bytes_ -= n * class_bytes(c);
+          cache.cached_bytes.fetch_add(n * class_bytes(c), std::memory_order_relaxed);
+        }
+
+        if(blocks.empty()) {
+          cache.misses.fetch_add(1ul, std::memory_order_relaxed);
+          return malloc_block(class_bytes(c));
+        }
+
+        void* const block = blocks.back();
+        blocks.pop_back();
+        cache.hits.fetch_add(1ul, std::memory_order_relaxed);
+        cache.cached_bytes.fetch_sub(class_bytes(c), std::memory_order_relaxed);
+        remove_cached(class_bytes(c));
+        return block;
+      }
+
+      /// Return a block to the pool
+
+      /// \param block The block to be returned
+      /// \param bytes The number of bytes that were requested for \c block
+      void deallocate(void* const block, const std::size_t bytes) {
+        if(! block)
+          return;
+
+        if(bytes > max_bytes) {
+          free_block(block, bytes);
+          return;
+        }
+
+        // Return blocks that do not fit within the cache limit to the system
+        const unsigned int c = size_class(bytes);
+        if(cached_total_.load(std::memory_order_relaxed) + class_bytes(c) >
+            max_cached_bytes_.load(std::memory_order_relaxed))
+        {
+          free_block(block, class_bytes(c));
+          return;
+        }
+
+        ThreadCache& cache = thread_cache();
+        block_list& blocks = cache.blocks[c];
+        if(blocks.capacity() < thread_cache_size)
+          blocks.reserve(thread_cache_size);
+        blocks.push_back(block);
+        cache.cached_bytes.fetch_add(class_bytes(c), std::memory_order_relaxed);
+        add_cached(class_bytes(c));
+
+        // Spill half of a full thread cache to the shared cache
+        if(blocks.size() >= thread_cache_size) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          const std::size_t n = blocks.size() - thread_cache_size / 2ul;
+          spill(c, blocks, thread_cache_size / 2ul, cache.domain);
+          cache.cached_bytes.fetch_sub(n * class_bytes(c), std::memory_order_relaxed);
+          if(cached_total_.load(std::memory_order_relaxed) > max_cached_bytes())
+            trim();
+        }
+      }
+
+      /// Free all cached blocks
+
+      /// The cache of the calling thread and the shared caches of all domains
+      /// are emptied.
+      /// The caches of other threads are not modified.
+      void release() {
+        ThreadCache& cache = thread_cache();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for(unsigned int c = 0u; c < num_classes; ++c) {
+          const std::size_t bytes = class_bytes(c);
+          for(void* block : cache.blocks[c])
+            free_block(block, bytes);
+          cache.blocks[c].clear();
+          for(unsigned int d = 0u; d < max_domains; ++d) {
+            for(void* block : blocks_[d][c])
+              free_block(block, bytes);
+            blocks_[d][c].clear();
+          }
+        }
+        remove_cached(cache.cached_bytes.load(std::memory_order_relaxed) + cached_bytes_);
+        cache.cached_bytes = 0ul;
+        cached_bytes_ = 0ul;
+      }
+
+      /// \return The limit of the bytes held in free blocks by this pool
+      std::size_t max_cached_bytes() const {
+        return max_cached_bytes_.load(std::memory_order_relaxed);
+      }
+
+      /// Set the limit of the bytes held in free blocks
+
+      /// Blocks of the shared caches are freed until the cached bytes fit
+      /// within \c bytes ; blocks held by the caches of running threads are
+      /// freed as they are spilled.
+      /// \param bytes The limit of the cached bytes of this pool
+      void set_max_cached_bytes(const std::size_t bytes) {
+        max_cached_bytes_.store(bytes, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex_);
+        trim();
+      }
+
+      /// Pool statistics
+
+      /// \return The pool statistics summed over all threads
+      PoolStatistics statistics() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PoolStatistics result = { hits_, misses_, unpooled_, cached_bytes_ };
+        for(const ThreadCache* cache : caches_) {
+          result.hits += cache->hits.load(std::memory_order_relaxed);
+          result.misses += cache->misses.load(std::memory_order_relaxed);
+          result.unpooled += cache->unpooled.load(std::memory_order_relaxed);
+          result.cached_bytes += cache->cached_bytes.load(std::memory_order_relaxed);
+        }
+        return result;
+      }
+
+      /// Reset the hit, miss, and unpooled counters
+      void reset_statistics() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        hits_ = misses_ = unpooled_ = 0ul;
+        for(ThreadCache* cache : caches_) {
+          cache->hits = 0ul;
+          cache->misses = 0ul;
+          cache->unpooled = 0ul;
+        }
+      }
+
+    }; // class TilePool
+
+  } // namespace detail
+
+  /// Pooled, aligned allocator for tile data
+
+  /// This allocator takes memory from \c detail::TilePool, which caches freed
+  /// blocks so that tiles of recurring sizes are not returned to the system
+  /// allocator. It can be used as the allocator of \c Tensor , e.g.
+  /// <tt>Tensor<double, PoolAllocator<double> ></tt>.
+  /// \tparam T The element type
+  template <class T>
+  class PoolAllocator {
+  public:
+    typedef T value_type; ///< Element type
+    typedef T* pointer; ///< Element pointer type
+    typedef const T* const_pointer; ///< Element const pointer type
+    typedef T& reference; ///< Element reference type
+    typedef const T& const_reference; ///< Element const reference type
+    typedef std::size_t size_type; ///< Size type
+    typedef std::ptrdiff_t difference_type; ///< Difference type
+
+    template <class U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+    PoolAllocator() = default;
+    PoolAllocator(const PoolAllocator<T>&) = default;
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>&) { }
+    ~PoolAllocator() = default;
+    PoolAllocator<T>& operator=(const PoolAllocator<T>&) = default;
+
+    /// Allocate memory for \c n elements
+
+    /// \param n The number of elements
+    /// \return A pointer to uninitialized memory for \c n elements
+    pointer allocate(const size_type n) {
+      return static_cast<pointer>(detail::TilePool::instance().allocate(n * sizeof(T)));
+    }
+
+    /// Return memory to the pool
+
+    /// \param p The pointer returned by \c allocate
+    /// \param n The number of elements passed to \c allocate
+    void deallocate(pointer p, const size_type n) {
+      detail::TilePool::instance().deallocate(p, n * sizeof(T));
+    }
+
+    /// Maximum number of elements that can be allocated
+    size_type max_size() const {
+      return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+  }; // class PoolAllocator
+
+  template <class T, class U>
+  inline bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) { return true; }
+
+  template <class T, class U>
+  inline bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) { return false; }
+
+  /// Tile memory pool statistics
+
+  /// \return The statistics of the tile pool of this process
+  inline PoolStatistics pool_statistics() {
+    return detail::TilePool::instance().statistics();
+  }
+
+  /// Pooled allocator for pinned tile data
+
+  /// This allocator takes page-locked memory from
+  /// \c detail::TilePool::pinned_instance() . Devices and network adapters
+  /// can access it directly, so tiles that are copied to a GPU or sent by
+  /// MPI, e.g. the tiles broadcast by SUMMA, are transferred without a
+  /// staging copy. It can be used as the allocator of \c Tensor , e.g.
+  /// <tt>Tensor<double, PinnedAllocator<double> ></tt>.
+  /// \tparam T The element type
+  template <class T>
+  class PinnedAllocator {
+  public:
+    typedef T value_type; ///< Element type
+    typedef T* pointer; ///< Element pointer type
+    typedef const T* const_pointer; ///< Element const pointer type
+    typedef T& reference; ///< Element reference type
+    typedef const T& const_reference; ///< Element const reference type
+    typedef std::size_t size_type; ///< Size type
+    typedef std::ptrdiff_t difference_type; ///< Difference type
+
+    template <class U>
+    struct rebind { typedef PinnedAllocator<U> other; };
+
+    PinnedAllocator() = default;
+    PinnedAllocator(const PinnedAllocator<T>&) = default;
+    template <class U>
+    PinnedAllocator(const PinnedAllocator<U>&) { }
+    ~PinnedAllocator() = default;
+    PinnedAllocator<T>& operator=(const PinnedAllocator<T>&) = default;
+
+    /// Allocate memory for \c n elements
+
+    /// \param n The number of elements
+    /// \return A pointer to uninitialized, pinned memory for \c n elements
+    pointer allocate(const size_type n) {
+      return static_cast<pointer>(detail::TilePool::pinned_instance().allocate(n * sizeof(T)));
+    }
+
+    /// Return memory to the pool
+
+    /// \param p The pointer returned by \c allocate
+    /// \param n The number of elements passed to \c allocate
+    void deallocate(pointer p, const size_type n) {
+      detail::TilePool::pinned_instance().deallocate(p, n * sizeof(T));
+    }
+
+    /// Maximum number of elements that can be allocated
+    size_type max_size() const {
+      return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+  }; // class PinnedAllocator
+
+  template <class T, class U>
+  inline bool operator==(const PinnedAllocator<T>&, const PinnedAllocator<U>&) { return true; }
+
+  template <class T, class U>
+  inline bool operator!=(const PinnedAllocator<T>&, const PinnedAllocator<U>&) { return false; }
+
+  /// Pinned tile memory pool statistics
+
+  /// \return The statistics of the pinned tile pool of this process
+  inline PoolStatistics pinned_pool_statistics() {
+    return detail::TilePool::pinned_instance().statistics();
+  }
+
+  /// Pooled allocator for tile data backed by huge pages
+
+  /// This allocator takes memory from \c detail::TilePool::huge_instance() ,
+  /// which backs tiles of at least <tt>TilePool::huge_threshold()</tt> bytes
+  /// with huge pages, and recycles them like \c PoolAllocator . It can be
+  /// used as the allocator of \c Tensor , e.g.
+  /// <tt>Tensor<double, HugePageAllocator<double> ></tt>.
+  /// \tparam T The element type
+  template <class T>
+  class HugePageAllocator {
+  public:
+    typedef T value_type; ///< Element type
+    typedef T* pointer; ///< Element pointer type
+    typedef const T* const_pointer; ///< Element const pointer type
+    typedef T& reference; ///< Element reference type
+    typedef const T& const_reference; ///< Element const reference type
+    typedef std::size_t size_type; ///< Size type
+    typedef std::ptrdiff_t difference_type; ///< Difference type
+
+    template <class U>
+    struct rebind { typedef HugePageAllocator<U> other; };
+
+    HugePageAllocator() = default;
+    HugePageAllocator(const HugePageAllocator<T>&) = default;
+    template <class U>
+    HugePageAllocator(const HugePageAllocator<U>&) { }
+    ~HugePageAllocator() = default;
+    HugePageAllocator<T>& operator=(const HugePageAllocator<T>&) = default;
+
+    /// Allocate memory for \c n elements
+
+    /// \param n The number of elements
+    /// \return A pointer to uninitialized memory for \c n elements
+    pointer allocate(const size_type n) {
+      return static_cast<pointer>(detail::TilePool::huge_instance().allocate(n * sizeof(T)));
+    }
+
+    /// Return memory to the pool
+
+    /// \param p The pointer returned by \c allocate
+    /// \param n The number of elements passed to \c allocate
+    void deallocate(pointer p, const size_type n) {
+      detail::TilePool::huge_instance().deallocate(p, n * sizeof(T));
+    }
+
+    /// Maximum number of elements that can be allocated
+    size_type max_size() const {
+      return std::numeric_limits<size_type>::max() / sizeof(T);
+    }
+
+  }; // class HugePageAllocator
+
+  template <class T, class U>
+  inline bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) { return true; }
+
+  template <class T, class U>
+  inline bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) { return false; }
+
+  /// Huge page tile memory pool statistics
+
+  /// \return The statistics of the huge page tile pool of this process
+  inline PoolStatistics huge_pool_statistics() {
+    return detail::TilePool::huge_instance().statistics();
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_POOL_ALLOCATOR_H__INCLUDED
@@ -0,0 +1,221 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  statistics.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_STATISTICS_H__INCLUDED
+#define TILEDARRAY_TENSOR_STATISTICS_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/tensor/complex.h>
+#include <TiledArray/type_traits.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace TiledArray {
+
+  /// Statistics that are computed by \c Statistics
+
+  /// The flags are combined with <tt>|</tt> to select a set of statistics.
+  enum StatisticsFlags : unsigned int {
+    stat_sum = 1u, ///< The sum of the elements
+    stat_squared_norm = 2u, ///< The sum of the squared elements
+    stat_min = 4u, ///< The minimum element (not for complex elements)
+    stat_max = 8u, ///< The maximum element (not for complex elements)
+    stat_abs_min = 16u, ///< The minimum absolute value
+    stat_abs_max = 32u, ///< The maximum absolute value
+    stat_dot = 64u, ///< The dot product with a second tensor
+    stat_all = 127u ///< All statistics
+  }; // enum StatisticsFlags
+
+  /// A set of statistics of the elements of tensors
+
+  /// Convergence checks need several statistics of the same data, e.g. the
+  /// norm and the maximum absolute value of a residual. \c Statistics
+  /// computes a selected set of them in one pass over the elements, and the
+  /// statistics of several tensors are combined with \c join() , so the
+  /// statistics of an array need one pass over each tile and one global
+  /// reduction (see \c Expr::statistics() ).
+  /// \tparam Numeric The element type
+  template <typename Numeric>
+  class Statistics {
+  public:
+    typedef Numeric numeric_type; ///< The element type
+    typedef typename detail::scalar_type<Numeric>::type
+        scalar_type; ///< The scalar type of the elements
+
+  private:
+    unsigned int flags_; ///< The selected statistics
+    numeric_type sum_; ///< The sum of the elements
+    numeric_type dot_; ///< The dot product
+    scalar_type squared_norm_; ///< The sum of the squared elements
+    scalar_type min_; ///< The minimum element
+    scalar_type max_; ///< The maximum element
+    scalar_type abs_min_; ///< The minimum absolute value
+    scalar_type abs_max_; ///< The maximum absolute value
+
+    static constexpr bool is_complex = detail::is_complex<Numeric>::value;
+
+    /// Real part of an element
+    template <typename T>
+    static scalar_type real(const T x) { return x; }
+    template <typename T>
+    static scalar_type real(const std::complex<T> x) { return x.real(); }
+
+    /// Check that a statistic was selected
+    void check(const unsigned int flag) const {
+      TA_USER_ASSERT(flags_ & flag,
+          "Statistics: The statistic was not selected.");
+    }
+
+  public:
+
+    /// Construct an empty set of statistics
+
+    /// \param flags The selected statistics, a combination of
+    /// \c StatisticsFlags
+    /// \throw TiledArray::Exception When the minimum or maximum element of
+    /// complex elements is selected.
+    explicit Statistics(const unsigned int flags = 0u) :
+      flags_(flags), sum_(0), dot_(0), squared_norm_(0),
+      min_(std::numeric_limits<scalar_type>::max()),
+      max_(std::numeric_limits<scalar_type>::lowest()),
+      abs_min_(std::numeric_limits<scalar_type>::max()), abs_max_(0)
+    {
+      TA_USER_ASSERT(! (is_complex && (flags & (stat_min | stat_max))),
+          "Statistics: The minimum and maximum of complex elements are not defined.");
+    }
+
+    /// \return The selected statistics
+    unsigned int flags() const { return flags_; }
+
+    /// Add elements
+
+    /// \param n The number of elements
+    /// \param data The elements
+    void accumulate(const std::size_t n, const numeric_type* const data) {
+      numeric_type sum = sum_;
+      scalar_type squared_norm = squared_norm_, min = min_, max = max_,
+          abs_min = abs_min_, abs_max = abs_max_;
+
+      // All statistics are computed without branches, so the loop is
+      // vectorized; the pass is bound by the memory bandwidth.
+      for(std::size_t i = 0ul; i < n; ++i) {
+        const numeric_type x = data[i];
+        const scalar_type abs_x = std::abs(x);
+        sum += x;
+        squared_norm += detail::norm(x);
+        if(! is_complex) {
+          min = std::min(min, real(x));
+          max = std::max(max, real(x));
+        }
+        abs_min = std::min(abs_min, abs_x);
+        abs_max = std::max(abs_max, abs_x);
+      }
+
+      sum_ = sum;
+      squared_norm_ = squared_norm;
+      min_ = min;
+      max_ = max;
+      abs_min_ = abs_min;
+      abs_max_ = abs_max;
+    }
+
+    /// Add elements, and the dot product with a second set of elements
+
+    /// \tparam Right The element type of the second set
+    /// \param n The number of elements
+    /// \param data The elements
+    /// \param right The elements of the second set
+    template <typename Right>
+    void accumulate(const std::size_t n, const numeric_type* const data,
+        const Right* const right)
+    {
+      accumulate(n, data);
+      if(flags_ & stat_dot) {
+        numeric_type dot = dot_;
+        for(std::size_t i = 0ul; i < n; ++i)
+          dot += data[i] * right[i];
+        dot_ = dot;
+      }
+    }
+
+    /// Combine with the statistics of other elements
+
+    /// \param other The statistics of other elements
+    /// \return A reference to this object
+    Statistics& join(const Statistics& other) {
+      flags_ |= other.flags_;
+      sum_ += other.sum_;
+      dot_ += other.dot_;
+      squared_norm_ += other.squared_norm_;
+      min_ = std::min(min_, other.min_);
+      max_ = std::max(max_, other.max_);
+      abs_min_ = std::min(abs_min_, other.abs_min_);
+      abs_max_ = std::max(abs_max_, other.abs_max_);
+      return *this;
+    }
+
+    /// \return The sum of the elements
+    numeric_type sum() const { check(stat_sum); return sum_; }
+
+    /// \return The sum of the squared elements
+    scalar_type squared_norm() const {
+      check(stat_squared_norm);
+      return squared_norm_;
+    }
+
+    /// \return The vector 2-norm of the elements
+    scalar_type norm() const { return std::sqrt(squared_norm()); }
+
+    /// \return The minimum element
+    scalar_type min() const { check(stat_min); return min_; }
+
+    /// \return The maximum element
+    scalar_type max() const { check(stat_max); return max_; }
+
+    /// \return The minimum absolute value
+    scalar_type abs_min() const { check(stat_abs_min); return abs_min_; }
+
+    /// \return The maximum absolute value
+    scalar_type abs_max() const { check(stat_abs_max); return abs_max_; }
+
+    /// \return The dot product with the second set of elements
+    numeric_type dot() const { check(stat_dot); return dot_; }
+
+    /// Serialize the statistics
+
+    /// \tparam Archive The archive type
+    /// \param ar The archive
+    template <typename Archive>
+    void serialize(Archive& ar) {
+      ar & flags_ & sum_ & dot_ & squared_norm_ & min_ & max_ & abs_min_
+          & abs_max_;
+    }
+
+  }; // class Statistics
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_STATISTICS_H__INCLUDED
@@ -32,7 +32,9 @@ namespace TiledArray {
   template class Tensor<float, Eigen::aligned_allocator<float> >;
   template class Tensor<int, Eigen::aligned_allocator<int> >;
   template class Tensor<long, Eigen::aligned_allocator<long> >;
-//  template class Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >;
-//  template class Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >;
+  template class Tensor<double, PoolAllocator<double> >;
+  template class Tensor<float, PoolAllocator<float> >;
+  template class Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >;
+  template class Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >;
 
 } // namespace TiledArray
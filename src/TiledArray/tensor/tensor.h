@@ -20,10 +20,19 @@
 #ifndef TILEDARRAY_TENSOR_TENSOR_H__INCLUDED
 #define TILEDARRAY_TENSOR_TENSOR_H__INCLUDED
 
+#include <TiledArray/memory_tracker.h>
 #include <TiledArray/math/gemm_helper.h>
 #include <TiledArray/math/blas.h>
+#include <TiledArray/math/block_sparse_gemm.h>
+#include <TiledArray/tensor/tot_gemm.h>
 #include <TiledArray/tensor/kernels.h>
 #include <TiledArray/tensor/complex.h>
+#include <TiledArray/tensor/pool_allocator.h>
+#include <TiledArray/tensor/statistics.h>
+#include <TiledArray/tensor/wire_codec.h>
+#include <madness/world/worldmutex.h>
+#include <atomic>
+#include <functional>
 
 namespace TiledArray {
 
@@ -56,34 +65,102 @@ namespace TiledArray {
     template <typename X>
     using numeric_t = typename TiledArray::detail::numeric_type<X>::type;
 
+    /// Tensor data buffer
+
+    /// The buffer owns the data of a tensor. It is shared by the copies and
+    /// views of the tensor, and by its lazy clones until they are modified.
+    /// An external buffer holds memory that is owned by the user, and is
+    /// released with the user deleter instead of the allocator.
+    class Buffer : public allocator_type {
+    public:
+
+      /// Construct an empty buffer
+      Buffer() :
+        allocator_type(), data_(NULL), size_(0ul),
+        category_(MemoryCategory::tile), norm_(-1.0), lazy_(false),
+        read_only_(false), deleter_()
+      { }
+
+      /// Allocate a buffer
+
+      /// The data is uninitialized.
+      /// \param n The number of elements in the buffer
+      explicit Buffer(const size_type n) :
+        allocator_type(), data_(NULL), size_(n),
+        category_(MemoryTracker::category()), norm_(-1.0), lazy_(false),
+        read_only_(false), deleter_()
+      {
+        data_ = allocator_type::allocate(n);
+        MemoryTracker::instance().allocate(category_, n * sizeof(value_type));
+      }
+
+      /// Construct an external buffer
+
+      /// \param data The initialized data of the buffer
+      /// \param n The number of elements in the buffer
+      /// \param deleter The operation that releases \c data
+      /// \param read_only If \c true , the data is copied before it is modified
+      Buffer(const pointer data, const size_type n,
+          std::function<void(pointer)> deleter, const bool read_only) :
+        allocator_type(), data_(data), size_(n),
+        category_(MemoryCategory::tile), norm_(-1.0), lazy_(false),
+        read_only_(read_only),
+        deleter_(deleter ? std::move(deleter) : [] (pointer) { })
+      { }
+
+      ~Buffer() {
+        if(deleter_) {
+          deleter_(data_);
+        } else if(data_) {
+          math::destroy_vector(size_, data_);
+          allocator_type::deallocate(data_, size_);
+          MemoryTracker::instance().deallocate(category_, size_ * sizeof(value_type));
+        }
+        data_ = NULL;
+      }
+
+      pointer data_; ///< Tensor data
+      size_type size_; ///< The number of elements in the buffer
+      MemoryCategory category_; ///< The memory category of the data
+      std::atomic<double> norm_; ///< Cached norm of the data, or negative when not cached
+      std::atomic<bool> lazy_; ///< If true, the buffer is shared by a lazy clone
+      const bool read_only_; ///< If true, the external data must not be modified
+      const std::function<void(pointer)> deleter_; ///< The deleter of external data
+    }; // class Buffer
+
     /// Evaluation tensor
 
     /// This tensor is used as an evaluated intermediate for other tensors.
-    class Impl : public allocator_type {
+    class Impl {
     public:
 
       /// Default constructor
 
       /// Construct an empty tensor that has no data or dimensions
-      Impl() : allocator_type(), range_(), data_(NULL) { }
+      Impl() : range_(), buffer_(), data_(NULL), lock_() { }
 
       /// Construct with range
 
       /// \param range The N-dimensional range for this tensor
       explicit Impl(const range_type& range) :
-        allocator_type(), range_(range), data_(NULL)
-      {
-        data_ = allocator_type::allocate(range.volume());
-      }
+        range_(range), buffer_(std::make_shared<Buffer>(range.volume())),
+        data_(buffer_->data_), lock_()
+      { }
 
-      ~Impl() {
-        math::destroy_vector(range_.volume(), data_);
-        allocator_type::deallocate(data_, range_.volume());
-        data_ = NULL;
+      /// Construct a tensor that shares a data buffer
+
+      /// \param range The N-dimensional range for this tensor
+      /// \param buffer The buffer that holds the data
+      Impl(const range_type& range, const std::shared_ptr<Buffer>& buffer) :
+        range_(range), buffer_(buffer), data_(buffer->data_), lock_()
+      {
+        TA_ASSERT(range_.volume() == buffer->size_);
       }
 
       range_type range_; ///< Tensor size info
+      std::shared_ptr<Buffer> buffer_; ///< The buffer that owns the data
       pointer data_; ///< Tensor data
+      madness::Spinlock lock_; ///< Lock for copying a shared buffer
     }; // class Impl
 
     template <typename... Ts>
@@ -103,6 +180,50 @@ namespace TiledArray {
     std::shared_ptr<Impl> pimpl_; ///< Shared pointer to implementation object
     static const range_type empty_range_; ///< Empty range
 
+    /// Set the cached norm
+
+    /// \param norm The norm of this tensor, where a negative value is ignored
+    void cache_norm(const double norm) const {
+      if(pimpl_ && (norm >= 0.0))
+        pimpl_->buffer_->norm_.store(norm, std::memory_order_release);
+    }
+
+    /// Copy a data buffer that is shared with a lazy clone or read-only
+
+    /// The copy is assigned to the implementation object, so all copies of
+    /// this tensor use it.
+    void copy_buffer() {
+      madness::ScopedMutex<madness::Spinlock> lock(pimpl_->lock_);
+      if((pimpl_->buffer_.use_count() == 1l) && ! pimpl_->buffer_->read_only_)
+        return;
+
+      const size_type n = pimpl_->range_.volume();
+      std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>(n);
+      math::uninitialized_copy_vector(n, pimpl_->data_, buffer->data_);
+      pimpl_->buffer_ = buffer;
+      pimpl_->data_ = buffer->data_;
+    }
+
+    /// Prepare the data for write access
+
+    /// This is called by every non-const function that gives write access to
+    /// the data of this tensor. Data that is shared with a lazy clone (see
+    /// \c lazy_clone() ) or read-only external data is copied, and the cached
+    /// norm is cleared. Since this is called for each element access, the
+    /// shared state is only read with relaxed loads, and the norm is only
+    /// stored when one is cached; \c copy_buffer() checks the buffer again
+    /// under its lock.
+    void prepare_write() {
+      if(pimpl_) {
+        if(pimpl_->buffer_->read_only_ ||
+            (pimpl_->buffer_->lazy_.load(std::memory_order_relaxed) &&
+            (pimpl_->buffer_.use_count() > 1l)))
+          copy_buffer();
+        if(pimpl_->buffer_->norm_.load(std::memory_order_relaxed) >= 0.0)
+          pimpl_->buffer_->norm_.store(-1.0, std::memory_order_release);
+      }
+    }
+
   public:
 
     // Compiler generated functions
@@ -179,6 +300,59 @@ namespace TiledArray {
       math::uninitialized_copy_vector(range.volume(), u, pimpl_->data_);
     }
 
+    /// Construct a tensor that adopts external data
+
+    /// The tensor uses \c data without a copy, e.g. a buffer of an integral
+    /// library. \c deleter is called with \c data when the last tensor that
+    /// uses it is destroyed; a deleter that does nothing makes the tensor a
+    /// reference to memory that is released by the user after the tensor.
+    /// \code
+    /// double* data = new double[range.volume()];
+    /// ...
+    /// TiledArray::Tensor<double> tile(range, data,
+    ///     [] (double* p) { delete [] p; });
+    /// array.set(index, tile);
+    /// \endcode
+    /// \param range The range of the tensor
+    /// \param data The initialized elements of the tensor, in row-major order
+    /// \param deleter The operation that releases \c data
+    /// \note External data is not counted by the \c MemoryTracker .
+    Tensor(const range_type& range, const pointer data,
+        std::function<void(pointer)> deleter) :
+      pimpl_(std::make_shared<Impl>(range, std::make_shared<Buffer>(data,
+          range.volume(), std::move(deleter), false)))
+    {
+      TA_USER_ASSERT(data || (range.volume() == 0ul),
+          "Tensor: The external data is null.");
+    }
+
+    /// Construct a tensor that references read-only external data
+
+    /// The tensor uses \c data without a copy, e.g. a memory-mapped file,
+    /// until it is modified through a non-const member function, which then
+    /// copies the data (see \c lazy_clone() ). \c deleter is called with
+    /// \c data when the last tensor that uses it is destroyed.
+    /// \param range The range of the tensor
+    /// \param data The initialized elements of the tensor, in row-major order
+    /// \param deleter The operation that releases \c data
+    /// \note External data is not counted by the \c MemoryTracker .
+    Tensor(const range_type& range, const const_pointer data,
+        std::function<void(const_pointer)> deleter) :
+      pimpl_(std::make_shared<Impl>(range, std::make_shared<Buffer>(
+          const_cast<pointer>(data), range.volume(),
+          [deleter] (const pointer p) { if(deleter) deleter(p); }, true)))
+    {
+      TA_USER_ASSERT(data || (range.volume() == 0ul),
+          "Tensor: The external data is null.");
+    }
+
+    /// External data accessor
+
+    /// \return \c true if the data of this tensor is owned by the user
+    bool is_external() const {
+      return pimpl_ && bool(pimpl_->buffer_->deleter_);
+    }
+
     /// Construct a copy of a tensor interface object
 
     /// \tparam T1 A tensor type
@@ -206,11 +380,8 @@ namespace TiledArray {
     Tensor(const T1& other, const Permutation& perm) :
       pimpl_(new Impl(perm * other.range()))
     {
-      auto op =
-          [] (const numeric_t<T1> arg) -> numeric_t<T1>
-      { return arg; };
-
-      detail::tensor_init(op, perm, *this, other);
+      detail::tensor_init(math::CopyVectorOp<numeric_t<T1> >(), perm, *this,
+          other);
     }
 
     /// Copy and modify the data from \c other
@@ -282,6 +453,30 @@ namespace TiledArray {
         result = detail::tensor_op<Tensor_>(
             [] (const numeric_type value) -> numeric_type { return value; },
             *this);
+        result.cache_norm(cached_norm());
+      }
+      return result;
+    }
+
+    /// Copy-on-write clone
+
+    /// The result shares the data of this tensor until either of them is
+    /// modified through a non-const member function (e.g. element access,
+    /// \c data() , or an in-place operation), which then copies the data.
+    /// So the result behaves like \c clone() , but tensors that are not
+    /// modified are not copied. Pointers and iterators that were obtained
+    /// from this tensor before this call must not be used to modify it, and
+    /// a lazily shared tensor must not be modified by concurrent threads.
+    /// Tensors of tensors are cloned immediately.
+    /// \return A lazy copy of this tensor
+    Tensor_ lazy_clone() const {
+      if(! std::is_scalar<value_type>::value)
+        return clone();
+
+      Tensor_ result;
+      if(pimpl_) {
+        pimpl_->buffer_->lazy_.store(true, std::memory_order_release);
+        result.pimpl_ = std::make_shared<Impl>(pimpl_->range_, pimpl_->buffer_);
       }
       return result;
     }
@@ -325,6 +520,7 @@ namespace TiledArray {
     reference operator[](const size_type i) {
       TA_ASSERT(pimpl_);
       TA_ASSERT(pimpl_->range_.includes(i));
+      prepare_write();
       return pimpl_->data_[i];
     }
 
@@ -352,6 +548,7 @@ namespace TiledArray {
     reference operator[](const Index& i) {
       TA_ASSERT(pimpl_);
       TA_ASSERT(pimpl_->range_.includes(i));
+      prepare_write();
       return pimpl_->data_[pimpl_->range_.ordinal(i)];
     }
 
@@ -363,6 +560,7 @@ namespace TiledArray {
     reference operator()(const Index&... idx) {
       TA_ASSERT(pimpl_);
       TA_ASSERT(pimpl_->range_.includes(idx...));
+      prepare_write();
       return pimpl_->data_[pimpl_->range_.ordinal(idx...)];
     }
 
@@ -385,7 +583,10 @@ namespace TiledArray {
     /// Iterator factory
 
     /// \return An iterator to the first data element
-    iterator begin() { return (pimpl_ ? pimpl_->data_ : NULL); }
+    iterator begin() {
+      prepare_write();
+      return (pimpl_ ? pimpl_->data_ : NULL);
+    }
 
     /// Iterator factory
 
@@ -398,6 +599,7 @@ namespace TiledArray {
 
     /// \return An iterator to the last data element
     iterator end() {
+      prepare_write();
       return (pimpl_ ? pimpl_->data_ + pimpl_->range_.volume() : NULL);
     }
 
@@ -409,7 +611,10 @@ namespace TiledArray {
     /// Data direct access
 
     /// \return A const pointer to the tensor data
-    pointer data() { return (pimpl_ ? pimpl_->data_ : NULL); }
+    pointer data() {
+      prepare_write();
+      return (pimpl_ ? pimpl_->data_ : NULL);
+    }
 
     /// Test if the tensor is empty
 
@@ -447,17 +652,11 @@ namespace TiledArray {
       size_type n = 0ul;
       ar & n;
       if(n) {
-        std::shared_ptr<Impl> temp(new Impl());
-        temp->data_ = temp->allocate(n);
-        try {
-          ar & madness::archive::wrap(temp->data_, n);
-          ar & temp->range_;
-        } catch(...) {
-          temp->deallocate(temp->data_, n);
-          throw;
-        }
-
-        pimpl_ = temp;
+        std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>(n);
+        ar & madness::archive::wrap(buffer->data_, n);
+        range_type range;
+        ar & range;
+        pimpl_ = std::make_shared<Impl>(range, buffer);
       } else {
         pimpl_.reset();
       }
@@ -474,6 +673,7 @@ namespace TiledArray {
     detail::TensorInterface<T, BlockRange>
     block(const Index& lower_bound, const Index& upper_bound) {
       TA_ASSERT(pimpl_);
+      prepare_write();
       return detail::TensorInterface<T, BlockRange>(BlockRange(pimpl_->range_,
           lower_bound, upper_bound), pimpl_->data_);
     }
@@ -483,6 +683,7 @@ namespace TiledArray {
         const std::initializer_list<size_type>& upper_bound)
     {
       TA_ASSERT(pimpl_);
+      prepare_write();
       return detail::TensorInterface<T, BlockRange>(BlockRange(pimpl_->range_,
           lower_bound, upper_bound), pimpl_->data_);
     }
@@ -509,7 +710,9 @@ namespace TiledArray {
     /// \param perm The permutation to be applied to this tensor
     /// \return A permuted copy of this tensor
     Tensor_ permute(const Permutation& perm) const {
-      return Tensor_(*this, perm);
+      Tensor_ result(*this, perm);
+      result.cache_norm(cached_norm());
+      return result;
     }
 
 
@@ -533,11 +736,45 @@ namespace TiledArray {
     template <typename Index>
     Tensor_ shift(const Index& bound_shift) const {
       TA_ASSERT(pimpl_);
-      Tensor_ result = clone();
+      Tensor_ result = lazy_clone();
+      result.shift_to(bound_shift);
+      return result;
+    }
+
+    /// Shift the lower and upper bound of a view of this tensor
+
+    /// Unlike \c shift() , the data of this tensor is not copied. The result
+    /// has its own range but shares the data of this tensor, in the same way
+    /// that a copy of this tensor does.
+    /// \tparam Index The shift array type
+    /// \param bound_shift The shift to be applied to the tensor range
+    /// \return A shifted shallow copy of this tensor
+    template <typename Index>
+    Tensor_ shift_view(const Index& bound_shift) const {
+      TA_ASSERT(pimpl_);
+      Tensor_ result;
+      result.pimpl_ = std::make_shared<Impl>(pimpl_->range_, pimpl_->buffer_);
       result.shift_to(bound_shift);
       return result;
     }
 
+    /// Reshape a view of this tensor
+
+    /// The result has the range \c range , which may have a different rank,
+    /// and shares the data of this tensor in the same way that a copy of this
+    /// tensor does. The elements are reinterpreted in row-major order, so e.g.
+    /// a tensor with range <tt>[a,b,i,j]</tt> is viewed as a matrix with range
+    /// <tt>[a*b,i*j]</tt> without copying its data.
+    /// \param range The range of the result
+    /// \return A shallow copy of this tensor with range \c range
+    Tensor_ reshape_view(const range_type& range) const {
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(range.volume() == pimpl_->range_.volume());
+      Tensor_ result;
+      result.pimpl_ = std::make_shared<Impl>(range, pimpl_->buffer_);
+      return result;
+    }
+
     // Generic vector operations
 
     /// Use a binary, element wise operation to construct a new tensor
@@ -637,8 +874,9 @@ namespace TiledArray {
     template <typename Scalar,
         typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_ scale(const Scalar factor) const {
-      return unary([=] (const numeric_type a) -> numeric_type
-          { return a * factor; });
+      Tensor_ result = unary(math::ScalVectorOp<numeric_type, Scalar>{ factor });
+      result.cache_norm(std::abs(factor) * cached_norm());
+      return result;
     }
 
     /// Construct a scaled and permuted copy of this tensor
@@ -651,8 +889,10 @@ namespace TiledArray {
     template <typename Scalar,
         typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_ scale(const Scalar factor, const Permutation& perm) const {
-      return unary([=] (const numeric_type a) -> numeric_type
-          { return a * factor; }, perm);
+      Tensor_ result =
+          unary(math::ScalVectorOp<numeric_type, Scalar>{ factor }, perm);
+      result.cache_norm(std::abs(factor) * cached_norm());
+      return result;
     }
 
     /// Scale this tensor
@@ -663,7 +903,10 @@ namespace TiledArray {
     template <typename Scalar,
         typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_& scale_to(const Scalar factor) {
-      return inplace_unary([=] (numeric_type& MADNESS_RESTRICT res) { res *= factor; });
+      const double norm = cached_norm();
+      inplace_unary(math::ScalInplaceVectorOp<numeric_type, Scalar>{ factor });
+      cache_norm(std::abs(factor) * norm);
+      return *this;
     }
 
     // Addition operations
@@ -677,9 +920,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ add(const Right& right) const {
-      return binary(right, [] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return l + r; });
+      return binary(right,
+          math::BinaryVectorOp<math::SimdBinary::add, numeric_type>());
     }
 
     /// Add this and \c other to construct a new, permuted tensor
@@ -692,9 +934,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ add(const Right& right, const Permutation& perm) const {
-      return binary(right, [] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return l + r; }, perm);
+      return binary(right,
+          math::BinaryVectorOp<math::SimdBinary::add, numeric_type>(), perm);
     }
 
     /// Scale and add this and \c other to construct a new tensor
@@ -709,9 +950,8 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_ add(const Right& right, const Scalar factor) const {
-      return binary(right, [=] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return (l + r) * factor; });
+      return binary(right,
+          math::ScalBinaryVectorOp<math::SimdBinary::add, numeric_type, Scalar>{ factor });
     }
 
     /// Scale and add this and \c other to construct a new, permuted tensor
@@ -729,9 +969,8 @@ namespace TiledArray {
     Tensor_ add(const Right& right, const Scalar factor,
         const Permutation& perm) const
     {
-      return binary(right,  [=] (const numeric_type l,
-          const numeric_t<Right> r) -> numeric_type
-          { return (l + r) * factor; }, perm);
+      return binary(right,
+          math::ScalBinaryVectorOp<math::SimdBinary::add, numeric_type, Scalar>{ factor }, perm);
     }
 
     /// Add a constant to a copy of this tensor
@@ -763,8 +1002,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& add_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
-          const numeric_t<Right> r) { l += r; });
+      return inplace_binary(right,
+          math::InplaceBinaryVectorOp<math::SimdBinary::add, numeric_type>());
     }
 
     /// Add \c other to this tensor, and scale the result
@@ -778,9 +1017,47 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_& add_to(const Right& right, const Scalar factor) {
-      return inplace_binary(right, [=] (numeric_type& MADNESS_RESTRICT l,
-          const numeric_t<Right> r)
-          { (l += r) *= factor; });
+      return inplace_binary(right,
+          math::ScalInplaceBinaryVectorOp<math::SimdBinary::add, numeric_type, Scalar>{ factor });
+    }
+
+    /// Add a permuted copy of \c right to this tensor
+
+    /// The permutation and the addition are done in one pass over the data,
+    /// without a temporary tensor.
+    /// \tparam Right The right-hand tensor type
+    /// \param right The tensor that will be permuted and added to this tensor
+    /// \param perm The permutation to be applied to \c right
+    /// \return A reference to this tensor
+    template <typename Right,
+        typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
+    Tensor_& add_to(const Right& right, const Permutation& perm) {
+      detail::inplace_tensor_op(math::CopyVectorOp<numeric_type>(),
+          math::AddToOutputOp<numeric_type>(), perm, *this, right);
+      return *this;
+    }
+
+    /// Add a permuted copy of \c right to this tensor, and scale the result
+
+    /// The permutation, addition, and scaling are done in one pass over the
+    /// data, without a temporary tensor.
+    /// \tparam Right The right-hand tensor type
+    /// \tparam Scalar A scalar type
+    /// \param right The tensor that will be permuted and added to this tensor
+    /// \param factor The scaling factor
+    /// \param perm The permutation to be applied to \c right
+    /// \return A reference to this tensor
+    template <typename Right, typename Scalar,
+        typename std::enable_if<is_tensor<Right>::value &&
+        detail::is_numeric<Scalar>::value>::type* = nullptr>
+    Tensor_& add_to(const Right& right, const Scalar factor,
+        const Permutation& perm)
+    {
+      detail::inplace_tensor_op(
+          [] (const numeric_t<Right> r) -> numeric_type { return r; },
+          [=] (numeric_type* MADNESS_RESTRICT const l, const numeric_type r)
+          { (*l += r) *= factor; }, perm, *this, right);
+      return *this;
     }
 
     /// Add a constant to this tensor
@@ -802,9 +1079,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ subt(const Right& right) const {
-      return binary(right, [] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return l - r; });
+      return binary(right,
+          math::BinaryVectorOp<math::SimdBinary::subt, numeric_type>());
     }
 
     /// Subtract this and \c right to construct a new, permuted tensor
@@ -817,9 +1093,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ subt(const Right& right, const Permutation& perm) const {
-      return binary(right, [] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return l - r; }, perm);
+      return binary(right,
+          math::BinaryVectorOp<math::SimdBinary::subt, numeric_type>(), perm);
     }
 
     /// Scale and subtract this and \c right to construct a new tensor
@@ -834,9 +1109,8 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_ subt(const Right& right, const Scalar factor) const {
-      return binary(right, [=] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return (l - r) * factor; });
+      return binary(right,
+          math::ScalBinaryVectorOp<math::SimdBinary::subt, numeric_type, Scalar>{ factor });
     }
 
     /// Scale and subtract this and \c right to construct a new, permuted tensor
@@ -854,9 +1128,8 @@ namespace TiledArray {
     Tensor_ subt(const Right& right, const Scalar factor,
         const Permutation& perm) const
     {
-      return binary(right, [=] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return (l - r) * factor; }, perm);
+      return binary(right,
+          math::ScalBinaryVectorOp<math::SimdBinary::subt, numeric_type, Scalar>{ factor }, perm);
     }
 
     /// Subtract a constant from a copy of this tensor
@@ -885,9 +1158,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& subt_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
-          const numeric_t<Right> r)
-          { l -= r; });
+      return inplace_binary(right,
+          math::InplaceBinaryVectorOp<math::SimdBinary::subt, numeric_type>());
     }
 
     /// Subtract \c right from and scale this tensor
@@ -901,9 +1173,8 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_& subt_to(const Right& right, const Scalar factor) {
-      return inplace_binary(right, [=] (numeric_type& MADNESS_RESTRICT l,
-          const numeric_t<Right> r)
-          { (l -= r) *= factor; });
+      return inplace_binary(right,
+          math::ScalInplaceBinaryVectorOp<math::SimdBinary::subt, numeric_type, Scalar>{ factor });
     }
 
     /// Subtract a constant from this tensor
@@ -924,9 +1195,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ mult(const Right& right) const {
-      return binary(right, [] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return l * r; });
+      return binary(right,
+          math::BinaryVectorOp<math::SimdBinary::mult, numeric_type>());
     }
 
     /// Multiply this by \c right to create a new, permuted tensor
@@ -939,9 +1209,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_ mult(const Right& right, const Permutation& perm) const {
-      return binary(right, [] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return l * r; }, perm);
+      return binary(right,
+          math::BinaryVectorOp<math::SimdBinary::mult, numeric_type>(), perm);
     }
 
     /// Scale and multiply this by \c right to create a new tensor
@@ -956,9 +1225,8 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_ mult(const Right& right, const Scalar factor) const {
-      return binary(right, [=] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return (l * r) * factor; });
+      return binary(right,
+          math::ScalBinaryVectorOp<math::SimdBinary::mult, numeric_type, Scalar>{ factor });
     }
 
     /// Scale and multiply this by \c right to create a new, permuted tensor
@@ -976,9 +1244,8 @@ namespace TiledArray {
     Tensor_ mult(const Right& right, const Scalar factor,
         const Permutation& perm) const
     {
-      return binary(right,  [=] (const numeric_type l,
-          const numeric_t<Right> r)
-          -> numeric_type { return (l * r) * factor; }, perm);
+      return binary(right,
+          math::ScalBinaryVectorOp<math::SimdBinary::mult, numeric_type, Scalar>{ factor }, perm);
     }
 
     /// Multiply this tensor by \c right
@@ -989,9 +1256,8 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     Tensor_& mult_to(const Right& right) {
-      return inplace_binary(right, [] (numeric_type& MADNESS_RESTRICT l,
-          const numeric_t<Right> r)
-          { l *= r; });
+      return inplace_binary(right,
+          math::InplaceBinaryVectorOp<math::SimdBinary::mult, numeric_type>());
     }
 
     /// Scale and multiply this tensor by \c right
@@ -1005,9 +1271,8 @@ namespace TiledArray {
         typename std::enable_if<is_tensor<Right>::value &&
         detail::is_numeric<Scalar>::value>::type* = nullptr>
     Tensor_& mult_to(const Right& right, const Scalar factor) {
-      return inplace_binary(right, [=] (numeric_type& MADNESS_RESTRICT l,
-          const numeric_t<Right> r)
-          { (l *= r) *= factor; });
+      return inplace_binary(right,
+          math::ScalInplaceBinaryVectorOp<math::SimdBinary::mult, numeric_type, Scalar>{ factor });
     }
 
     // Negation operations
@@ -1016,7 +1281,10 @@ namespace TiledArray {
 
     /// \return A new tensor that contains the negative values of this tensor
     Tensor_ neg() const {
-      return unary([] (const numeric_type r) -> numeric_type { return -r; });
+      Tensor_ result =
+          unary([] (const numeric_type r) -> numeric_type { return -r; });
+      result.cache_norm(cached_norm());
+      return result;
     }
 
     /// Create a negated and permuted copy of this tensor
@@ -1024,15 +1292,20 @@ namespace TiledArray {
     /// \param perm The permutation to be applied to this tensor
     /// \return A new tensor that contains the negative values of this tensor
     Tensor_ neg(const Permutation& perm) const {
-      return unary([] (const numeric_type l) -> numeric_type { return -l; },
-          perm);
+      Tensor_ result =
+          unary([] (const numeric_type l) -> numeric_type { return -l; }, perm);
+      result.cache_norm(cached_norm());
+      return result;
     }
 
     /// Negate elements of this tensor
 
     /// \return A reference to this tensor
     Tensor_& neg_to() {
-      return inplace_unary([] (numeric_type& MADNESS_RESTRICT l) { l = -l; });
+      const double norm = cached_norm();
+      inplace_unary([] (numeric_type& MADNESS_RESTRICT l) { l = -l; });
+      cache_norm(norm);
+      return *this;
     }
 
 
@@ -1116,7 +1389,8 @@ namespace TiledArray {
     /// \c other and scaled by \c factor
     /// \throw TiledArray::Exception When this tensor is empty.
     /// \throw TiledArray::Exception When \c other is empty.
-    template <typename U, typename AU, typename V>
+    template <typename U, typename AU, typename V,
+        typename std::enable_if<! detail::is_tensor<U>::value>::type* = nullptr>
     Tensor_ gemm(const Tensor<U, AU>& other, const V factor,
         const math::GemmHelper& gemm_helper) const
     {
@@ -1145,8 +1419,11 @@ namespace TiledArray {
       const integer lda = (gemm_helper.left_op() == madness::cblas::NoTrans ? k : m);
       const integer ldb = (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
 
-      math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
-          pimpl_->data_, lda, other.data(), ldb, numeric_type(0), result.data(), n);
+      // The product of a tile with its own adjoint is Hermitian
+      if(! math::herk_product(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k,
+          factor, pimpl_->data_, lda, other.data(), ldb, numeric_type(0), result.data(), n))
+        math::block_sparse_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
+            pimpl_->data_, lda, other.data(), ldb, numeric_type(0), result.data(), n);
 
       return result;
     }
@@ -1189,12 +1466,17 @@ namespace TiledArray {
     /// \param right The right-hand tensor that will be contracted
     /// \param factor The scaling factor
     /// \param gemm_helper The *GEMM operation meta data
+    /// \param beta The scaling factor applied to this tensor before the
+    /// product is added; with zero, the data of this tensor is overwritten
+    /// without being read, so it may be uninitialized (e.g. a recycled tile)
     /// \return A new tensor which is the result of contracting this tensor with
     /// other
     /// \throw TiledArray::Exception When this tensor is empty.
-    template <typename U, typename AU, typename V, typename AV, typename W>
+    template <typename U, typename AU, typename V, typename AV, typename W,
+        typename std::enable_if<! detail::is_tensor<U>::value>::type* = nullptr>
     Tensor_& gemm(const Tensor<U, AU>& left, const Tensor<V, AV>& right,
-        const W factor, const math::GemmHelper& gemm_helper)
+        const W factor, const math::GemmHelper& gemm_helper,
+        const numeric_type beta = numeric_type(1))
     {
       // Check that this tensor is not empty and has the correct rank
       TA_ASSERT(pimpl_);
@@ -1242,8 +1524,92 @@ namespace TiledArray {
       const integer ldb =
           (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
 
-      math::gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
-          left.data(), lda, right.data(), ldb, numeric_type(1), pimpl_->data_, n);
+      prepare_write();
+      if(! math::herk_product(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k,
+          factor, left.data(), lda, right.data(), ldb, beta, pimpl_->data_, n))
+        math::block_sparse_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k, factor,
+            left.data(), lda, right.data(), ldb, beta, pimpl_->data_, n);
+
+      return *this;
+    }
+
+    // Tensor of tensors GEMM operations
+
+    /// Contract this tensor of tensors with \c other
+
+    /// The outer tensors are contracted as described by \c gemm_helper. When
+    /// \c inner_helper is not given, the product of two elements is the
+    /// Hadamard (element-wise) product of the inner tensors; otherwise the
+    /// inner tensors are contracted as described by \c inner_helper , and
+    /// the inner GEMMs are batched (see detail::tot_gemm_contract ).
+    /// \tparam U The other tensor element type
+    /// \tparam AU The other tensor allocator type
+    /// \tparam V The type of \c factor scalar
+    /// \param other The tensor that will be contracted with this tensor
+    /// \param factor Multiply the result by this constant
+    /// \param gemm_helper The *GEMM operation meta data of the outer tensors
+    /// \param inner_helper The *GEMM operation meta data of the inner tensors
+    /// \return A new tensor which is the result of contracting this tensor with
+    /// \c other and scaled by \c factor
+    /// \throw TiledArray::Exception When this tensor is empty.
+    /// \throw TiledArray::Exception When \c other is empty.
+    template <typename U, typename AU, typename V,
+        typename std::enable_if<detail::is_tensor<U>::value>::type* = nullptr>
+    Tensor_ gemm(const Tensor<U, AU>& other, const V factor,
+        const math::GemmHelper& gemm_helper,
+        const math::GemmHelper& inner_helper =
+            math::GemmHelper(madness::cblas::NoTrans, madness::cblas::NoTrans, 0u, 0u, 0u)) const
+    {
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.left_rank());
+      TA_ASSERT(!other.empty());
+      TA_ASSERT(other.range().rank() == gemm_helper.right_rank());
+
+      Tensor_ result(gemm_helper.make_result_range<range_type>(pimpl_->range_, other.range()));
+      return result.gemm(*this, other, factor, gemm_helper, inner_helper);
+    }
+
+    /// Contract two tensors of tensors and add the result to this tensor
+
+    /// \tparam U The left-hand tensor element type
+    /// \tparam AU The left-hand tensor allocator type
+    /// \tparam V The right-hand tensor element type
+    /// \tparam AV The right-hand tensor allocator type
+    /// \tparam W The type of the scaling factor
+    /// \param left The left-hand tensor that will be contracted
+    /// \param right The right-hand tensor that will be contracted
+    /// \param factor The scaling factor
+    /// \param gemm_helper The *GEMM operation meta data of the outer tensors
+    /// \param inner_helper The *GEMM operation meta data of the inner tensors;
+    /// the inner tensors are multiplied element-wise when it has rank zero
+    /// \return A reference to this tensor
+    /// \throw TiledArray::Exception When this tensor is empty.
+    template <typename U, typename AU, typename V, typename AV, typename W,
+        typename std::enable_if<detail::is_tensor<U>::value>::type* = nullptr>
+    Tensor_& gemm(const Tensor<U, AU>& left, const Tensor<V, AV>& right,
+        const W factor, const math::GemmHelper& gemm_helper,
+        const math::GemmHelper& inner_helper =
+            math::GemmHelper(madness::cblas::NoTrans, madness::cblas::NoTrans, 0u, 0u, 0u))
+    {
+      TA_ASSERT(pimpl_);
+      TA_ASSERT(pimpl_->range_.rank() == gemm_helper.result_rank());
+      TA_ASSERT(!left.empty());
+      TA_ASSERT(left.range().rank() == gemm_helper.left_rank());
+      TA_ASSERT(!right.empty());
+      TA_ASSERT(right.range().rank() == gemm_helper.right_rank());
+      TA_ASSERT(gemm_helper.left_right_coformal(left.range().extent_data(),
+          right.range().extent_data()));
+
+      integer m, n, k;
+      gemm_helper.compute_matrix_sizes(m, n, k, left.range(), right.range());
+
+      prepare_write();
+      if(inner_helper.result_rank() == 0u)
+        detail::tot_gemm_mult(gemm_helper.left_op(), gemm_helper.right_op(),
+            m, n, k, factor, left.data(), right.data(), pimpl_->data_);
+      else
+        detail::tot_gemm_contract(gemm_helper.left_op(), gemm_helper.right_op(),
+            m, n, k, factor, left.data(), right.data(), pimpl_->data_, inner_helper);
 
       return *this;
     }
@@ -1356,8 +1722,7 @@ namespace TiledArray {
 
     /// \return The vector norm of this tensor
     scalar_type squared_norm() const {
-      auto square_op = [] (scalar_type& MADNESS_RESTRICT res, const numeric_type arg)
-              { res += TiledArray::detail::norm(arg); };
+      math::SquaredNormReduceOp<scalar_type> square_op;
       auto sum_op = [] (scalar_type& MADNESS_RESTRICT res, const scalar_type arg)
               { res += arg; };
       return detail::tensor_reduce(square_op, sum_op, scalar_type(0), *this);
@@ -1365,14 +1730,35 @@ namespace TiledArray {
 
     /// Vector 2-norm
 
+    /// The norm is cached, so that it is computed once for tensors that are
+    /// not modified (e.g. by \c truncate , \c to_sparse , and \c foreach ).
+    /// The cache is cleared by every non-const function that gives write
+    /// access to the data, and it is carried over by \c clone , \c permute ,
+    /// \c scale , and \c neg , since the result norm is known.
     /// \return The vector norm of this tensor
     scalar_type norm() const {
-      return std::sqrt(squared_norm());
+      const double cached = cached_norm();
+      if(cached >= 0.0)
+        return cached;
+      const scalar_type result = std::sqrt(squared_norm());
+      cache_norm(result);
+      return result;
+    }
+
+    /// Cached norm accessor
+
+    /// \return The cached vector norm of this tensor, or a negative value if
+    /// the norm is not cached
+    double cached_norm() const {
+      return (pimpl_ ? pimpl_->buffer_->norm_.load(std::memory_order_acquire) : -1.0);
     }
 
     /// Minimum element
 
+    /// This is not defined for complex tensors.
     /// \return The minimum elements of this tensor
+    template <typename Numeric = numeric_type,
+        typename std::enable_if<! detail::is_complex<Numeric>::value>::type* = nullptr>
     numeric_type min() const {
       auto min_op = [] (numeric_type& MADNESS_RESTRICT res, const numeric_type arg)
               { res = std::min(res, arg); };
@@ -1381,7 +1767,10 @@ namespace TiledArray {
 
     /// Maximum element
 
+    /// This is not defined for complex tensors.
     /// \return The maximum elements of this tensor
+    template <typename Numeric = numeric_type,
+        typename std::enable_if<! detail::is_complex<Numeric>::value>::type* = nullptr>
     numeric_type max() const {
       auto max_op = [] (numeric_type& MADNESS_RESTRICT res, const numeric_type arg)
               { res = std::max(res, arg); };
@@ -1390,24 +1779,25 @@ namespace TiledArray {
 
     /// Absolute minimum element
 
-    /// \return The minimum elements of this tensor
-    numeric_type abs_min() const {
-      auto abs_min_op = [] (numeric_type& MADNESS_RESTRICT res, const numeric_type arg)
-              { res = std::min(res, std::abs(arg)); };
-      auto min_op = [] (numeric_type& MADNESS_RESTRICT res, const numeric_type arg)
+    /// \return The minimum absolute value of the elements of this tensor
+    scalar_type abs_min() const {
+      auto abs_min_op = [] (scalar_type& MADNESS_RESTRICT res, const numeric_type arg)
+              { res = std::min(res, scalar_type(std::abs(arg))); };
+      auto min_op = [] (scalar_type& MADNESS_RESTRICT res, const scalar_type arg)
               { res = std::min(res, arg); };
-      return reduce(abs_min_op, min_op, std::numeric_limits<numeric_type>::max());
+      return detail::tensor_reduce(abs_min_op, min_op,
+          std::numeric_limits<scalar_type>::max(), *this);
     }
 
     /// Absolute maximum element
 
-    /// \return The maximum elements of this tensor
-    numeric_type abs_max() const {
-      auto abs_max_op = [] (numeric_type& MADNESS_RESTRICT res, const numeric_type arg)
-              { res = std::max(res, std::abs(arg)); };
-      auto max_op = [] (numeric_type& MADNESS_RESTRICT res, const numeric_type arg)
+    /// \return The maximum absolute value of the elements of this tensor
+    scalar_type abs_max() const {
+      auto abs_max_op = [] (scalar_type& MADNESS_RESTRICT res, const numeric_type arg)
+              { res = std::max(res, scalar_type(std::abs(arg))); };
+      auto max_op = [] (scalar_type& MADNESS_RESTRICT res, const scalar_type arg)
               { res = std::max(res, arg); };
-      return reduce(abs_max_op, max_op, numeric_type(0));
+      return detail::tensor_reduce(abs_max_op, max_op, scalar_type(0), *this);
     }
 
     /// Vector dot product
@@ -1418,14 +1808,49 @@ namespace TiledArray {
     template <typename Right,
         typename std::enable_if<is_tensor<Right>::value>::type* = nullptr>
     numeric_type dot(const Right& other) const {
-      auto mult_add_op = [] (numeric_type& res, const numeric_type l,
-                const numeric_t<Right> r)
-                { res += l * r; };
+      math::DotReduceOp<numeric_type> mult_add_op;
       auto add_op = [] (numeric_type& MADNESS_RESTRICT res, const numeric_type value)
             { res += value; };
       return reduce(other, mult_add_op, add_op, numeric_type(0));
     }
 
+    /// Statistics of the elements
+
+    /// The selected statistics are computed in one pass over the elements.
+    /// \param flags The selected statistics, a combination of
+    /// \c StatisticsFlags
+    /// \return The statistics of the elements of this tensor
+    template <typename Numeric = numeric_type,
+        typename std::enable_if<std::is_same<Numeric, T>::value>::type* = nullptr>
+    Statistics<numeric_type> statistics(const unsigned int flags) const {
+      Statistics<numeric_type> result(flags);
+      if(pimpl_)
+        result.accumulate(size(), data());
+      return result;
+    }
+
+    /// Statistics of the elements, and the dot product with a tensor
+
+    /// The selected statistics of this tensor and its dot product with
+    /// \c other are computed in one pass over the elements.
+    /// \tparam Right The right-hand tensor type
+    /// \param other The right-hand tensor of the dot product
+    /// \param flags The selected statistics, a combination of
+    /// \c StatisticsFlags
+    /// \return The statistics of the elements of this tensor
+    template <typename Right,
+        typename std::enable_if<is_contiguous_tensor<Right>::value &&
+            std::is_same<numeric_type, T>::value>::type* = nullptr>
+    Statistics<numeric_type>
+    statistics(const Right& other, const unsigned int flags) const {
+      TA_ASSERT(! empty());
+      TA_ASSERT(! other.empty());
+      TA_ASSERT(range() == other.range());
+      Statistics<numeric_type> result(flags);
+      result.accumulate(size(), data(), other.data());
+      return result;
+    }
+
   }; // class Tensor
 
   template <typename T, typename A>
@@ -1441,10 +1866,14 @@ namespace TiledArray {
   class Tensor<int, Eigen::aligned_allocator<int> >;
   extern template
   class Tensor<long, Eigen::aligned_allocator<long> >;
-//  extern template
-//  class Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >;
-//  extern template
-//  class Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >;
+  extern template
+  class Tensor<double, PoolAllocator<double> >;
+  extern template
+  class Tensor<float, PoolAllocator<float> >;
+  extern template
+  class Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > >;
+  extern template
+  class Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > >;
 
 #endif // TILEDARRAY_HEADER_ONLY
 
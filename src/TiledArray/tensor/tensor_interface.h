@@ -28,6 +28,8 @@
 
 #include <TiledArray/tensor/kernels.h>
 #include <TiledArray/tensor/complex.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <TiledArray/math/block_sparse_gemm.h>
 
 namespace Eigen {
 
@@ -975,6 +977,74 @@ namespace TiledArray {
         return reduce(other, mult_add_op, add_op, numeric_type(0));
       }
 
+      /// Contract this view with a tensor
+
+      /// Views that are uniformly strided matrices, as defined by
+      /// \c gemm_helper , are passed to *GEMM in place with their row stride as
+      /// the leading dimension; other views are copied into a contiguous
+      /// tensor first.
+      /// \tparam Right The right-hand tensor type
+      /// \tparam Scalar A scalar type
+      /// \param right The right-hand tensor or tensor view
+      /// \param factor The scaling factor
+      /// \param gemm_helper The *GEMM operation meta data
+      /// \return A new tensor which is the product of this view and \c right
+      template <typename Right, typename Scalar,
+          typename std::enable_if<is_tensor<Right>::value &&
+              detail::is_numeric<Scalar>::value>::type* = nullptr>
+      result_tensor gemm(const Right& right, const Scalar factor,
+          const math::GemmHelper& gemm_helper) const
+      {
+        typedef Tensor<value_type, Eigen::aligned_allocator<value_type> >
+            left_tensor;
+        typedef Tensor<numeric_t<Right>, Eigen::aligned_allocator<numeric_t<Right> > >
+            right_tensor;
+
+        // Check that the arguments are not empty and have the correct ranks
+        TA_ASSERT(! right.empty());
+        TA_ASSERT(range_.rank() == gemm_helper.left_rank());
+        TA_ASSERT(right.range().rank() == gemm_helper.right_rank());
+
+        // Check that the inner dimensions of left and right match
+        TA_ASSERT(gemm_helper.left_right_coformal(range_.extent_data(),
+            right.range().extent_data()));
+
+        result_tensor result(gemm_helper.make_result_range<Range>(range_,
+            right.range()));
+
+        // Compute gemm dimensions
+        integer m = 1, n = 1, k = 1;
+        gemm_helper.compute_matrix_sizes(m, n, k, range_, right.range());
+
+        // Copy the arguments that cannot be addressed with a leading dimension
+        left_tensor left_copy;
+        const value_type* left_data = data_ + range_.ordinal(
+            typename range_type::ordinal_type(0));
+        integer lda = gemm_helper.left_leading_dimension(range_);
+        if(lda == 0) {
+          left_copy = left_tensor(*this);
+          left_data = left_copy.data();
+          lda = (gemm_helper.left_op() == madness::cblas::NoTrans ? k : m);
+        }
+
+        right_tensor right_copy;
+        const numeric_t<Right>* right_data = right.data() + right.range().ordinal(
+            typename Right::range_type::ordinal_type(0));
+        integer ldb = gemm_helper.right_leading_dimension(right.range());
+        if(ldb == 0) {
+          right_copy = right_tensor(right);
+          right_data = right_copy.data();
+          ldb = (gemm_helper.right_op() == madness::cblas::NoTrans ? n : k);
+        }
+
+        if(! math::herk_product(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k,
+            factor, left_data, lda, right_data, ldb, numeric_type(0), result.data(), n))
+          math::block_sparse_gemm(gemm_helper.left_op(), gemm_helper.right_op(), m, n, k,
+              factor, left_data, lda, right_data, ldb, numeric_type(0), result.data(), n);
+
+        return result;
+      }
+
     }; // class TensorInterface
 
   } // namespace detail
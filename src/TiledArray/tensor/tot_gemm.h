@@ -0,0 +1,203 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tot_gemm.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_TOT_GEMM_H__INCLUDED
+#define TILEDARRAY_TENSOR_TOT_GEMM_H__INCLUDED
+
+#include <TiledArray/math/blas.h>
+#include <TiledArray/math/gemm_helper.h>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    // Contraction kernels for tensors of tensors. The outer tensors are
+    // contracted as m x k and k x n matrices, as with ordinary tensors, but
+    // the product of two elements is an operation on the inner tensors:
+    //
+    //   tot_gemm_mult      c(i,j) += alpha * sum_l a(i,l) .* b(l,j)
+    //   tot_gemm_contract  c(i,j) += alpha * sum_l gemm(a(i,l), b(l,j))
+    //
+    // Empty inner tensors are treated as zero.
+
+    /// Offset of outer matrix element (i,j) of an \c m x \c n matrix
+
+    /// \param op The operation applied to the matrix
+    /// \param i The row index of op(matrix)
+    /// \param j The column index of op(matrix)
+    /// \param m The number of rows of op(matrix)
+    /// \param n The number of columns of op(matrix)
+    /// \return The offset of element (i,j) in the matrix data
+    inline std::size_t tot_gemm_offset(const madness::cblas::CBLAS_TRANSPOSE op,
+        const integer i, const integer j, const integer m, const integer n)
+    {
+      return (op == madness::cblas::NoTrans ? i * n + j : j * m + i);
+    }
+
+    /// Contract tensors of tensors with a Hadamard product of the inner tensors
+
+    /// \tparam A The left-hand inner tensor type
+    /// \tparam B The right-hand inner tensor type
+    /// \tparam C The result inner tensor type
+    /// \tparam Alpha The scaling factor type
+    /// \param op_a The operation applied to the left-hand outer matrix
+    /// \param op_b The operation applied to the right-hand outer matrix
+    /// \param m The number of outer rows of op(a) and c
+    /// \param n The number of outer columns of op(b) and c
+    /// \param k The number of outer columns of op(a) and rows of op(b)
+    /// \param alpha The scaling factor
+    /// \param a The left-hand outer matrix
+    /// \param b The right-hand outer matrix
+    /// \param c The result outer matrix
+    template <typename A, typename B, typename C, typename Alpha>
+    void tot_gemm_mult(const madness::cblas::CBLAS_TRANSPOSE op_a,
+        const madness::cblas::CBLAS_TRANSPOSE op_b, const integer m,
+        const integer n, const integer k, const Alpha alpha,
+        const A* const a, const B* const b, C* const c)
+    {
+      for(integer i = 0; i < m; ++i) {
+        for(integer l = 0; l < k; ++l) {
+          const A& a_il = a[tot_gemm_offset(op_a, i, l, m, k)];
+          if(a_il.empty())
+            continue;
+          C* const c_i = c + i * n;
+          for(integer j = 0; j < n; ++j) {
+            const B& b_lj = b[tot_gemm_offset(op_b, l, j, k, n)];
+            if(b_lj.empty())
+              continue;
+            if(c_i[j].empty())
+              c_i[j] = a_il.mult(b_lj, alpha);
+            else
+              c_i[j].add_to(a_il.mult(b_lj, alpha));
+          }
+        }
+      }
+    }
+
+    /// Contract tensors of tensors with a contraction of the inner tensors
+
+    /// The inner products are batched: for each outer column \c l of op(a),
+    /// the inner tensors of row \c l of op(b) are packed side by side into one
+    /// contiguous panel, so that each inner tensor of \c a is contracted with
+    /// the whole row in a single GEMM. The panel is formed once and reused
+    /// for every outer row of \c a .
+    /// \tparam A The left-hand inner tensor type
+    /// \tparam B The right-hand inner tensor type
+    /// \tparam C The result inner tensor type
+    /// \tparam Alpha The scaling factor type
+    /// \param op_a The operation applied to the left-hand outer matrix
+    /// \param op_b The operation applied to the right-hand outer matrix
+    /// \param m The number of outer rows of op(a) and c
+    /// \param n The number of outer columns of op(b) and c
+    /// \param k The number of outer columns of op(a) and rows of op(b)
+    /// \param alpha The scaling factor
+    /// \param a The left-hand outer matrix
+    /// \param b The right-hand outer matrix
+    /// \param c The result outer matrix
+    /// \param inner_helper The contraction of the inner tensors, which must
+    /// not transpose the right-hand inner tensors
+    template <typename A, typename B, typename C, typename Alpha>
+    void tot_gemm_contract(const madness::cblas::CBLAS_TRANSPOSE op_a,
+        const madness::cblas::CBLAS_TRANSPOSE op_b, const integer m,
+        const integer n, const integer k, const Alpha alpha,
+        const A* const a, const B* const b, C* const c,
+        const math::GemmHelper& inner_helper)
+    {
+      TA_ASSERT(inner_helper.right_op() == madness::cblas::NoTrans);
+      typedef typename C::value_type value_type;
+      typedef typename C::range_type range_type;
+
+      std::vector<value_type> panel;
+      std::vector<value_type> work;
+      std::vector<integer> col_offset(n + 1);
+
+      for(integer l = 0; l < k; ++l) {
+
+        // Pack the inner tensors of row l of op(b) into a q x N panel
+        integer q = 0;
+        col_offset[0] = 0;
+        for(integer j = 0; j < n; ++j) {
+          const B& b_lj = b[tot_gemm_offset(op_b, l, j, k, n)];
+          integer r = 0;
+          if(! b_lj.empty()) {
+            const unsigned int inner_rank = inner_helper.num_contract_ranks();
+            q = 1;
+            for(unsigned int d = 0u; d < inner_rank; ++d)
+              q *= b_lj.range().extent_data()[d];
+            r = b_lj.size() / q;
+          }
+          col_offset[j + 1] = col_offset[j] + r;
+        }
+        const integer N = col_offset[n];
+        if(N == 0)
+          continue;
+
+        panel.assign(q * N, value_type(0));
+        for(integer j = 0; j < n; ++j) {
+          const B& b_lj = b[tot_gemm_offset(op_b, l, j, k, n)];
+          if(b_lj.empty())
+            continue;
+          const integer r = col_offset[j + 1] - col_offset[j];
+          for(integer row = 0; row < q; ++row)
+            std::copy_n(b_lj.data() + row * r, r, panel.data() + row * N + col_offset[j]);
+        }
+
+        // Contract each inner tensor of column l of op(a) with the panel
+        for(integer i = 0; i < m; ++i) {
+          const A& a_il = a[tot_gemm_offset(op_a, i, l, m, k)];
+          if(a_il.empty())
+            continue;
+          const integer p = a_il.size() / q;
+          work.resize(p * N);
+          const integer lda = (inner_helper.left_op() == madness::cblas::NoTrans ? q : p);
+          math::gemm(inner_helper.left_op(), madness::cblas::NoTrans, p, N, q,
+              value_type(alpha), a_il.data(), lda, panel.data(), N, value_type(0),
+              work.data(), N);
+
+          // Scatter the result into the inner tensors of row i of c
+          C* const c_i = c + i * n;
+          for(integer j = 0; j < n; ++j) {
+            const B& b_lj = b[tot_gemm_offset(op_b, l, j, k, n)];
+            if(b_lj.empty())
+              continue;
+            const integer r = col_offset[j + 1] - col_offset[j];
+            if(c_i[j].empty())
+              c_i[j] = C(inner_helper.make_result_range<range_type>(a_il.range(),
+                  b_lj.range()), value_type(0));
+            value_type* MADNESS_RESTRICT const c_ij = c_i[j].data();
+            for(integer row = 0; row < p; ++row) {
+              const value_type* MADNESS_RESTRICT const w = work.data() + row * N + col_offset[j];
+              for(integer col = 0; col < r; ++col)
+                c_ij[row * r + col] += w[col];
+            }
+          }
+        }
+      }
+    }
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_TOT_GEMM_H__INCLUDED
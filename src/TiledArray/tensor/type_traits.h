@@ -167,6 +167,15 @@ namespace TiledArray {
                                  && is_shifted<T2, Ts...>::value;
     };
 
+    // Test if copies of the tensor share its data (i.e. the tensor is a
+    // reference counted handle), so it can be held by value in a Tile.
+
+    template <typename T>
+    struct is_shallow_copy_tensor : public std::false_type { };
+
+    template <typename T, typename A>
+    struct is_shallow_copy_tensor<Tensor<T, A> > : public std::true_type { };
+
   }  // namespace detail
 } // namespace TiledArray
 
@@ -0,0 +1,556 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  wire_codec.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TENSOR_WIRE_CODEC_H__INCLUDED
+#define TILEDARRAY_TENSOR_WIRE_CODEC_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/type_traits.h>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <vector>
+
+namespace TiledArray {
+
+  // Forward declaration
+  template <typename, typename> class Tensor;
+
+  namespace detail {
+
+    /// Codec for tile data that is sent over the network
+
+    /// The codec is disabled by default, and tile data is sent as raw bytes.
+    /// When enabled, the bytes of the elements are shuffled so that byte
+    /// \c b of every element is stored together, and the shuffled bytes are
+    /// run-length encoded with PackBits. The sign and exponent bytes of the
+    /// elements of a tile usually repeat, and zero elements are removed
+    /// entirely. The lossy codec also drops the elements with a magnitude
+    /// less than a tolerance, which is usually set from the zero threshold of
+    /// \c SparseShape :
+    /// \code
+    /// TiledArray::detail::WireCodec::instance().enable_lossy(
+    ///     TiledArray::SparseShape<float>::threshold());
+    /// \endcode
+    /// The absolute error of each element is then less than the tolerance.
+    /// Data is sent raw when it is not compressed by the codec. The codec is
+    /// only applied to tiles that are wrapped in a \c WireTile , which is done
+    /// for SUMMA broadcasts and remote gets; other serialization of tiles,
+    /// e.g. checkpoints and spilled tiles, always stores the raw data. The
+    /// codec of the data is stored in the message, so the receiver does not
+    /// need to use the same codec or tolerance as the sender.
+    /// \note The codec must be enabled or disabled on all processes, and only
+    /// affects the evaluations that are started afterwards.
+    class WireCodec {
+    public:
+      /// Data encoding
+      typedef enum {
+        raw = 0, ///< Raw element bytes
+        lossless = 1, ///< Shuffled and run-length encoded element bytes
+        lossy = 2 ///< Lossless encoding of the elements above a tolerance
+      } codec_type;
+
+    private:
+
+      std::atomic<int> codec_; ///< The codec used for outgoing data
+      std::atomic<double> tolerance_; ///< The lossy codec tolerance
+
+      WireCodec() : codec_(raw), tolerance_(0.0) { }
+
+      WireCodec(const WireCodec&) = delete;
+      WireCodec& operator=(const WireCodec&) = delete;
+
+      /// Run-length encode bytes
+
+      /// Runs of 3 to 128 equal bytes are stored as a control byte
+      /// <tt>257 - n</tt> followed by the byte, and other bytes as a control
+      /// byte <tt>n - 1</tt> followed by \c n literal bytes.
+      /// \param first The first byte to be encoded
+      /// \param last The end of the bytes to be encoded
+      /// \param[out] result The encoded bytes
+      static void pack(const unsigned char* first, const unsigned char* const last,
+          std::vector<unsigned char>& result)
+      {
+        while(first != last) {
+          // Find the length of the run at first
+          const unsigned char* run = first + 1;
+          while((run != last) && (*run == *first) && ((run - first) < 128l))
+            ++run;
+
+          if((run - first) >= 3l) {
+            result.push_back(static_cast<unsigned char>(257l - (run - first)));
+            result.push_back(*first);
+            first = run;
+          } else {
+            // Copy literal bytes until the next run
+            const unsigned char* literal = first;
+            while((literal != last) && ((literal - first) < 128l)) {
+              if(((last - literal) >= 3l) && (literal[0] == literal[1])
+                  && (literal[0] == literal[2]))
+                break;
+              ++literal;
+            }
+            result.push_back(static_cast<unsigned char>((literal - first) - 1l));
+            result.insert(result.end(), first, literal);
+            first = literal;
+          }
+        }
+      }
+
+      /// Decode run-length encoded bytes
+
+      /// \param first The first encoded byte
+      /// \param last The end of the encoded bytes
+      /// \param[out] result The decoded bytes
+      /// \param n The number of decoded bytes
+      /// \return A pointer to the first byte after the decoded data
+      static const unsigned char* unpack(const unsigned char* first,
+          const unsigned char* const last, unsigned char* result, const std::size_t n)
+      {
+        unsigned char* const result_last = result + n;
+        while(result != result_last) {
+          TA_USER_ASSERT(first != last, "WireCodec: Truncated tile data.");
+          const unsigned int control = *first++;
+          if(control < 128u) {
+            const std::size_t size = control + 1u;
+            TA_USER_ASSERT((std::size_t(last - first) >= size) &&
+                (std::size_t(result_last - result) >= size),
+                "WireCodec: Invalid tile data.");
+            std::memcpy(result, first, size);
+            first += size;
+            result += size;
+          } else {
+            const std::size_t size = 257u - control;
+            TA_USER_ASSERT((first != last) && (std::size_t(result_last - result) >= size),
+                "WireCodec: Invalid tile data.");
+            std::memset(result, *first++, size);
+            result += size;
+          }
+        }
+        return first;
+      }
+
+      /// Shuffle and encode elements
+
+      /// \tparam T The element type
+      /// \param data The elements to be encoded
+      /// \param n The number of elements
+      /// \param[out] result The encoded bytes
+      template <typename T>
+      static void encode_lossless(const T* const data, const std::size_t n,
+          std::vector<unsigned char>& result)
+      {
+        const unsigned char* const bytes = reinterpret_cast<const unsigned char*>(data);
+        std::vector<unsigned char> shuffled(n * sizeof(T));
+        for(std::size_t b = 0ul; b < sizeof(T); ++b)
+          for(std::size_t i = 0ul; i < n; ++i)
+            shuffled[b * n + i] = bytes[i * sizeof(T) + b];
+        pack(shuffled.data(), shuffled.data() + shuffled.size(), result);
+      }
+
+      /// Decode and unshuffle elements
+
+      /// \tparam T The element type
+      /// \param first The first encoded byte
+      /// \param last The end of the encoded bytes
+      /// \param[out] data The decoded elements
+      /// \param n The number of elements
+      template <typename T>
+      static void decode_lossless(const unsigned char* first,
+          const unsigned char* const last, T* const data, const std::size_t n)
+      {
+        std::vector<unsigned char> shuffled(n * sizeof(T));
+        unpack(first, last, shuffled.data(), shuffled.size());
+        unsigned char* const bytes = reinterpret_cast<unsigned char*>(data);
+        for(std::size_t b = 0ul; b < sizeof(T); ++b)
+          for(std::size_t i = 0ul; i < n; ++i)
+            bytes[i * sizeof(T) + b] = shuffled[b * n + i];
+      }
+
+      /// Encode integer elements
+
+      /// Integer elements are never dropped, and are encoded without loss.
+      template <typename T>
+      static void encode_lossy(const T* const data, const std::size_t n,
+          const double, std::vector<unsigned char>& result, std::true_type)
+      {
+        encode_lossless(data, n, result);
+      }
+
+      /// Encode the elements above a tolerance
+
+      /// The encoded data is a bit mask of the elements that are sent,
+      /// followed by the lossless encoding of the sent elements.
+      /// \tparam T The element type
+      /// \param data The elements to be encoded
+      /// \param n The number of elements
+      /// \param tolerance Elements with a magnitude less than \c tolerance
+      /// are dropped
+      /// \param[out] result The encoded bytes
+      template <typename T>
+      static void encode_lossy(const T* const data, const std::size_t n,
+          const double tolerance, std::vector<unsigned char>& result, std::false_type)
+      {
+        std::vector<unsigned char> mask((n + 7ul) >> 3, 0u);
+        std::vector<T> values;
+        for(std::size_t i = 0ul; i < n; ++i) {
+          using std::abs;
+          if(! (abs(data[i]) < tolerance)) {
+            mask[i >> 3] |= (1u << (i & 7ul));
+            values.push_back(data[i]);
+          }
+        }
+        pack(mask.data(), mask.data() + mask.size(), result);
+        encode_lossless(values.data(), values.size(), result);
+      }
+
+      /// Decode integer elements
+      template <typename T>
+      static void decode_lossy(const unsigned char* first,
+          const unsigned char* const last, T* const data, const std::size_t n,
+          std::true_type)
+      {
+        decode_lossless(first, last, data, n);
+      }
+
+      /// Decode the elements above a tolerance
+
+      /// \tparam T The element type
+      /// \param first The first encoded byte
+      /// \param last The end of the encoded bytes
+      /// \param[out] data The decoded elements, where dropped elements are zero
+      /// \param n The number of elements
+      template <typename T>
+      static void decode_lossy(const unsigned char* first,
+          const unsigned char* const last, T* const data, const std::size_t n,
+          std::false_type)
+      {
+        std::vector<unsigned char> mask((n + 7ul) >> 3);
+        first = unpack(first, last, mask.data(), mask.size());
+        std::size_t m = 0ul;
+        for(std::size_t i = 0ul; i < n; ++i)
+          m += (mask[i >> 3] >> (i & 7ul)) & 1u;
+        std::vector<T> values(m);
+        decode_lossless(first, last, values.data(), m);
+        for(std::size_t i = 0ul, j = 0ul; i < n; ++i)
+          data[i] = (((mask[i >> 3] >> (i & 7ul)) & 1u) ? values[j++] : T(0));
+      }
+
+    public:
+
+      /// Codec accessor
+
+      /// \return A reference to the codec of this process
+      static WireCodec& instance() {
+        static WireCodec* const codec = new WireCodec();
+        return *codec;
+      }
+
+      /// Send tile data as raw bytes
+      void disable() { codec_ = raw; }
+
+      /// Compress tile data without loss
+      void enable_lossless() { codec_ = lossless; }
+
+      /// Compress tile data, and drop small elements
+
+      /// \param tolerance Elements with a magnitude less than \c tolerance
+      /// are sent as zero
+      void enable_lossy(const double tolerance) {
+        TA_USER_ASSERT(tolerance >= 0.0,
+            "WireCodec::enable_lossy(): The tolerance must be non-negative.");
+        tolerance_ = tolerance;
+        codec_ = lossy;
+      }
+
+      /// Codec accessor
+
+      /// \return The codec used for outgoing tile data
+      codec_type codec() const { return codec_type(codec_.load()); }
+
+      /// Codec status
+
+      /// \return \c true if outgoing tile data is encoded
+      bool enabled() const { return codec() != raw; }
+
+      /// Tolerance accessor
+
+      /// \return The tolerance of the lossy codec
+      double tolerance() const { return tolerance_; }
+
+      /// Encode elements
+
+      /// Integer elements are never dropped by the lossy codec.
+      /// \tparam T The element type
+      /// \param codec The codec
+      /// \param data The elements to be encoded
+      /// \param n The number of elements
+      /// \param tolerance The tolerance of the lossy codec
+      /// \return The encoded bytes
+      template <typename T>
+      static std::vector<unsigned char> encode(const codec_type codec,
+          const T* const data, const std::size_t n, const double tolerance)
+      {
+        std::vector<unsigned char> result;
+        switch(codec) {
+          case lossless:
+            encode_lossless(data, n, result);
+            break;
+          case lossy:
+            encode_lossy(data, n, tolerance, result, std::is_integral<T>());
+            break;
+          default:
+            result.resize(n * sizeof(T));
+            std::memcpy(result.data(), data, result.size());
+        }
+        return result;
+      }
+
+      /// Decode elements
+
+      /// \tparam T The element type
+      /// \param codec The codec of \c first
+      /// \param first The first encoded byte
+      /// \param last The end of the encoded bytes
+      /// \param[out] data The decoded elements
+      /// \param n The number of elements
+      template <typename T>
+      static void decode(const codec_type codec, const unsigned char* first,
+          const unsigned char* const last, T* const data, const std::size_t n)
+      {
+        switch(codec) {
+          case lossless:
+            decode_lossless(first, last, data, n);
+            break;
+          case lossy:
+            decode_lossy(first, last, data, n, std::is_integral<T>());
+            break;
+          case raw:
+            TA_USER_ASSERT(std::size_t(last - first) == n * sizeof(T),
+                "WireCodec: Invalid tile data.");
+            std::memcpy(data, first, n * sizeof(T));
+            break;
+          default:
+            TA_EXCEPTION("WireCodec: Unknown tile data codec.");
+        }
+      }
+
+    }; // class WireCodec
+
+    /// Wire tile check
+
+    /// \tparam T The tile type
+    template <typename T>
+    struct is_wire_tile : public std::false_type { };
+
+    /// Tensors of numbers are encoded by \c WireCodec
+    template <typename T, typename A>
+    struct is_wire_tile<Tensor<T, A> > :
+        public std::integral_constant<bool, std::is_arithmetic<T>::value ||
+            is_complex<T>::value>
+    { };
+
+    /// Vectors of tensors, i.e. coalesced tiles, are encoded tile by tile
+    template <typename T, typename A>
+    struct is_wire_tile<std::vector<T, A> > : public is_wire_tile<T> { };
+
+    /// A tile that is sent to another process
+
+    /// Tiles that are not encoded by \c WireCodec are serialized as is.
+    /// \tparam T The tile type
+    template <typename T, typename Enable = void>
+    class WireTile {
+      T tile_; ///< The tile
+
+    public:
+      WireTile() = default;
+
+      /// Wrap a tile
+
+      /// \param tile The tile to be sent
+      explicit WireTile(const T& tile) : tile_(tile) { }
+
+      /// Tile accessor
+
+      /// \return The tile
+      const T& tile() const { return tile_; }
+
+      /// Serialize the tile
+
+      /// \tparam Archive The archive type
+      /// \param ar The archive
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & tile_; }
+
+    }; // class WireTile
+
+    /// A tensor that is sent to another process
+
+    /// The elements of the tensor are encoded once, with the codec of this
+    /// process at the time the tensor is wrapped, so the size of the message
+    /// does not depend on when it is serialized.
+    /// \tparam T The element type
+    /// \tparam A The allocator type
+    template <typename T, typename A>
+    class WireTile<Tensor<T, A>,
+        typename std::enable_if<is_wire_tile<Tensor<T, A> >::value>::type>
+    {
+      typedef Tensor<T, A> tile_type; ///< The tile type
+
+      tile_type tile_; ///< The tile, which holds the elements when they are raw
+      WireCodec::codec_type codec_; ///< The codec of \c bytes_
+      std::vector<unsigned char> bytes_; ///< The encoded elements
+
+    public:
+      WireTile() : tile_(), codec_(WireCodec::raw), bytes_() { }
+
+      /// Wrap and encode a tensor
+
+      /// The elements are sent raw when they are not compressed by the codec.
+      /// \param tile The tensor to be sent
+      explicit WireTile(const tile_type& tile) :
+        tile_(tile), codec_(WireCodec::instance().codec()), bytes_()
+      {
+        if(tile_.empty() || (codec_ == WireCodec::raw)) {
+          codec_ = WireCodec::raw;
+          return;
+        }
+        bytes_ = WireCodec::encode(codec_, tile_.data(), tile_.size(),
+            WireCodec::instance().tolerance());
+        if(bytes_.size() >= (tile_.size() * sizeof(T))) {
+          codec_ = WireCodec::raw;
+          std::vector<unsigned char>().swap(bytes_);
+        }
+      }
+
+      /// Tile accessor
+
+      /// \return The tensor
+      const tile_type& tile() const { return tile_; }
+
+      /// Output serialization function
+
+      /// \tparam Archive The output archive type
+      /// \param[out] ar The output archive
+      template <typename Archive,
+          typename std::enable_if<
+            madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
+      void serialize(Archive& ar) {
+        ar & static_cast<unsigned char>(codec_);
+        if(codec_ == WireCodec::raw)
+          ar & tile_;
+        else
+          ar & tile_.range() & bytes_;
+      }
+
+      /// Input serialization function
+
+      /// \tparam Archive The input archive type
+      /// \param[in] ar The input archive
+      template <typename Archive,
+          typename std::enable_if<
+            madness::archive::is_input_archive<Archive>::value>::type* = nullptr>
+      void serialize(Archive& ar) {
+        unsigned char codec = WireCodec::raw;
+        ar & codec;
+        codec_ = WireCodec::codec_type(codec);
+        if(codec_ == WireCodec::raw) {
+          ar & tile_;
+        } else {
+          typename tile_type::range_type range;
+          ar & range & bytes_;
+          tile_ = tile_type(range);
+          WireCodec::decode(codec_, bytes_.data(), bytes_.data() + bytes_.size(),
+              tile_.data(), tile_.size());
+          std::vector<unsigned char>().swap(bytes_);
+        }
+      }
+
+    }; // class WireTile
+
+    /// Tiles that are sent together to another process
+
+    /// \tparam T The tile type
+    /// \tparam A The allocator type
+    template <typename T, typename A>
+    class WireTile<std::vector<T, A>,
+        typename std::enable_if<is_wire_tile<std::vector<T, A> >::value>::type>
+    {
+      std::vector<WireTile<T> > tiles_; ///< The wrapped tiles
+
+    public:
+      WireTile() = default;
+
+      /// Wrap and encode tiles
+
+      /// \param tiles The tiles to be sent
+      explicit WireTile(const std::vector<T, A>& tiles) : tiles_() {
+        tiles_.reserve(tiles.size());
+        for(const auto& tile : tiles)
+          tiles_.emplace_back(tile);
+      }
+
+      /// Tile accessor
+
+      /// \return The tiles
+      std::vector<T, A> tile() const {
+        std::vector<T, A> result;
+        result.reserve(tiles_.size());
+        for(const auto& tile : tiles_)
+          result.push_back(tile.tile());
+        return result;
+      }
+
+      /// Serialize the tiles
+
+      /// \tparam Archive The archive type
+      /// \param ar The archive
+      template <typename Archive>
+      void serialize(Archive& ar) { ar & tiles_; }
+
+    }; // class WireTile
+
+    /// Wrap a tile that is sent to another process
+
+    /// \tparam T The tile type
+    /// \param tile The tile
+    /// \return The wrapped tile
+    template <typename T>
+    WireTile<T> wire_pack(const T& tile) { return WireTile<T>(tile); }
+
+    /// Unwrap a tile that was received from another process
+
+    /// \tparam T The tile type
+    /// \param wire The wrapped tile
+    /// \return The tile
+    template <typename T>
+    T wire_unpack(const WireTile<T>& wire) { return wire.tile(); }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TENSOR_WIRE_CODEC_H__INCLUDED
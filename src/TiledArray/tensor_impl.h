@@ -48,7 +48,7 @@ namespace TiledArray {
     private:
       World& world_; ///< World that contains
       const trange_type trange_; ///< Tiled range type
-      const shape_type shape_; ///< Tensor shape
+      shape_type shape_; ///< Tensor shape
       std::shared_ptr<pmap_interface> pmap_; ///< Process map for tiles
 
     public:
@@ -159,6 +159,20 @@ namespace TiledArray {
       /// \return The tiled range of the tensor
       const trange_type& trange() const { return trange_; }
 
+    protected:
+
+      /// Replace the tensor shape
+
+      /// \param shape The new shape of this tensor
+      /// \note This must be called collectively with the same \c shape on all
+      /// processes, when no other operation is accessing this tensor.
+      void set_shape(const shape_type& shape) {
+        TA_ASSERT(shape.validate(trange_.tiles_range()));
+        shape_ = shape;
+      }
+
+    public:
+
       /// \deprecated use TensorImpl::world()
       DEPRECATED World& get_world() const { return world_; }
 
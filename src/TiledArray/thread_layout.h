@@ -0,0 +1,273 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  thread_layout.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_THREAD_LAYOUT_H__INCLUDED
+#define TILEDARRAY_THREAD_LAYOUT_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Thread layout options of \c initialize()
+
+  /// The options are applied through the MADNESS environment variables
+  /// \c MAD_NUM_THREADS and \c MAD_BIND before the runtime is started, so
+  /// they take precedence over values set in the environment.
+  struct ThreadLayoutOptions {
+    int compute_threads = 0; ///< The number of compute threads, or zero for
+                             ///< the MADNESS default (all cores of this rank
+                             ///< when threads are bound)
+    bool bind = false; ///< Bind the threads of this process to cores
+    bool comm_core = true; ///< When binding, reserve a core for the
+                           ///< communication thread, so it does not compete
+                           ///< with compute tasks
+    bool numa = false; ///< When binding, place the threads of each rank on a
+                       ///< node in the cores of one NUMA domain
+    bool report = false; ///< Print the layout of each process
+  }; // struct ThreadLayoutOptions
+
+  /// The thread layout of this process
+  struct ThreadLayout {
+    int compute_threads = -1; ///< The number of compute threads, or -1 if unknown
+    int main_cpu = -1; ///< The core of the main thread, or -1 if not bound
+    int comm_cpu = -1; ///< The core of the communication thread, or -1 if not bound
+    int first_compute_cpu = -1; ///< The core of the first compute thread, or
+                                ///< -1 if not bound; compute threads are
+                                ///< bound to consecutive cores
+    int numa_domain = -1; ///< The NUMA domain of the threads, or -1 if not used
+    int local_rank = 0; ///< The rank of this process on its node
+    int local_size = 1; ///< The number of processes on the node
+
+    /// Print the layout
+
+    /// \param os The output stream
+    /// \param rank The rank of this process
+    void print(std::ostream& os, const int rank) const {
+      os << "TiledArray: rank " << rank << " (local " << local_rank << "/"
+         << local_size << "): " << compute_threads << " compute threads";
+      if(main_cpu >= 0) {
+        os << ", main thread on core " << main_cpu
+           << ", communication thread on core " << comm_cpu
+           << ", compute threads on cores " << first_compute_cpu;
+        if(compute_threads > 1)
+          os << "-" << (first_compute_cpu + compute_threads - 1);
+      } else {
+        os << ", not bound";
+      }
+      if(numa_domain >= 0)
+        os << ", NUMA domain " << numa_domain;
+      os << "\n";
+    }
+  }; // struct ThreadLayout
+
+  namespace detail {
+
+    /// Parse a Linux CPU list
+
+    /// \param list A list of cores, e.g. <tt>"0-3,8,10-11"</tt>
+    /// \return The cores in \c list
+    inline std::vector<int> parse_cpulist(const std::string& list) {
+      std::vector<int> result;
+      std::stringstream ss(list);
+      std::string item;
+      while(std::getline(ss, item, ',')) {
+        if(item.find_first_of("0123456789") == std::string::npos)
+          continue;
+        const std::size_t dash = item.find('-');
+        const int first = std::atoi(item.substr(0, dash).c_str());
+        const int last = (dash == std::string::npos ? first :
+            std::atoi(item.substr(dash + 1).c_str()));
+        for(int cpu = first; cpu <= last; ++cpu)
+          result.push_back(cpu);
+      }
+      return result;
+    }
+
+    /// The cores of each NUMA domain of this node
+
+    /// The domains are read from \c /sys/devices/system/node . If they are
+    /// not available, all cores are in one domain.
+    /// \return The cores of each NUMA domain
+    inline std::vector<std::vector<int> > numa_domains() {
+      std::vector<std::vector<int> > result;
+      for(int node = 0; ; ++node) {
+        std::ifstream file("/sys/devices/system/node/node" +
+            std::to_string(node) + "/cpulist");
+        if(! file)
+          break;
+        std::string list;
+        std::getline(file, list);
+        std::vector<int> cpus = parse_cpulist(list);
+        if(! cpus.empty())
+          result.push_back(std::move(cpus));
+      }
+
+      if(result.empty()) {
+        const int n = std::max(1u, std::thread::hardware_concurrency());
+        result.emplace_back(n);
+        for(int cpu = 0; cpu < n; ++cpu)
+          result.back()[cpu] = cpu;
+      }
+      return result;
+    }
+
+    /// The rank and number of processes on this node, from the launcher
+
+    /// MPI is not initialized when the layout is chosen, so the local rank
+    /// is taken from the environment of Open MPI, MPICH, or Slurm.
+    /// \return The local rank and the number of local processes, or
+    /// <tt>(0, 1)</tt> if they are not known
+    inline std::pair<int, int> launcher_local_rank() {
+      const char* const vars[][2] = {
+          { "OMPI_COMM_WORLD_LOCAL_RANK", "OMPI_COMM_WORLD_LOCAL_SIZE" },
+          { "MPI_LOCALRANKID", "MPI_LOCALNRANKS" },
+          { "SLURM_LOCALID", "SLURM_NTASKS_PER_NODE" } };
+      for(const auto& var : vars) {
+        const char* const rank = getenv(var[0]);
+        const char* const size = getenv(var[1]);
+        if(rank && size && (std::atoi(rank) >= 0) &&
+            (std::atoi(rank) < std::atoi(size)))
+          return std::make_pair(std::atoi(rank), std::atoi(size));
+      }
+      return std::make_pair(0, 1);
+    }
+
+    /// Choose the thread layout of a process
+
+    /// The cores of the node are divided into contiguous blocks, one per
+    /// local rank; with \c numa , the ranks are first divided among the NUMA
+    /// domains, so the block of each rank is in one domain. The main thread
+    /// is bound to the first core of the block, the communication thread to
+    /// the second core (or with the main thread if \c comm_core is \c false ),
+    /// and the compute threads to the following consecutive cores.
+    /// \param options The layout options
+    /// \param domains The cores of each NUMA domain of the node
+    /// \param local_rank The rank of this process on the node
+    /// \param local_size The number of processes on the node
+    /// \return The thread layout of this process
+    inline ThreadLayout make_thread_layout(const ThreadLayoutOptions& options,
+        const std::vector<std::vector<int> >& domains, const int local_rank,
+        const int local_size)
+    {
+      TA_ASSERT(! domains.empty());
+      TA_ASSERT((local_rank >= 0) && (local_rank < local_size));
+
+      ThreadLayout layout;
+      layout.local_rank = local_rank;
+      layout.local_size = local_size;
+      layout.compute_threads = (options.compute_threads > 0 ?
+          options.compute_threads : -1);
+      if(! options.bind)
+        return layout;
+
+      // Select the cores of this rank, and its position among the ranks that
+      // share them
+      std::vector<int> cpus;
+      int rank = local_rank, ranks = local_size;
+      if(options.numa && (domains.size() > 1ul)) {
+        const int n = domains.size();
+        const int domain = (local_rank * n) / local_size;
+        const int first_rank = (domain * local_size + n - 1) / n;
+        const int last_rank = ((domain + 1) * local_size + n - 1) / n;
+        cpus = domains[domain];
+        rank = local_rank - first_rank;
+        ranks = std::max(1, last_rank - first_rank);
+        layout.numa_domain = domain;
+      } else {
+        for(const auto& domain : domains)
+          cpus.insert(cpus.end(), domain.begin(), domain.end());
+        std::sort(cpus.begin(), cpus.end());
+      }
+
+      // The block of cores of this rank
+      const std::size_t first = (rank * cpus.size()) / ranks;
+      const std::size_t last = std::max(first + 1ul,
+          ((rank + 1) * cpus.size()) / ranks);
+      std::vector<int> block(cpus.begin() + std::min(first, cpus.size() - 1ul),
+          cpus.begin() + std::min(last, cpus.size()));
+
+      layout.main_cpu = block[0];
+      std::size_t next = 1ul;
+      if(options.comm_core && (block.size() > 2ul))
+        layout.comm_cpu = block[next++];
+      else
+        layout.comm_cpu = block[0];
+      if(next >= block.size())
+        next = block.size() - 1ul;
+      layout.first_compute_cpu = block[next];
+
+      // Compute threads are bound to consecutive cores
+      int available = 1;
+      while((next + available < block.size()) &&
+          (block[next + available] == block[next] + available))
+        ++available;
+      if(layout.compute_threads < 0)
+        layout.compute_threads = available;
+
+      return layout;
+    }
+
+    /// Apply a thread layout to the MADNESS runtime
+
+    /// \param layout The thread layout
+    /// \note This must be called before the MADNESS runtime is initialized.
+    inline void apply_thread_layout(const ThreadLayout& layout) {
+      // MAD_NUM_THREADS includes the main thread
+      if(layout.compute_threads > 0)
+        setenv("MAD_NUM_THREADS",
+            std::to_string(layout.compute_threads + 1).c_str(), 1);
+      if(layout.main_cpu >= 0) {
+        const std::string bind = std::to_string(layout.main_cpu) + " " +
+            std::to_string(layout.comm_cpu) + " " +
+            std::to_string(layout.first_compute_cpu);
+        setenv("MAD_BIND", bind.c_str(), 1);
+      }
+    }
+
+    /// The thread layout of this process
+    inline ThreadLayout& thread_layout() {
+      static ThreadLayout layout;
+      return layout;
+    }
+
+  } // namespace detail
+
+  /// Thread layout accessor
+
+  /// \return The thread layout chosen by \c initialize()
+  inline const ThreadLayout& thread_layout() { return detail::thread_layout(); }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_THREAD_LAYOUT_H__INCLUDED
@@ -21,6 +21,7 @@
 #define TILEDARRAY_TILE_H__INCLUDED
 
 #include <TiledArray/tile_op/tile_interface.h>
+#include <TiledArray/tensor/type_traits.h>
 #include <memory>
 
 // Forward declaration of MADNESS archive type traits
@@ -35,6 +36,66 @@ namespace madness {
 
 namespace TiledArray {
 
+  namespace detail {
+
+    /// Tile data storage
+
+    /// The tensor is held by a shared pointer so that copies of a tile share
+    /// the same tensor object.
+    /// \tparam T The tensor type
+    template <typename T, typename Enable = void>
+    class TileStorage {
+      std::shared_ptr<T> pimpl_;
+
+    public:
+
+      /// Construct the tensor from \c args
+      template <typename... Args>
+      void emplace(Args&&... args) {
+        pimpl_ = std::make_shared<T>(std::forward<Args>(args)...);
+      }
+
+      void reset() { pimpl_.reset(); }
+
+      bool empty() const { return not bool(pimpl_); }
+
+      T& get() { return *pimpl_; }
+
+      const T& get() const { return *pimpl_; }
+
+    }; // class TileStorage
+
+    /// Tile data storage for shallow copy tensors
+
+    /// Copies of a shallow copy tensor (e.g. \c Tensor ) already share its
+    /// data, so the tensor is held by value. This avoids a second pointer
+    /// indirection and reference count on every tile access and copy. A tile
+    /// that holds an empty tensor is empty.
+    /// \tparam T The tensor type
+    template <typename T>
+    class TileStorage<T, typename std::enable_if<is_shallow_copy_tensor<T>::value>::type> {
+      T tensor_;
+
+    public:
+
+      /// Construct the tensor from \c args
+      template <typename... Args>
+      void emplace(Args&&... args) {
+        tensor_ = T(std::forward<Args>(args)...);
+      }
+
+      void reset() { tensor_ = T(); }
+
+      bool empty() const { return tensor_.empty(); }
+
+      T& get() { return tensor_; }
+
+      const T& get() const { return tensor_; }
+
+    }; // class TileStorage
+
+  }  // namespace detail
+
 
   /**
    * \defgroup TileInterface Tile interface for user defined tensor types
@@ -74,6 +135,11 @@ namespace TiledArray {
   /// as for the intrusive or non-instrusive interface. See the
   /// \ref NonIntrusiveTileInterface "non-intrusive tile interface"
   /// documentation for more details.
+  /// Tensor types whose copies already share data (see
+  /// \c detail::is_shallow_copy_tensor ) are held directly, otherwise the
+  /// tensor is held by a shared pointer. In the former case, copies of a tile
+  /// share the tensor data, but assigning a new tensor to one tile does not
+  /// change its copies.
   /// \tparam T The tensor type used to represent tile data
   template <typename T>
   class Tile {
@@ -85,7 +151,7 @@ namespace TiledArray {
 
   private:
 
-    std::shared_ptr<tensor_type> pimpl_;
+    detail::TileStorage<tensor_type> pimpl_;
 
   public:
 
@@ -107,16 +173,15 @@ namespace TiledArray {
         not std::is_convertible<Arg,Tile_>::value
       >::type
     >
-    explicit Tile(Arg&& arg) :
-      pimpl_(std::make_shared<tensor_type>(std::forward<Arg>(arg)))
-    { }
+    explicit Tile(Arg&& arg) : pimpl_() {
+      pimpl_.emplace(std::forward<Arg>(arg));
+    }
 
     template <typename Arg1, typename Arg2, typename ... Args>
-    Tile(Arg1&& arg1, Arg2&& arg2, Args&&... args) :
-      pimpl_(std::make_shared<tensor_type>(std::forward<Arg1>(arg1),
-                                           std::forward<Arg2>(arg2),
-                                           std::forward<Args>(args)...))
-    { }
+    Tile(Arg1&& arg1, Arg2&& arg2, Args&&... args) : pimpl_() {
+      pimpl_.emplace(std::forward<Arg1>(arg1), std::forward<Arg2>(arg2),
+          std::forward<Args>(args)...);
+    }
 
     ~Tile() = default;
 
@@ -126,12 +191,12 @@ namespace TiledArray {
     Tile_& operator=(const Tile_&) = default;
 
     Tile_& operator=(const tensor_type& tensor) {
-      *pimpl_ = tensor;
+      pimpl_.get() = tensor;
       return *this;
     }
 
     Tile_& operator=(tensor_type&& tensor) {
-      *pimpl_ = std::move(tensor);
+      pimpl_.get() = std::move(tensor);
       return *this;
     }
 
@@ -139,14 +204,14 @@ namespace TiledArray {
     // State accessor ----------------------------------------------------------
 
     bool empty() const {
-      return not bool(pimpl_);
+      return pimpl_.empty();
     }
 
     // Tile accessor -----------------------------------------------------------
 
-    tensor_type& tensor() { return *pimpl_; }
+    tensor_type& tensor() { return pimpl_.get(); }
 
-    const tensor_type& tensor() const { return *pimpl_; }
+    const tensor_type& tensor() const { return pimpl_.get(); }
 
 
     // Iterator accessor -------------------------------------------------------
@@ -232,11 +297,11 @@ namespace TiledArray {
         typename std::enable_if<madness::archive::is_output_archive<Archive>::value>::type* = nullptr>
     void serialize(Archive &ar) const {
       // Serialize data for empty tile check
-      bool empty = !static_cast<bool>(pimpl_);
+      bool empty = pimpl_.empty();
       ar & empty;
       if (!empty) {
         // Serialize tile data
-        ar & *pimpl_;
+        ar & pimpl_.get();
       }
     }
 
@@ -253,7 +318,7 @@ namespace TiledArray {
         ar & tensor;
 
         // construct a new pimpl
-        pimpl_ = std::make_shared<T>(std::move(tensor));
+        pimpl_.emplace(std::move(tensor));
       } else {
         // Set pimpl to an empty tile
         pimpl_.reset();
@@ -291,6 +356,16 @@ namespace TiledArray {
     return Tile<Arg>(clone(arg.tensor()));
   }
 
+  /// Create a copy-on-write copy of \c arg
+
+  /// \tparam Arg The tile argument type
+  /// \param arg The tile argument to be copied
+  /// \return A lazy copy of \c arg
+  template <typename Arg>
+  inline Tile<Arg> lazy_clone(const Tile<Arg>& arg) {
+    return Tile<Arg>(lazy_clone(arg.tensor()));
+  }
+
 
   // Empty operations ----------------------------------------------------------
 
@@ -335,6 +410,30 @@ namespace TiledArray {
       Tile<decltype(shift(arg.tensor(), range_shift))>
   { return detail::make_tile(shift(arg.tensor(), range_shift)); }
 
+  /// Shift the range of a view of \c arg
+
+  /// \tparam Arg The tensor argument type
+  /// \tparam Index An array type
+  /// \param arg The tile argument to be shifted
+  /// \param range_shift The offset to be applied to the argument range
+  /// \return A shallow copy of the tile with a new range
+  template <typename Arg, typename Index>
+  inline auto shift_view(const Tile<Arg>& arg, const Index& range_shift) ->
+      Tile<decltype(shift_view(arg.tensor(), range_shift))>
+  { return detail::make_tile(shift_view(arg.tensor(), range_shift)); }
+
+  /// Reshape a view of \c arg
+
+  /// \tparam Arg The tensor argument type
+  /// \tparam Range The range type
+  /// \param arg The tile argument to be reshaped
+  /// \param range The range of the result
+  /// \return A shallow copy of the tile with range \c range
+  template <typename Arg, typename Range>
+  inline auto reshape_view(const Tile<Arg>& arg, const Range& range) ->
+      Tile<decltype(reshape_view(arg.tensor(), range))>
+  { return detail::make_tile(reshape_view(arg.tensor(), range)); }
+
   /// Shift the range of \c arg in place
 
   /// \tparam Arg The tensor argument type
@@ -0,0 +1,300 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_accumulator.h
+ *  Oct 15, 2016
+ *
+ */
+
+
+#ifndef TILEDARRAY_TILE_ACCUMULATOR_H__INCLUDED
+#define TILEDARRAY_TILE_ACCUMULATOR_H__INCLUDED
+
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/reduce_task.h>
+#include <map>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Reduction operation that sums tiles
+
+    /// The first tile of a reduction is taken as the result without a copy,
+    /// so the argument tiles must not be referenced elsewhere.
+    /// \tparam Tile The tile type
+    template <typename Tile>
+    class TileSumOp {
+    public:
+      typedef Tile result_type; ///< The result type
+      typedef Tile argument_type; ///< The argument type
+
+      /// \return An empty tile
+      result_type operator()() const { return result_type(); }
+
+      /// \return \c result
+      const result_type& operator()(const result_type& result) const {
+        return result;
+      }
+
+      /// Add a tile to the result
+      void operator()(result_type& result, const argument_type& arg) const {
+        if(result.empty())
+          result = arg;
+        else
+          add_to(result, arg);
+      }
+    }; // class TileSumOp
+
+  } // namespace detail
+
+  /// Accumulate contributions to the tiles of a distributed array
+
+  /// Integral and Fock builds produce contributions to arbitrary tiles on
+  /// arbitrary processes, which cannot be written with \c DistArray::set ,
+  /// since a tile can only be set once. A \c TileAccumulator gives
+  /// "scatter-add" semantics: any thread of any process adds contributions
+  /// to any tile with \c add() , and \c array() builds the array of the sums.
+  /// The contributions to a tile are first summed locally, with a lock per
+  /// tile, so a process holds at most one partial sum of each tile. When
+  /// \c array() is called, the partial sums are sent to the tile owners in
+  /// messages of about \c max_batch_bytes() bytes, and the owners sum them
+  /// with a \c ReduceTask per tile as they arrive. One fence waits for all
+  /// partial sums to be delivered.
+  /// \code
+  /// TiledArray::TileAccumulator<TiledArray::TSpArrayD> fock(world, trange);
+  /// // ... in tasks on any process
+  /// fock.add({i, j}, contribution);
+  /// // ... once all tasks that add contributions are complete
+  /// TiledArray::TSpArrayD f = fock.array();
+  /// \endcode
+  /// Tiles without contributions are zero; the shape of a sparse array is
+  /// computed from the norms of the sums.
+  /// \tparam Array The \c DistArray type
+  template <typename Array>
+  class TileAccumulator :
+      public madness::WorldObject<TileAccumulator<Array> >,
+      private madness::Spinlock
+  {
+  public:
+    typedef TileAccumulator<Array> TileAccumulator_; ///< This object type
+    typedef madness::WorldObject<TileAccumulator_> WorldObject_; ///< Base object type
+    typedef typename Array::value_type value_type; ///< The tile type
+    typedef typename Array::size_type size_type; ///< Size type
+    typedef typename Array::pmap_interface pmap_interface; ///< Process map type
+
+  private:
+    typedef madness::ConcurrentHashMap<size_type, value_type> container_type;
+    typedef detail::TileSumOp<value_type> op_type;
+
+    /// Partial sums that are sent to one owner
+    struct Batch {
+      std::vector<size_type> indices; ///< Tile ordinals
+      std::vector<value_type> tiles; ///< Partial sums
+      std::size_t bytes = 0ul; ///< The size of the partial sums in bytes
+    }; // struct Batch
+
+    const TiledRange trange_; ///< The tiled range of the array
+    std::shared_ptr<pmap_interface> pmap_; ///< The process map of the array
+    container_type partials_; ///< The partial sums of this process
+    std::map<size_type, ReduceTask<op_type> > reducers_; ///< The reductions
+                                                          ///< of the local tiles
+    bool done_; ///< \c true when the array has been built
+
+    TileAccumulator(const TileAccumulator_&) = delete;
+    TileAccumulator_& operator=(const TileAccumulator_&) = delete;
+
+    /// \return \c true when \c block is included in \c range
+    static bool is_block(const Range& range, const Range& block) {
+      if(range.rank() != block.rank())
+        return false;
+      for(unsigned int i = 0u; i < range.rank(); ++i)
+        if((block.lobound_data()[i] < range.lobound_data()[i]) ||
+            (block.upbound_data()[i] > range.upbound_data()[i]))
+          return false;
+      return true;
+    }
+
+    /// Add partial sums to the reductions of local tiles
+    void reduce(const std::vector<size_type>& indices,
+        const std::vector<value_type>& tiles)
+    {
+      TA_ASSERT(indices.size() == tiles.size());
+      lock(); // <<< Begin critical section
+      for(size_type j = 0ul; j < indices.size(); ++j) {
+        auto it = reducers_.find(indices[j]);
+        if(it == reducers_.end())
+          it = reducers_.emplace(indices[j],
+              ReduceTask<op_type>(WorldObject_::get_world(), op_type())).first;
+        it->second.add(tiles[j]);
+      }
+      unlock(); // <<< End critical section
+    }
+
+    /// Send a batch to its owner, and clear it
+    void flush(const ProcessID proc, Batch& batch) {
+      if(batch.indices.empty())
+        return;
+      if(proc == WorldObject_::get_world().rank())
+        reduce(batch.indices, batch.tiles);
+      else
+        WorldObject_::task(proc, & TileAccumulator_::reduce, batch.indices,
+            batch.tiles, madness::TaskAttributes::hipri());
+      batch.indices.clear();
+      batch.tiles.clear();
+      batch.bytes = 0ul;
+    }
+
+  public:
+
+    /// \return The size of the partial sums, in bytes, above which a batch
+    /// is sent to its owner
+    static constexpr std::size_t max_batch_bytes() { return 1ul << 20; }
+
+    /// Constructor
+
+    /// This is a collective operation.
+    /// \param world The world where the array will live
+    /// \param trange The tiled range of the array
+    /// \param pmap The process map of the array [default = the default
+    /// process map of the array policy]
+    TileAccumulator(World& world, const TiledRange& trange,
+        std::shared_ptr<pmap_interface> pmap = std::shared_ptr<pmap_interface>()) :
+      WorldObject_(world), madness::Spinlock(), trange_(trange),
+      pmap_(pmap ? pmap : detail::policy_t<Array>::default_pmap(world,
+          trange.tiles_range().volume())),
+      partials_(), reducers_(), done_(false)
+    {
+      TA_USER_ASSERT(pmap_->size() == trange_.tiles_range().volume(),
+          "TileAccumulator: The process map does not match the tiled range.");
+      WorldObject_::process_pending();
+    }
+
+    virtual ~TileAccumulator() { }
+
+    /// \return The tiled range of the array
+    const TiledRange& trange() const { return trange_; }
+
+    /// Add a contribution to a tile
+
+    /// The contribution is added to the partial sum of the tile on this
+    /// process. It may be a whole tile or a sub-block of a tile, i.e. its
+    /// range is included in the range of the tile. This function is thread
+    /// safe, and contributions to different tiles are added concurrently.
+    /// \tparam Index An index or ordinal type
+    /// \param i The index of the tile
+    /// \param contribution The contribution, which is not modified
+    /// \throw TiledArray::Exception When \c i is not in the tiled range, or
+    /// the range of \c contribution is not included in the range of the
+    /// tile, or the array has been built.
+    template <typename Index>
+    void add(const Index& i, const value_type& contribution) {
+      TA_USER_ASSERT(! done_,
+          "TileAccumulator::add(): The array has been built.");
+      TA_USER_ASSERT(trange_.tiles_range().includes(i),
+          "TileAccumulator::add(): The tile index is not in the tiled range.");
+      const size_type ord = trange_.tiles_range().ordinal(i);
+      const Range range = trange_.make_tile_range(ord);
+      const bool whole = (contribution.range() == range);
+      TA_USER_ASSERT(whole || is_block(range, contribution.range()),
+          "TileAccumulator::add(): The contribution is not in the range of the tile.");
+
+      typename container_type::accessor acc;
+      if(partials_.insert(acc, ord)) {
+        if(whole) {
+          acc->second = contribution.clone();
+          return;
+        }
+        acc->second = value_type(range, typename value_type::value_type(0));
+      }
+      if(whole)
+        add_to(acc->second, contribution);
+      else
+        acc->second.block(contribution.range().lobound(),
+            contribution.range().upbound()).add_to(contribution);
+    }
+
+    /// Add a contribution to a tile
+
+    /// \tparam Integer An integer type
+    /// \param i The index of the tile
+    /// \param contribution The contribution
+    template <typename Integer>
+    void add(const std::initializer_list<Integer>& i, const value_type& contribution) {
+      add<std::initializer_list<Integer> >(i, contribution);
+    }
+
+    /// Build the array of the sums
+
+    /// The partial sums of this process are sent to the tile owners, and
+    /// the owners build their tiles once all partial sums have arrived. This
+    /// is a collective operation, and the tasks that add contributions must
+    /// be complete on all processes. It may be called once.
+    /// \return The array of the sums of the contributions
+    Array array() {
+      TA_USER_ASSERT(! done_,
+          "TileAccumulator::array(): The array has been built.");
+      done_ = true;
+      World& world = WorldObject_::get_world();
+
+      // Send the partial sums to the owners
+      std::map<ProcessID, Batch> batches;
+      for(auto& partial : partials_) {
+        const ProcessID proc = pmap_->owner(partial.first);
+        Batch& batch = batches[proc];
+        batch.indices.push_back(partial.first);
+        batch.bytes += partial.second.size() * sizeof(typename value_type::value_type);
+        batch.tiles.push_back(std::move(partial.second));
+        if(batch.bytes >= max_batch_bytes())
+          flush(proc, batch);
+      }
+      for(auto& batch : batches)
+        flush(batch.first, batch.second);
+      partials_.clear();
+
+      // Wait for all partial sums to arrive
+      world.gop.fence();
+
+      // Sum the partial sums of the local tiles
+      std::vector<std::pair<size_type, Future<value_type> > > sums;
+      for(auto& reducer : reducers_)
+        sums.emplace_back(reducer.first, reducer.second.submit());
+      reducers_.clear();
+
+      std::vector<std::pair<std::size_t, value_type> > tiles;
+      tiles.reserve(sums.size());
+      auto it = sums.begin();
+      for(const auto index : *pmap_) {
+        while((it != sums.end()) && (it->first < index))
+          ++it;
+        if((it != sums.end()) && (it->first == index))
+          tiles.emplace_back(index, it->second.get());
+        else if(is_dense<Array>::value)
+          tiles.emplace_back(index, value_type(trange_.make_tile_range(index),
+              typename value_type::value_type(0)));
+      }
+
+      return detail::make_retiled_array<Array>(world, trange_, pmap_, tiles);
+    }
+
+  }; // class TileAccumulator
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_ACCUMULATOR_H__INCLUDED
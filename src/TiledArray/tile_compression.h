@@ -0,0 +1,205 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_compression.h
+ *  Oct 15, 2026
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_COMPRESSION_H__INCLUDED
+#define TILEDARRAY_TILE_COMPRESSION_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/tensor/wire_codec.h>
+#include <madness/world/vector_archive.h>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// In-memory store of compressed tiles
+
+    /// Tiles are serialized, and the serialized bytes are compressed without
+    /// loss by the lossless codec of \c WireCodec , i.e. the bytes are
+    /// shuffled in 8-byte words, so that byte \c b of the elements is stored
+    /// together, and run-length encoded. Bytes that do not compress are kept
+    /// raw. A tile is removed from the store when it is read, since it is
+    /// then resident again.
+    /// \tparam T The tile type
+    template <typename T>
+    class CompressedTiles {
+    public:
+      typedef std::size_t size_type; ///< Size type
+      typedef T value_type; ///< Tile type
+
+    private:
+      typedef std::uint64_t word_type; ///< The shuffled word type
+
+      /// A compressed tile
+      struct Buffer {
+        WireCodec::codec_type codec; ///< The codec of \c data
+        size_type size; ///< The size of the serialized tile
+        std::vector<unsigned char> data; ///< The compressed tile
+      }; // struct Buffer
+
+      mutable madness::Spinlock lock_; ///< Lock for the tiles
+      std::unordered_map<size_type, Buffer> tiles_; ///< The compressed tiles
+      size_type bytes_; ///< The size of the compressed tiles
+
+      CompressedTiles(const CompressedTiles&) = delete;
+      CompressedTiles& operator=(const CompressedTiles&) = delete;
+
+    public:
+
+      CompressedTiles() : lock_(), tiles_(), bytes_(0ul) { }
+
+      /// Tile query
+
+      /// \param key The key of the tile
+      /// \return \c true if the tile is compressed
+      bool contains(const size_type key) const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        return tiles_.find(key) != tiles_.end();
+      }
+
+      /// \return \c true if there are no compressed tiles
+      bool empty() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        return tiles_.empty();
+      }
+
+      /// \return The number of compressed tiles
+      size_type size() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        return tiles_.size();
+      }
+
+      /// \return The size of the compressed tiles, in bytes
+      size_type bytes() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        return bytes_;
+      }
+
+      /// \return The keys of the compressed tiles
+      std::vector<size_type> keys() const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        std::vector<size_type> result;
+        result.reserve(tiles_.size());
+        for(const auto& tile : tiles_)
+          result.push_back(tile.first);
+        return result;
+      }
+
+      /// Compress a tile
+
+      /// A previously compressed tile with the same key is replaced.
+      /// \param key The key of the tile
+      /// \param value The tile
+      void write(const size_type key, const value_type& value) {
+        std::vector<unsigned char> bytes;
+        {
+          madness::archive::VectorOutputArchive ar(bytes);
+          ar & value;
+        }
+
+        // Shuffle and encode the serialized tile in whole words
+        Buffer buffer;
+        buffer.size = bytes.size();
+        std::vector<word_type> words((bytes.size() + sizeof(word_type) - 1ul) /
+            sizeof(word_type), word_type(0));
+        if(! bytes.empty())
+          std::memcpy(words.data(), bytes.data(), bytes.size());
+        buffer.data = WireCodec::encode(WireCodec::lossless, words.data(),
+            words.size(), 0.0);
+        buffer.codec = WireCodec::lossless;
+        if(buffer.data.size() >= bytes.size()) {
+          buffer.data = std::move(bytes);
+          buffer.codec = WireCodec::raw;
+        }
+        buffer.data.shrink_to_fit();
+
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        auto it = tiles_.find(key);
+        if(it != tiles_.end()) {
+          bytes_ -= it->second.data.size();
+          tiles_.erase(it);
+        }
+        bytes_ += buffer.data.size();
+        tiles_.emplace(key, std::move(buffer));
+      }
+
+      /// Decompress and remove a tile
+
+      /// \param key The key of the tile
+      /// \return The tile
+      /// \throw TiledArray::Exception When the tile is not compressed
+      value_type read(const size_type key) {
+        Buffer buffer;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          auto it = tiles_.find(key);
+          TA_ASSERT(it != tiles_.end());
+          buffer = std::move(it->second);
+          bytes_ -= buffer.data.size();
+          tiles_.erase(it);
+        }
+
+        std::vector<unsigned char> bytes;
+        if(buffer.codec == WireCodec::raw) {
+          bytes = std::move(buffer.data);
+        } else {
+          std::vector<word_type> words((buffer.size + sizeof(word_type) - 1ul) /
+              sizeof(word_type));
+          WireCodec::decode(buffer.codec, buffer.data.data(),
+              buffer.data.data() + buffer.data.size(), words.data(), words.size());
+          bytes.resize(buffer.size);
+          if(! bytes.empty())
+            std::memcpy(bytes.data(), words.data(), bytes.size());
+        }
+
+        value_type value;
+        madness::archive::VectorInputArchive ar(bytes);
+        ar & value;
+        return value;
+      }
+
+      /// Remove a tile
+
+      /// Nothing is done if the tile is not compressed.
+      /// \param key The key of the tile
+      void erase(const size_type key) {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        auto it = tiles_.find(key);
+        if(it != tiles_.end()) {
+          bytes_ -= it->second.data.size();
+          tiles_.erase(it);
+        }
+      }
+
+    }; // class CompressedTiles
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_COMPRESSION_H__INCLUDED
@@ -0,0 +1,191 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_cost.h
+ *  Oct 15, 2016
+ *
+ */
+
+
+#ifndef TILEDARRAY_TILE_COST_H__INCLUDED
+#define TILEDARRAY_TILE_COST_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/pmap/weighted_pmap.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Recorder of the measured cost of result tiles
+
+  /// The cost estimates that distribute the tiles of an array, e.g. the
+  /// volume of the non-zero tiles, do not account for the work that is done
+  /// to compute them, which depends on the sparsity of the arguments. In
+  /// iterative methods, where the same expressions are evaluated with
+  /// slowly changing data, the time that was measured in one iteration is a
+  /// better estimate for the next. A recorder that is given to an expression
+  /// accumulates the compute time of each result tile, i.e. the time of the
+  /// tile operations of the evaluator of the result (the tile pair
+  /// contractions of a contraction, or the element-wise operation of an
+  /// element-wise expression). Between iterations, the measured costs are
+  /// used to construct a process map with tiles of equal total cost, and the
+  /// arrays of the iteration are moved to it (see \c rebalance() ):
+  /// \code
+  /// auto cost = std::make_shared<TiledArray::TileCostRecorder>(r.size());
+  /// for(...) {
+  ///   r("i,j") = (t("i,k") * v("k,j")).set_cost_recorder(cost);
+  ///   ...
+  ///   world.gop.fence();
+  ///   if(TiledArray::rebalance(r, *cost))
+  ///     t = TiledArray::redistribute(t, r.pmap());
+  ///   cost->reset();
+  /// }
+  /// \endcode
+  /// \note Costs are recorded concurrently by the tasks of an evaluation,
+  /// and the recorder must have the number of tiles of the result.
+  class TileCostRecorder {
+  public:
+    typedef std::size_t size_type; ///< Size type
+    typedef std::chrono::steady_clock clock_type; ///< Clock type
+
+  private:
+    std::unique_ptr<std::atomic<std::int64_t>[]> cost_; ///< The cost of each tile, in nanoseconds
+    const size_type size_; ///< The number of tiles
+
+    TileCostRecorder(const TileCostRecorder&) = delete;
+    TileCostRecorder& operator=(const TileCostRecorder&) = delete;
+
+  public:
+
+    /// Constructor
+
+    /// \param size The number of tiles of the result
+    explicit TileCostRecorder(const size_type size) :
+      cost_(new std::atomic<std::int64_t>[size]), size_(size)
+    { reset(); }
+
+    /// \return The number of tiles
+    size_type size() const { return size_; }
+
+    /// Add to the cost of a tile
+
+    /// \param tile The ordinal index of the tile
+    /// \param time The compute time of \c tile
+    void record(const size_type tile, const clock_type::duration& time) {
+      TA_ASSERT(tile < size_);
+      cost_[tile].fetch_add(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(),
+          std::memory_order_relaxed);
+    }
+
+    /// Cost that was recorded by this process
+
+    /// \param tile The ordinal index of the tile
+    /// \return The compute time of \c tile on this process, in seconds
+    double local_cost(const size_type tile) const {
+      TA_ASSERT(tile < size_);
+      return 1.0e-9 * double(cost_[tile].load(std::memory_order_relaxed));
+    }
+
+    /// Discard the recorded costs
+    void reset() {
+      for(size_type i = 0ul; i < size_; ++i)
+        cost_[i].store(0, std::memory_order_relaxed);
+    }
+
+    /// Cost of the tiles
+
+    /// The costs of all processes are summed, since the partial results of
+    /// a tile may be computed by several processes, e.g. by the layers of a
+    /// 2.5D contraction. This is a collective operation, and the evaluations
+    /// whose costs are recorded must be complete.
+    /// \param world The world where the tiles were computed
+    /// \return The compute time of each tile, in seconds
+    std::vector<double> costs(World& world) const {
+      std::vector<double> result(size_);
+      for(size_type i = 0ul; i < size_; ++i)
+        result[i] = local_cost(i);
+      world.gop.sum(result.data(), result.size());
+      return result;
+    }
+
+    /// Process map that balances the recorded costs
+
+    /// \param world The world where the tiles were computed
+    /// \param pmap The current process map of the tiles
+    /// \param threshold The load imbalance of \c pmap above which the tiles
+    /// are redistributed
+    /// \return A process map whose processes have tiles of approximately
+    /// equal cost, or null if the imbalance of \c pmap does not exceed
+    /// \c threshold , or no cost was recorded
+    /// \note This is a collective operation.
+    std::shared_ptr<Pmap> make_pmap(World& world, const Pmap& pmap,
+        const double threshold = TILEDARRAY_WEIGHTED_PMAP_THRESHOLD) const
+    {
+      TA_USER_ASSERT(pmap.size() == size_,
+          "TileCostRecorder::make_pmap(): The process map does not have the number of recorded tiles.");
+      const std::vector<double> weights = costs(world);
+      if(detail::WeightedPmap::imbalance(pmap, weights) <= threshold)
+        return std::shared_ptr<Pmap>();
+      return std::make_shared<detail::WeightedPmap>(world, weights);
+    }
+
+  }; // class TileCostRecorder
+
+  namespace detail {
+
+    /// Record the lifetime of a scope as the cost of a tile
+
+    /// Nothing is recorded when the recorder is null.
+    class TileCostScope {
+      TileCostRecorder* const recorder_; ///< The recorder, or null
+      const std::size_t tile_; ///< The ordinal index of the tile
+      TileCostRecorder::clock_type::time_point begin_; ///< Start time
+
+    public:
+      /// Constructor
+
+      /// \param recorder The recorder of the cost, which may be null
+      /// \param tile The ordinal index of the tile
+      TileCostScope(TileCostRecorder* const recorder, const std::size_t tile) :
+        recorder_(recorder), tile_(tile),
+        begin_(recorder ? TileCostRecorder::clock_type::now() :
+            TileCostRecorder::clock_type::time_point())
+      { }
+
+      TileCostScope(const TileCostScope&) = delete;
+      TileCostScope& operator=(const TileCostScope&) = delete;
+
+      ~TileCostScope() {
+        if(recorder_)
+          recorder_->record(tile_, TileCostRecorder::clock_type::now() - begin_);
+      }
+
+    }; // class TileCostScope
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_COST_H__INCLUDED
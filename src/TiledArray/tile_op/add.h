@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_TILE_OP_ADD_H__INCLUDED
 #define TILEDARRAY_TILE_OP_ADD_H__INCLUDED
 
+#include <TiledArray/op_stats.h>
 #include <TiledArray/tile_op/tile_interface.h>
 #include <TiledArray/zero_tensor.h>
 
@@ -88,6 +89,8 @@ namespace TiledArray {
     // Non-permuting tile evaluation functions
     // The compiler will select the correct functions based on the consumability
     // of the arguments.
+    // Arguments that cannot be consumed are passed through as copy-on-write
+    // copies, so they are only copied when the result tile is modified.
 
     template <bool LC, bool RC,
         typename std::enable_if<!(LC || RC)>::type* = nullptr>
@@ -113,8 +116,8 @@ namespace TiledArray {
     template <bool LC, bool RC,
         typename std::enable_if<!RC>::type* = nullptr>
     static result_type eval(const ZeroTensor&, const right_type& second) {
-      using TiledArray::clone;
-      return clone(second);
+      using TiledArray::lazy_clone;
+      return lazy_clone(second);
     }
 
     template <bool LC, bool RC,
@@ -126,8 +129,8 @@ namespace TiledArray {
     template <bool LC, bool RC,
         typename std::enable_if<!LC>::type* = nullptr>
     static result_type eval(const left_type& first, const ZeroTensor&) {
-      using TiledArray::clone;
-      return clone(first);
+      using TiledArray::lazy_clone;
+      return lazy_clone(first);
     }
 
     template <bool LC, bool RC,
@@ -151,6 +154,7 @@ namespace TiledArray {
     /// \return The permuted and scaled sum of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::add, left, right);
       return eval(std::forward<L>(left), std::forward<R>(right), perm);
     }
 
@@ -166,6 +170,7 @@ namespace TiledArray {
     /// \return The scaled sum of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::add, left, right);
       return Add_::template eval<left_is_consumable, right_is_consumable>(
           std::forward<L>(left), std::forward<R>(right));
     }
@@ -181,6 +186,7 @@ namespace TiledArray {
     /// \return The sum of `left` and `right`.
     template <typename R>
     result_type consume_left(left_type& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::add, left, right);
       return Add_::template eval<is_consumable_tile<left_type>::value,
           false>(left, std::forward<R>(right));
     }
@@ -196,6 +202,7 @@ namespace TiledArray {
     /// \return The sum of `left` and `right`.
     template <typename L>
     result_type consume_right(L&& left, right_type& right) const {
+      const detail::OpStatsScope stats(TileOpKind::add, left, right);
       return Add_::template eval<false,
           is_consumable_tile<right_type>::value>(std::forward<L>(left), right);
     }
@@ -341,6 +348,7 @@ namespace TiledArray {
     /// \return The permuted and scaled sum of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::add, left, right);
       return eval(std::forward<L>(left), std::forward<R>(right), perm);
     }
 
@@ -356,6 +364,7 @@ namespace TiledArray {
     /// \return The scaled sum of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::add, left, right);
       return ScalAdd_::template eval<left_is_consumable,
           right_is_consumable>(std::forward<L>(left), std::forward<R>(right));
     }
@@ -371,6 +380,7 @@ namespace TiledArray {
     /// \return The sum of `left` and `right`.
     template <typename R>
     result_type consume_left(left_type& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::add, left, right);
       return ScalAdd_::template eval<is_consumable_tile<left_type>::value,
           false>(left, std::forward<R>(right));
     }
@@ -386,6 +396,7 @@ namespace TiledArray {
     /// \return The sum of `left` and `right`.
     template <typename L>
     result_type consume_right(L&& left, right_type& right) const {
+      const detail::OpStatsScope stats(TileOpKind::add, left, right);
       return ScalAdd_::template eval<false,
           is_consumable_tile<right_type>::value>(std::forward<L>(left), right);
     }
@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_TILE_OP_BINARY_REDUCTION_H__INCLUDED
 #define TILEDARRAY_TILE_OP_BINARY_REDUCTION_H__INCLUDED
 
+#include <TiledArray/tensor/statistics.h>
 #include <TiledArray/tile_op/tile_interface.h>
 
 namespace TiledArray {
@@ -66,6 +67,57 @@ namespace TiledArray {
 
   }; // class DotReduction
 
+  /// Tile statistics and dot product reduction
+
+  /// This reduction operation computes a set of statistics of the elements of
+  /// the left-hand tiles and their dot product with the right-hand tiles (see
+  /// \c Statistics ) in one pass over each pair of tiles.
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  template <typename Left, typename Right>
+  class StatisticsDotReduction {
+  public:
+    // typedefs
+    using result_type = decltype(statistics(std::declval<Left>(),
+        std::declval<Right>(), 0u));
+    typedef Left first_argument_type;
+    typedef Right second_argument_type;
+
+  private:
+    unsigned int flags_; ///< The selected statistics
+
+  public:
+
+    /// Constructor
+
+    /// \param flags The selected statistics, a combination of
+    /// \c StatisticsFlags
+    explicit StatisticsDotReduction(const unsigned int flags = stat_all) :
+      flags_(flags)
+    { }
+
+    // Reduction functions
+
+    // Make an empty result object
+    result_type operator()() const { return result_type(flags_); }
+
+    // Post process the result
+    const result_type& operator()(const result_type& result) const { return result; }
+
+    // Reduce two result objects
+    void operator()(result_type& result, const result_type& arg) const {
+      result.join(arg);
+    }
+
+    // Reduce an argument pair
+    void operator()(result_type& result, const first_argument_type& left,
+        const second_argument_type& right) const {
+      using TiledArray::statistics;
+      result.join(statistics(left, right, flags_));
+    }
+
+  }; // class StatisticsDotReduction
+
 } // namespace TiledArray
 
 #endif // TILEDARRAY_TILE_OP_BINARY_REDUCTION_H__INCLUDED
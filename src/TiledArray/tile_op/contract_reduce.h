@@ -28,10 +28,50 @@
 
 #include <TiledArray/permutation.h>
 #include <TiledArray/math/gemm_helper.h>
+#include <TiledArray/op_stats.h>
 #include <TiledArray/tile_op/tile_interface.h>
 #include <TiledArray/tensor/complex.h>
+#include <TiledArray/tensor/type_traits.h>
+#include <TiledArray/tile_op/result_pool.h>
 
 namespace TiledArray {
+  namespace detail {
+
+    /// Operation counts of a tile contraction
+
+    /// \tparam Left The left-hand tile type
+    /// \tparam Right The right-hand tile type
+    /// \param gemm_helper The contraction helper
+    /// \param left The left-hand tile
+    /// \param right The right-hand tile
+    /// \return The floating point operations, \c 2mnk , and the bytes of the
+    /// arguments and the result of the contraction
+    template <typename Left, typename Right>
+    inline auto contract_op_stats(const math::GemmHelper& gemm_helper,
+        const Left& left, const Right& right, int) ->
+        decltype(left.range(), right.range(), std::array<std::uint64_t, 2>())
+    {
+      if(! OpStats::instance().enabled() || left.empty() || right.empty())
+        return std::array<std::uint64_t, 2>{{ 0ul, 0ul }};
+      integer m = 1, n = 1, k = 1;
+      gemm_helper.compute_matrix_sizes(m, n, k, left.range(), right.range());
+      const std::uint64_t element_size = std::max(
+          op_stats_element_size(left, 0), op_stats_element_size(right, 0));
+      return std::array<std::uint64_t, 2>{{ 2ul * m * n * k,
+          (std::uint64_t(m) * k + std::uint64_t(k) * n + 2ul * m * n) * element_size }};
+    }
+
+    /// Operation counts of other tile contractions
+
+    /// \return Zero counts
+    template <typename Left, typename Right>
+    inline std::array<std::uint64_t, 2>
+    contract_op_stats(const math::GemmHelper&, const Left&, const Right&, long) {
+      return std::array<std::uint64_t, 2>{{ 0ul, 0ul }};
+    }
+
+  } // namespace detail
+
 
   /// Contract and reduce base
 
@@ -54,14 +94,53 @@ namespace TiledArray {
           const unsigned int result_rank, const unsigned int left_rank,
           const unsigned int right_rank, const Permutation& perm = Permutation()) :
         gemm_helper_(left_op, right_op, result_rank, left_rank, right_rank),
-        alpha_(alpha), perm_(perm)
+        fused_gemm_helper_(transpose_op(right_op), transpose_op(left_op),
+            result_rank, right_rank, left_rank),
+        alpha_(alpha), perm_(perm),
+        fused_perm_(std::is_same<Left, Right>::value &&
+            (left_op != madness::cblas::ConjTrans) &&
+            (right_op != madness::cblas::ConjTrans) &&
+            is_outer_swap(perm, gemm_helper_.left_outer_end()
+            - gemm_helper_.left_outer_begin()))
       { }
 
       math::GemmHelper gemm_helper_; ///< Gemm helper object
+      math::GemmHelper fused_gemm_helper_; ///< Gemm helper object for the transposed product
       scalar_type alpha_; ///< Scaling factor applied to the contraction of the left- and right-hand arguments
       Permutation perm_; ///< Permutation that is applied to the final result tensor
+      bool fused_perm_; ///< The permutation is applied by the gemm
     };
 
+    static madness::cblas::CBLAS_TRANSPOSE
+    transpose_op(const madness::cblas::CBLAS_TRANSPOSE op) {
+      return (op == madness::cblas::NoTrans ? madness::cblas::Trans : madness::cblas::NoTrans);
+    }
+
+    /// Check for a permutation that swaps the left and right outer indices
+
+    /// A result tensor with indices <tt>[M..., N...]</tt> that is permuted to
+    /// <tt>[N..., M...]</tt> is the transpose of the matrix product, which
+    /// can be computed directly as <tt>op(right)^T * op(left)^T</tt>.
+    /// \param perm The result permutation
+    /// \param left_outer_rank The number of outer indices of the left-hand
+    /// argument
+    /// \return \c true when \c perm swaps the left and right outer indices
+    static bool is_outer_swap(const Permutation& perm, const unsigned int left_outer_rank) {
+      if(! perm)
+        return false;
+      const unsigned int rank = perm.dim();
+      if((left_outer_rank == 0u) || (left_outer_rank >= rank))
+        return false;
+      const unsigned int right_outer_rank = rank - left_outer_rank;
+      for(unsigned int i = 0u; i < rank; ++i) {
+        const unsigned int swap_i =
+            (i < left_outer_rank ? i + right_outer_rank : i - left_outer_rank);
+        if(perm[i] != swap_i)
+          return false;
+      }
+      return true;
+    }
+
     std::shared_ptr<Impl> pimpl_;
 
   public:
@@ -108,6 +187,25 @@ namespace TiledArray {
       return pimpl_->perm_;
     }
 
+    /// Fused permutation query
+
+    /// \return \c true when the result permutation is applied by computing
+    /// the transposed product with \c fused_gemm_helper() , in which case
+    /// ContractReduce forms the result tiles directly in the permuted layout
+    bool fused_perm() const {
+      TA_ASSERT(pimpl_);
+      return pimpl_->fused_perm_;
+    }
+
+    /// Gemm meta data accessor for the transposed product
+
+    /// \return A const reference to the gemm helper object that computes
+    /// <tt>op(right)^T * op(left)^T</tt>
+    const math::GemmHelper& fused_gemm_helper() const {
+      TA_ASSERT(pimpl_);
+      return pimpl_->fused_gemm_helper_;
+    }
+
 
     /// Scaling factor accessor
 
@@ -171,6 +269,77 @@ namespace TiledArray {
         result_type; ///< The result tile type.
     typedef Scalar scalar_type;
 
+  private:
+
+    typedef TiledArray::detail::ResultPool<result_type>
+        pool_type; ///< The result pool type
+
+    std::shared_ptr<pool_type> pool_; ///< Pool of partial result tiles (may be null)
+
+    template <typename R = result_type,
+        typename std::enable_if<TiledArray::detail::is_tensor<R>::value>::type* = nullptr>
+    static std::shared_ptr<pool_type> make_pool() {
+      return std::make_shared<pool_type>(0ul);
+    }
+
+    template <typename R = result_type,
+        typename std::enable_if<! TiledArray::detail::is_tensor<R>::value>::type* = nullptr>
+    static std::shared_ptr<pool_type> make_pool() {
+      return std::shared_ptr<pool_type>();
+    }
+
+    /// Take a result tile from the result pool
+
+    /// The data of the tile is uninitialized; see \c overwrite_gemm() .
+    /// \param[out] result The result tile
+    /// \param left The left-hand argument of the product
+    /// \param right The right-hand argument of the product
+    /// \param gemm_helper The gemm helper of the product
+    /// \return \c true if \c result was taken from the pool
+    template <typename L, typename R, typename Res = result_type,
+        typename std::enable_if<TiledArray::detail::is_tensor<Res>::value>::type* = nullptr>
+    bool acquire(Res& result, const L& left, const R& right,
+        const math::GemmHelper& gemm_helper) const
+    {
+      return pool_ && pool_->capacity() && pool_->acquire(result,
+          gemm_helper.make_result_range<typename Res::range_type>(left.range(),
+          right.range()));
+    }
+
+    template <typename L, typename R, typename Res = result_type,
+        typename std::enable_if<! TiledArray::detail::is_tensor<Res>::value>::type* = nullptr>
+    bool acquire(Res&, const L&, const R&, const math::GemmHelper&) const {
+      return false;
+    }
+
+    /// Contract a pair of tiles into a result tile from the result pool
+
+    /// The product is written with \c beta equal to zero, so the stale data
+    /// of \c result is not cleared or read.
+    /// \param[in,out] result A result tile taken from the result pool
+    /// \param left The left-hand tile to be contracted
+    /// \param right The right-hand tile to be contracted
+    /// \param gemm_helper The gemm helper of the product
+    template <typename L, typename R, typename Res = result_type>
+    auto overwrite_gemm(Res& result, const L& left, const R& right,
+        const math::GemmHelper& gemm_helper, int) const ->
+        decltype(result.gemm(left, right, std::declval<scalar_type>(),
+            gemm_helper, TiledArray::detail::numeric_t<Res>(0)), void())
+    {
+      result.gemm(left, right, ContractReduceBase_::factor(), gemm_helper,
+          TiledArray::detail::numeric_t<Res>(0));
+    }
+
+    template <typename L, typename R, typename Res = result_type>
+    void overwrite_gemm(Res& result, const L& left, const R& right,
+        const math::GemmHelper& gemm_helper, long) const
+    {
+      using TiledArray::gemm;
+      result = gemm(left, right, ContractReduceBase_::factor(), gemm_helper);
+    }
+
+  public:
+
     /// Compiler generated functions
     ContractReduce() = default;
     ContractReduce(const ContractReduce_&) = default;
@@ -194,9 +363,31 @@ namespace TiledArray {
         const unsigned int result_rank, const unsigned int left_rank,
         const unsigned int right_rank, const Permutation& perm = Permutation()) :
       ContractReduceBase_(left_op, right_op, alpha, result_rank, left_rank,
-          right_rank, perm)
+          right_rank, perm), pool_(make_pool())
     { }
 
+    /// Set the capacity of the partial result pool
+
+    /// Partial results that are added to other results (see \c recycle() )
+    /// are kept in a pool, which is shared by the copies of this object, and
+    /// reused by the first contraction of new partial results with the same
+    /// extents. The pool is only used for \c Tensor results.
+    /// \param capacity The maximum number of tiles held by the pool
+    void reserve_result_pool(const std::size_t capacity) const {
+      if(pool_)
+        pool_->reserve(capacity);
+    }
+
+    /// Return a partial result that is no longer used to the result pool
+
+    /// \param result A partial result whose data is not shared
+    template <typename Res = result_type,
+        typename std::enable_if<TiledArray::detail::is_tensor<Res>::value>::type* = nullptr>
+    void recycle(Res& result) const {
+      if(pool_)
+        pool_->release(result);
+    }
+
 
     /// Create a result type object
 
@@ -210,9 +401,10 @@ namespace TiledArray {
       using TiledArray::empty;
       TA_ASSERT(! empty(temp));
 
-      if(! ContractReduceBase_::perm())
+      if((! ContractReduceBase_::perm()) || ContractReduceBase_::fused_perm())
         return temp;
 
+      const detail::OpStatsScope stats(TileOpKind::permute, temp);
       using TiledArray::permute;
       return permute(temp, ContractReduceBase_::perm());
     }
@@ -236,14 +428,49 @@ namespace TiledArray {
     void operator()(result_type& result, first_argument_type left,
         second_argument_type right) const
     {
+      const auto counts = detail::contract_op_stats(
+          ContractReduceBase_::gemm_helper(), left, right, 0);
+      const detail::OpStatsScope stats(counts[0], counts[1]);
       using TiledArray::empty;
       using TiledArray::gemm;
-      if(empty(result))
-        result = gemm(left, right, ContractReduceBase_::factor(),
-            ContractReduceBase_::gemm_helper());
+      if(ContractReduceBase_::fused_perm()) {
+        fused_gemm(result, left, right);
+      } else {
+        const math::GemmHelper& gemm_helper = ContractReduceBase_::gemm_helper();
+        if(! empty(result))
+          gemm(result, left, right, ContractReduceBase_::factor(), gemm_helper);
+        else if(acquire(result, left, right, gemm_helper))
+          overwrite_gemm(result, left, right, gemm_helper, 0);
+        else
+          result = gemm(left, right, ContractReduceBase_::factor(), gemm_helper);
+      }
+    }
+
+  private:
+
+    /// Accumulate the transposed product, which is the permuted result
+
+    /// \param[in,out] result The result object that will be the reduction target
+    /// \param[in] left The left-hand tile to be contracted
+    /// \param[in] right The right-hand tile to be contracted
+    template <typename L, typename R,
+        typename std::enable_if<std::is_same<L, R>::value>::type* = nullptr>
+    void fused_gemm(result_type& result, const L& left, const R& right) const {
+      using TiledArray::empty;
+      using TiledArray::gemm;
+      const math::GemmHelper& gemm_helper = ContractReduceBase_::fused_gemm_helper();
+      if(! empty(result))
+        gemm(result, right, left, ContractReduceBase_::factor(), gemm_helper);
+      else if(acquire(result, right, left, gemm_helper))
+        overwrite_gemm(result, right, left, gemm_helper, 0);
       else
-        gemm(result, left, right, ContractReduceBase_::factor(),
-            ContractReduceBase_::gemm_helper());
+        result = gemm(right, left, ContractReduceBase_::factor(), gemm_helper);
+    }
+
+    template <typename L, typename R,
+        typename std::enable_if<! std::is_same<L, R>::value>::type* = nullptr>
+    void fused_gemm(result_type&, const L&, const R&) const {
+      TA_ASSERT(false); // fused_perm() is false for mixed argument types
     }
 
   }; // class ContractReduce
@@ -314,6 +541,7 @@ namespace TiledArray {
       if(! ContractReduceBase_::perm())
         return conj_to(temp);
 
+      const detail::OpStatsScope stats(TileOpKind::permute, temp);
       return conj(temp, ContractReduceBase_::perm());
     }
 
@@ -336,6 +564,9 @@ namespace TiledArray {
     void operator()(result_type& result, first_argument_type left,
         second_argument_type right) const
     {
+      const auto counts = detail::contract_op_stats(
+          ContractReduceBase_::gemm_helper(), left, right, 0);
+      const detail::OpStatsScope stats(counts[0], counts[1]);
       using TiledArray::empty;
       using TiledArray::gemm;
       if(empty(result))
@@ -412,6 +643,7 @@ namespace TiledArray {
       if(! ContractReduceBase_::perm())
         return conj_to(temp, ContractReduceBase_::factor().factor());
 
+      const detail::OpStatsScope stats(TileOpKind::permute, temp);
       return conj(temp, ContractReduceBase_::factor().factor(),
           ContractReduceBase_::perm());
     }
@@ -435,6 +667,9 @@ namespace TiledArray {
     void operator()(result_type& result, first_argument_type left,
         second_argument_type right) const
     {
+      const auto counts = detail::contract_op_stats(
+          ContractReduceBase_::gemm_helper(), left, right, 0);
+      const detail::OpStatsScope stats(counts[0], counts[1]);
       using TiledArray::empty;
       using TiledArray::gemm;
       if(empty(result))
@@ -445,6 +680,116 @@ namespace TiledArray {
 
   }; // class ContractReduce
 
+
+  /// Mixed precision contract and reduce operation
+
+  /// The tiles are contracted with the precision of the argument tiles
+  /// (e.g. with sgemm for single precision tiles), and the contracted tiles
+  /// are accumulated in a \c Result tile that has a higher precision (e.g. a
+  /// double precision tile). The rounding error of the result is then that
+  /// of a single tile contraction instead of that of the entire sum over the
+  /// inner dimension.
+  /// \tparam Result The result tile type
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar The scaling factor type
+  template <typename Result, typename Left, typename Right, typename Scalar>
+  class MixedContractReduce : public ContractReduceBase<Left, Right, Scalar> {
+  public:
+    typedef MixedContractReduce<Result, Left, Right, Scalar>
+        MixedContractReduce_; ///< This class type
+    typedef ContractReduceBase<Left, Right, Scalar>
+        ContractReduceBase_; ///< This class type
+    typedef typename ContractReduceBase_::first_argument_type
+        first_argument_type; ///< The left tile type
+    typedef typename ContractReduceBase_::second_argument_type
+        second_argument_type; ///< The right tile type
+    typedef Result result_type; ///< The result tile type.
+    typedef Scalar scalar_type;
+
+    /// Compiler generated functions
+    MixedContractReduce() = default;
+    MixedContractReduce(const MixedContractReduce_&) = default;
+    MixedContractReduce(MixedContractReduce_&&) = default;
+    ~MixedContractReduce() = default;
+    MixedContractReduce_& operator=(const MixedContractReduce_&) = default;
+    MixedContractReduce_& operator=(MixedContractReduce_&&) = default;
+
+    /// Construct contract/reduce functor
+
+    /// \param left_op The left-hand BLAS matrix operation
+    /// \param right_op The right-hand BLAS matrix operation
+    /// \param alpha The scaling factor applied to the contracted tiles
+    /// \param result_rank The rank of the result tensor
+    /// \param left_rank The rank of the left-hand tensor
+    /// \param right_rank The rank of the right-hand tensor
+    /// \param perm The permutation to be applied to the result tensor
+    /// (default = no permute)
+    MixedContractReduce(const madness::cblas::CBLAS_TRANSPOSE left_op,
+        const madness::cblas::CBLAS_TRANSPOSE right_op, const scalar_type alpha,
+        const unsigned int result_rank, const unsigned int left_rank,
+        const unsigned int right_rank, const Permutation& perm = Permutation()) :
+      ContractReduceBase_(left_op, right_op, alpha, result_rank, left_rank,
+          right_rank, perm)
+    { }
+
+
+    /// Create a result type object
+
+    /// Initialize a result object for subsequent reductions
+    result_type operator()() const {
+      return result_type();
+    }
+
+    /// Post processing step
+    result_type operator()(const result_type& temp) const {
+      using TiledArray::empty;
+      TA_ASSERT(! empty(temp));
+
+      if(! ContractReduceBase_::perm())
+        return temp;
+
+      const detail::OpStatsScope stats(TileOpKind::permute, temp);
+      using TiledArray::permute;
+      return permute(temp, ContractReduceBase_::perm());
+    }
+
+    /// Reduce two result objects
+
+    /// Add \c arg to \c result .
+    /// \param[in,out] result The result object that will be the reduction target
+    /// \param[in] arg The argument that will be added to \c result
+    void operator()(result_type& result, const result_type& arg) const {
+      using TiledArray::add_to;
+      add_to(result, arg);
+    }
+
+    /// Contract a pair of tiles and add to a target tile
+
+    /// Contract \c left and \c right , and add the promoted result to
+    /// \c result .
+    /// \param[in,out] result The result object that will be the reduction target
+    /// \param[in] left The left-hand tile to be contracted
+    /// \param[in] right The right-hand tile to be contracted
+    void operator()(result_type& result, first_argument_type left,
+        second_argument_type right) const
+    {
+      const auto counts = detail::contract_op_stats(
+          ContractReduceBase_::gemm_helper(), left, right, 0);
+      const detail::OpStatsScope stats(counts[0], counts[1]);
+      using TiledArray::empty;
+      using TiledArray::gemm;
+      using TiledArray::add_to;
+      const auto temp = gemm(left, right, ContractReduceBase_::factor(),
+          ContractReduceBase_::gemm_helper());
+      if(empty(result))
+        result = result_type(temp);
+      else
+        add_to(result, temp);
+    }
+
+  }; // class MixedContractReduce
+
 } // namespace TiledArray
 
 #endif // TILEDARRAY_CONTRACT_REDUCE_H__INCLUDED
@@ -0,0 +1,195 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  fused.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_OP_FUSED_H__INCLUDED
+#define TILEDARRAY_TILE_OP_FUSED_H__INCLUDED
+
+#include <vector>
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+
+namespace TiledArray {
+  namespace detail {
+
+    // Fused element-wise kernels
+
+    // An element-wise expression over congruent tiles is evaluated by a tree
+    // of kernel objects, where each call returns one element of the result.
+    // The kernel objects are small and their call operators are inline, so
+    // the compiler flattens the tree into a single loop over the elements that
+    // reads each argument once and writes only the result.
+
+    /// Fused kernel argument
+
+    /// \tparam T The element type
+    template <typename T>
+    class FusedArg {
+      unsigned int index_; ///< The argument index
+
+    public:
+      typedef T value_type; ///< The element type
+
+      /// Constructor
+
+      /// \param index The index of the argument in the argument list
+      explicit FusedArg(const unsigned int index) : index_(index) { }
+
+      /// Element accessor
+
+      /// \param args The argument data
+      /// \param i The element index
+      /// \return Element \c i of argument \c index
+      value_type operator()(const T* const* args, const std::size_t i) const {
+        return args[index_][i];
+      }
+    }; // class FusedArg
+
+    /// Fused kernel scaling
+
+    /// \tparam Arg The argument kernel type
+    /// \tparam Scalar The scaling factor type
+    template <typename Arg, typename Scalar>
+    class FusedScal {
+      Arg arg_; ///< The argument kernel
+      Scalar factor_; ///< The scaling factor
+
+    public:
+      typedef typename Arg::value_type value_type; ///< The element type
+
+      FusedScal(const Arg& arg, const Scalar factor) :
+        arg_(arg), factor_(factor)
+      { }
+
+      value_type operator()(const value_type* const* args, const std::size_t i) const {
+        return arg_(args, i) * factor_;
+      }
+    }; // class FusedScal
+
+    /// Fused kernel addition
+
+    /// \tparam Left The left-hand kernel type
+    /// \tparam Right The right-hand kernel type
+    template <typename Left, typename Right>
+    class FusedAdd {
+      Left left_; ///< The left-hand kernel
+      Right right_; ///< The right-hand kernel
+
+    public:
+      typedef typename Left::value_type value_type; ///< The element type
+
+      FusedAdd(const Left& left, const Right& right) :
+        left_(left), right_(right)
+      { }
+
+      value_type operator()(const value_type* const* args, const std::size_t i) const {
+        return left_(args, i) + right_(args, i);
+      }
+    }; // class FusedAdd
+
+    /// Fused kernel subtraction
+
+    /// \tparam Left The left-hand kernel type
+    /// \tparam Right The right-hand kernel type
+    template <typename Left, typename Right>
+    class FusedSubt {
+      Left left_; ///< The left-hand kernel
+      Right right_; ///< The right-hand kernel
+
+    public:
+      typedef typename Left::value_type value_type; ///< The element type
+
+      FusedSubt(const Left& left, const Right& right) :
+        left_(left), right_(right)
+      { }
+
+      value_type operator()(const value_type* const* args, const std::size_t i) const {
+        return left_(args, i) - right_(args, i);
+      }
+    }; // class FusedSubt
+
+    /// Fused kernel element-wise multiplication
+
+    /// \tparam Left The left-hand kernel type
+    /// \tparam Right The right-hand kernel type
+    template <typename Left, typename Right>
+    class FusedMult {
+      Left left_; ///< The left-hand kernel
+      Right right_; ///< The right-hand kernel
+
+    public:
+      typedef typename Left::value_type value_type; ///< The element type
+
+      FusedMult(const Left& left, const Right& right) :
+        left_(left), right_(right)
+      { }
+
+      value_type operator()(const value_type* const* args, const std::size_t i) const {
+        return left_(args, i) * right_(args, i);
+      }
+    }; // class FusedMult
+
+    /// Evaluate a fused kernel
+
+    /// Arguments that are empty tiles are zero tiles of the shape.
+    /// \tparam Tile The tile type
+    /// \tparam Kernel The fused kernel type
+    /// \param kernel The fused kernel
+    /// \param range The range of the result tile
+    /// \param args The argument tiles, in the order of the argument indices
+    /// of \c kernel
+    /// \return The result tile
+    template <typename Tile, typename Kernel>
+    Tile fused_tile(const Kernel& kernel, const typename Tile::range_type& range,
+        const std::vector<Tile>& args)
+    {
+      typedef typename Tile::value_type value_type;
+      const std::size_t volume = range.volume();
+
+      std::vector<value_type> zeros;
+      std::vector<const value_type*> data(args.size());
+      for(std::size_t a = 0ul; a < args.size(); ++a) {
+        if(args[a].empty()) {
+          if(zeros.empty())
+            zeros.resize(volume, value_type(0));
+          data[a] = zeros.data();
+        } else {
+          TA_ASSERT(args[a].range().volume() == volume);
+          data[a] = args[a].data();
+        }
+      }
+
+      Tile result(range);
+      value_type* MADNESS_RESTRICT const result_data = result.data();
+      const value_type* const* const args_data = data.data();
+      for(std::size_t i = 0ul; i < volume; ++i)
+        result_data[i] = kernel(args_data, i);
+
+      return result;
+    }
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_OP_FUSED_H__INCLUDED
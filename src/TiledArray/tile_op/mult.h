@@ -27,6 +27,7 @@
 #define TILEDARRAY_TILE_OP_MULT_H__INCLUDED
 
 #include <TiledArray/error.h>
+#include <TiledArray/op_stats.h>
 #include <TiledArray/tile_op/tile_interface.h>
 #include <TiledArray/zero_tensor.h>
 
@@ -155,6 +156,7 @@ namespace TiledArray {
     /// \return The permuted and scaled product of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::mult, left, right);
       return eval(std::forward<L>(left), std::forward<R>(right), perm);
     }
 
@@ -168,6 +170,7 @@ namespace TiledArray {
     /// \return The scaled product of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::mult, left, right);
       return Mult_::template eval<left_is_consumable, right_is_consumable>(
           std::forward<L>(left), std::forward<R>(right));
     }
@@ -181,6 +184,7 @@ namespace TiledArray {
     /// \return The product of `left` and `right`.
     template <typename R>
     result_type consume_left(left_type& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::mult, left, right);
       return Mult_::template eval<is_consumable_tile<left_type>::value, false>(
           left, std::forward<R>(right));
     }
@@ -194,6 +198,7 @@ namespace TiledArray {
     /// \return The product of `left` and `right`.
     template <typename L>
     result_type consume_right(L&& left, right_type& right) const {
+      const detail::OpStatsScope stats(TileOpKind::mult, left, right);
       return Mult_::template eval<false, is_consumable_tile<right_type>::value>(
           std::forward<L>(left), right);
     }
@@ -337,6 +342,7 @@ namespace TiledArray {
     /// \return The permuted and scaled product of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::mult, left, right);
       return eval(std::forward<L>(left), std::forward<R>(right), perm);
     }
 
@@ -350,6 +356,7 @@ namespace TiledArray {
     /// \return The scaled product of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::mult, left, right);
       return ScalMult_::template eval<left_is_consumable,
           right_is_consumable>(std::forward<L>(left), std::forward<R>(right));
     }
@@ -363,6 +370,7 @@ namespace TiledArray {
     /// \return The product of `left` and `right`.
     template <typename R>
     result_type consume_left(left_type& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::mult, left, right);
       return ScalMult_::template eval<is_consumable_tile<left_type>::value, false>(left,
           std::forward<R>(right));
     }
@@ -376,6 +384,7 @@ namespace TiledArray {
     /// \return The product of `left` and `right`.
     template <typename L>
     result_type consume_right(L&& left, right_type& right) const {
+      const detail::OpStatsScope stats(TileOpKind::mult, left, right);
       return ScalMult_::template eval<false, is_consumable_tile<right_type>::value>(std::forward<L>(left),
           right);
     }
@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_TILE_OP_NEG_H__INCLUDED
 #define TILEDARRAY_TILE_OP_NEG_H__INCLUDED
 
+#include <TiledArray/op_stats.h>
 #include <TiledArray/tile_op/tile_interface.h>
 
 namespace TiledArray {
@@ -86,6 +87,7 @@ namespace TiledArray {
     /// \return A permuted and negated copy of `arg`
     template <typename A>
     result_type operator()(A&& arg, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::scal, arg);
       return eval(arg, perm);
     }
 
@@ -96,6 +98,7 @@ namespace TiledArray {
     /// \return A negated copy of `arg`
     template <typename A>
     result_type operator()(A&& arg) const {
+      const detail::OpStatsScope stats(TileOpKind::scal, arg);
       return Neg_::template eval<is_consumable>(arg);
     }
 
@@ -106,6 +109,7 @@ namespace TiledArray {
     /// \return In-place negated `arg`
     template <typename A>
     result_type consume(A& arg) const {
+      const detail::OpStatsScope stats(TileOpKind::scal, arg);
       return Neg_::template eval<is_consumable_tile<Arg>::value>(arg);
     }
 
@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_TILE_OP_NOOP_H__INCLUDED
 #define TILEDARRAY_TILE_OP_NOOP_H__INCLUDED
 
+#include <TiledArray/op_stats.h>
 #include <TiledArray/tile_op/tile_interface.h>
 
 namespace TiledArray {
@@ -59,12 +60,14 @@ namespace TiledArray {
 
     // Non-permuting tile evaluation functions
     // The compiler will select the correct functions based on the
-    // consumability of the arguments.
+    // consumability of the arguments. Arguments that cannot be consumed are
+    // returned as copy-on-write copies, so they are only copied when the
+    // result tile is modified.
 
     template <bool C, typename std::enable_if<!C>::type* = nullptr>
     static result_type eval(const Arg& arg) {
-      using TiledArray::clone;
-      return clone(arg);
+      using TiledArray::lazy_clone;
+      return lazy_clone(arg);
     }
 
     template <bool C, typename std::enable_if<C>::type* = nullptr>
@@ -79,6 +82,7 @@ namespace TiledArray {
     /// \param perm The permutation applied to the result tile
     /// \return A permuted copy of `arg`
     result_type operator()(const argument_type& arg, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::permute, arg);
       return eval(arg, perm);
     }
 
@@ -86,7 +90,8 @@ namespace TiledArray {
 
     /// \tparam A The tile argument type
     /// \param arg The tile argument
-    /// \return A clone of the `arg`
+    /// \return A copy-on-write clone of the `arg`, or `arg` when it is
+    /// consumable
     template <typename A>
     result_type operator()(A&& arg) const {
       return Noop_::template eval<is_consumable>(arg);
@@ -0,0 +1,161 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  result_pool.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_OP_RESULT_POOL_H__INCLUDED
+#define TILEDARRAY_TILE_OP_RESULT_POOL_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <algorithm>
+#include <vector>
+
+namespace TiledArray {
+  namespace detail {
+
+    /// Pool of reusable result tiles
+
+    /// The partial results of a reduction are released to the pool when they
+    /// are added to another result, and taken from the pool by new partial
+    /// results of any tile with the same extents, so that the tile data is
+    /// not allocated again. The data of a tile taken from the pool is not
+    /// cleared, so it must be overwritten by the new result (e.g. with a GEMM
+    /// with \c beta equal to zero). The pool holds no more than \c capacity tiles.
+    /// This object is thread safe.
+    /// \tparam Tile The tile type, which must be a \c Tensor
+    template <typename Tile>
+    class ResultPool {
+    public:
+      typedef typename Tile::range_type range_type; ///< Tile range type
+      typedef typename Tile::numeric_type numeric_type; ///< Tile element type
+
+    private:
+      std::vector<Tile> tiles_; ///< The tiles that are not in use
+      std::size_t capacity_; ///< The maximum number of tiles in the pool
+      std::size_t hits_; ///< The number of tiles taken from the pool
+      mutable madness::Spinlock lock_; ///< Pool lock
+
+      /// Check that two ranges have the same extents
+      static bool same_extents(const range_type& left, const range_type& right) {
+        return (left.rank() == right.rank()) &&
+            std::equal(left.extent_data(), left.extent_data() + left.rank(),
+                right.extent_data());
+      }
+
+    public:
+
+      /// Construct a pool
+
+      /// \param capacity The maximum number of tiles held by the pool
+      explicit ResultPool(const std::size_t capacity) :
+        tiles_(), capacity_(capacity), hits_(0ul), lock_()
+      {
+        tiles_.reserve(capacity);
+      }
+
+      ResultPool(const ResultPool&) = delete;
+      ResultPool& operator=(const ResultPool&) = delete;
+
+      /// Take a tile from the pool
+
+      /// \param[out] tile A tile with the range \c range and uninitialized
+      /// data, if the pool has a tile with the same extents
+      /// \param range The range of the tile
+      /// \return \c true if \c tile was taken from the pool
+      bool acquire(Tile& tile, const range_type& range) {
+        Tile result;
+        {
+          madness::ScopedMutex<madness::Spinlock> lock(lock_);
+          for(std::size_t i = tiles_.size(); i > 0ul; --i) {
+            if(same_extents(tiles_[i - 1ul].range(), range)) {
+              result = std::move(tiles_[i - 1ul]);
+              tiles_[i - 1ul] = std::move(tiles_.back());
+              tiles_.pop_back();
+              ++hits_;
+              break;
+            }
+          }
+        }
+        if(result.empty())
+          return false;
+
+        // Move the tile to the requested range
+        std::vector<long> bound_shift(range.rank());
+        for(unsigned int d = 0u; d < range.rank(); ++d)
+          bound_shift[d] = long(range.lobound(d)) - long(result.range().lobound(d));
+        result.shift_to(bound_shift);
+
+        tile = std::move(result);
+        return true;
+      }
+
+      /// Return a tile to the pool
+
+      /// The tile is kept if the pool is not full. The data of \c tile must
+      /// not be shared with other tiles.
+      /// \param[in,out] tile The tile to be returned; it is empty on return
+      /// when it is kept by the pool
+      void release(Tile& tile) {
+        if(tile.empty())
+          return;
+        madness::ScopedMutex<madness::Spinlock> lock(lock_);
+        if(tiles_.size() < capacity_)
+          tiles_.push_back(std::move(tile));
+      }
+
+      /// Set the maximum number of tiles held by the pool
+
+      /// \param capacity The maximum number of tiles held by the pool
+      void reserve(const std::size_t capacity) {
+        madness::ScopedMutex<madness::Spinlock> lock(lock_);
+        capacity_ = capacity;
+        if(tiles_.size() > capacity_)
+          tiles_.resize(capacity_);
+        tiles_.reserve(capacity_);
+      }
+
+      /// \return The maximum number of tiles held by the pool
+      std::size_t capacity() const {
+        madness::ScopedMutex<madness::Spinlock> lock(lock_);
+        return capacity_;
+      }
+
+      /// \return The number of tiles held by the pool
+      std::size_t size() const {
+        madness::ScopedMutex<madness::Spinlock> lock(lock_);
+        return tiles_.size();
+      }
+
+      /// \return The number of tiles that were taken from the pool
+      std::size_t hits() const {
+        madness::ScopedMutex<madness::Spinlock> lock(lock_);
+        return hits_;
+      }
+
+    }; // class ResultPool
+
+  }  // namespace detail
+}  // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_OP_RESULT_POOL_H__INCLUDED
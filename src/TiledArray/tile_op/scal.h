@@ -27,6 +27,7 @@
 #define TILEDARRAY_TILE_OP_SCAL_H__INCLUDED
 
 #include <type_traits>
+#include <TiledArray/op_stats.h>
 #include <TiledArray/tile_op/tile_interface.h>
 
 namespace TiledArray {
@@ -54,6 +55,17 @@ namespace TiledArray {
   private:
 
     scalar_type factor_; ///< Scaling factor
+    bool folded_; ///< If true, the factor is applied by the consumer
+
+    // Pass the argument through when the factor is folded into the consumer
+    result_type pass(const argument_type& arg, std::true_type) const {
+      return arg;
+    }
+
+    result_type pass(const argument_type&, std::false_type) const {
+      TA_ASSERT(false); // Only tiles of the result type can be passed through
+      return result_type();
+    }
 
     // Permuting tile evaluation function
     // These operations cannot consume the argument tile since this operation
@@ -71,12 +83,16 @@ namespace TiledArray {
     template <bool C, typename std::enable_if<!C>::type* = nullptr>
     result_type eval(const argument_type& arg) const {
       using TiledArray::scale;
+      if(folded_)
+        return pass(arg, std::is_same<result_type, argument_type>());
       return scale(arg, factor_);
     }
 
     template <bool C, typename std::enable_if<C>::type* = nullptr>
     result_type eval(argument_type& arg) const {
       using TiledArray::scale_to;
+      if(folded_)
+        return pass(arg, std::is_same<result_type, argument_type>());
       return scale_to(arg, factor_);
     }
 
@@ -91,9 +107,26 @@ namespace TiledArray {
 
     /// Constructor
 
-    /// Construct a scaling operation that scales the result tensor
+    /// Construct a scaling operation that scales the result tensor. When
+    /// \c folded is \c true , the consumer of the result applies \c factor
+    /// (e.g. as a GEMM \c alpha or a conjugate transpose), and non-permuting
+    /// evaluations return the argument tile without a copy. Folding requires
+    /// that the result and argument tile types are the same.
     /// \param factor The scaling factor for the operation
-    explicit Scal(const scalar_type factor) : factor_(factor) { }
+    /// \param folded If \c true , \c factor is applied by the consumer
+    explicit Scal(const scalar_type factor, const bool folded = false) :
+      factor_(factor), folded_(folded)
+    { }
+
+    /// Scaling factor accessor
+
+    /// \return The scaling factor
+    scalar_type factor() const { return factor_; }
+
+    /// Folded factor query
+
+    /// \return \c true if the factor is applied by the consumer
+    bool folded() const { return folded_; }
 
     /// Scale and permute operator
 
@@ -102,6 +135,7 @@ namespace TiledArray {
     /// \return A permuted and scaled copy of `arg`
     result_type
     operator()(const argument_type& arg, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::scal, arg);
       return eval(arg, perm);
     }
 
@@ -112,6 +146,7 @@ namespace TiledArray {
     /// \return A scaled copy of `arg`
     template <typename A>
     result_type operator()(A&& arg) const {
+      const detail::OpStatsScope stats(TileOpKind::scal, arg);
       return Scal_::template eval<is_consumable &&
           ! std::is_const<typename std::remove_reference<A>::type>::value>(
           std::forward<A>(arg));
@@ -122,6 +157,7 @@ namespace TiledArray {
     /// \param arg The tile argument
     /// \return In-place scaled `arg`
     result_type consume(argument_type& arg) const {
+      const detail::OpStatsScope stats(TileOpKind::scal, arg);
       return Scal_::template eval<is_consumable_tile<Arg>::value>(arg);
     }
 
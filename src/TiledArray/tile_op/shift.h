@@ -26,6 +26,8 @@
 #ifndef TILEDARRAY_TILE_OP_SHIFT_H__INCLUDED
 #define TILEDARRAY_TILE_OP_SHIFT_H__INCLUDED
 
+#include <TiledArray/op_stats.h>
+
 namespace TiledArray {
 
   /// Tile shift operation
@@ -35,10 +37,12 @@ namespace TiledArray {
   /// \tparam Result The result type
   /// \tparam Arg The argument type
   /// \tparam Consumable Flag that is \c true when Arg is consumable
-  template <typename Arg, bool Consumable>
+  /// \tparam View Flag that is \c true when the non-permuted result of a
+  /// non-consumable argument may share the data of the argument
+  template <typename Arg, bool Consumable, bool View = false>
   class Shift {
   public:
-    typedef Shift<Arg, Consumable> Shift_; ///< This object type
+    typedef Shift<Arg, Consumable, View> Shift_; ///< This object type
     typedef Arg argument_type; ///< The argument type
     typedef decltype(shift(std::declval<argument_type>(), std::declval<std::vector<long> >()))
         result_type; ///< The result tile type
@@ -66,12 +70,18 @@ namespace TiledArray {
     // The compiler will select the correct functions based on the consumability
     // of the arguments.
 
-    template <bool C, typename std::enable_if<!C>::type* = nullptr>
+    template <bool C, typename std::enable_if<!C && !View>::type* = nullptr>
     result_type eval(const argument_type& arg) const {
       using TiledArray::shift;
       return shift(arg, range_shift_);
     }
 
+    template <bool C, typename std::enable_if<!C && View>::type* = nullptr>
+    result_type eval(const argument_type& arg) const {
+      using TiledArray::shift_view;
+      return shift_view(arg, range_shift_);
+    }
+
     template <bool C, typename std::enable_if<C>::type* = nullptr>
     result_type eval(argument_type& arg) const {
       using TiledArray::shift_to;
@@ -103,6 +113,7 @@ namespace TiledArray {
     /// \param perm The permutation applied to the result tile
     /// \return A permuted and shifted copy of `arg`
     result_type operator()(const argument_type& arg, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::shift, arg);
       return eval(arg, perm);
     }
 
@@ -113,6 +124,7 @@ namespace TiledArray {
     /// \return A shifted copy of `arg`
     template <typename A>
     result_type operator()(A&& arg) const {
+      const detail::OpStatsScope stats(TileOpKind::shift, arg);
       return Shift_::template eval<is_consumable &&
           ! std::is_const<typename std::remove_reference<A>::type>::value>(
           std::forward<A>(arg));
@@ -125,6 +137,7 @@ namespace TiledArray {
     /// \return In-place shifted `arg`
     template <typename A>
     result_type consume(A& arg) const {
+      const detail::OpStatsScope stats(TileOpKind::shift, arg);
       return Shift_::template eval<is_consumable_tile<argument_type>::value>(arg);
     }
 
@@ -216,6 +229,7 @@ namespace TiledArray {
     /// \param perm The permutation applied to the result tile
     /// \return A permuted and shifted copy of `arg`
     result_type operator()(const argument_type& arg, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::shift, arg);
       return eval(arg, perm);
     }
 
@@ -226,6 +240,7 @@ namespace TiledArray {
     /// \return A shifted copy of `arg`
     template <typename A>
     result_type operator()(A&& arg) const {
+      const detail::OpStatsScope stats(TileOpKind::shift, arg);
       return ScalShift_::template eval<is_consumable>(arg);
       return ScalShift_::template eval<is_consumable &&
           ! std::is_const<typename std::remove_reference<A>::type>::value>(
@@ -237,6 +252,7 @@ namespace TiledArray {
     /// \param arg The tile argument
     /// \return In-place shifted `arg`
     result_type consume(argument_type& arg) const {
+      const detail::OpStatsScope stats(TileOpKind::shift, arg);
       return ScalShift_::template eval<is_consumable_tile<argument_type>::value>(arg);
     }
 
@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_TILE_OP_SUBT_H__INCLUDED
 #define TILEDARRAY_TILE_OP_SUBT_H__INCLUDED
 
+#include <TiledArray/op_stats.h>
 #include <TiledArray/tile_op/tile_interface.h>
 #include <TiledArray/zero_tensor.h>
 
@@ -91,6 +92,8 @@ namespace TiledArray {
     // Non-permuting tile evaluation functions
     // The compiler will select the correct functions based on the consumability
     // of the arguments.
+    // Arguments that cannot be consumed are passed through as copy-on-write
+    // copies, so they are only copied when the result tile is modified.
 
     template <bool LC, bool RC,
         typename std::enable_if<!(LC || RC)>::type* = nullptr>
@@ -130,8 +133,8 @@ namespace TiledArray {
     template <bool LC, bool RC,
         typename std::enable_if<!LC>::type* = nullptr>
     static result_type eval(const left_type& first, ZeroTensor) {
-      using TiledArray::clone;
-      return clone(first);
+      using TiledArray::lazy_clone;
+      return lazy_clone(first);
     }
 
     template <bool LC, bool RC,
@@ -155,6 +158,7 @@ namespace TiledArray {
     /// \return The permuted and scaled difference of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::subt, left, right);
       return eval(std::forward<L>(left), std::forward<R>(right), perm);
     }
 
@@ -170,6 +174,7 @@ namespace TiledArray {
     /// \return The scaled difference of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::subt, left, right);
       return Subt_::template eval<left_is_consumable, right_is_consumable>(
           std::forward<L>(left), std::forward<R>(right));
     }
@@ -185,6 +190,7 @@ namespace TiledArray {
     /// \return The difference of `left` and `right`.
     template <typename R>
     result_type consume_left(left_type& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::subt, left, right);
       return Subt_::template eval<is_consumable_tile<left_type>::value, false>(
           left, std::forward<R>(right));
     }
@@ -200,6 +206,7 @@ namespace TiledArray {
     /// \return The difference of `left` and `right`.
     template <typename L>
     result_type consume_right(L&& left, right_type& right) const {
+      const detail::OpStatsScope stats(TileOpKind::subt, left, right);
       return Subt_::template eval<false, is_consumable_tile<right_type>::value>(
           std::forward<L>(left), right);
     }
@@ -345,6 +352,7 @@ namespace TiledArray {
     /// \return The permuted and scaled difference of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right, const Permutation& perm) const {
+      const detail::OpStatsScope stats(TileOpKind::subt, left, right);
       return eval(std::forward<L>(left), std::forward<R>(right), perm);
     }
 
@@ -360,6 +368,7 @@ namespace TiledArray {
     /// \return The scaled difference of `left` and `right`.
     template <typename L, typename R>
     result_type operator()(L&& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::subt, left, right);
       return ScalSubt_::template eval<left_is_consumable, right_is_consumable>(
           std::forward<L>(left), std::forward<R>(right));
     }
@@ -375,6 +384,7 @@ namespace TiledArray {
     /// \return The difference of `left` and `right`.
     template <typename R>
     result_type consume_left(left_type& left, R&& right) const {
+      const detail::OpStatsScope stats(TileOpKind::subt, left, right);
       return ScalSubt_::template eval<is_consumable_tile<left_type>::value, false>(
           left, std::forward<R>(right));
     }
@@ -390,6 +400,7 @@ namespace TiledArray {
     /// \return The difference of `left` and `right`.
     template <typename L>
     result_type consume_right(L&& left, right_type& right) const {
+      const detail::OpStatsScope stats(TileOpKind::subt, left, right);
       return ScalSubt_::template eval<false, is_consumable_tile<right_type>::value>(
           std::forward<L>(left), right);
     }
@@ -268,6 +268,30 @@ namespace TiledArray {
     return arg.clone();
   }
 
+  namespace detail {
+
+    template <typename Arg>
+    inline auto lazy_clone(const Arg& arg, int) -> decltype(arg.lazy_clone())
+    { return arg.lazy_clone(); }
+
+    template <typename Arg>
+    inline Arg lazy_clone(const Arg& arg, long) { return arg.clone(); }
+
+  } // namespace detail
+
+  /// Create a copy-on-write copy of \c arg
+
+  /// The data of \c arg is shared with the result until one of them is
+  /// modified when the tile type supports it (i.e. it has a \c lazy_clone
+  /// member function); otherwise this is equivalent to \c clone() .
+  /// \tparam Arg The tile argument type
+  /// \param arg The tile argument to be copied
+  /// \return A lazy copy of \c arg
+  template <typename Arg>
+  inline Arg lazy_clone(const Arg& arg) {
+    return detail::lazy_clone(arg, 0);
+  }
+
 
   // Empty operations ----------------------------------------------------------
 
@@ -295,6 +319,49 @@ namespace TiledArray {
       decltype(arg.shift(range_shift))
   { return arg.shift(range_shift); }
 
+  namespace detail {
+
+    template <typename Arg, typename Index>
+    inline auto shift_view(const Arg& arg, const Index& range_shift, int) ->
+        decltype(arg.shift_view(range_shift))
+    { return arg.shift_view(range_shift); }
+
+    template <typename Arg, typename Index>
+    inline auto shift_view(const Arg& arg, const Index& range_shift, long) ->
+        decltype(arg.shift(range_shift))
+    { return arg.shift(range_shift); }
+
+  } // namespace detail
+
+  /// Shift the range of a view of \c arg
+
+  /// The data of \c arg is shared with the result when the tile type
+  /// supports views (i.e. it has a \c shift_view member function);
+  /// otherwise this is equivalent to \c shift() .
+  /// \tparam Arg The tile argument type
+  /// \tparam Index An array type
+  /// \param arg The tile argument to be shifted
+  /// \param range_shift The offset to be applied to the argument range
+  /// \return A shallow copy of the tile with a new range
+  template <typename Arg, typename Index>
+  inline auto shift_view(const Arg& arg, const Index& range_shift) ->
+      decltype(detail::shift_view(arg, range_shift, 0))
+  { return detail::shift_view(arg, range_shift, 0); }
+
+  /// Reshape a view of \c arg
+
+  /// The data of \c arg is shared with the result, so the tile type must
+  /// support views (i.e. it has a \c reshape_view member function).
+  /// \tparam Arg The tile argument type
+  /// \tparam Range The range type
+  /// \param arg The tile argument to be reshaped
+  /// \param range The range of the result, which has the volume of \c arg
+  /// \return A shallow copy of the tile with range \c range
+  template <typename Arg, typename Range>
+  inline auto reshape_view(const Arg& arg, const Range& range) ->
+      decltype(arg.reshape_view(range))
+  { return arg.reshape_view(range); }
+
   /// Shift the range of \c arg in place
 
   /// \tparam Arg The tile argument type
@@ -433,6 +500,34 @@ namespace TiledArray {
   inline Result& add_to(Result& result, const Arg& arg, const Scalar factor)
   { return result.add_to(arg, factor); }
 
+  /// Add a permuted argument to the result tile
+
+  /// \tparam Result The result tile type
+  /// \tparam Arg The argument tile type
+  /// \param result The result tile
+  /// \param arg The argument to be permuted and added to the result
+  /// \param perm The permutation to be applied to \c arg
+  /// \return A tile that is equal to <tt>result[i] += (perm ^ arg)[i]</tt>
+  template <typename Result, typename Arg>
+  inline Result& add_to(Result& result, const Arg& arg, const Permutation& perm)
+  { return result.add_to(arg, perm); }
+
+  /// Add a permuted argument to and scale the result tile
+
+  /// \tparam Result The result tile type
+  /// \tparam Arg The argument tile type
+  /// \tparam Scalar A scalar type
+  /// \param result The result tile
+  /// \param arg The argument to be permuted and added to \c result
+  /// \param factor The scaling factor
+  /// \param perm The permutation to be applied to \c arg
+  /// \return A tile that is equal to <tt>(result[i] += (perm ^ arg)[i]) *= factor</tt>
+  template <typename Result, typename Arg, typename Scalar,
+      typename std::enable_if<detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Result& add_to(Result& result, const Arg& arg, const Scalar factor,
+      const Permutation& perm)
+  { return result.add_to(arg, factor, perm); }
+
   /// Add constant scalar to the result tile
 
   /// \tparam Result The result tile type
@@ -858,6 +953,48 @@ namespace TiledArray {
     return result.gemm(left, right, factor, gemm_config);
   }
 
+  /// Contract and scale tensor of tensor tile arguments
+
+  /// The outer tensors are contracted as defined by \c gemm_config and the
+  /// inner tensors as defined by \c inner_config .
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar A scalar type
+  /// \param left The left-hand argument to be contracted
+  /// \param right The right-hand argument to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \param inner_config The gemm helper for the inner tensors
+  /// \return A tile that is equal to <tt>(left * right) * factor</tt>
+  template <typename Left, typename Right, typename Scalar,
+      typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline auto gemm(const Left& left, const Right& right, const Scalar factor,
+      const math::GemmHelper& gemm_config, const math::GemmHelper& inner_config) ->
+      decltype(left.gemm(right, factor, gemm_config, inner_config))
+  { return left.gemm(right, factor, gemm_config, inner_config); }
+
+  /// Contract and scale tensor of tensor tile arguments to the result tile
+
+  /// \tparam Result The result tile type
+  /// \tparam Left The left-hand tile type
+  /// \tparam Right The right-hand tile type
+  /// \tparam Scalar A scalar type
+  /// \param result The contracted result
+  /// \param left The left-hand argument to be contracted
+  /// \param right The right-hand argument to be contracted
+  /// \param factor The scaling factor
+  /// \param gemm_config A helper object used to simplify gemm operations
+  /// \param inner_config The gemm helper for the inner tensors
+  /// \return A tile that is equal to <tt>result = (left * right) * factor</tt>
+  template <typename Result, typename Left, typename Right, typename Scalar,
+      typename std::enable_if<TiledArray::detail::is_numeric<Scalar>::value>::type* = nullptr>
+  inline Result& gemm(Result& result, const Left& left, const Right& right,
+            const Scalar factor, const math::GemmHelper& gemm_config,
+            const math::GemmHelper& inner_config)
+  {
+    return result.gemm(left, right, factor, gemm_config, inner_config);
+  }
+
 
   // Reduction operations ------------------------------------------------------
 
@@ -954,6 +1091,33 @@ namespace TiledArray {
   inline auto dot(const Left& left, const Right& right) -> decltype(left.dot(right))
   { return left.dot(right); }
 
+  /// Statistics of the elements of a tile
+
+  /// \tparam Arg The tile argument type
+  /// \param arg The argument tile
+  /// \param flags The selected statistics, a combination of
+  /// \c StatisticsFlags
+  /// \return The selected statistics of the elements of \c arg
+  template <typename Arg>
+  inline auto statistics(const Arg& arg, const unsigned int flags)
+      -> decltype(arg.statistics(flags))
+  { return arg.statistics(flags); }
+
+  /// Statistics of the elements of a tile, and its dot product with a tile
+
+  /// \tparam Left The left-hand argument type
+  /// \tparam Right The right-hand argument type
+  /// \param left The left-hand argument tile
+  /// \param right The right-hand argument tile of the dot product
+  /// \param flags The selected statistics, a combination of
+  /// \c StatisticsFlags
+  /// \return The selected statistics of the elements of \c left , and
+  /// <tt>sum_i left[i] * right[i]</tt>
+  template <typename Left, typename Right>
+  inline auto statistics(const Left& left, const Right& right,
+      const unsigned int flags) -> decltype(left.statistics(right, flags))
+  { return left.statistics(right, flags); }
+
   /** @}*/
 
 } // namespace TiledArray
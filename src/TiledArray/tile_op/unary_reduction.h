@@ -26,6 +26,7 @@
 #ifndef TILEDARRAY_TILE_OP_UNARY_REDUCTION_H__INCLUDED
 #define TILEDARRAY_TILE_OP_UNARY_REDUCTION_H__INCLUDED
 
+#include <TiledArray/tensor/statistics.h>
 #include <TiledArray/tile_op/tile_interface.h>
 
 namespace TiledArray {
@@ -290,6 +291,52 @@ namespace TiledArray {
 
   }; // class AbsMaxReduction
 
+  /// Tile statistics reduction
+
+  /// This reduction operation computes a set of statistics of the elements of
+  /// tiles (see \c Statistics ) in one pass over each tile.
+  /// \tparam Tile The tile type
+  template <typename Tile>
+  class StatisticsReduction {
+  public:
+    // typedefs
+    using result_type = decltype(statistics(std::declval<Tile>(), 0u));
+    typedef Tile argument_type;
+
+  private:
+    unsigned int flags_; ///< The selected statistics
+
+  public:
+
+    /// Constructor
+
+    /// \param flags The selected statistics, a combination of
+    /// \c StatisticsFlags
+    explicit StatisticsReduction(const unsigned int flags = stat_all & ~stat_dot) :
+      flags_(flags)
+    { }
+
+    // Reduction functions
+
+    // Make an empty result object
+    result_type operator()() const { return result_type(flags_); }
+
+    // Post process the result
+    const result_type& operator()(const result_type& result) const { return result; }
+
+    // Reduce two result objects
+    void operator()(result_type& result, const result_type& arg) const {
+      result.join(arg);
+    }
+
+    // Reduce an argument
+    void operator()(result_type& result, const argument_type& arg) const {
+      using TiledArray::statistics;
+      result.join(statistics(arg, flags_));
+    }
+
+  }; // class StatisticsReduction
+
 } // namespace TiledArray
 
 #endif // TILEDARRAY_TILE_OP_UNARY_REDUCTION_H__INCLUDED
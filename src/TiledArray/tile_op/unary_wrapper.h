@@ -134,6 +134,11 @@ namespace TiledArray {
       /// \return A reference to the permutation applied to the result tile
       const Permutation& permutation() const { return perm_; }
 
+      /// Base operation accessor
+
+      /// \return A const reference to the base tile operation
+      const Op& op() const { return op_; }
+
 
       /// Apply operator to `arg` and possibly permute the result
 
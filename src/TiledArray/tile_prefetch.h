@@ -0,0 +1,129 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_prefetch.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_PREFETCH_H__INCLUDED
+#define TILEDARRAY_TILE_PREFETCH_H__INCLUDED
+
+#include <TiledArray/madness.h>
+#include <TiledArray/error.h>
+#include <unordered_map>
+#include <vector>
+
+namespace TiledArray {
+
+  /// Prefetched tiles of an array
+
+  /// This object holds the futures of the tiles that were requested by
+  /// \c DistArray::prefetch . The tiles are cached locally until this object
+  /// is destroyed or \c release() is called, so the lifetime of the cache is
+  /// bound to the scope of this object. Tiles that were not prefetched are
+  /// fetched from the array on demand.
+  /// \tparam Array The array type
+  template <typename Array>
+  class TilePrefetch {
+  public:
+    typedef TilePrefetch<Array> TilePrefetch_; ///< This object type
+    typedef typename Array::size_type size_type; ///< Size type
+    typedef typename Array::value_type value_type; ///< Tile type
+    typedef Future<value_type> future; ///< Future tile type
+
+  private:
+    Array array_; ///< The array of the tiles
+    std::unordered_map<size_type, future> tiles_; ///< The prefetched tiles
+
+    TilePrefetch(const TilePrefetch_&) = delete;
+    TilePrefetch_& operator=(const TilePrefetch_&) = delete;
+
+  public:
+
+    /// Construct the cache of a set of tiles
+
+    /// \param array The array of the tiles
+    /// \param ords The ordinals of the tiles
+    /// \param tiles The futures to the tiles, in the order of \c ords
+    TilePrefetch(const Array& array, const std::vector<size_type>& ords,
+        const std::vector<future>& tiles) :
+      array_(array), tiles_(ords.size())
+    {
+      TA_ASSERT(ords.size() == tiles.size());
+      for(size_type j = 0ul; j < ords.size(); ++j)
+        tiles_.emplace(ords[j], tiles[j]);
+    }
+
+    TilePrefetch(TilePrefetch_&&) = default;
+    TilePrefetch_& operator=(TilePrefetch_&&) = default;
+
+    ~TilePrefetch() = default;
+
+    /// Find a tile
+
+    /// \tparam Index The index type
+    /// \param i The index or the ordinal of the tile
+    /// \return A \c future to tile \c i , which is taken from the cache if
+    /// the tile was prefetched
+    /// \throw TiledArray::Exception When tile \c i is zero
+    template <typename Index>
+    future find(const Index& i) const {
+      const auto it = tiles_.find(array_.trange().tiles_range().ordinal(i));
+      if(it != tiles_.end())
+        return it->second;
+      return array_.find(i);
+    }
+
+    /// Find a tile
+
+    /// \tparam Integer An integer type
+    /// \param i The tile index, as an \c std::initializer_list<Integer>
+    /// \return A \c future to tile \c i
+    /// \throw TiledArray::Exception When tile \c i is zero
+    template <typename Integer>
+    future find(const std::initializer_list<Integer>& i) const {
+      return find<std::initializer_list<Integer> >(i);
+    }
+
+    /// Prefetched tile query
+
+    /// \tparam Index The index type
+    /// \param i The index or the ordinal of the tile
+    /// \return \c true if tile \c i is held by this cache
+    template <typename Index>
+    bool contains(const Index& i) const {
+      return tiles_.count(array_.trange().tiles_range().ordinal(i)) != 0ul;
+    }
+
+    /// \return The number of prefetched tiles
+    size_type size() const { return tiles_.size(); }
+
+    /// Release the prefetched tiles
+
+    /// The local copies of remote tiles are freed once all other references
+    /// to them are released.
+    void release() { tiles_.clear(); }
+
+  }; // class TilePrefetch
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_PREFETCH_H__INCLUDED
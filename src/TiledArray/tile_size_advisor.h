@@ -0,0 +1,221 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_size_advisor.h
+ *  Oct 15, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_SIZE_ADVISOR_H__INCLUDED
+#define TILEDARRAY_TILE_SIZE_ADVISOR_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/math/blas.h>
+#include <TiledArray/tiled_range1.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace TiledArray {
+
+  /// GEMM throughput model for choosing tile sizes
+
+  /// The time of a tile contraction with \c b x \c b x \c b tiles is modeled
+  /// as <tt>overhead + 2 b^3 / flops</tt> , where \c overhead is the fixed
+  /// cost of a tile task (scheduling, dispatch and small-matrix
+  /// inefficiency) and \c flops is the GEMM throughput of one thread for
+  /// large tiles. The efficiency of a tile size is the fraction of the time
+  /// spent at full throughput. The default values are typical of one core of
+  /// a current CPU; \c measure() fits them to this machine.
+  struct TilingModel {
+    double flops = 1.0e10; ///< GEMM throughput of one thread, in flop/s
+    double overhead = 1.0e-5; ///< Fixed cost of a tile task, in seconds
+    double efficiency = 0.9; ///< The smallest acceptable efficiency of a tile size
+    std::size_t max_block_size = 512ul; ///< The largest tile size
+    std::size_t tiles_per_proc = 4ul; ///< Tiles per process row/column for load balance
+
+    /// Efficiency of a tile size
+
+    /// \param b The tile size
+    /// \return The fraction of the time of a \c b x \c b x \c b tile
+    /// contraction that is spent at full GEMM throughput
+    double block_efficiency(const std::size_t b) const {
+      const double t = 2.0 * double(b) * double(b) * double(b) / flops;
+      return t / (t + overhead);
+    }
+
+    /// Smallest efficient tile size
+
+    /// \return The smallest tile size with an efficiency of at least
+    /// \c efficiency , but no more than \c max_block_size
+    std::size_t min_block_size() const {
+      const double b3 = efficiency / (1.0 - efficiency) * overhead * flops * 0.5;
+      return std::min<std::size_t>(std::max<std::size_t>(
+          std::ceil(std::cbrt(b3)), 1ul), max_block_size);
+    }
+
+    /// Fit the model to the GEMM throughput of this machine
+
+    /// The throughput is measured with a \c n x \c n x \c n GEMM, and the
+    /// overhead with a 16 x 16 x 16 GEMM plus the cost of a task, which is
+    /// taken from the default model.
+    /// \param n The size of the large GEMM
+    /// \return A model with the measured throughput and overhead
+    static TilingModel measure(const std::size_t n = 256ul) {
+      TilingModel result;
+      const double large = time_gemm(n, 2ul);
+      result.flops = 2.0 * double(n) * double(n) * double(n) / large;
+      const double small = time_gemm(16ul, 100ul);
+      result.overhead += std::max(small - 2.0 * 16.0 * 16.0 * 16.0 / result.flops, 0.0);
+      return result;
+    }
+
+  private:
+
+    /// Time a square GEMM
+
+    /// \param n The matrix size
+    /// \param repeat The number of repetitions
+    /// \return The smallest time of one GEMM, in seconds
+    static double time_gemm(const std::size_t n, const std::size_t repeat) {
+      const std::vector<double> a(n * n, 1.0), b(n * n, 1.0);
+      std::vector<double> c(n * n, 0.0);
+      double result = std::numeric_limits<double>::max();
+      for(std::size_t r = 0ul; r < repeat; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans, n, n, n,
+            1.0, a.data(), n, b.data(), n, 1.0, c.data(), n);
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        result = std::min(result, time.count());
+      }
+      return std::max(result, 1.0e-9);
+    }
+
+  }; // struct TilingModel
+
+  /// Propose a tile size
+
+  /// Larger tiles give fewer messages and tasks, but there must be enough
+  /// non-zero tiles for all processes. The proposed size is the largest size
+  /// that gives each process row and column of a square process grid
+  /// \c model.tiles_per_proc non-zero tiles along the dimension, but no
+  /// less than the smallest efficient size of \c model and no more than
+  /// \c model.max_block_size .
+  /// \param extent The number of elements in the dimension
+  /// \param nprocs The number of processes
+  /// \param density The fraction of tiles that are non-zero [default = 1]
+  /// \param model The GEMM throughput model
+  /// \return The proposed number of elements in a tile
+  inline std::size_t advise_tile_size(const std::size_t extent,
+      const std::size_t nprocs, const double density = 1.0,
+      const TilingModel& model = TilingModel())
+  {
+    TA_USER_ASSERT(nprocs > 0ul,
+        "TiledArray::advise_tile_size(): The number of processes must be greater than zero.");
+    TA_USER_ASSERT((density > 0.0) && (density <= 1.0),
+        "TiledArray::advise_tile_size(): The density must be in (0,1].");
+
+    // With a fraction density of non-zero tiles, a matrix with n tiles per
+    // dimension has about density * n^2 non-zero tiles.
+    const double tiles = std::sqrt(double(nprocs) / density) * double(model.tiles_per_proc);
+    const std::size_t parallel = std::max<std::size_t>(double(extent) / tiles, 1ul);
+    return std::min<std::size_t>(std::max(model.min_block_size(),
+        std::min(parallel, model.max_block_size)), std::max<std::size_t>(extent, 1ul));
+  }
+
+  /// Propose uniform tile boundaries
+
+  /// \param lower The first element of the dimension
+  /// \param upper One past the last element of the dimension
+  /// \param nprocs The number of processes
+  /// \param density The fraction of tiles that are non-zero [default = 1]
+  /// \param model The GEMM throughput model
+  /// \return A tiling of <tt>[lower,upper)</tt> into tiles of about
+  /// <tt>advise_tile_size()</tt> elements, where the tile sizes differ by at
+  /// most one
+  inline TiledRange1 advise_tiling(const std::size_t lower,
+      const std::size_t upper, const std::size_t nprocs,
+      const double density = 1.0, const TilingModel& model = TilingModel())
+  {
+    TA_USER_ASSERT(lower < upper,
+        "TiledArray::advise_tiling(): The range must not be empty.");
+    const std::size_t extent = upper - lower;
+    const std::size_t size = advise_tile_size(extent, nprocs, density, model);
+    const std::size_t ntiles = std::max<std::size_t>(
+        std::llround(double(extent) / double(size)), 1ul);
+
+    std::vector<std::size_t> boundaries;
+    boundaries.reserve(ntiles + 1ul);
+    for(std::size_t t = 0ul; t <= ntiles; ++t)
+      boundaries.push_back(lower + (extent * t) / ntiles);
+    return TiledRange1(boundaries.begin(), boundaries.end());
+  }
+
+  /// Propose tile boundaries that follow a block structure
+
+  /// The proposed boundaries are a subset of the boundaries of
+  /// \c structure , so blocks of the structure are never split. This keeps
+  /// the blocks of a sparse structure (e.g. atoms or shells, or the current
+  /// tiling of a sparse array) intact, so zero blocks are not merged into
+  /// tiles that are mostly zero. Each tile ends at the boundary closest to
+  /// <tt>advise_tile_size()</tt> elements from its start.
+  /// \param structure The block structure of the dimension
+  /// \param nprocs The number of processes
+  /// \param density The fraction of tiles that are non-zero [default = 1]
+  /// \param model The GEMM throughput model
+  /// \return A coarsening of \c structure
+  inline TiledRange1 advise_tiling(const TiledRange1& structure,
+      const std::size_t nprocs, const double density = 1.0,
+      const TilingModel& model = TilingModel())
+  {
+    const std::size_t size = advise_tile_size(structure.extent(), nprocs,
+        density, model);
+
+    std::vector<std::size_t> boundaries(1ul, structure.elements_range().first);
+    for(auto it = structure.begin(); it != structure.end(); ++it) {
+      const std::size_t start = boundaries.back();
+      if(it->second - start < size)
+        continue;
+
+      // Choose this boundary or the previous one, whichever is closer to the
+      // target size
+      const std::size_t previous = it->first;
+      if((previous > start) && (size - (previous - start) < (it->second - start) - size))
+        boundaries.push_back(previous);
+      if(it->second - boundaries.back() >= size)
+        boundaries.push_back(it->second);
+    }
+    if(boundaries.back() != structure.elements_range().second) {
+      // Merge a short last tile into the previous one
+      if((boundaries.size() > 1ul) &&
+          (structure.elements_range().second - boundaries.back() < size / 2ul))
+        boundaries.back() = structure.elements_range().second;
+      else
+        boundaries.push_back(structure.elements_range().second);
+    }
+
+    return TiledRange1(boundaries.begin(), boundaries.end());
+  }
+
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_SIZE_ADVISOR_H__INCLUDED
@@ -0,0 +1,380 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_spill.h
+ *  Oct 14, 2016
+ *
+ */
+
+#ifndef TILEDARRAY_TILE_SPILL_H__INCLUDED
+#define TILEDARRAY_TILE_SPILL_H__INCLUDED
+
+#include <TiledArray/error.h>
+#include <TiledArray/madness.h>
+#include <TiledArray/profiler.h>
+#include <cstdlib>
+#include <list>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace TiledArray {
+
+  /// Out-of-core tile storage policy
+
+  /// When spilling is enabled, the local tiles of distributed storage objects
+  /// that are constructed afterwards are tracked in a least-recently-used
+  /// (LRU) list. When the tracked tiles hold more than the memory cap, the
+  /// least recently used tiles are written to memory-mapped files in the
+  /// spill directory and removed from the storage. Spilled tiles are read back
+  /// in a task when they are accessed again. Spilling is disabled by default;
+  /// it is enabled with \c enable() or by setting the \c TA_SPILL_DIR
+  /// environment variable, where the memory cap (in bytes) is given by
+  /// \c TA_SPILL_MEMORY (default = 1 GiB).
+  /// \note The memory of a spilled tile is only released when all other
+  /// copies of the tile, e.g. those held by tasks, have been destroyed.
+  /// \note There is one spill policy per process, so the memory cap applies to
+  /// the tiles of all arrays of this process.
+  class TileSpill {
+  public:
+    typedef std::size_t size_type; ///< Size type
+
+    /// Spill client interface
+
+    /// Clients own the tiles that are tracked by the spill policy.
+    class Client {
+    public:
+      virtual ~Client() { }
+
+      /// Spill a tile
+
+      /// \param key The key of the tile to be spilled
+      virtual void spill(const size_type key) = 0;
+    }; // class Client
+
+  private:
+
+    typedef std::pair<Client*, size_type> entry_type;
+    typedef std::list<entry_type> list_type;
+
+    /// The hash function of an entry
+    struct hash_entry {
+      std::size_t operator()(const entry_type& entry) const {
+        return std::hash<Client*>()(entry.first) ^ (entry.second * 0x9e3779b97f4a7c15ul);
+      }
+    }; // struct hash_entry
+
+    /// The location and size of a tracked tile
+    struct Position {
+      list_type::iterator iterator; ///< The position of the tile in the LRU list
+      size_type bytes; ///< The size of the tile
+    }; // struct Position
+
+    typedef std::unordered_map<entry_type, Position, hash_entry> map_type;
+
+    bool enabled_; ///< Spilling flag
+    std::string directory_; ///< The spill directory
+    size_type memory_cap_; ///< The maximum number of bytes held by tracked tiles
+    size_type bytes_; ///< The number of bytes held by tracked tiles
+    mutable madness::Mutex lock_; ///< Lock for the LRU list
+    list_type lru_; ///< The tracked tiles, from the most to least recently used
+    map_type positions_; ///< Tracked tile positions
+
+    TileSpill() :
+      enabled_(getenv("TA_SPILL_DIR") != nullptr),
+      directory_(enabled_ ? getenv("TA_SPILL_DIR") : "."),
+      memory_cap_(getenv("TA_SPILL_MEMORY") ?
+          std::strtoul(getenv("TA_SPILL_MEMORY"), nullptr, 10) : (1ul << 30)),
+      bytes_(0ul), lock_(), lru_(), positions_()
+    { }
+
+    TileSpill(const TileSpill&) = delete;
+    TileSpill& operator=(const TileSpill&) = delete;
+
+    /// Remove a tracked tile
+
+    /// \param it The position of the tile
+    /// \note The caller must hold \c lock_ .
+    void erase(const map_type::iterator& it) {
+      bytes_ -= it->second.bytes;
+      lru_.erase(it->second.iterator);
+      positions_.erase(it);
+    }
+
+  public:
+
+    /// Spill policy accessor
+
+    /// \return A reference to the spill policy of this process
+    static TileSpill& instance() {
+      static TileSpill* const spill = new TileSpill();
+      return *spill;
+    }
+
+    /// Enable spilling
+
+    /// Only storage objects that are constructed after this call spill tiles.
+    /// \param directory The spill directory, which should be on a local disk
+    /// \param memory_cap The maximum number of bytes held by the local tiles
+    void enable(const std::string& directory, const size_type memory_cap) {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      directory_ = directory;
+      memory_cap_ = memory_cap;
+      enabled_ = true;
+    }
+
+    /// Disable spilling
+
+    /// Storage objects that were constructed while spilling was enabled
+    /// continue to spill tiles.
+    void disable() {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      enabled_ = false;
+    }
+
+    /// Spilling status
+
+    /// \return \c true if new storage objects spill tiles
+    bool enabled() const {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      return enabled_;
+    }
+
+    /// Spill directory accessor
+
+    /// \return The directory of the spill files
+    std::string directory() const {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      return directory_;
+    }
+
+    /// Memory cap accessor
+
+    /// \return The maximum number of bytes held by tracked tiles
+    size_type memory_cap() const {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      return memory_cap_;
+    }
+
+    /// Tracked memory accessor
+
+    /// \return The number of bytes held by tracked tiles
+    size_type bytes() const {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      return bytes_;
+    }
+
+    /// Mark a tile as used
+
+    /// The tile is moved to the front of the LRU list, or inserted if it is
+    /// not tracked. Least recently used tiles are then spilled until the
+    /// tracked tiles fit in the memory cap, where the tile \c key is never
+    /// spilled.
+    /// \param client The owner of the tile
+    /// \param key The key of the tile
+    /// \param bytes The size of the tile
+    /// \note The caller must not hold any lock of \c client that is
+    /// acquired by <tt>Client::spill()</tt> .
+    void touch(Client* const client, const size_type key, const size_type bytes) {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+
+      const entry_type entry(client, key);
+      auto it = positions_.find(entry);
+      if(it != positions_.end()) {
+        lru_.splice(lru_.begin(), lru_, it->second.iterator);
+      } else {
+        lru_.push_front(entry);
+        positions_.emplace(entry, Position{ lru_.begin(), bytes });
+        bytes_ += bytes;
+      }
+
+      // Spill the least recently used tiles. The lock is held while tiles are
+      // spilled, so clients cannot be destroyed while they spill a tile.
+      while((bytes_ > memory_cap_) && (lru_.size() > 1ul)) {
+        const entry_type victim = lru_.back();
+        erase(positions_.find(victim));
+        victim.first->spill(victim.second);
+      }
+    }
+
+    /// Stop tracking a tile
+
+    /// \param client The owner of the tile
+    /// \param key The key of the tile
+    void remove(Client* const client, const size_type key) {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      auto it = positions_.find(entry_type(client, key));
+      if(it != positions_.end())
+        erase(it);
+    }
+
+    /// Stop tracking the tiles of a client
+
+    /// \param client The client that is removed
+    void remove(Client* const client) {
+      madness::ScopedMutex<madness::Mutex> locker(&lock_);
+      for(auto it = lru_.begin(); it != lru_.end();) {
+        const entry_type entry = *it++;
+        if(entry.first == client)
+          erase(positions_.find(entry));
+      }
+    }
+
+  }; // class TileSpill
+
+  namespace detail {
+
+    /// Memory-mapped spill file
+
+    /// Tiles are serialized into a file in the spill directory, which is
+    /// removed from the file system when the spill file is constructed, so it
+    /// is deleted when this object is destroyed or the process exits. Since
+    /// tiles do not change once they are set, each tile is written only once
+    /// and its data is reused when the tile is spilled again.
+    /// \tparam T The tile type
+    template <typename T>
+    class SpillFile {
+    public:
+      typedef std::size_t size_type; ///< Size type
+      typedef T value_type; ///< Tile type
+
+    private:
+      int fd_; ///< The file descriptor
+      size_type size_; ///< The size of the file
+      mutable madness::Spinlock lock_; ///< Lock for the tile positions
+      std::unordered_map<size_type, std::pair<size_type, size_type> > tiles_; ///< Tile offsets and sizes
+
+      SpillFile(const SpillFile&) = delete;
+      SpillFile& operator=(const SpillFile&) = delete;
+
+      /// Map a range of the file into memory
+
+      /// \param offset The offset of the range
+      /// \param size The size of the range
+      /// \param prot The memory protection flags
+      /// \return A pair of the mapped address and the aligned offset
+      std::pair<unsigned char*, size_type>
+      map(const size_type offset, const size_type size, const int prot) const {
+        static const size_type page_size = sysconf(_SC_PAGESIZE);
+        const size_type aligned_offset = offset - (offset % page_size);
+        void* const pointer = mmap(nullptr, size + (offset - aligned_offset),
+            prot, MAP_SHARED, fd_, aligned_offset);
+        if(pointer == MAP_FAILED)
+          TA_EXCEPTION("SpillFile: Unable to map the spill file.");
+        return std::make_pair(static_cast<unsigned char*>(pointer), aligned_offset);
+      }
+
+    public:
+
+      /// Constructor
+
+      /// \param directory The spill directory
+      explicit SpillFile(const std::string& directory) :
+        fd_(-1), size_(0ul), lock_(), tiles_()
+      {
+        static madness::AtomicInt count;
+        std::stringstream ss;
+        ss << directory << "/ta_spill." << getpid() << "." << count++;
+        const std::string name = ss.str();
+        fd_ = open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if(fd_ < 0)
+          TA_EXCEPTION("SpillFile: Unable to create the spill file.");
+        unlink(name.c_str());
+      }
+
+      ~SpillFile() { close(fd_); }
+
+      /// Tile query
+
+      /// \param key The key of the tile
+      /// \return \c true if the tile has been written to this file
+      bool contains(const size_type key) const {
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        return tiles_.find(key) != tiles_.end();
+      }
+
+      /// Write a tile
+
+      /// Nothing is done if the tile has already been written.
+      /// \param key The key of the tile
+      /// \param value The tile
+      /// \throw TiledArray::Exception When the file cannot be written
+      void write(const size_type key, const value_type& value) {
+        if(contains(key))
+          return;
+
+        madness::archive::BufferOutputArchive count_ar;
+        count_ar & value;
+        const size_type size = count_ar.size();
+
+        size_type offset = 0ul;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          offset = size_;
+          size_ += size;
+          if(ftruncate(fd_, size_) != 0)
+            TA_EXCEPTION("SpillFile: Unable to resize the spill file.");
+        }
+
+        const std::pair<unsigned char*, size_type> region =
+            map(offset, size, PROT_READ | PROT_WRITE);
+        madness::archive::BufferOutputArchive ar(region.first + (offset - region.second), size);
+        ar & value;
+        munmap(region.first, size + (offset - region.second));
+
+        madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+        tiles_.emplace(key, std::make_pair(offset, size));
+      }
+
+      /// Read a tile
+
+      /// \param key The key of the tile
+      /// \return The tile
+      /// \throw TiledArray::Exception When the tile has not been written
+      value_type read(const size_type key) const {
+        std::pair<size_type, size_type> position;
+        {
+          madness::ScopedMutex<madness::Spinlock> locker(&lock_);
+          auto it = tiles_.find(key);
+          TA_ASSERT(it != tiles_.end());
+          position = it->second;
+        }
+
+        const std::pair<unsigned char*, size_type> region =
+            map(position.first, position.second, PROT_READ);
+        value_type value;
+        madness::archive::BufferInputArchive ar(
+            region.first + (position.first - region.second), position.second);
+        ar & value;
+        munmap(region.first, position.second + (position.first - region.second));
+
+        return value;
+      }
+
+    }; // class SpillFile
+
+  } // namespace detail
+} // namespace TiledArray
+
+#endif // TILEDARRAY_TILE_SPILL_H__INCLUDED
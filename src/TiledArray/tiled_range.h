@@ -22,12 +22,15 @@
 
 #include <TiledArray/tiled_range1.h>
 #include <TiledArray/range.h>
+#include <memory>
 
 namespace TiledArray {
 
   /// Range data of a tiled array
 
-  /// TiledRange is a direct (Cartesian) product of 1-dimensional tiled ranges (TiledRange1)
+  /// TiledRange is a direct (Cartesian) product of 1-dimensional tiled ranges (TiledRange1).
+  /// The ranges of all tiles may be precomputed with \c cache_tile_ranges() ;
+  /// the table is shared by copies of the tiled range.
   class TiledRange {
   private:
 
@@ -69,33 +72,36 @@ namespace TiledArray {
     typedef std::vector<TiledRange1> Ranges;
 
     /// Default constructor
-    TiledRange() : range_(), elements_range_(), ranges_() { }
+    TiledRange() : range_(), elements_range_(), ranges_(), tile_ranges_() { }
 
     /// Constructed with a set of ranges pointed to by [ first, last ).
     template <typename InIter>
     TiledRange(InIter first, InIter last) :
-      range_(), elements_range_(), ranges_(first, last)
+      range_(), elements_range_(), ranges_(first, last), tile_ranges_()
     {
       init();
     }
 
     /// Constructed with a set of ranges pointed to by [ first, last ).
     TiledRange(const std::initializer_list<std::initializer_list<size_type> >& list) :
-      range_(), elements_range_(), ranges_(list.begin(), list.end())
+      range_(), elements_range_(), ranges_(list.begin(), list.end()),
+      tile_ranges_()
     {
       init();
     }
 
     /// Constructed with an initializer_list of TiledRange1's
     TiledRange(const std::initializer_list<TiledRange1>& list) :
-      range_(), elements_range_(), ranges_(list.begin(), list.end())
+      range_(), elements_range_(), ranges_(list.begin(), list.end()),
+      tile_ranges_()
     {
       init();
     }
 
     /// Copy constructor
     TiledRange(const TiledRange_& other) :
-        range_(other.range_), elements_range_(other.elements_range_), ranges_(other.ranges_)
+        range_(other.range_), elements_range_(other.elements_range_),
+        ranges_(other.ranges_), tile_ranges_(other.tile_ranges_)
     { }
 
     /// TiledRange assignment operator
@@ -113,10 +119,40 @@ namespace TiledArray {
     TiledRange_& operator *=(const Permutation& p) {
       TA_ASSERT(p.dim() == range_.rank());
       Ranges temp = p * ranges_;
+      const bool cached = bool(tile_ranges_);
       TiledRange(temp.begin(), temp.end()).swap(*this);
+      if(cached)
+        cache_tile_ranges();
       return *this;
     }
 
+    /// Precompute the ranges of all tiles
+
+    /// After this call, \c make_tile_range() copies the tile range from a
+    /// table instead of constructing it. The table is shared with copies of
+    /// this object that are made after this call. This is useful when there
+    /// are many tiles, at the cost of one \c Range object per tile.
+    /// \note This function is not thread safe with respect to other member
+    /// functions of this object.
+    void cache_tile_ranges() {
+      if(tile_ranges_)
+        return;
+
+      const size_type n = range_.volume();
+      std::shared_ptr<std::vector<tiles_range_type> > tile_ranges =
+          std::make_shared<std::vector<tiles_range_type> >();
+      tile_ranges->reserve(n);
+      for(const auto& index : range_)
+        tile_ranges->push_back(build_tile_range(index));
+      tile_ranges_ = tile_ranges;
+    }
+
+    /// Check for a precomputed tile range table
+
+    /// \return \c true if the tile ranges have been precomputed by
+    /// \c cache_tile_ranges()
+    bool tile_ranges_cached() const { return bool(tile_ranges_); }
+
     /// Access the tile range
 
     /// \return A const reference to the tile range object
@@ -165,7 +201,9 @@ namespace TiledArray {
     /// \return The constructed range object
     tiles_range_type make_tile_range(const size_type& i) const {
       TA_ASSERT(tiles_range().includes(i));
-      return make_tile_range(tiles_range().idx(i));
+      if(tile_ranges_)
+        return (*tile_ranges_)[i];
+      return build_tile_range(tiles_range().idx(i));
     }
 
     /// Construct a range for the tile indexed by the given index.
@@ -190,9 +228,22 @@ namespace TiledArray {
     template <typename Index>
     typename std::enable_if<! std::is_integral<Index>::value, tiles_range_type>::type
     make_tile_range(const Index& index) const {
-      const auto rank = range_.rank();
-      TA_ASSERT(index.size() == rank);
+      TA_ASSERT(index.size() == range_.rank());
       TA_ASSERT(range_.includes(index));
+      if(tile_ranges_)
+        return (*tile_ranges_)[range_.ordinal(index)];
+      return build_tile_range(index);
+    }
+
+  private:
+
+    /// Construct the range of the tile indexed by the given index
+
+    /// \param index The index of the tile range to be constructed
+    /// \return The constructed range object
+    template <typename Index>
+    tiles_range_type build_tile_range(const Index& index) const {
+      const auto rank = range_.rank();
       typename tiles_range_type::index lower;
       typename tiles_range_type::index upper;
       lower.reserve(rank);
@@ -207,6 +258,8 @@ namespace TiledArray {
       return tiles_range_type(lower, upper);
     }
 
+  public:
+
     /// Construct a range for the tile indexed by the given index.
 
     /// \param index The tile index, given as a \c std::initializer_list
@@ -273,12 +326,14 @@ namespace TiledArray {
       range_.swap(other.range_);
       elements_range_.swap(other.elements_range_);
       std::swap(ranges_, other.ranges_);
+      std::swap(tile_ranges_, other.tile_ranges_);
     }
 
   private:
     range_type range_; ///< Stores information on tile indexing for the range.
     tiles_range_type elements_range_; ///< Stores information on element indexing for the range.
     Ranges ranges_; ///< Stores tile boundaries for each dimension.
+    std::shared_ptr<const std::vector<tiles_range_type> > tile_ranges_; ///< Precomputed tile ranges (optional).
   };
 
   /// TiledRange permutation operator.
@@ -23,6 +23,7 @@
 #include <TiledArray/error.h>
 #include <TiledArray/type_traits.h>
 #include <vector>
+#include <memory>
 #include <initializer_list>
 
 namespace TiledArray {
@@ -32,6 +33,10 @@ namespace TiledArray {
   /// the format {a0, a1, a2, ...}, where 0 <= a0 < a1 < a2 < ... Each tile is
   /// defined as [a0,a1), [a1,a2), ... The number of tiles in the range will be
   /// equal to one less than the number of elements in the array.
+  /// Element indices of uniform tilings (i.e. all tiles but the last have the
+  /// same size, and the last is no larger) are mapped to tile indices
+  /// arithmetically; otherwise an element to tile table is used, which is
+  /// shared by copies of the range.
   class TiledRange1 {
   private:
     struct Enabler { };
@@ -43,7 +48,7 @@ namespace TiledArray {
     /// Default constructor, range of 0 tiles and elements.
     TiledRange1() :
         range_(0,0), elements_range_(0,0),
-        tiles_ranges_(1, range_type(0,0)), elem2tile_(1, 0)
+        tiles_ranges_(1, range_type(0,0)), tile_size_(0), elem2tile_()
     {
       init_map_();
     }
@@ -53,7 +58,8 @@ namespace TiledArray {
     template <typename RandIter,
         typename std::enable_if<detail::is_random_iterator<RandIter>::value>::type* = nullptr>
     TiledRange1(RandIter first, RandIter last) :
-        range_(), elements_range_(), tiles_ranges_(), elem2tile_()
+        range_(), elements_range_(), tiles_ranges_(), tile_size_(0),
+        elem2tile_()
     {
       init_tiles_(first, last, 0);
       init_map_();
@@ -62,7 +68,8 @@ namespace TiledArray {
     /// Copy constructor
     TiledRange1(const TiledRange1& rng) :
         range_(rng.range_), elements_range_(rng.elements_range_),
-        tiles_ranges_(rng.tiles_ranges_), elem2tile_(rng.elem2tile_)
+        tiles_ranges_(rng.tiles_ranges_), tile_size_(rng.tile_size_),
+        elem2tile_(rng.elem2tile_)
     { }
 
     /// Construct a 1D tiled range.
@@ -73,7 +80,8 @@ namespace TiledArray {
     /// \param t0 The starting index of the first tile
     /// \param t_rest The rest of tile boundaries
     template<typename... _sizes>
-    explicit TiledRange1(const size_type& t0, const _sizes&... t_rest)
+    explicit TiledRange1(const size_type& t0, const _sizes&... t_rest) :
+        tile_size_(0)
     {
       const size_type n = sizeof...(_sizes) + 1;
       size_type tile_boundaries[n] = {t0, static_cast<size_type>(t_rest)...};
@@ -87,7 +95,8 @@ namespace TiledArray {
     /// The number of tile boundaries is n + 1, where n is the number of tiles.
     /// Tiles are defined as [t0, t1), [t1, t2), [t2, t3), ...
     /// \param list The list of tile boundaries in order from smallest to largest
-    explicit TiledRange1(const std::initializer_list<size_type>& list)
+    explicit TiledRange1(const std::initializer_list<size_type>& list) :
+        tile_size_(0)
     {
       init_tiles_(list.begin(), list.end(), 0);
       init_map_();
@@ -146,12 +155,24 @@ namespace TiledArray {
       return tiles_ranges_[i - range_.first];
     }
 
-    const size_type& element_to_tile(const size_type& i) const {
+    /// Element to tile index map
+
+    /// This is O(1) for all tilings.
+    /// \param i The element index
+    /// \return The index of the tile that contains element \c i
+    size_type element_to_tile(const size_type& i) const {
       TA_ASSERT( includes(elements_range_, i) );
-      return elem2tile_[i - elements_range_.first];
+      const size_type e = i - elements_range_.first;
+      return (tile_size_ ? range_.first + e / tile_size_ : (*elem2tile_)[e]);
     }
 
-    DEPRECATED const size_type& element2tile(const size_type& i) const {
+    /// Uniform tile size accessor
+
+    /// \return The size of all tiles but the last, if the tiling is uniform,
+    /// otherwise zero
+    size_type uniform_tile_size() const { return tile_size_; }
+
+    DEPRECATED size_type element2tile(const size_type& i) const {
       return element_to_tile(i);
     }
 
@@ -159,6 +180,7 @@ namespace TiledArray {
       std::swap(range_, other.range_);
       std::swap(elements_range_, other.elements_range_);
       std::swap(tiles_ranges_, other.tiles_ranges_);
+      std::swap(tile_size_, other.tile_size_);
       std::swap(elem2tile_, other.elem2tile_);
     }
 
@@ -194,16 +216,34 @@ namespace TiledArray {
 
     /// Initialize secondary data
     void init_map_() {
+      tile_size_ = 0;
+      elem2tile_.reset();
+
       // check for 0 size range.
       if((elements_range_.second - elements_range_.first) == 0)
         return;
 
-      // initialize elem2tile map
-      elem2tile_.resize(elements_range_.second - elements_range_.first);
+      // Check for a uniform tiling, where the last tile may be smaller
       const size_type end = range_.second - range_.first;
-      for(size_type t = 0; t < end; ++t)
+      const size_type size = tiles_ranges_.front().second - tiles_ranges_.front().first;
+      size_type t = 1;
+      for(; t < (end - 1); ++t)
+        if((tiles_ranges_[t].second - tiles_ranges_[t].first) != size)
+          break;
+      if((t >= (end - 1)) &&
+          ((tiles_ranges_.back().second - tiles_ranges_.back().first) <= size)) {
+        tile_size_ = size;
+        return;
+      }
+
+      // initialize elem2tile map
+      std::shared_ptr<std::vector<size_type> > elem2tile =
+          std::make_shared<std::vector<size_type> >(
+          elements_range_.second - elements_range_.first);
+      for(t = 0; t < end; ++t)
         for(size_type e = tiles_ranges_[t].first; e < tiles_ranges_[t].second; ++e)
-          elem2tile_[e - elements_range_.first] = t + range_.first;
+          (*elem2tile)[e - elements_range_.first] = t + range_.first;
+      elem2tile_ = elem2tile;
     }
 
     friend std::ostream& operator <<(std::ostream&, const TiledRange1&);
@@ -212,7 +252,8 @@ namespace TiledArray {
     range_type range_; ///< the range of tile indices
     range_type elements_range_; ///< the range of element indices
     std::vector<range_type> tiles_ranges_; ///< ranges of each tile.
-    std::vector<size_type> elem2tile_; ///< maps element index to tile index (secondary data).
+    size_type tile_size_; ///< the size of uniform tiles, or zero (secondary data).
+    std::shared_ptr<const std::vector<size_type> > elem2tile_; ///< maps element index to tile index for non-uniform tilings (secondary data).
 
   }; // class TiledRange1
 
@@ -31,29 +31,65 @@
 // Array policy classes
 #include <TiledArray/policies/dense_policy.h>
 #include <TiledArray/policies/sparse_policy.h>
+#include <TiledArray/policies/compressed_sparse_policy.h>
+#include <TiledArray/policies/bitset_sparse_policy.h>
 
 // Expression functionality
 #include <TiledArray/expressions/scal_expr.h>
 #include <TiledArray/expressions/tsr_expr.h>
+#include <TiledArray/expressions/expr_cache.h>
 #include <TiledArray/conversions/sparse_to_dense.h>
 #include <TiledArray/conversions/dense_to_sparse.h>
 #include <TiledArray/conversions/to_new_tile_type.h>
 #include <TiledArray/conversions/truncate.h>
 #include <TiledArray/conversions/foreach.h>
 #include <TiledArray/conversions/make_array.h>
+#include <TiledArray/direct_tile.h>
+#include <TiledArray/quantized_tile.h>
 
 // Special Arrays
 #include <TiledArray/special/diagonal_array.h>
+#include <TiledArray/symm_array.h>
+#include <TiledArray/spin_array.h>
 
 // Process maps
 #include <TiledArray/pmap/hash_pmap.h>
+#include <TiledArray/pmap/morton_pmap.h>
+#include <TiledArray/pmap/pmap_analysis.h>
 #include <TiledArray/pmap/replicated_pmap.h>
+#include <TiledArray/pmap/weighted_pmap.h>
 
 // Utility functionality
 #include <TiledArray/conversions/eigen.h>
+#include <TiledArray/conversions/block_cyclic.h>
+#include <TiledArray/conversions/block_gather.h>
+#include <TiledArray/conversions/redistribute.h>
+#include <TiledArray/conversions/reshape.h>
+#include <TiledArray/conversions/retile.h>
+#include <TiledArray/sub_world.h>
+#include <TiledArray/conversions/elements.h>
+#include <TiledArray/tile_accumulator.h>
+#include <TiledArray/tile_size_advisor.h>
+#include <TiledArray/checkpoint.h>
+#include <TiledArray/memory_governor.h>
+#include <TiledArray/memory_tracker.h>
+#include <TiledArray/comm_tracker.h>
+#include <TiledArray/region_timer.h>
 
 // Linear algebra
+#include <TiledArray/algebra/ao_to_mo.h>
+#include <TiledArray/algebra/batched_contract.h>
+#include <TiledArray/algebra/cholesky.h>
 #include <TiledArray/algebra/conjgrad.h>
+#include <TiledArray/algebra/davidson.h>
+#include <TiledArray/algebra/df_exchange.h>
+#include <TiledArray/algebra/energy_denominator.h>
+#include <TiledArray/algebra/gmres.h>
+#include <TiledArray/algebra/heig.h>
+#include <TiledArray/algebra/incremental_eval.h>
+#include <TiledArray/algebra/multi_contract.h>
+#include <TiledArray/algebra/pipelined_conjgrad.h>
+#include <TiledArray/algebra/svd.h>
 #include "TiledArray/dist_array.h"
 
 #ifdef TILEDARRAY_HAS_ELEMENTAL
@@ -29,6 +29,10 @@ namespace Eigen { // Eigen Alligned allocator for TA::Tensor
 
 namespace TiledArray {
 
+  // TiledArray pooled tile allocator
+  template <class>
+  class PoolAllocator;
+
   //TiledArray Policy
   class DensePolicy;
   class SparsePolicy;
@@ -43,6 +47,8 @@ namespace TiledArray {
   typedef Tensor<long, Eigen::aligned_allocator<long> > TensorL;
   typedef Tensor<std::complex<double>, Eigen::aligned_allocator<std::complex<double> > > TensorZ;
   typedef Tensor<std::complex<float>, Eigen::aligned_allocator<std::complex<float> > > TensorC;
+  typedef Tensor<double, PoolAllocator<double> > TensorPoolD;
+  typedef Tensor<float, PoolAllocator<float> > TensorPoolF;
 
   // TiledArray Arrays
   template <typename, typename> class DistArray;
@@ -0,0 +1,114 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  ao_to_mo.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct AOToMOFixture {
+  AOToMOFixture() :
+    world(*GlobalFixture::world),
+    trao{0, 2, 5, 6}, tro{0, 2}, trv{0, 3, 4}
+  {
+    eri = TArrayD(world, TiledRange{trao, trao, trao, trao});
+    c_occ = TArrayD(world, TiledRange{trao, tro});
+    c_vir = TArrayD(world, TiledRange{trao, trv});
+    fill(eri, [] (const Range::index& i) {
+      return 1.0 / double(1ul + i[0] + 2ul * i[1] + 3ul * i[2] + 4ul * i[3]);
+    });
+    fill(c_occ, [] (const Range::index& i) {
+      return double(int(i[0]) - int(i[1])) * 0.5;
+    });
+    fill(c_vir, [] (const Range::index& i) {
+      return double(i[0] * i[1] + 1ul) * 0.125;
+    });
+  }
+
+  // Set the local tiles of an array with op
+  template <typename Array, typename Op>
+  static void fill(Array& array, const Op& op) {
+    for(const auto t : *array.pmap()) {
+      TensorD tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = op(index);
+      array.set(t, tile);
+    }
+  }
+
+  // Compare a transform to the chained contractions
+  void check(const TArrayD& mo) {
+    TArrayD ref;
+    ref("i,j,k,l") = eri("p,q,r,s") * c_occ("p,i") * c_vir("q,j")
+        * c_occ("r,k") * c_vir("s,l");
+
+    BOOST_CHECK_EQUAL(mo.trange(), ref.trange());
+    for(const auto t : *mo.pmap()) {
+      const TensorD tile = mo.find(t).get();
+      const TensorD ref_tile = ref.find(t).get();
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_CLOSE(tile[i], ref_tile[i], 1.0e-8);
+    }
+  }
+
+  World& world;
+  TiledRange1 trao, tro, trv;
+  TArrayD eri, c_occ, c_vir;
+}; // AOToMOFixture
+
+BOOST_FIXTURE_TEST_SUITE( ao_to_mo_suite, AOToMOFixture )
+
+BOOST_AUTO_TEST_CASE( order )
+{
+  // The dimension with the smallest MO size is transformed first
+  const std::array<unsigned int, 4> order = detail::quarter_transform_order(
+      std::array<std::size_t, 4>{{ 10ul, 10ul, 10ul, 10ul }},
+      std::array<std::size_t, 4>{{ 8ul, 8ul, 2ul, 4ul }});
+  BOOST_CHECK_EQUAL(order[0], 2u);
+  BOOST_CHECK_EQUAL(order[1], 3u);
+}
+
+BOOST_AUTO_TEST_CASE( one_batch )
+{
+  check(ao_to_mo(eri, c_occ, c_vir, c_occ, c_vir));
+}
+
+BOOST_AUTO_TEST_CASE( batches )
+{
+  // One tile of the batch dimension per batch
+  check(ao_to_mo(eri, c_occ, c_vir, c_occ, c_vir, 1ul));
+}
+
+BOOST_AUTO_TEST_CASE( invalid_args )
+{
+  TArrayD c(world, TiledRange{trv, tro});
+  BOOST_CHECK_THROW(ao_to_mo(eri, c_occ, c, c_occ, c_vir), TiledArray::Exception);
+  BOOST_CHECK_THROW(ao_to_mo(c_occ, c_occ, c_vir, c_occ, c_vir),
+      TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
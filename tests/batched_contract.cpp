@@ -0,0 +1,183 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  batched_contract.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct BatchedContractFixture {
+  BatchedContractFixture() :
+    world(*GlobalFixture::world),
+    tri{0, 2, 5}, trj{0, 3, 4, 7}, trl{0, 4, 6}, trk{0, 1, 5}
+  { }
+
+  static int a_value(const std::size_t i, const std::size_t j, const std::size_t l) {
+    return int(i + 2ul * j + 3ul * l);
+  }
+
+  static int b_value(const std::size_t j, const std::size_t l, const std::size_t k) {
+    return int(j + 2ul * k) - int(l);
+  }
+
+  // c(i,j,k) = sum_l a(i,j,l) * b(j,l,k)
+  static int c_value(const std::size_t i, const std::size_t j, const std::size_t k) {
+    int result = 0;
+    for(std::size_t l = 0ul; l < 6ul; ++l)
+      result += a_value(i, j, l) * b_value(j, l, k);
+    return result;
+  }
+
+  // Set the non-zero local tiles of an array with op
+  template <typename Array, typename Op>
+  static void fill(Array& array, const Op& op) {
+    for(const auto t : *array.pmap()) {
+      if(array.is_zero(t))
+        continue;
+      TensorI tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = op(index[0], index[1], index[2]);
+      array.set(t, tile);
+    }
+  }
+
+  World& world;
+  TiledRange1 tri, trj, trl, trk;
+}; // BatchedContractFixture
+
+BOOST_FIXTURE_TEST_SUITE( batched_contract_suite, BatchedContractFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TArrayI a(world, TiledRange{tri, trj, trl});
+  TArrayI b(world, TiledRange{trj, trl, trk});
+  fill(a, & a_value);
+  fill(b, & b_value);
+
+  TArrayI c;
+  BOOST_REQUIRE_NO_THROW(c = batched_contract(a, "i,j,l", b, "j,l,k", "i,j,k"));
+  BOOST_CHECK_EQUAL(c.trange(), (TiledRange{tri, trj, trk}));
+  for(const auto t : *c.pmap()) {
+    const TensorI tile = c.find(t).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], c_value(index[0], index[1], index[2]));
+  }
+
+  // A result order that differs from the kernel order
+  TArrayI ct = batched_contract(a, "i,j,l", b, "j,l,k", "k,j,i");
+  BOOST_CHECK_EQUAL(ct.trange(), (TiledRange{trk, trj, tri}));
+  for(const auto t : *ct.pmap()) {
+    const TensorI tile = ct.find(t).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], c_value(index[2], index[1], index[0]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  // Zero the left tile (0,1,1), which is the only contribution to the
+  // summed block l in [4,6) for result tiles (0,1,k)
+  const TiledRange a_trange{tri, trj, trl};
+  Tensor<float> norms(a_trange.tiles_range(), 1.0f);
+  norms(0, 1, 1) = 0.0f;
+  TSpArrayI a(world, a_trange, SparseShape<float>(norms, a_trange));
+  TSpArrayI b(world, TiledRange{trj, trl, trk});
+  fill(a, & a_value);
+  fill(b, & b_value);
+
+  TSpArrayI c = batched_contract(a, "i,j,l", b, "j,l,k", "i,j,k");
+  for(const auto t : *c.pmap()) {
+    BOOST_REQUIRE(! c.is_zero(t));
+    const TensorI tile = c.find(t).get();
+    for(const auto& index : tile.range()) {
+      int expected = c_value(index[0], index[1], index[2]);
+      if(index[0] < 2ul && index[1] == 3ul)
+        for(std::size_t l = 4ul; l < 6ul; ++l)
+          expected -= a_value(index[0], index[1], l) * b_value(index[1], l, index[2]);
+      BOOST_CHECK_EQUAL(tile[index], expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( batch )
+{
+  // The pairs have different tiled ranges
+  std::vector<TArrayI> a, b;
+  std::vector<TSpArrayI> sa, sb;
+  for(const TiledRange1& tr : { tri, trk, tri }) {
+    a.emplace_back(world, TiledRange{tr, trj, trl});
+    b.emplace_back(world, TiledRange{trj, trl, trk});
+    fill(a.back(), & a_value);
+    fill(b.back(), & b_value);
+    sa.emplace_back(world, TiledRange{tr, trj, trl});
+    sb.emplace_back(world, TiledRange{trj, trl, trk});
+    fill(sa.back(), & a_value);
+    fill(sb.back(), & b_value);
+  }
+
+  std::vector<TArrayI> c;
+  std::vector<TSpArrayI> sc;
+  BOOST_REQUIRE_NO_THROW(c = batched_contract(a, "i,j,l", b, "j,l,k", "i,j,k"));
+  BOOST_REQUIRE_NO_THROW(sc = batched_contract(sa, "i,j,l", sb, "j,l,k", "i,j,k"));
+  BOOST_REQUIRE_EQUAL(c.size(), a.size());
+  BOOST_REQUIRE_EQUAL(sc.size(), a.size());
+  for(std::size_t p = 0ul; p < a.size(); ++p) {
+    BOOST_CHECK_EQUAL(c[p].trange(), (TiledRange{a[p].trange().dim(0), trj, trk}));
+    BOOST_CHECK_EQUAL(sc[p].trange(), c[p].trange());
+    for(const auto t : *c[p].pmap()) {
+      BOOST_REQUIRE(! sc[p].is_zero(t));
+      const TensorI tile = c[p].find(t).get();
+      const TensorI sparse_tile = sc[p].find(t).get();
+      for(const auto& index : tile.range()) {
+        BOOST_CHECK_EQUAL(tile[index], c_value(index[0], index[1], index[2]));
+        BOOST_CHECK_EQUAL(sparse_tile[index], tile[index]);
+      }
+    }
+  }
+
+  // The number of arguments must match
+  b.pop_back();
+  BOOST_CHECK_THROW(batched_contract(a, "i,j,l", b, "j,l,k", "i,j,k"),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( invalid_vars )
+{
+  TArrayI a(world, TiledRange{tri, trj, trl});
+  TArrayI b(world, TiledRange{trj, trl, trk});
+  fill(a, & a_value);
+  fill(b, & b_value);
+
+  // l is in neither the result nor b
+  BOOST_CHECK_THROW(batched_contract(a, "i,j,l", b, "j,m,k", "i,j,k"),
+      TiledArray::Exception);
+  // m is not in either argument
+  BOOST_CHECK_THROW(batched_contract(a, "i,j,l", b, "j,l,k", "i,j,m"),
+      TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -675,6 +675,37 @@ BOOST_AUTO_TEST_CASE( bit_count )
   BOOST_CHECK_EQUAL(set.count(), count);
 }
 
+BOOST_AUTO_TEST_CASE( find_set_bits )
+{
+  // Check that an empty bitset has no set bits
+  BOOST_CHECK_EQUAL(set.find_first(), size);
+
+  // Fill bitset with random data
+  std::size_t n = size * 0.25;
+  GlobalFixture::world->srand(27);
+  for(std::size_t i = 0; i < n; ++i)
+    set.set(std::size_t(GlobalFixture::world->rand()) % size);
+  set.set(size - 1ul);
+
+  // Check that the set bits are found in order
+  std::vector<std::size_t> expected, found;
+  for(std::size_t i = 0ul; i < size; ++i)
+    if(set[i])
+      expected.push_back(i);
+  for(std::size_t i = set.find_first(); i < size; i = set.find_next(i))
+    found.push_back(i);
+  BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(),
+      expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(set.find_next(size - 1ul), size);
+
+  // Check that bits past the end of the set are not found
+  set.reset();
+  set.flip();
+  set.reset(size - 1ul);
+  BOOST_CHECK_EQUAL(set.find_first(), 0ul);
+  BOOST_CHECK_EQUAL(set.find_next(size - 2ul), size);
+}
+
 BOOST_AUTO_TEST_CASE( operator_bool )
 {
   // Check that a bitset full of zeros returns false
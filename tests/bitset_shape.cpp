@@ -0,0 +1,226 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  bitset_shape.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/bitset_shape.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "sparse_shape_fixture.h"
+
+using namespace TiledArray;
+
+struct BitsetShapeFixture : public SparseShapeFixture {
+
+  BitsetShapeFixture() :
+    bitset_shape(sparse_shape, tr),
+    bitset_left(left, tr),
+    bitset_right(right, tr)
+  { }
+
+  // Check that a bitset shape has the pattern of a sparse shape
+  static void check(const BitsetShape& result, const SparseShape<float>& expected) {
+    BOOST_REQUIRE(! result.empty());
+    BOOST_REQUIRE(result.validate(expected.data().range()));
+
+    std::size_t nnz = 0ul;
+    for(std::size_t i = 0ul; i < expected.data().size(); ++i) {
+      BOOST_CHECK_EQUAL(result.is_zero(i), expected.is_zero(i));
+      if(! expected.is_zero(i))
+        ++nnz;
+    }
+    BOOST_CHECK_EQUAL(result.nnz(), nnz);
+    BOOST_CHECK_CLOSE(result.sparsity(), expected.sparsity(), 0.001);
+  }
+
+  BitsetShape bitset_shape;
+  BitsetShape bitset_left;
+  BitsetShape bitset_right;
+}; // BitsetShapeFixture
+
+BOOST_FIXTURE_TEST_SUITE( bitset_shape_suite, BitsetShapeFixture )
+
+BOOST_AUTO_TEST_CASE( default_constructor )
+{
+  BOOST_CHECK_NO_THROW(BitsetShape x);
+  BitsetShape x;
+  BOOST_CHECK(x.empty());
+  BOOST_CHECK(! x.is_dense());
+  BOOST_CHECK(! x.validate(tr.tiles_range()));
+}
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  const Tensor<float> tile_norms = make_norm_tensor(tr, 0.5, 42);
+  const SparseShape<float> expected(tile_norms, tr);
+
+  // Dense constructor
+  BOOST_CHECK_NO_THROW(BitsetShape x(tile_norms, tr));
+  check(BitsetShape(tile_norms, tr), expected);
+  check(bitset_shape, sparse_shape);
+
+  // Sparse constructor
+  std::vector<std::pair<std::vector<std::size_t>, float> > sparse_norms;
+  for(std::size_t i = 0ul; i < tile_norms.size(); ++i)
+    if(tile_norms[i] > 0.0f)
+      sparse_norms.emplace_back(tr.tiles_range().idx(i), tile_norms[i]);
+  check(BitsetShape(sparse_norms, tr), expected);
+
+  // Pattern constructor
+  check(BitsetShape(bitset_shape.pattern(), tr), sparse_shape);
+}
+
+BOOST_AUTO_TEST_CASE( comm_constructor )
+{
+  World& world = *GlobalFixture::world;
+  const Tensor<float> tile_norms = make_norm_tensor(tr, 0.5, 42);
+  const SparseShape<float> expected(tile_norms, tr);
+
+  // Each process contributes a part of the norms
+  Tensor<float> local_norms(tr.tiles_range(), 0.0f);
+  std::vector<std::pair<std::vector<std::size_t>, float> > sparse_norms;
+  for(std::size_t i = world.rank(); i < tile_norms.size(); i += world.size()) {
+    local_norms[i] = tile_norms[i];
+    sparse_norms.emplace_back(tr.tiles_range().idx(i), tile_norms[i]);
+  }
+
+  check(BitsetShape(world, local_norms, tr), expected);
+  check(BitsetShape(world, sparse_norms, tr), expected);
+}
+
+BOOST_AUTO_TEST_CASE( permute )
+{
+  check(bitset_shape.perm(perm), sparse_shape.perm(perm));
+}
+
+BOOST_AUTO_TEST_CASE( block )
+{
+  std::vector<std::size_t> lower(GlobalFixture::dim, 1ul);
+  std::vector<std::size_t> upper(GlobalFixture::dim, 4ul);
+  upper.front() = 3ul;
+
+  check(bitset_shape.block(lower, upper), sparse_shape.block(lower, upper));
+  check(bitset_shape.block(lower, upper, perm), sparse_shape.block(lower, upper, perm));
+}
+
+BOOST_AUTO_TEST_CASE( update_block )
+{
+  std::vector<std::size_t> lower(GlobalFixture::dim, 1ul);
+  std::vector<std::size_t> upper(GlobalFixture::dim, 4ul);
+
+  check(bitset_shape.update_block(lower, upper, bitset_left.block(lower, upper)),
+      sparse_shape.update_block(lower, upper, left.block(lower, upper)));
+}
+
+BOOST_AUTO_TEST_CASE( mask )
+{
+  check(bitset_left.mask(bitset_right), left.mask(right));
+}
+
+BOOST_AUTO_TEST_CASE( add )
+{
+  check(bitset_left.add(bitset_right), left.add(right));
+  check(bitset_left.add(bitset_right, perm), left.add(right, perm));
+  check(bitset_left.subt(bitset_right), left.subt(right));
+  BOOST_CHECK_EQUAL(bitset_shape.add(2.0f).nnz(), tr.tiles_range().volume());
+}
+
+BOOST_AUTO_TEST_CASE( mult )
+{
+  const BitsetShape result = bitset_left.mult(bitset_right, -3.1);
+  for(std::size_t i = 0ul; i < tr.tiles_range().volume(); ++i)
+    BOOST_CHECK_EQUAL(result.is_zero(i), left.is_zero(i) || right.is_zero(i));
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  const BitsetShape result = bitset_left.gemm(bitset_right, -7.2, gemm_helper);
+
+  // Compute the boolean product of the patterns
+  integer M = 0, N = 0, K = 0;
+  gemm_helper.compute_matrix_sizes(M, N, K, left.data().range(), right.data().range());
+  BOOST_REQUIRE_EQUAL(result.pattern().size(), std::size_t(M * N));
+  for(integer m = 0; m < M; ++m) {
+    for(integer n = 0; n < N; ++n) {
+      bool nonzero = false;
+      for(integer k = 0; k < K; ++k)
+        nonzero = nonzero || (! left.is_zero(m * K + k) && ! right.is_zero(k * N + n));
+      BOOST_CHECK_EQUAL(result.is_zero(m * N + n), ! nonzero);
+    }
+  }
+
+  // The pattern includes the non-zero tiles of the sparse shape
+  const SparseShape<float> expected = left.gemm(right, -7.2, gemm_helper);
+  for(std::size_t i = 0ul; i < expected.data().size(); ++i)
+    if(! expected.is_zero(i))
+      BOOST_CHECK(! result.is_zero(i));
+
+  // Permuted result
+  const Permutation result_perm({1, 0});
+  const BitsetShape perm_result =
+      bitset_left.gemm(bitset_right, -7.2, gemm_helper, result_perm);
+  const BitsetShape expected_perm_result = result.perm(result_perm);
+  for(std::size_t i = 0ul; i < std::size_t(M * N); ++i)
+    BOOST_CHECK_EQUAL(perm_result.is_zero(i), expected_perm_result.is_zero(i));
+}
+
+BOOST_AUTO_TEST_CASE( array_expressions )
+{
+  typedef DistArray<TensorD, BitsetSparsePolicy> TBSpArrayD;
+  World& world = *GlobalFixture::world;
+
+  TSpArrayD a(world, tr, left), b(world, tr, right);
+  TBSpArrayD ba(world, tr, bitset_left), bb(world, tr, bitset_right);
+  a.fill_local(1.0);
+  b.fill_local(2.0);
+  ba.fill_local(1.0);
+  bb.fill_local(2.0);
+
+  // Check that the non-zero tiles of the sparse result are equal
+  auto check_array = [] (const TBSpArrayD& result, const TSpArrayD& expected) {
+    for(const auto i : *expected.pmap()) {
+      if(expected.is_zero(i))
+        continue;
+      BOOST_REQUIRE(! result.is_zero(i));
+      const TensorD tile = result.find(i).get();
+      const TensorD expected_tile = expected.find(i).get();
+      BOOST_REQUIRE_EQUAL(tile.range(), expected_tile.range());
+      for(std::size_t j = 0ul; j < tile.size(); ++j)
+        BOOST_CHECK_CLOSE(tile[j], expected_tile[j], 0.0001);
+    }
+  };
+
+  TSpArrayD c;
+  TBSpArrayD bc;
+  c("a,b,c") = 2 * a("a,b,c") + b("c,b,a");
+  bc("a,b,c") = 2 * ba("a,b,c") + bb("c,b,a");
+  check_array(bc, c);
+
+  c("a,b,d,e") = a("a,b,c") * b("c,d,e");
+  bc("a,b,d,e") = ba("a,b,c") * bb("c,d,e");
+  check_array(bc, c);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  block_cyclic.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/conversions/block_cyclic.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct BlockCyclicFixture {
+  BlockCyclicFixture() :
+    world(*GlobalFixture::world),
+    nprow(world.size() > 1 ? 2ul : 1ul),
+    npcol(world.size() / nprow),
+    desc(23ul, 17ul, 4ul, 3ul, nprow, npcol),
+    local(local_size(), 0)
+  { }
+
+  std::size_t local_size() const {
+    const std::size_t rank = world.rank();
+    if(rank >= nprow * npcol)
+      return 0ul;
+    return desc.local_rows(rank / npcol) * desc.local_cols(rank % npcol);
+  }
+
+  std::size_t lld() const {
+    const std::size_t rank = world.rank();
+    return (rank < nprow * npcol ? std::max<std::size_t>(desc.local_rows(rank / npcol), 1ul) : 1ul);
+  }
+
+  static int value(const std::size_t i, const std::size_t j) { return int(i * 100ul + j); }
+
+  // Fill the local matrix of this process
+  void fill_local() {
+    for(std::size_t i = 0ul; i < desc.m; ++i)
+      for(std::size_t j = 0ul; j < desc.n; ++j)
+        if(desc.owner(i, j) == std::size_t(world.rank()))
+          local[desc.local_row(i) + desc.local_col(j) * lld()] = value(i, j);
+  }
+
+  // Check the local matrix of this process
+  void check_local() const {
+    for(std::size_t i = 0ul; i < desc.m; ++i)
+      for(std::size_t j = 0ul; j < desc.n; ++j)
+        if(desc.owner(i, j) == std::size_t(world.rank()))
+          BOOST_CHECK_EQUAL(local[desc.local_row(i) + desc.local_col(j) * lld()], value(i, j));
+  }
+
+  // Check the local tiles of an array
+  static void check_array(const TArrayI& array) {
+    for(const auto i : *array.pmap()) {
+      const TensorI tile = array.find(i).get();
+      for(const auto& index : tile.range())
+        BOOST_CHECK_EQUAL(tile[index], value(index[0], index[1]));
+    }
+  }
+
+  World& world;
+  std::size_t nprow;
+  std::size_t npcol;
+  BlockCyclicDescriptor desc;
+  std::vector<int> local;
+}; // BlockCyclicFixture
+
+BOOST_FIXTURE_TEST_SUITE( block_cyclic_suite, BlockCyclicFixture )
+
+BOOST_AUTO_TEST_CASE( descriptor )
+{
+  // The local sizes of all process rows and columns must add up
+  std::size_t rows = 0ul, cols = 0ul;
+  for(std::size_t p = 0ul; p < nprow; ++p)
+    rows += desc.local_rows(p);
+  for(std::size_t p = 0ul; p < npcol; ++p)
+    cols += desc.local_cols(p);
+  BOOST_CHECK_EQUAL(rows, desc.m);
+  BOOST_CHECK_EQUAL(cols, desc.n);
+
+  // Rows owned by one process row have consecutive local indices
+  for(std::size_t p = 0ul; p < nprow; ++p) {
+    std::size_t next = 0ul;
+    for(std::size_t i = 0ul; i < desc.m; ++i)
+      if(desc.row_owner(i) == p)
+        BOOST_CHECK_EQUAL(desc.local_row(i), next++);
+  }
+
+  TArrayI array(world, desc.make_trange(), desc.make_pmap(world));
+  BOOST_CHECK(desc.matches(array));
+  TArrayI other(world, desc.make_trange());
+  BOOST_CHECK_EQUAL(desc.matches(other), world.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE( matching_layout )
+{
+  fill_local();
+
+  TArrayI array;
+  BOOST_REQUIRE_NO_THROW(array = block_cyclic_to_array<TArrayI>(world, desc,
+      local.data(), lld()));
+  BOOST_CHECK(desc.matches(array));
+  check_array(array);
+
+  std::fill(local.begin(), local.end(), 0);
+  BOOST_REQUIRE_NO_THROW(array_to_block_cyclic(array, desc, local.data(), lld()));
+  check_local();
+}
+
+BOOST_AUTO_TEST_CASE( redistribute )
+{
+  fill_local();
+
+  // A tiling that does not match the blocks
+  const TiledRange trange({ TiledRange1{0, 5, 11, 23}, TiledRange1{0, 7, 17} });
+
+  TArrayI array;
+  BOOST_REQUIRE_NO_THROW(array = block_cyclic_to_array<TArrayI>(world, desc,
+      local.data(), lld(), trange));
+  BOOST_CHECK_EQUAL(array.trange(), trange);
+  check_array(array);
+
+  std::fill(local.begin(), local.end(), 0);
+  BOOST_REQUIRE_NO_THROW(array_to_block_cyclic(array, desc, local.data(), lld()));
+  check_local();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
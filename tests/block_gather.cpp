@@ -0,0 +1,123 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  block_gather.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+
+#include "TiledArray/conversions/block_gather.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct BlockGatherFixture {
+  BlockGatherFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8, 12, 13}, TiledRange1{0, 5, 10, 11} })
+  { }
+
+  // The value of element (i,j)
+  static int value(const std::size_t i, const std::size_t j) {
+    return int(100ul * i + j + 1ul);
+  }
+
+  // Set the local tiles of an array to their element values
+  template <typename Array>
+  static void fill(Array& array) {
+    for(const auto t : *array.pmap()) {
+      if(array.is_zero(t))
+        continue;
+      TensorI tile(array.trange().make_tile_range(t));
+      for(std::size_t i = tile.range().lobound(0); i < tile.range().upbound(0); ++i)
+        for(std::size_t j = tile.range().lobound(1); j < tile.range().upbound(1); ++j)
+          tile(i, j) = value(i, j);
+      array.set(t, tile);
+    }
+  }
+
+  World& world;
+  TiledRange trange;
+}; // BlockGatherFixture
+
+BOOST_FIXTURE_TEST_SUITE( block_gather_suite, BlockGatherFixture )
+
+BOOST_AUTO_TEST_CASE( gather )
+{
+  Tensor<float> norms(trange.tiles_range(), 1.0f);
+  norms(1, 1) = 0.0f;
+  TSpArrayI a(world, trange, SparseShape<float>(norms, trange));
+  fill(a);
+
+  const std::vector<std::size_t> lower = { 2, 4 }, upper = { 12, 11 };
+  TensorI block;
+  BOOST_REQUIRE_NO_THROW(block = gather_block(a, lower, upper));
+  BOOST_CHECK_EQUAL(block.range(), Range(lower, upper));
+  for(std::size_t i = lower[0]; i < upper[0]; ++i) {
+    for(std::size_t j = lower[1]; j < upper[1]; ++j) {
+      // Tile (1,1) holds the elements [3,8) x [5,10)
+      const bool zero = (i >= 3ul) && (i < 8ul) && (j >= 5ul) && (j < 10ul);
+      BOOST_CHECK_EQUAL(block(i, j), (zero ? 0 : value(i, j)));
+    }
+  }
+
+  // The whole array
+  const TensorI all = gather_block(a, { 0, 0 }, { 13, 11 });
+  BOOST_CHECK_EQUAL(all.range(), trange.elements_range());
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(gather_block(a, { 0, 0 }, { 14, 11 }), TiledArray::Exception);
+  BOOST_CHECK_THROW(gather_block(a, { 2, 4 }, { 2, 6 }), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( scatter )
+{
+  TArrayI a(world, trange);
+  fill(a);
+  world.gop.fence();
+
+  // Each process negates a different row of the array
+  if(world.rank() < 13) {
+    const std::size_t row = world.rank();
+    TensorI block = gather_block(a, { row, 2ul }, { row + 1ul, 9ul });
+    for(auto& x : block)
+      x = -x;
+    scatter_block(a, block);
+  }
+  world.gop.fence();
+
+  for(const auto t : *a.pmap()) {
+    const TensorI tile = a.find(t).get();
+    for(std::size_t i = tile.range().lobound(0); i < tile.range().upbound(0); ++i) {
+      for(std::size_t j = tile.range().lobound(1); j < tile.range().upbound(1); ++j) {
+        const bool negated = (i < std::size_t(world.size())) && (j >= 2ul) && (j < 9ul);
+        BOOST_CHECK_EQUAL(tile(i, j), (negated ? -value(i, j) : value(i, j)));
+      }
+    }
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
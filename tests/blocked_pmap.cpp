@@ -118,4 +118,29 @@ BOOST_AUTO_TEST_CASE( local_group )
   }
 }
 
+BOOST_AUTO_TEST_CASE( owners )
+{
+  std::vector<std::size_t> owners;
+  std::unique_ptr<bool[]> local;
+
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    const TiledArray::detail::BlockedPmap pmap(* GlobalFixture::world, tiles);
+    const Pmap& base = pmap;
+    owners.assign(tiles, 0ul);
+    local.reset(new bool[tiles]);
+
+    // Check sub-ranges of the tiles
+    for(std::size_t first = 0ul; first < tiles; first += 7ul) {
+      for(std::size_t last = first; last <= tiles; last += 5ul) {
+        base.owners(first, last, owners.data());
+        base.are_local(first, last, local.get());
+        for(std::size_t tile = first; tile < last; ++tile) {
+          BOOST_CHECK_EQUAL(owners[tile - first], pmap.owner(tile));
+          BOOST_CHECK_EQUAL(local[tile - first], pmap.is_local(tile));
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
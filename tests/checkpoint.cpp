@@ -0,0 +1,145 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  checkpoint.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+#include "TiledArray/checkpoint.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "array_fixture.h"
+#include <cstdio>
+
+struct CheckpointFixture : public ArrayFixture {
+
+  CheckpointFixture() : prefix("ta_test_checkpoint") { }
+
+  ~CheckpointFixture() {
+    world.gop.fence();
+    if(world.rank() == 0) {
+      std::remove((prefix + ".meta").c_str());
+      for(int r = 0; r < world.size(); ++r) {
+        std::remove(TiledArray::detail::checkpoint_file_name(prefix, r).c_str());
+        std::remove(TiledArray::detail::checkpoint_file_name(prefix, r, ".idx").c_str());
+      }
+    }
+    world.gop.fence();
+  }
+
+  template <typename A>
+  static void check(const A& expected, const A& result) {
+    BOOST_CHECK_EQUAL(result.trange(), expected.trange());
+    for(std::size_t i = 0ul; i < expected.size(); ++i) {
+      BOOST_CHECK_EQUAL(result.is_zero(i), expected.is_zero(i));
+      if(expected.is_zero(i) || (! result.is_local(i)))
+        continue;
+
+      const typename A::value_type expected_tile = expected.find(i).get();
+      const typename A::value_type result_tile = result.find(i).get();
+      BOOST_CHECK_EQUAL(result_tile.range(), expected_tile.range());
+      for(std::size_t j = 0ul; j < expected_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(result_tile[j], expected_tile[j]);
+    }
+  }
+
+  const std::string prefix;
+}; // struct CheckpointFixture
+
+BOOST_FIXTURE_TEST_SUITE( checkpoint_suite, CheckpointFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  BOOST_REQUIRE_NO_THROW(TiledArray::write_checkpoint(a, prefix));
+
+  ArrayN result;
+  BOOST_REQUIRE_NO_THROW(result = TiledArray::read_checkpoint<ArrayN>(world, prefix));
+  check(a, result);
+
+  // Read the checkpoint with a different process map
+  std::shared_ptr<ArrayN::pmap_interface> pmap =
+      std::make_shared<TiledArray::detail::HashPmap>(world, a.size());
+  BOOST_REQUIRE_NO_THROW(result = TiledArray::read_checkpoint<ArrayN>(world, prefix, pmap));
+  BOOST_CHECK(result.pmap() == pmap);
+  check(a, result);
+
+  // Check that the shape type is checked
+  BOOST_CHECK_THROW(TiledArray::read_checkpoint<SpArrayN>(world, prefix),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  SpArrayN s(world, tr, TiledArray::SparseShape<float>(shape_tensor, tr));
+  for(auto it = s.begin(); it != s.end(); ++it)
+    s.set(it.index(), world.rank() + it.ordinal());
+  world.gop.fence();
+
+  BOOST_REQUIRE_NO_THROW(TiledArray::write_checkpoint(s, prefix));
+
+  SpArrayN result;
+  BOOST_REQUIRE_NO_THROW(result = TiledArray::read_checkpoint<SpArrayN>(world, prefix));
+  check(s, result);
+  for(std::size_t i = 0ul; i < s.size(); ++i)
+    BOOST_CHECK_EQUAL(result.shape()[i], s.shape()[i]);
+
+  // The shape is read with its zero threshold
+  SpArrayN t(world, tr, TiledArray::SparseShape<float>(shape_tensor, tr, 0.5f));
+  for(auto it = t.begin(); it != t.end(); ++it)
+    t.set(it.index(), world.rank() + it.ordinal());
+  world.gop.fence();
+  BOOST_REQUIRE_NO_THROW(TiledArray::write_checkpoint(t, prefix));
+  BOOST_REQUIRE_NO_THROW(result = TiledArray::read_checkpoint<SpArrayN>(world, prefix));
+  BOOST_CHECK_EQUAL(result.shape().zero_threshold(), 0.5f);
+  check(t, result);
+}
+
+BOOST_AUTO_TEST_CASE( async )
+{
+  SpArrayN s(world, tr, TiledArray::SparseShape<float>(shape_tensor, tr));
+  for(auto it = s.begin(); it != s.end(); ++it)
+    s.set(it.index(), world.rank() + it.ordinal());
+  const SpArrayN expected = s;
+
+  // The checkpoint holds the tiles of the snapshot
+  TiledArray::Future<bool> done;
+  BOOST_REQUIRE_NO_THROW(done = TiledArray::write_checkpoint_async(s, prefix));
+  s = SpArrayN();
+  BOOST_CHECK(done.get());
+  world.gop.fence();
+
+  SpArrayN result;
+  BOOST_REQUIRE_NO_THROW(result = TiledArray::read_checkpoint<SpArrayN>(world, prefix));
+  check(expected, result);
+
+  // A checkpoint that cannot be written sets the future to false
+  done = TiledArray::write_checkpoint_async(a, "ta_no_such_directory/" + prefix);
+  BOOST_CHECK(! done.get());
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( missing )
+{
+  BOOST_CHECK_THROW(TiledArray::read_checkpoint<ArrayN>(world, prefix + "_missing"),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
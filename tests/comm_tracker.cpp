@@ -0,0 +1,133 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  comm_tracker.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/comm_tracker.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct CommTrackerFixture {
+
+  CommTrackerFixture() : tracker(CommTracker::instance()), enabled(tracker.enabled()) {
+    tracker.enable();
+    tracker.reset();
+  }
+
+  ~CommTrackerFixture() {
+    if(! enabled)
+      tracker.disable();
+  }
+
+  CommTracker& tracker;
+  const bool enabled;
+}; // CommTrackerFixture
+
+BOOST_FIXTURE_TEST_SUITE( comm_tracker_suite, CommTrackerFixture )
+
+BOOST_AUTO_TEST_CASE( counters )
+{
+  tracker.send(CommCategory::remote_set, 100ul);
+  tracker.send(CommCategory::remote_set, 50ul, 2ul);
+  tracker.receive(CommCategory::remote_set, 30ul, CommTracker::now());
+
+  const CommUsage usage = tracker.usage(CommCategory::remote_set);
+  BOOST_CHECK_EQUAL(usage.messages_sent, 3ul);
+  BOOST_CHECK_EQUAL(usage.bytes_sent, 150ul);
+  BOOST_CHECK_EQUAL(usage.messages_received, 1ul);
+  BOOST_CHECK_EQUAL(usage.bytes_received, 30ul);
+  BOOST_CHECK_GE(usage.wait_time, 0.0);
+
+  // Other categories are not changed
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::remote_get).messages_sent, 0ul);
+
+  tracker.reset();
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::remote_set).messages_sent, 0ul);
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::remote_set).bytes_received, 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( future_tile )
+{
+  const std::size_t bytes = 12ul * sizeof(double);
+
+  // The tile is counted when it is set
+  Future<TensorD> tile;
+  detail::comm_receive(CommCategory::summa_col, tile);
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::summa_col).messages_received, 0ul);
+  tile.set(TensorD(Range(std::array<int, 2>{{3, 4}}), 1.0));
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::summa_col).messages_received, 1ul);
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::summa_col).bytes_received, bytes);
+
+  // Ready tiles are counted immediately
+  detail::comm_send(CommCategory::summa_row, tile);
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::summa_row).messages_sent, 1ul);
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::summa_row).bytes_sent, bytes);
+
+  // Nothing is counted when tracking is disabled
+  tracker.disable();
+  detail::comm_send(CommCategory::summa_row, tile);
+  BOOST_CHECK_EQUAL(tracker.usage(CommCategory::summa_row).messages_sent, 1ul);
+}
+
+BOOST_AUTO_TEST_CASE( remote_find )
+{
+  World& world = *GlobalFixture::world;
+  TiledRange1 tr1{0, 3, 8, 12};
+  TArrayD a(world, TiledRange({tr1, tr1}));
+  a.fill(1.0);
+  world.gop.fence();
+  tracker.reset();
+
+  std::size_t remote = 0ul;
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    if(a.is_local(i))
+      continue;
+    a.find(i).get();
+    ++remote;
+  }
+  world.gop.fence();
+
+  const CommUsage usage = tracker.usage(CommCategory::remote_get);
+  BOOST_CHECK_EQUAL(usage.messages_received, remote);
+
+  // Every request is answered by another process
+  const std::vector<CommUsage> total = sum_comm_usage(world);
+  BOOST_REQUIRE_EQUAL(total.size(), CommTracker::num_categories);
+  const CommUsage& get = total[static_cast<unsigned int>(CommCategory::remote_get)];
+  BOOST_CHECK_EQUAL(get.messages_sent, get.messages_received);
+  BOOST_CHECK_EQUAL(get.bytes_sent, get.bytes_received);
+}
+
+BOOST_AUTO_TEST_CASE( print )
+{
+  World& world = *GlobalFixture::world;
+  std::stringstream ss;
+  BOOST_REQUIRE_NO_THROW(print_comm_usage(world, ss));
+  if(world.rank() == 0)
+    BOOST_CHECK(ss.str().find("remote_get") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
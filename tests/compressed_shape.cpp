@@ -0,0 +1,229 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  compressed_shape.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/compressed_shape.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "sparse_shape_fixture.h"
+
+using namespace TiledArray;
+
+struct CompressedShapeFixture : public SparseShapeFixture {
+
+  CompressedShapeFixture() :
+    compressed_shape(sparse_shape, tr),
+    compressed_left(left, tr),
+    compressed_right(right, tr)
+  { }
+
+  // Check that a compressed shape holds the same norms as a sparse shape
+  static void check(const CompressedShape<float>& result,
+      const SparseShape<float>& expected)
+  {
+    BOOST_REQUIRE(! result.empty());
+    BOOST_REQUIRE(result.validate(expected.data().range()));
+
+    std::size_t nnz = 0ul;
+    for(std::size_t i = 0ul; i < expected.data().size(); ++i) {
+      BOOST_CHECK_CLOSE(result[i], expected[i], 0.001);
+      BOOST_CHECK_EQUAL(result.is_zero(i), expected.is_zero(i));
+      if(! expected.is_zero(i))
+        ++nnz;
+    }
+    BOOST_CHECK_EQUAL(result.nnz(), nnz);
+    BOOST_CHECK_CLOSE(result.sparsity(), expected.sparsity(), 0.001);
+  }
+
+  CompressedShape<float> compressed_shape;
+  CompressedShape<float> compressed_left;
+  CompressedShape<float> compressed_right;
+}; // CompressedShapeFixture
+
+BOOST_FIXTURE_TEST_SUITE( compressed_shape_suite, CompressedShapeFixture )
+
+BOOST_AUTO_TEST_CASE( default_constructor )
+{
+  BOOST_CHECK_NO_THROW(CompressedShape<float> x);
+  CompressedShape<float> x;
+  BOOST_CHECK(x.empty());
+  BOOST_CHECK(! x.is_dense());
+  BOOST_CHECK(! x.validate(tr.tiles_range()));
+}
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  const Tensor<float> tile_norms = make_norm_tensor(tr, 0.5, 42);
+  const SparseShape<float> expected(tile_norms, tr);
+
+  // Dense constructor
+  BOOST_CHECK_NO_THROW(CompressedShape<float> x(tile_norms, tr));
+  check(CompressedShape<float>(tile_norms, tr), expected);
+  check(compressed_shape, sparse_shape);
+
+  // Sparse constructor
+  std::vector<std::pair<std::vector<std::size_t>, float> > sparse_norms;
+  for(std::size_t i = 0ul; i < tile_norms.size(); ++i)
+    if(tile_norms[i] > 0.0f)
+      sparse_norms.emplace_back(tr.tiles_range().idx(i), tile_norms[i]);
+  check(CompressedShape<float>(sparse_norms, tr), expected);
+}
+
+BOOST_AUTO_TEST_CASE( comm_constructor )
+{
+  World& world = *GlobalFixture::world;
+  const Tensor<float> tile_norms = make_norm_tensor(tr, 0.5, 42);
+  const SparseShape<float> expected(tile_norms, tr);
+
+  // Each process contributes a part of the norms
+  Tensor<float> local_norms(tr.tiles_range(), 0.0f);
+  std::vector<std::pair<std::vector<std::size_t>, float> > sparse_norms;
+  for(std::size_t i = world.rank(); i < tile_norms.size(); i += world.size()) {
+    local_norms[i] = tile_norms[i];
+    sparse_norms.emplace_back(tr.tiles_range().idx(i), tile_norms[i]);
+  }
+
+  check(CompressedShape<float>(world, local_norms, tr), expected);
+  check(CompressedShape<float>(world, sparse_norms, tr), expected);
+}
+
+BOOST_AUTO_TEST_CASE( permute )
+{
+  check(compressed_shape.perm(perm), sparse_shape.perm(perm));
+}
+
+BOOST_AUTO_TEST_CASE( block )
+{
+  std::vector<std::size_t> lower(GlobalFixture::dim, 1ul);
+  std::vector<std::size_t> upper(GlobalFixture::dim, 4ul);
+  upper.front() = 3ul;
+
+  check(compressed_shape.block(lower, upper), sparse_shape.block(lower, upper));
+  check(compressed_shape.block(lower, upper, -2.5), sparse_shape.block(lower, upper, -2.5));
+  check(compressed_shape.block(lower, upper, perm), sparse_shape.block(lower, upper, perm));
+}
+
+BOOST_AUTO_TEST_CASE( update_block )
+{
+  std::vector<std::size_t> lower(GlobalFixture::dim, 1ul);
+  std::vector<std::size_t> upper(GlobalFixture::dim, 4ul);
+
+  check(compressed_shape.update_block(lower, upper, compressed_left.block(lower, upper)),
+      sparse_shape.update_block(lower, upper, left.block(lower, upper)));
+}
+
+BOOST_AUTO_TEST_CASE( mask )
+{
+  check(compressed_left.mask(compressed_right), left.mask(right));
+}
+
+BOOST_AUTO_TEST_CASE( scale )
+{
+  check(compressed_shape.scale(-4.1), sparse_shape.scale(-4.1));
+  check(compressed_shape.scale(-4.1, perm), sparse_shape.scale(-4.1, perm));
+}
+
+BOOST_AUTO_TEST_CASE( add )
+{
+  check(compressed_left.add(compressed_right), left.add(right));
+  check(compressed_left.add(compressed_right, perm), left.add(right, perm));
+  check(compressed_left.add(compressed_right, -2.2), left.add(right, -2.2));
+  check(compressed_left.add(compressed_right, -2.2, perm), left.add(right, -2.2, perm));
+  check(compressed_left.subt(compressed_right), left.subt(right));
+}
+
+BOOST_AUTO_TEST_CASE( add_const )
+{
+  check(compressed_shape.add(-8.8f), sparse_shape.add(-8.8f));
+  check(compressed_shape.add(-8.8f, perm), sparse_shape.add(-8.8f, perm));
+}
+
+BOOST_AUTO_TEST_CASE( mult )
+{
+  check(compressed_left.mult(compressed_right), left.mult(right));
+  check(compressed_left.mult(compressed_right, perm), left.mult(right, perm));
+  check(compressed_left.mult(compressed_right, -3.1), left.mult(right, -3.1));
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  check(compressed_left.gemm(compressed_right, -7.2, gemm_helper),
+      left.gemm(right, -7.2, gemm_helper));
+
+  // Outer product
+  math::GemmHelper outer_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u * GlobalFixture::dim, GlobalFixture::dim, GlobalFixture::dim);
+  check(compressed_left.gemm(compressed_right, 1.5, outer_helper),
+      left.gemm(right, 1.5, outer_helper));
+}
+
+BOOST_AUTO_TEST_CASE( gemm_perm )
+{
+  const Permutation result_perm({1, 0});
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  check(compressed_left.gemm(compressed_right, -7.2, gemm_helper, result_perm),
+      left.gemm(right, -7.2, gemm_helper, result_perm));
+}
+
+BOOST_AUTO_TEST_CASE( array_expressions )
+{
+  typedef DistArray<TensorD, CompressedSparsePolicy> TCSpArrayD;
+  World& world = *GlobalFixture::world;
+
+  TSpArrayD a(world, tr, left), b(world, tr, right);
+  TCSpArrayD ca(world, tr, compressed_left), cb(world, tr, compressed_right);
+  a.fill_local(1.0);
+  b.fill_local(2.0);
+  ca.fill_local(1.0);
+  cb.fill_local(2.0);
+
+  // Check that the arrays give the same result
+  auto check_array = [] (const TCSpArrayD& result, const TSpArrayD& expected) {
+    check(result.shape(), expected.shape());
+    for(const auto i : *expected.pmap()) {
+      if(expected.is_zero(i))
+        continue;
+      const TensorD tile = result.find(i).get();
+      const TensorD expected_tile = expected.find(i).get();
+      BOOST_REQUIRE_EQUAL(tile.range(), expected_tile.range());
+      for(std::size_t j = 0ul; j < tile.size(); ++j)
+        BOOST_CHECK_CLOSE(tile[j], expected_tile[j], 0.0001);
+    }
+  };
+
+  TSpArrayD c;
+  TCSpArrayD cc;
+  c("a,b,c") = 2 * a("a,b,c") + b("c,b,a");
+  cc("a,b,c") = 2 * ca("a,b,c") + cb("c,b,a");
+  check_array(cc, c);
+
+  c("a,b,d,e") = a("a,b,c") * b("c,d,e");
+  cc("a,b,d,e") = ca("a,b,c") * cb("c,d,e");
+  check_array(cc, c);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -180,5 +180,43 @@ BOOST_AUTO_TEST_CASE( local_group )
   }
 }
 
+BOOST_AUTO_TEST_CASE( owners )
+{
+  std::vector<std::size_t> owners;
+  std::unique_ptr<bool[]> local;
+
+  for(std::size_t x = 1ul; x < 10ul; ++x) {
+    for(std::size_t y = 1ul; y < 10ul; ++y) {
+      // Compute the limits for process rows
+      const std::size_t min_proc_rows =
+          std::max<std::size_t>(((GlobalFixture::world->size() + y - 1ul) / y), 1ul);
+      const std::size_t max_proc_rows = std::min<std::size_t>(GlobalFixture::world->size(), x);
+
+      // Compute process rows and process columns
+      const std::size_t p_rows = std::max<std::size_t>(min_proc_rows,
+          std::min<std::size_t>(std::sqrt(GlobalFixture::world->size() * x / y), max_proc_rows));
+      const std::size_t p_cols = GlobalFixture::world->size() / p_rows;
+
+      const std::size_t tiles = x * y;
+      const TiledArray::detail::CyclicPmap pmap(* GlobalFixture::world, x, y, p_rows, p_cols);
+      const Pmap& base = pmap;
+      owners.assign(tiles, 0ul);
+      local.reset(new bool[tiles]);
+
+      // Check sub-ranges that start and end in the middle of tile rows
+      for(std::size_t first = 0ul; first < tiles; first += 3ul) {
+        for(std::size_t last = first; last <= tiles; last += 4ul) {
+          base.owners(first, last, owners.data());
+          base.are_local(first, last, local.get());
+          for(std::size_t tile = first; tile < last; ++tile) {
+            BOOST_CHECK_EQUAL(owners[tile - first], pmap.owner(tile));
+            BOOST_CHECK_EQUAL(local[tile - first], pmap.is_local(tile));
+          }
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,127 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  df_exchange.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct DFExchangeFixture {
+  DFExchangeFixture() :
+    world(*GlobalFixture::world),
+    trx{0, 3, 4, 8}, trao{0, 2, 5, 6}, tro{0, 1, 3}
+  { }
+
+  static double b_value(const std::size_t x, const std::size_t r, const std::size_t m) {
+    return double(x + 1ul) / double(r + 2ul * m + 1ul);
+  }
+
+  static double c_value(const std::size_t r, const std::size_t i) {
+    return double(int(r) - 2 * int(i)) * 0.25;
+  }
+
+  // Set the non-zero local tiles of an array with op
+  template <typename Array, typename Op>
+  static void fill(Array& array, const Op& op) {
+    for(const auto t : *array.pmap()) {
+      if(array.is_zero(t))
+        continue;
+      TensorD tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = op(index);
+      array.set(t, tile);
+    }
+  }
+
+  // Compare the tiles of the result to the two-step expression
+  template <typename Array>
+  static void check(const Array& b, const Array& c, const Array& k) {
+    Array w, ref;
+    w("X,i,mu") = b("X,rho,mu") * c("rho,i");
+    ref("mu,nu") = w("X,i,mu") * w("X,i,nu");
+
+    BOOST_CHECK_EQUAL(k.trange(), ref.trange());
+    for(const auto t : *k.pmap()) {
+      BOOST_CHECK_EQUAL(k.is_zero(t), ref.is_zero(t));
+      if(k.is_zero(t))
+        continue;
+      const TensorD tile = k.find(t).get();
+      const TensorD ref_tile = ref.find(t).get();
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_CLOSE(tile[i], ref_tile[i], 1.0e-8);
+    }
+  }
+
+  World& world;
+  TiledRange1 trx, trao, tro;
+}; // DFExchangeFixture
+
+BOOST_FIXTURE_TEST_SUITE( df_exchange_suite, DFExchangeFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TArrayD b(world, TiledRange{trx, trao, trao});
+  TArrayD c(world, TiledRange{trao, tro});
+  fill(b, [] (const Range::index& i) { return b_value(i[0], i[1], i[2]); });
+  fill(c, [] (const Range::index& i) { return c_value(i[0], i[1]); });
+
+  TArrayD k;
+  BOOST_REQUIRE_NO_THROW(k = df_exchange(b, c));
+  BOOST_CHECK_EQUAL(k.trange(), (TiledRange{trao, trao}));
+  check(b, c, k);
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  // Zero one tile of an auxiliary slice and a whole slice of b
+  const TiledRange b_trange{trx, trao, trao};
+  Tensor<float> norms(b_trange.tiles_range(), 1.0f);
+  norms(0, 1, 2) = 0.0f;
+  for(std::size_t r = 0ul; r < 3ul; ++r)
+    for(std::size_t m = 0ul; m < 3ul; ++m)
+      norms(1, r, m) = 0.0f;
+  TSpArrayD b(world, b_trange, SparseShape<float>(norms, b_trange));
+  TSpArrayD c(world, TiledRange{trao, tro});
+  fill(b, [] (const Range::index& i) { return b_value(i[0], i[1], i[2]); });
+  fill(c, [] (const Range::index& i) { return c_value(i[0], i[1]); });
+
+  check(b, c, df_exchange(b, c));
+}
+
+BOOST_AUTO_TEST_CASE( invalid_args )
+{
+  TArrayD b(world, TiledRange{trx, trao, trao});
+  TArrayD c(world, TiledRange{trx, tro});
+  TArrayD m(world, TiledRange{trao, trao, tro});
+
+  // The contracted dimensions are not tiled the same way
+  BOOST_CHECK_THROW(df_exchange(b, c), TiledArray::Exception);
+  // The coefficients are not a matrix
+  BOOST_CHECK_THROW(df_exchange(b, m), TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
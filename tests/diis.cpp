@@ -0,0 +1,90 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  diis.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+
+#include "TiledArray/algebra/diis.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct DIISFixture {
+  DIISFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8}, TiledRange1{0, 4, 6} })
+  { }
+
+  // A deterministic vector for iteration k
+  TArrayD make_vector(const unsigned int k, const double shift) const {
+    TArrayD result(world, trange);
+    for(const auto index : *result.pmap()) {
+      TensorD tile(trange.make_tile_range(index));
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        tile[i] = std::sin(double(k * 31u + i + index) + shift) / double(k + 1u);
+      result.set(index, tile);
+    }
+    return result;
+  }
+
+  // Run a few extrapolations and return the last extrapolated vector
+  TArrayD run(const DIISStorage storage) const {
+    DIIS<TArrayD> diis(1, 3);
+    diis.set_storage(storage);
+    TArrayD x;
+    for(unsigned int k = 0u; k < 5u; ++k) {
+      x = make_vector(k, 0.0);
+      TArrayD error = make_vector(k, 0.5);
+      diis.extrapolate(x, error);
+    }
+    return x;
+  }
+
+  static double difference(const TArrayD& a, const TArrayD& b) {
+    TArrayD d;
+    d("i,j") = a("i,j") - b("i,j");
+    return norm2(d) / norm2(a);
+  }
+
+  World& world;
+  TiledRange trange;
+}; // DIISFixture
+
+BOOST_FIXTURE_TEST_SUITE( diis_suite, DIISFixture )
+
+BOOST_AUTO_TEST_CASE( storage )
+{
+  const TArrayD reference = run(DIISStorage::memory);
+
+  TArrayD x;
+  BOOST_REQUIRE_NO_THROW(x = run(DIISStorage::disk));
+  BOOST_CHECK_SMALL(difference(reference, x), 1.0e-14);
+
+  // Only the history vectors are rounded to single precision
+  BOOST_REQUIRE_NO_THROW(x = run(DIISStorage::compressed));
+  BOOST_CHECK_SMALL(difference(reference, x), 1.0e-5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
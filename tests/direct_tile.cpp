@@ -0,0 +1,180 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  direct_tile.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/direct_tile.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct DirectTileFixture {
+  typedef DistArray<DirectTile<TensorD>, DensePolicy> DirectArrayD;
+  typedef DistArray<DirectTile<TensorD>, SparsePolicy> DirectSpArrayD;
+
+  DirectTileFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8, 12}, TiledRange1{0, 4, 9} })
+  { }
+
+  static double value(const std::size_t i, const std::size_t j) {
+    return double(i * 10ul + j);
+  }
+
+  // Generate the tiles of value(i,j) and count the generated tiles
+  static std::function<TensorD(const Range&)> generator(std::atomic<int>& count) {
+    return [&count] (const Range& range) {
+      ++count;
+      TensorD tile(range);
+      for(const auto& index : range)
+        tile[index] = value(index[0], index[1]);
+      return tile;
+    };
+  }
+
+  World& world;
+  TiledRange trange;
+}; // DirectTileFixture
+
+BOOST_FIXTURE_TEST_SUITE( direct_tile_suite, DirectTileFixture )
+
+BOOST_AUTO_TEST_CASE( tile )
+{
+  std::atomic<int> count(0);
+  const Range range(std::array<std::size_t, 2>{{3, 4}});
+  DirectTile<TensorD> tile(range,
+      std::make_shared<const DirectTile<TensorD>::generator_type>(generator(count)));
+  BOOST_CHECK(! tile.empty());
+  BOOST_CHECK_EQUAL(tile.range(), range);
+  BOOST_CHECK(is_lazy_tile<DirectTile<TensorD> >::value);
+
+  // The data is generated on each conversion
+  BOOST_CHECK_EQUAL(count.load(), 0);
+  const TensorD data = tile;
+  BOOST_CHECK_EQUAL(count.load(), 1);
+  for(const auto& index : range)
+    BOOST_CHECK_EQUAL(data[index], value(index[0], index[1]));
+
+  BOOST_CHECK(DirectTile<TensorD>().empty());
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  std::atomic<int> count(0);
+  DirectArrayD g = make_direct_array<DirectArrayD>(world, trange, generator(count));
+  world.gop.fence();
+  BOOST_CHECK_EQUAL(count.load(), 0);
+
+  // Contract with the generated and the stored array
+  TArrayD a(world, TiledRange({ trange.data()[1], trange.data()[0] }));
+  a.fill_local(1.0);
+  TArrayD stored = make_array<TArrayD>(world, trange, g.pmap(),
+      [] (TensorD& tile, const Range& range) {
+        tile = TensorD(range);
+        for(const auto& index : range)
+          tile[index] = value(index[0], index[1]);
+      });
+
+  TArrayD direct_result, stored_result;
+  direct_result("i,k") = g("i,j") * a("j,k");
+  stored_result("i,k") = stored("i,j") * a("j,k");
+  world.gop.fence();
+
+  // Each local tile was generated at least once
+  BOOST_CHECK_GE(count.load(), int(g.pmap()->local_size()));
+
+  for(const auto i : *direct_result.pmap()) {
+    const TensorD x = direct_result.find(i).get();
+    const TensorD y = stored_result.find(i).get();
+    for(std::size_t e = 0ul; e < x.size(); ++e)
+      BOOST_CHECK_CLOSE(x[e], y[e], 1.0e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cache )
+{
+  std::atomic<int> count(0);
+  auto cache = std::make_shared<DirectTileCache<TensorD> >(generator(count),
+      std::size_t(1) << 30);
+  DirectArrayD g = make_cached_direct_array<DirectArrayD>(world, trange, cache);
+  TArrayD a(world, TiledRange({ trange.data()[1], trange.data()[0] }));
+  a.fill_local(1.0);
+
+  // Tiles are generated by the first expression that uses them
+  TArrayD result1, result2;
+  result1("i,k") = g("i,j") * a("j,k");
+  world.gop.fence();
+  const int generated = count.load();
+  BOOST_CHECK_GE(generated, int(g.pmap()->local_size()));
+  BOOST_CHECK_EQUAL(cache->misses(), std::size_t(generated));
+  BOOST_CHECK_EQUAL(cache->size(), g.pmap()->local_size());
+
+  // Cached tiles are not generated again, and expressions do not modify them
+  const std::size_t hits = cache->hits();
+  result2("i,k") = 2.0 * g("i,k");
+  world.gop.fence();
+  BOOST_CHECK_EQUAL(count.load(), generated);
+  BOOST_CHECK_EQUAL(cache->hits(), hits + g.pmap()->local_size());
+  for(const auto i : *result2.pmap()) {
+    const TensorD tile = result2.find(i).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], 2.0 * value(index[0], index[1]));
+  }
+
+  // A capacity of zero drops the cached tiles
+  cache->capacity(0ul);
+  BOOST_CHECK_EQUAL(cache->bytes(), 0ul);
+  BOOST_CHECK_EQUAL(cache->size(), 0ul);
+  result2("i,k") = 2.0 * g("i,k");
+  world.gop.fence();
+  BOOST_CHECK_EQUAL(count.load(), generated + int(g.pmap()->local_size()));
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  std::atomic<int> count(0);
+  Tensor<float> norms(trange.tiles_range(), 1.0f);
+  norms(1, 0) = 0.0f;
+  SparseShape<float> shape(norms, trange);
+  DirectSpArrayD g = make_direct_array<DirectSpArrayD>(world, trange,
+      generator(count), shape);
+
+  // Zero tiles are not set and not generated
+  TSpArrayD result;
+  result("i,j") = 2.0 * g("i,j");
+  world.gop.fence();
+  BOOST_CHECK(result.is_zero(std::vector<std::size_t>{1, 0}));
+  for(const auto i : *result.pmap()) {
+    if(result.is_zero(i))
+      continue;
+    const TensorD tile = result.find(i).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], 2.0 * value(index[0], index[1]));
+  }
+  BOOST_CHECK_EQUAL(count.load(), int(g.pmap()->local_size()) -
+      (g.is_local(std::vector<std::size_t>{1, 0}) ? 1 : 0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
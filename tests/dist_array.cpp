@@ -163,6 +163,42 @@ BOOST_AUTO_TEST_CASE( find_remote )
   }
 }
 
+BOOST_AUTO_TEST_CASE( prefetch )
+{
+  {
+    auto tiles = a.prefetch(a.range());
+    BOOST_CHECK_EQUAL(tiles.size(), a.range().volume());
+
+    for(ArrayN::range_type::const_iterator it = a.range().begin(); it != a.range().end(); ++it) {
+      BOOST_CHECK(tiles.contains(*it));
+
+      Future<ArrayN::value_type> tile = tiles.find(*it);
+
+      const int owner = a.owner(*it);
+      for(ArrayN::value_type::iterator it = tile.get().begin(); it != tile.get().end(); ++it)
+        BOOST_CHECK_EQUAL(*it, owner + 1);
+    }
+
+    tiles.release();
+    BOOST_CHECK_EQUAL(tiles.size(), 0ul);
+  }
+
+  // Prefetch a subset of the tiles by ordinal, with duplicates
+  std::vector<std::size_t> ords = { 0ul, 2ul, 2ul };
+  auto tiles = a.prefetch(ords);
+  BOOST_CHECK_EQUAL(tiles.size(), 2ul);
+  BOOST_CHECK(tiles.contains(0ul));
+  BOOST_CHECK(! tiles.contains(1ul));
+
+  // Tiles that were not prefetched are still found
+  for(std::size_t i = 0ul; i < 3ul; ++i) {
+    Future<ArrayN::value_type> tile = tiles.find(i);
+    const int owner = a.owner(i);
+    for(ArrayN::value_type::iterator it = tile.get().begin(); it != tile.get().end(); ++it)
+      BOOST_CHECK_EQUAL(*it, owner + 1);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( fill_tiles )
 {
   ArrayN a(world, tr);
@@ -182,6 +218,35 @@ BOOST_AUTO_TEST_CASE( fill_tiles )
   }
 }
 
+BOOST_AUTO_TEST_CASE( init_tiles_bulk )
+{
+  for(std::size_t chunk_size : { 0ul, 1ul, 3ul }) {
+    ArrayN a(world, tr);
+    a.init_tiles_bulk([] (const ArrayN::range_type& range) -> TensorI {
+      return TensorI(range, int(range.volume()));
+    }, false, chunk_size);
+
+    for(auto index : * a.pmap()) {
+      Future<ArrayN::value_type> tile = a.find(index);
+
+      // Check that the range for the constructed tile is correct.
+      BOOST_CHECK_EQUAL(tile.get().range(), tr.make_tile_range(index));
+
+      for(auto value : tile.get())
+        BOOST_CHECK_EQUAL(value, int(tile.get().range().volume()));
+    }
+
+    // Tiles that are already set are skipped
+    BOOST_CHECK_NO_THROW(a.init_tiles_bulk([] (const ArrayN::range_type& range) {
+      return TensorI(range, 0);
+    }, true, chunk_size));
+    for(auto index : * a.pmap())
+      BOOST_CHECK_NE(a.find(index).get()[0], 0);
+
+    world.gop.fence();
+  }
+}
+
 BOOST_AUTO_TEST_CASE( assign_tiles )
 {
   std::vector<int> data;
@@ -206,6 +271,32 @@ BOOST_AUTO_TEST_CASE( assign_tiles )
   }
 }
 
+BOOST_AUTO_TEST_CASE( set_tiles_batch )
+{
+  ArrayN a(world, tr);
+
+  // Set all tiles, local and remote, from one process
+  if(world.rank() == 0) {
+    std::vector<ArrayN::size_type> ords;
+    std::vector<ArrayN::value_type> tiles;
+    for(std::size_t i = 0ul; i < a.range().volume(); ++i) {
+      ords.push_back(i);
+      tiles.push_back(ArrayN::value_type(tr.make_tile_range(i), int(i)));
+    }
+    a.set(ords, tiles);
+  }
+
+  world.gop.fence();
+
+  for(ArrayN::iterator it = a.begin(); it != a.end(); ++it) {
+    Future<ArrayN::value_type> tile = *it;
+    BOOST_CHECK(tile.probe());
+    BOOST_CHECK_EQUAL(tile.get().range(), tr.make_tile_range(it.ordinal()));
+    for(ArrayN::value_type::iterator v = tile.get().begin(); v != tile.get().end(); ++v)
+      BOOST_CHECK_EQUAL(*v, int(it.ordinal()));
+  }
+}
+
 BOOST_AUTO_TEST_CASE( clone )
 {
   std::vector<int> data;
@@ -253,6 +344,121 @@ BOOST_AUTO_TEST_CASE( clone )
   }
 }
 
+BOOST_AUTO_TEST_CASE( to_sparse_to_dense )
+{
+  // Zero every third tile of a
+  ArrayN d(world, tr);
+  for(auto index : * d.pmap())
+    d.set(index, (index % 3 ? world.rank() + 1 : 0));
+
+  SpArrayN s;
+  BOOST_REQUIRE_NO_THROW(s = TiledArray::to_sparse(d));
+  ArrayN r;
+  BOOST_REQUIRE_NO_THROW(r = TiledArray::to_dense(s));
+
+  for(typename ArrayN::size_type index = 0ul; index < d.size(); ++index) {
+    BOOST_CHECK_EQUAL(s.is_zero(index), (index % 3) == 0ul);
+    BOOST_CHECK_EQUAL(s.owner(index), d.owner(index));
+    if(! d.is_local(index))
+      continue;
+
+    const TensorI t = d.find(index).get();
+    const TensorI rt = r.find(index).get();
+    BOOST_CHECK_NE(rt.data(), t.data());
+    BOOST_CHECK_EQUAL_COLLECTIONS(rt.begin(), rt.end(), t.begin(), t.end());
+
+    if(! s.is_zero(index)) {
+      const TensorI st = s.find(index).get();
+      BOOST_CHECK_NE(st.data(), t.data());
+      BOOST_CHECK_EQUAL_COLLECTIONS(st.begin(), st.end(), t.begin(), t.end());
+    }
+  }
+
+  // Converting a temporary array moves its tiles
+  std::vector<const int*> data;
+  for(auto index : * s.pmap())
+    data.push_back(s.is_zero(index) ? nullptr : s.find(index).get().data());
+  ArrayN m = TiledArray::to_dense(std::move(s));
+  auto data_it = data.begin();
+  for(auto index : * m.pmap()) {
+    if(*data_it)
+      BOOST_CHECK_EQUAL(m.find(index).get().data(), *data_it);
+    ++data_it;
+  }
+
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( to_new_tile_type )
+{
+  typedef TiledArray::DistArray<TiledArray::Tensor<double>, TiledArray::DensePolicy> ArrayD;
+  typedef TiledArray::DistArray<TiledArray::Tile<TensorI>, TiledArray::DensePolicy> ArrayT;
+
+  ArrayN a(world, tr);
+  for(auto index : * a.pmap())
+    a.set(index, world.rank() + index);
+
+  // Convert the tiles in chunks of two
+  ArrayD d;
+  BOOST_REQUIRE_NO_THROW(d = TiledArray::to_new_tile_type(a,
+      [] (const TensorI& tile) {
+        return TiledArray::Tensor<double>(tile,
+            [] (const int value) { return 2.0 * value; });
+      }, 2ul));
+
+  for(auto index : * a.pmap()) {
+    const TensorI t = a.find(index).get();
+    const TiledArray::Tensor<double> dt = d.find(index).get();
+    BOOST_CHECK_EQUAL(dt.range(), t.range());
+    for(std::size_t i = 0ul; i < t.size(); ++i)
+      BOOST_CHECK_EQUAL(dt[i], 2.0 * t[i]);
+  }
+
+  // Converting a temporary array moves its tiles
+  std::vector<const int*> data;
+  for(auto index : * a.pmap())
+    data.push_back(a.find(index).get().data());
+  ArrayT t = TiledArray::to_new_tile_type(std::move(a),
+      [] (TensorI tile) { return TiledArray::Tile<TensorI>(std::move(tile)); });
+  auto data_it = data.begin();
+  for(auto index : * t.pmap())
+    BOOST_CHECK_EQUAL(t.find(index).get().tensor().data(), *data_it++);
+  world.gop.fence();
+
+  // The tiles of the argument were moved
+  for(auto index : * a.pmap())
+    BOOST_CHECK(a.find(index).get().empty());
+}
+
+BOOST_AUTO_TEST_CASE( truncate_in_place )
+{
+  SpArrayN s(world, tr, TiledArray::SparseShape<float>(shape_tensor, tr));
+  for(auto index : * s.pmap())
+    if(! s.is_zero(index))
+      s.set(index, (index % 2 ? world.rank() + 1 : 0));
+  world.gop.fence();
+
+  std::vector<const int*> data;
+  for(auto index : * s.pmap())
+    data.push_back(s.is_zero(index) ? nullptr : s.find(index).get().data());
+  const madness::uniqueidT id = s.id();
+
+  BOOST_REQUIRE_NO_THROW(s.truncate());
+
+  // The array is the same object, and the remaining tiles are not copied
+  BOOST_CHECK(s.id() == id);
+  for(std::size_t i = 0ul; i < s.size(); ++i)
+    BOOST_CHECK_EQUAL(s.is_zero(i), (shape_tensor[i] == 0.0f) || ((i % 2) == 0ul));
+  auto data_it = data.begin();
+  for(auto index : * s.pmap()) {
+    if(! s.is_zero(index))
+      BOOST_CHECK_EQUAL(s.find(index).get().data(), *data_it);
+    ++data_it;
+  }
+
+  world.gop.fence();
+}
+
 BOOST_AUTO_TEST_CASE( make_replicated )
 {
   // Get a copy of the original process map
@@ -277,5 +483,72 @@ BOOST_AUTO_TEST_CASE( make_replicated )
   }
 }
 
+BOOST_AUTO_TEST_CASE( make_replicated_config )
+{
+  detail::ReplicatorConfig& config = detail::ReplicatorConfig::instance();
+  const ReplicateAlgorithm algorithm = config.algorithm();
+  const std::size_t chunk_size = config.chunk_size();
+
+  for(ReplicateAlgorithm alg : { ReplicateAlgorithm::tree, ReplicateAlgorithm::flat }) {
+    for(std::size_t chunk : { 0ul, 1ul, 3ul }) {
+      config.algorithm(alg);
+      config.chunk_size(chunk);
+
+      ArrayN b(world, tr);
+      for(const auto index : *b.pmap())
+        b.set(index, world.rank() + 1);
+      std::shared_ptr<ArrayN::pmap_interface> distributed_pmap = b.pmap();
+
+      BOOST_REQUIRE_NO_THROW(b.make_replicated());
+
+      // Check that all the data is local
+      for(std::size_t i = 0; i < b.size(); ++i) {
+        BOOST_CHECK(b.is_local(i));
+        const ArrayN::value_type tile = b.find(i).get();
+        BOOST_CHECK_EQUAL(tile.range(), b.trange().make_tile_range(i));
+        for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+          BOOST_CHECK_EQUAL(*it, distributed_pmap->owner(i) + 1);
+      }
+      world.gop.fence();
+    }
+  }
+
+  config.algorithm(algorithm);
+  config.chunk_size(chunk_size);
+}
+
+BOOST_AUTO_TEST_CASE( make_replicated_node_shared )
+{
+  NodeSharedReplication& policy = NodeSharedReplication::instance();
+  const bool enabled = policy.enabled();
+  detail::ReplicatorConfig& config = detail::ReplicatorConfig::instance();
+  const ReplicateAlgorithm algorithm = config.algorithm();
+  policy.enable();
+
+  for(ReplicateAlgorithm alg : { ReplicateAlgorithm::tree, ReplicateAlgorithm::flat }) {
+    config.algorithm(alg);
+    ArrayN b(world, tr);
+    for(const auto index : *b.pmap())
+      b.set(index, world.rank() + 1);
+    std::shared_ptr<ArrayN::pmap_interface> distributed_pmap = b.pmap();
+
+    BOOST_REQUIRE_NO_THROW(b.make_replicated());
+
+    // Check that all the data is local
+    for(std::size_t i = 0; i < b.size(); ++i) {
+      BOOST_CHECK(b.is_local(i));
+      const ArrayN::value_type tile = b.find(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), b.trange().make_tile_range(i));
+      for(ArrayN::value_type::const_iterator it = tile.begin(); it != tile.end(); ++it)
+        BOOST_CHECK_EQUAL(*it, distributed_pmap->owner(i) + 1);
+    }
+    world.gop.fence();
+  }
+
+  config.algorithm(algorithm);
+  if(! enabled)
+    policy.disable();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
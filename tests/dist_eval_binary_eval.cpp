@@ -170,6 +170,47 @@ BOOST_AUTO_TEST_CASE( eval )
 
 }
 
+BOOST_AUTO_TEST_CASE( batched_eval )
+{
+  TiledArray::detail::TileBatchPolicy& policy =
+      TiledArray::detail::TileBatchPolicy::instance();
+  const std::size_t max_elements = policy.max_elements();
+  const std::size_t tasks_per_thread = policy.tasks_per_thread();
+
+  // Evaluate all local tiles in batches of at least two tiles
+  const std::size_t tile_volume = left.trange().make_tile_range(0).volume();
+  policy.max_elements(2ul * tile_volume + 1ul);
+  policy.tasks_per_thread(0ul);
+
+  auto left_arg = make_array_eval(left, left.world(), DenseShape(),
+      left.pmap(), Permutation(), make_array_noop());
+  auto right_arg = make_array_eval(right, right.world(), DenseShape(),
+      left.pmap(), Permutation(), make_array_noop());
+
+  auto dist_eval = make_binary_eval(left_arg, right_arg,
+      left_arg.world(), DenseShape(), left_arg.pmap(), Permutation(), make_add());
+  using dist_eval_type = decltype(dist_eval);
+
+  BOOST_REQUIRE_NO_THROW(dist_eval.eval());
+  BOOST_REQUIRE_NO_THROW(dist_eval.wait());
+  policy.max_elements(max_elements);
+  policy.tasks_per_thread(tasks_per_thread);
+
+  // Check that each tile has been properly added.
+  for(auto index : * dist_eval.pmap()) {
+    const TArrayI::value_type left_tile = left.find(index);
+    const TArrayI::value_type right_tile = right.find(index);
+
+    dist_eval_type::eval_type eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = dist_eval.get(index).get());
+
+    BOOST_CHECK_EQUAL(eval_tile.range(), left_tile.range());
+    for(std::size_t i = 0ul; i < eval_tile.size(); ++i) {
+      BOOST_CHECK_EQUAL(eval_tile[i], left_tile[i] + right_tile[i]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( perm_eval )
 {
   auto left_arg = make_array_eval(left, left.world(), DenseShape(),
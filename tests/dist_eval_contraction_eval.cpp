@@ -446,4 +446,188 @@ BOOST_AUTO_TEST_CASE( sparse_eval )
   do_sparse_eval(true);
 }
 
+BOOST_AUTO_TEST_CASE( sparse_filter_eval )
+{
+  // The tiles of the first column of left and the first row of right have
+  // small (but non-zero) norms, so their products are below the threshold of
+  // the result and are skipped, while all result tiles are non-zero. The data
+  // of these tiles is zero, so the result is still exact.
+  TiledRange trange{dims[0], dims[0]};
+  const float small = SparseShape<float>::threshold() * 2.0f;
+  Tensor<float> left_norms(trange.tiles_range()), right_norms(trange.tiles_range());
+  for(std::size_t i = 0ul; i < left_norms.size(); ++i) {
+    const auto index = trange.tiles_range().idx(i);
+    const float volume = trange.make_tile_range(i).volume();
+    left_norms[i] = (index[1] == 0ul ? small : 1.0f) * volume;
+    right_norms[i] = (index[0] == 0ul ? small : 1.0f) * volume;
+  }
+  TSpArrayI left(*GlobalFixture::world, trange, SparseShape<float>(left_norms, trange));
+  TSpArrayI right(*GlobalFixture::world, trange, SparseShape<float>(right_norms, trange));
+  for(auto it = left.begin(); it != left.end(); ++it) {
+    TensorI tile(trange.make_tile_range(it.index()));
+    for(auto& value : tile)
+      value = (trange.tiles_range().idx(it.index())[1] == 0ul ? 0 :
+          GlobalFixture::world->rand() % 27);
+    *it = tile;
+  }
+  for(auto it = right.begin(); it != right.end(); ++it) {
+    TensorI tile(trange.make_tile_range(it.index()));
+    for(auto& value : tile)
+      value = (trange.tiles_range().idx(it.index())[0] == 0ul ? 0 :
+          GlobalFixture::world->rand() % 27);
+    *it = tile;
+  }
+
+  const std::size_t k = trange.tiles_range().extent(1);
+  auto left_arg = make_array_eval(left, left.world(), left.shape(),
+      proc_grid.make_row_phase_pmap(k), Permutation(), make_array_noop());
+  auto right_arg = make_array_eval(right, right.world(), right.shape(),
+      proc_grid.make_col_phase_pmap(k), Permutation(), make_array_noop());
+  auto op = make_contract(2u, 2u, 2u);
+  SparseShape<float> result_shape =
+      left_arg.shape().gemm(right_arg.shape(), 1, op.gemm_helper());
+  BOOST_REQUIRE_EQUAL(result_shape.sparsity(), 0.0f);
+
+  auto contract = make_contract_eval(left_arg, right_arg,
+      left_arg.world(), result_shape, pmap, Permutation(), op);
+  using dist_eval_type = decltype(contract);
+
+  // Record the number of tile pairs of each result tile
+  SummaTrace& trace = SummaTrace::instance();
+  trace.clear();
+  trace.enable();
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+  trace.disable();
+
+  // Only the pairs of the first k step are skipped
+  std::size_t reduce_count = 0ul;
+  for(const SummaTrace::Event& event : trace.events()) {
+    if(event.kind != SummaEventKind::reduce_submit)
+      continue;
+    ++reduce_count;
+    BOOST_CHECK_EQUAL(event.count, k - 1ul);
+  }
+  trace.clear();
+  BOOST_CHECK_EQUAL(reduce_count, proc_grid.local_size());
+
+  // Compute the reference contraction
+  const matrix_type l = copy_to_matrix(left, 1), r = copy_to_matrix(right, 1);
+  const matrix_type reference = l * r;
+
+  for(auto index : *contract.pmap()) {
+    BOOST_CHECK(! contract.is_zero(index));
+    dist_eval_type::eval_type eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = contract.get(index).get());
+    BOOST_CHECK_EQUAL(eval_tile.range(), contract.trange().make_tile_range(index));
+    BOOST_CHECK(eigen_map(eval_tile) == reference.block(eval_tile.range().lobound(0),
+        eval_tile.range().lobound(1), eval_tile.range().extent(0), eval_tile.range().extent(1)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( coalesced_eval )
+{
+  detail::SummaCoalescePolicy& policy = detail::SummaCoalescePolicy::instance();
+  const std::size_t max_elements = policy.max_elements();
+
+  // Tiles are coalesced when their mean volume is small enough
+  policy.max_elements(100ul);
+  BOOST_CHECK(policy.coalesce(2ul, 200ul));
+  BOOST_CHECK(! policy.coalesce(2ul, 201ul));
+  BOOST_CHECK(! policy.coalesce(1ul, 1ul));
+
+  // Evaluate with all broadcasts coalesced
+  policy.max_elements(1ul << 40);
+  auto contract = make_contract_eval(left_arg, right_arg,
+      left_arg.world(), DenseShape(), pmap, Permutation(), make_contract(2u,
+      left_arg.trange().tiles_range().rank(), right_arg.trange().tiles_range().rank()));
+  using dist_eval_type = decltype(contract);
+
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+  policy.max_elements(max_elements);
+
+  // Compute the reference contraction
+  const matrix_type l = copy_to_matrix(left, 1),
+                    r = copy_to_matrix(right, GlobalFixture::dim - 1);
+  const matrix_type reference = l * r;
+
+  for(auto index : *contract.pmap()) {
+    dist_eval_type::eval_type eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = contract.get(index).get());
+    BOOST_CHECK(eigen_map(eval_tile) == reference.block(eval_tile.range().lobound(0),
+        eval_tile.range().lobound(1), eval_tile.range().extent(0), eval_tile.range().extent(1)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( steal_eval )
+{
+  detail::SummaStealPolicy& policy = detail::SummaStealPolicy::instance();
+  const double fraction = policy.fraction();
+  const std::size_t max_batch = policy.max_batch();
+
+  // The stealable iterations are at the end of the pipeline
+  policy.fraction(0.25);
+  BOOST_CHECK_EQUAL(policy.steps(8ul), 2ul);
+  BOOST_CHECK_EQUAL(policy.steps(9ul), 3ul);
+  BOOST_CHECK_EQUAL(policy.steps(0ul), 0ul);
+  policy.fraction(1.0);
+  BOOST_CHECK_EQUAL(policy.steps(5ul), 5ul);
+
+  // Evaluate with the tile pairs of half of the iterations stealable
+  policy.fraction(0.5);
+  policy.max_batch(1ul);
+  auto contract = make_contract_eval(left_arg, right_arg,
+      left_arg.world(), DenseShape(), pmap, Permutation(), make_contract(2u,
+      left_arg.trange().tiles_range().rank(), right_arg.trange().tiles_range().rank()));
+  using dist_eval_type = decltype(contract);
+
+  BOOST_REQUIRE_NO_THROW(contract.eval());
+  BOOST_REQUIRE_NO_THROW(contract.wait());
+  policy.fraction(fraction);
+  policy.max_batch(max_batch);
+
+  // Compute the reference contraction
+  const matrix_type l = copy_to_matrix(left, 1),
+                    r = copy_to_matrix(right, GlobalFixture::dim - 1);
+  const matrix_type reference = l * r;
+
+  for(auto index : *contract.pmap()) {
+    dist_eval_type::eval_type eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = contract.get(index).get());
+    BOOST_CHECK(eigen_map(eval_tile) == reference.block(eval_tile.range().lobound(0),
+        eval_tile.range().lobound(1), eval_tile.range().extent(0), eval_tile.range().extent(1)));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( summa_group_cache )
+{
+  World& world = *GlobalFixture::world;
+  detail::SummaGroupCache cache;
+  const std::vector<ProcessID> procs(1, world.rank());
+
+  // Groups with the same members are shared
+  madness::Group group1 = cache.group(world, true, procs,
+      madness::DistributedID(madness::uniqueidT(), 0ul));
+  madness::Group group2 = cache.group(world, true, procs,
+      madness::DistributedID(madness::uniqueidT(), 1ul));
+  BOOST_CHECK_EQUAL(cache.size(), 1ul);
+  BOOST_CHECK(group1.id() == group2.id());
+
+  // Row and column groups are not shared
+  cache.group(world, false, procs,
+      madness::DistributedID(madness::uniqueidT(), 2ul));
+  BOOST_CHECK_EQUAL(cache.size(), 2ul);
+
+  // Shared keys are unique and do not overlap with the iteration keys
+  BOOST_CHECK_EQUAL(detail::SummaGroupCache::shared_key(10ul, 0ul, true), 20ul);
+  BOOST_CHECK_NE(detail::SummaGroupCache::shared_key(10ul, 3ul, true),
+      detail::SummaGroupCache::shared_key(10ul, 3ul, false));
+  BOOST_CHECK_NE(detail::SummaGroupCache::shared_key(10ul, 3ul, true),
+      detail::SummaGroupCache::shared_key(10ul, 4ul, true));
+
+  cache.clear();
+  BOOST_CHECK_EQUAL(cache.size(), 0ul);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -182,6 +182,40 @@ BOOST_AUTO_TEST_CASE( eval )
   }
 }
 
+BOOST_AUTO_TEST_CASE( batched_eval )
+{
+  TiledArray::detail::TileBatchPolicy& policy =
+      TiledArray::detail::TileBatchPolicy::instance();
+  const std::size_t max_elements = policy.max_elements();
+  const std::size_t tasks_per_thread = policy.tasks_per_thread();
+
+  // Evaluate all local tiles in batches of at least two tiles
+  const std::size_t tile_volume = arg.trange().make_tile_range(0).volume();
+  policy.max_elements(2ul * tile_volume + 1ul);
+  policy.tasks_per_thread(0ul);
+
+  auto dist_eval = make_unary_eval(arg, arg.world(),
+      DenseShape(), arg.pmap(), Permutation(), make_scal0(3));
+
+  BOOST_REQUIRE_NO_THROW(dist_eval.eval());
+  BOOST_REQUIRE_NO_THROW(dist_eval.wait());
+  policy.max_elements(max_elements);
+  policy.tasks_per_thread(tasks_per_thread);
+
+  // Check that each tile has been properly scaled.
+  for(auto index : *dist_eval.pmap()) {
+    TensorI array_tile = array.find(index);
+
+    TensorI eval_tile;
+    BOOST_REQUIRE_NO_THROW(eval_tile = dist_eval.get(index).get());
+
+    BOOST_CHECK_EQUAL(eval_tile.range(), array_tile.range());
+    for(std::size_t i = 0ul; i < eval_tile.size(); ++i) {
+      BOOST_CHECK_EQUAL(eval_tile[i], 3 * array_tile[i]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( double_eval )
 {
   /// Construct a scaling unary evaluator
@@ -21,6 +21,7 @@
 #include "tiledarray.h"
 #include "unit_test_config.h"
 #include <iterator>
+#include <numeric>
 
 using namespace TiledArray;
 
@@ -121,5 +122,253 @@ BOOST_AUTO_TEST_CASE( array_operator )
 #endif // TA_EXCEPTION_ERROR
 }
 
+BOOST_AUTO_TEST_CASE( spill )
+{
+  typedef detail::DistributedStorage<Tensor<double> > TensorStorage;
+  const std::size_t bytes = 10ul * sizeof(double);
+
+  TileSpill& tile_spill = TileSpill::instance();
+  const bool enabled = tile_spill.enabled();
+  const std::string directory = tile_spill.directory();
+  const std::size_t memory_cap = tile_spill.memory_cap();
+
+  tile_spill.enable(".", 2ul * bytes);
+  {
+    TensorStorage s(world, 10, pmap);
+    BOOST_CHECK(s.spilling());
+
+    std::size_t count = 0ul;
+    for(std::size_t i = 0ul; i < s.max_size(); ++i) {
+      if(s.is_local(i)) {
+        s.set(i, Tensor<double>(Range(std::vector<std::size_t>{ 10ul }), double(i)));
+        ++count;
+      }
+    }
+
+    // Check that only the most recently used tiles are held in memory
+    BOOST_CHECK_LE(tile_spill.bytes(), 2ul * bytes);
+    BOOST_CHECK_EQUAL(s.size(), std::min(count, 2ul));
+
+    // Check that spilled tiles are read back
+    for(std::size_t i = 0ul; i < s.max_size(); ++i) {
+      if(s.is_local(i)) {
+        const Tensor<double> tile = s.get(i).get();
+        BOOST_CHECK_EQUAL(tile.size(), 10ul);
+        for(std::size_t j = 0ul; j < tile.size(); ++j)
+          BOOST_CHECK_EQUAL(tile[j], double(i));
+      }
+    }
+    BOOST_CHECK_LE(tile_spill.bytes(), 2ul * bytes);
+  }
+
+  // Check that the tiles of destroyed storage objects are not tracked
+  BOOST_CHECK_EQUAL(tile_spill.bytes(), 0ul);
+
+  tile_spill.enable(directory, memory_cap);
+  if(! enabled)
+    tile_spill.disable();
+}
+
+BOOST_AUTO_TEST_CASE( remote_cache )
+{
+  typedef detail::DistributedStorage<Tensor<double> > TensorStorage;
+  const std::size_t bytes = 10ul * sizeof(double);
+
+  RemoteTileCache& cache = RemoteTileCache::instance();
+  const bool enabled = cache.enabled();
+  const std::size_t capacity = cache.capacity();
+
+  cache.enable(2ul * bytes);
+  {
+    TensorStorage s(world, 10, pmap);
+    BOOST_CHECK(s.caching());
+
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      if(s.is_local(i))
+        s.set(i, Tensor<double>(Range(std::vector<std::size_t>{ 10ul }), double(i)));
+    world.gop.fence();
+
+    // Check that remote tiles are received, with and without the cache
+    for(unsigned int pass = 0u; pass < 2u; ++pass) {
+      for(std::size_t i = 0ul; i < s.max_size(); ++i) {
+        const Tensor<double> tile = s.get(i).get();
+        BOOST_CHECK_EQUAL(tile.size(), 10ul);
+        for(std::size_t j = 0ul; j < tile.size(); ++j)
+          BOOST_CHECK_EQUAL(tile[j], double(i));
+      }
+
+      // Check that only the most recently used tiles are cached
+      BOOST_CHECK_LE(cache.bytes(), 2ul * bytes);
+    }
+
+    // Check that the batched get uses the cache
+    std::vector<std::size_t> indices(s.max_size());
+    std::iota(indices.begin(), indices.end(), 0ul);
+    std::vector<TensorStorage::future> tiles = s.get(indices);
+    for(std::size_t i = 0ul; i < tiles.size(); ++i)
+      BOOST_CHECK_EQUAL(tiles[i].get()[0], double(i));
+    BOOST_CHECK_LE(cache.bytes(), 2ul * bytes);
+
+    // Check that invalidation drops the cached tiles
+    const std::size_t version = cache.version();
+    cache.fence(world);
+    BOOST_CHECK_EQUAL(cache.version(), version + 1ul);
+    BOOST_CHECK_EQUAL(cache.bytes(), 0ul);
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      BOOST_CHECK_EQUAL(s.get(i).get()[0], double(i));
+    world.gop.fence();
+  }
+
+  // Check that the tiles of destroyed storage objects are not tracked
+  BOOST_CHECK_EQUAL(cache.bytes(), 0ul);
+
+  cache.enable(capacity);
+  if(! enabled)
+    cache.disable();
+}
+
+BOOST_AUTO_TEST_CASE( hot_tiles )
+{
+  typedef detail::DistributedStorage<Tensor<double> > TensorStorage;
+
+  HotTileReplication& replication = HotTileReplication::instance();
+  const std::size_t threshold = replication.threshold();
+
+  replication.enable(1ul);
+  {
+    TensorStorage s(world, 10, pmap);
+    BOOST_CHECK(s.replicating());
+
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      if(s.is_local(i))
+        s.set(i, Tensor<double>(Range(std::vector<std::size_t>{ 10ul }), double(i)));
+    world.gop.fence();
+
+    // Read every element, so remote elements are replicated
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      BOOST_CHECK_EQUAL(s.get(i).get()[0], double(i));
+    world.gop.fence();
+
+    if(world.size() > 1) {
+      for(std::size_t i = 0ul; i < s.max_size(); ++i)
+        BOOST_CHECK(s.is_replicated(i));
+    }
+
+    // Check that replicas hold the element
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      BOOST_CHECK_EQUAL(s.get(i).get()[0], double(i));
+    world.gop.fence();
+
+    // Check that erasing an element drops its replicas
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      if(s.is_local(i))
+        s.erase(i);
+    world.gop.fence();
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      BOOST_CHECK(! s.is_replicated(i));
+
+    // Check that new values are read after the elements are set again
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      if(s.is_local(i))
+        s.set(i, Tensor<double>(Range(std::vector<std::size_t>{ 10ul }), -double(i)));
+    world.gop.fence();
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      BOOST_CHECK_EQUAL(s.get(i).get()[0], -double(i));
+    world.gop.fence();
+  }
+
+  if(threshold)
+    replication.enable(threshold);
+  else
+    replication.disable();
+}
+
+BOOST_AUTO_TEST_CASE( compress )
+{
+  typedef detail::DistributedStorage<Tensor<double> > TensorStorage;
+
+  TensorStorage s(world, 10, pmap);
+  std::size_t local = 0ul;
+  for(std::size_t i = 0ul; i < s.max_size(); ++i) {
+    if(s.is_local(i)) {
+      Tensor<double> tile(Range(std::vector<std::size_t>{ 1000ul }), 0.0);
+      for(std::size_t j = 0ul; j < tile.size(); j += 10ul)
+        tile[j] = double(i + j);
+      s.set(i, tile);
+      ++local;
+    }
+  }
+  world.gop.fence();
+
+  // Check that the local elements are compressed
+  BOOST_CHECK_EQUAL(s.compress(), local);
+  BOOST_CHECK_EQUAL(s.compressed_size(), local);
+  BOOST_CHECK_EQUAL(s.size(), 0ul);
+  BOOST_CHECK(s.compressed_bytes() < local * 1000ul * sizeof(double));
+  world.gop.fence();
+
+  // Check that elements are decompressed when they are accessed
+  for(std::size_t i = 0ul; i < s.max_size(); ++i) {
+    const Tensor<double> tile = s.get(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), Range(std::vector<std::size_t>{ 1000ul }));
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_EQUAL(tile[j], ((j % 10ul) ? 0.0 : double(i + j)));
+  }
+  world.gop.fence();
+  BOOST_CHECK_EQUAL(s.compressed_size(), 0ul);
+  BOOST_CHECK_EQUAL(s.size(), local);
+
+  // Check that all elements are decompressed
+  BOOST_CHECK_EQUAL(s.compress(), local);
+  s.decompress();
+  BOOST_CHECK_EQUAL(s.compressed_size(), 0ul);
+  BOOST_CHECK_EQUAL(s.compressed_bytes(), 0ul);
+  BOOST_CHECK_EQUAL(s.size(), local);
+  for(std::size_t i = 0ul; i < s.max_size(); ++i)
+    if(s.is_local(i))
+      BOOST_CHECK_EQUAL(s.get(i).get()[10], double(i + 10ul));
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( one_sided_get )
+{
+  typedef detail::DistributedStorage<Tensor<double> > TensorStorage;
+
+  // Check that elements that are not contiguous are not exposed
+  BOOST_CHECK(! t.expose());
+  BOOST_CHECK(! t.is_exposed());
+
+  {
+    TensorStorage s(world, 10, pmap);
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      if(s.is_local(i))
+        s.set(i, Tensor<double>(Range(std::vector<std::size_t>{ 10ul }), double(i)));
+
+    const bool exposed = s.expose();
+    BOOST_CHECK_EQUAL(exposed, s.is_exposed());
+    BOOST_CHECK_EQUAL(exposed, (! s.spilling()) &&
+        detail::RmaWindow<Tensor<double> >::supported(world));
+
+    // Check that remote elements are read, one at a time and in a batch
+    for(std::size_t i = 0ul; i < s.max_size(); ++i) {
+      const Tensor<double> tile = s.get(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), Range(std::vector<std::size_t>{ 10ul }));
+      for(std::size_t j = 0ul; j < tile.size(); ++j)
+        BOOST_CHECK_EQUAL(tile[j], double(i));
+    }
+    std::vector<std::size_t> indices(s.max_size());
+    std::iota(indices.begin(), indices.end(), 0ul);
+    std::vector<TensorStorage::future> tiles = s.get(indices);
+    for(std::size_t i = 0ul; i < tiles.size(); ++i)
+      BOOST_CHECK_EQUAL(tiles[i].get()[9], double(i));
+
+    // Check that gets use messages after the elements are concealed
+    s.conceal();
+    BOOST_CHECK(! s.is_exposed());
+    for(std::size_t i = 0ul; i < s.max_size(); ++i)
+      BOOST_CHECK_EQUAL(s.get(i).get()[0], double(i));
+    world.gop.fence();
+  }
+}
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -357,4 +357,73 @@ BOOST_AUTO_TEST_CASE( array_to_vector ) {
 }
 
 
+BOOST_AUTO_TEST_CASE( distributed_matrix_to_array ) {
+  World& world = *GlobalFixture::world;
+
+  // Fill the matrix with the same data on all processes
+  for(Eigen::MatrixXi::Index i = 0; i < matrix.rows(); ++i)
+    for(Eigen::MatrixXi::Index j = 0; j < matrix.cols(); ++j)
+      rmatrix(i, j) = matrix(i, j) = int(i * matrix.cols() + j);
+
+  // Each process provides one slab of rows
+  const std::size_t rows = matrix.rows();
+  const std::size_t first = rows * world.rank() / world.size();
+  const std::size_t last = rows * (world.rank() + 1) / world.size();
+  const Eigen::MatrixXi slab = matrix.middleRows(first, last - first);
+  BOOST_CHECK_NO_THROW((array = eigen_block_to_array<TArrayI>(world, trange, slab, first)));
+
+  for(std::size_t i = 0ul; i < array.size(); ++i) {
+    if(! array.is_local(i))
+      continue;
+    const TArrayI::value_type tile = array.find(i).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], matrix(index[0], index[1]));
+  }
+
+  // Raw row-major buffer slabs
+  TArrayI buffer_array;
+  BOOST_CHECK_NO_THROW((buffer_array = row_major_slab_to_array<TArrayI>(world,
+      trange, rmatrix.data() + first * rmatrix.cols(), first, last)));
+  for(std::size_t i = 0ul; i < buffer_array.size(); ++i) {
+    if(! buffer_array.is_local(i))
+      continue;
+    const TArrayI::value_type tile = buffer_array.find(i).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], matrix(index[0], index[1]));
+  }
+
+  // Gather a slab of columns on each process
+  const std::size_t cols = matrix.cols();
+  const std::size_t col_first = cols * world.rank() / world.size();
+  const std::size_t col_last = cols * (world.rank() + 1) / world.size();
+  Eigen::MatrixXi block;
+  BOOST_CHECK_NO_THROW((block = array_to_eigen_block(array, 0ul, rows,
+      col_first, col_last - col_first)));
+  BOOST_CHECK_EQUAL(block, matrix.middleCols(col_first, col_last - col_first));
+
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( distributed_vector_to_array ) {
+  World& world = *GlobalFixture::world;
+
+  for(Eigen::VectorXi::Index i = 0; i < vector.size(); ++i)
+    vector(i) = int(i) + 1;
+
+  const std::size_t size = vector.size();
+  const std::size_t first = size * world.rank() / world.size();
+  const std::size_t last = size * (world.rank() + 1) / world.size();
+  const Eigen::VectorXi segment = vector.segment(first, last - first);
+  BOOST_CHECK_NO_THROW((array1 = eigen_block_to_array<TArrayI>(world, trange1, segment, first)));
+
+  Eigen::MatrixXi result;
+  BOOST_CHECK_NO_THROW((result = array_to_eigen_block(array1, 0ul, size)));
+  BOOST_CHECK_EQUAL(result.rows(), vector.size());
+  BOOST_CHECK_EQUAL(result.cols(), 1);
+  for(Eigen::VectorXi::Index i = 0; i < vector.size(); ++i)
+    BOOST_CHECK_EQUAL(result(i, 0), vector(i));
+
+  world.gop.fence();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
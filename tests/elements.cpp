@@ -0,0 +1,124 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  elements.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/conversions/elements.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct ElementsFixture {
+  typedef std::pair<std::array<std::size_t, 2>, int> element_type;
+
+  ElementsFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8, 12}, TiledRange1{0, 5, 10} })
+  { }
+
+  static int value(const std::size_t i, const std::size_t j) { return int(i * 100ul + j); }
+
+  // The elements given by this process, where each element of the rows
+  // [0,lower) is given by one process
+  std::vector<element_type> elements(const std::size_t upper) const {
+    std::vector<element_type> result;
+    for(std::size_t i = 0ul; i < upper; ++i)
+      for(std::size_t j = 0ul; j < 10ul; ++j)
+        if(ProcessID((i + j) % world.size()) == world.rank())
+          result.emplace_back(std::array<std::size_t, 2>{{i, j}}, value(i, j));
+    return result;
+  }
+
+  World& world;
+  TiledRange trange;
+}; // ElementsFixture
+
+BOOST_FIXTURE_TEST_SUITE( elements_suite, ElementsFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  const std::vector<element_type> local = elements(12ul);
+  TArrayI a;
+  BOOST_REQUIRE_NO_THROW(a = make_array_from_elements<TArrayI>(world, trange,
+      local.begin(), local.end()));
+  BOOST_CHECK_EQUAL(a.trange(), trange);
+
+  for(const auto i : *a.pmap()) {
+    const TensorI tile = a.find(i).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], value(index[0], index[1]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  // Only the rows of the first tile row are given
+  const std::vector<element_type> local = elements(3ul);
+  TSpArrayI a = make_array_from_elements<TSpArrayI>(world, trange,
+      local.begin(), local.end());
+
+  for(const auto i : *a.pmap()) {
+    BOOST_CHECK_EQUAL(a.is_zero(i), a.trange().tiles_range().idx(i)[0] != 0ul);
+    if(a.is_zero(i))
+      continue;
+    const TensorI tile = a.find(i).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], value(index[0], index[1]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( accumulate )
+{
+  // Every process gives element (4,6)
+  const std::vector<element_type> local(1,
+      element_type(std::array<std::size_t, 2>{{4ul, 6ul}}, 2));
+
+  TArrayI sum = make_array_from_elements<TArrayI>(world, trange,
+      local.begin(), local.end(), true);
+  TArrayI set = make_array_from_elements<TArrayI>(world, trange,
+      local.begin(), local.end());
+
+  const std::size_t tile = trange.tiles_range().ordinal(std::vector<std::size_t>{1, 1});
+  if(sum.is_local(tile)) {
+    const TensorI sum_tile = sum.find(tile).get();
+    const TensorI set_tile = set.find(tile).get();
+    for(const auto& index : sum_tile.range()) {
+      const bool given = (index[0] == 4ul && index[1] == 6ul);
+      BOOST_CHECK_EQUAL(sum_tile[index], (given ? 2 * world.size() : 0));
+      BOOST_CHECK_EQUAL(set_tile[index], (given ? 2 : 0));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( out_of_range )
+{
+  const std::vector<element_type> local(1,
+      element_type(std::array<std::size_t, 2>{{12ul, 0ul}}, 1));
+  BOOST_CHECK_THROW(make_array_from_elements<TArrayI>(world, trange,
+      local.begin(), local.end()), TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
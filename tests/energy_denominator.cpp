@@ -0,0 +1,125 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  energy_denominator.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct EnergyDenominatorFixture {
+  EnergyDenominatorFixture() :
+    world(*GlobalFixture::world),
+    tro{0, 2, 3}, trv{0, 2, 5}
+  {
+    e_occ = TArrayD(world, TiledRange{tro});
+    e_vir = TArrayD(world, TiledRange{trv});
+    fill(e_occ, [] (const Range::index& i) { return -2.0 + 0.5 * double(i[0]); });
+    fill(e_vir, [] (const Range::index& i) { return 0.25 + double(i[0]); });
+  }
+
+  // Set the local tiles of an array with op
+  template <typename Array, typename Op>
+  static void fill(Array& array, const Op& op) {
+    for(const auto t : *array.pmap()) {
+      TensorD tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = op(index);
+      array.set(t, tile);
+    }
+  }
+
+  // Element value of the residuals
+  static double residual(const Range::index& i) {
+    double result = 1.0;
+    for(std::size_t d = 0ul; d < i.size(); ++d)
+      result += double((d + 1ul) * i[d]);
+    return result;
+  }
+
+  // Check that array is the residual divided by the denominator
+  template <typename Array>
+  void check(const Array& array, const EnergyDenominator<double>& denom) {
+    for(const auto t : *array.pmap()) {
+      if(array.is_zero(t))
+        continue;
+      const TensorD tile = array.find(t).get();
+      for(const auto& index : tile.range())
+        BOOST_CHECK_CLOSE(tile[index],
+            residual(index) / denom.denominator(index), 1.0e-10);
+    }
+  }
+
+  World& world;
+  TiledRange1 tro, trv;
+  TArrayD e_occ, e_vir;
+}; // EnergyDenominatorFixture
+
+BOOST_FIXTURE_TEST_SUITE( energy_denominator_suite, EnergyDenominatorFixture )
+
+BOOST_AUTO_TEST_CASE( denominator )
+{
+  EnergyDenominator<double> denom({ e_vir, e_occ }, { 1.0, -1.0 }, 0.5);
+  BOOST_CHECK_EQUAL(denom.rank(), 2u);
+  const std::vector<std::size_t> index = { 3ul, 1ul };
+  BOOST_CHECK_CLOSE(denom.denominator(index), 3.25 + 1.5 + 0.5, 1.0e-12);
+}
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  EnergyDenominator<double> denom({ e_vir, e_vir, e_occ, e_occ },
+      { 1.0, 1.0, -1.0, -1.0 });
+  TArrayD r(world, TiledRange{trv, trv, tro, tro});
+  fill(r, residual);
+  const double norm = r("a,b,i,j").norm().get();
+
+  BOOST_CHECK_CLOSE(denom(r), norm, 1.0e-10);
+  check(r, denom);
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  EnergyDenominator<double> denom({ e_vir, e_occ }, { 1.0, -1.0 });
+  TSpArrayD r(world, TiledRange{trv, tro});
+  fill(r, residual);
+  const double norm = r("a,i").norm().get();
+
+  BOOST_CHECK_CLOSE(denom(r), norm, 1.0e-10);
+  check(r, denom);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( invalid_args )
+{
+  BOOST_CHECK_THROW(EnergyDenominator<double>({ e_vir }, { 1.0, -1.0 }),
+      TiledArray::Exception);
+  EnergyDenominator<double> denom({ e_vir, e_occ }, { 1.0, -1.0 });
+  TArrayD r(world, TiledRange{trv, trv});
+  fill(r, residual);
+  BOOST_CHECK_THROW(denom(r), TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
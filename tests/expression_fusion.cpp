@@ -0,0 +1,180 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  expression_fusion.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/expressions/fused_kernel.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "range_fixture.h"
+
+using namespace TiledArray;
+
+struct ExpressionFusionFixture : public TiledRangeFixture {
+
+  ExpressionFusionFixture() :
+    a(*GlobalFixture::world, tr),
+    b(*GlobalFixture::world, tr),
+    c(*GlobalFixture::world, tr),
+    d(*GlobalFixture::world, tr)
+  {
+    fill(a, 1);
+    fill(b, 2);
+    fill(c, 3);
+    fill(d, 4);
+    GlobalFixture::world->gop.fence();
+  }
+
+  ~ExpressionFusionFixture() {
+    expressions::set_expression_fusion(true);
+    GlobalFixture::world->gop.fence();
+  }
+
+  // Fill an array with values that depend on the element index
+  static void fill(TArrayI& array, const int seed) {
+    for(const auto index : *array.pmap()) {
+      TensorI tile(array.trange().make_tile_range(index));
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        tile[i] = int((i * seed + index) % 17ul) - 8;
+      array.set(index, tile);
+    }
+  }
+
+  // Compare the local tiles of two arrays
+  static void check_equal(const TArrayI& result, const TArrayI& reference) {
+    for(const auto index : *result.pmap()) {
+      const TensorI result_tile = result.find(index).get();
+      const TensorI reference_tile = reference.find(index).get();
+      BOOST_CHECK_EQUAL(result_tile.range(), reference_tile.range());
+      for(std::size_t i = 0ul; i < result_tile.size(); ++i)
+        BOOST_CHECK_EQUAL(result_tile[i], reference_tile[i]);
+    }
+  }
+
+  TArrayI a;
+  TArrayI b;
+  TArrayI c;
+  TArrayI d;
+}; // ExpressionFusionFixture
+
+BOOST_FIXTURE_TEST_SUITE( expression_fusion_suite, ExpressionFusionFixture )
+
+BOOST_AUTO_TEST_CASE( kernel )
+{
+  const Range range(std::array<int, 2>{{3, 4}});
+  TensorI x(range), y(range);
+  for(std::size_t i = 0ul; i < x.size(); ++i) {
+    x[i] = int(i);
+    y[i] = int(2 * i) + 1;
+  }
+
+  typedef detail::FusedArg<int> arg_type;
+  typedef detail::FusedScal<detail::FusedSubt<arg_type, arg_type>, int> kernel_type;
+  const kernel_type kernel(detail::FusedSubt<arg_type, arg_type>(arg_type(0u),
+      arg_type(1u)), 3);
+
+  TensorI result = detail::fused_tile(kernel, range, std::vector<TensorI>{x, y});
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], (x[i] - y[i]) * 3);
+
+  // Empty arguments are zero tiles
+  result = detail::fused_tile(kernel, range, std::vector<TensorI>{x, TensorI()});
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_EQUAL(result[i], x[i] * 3);
+}
+
+BOOST_AUTO_TEST_CASE( element_wise )
+{
+  TArrayI result, reference;
+
+  BOOST_REQUIRE_NO_THROW(result("a,b,c") =
+      a("a,b,c") + 2 * b("a,b,c") - c("a,b,c") * d("a,b,c"));
+  expressions::set_expression_fusion(false);
+  BOOST_REQUIRE_NO_THROW(reference("a,b,c") =
+      a("a,b,c") + 2 * b("a,b,c") - c("a,b,c") * d("a,b,c"));
+  check_equal(result, reference);
+
+  expressions::set_expression_fusion(true);
+  BOOST_REQUIRE_NO_THROW(result("a,b,c") =
+      -3 * (a("a,b,c") - b("a,b,c")) * (2 * (c("a,b,c") + d("a,b,c"))));
+  expressions::set_expression_fusion(false);
+  BOOST_REQUIRE_NO_THROW(reference("a,b,c") =
+      -3 * (a("a,b,c") - b("a,b,c")) * (2 * (c("a,b,c") + d("a,b,c"))));
+  check_equal(result, reference);
+}
+
+BOOST_AUTO_TEST_CASE( permuted )
+{
+  TArrayI result, reference;
+
+  // Permuted arguments are not fused, but the rest of the tree is
+  BOOST_REQUIRE_NO_THROW(result("a,b,c") =
+      a("c,b,a") + b("a,b,c") * c("a,b,c") + d("a,b,c"));
+  expressions::set_expression_fusion(false);
+  BOOST_REQUIRE_NO_THROW(reference("a,b,c") =
+      a("c,b,a") + b("a,b,c") * c("a,b,c") + d("a,b,c"));
+  check_equal(result, reference);
+
+  // Permuted result
+  expressions::set_expression_fusion(true);
+  BOOST_REQUIRE_NO_THROW(result("c,b,a") = a("a,b,c") - 2 * b("a,b,c"));
+  expressions::set_expression_fusion(false);
+  BOOST_REQUIRE_NO_THROW(reference("c,b,a") = a("a,b,c") - 2 * b("a,b,c"));
+  check_equal(result, reference);
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  TArrayI result, reference;
+
+  // The contraction is evaluated separately and the sum is not fused
+  BOOST_REQUIRE_NO_THROW(result("i,j") =
+      a("i,b,c") * b("j,b,c") + 2 * (c("i,b,c") * d("j,b,c")));
+  expressions::set_expression_fusion(false);
+  BOOST_REQUIRE_NO_THROW(reference("i,j") =
+      a("i,b,c") * b("j,b,c") + 2 * (c("i,b,c") * d("j,b,c")));
+  check_equal(result, reference);
+}
+
+BOOST_AUTO_TEST_CASE( reduction )
+{
+  // Fused reductions return before the tiles are evaluated
+  auto sum = (a("a,b,c") - 2 * b("a,b,c")).sum();
+  auto squared_norm = (a("a,b,c") * c("a,b,c") + d("a,b,c")).squared_norm();
+  auto dot = (a("a,b,c") - b("a,b,c")).dot(c("a,b,c") + d("a,b,c"));
+
+  expressions::set_expression_fusion(false);
+  BOOST_CHECK_EQUAL(sum.get(), (a("a,b,c") - 2 * b("a,b,c")).sum().get());
+  BOOST_CHECK_EQUAL(squared_norm.get(),
+      (a("a,b,c") * c("a,b,c") + d("a,b,c")).squared_norm().get());
+  BOOST_CHECK_EQUAL(dot.get(),
+      (a("a,b,c") - b("a,b,c")).dot(c("a,b,c") + d("a,b,c")).get());
+
+  // A permuted argument is not fused
+  expressions::set_expression_fusion(true);
+  dot = (a("a,b,c") - b("a,b,c")).dot(c("c,b,a"));
+  expressions::set_expression_fusion(false);
+  BOOST_CHECK_EQUAL(dot.get(), (a("a,b,c") - b("a,b,c")).dot(c("c,b,a")).get());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
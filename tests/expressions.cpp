@@ -492,6 +492,32 @@ BOOST_AUTO_TEST_CASE( scale_permute )
   }
 }
 
+BOOST_AUTO_TEST_CASE( add_permute_placement )
+{
+  Permutation perm({2, 1, 0});
+  for(auto placement : { expressions::EvalPlacement::argument_owner,
+      expressions::EvalPlacement::result_owner,
+      expressions::EvalPlacement::automatic })
+  {
+    expressions::set_eval_placement(placement);
+    BOOST_REQUIRE_NO_THROW(c("c,b,a") = a("a,b,c") + b("a,b,c"));
+
+    for(std::size_t i = 0ul; i < a.size(); ++i) {
+      const std::size_t perm_index = c.range().ordinal(perm * a.range().idx(i));
+      if(c.is_local(perm_index)) {
+        TArrayI::value_type c_tile = c.find(perm_index).get();
+        TArrayI::value_type perm_a_tile = perm * a.find(i).get();
+        TArrayI::value_type perm_b_tile = perm * b.find(i).get();
+
+        BOOST_CHECK_EQUAL(c_tile.range(), perm_a_tile.range());
+        for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+          BOOST_CHECK_EQUAL(c_tile[j], perm_a_tile[j] + perm_b_tile[j]);
+      }
+    }
+  }
+  expressions::set_eval_placement(expressions::EvalPlacement::automatic);
+}
+
 BOOST_AUTO_TEST_CASE( block )
 {
   BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c").block({3,3,3}, {5,5,5}));
@@ -557,6 +583,33 @@ BOOST_AUTO_TEST_CASE( const_block )
   }
 }
 
+BOOST_AUTO_TEST_CASE( block_view )
+{
+  BlockRange block_range(a.trange().tiles_range(), {3,3,3}, {5,5,5});
+
+  // Keep a copy of the argument tiles
+  std::vector<Tensor<int> > arg_tiles;
+  for(std::size_t index = 0ul; index < block_range.volume(); ++index)
+    arg_tiles.push_back(a.find(block_range.ordinal(index)).get().clone());
+
+  // The block tiles are views of the array tiles and must not be modified
+  // by the operation that uses them.
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") = a("a,b,c").block({3,3,3}, {5,5,5})
+      + a("a,b,c").block({3,3,3}, {5,5,5}));
+
+  for(std::size_t index = 0ul; index < block_range.volume(); ++index) {
+    Tensor<int> arg_tile = a.find(block_range.ordinal(index)).get();
+    Tensor<int> result_tile = c.find(index).get();
+
+    BOOST_CHECK_EQUAL(arg_tile.range(), arg_tiles[index].range());
+    BOOST_CHECK_NE(result_tile.data(), arg_tile.data());
+    for(std::size_t j = 0ul; j < result_tile.range().volume(); ++j) {
+      BOOST_CHECK_EQUAL(arg_tile[j], arg_tiles[index][j]);
+      BOOST_CHECK_EQUAL(result_tile[j], 2 * arg_tile[j]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE( scal_block )
 {
   BOOST_REQUIRE_NO_THROW(c("a,b,c") = 2 * a("a,b,c").block({3,3,3}, {5,5,5}));
@@ -607,6 +660,42 @@ BOOST_AUTO_TEST_CASE( assign_sub_block )
     }
   }
 }
+BOOST_AUTO_TEST_CASE( assign_sub_block_in_place )
+{
+  c.fill_local(1);
+
+  // Record the data of the local tiles of the block
+  BlockRange block_range(a.trange().tiles_range(), {3,3,3}, {5,5,5});
+  std::vector<std::pair<std::size_t, const int*> > data;
+  for(std::size_t index = 0ul; index < block_range.volume(); ++index)
+    if(c.is_local(block_range.ordinal(index)))
+      data.emplace_back(index, c.find(block_range.ordinal(index)).get().data());
+
+  BOOST_REQUIRE_NO_THROW(c("a,b,c").block({3,3,3}, {5,5,5}).no_alias() =
+      2 * a("a,b,c").block({3,3,3}, {5,5,5}));
+
+  // Check that the result is written into the existing tiles
+  for(const auto& tile_data : data)
+    BOOST_CHECK_EQUAL(c.find(block_range.ordinal(tile_data.first)).get().data(),
+        tile_data.second);
+
+  for(std::size_t index = 0ul; index < block_range.volume(); ++index) {
+    Tensor<int> arg_tile = a.find(block_range.ordinal(index)).get();
+    Tensor<int> result_tile = c.find(block_range.ordinal(index)).get();
+
+    BOOST_CHECK_EQUAL(result_tile.range(), arg_tile.range());
+
+    for(std::size_t j = 0ul; j < result_tile.range().volume(); ++j) {
+      BOOST_CHECK_EQUAL(result_tile[j], 2 * arg_tile[j]);
+    }
+  }
+
+  // Check that the tiles outside the block are unchanged
+  Tensor<int> tile = c.find(0).get();
+  for(std::size_t j = 0ul; j < tile.range().volume(); ++j)
+    BOOST_CHECK_EQUAL(tile[j], 1);
+}
+
 BOOST_AUTO_TEST_CASE(assign_subblock_block_contract)
 {
   w.fill_local(0.0);
@@ -1213,6 +1302,821 @@ BOOST_AUTO_TEST_CASE( scale_cont )
 }
 
 
+BOOST_AUTO_TEST_CASE( cont_layers )
+{
+  TArrayI ref;
+  ref("i,j") = a("i,b,c") * b("j,b,c");
+
+  for(unsigned int layers = 1u; layers <= 3u; ++layers) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") =
+        (a("i,b,c") * b("j,b,c")).set_contraction_layers(layers));
+
+    for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+      TArrayI::value_type ref_tile = *it;
+      TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_layers_reduction )
+{
+  // Each layer needs its own processes, so the layers are limited by the
+  // number of processes; the partial results of the layers are reduced onto
+  // the first layer.
+  const unsigned int max_layers =
+      std::min<unsigned int>(GlobalFixture::world->size(), 4u);
+
+  TArrayI ref, ref_perm;
+  ref("i,j") = (a("i,b,c") * b("j,b,c")).set_contraction_layers(1u);
+  ref_perm("j,i") = (a("i,b,c") * b("j,b,c")).set_contraction_layers(1u);
+
+  for(unsigned int layers = 2u; layers <= max_layers; ++layers) {
+    auto plan = std::make_shared<ContractionPlan>();
+    BOOST_REQUIRE_NO_THROW(w("i,j") = (a("i,b,c") * b("j,b,c"))
+        .set_contraction_plan(plan).set_contraction_layers(layers));
+    BOOST_CHECK_EQUAL(plan->proc_grid().layers(), layers);
+
+    TArrayI w_perm;
+    BOOST_REQUIRE_NO_THROW(w_perm("j,i") =
+        (a("i,b,c") * b("j,b,c")).set_contraction_layers(layers));
+
+    for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+      TArrayI::value_type ref_tile = *it;
+      TArrayI::value_type tile = w.find(it.ordinal()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+
+    for(TArrayI::const_iterator it = ref_perm.begin(); it != ref_perm.end(); ++it) {
+      TArrayI::value_type ref_tile = *it;
+      TArrayI::value_type tile = w_perm.find(it.ordinal()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_symmetric )
+{
+  // A copy of a is not recognized as the same array, so the reference is
+  // evaluated with SUMMA.
+  TArrayI a_copy;
+  a_copy("i,b,c") = a("i,b,c");
+
+  TArrayI ref;
+  ref("i,j") = a("i,b,c") * a_copy("j,b,c");
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * a("j,b,c"));
+
+  for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+
+  // Contracted dimensions first
+  ref("i,j") = a("b,c,i") * a_copy("b,c,j");
+  BOOST_REQUIRE_NO_THROW(w("i,j") = a("b,c,i") * a("b,c,j"));
+
+  for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_scaled_leaves )
+{
+  TArrayI ref;
+  ref("i,j") = a("i,b,c") * b("j,b,c");
+
+  // Keep copies of the argument tiles to check that folding the leaf scaling
+  // factors into the contraction does not modify the arguments.
+  TArrayI a_copy;
+  a_copy("i,b,c") = a("i,b,c");
+
+  BOOST_REQUIRE_NO_THROW(w("i,j") = (2 * a("i,b,c")) * (3 * b("j,b,c")));
+
+  for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 6 * ref_tile[i]);
+  }
+
+  // Mix the leaf factors with a contraction factor and a permuted leaf
+  BOOST_REQUIRE_NO_THROW(w("i,j") = 5 * ((2 * a("i,b,c")) * (3 * b("j,c,b"))));
+
+  TArrayI ref_perm;
+  ref_perm("i,j") = a("i,b,c") * b("j,c,b");
+  for(TArrayI::const_iterator it = ref_perm.begin(); it != ref_perm.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 30 * ref_tile[i]);
+  }
+
+  for(TArrayI::const_iterator it = a_copy.begin(); it != a_copy.end(); ++it) {
+    TArrayI::value_type copy_tile = *it;
+    TArrayI::value_type tile = a.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], copy_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( scaled_expression_args )
+{
+  TArrayI ref;
+  ref("i,j") = (a("i,b,c") + b("i,b,c")) * b("j,b,c");
+
+  TArrayI a_copy;
+  a_copy("i,b,c") = a("i,b,c");
+
+  // The factor of a scaled (non-leaf) argument is folded into the contraction
+  auto sum = a("i,b,c") + b("i,b,c");
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      expressions::ScalExpr<decltype(sum), int>(sum, 2) * (3 * b("j,b,c")));
+
+  for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 6 * ref_tile[i]);
+  }
+
+  // Nested factors are folded into the contraction
+  auto scal_a = 3 * a("i,b,c");
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      expressions::ScalExpr<decltype(scal_a), int>(scal_a, 2) * b("j,b,c"));
+
+  TArrayI ref_a;
+  ref_a("i,j") = a("i,b,c") * b("j,b,c");
+  for(TArrayI::const_iterator it = ref_a.begin(); it != ref_a.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 6 * ref_tile[i]);
+  }
+
+  // Nested factors and a permutation are applied by one operation
+  Permutation perm({2, 1, 0});
+  auto scal_abc = 3 * a("c,b,a");
+  BOOST_REQUIRE_NO_THROW(c("a,b,c") =
+      expressions::ScalExpr<decltype(scal_abc), int>(scal_abc, 2));
+
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    const std::size_t perm_index = c.range().ordinal(perm * a.range().idx(i));
+    if(c.is_local(perm_index)) {
+      TArrayI::value_type c_tile = c.find(perm_index).get();
+      TArrayI::value_type perm_a_tile = perm * a.find(i).get();
+
+      BOOST_CHECK_EQUAL(c_tile.range(), perm_a_tile.range());
+      for(std::size_t j = 0ul; j < c_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(c_tile[j], 6 * perm_a_tile[j]);
+    }
+  }
+
+  // The arguments are not modified
+  for(TArrayI::const_iterator it = a_copy.begin(); it != a_copy.end(); ++it) {
+    TArrayI::value_type copy_tile = *it;
+    TArrayI::value_type tile = a.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], copy_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_conj_leaves )
+{
+  TArrayZ x(*GlobalFixture::world, tr);
+  TArrayZ y(*GlobalFixture::world, tr);
+  random_fill(x);
+  random_fill(y);
+  GlobalFixture::world->gop.fence();
+
+  // Explicitly conjugated arguments
+  TArrayZ x_conj, y_conj;
+  x_conj("a,b,c") = conj(x("a,b,c"));
+  y_conj("a,b,c") = conj(y("a,b,c"));
+
+  auto check = [] (const TArrayZ& result, const TArrayZ& ref,
+      const std::complex<double> factor)
+  {
+    for(TArrayZ::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+      TArrayZ::value_type ref_tile = *it;
+      TArrayZ::value_type tile = result.find(it.ordinal()).get();
+
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], factor * ref_tile[i]);
+    }
+  };
+
+  // The conjugation of transposed arguments is done by ConjTrans
+  TArrayZ z, ref;
+  BOOST_REQUIRE_NO_THROW(z("i,j") = x("i,b,c") * conj(y("j,b,c")));
+  ref("i,j") = x("i,b,c") * y_conj("j,b,c");
+  check(z, ref, 1.0);
+
+  BOOST_REQUIRE_NO_THROW(z("i,j") = conj(x("b,c,i")) * y("b,c,j"));
+  ref("i,j") = x_conj("b,c,i") * y("b,c,j");
+  check(z, ref, 1.0);
+
+  // Scaled and negated conjugated leaves
+  BOOST_REQUIRE_NO_THROW(z("i,j") = (2.0 * conj(x("b,c,i"))) * -conj(y("j,b,c")));
+  ref("i,j") = x_conj("b,c,i") * y_conj("j,b,c");
+  check(z, ref, -2.0);
+
+  // Arguments that are not transposed are conjugated by the leaf
+  BOOST_REQUIRE_NO_THROW(z("i,j") = conj(x("i,b,c")) * y("b,c,j"));
+  ref("i,j") = x_conj("i,b,c") * y("b,c,j");
+  check(z, ref, 1.0);
+
+  // The product of an array and its adjoint is computed with herk
+  BOOST_REQUIRE_NO_THROW(z("i,j") = 3.0 * (x("i,b,c") * conj(x("j,b,c"))));
+  ref("i,j") = x("i,b,c") * x_conj("j,b,c");
+  check(z, ref, 3.0);
+
+  // The arguments are not modified
+  TArrayZ x_ref;
+  x_ref("a,b,c") = conj(x_conj("a,b,c"));
+  check(x, x_ref, 1.0);
+}
+
+BOOST_AUTO_TEST_CASE( cont_summa_depth )
+{
+  TArrayI ref;
+  ref("i,j") = a("i,b,c") * b("j,b,c");
+
+  for(std::size_t depth = 1ul; depth <= 3ul; ++depth) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") =
+        (a("i,b,c") * b("j,b,c")).set_summa_depth(depth).set_summa_memory(1ul << 30));
+
+    for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+      TArrayI::value_type ref_tile = *it;
+      TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_plan )
+{
+  TArrayI ref;
+  ref("i,j") = a("i,b,c") * b("j,b,c");
+
+  auto plan = std::make_shared<ContractionPlan>();
+  for(unsigned int iter = 0u; iter < 3u; ++iter) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") =
+        (a("i,b,c") * b("j,b,c")).set_contraction_plan(plan));
+
+    for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+      TArrayI::value_type ref_tile = *it;
+      TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+
+  // The first evaluation computes the plan, and the others reuse it
+  BOOST_CHECK_EQUAL(plan->misses(), 1ul);
+  BOOST_CHECK_EQUAL(plan->hits(), 2ul);
+
+  // A different contraction recomputes the plan
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_contraction_plan(plan).set_contraction_layers(2u));
+  BOOST_CHECK_EQUAL(plan->misses(), (GlobalFixture::world->size() > 1 ? 2ul : 1ul));
+}
+
+BOOST_AUTO_TEST_CASE( cont_plan_persistent )
+{
+  TArrayI ref;
+  ref("i,j") = a("i,b,c") * b("j,b,c");
+
+  // Later evaluations restart the broadcasts of the first one
+  TiledArray::detail::SummaPersistentPolicy::instance().enable();
+  auto plan = std::make_shared<ContractionPlan>();
+  for(unsigned int iter = 0u; iter < 3u; ++iter) {
+    BOOST_REQUIRE_NO_THROW(w("i,j") =
+        (a("i,b,c") * b("j,b,c")).set_contraction_plan(plan));
+
+    for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+      TArrayI::value_type ref_tile = *it;
+      TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+  TiledArray::detail::SummaPersistentPolicy::instance().disable();
+
+  // The persistent requests of the channels are freed with the plan
+  GlobalFixture::world->gop.fence();
+  plan.reset();
+}
+
+BOOST_AUTO_TEST_CASE( cont_screening )
+{
+  TArrayI ref;
+  ref("i,j") = a("i,b,c") * b("j,b,c");
+
+  // Dense shapes are not screened
+  BOOST_REQUIRE_NO_THROW(w("i,j") =
+      (a("i,b,c") * b("j,b,c")).set_screening_error(1.0e6));
+
+  for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_estimate )
+{
+  TiledArray::expressions::ExprEstimate est;
+  BOOST_REQUIRE_NO_THROW(est = (a("i,b,c") * b("j,b,c")).estimate(w("i,j")));
+
+  // The result, left, and right-hand nodes
+  BOOST_REQUIRE_EQUAL(est.nodes().size(), 3ul);
+  BOOST_CHECK_EQUAL(est.nodes()[0].depth, 0u);
+  BOOST_CHECK_EQUAL(est.nodes()[1].depth, 1u);
+  BOOST_CHECK_EQUAL(est.nodes()[2].depth, 1u);
+
+  // The arrays are dense
+  const auto& left = a.trange();
+  const auto& right = b.trange();
+  const double m = left.elements_range().extent(0);
+  const double k = left.elements_range().volume() / m;
+  const double n = right.elements_range().extent(0);
+  const std::size_t M = left.tiles_range().extent(0);
+  const std::size_t K = left.tiles_range().volume() / M;
+  const std::size_t N = right.tiles_range().extent(0);
+  BOOST_CHECK_CLOSE(est.flops(), 2.0 * m * n * k, 1.0e-8);
+  BOOST_CHECK_EQUAL(est.nodes()[0].tiles, M * N);
+  BOOST_CHECK_EQUAL(est.tasks(), M * K * N + M * N);
+  BOOST_CHECK_GE(est.peak_memory(), est.nodes()[0].memory);
+  BOOST_CHECK_GT(est.nodes()[0].memory, 0.0);
+  BOOST_CHECK_EQUAL(est.nodes()[1].memory, 0.0);
+  if(GlobalFixture::world->size() == 1)
+    BOOST_CHECK_EQUAL(est.comm_bytes(), 0.0);
+
+  // Element-wise expressions
+  BOOST_REQUIRE_NO_THROW(est = (a("a,b,c") + b("a,b,c")).estimate(c("a,b,c")));
+  BOOST_REQUIRE_EQUAL(est.nodes().size(), 3ul);
+  BOOST_CHECK_CLOSE(est.flops(), double(left.elements_range().volume()), 1.0e-8);
+  BOOST_CHECK_EQUAL(est.tasks(), left.tiles_range().volume());
+}
+
+BOOST_AUTO_TEST_CASE( cont_async )
+{
+  TArrayI ref_w, ref_u;
+  ref_w("i,j") = a("i,b,c") * b("j,b,c");
+  ref_u("i,j") = ref_w("i,j") + b("i,b,c") * a("j,b,c");
+
+  TArrayI u;
+  {
+    TiledArray::expressions::AsyncEval async;
+    BOOST_CHECK(TiledArray::expressions::async_eval());
+
+    // Independent contractions followed by a dependent sum
+    BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+    BOOST_REQUIRE_NO_THROW(u("i,j") = b("i,b,c") * a("j,b,c"));
+    BOOST_REQUIRE_NO_THROW(u("i,j") = w("i,j") + u("i,j"));
+  }
+  BOOST_CHECK(! TiledArray::expressions::async_eval());
+  BOOST_CHECK_EQUAL(TiledArray::expressions::detail::AsyncEvalQueue::instance().size(), 0ul);
+  GlobalFixture::world->gop.fence();
+
+  for(TArrayI::const_iterator it = ref_w.begin(); it != ref_w.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+
+  for(TArrayI::const_iterator it = ref_u.begin(); it != ref_u.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = u.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+
+  // Assignment with an explicit handle
+  TiledArray::expressions::EvalHandle handle;
+  BOOST_REQUIRE_NO_THROW(handle = u("i,j").assign_async(a("i,b,c") * b("j,b,c")));
+  BOOST_REQUIRE_NO_THROW(handle.wait());
+  BOOST_CHECK(handle.probe());
+  TiledArray::expressions::wait_async();
+
+  // Completion notification
+  madness::AtomicInt done;
+  done = 0;
+  BOOST_REQUIRE_NO_THROW(handle = w("i,j").assign_async(a("i,b,c") * b("j,b,c")));
+  BOOST_REQUIRE_NO_THROW(handle.on_completion([&done] () { ++done; }));
+  Future<bool> completed = handle.completion();
+  BOOST_CHECK(completed.get());
+  BOOST_CHECK(handle.probe());
+  BOOST_CHECK_EQUAL(int(done), 1);
+  BOOST_REQUIRE_NO_THROW(handle.on_completion([&done] () { ++done; }));
+  BOOST_CHECK_EQUAL(int(done), 2);
+  TiledArray::expressions::wait_async();
+
+  for(TArrayI::const_iterator it = ref_w.begin(); it != ref_w.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = u.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_dataflow )
+{
+  TArrayI ref_w, ref_u;
+  ref_w("i,j") = a("i,b,c") * b("j,b,c");
+  ref_u("i,j") = ref_w("i,k") * ref_w("k,j") + ref_w("i,j");
+
+  TArrayI u;
+  {
+    TiledArray::expressions::DataflowEval dataflow;
+    BOOST_CHECK(TiledArray::expressions::async_eval());
+    BOOST_CHECK(TiledArray::expressions::dataflow_eval());
+
+    // A chain of contractions, each of which consumes the tiles of the
+    // previous result as they are computed
+    BOOST_REQUIRE_NO_THROW(w("i,j") = a("i,b,c") * b("j,b,c"));
+    BOOST_REQUIRE_NO_THROW(u("i,j") = w("i,k") * w("k,j"));
+    BOOST_REQUIRE_NO_THROW(u("i,j") = u("i,j") + w("i,j"));
+  }
+  BOOST_CHECK(! TiledArray::expressions::dataflow_eval());
+  BOOST_CHECK(! TiledArray::expressions::async_eval());
+  BOOST_CHECK_EQUAL(TiledArray::expressions::detail::AsyncEvalQueue::instance().size(), 0ul);
+  GlobalFixture::world->gop.fence();
+
+  for(TArrayI::const_iterator it = ref_w.begin(); it != ref_w.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = w.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+
+  for(TArrayI::const_iterator it = ref_u.begin(); it != ref_u.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = u.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_sum )
+{
+  // Evaluate the terms one at a time
+  TArrayI ref_w, ref_u, ref_v;
+  ref_w("i,j") = a("i,b,c") * b("j,b,c");
+  ref_u("i,j") = b("i,b,c") * a("j,b,c");
+  ref_v("i,j") = ref_w("i,k") * ref_u("k,j");
+  ref_v("i,j") = ref_v("i,j") + ref_u("i,j");
+  ref_v("i,j") = ref_v("i,j") + 2 * ref_w("i,j");
+
+  // The products are accumulated into one result
+  TArrayI r;
+  BOOST_REQUIRE_NO_THROW(r("i,j") = (a("i,b,c") * b("k,b,c")) * (b("k,b,c") * a("j,b,c"))
+      + b("i,b,c") * a("j,b,c") + 2 * (a("i,b,c") * b("j,b,c")));
+
+  for(TArrayI::const_iterator it = ref_v.begin(); it != ref_v.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = r.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+
+  // A sum of products and arrays, which uses the result
+  TArrayI ref_x, ref_y;
+  ref_x("i,j") = r("i,k") * ref_u("k,j");
+  ref_x("i,j") = ref_x("i,j") - ref_w("i,j");
+  ref_y("i,j") = ref_u("i,k") * ref_w("k,j");
+  ref_x("i,j") = ref_x("i,j") + ref_y("i,j");
+  ref_x("i,j") = ref_x("i,j") + r("i,j");
+
+  BOOST_REQUIRE_NO_THROW(r("i,j") = r("i,k") * ref_u("k,j") - ref_w("i,j")
+      + ref_u("i,k") * ref_w("k,j") + r("i,j"));
+
+  for(TArrayI::const_iterator it = ref_x.begin(); it != ref_x.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = r.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_sum_schedule )
+{
+  using TiledArray::expressions::SumSchedule;
+  SumSchedule& schedule = SumSchedule::instance();
+  const std::size_t memory_cap = schedule.memory_cap();
+
+  TArrayI ref_w, ref_u;
+  ref_w("i,j") = a("i,b,c") * b("j,b,c");
+  ref_u("i,j") = b("i,b,c") * a("j,b,c");
+
+  // A cap that no term fits in, so each term is evaluated alone
+  schedule.set_memory_cap(1ul);
+
+  TArrayI r;
+  BOOST_REQUIRE_NO_THROW(r("i,j") = a("i,b,c") * b("j,b,c") + ref_u("i,j")
+      - 2 * (b("i,b,c") * a("j,b,c")));
+
+  for(TArrayI::const_iterator it = ref_w.begin(); it != ref_w.end(); ++it) {
+    TArrayI::value_type w_tile = *it;
+    TArrayI::value_type u_tile = ref_u.find(it.ordinal()).get();
+    TArrayI::value_type tile = r.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], w_tile[i] - u_tile[i]);
+  }
+
+  // The result may be a term of the sum
+  BOOST_REQUIRE_NO_THROW(r("i,j") = r("i,j") + b("i,b,c") * a("j,b,c")
+      - ref_w("i,j"));
+  schedule.set_memory_cap(memory_cap);
+
+  // The terms did not modify the argument arrays
+  TArrayI check;
+  check("i,j") = b("i,b,c") * a("j,b,c");
+  for(TArrayI::const_iterator it = check.begin(); it != check.end(); ++it) {
+    TArrayI::value_type u_tile = *it;
+    TArrayI::value_type ref_tile = ref_u.find(it.ordinal()).get();
+    TArrayI::value_type tile = r.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i) {
+      BOOST_CHECK_EQUAL(tile[i], 0);
+      BOOST_CHECK_EQUAL(ref_tile[i], u_tile[i]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cached_intermediate )
+{
+  using TiledArray::expressions::ExprCache;
+  using TiledArray::expressions::cached;
+  ExprCache& cache = ExprCache::instance();
+  cache.clear();
+  const std::size_t hits = cache.hits();
+  const std::size_t misses = cache.misses();
+
+  TArrayI ref, r;
+  ref("a,b,c") = 2 * (a("a,b,c") + b("a,b,c"));
+
+  // The intermediate is evaluated once and reused
+  BOOST_REQUIRE_NO_THROW(r("a,b,c") = cached(a("a,b,c") + b("a,b,c")) + a("a,b,c"));
+  BOOST_REQUIRE_NO_THROW(r("a,b,c") = r("a,b,c") - a("a,b,c")
+      + cached(a("a,b,c") + b("a,b,c")));
+  BOOST_CHECK_EQUAL(cache.size(), 1ul);
+  BOOST_CHECK_EQUAL(cache.misses() - misses, 1ul);
+  BOOST_CHECK_EQUAL(cache.hits() - hits, 1ul);
+
+  for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = r.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+  }
+
+  // Reassigning an argument invalidates the intermediate
+  TArrayI d;
+  d("a,b,c") = b("a,b,c");
+  BOOST_REQUIRE_NO_THROW(r("a,b,c") = cached(a("a,b,c") + d("a,b,c")));
+  BOOST_CHECK_EQUAL(cache.size(), 2ul);
+  d("a,b,c") = a("a,b,c");
+  BOOST_REQUIRE_NO_THROW(r("a,b,c") = cached(a("a,b,c") + d("a,b,c")));
+  BOOST_CHECK_EQUAL(cache.misses() - misses, 3ul);
+  BOOST_CHECK_EQUAL(cache.size(), 2ul);
+
+  for(TArrayI::const_iterator it = a.begin(); it != a.end(); ++it) {
+    TArrayI::value_type a_tile = *it;
+    TArrayI::value_type tile = r.find(it.ordinal()).get();
+
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], 2 * a_tile[i]);
+  }
+
+  // Destroying an argument removes the intermediate
+  d = TArrayI();
+  BOOST_REQUIRE_NO_THROW(r("a,b,c") = cached(a("a,b,c") + b("a,b,c")));
+  BOOST_CHECK_EQUAL(cache.size(), 1ul);
+
+  cache.clear();
+}
+
+BOOST_AUTO_TEST_CASE( cont_order )
+{
+  using TiledArray::expressions::ContOrder;
+
+  // The chain is cheaper to evaluate from the right
+  std::array<std::size_t, 5> tiling_large = {{ 0, 10, 20, 30, 40 }};
+  std::array<std::size_t, 2> tiling_small = {{ 0, 2 }};
+  TiledRange1 large(tiling_large.begin(), tiling_large.end());
+  TiledRange1 small(tiling_small.begin(), tiling_small.end());
+  TArrayI x(*GlobalFixture::world, TiledRange({ large, small }));
+  TArrayI y(*GlobalFixture::world, TiledRange({ small, large }));
+  TArrayI z(*GlobalFixture::world, TiledRange({ large, small }));
+  random_fill(x);
+  random_fill(y);
+  random_fill(z);
+  GlobalFixture::world->gop.fence();
+
+  TArrayI ref, ref_scaled, result, result_scaled;
+  ContOrder::instance().disable();
+  ref("i,j") = x("i,k") * y("k,l") * z("l,j");
+  ref_scaled("i,j") = 2 * (3 * x("i,k") * y("k,l") * z("l,j"));
+  ContOrder::instance().enable();
+
+  BOOST_REQUIRE_NO_THROW(result("i,j") = x("i,k") * y("k,l") * z("l,j"));
+  BOOST_REQUIRE_NO_THROW(result_scaled("i,j") = 2 * (3 * x("i,k") * y("k,l") * z("l,j")));
+
+  for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    TArrayI::value_type tile = result.find(it.ordinal()).get();
+    TArrayI::value_type ref_scaled_tile = ref_scaled.find(it.ordinal()).get();
+    TArrayI::value_type scaled_tile = result_scaled.find(it.ordinal()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+    for(std::size_t i = 0ul; i < tile.size(); ++i) {
+      BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+      BOOST_CHECK_EQUAL(scaled_tile[i], ref_scaled_tile[i]);
+    }
+  }
+
+  // Permuted result
+  BOOST_REQUIRE_NO_THROW(result("j,i") = x("i,k") * y("k,l") * z("l,j"));
+  for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayI::value_type ref_tile = *it;
+    for(Range::const_iterator rit = ref_tile.range().begin(); rit != ref_tile.range().end(); ++rit) {
+      const std::vector<std::size_t> index = { (*rit)[1], (*rit)[0] };
+      BOOST_CHECK_EQUAL(result.find(result.trange().element_to_tile(index)).get()[index],
+          ref_tile[*rit]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( cont_order_override )
+{
+  using TiledArray::expressions::ContOrder;
+
+  // Chains with evaluation parameters are evaluated in the written order,
+  // so the parameters apply to the result
+  std::array<std::size_t, 5> tiling_large = {{ 0, 10, 20, 30, 40 }};
+  std::array<std::size_t, 2> tiling_small = {{ 0, 2 }};
+  TiledRange1 large(tiling_large.begin(), tiling_large.end());
+  TiledRange1 small(tiling_small.begin(), tiling_small.end());
+  World& world = *GlobalFixture::world;
+  auto make_array = [&world] (const TiledRange& trange) {
+    Tensor<float> norms(trange.tiles_range(), 1.0f);
+    TSpArrayI array(world, trange, SparseShape<float>(norms, trange));
+    for(const auto index : *array.pmap())
+      array.set(index, make_rand_tile<TSpArrayI>(trange.make_tile_range(index)));
+    return array;
+  };
+  TSpArrayI x = make_array(TiledRange({ large, small }));
+  TSpArrayI y = make_array(TiledRange({ small, large }));
+  TSpArrayI z = make_array(TiledRange({ large, small }));
+  world.gop.fence();
+
+  // Mask the off-diagonal tiles of the result
+  const TiledRange result_trange({ large, large });
+  Tensor<float> mask_norms(result_trange.tiles_range(), 0.0f);
+  for(std::size_t i = 0ul; i < large.tile_extent(); ++i)
+    mask_norms(i, i) = 1.0f;
+  const SparseShape<float> mask(mask_norms, result_trange);
+
+  TSpArrayI ref, result;
+  ContOrder::instance().disable();
+  ref("i,j") = x("i,k") * y("k,l") * z("l,j");
+  ContOrder::instance().enable();
+
+  ContOrder::instance().clear_paths();
+  BOOST_REQUIRE_NO_THROW(result("i,j") =
+      (x("i,k") * y("k,l") * z("l,j")).set_shape(mask).set_world(world));
+  BOOST_CHECK_EQUAL(ContOrder::instance().paths(), 0ul);
+  BOOST_CHECK(&result.world() == &world);
+
+  for(std::size_t i = 0ul; i < result_trange.tiles_range().volume(); ++i) {
+    const auto index = result_trange.tiles_range().idx(i);
+    if(index[0] != index[1]) {
+      BOOST_CHECK(result.is_zero(i));
+    } else if(result.is_local(i)) {
+      BOOST_REQUIRE(! result.is_zero(i));
+      TSpArrayI::value_type ref_tile = ref.find(i).get();
+      TSpArrayI::value_type tile = result.find(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t j = 0ul; j < tile.size(); ++j)
+        BOOST_CHECK_EQUAL(tile[j], ref_tile[j]);
+    }
+  }
+  ContOrder::instance().clear_paths();
+}
+
+BOOST_AUTO_TEST_CASE( cont_einsum )
+{
+  using TiledArray::expressions::ContOrder;
+
+  // A four operand network that is cheapest to contract from the right
+  std::array<std::size_t, 5> tiling_large = {{ 0, 10, 20, 30, 40 }};
+  std::array<std::size_t, 2> tiling_small = {{ 0, 2 }};
+  TiledRange1 large(tiling_large.begin(), tiling_large.end());
+  TiledRange1 small(tiling_small.begin(), tiling_small.end());
+  TArrayI w(*GlobalFixture::world, TiledRange({ large, small }));
+  TArrayI x(*GlobalFixture::world, TiledRange({ small, large }));
+  TArrayI y(*GlobalFixture::world, TiledRange({ large, small }));
+  TArrayI z(*GlobalFixture::world, TiledRange({ small, large }));
+  random_fill(w);
+  random_fill(x);
+  random_fill(y);
+  random_fill(z);
+  GlobalFixture::world->gop.fence();
+
+  TArrayI ref, result;
+  ContOrder::instance().disable();
+  ref("i,j") = 2 * (w("i,k") * x("k,l") * y("l,m") * z("m,j"));
+  ContOrder::instance().enable();
+
+  ContOrder::instance().clear_paths();
+  for(int iter = 0; iter < 2; ++iter) {
+    BOOST_REQUIRE_NO_THROW(einsum(result("i,j"), w("i,k"), x("k,l"),
+        2 * y("l,m"), z("m,j")));
+    BOOST_CHECK_EQUAL(ContOrder::instance().paths(), 1ul);
+
+    for(TArrayI::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+      TArrayI::value_type ref_tile = *it;
+      TArrayI::value_type tile = result.find(it.ordinal()).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_EQUAL(tile[i], ref_tile[i]);
+    }
+  }
+  ContOrder::instance().clear_paths();
+}
+
+BOOST_AUTO_TEST_CASE( cont_mixed_precision )
+{
+  std::array<std::size_t, 5> tiling = {{ 0, 10, 20, 30, 40 }};
+  TiledRange1 tr1(tiling.begin(), tiling.end());
+  TArrayF x(*GlobalFixture::world, TiledRange({ tr1, tr1 }));
+  TArrayF y(*GlobalFixture::world, TiledRange({ tr1, tr1 }));
+  random_fill(x);
+  random_fill(y);
+  GlobalFixture::world->gop.fence();
+
+  // The products of the random integers are exact in single precision
+  TArrayF ref;
+  ref("i,j") = x("i,k") * y("k,j");
+
+  TArrayD result, result_scaled;
+  BOOST_REQUIRE_NO_THROW(result("i,j") = x("i,k") * y("k,j"));
+  BOOST_REQUIRE_NO_THROW(result_scaled("j,i") = 2 * (x("i,k") * y("k,j")));
+
+  for(TArrayF::const_iterator it = ref.begin(); it != ref.end(); ++it) {
+    TArrayF::value_type ref_tile = *it;
+    TArrayD::value_type tile = result.find(it.ordinal()).get();
+
+    BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+    for(Range::const_iterator rit = ref_tile.range().begin(); rit != ref_tile.range().end(); ++rit) {
+      BOOST_CHECK_EQUAL(tile[*rit], double(ref_tile[*rit]));
+
+      const std::vector<std::size_t> index = { (*rit)[1], (*rit)[0] };
+      BOOST_CHECK_EQUAL(result_scaled.find(result_scaled.trange().element_to_tile(index)).get()[index],
+          2.0 * double(ref_tile[*rit]));
+    }
+  }
+
+  // Only contractions accumulate in the precision of the result
+  BOOST_CHECK_THROW(result("i,j") = x("i,j") * y("i,j"), TiledArray::Exception);
+}
+
 BOOST_AUTO_TEST_CASE( cont_non_uniform1 )
 {
   // Construc the tiled range
@@ -1418,6 +2322,47 @@ BOOST_AUTO_TEST_CASE( no_alias_plus_reduce )
   }
 }
 
+BOOST_AUTO_TEST_CASE( no_alias_cont_in_place )
+{
+  TArrayI result;
+  result("a,b") = a("a,i,j") * b("b,i,j");
+
+  TArrayI expected;
+  expected("a,b") = 3 * (a("a,i,j") * b("b,i,j"));
+
+  // Record the data of the local tiles
+  std::vector<const int*> data;
+  for(auto it = result.begin(); it != result.end(); ++it)
+    data.push_back(it->get().data());
+
+  // The contraction is accumulated into the existing tiles
+  BOOST_REQUIRE_NO_THROW(result("a,b").no_alias() += 2 * (a("a,i,j") * b("b,i,j")));
+
+  std::size_t t = 0ul;
+  for(auto it = result.begin(); it != result.end(); ++it, ++t) {
+    const TArrayI::value_type tile = *it;
+    BOOST_CHECK_EQUAL(tile.data(), data[t]);
+
+    const TArrayI::value_type expected_tile = expected.find(it.ordinal()).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], expected_tile[i]);
+  }
+
+  // Subtraction is accumulated in place with a negative factor
+  BOOST_REQUIRE_NO_THROW(result("a,b").no_alias() -= a("a,i,j") * b("b,i,j"));
+  expected("a,b") = 2 * (a("a,i,j") * b("b,i,j"));
+
+  t = 0ul;
+  for(auto it = result.begin(); it != result.end(); ++it, ++t) {
+    const TArrayI::value_type tile = *it;
+    BOOST_CHECK_EQUAL(tile.data(), data[t]);
+
+    const TArrayI::value_type expected_tile = expected.find(it.ordinal()).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_EQUAL(tile[i], expected_tile[i]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE( outer_product )
 {
   // Generate Eigen matrices from input arrays.
@@ -1437,6 +2382,36 @@ BOOST_AUTO_TEST_CASE( outer_product )
   BOOST_CHECK_EQUAL(ew, ew_test);
 }
 
+BOOST_AUTO_TEST_CASE( matrix_vector )
+{
+  random_fill(w);
+  GlobalFixture::world->gop.fence();
+
+  // Generate Eigen matrices from input arrays.
+  EigenMatrixXi ew = make_matrix(w);
+  EigenMatrixXi eu = make_matrix(u);
+
+  // Matrix-vector product
+  TArrayI x;
+  BOOST_REQUIRE_NO_THROW(x("i") = w("i,j") * u("j"));
+  GlobalFixture::world->gop.fence();
+  BOOST_CHECK_EQUAL(make_matrix(x), EigenMatrixXi(ew * eu));
+
+  // Transposed matrix-vector product
+  BOOST_REQUIRE_NO_THROW(x("i") = w("j,i") * u("j"));
+  GlobalFixture::world->gop.fence();
+  BOOST_CHECK_EQUAL(make_matrix(x), EigenMatrixXi(ew.transpose() * eu));
+
+  // Vector-matrix products
+  BOOST_REQUIRE_NO_THROW(x("j") = 2 * (u("i") * w("i,j")));
+  GlobalFixture::world->gop.fence();
+  BOOST_CHECK_EQUAL(make_matrix(x), EigenMatrixXi(2 * ew.transpose() * eu));
+
+  BOOST_REQUIRE_NO_THROW(x("j") = u("i") * w("j,i"));
+  GlobalFixture::world->gop.fence();
+  BOOST_CHECK_EQUAL(make_matrix(x), EigenMatrixXi(ew * eu));
+}
+
 BOOST_AUTO_TEST_CASE( dot )
 {
   // Test the dot expression function
@@ -1481,6 +2456,31 @@ BOOST_AUTO_TEST_CASE( dot_expr )
   BOOST_CHECK_EQUAL(result, expected);
 }
 
+BOOST_AUTO_TEST_CASE( statistics )
+{
+  const unsigned int flags = TiledArray::stat_sum | TiledArray::stat_squared_norm |
+      TiledArray::stat_min | TiledArray::stat_max | TiledArray::stat_abs_max;
+  TiledArray::Statistics<int> stats;
+  BOOST_REQUIRE_NO_THROW(stats = a("a,b,c").statistics(flags).get());
+
+  // Compute the expected values with one reduction per statistic
+  BOOST_CHECK_EQUAL(stats.sum(), a("a,b,c").sum().get());
+  BOOST_CHECK_EQUAL(stats.squared_norm(), a("a,b,c").squared_norm().get());
+  BOOST_CHECK_EQUAL(stats.min(), a("a,b,c").min().get());
+  BOOST_CHECK_EQUAL(stats.max(), a("a,b,c").max().get());
+  BOOST_CHECK_EQUAL(stats.abs_max(), a("a,b,c").abs_max().get());
+
+  // Statistics that were not selected are not available
+  BOOST_CHECK_THROW(stats.abs_min(), TiledArray::Exception);
+
+  // The statistics of a fused expression, with the dot product
+  BOOST_REQUIRE_NO_THROW(stats = (a("a,b,c") - b("a,b,c")).statistics(b("a,b,c"),
+      TiledArray::stat_squared_norm).get());
+  BOOST_CHECK_EQUAL(stats.squared_norm(),
+      (a("a,b,c") - b("a,b,c")).squared_norm().get());
+  BOOST_CHECK_EQUAL(stats.dot(), (a("a,b,c") - b("a,b,c")).dot(b("a,b,c")).get());
+}
+
 BOOST_AUTO_TEST_CASE( dot_contr )
 {
   int result = 0;
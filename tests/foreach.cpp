@@ -341,4 +341,57 @@ BOOST_AUTO_TEST_CASE( foreach_binary_sparse_inplace )
 
 }
 
+BOOST_AUTO_TEST_CASE( foreach_grained )
+{
+  // Chunks hold a few tiles, or a single tile when the grain is 1
+  for(std::size_t grain : { 1ul, 500ul }) {
+    TArrayI result = foreach(a, [] (TensorI& result, const TensorI& arg) {
+      result = arg.scale(2);
+    }, grain);
+
+    TArrayI result_inplace = a.clone();
+    foreach_inplace(result_inplace, b, [] (TensorI& l, const TensorI& r) {
+      l.add_to(r);
+    }, true, grain);
+
+    for(auto index : * result.pmap()) {
+      TensorI tilea = a.find(index).get();
+      TensorI tileb = b.find(index).get();
+      TensorI tile = result.find(index).get();
+      TensorI tile_inplace = result_inplace.find(index).get();
+      for(std::size_t i = 0; i < tile.size(); ++i) {
+        BOOST_CHECK_EQUAL(tile[i], 2 * tilea[i]);
+        BOOST_CHECK_EQUAL(tile_inplace[i], tilea[i] + tileb[i]);
+      }
+    }
+  }
+}
+
+
+BOOST_AUTO_TEST_CASE( foreach_sparse_grained )
+{
+  auto op = [] (TensorI& result, const TensorI& l, const TensorI& r) -> float {
+    result = (l.empty() ? r.clone() : (r.empty() ? l.clone() : l.add(r)));
+    return result.norm();
+  };
+
+  TSpArrayI reference = foreach(c, d, op, ShapeReductionMethod::Union);
+
+  for(std::size_t grain : { 1ul, 500ul }) {
+    TSpArrayI result = foreach(c, d, op, ShapeReductionMethod::Union, grain);
+
+    for(auto index : * result.pmap()) {
+      BOOST_CHECK_EQUAL(result.is_zero(index), reference.is_zero(index));
+      if(result.is_zero(index))
+        continue;
+
+      TensorI tile0 = reference.find(index).get();
+      TensorI tile = result.find(index).get();
+      for(std::size_t i = 0; i < tile.size(); ++i) {
+        BOOST_CHECK_EQUAL(tile[i], tile0[i]);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
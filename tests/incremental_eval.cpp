@@ -0,0 +1,122 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  incremental_eval.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct IncrementalEvalFixture {
+  IncrementalEvalFixture() :
+    world(*GlobalFixture::world),
+    tr{0, 2, 5, 6}, trange{tr, tr}
+  {
+    v = TSpArrayD(world, trange);
+    fill(v, [] (std::size_t i, std::size_t j) { return 1.0 / double(1ul + i + j); });
+  }
+
+  // Set the local tiles of an array with op
+  template <typename Op>
+  static void fill(TSpArrayD& array, const Op& op) {
+    for(const auto t : *array.pmap()) {
+      TensorD tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = op(index[0], index[1]);
+      array.set(t, tile);
+    }
+  }
+
+  // Element (i,j) of an array
+  static double element(const TSpArrayD& array, const std::size_t i, const std::size_t j) {
+    const std::vector<std::size_t> index = { i, j };
+    const auto t = array.trange().element_to_tile(index);
+    if(array.is_zero(t))
+      return 0.0;
+    return array.find(t).get()[index];
+  }
+
+  World& world;
+  TiledRange1 tr;
+  TiledRange trange;
+  TSpArrayD v;
+}; // IncrementalEvalFixture
+
+BOOST_FIXTURE_TEST_SUITE( incremental_eval_suite, IncrementalEvalFixture )
+
+BOOST_AUTO_TEST_CASE( delta_tiles )
+{
+  TSpArrayD x(world, trange), y(world, trange);
+  fill(x, [] (std::size_t i, std::size_t j) { return double(i + j); });
+  // Change tile (0,0) by 1e-9 and tile (1,2) by 1
+  fill(y, [] (std::size_t i, std::size_t j) {
+    return double(i + j) + (i < 2ul && j < 2ul ? 1.0e-9 : 0.0)
+        + ((i >= 2ul && i < 5ul && j == 5ul) ? 1.0 : 0.0);
+  });
+
+  TSpArrayD d = delta(y, x, 1.0e-6);
+  for(std::size_t t = 0ul; t < d.size(); ++t)
+    BOOST_CHECK_EQUAL(d.is_zero(t), t != 5ul);
+  if(d.is_local(5ul)) {
+    const TensorD tile = d.find(5ul).get();
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      BOOST_CHECK_CLOSE(tile[i], 1.0, 1.0e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( linear_op )
+{
+  IncrementalEval<TSpArrayD> eval(1.0e-6);
+  auto op = [this] (const TSpArrayD& x, TSpArrayD& y) { y("i,j") = v("i,k") * x("k,j"); };
+
+  TSpArrayD x0(world, trange), x1(world, trange);
+  fill(x0, [] (std::size_t i, std::size_t j) { return double(i) - double(j); });
+  // Change the elements of tile (2,1) by 1 and the others by 1e-9
+  fill(x1, [] (std::size_t i, std::size_t j) {
+    return double(i) - double(j) + (i == 5ul && j >= 2ul && j < 5ul ? 1.0 : 1.0e-9);
+  });
+
+  TSpArrayD r0 = eval(x0, op);
+  BOOST_CHECK_EQUAL(eval.changed_tiles(), 9ul);
+
+  TSpArrayD r1 = eval(x1, op);
+  BOOST_CHECK_EQUAL(eval.changed_tiles(), 1ul);
+
+  // The result is the operation applied to x1 within the tolerance
+  TSpArrayD ref;
+  op(x1, ref);
+  for(std::size_t i = 0ul; i < 6ul; ++i)
+    for(std::size_t j = 0ul; j < 6ul; ++j)
+      BOOST_CHECK_SMALL(element(r1, i, j) - element(ref, i, j), 1.0e-7);
+
+  // An unchanged argument reuses the last result
+  TSpArrayD r2 = eval(x1, op);
+  BOOST_CHECK_EQUAL(eval.changed_tiles(), 0ul);
+  BOOST_CHECK_EQUAL(r2.id(), r1.id());
+
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  index_list.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/expressions/index_list.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "range_fixture.h"
+
+using namespace TiledArray;
+using TiledArray::expressions::VariableList;
+using TiledArray::expressions::IndexPermutation;
+using TiledArray::expressions::IndexContraction;
+
+struct IndexListFixture {
+  typedef IndexList<'i','j','k'> ijk;
+  typedef IndexList<'k','i','j'> kij;
+  typedef IndexList<'i','k'> ik;
+  typedef IndexList<'k','j'> kj;
+  typedef IndexList<'i','j'> ij;
+}; // IndexListFixture
+
+BOOST_FIXTURE_TEST_SUITE( index_list_suite, IndexListFixture )
+
+BOOST_AUTO_TEST_CASE( variable_list )
+{
+  static_assert(ijk::rank == 3u, "IndexList rank is incorrect");
+  BOOST_CHECK_EQUAL(ijk::string(), "i,j,k");
+  BOOST_CHECK_EQUAL(ijk::variable_list(), VariableList("i,j,k"));
+
+  // The variable list is constructed once
+  BOOST_CHECK_EQUAL(& ijk::variable_list(), & ijk::variable_list());
+}
+
+BOOST_AUTO_TEST_CASE( permutation )
+{
+  static_assert(IndexPermutation<ijk, ijk>::is_identity(),
+      "IndexPermutation should be the identity");
+  static_assert(! IndexPermutation<ijk, kij>::is_identity(),
+      "IndexPermutation should not be the identity");
+
+  BOOST_CHECK_EQUAL((IndexPermutation<ijk, kij>::permutation()),
+      ijk::variable_list().permutation(kij::variable_list()));
+  BOOST_CHECK_EQUAL((IndexPermutation<kij, ijk>::permutation()),
+      kij::variable_list().permutation(ijk::variable_list()));
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  typedef IndexContraction<ij, ik, kj> contraction;
+  static_assert(contraction::contract_rank == 1u,
+      "IndexContraction contract rank is incorrect");
+
+  const math::GemmHelper gemm_helper = contraction::gemm_helper();
+  BOOST_CHECK_EQUAL(gemm_helper.result_rank(), 2u);
+  BOOST_CHECK_EQUAL(gemm_helper.left_rank(), 2u);
+  BOOST_CHECK_EQUAL(gemm_helper.right_rank(), 2u);
+  BOOST_CHECK_EQUAL(gemm_helper.num_contract_ranks(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE( expressions )
+{
+  World& world = *GlobalFixture::world;
+  TiledRange1 tr1{0, 3, 8};
+  TArrayI a(world, TiledRange({tr1, tr1}));
+  TArrayI b(world, TiledRange({tr1, tr1}));
+  a.fill(1);
+  b.fill(2);
+
+  TArrayI c, d;
+  BOOST_REQUIRE_NO_THROW(c(ij()) = a(ij()) + b(IndexList<'j','i'>()));
+  BOOST_REQUIRE_NO_THROW(d("i,j") = a("i,j") + b("j,i"));
+  for(const auto index : *c.pmap()) {
+    const TensorI c_tile = c.find(index).get();
+    const TensorI d_tile = d.find(index).get();
+    for(std::size_t i = 0ul; i < c_tile.size(); ++i)
+      BOOST_CHECK_EQUAL(c_tile[i], d_tile[i]);
+  }
+
+  BOOST_REQUIRE_NO_THROW(c(ij()) = a(ik()) * b(kj()));
+  BOOST_REQUIRE_NO_THROW(d("i,j") = a("i,k") * b("k,j"));
+  for(const auto index : *c.pmap()) {
+    const TensorI c_tile = c.find(index).get();
+    const TensorI d_tile = d.find(index).get();
+    for(std::size_t i = 0ul; i < c_tile.size(); ++i)
+      BOOST_CHECK_EQUAL(c_tile[i], d_tile[i]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,159 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  krylov.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct KrylovFixture {
+  typedef Eigen::MatrixXd matrix_type;
+  typedef Eigen::VectorXd vector_type;
+
+  // Matrix-vector product as a TiledArray expression
+  struct Operator {
+    TArrayD A;
+    void operator()(const TArrayD& x, TArrayD& result) const {
+      result("i") = A("i,j") * x("j");
+    }
+  }; // struct Operator
+
+  // Products of a matrix with a block of vectors, evaluated together
+  struct BlockOperator {
+    TArrayD A;
+    unsigned int calls;
+    void operator()(const std::vector<TArrayD>& x, std::vector<TArrayD>& result) {
+      ++calls;
+      result = multi_contract(A, "i,j", x, "j", "i");
+    }
+  }; // struct BlockOperator
+
+  KrylovFixture() :
+    world(*GlobalFixture::world),
+    tr1{0, 3, 7, 8, 13},
+    n(13ul)
+  { }
+
+  // A diagonally dominant matrix; symmetric when asym is zero
+  matrix_type make_matrix(const double asym) const {
+    matrix_type m(n, n);
+    for(std::size_t i = 0ul; i < n; ++i)
+      for(std::size_t j = 0ul; j < n; ++j)
+        m(i, j) = 1.0 / double(i + j + 1ul) + (i < j ? asym : 0.0);
+    m.diagonal().array() += double(n);
+    return m;
+  }
+
+  // Solve with solver and check the solution against Eigen
+  template <typename Solver>
+  void check_solve(Solver& solver, const matrix_type& m) const {
+    vector_type b(n);
+    for(std::size_t i = 0ul; i < n; ++i)
+      b[i] = double(i % 4ul) - 1.5;
+    const vector_type diag_inv = m.diagonal().cwiseInverse();
+
+    Operator op{ eigen_to_array<TArrayD>(world, TiledRange({tr1, tr1}), m) };
+    const TiledRange trange({tr1});
+    TArrayD b_array = eigen_to_array<TArrayD>(world, trange, b);
+    TArrayD precond = eigen_to_array<TArrayD>(world, trange, diag_inv);
+    TArrayD x = clone(b_array);
+
+    BOOST_REQUIRE_NO_THROW(solver(op, b_array, x, precond, 1.0e-11));
+    const vector_type x_eigen = array_to_eigen_block(x, 0ul, n);
+    const vector_type x_ref = m.lu().solve(b);
+    BOOST_CHECK((x_eigen - x_ref).norm() < 1.0e-8 * x_ref.norm());
+  }
+
+  World& world;
+  TiledRange1 tr1;
+  std::size_t n;
+}; // KrylovFixture
+
+BOOST_FIXTURE_TEST_SUITE( krylov_suite, KrylovFixture )
+
+BOOST_AUTO_TEST_CASE( pipelined_conjugate_gradient )
+{
+  PipelinedConjugateGradientSolver<TArrayD, Operator> solver;
+  check_solve(solver, make_matrix(0.0));
+}
+
+BOOST_AUTO_TEST_CASE( gmres )
+{
+  GMRESSolver<TArrayD, Operator> solver;
+  check_solve(solver, make_matrix(0.25));
+}
+
+BOOST_AUTO_TEST_CASE( gmres_restart )
+{
+  // A small subspace that forces restarts
+  GMRESSolver<TArrayD, Operator> solver(4u, 200u);
+  check_solve(solver, make_matrix(0.25));
+}
+
+BOOST_AUTO_TEST_CASE( davidson )
+{
+  const matrix_type m = make_matrix(0.0);
+  const vector_type diag = m.diagonal();
+  const TiledRange trange({tr1});
+  BlockOperator op{ eigen_to_array<TArrayD>(world, TiledRange({tr1, tr1}), m), 0u };
+
+  // Divide the residual by the shifted diagonal
+  const auto precond = [&] (const double lambda, TArrayD& r) {
+    vector_type r_eigen = array_to_eigen_block(r, 0ul, n);
+    for(std::size_t i = 0ul; i < n; ++i)
+      r_eigen[i] /= (std::abs(diag[i] - lambda) > 1.0e-4 ? diag[i] - lambda : 1.0e-4);
+    r = eigen_to_array<TArrayD>(world, trange, r_eigen);
+  };
+
+  const Eigen::SelfAdjointEigenSolver<matrix_type> ref(m);
+  for(const unsigned int max_subspace : { 0u, 4u }) {
+    std::vector<TArrayD> x;
+    for(std::size_t k = 0ul; k < 2ul; ++k) {
+      vector_type guess = vector_type::Zero(n);
+      guess[k] = 1.0;
+      guess[k + 2ul] = 0.1;
+      x.push_back(eigen_to_array<TArrayD>(world, trange, guess));
+    }
+
+    // A small subspace forces collapses
+    DavidsonSolver<TArrayD, BlockOperator> solver(max_subspace, 200u);
+    std::vector<double> values;
+    op.calls = 0u;
+    BOOST_REQUIRE_NO_THROW(values = solver(op, precond, x, 1.0e-10));
+    BOOST_REQUIRE_EQUAL(values.size(), 2ul);
+    BOOST_CHECK(op.calls > 0u);
+
+    for(std::size_t k = 0ul; k < 2ul; ++k) {
+      BOOST_CHECK_CLOSE(values[k], ref.eigenvalues()[k], 1.0e-8);
+      const vector_type x_eigen = array_to_eigen_block(x[k], 0ul, n);
+      BOOST_CHECK_CLOSE(x_eigen.norm(), 1.0, 1.0e-8);
+      BOOST_CHECK((m * x_eigen - values[k] * x_eigen).norm() < 1.0e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/layered_pmap.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct LayeredCyclicPmapFixture {
+
+  LayeredCyclicPmapFixture() { }
+
+};
+
+
+// =============================================================================
+// LayeredCyclicPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( layered_pmap_suite, LayeredCyclicPmapFixture )
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t size = GlobalFixture::world->size();
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    const std::size_t stride = size / layers;
+    for(std::size_t x = 1ul; x < 10ul; ++x) {
+      for(std::size_t y = 1ul; y < 10ul; ++y) {
+        const std::size_t p_rows = std::min(x, stride);
+        const std::size_t p_cols = stride / p_rows;
+
+        TiledArray::detail::LayeredCyclicPmap row_pmap(* GlobalFixture::world,
+            x, y, p_rows, p_cols, layers, stride, true);
+        TiledArray::detail::LayeredCyclicPmap col_pmap(* GlobalFixture::world,
+            x, y, p_rows, p_cols, layers, stride, false);
+
+        for(std::size_t i = 0ul; i < x; ++i) {
+          for(std::size_t j = 0ul; j < y; ++j) {
+            const std::size_t proc = (i % p_rows) * p_cols + (j % p_cols);
+            BOOST_CHECK_EQUAL(row_pmap.owner(i * y + j), (i % layers) * stride + proc);
+            BOOST_CHECK_EQUAL(col_pmap.owner(i * y + j), (j % layers) * stride + proc);
+          }
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_size )
+{
+  const std::size_t size = GlobalFixture::world->size();
+
+  for(std::size_t layers = 1ul; layers <= size; ++layers) {
+    const std::size_t stride = size / layers;
+    for(std::size_t x = 1ul; x < 10ul; ++x) {
+      for(std::size_t y = 1ul; y < 10ul; ++y) {
+        const std::size_t p_rows = std::min(x, stride);
+        const std::size_t p_cols = stride / p_rows;
+
+        TiledArray::detail::LayeredCyclicPmap pmap(* GlobalFixture::world,
+            x, y, p_rows, p_cols, layers, stride, (x < y));
+
+        // Check that all local elements map to this rank
+        for(detail::LayeredCyclicPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it)
+          BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+
+        // Check that the total number of elements in all local groups is
+        // equal to the number of tiles in the map.
+        std::size_t total_size = pmap.local_size();
+        GlobalFixture::world->gop.sum(total_size);
+        BOOST_CHECK_EQUAL(total_size, x * y);
+        BOOST_CHECK(pmap.empty() == (pmap.local_size() == 0ul));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  linalg.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct LinalgFixture {
+  typedef Eigen::MatrixXd matrix_type;
+
+  LinalgFixture() :
+    world(*GlobalFixture::world),
+    tr1{0, 3, 7, 8, 13},
+    trange({tr1, tr1})
+  { }
+
+  // A symmetric positive definite matrix
+  matrix_type make_spd() const {
+    const std::size_t n = tr1.elements_range().second;
+    matrix_type m(n, n);
+    for(std::size_t i = 0ul; i < n; ++i)
+      for(std::size_t j = 0ul; j < n; ++j)
+        m(i, j) = 1.0 / double(i + j + 1ul);
+    return m + matrix_type::Identity(n, n) * double(n);
+  }
+
+  // Gather a whole array on this process
+  static matrix_type gather(const TArrayD& array) {
+    const auto* const extent = array.trange().elements_range().extent_data();
+    return array_to_eigen_block(array, 0ul, extent[0], 0ul, extent[1]);
+  }
+
+  World& world;
+  TiledRange1 tr1;
+  TiledRange trange;
+}; // LinalgFixture
+
+BOOST_FIXTURE_TEST_SUITE( linalg_suite, LinalgFixture )
+
+BOOST_AUTO_TEST_CASE( cholesky_factor )
+{
+  const matrix_type m = make_spd();
+  TArrayD a = eigen_to_array<TArrayD>(world, trange, m);
+
+  TArrayD l;
+  BOOST_REQUIRE_NO_THROW(l = cholesky(a));
+  BOOST_CHECK_EQUAL(l.trange(), trange);
+
+  const matrix_type l_matrix = gather(l);
+  BOOST_CHECK(l_matrix.isLowerTriangular());
+  BOOST_CHECK((l_matrix * l_matrix.transpose()).isApprox(m, 1.0e-12));
+}
+
+BOOST_AUTO_TEST_CASE( hermitian_eigensolve )
+{
+  const matrix_type m = make_spd();
+  TArrayD a = eigen_to_array<TArrayD>(world, trange, m);
+
+  std::vector<double> values;
+  TArrayD vectors;
+  BOOST_REQUIRE_NO_THROW(std::tie(values, vectors) = heig(a));
+  BOOST_CHECK_EQUAL(values.size(), m.rows());
+  BOOST_CHECK(std::is_sorted(values.begin(), values.end()));
+
+  const matrix_type x = gather(vectors);
+  const Eigen::Map<const Eigen::VectorXd> lambda(values.data(), values.size());
+  BOOST_CHECK((m * x).isApprox(x * lambda.asDiagonal(), 1.0e-10));
+  BOOST_CHECK((x.transpose() * x).isIdentity(1.0e-10));
+}
+
+BOOST_AUTO_TEST_CASE( generalized_eigensolve )
+{
+  const matrix_type m = make_spd();
+  matrix_type s = matrix_type::Identity(m.rows(), m.cols());
+  s.diagonal().setLinSpaced(1.0, 2.0);
+  TArrayD a = eigen_to_array<TArrayD>(world, trange, m);
+  TArrayD b = eigen_to_array<TArrayD>(world, trange, s);
+
+  std::vector<double> values;
+  TArrayD vectors;
+  BOOST_REQUIRE_NO_THROW(std::tie(values, vectors) = heig(a, b));
+
+  const matrix_type x = gather(vectors);
+  const Eigen::Map<const Eigen::VectorXd> lambda(values.data(), values.size());
+  BOOST_CHECK((m * x).isApprox(s * x * lambda.asDiagonal(), 1.0e-10));
+  BOOST_CHECK((x.transpose() * s * x).isIdentity(1.0e-10));
+}
+
+BOOST_AUTO_TEST_CASE( singular_value_decomposition )
+{
+  const TiledRange rect_trange({ tr1, TiledRange1{0, 2, 5} });
+  matrix_type m(13, 5);
+  for(std::size_t i = 0ul; i < 13ul; ++i)
+    for(std::size_t j = 0ul; j < 5ul; ++j)
+      m(i, j) = double(i * 5ul + j) / double(i + j + 1ul);
+  TArrayD a = eigen_to_array<TArrayD>(world, rect_trange, m);
+
+  std::vector<double> sigma;
+  TArrayD u, vt;
+  BOOST_REQUIRE_NO_THROW(std::tie(sigma, u, vt) = svd(a));
+  BOOST_CHECK_EQUAL(sigma.size(), 5ul);
+  BOOST_CHECK_EQUAL(u.trange(), TiledRange({ tr1, rect_trange.data()[1] }));
+  BOOST_CHECK_EQUAL(vt.trange(), TiledRange({ rect_trange.data()[1], rect_trange.data()[1] }));
+
+  const Eigen::Map<const Eigen::VectorXd> s(sigma.data(), sigma.size());
+  BOOST_CHECK((gather(u) * s.asDiagonal() * gather(vt)).isApprox(m, 1.0e-10));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  masked_eval.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct MaskedEvalFixture {
+  typedef TSpArrayD::shape_type shape_type;
+
+  MaskedEvalFixture() :
+    world(*GlobalFixture::world),
+    tr{0, 2, 5, 6, 9}, trange{tr, tr}
+  {
+    a = TSpArrayD(world, trange);
+    b = TSpArrayD(world, trange);
+    fill(a, [] (std::size_t i, std::size_t j) { return 1.0 / double(1ul + i + 2ul * j); });
+    fill(b, [] (std::size_t i, std::size_t j) { return double(i) - 0.5 * double(j); });
+
+    // The diagonal tiles
+    Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < 4ul; ++i)
+      norms(i, i) = 1.0f;
+    diagonal = shape_type(norms, trange);
+  }
+
+  // Set the local tiles of an array with op
+  template <typename Op>
+  static void fill(TSpArrayD& array, const Op& op) {
+    for(const auto t : *array.pmap()) {
+      TensorD tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = op(index[0], index[1]);
+      array.set(t, tile);
+    }
+  }
+
+  // Check that array has the diagonal tiles of ref
+  void check(const TSpArrayD& array, const TSpArrayD& ref) const {
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      BOOST_CHECK_EQUAL(array.is_zero(t), diagonal.is_zero(t));
+      if(array.is_zero(t) || ! array.is_local(t))
+        continue;
+      const TensorD tile = array.find(t).get();
+      const TensorD ref_tile = ref.find(t).get();
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_CLOSE(tile[i], ref_tile[i], 1.0e-8);
+    }
+  }
+
+  World& world;
+  TiledRange1 tr;
+  TiledRange trange;
+  TSpArrayD a, b;
+  shape_type diagonal;
+}; // MaskedEvalFixture
+
+BOOST_FIXTURE_TEST_SUITE( masked_eval_suite, MaskedEvalFixture )
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  TSpArrayD c, ref;
+  c("i,j") = (a("i,k") * b("k,j")).set_shape(diagonal);
+  ref("i,j") = a("i,k") * b("k,j");
+  check(c, ref);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( permuted_contraction )
+{
+  TSpArrayD c, ref;
+  c("j,i") = (a("i,k") * b("k,j")).set_shape(diagonal);
+  ref("j,i") = a("i,k") * b("k,j");
+  check(c, ref);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( nested )
+{
+  // The mask is propagated through the sum and the scaling to the contraction
+  TSpArrayD c, ref;
+  c("i,j") = (2.0 * (a("i,k") * b("k,j")) + a("j,i")).set_shape(diagonal);
+  ref("i,j") = 2.0 * (a("i,k") * b("k,j")) + a("j,i");
+  check(c, ref);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( arg_masks )
+{
+  // Row 0 and column 2 of the result are requested
+  Tensor<float> norms(trange.tiles_range(), 0.0f);
+  norms(0, 2) = 1.0f;
+  const shape_type result(norms, trange);
+  const auto masks = expressions::contraction_arg_masks(result, trange, trange, 1u);
+  for(std::size_t i = 0ul; i < 4ul; ++i) {
+    for(std::size_t j = 0ul; j < 4ul; ++j) {
+      BOOST_CHECK_EQUAL(masks.first.is_zero(i * 4ul + j), i != 0ul);
+      BOOST_CHECK_EQUAL(masks.second.is_zero(i * 4ul + j), j != 2ul);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
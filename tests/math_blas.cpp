@@ -24,6 +24,7 @@
  */
 
 #include "TiledArray/math/blas.h"
+#include "TiledArray/math/parallel_gemm.h"
 #include "tiledarray.h"
 #include "unit_test_config.h"
 
@@ -350,4 +351,119 @@ BOOST_AUTO_TEST_CASE_TEMPLATE( complex_gemm_ld , T, floating_point_types )
   delete [] c;
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE( complex_herk , T, floating_point_types )
+{
+  const integer max_n = std::max(m, k);
+  std::vector<std::complex<T> > a(m * k), c(max_n * max_n);
+  rand_fill(reinterpret_cast<T*>(a.data()), 2 * m * k, 29);
+  rand_fill(reinterpret_cast<T*>(c.data()), 2 * max_n * max_n, 99);
+
+  // c = 3 * a * a^H + 2 * c and c = 3 * a^H * a + 2 * c
+  for(auto op : { madness::cblas::NoTrans, madness::cblas::ConjTrans }) {
+    const integer n = (op == madness::cblas::NoTrans ? m : k);
+    const integer kk = (op == madness::cblas::NoTrans ? k : m);
+    const auto adjoint_op = (op == madness::cblas::NoTrans ?
+        madness::cblas::ConjTrans : madness::cblas::NoTrans);
+    std::vector<std::complex<T> > expected(n * n), result(n * n);
+    std::copy(c.begin(), c.begin() + n * n, expected.begin());
+    std::copy(c.begin(), c.begin() + n * n, result.begin());
+
+    TiledArray::math::gemm(op, adjoint_op, n, n, kk, std::complex<T>(3), a.data(), k,
+        a.data(), k, std::complex<T>(2), expected.data(), n);
+    bool herk = false;
+    BOOST_REQUIRE_NO_THROW(herk = TiledArray::math::herk_product(op, adjoint_op,
+        n, n, kk, std::complex<T>(3), a.data(), k, a.data(), k,
+        std::complex<T>(2), result.data(), n));
+    BOOST_CHECK(herk);
+
+    for(std::size_t i = 0ul; i < result.size(); ++i) {
+      BOOST_CHECK_CLOSE(result[i].real(), expected[i].real(), tol);
+      BOOST_CHECK_CLOSE(result[i].imag(), expected[i].imag(), tol);
+    }
+  }
+
+  // Products that are not Hermitian are not computed
+  std::vector<std::complex<T> > result(m * m);
+  BOOST_CHECK(! TiledArray::math::herk_product(madness::cblas::NoTrans,
+      madness::cblas::Trans, m, m, k, std::complex<T>(3), a.data(), k,
+      a.data(), k, std::complex<T>(0), result.data(), m));
+  BOOST_CHECK(! TiledArray::math::herk_product(madness::cblas::NoTrans,
+      madness::cblas::ConjTrans, m, m, k, std::complex<T>(0, 3), a.data(), k,
+      a.data(), k, std::complex<T>(0), result.data(), m));
+}
+
+BOOST_AUTO_TEST_CASE( parallel_gemm )
+{
+  // The matrices are large enough to be divided into blocks
+  const integer m = 2 * TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE + 17,
+      n = TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE + 3, k = 241;
+
+  std::vector<double> a(m * k), b(k * n), c(m * n);
+  rand_fill(a.data(), a.size(), 29);
+  rand_fill(b.data(), b.size(), 47);
+  rand_fill(c.data(), c.size(), 99);
+
+  for(auto op_a : { madness::cblas::NoTrans, madness::cblas::Trans }) {
+    for(auto op_b : { madness::cblas::NoTrans, madness::cblas::Trans }) {
+      const integer lda = (op_a == madness::cblas::NoTrans ? k : m);
+      const integer ldb = (op_b == madness::cblas::NoTrans ? n : k);
+
+      std::vector<double> expected = c;
+      TiledArray::math::gemm(op_a, op_b, m, n, k, 3.0, a.data(), lda,
+          b.data(), ldb, 2.0, expected.data(), n);
+
+      std::vector<double> result = c;
+      BOOST_REQUIRE_NO_THROW(TiledArray::math::parallel_gemm(op_a, op_b, m,
+          n, k, 3.0, a.data(), lda, b.data(), ldb, 2.0, result.data(), n));
+
+      for(std::size_t i = 0ul; i < result.size(); ++i)
+        BOOST_CHECK_CLOSE(result[i], expected[i], tol);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( subtiling )
+{
+  TiledArray::math::Subtiling& settings = TiledArray::math::Subtiling::instance();
+  const integer m = 97, n = 71, k = 53;
+
+  // Small matrices are divided into subtiles when subtiling is enabled
+  BOOST_CHECK(! TiledArray::math::use_parallel_gemm(m, n, k));
+  settings.enable(16l);
+  BOOST_CHECK(settings.always());
+  BOOST_CHECK_EQUAL(settings.subtile_size(), 16l);
+#ifdef HAVE_INTEL_TBB
+  BOOST_CHECK(TiledArray::math::use_parallel_gemm(m, n, k));
+#endif // HAVE_INTEL_TBB
+  BOOST_CHECK(! TiledArray::math::use_parallel_gemm(16l, 16l, k));
+
+  std::vector<double> a(m * k), b(k * n), c(m * n);
+  rand_fill(a.data(), a.size(), 31);
+  rand_fill(b.data(), b.size(), 43);
+  rand_fill(c.data(), c.size(), 59);
+
+  for(auto op_a : { madness::cblas::NoTrans, madness::cblas::Trans }) {
+    for(auto op_b : { madness::cblas::NoTrans, madness::cblas::Trans }) {
+      const integer lda = (op_a == madness::cblas::NoTrans ? k : m);
+      const integer ldb = (op_b == madness::cblas::NoTrans ? n : k);
+
+      std::vector<double> expected = c;
+      TiledArray::math::gemm(op_a, op_b, m, n, k, 3.0, a.data(), lda,
+          b.data(), ldb, 2.0, expected.data(), n);
+
+      std::vector<double> result = c;
+      BOOST_REQUIRE_NO_THROW(TiledArray::math::parallel_gemm(op_a, op_b, m,
+          n, k, 3.0, a.data(), lda, b.data(), ldb, 2.0, result.data(), n));
+
+      for(std::size_t i = 0ul; i < result.size(); ++i)
+        BOOST_CHECK_CLOSE(result[i], expected[i], tol);
+    }
+  }
+
+  settings.disable();
+  BOOST_CHECK(! settings.always());
+  BOOST_CHECK_EQUAL(settings.subtile_size(), TILEDARRAY_PARALLEL_GEMM_BLOCK_SIZE);
+  BOOST_CHECK(! TiledArray::math::use_parallel_gemm(m, n, k));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,184 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  math_block_sparse_gemm.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/math/block_sparse_gemm.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+struct BlockSparseGemmFixture {
+
+  BlockSparseGemmFixture() :
+    m(20), n(14), k(18)
+  {
+    TiledArray::math::BlockSparseGemm::instance().set_block_size(4);
+    TiledArray::math::BlockSparseGemm::instance().set_threshold(1.0e-8);
+  }
+
+  ~BlockSparseGemmFixture() {
+    TiledArray::math::BlockSparseGemm::instance().set_block_size(
+        TILEDARRAY_BLOCK_SPARSE_GEMM_BLOCK_SIZE);
+    TiledArray::math::BlockSparseGemm::instance().set_threshold(0.0);
+  }
+
+  /// Fill a row-major matrix with random values, where every other block of
+  /// 4 rows or columns is zero
+  static void block_fill(std::vector<double>& x, const integer rows,
+      const integer cols, const int seed)
+  {
+    GlobalFixture::world->srand(seed);
+    for(integer i = 0l; i < rows; ++i)
+      for(integer j = 0l; j < cols; ++j)
+        x[i * cols + j] = (((i / 4l) + (j / 4l)) % 2l ? 0.0 :
+            double(GlobalFixture::world->rand() % 101));
+  }
+
+  /// Compare the block-sparse gemm with the Eigen based gemm
+  void check(const madness::cblas::CBLAS_TRANSPOSE op_a,
+      const madness::cblas::CBLAS_TRANSPOSE op_b, const double beta)
+  {
+    const integer lda = (op_a == madness::cblas::NoTrans ? k : m);
+    const integer ldb = (op_b == madness::cblas::NoTrans ? n : k);
+    const integer ldc = n;
+
+    std::vector<double> a(m * k), b(k * n), c(m * n);
+    block_fill(a, (op_a == madness::cblas::NoTrans ? m : k), lda, 29);
+    block_fill(b, (op_b == madness::cblas::NoTrans ? k : n), ldb, 47);
+    block_fill(c, m, n, 99);
+    std::vector<double> expected = c;
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+    Eigen::Map<const matrix_type> A(a.data(), (op_a == madness::cblas::NoTrans ? m : k), lda);
+    Eigen::Map<const matrix_type> B(b.data(), (op_b == madness::cblas::NoTrans ? k : n), ldb);
+    Eigen::Map<matrix_type> C(expected.data(), m, n);
+    const matrix_type opA = (op_a == madness::cblas::NoTrans ? matrix_type(A) : matrix_type(A.transpose()));
+    const matrix_type opB = (op_b == madness::cblas::NoTrans ? matrix_type(B) : matrix_type(B.transpose()));
+    C = 3.0 * opA * opB + beta * C;
+
+    TiledArray::math::block_sparse_gemm(op_a, op_b, m, n, k, 3.0, a.data(), lda,
+        b.data(), ldb, beta, c.data(), ldc);
+
+    for(std::size_t i = 0ul; i < c.size(); ++i)
+      BOOST_CHECK_CLOSE_FRACTION(std::abs(c[i] - expected[i]) + 1.0, 1.0, tol);
+  }
+
+  integer m, n, k;
+  static const double tol;
+
+}; // BlockSparseGemmFixture
+
+const double BlockSparseGemmFixture::tol = 1.0e-12;
+
+BOOST_FIXTURE_TEST_SUITE( block_sparse_gemm_suite, BlockSparseGemmFixture )
+
+BOOST_AUTO_TEST_CASE( enable )
+{
+  BOOST_CHECK(TiledArray::math::use_block_sparse_gemm(m, n, k));
+  BOOST_CHECK(! TiledArray::math::use_block_sparse_gemm(4, 4, 4));
+
+  TiledArray::math::BlockSparseGemm::instance().set_threshold(0.0);
+  BOOST_CHECK(! TiledArray::math::BlockSparseGemm::instance().enabled());
+  BOOST_CHECK(! TiledArray::math::use_block_sparse_gemm(m, n, k));
+}
+
+BOOST_AUTO_TEST_CASE( norms )
+{
+  std::vector<double> a(m * k);
+  block_fill(a, m, k, 29);
+
+  const std::vector<double> norms =
+      TiledArray::math::block_norms(madness::cblas::NoTrans, m, k, a.data(), k, 4);
+  const std::vector<double> norms_t =
+      TiledArray::math::block_norms(madness::cblas::Trans, k, m, a.data(), k, 4);
+  BOOST_REQUIRE_EQUAL(norms.size(), 25ul);
+  BOOST_REQUIRE_EQUAL(norms_t.size(), 25ul);
+
+  for(integer ib = 0l; ib < 5l; ++ib) {
+    for(integer jb = 0l; jb < 5l; ++jb) {
+      double norm = 0.0;
+      for(integer i = ib * 4l; i < std::min(m, ib * 4l + 4l); ++i)
+        for(integer j = jb * 4l; j < std::min(k, jb * 4l + 4l); ++j)
+          norm += a[i * k + j] * a[i * k + j];
+      norm = std::sqrt(norm);
+
+      BOOST_CHECK_CLOSE(norms[ib * 5l + jb], norm, tol);
+      BOOST_CHECK_CLOSE(norms_t[jb * 5l + ib], norm, tol);
+      if((ib + jb) % 2l)
+        BOOST_CHECK_EQUAL(norms[ib * 5l + jb], 0.0);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  const madness::cblas::CBLAS_TRANSPOSE ops[2] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+
+  for(auto op_a : ops)
+    for(auto op_b : ops)
+      for(double beta : { 0.0, 1.0, 2.0 })
+        check(op_a, op_b, beta);
+}
+
+BOOST_AUTO_TEST_CASE( screened_result )
+{
+  // With zero arguments every block product is screened, so only c is scaled
+  std::vector<double> a(m * k, 0.0), b(k * n, 0.0), c(m * n, 1.0);
+
+  TiledArray::math::block_sparse_gemm(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, m, n, k, 1.0, a.data(), k, b.data(), n, 2.0,
+      c.data(), n);
+  for(double x : c)
+    BOOST_CHECK_EQUAL(x, 2.0);
+
+  TiledArray::math::block_sparse_gemm(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, m, n, k, 1.0, a.data(), k, b.data(), n, 0.0,
+      c.data(), n);
+  for(double x : c)
+    BOOST_CHECK_EQUAL(x, 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( tensor_contraction )
+{
+  TiledArray::Range left_range(std::size_t(m), std::size_t(k)),
+      right_range(std::size_t(k), std::size_t(n));
+  TiledArray::Tensor<double> left(left_range), right(right_range);
+  std::vector<double> a(m * k), b(k * n);
+  block_fill(a, m, k, 29);
+  block_fill(b, k, n, 47);
+  std::copy(a.begin(), a.end(), left.data());
+  std::copy(b.begin(), b.end(), right.data());
+
+  TiledArray::math::GemmHelper gemm_helper(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 2u, 2u, 2u);
+  TiledArray::Tensor<double> result = left.gemm(right, 1.0, gemm_helper);
+
+  TiledArray::math::BlockSparseGemm::instance().set_threshold(0.0);
+  TiledArray::Tensor<double> reference = left.gemm(right, 1.0, gemm_helper);
+
+  for(std::size_t i = 0ul; i < result.size(); ++i)
+    BOOST_CHECK_CLOSE_FRACTION(std::abs(result[i] - reference[i]) + 1.0, 1.0, tol);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  math_gemm_backend.cpp
+ *  Oct 15, 2026
+ *
+ */
+
+#include "TiledArray/math/blas.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using TiledArray::math::GemmBackend;
+using TiledArray::math::GemmDispatcher;
+
+namespace {
+
+  int external_calls = 0;
+
+  // An external backend that counts its calls and uses BLAS
+  void external_gemm(madness::cblas::CBLAS_TRANSPOSE op_a,
+      madness::cblas::CBLAS_TRANSPOSE op_b, const integer m, const integer n,
+      const integer k, const double alpha, const double* a, const integer lda,
+      const double* b, const integer ldb, const double beta, double* c,
+      const integer ldc)
+  {
+    ++external_calls;
+    TiledArray::math::backend_gemm(GemmBackend::blas, op_a, op_b, m, n, k,
+        alpha, a, lda, b, ldb, beta, c, ldc);
+  }
+
+} // namespace
+
+struct GemmBackendFixture {
+
+  GemmBackendFixture() :
+    dispatcher(GemmDispatcher::instance()),
+    small_threshold(dispatcher.small_threshold()),
+    external_threshold(dispatcher.external_threshold())
+  {
+    dispatcher.unforce();
+    dispatcher.reset_stats();
+  }
+
+  ~GemmBackendFixture() {
+    dispatcher.set_external<double>(nullptr);
+    dispatcher.set_small_threshold(small_threshold);
+    dispatcher.set_external_threshold(external_threshold);
+    dispatcher.enable_stats(false);
+    dispatcher.unforce();
+  }
+
+  // Multiply 6x4 and 4x5 matrices with math::gemm, and compare the result
+  // with Eigen
+  void check() const {
+    const integer m = 6, n = 5, k = 4;
+    std::vector<double> a(m * k), b(k * n), c(m * n, 1.0), expected(m * n, 1.0);
+    for(std::size_t i = 0ul; i < a.size(); ++i)
+      a[i] = double(i % 7);
+    for(std::size_t i = 0ul; i < b.size(); ++i)
+      b[i] = double(i % 5) - 2.0;
+
+    TiledArray::math::gemm(madness::cblas::NoTrans, madness::cblas::NoTrans,
+        m, n, k, 2.0, a.data(), k, b.data(), n, 3.0, c.data(), n);
+
+    typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+    Eigen::Map<const matrix_type> A(a.data(), m, k);
+    Eigen::Map<const matrix_type> B(b.data(), k, n);
+    Eigen::Map<matrix_type> C(expected.data(), m, n);
+    C = 2.0 * A * B + 3.0 * C;
+    for(std::size_t i = 0ul; i < c.size(); ++i)
+      BOOST_CHECK_CLOSE(c[i] + 1.0, expected[i] + 1.0, 1.0e-10);
+  }
+
+  GemmDispatcher& dispatcher;
+  const integer small_threshold;
+  const integer external_threshold;
+}; // GemmBackendFixture
+
+BOOST_FIXTURE_TEST_SUITE( gemm_backend_suite, GemmBackendFixture )
+
+BOOST_AUTO_TEST_CASE( routing )
+{
+  dispatcher.set_small_threshold(1000l);
+  dispatcher.set_external_threshold(100000l);
+  BOOST_CHECK(dispatcher.select<double>(10, 10, 10) == GemmBackend::small);
+  BOOST_CHECK(dispatcher.select<double>(20, 20, 20) == GemmBackend::blas);
+
+  // The external backend is only used when one is registered
+  BOOST_CHECK(dispatcher.select<double>(100, 100, 100) == GemmBackend::blas);
+  dispatcher.set_external<double>(& external_gemm);
+  BOOST_CHECK(dispatcher.has_external<double>());
+  BOOST_CHECK(! dispatcher.has_external<float>());
+  BOOST_CHECK(dispatcher.select<double>(100, 100, 100) == GemmBackend::external);
+  BOOST_CHECK(dispatcher.select<float>(100, 100, 100) == GemmBackend::blas);
+
+  dispatcher.force(GemmBackend::small);
+  BOOST_CHECK(dispatcher.select<double>(100, 100, 100) == GemmBackend::small);
+}
+
+BOOST_AUTO_TEST_CASE( backends )
+{
+  dispatcher.set_external<double>(& external_gemm);
+  const int calls = external_calls;
+  for(unsigned int b = 0u; b < GemmDispatcher::num_backends; ++b) {
+    dispatcher.force(static_cast<GemmBackend>(b));
+    check();
+  }
+  BOOST_CHECK_EQUAL(external_calls, calls + 1);
+}
+
+BOOST_AUTO_TEST_CASE( stats )
+{
+  dispatcher.enable_stats();
+  dispatcher.force(GemmBackend::small);
+  check();
+  check();
+  dispatcher.force(GemmBackend::blas);
+  check();
+
+  const auto small = dispatcher.stats(GemmBackend::small);
+  BOOST_CHECK_EQUAL(small.calls, 2ul);
+  BOOST_CHECK_EQUAL(small.flops, 2.0 * 2.0 * 6.0 * 5.0 * 4.0);
+  BOOST_CHECK_GE(small.seconds, 0.0);
+  BOOST_CHECK_EQUAL(dispatcher.stats(GemmBackend::blas).calls, 1ul);
+  BOOST_CHECK_EQUAL(dispatcher.stats(GemmBackend::external).calls, 0ul);
+
+  dispatcher.reset_stats();
+  BOOST_CHECK_EQUAL(dispatcher.stats(GemmBackend::small).calls, 0ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
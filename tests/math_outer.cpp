@@ -334,4 +334,31 @@ BOOST_AUTO_TEST_CASE( outer_and_fill_small_left_right )
 
 }
 
+BOOST_AUTO_TEST_CASE( large_outer )
+{
+  // The matrix is large enough to be computed in cache blocks and parallel
+  // panels, with partial blocks on the edges
+  std::vector<int> x(2ul * TILEDARRAY_MATRIX_GRAIN_SIZE / TILEDARRAY_MATRIX_BLOCK_SIZE + 3ul);
+  std::vector<int> y(2ul * TILEDARRAY_MATRIX_BLOCK_SIZE + 5ul);
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    x[i] = int(i % 13ul);
+  for(std::size_t j = 0ul; j < y.size(); ++j)
+    y[j] = int(j % 7ul);
+
+  std::vector<int> a(x.size() * y.size(), 0), b(a.size(), 0);
+  TiledArray::math::outer_fill(x.size(), y.size(), x.data(), y.data(), a.data(),
+      &OuterFixture::subt);
+  TiledArray::math::outer(x.size(), y.size(), x.data(), y.data(), a.data(),
+      &OuterFixture::add_subt);
+  TiledArray::math::outer_fill(x.size(), y.size(), x.data(), y.data(), a.data(),
+      b.data(), &OuterFixture::add_subt);
+
+  for(std::size_t i = 0ul; i < x.size(); ++i) {
+    for(std::size_t j = 0ul; j < y.size(); ++j) {
+      BOOST_CHECK_EQUAL(a[i * y.size() + j], 2 * (x[i] - y[j]));
+      BOOST_CHECK_EQUAL(b[i * y.size() + j], 3 * (x[i] - y[j]));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
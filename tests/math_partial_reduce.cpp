@@ -151,4 +151,33 @@ BOOST_AUTO_TEST_CASE( binary_col_reduce )
   }
 }
 
+BOOST_AUTO_TEST_CASE( large_reduce )
+{
+  // The matrix is large enough to be reduced in cache blocks and parallel
+  // panels, with partial blocks on the edges
+  const std::size_t lm = 2ul * TILEDARRAY_MATRIX_GRAIN_SIZE / TILEDARRAY_MATRIX_BLOCK_SIZE + 3ul;
+  const std::size_t ln = 2ul * TILEDARRAY_MATRIX_BLOCK_SIZE + 5ul;
+  std::vector<int> la(lm * ln), lx(lm, 1), ly(ln, 2);
+  for(std::size_t i = 0ul; i < la.size(); ++i)
+    la[i] = int(i % 17ul) - 8;
+
+  std::vector<int> row_result(lm, 0), col_result(ln, 0);
+  math::row_reduce(lm, ln, la.data(), ly.data(), row_result.data(), MultSum());
+  math::col_reduce(lm, ln, la.data(), lx.data(), col_result.data(), MultSum());
+
+  for(std::size_t i = 0ul; i < lm; ++i) {
+    int expected = 0;
+    for(std::size_t j = 0ul; j < ln; ++j)
+      expected += la[i * ln + j] * ly[j];
+    BOOST_CHECK_EQUAL(row_result[i], expected);
+  }
+
+  for(std::size_t j = 0ul; j < ln; ++j) {
+    int expected = 0;
+    for(std::size_t i = 0ul; i < lm; ++i)
+      expected += la[i * ln + j] * lx[i];
+    BOOST_CHECK_EQUAL(col_result[j], expected);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
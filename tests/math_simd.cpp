@@ -0,0 +1,134 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  math_simd.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+#include "TiledArray/math/simd.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using TiledArray::math::SimdIsa;
+
+struct SimdFixture {
+
+  SimdFixture() :
+    isa(TiledArray::math::simd_isa()),
+    isa_list{ SimdIsa::scalar, SimdIsa::neon, SimdIsa::avx2, SimdIsa::avx512 },
+    sizes{ 1ul, 3ul, 8ul, 37ul, 131ul }
+  { }
+
+  ~SimdFixture() { TiledArray::math::simd_isa(isa); }
+
+  template <typename T>
+  static TiledArray::Tensor<T> make_tensor(const std::size_t n, const int seed) {
+    TiledArray::Tensor<T> result(TiledArray::Range(std::vector<std::size_t>{ n }));
+    GlobalFixture::world->srand(seed);
+    for(std::size_t i = 0ul; i < n; ++i)
+      result[i] = T(GlobalFixture::world->rand() % 101) / T(7);
+    return result;
+  }
+
+  template <typename T>
+  void check() {
+    const T tol = (std::is_same<T, float>::value ? T(1.0e-4) : T(1.0e-10));
+
+    for(SimdIsa x : isa_list) {
+      if(! TiledArray::math::simd_supported(x))
+        continue;
+      TiledArray::math::simd_isa(x);
+
+      for(std::size_t n : sizes) {
+        const TiledArray::Tensor<T> a = make_tensor<T>(n, 23);
+        const TiledArray::Tensor<T> b = make_tensor<T>(n, 41);
+
+        const TiledArray::Tensor<T> sum = a.add(b);
+        const TiledArray::Tensor<T> scal_sum = a.add(b, 3);
+        const TiledArray::Tensor<T> diff = a.subt(b);
+        const TiledArray::Tensor<T> scal_diff = a.subt(b, 3);
+        const TiledArray::Tensor<T> prod = a.mult(b);
+        const TiledArray::Tensor<T> scal_prod = a.mult(b, 3);
+        const TiledArray::Tensor<T> scal = a.scale(3);
+
+        TiledArray::Tensor<T> sum_to = a.clone();
+        sum_to.add_to(b);
+        TiledArray::Tensor<T> scal_sum_to = a.clone();
+        scal_sum_to.add_to(b, 3);
+        TiledArray::Tensor<T> diff_to = a.clone();
+        diff_to.subt_to(b);
+        TiledArray::Tensor<T> prod_to = a.clone();
+        prod_to.mult_to(b, 3);
+        TiledArray::Tensor<T> scal_to = a.clone();
+        scal_to.scale_to(3);
+
+        T dot = 0, norm = 0;
+        for(std::size_t i = 0ul; i < n; ++i) {
+          BOOST_CHECK_EQUAL(sum[i], a[i] + b[i]);
+          BOOST_CHECK_CLOSE(scal_sum[i], (a[i] + b[i]) * T(3), tol);
+          BOOST_CHECK_EQUAL(diff[i], a[i] - b[i]);
+          BOOST_CHECK_CLOSE(scal_diff[i], (a[i] - b[i]) * T(3), tol);
+          BOOST_CHECK_EQUAL(prod[i], a[i] * b[i]);
+          BOOST_CHECK_CLOSE(scal_prod[i], (a[i] * b[i]) * T(3), tol);
+          BOOST_CHECK_EQUAL(scal[i], a[i] * T(3));
+          BOOST_CHECK_EQUAL(sum_to[i], a[i] + b[i]);
+          BOOST_CHECK_CLOSE(scal_sum_to[i], (a[i] + b[i]) * T(3), tol);
+          BOOST_CHECK_EQUAL(diff_to[i], a[i] - b[i]);
+          BOOST_CHECK_CLOSE(prod_to[i], (a[i] * b[i]) * T(3), tol);
+          BOOST_CHECK_EQUAL(scal_to[i], a[i] * T(3));
+          dot += a[i] * b[i];
+          norm += a[i] * a[i];
+        }
+
+        BOOST_CHECK_CLOSE(a.dot(b), dot, tol);
+        BOOST_CHECK_CLOSE(a.squared_norm(), norm, tol);
+      }
+    }
+  }
+
+  const SimdIsa isa; // The original instruction set
+  const std::vector<SimdIsa> isa_list;
+  const std::vector<std::size_t> sizes;
+
+}; // SimdFixture
+
+BOOST_FIXTURE_TEST_SUITE( math_simd_suite, SimdFixture )
+
+BOOST_AUTO_TEST_CASE( isa )
+{
+  BOOST_CHECK(TiledArray::math::simd_supported(SimdIsa::scalar));
+  BOOST_CHECK(TiledArray::math::simd_supported(TiledArray::math::simd_isa()));
+
+  TiledArray::math::simd_isa(SimdIsa::scalar);
+  BOOST_CHECK(TiledArray::math::simd_isa() == SimdIsa::scalar);
+}
+
+BOOST_AUTO_TEST_CASE( double_ops )
+{
+  check<double>();
+}
+
+BOOST_AUTO_TEST_CASE( float_ops )
+{
+  check<float>();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  math_small_gemm.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+#include "TiledArray/math/small_gemm.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+struct SmallGemmFixture {
+
+  SmallGemmFixture() :
+    m(7), n(11), k(5)
+  { }
+
+  ~SmallGemmFixture() { }
+
+
+  template <typename T>
+  static void rand_fill(std::vector<T>& x, const int seed) {
+    GlobalFixture::world->srand(seed);
+    for(std::size_t i = 0ul; i < x.size(); ++i)
+      x[i] = T(GlobalFixture::world->rand() % 101, GlobalFixture::world->rand() % 101);
+  }
+
+  static void rand_fill(std::vector<double>& x, const int seed) {
+    GlobalFixture::world->srand(seed);
+    for(std::size_t i = 0ul; i < x.size(); ++i)
+      x[i] = GlobalFixture::world->rand() % 101;
+  }
+
+  /// Compute the reference result with the Eigen based gemm
+  template <typename T>
+  void check(const madness::cblas::CBLAS_TRANSPOSE op_a,
+      const madness::cblas::CBLAS_TRANSPOSE op_b, const T beta)
+  {
+    const integer lda = (op_a == madness::cblas::NoTrans ? k : m);
+    const integer ldb = (op_b == madness::cblas::NoTrans ? n : k);
+    const integer ldc = n;
+
+    std::vector<T> a(m * k), b(k * n), c(m * n);
+    rand_fill(a, 29);
+    rand_fill(b, 47);
+    rand_fill(c, 99);
+    std::vector<T> expected = c;
+
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix_type;
+    Eigen::Map<const matrix_type> A(a.data(), (op_a == madness::cblas::NoTrans ? m : k), lda);
+    Eigen::Map<const matrix_type> B(b.data(), (op_b == madness::cblas::NoTrans ? k : n), ldb);
+    Eigen::Map<matrix_type> C(expected.data(), m, n);
+    const matrix_type opA = (op_a == madness::cblas::NoTrans ? matrix_type(A) :
+        (op_a == madness::cblas::Trans ? matrix_type(A.transpose()) : matrix_type(A.adjoint())));
+    const matrix_type opB = (op_b == madness::cblas::NoTrans ? matrix_type(B) :
+        (op_b == madness::cblas::Trans ? matrix_type(B.transpose()) : matrix_type(B.adjoint())));
+    C = T(3) * opA * opB + beta * C;
+
+    TiledArray::math::small_gemm(op_a, op_b, m, n, k, T(3), a.data(), lda,
+        b.data(), ldb, beta, c.data(), ldc);
+
+    for(std::size_t i = 0ul; i < c.size(); ++i)
+      BOOST_CHECK_CLOSE_FRACTION(std::abs(c[i] - expected[i]) + 1.0, 1.0, tol);
+  }
+
+  integer m, n, k;
+  static const double tol;
+
+}; // SmallGemmFixture
+
+const double SmallGemmFixture::tol = 1.0e-12;
+
+BOOST_FIXTURE_TEST_SUITE( small_gemm_suite, SmallGemmFixture )
+
+BOOST_AUTO_TEST_CASE( threshold )
+{
+  BOOST_CHECK(TiledArray::math::use_small_gemm(16, 16, 16));
+  BOOST_CHECK(TiledArray::math::use_small_gemm(32, 32, 32));
+  BOOST_CHECK(! TiledArray::math::use_small_gemm(64, 64, 64));
+  BOOST_CHECK(! TiledArray::math::use_small_gemm(65536, 65536, 2));
+}
+
+BOOST_AUTO_TEST_CASE( real_gemm )
+{
+  const madness::cblas::CBLAS_TRANSPOSE ops[2] =
+      { madness::cblas::NoTrans, madness::cblas::Trans };
+
+  for(auto op_a : ops)
+    for(auto op_b : ops)
+      for(double beta : { 0.0, 1.0, 2.0 })
+        check(op_a, op_b, beta);
+}
+
+BOOST_AUTO_TEST_CASE( complex_gemm )
+{
+  const madness::cblas::CBLAS_TRANSPOSE ops[3] =
+      { madness::cblas::NoTrans, madness::cblas::Trans, madness::cblas::ConjTrans };
+
+  for(auto op_a : ops)
+    for(auto op_b : ops)
+      for(double beta : { 0.0, 1.0, 2.0 })
+        check(op_a, op_b, std::complex<double>(beta, 0.0));
+}
+
+BOOST_AUTO_TEST_CASE( fixed_gemm )
+{
+  // Sizes with (n, k <= TILEDARRAY_FIXED_GEMM_MAX_SIZE) and without fixed
+  // size kernels
+  const madness::cblas::CBLAS_TRANSPOSE ops[3] =
+      { madness::cblas::NoTrans, madness::cblas::Trans, madness::cblas::ConjTrans };
+  std::vector<double> a(4), b(4), c(4, 1.0);
+  BOOST_CHECK(TiledArray::math::fixed_gemm(madness::cblas::NoTrans,
+      madness::cblas::NoTrans, 2, 2, 2, 1.0, a.data(), 2, b.data(), 2, 0.0,
+      c.data(), 2));
+  BOOST_CHECK(! TiledArray::math::fixed_gemm(madness::cblas::NoTrans,
+      madness::cblas::Trans, 2, 2, 2, 1.0, a.data(), 2, b.data(), 2, 0.0,
+      c.data(), 2));
+
+  m = 3;
+  for(n = 1; n <= TILEDARRAY_FIXED_GEMM_MAX_SIZE + 1; ++n) {
+    for(k = 1; k <= TILEDARRAY_FIXED_GEMM_MAX_SIZE + 1; ++k) {
+      for(auto op_a : ops) {
+        for(double beta : { 0.0, 2.0 }) {
+          check(op_a, madness::cblas::NoTrans, beta);
+          check(op_a, madness::cblas::NoTrans, std::complex<double>(beta, 0.0));
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
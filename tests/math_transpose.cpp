@@ -154,4 +154,59 @@ BOOST_AUTO_TEST_CASE( binary )
   delete [] b;
   delete [] c;
 }
+BOOST_AUTO_TEST_CASE( simd )
+{
+  const std::size_t m = 37;
+  const std::size_t n = 45;
+  const std::size_t mn = m * n;
+
+  std::vector<double> a(mn), b(mn);
+  std::vector<std::complex<float> > c(mn), d(mn);
+
+  GlobalFixture::world->srand(1764);
+  for(std::size_t i = 0ul; i < mn; ++i) {
+    a[i] = GlobalFixture::world->rand() % 42;
+    c[i] = std::complex<float>(GlobalFixture::world->rand() % 42,
+        GlobalFixture::world->rand() % 42);
+  }
+
+  for(std::size_t x = 1ul; x < m; x += 5ul) {
+    for(std::size_t y = 1ul; y < n; y += 3ul) {
+      // Copy
+      std::fill(b.begin(), b.end(), 1.0);
+      TiledArray::math::transpose(TiledArray::math::CopyVectorOp<double>(),
+          TiledArray::math::InitOutputOp<double>(), x, y, m, b.data(), n,
+          a.data());
+
+      // Scaled copy
+      std::fill(d.begin(), d.end(), std::complex<float>(0.0f, 0.0f));
+      TiledArray::math::transpose(
+          TiledArray::math::ScalVectorOp<std::complex<float>, float>{ 3.0f },
+          TiledArray::math::InitOutputOp<std::complex<float> >(), x, y, m,
+          d.data(), n, c.data());
+
+      for(std::size_t i = 0ul; i < m; ++i) {
+        for(std::size_t j = 0ul; j < n; ++j) {
+          if((i < x) && (j < y)) {
+            BOOST_CHECK_EQUAL(b[j * m + i], a[i * n + j]);
+            BOOST_CHECK_EQUAL(d[j * m + i], c[i * n + j] * 3.0f);
+          } else {
+            BOOST_CHECK_EQUAL(b[j * m + i], 1.0);
+            BOOST_CHECK_EQUAL(d[j * m + i], std::complex<float>(0.0f, 0.0f));
+          }
+        }
+      }
+
+      // Accumulate
+      TiledArray::math::transpose(TiledArray::math::ScalVectorOp<double, int>{ 2 },
+          TiledArray::math::AddToOutputOp<double>(), x, y, m, b.data(), n,
+          a.data());
+
+      for(std::size_t i = 0ul; i < x; ++i)
+        for(std::size_t j = 0ul; j < y; ++j)
+          BOOST_CHECK_EQUAL(b[j * m + i], 3.0 * a[i * n + j]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
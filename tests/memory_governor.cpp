@@ -0,0 +1,116 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  memory_governor.cpp
+ *  Oct 15, 2026
+ *
+ */
+#include "TiledArray/memory_governor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct MemoryGovernorFixture {
+
+  MemoryGovernorFixture() : governor(detail::MemoryGovernor::instance()) { }
+
+  ~MemoryGovernorFixture() { governor.set_limit(0ul); }
+
+  detail::MemoryGovernor& governor;
+}; // MemoryGovernorFixture
+
+BOOST_FIXTURE_TEST_SUITE( memory_governor_suite, MemoryGovernorFixture )
+
+BOOST_AUTO_TEST_CASE( no_limit )
+{
+  governor.set_limit(0ul);
+  BOOST_CHECK(! governor.enabled());
+
+  // Tasks are launched immediately and are not governed
+  std::size_t reserved = 1ul;
+  governor.submit(100ul, [&reserved] (const std::size_t r) { reserved = r; });
+  BOOST_CHECK_EQUAL(reserved, 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( defer )
+{
+  const std::size_t live = MemoryTracker::instance().total().live;
+  governor.set_limit(live + 100ul);
+  BOOST_CHECK(governor.enabled());
+  const std::size_t deferrals = governor.deferrals();
+
+  // The first task always runs, the second does not fit
+  std::vector<std::size_t> launched;
+  governor.submit(60ul, [&launched] (const std::size_t r) { launched.push_back(r); });
+  governor.submit(60ul, [&launched] (const std::size_t r) { launched.push_back(r); });
+  BOOST_REQUIRE_EQUAL(launched.size(), 1ul);
+  BOOST_CHECK_EQUAL(launched[0], 60ul);
+  BOOST_CHECK_EQUAL(governor.deferrals(), deferrals + 1ul);
+
+  // The second task is launched when the first is done
+  governor.release(launched[0]);
+  BOOST_REQUIRE_EQUAL(launched.size(), 2ul);
+  governor.release(launched[1]);
+}
+
+BOOST_AUTO_TEST_CASE( remove_limit )
+{
+  const std::size_t live = MemoryTracker::instance().total().live;
+  governor.set_limit(live + 100ul);
+
+  std::vector<std::size_t> launched;
+  governor.submit(200ul, [&launched] (const std::size_t r) { launched.push_back(r); });
+  governor.submit(200ul, [&launched] (const std::size_t r) { launched.push_back(r); });
+  BOOST_REQUIRE_EQUAL(launched.size(), 1ul);
+
+  // Deferred tasks are launched when the limit is removed
+  governor.set_limit(0ul);
+  BOOST_REQUIRE_EQUAL(launched.size(), 2ul);
+  for(const auto r : launched)
+    governor.release(r);
+}
+
+BOOST_AUTO_TEST_CASE( expression )
+{
+  World& world = *GlobalFixture::world;
+  TiledRange1 tr1{0, 3, 8, 12};
+  TArrayD a(world, TiledRange({tr1, tr1}));
+  TArrayD b(world, TiledRange({tr1, tr1}));
+
+  // Evaluate with at most one tile task at a time
+  set_max_memory(1ul);
+  BOOST_CHECK_EQUAL(max_memory(), 1ul);
+  a.init_tiles([] (const Range& range) { return TensorD(range, 1.0); });
+  b.fill(2.0);
+  TArrayD c;
+  BOOST_REQUIRE_NO_THROW(c("i,j") = 2.0 * (a("i,j") + b("j,i")));
+  world.gop.fence();
+  set_max_memory(0ul);
+
+  for(const auto index : *c.pmap()) {
+    const TensorD tile = c.find(index).get();
+    for(const auto& x : tile)
+      BOOST_CHECK_EQUAL(x, 6.0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  memory_tracker.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/memory_tracker.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct MemoryTrackerFixture {
+
+  MemoryTrackerFixture() : tracker(MemoryTracker::instance()) { }
+
+  MemoryTracker& tracker;
+}; // MemoryTrackerFixture
+
+BOOST_FIXTURE_TEST_SUITE( memory_tracker_suite, MemoryTrackerFixture )
+
+BOOST_AUTO_TEST_CASE( tensor_allocation )
+{
+  const std::size_t live = tracker.usage(MemoryCategory::tile).live;
+  const std::size_t bytes = 12ul * sizeof(double);
+  {
+    TensorD t(Range(std::array<int, 2>{{3, 4}}), 1.0);
+    BOOST_CHECK_EQUAL(tracker.usage(MemoryCategory::tile).live, live + bytes);
+    BOOST_CHECK_GE(tracker.usage(MemoryCategory::tile).peak, live + bytes);
+
+    // Copies share the data and are not counted
+    TensorD copy = t;
+    BOOST_CHECK_EQUAL(tracker.usage(MemoryCategory::tile).live, live + bytes);
+  }
+  BOOST_CHECK_EQUAL(tracker.usage(MemoryCategory::tile).live, live);
+}
+
+BOOST_AUTO_TEST_CASE( scope )
+{
+  const std::size_t tile_live = tracker.usage(MemoryCategory::tile).live;
+  const std::size_t reduce_live = tracker.usage(MemoryCategory::reduce).live;
+  const std::size_t bytes = 12ul * sizeof(double);
+  {
+    TensorD t;
+    {
+      detail::MemoryScope memory_scope(MemoryCategory::reduce);
+      BOOST_CHECK(MemoryTracker::category() == MemoryCategory::reduce);
+      t = TensorD(Range(std::array<int, 2>{{3, 4}}), 1.0);
+    }
+    BOOST_CHECK(MemoryTracker::category() == MemoryCategory::tile);
+
+    // The data stays in the category it was allocated in
+    BOOST_CHECK_EQUAL(tracker.usage(MemoryCategory::reduce).live, reduce_live + bytes);
+    BOOST_CHECK_EQUAL(tracker.usage(MemoryCategory::tile).live, tile_live);
+  }
+  BOOST_CHECK_EQUAL(tracker.usage(MemoryCategory::reduce).live, reduce_live);
+}
+
+BOOST_AUTO_TEST_CASE( peak )
+{
+  tracker.reset_peak();
+  const MemoryUsage start = tracker.usage(MemoryCategory::shape);
+  BOOST_CHECK_EQUAL(start.peak, start.live);
+
+  tracker.allocate(MemoryCategory::shape, 100ul);
+  tracker.allocate(MemoryCategory::shape, 50ul);
+  tracker.deallocate(MemoryCategory::shape, 150ul);
+  BOOST_CHECK_EQUAL(tracker.usage(MemoryCategory::shape).live, start.live);
+  BOOST_CHECK_EQUAL(tracker.usage(MemoryCategory::shape).peak, start.live + 150ul);
+
+  // Broadcast memory is not included in the total
+  const std::size_t total = tracker.total().live;
+  tracker.allocate(MemoryCategory::broadcast, 100ul);
+  BOOST_CHECK_EQUAL(tracker.total().live, total);
+  tracker.deallocate(MemoryCategory::broadcast, 100ul);
+}
+
+BOOST_AUTO_TEST_CASE( max_usage )
+{
+  World& world = *GlobalFixture::world;
+  std::vector<MemoryUsage> usage;
+  BOOST_REQUIRE_NO_THROW(usage = max_memory_usage(world));
+  BOOST_CHECK_EQUAL(usage.size(), MemoryTracker::num_categories + 1u);
+  for(const auto& u : usage)
+    BOOST_CHECK_GE(u.peak, u.live);
+}
+
+BOOST_AUTO_TEST_CASE( array_memory )
+{
+  World& world = *GlobalFixture::world;
+  TiledRange1 tr1{0, 3, 8};
+  TArrayD a(world, TiledRange({tr1, tr1}));
+  a.fill(1.0);
+
+  std::size_t local = 0ul;
+  for(const auto index : *a.pmap())
+    local += a.trange().make_tile_range(index).volume() * sizeof(double);
+  BOOST_CHECK_EQUAL(local_memory(a), local);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
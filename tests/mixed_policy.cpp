@@ -0,0 +1,132 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  mixed_policy.cpp
+ *  Oct 15, 2026
+ *
+ */
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct MixedPolicyFixture {
+
+  MixedPolicyFixture() :
+    world(*GlobalFixture::world),
+    tr{0, 2, 5, 6, 9}, trange{tr, tr}
+  {
+    a = TArrayD(world, trange);
+    fill(a, [] (std::size_t i, std::size_t j) { return 1.0 / double(1ul + i + 2ul * j); });
+
+    // b has the tiles of the diagonal and of the first row
+    Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < 4ul; ++i) {
+      norms(i, i) = 1.0f;
+      norms(0, i) = 1.0f;
+    }
+    b = TSpArrayD(world, trange, TSpArrayD::shape_type(norms, trange));
+    fill(b, [] (std::size_t i, std::size_t j) { return double(i) - 0.5 * double(j); });
+
+    sparse_a = to_sparse(a);
+  }
+
+  // Set the local non-zero tiles of an array with op
+  template <typename A, typename Op>
+  static void fill(A& array, const Op& op) {
+    for(const auto t : *array.pmap()) {
+      if(array.is_zero(t))
+        continue;
+      TensorD tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = op(index[0], index[1]);
+      array.set(t, tile);
+    }
+  }
+
+  // Check that array has the non-zero tiles and the elements of ref
+  static void check(const TSpArrayD& array, const TSpArrayD& ref) {
+    BOOST_CHECK(array.trange() == ref.trange());
+    for(std::size_t t = 0ul; t < array.size(); ++t) {
+      BOOST_CHECK_EQUAL(array.is_zero(t), ref.is_zero(t));
+      if(array.is_zero(t) || ! array.is_local(t))
+        continue;
+      const TensorD tile = array.find(t).get();
+      const TensorD ref_tile = ref.find(t).get();
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_CLOSE(tile[i], ref_tile[i], 1.0e-8);
+    }
+  }
+
+  World& world;
+  TiledRange1 tr;
+  TiledRange trange;
+  TArrayD a;
+  TSpArrayD b, sparse_a;
+}; // MixedPolicyFixture
+
+BOOST_FIXTURE_TEST_SUITE( mixed_policy_suite, MixedPolicyFixture )
+
+BOOST_AUTO_TEST_CASE( dense_sparse_contraction )
+{
+  TSpArrayD c, ref;
+  BOOST_REQUIRE_NO_THROW(c("i,j") = a("i,k") * b("k,j"));
+  ref("i,j") = sparse_a("i,k") * b("k,j");
+  check(c, ref);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( sparse_dense_contraction )
+{
+  TSpArrayD c, ref;
+  BOOST_REQUIRE_NO_THROW(c("j,i") = 2.0 * (b("i,k") * a("j,k")));
+  ref("j,i") = 2.0 * (b("i,k") * sparse_a("j,k"));
+  check(c, ref);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( hadamard )
+{
+  TSpArrayD c, ref;
+  BOOST_REQUIRE_NO_THROW(c("i,j") = a("j,i") * b("i,j"));
+  ref("i,j") = sparse_a("j,i") * b("i,j");
+  check(c, ref);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( truncate )
+{
+  // The tiles of a are not screened, so the norms of the result are bounds
+  // until they are recomputed
+  TSpArrayD c, ref;
+  c("i,j") = a("i,k") * b("k,j");
+  ref("i,j") = sparse_a("i,k") * b("k,j");
+  c.truncate();
+  ref.truncate();
+  check(c, ref);
+  for(std::size_t t = 0ul; t < c.size(); ++t)
+    if(! c.is_zero(t))
+      BOOST_CHECK_CLOSE(c.shape()[t], ref.shape()[t], 1.0e-3);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
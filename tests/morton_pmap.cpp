@@ -0,0 +1,149 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/morton_pmap.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct MortonPmapFixture {
+
+  MortonPmapFixture() { }
+
+  /// Construct a rank-3 tile range with \c tiles tiles
+  static Range make_range(const std::size_t tiles) {
+    return Range(tiles, 1ul + (tiles % 3ul), 3ul);
+  }
+
+};
+
+// =============================================================================
+// MortonPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( morton_pmap_suite, MortonPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  for(std::size_t tiles = 1ul; tiles < 40ul; ++tiles) {
+    const Range range = make_range(tiles);
+    BOOST_REQUIRE_NO_THROW(TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range));
+    TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range);
+    BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+    BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+    BOOST_CHECK_EQUAL(pmap.size(), range.volume());
+  }
+
+#ifdef TA_EXCEPTION_ERROR
+  // 7 dimensions with 10 key bits each do not fit in a 63-bit key
+  BOOST_CHECK_THROW(TiledArray::detail::MortonPmap pmap(* GlobalFixture::world,
+      Range(513ul, 513ul, 513ul, 513ul, 513ul, 513ul, 513ul)), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( key )
+{
+  TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, Range(4ul, 4ul));
+
+  // Check the Z-order of the tiles
+  const std::size_t keys[4][4] = { {  0,  1,  4,  5 },
+                                   {  2,  3,  6,  7 },
+                                   {  8,  9, 12, 13 },
+                                   { 10, 11, 14, 15 } };
+  for(std::size_t i = 0ul; i < 4ul; ++i)
+    for(std::size_t j = 0ul; j < 4ul; ++j)
+      BOOST_CHECK_EQUAL(pmap.key(i * 4ul + j), keys[i][j]);
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  // Check various pmap sizes
+  for(std::size_t tiles = 1ul; tiles < 40ul; ++tiles) {
+    const Range range = make_range(tiles);
+    TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range);
+
+    for(std::size_t tile = 0; tile < range.volume(); ++tile) {
+      std::fill_n(p_owner, size, 0);
+      p_owner[rank] = pmap.owner(tile);
+      // check that the value is in range
+      BOOST_CHECK_LT(p_owner[rank], size);
+      GlobalFixture::world->gop.sum(p_owner, size);
+
+      // Make sure everyone agrees on who owns what.
+      for(std::size_t p = 0ul; p < size; ++p)
+        BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_size )
+{
+  for(std::size_t tiles = 1ul; tiles < 40ul; ++tiles) {
+    const Range range = make_range(tiles);
+    TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range);
+
+    std::size_t total_size = pmap.local_size();
+    GlobalFixture::world->gop.sum(total_size);
+
+    // Check that the total number of elements in all local groups is equal to
+    // the number of tiles in the map.
+    BOOST_CHECK_EQUAL(total_size, range.volume());
+    BOOST_CHECK(pmap.empty() == (pmap.local_size() == 0ul));
+
+    // Check that each process has approximately N/P tiles
+    BOOST_CHECK_LE(pmap.local_size(), range.volume() / pmap.procs() + 1ul);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[360];
+
+  for(std::size_t tiles = 1ul; tiles < 40ul; ++tiles) {
+    const Range range = make_range(tiles);
+    TiledArray::detail::MortonPmap pmap(* GlobalFixture::world, range);
+
+    // Check that all local elements map to this rank
+    for(detail::MortonPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+    }
+
+    std::fill_n(tile_owners, range.volume(), 0);
+    for(detail::MortonPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      tile_owners[*it] += GlobalFixture::world->rank();
+    }
+
+    GlobalFixture::world->gop.sum(tile_owners, range.volume());
+    for(std::size_t tile = 0; tile < range.volume(); ++tile) {
+      BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+    }
+
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,120 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  multi_contract.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct MultiContractFixture {
+  MultiContractFixture() :
+    world(*GlobalFixture::world),
+    tr{0, 2, 5, 6}, tro{0, 1, 3}, trange{tr, tr}, vec_trange{tr, tro}
+  {
+    op = TSpArrayD(world, trange);
+    fill(op, [] (const Range::index& i) {
+      return 1.0 / double(1ul + i[0] + 2ul * i[1]);
+    });
+    for(std::size_t n = 0ul; n < 3ul; ++n) {
+      vecs.emplace_back(world, vec_trange);
+      fill(vecs.back(), [n] (const Range::index& i) {
+        return double(int(i[0]) - int(i[1] * n)) * 0.25;
+      });
+    }
+  }
+
+  // Set the local tiles of an array with op
+  template <typename Op>
+  static void fill(TSpArrayD& array, const Op& op) {
+    for(const auto t : *array.pmap()) {
+      TensorD tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = op(index);
+      array.set(t, tile);
+    }
+  }
+
+  // Compare two arrays with the same tiled range
+  static void check(const TSpArrayD& array, const TSpArrayD& ref) {
+    BOOST_CHECK_EQUAL(array.trange(), ref.trange());
+    for(std::size_t t = 0ul; t < ref.size(); ++t) {
+      BOOST_CHECK_EQUAL(array.is_zero(t), ref.is_zero(t));
+      if(ref.is_zero(t) || ! ref.is_local(t))
+        continue;
+      const TensorD tile = array.find(t).get();
+      const TensorD ref_tile = ref.find(t).get();
+      BOOST_CHECK_EQUAL(tile.range(), ref_tile.range());
+      for(std::size_t i = 0ul; i < tile.size(); ++i)
+        BOOST_CHECK_CLOSE(tile[i], ref_tile[i], 1.0e-8);
+    }
+  }
+
+  World& world;
+  TiledRange1 tr, tro;
+  TiledRange trange, vec_trange;
+  TSpArrayD op;
+  std::vector<TSpArrayD> vecs;
+}; // MultiContractFixture
+
+BOOST_FIXTURE_TEST_SUITE( multi_contract_suite, MultiContractFixture )
+
+BOOST_AUTO_TEST_CASE( shared_left )
+{
+  const std::vector<TSpArrayD> results =
+      multi_contract(op, "a,c", vecs, "c,i", "a,i");
+  BOOST_REQUIRE_EQUAL(results.size(), vecs.size());
+  for(std::size_t n = 0ul; n < vecs.size(); ++n) {
+    TSpArrayD ref;
+    ref("a,i") = op("a,c") * vecs[n]("c,i");
+    check(results[n], ref);
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( shared_right )
+{
+  const std::vector<TSpArrayD> results =
+      multi_contract(vecs, "c,i", op, "c,a", "i,a");
+  BOOST_REQUIRE_EQUAL(results.size(), vecs.size());
+  for(std::size_t n = 0ul; n < vecs.size(); ++n) {
+    TSpArrayD ref;
+    ref("i,a") = vecs[n]("c,i") * op("c,a");
+    check(results[n], ref);
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( invalid_args )
+{
+  BOOST_CHECK_THROW(multi_contract(op, "a,c", std::vector<TSpArrayD>(),
+      "c,i", "a,i"), TiledArray::Exception);
+  std::vector<TSpArrayD> args = { vecs[0], op };
+  BOOST_CHECK_THROW(multi_contract(op, "a,c", args, "c,i", "a,i"),
+      TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
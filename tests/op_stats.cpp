@@ -0,0 +1,95 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  op_stats.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/op_stats.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct OpStatsFixture {
+
+  OpStatsFixture() :
+    stats(OpStats::instance()),
+    a(Range(std::array<int, 2>{{3, 4}}), 1.0),
+    b(Range(std::array<int, 2>{{4, 5}}), 2.0)
+  {
+    stats.enable();
+  }
+
+  OpStats& stats;
+  TensorD a, b;
+}; // OpStatsFixture
+
+BOOST_FIXTURE_TEST_SUITE( op_stats_suite, OpStatsFixture )
+
+BOOST_AUTO_TEST_CASE( add )
+{
+  const OpStats::Counters before = stats.counters(TileOpKind::add);
+  Add<TensorD, TensorD, false, false> add_op;
+  const TensorD c = add_op(a, a);
+  const OpStats::Counters after = stats.counters(TileOpKind::add);
+
+  BOOST_CHECK_EQUAL(after.calls, before.calls + 1ul);
+  BOOST_CHECK_EQUAL(after.flops, before.flops + 12ul);
+  BOOST_CHECK_EQUAL(after.bytes, before.bytes + 36ul * sizeof(double));
+  std::uint64_t histogram = 0ul;
+  for(unsigned int i = 0u; i < OpStats::bins; ++i)
+    histogram += after.histogram[i] - before.histogram[i];
+  BOOST_CHECK_EQUAL(histogram, 1ul);
+}
+
+BOOST_AUTO_TEST_CASE( contract )
+{
+  const OpStats::Counters before = stats.counters(TileOpKind::contract);
+  ContractReduce<TensorD, TensorD, double> op(
+      madness::cblas::NoTrans, madness::cblas::NoTrans, 1.0, 2u, 2u, 2u);
+  TensorD c = op();
+  op(c, a, b);
+  const OpStats::Counters after = stats.counters(TileOpKind::contract);
+
+  BOOST_CHECK_EQUAL(after.calls, before.calls + 1ul);
+  BOOST_CHECK_EQUAL(after.flops, before.flops + 2ul * 3ul * 5ul * 4ul);
+}
+
+BOOST_AUTO_TEST_CASE( disable )
+{
+  stats.disable();
+  const OpStats::Counters before = stats.counters(TileOpKind::add);
+  Add<TensorD, TensorD, false, false> add_op;
+  const TensorD c = add_op(a, a);
+  BOOST_CHECK_EQUAL(stats.counters(TileOpKind::add).calls, before.calls);
+  stats.enable();
+}
+
+BOOST_AUTO_TEST_CASE( write )
+{
+  std::stringstream ss;
+  BOOST_CHECK_NO_THROW(stats.write(ss));
+  BOOST_CHECK_NE(ss.str().find("contract"), std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -156,4 +156,43 @@ BOOST_AUTO_TEST_CASE( permute_constructor_tensor ) {
   }
 }
 
+BOOST_AUTO_TEST_CASE( table ) {
+  const std::vector<Permutation> perms = { Permutation({0,1,2,3}), perm,
+      Permutation({3,2,1,0}), Permutation({2,0,3,1}) };
+  for(const auto& p : perms) {
+    const std::vector<std::size_t> table = make_perm_index_table(range, p);
+    const PermIndex perm_index(range, p);
+
+    BOOST_REQUIRE_EQUAL(table.size(), range.volume());
+    for(std::size_t i = 0ul; i < range.volume(); ++i)
+      BOOST_CHECK_EQUAL(table[i], perm_index(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( table_cache ) {
+  PermIndexTableCache& cache = PermIndexTableCache::instance();
+  const std::size_t max_volume = cache.max_volume();
+  const std::size_t capacity = cache.capacity();
+  cache.set(range.volume(), 2ul);
+
+  // Tables are shared by equal ranges and permutations
+  std::shared_ptr<const std::vector<std::size_t> > table = cache.get(range, perm);
+  BOOST_REQUIRE(table);
+  BOOST_CHECK(table == cache.get(Range(start, finish), Permutation({1,2,0,3})));
+  BOOST_CHECK(*table == make_perm_index_table(range, perm));
+
+  // Least recently used tables are dropped
+  BOOST_CHECK(cache.get(range, -perm) != table);
+  BOOST_CHECK(cache.get(perm_range, perm));
+  BOOST_CHECK_EQUAL(cache.size(), 2ul);
+  BOOST_CHECK(cache.get(range, perm) != table);
+
+  // Large ranges are not tabulated
+  cache.set(range.volume() - 1ul, 2ul);
+  BOOST_CHECK_EQUAL(cache.size(), 0ul);
+  BOOST_CHECK(! cache.get(range, perm));
+
+  cache.set(max_volume, capacity);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  permuted_pmap.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/pmap/permuted_pmap.h"
+#include "TiledArray/pmap/blocked_pmap.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct PermutedPmapFixture {
+
+  PermutedPmapFixture() :
+    source_range(3, 4, 5), perm({2, 0, 1}),
+    target_pmap(std::make_shared<detail::BlockedPmap>(* GlobalFixture::world,
+        source_range.volume())),
+    pmap(* GlobalFixture::world, target_pmap, source_range, perm)
+  { }
+
+  ~PermutedPmapFixture() { }
+
+  Range source_range;
+  Permutation perm;
+  std::shared_ptr<Pmap> target_pmap;
+  detail::PermutedPmap pmap;
+
+}; // Fixture
+
+BOOST_FIXTURE_TEST_SUITE( permuted_pmap_suite, PermutedPmapFixture )
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const Range target_range = perm * source_range;
+
+  BOOST_CHECK_EQUAL(pmap.size(), source_range.volume());
+  BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+
+  // Each tile is owned by the owner of the permuted tile
+  for(std::size_t i = 0ul; i < source_range.volume(); ++i) {
+    const std::size_t target =
+        target_range.ordinal(perm * source_range.idx(i));
+    BOOST_CHECK_EQUAL(pmap.owner(i), target_pmap->owner(target));
+    BOOST_CHECK_EQUAL(pmap.is_local(i), target_pmap->is_local(target));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_tiles )
+{
+  std::vector<std::size_t> local;
+  for(std::size_t i = 0ul; i < source_range.volume(); ++i)
+    if(pmap.is_local(i))
+      local.push_back(i);
+
+  BOOST_CHECK_EQUAL(pmap.local_size(), target_pmap->local_size());
+  BOOST_CHECK_EQUAL_COLLECTIONS(pmap.begin(), pmap.end(), local.begin(),
+      local.end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
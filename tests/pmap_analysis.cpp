@@ -0,0 +1,163 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/pmap_analysis.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct PmapAnalysisFixture {
+
+  PmapAnalysisFixture() :
+    tr_i(make_trange1({ 0, 3, 5, 9, 10 })),
+    tr_k(make_trange1({ 0, 2, 6, 7 })),
+    tr_j(make_trange1({ 0, 4, 8 })),
+    left_trange({ tr_i, tr_k }),
+    right_trange({ tr_k, tr_j }),
+    left_shape(make_shape(left_trange, 3ul)),
+    right_shape(make_shape(right_trange, 4ul))
+  { }
+
+  static TiledRange1 make_trange1(const std::vector<std::size_t>& bounds) {
+    return TiledRange1(bounds.begin(), bounds.end());
+  }
+
+  /// A shape where every \c n -th tile is zero
+  static SparseShape<float> make_shape(const TiledRange& trange, const std::size_t n) {
+    Tensor<float> norms(trange.tiles_range(), 0.0f);
+    for(std::size_t i = 0ul; i < norms.size(); ++i)
+      if(i % n)
+        norms[i] = trange.make_tile_range(i).volume();
+    return SparseShape<float>(norms, trange);
+  }
+
+  /// Flops of a tile of C(i,j) = A(i,k) B(k,j)
+  double reference_flops(const std::size_t i, const std::size_t j) const {
+    const std::size_t K = tr_k.tiles_range().second;
+    const std::size_t J = tr_j.tiles_range().second;
+    double result = 0.0;
+    for(std::size_t k = 0ul; k < K; ++k) {
+      if(left_shape.is_zero(i * K + k) || right_shape.is_zero(k * J + j))
+        continue;
+      result += 2.0 * double(tr_i.tile(i).second - tr_i.tile(i).first) *
+          double(tr_k.tile(k).second - tr_k.tile(k).first) *
+          double(tr_j.tile(j).second - tr_j.tile(j).first);
+    }
+    return result;
+  }
+
+  const TiledRange1 tr_i, tr_k, tr_j;
+  const TiledRange left_trange, right_trange;
+  const SparseShape<float> left_shape, right_shape;
+}; // PmapAnalysisFixture
+
+BOOST_FIXTURE_TEST_SUITE( pmap_analysis_suite, PmapAnalysisFixture )
+
+BOOST_AUTO_TEST_CASE( tile_flops )
+{
+  const std::size_t I = tr_i.tiles_range().second, J = tr_j.tiles_range().second;
+
+  const std::vector<double> flops = contraction_tile_flops("i,j", "i,k",
+      left_trange, left_shape, "k,j", right_trange, right_shape);
+  BOOST_REQUIRE_EQUAL(flops.size(), I * J);
+  for(std::size_t i = 0ul; i < I; ++i)
+    for(std::size_t j = 0ul; j < J; ++j)
+      BOOST_CHECK_CLOSE(flops[i * J + j] + 1.0, reference_flops(i, j) + 1.0, 1.0e-10);
+
+  // The result tiles follow the order of the result indices
+  const std::vector<double> flops_t = contraction_tile_flops("j,i", "k,j",
+      right_trange, right_shape, "i,k", left_trange, left_shape);
+  BOOST_REQUIRE_EQUAL(flops_t.size(), I * J);
+  for(std::size_t i = 0ul; i < I; ++i)
+    for(std::size_t j = 0ul; j < J; ++j)
+      BOOST_CHECK_EQUAL(flops_t[j * I + i], flops[i * J + j]);
+}
+
+BOOST_AUTO_TEST_CASE( load )
+{
+  World& world = * GlobalFixture::world;
+  const std::size_t I = tr_i.tiles_range().second, J = tr_j.tiles_range().second;
+  detail::BlockedPmap left_pmap(world, left_trange.tiles_range().volume());
+  detail::HashPmap right_pmap(world, right_trange.tiles_range().volume());
+  detail::BlockedPmap result_pmap(world, I * J);
+
+  PmapAnalysis analysis(world.size());
+  analysis.add_array(left_trange, left_shape, left_pmap);
+  const PmapLoad stored = analysis.total();
+  std::size_t tiles = 0ul;
+  double bytes = 0.0;
+  for(std::size_t i = 0ul; i < left_trange.tiles_range().volume(); ++i) {
+    if(left_shape.is_zero(i))
+      continue;
+    ++tiles;
+    bytes += left_trange.make_tile_range(i).volume() * sizeof(double);
+  }
+  BOOST_CHECK_EQUAL(stored.tiles, tiles);
+  BOOST_CHECK_CLOSE(stored.bytes, bytes, 1.0e-10);
+  BOOST_CHECK_EQUAL(stored.flops, 0.0);
+
+  analysis.reset();
+  analysis.add_contraction("i,j", result_pmap, "i,k", left_trange, left_shape,
+      left_pmap, "k,j", right_trange, right_shape, right_pmap);
+  const PmapLoad total = analysis.total();
+
+  // The flops of each process are the flops of its result tiles
+  double flops = 0.0;
+  std::vector<double> proc_flops(world.size(), 0.0);
+  for(std::size_t i = 0ul; i < I; ++i) {
+    for(std::size_t j = 0ul; j < J; ++j) {
+      flops += reference_flops(i, j);
+      proc_flops[result_pmap.owner(i * J + j)] += reference_flops(i, j);
+    }
+  }
+  BOOST_CHECK_CLOSE(total.flops, flops, 1.0e-10);
+  for(std::size_t p = 0ul; p < proc_flops.size(); ++p)
+    BOOST_CHECK_CLOSE(analysis.load()[p].flops + 1.0, proc_flops[p] + 1.0, 1.0e-10);
+
+  // Every byte that is received is sent
+  BOOST_CHECK_CLOSE(total.recv_bytes + 1.0, total.send_bytes + 1.0, 1.0e-10);
+  BOOST_CHECK_GE(analysis.flop_imbalance(), 1.0);
+  if(world.size() == 1) {
+    BOOST_CHECK_EQUAL(total.recv_bytes, 0.0);
+    BOOST_CHECK_CLOSE(analysis.flop_imbalance(), 1.0, 1.0e-10);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( invalid_contraction )
+{
+#ifdef TA_EXCEPTION_ERROR
+  World& world = * GlobalFixture::world;
+  detail::BlockedPmap left_pmap(world, left_trange.tiles_range().volume());
+  detail::BlockedPmap right_pmap(world, right_trange.tiles_range().volume());
+  detail::BlockedPmap result_pmap(world, 12ul);
+  PmapAnalysis analysis(world.size());
+
+  // The tilings of the contracted index differ
+  BOOST_CHECK_THROW(analysis.add_contraction("i,j", result_pmap, "i,k",
+      left_trange, left_shape, left_pmap, "j,k", right_trange, right_shape,
+      right_pmap), TiledArray::Exception);
+  // A result index is in both arguments
+  BOOST_CHECK_THROW(contraction_tile_flops("k", "i,k", left_trange, left_shape,
+      "k,j", right_trange, right_shape), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_SUITE_END()
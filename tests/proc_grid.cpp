@@ -193,6 +193,128 @@ BOOST_AUTO_TEST_CASE( make_groups )
   }
 }
 
+BOOST_AUTO_TEST_CASE( layers )
+{
+  const ProcessID nprocs = GlobalFixture::world->size();
+
+  for(ProcessID layers = 1; layers <= nprocs; ++layers) {
+    // Construct the process grid
+    TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, 42, 84,
+        2048, 1024, layers);
+
+    BOOST_CHECK_EQUAL(proc_grid.layers(), std::size_t(layers));
+    BOOST_CHECK_EQUAL(proc_grid.layer_stride(), std::size_t(nprocs / layers));
+    BOOST_CHECK_LE(proc_grid.proc_size(), proc_grid.layer_stride());
+
+    if(proc_grid.local_size() > 0ul) {
+      // Check that this process maps to itself in its own layer
+      BOOST_CHECK_EQUAL(proc_grid.rank_layer(),
+          GlobalFixture::world->rank() / ProcessID(proc_grid.layer_stride()));
+      BOOST_CHECK_EQUAL(proc_grid.map_layer(proc_grid.rank_layer()),
+          GlobalFixture::world->rank());
+      BOOST_CHECK_EQUAL(proc_grid.map_row(proc_grid.rank_row()),
+          GlobalFixture::world->rank());
+      BOOST_CHECK_EQUAL(proc_grid.map_col(proc_grid.rank_col()),
+          GlobalFixture::world->rank());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( default_layers )
+{
+  typedef TiledArray::detail::ProcGrid ProcGrid;
+
+  // Tall-skinny contraction: 2x2 result tiles and 64 contracted tiles
+  BOOST_CHECK_EQUAL(ProcGrid::default_layers(16u, 2u, 2u, 64u, 100ul, 100ul, 6400ul), 4u);
+  BOOST_CHECK_EQUAL(ProcGrid::default_layers(16u, 1u, 1u, 64u, 50ul, 50ul, 6400ul), 16u);
+
+  // The number of layers is limited by the number of contracted tiles
+  BOOST_CHECK_EQUAL(ProcGrid::default_layers(16u, 1u, 1u, 3u, 50ul, 50ul, 6400ul), 3u);
+
+  // A single layer when the result tiles keep the processes busy, the
+  // contracted dimension is short, or there is one process
+  BOOST_CHECK_EQUAL(ProcGrid::default_layers(16u, 4u, 4u, 64u, 400ul, 400ul, 6400ul), 1u);
+  BOOST_CHECK_EQUAL(ProcGrid::default_layers(16u, 2u, 2u, 64u, 10000ul, 100ul, 6400ul), 1u);
+  BOOST_CHECK_EQUAL(ProcGrid::default_layers(1u, 1u, 1u, 64u, 50ul, 50ul, 6400ul), 1u);
+}
+
+BOOST_AUTO_TEST_CASE( match_layout )
+{
+  TiledArray::World& world = *GlobalFixture::world;
+  const std::size_t nprocs = std::min<std::size_t>(world.size(), 16ul);
+
+  // A layout that moves little broadcast data is adopted
+  TiledArray::detail::ProcGrid proc_grid(world, 16, 16, 1600, 1600);
+  BOOST_CHECK(proc_grid.match_layout(proc_grid.proc_rows(), proc_grid.proc_cols(),
+      1600, 1600, 1600));
+  BOOST_CHECK(proc_grid.match_layout(1, nprocs, 1600, 1600, 1));
+  BOOST_CHECK_EQUAL(proc_grid.proc_rows(), 1u);
+  BOOST_CHECK_EQUAL(proc_grid.proc_cols(), nprocs);
+  BOOST_CHECK_EQUAL(proc_grid.proc_size(), nprocs);
+  if(std::size_t(world.rank()) < nprocs)
+    BOOST_CHECK_EQUAL(proc_grid.local_rows(), 16u);
+
+  // The result process map matches the layout
+  TiledArray::detail::CyclicPmap layout(world, 16, 16, 1, nprocs);
+  std::shared_ptr<TiledArray::Pmap> pmap = proc_grid.make_pmap();
+  for(std::size_t i = 0ul; i < 256ul; ++i)
+    BOOST_CHECK_EQUAL(pmap->owner(i), layout.owner(i));
+
+  // A layout with a much larger broadcast volume is not adopted
+  TiledArray::detail::ProcGrid tall_grid(world, 16, 16, 16000, 16);
+  if(tall_grid.proc_rows() > 1u) {
+    BOOST_CHECK(! tall_grid.match_layout(1, nprocs, 16000, 16, 1000000));
+    BOOST_CHECK_NE(tall_grid.proc_rows(), 1u);
+  }
+
+  // Layouts with more process rows than tile rows are not valid
+  BOOST_CHECK(! proc_grid.match_layout(17, 1, 1600, 1600, 1));
+}
+
+BOOST_AUTO_TEST_CASE( topology )
+{
+  const ProcessID nprocs = 32;
+  const ProcessID procs_per_node = 8;
+
+  // Construct a topology for four nodes with two sockets each
+  std::vector<ProcessID> node(nprocs), socket(nprocs);
+  for(ProcessID p = 0; p < nprocs; ++p) {
+    node[p] = (p / procs_per_node) * procs_per_node;
+    socket[p] = (p / (procs_per_node / 2)) * (procs_per_node / 2);
+  }
+  const TiledArray::detail::ProcTopology topology(node, socket);
+  BOOST_CHECK(! topology.trivial());
+  BOOST_CHECK_EQUAL(topology.broadcast_cost(8ul,
+      [] (const std::size_t i) { return ProcessID(i); }), 2.0);
+  BOOST_CHECK_EQUAL(topology.broadcast_cost(4ul,
+      [] (const std::size_t i) { return ProcessID(i * 8ul); }), 3.0);
+
+  TiledArray::detail::ProcGrid proc_grid0(*GlobalFixture::world, 0, nprocs,
+      128, 128, 12800, 12800);
+  TiledArray::detail::ProcGrid proc_grid(*GlobalFixture::world, 0, nprocs,
+      128, 128, 12800, 12800, topology);
+
+  // Check that the topology-aware grid does not add unused processes
+  BOOST_CHECK_GE(proc_grid.proc_size(), proc_grid0.proc_size());
+
+  // Check that the row broadcasts stay inside a node
+  for(std::size_t row = 0ul; row < proc_grid.proc_rows(); ++row)
+    for(std::size_t col = 0ul; col < proc_grid.proc_cols(); ++col)
+      BOOST_CHECK_EQUAL(node[row * proc_grid.proc_cols() + col],
+          node[row * proc_grid.proc_cols()]);
+
+  // Check that a trivial topology does not change the grid
+  std::vector<ProcessID> self(nprocs);
+  for(ProcessID p = 0; p < nprocs; ++p)
+    self[p] = p;
+  const TiledArray::detail::ProcTopology distinct(self, self);
+  BOOST_CHECK(distinct.trivial());
+  TiledArray::detail::ProcGrid proc_grid1(*GlobalFixture::world, 0, nprocs,
+      128, 128, 12800, 12800, distinct);
+  BOOST_CHECK_EQUAL(proc_grid1.proc_rows(), proc_grid0.proc_rows());
+  BOOST_CHECK_EQUAL(proc_grid1.proc_cols(), proc_grid0.proc_cols());
+}
+
 #if 0
 // This test case us used to evaluate distribute statistics. This unit test
 // should only be enabled when changes are made to the ProcGrid algorithm, and
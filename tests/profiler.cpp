@@ -0,0 +1,119 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  profiler.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+#include "TiledArray/profiler.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using TiledArray::TaskProfiler;
+using TiledArray::detail::ProfileScope;
+
+struct ProfilerFixture {
+
+  ProfilerFixture() {
+    TaskProfiler::instance().disable();
+    TaskProfiler::instance().clear();
+  }
+
+  ~ProfilerFixture() {
+    TaskProfiler::instance().disable();
+    TaskProfiler::instance().clear();
+  }
+
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( profiler_suite, ProfilerFixture )
+
+BOOST_AUTO_TEST_CASE( tile_bytes )
+{
+  TiledArray::TensorD t(TiledArray::Range(std::array<int, 2>{{3, 4}}), 1.0);
+  BOOST_CHECK_EQUAL(TiledArray::detail::tile_bytes(t), 12ul * sizeof(double));
+  BOOST_CHECK_EQUAL(TiledArray::detail::tile_bytes(TiledArray::TensorD()), 0ul);
+  BOOST_CHECK_EQUAL(TiledArray::detail::tile_bytes(1.0), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( disabled )
+{
+  {
+    ProfileScope profile("test", "test");
+    BOOST_CHECK(! profile.enabled());
+  }
+  BOOST_CHECK_EQUAL(TaskProfiler::instance().size(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( record )
+{
+  TaskProfiler& profiler = TaskProfiler::instance();
+  profiler.enable();
+  {
+    ProfileScope profile("test_event", "test", 3ul, 8ul);
+    BOOST_CHECK(profile.enabled());
+    profile.add_bytes(8ul);
+  }
+  BOOST_CHECK_EQUAL(profiler.size(), 1ul);
+
+  // Check the trace output
+  std::stringstream ss;
+  profiler.write(ss, 2);
+  const std::string trace = ss.str();
+  BOOST_CHECK_EQUAL(trace.find("{\"traceEvents\":["), 0ul);
+  BOOST_CHECK(trace.find("\"name\":\"test_event\"") != std::string::npos);
+  BOOST_CHECK(trace.find("\"cat\":\"test\"") != std::string::npos);
+  BOOST_CHECK(trace.find("\"ph\":\"X\"") != std::string::npos);
+  BOOST_CHECK(trace.find("\"pid\":2") != std::string::npos);
+  BOOST_CHECK(trace.find("\"bytes\":16,\"index\":3") != std::string::npos);
+
+  profiler.clear();
+  BOOST_CHECK_EQUAL(profiler.size(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  const TiledArray::TiledRange1 tr1(0, 3, 6, 9);
+  TiledArray::TiledRange trange{tr1, tr1};
+  TiledArray::TArrayD a(*GlobalFixture::world, trange);
+  TiledArray::TArrayD b(*GlobalFixture::world, trange);
+  TiledArray::TArrayD c;
+  a.fill_local(1.0);
+  b.fill_local(2.0);
+
+  TaskProfiler& profiler = TaskProfiler::instance();
+  profiler.enable();
+  c("i,j") = a("i,k") * b("k,j") + a("i,j");
+  GlobalFixture::world->gop.fence();
+  profiler.disable();
+
+  // The first process is always part of the SUMMA process grid
+  if(GlobalFixture::world->rank() == 0) {
+    std::stringstream ss;
+    profiler.write(ss, 0);
+    const std::string trace = ss.str();
+    BOOST_CHECK(trace.find("\"name\":\"summa_step\"") != std::string::npos);
+    BOOST_CHECK(profiler.size() > 0ul);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,145 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  quantized_tile.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/quantized_tile.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct QuantizedTileFixture {
+  typedef DistArray<QuantizedTile<double>, DensePolicy> QuantizedArrayD;
+
+  QuantizedTileFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8, 12}, TiledRange1{0, 4, 9} })
+  { }
+
+  // A tile with elements in [-scale, scale]
+  static TensorD make_tile(const Range& range, const double scale) {
+    TensorD tile(range);
+    for(std::size_t i = 0ul; i < tile.size(); ++i)
+      tile[i] = scale * std::sin(double(i + 1ul));
+    return tile;
+  }
+
+  World& world;
+  TiledRange trange;
+}; // QuantizedTileFixture
+
+BOOST_FIXTURE_TEST_SUITE( quantized_tile_suite, QuantizedTileFixture )
+
+BOOST_AUTO_TEST_CASE( tile )
+{
+  const Range range(std::array<std::size_t, 2>{{5, 7}});
+  BOOST_CHECK(is_lazy_tile<QuantizedTile<double> >::value);
+  BOOST_CHECK(QuantizedTile<double>().empty());
+
+  // The most compact format within the tolerance is used
+  const TensorD tensor = make_tile(range, 1.0);
+  const QuantizedTile<double> tile8(tensor, 1.0e-2);
+  const QuantizedTile<double> tile16(tensor, 1.0e-4);
+  const QuantizedTile<double> tile64(tensor, 1.0e-8);
+  BOOST_CHECK_EQUAL(tile8.format(), QuantizedTile<double>::int8);
+  BOOST_CHECK_EQUAL(tile16.format(), QuantizedTile<double>::int16);
+  BOOST_CHECK_EQUAL(tile64.format(), QuantizedTile<double>::raw);
+  BOOST_CHECK_EQUAL(tile8.bytes(), tensor.size());
+  BOOST_CHECK_EQUAL(tile16.bytes(), 2ul * tensor.size());
+
+  // The decoded elements are within the tolerance
+  for(const QuantizedTile<double>* tile : { &tile8, &tile16, &tile64 }) {
+    BOOST_CHECK_EQUAL(tile->range(), range);
+    const TensorD decoded = *tile;
+    for(std::size_t i = 0ul; i < tensor.size(); ++i)
+      BOOST_CHECK_LE(std::abs(decoded[i] - tensor[i]), tile->max_error() + 1.0e-15);
+  }
+  BOOST_CHECK_LE(tile8.max_error(), 1.0e-2);
+  BOOST_CHECK_LE(tile16.max_error(), 1.0e-4);
+  BOOST_CHECK_EQUAL(tile64.max_error(), 0.0);
+
+  // A zero tile is decoded exactly
+  const TensorD zero(range, 0.0);
+  const TensorD zero_decoded = QuantizedTile<double>(zero, 0.0).eval();
+  for(std::size_t i = 0ul; i < zero.size(); ++i)
+    BOOST_CHECK_EQUAL(zero_decoded[i], 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( serialization )
+{
+  const Range range(std::array<std::size_t, 2>{{5, 7}});
+  const TensorD tensor = make_tile(range, 3.0);
+  for(const double tolerance : { 1.0e-1, 1.0e-4, 0.0 }) {
+    const QuantizedTile<double> tile(tensor, tolerance);
+
+    std::size_t buf_size = (tensor.size() + 1024ul) * sizeof(double);
+    unsigned char* buf = new unsigned char[buf_size];
+    madness::archive::BufferOutputArchive oar(buf, buf_size);
+    BOOST_REQUIRE_NO_THROW(oar & tile);
+    std::size_t nbyte = oar.size();
+    oar.close();
+
+    QuantizedTile<double> result;
+    madness::archive::BufferInputArchive iar(buf, nbyte);
+    BOOST_REQUIRE_NO_THROW(iar & result);
+    iar.close();
+    delete [] buf;
+
+    BOOST_CHECK_EQUAL(result.format(), tile.format());
+    BOOST_CHECK_EQUAL(result.scale(), tile.scale());
+    const TensorD x = tile, y = result;
+    BOOST_CHECK_EQUAL(y.range(), x.range());
+    for(std::size_t i = 0ul; i < x.size(); ++i)
+      BOOST_CHECK_EQUAL(y[i], x[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  TArrayD v = make_array<TArrayD>(world, trange,
+      [] (TensorD& tile, const Range& range) {
+        tile = make_tile(range, 2.0);
+      });
+  TArrayD a(world, TiledRange({ trange.data()[1], trange.data()[0] }));
+  a.fill_local(1.0);
+
+  const double tolerance = 1.0e-4;
+  QuantizedArrayD q = quantize(v, tolerance);
+
+  TArrayD quantized_result, result;
+  quantized_result("i,k") = q("i,j") * a("j,k");
+  result("i,k") = v("i,j") * a("j,k");
+  world.gop.fence();
+
+  // Each result element sums 9 elements with an error below the tolerance
+  for(const auto i : *result.pmap()) {
+    const TensorD x = quantized_result.find(i).get();
+    const TensorD y = result.find(i).get();
+    for(std::size_t e = 0ul; e < x.size(); ++e)
+      BOOST_CHECK_LE(std::abs(x[e] - y[e]), 9.0 * tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
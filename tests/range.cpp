@@ -364,4 +364,44 @@ BOOST_AUTO_TEST_CASE( swap )
   BOOST_CHECK_EQUAL(r.volume(), volume);
 }
 
+BOOST_AUTO_TEST_CASE( inline_storage )
+{
+  // Ranges with rank up to TILEDARRAY_RANGE_SMALL_RANK use inline storage,
+  // larger ranges use the heap; copy, move, and swap must work across both.
+  std::vector<std::size_t> small_extent(2, 3ul);
+  std::vector<std::size_t> large_extent(TILEDARRAY_RANGE_SMALL_RANK + 1, 2ul);
+  Range small(small_extent), large(large_extent);
+
+  Range small_copy(small), large_copy(large);
+  BOOST_CHECK_EQUAL(small_copy, small);
+  BOOST_CHECK_EQUAL(large_copy, large);
+  BOOST_CHECK(small_copy.lobound_data() != small.lobound_data());
+
+  Range small_move(std::move(small_copy));
+  BOOST_CHECK_EQUAL(small_move, small);
+  BOOST_CHECK_EQUAL(small_copy.rank(), 0u);
+  BOOST_CHECK(small_copy.lobound_data() == nullptr);
+
+  Range large_move(std::move(large_copy));
+  BOOST_CHECK_EQUAL(large_move, large);
+  BOOST_CHECK_EQUAL(large_copy.rank(), 0u);
+
+  BOOST_CHECK_NO_THROW(small_move.swap(large_move));
+  BOOST_CHECK_EQUAL(small_move, large);
+  BOOST_CHECK_EQUAL(large_move, small);
+
+  small_move = std::move(large_move);
+  BOOST_CHECK_EQUAL(small_move, small);
+  large_move = large;
+  BOOST_CHECK_EQUAL(large_move, large);
+
+  // In-place permutation of a large range
+  std::vector<unsigned int> p(large.rank());
+  for(unsigned int i = 0u; i < p.size(); ++i)
+    p[i] = i;
+  std::swap(p[0], p[1]);
+  Permutation perm(p);
+  BOOST_CHECK_EQUAL(large_move *= perm, perm * large);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,107 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  redistribute.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/conversions/redistribute.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct RedistributeFixture {
+  RedistributeFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8, 12, 13}, TiledRange1{0, 5, 10, 11} })
+  { }
+
+  // Set the local tiles of an array to their ordinal index
+  template <typename Array>
+  static void fill(Array& array) {
+    for(const auto i : *array.pmap())
+      if(! array.is_zero(i))
+        array.set(i, TensorI(array.trange().make_tile_range(i), int(i)));
+  }
+
+  World& world;
+  TiledRange trange;
+}; // RedistributeFixture
+
+BOOST_FIXTURE_TEST_SUITE( redistribute_suite, RedistributeFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TArrayI a(world, trange);
+  fill(a);
+
+  std::shared_ptr<Pmap> pmap =
+      std::make_shared<detail::HashPmap>(world, trange.tiles_range().volume());
+  TArrayI b;
+  BOOST_REQUIRE_NO_THROW(b = redistribute(a, pmap));
+  BOOST_CHECK_EQUAL(b.pmap(), pmap);
+  BOOST_CHECK_EQUAL(b.trange(), trange);
+
+  for(const auto i : *b.pmap()) {
+    const TensorI tile = b.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), trange.make_tile_range(i));
+    for(const auto value : tile)
+      BOOST_CHECK_EQUAL(value, int(i));
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  Tensor<float> norms(trange.tiles_range(), 1.0f);
+  norms(1, 1) = 0.0f;
+  norms(3, 0) = 0.0f;
+  TSpArrayI a(world, trange, SparseShape<float>(norms, trange));
+  fill(a);
+
+  std::shared_ptr<Pmap> pmap =
+      std::make_shared<detail::HashPmap>(world, trange.tiles_range().volume());
+  TSpArrayI b = redistribute(a, pmap);
+  BOOST_CHECK_EQUAL(b.pmap(), pmap);
+
+  for(std::size_t i = 0ul; i < b.size(); ++i)
+    BOOST_CHECK_EQUAL(b.is_zero(i), a.is_zero(i));
+  for(const auto i : *b.pmap()) {
+    if(b.is_zero(i))
+      continue;
+    for(const auto value : b.find(i).get())
+      BOOST_CHECK_EQUAL(value, int(i));
+  }
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( wrong_size )
+{
+  TArrayI a(world, trange);
+  fill(a);
+  std::shared_ptr<Pmap> pmap = std::make_shared<detail::HashPmap>(world, 3ul);
+  BOOST_CHECK_THROW(redistribute(a, pmap), TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -137,6 +137,30 @@ BOOST_AUTO_TEST_CASE( reduce_future )
 
 }
 
+BOOST_AUTO_TEST_CASE( reduce_max_results )
+{
+  for(std::size_t max_results = 1ul; max_results <= 3ul; ++max_results) {
+    ReduceTask<plus<int> > task(world, plus<int>(), nullptr, max_results);
+
+    std::vector<Future<int> > fut_vec;
+    for(int i = 0; i < 100; ++i) {
+      Future<int> f;
+      fut_vec.push_back(f);
+      task.add(f);
+    }
+
+    Future<int> result = task.submit();
+
+    int sum = 0;
+    for(int i = 0; i < 100; ++i) {
+      sum += i;
+      fut_vec[i].set(i);
+    }
+
+    BOOST_CHECK_EQUAL(result.get(), sum);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
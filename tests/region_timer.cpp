@@ -0,0 +1,122 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  region_timer.cpp
+ *  Oct 15, 2026
+ *
+ */
+#include "TiledArray/region_timer.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct RegionTimerFixture {
+
+  RegionTimerFixture() : timer(RegionTimer::instance()) { timer.clear(); }
+
+  ~RegionTimerFixture() { timer.clear(); }
+
+  RegionTimer& timer;
+}; // RegionTimerFixture
+
+BOOST_FIXTURE_TEST_SUITE( region_timer_suite, RegionTimerFixture )
+
+BOOST_AUTO_TEST_CASE( nested )
+{
+  for(int i = 0; i < 2; ++i) {
+    TimedRegion outer("outer");
+    BOOST_CHECK(RegionTimer::active());
+    {
+      TimedRegion inner("inner");
+      timer.add_wait(0.5);
+    }
+    TimedRegion other("other");
+  }
+  BOOST_CHECK(! RegionTimer::active());
+
+  const std::vector<RegionTimer::Times> times = timer.times();
+  BOOST_REQUIRE_EQUAL(times.size(), 3ul);
+  BOOST_CHECK_EQUAL(times[0].path, "outer");
+  BOOST_CHECK_EQUAL(times[1].path, "outer/inner");
+  BOOST_CHECK_EQUAL(times[2].path, "outer/other");
+  for(const RegionTimer::Times& region : times)
+    BOOST_CHECK_EQUAL(region.calls, 2ul);
+
+  // Nested times and waits are included in the enclosing region
+  BOOST_CHECK_GE(times[0].time, times[1].time + times[2].time);
+  BOOST_CHECK_EQUAL(times[0].wait, 1.0);
+  BOOST_CHECK_EQUAL(times[1].wait, 1.0);
+  BOOST_CHECK_EQUAL(times[2].wait, 0.0);
+
+  // Nothing is recorded outside of a region
+  timer.add_wait(1.0);
+  timer.add_expression();
+  BOOST_CHECK_EQUAL(timer.times("outer").wait, 1.0);
+  BOOST_CHECK_EQUAL(timer.times("outer").expressions, 0ul);
+  BOOST_CHECK_EQUAL(timer.times("missing").calls, 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( expressions )
+{
+  World& world = *GlobalFixture::world;
+  TiledRange1 tr1{0, 3, 8, 12};
+  TArrayD a(world, TiledRange({tr1, tr1})), b;
+  a.fill(1.0);
+
+  {
+    TimedRegion region("assign");
+    b("i,j") = a("i,j") + a("i,j");
+    b("i,j") = a("i,k") * b("k,j");
+    region.fence(world);
+  }
+
+  const RegionTimer::Times times = timer.times("assign");
+  BOOST_CHECK_EQUAL(times.expressions, 2ul);
+  BOOST_CHECK_GE(times.wait, 0.0);
+  BOOST_CHECK_LE(times.wait, times.time);
+}
+
+BOOST_AUTO_TEST_CASE( report )
+{
+  World& world = *GlobalFixture::world;
+  {
+    TimedRegion region("report");
+    TimedRegion inner("inner");
+  }
+
+  const std::vector<RegionTimes> times = region_times(world);
+  BOOST_REQUIRE_EQUAL(times.size(), 2ul);
+  BOOST_CHECK_EQUAL(times[0].path, "report");
+  BOOST_CHECK_EQUAL(times[0].depth, 0u);
+  BOOST_CHECK_EQUAL(times[1].path, "report/inner");
+  BOOST_CHECK_EQUAL(times[1].depth, 1u);
+  BOOST_CHECK_EQUAL(times[0].calls, 1ul);
+  BOOST_CHECK_LE(times[0].min, times[0].avg);
+  BOOST_CHECK_LE(times[0].avg, times[0].max);
+
+  std::stringstream ss;
+  BOOST_REQUIRE_NO_THROW(print_region_times(world, ss));
+  if(world.rank() == 0)
+    BOOST_CHECK(ss.str().find("inner") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
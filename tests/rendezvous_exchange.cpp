@@ -0,0 +1,114 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  rendezvous_exchange.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/rendezvous_exchange.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using TiledArray::detail::RendezvousHandle;
+
+struct RendezvousExchangeFixture {
+  typedef TiledArray::Tensor<double> TensorD;
+
+  RendezvousExchangeFixture() : world(*GlobalFixture::world) { }
+
+  ~RendezvousExchangeFixture() {
+    TiledArray::RendezvousExchange::instance().disable();
+    world.gop.fence();
+  }
+
+  static TensorD make_tile(const std::size_t n) {
+    TensorD tile(TiledArray::Range(std::vector<std::size_t>{ n }));
+    for(std::size_t i = 0ul; i < n; ++i)
+      tile[i] = double(i) / 3.0;
+    return tile;
+  }
+
+  static void check(const TensorD& expected, const TensorD& result) {
+    BOOST_CHECK_EQUAL(result.range(), expected.range());
+    for(std::size_t i = 0ul; i < expected.size(); ++i)
+      BOOST_CHECK_EQUAL(result[i], expected[i]);
+  }
+
+  madness::World& world;
+}; // RendezvousExchangeFixture
+
+BOOST_FIXTURE_TEST_SUITE( rendezvous_exchange_suite, RendezvousExchangeFixture )
+
+BOOST_AUTO_TEST_CASE( small_tile )
+{
+  const TensorD tile = make_tile(10ul);
+
+  // Check that small tiles are held by the handle
+  RendezvousHandle handle;
+  BOOST_REQUIRE_NO_THROW(handle = TiledArray::detail::rendezvous_send(& world,
+      tile, world.rank()));
+  BOOST_CHECK_LT(handle.tag, 0);
+  BOOST_CHECK_EQUAL(handle.data.size(), handle.size);
+
+  check(tile, TiledArray::detail::rendezvous_recv<TensorD>(& world, handle,
+      world.rank()));
+}
+
+BOOST_AUTO_TEST_CASE( large_tile )
+{
+  const TensorD tile =
+      make_tile(TILEDARRAY_RENDEZVOUS_THRESHOLD / sizeof(double) + 17ul);
+
+  // Check that the elements of large tiles are sent separately
+  RendezvousHandle handle;
+  BOOST_REQUIRE_NO_THROW(handle = TiledArray::detail::rendezvous_send(& world,
+      tile, world.rank()));
+  BOOST_CHECK_GE(handle.tag, 0);
+  BOOST_CHECK_EQUAL(handle.size, tile.size() * sizeof(double));
+  BOOST_CHECK_LT(handle.data.size(), handle.size);
+
+  check(tile, TiledArray::detail::rendezvous_recv<TensorD>(& world, handle,
+      world.rank()));
+}
+
+BOOST_AUTO_TEST_CASE( remote_get )
+{
+  TiledArray::RendezvousExchange::instance().enable();
+
+  // Use tiles that are larger than the rendezvous threshold
+  const std::size_t n = TILEDARRAY_RENDEZVOUS_THRESHOLD / sizeof(double) + 1ul;
+  TiledArray::TiledRange1 tr1{ 0ul, n, 2ul * n, 3ul * n };
+  TiledArray::TiledRange tr({ tr1 });
+  TiledArray::TArrayD a(world, tr);
+  for(auto it = a.begin(); it != a.end(); ++it)
+    *it = TensorD(a.trange().make_tile_range(it.ordinal()), double(world.rank()));
+  world.gop.fence();
+
+  for(std::size_t i = 0ul; i < a.size(); ++i) {
+    const TensorD tile = a.find(i).get();
+    BOOST_CHECK_EQUAL(tile.range(), a.trange().make_tile_range(i));
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_EQUAL(tile[j], double(a.owner(i)));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
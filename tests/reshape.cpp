@@ -0,0 +1,145 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  reshape.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/conversions/reshape.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct ReshapeFixture {
+  ReshapeFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 2, 6}, TiledRange1{0, 3}, TiledRange1{0, 1, 4},
+        TiledRange1{0, 2} }),
+    fused_trange({ TiledRange1{0, 6, 18}, TiledRange1{0, 2, 8} })
+  { }
+
+  static int value(const std::size_t a, const std::size_t b,
+      const std::size_t i, const std::size_t j)
+  { return int(a * 1000ul + b * 100ul + i * 10ul + j); }
+
+  // Set the tiles of a 4-d array with value(a,b,i,j)
+  template <typename Array>
+  static void fill(Array& array) {
+    for(const auto t : *array.pmap()) {
+      if(array.is_zero(t))
+        continue;
+      TensorI tile(array.trange().make_tile_range(t));
+      for(const auto& index : tile.range())
+        tile[index] = value(index[0], index[1], index[2], index[3]);
+      array.set(t, tile);
+    }
+  }
+
+  World& world;
+  TiledRange trange;
+  TiledRange fused_trange;
+}; // ReshapeFixture
+
+BOOST_FIXTURE_TEST_SUITE( reshape_suite, ReshapeFixture )
+
+BOOST_AUTO_TEST_CASE( compatible )
+{
+  BOOST_CHECK(detail::is_reshape_compatible(trange, fused_trange));
+  BOOST_CHECK(detail::is_reshape_compatible(fused_trange, trange));
+  BOOST_CHECK(detail::is_reshape_compatible(trange, trange));
+
+  // Fuse all dimensions into one
+  BOOST_CHECK(! detail::is_reshape_compatible(trange,
+      TiledRange({ TiledRange1{0, 48, 144} })));
+
+  // Fused dimensions that do not map onto the tiles
+  BOOST_CHECK(! detail::is_reshape_compatible(trange,
+      TiledRange({ TiledRange1{0, 3, 18}, TiledRange1{0, 2, 8} })));
+  BOOST_CHECK(! detail::is_reshape_compatible(fused_trange,
+      TiledRange({ TiledRange1{0, 2, 6}, TiledRange1{0, 1, 3}, TiledRange1{0, 1, 4},
+          TiledRange1{0, 2} })));
+
+  // Extents that cannot be fused
+  BOOST_CHECK(! detail::is_reshape_compatible(trange,
+      TiledRange({ TiledRange1{0, 6, 18}, TiledRange1{0, 2, 9} })));
+}
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TArrayI a(world, trange);
+  fill(a);
+
+  TArrayI b;
+  BOOST_REQUIRE_NO_THROW(b = reshape(a, fused_trange));
+  BOOST_CHECK_EQUAL(b.trange(), fused_trange);
+  BOOST_CHECK_EQUAL(b.pmap(), a.pmap());
+
+  for(const auto t : *b.pmap()) {
+    const TensorI tile = b.find(t).get();
+    const TensorI source = a.find(t).get();
+    BOOST_CHECK_EQUAL(tile.range(), fused_trange.make_tile_range(t));
+
+    // The data is shared with the source tile
+    BOOST_CHECK_EQUAL(tile.data(), source.data());
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], value(index[0] / 3ul, index[0] % 3ul,
+          index[1] / 2ul, index[1] % 2ul));
+  }
+
+  // Split the fused dimensions
+  TArrayI c = reshape(b, trange);
+  BOOST_CHECK_EQUAL(c.trange(), trange);
+  for(const auto t : *c.pmap()) {
+    const TensorI tile = c.find(t).get();
+    BOOST_CHECK_EQUAL(tile.range(), trange.make_tile_range(t));
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], value(index[0], index[1], index[2], index[3]));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  // Zero tile (1,0,0,0)
+  Tensor<float> norms(trange.tiles_range(), 1.0f);
+  norms[trange.tiles_range().ordinal(std::vector<std::size_t>{1, 0, 0, 0})] = 0.0f;
+  TSpArrayI a(world, trange, SparseShape<float>(norms, trange));
+  fill(a);
+
+  TSpArrayI b = reshape(a, fused_trange);
+  BOOST_CHECK_EQUAL(b.trange(), fused_trange);
+  BOOST_CHECK(b.is_zero(std::vector<std::size_t>{1, 0}));
+  BOOST_CHECK(! b.is_zero(std::vector<std::size_t>{1, 1}));
+  for(std::size_t t = 0ul; t < fused_trange.tiles_range().volume(); ++t)
+    BOOST_CHECK_EQUAL(b.is_zero(t), a.is_zero(t));
+}
+
+BOOST_AUTO_TEST_CASE( incompatible )
+{
+  TArrayI a(world, trange);
+  fill(a);
+  TiledRange other({ TiledRange1{0, 3, 18}, TiledRange1{0, 2, 8} });
+  BOOST_CHECK_THROW(reshape(a, other), TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
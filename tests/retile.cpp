@@ -0,0 +1,173 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  retile.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/conversions/retile.h"
+#include "TiledArray/tile_size_advisor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct RetileFixture {
+  RetileFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8, 12}, TiledRange1{0, 5, 10} }),
+    new_trange({ TiledRange1{0, 2, 4, 6, 9, 12}, TiledRange1{0, 4, 7, 10} })
+  { }
+
+  static int value(const std::size_t i, const std::size_t j) { return int(i * 100ul + j); }
+
+  // Set the tiles of an array with value(i,j)
+  template <typename Array>
+  static void fill(Array& array) {
+    for(const auto i : *array.pmap()) {
+      if(array.is_zero(i))
+        continue;
+      TensorI tile(array.trange().make_tile_range(i));
+      for(const auto& index : tile.range())
+        tile[index] = value(index[0], index[1]);
+      array.set(i, tile);
+    }
+  }
+
+  // Check the local tiles of an array, where the elements of zero tiles of
+  // the source are zero
+  template <typename Array>
+  static void check(const Array& array, const Array& source) {
+    for(const auto i : *array.pmap()) {
+      if(array.is_zero(i))
+        continue;
+      const TensorI tile = array.find(i).get();
+      for(const auto& index : tile.range()) {
+        const bool zero = source.is_zero(source.trange().element_to_tile(index));
+        BOOST_CHECK_EQUAL(tile[index], (zero ? 0 : value(index[0], index[1])));
+      }
+    }
+  }
+
+  World& world;
+  TiledRange trange;
+  TiledRange new_trange;
+}; // RetileFixture
+
+BOOST_FIXTURE_TEST_SUITE( retile_suite, RetileFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TArrayI a(world, trange);
+  fill(a);
+
+  TArrayI b;
+  BOOST_REQUIRE_NO_THROW(b = retile(a, new_trange));
+  BOOST_CHECK_EQUAL(b.trange(), new_trange);
+  check(b, a);
+
+  // Retile back to the original tiling
+  TArrayI c = retile(b, trange);
+  BOOST_CHECK_EQUAL(c.trange(), trange);
+  check(c, a);
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  // Zero tiles (0,1) and (2,0)
+  Tensor<float> norms(trange.tiles_range(), 1.0f);
+  norms(0, 1) = 0.0f;
+  norms(2, 0) = 0.0f;
+  TSpArrayI a(world, trange, SparseShape<float>(norms, trange));
+  fill(a);
+
+  TSpArrayI b = retile(a, new_trange);
+  BOOST_CHECK_EQUAL(b.trange(), new_trange);
+
+  // New tiles that are inside zero tiles of a are zero
+  BOOST_CHECK(b.is_zero(new_trange.tiles_range().ordinal(std::vector<std::size_t>{0, 2})));
+  BOOST_CHECK(b.is_zero(new_trange.tiles_range().ordinal(std::vector<std::size_t>{4, 0})));
+  BOOST_CHECK(! b.is_zero(new_trange.tiles_range().ordinal(std::vector<std::size_t>{0, 1})));
+  check(b, a);
+}
+
+BOOST_AUTO_TEST_CASE( mismatched_range )
+{
+  TArrayI a(world, trange);
+  fill(a);
+  TiledRange other({ TiledRange1{0, 3, 8}, TiledRange1{0, 5, 10} });
+  BOOST_CHECK_THROW(retile(a, other), TiledArray::Exception);
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( tile_size )
+{
+  TilingModel model;
+  model.flops = 1.0e10;
+  model.overhead = 1.0e-5;
+
+  // The smallest efficient size satisfies the target efficiency
+  const std::size_t b = model.min_block_size();
+  BOOST_CHECK_GE(model.block_efficiency(b), model.efficiency);
+  BOOST_CHECK_LT(model.block_efficiency(b - 1ul), model.efficiency);
+
+  // More processes and lower density give smaller tiles
+  const std::size_t one = advise_tile_size(100000ul, 1ul, 1.0, model);
+  const std::size_t many = advise_tile_size(100000ul, 1024ul, 1.0, model);
+  const std::size_t sparse = advise_tile_size(100000ul, 1024ul, 0.1, model);
+  BOOST_CHECK_EQUAL(one, model.max_block_size);
+  BOOST_CHECK_LE(many, one);
+  BOOST_CHECK_LE(sparse, many);
+  BOOST_CHECK_GE(sparse, b);
+
+  // Tiles are never larger than the dimension
+  BOOST_CHECK_EQUAL(advise_tile_size(10ul, 1ul, 1.0, model), 10ul);
+}
+
+BOOST_AUTO_TEST_CASE( tiling )
+{
+  TilingModel model;
+  model.max_block_size = 100ul;
+  model.overhead = 0.0;
+
+  // Uniform tiles
+  const TiledRange1 uniform = advise_tiling(0ul, 1000ul, 1ul, 1.0, model);
+  BOOST_CHECK_EQUAL(uniform.tile_extent(), 10ul);
+  BOOST_CHECK_EQUAL(uniform.elements_range().second, 1000ul);
+
+  // Tiles that follow a structure with blocks of 30 elements
+  std::vector<std::size_t> blocks;
+  for(std::size_t i = 0ul; i <= 990ul; i += 30ul)
+    blocks.push_back(i);
+  blocks.push_back(1000ul);
+  const TiledRange1 structure(blocks.begin(), blocks.end());
+  const TiledRange1 tiling = advise_tiling(structure, 1ul, 1.0, model);
+  BOOST_CHECK_EQUAL(tiling.elements_range().first, 0ul);
+  BOOST_CHECK_EQUAL(tiling.elements_range().second, 1000ul);
+  for(const auto& tile : tiling) {
+    BOOST_CHECK(std::find(blocks.begin(), blocks.end(), tile.first) != blocks.end());
+    BOOST_CHECK_GE(tile.second - tile.first, 90ul);
+    BOOST_CHECK_LE(tile.second - tile.first, 100ul);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
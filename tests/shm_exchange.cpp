@@ -0,0 +1,88 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  shm_exchange.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+#include "TiledArray/shm_exchange.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using TiledArray::detail::ShmHandle;
+
+struct ShmExchangeFixture {
+
+  ShmExchangeFixture() { }
+
+  ~ShmExchangeFixture() { }
+
+  static TiledArray::Tensor<double> make_tile(const std::size_t n) {
+    TiledArray::Tensor<double> tile(TiledArray::Range(std::vector<std::size_t>{ n }));
+    for(std::size_t i = 0ul; i < n; ++i)
+      tile[i] = double(i) / 3.0;
+    return tile;
+  }
+
+  static void check(const TiledArray::Tensor<double>& expected,
+      const TiledArray::Tensor<double>& result)
+  {
+    BOOST_CHECK_EQUAL(result.range(), expected.range());
+    for(std::size_t i = 0ul; i < expected.size(); ++i)
+      BOOST_CHECK_EQUAL(result[i], expected[i]);
+  }
+
+}; // ShmExchangeFixture
+
+BOOST_FIXTURE_TEST_SUITE( shm_exchange_suite, ShmExchangeFixture )
+
+BOOST_AUTO_TEST_CASE( small_tile )
+{
+  const TiledArray::Tensor<double> tile = make_tile(10ul);
+
+  // Check that small tiles are held by the handle
+  ShmHandle handle;
+  BOOST_REQUIRE_NO_THROW(handle = TiledArray::detail::shm_write(tile, 1));
+  BOOST_CHECK(handle.name.empty());
+  BOOST_CHECK_EQUAL(handle.data.size(), handle.size);
+
+  check(tile, TiledArray::detail::shm_read<TiledArray::Tensor<double> >(handle));
+}
+
+BOOST_AUTO_TEST_CASE( large_tile )
+{
+  const TiledArray::Tensor<double> tile =
+      make_tile(TILEDARRAY_SHM_EXCHANGE_THRESHOLD / sizeof(double) + 17ul);
+
+  // Check that large tiles are held in shared memory
+  ShmHandle handle;
+  BOOST_REQUIRE_NO_THROW(handle = TiledArray::detail::shm_write(tile, 2));
+  BOOST_CHECK(! handle.name.empty());
+  BOOST_CHECK(handle.data.empty());
+
+  // Check that the segment is removed after the last read
+  check(tile, TiledArray::detail::shm_read<TiledArray::Tensor<double> >(handle));
+  check(tile, TiledArray::detail::shm_read<TiledArray::Tensor<double> >(handle));
+  BOOST_CHECK_THROW(TiledArray::detail::shm_read<TiledArray::Tensor<double> >(handle),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
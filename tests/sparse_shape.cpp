@@ -207,6 +207,32 @@ BOOST_AUTO_TEST_CASE( comm_constructor )
 }
 
 
+BOOST_AUTO_TEST_CASE( sparse_allreduce )
+{
+  World& world = *GlobalFixture::world;
+  const std::size_t n = 1000ul;
+
+  // Each process contributes a few non-zero elements, so only the non-zero
+  // elements are exchanged
+  std::vector<float> data(n, 0.0f);
+  for(std::size_t i = world.rank(); i < n; i += 97ul)
+    data[i] = float(i + 1ul);
+  BOOST_REQUIRE_NO_THROW(TiledArray::detail::sparse_allreduce(world, data.data(), n));
+  for(std::size_t i = 0ul; i < n; ++i) {
+    float expected = 0.0f;
+    for(ProcessID p = 0; p < world.size(); ++p)
+      if((i >= std::size_t(p)) && (((i - p) % 97ul) == 0ul))
+        expected += float(i + 1ul);
+    BOOST_CHECK_EQUAL(data[i], expected);
+  }
+
+  // All elements are non-zero, so the buffer is summed directly
+  std::fill(data.begin(), data.end(), 1.0f);
+  BOOST_REQUIRE_NO_THROW(TiledArray::detail::sparse_allreduce(world, data.data(), n));
+  for(std::size_t i = 0ul; i < n; ++i)
+    BOOST_CHECK_EQUAL(data[i], float(world.size()));
+}
+
 BOOST_AUTO_TEST_CASE( copy_constructor )
 {
   // Construct the shape
@@ -1240,4 +1266,241 @@ BOOST_AUTO_TEST_CASE( gemm_perm )
   BOOST_CHECK_CLOSE(result.sparsity(), float(zero_tile_count) / float(result_norms.size()), tolerance);
 }
 
+BOOST_AUTO_TEST_CASE( split_norm )
+{
+  Tensor<float> tile(Range(std::array<int, 2>{{2, 2}}), 0.0f);
+  tile[0] = 3.0f;
+  tile[3] = 4.0f;
+
+  // For a diagonal matrix the split norm is the spectral norm
+  BOOST_CHECK_CLOSE(SparseShape<float>::split_norm(tile, 1u), 4.0f, tolerance);
+
+  // A row vector is limited by the Frobenius norm
+  BOOST_CHECK_CLOSE(SparseShape<float>::split_norm(tile, 0u), 5.0f, tolerance);
+  BOOST_CHECK_CLOSE(SparseShape<float>::split_norm(tile, 2u), 5.0f, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE( gemm_split_norms )
+{
+  // Construct shapes with split norms that are half of the tile norms
+  const Tensor<float> left_norms = make_norm_tensor(tr, 0.1, 23);
+  const Tensor<float> right_norms = make_norm_tensor(tr, 0.1, 82);
+  const std::vector<Tensor<float> > left_split_norms(GlobalFixture::dim - 1u,
+      left_norms.scale(0.5f));
+  const std::vector<Tensor<float> > right_split_norms(GlobalFixture::dim - 1u,
+      right_norms.scale(0.5f));
+  const SparseShape<float> x(left_norms, left_split_norms, tr);
+  const SparseShape<float> y(right_norms, right_split_norms, tr);
+  BOOST_CHECK(x.has_split_norms());
+  BOOST_CHECK(! left.has_split_norms());
+  BOOST_CHECK_EQUAL(x.split_norms(0u).data(), x.data().data());
+  for(std::size_t i = 0ul; i < x.data().size(); ++i)
+    BOOST_CHECK_CLOSE(x.split_norms(1u)[i], x[i] * 0.5f, tolerance);
+
+  // Scaled shapes keep the split norms
+  const SparseShape<float> z = x.scale(-2.0f);
+  BOOST_CHECK(z.has_split_norms());
+  for(std::size_t i = 0ul; i < z.data().size(); ++i)
+    BOOST_CHECK_CLOSE(z.split_norms(1u)[i], z[i] * 0.5f, tolerance);
+
+  // Evaluate the contraction of sparse shapes with and without split norms
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = x.gemm(y, -7.2, gemm_helper));
+  const SparseShape<float> reference = left.gemm(right, -7.2, gemm_helper);
+  BOOST_CHECK(result.has_split_norms());
+  BOOST_CHECK(! reference.has_split_norms());
+
+  // The Frobenius norm bound is halved, and the spectral norm bound of the
+  // result is a quarter of the reference bound.
+  const float threshold = SparseShape<float>::threshold();
+  for(std::size_t i = 0ul; i < result.data().size(); ++i) {
+    const float expected = reference[i] * 0.5f;
+    if(expected < threshold) {
+      BOOST_CHECK(result.is_zero(i));
+      BOOST_CHECK_EQUAL(result.split_norms(1u)[i], 0.0f);
+    } else {
+      BOOST_CHECK_CLOSE(result[i], expected, 0.01f);
+      BOOST_CHECK_CLOSE(result.split_norms(1u)[i], reference[i] * 0.25f, 0.01f);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( gemm_cooperative )
+{
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  const Permutation perm({1, 0});
+
+  // The cooperative contraction gives the same shape on all processes
+  SparseShape<float> result, result_perm;
+  BOOST_REQUIRE_NO_THROW(result = left.gemm(*GlobalFixture::world, right,
+      -7.2, gemm_helper));
+  BOOST_REQUIRE_NO_THROW(result_perm = left.gemm(*GlobalFixture::world, right,
+      -7.2, gemm_helper, perm));
+  const SparseShape<float> reference = left.gemm(right, -7.2, gemm_helper);
+  const SparseShape<float> reference_perm = left.gemm(right, -7.2, gemm_helper, perm);
+
+  BOOST_CHECK_EQUAL(result.data().range(), reference.data().range());
+  BOOST_CHECK_EQUAL(result.sparsity(), reference.sparsity());
+  for(std::size_t i = 0ul; i < result.data().size(); ++i) {
+    BOOST_CHECK_CLOSE(result[i], reference[i], tolerance);
+    BOOST_CHECK_CLOSE(result_perm[i], reference_perm[i], tolerance);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( zero_threshold )
+{
+  const float loose = 50.0f;
+  BOOST_CHECK_EQUAL(left.zero_threshold(), SparseShapeFixture::zero_threshold());
+
+  // Construct a shape with a looser threshold than the default
+  SparseShape<float> x;
+  BOOST_REQUIRE_NO_THROW(x = SparseShape<float>(make_norm_tensor(tr, 0.1, 23),
+      tr, loose));
+  BOOST_CHECK_EQUAL(x.zero_threshold(), loose);
+  BOOST_CHECK_EQUAL(SparseShape<float>::threshold(),
+      SparseShapeFixture::zero_threshold());
+
+  // Check that the threshold of the shape is used for zero tiles
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+    if(left[i] < loose) {
+      BOOST_CHECK_EQUAL(x[i], 0.0f);
+      BOOST_CHECK(x.is_zero(i));
+    } else {
+      BOOST_CHECK_CLOSE(x[i], left[i], tolerance);
+      BOOST_CHECK(! x.is_zero(i));
+    }
+  }
+
+  // Check that the copy with a new threshold is the same shape
+  SparseShape<float> y;
+  BOOST_REQUIRE_NO_THROW(y = left.with_threshold(loose));
+  BOOST_CHECK_EQUAL(y.zero_threshold(), loose);
+  BOOST_CHECK_EQUAL(y.sparsity(), x.sparsity());
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i)
+    BOOST_CHECK_EQUAL(y[i], x[i]);
+
+  // Check that the results of operations use the looser threshold
+  BOOST_CHECK_EQUAL(x.perm(perm).zero_threshold(), loose);
+  BOOST_CHECK_EQUAL(x.scale(-2.0).zero_threshold(), loose);
+  BOOST_CHECK_EQUAL(left.add(x).zero_threshold(), loose);
+  BOOST_CHECK_EQUAL(x.add(left, perm).zero_threshold(), loose);
+  BOOST_CHECK_EQUAL(left.mult(x).zero_threshold(), loose);
+  BOOST_CHECK_EQUAL(left.mask(x).zero_threshold(), left.zero_threshold());
+
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = left.add(x));
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+    const float expected = left[i] + x[i];
+    if(expected < loose) {
+      BOOST_CHECK(result.is_zero(i));
+    } else {
+      BOOST_CHECK_CLOSE(result[i], expected, tolerance);
+      BOOST_CHECK(! result.is_zero(i));
+    }
+  }
+
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, left.data().range().rank(), right.data().range().rank());
+  BOOST_REQUIRE_NO_THROW(result = right.gemm(x, 1, gemm_helper));
+  BOOST_CHECK_EQUAL(result.zero_threshold(), loose);
+  for(std::size_t i = 0ul; i < result.data().size(); ++i)
+    BOOST_CHECK_EQUAL(result.is_zero(i), result[i] < loose);
+}
+
+BOOST_AUTO_TEST_CASE( screen )
+{
+  // Compute the estimated Frobenius norm of the shape
+  float squared_norm = 0.0f;
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+    const float norm = left[i] * tr.make_tile_range(i).volume();
+    squared_norm += norm * norm;
+  }
+  const float error = 0.1f * std::sqrt(squared_norm);
+
+  SparseShape<float> result;
+  BOOST_REQUIRE_NO_THROW(result = left.screen(error));
+  BOOST_CHECK_EQUAL(result.zero_threshold(), left.zero_threshold());
+  BOOST_CHECK_GT(result.sparsity(), left.sparsity());
+
+  // Check that the smallest tiles are dropped within the error budget
+  float squared_error = 0.0f;
+  float min_kept = std::numeric_limits<float>::max();
+  float max_dropped = 0.0f;
+  for(Tensor<float>::size_type i = 0ul; i < tr.tiles_range().volume(); ++i) {
+    if(result.is_zero(i)) {
+      BOOST_CHECK_EQUAL(result[i], 0.0f);
+      if(! left.is_zero(i)) {
+        const float norm = left[i] * tr.make_tile_range(i).volume();
+        squared_error += norm * norm;
+        max_dropped = std::max(max_dropped, left[i]);
+      }
+    } else {
+      BOOST_CHECK_EQUAL(result[i], left[i]);
+      min_kept = std::min(min_kept, left[i]);
+    }
+  }
+  BOOST_CHECK_LE(std::sqrt(squared_error), error * 1.0001f);
+  BOOST_CHECK_LT(max_dropped, min_kept);
+
+  // Check that a zero error budget does not change the shape
+  BOOST_REQUIRE_NO_THROW(result = left.screen(0.0f));
+  BOOST_CHECK_EQUAL(result.sparsity(), left.sparsity());
+}
+
+BOOST_AUTO_TEST_CASE( serialization )
+{
+  madness::archive::BufferOutputArchive count_ar;
+  count_ar & sparse_shape;
+  std::vector<unsigned char> buf(count_ar.size());
+  madness::archive::BufferOutputArchive oar(buf.data(), buf.size());
+  BOOST_REQUIRE_NO_THROW(oar & sparse_shape);
+  oar.close();
+
+  SparseShape<float> result;
+  madness::archive::BufferInputArchive iar(buf.data(), buf.size());
+  BOOST_REQUIRE_NO_THROW(iar & result);
+  iar.close();
+
+  BOOST_CHECK_EQUAL(result.zero_threshold(), sparse_shape.zero_threshold());
+  BOOST_CHECK_EQUAL(result.sparsity(), sparse_shape.sparsity());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.data().begin(), result.data().end(),
+      sparse_shape.data().begin(), sparse_shape.data().end());
+
+  // Check the tile sizes, which are used by the addition of a constant
+  const SparseShape<float> x = result.add(1.0f), y = sparse_shape.add(1.0f);
+  BOOST_CHECK_EQUAL_COLLECTIONS(x.data().begin(), x.data().end(),
+      y.data().begin(), y.data().end());
+}
+
+BOOST_AUTO_TEST_CASE( load_constructor )
+{
+  const SparseShape<float> shape = sparse_shape.with_threshold(0.25f);
+  madness::archive::BufferOutputArchive count_ar;
+  count_ar & shape;
+  std::vector<unsigned char> buf(count_ar.size());
+  madness::archive::BufferOutputArchive oar(buf.data(), buf.size());
+  oar & shape;
+  oar.close();
+
+  // The shape is loaded with its threshold
+  {
+    madness::archive::BufferInputArchive iar(buf.data(), buf.size());
+    BOOST_REQUIRE_NO_THROW(SparseShape<float> result(tr, iar));
+  }
+  madness::archive::BufferInputArchive iar(buf.data(), buf.size());
+  SparseShape<float> result(tr, iar);
+  BOOST_CHECK_EQUAL(result.zero_threshold(), 0.25f);
+  BOOST_CHECK_EQUAL(result.sparsity(), shape.sparsity());
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.data().begin(), result.data().end(),
+      shape.data().begin(), shape.data().end());
+
+  // A shape with a different tiled range is rejected
+  const TiledRange other_tr{ TiledRange1{ 0, 10 } };
+  madness::archive::BufferInputArchive bad_iar(buf.data(), buf.size());
+  BOOST_CHECK_THROW(SparseShape<float>(other_tr, bad_iar), TiledArray::Exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -44,11 +44,14 @@ namespace TiledArray {
       tolerance(0.0001)
 
     {
-      SparseShape<float>::threshold(0.001);
+      SparseShape<float>::threshold(zero_threshold());
     }
 
     ~SparseShapeFixture() { }
 
+    // The zero threshold of the fixture shapes
+    static float zero_threshold() { return 0.001f; }
+
 
     static Tensor<float> make_norm_tensor(const TiledRange& trange, const float fill_percent, const int seed) {
       GlobalFixture::world->srand(seed);
@@ -69,7 +72,7 @@ namespace TiledArray {
 
     static SparseShape<float> make_shape(const TiledRange& trange, const float fill_percent, const int seed) {
       Tensor<float> tile_norms = make_norm_tensor(trange, fill_percent, seed);
-      return SparseShape<float>(tile_norms, trange);
+      return SparseShape<float>(tile_norms, trange, zero_threshold());
     }
 
     static Permutation make_perm() {
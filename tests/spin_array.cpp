@@ -0,0 +1,135 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  spin_array.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/spin_array.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct SpinArrayFixture {
+
+  SpinArrayFixture() :
+    world(*GlobalFixture::world),
+    trange({TiledRange1{0, 2, 5, 6}, TiledRange1{0, 3, 6}})
+  {
+    a.set_block("ab", make_array(1));
+    a.set_block("bb", make_array(2));
+    b.set_block("ab", make_array(3));
+    b.set_block("bb", make_array(4));
+  }
+
+  TSpArrayI make_array(const int seed) {
+    Tensor<float> norms(trange.tiles_range(), 1.0f);
+    TSpArrayI result(world, trange, SparseShape<float>(norms, trange));
+    result.init_tiles([seed] (const Range& range) -> TensorI {
+      TensorI tile(range);
+      for(const auto& i : range)
+        tile[i] = seed * int(i[0] + 1) - int(i[1]);
+      return tile;
+    });
+    return result;
+  }
+
+  static void check_array(const TSpArrayI& expected, const TSpArrayI& result) {
+    for(std::size_t i = 0ul; i < expected.size(); ++i) {
+      if(! expected.is_local(i))
+        continue;
+      const TensorI expected_tile = expected.find(i).get();
+      const TensorI result_tile = result.find(i).get();
+      BOOST_CHECK_EQUAL(result_tile.range(), expected_tile.range());
+      for(std::size_t j = 0ul; j < expected_tile.size(); ++j)
+        BOOST_CHECK_EQUAL(result_tile[j], expected_tile[j]);
+    }
+  }
+
+  World& world;
+  TiledRange trange;
+  SpinArray<TensorI> a;
+  SpinArray<TensorI> b;
+}; // SpinArrayFixture
+
+BOOST_FIXTURE_TEST_SUITE( spin_array_suite, SpinArrayFixture )
+
+BOOST_AUTO_TEST_CASE( spins )
+{
+  BOOST_CHECK_EQUAL(SpinArray<TensorI>::spins("p1a,p2b,h1a,h2b"), "abab");
+  BOOST_CHECK_EQUAL(SpinArray<TensorI>::spins(" ia , jb "), "ab");
+  BOOST_CHECK_EQUAL(SpinArray<TensorI>::spins("ib"), "b");
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(SpinArray<TensorI>::spins("i,j"), Exception);
+  BOOST_CHECK_THROW(SpinArray<TensorI>::spins("ia,"), Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( blocks )
+{
+  BOOST_CHECK_EQUAL(a.size(), 2ul);
+  BOOST_CHECK(a.has_block("ab"));
+  BOOST_CHECK(! a.has_block("aa"));
+#ifdef TA_EXCEPTION_ERROR
+  const SpinArray<TensorI>& ca = a;
+  BOOST_CHECK_THROW(ca.block("aa"), Exception);
+#endif // TA_EXCEPTION_ERROR
+
+  // Blocks share the data of the arrays they are set to
+  SpinArray<TensorI> c;
+  c.set_block("aa", a.block("bb"));
+  c.set_block("bb", c.block("aa"));
+  BOOST_CHECK(c.block("bb").id() == a.block("bb").id());
+}
+
+BOOST_AUTO_TEST_CASE( expressions )
+{
+  SpinArray<TensorI> r;
+  BOOST_REQUIRE_NO_THROW(r.assign_blocks([&] () {
+    r("ia,jb") = a("ia,jb") + 2 * b("ia,jb");
+    r("ib,jb") = a("ib,jb") - b("ib,jb");
+  }));
+  world.gop.fence();
+
+  BOOST_CHECK_EQUAL(r.size(), 2ul);
+
+  TSpArrayI expected_ab;
+  expected_ab("i,j") = a.block("ab")("i,j") + 2 * b.block("ab")("i,j");
+  check_array(expected_ab, r.block("ab"));
+
+  TSpArrayI expected_bb;
+  expected_bb("i,j") = a.block("bb")("i,j") - b.block("bb")("i,j");
+  check_array(expected_bb, r.block("bb"));
+}
+
+BOOST_AUTO_TEST_CASE( for_each_block )
+{
+  std::string spins;
+  a.for_each_block([&] (const std::string& s, TSpArrayI& block) {
+    spins += s;
+    BOOST_CHECK(block.is_initialized());
+  });
+  BOOST_CHECK_EQUAL(spins, "abbb");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
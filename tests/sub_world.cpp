@@ -0,0 +1,162 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  sub_world.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/sub_world.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct SubWorldFixture {
+  SubWorldFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8, 12, 13}, TiledRange1{0, 5, 10, 11} })
+  { }
+
+  // Set the local tiles of an array to their ordinal index
+  template <typename Array>
+  static void fill(Array& array) {
+    for(const auto i : *array.pmap())
+      if(! array.is_zero(i))
+        array.set(i, TensorI(array.trange().make_tile_range(i), int(i)));
+  }
+
+  // Check that the local tiles of an array are their ordinal index times factor
+  template <typename Array>
+  static void check(const Array& array, const int factor) {
+    for(const auto i : *array.pmap()) {
+      if(array.is_zero(i))
+        continue;
+      const TensorI tile = array.find(i).get();
+      BOOST_CHECK_EQUAL(tile.range(), array.trange().make_tile_range(i));
+      for(const auto value : tile)
+        BOOST_CHECK_EQUAL(value, int(i) * factor);
+    }
+  }
+
+  World& world;
+  TiledRange trange;
+}; // SubWorldFixture
+
+BOOST_FIXTURE_TEST_SUITE( sub_world_suite, SubWorldFixture )
+
+BOOST_AUTO_TEST_CASE( split )
+{
+  const std::size_t groups = std::min<std::size_t>(2ul, world.size());
+  SubWorld sub(world, groups);
+  BOOST_CHECK_EQUAL(sub.groups(), groups);
+  BOOST_CHECK_EQUAL(& sub.parent(), & world);
+
+  ProcessID procs = 0;
+  for(std::size_t g = 0ul; g < sub.groups(); ++g) {
+    BOOST_CHECK_EQUAL(sub.first(g), procs);
+    procs += sub.size(g);
+  }
+  BOOST_CHECK_EQUAL(procs, world.size());
+
+  const std::size_t color = sub.color();
+  BOOST_CHECK_EQUAL(sub.world().size(), sub.size(color));
+  BOOST_CHECK_EQUAL(sub.world().rank(), world.rank() - sub.first(color));
+}
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TArrayI a(world, trange);
+  fill(a);
+
+  const std::size_t groups = std::min<std::size_t>(2ul, world.size());
+  SubWorld sub(world, groups);
+
+  // Evaluate a different expression on each group
+  std::vector<TArrayI> results(groups);
+  for(std::size_t g = 0ul; g < groups; ++g) {
+    TArrayI a_g = sub.to_group(a, g);
+    if(g == sub.color()) {
+      BOOST_CHECK_EQUAL(& a_g.world(), & sub.world());
+      BOOST_CHECK_EQUAL(a_g.trange(), trange);
+      check(a_g, 1);
+      results[g]("i,j") = int(g + 2ul) * a_g("i,j");
+    } else {
+      BOOST_CHECK(! a_g.is_initialized());
+    }
+  }
+
+  // Move the results back to the parent world
+  for(std::size_t g = 0ul; g < groups; ++g) {
+    TArrayI result = sub.from_group(results[g], g);
+    BOOST_CHECK_EQUAL(& result.world(), & world);
+    BOOST_CHECK_EQUAL(result.trange(), trange);
+    check(result, int(g + 2ul));
+  }
+
+  results.clear();
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  Tensor<float> norms(trange.tiles_range(), 1.0f);
+  norms(1, 1) = 0.0f;
+  norms(3, 0) = 0.0f;
+  TSpArrayI a(world, trange, SparseShape<float>(norms, trange));
+  fill(a);
+
+  std::vector<std::size_t> sizes(1ul, world.size());
+  if(world.size() > 2) {
+    sizes[0] = 1ul;
+    sizes.push_back(world.size() - 1ul);
+  }
+  SubWorld sub(world, sizes);
+  BOOST_CHECK_EQUAL(sub.groups(), sizes.size());
+
+  const std::size_t last = sub.groups() - 1ul;
+  TSpArrayI a_last = sub.to_group(a, last);
+  TSpArrayI result;
+  if(sub.color() == last) {
+    for(std::size_t i = 0ul; i < a_last.size(); ++i)
+      BOOST_CHECK_EQUAL(a_last.is_zero(i), a.is_zero(i));
+    result("i,j") = 3 * a_last("i,j");
+  }
+
+  TSpArrayI b = sub.from_group(result, last);
+  for(std::size_t i = 0ul; i < b.size(); ++i)
+    BOOST_CHECK_EQUAL(b.is_zero(i), a.is_zero(i));
+  check(b, 3);
+
+  a_last = TSpArrayI();
+  result = TSpArrayI();
+  world.gop.fence();
+}
+
+BOOST_AUTO_TEST_CASE( invalid_args )
+{
+  BOOST_CHECK_THROW(SubWorld(world, 0ul), TiledArray::Exception);
+  BOOST_CHECK_THROW(SubWorld(world, world.size() + 1ul), TiledArray::Exception);
+  BOOST_CHECK_THROW(SubWorld(world, std::vector<std::size_t>(1ul, world.size() + 1ul)),
+      TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,216 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/dist_eval/summa_depth.h"
+#include "TiledArray/dist_eval/summa_order.h"
+#include "TiledArray/dist_eval/summa_priority.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using TiledArray::detail::SummaDepthController;
+using TiledArray::detail::SummaOrderPolicy;
+using TiledArray::detail::SummaPriorityPolicy;
+
+struct SummaDepthFixture {
+
+  SummaDepthFixture() { SummaDepthController::instance().reset(); }
+
+  ~SummaDepthFixture() { SummaDepthController::instance().reset(); }
+
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( summa_depth_suite, SummaDepthFixture )
+
+BOOST_AUTO_TEST_CASE( parse_memory )
+{
+  BOOST_CHECK_EQUAL(SummaDepthController::parse_memory(nullptr), 0ul);
+  BOOST_CHECK_EQUAL(SummaDepthController::parse_memory("2 GiB"), 2147483648ul);
+  BOOST_CHECK_EQUAL(SummaDepthController::parse_memory("200 MB"), 200000000ul);
+  BOOST_CHECK_EQUAL(SummaDepthController::parse_memory("1073741824"), 1073741824ul);
+
+  // Check the lower bound
+  BOOST_CHECK_EQUAL(SummaDepthController::parse_memory("1 KiB"), 104857600ul);
+}
+
+BOOST_AUTO_TEST_CASE( parse_depth )
+{
+  BOOST_CHECK_EQUAL(SummaDepthController::parse_depth(nullptr), 0ul);
+  BOOST_CHECK_EQUAL(SummaDepthController::parse_depth("4"), 4ul);
+}
+
+BOOST_AUTO_TEST_CASE( latency_depth )
+{
+  SummaDepthController& controller = SummaDepthController::instance();
+
+  // No timing data is available
+  BOOST_CHECK_EQUAL(controller.latency_depth(), 0ul);
+  controller.record_latency(0.01);
+  BOOST_CHECK_EQUAL(controller.latency_depth(), 0ul);
+
+  // The depth must cover the latency of a broadcast
+  controller.record_step_time(0.004);
+  BOOST_CHECK_EQUAL(controller.latency_depth(), 4ul);
+
+  // Samples are smoothed
+  controller.record_latency(0.03);
+  BOOST_CHECK_EQUAL(controller.latency_depth(), 5ul);
+
+  controller.reset();
+  BOOST_CHECK_EQUAL(controller.latency_depth(), 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( step_latency_depth )
+{
+  SummaDepthController& controller = SummaDepthController::instance();
+
+  // No latency data is available
+  BOOST_CHECK_EQUAL(controller.latency_depth(0.004), 0ul);
+
+  // The depth covers the latency with steps of the running contraction,
+  // without the step time of previous contractions
+  controller.record_latency(0.01);
+  BOOST_CHECK_EQUAL(controller.latency_depth(0.004), 4ul);
+  BOOST_CHECK_EQUAL(controller.latency_depth(0.02), 2ul);
+  BOOST_CHECK_EQUAL(controller.latency_depth(0.0), 0ul);
+  BOOST_CHECK_EQUAL(controller.latency_depth(), 0ul);
+
+  controller.reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( summa_priority_suite )
+
+BOOST_AUTO_TEST_CASE( priority )
+{
+  SummaPriorityPolicy& policy = SummaPriorityPolicy::instance();
+  const std::size_t bcast_distance = policy.bcast_distance();
+  const std::size_t reduce_distance = policy.reduce_distance();
+
+  policy.bcast_distance(2ul);
+  policy.reduce_distance(1ul);
+
+  // Tiles are collected with high priority near the front of the pipeline
+  BOOST_CHECK(policy.bcast_hipri(4ul, 3ul));
+  BOOST_CHECK(! policy.bcast_hipri(5ul, 3ul));
+
+  // Contractions have high priority in the final iterations
+  BOOST_CHECK(policy.reduce_hipri(9ul, 10ul));
+  BOOST_CHECK(! policy.reduce_hipri(8ul, 10ul));
+
+  // A distance of zero gives all tasks high priority
+  policy.bcast_distance(0ul);
+  policy.reduce_distance(0ul);
+  BOOST_CHECK(policy.bcast_hipri(100ul, 0ul));
+  BOOST_CHECK(policy.reduce_hipri(0ul, 100ul));
+
+  policy.bcast_distance(bcast_distance);
+  policy.reduce_distance(reduce_distance);
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  TiledArray::World& world = *GlobalFixture::world;
+  SummaPriorityPolicy& policy = SummaPriorityPolicy::instance();
+  const std::size_t bcast_distance = policy.bcast_distance();
+  const std::size_t reduce_distance = policy.reduce_distance();
+
+  TiledArray::TiledRange1 tr1{0, 2, 5, 9, 14, 20};
+  TiledArray::TArrayD a(world, TiledArray::TiledRange({tr1, tr1}));
+  TiledArray::TArrayD b(world, TiledArray::TiledRange({tr1, tr1}));
+  a.fill(1.0);
+  b.fill(2.0);
+
+  // The result does not depend on the priorities
+  TiledArray::TArrayD ref, c;
+  policy.bcast_distance(0ul);
+  policy.reduce_distance(0ul);
+  ref("i,j") = a("i,k") * b("k,j");
+  policy.bcast_distance(1ul);
+  policy.reduce_distance(1ul);
+  c("i,j") = a("i,k") * b("k,j");
+
+  for(const auto index : *c.pmap()) {
+    const TiledArray::TensorD c_tile = c.find(index).get();
+    const TiledArray::TensorD ref_tile = ref.find(index).get();
+    for(std::size_t i = 0ul; i < c_tile.size(); ++i)
+      BOOST_CHECK_CLOSE(c_tile[i], ref_tile[i], 1.0e-10);
+  }
+
+  policy.bcast_distance(bcast_distance);
+  policy.reduce_distance(reduce_distance);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE( summa_order_suite )
+
+BOOST_AUTO_TEST_CASE( block_size )
+{
+  SummaOrderPolicy& policy = SummaOrderPolicy::instance();
+  const std::size_t cache_bytes = policy.cache_bytes();
+
+  // Blocks of argument tiles fit in the cache
+  policy.cache_bytes(1024ul);
+  BOOST_CHECK_EQUAL(policy.block_size(128ul, 128ul), 4ul);
+  BOOST_CHECK_EQUAL(policy.block_size(100ul, 200ul), 3ul);
+
+  // Blocks have at least one row and column
+  BOOST_CHECK_EQUAL(policy.block_size(1024ul, 1024ul), 1ul);
+
+  // A cache size of zero disables blocking
+  policy.cache_bytes(0ul);
+  BOOST_CHECK_EQUAL(policy.block_size(128ul, 128ul),
+      std::numeric_limits<std::size_t>::max());
+
+  policy.cache_bytes(cache_bytes);
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  TiledArray::World& world = *GlobalFixture::world;
+  SummaOrderPolicy& policy = SummaOrderPolicy::instance();
+  const std::size_t cache_bytes = policy.cache_bytes();
+
+  TiledArray::TiledRange1 tr1{0, 2, 5, 9, 14, 20};
+  TiledArray::TArrayD a(world, TiledArray::TiledRange({tr1, tr1}));
+  TiledArray::TArrayD b(world, TiledArray::TiledRange({tr1, tr1}));
+  a.fill(1.0);
+  b.fill(2.0);
+
+  // The result does not depend on the order of the tile contractions
+  TiledArray::TArrayD ref, c;
+  policy.cache_bytes(0ul);
+  ref("i,j") = a("i,k") * b("k,j");
+  policy.cache_bytes(1ul);
+  c("i,j") = a("i,k") * b("k,j");
+
+  for(const auto index : *c.pmap()) {
+    const TiledArray::TensorD c_tile = c.find(index).get();
+    const TiledArray::TensorD ref_tile = ref.find(index).get();
+    for(std::size_t i = 0ul; i < c_tile.size(); ++i)
+      BOOST_CHECK_CLOSE(c_tile[i], ref_tile[i], 1.0e-10);
+  }
+
+  policy.cache_bytes(cache_bytes);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
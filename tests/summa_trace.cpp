@@ -0,0 +1,124 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  summa_trace.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/summa_trace.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct SummaTraceFixture {
+
+  SummaTraceFixture() : trace(SummaTrace::instance()) {
+    trace.disable();
+    trace.clear();
+  }
+
+  ~SummaTraceFixture() {
+    trace.disable();
+    trace.clear();
+  }
+
+  // Count the events of a type
+  static std::size_t count(const std::vector<SummaTrace::Event>& events,
+      const SummaEventKind kind)
+  {
+    return std::count_if(events.begin(), events.end(),
+        [kind] (const SummaTrace::Event& event) { return event.kind == kind; });
+  }
+
+  SummaTrace& trace;
+}; // SummaTraceFixture
+
+BOOST_FIXTURE_TEST_SUITE( summa_trace_suite, SummaTraceFixture )
+
+BOOST_AUTO_TEST_CASE( disabled )
+{
+  trace.record(SummaEventKind::step_begin, 1ul, 0ul);
+  BOOST_CHECK(trace.events().empty());
+}
+
+BOOST_AUTO_TEST_CASE( binary_round_trip )
+{
+  trace.enable();
+  trace.record(SummaEventKind::step_begin, 1ul, 0ul);
+  trace.record(SummaEventKind::bcast_col, 1ul, 0ul, 800ul, 2ul, 4ul);
+  trace.record(SummaEventKind::tiles_ready, 1ul, 0ul, 1000ul);
+  trace.record(SummaEventKind::step_end, 1ul, 0ul);
+
+  std::stringstream ss;
+  trace.write(ss);
+  const std::vector<SummaTrace::Event> events = SummaTrace::read(ss);
+  BOOST_REQUIRE_EQUAL(events.size(), 4ul);
+  BOOST_CHECK(events[1].kind == SummaEventKind::bcast_col);
+  BOOST_CHECK_EQUAL(events[1].value, 800ul);
+  BOOST_CHECK_EQUAL(events[1].count, 2u);
+  BOOST_CHECK_EQUAL(events[1].group, 4u);
+
+  // One step with the broadcast and wait time
+  const std::vector<SummaTrace::Step> steps = SummaTrace::steps(events);
+  BOOST_REQUIRE_EQUAL(steps.size(), 1ul);
+  BOOST_CHECK_EQUAL(steps[0].bytes, 800ul);
+  BOOST_CHECK_EQUAL(steps[0].wait, 1000ul);
+  BOOST_CHECK_GE(steps[0].end, steps[0].begin);
+
+  std::stringstream report;
+  SummaTrace::write_report(report, events);
+  BOOST_CHECK_NE(report.str().find("total"), std::string::npos);
+
+  std::stringstream timeline;
+  SummaTrace::write_timeline(timeline, events, 0);
+  BOOST_CHECK_NE(timeline.str().find("summa_step"), std::string::npos);
+
+  std::stringstream bad("not a trace");
+  BOOST_CHECK_THROW(SummaTrace::read(bad), TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  World& world = *GlobalFixture::world;
+  TiledRange1 tr{0, 2, 5, 7};
+  TArrayD a(world, TiledRange{tr, tr}), b(world, TiledRange{tr, tr}), c;
+  a.fill(1.0);
+  b.fill(2.0);
+
+  trace.enable();
+  c("i,j") = a("i,k") * b("k,j");
+  world.gop.fence();
+  trace.disable();
+
+  // Each step that was started on this process is completed
+  const std::vector<SummaTrace::Event> events = trace.events();
+  BOOST_CHECK_EQUAL(count(events, SummaEventKind::step_begin),
+      count(events, SummaEventKind::step_end));
+  BOOST_CHECK_EQUAL(count(events, SummaEventKind::step_begin),
+      count(events, SummaEventKind::tiles_ready));
+  if(world.size() == 1)
+    BOOST_CHECK_EQUAL(count(events, SummaEventKind::reduce_submit),
+        c.pmap()->local_size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  symm_array.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/symm_array.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct SymmArrayFixture {
+  typedef symmetry::Permutation SymmPermutation;
+
+  SymmArrayFixture() :
+    world(*GlobalFixture::world),
+    tr1({0, 2, 5, 6}),
+    trange({tr1, tr1, tr1, tr1}),
+    // t_{ijkl} = -t_{jikl} = -t_{ijlk}
+    symm(symmetry::PermutationGroup({SymmPermutation{1,0,2,3},
+        SymmPermutation{0,1,3,2}}), true),
+    full(make_full())
+  { }
+
+  TSpArrayI make_full() {
+    Tensor<float> norms(trange.tiles_range(), 1.0f);
+    TSpArrayI result(world, trange, SparseShape<float>(norms, trange));
+    result.init_tiles([] (const Range& range) -> TensorI {
+      TensorI tile(range);
+      for(const auto& i : range)
+        tile[i] = (int(i[0]) - int(i[1])) * (int(i[2]) - int(i[3]))
+            * int(i[0] + i[1] + i[2] + i[3] + 1);
+      return tile;
+    });
+    return result;
+  }
+
+  static void check_tile(const TensorI& expected, const TensorI& result) {
+    BOOST_CHECK_EQUAL(result.range(), expected.range());
+    for(std::size_t j = 0ul; j < expected.size(); ++j)
+      BOOST_CHECK_EQUAL(result[j], expected[j]);
+  }
+
+  World& world;
+  TiledRange1 tr1;
+  TiledRange trange;
+  symmetry::TileSymmetry symm;
+  TSpArrayI full;
+}; // SymmArrayFixture
+
+BOOST_FIXTURE_TEST_SUITE( symm_array_suite, SymmArrayFixture )
+
+BOOST_AUTO_TEST_CASE( tile_map )
+{
+  // The tile (1,0,2,0) is obtained from (0,1,0,2) by swapping both pairs
+  const auto tile_map = symm.map(std::vector<std::size_t>{1,0,2,0});
+  BOOST_CHECK((tile_map.unique == std::vector<std::size_t>{0,1,0,2}));
+  BOOST_CHECK_EQUAL(tile_map.factor, 1);
+
+  BOOST_CHECK(symm.is_unique(std::vector<std::size_t>{0,1,0,2}));
+  BOOST_CHECK(! symm.is_unique(std::vector<std::size_t>{0,1,2,0}));
+  BOOST_CHECK_EQUAL(symm.map(std::vector<std::size_t>{0,1,2,0}).factor, -1);
+
+  BOOST_CHECK_EQUAL(symm.orbit_size(std::vector<std::size_t>{0,1,0,2}, {2,3}), 2ul);
+  BOOST_CHECK_EQUAL(symm.orbit_size(std::vector<std::size_t>{0,1,2,2}, {2,3}), 1ul);
+}
+
+BOOST_AUTO_TEST_CASE( pack )
+{
+  SymmArray<TensorI> packed;
+  BOOST_REQUIRE_NO_THROW(packed = SymmArray<TensorI>(full, symm));
+
+  const auto& tiles_range = trange.tiles_range();
+  for(std::size_t i = 0ul; i < tiles_range.volume(); ++i) {
+    const bool unique = symm.is_unique(tiles_range.idx(i));
+    BOOST_CHECK_EQUAL(packed.is_unique(i), unique);
+    BOOST_CHECK_EQUAL(packed.array().is_zero(i), ! unique);
+    BOOST_CHECK(! packed.is_zero(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( find )
+{
+  SymmArray<TensorI> packed(full, symm);
+
+  for(std::size_t i = 0ul; i < full.size(); ++i) {
+    if(! full.is_local(i))
+      continue;
+    check_tile(full.find(i).get(), packed.find(i).get());
+  }
+}
+
+BOOST_AUTO_TEST_CASE( unpack )
+{
+  SymmArray<TensorI> packed(full, symm);
+
+  TSpArrayI result;
+  BOOST_REQUIRE_NO_THROW(result = packed.unpack());
+  for(std::size_t i = 0ul; i < full.size(); ++i) {
+    BOOST_CHECK(! result.is_zero(i));
+    if(! result.is_local(i))
+      continue;
+    check_tile(full.find(i).get(), result.find(i).get());
+  }
+}
+
+BOOST_AUTO_TEST_CASE( contraction )
+{
+  SymmArray<TensorI> packed(full, symm);
+
+  TSpArrayI expected;
+  expected("a,b,i,j") = full("a,b,c,d") * full("c,d,i,j");
+
+  SymmArray<TensorI> result(full, symm);
+  BOOST_REQUIRE_NO_THROW(result("a,b,i,j") =
+      packed.contraction_operand({2,3})("a,b,c,d") * packed("c,d,i,j"));
+
+  for(std::size_t i = 0ul; i < expected.size(); ++i) {
+    if(! expected.is_local(i))
+      continue;
+    check_tile(expected.find(i).get(), result.find(i).get());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,113 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  symm_irrep_blocking.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/symm/irrep_blocking.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+using TiledArray::symmetry::IrrepBlocking;
+
+struct IrrepBlockingFixture {
+
+  IrrepBlockingFixture() :
+    tr1({0, 2, 5, 6, 9}),
+    trange({tr1, tr1}),
+    // Tiles of irreps Ag, B1g, B2g, B1g
+    blocking({{0u, 1u, 2u, 1u}, {0u, 1u, 2u, 1u}})
+  { }
+
+  TiledRange1 tr1;
+  TiledRange trange;
+  IrrepBlocking blocking;
+}; // IrrepBlockingFixture
+
+BOOST_FIXTURE_TEST_SUITE( symm_irrep_blocking_suite, IrrepBlockingFixture )
+
+BOOST_AUTO_TEST_CASE( is_zero )
+{
+  BOOST_CHECK(blocking.validate(trange));
+  BOOST_CHECK(! blocking.validate(TiledRange({tr1, tr1, tr1})));
+
+  BOOST_CHECK_EQUAL(blocking.irrep(std::vector<std::size_t>{1, 2}), 3u);
+  BOOST_CHECK(blocking.is_zero(std::vector<std::size_t>{1, 2}));
+  BOOST_CHECK(! blocking.is_zero(std::vector<std::size_t>{1, 3}));
+  BOOST_CHECK(! blocking.is_zero(std::vector<std::size_t>{2, 2}));
+
+  IrrepBlocking b1u_blocking({{0u, 1u, 2u, 1u}, {0u, 1u, 2u, 1u}}, 3u);
+  BOOST_CHECK(! b1u_blocking.is_zero(std::vector<std::size_t>{1, 2}));
+  BOOST_CHECK(b1u_blocking.is_zero(std::vector<std::size_t>{1, 3}));
+}
+
+BOOST_AUTO_TEST_CASE( make_shape )
+{
+  std::size_t calls = 0ul;
+  SparseShape<float> shape = symmetry::make_shape(trange, blocking,
+      [&] (const std::size_t) -> float { ++calls; return 1.0f; });
+
+  // The norm function is only called for tiles allowed by symmetry
+  BOOST_CHECK_EQUAL(calls, 6ul);
+
+  const auto& tiles_range = trange.tiles_range();
+  for(std::size_t i = 0ul; i < tiles_range.volume(); ++i) {
+    const bool zero = blocking.is_zero(tiles_range.idx(i));
+    BOOST_CHECK_EQUAL(shape.is_zero(i), zero);
+    if(zero)
+      BOOST_CHECK_EQUAL(shape[i], 0.0f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( mask )
+{
+  Tensor<float> norms(trange.tiles_range(), 1.0f);
+  SparseShape<float> shape = symmetry::mask(SparseShape<float>(norms, trange), blocking);
+
+  const auto& tiles_range = trange.tiles_range();
+  for(std::size_t i = 0ul; i < tiles_range.volume(); ++i)
+    BOOST_CHECK_EQUAL(shape.is_zero(i), blocking.is_zero(tiles_range.idx(i)));
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  IrrepBlocking b1g_blocking({{0u, 1u, 2u, 1u}, {0u, 1u, 2u, 1u}}, 1u);
+  SparseShape<float> left = symmetry::make_shape(trange, b1g_blocking);
+  SparseShape<float> right = symmetry::make_shape(trange, blocking);
+
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  SparseShape<float> result = left.gemm(right, 1, gemm_helper);
+  IrrepBlocking result_blocking = b1g_blocking.gemm(blocking, gemm_helper);
+  BOOST_CHECK_EQUAL(result_blocking.symmetry(), 1u);
+
+  // Tiles that are zero by symmetry are exactly zero in the result
+  const auto& tiles_range = trange.tiles_range();
+  for(std::size_t i = 0ul; i < tiles_range.volume(); ++i) {
+    const bool zero = result_blocking.is_zero(tiles_range.idx(i));
+    BOOST_CHECK_EQUAL(result.is_zero(i), zero);
+    if(zero)
+      BOOST_CHECK_EQUAL(result[i], 0.0f);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -269,6 +269,112 @@ BOOST_AUTO_TEST_CASE( clone ) {
   BOOST_CHECK_EQUAL_COLLECTIONS(tc.begin(), tc.end(), t.begin(), t.end());
 }
 
+BOOST_AUTO_TEST_CASE( external_data ) {
+  const std::size_t n = r.volume();
+  int deleted = 0;
+
+  {
+    // Adopt a buffer
+    int* data = new int[n];
+    std::copy(t.begin(), t.end(), data);
+    TensorN te(r, data, [&deleted] (int* p) { delete [] p; ++deleted; });
+    BOOST_CHECK(te.is_external());
+    BOOST_CHECK_EQUAL(te.data(), data);
+    BOOST_CHECK_EQUAL_COLLECTIONS(te.begin(), te.end(), t.begin(), t.end());
+
+    // Writes modify the buffer
+    te[0] += 1;
+    BOOST_CHECK_EQUAL(data[0], t[0] + 1);
+
+    // Shallow copies share the buffer
+    TensorN tc = te;
+    BOOST_CHECK_EQUAL(tc.data(), data);
+  }
+  BOOST_CHECK_EQUAL(deleted, 1);
+
+  {
+    // Reference read-only data
+    std::vector<int> data(t.begin(), t.end());
+    const int* const cdata = data.data();
+    TensorN te(r, cdata, [&deleted] (const int*) { ++deleted; });
+    const TensorN& cte = te;
+    BOOST_CHECK_EQUAL(cte.data(), cdata);
+
+    // Writes copy the data
+    te.scale_to(2);
+    BOOST_CHECK_NE(cte.data(), cdata);
+    BOOST_CHECK(! te.is_external());
+    BOOST_CHECK_EQUAL_COLLECTIONS(data.begin(), data.end(), t.begin(), t.end());
+    for(std::size_t i = 0ul; i < n; ++i)
+      BOOST_CHECK_EQUAL(te[i], 2 * t[i]);
+  }
+  BOOST_CHECK_EQUAL(deleted, 2);
+}
+
+BOOST_AUTO_TEST_CASE( lazy_clone ) {
+  TensorN ts = t.clone();
+  TensorN tc;
+  BOOST_REQUIRE_NO_THROW(tc = ts.lazy_clone());
+
+  // Check that the data is shared until it is modified
+  const TensorN& cts = ts;
+  const TensorN& ctc = tc;
+  BOOST_CHECK_EQUAL(ctc.data(), cts.data());
+  BOOST_CHECK_EQUAL(tc.range(), ts.range());
+
+  // Check that writing to the clone copies the data
+  tc[0] += 1;
+  BOOST_CHECK_NE(ctc.data(), cts.data());
+  BOOST_CHECK_EQUAL(ts[0], t[0]);
+  BOOST_CHECK_EQUAL(tc[0], t[0] + 1);
+  for(std::size_t i = 1ul; i < tc.size(); ++i)
+    BOOST_CHECK_EQUAL(tc[i], t[i]);
+
+  // Check that writing to the source does not modify the clone
+  TensorN tl = ts.lazy_clone();
+  ts.scale_to(2);
+  BOOST_CHECK_EQUAL_COLLECTIONS(tl.begin(), tl.end(), t.begin(), t.end());
+  for(std::size_t i = 0ul; i < ts.size(); ++i)
+    BOOST_CHECK_EQUAL(ts[i], 2 * t[i]);
+
+  // Check that a shallow copy of a lazy clone still shares its writes
+  TensorN tv = tl;
+  tv[0] = 0;
+  BOOST_CHECK_EQUAL(tl[0], 0);
+}
+
+BOOST_AUTO_TEST_CASE( shift_view ) {
+  std::vector<long> bound_shift(GlobalFixture::dim, 0l);
+  for(unsigned int i = 0u; i < GlobalFixture::dim; ++i)
+    bound_shift[i] = -long(r.lobound_data()[i]) + long(i);
+  range_type shifted_range = r;
+  shifted_range.inplace_shift(bound_shift);
+
+  TensorN tv;
+  {
+    TensorN ts = t.clone();
+    BOOST_REQUIRE_NO_THROW(tv = ts.shift_view(bound_shift));
+
+    // Check that the view shares data with the source
+    BOOST_CHECK_EQUAL(tv.data(), ts.data());
+    BOOST_CHECK_EQUAL(tv.range(), shifted_range);
+    BOOST_CHECK_EQUAL(ts.range(), r);
+
+    // Check that a view of a view shares the same data
+    TensorN tvv = tv.shift_view(std::vector<long>(GlobalFixture::dim, 1l));
+    BOOST_CHECK_EQUAL(tvv.data(), ts.data());
+    BOOST_CHECK_EQUAL(tv.range(), shifted_range);
+  }
+
+  // Check that the data is held by the view after the source is destroyed
+  BOOST_CHECK_EQUAL_COLLECTIONS(tv.begin(), tv.end(), t.begin(), t.end());
+
+  // Check that the view matches a shifted copy
+  TensorN tc = shift(t, bound_shift);
+  BOOST_CHECK_NE(tc.data(), t.data());
+  BOOST_CHECK_EQUAL(tc.range(), tv.range());
+}
+
 BOOST_AUTO_TEST_CASE( range_accessor )
 {
   BOOST_CHECK_EQUAL_COLLECTIONS(t.range().lobound_data(), t.range().lobound_data() + t.range().rank(),
@@ -531,5 +637,149 @@ BOOST_AUTO_TEST_CASE( inplace_conj_scal_op ) {
   }
 }
 
+BOOST_AUTO_TEST_CASE( permute_add_to ) {
+  Permutation perm = make_perm();
+  TensorN s(r);
+  rand_fill(431, s.size(), s.data());
+  TensorN x(perm * r);
+  rand_fill(253, x.size(), x.data());
+
+  TensorN t = x.clone();
+  BOOST_REQUIRE_NO_THROW(t.add_to(s, perm));
+  BOOST_CHECK_EQUAL(t.range(), x.range());
+
+  TensorN st = x.clone();
+  BOOST_REQUIRE_NO_THROW(st.add_to(s, 3, perm));
+  BOOST_CHECK_EQUAL(st.range(), x.range());
+
+  for(std::size_t i = 0ul; i < s.size(); ++i) {
+    std::size_t pi = x.range().ordinal(perm * s.range().idx(i));
+    BOOST_CHECK_EQUAL(t[pi], x[pi] + s[i]);
+    BOOST_CHECK_EQUAL(st[pi], (x[pi] + s[i]) * 3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( large_reduction ) {
+  // The tensor is large enough to be reduced in parallel blocks
+  Tensor<double> t(Range(std::vector<std::size_t>{ 3ul * TILEDARRAY_REDUCE_GRAIN_SIZE + 37ul }));
+  for(std::size_t i = 0ul; i < t.size(); ++i)
+    t[i] = std::sin(double(i));
+
+  double sum = 0.0, squared_norm = 0.0, max = t[0];
+  for(std::size_t i = 0ul; i < t.size(); ++i) {
+    sum += t[i];
+    squared_norm += t[i] * t[i];
+    max = std::max(max, t[i]);
+  }
+
+  const double t_sum = t.sum();
+  const double t_squared_norm = t.squared_norm();
+  BOOST_CHECK_CLOSE(t_sum, sum, 1.0e-6);
+  BOOST_CHECK_CLOSE(t_squared_norm, squared_norm, 1.0e-10);
+  BOOST_CHECK_CLOSE(t.dot(t), squared_norm, 1.0e-10);
+  BOOST_CHECK_EQUAL(t.max(), max);
+
+  // Check that the reduction order is stable
+  for(int i = 0; i < 10; ++i) {
+    BOOST_CHECK_EQUAL(t.sum(), t_sum);
+    BOOST_CHECK_EQUAL(t.squared_norm(), t_squared_norm);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( large_permute ) {
+  // The tensor is large enough to be permuted in parallel blocks
+  Tensor<int> t(Range(std::vector<std::size_t>{ 64ul, 130ul, 127ul }));
+  for(std::size_t i = 0ul; i < t.size(); ++i)
+    t[i] = int(i);
+  BOOST_REQUIRE_GE(t.size(), TILEDARRAY_TILE_PARALLEL_SIZE);
+
+  // Permute with and without a permuted inner dimension
+  for(const auto& perm : { Permutation({1, 0, 2}), Permutation({2, 0, 1}),
+      Permutation({0, 2, 1}) })
+  {
+    Tensor<int> x = t.permute(perm);
+    BOOST_CHECK_EQUAL(x.range(), perm * t.range());
+
+    std::size_t errors = 0ul;
+    for(std::size_t i = 0ul; i < t.size(); ++i)
+      if(x[perm * t.range().idx(i)] != t[i])
+        ++errors;
+    BOOST_CHECK_EQUAL(errors, 0ul);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( statistics ) {
+  Tensor<double> x(Range(std::vector<std::size_t>{ 7ul, 5ul }));
+  Tensor<double> y(x.range());
+  for(std::size_t i = 0ul; i < x.size(); ++i) {
+    x[i] = std::sin(double(i));
+    y[i] = std::cos(double(i));
+  }
+
+  Statistics<double> stats = x.statistics(stat_all & ~stat_dot);
+  BOOST_CHECK_CLOSE(stats.sum(), x.sum(), 1.0e-10);
+  BOOST_CHECK_CLOSE(stats.squared_norm(), x.squared_norm(), 1.0e-10);
+  BOOST_CHECK_CLOSE(stats.norm(), x.norm(), 1.0e-10);
+  BOOST_CHECK_EQUAL(stats.min(), x.min());
+  BOOST_CHECK_EQUAL(stats.max(), x.max());
+  BOOST_CHECK_EQUAL(stats.abs_min(), x.abs_min());
+  BOOST_CHECK_EQUAL(stats.abs_max(), x.abs_max());
+  BOOST_CHECK_THROW(stats.dot(), Exception);
+
+  // The statistics of two tensors are joined
+  stats.join(y.statistics(stat_all & ~stat_dot));
+  BOOST_CHECK_CLOSE(stats.sum(), x.sum() + y.sum(), 1.0e-10);
+  BOOST_CHECK_EQUAL(stats.max(), std::max(x.max(), y.max()));
+  BOOST_CHECK_EQUAL(stats.abs_min(), std::min(x.abs_min(), y.abs_min()));
+
+  // The dot product is computed with the statistics of the left tensor
+  stats = x.statistics(y, stat_dot | stat_abs_max);
+  BOOST_CHECK_CLOSE(stats.dot(), x.dot(y), 1.0e-10);
+  BOOST_CHECK_EQUAL(stats.abs_max(), x.abs_max());
+
+  // The minimum of complex elements is not defined
+  Tensor<std::complex<double> > z(x.range(), std::complex<double>(1.0, 2.0));
+  BOOST_CHECK_CLOSE(z.statistics(stat_abs_max).abs_max(), std::sqrt(5.0), 1.0e-10);
+  BOOST_CHECK_THROW(z.statistics(stat_min), Exception);
+}
+
+BOOST_AUTO_TEST_CASE( norm_cache ) {
+  Tensor<double> x(Range(std::vector<std::size_t>{ 7ul, 5ul }));
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    x[i] = double(i) - 11.0;
+
+  double norm = 0.0;
+  for(std::size_t i = 0ul; i < x.size(); ++i)
+    norm += x[i] * x[i];
+  norm = std::sqrt(norm);
+
+  // The norm is cached by norm()
+  const Tensor<double>& cx = x;
+  BOOST_CHECK_LT(cx.cached_norm(), 0.0);
+  BOOST_CHECK_CLOSE(cx.norm(), norm, 1.0e-10);
+  BOOST_CHECK_CLOSE(cx.cached_norm(), norm, 1.0e-10);
+
+  // The cache is shared by copies, and carried over to derived tensors
+  const Tensor<double> y = cx;
+  BOOST_CHECK_CLOSE(y.cached_norm(), norm, 1.0e-10);
+  BOOST_CHECK_CLOSE(cx.clone().cached_norm(), norm, 1.0e-10);
+  BOOST_CHECK_CLOSE(cx.scale(-3.0).cached_norm(), 3.0 * norm, 1.0e-10);
+  BOOST_CHECK_CLOSE(cx.neg().cached_norm(), norm, 1.0e-10);
+  BOOST_CHECK_CLOSE(cx.permute(Permutation({1, 0})).cached_norm(), norm, 1.0e-10);
+
+  // In-place scaling updates the cache
+  x.scale_to(2.0);
+  BOOST_CHECK_CLOSE(cx.cached_norm(), 2.0 * norm, 1.0e-10);
+  BOOST_CHECK_CLOSE(std::sqrt(cx.squared_norm()), 2.0 * norm, 1.0e-10);
+
+  // Write access clears the cache
+  x[0] = 100.0;
+  BOOST_CHECK_LT(cx.cached_norm(), 0.0);
+  BOOST_CHECK_CLOSE(cx.norm(), std::sqrt(cx.squared_norm()), 1.0e-10);
+  x.add_to(cx);
+  BOOST_CHECK_LT(cx.cached_norm(), 0.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
 
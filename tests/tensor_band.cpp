@@ -0,0 +1,251 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tensor_band.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/tensor/band_tensor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using TiledArray::Range;
+using TiledArray::Permutation;
+using TiledArray::BandTensor;
+using TiledArray::math::GemmHelper;
+
+struct BandTensorFixture {
+  typedef TiledArray::Tensor<double> TensorD;
+  typedef BandTensor<double> BandD;
+
+  BandTensorFixture() :
+    a(make_dense(Range(std::vector<std::size_t>{ 3, 5 },
+        std::vector<std::size_t>{ 20, 28 }), 1)),
+    b(make_dense(Range(std::vector<std::size_t>{ 3, 5 },
+        std::vector<std::size_t>{ 20, 28 }), 7)),
+    band_a(a, 2ul, 1ul), band_b(b, 0ul, 3ul)
+  { }
+
+  /// Construct a dense matrix
+
+  /// \param range The range of the matrix
+  /// \param seed The seed of the matrix elements
+  /// \return A matrix with non-zero elements
+  static TensorD make_dense(const Range& range, const int seed) {
+    TensorD result(range);
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      result[i] = std::sin(double(seed + i + 1ul));
+    return result;
+  }
+
+  /// Maximum element difference
+
+  /// \param tile A banded tile
+  /// \param tensor A dense tile
+  /// \return The maximum absolute difference of the elements
+  static double diff(const BandD& tile, const TensorD& tensor) {
+    BOOST_CHECK_EQUAL(tile.range(), tensor.range());
+    return tile.dense().subt(tensor).abs_max();
+  }
+
+  static constexpr double tol = 1.0e-12;
+
+  TensorD a, b;
+  BandD band_a, band_b;
+}; // BandTensorFixture
+
+constexpr double BandTensorFixture::tol;
+
+BOOST_FIXTURE_TEST_SUITE( band_tensor_suite, BandTensorFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  BOOST_CHECK(BandD().empty());
+
+  // Only the elements in the band of the array are stored
+  BOOST_CHECK(! band_a.empty());
+  BOOST_CHECK_EQUAL(band_a.range(), a.range());
+  BOOST_CHECK_EQUAL(band_a.first_diagonal(), -2l);
+  BOOST_CHECK_EQUAL(band_a.band_width(), 4ul);
+  for(std::size_t i = 3ul; i < 20ul; ++i) {
+    for(std::size_t j = 5ul; j < 28ul; ++j) {
+      const long d = long(j) - long(i);
+      BOOST_CHECK_EQUAL(band_a.in_band(i, j), (d >= -2l) && (d <= 1l));
+      BOOST_CHECK_EQUAL(band_a(i, j), (band_a.in_band(i, j) ?
+          a(std::array<std::size_t, 2>{{i, j}}) : 0.0));
+    }
+  }
+
+  // Zero and constant tiles
+  BandD z(a.range());
+  BOOST_CHECK_EQUAL(z.band_width(), 0ul);
+  BOOST_CHECK_EQUAL(z.dense().abs_max(), 0.0);
+  BandD d(a.range(), 0ul, 0ul, 2.0);
+  BOOST_CHECK_EQUAL(d.band_width(), 1ul);
+  BOOST_CHECK_EQUAL(d.sum(), 2.0 * 15.0);
+
+  // The band is clipped to the tile
+  BandD off(Range(std::vector<std::size_t>{ 0, 10 },
+      std::vector<std::size_t>{ 4, 14 }), 1ul, 1ul, 1.0);
+  BOOST_CHECK_EQUAL(off.band_width(), 0ul);
+  BOOST_CHECK_EQUAL(off.norm(), 0.0);
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(BandD(Range(2, 3, 4)), TiledArray::Exception);
+  BOOST_CHECK_THROW(band_a(3ul, 20ul) = 1.0, TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( permute_shift )
+{
+  Permutation perm({1, 0});
+  BandD t = band_a.permute(perm);
+  BOOST_CHECK_EQUAL(t.first_diagonal(), -1l);
+  BOOST_CHECK_EQUAL(t.band_width(), 4ul);
+  BOOST_CHECK_LT(diff(t, band_a.dense().permute(perm)), tol);
+  BOOST_CHECK_LT(diff(band_a.permute(Permutation({0, 1})), band_a.dense()), tol);
+
+  t = band_a.shift(std::vector<long>{ 1, 3 });
+  BOOST_CHECK_EQUAL(t.first_diagonal(), 0l);
+  BOOST_CHECK_LT(diff(t, band_a.dense().shift(std::vector<long>{ 1, 3 })), tol);
+}
+
+BOOST_AUTO_TEST_CASE( scale_add_mult )
+{
+  const TensorD dense_a = band_a.dense(), dense_b = band_b.dense();
+
+  BOOST_CHECK_LT(diff(band_a.scale(3.0), dense_a.scale(3.0)), tol);
+  BOOST_CHECK_LT(diff(band_a.neg(), dense_a.neg()), tol);
+
+  BandD t = band_a.add(band_b);
+  BOOST_CHECK_EQUAL(t.first_diagonal(), -2l);
+  BOOST_CHECK_EQUAL(t.band_width(), 6ul);
+  BOOST_CHECK_LT(diff(t, dense_a.add(dense_b)), tol);
+  BOOST_CHECK_LT(diff(band_a.add(band_b, 2.0), dense_a.add(dense_b, 2.0)), tol);
+  BOOST_CHECK_LT(diff(band_a.subt(band_b), dense_a.subt(dense_b)), tol);
+  BOOST_CHECK_LT(diff(band_a.add(1.5), dense_a.add(1.5)), tol);
+
+  t = band_a.clone();
+  t.add_to(band_b);
+  t.subt_to(band_b);
+  BOOST_CHECK_LT(diff(t, dense_a), tol);
+
+  t = band_a.mult(band_b);
+  BOOST_CHECK_EQUAL(t.first_diagonal(), 0l);
+  BOOST_CHECK_EQUAL(t.band_width(), 2ul);
+  BOOST_CHECK_LT(diff(t, dense_a.mult(dense_b)), tol);
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  const TensorD dense_a = band_a.dense(), dense_b = band_b.dense();
+
+  // (17 x 23) * (23 x 17)
+  GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::Trans, 2u, 2u, 2u);
+  BandD t = band_a.gemm(band_b, 0.5, gemm_helper);
+  BOOST_CHECK_EQUAL(t.band_width(), 7ul);
+  BOOST_CHECK_LT(diff(t, dense_a.gemm(dense_b, 0.5, gemm_helper)), tol);
+
+  // (23 x 17) * (17 x 23), accumulated
+  GemmHelper gemm_helper_t(madness::cblas::Trans, madness::cblas::NoTrans, 2u, 2u, 2u);
+  BandD c;
+  c.gemm(band_a, band_b, 1.0, gemm_helper_t);
+  c.gemm(band_b, band_b, 1.0, gemm_helper_t);
+  TensorD ref_c = dense_a.gemm(dense_b, 1.0, gemm_helper_t);
+  ref_c.gemm(dense_b, dense_b, 1.0, gemm_helper_t);
+  BOOST_CHECK_LT(diff(c, ref_c), tol);
+}
+
+BOOST_AUTO_TEST_CASE( reduction )
+{
+  const TensorD dense_a = band_a.dense(), dense_b = band_b.dense();
+
+  BOOST_CHECK_CLOSE(band_a.sum(), dense_a.sum(), 1.0e-8);
+  BOOST_CHECK_CLOSE(band_a.trace(), dense_a.trace(), 1.0e-8);
+  BOOST_CHECK_CLOSE(band_a.squared_norm(), dense_a.squared_norm(), 1.0e-8);
+  BOOST_CHECK_CLOSE(band_a.dot(band_b), dense_a.dot(dense_b), 1.0e-8);
+  BOOST_CHECK_CLOSE(band_a.abs_max(), dense_a.abs_max(), 1.0e-8);
+  BOOST_CHECK_EQUAL(BandD(a.range()).norm(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( serialization )
+{
+  madness::archive::BufferOutputArchive count;
+  count & band_a;
+  std::vector<unsigned char> buf(count.size());
+  madness::archive::BufferOutputArchive oar(buf.data(), buf.size());
+  oar & band_a;
+  oar.close();
+
+  BandD t;
+  madness::archive::BufferInputArchive iar(buf.data(), buf.size());
+  iar & t;
+  iar.close();
+
+  BOOST_CHECK_EQUAL(t.first_diagonal(), band_a.first_diagonal());
+  BOOST_CHECK_EQUAL(t.band_width(), band_a.band_width());
+  BOOST_CHECK_LT(diff(t, band_a.dense()), tol);
+}
+
+BOOST_AUTO_TEST_CASE( diagonal_array )
+{
+  std::array<std::size_t, 4> tiling = {{ 0, 7, 17, 30 }};
+  TiledArray::TiledRange1 tr1(tiling.begin(), tiling.end());
+  TiledArray::TiledRange trange({ tr1, tr1 });
+
+  auto d = TiledArray::band_diagonal_array<double, TiledArray::SparsePolicy>(
+      *GlobalFixture::world, trange, 2.0);
+  auto d_ref = TiledArray::diagonal_array<double, TiledArray::SparsePolicy>(
+      *GlobalFixture::world, trange, 2.0);
+  TiledArray::TSpArrayD x(*GlobalFixture::world, trange);
+  TiledArray::DistArray<BandD, TiledArray::SparsePolicy>
+      x_band(*GlobalFixture::world, trange);
+  for(auto it = x.pmap()->begin(); it != x.pmap()->end(); ++it) {
+    const TensorD tile = make_dense(trange.make_tile_range(*it), int(*it));
+    x.set(*it, tile);
+    x_band.set(*it, BandD(tile, 30ul, 30ul));
+  }
+  GlobalFixture::world->gop.fence();
+
+  // Only the diagonal is stored
+  for(auto it = d.pmap()->begin(); it != d.pmap()->end(); ++it) {
+    BOOST_CHECK_EQUAL(d.is_zero(*it), d_ref.is_zero(*it));
+    if(! d.is_zero(*it)) {
+      const BandD tile = d.find(*it).get();
+      BOOST_CHECK_EQUAL(tile.band_width(), 1ul);
+      BOOST_CHECK_LT(diff(tile, d_ref.find(*it).get()), tol);
+    }
+  }
+
+  // Multiply by the diagonal
+  TiledArray::DistArray<BandD, TiledArray::SparsePolicy> y;
+  TiledArray::TSpArrayD y_ref;
+  BOOST_REQUIRE_NO_THROW(y("i,j") = d("i,k") * x_band("k,j"));
+  y_ref("i,j") = d_ref("i,k") * x("k,j");
+  for(auto it = y.pmap()->begin(); it != y.pmap()->end(); ++it) {
+    BOOST_REQUIRE_EQUAL(y.is_zero(*it), y_ref.is_zero(*it));
+    if(! y.is_zero(*it))
+      BOOST_CHECK_LT(diff(y.find(*it).get(), y_ref.find(*it).get()), tol);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
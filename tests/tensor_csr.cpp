@@ -0,0 +1,261 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tensor_csr.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/tensor/csr_tensor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using TiledArray::Range;
+using TiledArray::Permutation;
+using TiledArray::CsrTensor;
+using TiledArray::math::GemmHelper;
+
+struct CsrTensorFixture {
+  typedef TiledArray::Tensor<double> TensorD;
+  typedef CsrTensor<double> CsrD;
+
+  CsrTensorFixture() :
+    a(make_sparse(Range(std::vector<std::size_t>{ 3, 5 },
+        std::vector<std::size_t>{ 20, 28 }), 1, 23)),
+    b(make_sparse(Range(std::vector<std::size_t>{ 3, 5 },
+        std::vector<std::size_t>{ 20, 28 }), 3, 29)),
+    c(make_sparse(Range(std::vector<std::size_t>{ 3, 5 },
+        std::vector<std::size_t>{ 20, 28 }), 2, 1)),
+    csr_a(a), csr_b(b), csr_c(c)
+  { }
+
+  /// Construct a dense matrix with a fraction of non-zero elements
+
+  /// \param range The range of the matrix
+  /// \param seed The seed of the matrix elements
+  /// \param stride One of \c stride elements is non-zero
+  /// \return A matrix with a fraction of non-zero elements
+  static TensorD make_sparse(const Range& range, const int seed,
+      const std::size_t stride)
+  {
+    TensorD result(range, 0.0);
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      if((i * 7ul + seed) % stride == 0ul)
+        result[i] = std::sin(double(seed + i + 1ul));
+    return result;
+  }
+
+  /// Maximum element difference
+
+  /// \param tile An element-sparse tile
+  /// \param tensor A dense tile
+  /// \return The maximum absolute difference of the elements
+  static double diff(const CsrD& tile, const TensorD& tensor) {
+    BOOST_CHECK_EQUAL(tile.range(), tensor.range());
+    return tile.dense().subt(tensor).abs_max();
+  }
+
+  static constexpr double tol = 1.0e-12;
+
+  TensorD a, b, c;
+  CsrD csr_a, csr_b, csr_c;
+}; // CsrTensorFixture
+
+constexpr double CsrTensorFixture::tol;
+
+BOOST_FIXTURE_TEST_SUITE( csr_tensor_suite, CsrTensorFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  BOOST_CHECK(CsrD().empty());
+
+  // The format is chosen from the fill ratio
+  BOOST_CHECK(! csr_a.is_dense());
+  BOOST_CHECK(! csr_b.is_dense());
+  BOOST_CHECK(csr_c.is_dense());
+  BOOST_CHECK_LE(csr_a.fill_ratio(), CsrD::fill_threshold());
+  BOOST_CHECK_EQUAL(csr_c.nnz(), c.size());
+  BOOST_CHECK_EQUAL(csr_a.row_ptr().size(), 18ul);
+  BOOST_CHECK_EQUAL(csr_a.row_ptr().back(), csr_a.nnz());
+  for(std::size_t i = 3ul; i < 20ul; ++i)
+    for(std::size_t j = 5ul; j < 28ul; ++j)
+      BOOST_CHECK_EQUAL(csr_a(i, j), a(std::array<std::size_t, 2>{{i, j}}));
+
+  // Zero tiles and CSR arrays
+  CsrD z(a.range());
+  BOOST_CHECK(! z.is_dense());
+  BOOST_CHECK_EQUAL(z.nnz(), 0ul);
+  BOOST_CHECK_EQUAL(z.dense().abs_max(), 0.0);
+  CsrD t(a.range(), csr_a.row_ptr(), csr_a.col(), csr_a.value());
+  BOOST_CHECK_LT(diff(t, a), tol);
+
+  // The threshold applies to new tiles
+  const double threshold = CsrD::fill_threshold();
+  CsrD::set_fill_threshold(0.0);
+  BOOST_CHECK(CsrD(a).is_dense());
+  CsrD::set_fill_threshold(threshold);
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(CsrD(Range(2, 3, 4)), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( permute_shift )
+{
+  Permutation perm({1, 0});
+  CsrD t = csr_a.permute(perm);
+  BOOST_CHECK(! t.is_dense());
+  BOOST_CHECK_EQUAL(t.nnz(), csr_a.nnz());
+  BOOST_CHECK_LT(diff(t, a.permute(perm)), tol);
+  BOOST_CHECK_LT(diff(csr_c.permute(perm), c.permute(perm)), tol);
+  BOOST_CHECK_LT(diff(csr_a.permute(Permutation({0, 1})), a), tol);
+
+  t = csr_a.shift(std::vector<long>{ 1, 3 });
+  BOOST_CHECK_LT(diff(t, a.shift(std::vector<long>{ 1, 3 })), tol);
+}
+
+BOOST_AUTO_TEST_CASE( scale_add_mult )
+{
+  BOOST_CHECK_LT(diff(csr_a.scale(3.0), a.scale(3.0)), tol);
+  BOOST_CHECK_LT(diff(csr_a.neg(), a.neg()), tol);
+
+  // The sum of sparse tiles is sparse, and a sum with a dense tile is dense
+  CsrD t = csr_a.add(csr_b);
+  BOOST_CHECK(! t.is_dense());
+  BOOST_CHECK_LT(diff(t, a.add(b)), tol);
+  BOOST_CHECK_LT(diff(csr_a.add(csr_b, 2.0), a.add(b, 2.0)), tol);
+  BOOST_CHECK_LT(diff(csr_a.subt(csr_b), a.subt(b)), tol);
+  t = csr_a.add(csr_c);
+  BOOST_CHECK(t.is_dense());
+  BOOST_CHECK_LT(diff(t, a.add(c)), tol);
+  BOOST_CHECK_LT(diff(csr_c.subt(csr_a), c.subt(a)), tol);
+  BOOST_CHECK_LT(diff(csr_a.add(1.5), a.add(1.5)), tol);
+  BOOST_CHECK_EQUAL(csr_a.subt(csr_a).nnz(), 0ul);
+
+  t = csr_a.clone();
+  t.add_to(csr_b);
+  t.subt_to(csr_b);
+  BOOST_CHECK_LT(diff(t, a), tol);
+
+  // Element-wise products with a sparse tile are sparse
+  t = csr_a.mult(csr_c);
+  BOOST_CHECK(! t.is_dense());
+  BOOST_CHECK_LT(diff(t, a.mult(c)), tol);
+  BOOST_CHECK_LT(diff(csr_c.mult(csr_a), c.mult(a)), tol);
+  BOOST_CHECK_LT(diff(csr_a.mult(csr_b), a.mult(b)), tol);
+  BOOST_CHECK_LT(diff(csr_c.mult(csr_c), c.mult(c)), tol);
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  // All pairs of formats, (17 x 23) * (23 x 17) and (23 x 17) * (17 x 23)
+  const GemmHelper nt(madness::cblas::NoTrans, madness::cblas::Trans, 2u, 2u, 2u);
+  const GemmHelper tn(madness::cblas::Trans, madness::cblas::NoTrans, 2u, 2u, 2u);
+  for(const GemmHelper& gemm_helper : { nt, tn }) {
+    BOOST_CHECK_LT(diff(csr_a.gemm(csr_b, 0.5, gemm_helper),
+        a.gemm(b, 0.5, gemm_helper)), tol);
+    BOOST_CHECK_LT(diff(csr_a.gemm(csr_c, 0.5, gemm_helper),
+        a.gemm(c, 0.5, gemm_helper)), tol);
+    BOOST_CHECK_LT(diff(csr_c.gemm(csr_a, 0.5, gemm_helper),
+        c.gemm(a, 0.5, gemm_helper)), tol);
+    BOOST_CHECK_LT(diff(csr_c.gemm(csr_c, 0.5, gemm_helper),
+        c.gemm(c, 0.5, gemm_helper)), tol);
+  }
+  BOOST_CHECK(csr_c.gemm(csr_c, 1.0, nt).is_dense());
+  BOOST_CHECK(csr_a.gemm(csr_c, 1.0, nt).is_dense());
+
+  // Accumulated products of mixed formats
+  CsrD t;
+  t.gemm(csr_a, csr_b, 1.0, tn);
+  t.gemm(csr_c, csr_c, 1.0, tn);
+  t.gemm(csr_a, csr_c, 1.0, tn);
+  TensorD ref = a.gemm(b, 1.0, tn);
+  ref.gemm(c, c, 1.0, tn);
+  ref.gemm(a, c, 1.0, tn);
+  BOOST_CHECK_LT(diff(t, ref), tol);
+}
+
+BOOST_AUTO_TEST_CASE( reduction )
+{
+  BOOST_CHECK_CLOSE(csr_a.sum(), a.sum(), 1.0e-8);
+  BOOST_CHECK_CLOSE(csr_a.squared_norm(), a.squared_norm(), 1.0e-8);
+  BOOST_CHECK_CLOSE(csr_a.dot(csr_c), a.dot(c), 1.0e-8);
+  BOOST_CHECK_CLOSE(csr_c.dot(csr_a), a.dot(c), 1.0e-8);
+  BOOST_CHECK_CLOSE(csr_a.abs_max(), a.abs_max(), 1.0e-8);
+  BOOST_CHECK_CLOSE(csr_a.max(), a.max(), 1.0e-8);
+  BOOST_CHECK_CLOSE(csr_a.min(), a.min(), 1.0e-8);
+  BOOST_CHECK_EQUAL(csr_a.abs_min(), 0.0);
+  BOOST_CHECK_EQUAL(csr_a.product(), 0.0);
+  BOOST_CHECK_EQUAL(CsrD(a.range()).norm(), 0.0);
+
+  TensorD s = make_sparse(Range(std::vector<std::size_t>{ 2, 4 },
+      std::vector<std::size_t>{ 12, 14 }), 1, 3);
+  BOOST_CHECK_CLOSE(CsrD(s).trace(), s.trace(), 1.0e-8);
+}
+
+BOOST_AUTO_TEST_CASE( serialization )
+{
+  for(const CsrD& tile : { csr_a, csr_c }) {
+    madness::archive::BufferOutputArchive count;
+    count & tile;
+    std::vector<unsigned char> buf(count.size());
+    madness::archive::BufferOutputArchive oar(buf.data(), buf.size());
+    oar & tile;
+    oar.close();
+
+    CsrD t;
+    madness::archive::BufferInputArchive iar(buf.data(), buf.size());
+    iar & t;
+    iar.close();
+
+    BOOST_CHECK_EQUAL(t.is_dense(), tile.is_dense());
+    BOOST_CHECK_EQUAL(t.nnz(), tile.nnz());
+    BOOST_CHECK_LT(diff(t, tile.dense()), tol);
+  }
+}
+
+BOOST_AUTO_TEST_CASE( array_contraction )
+{
+  std::array<std::size_t, 4> tiling = {{ 0, 7, 17, 30 }};
+  TiledArray::TiledRange1 tr1(tiling.begin(), tiling.end());
+  TiledArray::TiledRange trange({ tr1, tr1 });
+
+  // Mix sparse and dense tiles
+  TiledArray::TSpArrayD x(*GlobalFixture::world, trange);
+  for(auto it = x.pmap()->begin(); it != x.pmap()->end(); ++it)
+    x.set(*it, make_sparse(trange.make_tile_range(*it), int(*it),
+        (*it % 2ul ? 1ul : 17ul)));
+  GlobalFixture::world->gop.fence();
+  auto x_csr = TiledArray::to_new_tile_type(x,
+      [] (const TensorD& tile) { return CsrD(tile); });
+
+  TiledArray::DistArray<CsrD, TiledArray::SparsePolicy> y;
+  TiledArray::TSpArrayD y_ref;
+  BOOST_REQUIRE_NO_THROW(y("i,j") = x_csr("i,k") * x_csr("j,k"));
+  y_ref("i,j") = x("i,k") * x("j,k");
+  for(auto it = y.pmap()->begin(); it != y.pmap()->end(); ++it) {
+    BOOST_REQUIRE_EQUAL(y.is_zero(*it), y_ref.is_zero(*it));
+    if(! y.is_zero(*it))
+      BOOST_CHECK_LT(diff(y.find(*it).get(), y_ref.find(*it).get()), 1.0e-10);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tensor_device.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/config.h"
+
+#ifdef TILEDARRAY_HAS_CUDA
+
+#include "TiledArray/tensor/device_tensor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using TiledArray::Range;
+using TiledArray::Permutation;
+using TiledArray::DeviceTensor;
+using TiledArray::math::GemmHelper;
+
+struct DeviceTensorFixture {
+  typedef TiledArray::Tensor<double> TensorD;
+  typedef DeviceTensor<double> DeviceD;
+
+  DeviceTensorFixture() :
+    a(make_tensor(Range(std::vector<std::size_t>{ 17, 23 }), 1)),
+    b(make_tensor(Range(std::vector<std::size_t>{ 17, 23 }), 2)),
+    c(make_tensor(Range(std::vector<std::size_t>{ 23, 11 }), 3)),
+    d_a(a), d_b(b), d_c(c)
+  { }
+
+  static TensorD make_tensor(const Range& range, const int seed) {
+    TensorD result(range);
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      result[i] = std::sin(double(seed) * double(i + 1ul));
+    return result;
+  }
+
+  /// Maximum element difference
+
+  /// \param tile A device tile
+  /// \param tensor A host tile
+  /// \return The maximum absolute difference of the elements
+  static double diff(const DeviceD& tile, const TensorD& tensor) {
+    BOOST_CHECK_EQUAL(tile.range(), tensor.range());
+    return tile.host().subt(tensor).abs_max();
+  }
+
+  static constexpr double tol = 1.0e-12;
+
+  TensorD a, b, c;
+  DeviceD d_a, d_b, d_c;
+}; // DeviceTensorFixture
+
+BOOST_FIXTURE_TEST_SUITE( tensor_device_suite, DeviceTensorFixture )
+
+BOOST_AUTO_TEST_CASE( construct )
+{
+  BOOST_CHECK(DeviceD().empty());
+  BOOST_CHECK_LT(diff(d_a, a), tol);
+  BOOST_CHECK_LT(diff(DeviceD(a.range(), 0.0), TensorD(a.range(), 0.0)), tol);
+  BOOST_CHECK_LT(diff(DeviceD(a.range(), 2.0), TensorD(a.range(), 2.0)), tol);
+  BOOST_CHECK_LT(diff(d_a.clone(), a), tol);
+}
+
+BOOST_AUTO_TEST_CASE( element_wise )
+{
+  BOOST_CHECK_LT(diff(d_a.scale(3.0), a.scale(3.0)), tol);
+  BOOST_CHECK_LT(diff(d_a.neg(), a.neg()), tol);
+  BOOST_CHECK_LT(diff(d_a.add(d_b), a.add(b)), tol);
+  BOOST_CHECK_LT(diff(d_a.add(d_b, 2.0), a.add(b, 2.0)), tol);
+  BOOST_CHECK_LT(diff(d_a.subt(d_b), a.subt(b)), tol);
+  BOOST_CHECK_LT(diff(d_a.subt(d_b, 2.0), a.subt(b, 2.0)), tol);
+  BOOST_CHECK_LT(diff(d_a.mult(d_b), a.mult(b)), tol);
+
+  DeviceD t = d_a.clone();
+  t.add_to(d_b).scale_to(0.5).mult_to(d_b).subt_to(d_a);
+  BOOST_CHECK_LT(diff(t, a.add(b).scale(0.5).mult(b).subt(a)), tol);
+}
+
+BOOST_AUTO_TEST_CASE( permute )
+{
+  Permutation perm({1, 0});
+  BOOST_CHECK_LT(diff(d_a.permute(perm), a.permute(perm)), tol);
+  BOOST_CHECK_LT(diff(d_a.add(d_b, perm), a.add(b, perm)), tol);
+}
+
+BOOST_AUTO_TEST_CASE( contract )
+{
+  GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans, 2u, 2u, 2u);
+  BOOST_CHECK_LT(diff(d_a.gemm(d_c, 2.0, gemm_helper),
+      a.gemm(c, 2.0, gemm_helper)), 1.0e-10);
+
+  GemmHelper gemm_helper_t(madness::cblas::NoTrans, madness::cblas::Trans, 2u, 2u, 2u);
+  BOOST_CHECK_LT(diff(d_a.gemm(d_b, 1.0, gemm_helper_t),
+      a.gemm(b, 1.0, gemm_helper_t)), 1.0e-10);
+}
+
+BOOST_AUTO_TEST_CASE( reduce )
+{
+  BOOST_CHECK_CLOSE(d_a.norm(), a.norm(), 1.0e-10);
+  BOOST_CHECK_CLOSE(d_a.squared_norm(), a.squared_norm(), 1.0e-10);
+  BOOST_CHECK_CLOSE(d_a.dot(d_b), a.dot(b), 1.0e-10);
+  BOOST_CHECK_CLOSE(d_a.sum(), a.sum(), 1.0e-10);
+}
+
+BOOST_AUTO_TEST_CASE( serialize )
+{
+  std::size_t buf_size = (a.range().volume() * sizeof(double)
+      + sizeof(TiledArray::Range) * 2) * 2;
+  std::vector<unsigned char> buf(buf_size);
+  madness::archive::BufferOutputArchive oar(buf.data(), buf_size);
+  oar & d_a;
+  std::size_t nbyte = oar.size();
+  oar.close();
+
+  DeviceD d;
+  madness::archive::BufferInputArchive iar(buf.data(), nbyte);
+  iar & d;
+  iar.close();
+
+  BOOST_CHECK_LT(diff(d, a), tol);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+#endif // TILEDARRAY_HAS_CUDA
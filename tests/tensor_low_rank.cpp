@@ -0,0 +1,249 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tensor_low_rank.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+#include "TiledArray/tensor/low_rank_tensor.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using TiledArray::Range;
+using TiledArray::Permutation;
+using TiledArray::LowRankTensor;
+using TiledArray::math::GemmHelper;
+
+struct LowRankTensorFixture {
+  typedef TiledArray::Tensor<double> TensorD;
+  typedef LowRankTensor<double> LowRankD;
+
+  LowRankTensorFixture() :
+    a(make_dense(Range(std::vector<std::size_t>{ 17, 23 }), 3ul, 1)),
+    b(make_dense(Range(std::vector<std::size_t>{ 17, 23 }), 2ul, 10)),
+    lr_a(a), lr_b(b)
+  { }
+
+  /// Construct a dense matrix with a given rank
+
+  /// \param range The range of the matrix
+  /// \param rank The rank of the matrix
+  /// \param seed The seed of the matrix elements
+  /// \return The sum of \c rank outer products
+  static TensorD make_dense(const Range& range, const std::size_t rank,
+      const int seed)
+  {
+    const std::size_t m = range.extent_data()[0], n = range.extent_data()[1];
+    TensorD result(range, 0.0);
+    for(std::size_t r = 0ul; r < rank; ++r)
+      for(std::size_t i = 0ul; i < m; ++i)
+        for(std::size_t j = 0ul; j < n; ++j)
+          result[i * n + j] += std::sin(double(seed + r + 1ul) * double(i + 1ul))
+              * std::cos(double(seed + 2ul * r + 1ul) * double(j + 1ul));
+    return result;
+  }
+
+  /// Maximum element difference
+
+  /// \param tile A low-rank tile
+  /// \param tensor A dense tile
+  /// \return The maximum absolute difference of the elements
+  static double diff(const LowRankD& tile, const TensorD& tensor) {
+    BOOST_CHECK_EQUAL(tile.range(), tensor.range());
+    return tile.dense().subt(tensor).abs_max();
+  }
+
+  static constexpr double tol = 1.0e-10;
+
+  TensorD a, b;
+  LowRankD lr_a, lr_b;
+}; // LowRankTensorFixture
+
+constexpr double LowRankTensorFixture::tol;
+
+BOOST_FIXTURE_TEST_SUITE( low_rank_tensor_suite, LowRankTensorFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  BOOST_CHECK(LowRankD().empty());
+
+  // Dense tiles are compressed to their numerical rank
+  BOOST_CHECK(! lr_a.empty());
+  BOOST_CHECK_EQUAL(lr_a.range(), a.range());
+  BOOST_CHECK_EQUAL(lr_a.size(), a.size());
+  BOOST_CHECK_EQUAL(lr_a.rank(), 3ul);
+  BOOST_CHECK_EQUAL(lr_b.rank(), 2ul);
+  BOOST_CHECK_LT(diff(lr_a, a), tol);
+
+  // Zero and constant tiles
+  LowRankD z(a.range());
+  BOOST_CHECK_EQUAL(z.rank(), 0ul);
+  BOOST_CHECK_EQUAL(z.dense().abs_max(), 0.0);
+  LowRankD c(a.range(), 2.0);
+  BOOST_CHECK_EQUAL(c.rank(), 1ul);
+  BOOST_CHECK_LT(diff(c, TensorD(a.range(), 2.0)), tol);
+
+  // Factors are recompressed
+  TensorD left(Range(17, 4), 1.0), right(Range(4, 23), 1.0);
+  LowRankD f(a.range(), left, right);
+  BOOST_CHECK_EQUAL(f.rank(), 1ul);
+  BOOST_CHECK_LT(diff(f, TensorD(a.range(), 4.0)), tol);
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(LowRankD(Range(2, 3, 4)), TiledArray::Exception);
+  BOOST_CHECK_THROW(LowRankD(a.range(), TensorD(Range(16, 4), 1.0), right),
+      TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( permute )
+{
+  Permutation perm({1, 0});
+  LowRankD t = lr_a.permute(perm);
+  BOOST_CHECK_EQUAL(t.rank(), lr_a.rank());
+  BOOST_CHECK_LT(diff(t, a.permute(perm)), tol);
+  BOOST_CHECK_LT(diff(lr_a.permute(Permutation({0, 1})), a), tol);
+}
+
+BOOST_AUTO_TEST_CASE( scale_neg )
+{
+  BOOST_CHECK_LT(diff(lr_a.scale(3.0), a.scale(3.0)), tol);
+  BOOST_CHECK_LT(diff(lr_a.neg(), a.neg()), tol);
+  LowRankD t = lr_a.clone();
+  t.scale_to(-2.0);
+  BOOST_CHECK_LT(diff(t, a.scale(-2.0)), tol);
+  BOOST_CHECK_LT(diff(lr_a, a), tol);
+}
+
+BOOST_AUTO_TEST_CASE( add_subt )
+{
+  LowRankD t = lr_a.add(lr_b);
+  BOOST_CHECK_EQUAL(t.rank(), 5ul);
+  BOOST_CHECK_LT(diff(t, a.add(b)), tol);
+  BOOST_CHECK_LT(diff(lr_a.add(lr_b, 2.0), a.add(b, 2.0)), tol);
+  BOOST_CHECK_LT(diff(lr_a.subt(lr_b), a.subt(b)), tol);
+  BOOST_CHECK_LT(diff(lr_a.add(1.5), a.add(1.5)), tol);
+
+  // The rank of a tile minus itself is zero
+  BOOST_CHECK_EQUAL(lr_a.subt(lr_a).rank(), 0ul);
+
+  t = lr_a.clone();
+  t.add_to(lr_b);
+  BOOST_CHECK_LT(diff(t, a.add(b)), tol);
+  t.subt_to(lr_b);
+  BOOST_CHECK_LT(diff(t, a), tol);
+  BOOST_CHECK_EQUAL(t.rank(), 3ul);
+}
+
+BOOST_AUTO_TEST_CASE( mult )
+{
+  LowRankD t = lr_a.mult(lr_b);
+  BOOST_CHECK_LE(t.rank(), 6ul);
+  BOOST_CHECK_LT(diff(t, a.mult(b)), tol);
+  BOOST_CHECK_LT(diff(lr_a.mult(lr_b, 2.0, Permutation({1, 0})),
+      a.mult(b, 2.0, Permutation({1, 0}))), tol);
+}
+
+BOOST_AUTO_TEST_CASE( gemm )
+{
+  // (17 x 23) * (23 x 17)
+  GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::Trans, 2u, 2u, 2u);
+  LowRankD t = lr_a.gemm(lr_b, 0.5, gemm_helper);
+  TensorD ref = a.gemm(b, 0.5, gemm_helper);
+  BOOST_CHECK_LE(t.rank(), 2ul);
+  BOOST_CHECK_LT(diff(t, ref), tol * ref.abs_max());
+
+  // (23 x 17) * (17 x 23), accumulated
+  GemmHelper gemm_helper_t(madness::cblas::Trans, madness::cblas::NoTrans, 2u, 2u, 2u);
+  LowRankD c;
+  c.gemm(lr_a, lr_b, 1.0, gemm_helper_t);
+  c.gemm(lr_b, lr_b, 1.0, gemm_helper_t);
+  TensorD ref_c = a.gemm(b, 1.0, gemm_helper_t);
+  ref_c.gemm(b, b, 1.0, gemm_helper_t);
+  BOOST_CHECK_LT(diff(c, ref_c), tol * ref_c.abs_max());
+}
+
+BOOST_AUTO_TEST_CASE( reduction )
+{
+  BOOST_CHECK_CLOSE(lr_a.sum(), a.sum(), 1.0e-8);
+  BOOST_CHECK_CLOSE(lr_a.trace(), a.trace(), 1.0e-8);
+  BOOST_CHECK_CLOSE(lr_a.squared_norm(), a.squared_norm(), 1.0e-8);
+  BOOST_CHECK_CLOSE(lr_a.norm(), a.norm(), 1.0e-8);
+  BOOST_CHECK_CLOSE(lr_a.dot(lr_b), a.dot(b), 1.0e-8);
+  BOOST_CHECK_CLOSE(lr_a.abs_max(), a.abs_max(), 1.0e-8);
+  BOOST_CHECK_EQUAL(LowRankD(a.range()).norm(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( serialization )
+{
+  madness::archive::BufferOutputArchive count;
+  count & lr_a;
+  std::vector<unsigned char> buf(count.size());
+  madness::archive::BufferOutputArchive oar(buf.data(), buf.size());
+  oar & lr_a;
+  oar.close();
+
+  LowRankD t;
+  madness::archive::BufferInputArchive iar(buf.data(), buf.size());
+  iar & t;
+  iar.close();
+
+  BOOST_CHECK_EQUAL(t.rank(), lr_a.rank());
+  BOOST_CHECK_LT(diff(t, a), tol);
+}
+
+BOOST_AUTO_TEST_CASE( array_contraction )
+{
+  typedef TiledArray::DistArray<LowRankD> LowRankArray;
+
+  std::array<std::size_t, 3> tiling = {{ 0, 17, 34 }};
+  TiledArray::TiledRange1 tr1(tiling.begin(), tiling.end());
+  TiledArray::TiledRange trange({ tr1, tr1 });
+
+  LowRankArray x(*GlobalFixture::world, trange), y(*GlobalFixture::world, trange);
+  TiledArray::TArrayD x_ref(*GlobalFixture::world, trange),
+      y_ref(*GlobalFixture::world, trange);
+  for(auto it = x.pmap()->begin(); it != x.pmap()->end(); ++it) {
+    const Range range = trange.make_tile_range(*it);
+    TensorD xt = make_dense(range, 2ul, int(*it));
+    TensorD yt = make_dense(range, 1ul, int(*it) + 5);
+    x.set(*it, LowRankD(xt));
+    y.set(*it, LowRankD(yt));
+    x_ref.set(*it, xt);
+    y_ref.set(*it, yt);
+  }
+  GlobalFixture::world->gop.fence();
+
+  LowRankArray z;
+  TiledArray::TArrayD z_ref;
+  BOOST_REQUIRE_NO_THROW(z("i,j") = 2.0 * (x("i,k") * y("j,k")) + x("i,j"));
+  z_ref("i,j") = 2.0 * (x_ref("i,k") * y_ref("j,k")) + x_ref("i,j");
+
+  for(auto it = z.pmap()->begin(); it != z.pmap()->end(); ++it) {
+    const LowRankD tile = z.find(*it).get();
+    const TensorD ref = z_ref.find(*it).get();
+    BOOST_CHECK_LE(tile.rank(), 3ul);
+    BOOST_CHECK_LT(diff(tile, ref), tol * ref.abs_max());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -863,4 +863,65 @@ BOOST_AUTO_TEST_CASE( dot )
   BOOST_CHECK_EQUAL(x, expected);
 }
 
+BOOST_AUTO_TEST_CASE( gemm_mult )
+{
+  // Tensors of tensors with inner tensors of the same range
+  Tensor<Tensor<int> > x(Range(size)), y(Range(size));
+  for(std::size_t i = 0ul; i < x.size(); ++i) {
+    x[i] = make_rand_tensor(Range(4, 3));
+    y[i] = make_rand_tensor(Range(4, 3));
+  }
+
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  Tensor<Tensor<int> > t;
+  BOOST_REQUIRE_NO_THROW(t = x.gemm(y, 3, gemm_helper));
+  BOOST_CHECK_EQUAL(t.range(), Range(size));
+
+  for(std::size_t i = 0ul; i < size[0]; ++i) {
+    for(std::size_t j = 0ul; j < size[1]; ++j) {
+      Tensor<int> expected(Range(4, 3), 0);
+      for(std::size_t l = 0ul; l < size[1]; ++l)
+        expected.add_to(x(i,l).mult(y(l,j), 3));
+
+      BOOST_CHECK_EQUAL(t(i,j).range(), expected.range());
+      for(std::size_t index = 0ul; index < expected.size(); ++index)
+        BOOST_CHECK_EQUAL(t(i,j)[index], expected[index]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( gemm_contract )
+{
+  math::GemmHelper gemm_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+  math::GemmHelper inner_helper(madness::cblas::NoTrans, madness::cblas::NoTrans,
+      2u, 2u, 2u);
+
+  // The inner tensor a(i,l) has range [10i, 10l) and b(l,j) has [10l, 10j),
+  // so the inner tensors are conformal for a matrix product.
+  Tensor<Tensor<int> > t;
+  BOOST_REQUIRE_NO_THROW(t = a.gemm(b, 2, gemm_helper, inner_helper));
+  BOOST_CHECK_EQUAL(t.range(), Range(size));
+
+  for(std::size_t i = 0ul; i < size[0]; ++i) {
+    for(std::size_t j = 0ul; j < size[1]; ++j) {
+      Tensor<int> expected = a(i,0).gemm(b(0,j), 2, inner_helper);
+      for(std::size_t l = 1ul; l < size[1]; ++l)
+        expected.gemm(a(i,l), b(l,j), 2, inner_helper);
+
+      BOOST_CHECK_EQUAL(t(i,j).range(), expected.range());
+      for(std::size_t index = 0ul; index < expected.size(); ++index)
+        BOOST_CHECK_EQUAL(t(i,j)[index], expected[index]);
+    }
+  }
+
+  // Accumulate into an existing result
+  Tensor<Tensor<int> > t2 = a.gemm(b, 2, gemm_helper, inner_helper);
+  BOOST_REQUIRE_NO_THROW(t2.gemm(a, b, 2, gemm_helper, inner_helper));
+  for(std::size_t i = 0ul; i < t.size(); ++i)
+    for(std::size_t index = 0ul; index < t[i].size(); ++index)
+      BOOST_CHECK_EQUAL(t2[i][index], 2 * t[i][index]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,306 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tensor_pool_allocator.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+#include "TiledArray/tensor/pool_allocator.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using TiledArray::HugePageAllocator;
+using TiledArray::PinnedAllocator;
+using TiledArray::PoolAllocator;
+using TiledArray::PoolStatistics;
+using TiledArray::Range;
+using TiledArray::detail::TilePool;
+
+struct PoolAllocatorFixture {
+
+  PoolAllocatorFixture() {
+    TilePool::instance().release();
+    TilePool::instance().reset_statistics();
+    TilePool::pinned_instance().release();
+    TilePool::pinned_instance().reset_statistics();
+    TilePool::huge_instance().release();
+    TilePool::huge_instance().reset_statistics();
+  }
+
+  ~PoolAllocatorFixture() {
+    TilePool::instance().release();
+    TilePool::instance().reset_statistics();
+    TilePool::pinned_instance().release();
+    TilePool::pinned_instance().reset_statistics();
+    TilePool::huge_instance().release();
+    TilePool::huge_instance().reset_statistics();
+  }
+
+}; // PoolAllocatorFixture
+
+BOOST_FIXTURE_TEST_SUITE( tensor_pool_allocator_suite, PoolAllocatorFixture )
+
+BOOST_AUTO_TEST_CASE( size_class )
+{
+  // Check that each size class holds the requests mapped to it
+  for(std::size_t bytes = 1ul; bytes <= (1ul << 16); ++bytes) {
+    const unsigned int c = TilePool::size_class(bytes);
+    BOOST_REQUIRE_LT(c, TilePool::num_classes);
+    BOOST_CHECK_GE(TilePool::class_bytes(c), bytes);
+    if(c > 0u)
+      BOOST_CHECK_LT(TilePool::class_bytes(c - 1u), bytes);
+  }
+
+  // Check that class sizes map back to their own class
+  for(unsigned int c = 0u; c < TilePool::num_classes; ++c)
+    BOOST_CHECK_EQUAL(TilePool::size_class(TilePool::class_bytes(c)), c);
+
+  BOOST_CHECK_EQUAL(TilePool::class_bytes(TilePool::num_classes - 1u),
+      TilePool::max_bytes);
+}
+
+BOOST_AUTO_TEST_CASE( allocate )
+{
+  PoolAllocator<double> alloc;
+
+  double* p = nullptr;
+  BOOST_REQUIRE_NO_THROW(p = alloc.allocate(1000ul));
+  BOOST_CHECK(p != nullptr);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % TilePool::alignment, 0ul);
+
+  PoolStatistics stats = TiledArray::pool_statistics();
+  BOOST_CHECK_EQUAL(stats.hits, 0ul);
+  BOOST_CHECK_EQUAL(stats.misses, 1ul);
+  BOOST_CHECK_EQUAL(stats.cached_bytes, 0ul);
+
+  // Freed blocks are cached, and reused by requests of the same size class
+  alloc.deallocate(p, 1000ul);
+  stats = TiledArray::pool_statistics();
+  BOOST_CHECK_EQUAL(stats.cached_bytes,
+      TilePool::class_bytes(TilePool::size_class(1000ul * sizeof(double))));
+
+  double* q = nullptr;
+  BOOST_REQUIRE_NO_THROW(q = alloc.allocate(990ul));
+  BOOST_CHECK_EQUAL(q, p);
+  stats = TiledArray::pool_statistics();
+  BOOST_CHECK_EQUAL(stats.hits, 1ul);
+  BOOST_CHECK_EQUAL(stats.misses, 1ul);
+  BOOST_CHECK_EQUAL(stats.cached_bytes, 0ul);
+  alloc.deallocate(q, 990ul);
+
+  // Large requests bypass the pool
+  const std::size_t n = TilePool::max_bytes / sizeof(double) + 1ul;
+  BOOST_REQUIRE_NO_THROW(p = alloc.allocate(n));
+  alloc.deallocate(p, n);
+  stats = TiledArray::pool_statistics();
+  BOOST_CHECK_EQUAL(stats.unpooled, 1ul);
+
+  // Release frees all cached blocks
+  TilePool::instance().release();
+  BOOST_CHECK_EQUAL(TiledArray::pool_statistics().cached_bytes, 0ul);
+}
+
+BOOST_AUTO_TEST_CASE( spill )
+{
+  PoolAllocator<float> alloc;
+  std::vector<float*> blocks;
+  for(std::size_t i = 0ul; i < 4ul * TilePool::thread_cache_size; ++i)
+    blocks.push_back(alloc.allocate(100ul));
+  for(float* p : blocks)
+    alloc.deallocate(p, 100ul);
+
+  // All freed blocks are held by the thread and shared caches
+  const std::size_t bytes = TilePool::class_bytes(TilePool::size_class(100ul * sizeof(float)));
+  BOOST_CHECK_EQUAL(TiledArray::pool_statistics().cached_bytes, blocks.size() * bytes);
+
+  for(std::size_t i = 0ul; i < blocks.size(); ++i)
+    blocks[i] = alloc.allocate(100ul);
+  PoolStatistics stats = TiledArray::pool_statistics();
+  BOOST_CHECK_EQUAL(stats.hits, blocks.size());
+  BOOST_CHECK_EQUAL(stats.misses, blocks.size());
+
+  for(float* p : blocks)
+    alloc.deallocate(p, 100ul);
+}
+
+BOOST_AUTO_TEST_CASE( max_cached )
+{
+  using TiledArray::MemoryCategory;
+  using TiledArray::memory_usage;
+
+  TilePool& pool = TilePool::instance();
+  const std::size_t max_cached = pool.max_cached_bytes();
+  const std::size_t bytes = TilePool::class_bytes(TilePool::size_class(100ul * sizeof(float)));
+
+  // The caches of other threads may hold blocks
+  const std::size_t cached = TiledArray::pool_statistics().cached_bytes;
+  const std::size_t live = memory_usage(MemoryCategory::pool).live;
+
+  PoolAllocator<float> alloc;
+  std::vector<float*> blocks;
+  for(std::size_t i = 0ul; i < 4ul * TilePool::thread_cache_size; ++i)
+    blocks.push_back(alloc.allocate(100ul));
+
+  // Blocks that do not fit within the limit are not cached
+  pool.set_max_cached_bytes(cached + 3ul * bytes);
+  for(float* p : blocks)
+    alloc.deallocate(p, 100ul);
+  BOOST_CHECK_EQUAL(TiledArray::pool_statistics().cached_bytes, cached + 3ul * bytes);
+
+  // The cached bytes are counted by the memory tracker
+  BOOST_CHECK_EQUAL(memory_usage(MemoryCategory::pool).live, live + 3ul * bytes);
+
+  // Lowering the limit frees the blocks of the shared caches
+  pool.set_max_cached_bytes(0ul);
+  const std::size_t trimmed = TiledArray::pool_statistics().cached_bytes;
+  BOOST_CHECK_LE(trimmed, cached + 3ul * bytes);
+  BOOST_CHECK_EQUAL(memory_usage(MemoryCategory::pool).live + cached, live + trimmed);
+
+  // The blocks of the thread cache are still reused, but freed blocks are
+  // no longer cached
+  for(std::size_t i = 0ul; i < 3ul; ++i)
+    blocks[i] = alloc.allocate(100ul);
+  for(std::size_t i = 0ul; i < 3ul; ++i)
+    alloc.deallocate(blocks[i], 100ul);
+  BOOST_CHECK_EQUAL(TiledArray::pool_statistics().cached_bytes, trimmed - 3ul * bytes);
+  BOOST_CHECK_EQUAL(memory_usage(MemoryCategory::pool).live + cached + 3ul * bytes,
+      live + trimmed);
+
+  pool.set_max_cached_bytes(max_cached);
+}
+
+BOOST_AUTO_TEST_CASE( domain )
+{
+  BOOST_CHECK_LT(TilePool::domain(), TilePool::max_domains);
+
+  // Blocks spilled to the shared cache of this thread's domain are reused
+  PoolAllocator<double> alloc;
+  std::vector<double*> blocks;
+  for(std::size_t i = 0ul; i < 2ul * TilePool::thread_cache_size; ++i)
+    blocks.push_back(alloc.allocate(10ul));
+  for(double* p : blocks)
+    alloc.deallocate(p, 10ul);
+  for(std::size_t i = 0ul; i < blocks.size(); ++i)
+    blocks[i] = alloc.allocate(10ul);
+  BOOST_CHECK_EQUAL(TiledArray::pool_statistics().hits, blocks.size());
+
+  for(double* p : blocks)
+    alloc.deallocate(p, 10ul);
+}
+
+BOOST_AUTO_TEST_CASE( pinned )
+{
+  BOOST_CHECK(! TilePool::instance().pinned());
+  BOOST_CHECK(TilePool::pinned_instance().pinned());
+
+  PinnedAllocator<double> alloc;
+  double* p = nullptr;
+  BOOST_REQUIRE_NO_THROW(p = alloc.allocate(1000ul));
+  BOOST_CHECK(p != nullptr);
+  alloc.deallocate(p, 1000ul);
+
+  // Pinned blocks are recycled by the pinned pool only
+  double* q = alloc.allocate(1000ul);
+  BOOST_CHECK_EQUAL(q, p);
+  PoolStatistics stats = TiledArray::pinned_pool_statistics();
+  BOOST_CHECK_EQUAL(stats.hits, 1ul);
+  BOOST_CHECK_EQUAL(stats.misses, 1ul);
+  BOOST_CHECK_EQUAL(TiledArray::pool_statistics().misses, 0ul);
+  alloc.deallocate(q, 1000ul);
+
+  // Pinned tiles have the same wire format as other tiles
+  typedef TiledArray::Tensor<double, PinnedAllocator<double> > TensorP;
+  Range r(std::array<int, 2>{{3, 5}});
+  TensorP t(r, 2.0);
+  std::size_t buf_size = r.volume() * sizeof(double) * 4ul + 1024ul;
+  std::vector<unsigned char> buf(buf_size);
+  madness::archive::BufferOutputArchive oar(buf.data(), buf_size);
+  oar & t;
+  std::size_t nbyte = oar.size();
+  oar.close();
+
+  TiledArray::Tensor<double> s;
+  madness::archive::BufferInputArchive iar(buf.data(), nbyte);
+  iar & s;
+  iar.close();
+  BOOST_CHECK_EQUAL(s.range(), r);
+  for(auto value : s)
+    BOOST_CHECK_EQUAL(value, 2.0);
+}
+
+BOOST_AUTO_TEST_CASE( huge )
+{
+  BOOST_CHECK(! TilePool::instance().huge());
+  BOOST_CHECK(TilePool::huge_instance().huge());
+
+  // Large blocks are aligned to a huge page
+  HugePageAllocator<double> alloc;
+  const std::size_t n = TilePool::huge_instance().huge_threshold() / sizeof(double) + 1ul;
+  double* p = nullptr;
+  BOOST_REQUIRE_NO_THROW(p = alloc.allocate(n));
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(p) % TilePool::huge_page_bytes, 0ul);
+  std::fill(p, p + n, 1.0);
+  alloc.deallocate(p, n);
+
+  // Huge blocks are recycled by the pool
+  double* q = alloc.allocate(n);
+  BOOST_CHECK_EQUAL(q, p);
+  PoolStatistics stats = TiledArray::huge_pool_statistics();
+  BOOST_CHECK_EQUAL(stats.hits, 1ul);
+  BOOST_CHECK_EQUAL(stats.misses, 1ul);
+  alloc.deallocate(q, n);
+
+  // Small blocks are not backed by huge pages
+  double* r = alloc.allocate(10ul);
+  BOOST_CHECK(r != nullptr);
+  alloc.deallocate(r, 10ul);
+
+  typedef TiledArray::Tensor<double, HugePageAllocator<double> > TensorH;
+  Range range(std::array<int, 2>{{512, 513}});
+  TensorH t(range, 2.0);
+  for(auto value : t)
+    BOOST_CHECK_EQUAL(value, 2.0);
+}
+
+BOOST_AUTO_TEST_CASE( tensor )
+{
+  typedef TiledArray::Tensor<double, PoolAllocator<double> > TensorN;
+
+  Range r(std::array<int, 2>{{3, 5}});
+  TensorN t(r, 1.0);
+  BOOST_CHECK_EQUAL(t.range(), r);
+  for(auto value : t)
+    BOOST_CHECK_EQUAL(value, 1.0);
+
+  TensorN s = t.scale(2.0);
+  for(auto value : s)
+    BOOST_CHECK_EQUAL(value, 2.0);
+
+  PoolStatistics stats = TiledArray::pool_statistics();
+  BOOST_CHECK_EQUAL(stats.misses, 2ul);
+
+  // A new tile of the same size reuses freed memory
+  t = TensorN();
+  TensorN u(r, 3.0);
+  BOOST_CHECK_EQUAL(TiledArray::pool_statistics().hits, stats.hits + 1ul);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -406,4 +406,51 @@ BOOST_AUTO_TEST_CASE( scale_to_view )
   }
 }
 
+BOOST_AUTO_TEST_CASE( gemm_view )
+{
+  auto make_tensor = [] (const Range& range) {
+    Tensor<double> result(range);
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      result[i] = std::sin(double(i + 1ul));
+    return result;
+  };
+  auto check_gemm = [] (const TensorView<double>& left,
+      const Tensor<double>& right, const math::GemmHelper& gemm_helper)
+  {
+    Tensor<double> result = left.gemm(right, 2.0, gemm_helper);
+    Tensor<double> ref = Tensor<double>(left).gemm(right, 2.0, gemm_helper);
+    BOOST_REQUIRE_EQUAL(result.range(), ref.range());
+    for(std::size_t i = 0ul; i < result.size(); ++i)
+      BOOST_CHECK_CLOSE_FRACTION(result[i] + 10.0, ref[i] + 10.0, 1.0e-12);
+  };
+
+  // Matrix blocks are used in place with the row stride of the parent tensor
+  Tensor<double> a = make_tensor(Range(9, 12));
+  Tensor<double> b = make_tensor(Range(10, 8));
+  math::GemmHelper nn(madness::cblas::NoTrans, madness::cblas::NoTrans, 2u, 2u, 2u);
+  math::GemmHelper tn(madness::cblas::Trans, madness::cblas::NoTrans, 2u, 2u, 2u);
+  TensorView<double> a_block = a.block({2, 3}, {7, 10});
+  BOOST_CHECK_EQUAL(nn.left_leading_dimension(a_block.range()), 12);
+  BOOST_CHECK_EQUAL(tn.left_leading_dimension(a_block.range()), 12);
+  check_gemm(a_block, Tensor<double>(b.block({1, 2}, {8, 6})), nn);
+  check_gemm(a_block, Tensor<double>(b.block({1, 2}, {6, 6})), tn);
+
+  // Contiguous tensors have their natural leading dimension
+  BOOST_CHECK_EQUAL(nn.left_leading_dimension(a.range()), 12);
+  BOOST_CHECK_EQUAL(nn.right_leading_dimension(b.range()), 8);
+
+  // Fused rows with a uniform stride
+  Tensor<double> c = make_tensor(Range(6, 5, 9));
+  TensorView<double> c_block = c.block({1, 0, 2}, {4, 5, 7});
+  math::GemmHelper nn_3(madness::cblas::NoTrans, madness::cblas::NoTrans, 3u, 3u, 2u);
+  BOOST_CHECK_EQUAL(nn_3.left_leading_dimension(c_block.range()), 9);
+  check_gemm(c_block, make_tensor(Range(5, 4)), nn_3);
+
+  // Fused columns that are not contiguous are copied
+  TensorView<double> c_strided = c.block({1, 1, 2}, {4, 4, 7});
+  math::GemmHelper nn_2(madness::cblas::NoTrans, madness::cblas::NoTrans, 2u, 3u, 3u);
+  BOOST_CHECK_EQUAL(nn_2.left_leading_dimension(c_strided.range()), 0);
+  check_gemm(c_strided, make_tensor(Range(3, 5, 4)), nn_2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
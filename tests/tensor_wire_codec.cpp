@@ -0,0 +1,203 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tensor_wire_codec.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+#include "TiledArray/tensor/wire_codec.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using TiledArray::Range;
+using TiledArray::detail::WireCodec;
+using TiledArray::detail::WireTile;
+
+struct WireCodecFixture {
+  typedef TiledArray::Tensor<double> TensorD;
+
+  WireCodecFixture() : t(Range(std::vector<std::size_t>{ 11, 13, 17 })) {
+    // Mostly zero elements with a few small and large elements
+    for(std::size_t i = 0ul; i < t.size(); ++i)
+      t[i] = (i % 7ul == 0ul ? double(i) + 0.5 : (i % 11ul == 0ul ? 1.0e-12 : 0.0));
+  }
+
+  ~WireCodecFixture() { WireCodec::instance().disable(); }
+
+  /// Serialize an object into a buffer and back
+
+  /// \param object The object to be serialized
+  /// \param[out] nbyte The size of the serialized object
+  /// \return The deserialized object
+  template <typename T>
+  static T copy(const T& object, std::size_t& nbyte) {
+    madness::archive::BufferOutputArchive count;
+    count & object;
+    nbyte = count.size();
+
+    std::vector<unsigned char> buf(nbyte);
+    madness::archive::BufferOutputArchive oar(buf.data(), buf.size());
+    oar & object;
+    BOOST_CHECK_EQUAL(oar.size(), nbyte);
+    oar.close();
+
+    T result;
+    madness::archive::BufferInputArchive iar(buf.data(), buf.size());
+    iar & result;
+    iar.close();
+    return result;
+  }
+
+  /// Send a tensor to another process
+
+  /// \param tensor The tensor to be sent
+  /// \param[out] nbyte The size of the message
+  /// \return The received tensor
+  template <typename T>
+  static T send(const T& tensor, std::size_t& nbyte) {
+    return copy(WireTile<T>(tensor), nbyte).tile();
+  }
+
+  TensorD t;
+}; // WireCodecFixture
+
+BOOST_FIXTURE_TEST_SUITE( wire_codec_suite, WireCodecFixture )
+
+BOOST_AUTO_TEST_CASE( raw )
+{
+  std::size_t nbyte = 0ul;
+  TensorD r = send(t, nbyte);
+  BOOST_CHECK_EQUAL(r.range(), t.range());
+  BOOST_CHECK_EQUAL_COLLECTIONS(r.begin(), r.end(), t.begin(), t.end());
+  BOOST_CHECK_GE(nbyte, t.size() * sizeof(double));
+}
+
+BOOST_AUTO_TEST_CASE( lossless )
+{
+  std::size_t raw_nbyte = 0ul, nbyte = 0ul;
+  send(t, raw_nbyte);
+
+  WireCodec::instance().enable_lossless();
+  BOOST_CHECK_EQUAL(WireCodec::instance().codec(), WireCodec::lossless);
+  TensorD r = send(t, nbyte);
+  BOOST_CHECK_EQUAL(r.range(), t.range());
+  BOOST_CHECK_EQUAL_COLLECTIONS(r.begin(), r.end(), t.begin(), t.end());
+  BOOST_CHECK_LT(nbyte, raw_nbyte / 2ul);
+
+  // Integer tiles
+  TiledArray::Tensor<int> ti(t.range());
+  for(std::size_t i = 0ul; i < ti.size(); ++i)
+    ti[i] = int(i % 5ul);
+  TiledArray::Tensor<int> ri = send(ti, nbyte);
+  BOOST_CHECK_EQUAL_COLLECTIONS(ri.begin(), ri.end(), ti.begin(), ti.end());
+}
+
+BOOST_AUTO_TEST_CASE( incompressible )
+{
+  // Data that cannot be compressed is sent raw
+  std::srand(27);
+  for(std::size_t i = 0ul; i < t.size(); ++i)
+    t[i] = std::ldexp(double(std::rand()) + std::ldexp(double(std::rand()), -31),
+        std::rand() % 1000 - 500);
+  std::size_t raw_nbyte = 0ul, nbyte = 0ul;
+  send(t, raw_nbyte);
+
+  WireCodec::instance().enable_lossless();
+  TensorD r = send(t, nbyte);
+  BOOST_CHECK_EQUAL_COLLECTIONS(r.begin(), r.end(), t.begin(), t.end());
+  BOOST_CHECK_EQUAL(nbyte, raw_nbyte);
+}
+
+BOOST_AUTO_TEST_CASE( lossy )
+{
+  std::size_t lossless_nbyte = 0ul, nbyte = 0ul;
+  WireCodec::instance().enable_lossless();
+  send(t, lossless_nbyte);
+
+  const double tolerance = 1.0e-8;
+  WireCodec::instance().enable_lossy(tolerance);
+  BOOST_CHECK_EQUAL(WireCodec::instance().codec(), WireCodec::lossy);
+  BOOST_CHECK_EQUAL(WireCodec::instance().tolerance(), tolerance);
+  TensorD r = send(t, nbyte);
+  BOOST_CHECK_EQUAL(r.range(), t.range());
+  BOOST_CHECK_LT(nbyte, lossless_nbyte);
+  for(std::size_t i = 0ul; i < t.size(); ++i) {
+    BOOST_CHECK_LT(std::abs(r[i] - t[i]), tolerance);
+    if(std::abs(t[i]) >= tolerance)
+      BOOST_CHECK_EQUAL(r[i], t[i]);
+  }
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(WireCodec::instance().enable_lossy(-1.0), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( local )
+{
+  // Tensors that are not sent, e.g. checkpoints and spilled tiles, are not
+  // encoded
+  std::size_t raw_nbyte = 0ul, nbyte = 0ul;
+  copy(t, raw_nbyte);
+
+  WireCodec::instance().enable_lossy(1.0e-8);
+  TensorD r = copy(t, nbyte);
+  BOOST_CHECK_EQUAL(nbyte, raw_nbyte);
+  BOOST_CHECK_EQUAL_COLLECTIONS(r.begin(), r.end(), t.begin(), t.end());
+}
+
+BOOST_AUTO_TEST_CASE( snapshot )
+{
+  // The codec of a message is fixed when the tensor is wrapped
+  WireCodec::instance().enable_lossless();
+  const WireTile<TensorD> wire(t);
+
+  madness::archive::BufferOutputArchive count;
+  count & wire;
+  std::vector<unsigned char> buf(count.size());
+
+  WireCodec::instance().disable();
+  madness::archive::BufferOutputArchive oar(buf.data(), buf.size());
+  oar & wire;
+  BOOST_CHECK_EQUAL(oar.size(), buf.size());
+  oar.close();
+
+  WireTile<TensorD> result;
+  madness::archive::BufferInputArchive iar(buf.data(), buf.size());
+  iar & result;
+  iar.close();
+  BOOST_CHECK_EQUAL_COLLECTIONS(result.tile().begin(), result.tile().end(),
+      t.begin(), t.end());
+}
+
+BOOST_AUTO_TEST_CASE( coalesced )
+{
+  WireCodec::instance().enable_lossless();
+  std::vector<TensorD> tiles{ t, TensorD(), t.clone() };
+  std::size_t nbyte = 0ul;
+  std::vector<TensorD> r = send(tiles, nbyte);
+  BOOST_REQUIRE_EQUAL(r.size(), tiles.size());
+  BOOST_CHECK(r[1].empty());
+  BOOST_CHECK_EQUAL_COLLECTIONS(r[0].begin(), r[0].end(), t.begin(), t.end());
+  BOOST_CHECK_EQUAL_COLLECTIONS(r[2].begin(), r[2].end(), t.begin(), t.end());
+  BOOST_CHECK_LT(nbyte, t.size() * sizeof(double));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
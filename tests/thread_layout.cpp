@@ -0,0 +1,127 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  thread_layout.cpp
+ *  Oct 15, 2016
+ *
+ */
+
+#include "TiledArray/thread_layout.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using namespace TiledArray;
+
+struct ThreadLayoutFixture {
+  ThreadLayoutFixture() :
+    domains({ detail::parse_cpulist("0-7"), detail::parse_cpulist("8-15") })
+  { }
+
+  std::vector<std::vector<int> > domains; ///< Two NUMA domains of 8 cores
+}; // ThreadLayoutFixture
+
+BOOST_FIXTURE_TEST_SUITE( thread_layout_suite, ThreadLayoutFixture )
+
+BOOST_AUTO_TEST_CASE( parse_cpulist )
+{
+  const std::vector<int> cpus = detail::parse_cpulist("0-3,8,10-11\n");
+  const std::vector<int> expected = { 0, 1, 2, 3, 8, 10, 11 };
+  BOOST_CHECK_EQUAL_COLLECTIONS(cpus.begin(), cpus.end(),
+      expected.begin(), expected.end());
+  BOOST_CHECK(detail::parse_cpulist("").empty());
+}
+
+BOOST_AUTO_TEST_CASE( unbound )
+{
+  ThreadLayoutOptions options;
+  options.compute_threads = 4;
+  const ThreadLayout layout = detail::make_thread_layout(options, domains, 1, 2);
+  BOOST_CHECK_EQUAL(layout.compute_threads, 4);
+  BOOST_CHECK_EQUAL(layout.main_cpu, -1);
+  BOOST_CHECK_EQUAL(layout.comm_cpu, -1);
+  BOOST_CHECK_EQUAL(layout.first_compute_cpu, -1);
+  BOOST_CHECK_EQUAL(layout.local_rank, 1);
+  BOOST_CHECK_EQUAL(layout.local_size, 2);
+}
+
+BOOST_AUTO_TEST_CASE( bound )
+{
+  ThreadLayoutOptions options;
+  options.bind = true;
+
+  // Two ranks share the 16 cores of the node
+  ThreadLayout layout = detail::make_thread_layout(options, domains, 1, 2);
+  BOOST_CHECK_EQUAL(layout.main_cpu, 8);
+  BOOST_CHECK_EQUAL(layout.comm_cpu, 9);
+  BOOST_CHECK_EQUAL(layout.first_compute_cpu, 10);
+  BOOST_CHECK_EQUAL(layout.compute_threads, 6);
+  BOOST_CHECK_EQUAL(layout.numa_domain, -1);
+
+  // The communication thread shares the core of the main thread
+  options.comm_core = false;
+  layout = detail::make_thread_layout(options, domains, 0, 1);
+  BOOST_CHECK_EQUAL(layout.main_cpu, 0);
+  BOOST_CHECK_EQUAL(layout.comm_cpu, 0);
+  BOOST_CHECK_EQUAL(layout.first_compute_cpu, 1);
+  BOOST_CHECK_EQUAL(layout.compute_threads, 15);
+}
+
+BOOST_AUTO_TEST_CASE( numa )
+{
+  ThreadLayoutOptions options;
+  options.bind = true;
+  options.numa = true;
+
+  // Four ranks, two in each domain
+  ThreadLayout layout = detail::make_thread_layout(options, domains, 2, 4);
+  BOOST_CHECK_EQUAL(layout.numa_domain, 1);
+  BOOST_CHECK_EQUAL(layout.main_cpu, 8);
+  BOOST_CHECK_EQUAL(layout.comm_cpu, 9);
+  BOOST_CHECK_EQUAL(layout.first_compute_cpu, 10);
+  BOOST_CHECK_EQUAL(layout.compute_threads, 2);
+
+  // One rank on the node uses the first domain
+  layout = detail::make_thread_layout(options, domains, 0, 1);
+  BOOST_CHECK_EQUAL(layout.numa_domain, 0);
+  BOOST_CHECK_EQUAL(layout.first_compute_cpu, 2);
+  BOOST_CHECK_EQUAL(layout.compute_threads, 6);
+
+  // Compute threads are limited to consecutive cores
+  const std::vector<std::vector<int> > split = { detail::parse_cpulist("0-3,8-11") };
+  layout = detail::make_thread_layout(options, split, 0, 1);
+  BOOST_CHECK_EQUAL(layout.numa_domain, -1);
+  BOOST_CHECK_EQUAL(layout.first_compute_cpu, 2);
+  BOOST_CHECK_EQUAL(layout.compute_threads, 2);
+}
+
+BOOST_AUTO_TEST_CASE( report )
+{
+  BOOST_CHECK_GT(thread_layout().compute_threads, 0);
+
+  ThreadLayoutOptions options;
+  options.bind = true;
+  const ThreadLayout layout = detail::make_thread_layout(options, domains, 0, 1);
+  std::stringstream ss;
+  layout.print(ss, 0);
+  BOOST_CHECK(ss.str().find("main thread on core 0") != std::string::npos);
+  BOOST_CHECK(ss.str().find("compute threads on cores 2-15") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,115 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_accumulator.cpp
+ *  Oct 15, 2026
+ *
+ */
+
+#include "TiledArray/tile_accumulator.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct TileAccumulatorFixture {
+
+  TileAccumulatorFixture() :
+    world(*GlobalFixture::world),
+    trange({ TiledRange1{0, 3, 8, 12}, TiledRange1{0, 5, 10} })
+  { }
+
+  // Each process adds ones to each tile, and process 0 also adds 2 to the
+  // first element of each tile with a one element block
+  template <typename Array>
+  void add(TileAccumulator<Array>& acc, const std::size_t tiles) const {
+    for(std::size_t i = 0ul; i < tiles; ++i) {
+      const Range range = trange.make_tile_range(i);
+      acc.add(trange.tiles_range().idx(i), TensorI(range, 1));
+      if(world.rank() == 0) {
+        std::vector<std::size_t> lower(range.lobound_data(),
+            range.lobound_data() + range.rank());
+        std::vector<std::size_t> upper = lower;
+        for(auto& u : upper)
+          ++u;
+        acc.add(i, TensorI(Range(lower, upper), 2));
+      }
+    }
+  }
+
+  // The expected value of an element of a tile with contributions
+  int value(const Range& range, const Range::index& index) const {
+    const bool first = std::equal(index.begin(), index.end(), range.lobound_data());
+    return world.size() + (first ? 2 : 0);
+  }
+
+  World& world;
+  TiledRange trange;
+}; // TileAccumulatorFixture
+
+BOOST_FIXTURE_TEST_SUITE( tile_accumulator_suite, TileAccumulatorFixture )
+
+BOOST_AUTO_TEST_CASE( dense )
+{
+  TileAccumulator<TArrayI> acc(world, trange);
+  add(acc, trange.tiles_range().volume());
+  TArrayI a;
+  BOOST_REQUIRE_NO_THROW(a = acc.array());
+  BOOST_CHECK_EQUAL(a.trange(), trange);
+
+  for(const auto i : *a.pmap()) {
+    const TensorI tile = a.find(i).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], value(tile.range(), index));
+  }
+
+  // The array can only be built once
+  BOOST_CHECK_THROW(acc.array(), TiledArray::Exception);
+}
+
+BOOST_AUTO_TEST_CASE( sparse )
+{
+  // Only the tiles of the first tile row have contributions
+  TileAccumulator<TSpArrayI> acc(world, trange);
+  add(acc, 2ul);
+  TSpArrayI a = acc.array();
+
+  for(const auto i : *a.pmap()) {
+    BOOST_CHECK_EQUAL(a.is_zero(i), i >= 2ul);
+    if(a.is_zero(i))
+      continue;
+    const TensorI tile = a.find(i).get();
+    for(const auto& index : tile.range())
+      BOOST_CHECK_EQUAL(tile[index], value(tile.range(), index));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( out_of_range )
+{
+  TileAccumulator<TArrayI> acc(world, trange);
+  BOOST_CHECK_THROW(acc.add(6ul, TensorI(trange.make_tile_range(0ul), 1)),
+      TiledArray::Exception);
+  BOOST_CHECK_THROW(acc.add(1ul, TensorI(trange.make_tile_range(0ul), 1)),
+      TiledArray::Exception);
+  acc.array();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
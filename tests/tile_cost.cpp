@@ -0,0 +1,149 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *  Justus Calvin
+ *  Department of Chemistry, Virginia Tech
+ *
+ *  tile_cost.cpp
+ *  Oct 14, 2016
+ *
+ */
+
+
+#include "TiledArray/tile_cost.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+
+using TiledArray::TileCostRecorder;
+
+struct TileCostFixture {
+
+  TileCostFixture() :
+    trange{TiledArray::TiledRange1(0, 3, 6, 9), TiledArray::TiledRange1(0, 3, 6, 9)},
+    a(*GlobalFixture::world, trange), b(*GlobalFixture::world, trange)
+  {
+    a.fill_local(1.0);
+    b.fill_local(2.0);
+  }
+
+  ~TileCostFixture() {
+    GlobalFixture::world->gop.fence();
+  }
+
+  TiledArray::TiledRange trange;
+  TiledArray::TArrayD a;
+  TiledArray::TArrayD b;
+}; // struct TileCostFixture
+
+
+BOOST_FIXTURE_TEST_SUITE( tile_cost_suite, TileCostFixture )
+
+BOOST_AUTO_TEST_CASE( record )
+{
+  TileCostRecorder recorder(4ul);
+  BOOST_CHECK_EQUAL(recorder.size(), 4ul);
+  recorder.record(1ul, std::chrono::milliseconds(2));
+  recorder.record(1ul, std::chrono::milliseconds(1));
+  BOOST_CHECK_CLOSE(recorder.local_cost(1ul), 0.003, 1.0e-6);
+  BOOST_CHECK_EQUAL(recorder.local_cost(0ul), 0.0);
+
+  // A scope without a recorder records nothing
+  {
+    TiledArray::detail::TileCostScope cost(nullptr, 0ul);
+  }
+  {
+    TiledArray::detail::TileCostScope cost(& recorder, 2ul);
+  }
+  BOOST_CHECK(recorder.local_cost(2ul) >= 0.0);
+
+  recorder.reset();
+  for(std::size_t i = 0ul; i < recorder.size(); ++i)
+    BOOST_CHECK_EQUAL(recorder.local_cost(i), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( costs )
+{
+  TileCostRecorder recorder(4ul);
+  if(GlobalFixture::world->rank() == 0)
+    recorder.record(3ul, std::chrono::seconds(1));
+  const std::vector<double> costs = recorder.costs(*GlobalFixture::world);
+  BOOST_CHECK_EQUAL(costs.size(), 4ul);
+  BOOST_CHECK_CLOSE(costs[3], 1.0, 1.0e-6);
+  BOOST_CHECK_EQUAL(costs[0], 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( expressions )
+{
+  auto recorder = std::make_shared<TileCostRecorder>(a.size());
+  TiledArray::TArrayD c;
+  BOOST_REQUIRE_NO_THROW(c("i,j") = (a("i,k") * b("k,j")).set_cost_recorder(recorder));
+  GlobalFixture::world->gop.fence();
+
+  // The result is not changed by recording
+  for(const auto index : *c.pmap()) {
+    const TiledArray::TensorD tile = c.find(index).get();
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_EQUAL(tile[j], 18.0);
+  }
+
+  double total = 0.0;
+  for(const double cost : recorder->costs(*GlobalFixture::world))
+    total += cost;
+  BOOST_CHECK(total > 0.0);
+
+  // Element-wise expressions record the cost of their tile operation
+  recorder->reset();
+  BOOST_REQUIRE_NO_THROW(c("i,j") = (a("i,j") + b("j,i")).set_cost_recorder(recorder));
+  GlobalFixture::world->gop.fence();
+  total = 0.0;
+  for(const double cost : recorder->costs(*GlobalFixture::world))
+    total += cost;
+  BOOST_CHECK(total > 0.0);
+}
+
+BOOST_AUTO_TEST_CASE( rebalance )
+{
+  // All the cost is in the first two tiles, which are on the first process
+  // of the default (blocked) process map
+  TileCostRecorder recorder(a.size());
+  if(GlobalFixture::world->rank() == 0) {
+    recorder.record(0ul, std::chrono::seconds(1));
+    recorder.record(1ul, std::chrono::seconds(1));
+  }
+
+  TiledArray::TArrayD c = a;
+  const bool moved = TiledArray::rebalance(c, recorder);
+  BOOST_CHECK_EQUAL(moved, GlobalFixture::world->size() > 1);
+  GlobalFixture::world->gop.fence();
+
+  if(moved)
+    BOOST_CHECK(TiledArray::detail::WeightedPmap::imbalance(*c.pmap(),
+        recorder.costs(*GlobalFixture::world)) <
+        TiledArray::detail::WeightedPmap::imbalance(*a.pmap(),
+        recorder.costs(*GlobalFixture::world)));
+  for(const auto index : *c.pmap()) {
+    const TiledArray::TensorD tile = c.find(index).get();
+    for(std::size_t j = 0ul; j < tile.size(); ++j)
+      BOOST_CHECK_EQUAL(tile[j], 1.0);
+  }
+
+  // A balanced map is kept
+  recorder.reset();
+  BOOST_CHECK(! TiledArray::rebalance(c, recorder));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -123,6 +123,26 @@ BOOST_AUTO_TEST_CASE( binary_add_right_zero )
   }
 }
 
+BOOST_AUTO_TEST_CASE( binary_add_zero_copy_on_write )
+{
+  Add<Tensor<int>, Tensor<int>, false, false> add_op;
+
+  // Store the sum of 0 and b in c
+  BOOST_CHECK_NO_THROW(c = add_op(ZeroTensor(), b));
+
+  // Check that c shares the data of b until it is modified
+  const Tensor<int>& cb = b;
+  const Tensor<int>& cc = c;
+  BOOST_CHECK_EQUAL(cc.data(), cb.data());
+
+  // Check that modifying c does not modify b
+  const int b0 = b[0];
+  c[0] += 1;
+  BOOST_CHECK_NE(cc.data(), cb.data());
+  BOOST_CHECK_EQUAL(b[0], b0);
+  BOOST_CHECK_EQUAL(c[0], b0 + 1);
+}
+
 BOOST_AUTO_TEST_CASE( binary_add_perm )
 {
   Add<Tensor<int>, Tensor<int>, false, false> add_op;
@@ -105,7 +105,41 @@ BOOST_AUTO_TEST_CASE( permute_empty )
 }
 #endif // TA_EXCEPTION_ERROR
 
-// TODO: Test non-empty permutation
+BOOST_AUTO_TEST_CASE( fused_permute )
+{
+  tensor_type left = make_tensor(2, 3, 20, 30);
+  tensor_type right = make_tensor(3, 4, 30, 40);
+  tensor_type right2 = make_tensor(3, 4, 30, 40);
+
+  // Compute the reference result without a permutation
+  ContractReduce<tensor_type, tensor_type, int>
+  ref_op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 2u, 2u, 2u);
+  BOOST_CHECK(! ref_op.fused_perm());
+  tensor_type ref;
+  ref_op(ref, left, right);
+  ref_op(ref, left, right2);
+  ref = ref_op(ref);
+
+  // The transpose of the result is formed directly by the contraction
+  const Permutation perm({1,0});
+  ContractReduce<tensor_type, tensor_type, int>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 2u, 2u, 2u, perm);
+  BOOST_CHECK(op.fused_perm());
+
+  tensor_type result;
+  BOOST_REQUIRE_NO_THROW(op(result, left, right));
+  BOOST_REQUIRE_NO_THROW(op(result, left, right2));
+  BOOST_CHECK_EQUAL(result.range(), perm * ref.range());
+
+  tensor_type final_result;
+  BOOST_REQUIRE_NO_THROW(final_result = op(result));
+  BOOST_CHECK_EQUAL(final_result.data(), result.data());
+
+  const tensor_type expected = permute(ref, perm);
+  BOOST_CHECK_EQUAL(final_result.range(), expected.range());
+  for(std::size_t i = 0ul; i < expected.size(); ++i)
+    BOOST_CHECK_EQUAL(final_result[i], expected[i]);
+}
 
 BOOST_AUTO_TEST_CASE( matrix_multiply )
 {
@@ -472,4 +506,56 @@ BOOST_AUTO_TEST_CASE( tensor_contract2 )
 }
 
 
+BOOST_AUTO_TEST_CASE( recycle_result )
+{
+  tensor_type left = make_tensor(2, 3, 20, 30);
+  tensor_type right = make_tensor(3, 4, 30, 40);
+
+  Eigen::Map<const matrix_type, Eigen::AutoAlign>
+    A(left.data(), 18, 27), B(right.data(), 27, 36);
+  matrix_type C = 3 * A * B;
+
+  ContractReduce<tensor_type, tensor_type, int>
+  op(madness::cblas::NoTrans, madness::cblas::NoTrans, 3, 2u, 2u, 2u);
+  op.reserve_result_pool(1ul);
+
+  tensor_type result;
+  BOOST_REQUIRE_NO_THROW(op(result, left, right));
+  const int* const data = result.data();
+
+  // Recycled results are reused by new partial results with the same extents
+  BOOST_REQUIRE_NO_THROW(op.recycle(result));
+  BOOST_CHECK(result.empty());
+
+  tensor_type left1 = make_tensor(0, 3, 18, 30);
+  tensor_type right1 = make_tensor(3, 0, 30, 36);
+  Eigen::Map<const matrix_type, Eigen::AutoAlign>
+    A1(left1.data(), 18, 27), B1(right1.data(), 27, 36);
+  matrix_type C1 = 3 * A1 * B1;
+
+  tensor_type result1;
+  BOOST_REQUIRE_NO_THROW(op(result1, left1, right1));
+  BOOST_CHECK_EQUAL(result1.data(), data);
+  BOOST_CHECK_EQUAL(result1.range().lobound(0), 0);
+  BOOST_CHECK_EQUAL(result1.range().lobound(1), 0);
+  BOOST_CHECK_EQUAL(result1.range().upbound(0), 18);
+  BOOST_CHECK_EQUAL(result1.range().upbound(1), 36);
+  Eigen::Map<const matrix_type, Eigen::AutoAlign> result1_map(result1.data(), 18, 36);
+  BOOST_CHECK_EQUAL(result1_map, C1);
+
+  // The pool is empty, so new results are allocated
+  tensor_type result2;
+  BOOST_REQUIRE_NO_THROW(op(result2, left, right));
+  BOOST_CHECK_NE(result2.data(), data);
+  Eigen::Map<const matrix_type, Eigen::AutoAlign> result2_map(result2.data(), 18, 36);
+  BOOST_CHECK_EQUAL(result2_map, C);
+
+  // Copies of the operation share the pool, which holds at most one tile
+  ContractReduce<tensor_type, tensor_type, int> op_copy(op);
+  BOOST_REQUIRE_NO_THROW(op_copy.recycle(result2));
+  BOOST_REQUIRE_NO_THROW(op.recycle(result1));
+  BOOST_CHECK(result2.empty());
+  BOOST_CHECK(! result1.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -149,5 +149,31 @@ BOOST_AUTO_TEST_CASE( make_tiles_range )
   }
 }
 
+BOOST_AUTO_TEST_CASE( cache_tile_ranges )
+{
+  TiledRange r(tr);
+  BOOST_CHECK(! r.tile_ranges_cached());
+  BOOST_REQUIRE_NO_THROW(r.cache_tile_ranges());
+  BOOST_CHECK(r.tile_ranges_cached());
+
+  // Check that cached and computed tile ranges match
+  TiledRange::size_type i = 0;
+  for(Range::const_iterator it = tr.tiles_range().begin(); it != tr.tiles_range().end(); ++it, ++i) {
+    BOOST_CHECK_EQUAL(r.make_tile_range(i), tr.make_tile_range(i));
+    BOOST_CHECK_EQUAL(r.make_tile_range(*it), tr.make_tile_range(*it));
+  }
+
+  // Check that copies share the cache and that permutation rebuilds it
+  TiledRange c(r);
+  BOOST_CHECK(c.tile_ranges_cached());
+  BOOST_CHECK_EQUAL(c, tr);
+  Permutation p({2,0,1});
+  TiledRange pr = p * tr;
+  c *= p;
+  BOOST_CHECK(c.tile_ranges_cached());
+  for(i = 0ul; i < pr.tiles_range().volume(); ++i)
+    BOOST_CHECK_EQUAL(c.make_tile_range(i), pr.make_tile_range(i));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -184,6 +184,30 @@ BOOST_AUTO_TEST_CASE( element_to_tile )
   BOOST_CHECK_EQUAL_COLLECTIONS(c.begin(), c.end(), e.begin(), e.end());
 }
 
+BOOST_AUTO_TEST_CASE( element_to_tile_uniform )
+{
+  // Uniform tilings, with and without a smaller last tile, and non-uniform
+  // tilings give the same map
+  for(const auto& r : { TiledRange1{ 3, 7, 11, 15 }, TiledRange1{ 3, 7, 11, 14 },
+      TiledRange1{ 3, 7, 11, 17 }, TiledRange1{ 3, 5, 11, 15 }, TiledRange1{ 3, 7 } })
+  {
+    for(std::size_t t = r.tiles_range().first; t < r.tiles_range().second; ++t)
+      for(std::size_t i = r.tile(t).first; i < r.tile(t).second; ++i)
+        BOOST_CHECK_EQUAL(r.element_to_tile(i), t);
+  }
+
+  BOOST_CHECK_EQUAL((TiledRange1{ 3, 7, 11, 15 }).uniform_tile_size(), 4ul);
+  BOOST_CHECK_EQUAL((TiledRange1{ 3, 7, 11, 14 }).uniform_tile_size(), 4ul);
+  BOOST_CHECK_EQUAL((TiledRange1{ 3, 7, 11, 17 }).uniform_tile_size(), 0ul);
+  BOOST_CHECK_EQUAL((TiledRange1{ 3, 5, 11, 15 }).uniform_tile_size(), 0ul);
+
+  // Check that copies give the same map
+  TiledRange1 r{ 3, 5, 11, 15 };
+  TiledRange1 c(r);
+  for(std::size_t i = r.elements_range().first; i < r.elements_range().second; ++i)
+    BOOST_CHECK_EQUAL(c.element_to_tile(i), r.element_to_tile(i));
+}
+
 BOOST_AUTO_TEST_CASE( comparison )
 {
   TiledRange1 r1{ 1, 2, 4, 6, 8, 10 };
@@ -0,0 +1,181 @@
+/*
+ *  This file is a part of TiledArray.
+ *  Copyright (C) 2016  Virginia Tech
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TiledArray/pmap/weighted_pmap.h"
+#include "tiledarray.h"
+#include "unit_test_config.h"
+#include "global_fixture.h"
+
+using namespace TiledArray;
+
+struct WeightedPmapFixture {
+
+  WeightedPmapFixture() { }
+
+  /// Weights with all non-zero tiles at the beginning
+  static std::vector<double> make_weights(const std::size_t tiles) {
+    std::vector<double> weights(tiles, 0.0);
+    for(std::size_t i = 0ul; i < (tiles + 3ul) / 4ul; ++i)
+      weights[i] = double(i % 3ul + 1ul);
+    return weights;
+  }
+
+};
+
+// =============================================================================
+// WeightedPmap Test Suite
+
+
+BOOST_FIXTURE_TEST_SUITE( weighted_pmap_suite, WeightedPmapFixture )
+
+BOOST_AUTO_TEST_CASE( constructor )
+{
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    BOOST_REQUIRE_NO_THROW(TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, make_weights(tiles)));
+    TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, make_weights(tiles));
+    BOOST_CHECK_EQUAL(pmap.rank(), GlobalFixture::world->rank());
+    BOOST_CHECK_EQUAL(pmap.procs(), GlobalFixture::world->size());
+    BOOST_CHECK_EQUAL(pmap.size(), tiles);
+  }
+
+#ifdef TA_EXCEPTION_ERROR
+  BOOST_CHECK_THROW(TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, std::vector<double>()), TiledArray::Exception);
+#endif // TA_EXCEPTION_ERROR
+}
+
+BOOST_AUTO_TEST_CASE( partition )
+{
+  typedef TiledArray::detail::WeightedPmap::size_type size_type;
+
+  for(std::size_t procs = 1ul; procs < 10ul; ++procs) {
+    for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+      const std::vector<double> weights = make_weights(tiles);
+      const std::vector<size_type> first =
+          TiledArray::detail::WeightedPmap::partition(weights, procs);
+
+      BOOST_REQUIRE_EQUAL(first.size(), procs + 1ul);
+      BOOST_CHECK_EQUAL(first.front(), 0ul);
+      BOOST_CHECK_EQUAL(first.back(), tiles);
+
+      // Check that the blocks are contiguous and that no process has more
+      // than its share of the weight plus one tile.
+      double total = 0.0, max_weight = 0.0;
+      for(const double w : weights) {
+        total += w;
+        max_weight = std::max(max_weight, w);
+      }
+      for(std::size_t p = 0ul; p < procs; ++p) {
+        BOOST_CHECK_LE(first[p], first[p + 1ul]);
+        double load = 0.0;
+        for(std::size_t i = first[p]; i < first[p + 1ul]; ++i)
+          load += weights[i];
+        BOOST_CHECK_LE(load, total / double(procs) + max_weight);
+      }
+    }
+  }
+
+  // Zero weights are distributed evenly
+  const std::vector<size_type> first =
+      TiledArray::detail::WeightedPmap::partition(std::vector<double>(10ul, 0.0), 5ul);
+  for(std::size_t p = 0ul; p <= 5ul; ++p)
+    BOOST_CHECK_EQUAL(first[p], 2ul * p);
+}
+
+BOOST_AUTO_TEST_CASE( imbalance )
+{
+  const std::vector<double> weights = make_weights(100ul);
+  TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, weights);
+  TiledArray::detail::BlockedPmap blocked_pmap(* GlobalFixture::world, 100ul);
+
+  const double imbalance = TiledArray::detail::WeightedPmap::imbalance(pmap, weights);
+  BOOST_CHECK_GE(imbalance, 1.0);
+  BOOST_CHECK_LE(imbalance,
+      TiledArray::detail::WeightedPmap::imbalance(blocked_pmap, weights));
+  if(GlobalFixture::world->size() == 1)
+    BOOST_CHECK_CLOSE(imbalance, 1.0, 1.0e-8);
+}
+
+BOOST_AUTO_TEST_CASE( owner )
+{
+  const std::size_t rank = GlobalFixture::world->rank();
+  const std::size_t size = GlobalFixture::world->size();
+
+  ProcessID* p_owner = new ProcessID[size];
+
+  // Check various pmap sizes
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, make_weights(tiles));
+
+    for(std::size_t tile = 0; tile < tiles; ++tile) {
+      std::fill_n(p_owner, size, 0);
+      p_owner[rank] = pmap.owner(tile);
+      // check that the value is in range
+      BOOST_CHECK_LT(p_owner[rank], size);
+      GlobalFixture::world->gop.sum(p_owner, size);
+
+      // Make sure everyone agrees on who owns what.
+      for(std::size_t p = 0ul; p < size; ++p)
+        BOOST_CHECK_EQUAL(p_owner[p], p_owner[rank]);
+    }
+  }
+
+  delete [] p_owner;
+}
+
+BOOST_AUTO_TEST_CASE( local_size )
+{
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, make_weights(tiles));
+
+    std::size_t total_size = pmap.local_size();
+    GlobalFixture::world->gop.sum(total_size);
+
+    // Check that the total number of elements in all local groups is equal to
+    // the number of tiles in the map.
+    BOOST_CHECK_EQUAL(total_size, tiles);
+    BOOST_CHECK(pmap.empty() == (pmap.local_size() == 0ul));
+  }
+}
+
+BOOST_AUTO_TEST_CASE( local_group )
+{
+  ProcessID tile_owners[100];
+
+  for(std::size_t tiles = 1ul; tiles < 100ul; ++tiles) {
+    TiledArray::detail::WeightedPmap pmap(* GlobalFixture::world, make_weights(tiles));
+
+    // Check that all local elements map to this rank
+    for(detail::WeightedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      BOOST_CHECK_EQUAL(pmap.owner(*it), GlobalFixture::world->rank());
+    }
+
+    std::fill_n(tile_owners, tiles, 0);
+    for(detail::WeightedPmap::const_iterator it = pmap.begin(); it != pmap.end(); ++it) {
+      tile_owners[*it] += GlobalFixture::world->rank();
+    }
+
+    GlobalFixture::world->gop.sum(tile_owners, tiles);
+    for(std::size_t tile = 0; tile < tiles; ++tile) {
+      BOOST_CHECK_EQUAL(tile_owners[tile], pmap.owner(tile));
+    }
+
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()